@@ -60,7 +60,9 @@ void batchedTensorForLoopFallback(const c10::OperatorHandle& op, torch::jit::Sta
               "Batching rule not implemented for ", schema, ". ",
               "The fallback path does not support operations with no returns.");
   TORCH_WARN("Batching rule not implemented for ", schema, " falling back "
-             "to slow (for loop and stack) implementation");
+             "to slow (for loop and stack) implementation. There is a performance "
+             "drop because it runs the operator once per example; please file "
+             "an issue so that we can prioritize the batching rule.");
 
   const auto num_arguments = schema.arguments().size();
   const auto arguments = torch::jit::last(stack, num_arguments);
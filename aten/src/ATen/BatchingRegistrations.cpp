@@ -3,6 +3,8 @@
 #include <ATen/BatchedFallback.h>
 #include <ATen/ATen.h>
 
+#include <numeric>
+
 namespace at {
 
 // NOTE: [What is a batching rule?]
@@ -19,7 +21,8 @@ namespace at {
 // NOTE: [When should I add a batching rule?]
 // When you are adding a new operator, you'll need to add a batching rule so
 // that vmap can work efficiently with said operator. If you do not, we'll attempt
-// to generate a slow fallback for the batching rule (this is not yet implemented).
+// to generate a slow fallback for the batching rule that runs the operator once
+// per example (see batchedTensorForLoopFallback), which warns when it is hit.
 
 // NOTE: [How to write batching rules?]
 // The signature of a batching rule should look like exactly like the C++ signature
@@ -48,19 +51,439 @@ namespace at {
 // if not use the same mechanism. In order to accomplish that we might have to
 // do some refactoring.
 
-Tensor sum_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
+// NOTE: [Batching rules of pointwise ops]
+// A pointwise op that takes a single tensor doesn't care where the batch dims
+// of its input are, so its batching rule calls it on the physical tensor as is
+// and the result gets the batch dims of the input.
+template <typename F, F Func, typename... ExtraArgs>
+Tensor unwrap_and_call(const Tensor& input, ExtraArgs... extra_args) {
+  auto* input_batched = unsafeGetBatchedImpl(input);
+  auto output_physical = Func(input_batched->value(), extra_args...);
+  auto old_bdims = input_batched->bdims();
+  return makeBatched(output_physical, BatchDims(old_bdims.begin(), old_bdims.end()));
+}
+
+// A 0-dim tensor that isn't batched: ops that broadcast treat it as a scalar,
+// so it can be passed to them as is.
+static bool isPhysicalScalarTensor(const Tensor& logical_tensor) {
+  return logical_tensor.dim() == 0 && !isBatchedTensor(logical_tensor);
+}
+
+// An unbatched tensor with the dtype and the dim (zero or not) of the logical
+// tensor, to compute the result type of an op on logical tensors.
+static Tensor resultTypeStandIn(const Tensor& logical_tensor) {
+  if (!isBatchedTensor(logical_tensor)) {
+    return logical_tensor;
+  }
+  if (logical_tensor.dim() == 0) {
+    return at::empty({}, logical_tensor.options());
+  }
+  return at::empty({0}, logical_tensor.options());
+}
+
+template <typename F, F Func, typename... ExtraArgs>
+Tensor binary_pointwise_batching_rule(
+    const Tensor& self, const Tensor& other, ExtraArgs... extra_args) {
+  if (self.dim() > 0 && other.dim() > 0) {
+    auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
+    auto result = Func(physical_args[0].tensor(), physical_args[1].tensor(), extra_args...);
+    return physical_args[0].newLogicalFromPhysical(result);
+  }
+  if (isPhysicalScalarTensor(self)) {
+    auto other_physical = MultiBatchVmapTransform::logicalToPhysical(other);
+    auto result = Func(self, other_physical.tensor(), extra_args...);
+    return other_physical.newLogicalFromPhysical(result);
+  }
+  if (isPhysicalScalarTensor(other)) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto result = Func(self_physical.tensor(), other, extra_args...);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  // One of the operands is a BatchedTensor with no logical dims. Its physical
+  // tensor has dims, so the op wouldn't type promote it like a 0-dim tensor:
+  // we promote the operands ourselves.
+  auto result_type = at::result_type(resultTypeStandIn(self), resultTypeStandIn(other));
+  auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
+  auto result = Func(
+      physical_args[0].tensor().to(result_type),
+      physical_args[1].tensor().to(result_type),
+      extra_args...);
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+// The logical dims are reduced away by viewing them as a single one, so that
+// a tensor with no logical dims (a scalar) has one to reduce over as well.
+static Tensor flattenLogicalDims(const VmapPhysicalView& self_physical) {
+  auto sizes = self_physical.tensor().sizes();
+  VmapDimVector flat_sizes(sizes.begin(), sizes.begin() + self_physical.numBatchDims());
+  flat_sizes.push_back(-1);
+  return self_physical.tensor().reshape(flat_sizes);
+}
+
+// Physical dims to reduce over when reducing the logical `dims` of a tensor,
+// all the logical dims when `dims` is empty
+static VmapDimVector getPhysicalReductionDims(
+    const VmapPhysicalView& self_physical, IntArrayRef dims) {
+  if (!dims.empty()) {
+    return self_physical.getPhysicalDims(dims);
+  }
+  VmapDimVector dims_physical;
+  for (int64_t dim = self_physical.numBatchDims(); dim < self_physical.tensor().dim(); dim++) {
+    dims_physical.push_back(dim);
+  }
+  return dims_physical;
+}
+
+using ReduceDimsFn = Tensor (*)(const Tensor&, IntArrayRef, bool, optional<ScalarType>);
+
+// Reductions over some dims, e.g. sum.dim_IntList, whose `dim` may be empty
+// to reduce over all of them
+template <ReduceDimsFn Func>
+Tensor reduce_dims_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim, optional<ScalarType> dtype) {
   auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
-  auto dims_physical = self_physical.getPhysicalDims(dims);
-  auto result = at::sum(self_physical.tensor(), dims_physical, keepdim, dtype);
+  if (/*logical*/self.dim() == 0) {
+    auto result = Func(flattenLogicalDims(self_physical), {-1}, /*keepdim=*/false, dtype);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  auto dims_physical = getPhysicalReductionDims(self_physical, dims);
+  auto result = Func(self_physical.tensor(), dims_physical, keepdim, dtype);
   return self_physical.newLogicalFromPhysical(result);
 }
 
-Tensor mul_batching_rule(const Tensor& self, const Tensor& other) {
+// Reductions over all the dims, e.g. sum. They are computed by the variant
+// that reduces over some dims.
+template <ReduceDimsFn Func>
+Tensor reduce_all_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto result = Func(flattenLogicalDims(self_physical), {-1}, /*keepdim=*/false, dtype);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor prod_dim_batching_rule(const Tensor& self, int64_t dim, bool keepdim, optional<ScalarType> dtype) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  if (/*logical*/self.dim() == 0) {
+    auto result = at::prod(flattenLogicalDims(self_physical), -1, /*keepdim=*/false, dtype);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = at::prod(self_physical.tensor(), dim_physical, keepdim, dtype);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor prod_batching_rule(const Tensor& self, optional<ScalarType> dtype) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  auto result = at::prod(flattenLogicalDims(self_physical), -1, /*keepdim=*/false, dtype);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+Tensor logsumexp_batching_rule(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  if (/*logical*/self.dim() == 0) {
+    auto result = at::logsumexp(flattenLogicalDims(self_physical), {-1}, /*keepdim=*/false);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  auto dims_physical = getPhysicalReductionDims(self_physical, dims);
+  auto result = at::logsumexp(self_physical.tensor(), dims_physical, keepdim);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+using SoftmaxFn = Tensor (*)(const Tensor&, int64_t, optional<ScalarType>);
+
+// softmax and log_softmax
+template <SoftmaxFn Func>
+Tensor softmax_batching_rule(const Tensor& self, int64_t dim, optional<ScalarType> dtype) {
+  auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+  if (/*logical*/self.dim() == 0) {
+    maybe_wrap_dim(dim, /*logical_dim*/0);
+    auto result = Func(self_physical.tensor().unsqueeze(-1), -1, dtype).squeeze(-1);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  auto dim_physical = self_physical.getPhysicalDim(dim);
+  auto result = Func(self_physical.tensor(), dim_physical, dtype);
+  return self_physical.newLogicalFromPhysical(result);
+}
+
+// Product of logical tensors that have at least 2 dims, which at::matmul
+// broadcasts like any other dims but the last 2
+static Tensor matmulOfMatrices(const Tensor& self, const Tensor& other) {
+  // An unbatched operand with no more dims than the other is passed as is,
+  // its dims broadcast against the logical dims of the other. For an
+  // unbatched self, the product is computed transposed so that at::matmul can
+  // fold the batch dims of other into a single matrix multiplication.
+  if (!isBatchedTensor(other) && other.dim() <= self.dim()) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto result = at::matmul(self_physical.tensor(), other);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  if (!isBatchedTensor(self) && self.dim() <= other.dim()) {
+    auto other_physical = MultiBatchVmapTransform::logicalToPhysical(other);
+    auto result = at::matmul(other_physical.tensor().transpose(-1, -2), self.transpose(-1, -2));
+    return other_physical.newLogicalFromPhysical(result.transpose(-1, -2));
+  }
   auto physical_args = BroadcastingVmapTransform::logicalToPhysical({self, other});
-  auto result = at::mul(physical_args[0].tensor(), physical_args[1].tensor());
+  auto result = at::matmul(physical_args[0].tensor(), physical_args[1].tensor());
   return physical_args[0].newLogicalFromPhysical(result);
 }
 
+Tensor mm_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical*/self.dim() == 2 && /*logical*/other.dim() == 2,
+      "mm: Expected 2-D arguments, but got ", self.dim(), "-D and ", other.dim(), "-D");
+  return matmulOfMatrices(self, other);
+}
+
+Tensor bmm_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical*/self.dim() == 3 && /*logical*/other.dim() == 3,
+      "bmm: Expected 3-D arguments, but got ", self.dim(), "-D and ", other.dim(), "-D");
+  TORCH_CHECK(self.size(0) == other.size(0),
+      "bmm: Expected the same batch size, but got ", self.size(0), " and ", other.size(0));
+  return matmulOfMatrices(self, other);
+}
+
+Tensor mv_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical*/self.dim() == 2 && /*logical*/other.dim() == 1,
+      "mv: Expected a 2-D and a 1-D argument, but got ", self.dim(), "-D and ", other.dim(), "-D");
+  return matmulOfMatrices(self, other.unsqueeze(-1)).squeeze(-1);
+}
+
+Tensor dot_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical*/self.dim() == 1 && /*logical*/other.dim() == 1,
+      "dot: Expected 1-D arguments, but got ", self.dim(), "-D and ", other.dim(), "-D");
+  return matmulOfMatrices(self.unsqueeze(0), other.unsqueeze(-1)).squeeze(-1).squeeze(-1);
+}
+
+Tensor matmul_batching_rule(const Tensor& self, const Tensor& other) {
+  TORCH_CHECK(/*logical*/self.dim() > 0 && /*logical*/other.dim() > 0,
+      "both arguments to matmul need to be at least 1D, but they are ",
+      self.dim(), "D and ", other.dim(), "D");
+  // Like at::matmul, a vector operand is a matrix with a dim of size 1 that
+  // gets squeezed from the result
+  const bool self_is_vector = self.dim() == 1;
+  const bool other_is_vector = other.dim() == 1;
+  auto result = matmulOfMatrices(
+      self_is_vector ? self.unsqueeze(0) : self,
+      other_is_vector ? other.unsqueeze(-1) : other);
+  if (self_is_vector) {
+    result = result.squeeze(-2);
+  }
+  if (other_is_vector) {
+    result = result.squeeze(-1);
+  }
+  return result;
+}
+
+static bool isDefinedOptionalTensor(const optional<Tensor>& tensor) {
+  return tensor.has_value() && tensor->defined();
+}
+
+static bool isBatchedOptionalTensor(const optional<Tensor>& tensor) {
+  return isDefinedOptionalTensor(tensor) && isBatchedTensor(*tensor);
+}
+
+using ConvFn = Tensor (*)(const Tensor&, const Tensor&, const optional<Tensor>&,
+                          IntArrayRef, IntArrayRef, IntArrayRef, int64_t);
+
+// conv1d, conv2d and conv3d.
+// The batch dims of the input are flattened into its own batch dim (N). When
+// the weight or the bias are batched, the batch dims are rather flattened into
+// the channels of the input, and every example makes `groups` groups of a
+// single convolution.
+template <ConvFn Func>
+Tensor conv_batching_rule(
+    const Tensor& input, const Tensor& weight, const optional<Tensor>& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  TORCH_CHECK(/*logical*/input.dim() >= 3,
+      "Expected a batch dim and a channel dim in the input of a convolution, but got ",
+      input.dim(), "-D input");
+  if (!isBatchedTensor(weight) && !isBatchedOptionalTensor(bias)) {
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    auto num_batch_dims = input_physical.numBatchDims();
+    auto input_sizes = input_physical.tensor().sizes();
+    VmapDimVector flat_input_sizes = {-1};
+    flat_input_sizes.insert(flat_input_sizes.end(), input_sizes.begin() + num_batch_dims + 1, input_sizes.end());
+    auto result = Func(
+        input_physical.tensor().reshape(flat_input_sizes), weight, bias, stride, padding, dilation, groups);
+    VmapDimVector result_sizes(input_sizes.begin(), input_sizes.begin() + num_batch_dims + 1);
+    result_sizes.insert(result_sizes.end(), result.sizes().begin() + 1, result.sizes().end());
+    return input_physical.newLogicalFromPhysical(result.view(result_sizes));
+  }
+
+  const bool batched_bias = isBatchedOptionalTensor(bias);
+  auto physical_args = batched_bias
+      ? MultiBatchVmapTransform::logicalToPhysical({input, weight, *bias})
+      : MultiBatchVmapTransform::logicalToPhysical({input, weight});
+  const auto& input_physical = physical_args[0].tensor();
+  const auto& weight_physical = physical_args[1].tensor();
+  auto num_batch_dims = physical_args[0].numBatchDims();
+  auto input_sizes = input_physical.sizes();
+  auto batch_sizes = input_sizes.slice(0, num_batch_dims);
+  int64_t batch_size = std::accumulate(
+      batch_sizes.begin(), batch_sizes.end(), int64_t(1), std::multiplies<int64_t>());
+  auto num_examples = input_sizes[num_batch_dims];
+  auto out_channels = weight_physical.size(num_batch_dims);
+
+  // [B..., N, C, *] -> [N, B * C, *]
+  VmapDimVector grouped_input_sizes = {batch_size, num_examples, -1};
+  grouped_input_sizes.insert(grouped_input_sizes.end(), input_sizes.begin() + num_batch_dims + 2, input_sizes.end());
+  VmapDimVector flat_input_sizes = {num_examples, -1};
+  flat_input_sizes.insert(flat_input_sizes.end(), input_sizes.begin() + num_batch_dims + 2, input_sizes.end());
+  auto flat_input = input_physical.reshape(grouped_input_sizes).transpose(0, 1).reshape(flat_input_sizes);
+  // [B..., O, C / groups, *] -> [B * O, C / groups, *]
+  auto weight_sizes = weight_physical.sizes();
+  VmapDimVector flat_weight_sizes = {-1};
+  flat_weight_sizes.insert(flat_weight_sizes.end(), weight_sizes.begin() + num_batch_dims + 1, weight_sizes.end());
+  auto flat_weight = weight_physical.reshape(flat_weight_sizes);
+  optional<Tensor> flat_bias;
+  if (batched_bias) {
+    flat_bias = physical_args[2].tensor().reshape({-1});
+  } else if (isDefinedOptionalTensor(bias)) {
+    flat_bias = bias->repeat({batch_size});
+  }
+
+  auto result = Func(flat_input, flat_weight, flat_bias, stride, padding, dilation, groups * batch_size);
+  // [N, B * O, *] -> [B..., N, O, *]
+  VmapDimVector grouped_result_sizes = {num_examples, batch_size, out_channels};
+  grouped_result_sizes.insert(grouped_result_sizes.end(), result.sizes().begin() + 2, result.sizes().end());
+  VmapDimVector result_sizes(batch_sizes.begin(), batch_sizes.end());
+  result_sizes.push_back(num_examples);
+  result_sizes.push_back(out_channels);
+  result_sizes.insert(result_sizes.end(), result.sizes().begin() + 2, result.sizes().end());
+  result = result.view(grouped_result_sizes).transpose(0, 1).reshape(result_sizes);
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+Tensor index_select_batching_rule(const Tensor& self, int64_t dim, const Tensor& index) {
+  if (!isBatchedTensor(index)) {
+    auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
+    auto dim_physical = self_physical.getPhysicalDim(dim);
+    auto result = at::index_select(self_physical.tensor(), dim_physical, index);
+    return self_physical.newLogicalFromPhysical(result);
+  }
+  // With a different index for every example, gather the selected slices:
+  // the index is viewed with size 1 for the other logical dims, and expanded
+  TORCH_CHECK(/*logical*/index.dim() <= 1, "index_select(): Index is supposed to be a vector");
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  const auto& self_physical = physical_args[0].tensor();
+  auto index_physical = physical_args[1].tensor();
+  if (/*logical*/index.dim() == 0) {
+    index_physical = index_physical.unsqueeze(-1);
+  }
+  auto num_batch_dims = physical_args[0].numBatchDims();
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto num_indices = index_physical.size(-1);
+  VmapDimVector index_sizes(self_physical.dim(), 1);
+  std::copy(index_physical.sizes().begin(), index_physical.sizes().begin() + num_batch_dims, index_sizes.begin());
+  index_sizes[dim_physical] = num_indices;
+  VmapDimVector result_sizes(self_physical.sizes().begin(), self_physical.sizes().end());
+  result_sizes[dim_physical] = num_indices;
+  auto result = at::gather(
+      self_physical, dim_physical, index_physical.reshape(index_sizes).expand(result_sizes));
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+Tensor gather_batching_rule(const Tensor& self, int64_t dim, const Tensor& index, bool sparse_grad) {
+  auto physical_args = MultiBatchVmapTransform::logicalToPhysical({self, index});
+  auto dim_physical = physical_args[0].getPhysicalDim(dim);
+  auto result = at::gather(physical_args[0].tensor(), dim_physical, physical_args[1].tensor(), sparse_grad);
+  return physical_args[0].newLogicalFromPhysical(result);
+}
+
+Tensor layer_norm_batching_rule(
+    const Tensor& input, IntArrayRef normalized_shape, const optional<Tensor>& weight,
+    const optional<Tensor>& bias, double eps, bool cudnn_enable) {
+  Tensor result;
+  if (isBatchedTensor(input)) {
+    // The normalized dims are the last ones, the batch dims are normalized
+    // separately like the other leading dims
+    auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+    if (!isBatchedOptionalTensor(weight) && !isBatchedOptionalTensor(bias)) {
+      auto result = at::layer_norm(input_physical.tensor(), normalized_shape, weight, bias, eps, cudnn_enable);
+      return input_physical.newLogicalFromPhysical(result);
+    }
+    result = input_physical.newLogicalFromPhysical(
+        at::layer_norm(input_physical.tensor(), normalized_shape, {}, {}, eps, cudnn_enable));
+  } else {
+    result = at::layer_norm(input, normalized_shape, {}, {}, eps, cudnn_enable);
+  }
+  // A batched weight or bias scales and shifts the normalized input
+  if (isDefinedOptionalTensor(weight)) {
+    result = result * *weight;
+  }
+  if (isDefinedOptionalTensor(bias)) {
+    result = result + *bias;
+  }
+  return result;
+}
+
+// Runs the batch_norm of every example like batchedTensorForLoopFallback
+static Tensor batch_norm_for_loop(
+    const Tensor& input, const optional<Tensor>& weight, const optional<Tensor>& bias,
+    const optional<Tensor>& running_mean, const optional<Tensor>& running_var,
+    bool training, double momentum, double eps, bool cudnn_enabled) {
+  static auto op = c10::Dispatcher::singleton().findSchemaOrThrow("aten::batch_norm", "");
+  torch::jit::Stack stack;
+  torch::jit::push(
+      stack, input, weight, bias, running_mean, running_var, training, momentum, eps, cudnn_enabled);
+  batchedTensorForLoopFallback(op, &stack);
+  return torch::jit::pop(stack).toTensor();
+}
+
+Tensor batch_norm_batching_rule(
+    const Tensor& input, const optional<Tensor>& weight, const optional<Tensor>& bias,
+    const optional<Tensor>& running_mean, const optional<Tensor>& running_var,
+    bool training, double momentum, double eps, bool cudnn_enabled) {
+  const bool has_running_stats =
+      isDefinedOptionalTensor(running_mean) || isDefinedOptionalTensor(running_var);
+  // Every example updates the running stats in turn
+  if (!isBatchedTensor(input) || isBatchedOptionalTensor(weight) || isBatchedOptionalTensor(bias) ||
+      isBatchedOptionalTensor(running_mean) || isBatchedOptionalTensor(running_var) ||
+      (training && has_running_stats)) {
+    return batch_norm_for_loop(
+        input, weight, bias, running_mean, running_var, training, momentum, eps, cudnn_enabled);
+  }
+
+  TORCH_CHECK(/*logical*/input.dim() >= 2,
+      "Expected a batch dim and a channel dim in the input of batch_norm, but got ",
+      input.dim(), "-D input");
+  auto input_physical = MultiBatchVmapTransform::logicalToPhysical(input);
+  auto num_batch_dims = input_physical.numBatchDims();
+  auto input_sizes = input_physical.tensor().sizes();
+  if (!training) {
+    // The running stats normalize every element on its own: the batch dims are
+    // flattened into the batch dim (N) of the input
+    VmapDimVector flat_input_sizes = {-1};
+    flat_input_sizes.insert(flat_input_sizes.end(), input_sizes.begin() + num_batch_dims + 1, input_sizes.end());
+    auto result = at::batch_norm(
+        input_physical.tensor().reshape(flat_input_sizes), weight, bias, running_mean, running_var,
+        training, momentum, eps, cudnn_enabled);
+    return input_physical.newLogicalFromPhysical(result.view(input_sizes));
+  }
+  // The statistics of every example: the batch dims are flattened into the
+  // channels of the input, [B..., N, C, *] -> [N, B * C, *]
+  auto batch_sizes = input_sizes.slice(0, num_batch_dims);
+  int64_t batch_size = std::accumulate(
+      batch_sizes.begin(), batch_sizes.end(), int64_t(1), std::multiplies<int64_t>());
+  auto num_examples = input_sizes[num_batch_dims];
+  VmapDimVector grouped_input_sizes = {batch_size, num_examples, -1};
+  grouped_input_sizes.insert(grouped_input_sizes.end(), input_sizes.begin() + num_batch_dims + 2, input_sizes.end());
+  VmapDimVector flat_input_sizes = {num_examples, -1};
+  flat_input_sizes.insert(flat_input_sizes.end(), input_sizes.begin() + num_batch_dims + 2, input_sizes.end());
+  auto flat_input = input_physical.tensor().reshape(grouped_input_sizes).transpose(0, 1).reshape(flat_input_sizes);
+  optional<Tensor> flat_weight;
+  if (isDefinedOptionalTensor(weight)) {
+    flat_weight = weight->repeat({batch_size});
+  }
+  optional<Tensor> flat_bias;
+  if (isDefinedOptionalTensor(bias)) {
+    flat_bias = bias->repeat({batch_size});
+  }
+  auto result = at::batch_norm(
+      flat_input, flat_weight, flat_bias, running_mean, running_var, training, momentum, eps, cudnn_enabled);
+  VmapDimVector grouped_result_sizes = {num_examples, batch_size, -1};
+  grouped_result_sizes.insert(grouped_result_sizes.end(), input_sizes.begin() + num_batch_dims + 2, input_sizes.end());
+  result = result.view(grouped_result_sizes).transpose(0, 1).reshape(input_sizes);
+  return input_physical.newLogicalFromPhysical(result);
+}
+
 Tensor expand_batching_rule(const Tensor& self, IntArrayRef size, bool implicit) {
   auto self_physical = MultiBatchVmapTransform::logicalToPhysical(self);
   auto size_physical = self_physical.getPhysicalShape(size);
@@ -239,8 +662,56 @@ TORCH_LIBRARY_IMPL(aten, Batched, m) {
   m.impl("_add_batch_dim", native::_add_batch_dim);
   m.impl("_remove_batch_dim", native::_remove_batch_dim);
 
-  m.impl_UNBOXED("sum.dim_IntList", sum_batching_rule);
-  m.impl_UNBOXED("mul.Tensor", mul_batching_rule);
+  // pointwise operations
+#define UNARY_POINTWISE(op) m.impl_UNBOXED(#op, unwrap_and_call<Tensor (*)(const Tensor&), at::op>);
+  UNARY_POINTWISE(abs);
+  UNARY_POINTWISE(cos);
+  UNARY_POINTWISE(exp);
+  UNARY_POINTWISE(log);
+  UNARY_POINTWISE(neg);
+  UNARY_POINTWISE(relu);
+  UNARY_POINTWISE(rsqrt);
+  UNARY_POINTWISE(sigmoid);
+  UNARY_POINTWISE(sin);
+  UNARY_POINTWISE(sqrt);
+  UNARY_POINTWISE(tanh);
+#undef UNARY_POINTWISE
+
+  using TensorTensorScalarType = Tensor (*)(const Tensor&, const Tensor&, Scalar);
+  using TensorTensorType = Tensor (*)(const Tensor&, const Tensor&);
+  m.impl_UNBOXED("add.Tensor", binary_pointwise_batching_rule<TensorTensorScalarType, at::add, Scalar>);
+  m.impl_UNBOXED("sub.Tensor", binary_pointwise_batching_rule<TensorTensorScalarType, at::sub, Scalar>);
+  m.impl_UNBOXED("mul.Tensor", binary_pointwise_batching_rule<TensorTensorType, at::mul>);
+  m.impl_UNBOXED("div.Tensor", binary_pointwise_batching_rule<TensorTensorType, at::div>);
+
+  // reductions
+  m.impl_UNBOXED("sum", reduce_all_batching_rule<at::sum>);
+  m.impl_UNBOXED("sum.dim_IntList", reduce_dims_batching_rule<at::sum>);
+  m.impl_UNBOXED("mean", reduce_all_batching_rule<at::mean>);
+  m.impl_UNBOXED("mean.dim", reduce_dims_batching_rule<at::mean>);
+  m.impl_UNBOXED("prod", prod_batching_rule);
+  m.impl_UNBOXED("prod.dim_int", prod_dim_batching_rule);
+  m.impl_UNBOXED("logsumexp", logsumexp_batching_rule);
+  m.impl_UNBOXED("softmax.int", softmax_batching_rule<at::softmax>);
+  m.impl_UNBOXED("log_softmax.int", softmax_batching_rule<at::log_softmax>);
+
+  // matrix products
+  m.impl_UNBOXED("mm", mm_batching_rule);
+  m.impl_UNBOXED("bmm", bmm_batching_rule);
+  m.impl_UNBOXED("mv", mv_batching_rule);
+  m.impl_UNBOXED("dot", dot_batching_rule);
+  m.impl_UNBOXED("matmul", matmul_batching_rule);
+
+  // convolutions and normalizations
+  m.impl_UNBOXED("conv1d", conv_batching_rule<at::conv1d>);
+  m.impl_UNBOXED("conv2d", conv_batching_rule<at::conv2d>);
+  m.impl_UNBOXED("conv3d", conv_batching_rule<at::conv3d>);
+  m.impl_UNBOXED("layer_norm", layer_norm_batching_rule);
+  m.impl_UNBOXED("batch_norm", batch_norm_batching_rule);
+
+  // indexing
+  m.impl_UNBOXED("index_select", index_select_batching_rule);
+  m.impl_UNBOXED("gather", gather_batching_rule);
 
   // view operations
   m.impl("chunk", chunk_batching_rule);
@@ -47,12 +47,15 @@ CPUGeneratorImpl::CPUGeneratorImpl(uint64_t seed_in)
 
 /**
  * Manually seeds the engine with the seed input
+ * Resets the philox_offset_ to 0
+ *
  * See Note [Acquire lock when using random generators]
  */
 void CPUGeneratorImpl::set_current_seed(uint64_t seed) {
   next_float_normal_sample_.reset();
   next_double_normal_sample_.reset();
   engine_ = mt19937(seed);
+  philox_offset_ = 0;
 }
 
 /**
@@ -151,6 +154,53 @@ void CPUGeneratorImpl::set_engine(at::mt19937 engine) {
   engine_ = engine;
 }
 
+/**
+ * Whether the kernels that support it draw from a philox engine instead
+ * of the mt19937 one.
+ * See Note [Parallel CPU random generation]
+ */
+bool CPUGeneratorImpl::philox_mode() const {
+  return philox_mode_;
+}
+
+/**
+ * Switches the generator to or from the philox engine
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CPUGeneratorImpl::set_philox_mode(bool enabled) {
+  philox_mode_ = enabled;
+}
+
+/**
+ * Gets the number of 128 bit philox numbers reserved since the last seeding
+ */
+uint64_t CPUGeneratorImpl::philox_offset() const {
+  return philox_offset_;
+}
+
+/**
+ * Sets the philox_offset_ of the next philox_engine_inputs call
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CPUGeneratorImpl::set_philox_offset(uint64_t offset) {
+  philox_offset_ = offset;
+}
+
+/**
+ * Gets the seed and the philox offset for a kernel, and reserves
+ * increment 128 bit philox numbers for it, like
+ * CUDAGeneratorImpl::philox_engine_inputs
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+std::pair<uint64_t, uint64_t> CPUGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  uint64_t offset = philox_offset_;
+  philox_offset_ += increment;
+  return std::make_pair(engine_.seed(), offset);
+}
+
 /**
  * Public clone method implementation
  *
@@ -170,6 +220,8 @@ CPUGeneratorImpl* CPUGeneratorImpl::clone_impl() const {
   gen->set_engine(engine_);
   gen->set_next_float_normal_sample(next_float_normal_sample_);
   gen->set_next_double_normal_sample(next_double_normal_sample_);
+  gen->set_philox_mode(philox_mode_);
+  gen->set_philox_offset(philox_offset_);
   return gen;
 }
 
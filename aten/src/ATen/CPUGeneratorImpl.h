@@ -4,6 +4,7 @@
 #include <ATen/core/MT19937RNGEngine.h>
 #include <c10/util/Optional.h>
 #include <c10/core/GeneratorImpl.h>
+#include <utility>
 
 namespace at {
 
@@ -27,11 +28,20 @@ struct CAFFE2_API CPUGeneratorImpl : public c10::GeneratorImpl {
   at::mt19937 engine();
   void set_engine(at::mt19937 engine);
 
+  // Counter-based generation, see Note [Parallel CPU random generation]
+  bool philox_mode() const;
+  void set_philox_mode(bool enabled);
+  uint64_t philox_offset() const;
+  void set_philox_offset(uint64_t offset);
+  std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+
 private:
   CPUGeneratorImpl* clone_impl() const override;
   at::mt19937 engine_;
   c10::optional<float> next_float_normal_sample_;
   c10::optional<double> next_double_normal_sample_;
+  bool philox_mode_ = false;
+  uint64_t philox_offset_ = 0;
 };
 
 namespace detail {
@@ -2,11 +2,35 @@
 
 #include <c10/core/GeneratorImpl.h>
 #include <ATen/core/Generator.h>
+#include <ATen/cuda/PhiloxCudaState.h>
 
 // TODO: this file should be in ATen/cuda, not top level
 
 namespace at {
 
+/**
+ * Note [CUDA Graph-safe RNG states]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Strategy:
+ * ~~~~~~~~~
+ * A CUDA graph containing multiple RNG ops behaves like a single giant kernel
+ * that's launched once per replay. Each replay must consume fresh random
+ * numbers, so the philox offset can't be baked into the captured kernels.
+ *
+ * While a graph is captured, philox_cuda_state() hands each kernel a
+ * PhiloxCudaState holding a pointer to a device scalar owned by the graph
+ * (offset_extragraph) plus the running offset within the graph
+ * (offset_intragraph). Before each replay, CUDAGraph::replay() fills the
+ * device scalar with the generator's current offset and advances the
+ * generator by the total offset the graph consumes, exactly as if the captured
+ * kernels had been launched eagerly. Kernels retrieve their seed and offset
+ * with at::cuda::philox::unpack(), which works in either case.
+ *
+ * Kernels still calling philox_engine_inputs() get their offset by value and
+ * therefore refuse to run during capture.
+ */
+
 struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   // Constructors
   CUDAGeneratorImpl(DeviceIndex device_index = -1);
@@ -19,13 +43,23 @@ struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   uint64_t seed() override;
   void set_philox_offset_per_thread(uint64_t offset);
   uint64_t philox_offset_per_thread();
+  void capture_prologue(int64_t* offset_extragraph);
+  uint64_t capture_epilogue();
+  PhiloxCudaState philox_cuda_state(uint64_t increment);
+
+  // Temporarily accommodates call sites that use philox_engine_inputs.
+  // Allows incremental refactor of call sites to use philox_cuda_state.
   std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+
   static DeviceType device_type();
 
 private:
   CUDAGeneratorImpl* clone_impl() const override;
   uint64_t seed_ = default_rng_seed_val;
   uint64_t philox_offset_per_thread_ = 0;
+  int64_t* offset_extragraph_ = nullptr;
+  uint32_t offset_intragraph_ = 0;
+  bool graph_expects_this_gen_ = false;
 };
 
 namespace cuda {
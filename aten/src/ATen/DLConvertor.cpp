@@ -214,14 +214,18 @@ Tensor fromDLPack(const DLManagedTensor* src) {
   auto deleter = [src](void* self) {
     src->deleter(const_cast<DLManagedTensor*>(src));
   };
+  // Producers may describe a view into a larger allocation by its base
+  // pointer and a byte offset instead of an adjusted data pointer.
+  void* data = static_cast<char*>(src->dl_tensor.data) +
+      src->dl_tensor.byte_offset;
   if (!src->dl_tensor.strides) {
-    return at::from_blob(src->dl_tensor.data,
+    return at::from_blob(data,
         IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
         deleter,
         at::device(device).dtype(stype));
   }
   return at::from_blob(
-      src->dl_tensor.data,
+      data,
       IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
       IntArrayRef(src->dl_tensor.strides, src->dl_tensor.ndim),
       deleter,
@@ -7,8 +7,38 @@
 #include <c10/util/Half.h>
 #include <c10/util/complex.h>
 
+#ifdef TEMPLATE_SELECTIVE_BUILD
+// Mobile builds can restrict the dtypes every kernel is built for, see
+// tools/code_analyzer/gen_selected_kernel_dtypes.py. The generated header
+// provides a constexpr should_include_kernel_dtype(kernel_tag, dtype) over the
+// NAME passed to the AT_DISPATCH_* macros; the cases of dtypes that are not
+// selected only raise an error, so the compiler drops the kernel code behind
+// them.
+#include <ATen/selected_mobile_ops.h>
+#include <type_traits>
+
+#define AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME) \
+  constexpr const char* at_dispatch_name = NAME;
+
+#define AT_PRIVATE_CHECK_SELECTIVE_BUILD(enum_type)                       \
+  if (!std::integral_constant<                                            \
+          bool,                                                           \
+          at::should_include_kernel_dtype(at_dispatch_name, enum_type)>:: \
+          value) {                                                        \
+    AT_ERROR(                                                             \
+        "dtype '",                                                        \
+        toString(enum_type),                                              \
+        "' not selected for kernel tag ",                                 \
+        at_dispatch_name);                                                \
+  }
+#else
+#define AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)
+#define AT_PRIVATE_CHECK_SELECTIVE_BUILD(enum_type)
+#endif
+
 #define AT_PRIVATE_CASE_TYPE(enum_type, type, ...) \
   case enum_type: {                                \
+    AT_PRIVATE_CHECK_SELECTIVE_BUILD(enum_type);   \
     using scalar_t = type;                         \
     return __VA_ARGS__();                          \
   }
@@ -25,6 +55,7 @@
 #define AT_QINT_PRIVATE_CASE_TYPE(                                           \
     enum_type, type, underlying_enum, underlying_type, ...)                  \
   case enum_type: {                                                          \
+    AT_PRIVATE_CHECK_SELECTIVE_BUILD(enum_type);                             \
     using scalar_t = type;                                                   \
     using underlying_t C10_UNUSED_DISPATCH_CUDA_WORKAROUND =                 \
         scalar_t::underlying;                                                \
@@ -134,6 +165,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_FLOATING_TYPES(TYPE, NAME, ...)                         \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -147,6 +179,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_FLOATING_TYPES_AND_HALF(TYPE, NAME, ...)                \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -161,6 +194,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_FLOATING_TYPES_AND(SCALARTYPE, TYPE, NAME, ...)         \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -179,6 +213,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 #define AT_DISPATCH_FLOATING_TYPES_AND2(                                    \
     SCALARTYPE1, SCALARTYPE2, TYPE, NAME, ...)                              \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -200,6 +235,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(TYPE, NAME, ...)             \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -218,6 +254,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 #define AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(                        \
     SCALARTYPE, TYPE, NAME, ...)                                            \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -240,6 +277,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 #define AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND2(                        \
     SCALARTYPE1, SCALARTYPE2, TYPE, NAME, ...)                              \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -265,6 +303,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_INTEGRAL_TYPES(TYPE, NAME, ...)                         \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -281,6 +320,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_INTEGRAL_TYPES_AND(SCALARTYPE, TYPE, NAME, ...)     \
   [&] {                                                                 \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                              \
     switch (TYPE) {                                                     \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)  \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)   \
@@ -298,6 +338,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_ALL_TYPES(TYPE, NAME, ...)                               \
   [&] {                                                                      \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                   \
     const auto& the_type = TYPE;                                             \
     /* don't use TYPE again in case it is an expensive or side-effect op  */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                    \
@@ -316,6 +357,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_COMPLEX_TYPES(TYPE, NAME, ...)                          \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -331,6 +373,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_QINT_TYPES(TYPE, NAME, ...)                             \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -348,6 +391,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_ALL_TYPES_AND_COMPLEX(TYPE, NAME, ...)                  \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op*/  \
     at::ScalarType _st = ::detail::scalar_type(the_type);                   \
@@ -370,6 +414,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_ALL_TYPES_AND(SCALARTYPE, TYPE, NAME, ...)          \
   [&] {                                                                 \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                              \
     switch (TYPE) {                                                     \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)  \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)   \
@@ -389,6 +434,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(SCALARTYPE, TYPE, NAME, ...)  \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     switch (TYPE) {                                                         \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)      \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)       \
@@ -412,6 +458,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_ALL_TYPES_AND2(SCALARTYPE1, SCALARTYPE2, TYPE, NAME, ...) \
   [&] {                                                                       \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                    \
     switch (TYPE) {                                                           \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)        \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)         \
@@ -436,6 +483,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 #define AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(                             \
     SCALARTYPE1, SCALARTYPE2, TYPE, NAME, ...)                              \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     switch (TYPE) {                                                         \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)      \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)       \
@@ -464,6 +512,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 #define AT_DISPATCH_ALL_TYPES_AND3(                                     \
     SCALARTYPE1, SCALARTYPE2, SCALARTYPE3, TYPE, NAME, ...)             \
   [&] {                                                                 \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                              \
     switch (TYPE) {                                                     \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)  \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)   \
@@ -492,6 +541,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 #define AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(                             \
     SCALARTYPE1, SCALARTYPE2, SCALARTYPE3, TYPE, NAME, ...)                 \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     switch (TYPE) {                                                         \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Byte, uint8_t, __VA_ARGS__)      \
       AT_PRIVATE_CASE_TYPE(at::ScalarType::Char, int8_t, __VA_ARGS__)       \
@@ -527,6 +577,7 @@ inline void deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF_AND_COMPLEX() {}
 
 #define AT_DISPATCH_ALL_TYPES_AND_HALF(TYPE, NAME, ...)                     \
   [&] {                                                                     \
+    AT_PRIVATE_DECLARE_DISPATCH_NAME(NAME)                                  \
     detail::deprecated_AT_DISPATCH_ALL_TYPES_AND_HALF();                    \
     const auto& the_type = TYPE;                                            \
     /* don't use TYPE again in case it is an expensive or side-effect op */ \
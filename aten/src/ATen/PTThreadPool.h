@@ -10,8 +10,12 @@ public:
   explicit PTThreadPool(
       int pool_size,
       int numa_node_id = -1)
-    : c10::ThreadPool(pool_size, numa_node_id, [](){
+    : c10::ThreadPool(pool_size, numa_node_id, [numa_node_id](){
         c10::setThreadName("PTThreadPool");
+        // Pin pool threads to the requested node, or to the process-wide
+        // preferred node so that they read tensors from local memory.
+        c10::NUMABind(
+            numa_node_id >= 0 ? numa_node_id : c10::GetPreferredNUMANode());
         at::init_num_threads();
       }) {}
 };
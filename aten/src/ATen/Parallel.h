@@ -143,6 +143,55 @@ CAFFE2_API std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 // Returns number of intra-op threads used by default
 CAFFE2_API int intraop_default_num_threads();
 
+// Note [Thread budget]
+// ~~~~~~~~~~~~~~~~~~~~
+// The inter-op pool, the intra-op pool and the OpenMP/MKL pools are sized
+// independently, so inter-op tasks (e.g. torch.jit._fork) that run parallel
+// ops can use far more threads than there are cores. With a thread budget
+// set, every thread running an inter-op task or a parallel region counts
+// against one process-wide limit. A parallel region only gets as many helper
+// threads as remain in the budget, capped at a fair share of the budget among
+// the threads currently running parallel work, and OpenMP/MKL are told that
+// thread count for the duration of the region or task. Work is never delayed:
+// the calling thread always runs, so the budget can be exceeded by threads
+// that start parallel work concurrently, but helpers are not added then.
+
+// Sets the thread budget; 0 disables it. Defaults to the TORCH_THREAD_BUDGET
+// environment variable, or 0 if it is not set.
+CAFFE2_API void set_thread_budget(int nthreads);
+
+// Returns the thread budget, or 0 if none is set
+CAFFE2_API int get_thread_budget();
+
+namespace internal {
+
+// Accounts the calling thread against the thread budget (unless an enclosing
+// guard on this thread already does) and reserves up to max_helpers helper
+// threads for it until destruction. See Note [Thread budget].
+class CAFFE2_API ThreadBudgetGuard {
+ public:
+  explicit ThreadBudgetGuard(int max_helpers);
+  ~ThreadBudgetGuard();
+
+  ThreadBudgetGuard(const ThreadBudgetGuard&) = delete;
+  ThreadBudgetGuard& operator=(const ThreadBudgetGuard&) = delete;
+
+  // Number of helper threads the caller may use; max_helpers if no budget
+  // is set.
+  int helpers() const {
+    return helpers_;
+  }
+
+ private:
+  bool active_ = false;
+  bool owns_caller_ = false;
+  int helpers_;
+  int prev_omp_threads_ = -1;
+  int prev_mkl_threads_ = -1;
+};
+
+} // namespace internal
+
 } // namespace at
 
 #if AT_PARALLEL_OPENMP
@@ -4,6 +4,8 @@
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <thread>
 
@@ -40,8 +42,100 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+// See Note [Thread budget]
+std::atomic<int>& thread_budget() {
+  static std::atomic<int> budget{
+      static_cast<int>(get_env_num_threads("TORCH_THREAD_BUDGET", 0))};
+  return budget;
+}
+// Threads currently accounted against the budget, callers and helpers
+std::atomic<int> budget_in_use{0};
+// Threads currently accounted as callers, i.e. running a parallel region or
+// an inter-op task
+std::atomic<int> budget_callers{0};
+thread_local bool budget_holds_caller = false;
+
 } // namespace
 
+void set_thread_budget(int nthreads) {
+  TORCH_CHECK(nthreads >= 0, "Expected non-negative thread budget");
+  thread_budget().store(nthreads);
+}
+
+int get_thread_budget() {
+  return thread_budget().load();
+}
+
+namespace internal {
+
+ThreadBudgetGuard::ThreadBudgetGuard(int max_helpers)
+    : helpers_(max_helpers) {
+  const int budget = thread_budget().load(std::memory_order_relaxed);
+  if (budget <= 0) {
+    return;
+  }
+  active_ = true;
+  if (!budget_holds_caller) {
+    budget_holds_caller = true;
+    owns_caller_ = true;
+    ++budget_in_use;
+    ++budget_callers;
+  }
+
+  // Each caller may use a fair share of the budget, itself included.
+  const int share = std::max(1, budget / std::max(1, budget_callers.load()));
+  int wanted = std::min(max_helpers, share - 1);
+  helpers_ = 0;
+  int in_use = budget_in_use.load();
+  while (wanted > 0) {
+    int granted = std::min(wanted, budget - in_use);
+    if (granted <= 0) {
+      break;
+    }
+    if (budget_in_use.compare_exchange_weak(in_use, in_use + granted)) {
+      helpers_ = granted;
+      break;
+    }
+  }
+
+#if AT_PARALLEL_OPENMP
+  // Parallel regions run on 1 + helpers threads; a guard without helpers
+  // (an inter-op task) lets OpenMP and MKL calls inside it use its share.
+  // Never raises the thread count that was set before.
+  int nthreads = max_helpers > 0 ? 1 + helpers_ : share;
+#ifdef _OPENMP
+  prev_omp_threads_ = omp_get_max_threads();
+  nthreads = std::min(nthreads, prev_omp_threads_);
+  omp_set_num_threads(nthreads);
+#endif
+#if defined(TH_BLAS_MKL) && !defined(TH_BLAS_MKL_SEQ)
+  prev_mkl_threads_ = mkl_set_num_threads_local(nthreads);
+#endif
+#endif // AT_PARALLEL_OPENMP
+}
+
+ThreadBudgetGuard::~ThreadBudgetGuard() {
+  if (!active_) {
+    return;
+  }
+#if AT_PARALLEL_OPENMP
+#ifdef _OPENMP
+  omp_set_num_threads(prev_omp_threads_);
+#endif
+#if defined(TH_BLAS_MKL) && !defined(TH_BLAS_MKL_SEQ)
+  mkl_set_num_threads_local(prev_mkl_threads_);
+#endif
+#endif // AT_PARALLEL_OPENMP
+  budget_in_use -= helpers_;
+  if (owns_caller_) {
+    --budget_in_use;
+    --budget_callers;
+    budget_holds_caller = false;
+  }
+}
+
+} // namespace internal
+
 std::string get_parallel_info() {
   std::ostringstream ss;
 
@@ -49,6 +143,8 @@ std::string get_parallel_info() {
      << at::get_num_threads() << std::endl;
   ss << "\tat::get_num_interop_threads() : "
      << at::get_num_interop_threads() << std::endl;
+  ss << "\tat::get_thread_budget() : "
+     << at::get_thread_budget() << std::endl;
 
   ss << at::get_openmp_version() << std::endl;
 #ifdef _OPENMP
@@ -70,6 +166,8 @@ std::string get_parallel_info() {
      << get_env_var("OMP_NUM_THREADS", "[not set]") << std::endl;
   ss << "\tMKL_NUM_THREADS : "
      << get_env_var("MKL_NUM_THREADS", "[not set]") << std::endl;
+  ss << "\tTORCH_THREAD_BUDGET : "
+     << get_env_var("TORCH_THREAD_BUDGET", "[not set]") << std::endl;
 
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
@@ -5,11 +5,18 @@
 
 #ifndef C10_MOBILE
 #include <c10/core/thread_pool.h>
-#else
-#include <caffe2/utils/threadpool/pthreadpool-cpp.h>
 #endif // C10_MOBILE
+#ifdef USE_PTHREADPOOL
+#include <caffe2/utils/threadpool/pthreadpool-cpp.h>
+#endif // USE_PTHREADPOOL
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -77,16 +84,10 @@ TaskThreadPoolBase& _get_intraop_pool() {
 
 #endif // C10_MOBILE
 
+#ifdef C10_MOBILE
 // Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
-#ifndef C10_MOBILE
-  for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
-  }
-  // Run the first task on the current thread directly.
-  fn(0, 0);
-#else
   caffe2::PThreadPool* const pool = caffe2::pthreadpool();
   TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!");
 
@@ -96,22 +97,126 @@ void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
     [&fn](const size_t task_id) {
       fn(0 /* unused */, task_id);
     }, range);
-#endif // C10_MOBILE
 }
+#endif // C10_MOBILE
 
 // RAII guard helps to support in_parallel_region() and get_thread_num() API.
+// Restores the previous values on exit, so that a thread running a nested
+// parallel region keeps its thread number in the enclosing one.
 struct ParallelRegionGuard {
-  ParallelRegionGuard(int64_t task_id) {
-    _set_thread_num(task_id);
+  ParallelRegionGuard(int64_t thread_num)
+    : prev_thread_num_(thread_num_),
+      prev_in_parallel_region_(in_parallel_region_) {
+    _set_thread_num(thread_num);
     _set_in_parallel_region(true);
   }
 
   ~ParallelRegionGuard() {
-    _set_in_parallel_region(false);
-    _unset_thread_num();
+    _set_in_parallel_region(prev_in_parallel_region_);
+    _set_thread_num(prev_thread_num_);
+  }
+
+ private:
+  size_t prev_thread_num_;
+  bool prev_in_parallel_region_;
+};
+
+#ifndef C10_MOBILE
+
+// State shared by the participants of one _parallel_run call.
+//
+// The chunks [0, num_tasks) are split into one contiguous block per
+// participant. A participant takes chunks from the front of its own block and,
+// once that is empty, steals chunks one at a time from the back of the other
+// blocks. Uneven per-chunk costs are therefore balanced across threads without
+// a shared queue, while each thread still walks mostly contiguous memory.
+//
+// Held by shared_ptr: pool tasks may only start after the caller has finished
+// every chunk itself and returned; they then find no work and exit.
+struct ParallelRunState {
+  ParallelRunState(size_t num_participants, size_t num_tasks)
+    : ranges(num_participants), remaining(num_tasks) {
+    // Every participant gets num_tasks / num_participants chunks; the first
+    // num_tasks % num_participants get one more.
+    size_t base = num_tasks / num_participants;
+    size_t extra = num_tasks % num_participants;
+    size_t lo = 0;
+    for (size_t p = 0; p < num_participants; ++p) {
+      size_t hi = lo + base + (p < extra ? 1 : 0);
+      ranges[p].store(pack(lo, hi));
+      lo = hi;
+    }
+  }
+
+  // Claims the next chunk for participant p; returns false once every block
+  // is empty.
+  bool next_chunk(size_t p, size_t& chunk) {
+    if (pop_front(p, chunk)) {
+      return true;
+    }
+    for (size_t i = 1; i < ranges.size(); ++i) {
+      if (steal_back((p + i) % ranges.size(), chunk)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void finish_chunk() {
+    if (--remaining == 0) {
+      std::lock_guard<std::mutex> lk(mutex);
+      cv.notify_one();
+    }
+  }
+
+  // Each block is a [lo, hi) range packed into one word, so that the owner
+  // and thieves claim chunks with a single compare-and-swap.
+  std::vector<std::atomic<uint64_t>> ranges;
+  std::atomic<size_t> remaining;
+
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+  std::mutex mutex;
+  std::condition_variable cv;
+
+ private:
+  static uint64_t pack(size_t lo, size_t hi) {
+    return (static_cast<uint64_t>(lo) << 32) | static_cast<uint64_t>(hi);
+  }
+  static size_t lo_of(uint64_t range) {
+    return static_cast<size_t>(range >> 32);
+  }
+  static size_t hi_of(uint64_t range) {
+    return static_cast<size_t>(range & 0xffffffff);
+  }
+
+  bool pop_front(size_t p, size_t& chunk) {
+    uint64_t range = ranges[p].load();
+    while (lo_of(range) < hi_of(range)) {
+      if (ranges[p].compare_exchange_weak(
+              range, pack(lo_of(range) + 1, hi_of(range)))) {
+        chunk = lo_of(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool steal_back(size_t victim, size_t& chunk) {
+    uint64_t range = ranges[victim].load();
+    while (lo_of(range) < hi_of(range)) {
+      if (ranges[victim].compare_exchange_weak(
+              range, pack(lo_of(range), hi_of(range) - 1))) {
+        chunk = hi_of(range) - 1;
+        return true;
+      }
+    }
+    return false;
   }
 };
 
+#endif // C10_MOBILE
+
 } // namespace
 
 namespace internal {
@@ -127,6 +232,53 @@ void _parallel_run(
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
 
+#ifndef C10_MOBILE
+  // Inside a parallel region only idle pool threads can help; the caller
+  // runs everything else itself.
+  size_t num_helpers = in_parallel_region()
+      ? _get_intraop_pool().numAvailable()
+      : _get_intraop_pool().size();
+  ThreadBudgetGuard budget(static_cast<int>(std::min(num_helpers, num_tasks - 1)));
+  size_t num_participants = std::min(
+      num_tasks, static_cast<size_t>(budget.helpers()) + 1);
+  TORCH_INTERNAL_ASSERT(
+      num_tasks <= std::numeric_limits<uint32_t>::max(),
+      "Too many parallel tasks: ", num_tasks);
+
+  auto state = std::make_shared<ParallelRunState>(num_participants, num_tasks);
+
+  auto participant = [f, state, begin, end, chunk_size](size_t p) {
+    ParallelRegionGuard guard(p);
+    size_t task_id;
+    while (state->next_chunk(p, task_id)) {
+      int64_t local_start = begin + task_id * chunk_size;
+      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+      try {
+        f(local_start, local_end, task_id);
+      } catch (...) {
+        if (!state->err_flag.test_and_set()) {
+          state->eptr = std::current_exception();
+        }
+      }
+      state->finish_chunk();
+    }
+  };
+
+  for (size_t p = 1; p < num_participants; ++p) {
+    _get_intraop_pool().run([participant, p]() { participant(p); });
+  }
+  // The caller is participant 0, and steals from the others once done.
+  participant(0);
+
+  // Wait for chunks other threads claimed but have not finished yet.
+  {
+    std::unique_lock<std::mutex> lk(state->mutex);
+    state->cv.wait(lk, [&state]() { return state->remaining == 0; });
+  }
+  if (state->eptr) {
+    std::rethrow_exception(state->eptr);
+  }
+#else
   struct {
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
@@ -169,6 +321,16 @@ void _parallel_run(
   if (state.eptr) {
     std::rethrow_exception(state.eptr);
   }
+#endif // C10_MOBILE
+}
+
+bool _nested_parallelism_available() {
+#ifndef C10_MOBILE
+  return num_intraop_threads.load() == CONSUMED &&
+      _get_intraop_pool().numAvailable() > 0;
+#else
+  return false;
+#endif // C10_MOBILE
 }
 
 } // namespace internal
@@ -206,6 +368,11 @@ void set_num_threads(int nthreads) {
         "when using native parallel backend");
     }
   }
+#ifdef USE_PTHREADPOOL
+  // XNNPACK and NNPACK run on caffe2's pthreadpool, which must not take more
+  // cores than the intra-op pool
+  caffe2::pthreadpool()->set_thread_count(nthreads);
+#endif // USE_PTHREADPOOL
 #else
   caffe2::PThreadPool* const pool = caffe2::pthreadpool();
   TORCH_INTERNAL_ASSERT(pool, "Invalid thread pool!");
@@ -9,25 +9,42 @@
 namespace at {
 namespace internal {
 
+// Number of chunks _parallel_run aims to create per thread. Having more
+// chunks than threads lets idle threads steal work from stragglers when the
+// cost per element is uneven. The mobile pthreadpool runs one chunk per task
+// and uses the chunk index as the thread number, so it keeps one per thread.
+#ifndef C10_MOBILE
+constexpr int64_t CHUNKS_PER_THREAD = 4;
+#else
+constexpr int64_t CHUNKS_PER_THREAD = 1;
+#endif
+
 inline std::tuple<size_t, size_t> calc_num_tasks_and_chunk_size(
     int64_t begin, int64_t end, int64_t grain_size) {
   if ((end - begin) < grain_size) {
     return std::make_tuple(1, std::max((int64_t)0, end - begin));
   }
   // Choose number of tasks based on grain size and number of threads.
-  size_t chunk_size = divup((end - begin), get_num_threads());
+  size_t chunk_size = divup((end - begin), get_num_threads() * CHUNKS_PER_THREAD);
   // Make sure each task is at least grain_size size.
   chunk_size = std::max((size_t)grain_size, chunk_size);
   size_t num_tasks = divup((end - begin), chunk_size);
   return std::make_tuple(num_tasks, chunk_size);
 }
 
+// Runs f over [begin, end) split into the chunks given by
+// calc_num_tasks_and_chunk_size. f receives the chunk bounds and the chunk
+// index; get_thread_num() inside f identifies the participating thread.
 CAFFE2_API void _parallel_run(
   const int64_t begin,
   const int64_t end,
   const int64_t grain_size,
   const std::function<void(int64_t, int64_t, size_t)>& f);
 
+// Whether a parallel_for called from inside a parallel region can be shared
+// with idle pool threads instead of running inline.
+CAFFE2_API bool _nested_parallelism_available();
+
 } // namespace internal
 
 template <class F>
@@ -40,7 +57,8 @@ inline void parallel_for(
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size ||
+      (in_parallel_region() && !internal::_nested_parallelism_available())) {
     f(begin, end);
     return;
   }
@@ -66,7 +84,8 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size ||
+      (in_parallel_region() && !internal::_nested_parallelism_available())) {
     return f(begin, end, ident);
   }
   size_t num_tasks, chunk_size;
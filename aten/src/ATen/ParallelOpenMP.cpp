@@ -8,6 +8,10 @@
 #include <mkl.h>
 #endif
 
+#ifdef USE_PTHREADPOOL
+#include <caffe2/utils/threadpool/pthreadpool-cpp.h>
+#endif
+
 namespace at {
 
 namespace {
@@ -49,6 +53,11 @@ void set_num_threads(int nthreads) {
   // See https://github.com/pytorch/pytorch/issues/13757
   mkl_set_dynamic(false);
 #endif
+#ifdef USE_PTHREADPOOL
+  // XNNPACK and NNPACK run on caffe2's pthreadpool, which must not take more
+  // cores than the OpenMP pool
+  caffe2::pthreadpool()->set_thread_count(nthreads);
+#endif
 }
 
 // Explicitly calling omp_get_max_threads() as the size of the parallel
@@ -24,6 +24,12 @@ inline void parallel_for(
     return;
   }
 #ifdef _OPENMP
+  // Caps the size of the parallel region below; see Note [Thread budget].
+  // Nested calls run inline and need no budget.
+  c10::optional<internal::ThreadBudgetGuard> budget;
+  if (!omp_in_parallel()) {
+    budget.emplace(omp_get_max_threads() - 1);
+  }
   std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
   std::exception_ptr eptr;
   // Work around memory leak when using 1 thread in nested "omp parallel"
@@ -81,6 +87,10 @@ inline scalar_t parallel_reduce(
     scalar_t* results_data = results.data();
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
+#ifdef _OPENMP
+    // Caps the size of the parallel region below; see Note [Thread budget].
+    internal::ThreadBudgetGuard budget(omp_get_max_threads() - 1);
+#endif
 #pragma omp parallel for if ((end - begin) >= grain_size)
     for (int64_t id = 0; id < num_results; id++) {
       int64_t i = begin + id * grain_size;
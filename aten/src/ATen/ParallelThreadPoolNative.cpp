@@ -73,7 +73,12 @@ void launch_no_thread_state(std::function<void()> fn) {
 #if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
   intraop_launch(std::move(fn));
 #else
-  get_pool().run(std::move(fn));
+  get_pool().run([fn]() {
+    // A running inter-op task counts against the thread budget, which
+    // limits the helpers its parallel regions can get.
+    ThreadBudgetGuard budget(/* max_helpers */ 0);
+    fn();
+  });
 #endif
 }
 } // namespace internal
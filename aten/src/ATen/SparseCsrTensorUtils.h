@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+
+#include <limits>
+
+namespace at { namespace sparse_csr {
+
+// Just for documentary purposes
+using SparseCsrTensor = Tensor;
+
+// This is an internal utility function for getting at the SparseCsrTensorImpl,
+// so that we can write sparse CSR tensor specific accessors for special fields
+// in SparseCsrTensor.  You should only use this for writing low level
+// setters/getters for SparseCsrTensorImpl fields; otherwise, you should use
+// the low level setters/getters that were implemented using this.
+//
+// This may be called repeatedly, so make sure it's pretty cheap.
+inline SparseCsrTensorImpl* get_sparse_csr_impl(const SparseCsrTensor& self) {
+  TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
+  AT_ASSERTM(self.is_sparse_csr(), "_internal_get_SparseCsrTensorImpl: not a sparse CSR tensor");
+  return static_cast<SparseCsrTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+// The dtype of the indices the conversions to CSR produce: int32 if the
+// indices of a rows x cols matrix with nnz elements fit it, which is what the
+// sparse BLAS libraries take, and int64 otherwise.
+inline ScalarType csr_index_dtype(int64_t rows, int64_t cols, int64_t nnz) {
+  constexpr int64_t int_max = std::numeric_limits<int32_t>::max();
+  return rows < int_max && cols <= int_max && nnz <= int_max ? kInt : kLong;
+}
+
+}} // namespace at::sparse_csr
@@ -5,9 +5,13 @@ namespace autocast {
 
 TORCH_API bool is_enabled();
 TORCH_API void set_enabled(bool enabled);
+TORCH_API bool is_cpu_enabled();
+TORCH_API void set_cpu_enabled(bool enabled);
 TORCH_API void clear_cache();
 TORCH_API int increment_nesting();
 TORCH_API int decrement_nesting();
+TORCH_API bool is_cache_persistent();
+TORCH_API void set_cache_persistent(bool persistent);
 
 } // namespace autocast
 } // namespace at
@@ -0,0 +1,299 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <benchmark/benchmark.h>
+
+// Micro-benchmarks of the core ATen operators, called straight from C++ so
+// that the numbers don't include the overhead of the Python bindings.
+//
+// Every benchmark takes its sizes as its first arguments, then the dtype, the
+// memory format for the 4-d inputs, and the number of intra-op threads. The
+// results of two builds can be compared with the tools of google-benchmark:
+//
+//   ./aten_ops_benchmark --benchmark_out=base.json --benchmark_out_format=json
+//   ./aten_ops_benchmark --benchmark_out=new.json --benchmark_out_format=json
+//   third_party/benchmark/tools/compare.py benchmarks base.json new.json
+
+namespace {
+
+const std::vector<int64_t> kThreads = {1, 4};
+
+int64_t dtypeArg(at::ScalarType dtype) {
+  return static_cast<int64_t>(dtype);
+}
+
+// Applies the dtype (argument dtype_index), memory format (argument
+// dtype_index + 1, for the benchmarks of 4-d inputs) and number of threads
+// (last argument) of a benchmark, and labels it with them
+struct BenchmarkArgs {
+  BenchmarkArgs(benchmark::State& state, int dtype_index, bool has_memory_format)
+      : dtype(static_cast<at::ScalarType>(state.range(dtype_index))),
+        memory_format(
+            has_memory_format && state.range(dtype_index + 1)
+                ? at::MemoryFormat::ChannelsLast
+                : at::MemoryFormat::Contiguous) {
+    int64_t num_threads = state.range(dtype_index + (has_memory_format ? 2 : 1));
+    at::set_num_threads(num_threads);
+    std::string label = c10::toString(dtype);
+    if (has_memory_format) {
+      label += memory_format == at::MemoryFormat::ChannelsLast
+          ? "/channels_last"
+          : "/contiguous";
+    }
+    state.SetLabel(label + "/threads:" + std::to_string(num_threads));
+  }
+
+  at::TensorOptions options() const {
+    return at::TensorOptions(dtype);
+  }
+
+  at::Tensor rand(at::IntArrayRef sizes) const {
+    at::Tensor t = at::isIntegralType(dtype, /*includeBool=*/false)
+        ? at::randint(-100, 100, sizes, options())
+        : at::rand(sizes, options());
+    return sizes.size() == 4 ? t.contiguous(memory_format) : t;
+  }
+
+  at::ScalarType dtype;
+  at::MemoryFormat memory_format;
+};
+
+void setProcessed(benchmark::State& state, const at::Tensor& t, int64_t num_tensors) {
+  state.SetItemsProcessed(state.iterations() * t.numel());
+  state.SetBytesProcessed(
+      state.iterations() * num_tensors * t.numel() * t.element_size());
+}
+
+// Elementwise and reduction benchmarks of N x C inputs
+void sizesArgs(
+    benchmark::internal::Benchmark* b,
+    const std::vector<at::ScalarType>& dtypes) {
+  b->ArgNames({"N", "C", "dtype", "threads"});
+  for (int64_t n : {64, 1024}) {
+    for (int64_t c : {64, 1024}) {
+      for (auto dtype : dtypes) {
+        for (int64_t threads : kThreads) {
+          b->Args({n, c, dtypeArg(dtype), threads});
+        }
+      }
+    }
+  }
+}
+
+void floatingSizesArgs(benchmark::internal::Benchmark* b) {
+  sizesArgs(b, {at::kFloat, at::kDouble});
+}
+
+void allSizesArgs(benchmark::internal::Benchmark* b) {
+  sizesArgs(b, {at::kFloat, at::kDouble, at::kLong});
+}
+
+// Benchmarks of N x C x H x W inputs
+void imageArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "HW", "dtype", "channels_last", "threads"});
+  for (int64_t n : {1, 16}) {
+    for (int64_t c : {3, 64}) {
+      for (int64_t hw : {56, 112}) {
+        for (int64_t channels_last : {0, 1}) {
+          for (int64_t threads : kThreads) {
+            b->Args({n, c, hw, dtypeArg(at::kFloat), channels_last, threads});
+          }
+        }
+      }
+    }
+  }
+}
+
+// Matrix multiplications of M x K and K x N matrices
+void matmulArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "K", "N", "dtype", "threads"});
+  for (int64_t size : {64, 256, 1024}) {
+    for (auto dtype : {at::kFloat, at::kDouble}) {
+      for (int64_t threads : kThreads) {
+        b->Args({size, size, size, dtypeArg(dtype), threads});
+      }
+    }
+  }
+  // Linear layers of small batches
+  for (int64_t m : {1, 16}) {
+    for (int64_t threads : kThreads) {
+      b->Args({m, 1024, 1024, dtypeArg(at::kFloat), threads});
+    }
+  }
+}
+
+void add(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  at::Tensor b = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  setProcessed(state, a, 3);
+}
+
+void mul_out(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  at::Tensor b = args.rand({state.range(0), state.range(1)});
+  at::Tensor out = at::empty_like(a);
+  for (auto _ : state) {
+    at::mul_out(out, a, b);
+  }
+  setProcessed(state, a, 3);
+}
+
+void relu(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::relu(a));
+  }
+  setProcessed(state, a, 2);
+}
+
+void sigmoid(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::sigmoid(a));
+  }
+  setProcessed(state, a, 2);
+}
+
+void sum(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.sum());
+  }
+  setProcessed(state, a, 1);
+}
+
+void sum_dim(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.sum(0));
+  }
+  setProcessed(state, a, 1);
+}
+
+void softmax(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::softmax(a, 1));
+  }
+  setProcessed(state, a, 2);
+}
+
+void cat(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  at::Tensor b = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::cat({a, b}, 1));
+  }
+  setProcessed(state, a, 4);
+}
+
+void transpose_contiguous(benchmark::State& state) {
+  BenchmarkArgs args(state, 2, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.t().contiguous());
+  }
+  setProcessed(state, a, 2);
+}
+
+void mm(benchmark::State& state) {
+  BenchmarkArgs args(state, 3, false);
+  at::Tensor a = args.rand({state.range(0), state.range(1)});
+  at::Tensor b = args.rand({state.range(1), state.range(2)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::mm(a, b));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * 2 * state.range(0) * state.range(1) * state.range(2));
+}
+
+void linear(benchmark::State& state) {
+  BenchmarkArgs args(state, 3, false);
+  at::Tensor input = args.rand({state.range(0), state.range(1)});
+  at::Tensor weight = args.rand({state.range(2), state.range(1)});
+  at::Tensor bias = args.rand({state.range(2)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::linear(input, weight, bias));
+  }
+  state.SetItemsProcessed(
+      state.iterations() * 2 * state.range(0) * state.range(1) * state.range(2));
+}
+
+void conv2d(benchmark::State& state) {
+  BenchmarkArgs args(state, 3, true);
+  const int64_t c = state.range(1);
+  at::Tensor input = args.rand({state.range(0), c, state.range(2), state.range(2)});
+  at::Tensor weight = args.rand({64, c, 3, 3});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::conv2d(input, weight, {}, 1, 1));
+  }
+  setProcessed(state, input, 2);
+}
+
+void max_pool2d(benchmark::State& state) {
+  BenchmarkArgs args(state, 3, true);
+  at::Tensor input = args.rand(
+      {state.range(0), state.range(1), state.range(2), state.range(2)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::max_pool2d(input, {2, 2}));
+  }
+  setProcessed(state, input, 1);
+}
+
+void batch_norm(benchmark::State& state) {
+  BenchmarkArgs args(state, 3, true);
+  const int64_t c = state.range(1);
+  at::Tensor input = args.rand({state.range(0), c, state.range(2), state.range(2)});
+  at::Tensor weight = args.rand({c});
+  at::Tensor bias = args.rand({c});
+  at::Tensor mean = args.rand({c});
+  at::Tensor var = args.rand({c});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::batch_norm(
+        input, weight, bias, mean, var, /*training=*/false, 0.1, 1e-5,
+        /*cudnn_enabled=*/false));
+  }
+  setProcessed(state, input, 2);
+}
+
+void add_4d(benchmark::State& state) {
+  BenchmarkArgs args(state, 3, true);
+  at::Tensor a = args.rand(
+      {state.range(0), state.range(1), state.range(2), state.range(2)});
+  at::Tensor b = args.rand(
+      {state.range(0), state.range(1), state.range(2), state.range(2)});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  setProcessed(state, a, 3);
+}
+
+} // namespace
+
+BENCHMARK(add)->Apply(allSizesArgs);
+BENCHMARK(mul_out)->Apply(allSizesArgs);
+BENCHMARK(relu)->Apply(allSizesArgs);
+BENCHMARK(sigmoid)->Apply(floatingSizesArgs);
+BENCHMARK(sum)->Apply(allSizesArgs);
+BENCHMARK(sum_dim)->Apply(allSizesArgs);
+BENCHMARK(softmax)->Apply(floatingSizesArgs);
+BENCHMARK(cat)->Apply(allSizesArgs);
+BENCHMARK(transpose_contiguous)->Apply(allSizesArgs);
+BENCHMARK(mm)->Apply(matmulArgs);
+BENCHMARK(linear)->Apply(matmulArgs);
+BENCHMARK(conv2d)->Apply(imageArgs);
+BENCHMARK(max_pool2d)->Apply(imageArgs);
+BENCHMARK(batch_norm)->Apply(imageArgs);
+BENCHMARK(add_4d)->Apply(imageArgs);
+BENCHMARK_MAIN();
@@ -43,14 +43,7 @@ namespace at {
 // trace).  To unify the two, we would first have to move profiling and tracing
 // out of VariableType.
 
-// TODO centralize this as part of dispatch key revamp
-static DispatchKeySet autograd_dispatch_keys{
-  DispatchKey::Autograd,
-  DispatchKey::XLAPreAutograd,
-  DispatchKey::PrivateUse1_PreAutograd,
-  DispatchKey::PrivateUse2_PreAutograd,
-  DispatchKey::PrivateUse3_PreAutograd,
-};
+static DispatchKeySet autograd_dispatch_keys = c10::autograd_dispatch_keyset();
 
 struct CAFFE2_API AutoNonVariableTypeMode {
   // NB: The enabled parameter must ALWAYS be black, as Henry Ford used to say.
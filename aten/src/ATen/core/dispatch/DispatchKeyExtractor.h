@@ -85,6 +85,55 @@ namespace detail {
   DispatchKeySet multi_dispatch_key_set(const Args&... args) {
     return MultiDispatchKeySet().apply(args...).ts;
   }
+
+  // Whether any of the tensor arguments requires grad.  Only meaningful for
+  // operators whose arguments are all either tensors, tensor lists or types
+  // that can't hold tensors, see OperatorEntry::hasAutogradFastPath().
+  struct AnyRequiresGrad : at::IterArgs<AnyRequiresGrad> {
+    bool out = false;
+    void operator()(const at::Tensor& x) {
+      out = out || x.requires_grad();
+    }
+    void operator()(at::ArrayRef<at::Tensor> xs) {
+      for (const auto& x : xs) {
+        out = out || x.requires_grad();
+      }
+    }
+    void operator()(const c10::optional<at::Tensor>& x) {
+      out = out || (x.has_value() && x->requires_grad());
+    }
+    template <typename T>
+    void operator()(const T& x) {
+      // do nothing
+    }
+    bool short_circuit() const {
+      return out;
+    }
+  };
+
+  template <typename... Args>
+  bool any_requires_grad(const Args&... args) {
+    return AnyRequiresGrad().apply(args...).out;
+  }
+
+  // Like any_requires_grad, for the last num_args values on the stack
+  inline bool any_requires_grad_boxed(const torch::jit::Stack& stack, size_t num_args) {
+    for (size_t i = 0; i < num_args; ++i) {
+      const auto& ivalue = torch::jit::peek(stack, i, num_args);
+      if (ivalue.isTensor()) {
+        if (ivalue.unsafeToTensorImpl()->requires_grad()) {
+          return true;
+        }
+      } else if (ivalue.isTensorList()) {
+        for (const at::Tensor tensor : ivalue.toTensorList()) {
+          if (tensor.requires_grad()) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
 }
 
 /**
@@ -119,6 +168,11 @@ public:
   }
 
   DispatchKey getDispatchKeyBoxed(const torch::jit::Stack* stack) const {
+    return getDispatchKeyForKeySet(DispatchKeySet::FULL, getDispatchKeySetBoxed(stack));
+  }
+
+  // The union of the key sets of the tensor arguments on the stack.
+  DispatchKeySet getDispatchKeySetBoxed(const torch::jit::Stack* stack) const {
     DispatchKeySet ks;
     dispatch_arg_indices_reverse_.for_each_set_bit([&] (size_t reverse_arg_index) {
       const auto& ivalue = torch::jit::peek(*stack, 0, reverse_arg_index + 1);
@@ -132,7 +186,7 @@ public:
         }
       }
     });
-    return dispatchKeySetToDispatchKey_(DispatchKeySet::FULL, ks);
+    return ks;
   }
 
   template<class... Args>
@@ -141,6 +195,12 @@ public:
     return dispatchKeySetToDispatchKey_(eligibleKeys, ks);
   }
 
+  // Like getDispatchKeyUnboxed, for arguments whose key sets were already
+  // combined into ks.
+  DispatchKey getDispatchKeyForKeySet(DispatchKeySet eligibleKeys, DispatchKeySet ks) const {
+    return dispatchKeySetToDispatchKey_(eligibleKeys, ks);
+  }
+
   void setOperatorHasFallthroughForKey(DispatchKey k, bool has_fallthrough);
 
   std::string dumpState() const;
@@ -3,6 +3,7 @@
 #include <ATen/SequenceNumber.h>
 #include <ATen/core/boxing/KernelFunction.h>
 #include <ATen/core/boxing/impl/boxing.h>
+#include <ATen/core/LegacyTypeDispatch.h>
 #include <ATen/core/dispatch/OperatorEntry.h>
 #include <ATen/core/dispatch/CppSignature.h>
 #include <ATen/core/dispatch/RegistrationHandleRAII.h>
@@ -137,6 +138,15 @@ public:
   // Invoke an operator via the boxed calling convention using an IValue stack
   void callBoxed(const OperatorHandle& op, Stack* stack) const;
 
+  // Enables or disables skipping the Autograd kernel in call and callBoxed,
+  // see Note [Autograd fast path].  Enabled by default.
+  void setAutogradFastPathEnabled(bool enabled) {
+    autograd_fast_path_enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool isAutogradFastPathEnabled() const {
+    return autograd_fast_path_enabled_.load(std::memory_order_relaxed);
+  }
+
   // ------------------------------------------------------------------------
   //
   // Performing registrations (NON user public; use op_registration)
@@ -214,6 +224,20 @@ public:
 private:
   Dispatcher();
 
+  void callBoxedWithDispatchKey_(const OperatorHandle& op, DispatchKey dispatchKey, Stack* stack) const;
+
+  // Called by callWithDispatchKey when RecordFunction callbacks may run,
+  // kept out of line so that the common path stays small
+  // Whether a call with arguments of key set ks that was dispatched to
+  // Autograd may go straight to the backend if it records no graph,
+  // see Note [Autograd fast path]
+  bool mayUseAutogradFastPath(const impl::OperatorEntry& entry, DispatchKeySet ks) const {
+    return ks == DispatchKeySet(DispatchKey::CPU) && entry.hasAutogradFastPath() && isAutogradFastPathEnabled();
+  }
+
+  template<class Return, class... Args>
+  C10_NOINLINE Return callWithDispatchKeySlowPath(const TypedOperatorHandle<Return (Args...)>& op, bool pre_sampled, DispatchKey dispatchKey, const KernelFunction& kernel, Args... args) const;
+
   OperatorHandle findOrRegisterSchema_(FunctionSchema&& schema);
   OperatorHandle findOrRegisterName_(const OperatorName& op_name);
 
@@ -238,6 +262,7 @@ private:
 
   std::unique_ptr<detail::RegistrationListenerList> listeners_;
   std::mutex mutex_;
+  std::atomic<bool> autograd_fast_path_enabled_{true};
 };
 
 /**
@@ -338,18 +363,14 @@ template<class... Args> inline void unused_arg_(const Args&...) {}
 }
 
 template<class Return, class... Args>
-inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, Args... args) const {
-  detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
-  const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
-
-#ifndef PYTORCH_DISABLE_PER_OP_PROFILING
+Return Dispatcher::callWithDispatchKeySlowPath(const TypedOperatorHandle<Return(Args...)>& op, bool pre_sampled, DispatchKey dispatchKey, const KernelFunction& kernel, Args... args) const {
   // Check if we need to run callbacks registered with RecordFunction
   // If true and callbacks need inputs, we box the arguments and pass
   // them into the callbacks and also into the kernel call
 
   // Note: for perf reasons we wouldn't want to pass arguments into
   // the function call or prematurely box them
-  at::RecordFunction guard(at::RecordScope::FUNCTION);
+  at::RecordFunction guard(at::RecordScope::FUNCTION, pre_sampled);
   if (C10_UNLIKELY(guard.active)) {
     if (shouldRecord(dispatchKey) && op.operatorIterator_->op.isObserved()) {
       int64_t seq_num = -1;
@@ -358,6 +379,7 @@ inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(A
       if (dispatchKey == DispatchKey::Autograd && at::GradMode::is_enabled()) {
         seq_num = at::sequence_number::peek();
       }
+      guard.setDispatchKey(dispatchKey);
       if (guard.needs_inputs) {
         torch::jit::Stack stack = impl::BoxedKernelWrapper<Return(Args...)>::boxArgs(args...);
         guard.before(op.schema().name(), stack, seq_num);
@@ -366,6 +388,19 @@ inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(A
       }
     }
   }
+  return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
+}
+
+template<class Return, class... Args>
+inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(Args...)>& op, DispatchKey dispatchKey, Args... args) const {
+  detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
+  const KernelFunction& kernel = op.operatorIterator_->op.lookup(dispatchKey);
+
+#ifndef PYTORCH_DISABLE_PER_OP_PROFILING
+  bool pre_sampled = false;
+  if (C10_UNLIKELY(at::shouldRunRecordFunction(&pre_sampled))) {
+    return callWithDispatchKeySlowPath<Return, Args...>(op, pre_sampled, dispatchKey, kernel, std::forward<Args>(args)...);
+  }
 #endif  // PYTORCH_DISABLE_PER_OP_PROFILING
   return kernel.template call<Return, Args...>(op, std::forward<Args>(args)...);
 }
@@ -373,11 +408,16 @@ inline Return Dispatcher::callWithDispatchKey(const TypedOperatorHandle<Return(A
 template<class Return, class... Args>
 inline Return Dispatcher::call(const TypedOperatorHandle<Return(Args...)>& op, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
-  auto dispatchKey = op.operatorIterator_->op.dispatchKeyExtractor()
-    .template getDispatchKeyUnboxed<Args...>(
-      DispatchKeySet::FULL,
-      args...
-    );
+  const auto& entry = op.operatorIterator_->op;
+  auto ks = detail::multi_dispatch_key_set(args...);
+  auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyForKeySet(DispatchKeySet::FULL, ks);
+  if (dispatchKey == DispatchKey::Autograd && mayUseAutogradFastPath(entry, ks) &&
+      !(at::GradMode::is_enabled() && detail::any_requires_grad(args...))) {
+    // See Note [Autograd fast path]
+    at::AutoNonVariableTypeMode non_var_type_mode(true);
+    dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyForKeySet(DispatchKeySet::FULL, ks);
+    return callWithDispatchKey<Return, Args...>(op, dispatchKey, args...);
+  }
   return callWithDispatchKey<Return, Args...>(op, dispatchKey, args...);
 }
 
@@ -397,24 +437,43 @@ inline Return Dispatcher::redispatch(const TypedOperatorHandle<Return (Args...)>
 inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
   const auto& entry = op.operatorIterator_->op;
-  auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyBoxed(stack);
+  auto ks = entry.dispatchKeyExtractor().getDispatchKeySetBoxed(stack);
+  auto dispatchKey = entry.dispatchKeyExtractor().getDispatchKeyForKeySet(DispatchKeySet::FULL, ks);
+  if (dispatchKey == DispatchKey::Autograd && mayUseAutogradFastPath(entry, ks) &&
+      !(at::GradMode::is_enabled() && detail::any_requires_grad_boxed(*stack, entry.schema().arguments().size()))) {
+    // See Note [Autograd fast path]
+    at::AutoNonVariableTypeMode non_var_type_mode(true);
+    callBoxedWithDispatchKey_(op, entry.dispatchKeyExtractor().getDispatchKeyForKeySet(DispatchKeySet::FULL, ks), stack);
+    return;
+  }
+  callBoxedWithDispatchKey_(op, dispatchKey, stack);
+}
+
+inline void Dispatcher::callBoxedWithDispatchKey_(const OperatorHandle& op, DispatchKey dispatchKey, Stack* stack) const {
+  const auto& entry = op.operatorIterator_->op;
   const auto& kernel = entry.lookup(dispatchKey);
 
 #ifndef PYTORCH_DISABLE_PER_OP_PROFILING
-  // using already existing stack to record function execution in observers
-  at::RecordFunction guard(at::RecordScope::FUNCTION);
-  if (C10_UNLIKELY(guard.active)) {
-    if (shouldRecord(dispatchKey) && entry.isObserved()) {
-      int64_t seq_num = -1;
-      if (dispatchKey == DispatchKey::Autograd && at::GradMode::is_enabled()) {
-        seq_num = at::sequence_number::peek();
-      }
-      if (guard.needs_inputs) {
-        guard.before(op.schema().name(), *stack, seq_num);
-      } else {
-        guard.before(op.schema().name(), seq_num);
+  bool pre_sampled = false;
+  if (C10_UNLIKELY(at::shouldRunRecordFunction(&pre_sampled))) {
+    // using already existing stack to record function execution in observers
+    at::RecordFunction guard(at::RecordScope::FUNCTION, pre_sampled);
+    if (C10_UNLIKELY(guard.active)) {
+      if (shouldRecord(dispatchKey) && entry.isObserved()) {
+        int64_t seq_num = -1;
+        if (dispatchKey == DispatchKey::Autograd && at::GradMode::is_enabled()) {
+          seq_num = at::sequence_number::peek();
+        }
+        guard.setDispatchKey(dispatchKey);
+        if (guard.needs_inputs) {
+          guard.before(op.schema().name(), *stack, seq_num);
+        } else {
+          guard.before(op.schema().name(), seq_num);
+        }
       }
     }
+    kernel.callBoxed(op, stack);
+    return;
   }
 #endif  // PYTORCH_DISABLE_PER_OP_PROFILING
   kernel.callBoxed(op, stack);
@@ -61,12 +61,14 @@ void OperatorEntry::registerSchema(FunctionSchema&& schema, std::string&& debug)
   // NB: don't register schema until after we've checked everything!
   dispatchKeyExtractor_.registerSchema(schema);
   schema_ = AnnotatedSchema(std::move(schema), std::move(debug));
+  updateAutogradFastPath_();
 }
 
 void OperatorEntry::deregisterSchema() {
   TORCH_INTERNAL_ASSERT(schema_.has_value());
   schema_ = c10::nullopt;
   dispatchKeyExtractor_.deregisterSchema();
+  updateAutogradFastPath_();
 }
 
 std::list<AnnotatedKernel>::iterator OperatorEntry::registerKernel(
@@ -182,6 +184,65 @@ void OperatorEntry::updateDispatchTable_(const c10::Dispatcher& dispatcher, Disp
   auto dispatch_ix = static_cast<uint8_t>(dispatch_key);
   dispatchTable_[dispatch_ix] = computeDispatchTableEntry(dispatcher, dispatch_key);
   dispatchKeyExtractor_.setOperatorHasFallthroughForKey(dispatch_key, dispatchTable_[dispatch_ix].isFallthrough());
+  if (dispatch_key == DispatchKey::Autograd || dispatch_key == DispatchKey::CPU) {
+    updateAutogradFastPath_();
+  }
+}
+
+namespace {
+  // Whether values of this type are known not to contain tensors
+  bool cannotHoldTensors(const TypePtr& type) {
+    switch (type->kind()) {
+      case TypeKind::IntType:
+      case TypeKind::FloatType:
+      case TypeKind::BoolType:
+      case TypeKind::NumberType:
+      case TypeKind::StringType:
+      case TypeKind::DeviceObjType:
+      case TypeKind::GeneratorType:
+      case TypeKind::NoneType:
+        return true;
+      case TypeKind::OptionalType:
+        return cannotHoldTensors(type->expect<OptionalType>()->getElementType());
+      case TypeKind::ListType:
+        return cannotHoldTensors(type->expect<ListType>()->getElementType());
+      default:
+        return false;
+    }
+  }
+} // anonymous namespace
+
+// Note [Autograd fast path]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// For an operator that neither mutates nor aliases its inputs, the Autograd
+// kernel of a call that doesn't record a graph (grad mode is off or no input
+// requires grad) only redispatches to the backend with autograd excluded.
+// Dispatcher::call and Dispatcher::callBoxed do that redispatch themselves
+// when all the tensor arguments are plain CPU tensors, which saves a
+// dispatch and the Autograd kernel's bookkeeping on every op of eager CPU
+// inference.  It is only done for operators with kernels registered for
+// both Autograd and CPU (catch-all kernels get their autograd support from
+// the operators they call, which may be views) and whose arguments can all
+// be checked for requires_grad.
+void OperatorEntry::updateAutogradFastPath_() {
+  autograd_fast_path_ = false;
+  if (!schema_.has_value() || schema_->schema.hasAnyAliasInfo() || schema_->schema.is_vararg()) {
+    return;
+  }
+  auto cpu_kernels = kernels_.find(DispatchKey::CPU);
+  if (kernels_.find(DispatchKey::Autograd) == kernels_.end() || cpu_kernels == kernels_.end() ||
+      cpu_kernels->second.front().kernel.isFallthrough()) {
+    return;
+  }
+  for (const auto& argument : schema_->schema.arguments()) {
+    const auto& type = argument.type();
+    if (!type->isSubtypeOf(OptionalType::ofTensor()) &&
+        !type->isSubtypeOf(ListType::ofTensors()) &&
+        !cannotHoldTensors(type)) {
+      return;
+    }
+  }
+  autograd_fast_path_ = true;
 }
 
 void OperatorEntry::updateDispatchTableFull_(const c10::Dispatcher& dispatcher) {
@@ -85,6 +85,12 @@ public:
     return is_observed_;
   }
 
+  // Whether calls that don't record a graph may skip the Autograd kernel,
+  // see Note [Autograd fast path]
+  bool hasAutogradFastPath() const {
+    return autograd_fast_path_;
+  }
+
   // We may allocate an OperatorEntry for an operator even when we don't
   // have a schema.  When we receive the schema registration, we post
   // facto register a schema.
@@ -239,6 +245,8 @@ private:
   // Whether this operator needs to be observed with RecordFunction
   const bool is_observed_;
 
+  bool autograd_fast_path_ = false;
+
   const KernelFunction& computeDispatchTableEntry(const c10::Dispatcher& dispatcher, DispatchKey dispatch_key) const;
   std::pair<const AnnotatedKernel&, const char*> computeDispatchTableEntryWithDebug(
     const c10::Dispatcher& dispatcher, DispatchKey dispatch_key
@@ -248,6 +256,8 @@ private:
   void updateDispatchTable_(const c10::Dispatcher& dispatcher, DispatchKey dispatch_key);
   // Like above, but for ALL entries in the dispatch table.
   void updateDispatchTableFull_(const c10::Dispatcher& dispatcher);
+  // Recomputes autograd_fast_path_ after the schema or kernels changed.
+  void updateAutogradFastPath_();
 };
 
 } // namespace impl
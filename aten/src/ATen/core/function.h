@@ -8,6 +8,10 @@ namespace c10 {
 struct FunctionSchema;
 };
 
+namespace at {
+CAFFE2_API void launch(std::function<void()> func);
+}
+
 namespace torch {
 namespace jit {
 
@@ -16,6 +20,9 @@ struct GraphExecutor;
 
 using Stack = std::vector<at::IValue>;
 using Kwargs = std::unordered_map<std::string, at::IValue>;
+// Runs the tasks of an asynchronous run, e.g. its forks and the continuations
+// of its waits. at::launch() runs them on the inter-op thread pool.
+using TaskLauncher = std::function<void(std::function<void()>)>;
 struct RecursiveMethodCallError : public std::exception {};
 
 TORCH_API void preoptimizeGraph(std::shared_ptr<Graph>& graph);
@@ -31,7 +38,9 @@ struct TORCH_API Function {
 
   virtual void run(Stack&& stack) = 0;
 
-  virtual c10::intrusive_ptr<c10::ivalue::Future> runAsync(Stack& stack) = 0;
+  virtual c10::intrusive_ptr<c10::ivalue::Future> runAsync(
+      Stack& stack,
+      TaskLauncher taskLauncher = at::launch) = 0;
 
   virtual at::IValue operator()(
       std::vector<at::IValue> stack,
@@ -18,7 +18,25 @@ const std::string& domain_prefix() {
   return _domain_prefix;
 }
 
+c10::optional<Symbol> InternedStrings::lookup(const std::string& s) const {
+  return table_.read([&](const Table& t) -> c10::optional<Symbol> {
+    auto it = t.string_to_sym.find(s);
+    if (it == t.string_to_sym.end())
+      return c10::nullopt;
+    return it->second;
+  });
+}
+
+const InternedStrings::SymbolInfo& InternedStrings::info(Symbol sym) const {
+  return *table_.read([&](const Table& t) {
+    return t.sym_to_info.at(sym);
+  });
+}
+
 Symbol InternedStrings::symbol(const std::string& s) {
+  // fast path: the symbol exists already, no lock needed
+  if (auto sym = lookup(s))
+    return *sym;
   std::lock_guard<std::mutex> guard(mutex_);
   return _symbol(s);
 }
@@ -46,17 +64,15 @@ Symbol InternedStrings::ns(Symbol sym) {
     return namespaces::ns;
     FORALL_NS_SYMBOLS(DEFINE_CASE)
 #undef DEFINE_CASE
-    default: {
-      std::lock_guard<std::mutex> guard(mutex_);
-      return sym_to_info_.at(sym).ns;
-    }
+    default:
+      return info(sym).ns;
   }
 }
 
 Symbol InternedStrings::_symbol(const std::string& s) {
-  auto it = string_to_sym_.find(s);
-  if (it != string_to_sym_.end())
-    return it->second;
+  // another thread may have added it since our lock-free lookup
+  if (auto sym = lookup(s))
+    return *sym;
 
   auto pos = s.find("::");
   if (pos == std::string::npos) {
@@ -66,15 +82,25 @@ Symbol InternedStrings::_symbol(const std::string& s) {
   }
   Symbol ns = _symbol("namespaces::" + s.substr(0, pos));
 
-  Symbol sym(sym_to_info_.size());
-  string_to_sym_[s] = sym;
-  sym_to_info_.push_back({ns, s, s.substr(pos + strlen("::"))});
+  Symbol sym(infos_.size());
+  add(sym, s, {ns, s, s.substr(pos + strlen("::"))});
   return sym;
 }
 
-std::pair<const char*, const char*> InternedStrings::customString(Symbol sym) {
-  std::lock_guard<std::mutex> guard(mutex_);
-  SymbolInfo& s = sym_to_info_.at(sym);
+void InternedStrings::add(Symbol sym, const std::string& s, SymbolInfo symbol_info) {
+  // infos_ is a deque, so references to existing entries (and the strings
+  // handed out by string()) stay valid
+  infos_.push_back(std::move(symbol_info));
+  const SymbolInfo* info_ptr = &infos_.back();
+  // applied to both copies of the table
+  table_.write([&](Table& t) {
+    t.string_to_sym.emplace(s, sym);
+    t.sym_to_info.push_back(info_ptr);
+  });
+}
+
+std::pair<const char*, const char*> InternedStrings::customString(Symbol sym) const {
+  const SymbolInfo& s = info(sym);
   return {s.qual_name.c_str(), s.unqual_name.c_str()};
 }
 
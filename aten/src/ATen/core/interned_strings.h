@@ -98,6 +98,7 @@ namespace c10 {
   _(prim, ConstantChunk)             \
   _(prim, MMTreeReduce)              \
   _(prim, MMBatchSide)               \
+  _(prim, HorizontalBatch)           \
   _(prim, min)                       \
   _(prim, max)                       \
   _(prim, abs)                       \
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -8,9 +9,14 @@
 #include <vector>
 #include <ATen/core/interned_strings.h>
 #include <c10/util/Exception.h>
+#include <c10/util/LeftRight.h>
+#include <c10/util/Optional.h>
 
 namespace c10 {
 
+// Symbols are resolved without taking a lock: the lookup tables live in a
+// LeftRight, so readers only bump an atomic counter, and mutex_ merely
+// serializes the (rare) interning of new symbols against each other.
 struct CAFFE2_API InternedStrings {
   InternedStrings();
   Symbol symbol(const std::string& s);
@@ -18,17 +24,28 @@ struct CAFFE2_API InternedStrings {
   Symbol ns(Symbol sym);
 
  private:
-  // prereq - holding mutex_
-  Symbol _symbol(const std::string& s);
-  std::pair<const char*, const char*> customString(Symbol sym);
-  std::unordered_map<std::string, Symbol> string_to_sym_;
-
   struct SymbolInfo {
     Symbol ns;
     std::string qual_name;
     std::string unqual_name;
   };
-  std::vector<SymbolInfo> sym_to_info_;
+
+  struct Table {
+    std::unordered_map<std::string, Symbol> string_to_sym;
+    // points into infos_, whose elements never move
+    std::vector<const SymbolInfo*> sym_to_info;
+  };
+
+  c10::optional<Symbol> lookup(const std::string& s) const;
+  const SymbolInfo& info(Symbol sym) const;
+  std::pair<const char*, const char*> customString(Symbol sym) const;
+  // prereq - holding mutex_
+  Symbol _symbol(const std::string& s);
+  void add(Symbol sym, const std::string& s, SymbolInfo symbol_info);
+
+  LeftRight<Table> table_;
+  // guarded by mutex_
+  std::deque<SymbolInfo> infos_;
 
   std::mutex mutex_;
 };
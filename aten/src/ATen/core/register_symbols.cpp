@@ -20,19 +20,21 @@ constexpr Entry entries[] = {
 
 } // namespace
 
-InternedStrings::InternedStrings()
-    : sym_to_info_(static_cast<size_t>(_keys::num_symbols)) {
+InternedStrings::InternedStrings() {
   // Instead of a loop, this could be done by expanding the
   // assignments directly into FORALL_NS_SYMBOLS, but it would create
   // a huge function (thanks to all the std::string constructors and
   // operator[]s) which would take several minutes to optimize. A
   // static C array of constexpr-constructible structs takes instead
   // no time to compile.
+  Table table;
+  table.sym_to_info.resize(static_cast<size_t>(_keys::num_symbols));
   for (const auto& entry : entries) {
-    string_to_sym_[entry.qual_name] = entry.sym;
-    sym_to_info_[entry.sym] = {
-        entry.ns_sym, entry.qual_name, entry.unqual_name};
+    infos_.push_back({entry.ns_sym, entry.qual_name, entry.unqual_name});
+    table.string_to_sym[entry.qual_name] = entry.sym;
+    table.sym_to_info[entry.sym] = &infos_.back();
   }
+  table_.write([&](Table& t) { t = table; });
 }
 
 } // namespace c10
@@ -4,16 +4,24 @@
 // See Note [Do not compile initializers with AVX]
 
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/detail/FunctionTraits.h>
+
+#include <type_traits>
 
 namespace at { namespace vec256 {
 
+// The functions below work on the vector type taken by the operation they
+// are given: Vec256<scalar_t>, or Vec512<scalar_t> in kernels compiled for
+// AVX512 (see vec512/vec512.h).
+template <typename Op>
+using vec_arg_t = typename std::decay<typename function_traits<Op>::template arg<0>::type>::type;
+
 // TODO: Make this more efficient
-template <typename scalar_t, typename Op>
+template <typename scalar_t, typename Op, typename Vec>
 inline scalar_t vec_reduce_all(
     const Op& vec_fun,
-    vec256::Vec256<scalar_t> acc_vec,
+    Vec acc_vec,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
   scalar_t acc_arr[Vec::size()];
   acc_vec.store(acc_arr);
   for (int64_t i = 1; i < size; i++) {
@@ -28,9 +36,9 @@ inline scalar_t vec_reduce_all(
 
 template <typename scalar_t, typename Op>
 inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec_arg_t<Op>;
   if (size < Vec::size())
-    return vec_reduce_all(vec_fun, Vec::loadu(data, size), size);
+    return vec_reduce_all<scalar_t>(vec_fun, Vec::loadu(data, size), size);
   int64_t d = Vec::size();
   Vec acc_vec = Vec::loadu(data);
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
@@ -41,19 +49,19 @@ inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
     Vec data_vec = Vec::loadu(data + d, size - d);
     acc_vec = Vec::set(acc_vec, vec_fun(acc_vec, data_vec), size - d);
   }
-  return vec_reduce_all(vec_fun, acc_vec, Vec::size());
+  return vec_reduce_all<scalar_t>(vec_fun, acc_vec, Vec::size());
 }
 
 // similar to reduce_all, but reduces into two outputs
 template <typename scalar_t, typename Op1, typename Op2>
 inline std::pair<scalar_t, scalar_t> reduce2_all(const Op1& vec_fun1, const Op2& vec_fun2,
     scalar_t* data, int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec_arg_t<Op1>;
   if (size < Vec::size()) {
     auto loaded_data = Vec::loadu(data, size);
     return std::pair<scalar_t, scalar_t>(
-      vec_reduce_all(vec_fun1, loaded_data, size),
-      vec_reduce_all(vec_fun2, loaded_data, size));
+      vec_reduce_all<scalar_t>(vec_fun1, loaded_data, size),
+      vec_reduce_all<scalar_t>(vec_fun2, loaded_data, size));
   }
   int64_t d = Vec::size();
   Vec acc_vec1 = Vec::loadu(data);
@@ -69,8 +77,8 @@ inline std::pair<scalar_t, scalar_t> reduce2_all(const Op1& vec_fun1, const Op2&
     acc_vec2 = Vec::set(acc_vec2, vec_fun2(acc_vec2, data_vec), size - d);
   }
   return std::pair<scalar_t, scalar_t>(
-    vec_reduce_all(vec_fun1, acc_vec1, Vec::size()),
-    vec_reduce_all(vec_fun2, acc_vec2, Vec::size()));
+    vec_reduce_all<scalar_t>(vec_fun1, acc_vec1, Vec::size()),
+    vec_reduce_all<scalar_t>(vec_fun2, acc_vec2, Vec::size()));
 }
 
 template <typename scalar_t, typename MapOp, typename ReduceOp>
@@ -79,9 +87,9 @@ inline scalar_t map_reduce_all(
     const ReduceOp& red_fun,
     scalar_t* data,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec_arg_t<MapOp>;
   if (size < Vec::size())
-    return vec_reduce_all(red_fun, map_fun(Vec::loadu(data, size)), size);
+    return vec_reduce_all<scalar_t>(red_fun, map_fun(Vec::loadu(data, size)), size);
   int64_t d = Vec::size();
   Vec acc_vec = map_fun(Vec::loadu(data));
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
@@ -94,7 +102,7 @@ inline scalar_t map_reduce_all(
     data_vec = map_fun(data_vec);
     acc_vec = Vec::set(acc_vec, red_fun(acc_vec, data_vec), size - d);
   }
-  return vec_reduce_all(red_fun, acc_vec, Vec::size());
+  return vec_reduce_all<scalar_t>(red_fun, acc_vec, Vec::size());
 }
 
 template <typename scalar_t, typename MapOp, typename ReduceOp>
@@ -104,12 +112,12 @@ inline scalar_t map2_reduce_all(
     const scalar_t* data,
     const scalar_t* data2,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec_arg_t<MapOp>;
   if (size < Vec::size()) {
     Vec data_vec = Vec::loadu(data, size);
     Vec data2_vec = Vec::loadu(data2, size);
     data_vec = map_fun(data_vec, data2_vec);
-    return vec_reduce_all(red_fun, data_vec, size);
+    return vec_reduce_all<scalar_t>(red_fun, data_vec, size);
   }
   int64_t d = Vec::size();
   Vec acc_vec = map_fun(Vec::loadu(data), Vec::loadu(data2));
@@ -125,7 +133,7 @@ inline scalar_t map2_reduce_all(
     data_vec = map_fun(data_vec, data2_vec);
     acc_vec = Vec::set(acc_vec, red_fun(acc_vec, data_vec), size - d);
   }
-  return vec_reduce_all(red_fun, acc_vec, Vec::size());
+  return vec_reduce_all<scalar_t>(red_fun, acc_vec, Vec::size());
 }
 
 template <typename scalar_t, typename Op>
@@ -134,7 +142,7 @@ inline void map(
     scalar_t* output_data,
     const scalar_t* input_data,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec_arg_t<Op>;
   int64_t d = 0;
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
     Vec output_vec = vec_fun(Vec::loadu(input_data + d));
@@ -153,7 +161,7 @@ inline void map2(
     scalar_t* input_data,
     scalar_t* input_data2,
     int64_t size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec_arg_t<Op>;
   int64_t d = 0;
   for (; d < size - (size % Vec::size()); d += Vec::size()) {
     Vec data_vec = Vec::loadu(input_data + d);
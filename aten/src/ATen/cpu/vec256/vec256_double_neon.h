@@ -0,0 +1,484 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+// Like vec256_float_neon.h, transcendentals go through the STL since we are
+// not building with Sleef for mobile yet.
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// aarch64 only, for the same reasons as vec256_float_neon.h. NEON is part of
+// the aarch64 baseline, so the DEFAULT kernels use it and there is no
+// separate CPU capability for it.
+#if defined(__aarch64__)
+
+#ifdef __BIG_ENDIAN__
+#error "Big endian is not supported."
+#endif
+
+template <> class Vec256<double> {
+private:
+  float64x2x2_t values;
+public:
+  using value_type = double;
+  static constexpr int size() {
+    return 4;
+  }
+  Vec256() {}
+  Vec256(float64x2x2_t v) : values(v) {}
+  Vec256(double val) : values{vdupq_n_f64(val), vdupq_n_f64(val) } {}
+  Vec256(double val0, double val1, double val2, double val3) :
+         values{val0, val1, val2, val3} {}
+  Vec256(float64x2_t val0, float64x2_t val1) : values{val0, val1} {}
+  operator float64x2x2_t() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vec256<double> blend(const Vec256<double>& a, const Vec256<double>& b) {
+    const uint64x2_t mask_low = {
+        (mask & 0x01) ? ~0ULL : 0ULL, (mask & 0x02) ? ~0ULL : 0ULL};
+    const uint64x2_t mask_high = {
+        (mask & 0x04) ? ~0ULL : 0ULL, (mask & 0x08) ? ~0ULL : 0ULL};
+    return Vec256<double>(
+        vbslq_f64(mask_low, b.values.val[0], a.values.val[0]),
+        vbslq_f64(mask_high, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<double> blendv(const Vec256<double>& a, const Vec256<double>& b,
+                               const Vec256<double>& mask) {
+    // NB: This requires that each value of the mask either all be zeros or
+    // all be 1s, as for Vec256<float>.
+    return Vec256<double>(
+        vbslq_f64(
+            vreinterpretq_u64_f64(mask.values.val[0]),
+            b.values.val[0],
+            a.values.val[0]),
+        vbslq_f64(
+            vreinterpretq_u64_f64(mask.values.val[1]),
+            b.values.val[1],
+            a.values.val[1]));
+  }
+  template<typename step_t>
+  static Vec256<double> arange(double base = 0., step_t step = static_cast<step_t>(1)) {
+    const float64x2_t base_vec = vdupq_n_f64(base);
+    const float64x2_t step_vec = vdupq_n_f64(step);
+    const float64x2_t low = {0., 1.};
+    const float64x2_t high = {2., 3.};
+    return Vec256<double>(
+        vfmaq_f64(base_vec, low, step_vec),
+        vfmaq_f64(base_vec, high, step_vec));
+  }
+  static Vec256<double> set(const Vec256<double>& a, const Vec256<double>& b,
+                            int64_t count = size()) {
+    switch (count) {
+      case 0:
+        return a;
+      case 1:
+        return blend<1>(a, b);
+      case 2:
+        return Vec256<double>(b.values.val[0], a.values.val[1]);
+      case 3:
+        return blend<7>(a, b);
+    }
+    return b;
+  }
+  static Vec256<double> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return vld1q_f64_x2(reinterpret_cast<const double*>(ptr));
+    }
+    else if (count == (size() >> 1)) {
+      Vec256<double> res;
+      res.values.val[0] = vld1q_f64(reinterpret_cast<const double*>(ptr));
+      res.values.val[1] = vdupq_n_f64(0.);
+      return res;
+    }
+    else {
+      __at_align32__ double tmp_values[size()];
+      for (auto i = 0; i < size(); ++i) {
+        tmp_values[i] = 0.0;
+      }
+      std::memcpy(
+          tmp_values,
+          reinterpret_cast<const double*>(ptr),
+          count * sizeof(double));
+      return vld1q_f64_x2(reinterpret_cast<const double*>(tmp_values));
+    }
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      vst1q_f64_x2(reinterpret_cast<double*>(ptr), values);
+    }
+    else if (count == (size() >> 1)) {
+      vst1q_f64(reinterpret_cast<double*>(ptr), values.val[0]);
+    }
+    else {
+      double tmp_values[size()];
+      vst1q_f64_x2(reinterpret_cast<double*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(double));
+    }
+  }
+  inline const float64x2_t& get_low() const {
+    return values.val[0];
+  }
+  inline float64x2_t& get_low() {
+    return values.val[0];
+  }
+  inline const float64x2_t& get_high() const {
+    return values.val[1];
+  }
+  inline float64x2_t& get_high() {
+    return values.val[1];
+  }
+  // Slow, see Vec256<float>::operator[].
+  const double operator[](int idx) const {
+    __at_align32__ double tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  };
+  const double operator[](int idx) {
+    __at_align32__ double tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  }
+  int zero_mask() const {
+    __at_align32__ double tmp[size()];
+    store(tmp);
+    int mask = 0;
+    for (int i = 0; i < size(); ++ i) {
+      if (tmp[i] == 0.) {
+        mask |= (1 << i);
+      }
+    }
+    return mask;
+  }
+  Vec256<double> map(double (*f)(double)) const {
+    __at_align32__ double tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec256<double> map2(
+      const Vec256<double>& other,
+      double (*f)(double, double)) const {
+    __at_align32__ double tmp[size()];
+    __at_align32__ double tmp_other[size()];
+    store(tmp);
+    other.store(tmp_other);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i], tmp_other[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec256<double> abs() const {
+    return Vec256<double>(vabsq_f64(values.val[0]), vabsq_f64(values.val[1]));
+  }
+  Vec256<double> angle() const {
+    return Vec256<double>(0.);
+  }
+  Vec256<double> real() const {
+    return *this;
+  }
+  Vec256<double> imag() const {
+    return Vec256<double>(0.);
+  }
+  Vec256<double> conj() const {
+    return *this;
+  }
+  Vec256<double> acos() const {
+    return map(std::acos);
+  }
+  Vec256<double> asin() const {
+    return map(std::asin);
+  }
+  Vec256<double> atan() const {
+    return map(std::atan);
+  }
+  Vec256<double> atan2(const Vec256<double> &b) const {
+    return map2(b, std::atan2);
+  }
+  Vec256<double> erf() const {
+    return map(std::erf);
+  }
+  Vec256<double> erfc() const {
+    return map(std::erfc);
+  }
+  Vec256<double> erfinv() const {
+    return map(calc_erfinv);
+  }
+  Vec256<double> exp() const {
+    return map(std::exp);
+  }
+  Vec256<double> expm1() const {
+    return map(std::expm1);
+  }
+  Vec256<double> fmod(const Vec256<double>& q) const {
+    return map2(q, std::fmod);
+  }
+  Vec256<double> log() const {
+    return map(std::log);
+  }
+  Vec256<double> log10() const {
+    return map(std::log10);
+  }
+  Vec256<double> log1p() const {
+    return map(std::log1p);
+  }
+  Vec256<double> log2() const {
+    return map(std::log2);
+  }
+  Vec256<double> frac() const;
+  Vec256<double> sin() const {
+    return map(std::sin);
+  }
+  Vec256<double> sinh() const {
+    return map(std::sinh);
+  }
+  Vec256<double> cos() const {
+    return map(std::cos);
+  }
+  Vec256<double> cosh() const {
+    return map(std::cosh);
+  }
+  Vec256<double> ceil() const {
+    return Vec256<double>(vrndpq_f64(values.val[0]), vrndpq_f64(values.val[1]));
+  }
+  Vec256<double> floor() const {
+    return Vec256<double>(vrndmq_f64(values.val[0]), vrndmq_f64(values.val[1]));
+  }
+  Vec256<double> neg() const {
+    return Vec256<double>(
+        vnegq_f64(values.val[0]),
+        vnegq_f64(values.val[1]));
+  }
+  Vec256<double> round() const {
+    // Rounds midway numbers to the nearest even integer, like round_impl.
+    return Vec256<double>(vrndnq_f64(values.val[0]), vrndnq_f64(values.val[1]));
+  }
+  Vec256<double> tan() const {
+    return map(std::tan);
+  }
+  Vec256<double> tanh() const {
+    return map(std::tanh);
+  }
+  Vec256<double> trunc() const {
+    return Vec256<double>(vrndq_f64(values.val[0]), vrndq_f64(values.val[1]));
+  }
+  Vec256<double> lgamma() const {
+    return map(std::lgamma);
+  }
+  Vec256<double> sqrt() const {
+    return Vec256<double>(
+        vsqrtq_f64(values.val[0]),
+        vsqrtq_f64(values.val[1]));
+  }
+  Vec256<double> reciprocal() const {
+    const float64x2_t one = vdupq_n_f64(1.);
+    return Vec256<double>(
+        vdivq_f64(one, values.val[0]),
+        vdivq_f64(one, values.val[1]));
+  }
+  Vec256<double> rsqrt() const {
+    const float64x2_t one = vdupq_n_f64(1.);
+    return Vec256<double>(
+        vdivq_f64(one, vsqrtq_f64(values.val[0])),
+        vdivq_f64(one, vsqrtq_f64(values.val[1])));
+  }
+  Vec256<double> pow(const Vec256<double> &b) const {
+    return map2(b, std::pow);
+  }
+  Vec256<double> operator==(const Vec256<double>& other) const {
+    float64x2_t r0 =
+      vreinterpretq_f64_u64(vceqq_f64(values.val[0], other.values.val[0]));
+    float64x2_t r1 =
+      vreinterpretq_f64_u64(vceqq_f64(values.val[1], other.values.val[1]));
+    return Vec256<double>(r0, r1);
+  }
+
+  Vec256<double> operator!=(const Vec256<double>& other) const {
+    float64x2_t r0 = vreinterpretq_f64_u32(vmvnq_u32(vreinterpretq_u32_u64(
+        vceqq_f64(values.val[0], other.values.val[0]))));
+    float64x2_t r1 = vreinterpretq_f64_u32(vmvnq_u32(vreinterpretq_u32_u64(
+        vceqq_f64(values.val[1], other.values.val[1]))));
+    return Vec256<double>(r0, r1);
+  }
+
+  Vec256<double> operator<(const Vec256<double>& other) const {
+    float64x2_t r0 =
+      vreinterpretq_f64_u64(vcltq_f64(values.val[0], other.values.val[0]));
+    float64x2_t r1 =
+      vreinterpretq_f64_u64(vcltq_f64(values.val[1], other.values.val[1]));
+    return Vec256<double>(r0, r1);
+  }
+
+  Vec256<double> operator<=(const Vec256<double>& other) const {
+    float64x2_t r0 =
+      vreinterpretq_f64_u64(vcleq_f64(values.val[0], other.values.val[0]));
+    float64x2_t r1 =
+      vreinterpretq_f64_u64(vcleq_f64(values.val[1], other.values.val[1]));
+    return Vec256<double>(r0, r1);
+  }
+
+  Vec256<double> operator>(const Vec256<double>& other) const {
+    float64x2_t r0 =
+      vreinterpretq_f64_u64(vcgtq_f64(values.val[0], other.values.val[0]));
+    float64x2_t r1 =
+      vreinterpretq_f64_u64(vcgtq_f64(values.val[1], other.values.val[1]));
+    return Vec256<double>(r0, r1);
+  }
+
+  Vec256<double> operator>=(const Vec256<double>& other) const {
+    float64x2_t r0 =
+      vreinterpretq_f64_u64(vcgeq_f64(values.val[0], other.values.val[0]));
+    float64x2_t r1 =
+      vreinterpretq_f64_u64(vcgeq_f64(values.val[1], other.values.val[1]));
+    return Vec256<double>(r0, r1);
+  }
+
+  Vec256<double> eq(const Vec256<double>& other) const;
+  Vec256<double> ne(const Vec256<double>& other) const;
+  Vec256<double> gt(const Vec256<double>& other) const;
+  Vec256<double> ge(const Vec256<double>& other) const;
+  Vec256<double> lt(const Vec256<double>& other) const;
+  Vec256<double> le(const Vec256<double>& other) const;
+};
+
+template <>
+Vec256<double> inline operator+(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vaddq_f64(a.get_low(), b.get_low());
+  float64x2_t r1 = vaddq_f64(a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+template <>
+Vec256<double> inline operator-(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vsubq_f64(a.get_low(), b.get_low());
+  float64x2_t r1 = vsubq_f64(a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+template <>
+Vec256<double> inline operator*(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vmulq_f64(a.get_low(), b.get_low());
+  float64x2_t r1 = vmulq_f64(a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+template <>
+Vec256<double> inline operator/(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vdivq_f64(a.get_low(), b.get_low());
+  float64x2_t r1 = vdivq_f64(a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+// frac. Implement this here so we can use subtraction
+Vec256<double> Vec256<double>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<double> inline maximum(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vmaxq_f64(a.get_low(), b.get_low());
+  float64x2_t r1 = vmaxq_f64(a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<double> inline minimum(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vminq_f64(a.get_low(), b.get_low());
+  float64x2_t r1 = vminq_f64(a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+template <>
+Vec256<double> inline clamp(const Vec256<double>& a, const Vec256<double>& min, const Vec256<double>& max) {
+  return minimum(max, maximum(min, a));
+}
+
+template <>
+Vec256<double> inline clamp_max(const Vec256<double>& a, const Vec256<double>& max) {
+  return minimum(max, a);
+}
+
+template <>
+Vec256<double> inline clamp_min(const Vec256<double>& a, const Vec256<double>& min) {
+  return maximum(min, a);
+}
+
+template <>
+Vec256<double> inline operator&(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vreinterpretq_f64_u64(vandq_u64(
+      vreinterpretq_u64_f64(a.get_low()),
+      vreinterpretq_u64_f64(b.get_low())));
+  float64x2_t r1 = vreinterpretq_f64_u64(vandq_u64(
+      vreinterpretq_u64_f64(a.get_high()),
+      vreinterpretq_u64_f64(b.get_high())));
+  return Vec256<double>(r0, r1);
+}
+
+template <>
+Vec256<double> inline operator|(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vreinterpretq_f64_u64(vorrq_u64(
+      vreinterpretq_u64_f64(a.get_low()),
+      vreinterpretq_u64_f64(b.get_low())));
+  float64x2_t r1 = vreinterpretq_f64_u64(vorrq_u64(
+      vreinterpretq_u64_f64(a.get_high()),
+      vreinterpretq_u64_f64(b.get_high())));
+  return Vec256<double>(r0, r1);
+}
+
+template <>
+Vec256<double> inline operator^(const Vec256<double>& a, const Vec256<double>& b) {
+  float64x2_t r0 = vreinterpretq_f64_u64(veorq_u64(
+      vreinterpretq_u64_f64(a.get_low()),
+      vreinterpretq_u64_f64(b.get_low())));
+  float64x2_t r1 = vreinterpretq_f64_u64(veorq_u64(
+      vreinterpretq_u64_f64(a.get_high()),
+      vreinterpretq_u64_f64(b.get_high())));
+  return Vec256<double>(r0, r1);
+}
+
+Vec256<double> Vec256<double>::eq(const Vec256<double>& other) const {
+  return (*this == other) & Vec256<double>(1.0);
+}
+
+Vec256<double> Vec256<double>::ne(const Vec256<double>& other) const {
+  return (*this != other) & Vec256<double>(1.0);
+}
+
+Vec256<double> Vec256<double>::gt(const Vec256<double>& other) const {
+  return (*this > other) & Vec256<double>(1.0);
+}
+
+Vec256<double> Vec256<double>::ge(const Vec256<double>& other) const {
+  return (*this >= other) & Vec256<double>(1.0);
+}
+
+Vec256<double> Vec256<double>::lt(const Vec256<double>& other) const {
+  return (*this < other) & Vec256<double>(1.0);
+}
+
+Vec256<double> Vec256<double>::le(const Vec256<double>& other) const {
+  return (*this <= other) & Vec256<double>(1.0);
+}
+
+template <>
+Vec256<double> inline fmadd(const Vec256<double>& a, const Vec256<double>& b, const Vec256<double>& c) {
+  float64x2_t r0 = vfmaq_f64(c.get_low(), a.get_low(), b.get_low());
+  float64x2_t r1 = vfmaq_f64(c.get_high(), a.get_high(), b.get_high());
+  return Vec256<double>(r0, r1);
+}
+
+#endif
+
+}}}
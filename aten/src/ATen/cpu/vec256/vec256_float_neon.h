@@ -635,6 +635,36 @@ inline void convert(const int32_t* src, float* dst, int64_t n) {
   }
 }
 
+template <>
+inline void convert(const c10::Half* src, float* dst, int64_t n) {
+  int64_t i;
+  const uint16_t* src_bits = reinterpret_cast<const uint16_t*>(src);
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src_bits + i))));
+    vst1q_f32(dst + i + 4, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src_bits + i + 4))));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, c10::Half* dst, int64_t n) {
+  int64_t i;
+  uint16_t* dst_bits = reinterpret_cast<uint16_t*>(dst);
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    vst1_u16(dst_bits + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    vst1_u16(dst_bits + i + 4, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i + 4))));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
 template <>
 Vec256<float> inline fmadd(const Vec256<float>& a, const Vec256<float>& b, const Vec256<float>& c) {
   float32x4_t r0 = vfmaq_f32(c.get_low(), a.get_low(), b.get_low());
@@ -1091,21 +1091,15 @@ struct Vec256QuantizedConverter {
       Vec256<float> scale,
       Vec256<float> zero_point,
       Vec256<float> scale_zp_premul) const {
+    // Only the integer to float conversion is done per element, so the
+    // arithmetic can use whatever Vec256<float> maps to (e.g. NEON).
     float_vec_return_type rv;
     for (int i = 0; i < float_num_vecs(); ++i) {
       float tmp_vals[8];
       for (int j = 0; j < 8; ++j) {
-        tmp_vals[j] = at::native::dequantize_val<T>(
-            scale[j], zero_point[j], T(vals[8 * i + j]));
+        tmp_vals[j] = static_cast<float>(vals[8 * i + j]);
       }
-      rv[i] = Vec256<float>(tmp_vals[0],
-          tmp_vals[1],
-          tmp_vals[2],
-          tmp_vals[3],
-          tmp_vals[4],
-          tmp_vals[5],
-          tmp_vals[6],
-          tmp_vals[7]);
+      rv[i] = (Vec256<float>::loadu(tmp_vals) - zero_point) * scale;
     }
     return rv;
   }
@@ -0,0 +1,51 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512_float.h>
+#include <ATen/cpu/vec512/vec512_double.h>
+
+namespace at {
+namespace vec256 {
+
+// Note [Vec512]
+// ~~~~~~~~~~~~~
+// Vec512<T> holds a 512-bit AVX512 register and has the same interface as
+// Vec256<T> for the operations the kernels use (loadu / store, arithmetic,
+// maximum / minimum, exp / log, ...). It only exists for float and double in
+// kernels compiled for CPU_CAPABILITY_AVX512, which also define
+// CPU_CAPABILITY_AVX2, so the Vec256 types in those kernels are the AVX2
+// ones. It lives in the vec256 namespace so that code written against a Vec
+// template parameter finds vec256::maximum, vec256::fmadd etc. for both.
+//
+// Kernels opt in by taking the vector type from vec_t<scalar_t> instead of
+// spelling out Vec256<scalar_t>; the helpers in vec256/functional.h and the
+// loops in native/cpu/Loops.h and native/cpu/Reduce.h deduce the vector type
+// from the ops they are given.
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+template <typename T>
+struct VecType {
+  using type = Vec256<T>;
+};
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+template <>
+struct VecType<float> {
+  using type = Vec512<float>;
+};
+
+template <>
+struct VecType<double> {
+  using type = Vec512<double>;
+};
+#endif
+
+// The widest vector type of T in this kernel build.
+template <typename T>
+using vec_t = typename VecType<T>::type;
+
+}}}
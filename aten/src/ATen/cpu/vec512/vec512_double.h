@@ -0,0 +1,231 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+#include <sleef.h>
+#endif
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+template <class T> class Vec512;
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+template <> class Vec512<double> {
+private:
+  __m512d values;
+  static __m512d from_mask(__mmask8 mask) {
+    return _mm512_castsi512_pd(_mm512_movm_epi64(mask));
+  }
+public:
+  using value_type = double;
+  static constexpr int size() {
+    return 8;
+  }
+  Vec512() {}
+  Vec512(__m512d v) : values(v) {}
+  Vec512(double val) {
+    values = _mm512_set1_pd(val);
+  }
+  operator __m512d() const {
+    return values;
+  }
+  static Vec512<double> blendv(const Vec512<double>& a, const Vec512<double>& b,
+                               const Vec512<double>& mask) {
+    return _mm512_mask_mov_pd(a.values, _mm512_movepi64_mask(_mm512_castpd_si512(mask.values)), b.values);
+  }
+  template<typename step_t>
+  static Vec512<double> arange(double base = 0., step_t step = static_cast<step_t>(1)) {
+    return _mm512_fmadd_pd(
+        _mm512_setr_pd(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm512_set1_pd(step), _mm512_set1_pd(base));
+  }
+  // Takes the first `count` elements from b and the rest from a.
+  static Vec512<double> set(const Vec512<double>& a, const Vec512<double>& b,
+                            int64_t count = size()) {
+    if (count >= size()) {
+      return b;
+    }
+    return _mm512_mask_mov_pd(a.values, static_cast<__mmask8>((1 << count) - 1), b.values);
+  }
+  // Partial loads are masked, so they don't touch the memory past `count`
+  // elements and zero the remaining lanes.
+  static Vec512<double> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size())
+      return _mm512_loadu_pd(reinterpret_cast<const double*>(ptr));
+    return _mm512_maskz_loadu_pd(
+        static_cast<__mmask8>((1 << count) - 1), reinterpret_cast<const double*>(ptr));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_pd(reinterpret_cast<double*>(ptr), values);
+    } else if (count > 0) {
+      _mm512_mask_storeu_pd(
+          reinterpret_cast<double*>(ptr), static_cast<__mmask8>((1 << count) - 1), values);
+    }
+  }
+  const double& operator[](int idx) const  = delete;
+  double& operator[](int idx) = delete;
+  int zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit and others are translated to 0-bit
+    return _mm512_cmp_pd_mask(values, _mm512_setzero_pd(), _CMP_EQ_OQ);
+  }
+  Vec512<double> map(double (*f)(double)) const {
+    double tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec512<double> abs() const {
+    return _mm512_andnot_pd(_mm512_set1_pd(-0.), values);
+  }
+  Vec512<double> neg() const {
+    return _mm512_xor_pd(_mm512_set1_pd(-0.), values);
+  }
+  Vec512<double> exp() const {
+    return Vec512<double>(Sleef_expd8_u10(values));
+  }
+  Vec512<double> expm1() const {
+    return Vec512<double>(Sleef_expm1d8_u10(values));
+  }
+  Vec512<double> log() const {
+    return Vec512<double>(Sleef_logd8_u10(values));
+  }
+  Vec512<double> log1p() const {
+    return Vec512<double>(Sleef_log1pd8_u10(values));
+  }
+  Vec512<double> sin() const {
+    return Vec512<double>(Sleef_sind8_u10(values));
+  }
+  Vec512<double> cos() const {
+    return Vec512<double>(Sleef_cosd8_u10(values));
+  }
+  Vec512<double> tanh() const {
+    return Vec512<double>(Sleef_tanhd8_u10(values));
+  }
+  Vec512<double> pow(const Vec512<double> &b) const {
+    return Vec512<double>(Sleef_powd8_u10(values, b));
+  }
+  Vec512<double> ceil() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+  }
+  Vec512<double> floor() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  }
+  Vec512<double> round() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  Vec512<double> trunc() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+  }
+  Vec512<double> frac() const;
+  Vec512<double> sqrt() const {
+    return _mm512_sqrt_pd(values);
+  }
+  Vec512<double> reciprocal() const {
+    return _mm512_div_pd(_mm512_set1_pd(1), values);
+  }
+  Vec512<double> rsqrt() const {
+    return _mm512_div_pd(_mm512_set1_pd(1), _mm512_sqrt_pd(values));
+  }
+  // Comparisons return all-ones lanes for true and all-zeros lanes for false,
+  // like the Vec256 ones, using the _CMP_**_OQ predicate.
+  Vec512<double> operator==(const Vec512<double>& other) const {
+    return from_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_EQ_OQ));
+  }
+  Vec512<double> operator!=(const Vec512<double>& other) const {
+    return from_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_NEQ_OQ));
+  }
+  Vec512<double> operator<(const Vec512<double>& other) const {
+    return from_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_LT_OQ));
+  }
+  Vec512<double> operator<=(const Vec512<double>& other) const {
+    return from_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_LE_OQ));
+  }
+  Vec512<double> operator>(const Vec512<double>& other) const {
+    return from_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_GT_OQ));
+  }
+  Vec512<double> operator>=(const Vec512<double>& other) const {
+    return from_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_GE_OQ));
+  }
+};
+
+inline Vec512<double> operator+(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_add_pd(a, b);
+}
+
+inline Vec512<double> operator-(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_sub_pd(a, b);
+}
+
+inline Vec512<double> operator*(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_mul_pd(a, b);
+}
+
+inline Vec512<double> operator/(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_div_pd(a, b);
+}
+
+inline Vec512<double> operator&(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_and_pd(a, b);
+}
+
+inline Vec512<double> operator|(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_or_pd(a, b);
+}
+
+inline Vec512<double> operator^(const Vec512<double>& a, const Vec512<double>& b) {
+  return _mm512_xor_pd(a, b);
+}
+
+// frac. Implement this here so we can use subtraction
+Vec512<double> Vec512<double>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+inline Vec512<double> maximum(const Vec512<double>& a, const Vec512<double>& b) {
+  __m512d max = _mm512_max_pd(a, b);
+  __mmask8 nan_mask = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+  // Exploit the fact that all-ones is a NaN.
+  return _mm512_mask_mov_pd(max, nan_mask, _mm512_castsi512_pd(_mm512_set1_epi64(-1)));
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+inline Vec512<double> minimum(const Vec512<double>& a, const Vec512<double>& b) {
+  __m512d min = _mm512_min_pd(a, b);
+  __mmask8 nan_mask = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+  // Exploit the fact that all-ones is a NaN.
+  return _mm512_mask_mov_pd(min, nan_mask, _mm512_castsi512_pd(_mm512_set1_epi64(-1)));
+}
+
+inline Vec512<double> clamp(const Vec512<double>& a, const Vec512<double>& min, const Vec512<double>& max) {
+  return _mm512_min_pd(max, _mm512_max_pd(min, a));
+}
+
+inline Vec512<double> clamp_max(const Vec512<double>& a, const Vec512<double>& max) {
+  return _mm512_min_pd(max, a);
+}
+
+inline Vec512<double> clamp_min(const Vec512<double>& a, const Vec512<double>& min) {
+  return _mm512_max_pd(min, a);
+}
+
+inline Vec512<double> fmadd(const Vec512<double>& a, const Vec512<double>& b, const Vec512<double>& c) {
+  return _mm512_fmadd_pd(a, b, c);
+}
+
+#endif
+
+}}}
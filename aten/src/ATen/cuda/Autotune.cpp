@@ -0,0 +1,357 @@
+#include <ATen/cuda/Autotune.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/cuda/StreamCapture.h>
+#include <c10/util/Exception.h>
+#include <c10/util/StringUtil.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace at {
+namespace cuda {
+namespace autotune {
+
+namespace {
+
+// Followed by the CUDA runtime version on the first line of a cache file.
+constexpr const char* kCacheHeader = "pytorch-cuda-autotune-v1";
+// Timed launches of every configuration, after one warm up launch.
+constexpr int kBenchmarkIterations = 3;
+
+bool envFlag(const char* name) {
+  const char* value = std::getenv(name);
+  return value != nullptr && strcmp(value, "1") == 0;
+}
+
+std::string envCachePath() {
+  const char* value = std::getenv("PYTORCH_CUDA_AUTOTUNE_CACHE");
+  return value != nullptr ? value : "";
+}
+
+std::atomic<bool> autotune_enabled{envFlag("PYTORCH_CUDA_AUTOTUNE")};
+
+struct State {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::unique_ptr<TunableOp>> ops;
+  // Tuned configurations by resultKey().
+  std::unordered_map<std::string, Config> results;
+  bool env_cache_loaded = false;
+};
+
+State& state() {
+  static State state;
+  return state;
+}
+
+int cudaRuntimeVersion() {
+  int version = 0;
+  AT_CUDA_CHECK(cudaRuntimeGetVersion(&version));
+  return version;
+}
+
+int64_t roundUpToPowerOf2(int64_t size) {
+  int64_t result = 1;
+  while (result < size) {
+    result *= 2;
+  }
+  return size <= 0 ? size : result;
+}
+
+// Keyed by the device name rather than its index, so that a saved cache is
+// used on every GPU of the same kind.
+std::string resultKey(
+    const std::string& op,
+    ScalarType dtype,
+    IntArrayRef sizes) {
+  std::ostringstream key;
+  key << getCurrentDeviceProperties()->name << '\t' << op << '\t'
+      << toString(dtype) << '\t';
+  for (size_t i = 0; i < sizes.size(); i++) {
+    key << (i == 0 ? "" : ",") << roundUpToPowerOf2(sizes[i]);
+  }
+  return key.str();
+}
+
+std::string configToString(const Config& config) {
+  std::ostringstream result;
+  for (size_t i = 0; i < config.size(); i++) {
+    result << (i == 0 ? "" : ",") << config[i];
+  }
+  return result.str();
+}
+
+bool configFromString(const std::string& str, Config* config) {
+  std::istringstream in(str);
+  std::string value;
+  while (std::getline(in, value, ',')) {
+    char* end = nullptr;
+    const long long parsed = std::strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0') {
+      return false;
+    }
+    config->push_back(parsed);
+  }
+  return !config->empty();
+}
+
+int64_t loadCacheLocked(State& s, const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    return 0;
+  }
+  std::string line;
+  const auto expected = c10::str(kCacheHeader, " ", cudaRuntimeVersion());
+  if (!std::getline(in, line) || line != expected) {
+    TORCH_WARN(
+        "Ignoring the CUDA autotune cache ", path, ": expected a first line of \"",
+        expected, "\", got \"", line, "\"");
+    return 0;
+  }
+  int64_t loaded = 0;
+  while (std::getline(in, line)) {
+    const auto config_begin = line.rfind('\t');
+    Config config;
+    if (config_begin == std::string::npos ||
+        !configFromString(line.substr(config_begin + 1), &config)) {
+      TORCH_WARN("Ignoring the CUDA autotune cache ", path, ": malformed line \"", line, "\"");
+      return loaded;
+    }
+    // What this process tuned itself is at least as good a choice
+    loaded += s.results.emplace(line.substr(0, config_begin), std::move(config)).second;
+  }
+  return loaded;
+}
+
+void maybeLoadEnvCacheLocked(State& s) {
+  if (s.env_cache_loaded) {
+    return;
+  }
+  s.env_cache_loaded = true;
+  const auto path = envCachePath();
+  if (!path.empty()) {
+    loadCacheLocked(s, path);
+  }
+}
+
+void maybeSaveEnvCache() {
+  const auto path = envCachePath();
+  if (path.empty()) {
+    return;
+  }
+  try {
+    // Keep what other processes sharing the file tuned in the meantime
+    load_cache(path);
+    save_cache(path);
+  } catch (const c10::Error& e) {
+    TORCH_WARN("Failed to save the CUDA autotune cache: ", e.what_without_backtrace());
+  }
+}
+
+} // namespace
+
+TunableOp::TunableOp(std::string name, std::vector<TunableParam> params)
+    : name_(std::move(name)), params_(std::move(params)) {
+  configs_.emplace_back();
+  for (const auto& param : params_) {
+    TORCH_CHECK(
+        !param.candidates.empty(),
+        "autotune: parameter ", param.name, " of ", name_, " has no candidates");
+    std::vector<Config> configs;
+    configs.reserve(configs_.size() * param.candidates.size());
+    // The first candidates vary slowest, so that configs_[0] is the default
+    for (const auto& config : configs_) {
+      for (const auto candidate : param.candidates) {
+        configs.push_back(config);
+        configs.back().push_back(candidate);
+      }
+    }
+    configs_ = std::move(configs);
+  }
+}
+
+Config TunableOp::run(
+    IntArrayRef sizes,
+    ScalarType dtype,
+    const std::function<void(const Config&)>& launch) {
+  const Config& default_config = configs_[0];
+  if (!enabled() || configs_.size() == 1) {
+    launch(default_config);
+    return default_config;
+  }
+
+  auto& s = state();
+  const auto key = resultKey(name_, dtype, sizes);
+  Config config;
+  {
+    std::lock_guard<std::mutex> guard(s.mutex);
+    maybeLoadEnvCacheLocked(s);
+    auto it = s.results.find(key);
+    if (it != s.results.end() &&
+        std::find(configs_.begin(), configs_.end(), it->second) != configs_.end()) {
+      config = it->second;
+    }
+  }
+  if (config.empty()) {
+    // Benchmarking synchronizes, which is not allowed during a capture
+    if (currentStreamCaptureStatus() != CaptureStatus::None) {
+      launch(default_config);
+      return default_config;
+    }
+    // Done without the lock; threads tuning the same key at once just
+    // come up with the same answer.
+    config = benchmark(launch);
+    {
+      std::lock_guard<std::mutex> guard(s.mutex);
+      s.results[key] = config;
+    }
+    maybeSaveEnvCache();
+  }
+  // Also leaves the outputs of the chosen configuration after benchmarking
+  launch(config);
+  return config;
+}
+
+Config TunableOp::benchmark(const std::function<void(const Config&)>& launch) {
+  const Config* best = &configs_[0];
+  float best_time = std::numeric_limits<float>::infinity();
+  for (const auto& config : configs_) {
+    try {
+      launch(config);
+      CUDAEvent start(cudaEventDefault);
+      CUDAEvent stop(cudaEventDefault);
+      start.record();
+      for (int i = 0; i < kBenchmarkIterations; i++) {
+        launch(config);
+      }
+      stop.record();
+      stop.synchronize();
+      const float time = start.elapsed_time(stop);
+      if (time < best_time) {
+        best_time = time;
+        best = &config;
+      }
+    } catch (const c10::Error& e) {
+      // e.g. a block size that the kernel's registers don't allow
+      cudaGetLastError(); // clear CUDA error
+    }
+  }
+  return *best;
+}
+
+TunableOp& registerTunableOp(
+    const std::string& name,
+    std::vector<TunableParam> params) {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  auto it = s.ops.find(name);
+  if (it == s.ops.end()) {
+    it = s.ops.emplace(name, std::make_unique<TunableOp>(name, std::move(params))).first;
+    return *it->second;
+  }
+  const auto& registered = it->second->params();
+  const bool same_params = registered.size() == params.size() &&
+      std::equal(
+          registered.begin(), registered.end(), params.begin(),
+          [](const TunableParam& a, const TunableParam& b) {
+            return a.name == b.name && a.candidates == b.candidates;
+          });
+  TORCH_CHECK(
+      same_params,
+      "autotune: ", name, " was already registered with other parameters");
+  return *it->second;
+}
+
+std::vector<std::string> registeredTunableOps() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  std::vector<std::string> names;
+  for (const auto& op : s.ops) {
+    names.push_back(op.first);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+bool enabled() {
+  return autotune_enabled.load(std::memory_order_relaxed);
+}
+
+void set_enabled(bool enabled) {
+  autotune_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void save_cache(const std::string& path) {
+  std::vector<std::pair<std::string, Config>> entries;
+  {
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    entries.assign(s.results.begin(), s.results.end());
+  }
+  std::sort(entries.begin(), entries.end());
+
+#ifdef _WIN32
+  const auto tmp_path = c10::str(path, ".tmp.", _getpid());
+#else
+  const auto tmp_path = c10::str(path, ".tmp.", getpid());
+#endif
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    TORCH_CHECK(out, "autotune: can't open ", tmp_path, " for writing");
+    out << kCacheHeader << " " << cudaRuntimeVersion() << "\n";
+    for (const auto& entry : entries) {
+      out << entry.first << '\t' << configToString(entry.second) << "\n";
+    }
+    out.close();
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      TORCH_CHECK(false, "autotune: failed to write ", tmp_path);
+    }
+  }
+  // Readers see either the previous cache or the whole new one
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+#ifdef _WIN32
+    // rename doesn't replace an existing file on Windows
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) == 0) {
+      return;
+    }
+#endif
+    std::remove(tmp_path.c_str());
+    TORCH_CHECK(false, "autotune: failed to rename ", tmp_path, " to ", path);
+  }
+}
+
+int64_t load_cache(const std::string& path) {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  return loadCacheLocked(s, path);
+}
+
+void clear_cache() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  s.results.clear();
+}
+
+} // namespace autotune
+} // namespace cuda
+} // namespace at
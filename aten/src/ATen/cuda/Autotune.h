@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/core/ScalarType.h>
+#include <c10/util/ArrayRef.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Opt-in autotuning of CUDA kernel launch configurations.
+//
+// A kernel declares its tunable parameters (block sizes, vector widths, ...)
+// and the candidate values of each once, by registering a TunableOp:
+//
+//   static auto& op = at::cuda::autotune::registerTunableOp(
+//       "layer_norm_forward", {{"block_size", {256, 128, 512, 1024}}});
+//
+// and launches through it, with a configuration of one value per parameter:
+//
+//   op.run({M, N}, X.scalar_type(), [&](const Config& config) {
+//     my_kernel<<<M, config[0], 0, stream>>>(...);
+//     AT_CUDA_CHECK(cudaGetLastError());
+//   });
+//
+// run() uses the default configuration, the first candidate of every
+// parameter, unless autotuning is enabled by PYTORCH_CUDA_AUTOTUNE=1 or
+// set_enabled(true). Then the first launch for an (op, dtype, shape bucket,
+// device) benchmarks every configuration by calling the launch function, and
+// later launches reuse the fastest one. The launch function must therefore
+// only write its outputs, so that running it several times is harmless. A
+// configuration whose launch throws is skipped.
+//
+// Shapes are bucketed by rounding every size up to a power of two, so that
+// the tuning cost is paid for a few shapes only. No tuning happens while a
+// CUDA graph is being captured.
+//
+// When PYTORCH_CUDA_AUTOTUNE_CACHE names a file, the results are loaded from
+// it when first needed and saved to it after every new tuning, so that other
+// processes on the same kind of GPU skip the benchmarking.
+
+namespace at {
+namespace cuda {
+namespace autotune {
+
+struct TunableParam {
+  std::string name;
+  // candidates[0] is the value used when autotuning is disabled.
+  std::vector<int64_t> candidates;
+};
+
+// One value per parameter of the op, in declaration order.
+using Config = std::vector<int64_t>;
+
+class TORCH_CUDA_API TunableOp {
+ public:
+  TunableOp(std::string name, std::vector<TunableParam> params);
+
+  const std::string& name() const {
+    return name_;
+  }
+  const std::vector<TunableParam>& params() const {
+    return params_;
+  }
+  // All configurations, the cartesian product of the candidates;
+  // configs()[0] is the default one.
+  const std::vector<Config>& configs() const {
+    return configs_;
+  }
+
+  // Calls launch with the configuration to use for sizes and dtype, and
+  // returns that configuration.
+  Config run(
+      IntArrayRef sizes,
+      ScalarType dtype,
+      const std::function<void(const Config&)>& launch);
+
+ private:
+  Config benchmark(const std::function<void(const Config&)>& launch);
+
+  std::string name_;
+  std::vector<TunableParam> params_;
+  std::vector<Config> configs_;
+};
+
+// Returns the op registered under name, registering it first if needed.
+// Registering the same name again with other parameters is an error.
+TORCH_CUDA_API TunableOp& registerTunableOp(
+    const std::string& name,
+    std::vector<TunableParam> params);
+
+TORCH_CUDA_API std::vector<std::string> registeredTunableOps();
+
+TORCH_CUDA_API bool enabled();
+TORCH_CUDA_API void set_enabled(bool enabled);
+
+// Writes the tuned configurations to path, replacing it atomically.
+TORCH_CUDA_API void save_cache(const std::string& path);
+// Adds the configurations saved at path, keeping the ones tuned by this
+// process, and returns how many were added. Returns 0, with a warning when
+// it exists, if path can't be read or was saved with another CUDA version.
+// Saved configurations that an op doesn't offer anymore are never used.
+TORCH_CUDA_API int64_t load_cache(const std::string& path);
+// Forgets the tuned configurations.
+TORCH_CUDA_API void clear_cache();
+
+} // namespace autotune
+} // namespace cuda
+} // namespace at
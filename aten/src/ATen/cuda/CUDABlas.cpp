@@ -5,6 +5,15 @@
 #include <ATen/cuda/CUDABlas.h>
 #include <ATen/cuda/Exceptions.h>
 
+#ifdef AT_CUDA_BLASLT_ENABLED
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/util/hash.h>
+#include <cublasLt.h>
+
+#include <mutex>
+#include <unordered_map>
+#endif
+
 #define CUDABLAS_POSINT_CHECK(FD, X)         \
   TORCH_CHECK(                               \
       (X > 0 && X <= INT_MAX),               \
@@ -329,6 +338,377 @@ void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
 }
 #endif
 
+#ifdef AT_CUDA_BLASLT_ENABLED
+
+namespace {
+
+// Workspace given to cublasLt, and that the heuristic may plan for.
+constexpr size_t kCuBlasLtWorkspaceSize = 1024 * 1024;
+
+template <typename T, cublasStatus_t (*destructor)(T*)>
+struct CuBlasLtDeleter {
+  void operator()(T* x) {
+    if (x != nullptr) {
+      TORCH_CUDABLAS_CHECK(destructor(x));
+    }
+  }
+};
+
+template <typename T, cublasStatus_t (*destructor)(T*)>
+class CuBlasLtDescriptor {
+ public:
+  T* descriptor() const {
+    return descriptor_.get();
+  }
+
+ protected:
+  std::unique_ptr<T, CuBlasLtDeleter<T, destructor>> descriptor_;
+};
+
+class CuBlasLtMatmulDescriptor : public CuBlasLtDescriptor<
+                                     cublasLtMatmulDescOpaque_t,
+                                     &cublasLtMatmulDescDestroy> {
+ public:
+  CuBlasLtMatmulDescriptor(
+      cublasComputeType_t compute_type,
+      cudaDataType_t scale_type) {
+    cublasLtMatmulDesc_t raw_descriptor = nullptr;
+    TORCH_CUDABLAS_CHECK(
+        cublasLtMatmulDescCreate(&raw_descriptor, compute_type, scale_type));
+    descriptor_.reset(raw_descriptor);
+  }
+
+  template <typename T>
+  void setAttribute(cublasLtMatmulDescAttributes_t attr, const T& value) {
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        descriptor(), attr, &value, sizeof(T)));
+  }
+};
+
+class CuBlasLtMatrixLayout : public CuBlasLtDescriptor<
+                                 cublasLtMatrixLayoutOpaque_t,
+                                 &cublasLtMatrixLayoutDestroy> {
+ public:
+  CuBlasLtMatrixLayout(
+      cudaDataType_t type,
+      uint64_t rows,
+      uint64_t cols,
+      int64_t ld) {
+    cublasLtMatrixLayout_t raw_descriptor = nullptr;
+    TORCH_CUDABLAS_CHECK(
+        cublasLtMatrixLayoutCreate(&raw_descriptor, type, rows, cols, ld));
+    descriptor_.reset(raw_descriptor);
+  }
+};
+
+class CuBlasLtMatmulPreference : public CuBlasLtDescriptor<
+                                     cublasLtMatmulPreferenceOpaque_t,
+                                     &cublasLtMatmulPreferenceDestroy> {
+ public:
+  CuBlasLtMatmulPreference() {
+    cublasLtMatmulPreference_t raw_descriptor = nullptr;
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceCreate(&raw_descriptor));
+    descriptor_.reset(raw_descriptor);
+  }
+
+  template <typename T>
+  void setAttribute(cublasLtMatmulPreferenceAttributes_t attr, const T& value) {
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        descriptor(), attr, &value, sizeof(T)));
+  }
+};
+
+// Largest power of two, up to 16, that the address is a multiple of. The
+// heuristic only returns algorithms valid for the alignments it is told.
+uint32_t _getAlignment(const void* ptr) {
+  uint32_t alignment = 1;
+  const auto address = reinterpret_cast<uintptr_t>(ptr);
+  for (; alignment < 16; alignment *= 2) {
+    if (address % (alignment * 2) != 0) {
+      break;
+    }
+  }
+  return alignment;
+}
+
+// Everything the choice of a cublasLt algorithm depends on.
+struct CuBlasLtAlgoKey {
+  int device;
+  cudaDataType_t data_type;
+  cublasComputeType_t compute_type;
+  bool transpose_mat1;
+  bool transpose_mat2;
+  int64_t m, n, k;
+  int64_t mat1_ld, mat2_ld, result_ld;
+  cublasLtEpilogue_t epilogue;
+  uint32_t mat1_alignment, mat2_alignment, result_alignment, bias_alignment;
+
+  bool operator==(const CuBlasLtAlgoKey& other) const {
+    return device == other.device && data_type == other.data_type &&
+        compute_type == other.compute_type &&
+        transpose_mat1 == other.transpose_mat1 &&
+        transpose_mat2 == other.transpose_mat2 && m == other.m &&
+        n == other.n && k == other.k && mat1_ld == other.mat1_ld &&
+        mat2_ld == other.mat2_ld && result_ld == other.result_ld &&
+        epilogue == other.epilogue && mat1_alignment == other.mat1_alignment &&
+        mat2_alignment == other.mat2_alignment &&
+        result_alignment == other.result_alignment &&
+        bias_alignment == other.bias_alignment;
+  }
+};
+
+struct CuBlasLtAlgoKeyHash {
+  size_t operator()(const CuBlasLtAlgoKey& key) const {
+    return c10::get_hash(
+        key.device,
+        static_cast<int>(key.data_type),
+        static_cast<int>(key.compute_type),
+        key.transpose_mat1,
+        key.transpose_mat2,
+        key.m,
+        key.n,
+        key.k,
+        key.mat1_ld,
+        key.mat2_ld,
+        key.result_ld,
+        static_cast<int>(key.epilogue),
+        key.mat1_alignment,
+        key.mat2_alignment,
+        key.result_alignment,
+        key.bias_alignment);
+  }
+};
+
+// Running the heuristic costs about as much as launching a small GEMM, so
+// its answer is kept for every shape seen, as the cudnn convolution
+// algorithm choices are.
+cublasLtMatmulAlgo_t _getCuBlasLtAlgo(
+    const CuBlasLtAlgoKey& key,
+    cublasLtHandle_t handle,
+    const CuBlasLtMatmulDescriptor& compute_desc,
+    const CuBlasLtMatrixLayout& mat1_desc,
+    const CuBlasLtMatrixLayout& mat2_desc,
+    const CuBlasLtMatrixLayout& result_desc) {
+  static std::mutex mutex;
+  static std::unordered_map<CuBlasLtAlgoKey, cublasLtMatmulAlgo_t, CuBlasLtAlgoKeyHash>
+      cache;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+
+  CuBlasLtMatmulPreference preference;
+  preference.setAttribute(
+      CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, kCuBlasLtWorkspaceSize);
+  preference.setAttribute(
+      CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES, key.mat1_alignment);
+  preference.setAttribute(
+      CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES, key.mat2_alignment);
+  preference.setAttribute(
+      CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES, key.result_alignment);
+  preference.setAttribute(
+      CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES, key.result_alignment);
+
+  cublasLtMatmulHeuristicResult_t heuristic_result = {};
+  int returned_result = 0;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulAlgoGetHeuristic(
+      handle,
+      compute_desc.descriptor(),
+      mat1_desc.descriptor(),
+      mat2_desc.descriptor(),
+      result_desc.descriptor(),
+      result_desc.descriptor(),
+      preference.descriptor(),
+      1,
+      &heuristic_result,
+      &returned_result));
+  if (returned_result == 0) {
+    TORCH_CUDABLAS_CHECK(CUBLAS_STATUS_NOT_SUPPORTED);
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  cache.emplace(key, heuristic_result.algo);
+  return heuristic_result.algo;
+}
+
+template <typename Dtype>
+struct CuBlasLtTypes {};
+
+template <>
+struct CuBlasLtTypes<double> {
+  static constexpr cudaDataType_t data_type = CUDA_R_64F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_64F;
+  static cublasComputeType_t compute_type() {
+    return CUBLAS_COMPUTE_64F;
+  }
+};
+
+template <>
+struct CuBlasLtTypes<float> {
+  static constexpr cudaDataType_t data_type = CUDA_R_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+  static cublasComputeType_t compute_type() {
+    // Matches the math mode of the cublas handles, see CublasHandlePool.cpp
+    return at::globalContext().allowTF32CuBLAS() ? CUBLAS_COMPUTE_32F_FAST_TF32
+                                                 : CUBLAS_COMPUTE_32F;
+  }
+};
+
+template <>
+struct CuBlasLtTypes<at::Half> {
+  static constexpr cudaDataType_t data_type = CUDA_R_16F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+  static cublasComputeType_t compute_type() {
+    return CUBLAS_COMPUTE_32F;
+  }
+};
+
+} // anonymous namespace
+
+template <typename Dtype>
+void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    at::acc_type<Dtype, true> alpha_val,
+    const Dtype* mat1_ptr,
+    int64_t mat1_ld,
+    const Dtype* mat2_ptr,
+    int64_t mat2_ld,
+    const Dtype* bias,
+    Dtype* result_ptr,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation) {
+  using Types = CuBlasLtTypes<Dtype>;
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, m);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, n);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias, k);
+  globalContext().alertCuBLASConfigNotDeterministic();
+  // The bias is added by the epilogue, instead of being read from result.
+  at::acc_type<Dtype, true> beta_val = 0;
+
+  CuBlasLtAlgoKey key;
+  key.device = c10::cuda::current_device();
+  key.data_type = Types::data_type;
+  key.compute_type = Types::compute_type();
+  key.transpose_mat1 = transpose_mat1;
+  key.transpose_mat2 = transpose_mat2;
+  key.m = m;
+  key.n = n;
+  key.k = k;
+  key.mat1_ld = mat1_ld;
+  key.mat2_ld = mat2_ld;
+  key.result_ld = result_ld;
+  key.epilogue = activation == GEMMAndBiasActivationEpilogue::RELU
+      ? CUBLASLT_EPILOGUE_RELU_BIAS
+      : CUBLASLT_EPILOGUE_BIAS;
+  key.mat1_alignment = _getAlignment(mat1_ptr);
+  key.mat2_alignment = _getAlignment(mat2_ptr);
+  key.result_alignment = _getAlignment(result_ptr);
+  key.bias_alignment = _getAlignment(bias);
+
+  CuBlasLtMatmulDescriptor compute_desc(key.compute_type, Types::scale_type);
+  compute_desc.setAttribute(
+      CUBLASLT_MATMUL_DESC_TRANSA, transpose_mat1 ? CUBLAS_OP_T : CUBLAS_OP_N);
+  compute_desc.setAttribute(
+      CUBLASLT_MATMUL_DESC_TRANSB, transpose_mat2 ? CUBLAS_OP_T : CUBLAS_OP_N);
+  compute_desc.setAttribute(CUBLASLT_MATMUL_DESC_EPILOGUE, key.epilogue);
+  compute_desc.setAttribute(CUBLASLT_MATMUL_DESC_BIAS_POINTER, bias);
+
+  CuBlasLtMatrixLayout mat1_desc(
+      Types::data_type,
+      transpose_mat1 ? k : m,
+      transpose_mat1 ? m : k,
+      mat1_ld);
+  CuBlasLtMatrixLayout mat2_desc(
+      Types::data_type,
+      transpose_mat2 ? n : k,
+      transpose_mat2 ? k : n,
+      mat2_ld);
+  CuBlasLtMatrixLayout result_desc(Types::data_type, m, n, result_ld);
+
+  // A cublas handle is also a valid cublasLt handle.
+  auto handle =
+      reinterpret_cast<cublasLtHandle_t>(at::cuda::getCurrentCUDABlasHandle());
+  const auto algo = _getCuBlasLtAlgo(
+      key, handle, compute_desc, mat1_desc, mat2_desc, result_desc);
+  auto workspace =
+      c10::cuda::CUDACachingAllocator::get()->allocate(kCuBlasLtWorkspaceSize);
+
+  TORCH_CUDABLAS_CHECK(cublasLtMatmul(
+      handle,
+      compute_desc.descriptor(),
+      &alpha_val,
+      mat1_ptr,
+      mat1_desc.descriptor(),
+      mat2_ptr,
+      mat2_desc.descriptor(),
+      &beta_val,
+      result_ptr,
+      result_desc.descriptor(),
+      result_ptr,
+      result_desc.descriptor(),
+      &algo,
+      workspace.get(),
+      kCuBlasLtWorkspaceSize,
+      at::cuda::getCurrentCUDAStream()));
+}
+
+template void gemm_and_bias<double>(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha_val,
+    const double* mat1_ptr,
+    int64_t mat1_ld,
+    const double* mat2_ptr,
+    int64_t mat2_ld,
+    const double* bias,
+    double* result_ptr,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation);
+
+template void gemm_and_bias<float>(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha_val,
+    const float* mat1_ptr,
+    int64_t mat1_ld,
+    const float* mat2_ptr,
+    int64_t mat2_ld,
+    const float* bias,
+    float* result_ptr,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation);
+
+template void gemm_and_bias<at::Half>(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha_val,
+    const at::Half* mat1_ptr,
+    int64_t mat1_ld,
+    const at::Half* mat2_ptr,
+    int64_t mat2_ld,
+    const at::Half* bias,
+    at::Half* result_ptr,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation);
+
+#endif // AT_CUDA_BLASLT_ENABLED
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define GEMV_CHECK_ARGVALUES(Dtype)           \
@@ -519,6 +899,58 @@ void dot<at::Half>(CUDABLAS_DOT_ARGTYPES(at::Half)) {
 #endif
 }
 
+#ifdef AT_CUDA_BLAS_BATCHED_LU_ENABLED
+template <>
+void getrfBatched<double>(CUDABLAS_GETRF_BATCHED_ARGTYPES(double)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasDgetrfBatched(
+      handle, n, dA_array, ldda, ipiv_array, info_array, batchsize));
+}
+
+template <>
+void getrfBatched<float>(CUDABLAS_GETRF_BATCHED_ARGTYPES(float)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasSgetrfBatched(
+      handle, n, dA_array, ldda, ipiv_array, info_array, batchsize));
+}
+
+// The info returned by getrsBatched only reports invalid arguments and is
+// written to host memory, so it is checked here rather than by the caller.
+template <>
+void getrsBatched<double>(CUDABLAS_GETRS_BATCHED_ARGTYPES(double)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  int info = 0;
+  TORCH_CUDABLAS_CHECK(cublasDgetrsBatched(
+      handle, _cublasOpFromChar(trans), n, nrhs, dA_array, ldda, ipiv_array,
+      dB_array, lddb, &info, batchsize));
+  TORCH_CHECK(info == 0, "cublasDgetrsBatched: Argument ", -info, " has illegal value");
+}
+
+template <>
+void getrsBatched<float>(CUDABLAS_GETRS_BATCHED_ARGTYPES(float)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  int info = 0;
+  TORCH_CUDABLAS_CHECK(cublasSgetrsBatched(
+      handle, _cublasOpFromChar(trans), n, nrhs, dA_array, ldda, ipiv_array,
+      dB_array, lddb, &info, batchsize));
+  TORCH_CHECK(info == 0, "cublasSgetrsBatched: Argument ", -info, " has illegal value");
+}
+
+template <>
+void getriBatched<double>(CUDABLAS_GETRI_BATCHED_ARGTYPES(double)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasDgetriBatched(
+      handle, n, dA_array, ldda, ipiv_array, dC_array, lddc, info_array, batchsize));
+}
+
+template <>
+void getriBatched<float>(CUDABLAS_GETRI_BATCHED_ARGTYPES(float)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  TORCH_CUDABLAS_CHECK(cublasSgetriBatched(
+      handle, n, dA_array, ldda, ipiv_array, dC_array, lddc, info_array, batchsize));
+}
+#endif // AT_CUDA_BLAS_BATCHED_LU_ENABLED
+
 } // namespace blas
 } // namespace cuda
 } // namespace at
@@ -11,10 +11,41 @@
 
   where Dtype is double, float, at::Half or at::BFloat16 (ROCm, NOT for dot).
   The functions are available in at::cuda::blas namespace.
+
+  With CUDA 11 outside of Windows, AT_CUDA_BLASLT_ENABLED is defined and
+
+    gemm_and_bias<Dtype>(transpose_mat1, transpose_mat2, m, n, k, alpha, mat1,
+  mat1_ld, mat2, mat2_ld, bias, result, result_ld, activation)
+
+  adds a bias and an optional activation to the product in the epilogue of a
+  cublasLt matmul.
+
+  Outside of ROCm, AT_CUDA_BLAS_BATCHED_LU_ENABLED is defined and
+
+    getrfBatched<Dtype>(n, dA_array, ldda, ipiv_array, info_array, batchsize)
+
+    getrsBatched<Dtype>(trans, n, nrhs, dA_array, ldda, ipiv_array, dB_array,
+  lddb, batchsize)
+
+    getriBatched<Dtype>(n, dA_array, ldda, ipiv_array, dC_array, lddc,
+  info_array, batchsize)
+
+  wrap cuBLAS' batched LU routines for double and float. The matrix pointer
+  arrays, pivots and infos all live on the device.
  */
 
+#include <ATen/AccumulateType.h>
 #include <ATen/cuda/CUDAContext.h>
 
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 11000 && !defined(_MSC_VER) && \
+    !defined(__HIP_PLATFORM_HCC__)
+#define AT_CUDA_BLASLT_ENABLED
+#endif
+
+#ifndef __HIP_PLATFORM_HCC__
+#define AT_CUDA_BLAS_BATCHED_LU_ENABLED
+#endif
+
 namespace at {
 namespace cuda {
 namespace blas {
@@ -69,6 +100,35 @@ template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16));
 #endif
 
+#ifdef AT_CUDA_BLASLT_ENABLED
+enum class GEMMAndBiasActivationEpilogue {
+  None,
+  RELU,
+};
+
+// result = activation(alpha * op(mat1) * op(mat2) + bias), with column-major
+// matrices as in gemm, where bias holds one value per row of the m x n
+// result. The algorithm picked by the cublasLt heuristic is cached per shape,
+// layout and alignment of the operands.
+template <typename Dtype>
+void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    at::acc_type<Dtype, true> alpha_val,
+    const Dtype* mat1_ptr,
+    int64_t mat1_ld,
+    const Dtype* mat2_ptr,
+    int64_t mat2_ld,
+    const Dtype* bias,
+    Dtype* result_ptr,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation =
+        GEMMAndBiasActivationEpilogue::None);
+#endif
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define CUDABLAS_GEMV_ARGTYPES(Dtype)                                         \
@@ -127,6 +187,49 @@ void dot<float>(CUDABLAS_DOT_ARGTYPES(float));
 template <>
 void dot<at::Half>(CUDABLAS_DOT_ARGTYPES(at::Half));
 
+#ifdef AT_CUDA_BLAS_BATCHED_LU_ENABLED
+/* BATCHED LU FUNCTIONS */
+
+#define CUDABLAS_GETRF_BATCHED_ARGTYPES(Dtype)                        \
+  int n, Dtype **dA_array, int ldda, int *ipiv_array, int *info_array, \
+      int batchsize
+
+template <typename Dtype>
+inline void getrfBatched(CUDABLAS_GETRF_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::getrfBatched: not implemented for ", typeid(Dtype).name());
+}
+template <>
+void getrfBatched<double>(CUDABLAS_GETRF_BATCHED_ARGTYPES(double));
+template <>
+void getrfBatched<float>(CUDABLAS_GETRF_BATCHED_ARGTYPES(float));
+
+#define CUDABLAS_GETRS_BATCHED_ARGTYPES(Dtype)                              \
+  char trans, int n, int nrhs, Dtype **dA_array, int ldda, int *ipiv_array, \
+      Dtype **dB_array, int lddb, int batchsize
+
+template <typename Dtype>
+inline void getrsBatched(CUDABLAS_GETRS_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::getrsBatched: not implemented for ", typeid(Dtype).name());
+}
+template <>
+void getrsBatched<double>(CUDABLAS_GETRS_BATCHED_ARGTYPES(double));
+template <>
+void getrsBatched<float>(CUDABLAS_GETRS_BATCHED_ARGTYPES(float));
+
+#define CUDABLAS_GETRI_BATCHED_ARGTYPES(Dtype)                           \
+  int n, Dtype **dA_array, int ldda, int *ipiv_array, Dtype **dC_array, \
+      int lddc, int *info_array, int batchsize
+
+template <typename Dtype>
+inline void getriBatched(CUDABLAS_GETRI_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::getriBatched: not implemented for ", typeid(Dtype).name());
+}
+template <>
+void getriBatched<double>(CUDABLAS_GETRI_BATCHED_ARGTYPES(double));
+template <>
+void getriBatched<float>(CUDABLAS_GETRI_BATCHED_ARGTYPES(float));
+#endif // AT_CUDA_BLAS_BATCHED_LU_ENABLED
+
 } // namespace blas
 } // namespace cuda
 } // namespace at
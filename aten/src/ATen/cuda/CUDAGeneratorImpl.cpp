@@ -1,7 +1,10 @@
 #include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/StreamCapture.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <ATen/Utils.h>
 
+#include <limits>
+
 namespace at {
 
 namespace cuda { namespace detail {
@@ -85,6 +88,7 @@ CUDAGeneratorImpl::CUDAGeneratorImpl(DeviceIndex device_index)
  * See Note [Acquire lock when using random generators]
  */
 void CUDAGeneratorImpl::set_current_seed(uint64_t seed) {
+  at::cuda::assertNotCapturing("Cannot call CUDAGeneratorImpl::set_current_seed");
   seed_ = seed;
   philox_offset_per_thread_ = 0;
 }
@@ -115,6 +119,7 @@ uint64_t CUDAGeneratorImpl::seed() {
  * See Note [Acquire lock when using random generators]
  */
 void CUDAGeneratorImpl::set_philox_offset_per_thread(uint64_t offset) {
+  at::cuda::assertNotCapturing("Cannot call CUDAGeneratorImpl::set_philox_offset_per_thread");
   philox_offset_per_thread_ = offset;
 }
 
@@ -122,9 +127,65 @@ void CUDAGeneratorImpl::set_philox_offset_per_thread(uint64_t offset) {
  * Gets the current philox_offset_per_thread_ of CUDAGeneratorImpl.
  */
 uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
+  at::cuda::assertNotCapturing("Cannot call CUDAGeneratorImpl::philox_offset_per_thread");
   return philox_offset_per_thread_;
 }
 
+/**
+ * Called by CUDAGraph to prepare this instance for a graph capture region.
+ * offset_extragraph is the initial offset at the start of the graphed region.
+ * offset_intragraph tracks the offset in the graphed region.
+ *
+ * See Note [CUDA Graph-safe RNG states]
+ */
+void CUDAGeneratorImpl::capture_prologue(int64_t* offset_extragraph) {
+  offset_extragraph_ = offset_extragraph;
+  offset_intragraph_ = 0;
+  graph_expects_this_gen_ = true;
+}
+
+/**
+ * Called by CUDAGraph to finalize a graph capture region for this instance.
+ * Returns the total offset increment consumed by one replay of the graph.
+ */
+uint64_t CUDAGeneratorImpl::capture_epilogue() {
+  graph_expects_this_gen_ = false;
+  return offset_intragraph_;
+}
+
+/**
+ * Gets the seed and philox offset value to be used in
+ * curandStatePhilox4_32_10, in an opaque PhiloxCudaState that's safe
+ * and can be used non-divergently in callers whether CUDA graph
+ * capture is underway or not. Kernels read the values with
+ * at::cuda::philox::unpack.
+ *
+ * See Note [CUDA Graph-safe RNG states]
+ * See Note [Acquire lock when using random generators]
+ */
+PhiloxCudaState CUDAGeneratorImpl::philox_cuda_state(uint64_t increment) {
+  if (at::cuda::currentStreamCaptureStatus() != at::cuda::CaptureStatus::None) {
+    TORCH_CHECK(graph_expects_this_gen_,
+                "philox_cuda_state for an unexpected CUDA generator used during capture. "
+                "Only the default CUDA generator of the capturing device can be used "
+                "inside a captured region.");
+    TORCH_CHECK(offset_intragraph_ + increment <= std::numeric_limits<uint32_t>::max(),
+                "Increment would overflow the philox offset of the captured region.");
+    uint32_t offset = this->offset_intragraph_;
+    this->offset_intragraph_ += increment;
+    return PhiloxCudaState(this->seed_,
+                           this->offset_extragraph_,
+                           offset);
+  } else {
+    TORCH_CHECK(!graph_expects_this_gen_,
+                "CUDA generator expects graph capture to be underway, "
+                "but the current stream is not capturing.");
+    uint64_t offset = this->philox_offset_per_thread_;
+    this->philox_offset_per_thread_ += increment;
+    return PhiloxCudaState(this->seed_, offset);
+  }
+}
+
 /**
  * Gets the seed and philox offset value to be used in
  * curandStatePhilox4_32_10
@@ -144,6 +205,8 @@ uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
  * See Note [Acquire lock when using random generators]
  */
 std::pair<uint64_t, uint64_t> CUDAGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  at::cuda::assertNotCapturing("Refactor this op to use CUDAGeneratorImpl::philox_cuda_state. "
+                               "Cannot call CUDAGeneratorImpl::philox_engine_inputs");
   uint64_t offset = this->philox_offset_per_thread_;
   this->philox_offset_per_thread_ += increment;
   return std::make_pair(this->seed_, offset);
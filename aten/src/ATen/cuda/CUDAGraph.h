@@ -0,0 +1,75 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/Device.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+
+namespace at {
+namespace cuda {
+
+// Standalone way to get a unique mempool id usable as a pool=... argument
+// to CUDAGraph::capture_begin
+TORCH_CUDA_API c10::cuda::CUDACachingAllocator::MempoolId_t graph_pool_handle();
+
+/*
+* CUDAGraph captures the kernels launched on a side stream and replays them
+* with a single cudaGraphLaunch.
+*
+* Memory allocated during capture comes from a private memory pool of the
+* caching allocator, so captured kernels can safely reuse their addresses on
+* every replay. The pool is kept alive until reset() (or destruction), and may
+* be shared with later captures by passing pool() to capture_begin().
+*
+* RNG ops using CUDAGeneratorImpl::philox_cuda_state are replay-safe: each
+* replay consumes fresh offsets from the default CUDA generator. See
+* Note [CUDA Graph-safe RNG states] in CUDAGeneratorImpl.h.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  void capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool = {0, 0});
+  void capture_end();
+  void replay();
+  void reset();
+  c10::cuda::CUDACachingAllocator::MempoolId_t pool();
+
+ protected:
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  cudaGraph_t graph_ = NULL;
+  cudaGraphExec_t graph_exec_ = NULL;
+#endif
+
+  // internal states so reset() can do its best cleaning up
+  // Set to true in capture_end if cudaStreamEndCapture succeeded
+  bool has_graph_ = false;
+  // Set to true in capture_end if cudaGraphInstantiate succeeded
+  bool has_graph_exec_ = false;
+
+  // uuid of this instance's current capture, retrieved from Cuda
+  c10::cuda::CUDACachingAllocator::CaptureId_t id_;
+
+  // uuid used to request a particular private mempool from CUDACachingAllocator.
+  // By default, this will be set to {id_, 0}.
+  //
+  // If capture_begin is called with "pool=other_graph.pool()", this graph's
+  // mempool_id_ will be set to the other graph's mempool_id_, and therefore
+  // share a mempool with the other graph.
+  c10::cuda::CUDACachingAllocator::MempoolId_t mempool_id_;
+
+  // Stream on which capture began
+  at::cuda::CUDAStream capture_stream_;
+
+  // Device where capture occurred. Right now, for simplicity, we require all
+  // ops in a capture to run on the same device, but this is a limitation of
+  // CUDAGraph, not CUDA itself.
+  int capture_dev_;
+
+  // RNG state trackers
+  at::Tensor offset_extragraph_;
+  uint64_t wholegraph_increment_;
+};
+
+} // namespace cuda
+} // namespace at
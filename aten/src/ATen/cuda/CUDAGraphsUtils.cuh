@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/cuda/PhiloxCudaState.h>
+#include <ATen/cuda/StreamCapture.h>
+
+#include <tuple>
+
+// Device-side utilities for making kernels capture-safe, i.e. usable while a
+// CUDA graph is being captured. See ATen/cuda/CUDAGraph.h.
+
+namespace at {
+namespace cuda {
+namespace philox {
+
+// In-kernel call to retrieve philox seed and offset from a PhiloxCudaState
+// instance whether that instance was created with graph capture underway or
+// not. See Note [CUDA Graph-safe RNG states] in CUDAGeneratorImpl.h.
+//
+// We can't write a __device__ function in CUDAGeneratorImpl.h, because it's
+// in ATen. Also, whatever call unpacks PhiloxCudaState in consumer kernels
+// must be inlineable. Easiest thing that comes to mind is, define a
+// __device__ unpack helper here, in ATen/cuda.
+__device__ __forceinline__ std::tuple<uint64_t, uint64_t>
+unpack(at::PhiloxCudaState arg) {
+  if (arg.captured_) {
+    return std::make_tuple(
+        arg.seed_,
+        static_cast<uint64_t>(*(arg.offset_.ptr) + arg.offset_intragraph_));
+  } else {
+    return std::make_tuple(arg.seed_, arg.offset_.val);
+  }
+}
+
+} // namespace philox
+} // namespace cuda
+} // namespace at
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+
+// Stores the seed and offset consumed by a Philox-based CUDA kernel.
+//
+// In eager mode the offset is known on the host and passed by value. While a
+// CUDA graph is captured, the offset for each replay is only known when the
+// replay is launched, so the kernel instead receives a pointer to a device
+// scalar holding the graph's base offset, which CUDAGraph::replay() updates,
+// plus the increment a kernel used within the graph. Kernels must read it with
+// at::cuda::philox::unpack() (see ATen/cuda/CUDAGraphsUtils.cuh).
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  // Called if graph capture is not underway
+  PhiloxCudaState(uint64_t seed,
+                  uint64_t offset) {
+    seed_ = seed;
+    offset_.val = offset;
+  }
+  // Called if graph capture is underway
+  PhiloxCudaState(uint64_t seed,
+                  int64_t* offset_extragraph,
+                  uint32_t offset_intragraph) {
+    seed_ = seed;
+    offset_.ptr = offset_extragraph;
+    offset_intragraph_ = offset_intragraph;
+    captured_ = true;
+  }
+
+  // Public members, directly accessible by at::cuda::philox::unpack.
+  // If we made them private with getters/setters, the getters/setters
+  // would have to be __device__, and we can't declare __device__ in ATen.
+  union Payload {
+    uint64_t val;
+    int64_t* ptr;
+  };
+
+  uint64_t seed_ = 0;
+  Payload offset_;
+  uint32_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
+} // namespace at
@@ -5,6 +5,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
 
@@ -139,6 +140,11 @@ Tensor elu_backward(
 }
 
 Tensor hardswish(const Tensor& self) {
+#if defined(C10_MOBILE)
+  if (xnnpack::use_hardswish(self)) {
+    return xnnpack::hardswish(self);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::unary_op(result, self);
   hardswish_stub(iter.device_type(), iter);
@@ -690,6 +696,12 @@ Tensor gelu_cpu(const Tensor& self) {
   return Y;
 }
 
+Tensor& gelu_out_cpu(Tensor& Y, const Tensor& self) {
+  auto it = TensorIterator::unary_op(Y, self);
+  GeluKernel(kCPU, it);
+  return Y;
+}
+
 Tensor gelu_backward_cpu(const Tensor& grad, const Tensor& self) {
   Tensor dX = at::native::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   auto it = TensorIterator::binary_op(dX, grad, self);
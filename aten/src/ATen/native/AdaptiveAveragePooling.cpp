@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <algorithm>
 #include <tuple>
 
 
@@ -101,6 +102,57 @@ namespace {
     });
   }
 
+  // Channels last: every input and output position is a contiguous run of
+  // channels, which the innermost loops go through.
+  template <typename scalar_t>
+  void adaptive_avg_pool2d_out_frame_channels_last(
+    scalar_t *input_p,
+    scalar_t *output_p,
+    int64_t sizeB,
+    int64_t sizeD,
+    int64_t isizeH,
+    int64_t isizeW,
+    int64_t osizeH,
+    int64_t osizeW)
+  {
+    at::parallel_for(0, sizeB * osizeH * osizeW, 0, [&](int64_t start, int64_t end) {
+      for (auto p = start; p < end; p++)
+      {
+        int64_t b = p / (osizeH * osizeW);
+        int64_t oh = (p / osizeW) % osizeH;
+        int64_t ow = p % osizeW;
+
+        int istartH = start_index(oh, osizeH, isizeH);
+        int iendH   = end_index(oh, osizeH, isizeH);
+        int kH = iendH - istartH;
+        int istartW = start_index(ow, osizeW, isizeW);
+        int iendW   = end_index(ow, osizeW, isizeW);
+        int kW = iendW - istartW;
+
+        /* local pointers */
+        scalar_t *op = output_p + p * sizeD;
+        std::fill(op, op + sizeD, scalar_t(0));
+
+        /* compute local averages: */
+        for (int ih = istartH; ih < iendH; ih++)
+        {
+          for (int iw = istartW; iw < iendW; iw++)
+          {
+            scalar_t *ip = input_p + ((b * isizeH + ih) * isizeW + iw) * sizeD;
+            for (int64_t d = 0; d < sizeD; d++)
+            {
+              op[d] += ip[d];
+            }
+          }
+        }
+        for (int64_t d = 0; d < sizeD; d++)
+        {
+          op[d] = op[d] / kW / kH;
+        }
+      }
+    });
+  }
+
   void adaptive_avg_pool2d_out_cpu_template(
     at::Tensor& output,
     at::Tensor const& input,
@@ -130,7 +182,25 @@ namespace {
     auto osizeW = output_size[1];
 
     /* resize output */
-    if (input.ndimension() == 3 || input.size(-4) == 1)
+    if (input.ndimension() == 4 && input.suggest_memory_format() == at::MemoryFormat::ChannelsLast)
+    {
+      int64_t sizeB = input.size(-4);
+      auto input_cl = input.contiguous(at::MemoryFormat::ChannelsLast);
+      output.resize_({sizeB, sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+
+      AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "adaptive_avg_pool2d_cpu", [&] {
+        auto input_data = input_cl.data_ptr<scalar_t>();
+        auto output_data = output.data_ptr<scalar_t>();
+        adaptive_avg_pool2d_out_frame_channels_last<scalar_t>(
+          input_data,
+          output_data,
+          sizeB,
+          sizeD,
+          isizeH, isizeW,
+          osizeH, osizeW);
+      });
+    }
+    else if (input.ndimension() == 3 || input.size(-4) == 1)
     {
       if (input.ndimension() == 3) {
         output.resize_({sizeD, osizeH, osizeW});
@@ -248,6 +318,56 @@ namespace {
     });
   }
 
+  template <typename scalar_t>
+  void adaptive_avg_pool2d_backward_out_frame_channels_last(
+    scalar_t *gradInput_p,
+    scalar_t *gradOutput_p,
+    int64_t sizeB,
+    int64_t sizeD,
+    int64_t isizeH,
+    int64_t isizeW,
+    int64_t osizeH,
+    int64_t osizeW)
+  {
+    /* the windows of neighbouring outputs may overlap, so that only the
+       images are split among threads */
+    at::parallel_for(0, sizeB, 0, [&](int64_t start, int64_t end) {
+      for (auto b = start; b < end; b++)
+      {
+        scalar_t *gradInput_p_b = gradInput_p + b * isizeH * isizeW * sizeD;
+        scalar_t *gradOutput_p_b = gradOutput_p + b * osizeH * osizeW * sizeD;
+
+        for (int64_t oh = 0; oh < osizeH; oh++)
+        {
+          int istartH = start_index(oh, osizeH, isizeH);
+          int iendH   = end_index(oh, osizeH, isizeH);
+          int kH = iendH - istartH;
+
+          for (int64_t ow = 0; ow < osizeW; ow++)
+          {
+            int istartW = start_index(ow, osizeW, isizeW);
+            int iendW   = end_index(ow, osizeW, isizeW);
+            int kW = iendW - istartW;
+
+            scalar_t *gop = gradOutput_p_b + (oh * osizeW + ow) * sizeD;
+            for (int ih = istartH; ih < iendH; ih++)
+            {
+              for (int iw = istartW; iw < iendW; iw++)
+              {
+                /* update gradient */
+                scalar_t *gip = gradInput_p_b + (ih * isizeW + iw) * sizeD;
+                for (int64_t d = 0; d < sizeD; d++)
+                {
+                  gip[d] += gop[d] / kH / kW;
+                }
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+
   Tensor& adaptive_avg_pool2d_backward_out_cpu_template(
     Tensor& gradInput,
     const Tensor& gradOutput_,
@@ -260,11 +380,29 @@ namespace {
     int osizeH = gradOutput_.size(-2);
     int osizeW = gradOutput_.size(-1);
 
-    /* get contiguous gradOutput */
-    auto gradOutput = gradOutput_.contiguous();
+    /* get gradOutput in the memory format of gradInput */
+    auto memory_format = gradInput.suggest_memory_format();
+    TORCH_INTERNAL_ASSERT(gradInput.is_contiguous(memory_format));
+    auto gradOutput = gradOutput_.contiguous(memory_format);
 
     /* backprop */
-    if (input.ndimension() == 3 || input.size(-4) == 1)
+    if (input.ndimension() == 4 && memory_format == at::MemoryFormat::ChannelsLast)
+    {
+      AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        input.scalar_type(), "adaptive_avg_pool2d_backward_cpu", [&] {
+          /* get raw pointers */
+          scalar_t *gradInput_data = gradInput.data_ptr<scalar_t>();
+          scalar_t *gradOutput_data = gradOutput.data_ptr<scalar_t>();
+
+          adaptive_avg_pool2d_backward_out_frame_channels_last<scalar_t>(
+            gradInput_data, gradOutput_data,
+            input.size(-4), sizeD,
+            isizeH, isizeW,
+            osizeH, osizeW);
+        }
+      );
+    }
+    else if (input.ndimension() == 3 || input.size(-4) == 1)
     {
       AT_DISPATCH_FLOATING_TYPES_AND_HALF(
         input.scalar_type(), "adaptive_avg_pool2d_backward_cpu", [&] {
@@ -347,7 +485,8 @@ namespace {
     const Tensor& gradOutput,
     const Tensor& input)
   {
-    gradInput.resize_as_(input);
+    gradInput.resize_(input.sizes(), input.suggest_memory_format());
+    gradInput.zero_();
     adaptive_avg_pool2d_backward_out_cpu_template(
       gradInput, gradOutput, input);
     return gradInput;
@@ -357,7 +496,7 @@ namespace {
     const Tensor& gradOutput,
     const Tensor& input)
   {
-    auto gradInput = at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    auto gradInput = at::zeros_like(input, input.suggest_memory_format());
     adaptive_avg_pool2d_backward_out_cpu_template(
       gradInput, gradOutput, input);
     return gradInput;
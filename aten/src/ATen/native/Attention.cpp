@@ -0,0 +1,50 @@
+#include <ATen/native/Attention.h>
+
+#include <ATen/NativeFunctions.h>
+
+#include <limits>
+
+namespace at {
+namespace native {
+
+Tensor fused_attention_math(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& key_padding_mask,
+    bool is_causal,
+    double scale) {
+  const int64_t N = query.size(0);
+  const int64_t L = query.size(1);
+  const int64_t S = key.size(1);
+  const auto neg_inf = -std::numeric_limits<double>::infinity();
+  Tensor attn = at::bmm(query, key.transpose(1, 2)).mul_(scale);
+  if (is_causal) {
+    // Query i attends keys 0..i
+    attn.masked_fill_(
+        at::ones({L, S}, query.options().dtype(kBool)).triu_(1), neg_inf);
+  }
+  if (key_padding_mask.defined()) {
+    const int64_t B = key_padding_mask.size(0);
+    attn = attn.view({B, N / B, L, S})
+               .masked_fill_(
+                   key_padding_mask.to(attn.device()).reshape({B, 1, 1, S}),
+                   neg_inf)
+               .view({N, L, S});
+  }
+  return at::bmm(at::softmax(attn, -1), value);
+}
+
+Tensor fused_attention_cpu(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& key_padding_mask,
+    bool is_causal,
+    double scale) {
+  check_fused_attention_args(query, key, value, key_padding_mask);
+  return fused_attention_math(query, key, value, key_padding_mask, is_causal, scale);
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,61 @@
+#pragma once
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// Checks shared by the CPU and CUDA implementations of _fused_attention:
+//
+//   query             [N, L, E]
+//   key, value        [N, S, E]
+//   key_padding_mask  optional bool [B, S], where N is a multiple of B (e.g.
+//                     N = B * num_heads); true masks key s out for the queries
+//                     of batch n / (N / B)
+inline void check_fused_attention_args(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& key_padding_mask) {
+  TORCH_CHECK(
+      query.dim() == 3 && key.dim() == 3 && value.dim() == 3,
+      "_fused_attention: Expected 3-D query, key and value, got ",
+      query.dim(), "-D, ", key.dim(), "-D and ", value.dim(), "-D tensors");
+  TORCH_CHECK(
+      key.sizes() == value.sizes(),
+      "_fused_attention: Expected key and value of the same sizes, got ",
+      key.sizes(), " and ", value.sizes());
+  TORCH_CHECK(
+      query.size(0) == key.size(0) && query.size(2) == key.size(2),
+      "_fused_attention: Expected query [N, L, E] and key [N, S, E], got ",
+      query.sizes(), " and ", key.sizes());
+  TORCH_CHECK(
+      query.scalar_type() == key.scalar_type() &&
+          query.scalar_type() == value.scalar_type(),
+      "_fused_attention: Expected query, key and value of the same dtype");
+  if (key_padding_mask.defined()) {
+    TORCH_CHECK(
+        key_padding_mask.scalar_type() == kBool,
+        "_fused_attention: Expected a bool key_padding_mask, got ",
+        key_padding_mask.scalar_type());
+    TORCH_CHECK(
+        key_padding_mask.dim() == 2 && key_padding_mask.size(1) == key.size(1) &&
+            key_padding_mask.size(0) > 0 &&
+            query.size(0) % key_padding_mask.size(0) == 0,
+        "_fused_attention: Expected a key_padding_mask of sizes [B, S] with N a "
+        "multiple of B, got ", key_padding_mask.sizes(), " for key of sizes ",
+        key.sizes());
+  }
+}
+
+// softmax(scale * query @ key^T, masked) @ value, materializing the [N, L, S]
+// attention matrix.
+Tensor fused_attention_math(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& key_padding_mask,
+    bool is_causal,
+    double scale);
+
+} // namespace native
+} // namespace at
@@ -1,6 +1,11 @@
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/BucketizationUtils.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <algorithm>
+#include <vector>
 
 /* Implement a TF like searchsorted and a bucketize function running on cpu
  *
@@ -43,6 +48,148 @@ const input_t* cus_lower_bound(const input_t* start, const input_t* end, input_t
   return start;
 }
 
+// minimal boundary size for which searching an Eytzinger copy beats binary search on the sorted data
+constexpr int64_t EYTZINGER_MIN_BOUNDARIES = 64;
+// number of queries walked down the tree in lock step
+constexpr int64_t EYTZINGER_INTERLEAVE = 8;
+
+// Whether the search for val continues past boundary value bd. This is the negation of the
+// predicate cus_lower_bound (right == false) or std::upper_bound (right == true) stops on.
+template<typename input_t, bool right>
+inline int64_t goes_right(input_t bd, input_t val) {
+  return right ? !(val < bd) : !(bd >= val);
+}
+
+// Sorted boundaries stored in BFS order of an implicit complete binary search tree
+// (node k has children 2k and 2k+1, the root is node 1). The top levels of the tree share a
+// few cache lines no matter how long the sequence is, and every query takes exactly `depth`
+// steps, so the descent needs no data dependent branches and several queries can be
+// interleaved to overlap their cache misses.
+//
+// The tree is padded to 2^depth - 1 nodes with copies of the last boundary. They answer
+// every comparison exactly like the last boundary does, so the search predicate stays
+// monotone, and they map to position n like falling off the right end of the tree does.
+template<typename input_t>
+struct EytzingerBoundaries {
+  EytzingerBoundaries(const input_t* sorted, int64_t n) : n(n), depth(0) {
+    while ((int64_t(1) << depth) - 1 < n) {
+      ++depth;
+    }
+    const int64_t nodes = (int64_t(1) << depth) - 1;
+    values.resize(nodes + 1);
+    positions.resize(nodes + 1);
+    positions[0] = n;
+    int64_t i = 0;
+    fill(sorted, i, 1, nodes);
+  }
+
+  template<typename output_t, bool right>
+  void search(const input_t* data_in, output_t* data_out, int64_t count) const {
+    const input_t* tree = values.data();
+    int64_t i = 0;
+    for (; i + EYTZINGER_INTERLEAVE <= count; i += EYTZINGER_INTERLEAVE) {
+      int64_t k[EYTZINGER_INTERLEAVE];
+      for (int64_t j = 0; j < EYTZINGER_INTERLEAVE; ++j) {
+        k[j] = 1;
+      }
+      for (int64_t level = 0; level < depth; ++level) {
+        for (int64_t j = 0; j < EYTZINGER_INTERLEAVE; ++j) {
+          k[j] = 2 * k[j] + goes_right<input_t, right>(tree[k[j]], data_in[i + j]);
+        }
+      }
+      for (int64_t j = 0; j < EYTZINGER_INTERLEAVE; ++j) {
+        data_out[i + j] = position(k[j]);
+      }
+    }
+    for (; i < count; ++i) {
+      int64_t k = 1;
+      for (int64_t level = 0; level < depth; ++level) {
+        k = 2 * k + goes_right<input_t, right>(tree[k], data_in[i]);
+      }
+      data_out[i] = position(k);
+    }
+  }
+
+ private:
+  // in-order walk of the tree assigns the sorted positions
+  void fill(const input_t* sorted, int64_t& i, int64_t k, int64_t nodes) {
+    if (k > nodes) {
+      return;
+    }
+    fill(sorted, i, 2 * k, nodes);
+    values[k] = sorted[std::min(i, n - 1)];
+    positions[k] = std::min(i, n);
+    ++i;
+    fill(sorted, i, 2 * k + 1, nodes);
+  }
+
+  // The leaf reached encodes the path taken; the answer is the last node where the search
+  // went left, found by dropping the trailing right turns and that left turn. A search that
+  // only went right ends at node 0.
+  int64_t position(int64_t k) const {
+    k >>= llvm::countTrailingOnes(static_cast<uint64_t>(k)) + 1;
+    return positions[k];
+  }
+
+  int64_t n;
+  int64_t depth;
+  std::vector<input_t> values;
+  std::vector<int64_t> positions;
+};
+
+// The Eytzinger search relies on the search predicate being monotone along the boundaries,
+// which NaN boundaries (sorted to the end) break; leave those to the plain binary search.
+template<typename input_t>
+bool eytzinger_applicable(const input_t* data_bd, int64_t idim_bd) {
+  return idim_bd >= EYTZINGER_MIN_BOUNDARIES && !_isnan(data_bd[idim_bd - 1]);
+}
+
+template<typename input_t, typename output_t, bool right>
+void eytzinger_search(const input_t* data_bd, int64_t idim_bd, const input_t* data_in, output_t* data_out, int64_t count) {
+  EytzingerBoundaries<input_t>(data_bd, idim_bd).template search<output_t, right>(data_in, data_out, count);
+}
+
+// Searches with boundaries shared by many values: 1D boundaries are laid out once and the
+// values are split across threads, N-D boundaries are laid out per row when each row serves
+// at least as many values as it has boundaries. Returns false when neither applies.
+template<typename input_t, typename output_t, bool right>
+bool searchsorted_cpu_eytzinger(
+    const input_t* data_in, const input_t* data_bd, output_t* data_out,
+    int64_t numel_in, int64_t idim_in, int64_t idim_bd, bool is_1d_boundaries) {
+  if (is_1d_boundaries) {
+    if (numel_in < idim_bd || !eytzinger_applicable(data_bd, idim_bd)) {
+      return false;
+    }
+    const EytzingerBoundaries<input_t> tree(data_bd, idim_bd);
+    at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
+      tree.template search<output_t, right>(data_in + start, data_out + start, end - start);
+    });
+    return true;
+  }
+
+  if (idim_in < idim_bd || idim_bd < EYTZINGER_MIN_BOUNDARIES) {
+    return false;
+  }
+  const int64_t rows = numel_in / idim_in;
+  at::parallel_for(0, rows, 1, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; ++row) {
+      const input_t* row_bd = data_bd + row * idim_bd;
+      const input_t* row_in = data_in + row * idim_in;
+      output_t* row_out = data_out + row * idim_in;
+      if (eytzinger_applicable(row_bd, idim_bd)) {
+        eytzinger_search<input_t, output_t, right>(row_bd, idim_bd, row_in, row_out, idim_in);
+      } else {
+        for (int64_t i = 0; i < idim_in; ++i) {
+          row_out[i] = right ?
+            std::upper_bound(row_bd, row_bd + idim_bd, row_in[i]) - row_bd :
+            cus_lower_bound(row_bd, row_bd + idim_bd, row_in[i]) - row_bd;
+        }
+      }
+    }
+  });
+  return true;
+}
+
 template<typename input_t, typename output_t>
 void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries, const bool& right) {
   int64_t numel_in = input.numel();
@@ -56,6 +203,15 @@ void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tens
   output_t *data_out = result.data_ptr<output_t>();
 
   bool is_1d_boundaries = boundaries.dim() == 1;
+  bool searched = right ?
+    searchsorted_cpu_eytzinger<input_t, output_t, true>(
+      data_in, data_bd, data_out, numel_in, idim_in, idim_bd, is_1d_boundaries) :
+    searchsorted_cpu_eytzinger<input_t, output_t, false>(
+      data_in, data_bd, data_out, numel_in, idim_in, idim_bd, is_1d_boundaries);
+  if (searched) {
+    return;
+  }
+
   at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
       // If boundaries tensor is 1d, we always search the entire boundary tensor
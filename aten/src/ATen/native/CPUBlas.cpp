@@ -86,6 +86,7 @@ fbgemm::matrix_op_t to_fbgemm(TransposeType trans) {
 }  // namespace (anonymous)
 
 DEFINE_DISPATCH(gemm_stub);
+DEFINE_DISPATCH(gemm_batched_small_stub);
 
 void gemm(
     TransposeType transa, TransposeType transb,
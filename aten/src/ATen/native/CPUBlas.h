@@ -34,6 +34,25 @@ using gemm_fn = void(*)(
 
 DECLARE_DISPATCH(gemm_fn, gemm_stub);
 
+// The largest number of rows, columns and inner products of the matrices that
+// gemm_batched_small takes.
+constexpr int64_t gemm_small_max_size = 32;
+
+// c[i] = beta * c[i] + alpha * (a[i] @ b[i]) for a batch of row-major
+// matrices too small for a gemm call per matrix to pay off. The rows of b and
+// c are contiguous, and the elements of a have any strides. c is not read
+// when beta is 0.
+using gemm_batched_small_fn = void(*)(
+    at::ScalarType type,
+    int64_t batch, int64_t m, int64_t n, int64_t k,
+    Scalar alpha,
+    const void *a, int64_t a_batch_stride, int64_t a_row_stride, int64_t a_col_stride,
+    const void *b, int64_t b_batch_stride, int64_t ldb,
+    Scalar beta,
+    void *c, int64_t c_batch_stride, int64_t ldc);
+
+DECLARE_DISPATCH(gemm_batched_small_fn, gemm_batched_small_stub);
+
 template <typename scalar_t>
 void gemm(
     TransposeType transa, TransposeType transb,
@@ -2,6 +2,7 @@
 
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <c10/util/Exception.h>
 
 #include <algorithm>
@@ -24,6 +25,12 @@ Tensor channel_shuffle(const Tensor& self, int64_t groups) {
              c, " channels and ", groups, " groups.");
   int64_t oc = c / groups;
 
+#if defined(C10_MOBILE)
+  if (xnnpack::use_channel_shuffle(self, groups)) {
+    return xnnpack::channel_shuffle(self, groups);
+  }
+#endif
+
   auto input_reshaped = self.view({b, groups, oc, -1});
   // TODO: contiguous can be made to preserve the memory format
   // of the input. However since the above reshape clobbers h and w
@@ -46,6 +46,7 @@ struct ConvParams {
   bool use_miopen(const at::Tensor& input, const at::Tensor& weight, bool bias_defined) const;
   bool use_mkldnn(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_nnpack(const at::Tensor& input) const;
+  bool use_cpu_winograd3x3(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_xnnpack(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool is_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
 };
@@ -254,6 +255,26 @@ auto ConvParams::use_nnpack(const at::Tensor& input) const -> bool {
   return false;
 }
 
+// See NOTE [ Winograd convolution on CPU ]. The transforms of the tiles only
+// pay off with enough channels to reuse them in the batched products, and
+// enough output tiles to split among threads.
+auto ConvParams::use_cpu_winograd3x3(const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  return input.device().is_cpu() &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         input.ndimension() == 4 &&
+         weight.ndimension() == 4 &&
+         weight.size(2) == 3 &&
+         weight.size(3) == 3 &&
+         !transposed &&
+         !is_strided() &&
+         !is_dilated() &&
+         !is_padding_neg() &&
+         padding[0] <= 2 && padding[1] <= 2 &&
+         input.size(1) >= 4 &&
+         weight.size(0) >= 4 &&
+         (input.size(2) + 2 * padding[0] - 2) * (input.size(3) + 2 * padding[1] - 2) >= 16;
+}
+
 auto ConvParams::use_xnnpack(
     const at::Tensor& input,
     const at::Tensor& weight,
@@ -836,6 +857,8 @@ at::Tensor _convolution_nogroup(
           return at::_nnpack_spatial_convolution(
               input, weight, bias, padding, stride);
 #endif
+        } else if (params.use_cpu_winograd3x3(input, weight)) {
+          return at::_winograd_conv2d(input, weight, bias, padding);
         } else {
           /* CPU implementation has specialized MM kernels
              for non-dilated case here */
@@ -0,0 +1,185 @@
+#include <ATen/native/CrossEntropy.h>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Reduction.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace at {
+namespace native {
+
+void check_fused_cross_entropy_inputs(const Tensor& self, const Tensor& target) {
+  TORCH_CHECK(self.dim() == 2,
+      "_fused_cross_entropy: expected 2-D logits of shape (N, C), but got ", self.dim(), "-D");
+  TORCH_CHECK(self.size(0) == 0 || self.size(1) > 0,
+      "_fused_cross_entropy: expected at least one class");
+  TORCH_CHECK(target.dim() == 1 && target.size(0) == self.size(0),
+      "_fused_cross_entropy: expected a target of shape (", self.size(0), "), but got ", target.sizes());
+  TORCH_CHECK(target.scalar_type() == ScalarType::Long,
+      "_fused_cross_entropy: expected a target of dtype Long, but got ", target.scalar_type());
+  TORCH_CHECK(target.device() == self.device(),
+      "_fused_cross_entropy: expected self and target on the same device");
+}
+
+Tensor fused_cross_entropy_reduce(
+    const Tensor& losses, const Tensor& target, int64_t reduction,
+    int64_t ignore_index, ScalarType dtype) {
+  if (reduction == Reduction::None) {
+    return losses.to(dtype);
+  }
+  auto total = losses.sum();
+  if (reduction == Reduction::Mean) {
+    total = total / target.ne(ignore_index).sum().to(total.scalar_type());
+  }
+  return total.to(dtype);
+}
+
+Tensor fused_cross_entropy_grad_scale(
+    const Tensor& grad_output, const Tensor& target, int64_t reduction,
+    int64_t ignore_index, ScalarType acc_type) {
+  auto scale = grad_output.to(acc_type);
+  if (reduction == Reduction::None) {
+    return scale.contiguous();
+  }
+  if (reduction == Reduction::Mean) {
+    scale = scale / target.ne(ignore_index).sum().to(acc_type);
+  }
+  return scale.expand({target.size(0)}).contiguous();
+}
+
+namespace {
+
+// Classes are processed in chunks of this size: the max of a chunk is found
+// first, then the running sum of exps is rescaled to it (if it grew) and the
+// exps of the chunk are added, all while the chunk is in cache.
+constexpr int64_t kCrossEntropyChunkSize = 2048;
+
+template <typename scalar_t, typename acc_t>
+void fused_cross_entropy_cpu_kernel(
+    const Tensor& input, const Tensor& target, Tensor& losses, Tensor& logsumexp,
+    int64_t ignore_index) {
+  const int64_t batch_size = input.size(0);
+  const int64_t n_classes = input.size(1);
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  acc_t* losses_data = losses.data_ptr<acc_t>();
+  acc_t* logsumexp_data = logsumexp.data_ptr<acc_t>();
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, n_classes));
+
+  at::parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* row = input_data + i * n_classes;
+      acc_t max_input = -std::numeric_limits<acc_t>::infinity();
+      acc_t sum = 0;
+      for (int64_t chunk_begin = 0; chunk_begin < n_classes; chunk_begin += kCrossEntropyChunkSize) {
+        const int64_t chunk_end = std::min(chunk_begin + kCrossEntropyChunkSize, n_classes);
+        acc_t chunk_max = -std::numeric_limits<acc_t>::infinity();
+        for (int64_t j = chunk_begin; j < chunk_end; j++) {
+          chunk_max = std::max(chunk_max, static_cast<acc_t>(row[j]));
+        }
+        if (chunk_max > max_input) {
+          sum *= std::exp(max_input - chunk_max);
+          max_input = chunk_max;
+        }
+        if (max_input == -std::numeric_limits<acc_t>::infinity()) {
+          // Every logit so far is -inf and adds nothing to the sum
+          continue;
+        }
+        for (int64_t j = chunk_begin; j < chunk_end; j++) {
+          sum += std::exp(static_cast<acc_t>(row[j]) - max_input);
+        }
+      }
+      const acc_t lse = max_input + std::log(sum);
+      logsumexp_data[i] = lse;
+
+      const int64_t cur_target = target_data[i];
+      if (cur_target == ignore_index) {
+        losses_data[i] = 0;
+        continue;
+      }
+      TORCH_CHECK(cur_target >= 0 && cur_target < n_classes,
+          "_fused_cross_entropy: target ", cur_target, " is out of bounds.");
+      losses_data[i] = lse - static_cast<acc_t>(row[cur_target]);
+    }
+  });
+}
+
+template <typename scalar_t, typename acc_t>
+void fused_cross_entropy_backward_cpu_kernel(
+    Tensor& grad_input, const Tensor& grad_scale, const Tensor& input, const Tensor& target,
+    const Tensor& logsumexp, int64_t ignore_index) {
+  const int64_t batch_size = input.size(0);
+  const int64_t n_classes = input.size(1);
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+  const acc_t* grad_scale_data = grad_scale.data_ptr<acc_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  const acc_t* logsumexp_data = logsumexp.data_ptr<acc_t>();
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, n_classes));
+
+  at::parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* row = input_data + i * n_classes;
+      scalar_t* grad_row = grad_input_data + i * n_classes;
+      const int64_t cur_target = target_data[i];
+      if (cur_target == ignore_index) {
+        std::fill(grad_row, grad_row + n_classes, scalar_t(0));
+        continue;
+      }
+      TORCH_CHECK(cur_target >= 0 && cur_target < n_classes,
+          "_fused_cross_entropy_backward: target ", cur_target, " is out of bounds.");
+      const acc_t scale = grad_scale_data[i];
+      const acc_t lse = logsumexp_data[i];
+      for (int64_t j = 0; j < n_classes; j++) {
+        const acc_t prob = std::exp(static_cast<acc_t>(row[j]) - lse);
+        grad_row[j] = static_cast<scalar_t>(scale * (j == cur_target ? prob - 1 : prob));
+      }
+    }
+  });
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> fused_cross_entropy_cpu(
+    const Tensor& self, const Tensor& target, int64_t reduction, int64_t ignore_index) {
+  check_fused_cross_entropy_inputs(self, target);
+  const auto input = self.contiguous();
+  const auto target_ = target.contiguous();
+  const auto acc_options = input.options().dtype(toAccumulateType(input.scalar_type(), /*is_cuda=*/false));
+  auto losses = at::empty({input.size(0)}, acc_options);
+  auto logsumexp = at::empty({input.size(0)}, acc_options);
+  AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, input.scalar_type(), "fused_cross_entropy_cpu", [&] {
+    using acc_t = acc_type<scalar_t, false>;
+    fused_cross_entropy_cpu_kernel<scalar_t, acc_t>(input, target_, losses, logsumexp, ignore_index);
+  });
+  return std::make_tuple(
+      fused_cross_entropy_reduce(losses, target_, reduction, ignore_index, self.scalar_type()),
+      logsumexp);
+}
+
+Tensor fused_cross_entropy_backward_cpu(
+    const Tensor& grad_output, const Tensor& self, const Tensor& target,
+    const Tensor& logsumexp, int64_t reduction, int64_t ignore_index) {
+  check_fused_cross_entropy_inputs(self, target);
+  TORCH_CHECK(logsumexp.dim() == 1 && logsumexp.size(0) == self.size(0),
+      "_fused_cross_entropy_backward: expected the logsumexp returned by _fused_cross_entropy");
+  const auto input = self.contiguous();
+  const auto target_ = target.contiguous();
+  const auto logsumexp_ = logsumexp.contiguous();
+  auto grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  AT_DISPATCH_FLOATING_TYPES_AND(ScalarType::BFloat16, input.scalar_type(), "fused_cross_entropy_backward_cpu", [&] {
+    using acc_t = acc_type<scalar_t, false>;
+    const auto grad_scale = fused_cross_entropy_grad_scale(
+        grad_output, target_, reduction, ignore_index, logsumexp_.scalar_type());
+    fused_cross_entropy_backward_cpu_kernel<scalar_t, acc_t>(
+        grad_input, grad_scale, input, target_, logsumexp_, ignore_index);
+  });
+  return grad_input;
+}
+
+} // namespace native
+} // namespace at
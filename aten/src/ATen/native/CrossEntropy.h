@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Shared by the CPU and CUDA implementations of _fused_cross_entropy.
+//
+// The kernels compute, for every row i of the (N, C) logits, the log-sum-exp
+// lse_i of the row with an online reduction over the classes, and the loss
+// lse_i - logits[i, target[i]] (0 for rows whose target is ignore_index).
+// The backward computes grad_scale_i * (exp(logits[i, j] - lse_i) - [j == target[i]]),
+// so only the N log-sum-exps are kept between forward and backward.
+
+void check_fused_cross_entropy_inputs(const Tensor& self, const Tensor& target);
+
+// Applies `reduction` to the per row losses (in the accumulate type)
+Tensor fused_cross_entropy_reduce(
+    const Tensor& losses, const Tensor& target, int64_t reduction,
+    int64_t ignore_index, ScalarType dtype);
+
+// Per row scale of the gradient (in the accumulate type): grad_output, which
+// is a scalar unless reduction is None, divided by the number of rows that
+// aren't ignored if reduction is Mean
+Tensor fused_cross_entropy_grad_scale(
+    const Tensor& grad_output, const Tensor& target, int64_t reduction,
+    int64_t ignore_index, ScalarType acc_type);
+
+}} // namespace at::native
@@ -3,6 +3,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/native/Pool.h>
+#include <algorithm>
 #include <tuple>
 
 
@@ -118,6 +119,74 @@ static void max_pool2d_with_indices_out_frame(
   });
 }
 
+// Channels last: every input and output position is a contiguous run of
+// channels, which the innermost loops go through. The indices are the same as
+// in the contiguous layout, the position of the max in its plane.
+template <typename scalar_t>
+static void max_pool2d_with_indices_out_frame_channels_last(
+          scalar_t *input_data,
+          scalar_t *output_data,
+          int64_t *indices_data,
+          int64_t nbatch,
+          int64_t nInputPlane,
+          int64_t inputWidth,
+          int64_t inputHeight,
+          int64_t outputWidth,
+          int64_t outputHeight,
+          int kW,
+          int kH,
+          int dW,
+          int dH,
+          int padW,
+          int padH,
+          int dilationW,
+          int dilationH)
+{
+  at::parallel_for(0, nbatch * outputHeight * outputWidth, 0, [&](int64_t start, int64_t end) {
+    for (auto p = start; p < end; p++)
+    {
+      int64_t n = p / (outputHeight * outputWidth);
+      int64_t i = (p / outputWidth) % outputHeight;
+      int64_t j = p % outputWidth;
+
+      int64_t hstart = i * dH - padH;
+      int64_t wstart = j * dW - padW;
+      int64_t hend = std::min(hstart + (kH - 1) * dilationH + 1, inputHeight);
+      int64_t wend = std::min(wstart + (kW - 1) * dilationW + 1, inputWidth);
+      while(hstart < 0)
+        hstart += dilationH;
+      while(wstart < 0)
+        wstart += dilationW;
+
+      /* local pointers */
+      scalar_t *ip = input_data + n * inputHeight * inputWidth * nInputPlane;
+      scalar_t *op = output_data + p * nInputPlane;
+      int64_t *indp = indices_data + p * nInputPlane;
+
+      /* compute local max: */
+      std::fill(op, op + nInputPlane, -std::numeric_limits<scalar_t>::infinity());
+      std::fill(indp, indp + nInputPlane, hstart * inputWidth + wstart);
+      for(int64_t y = hstart; y < hend; y += dilationH)
+      {
+        for(int64_t x = wstart; x < wend; x += dilationW)
+        {
+          int64_t tcntr = y * inputWidth + x;
+          scalar_t *vals = ip + tcntr * nInputPlane;
+          for (int64_t k = 0; k < nInputPlane; k++)
+          {
+            scalar_t val = vals[k];
+            if ((val > op[k]) || std::isnan(val))
+            {
+              op[k] = val;
+              indp[k] = tcntr;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
 void max_pool2d_with_indices_out_cpu_template(
           Tensor& output,
           Tensor& indices,
@@ -171,11 +240,39 @@ void max_pool2d_with_indices_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
-  /* get contiguous input */
-  Tensor input = input_.contiguous();
+  /* get input contiguous in its memory format */
+  const auto memory_format = input_.suggest_memory_format();
+  Tensor input = input_.contiguous(memory_format);
 
   /* resize output */
-  if (input.ndimension() == 3)
+  if (input.ndimension() == 4 && memory_format == at::MemoryFormat::ChannelsLast)
+  {
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, memory_format);
+    /* indices will contain the locations for each output point */
+    indices.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, memory_format);
+
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
+      "max_pool2d_with_indices_cpu",
+      [&] {
+        scalar_t *input_data = input.data_ptr<scalar_t>();
+        scalar_t *output_data = output.data_ptr<scalar_t>();
+        int64_t *indices_data = indices.data_ptr<int64_t>();
+
+        max_pool2d_with_indices_out_frame_channels_last(
+          input_data,
+          output_data,
+          indices_data,
+          nbatch,
+          nInputPlane,
+          inputWidth, inputHeight,
+          outputWidth, outputHeight,
+          kW, kH, dW, dH,
+          padW, padH,
+          dilationW, dilationH);
+      }
+    );
+  }
+  else if (input.ndimension() == 3)
   {
     output.resize_({nInputPlane, outputHeight, outputWidth});
     /* indices will contain the locations for each output point */
@@ -295,11 +392,48 @@ static void max_pool2d_with_indices_backward_out_frame(
   });
 }
 
+template <typename scalar_t>
+static void max_pool2d_with_indices_backward_out_frame_channels_last(
+          scalar_t *gradInput_data,
+          scalar_t *gradOutput_data,
+          int64_t *indices_data,
+          int64_t nbatch,
+          int64_t nInputPlane,
+          int64_t inputWidth,
+          int64_t inputHeight,
+          int64_t outputWidth,
+          int64_t outputHeight)
+{
+  /* the windows of neighbouring outputs may overlap, so that only the
+     images are split among threads */
+  at::parallel_for(0, nbatch, 0, [&](int64_t start, int64_t end) {
+    for (auto n = start; n < end; n++)
+    {
+      scalar_t *gradInput_p = gradInput_data + n * inputHeight * inputWidth * nInputPlane;
+      scalar_t *gradOutput_p = gradOutput_data + n * outputHeight * outputWidth * nInputPlane;
+      int64_t *ind_p = indices_data + n * outputHeight * outputWidth * nInputPlane;
+
+      for (int64_t p = 0; p < outputHeight * outputWidth * nInputPlane; p += nInputPlane)
+      {
+        for (int64_t k = 0; k < nInputPlane; k++)
+        {
+          /* retrieve position of max */
+          int64_t maxp = ind_p[p + k];
+          if (maxp != -1) {
+            /* update gradient */
+            gradInput_p[maxp * nInputPlane + k] += gradOutput_p[p + k];
+          }
+        }
+      }
+    }
+  });
+}
+
 Tensor& max_pool2d_with_indices_backward_out_cpu_template(
           Tensor& gradInput,
           const Tensor& gradOutput_,
           const Tensor& input,
-          const Tensor& indices,
+          const Tensor& indices_,
           IntArrayRef kernel_size,
           IntArrayRef stride,
           IntArrayRef padding,
@@ -333,11 +467,13 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   TORCH_CHECK((input.ndimension() == 3 || input.ndimension() == 4),
     "non-empty 3D or 4D (batch mode) tensor expected for input");
 
-  /* get contiguous gradOutput */
-  const Tensor gradOutput = gradOutput_.contiguous();
+  /* get gradOutput and indices contiguous in the memory format of input */
+  const auto memory_format = input.suggest_memory_format();
+  const Tensor gradOutput = gradOutput_.contiguous(memory_format);
+  const Tensor indices = indices_.contiguous(memory_format);
 
   /* resize */
-  gradInput.resize_as_(input);
+  gradInput.resize_(input.sizes(), memory_format);
   gradInput.zero_();
 
   /* sizes */
@@ -363,7 +499,27 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
     outputHeight_for_shape_check, outputWidth_for_shape_check);
 
   /* backprop */
-  if (input.ndimension() == 3)
+  if (input.ndimension() == 4 && memory_format == at::MemoryFormat::ChannelsLast)
+  {
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
+      "max_pool2d_with_indices_backward",
+      [&] {
+        /* get raw pointers */
+        scalar_t *gradInput_data = gradInput.data_ptr<scalar_t>();
+        scalar_t *gradOutput_data = gradOutput.data_ptr<scalar_t>();
+        int64_t *indices_data = indices.data_ptr<int64_t>();
+
+        max_pool2d_with_indices_backward_out_frame_channels_last<scalar_t>(
+          gradInput_data, gradOutput_data,
+          indices_data,
+          nbatch,
+          nInputPlane,
+          inputWidth, inputHeight,
+          outputWidth, outputHeight);
+      }
+    );
+  }
+  else if (input.ndimension() == 3)
   {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
       "max_pool2d_with_indices_backward",
@@ -495,7 +651,7 @@ Tensor max_pool2d_with_indices_backward_cpu(
   bool ceil_mode,
   const Tensor& indices)
 {
-  auto gradInput = at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto gradInput = at::zeros_like(input, input.suggest_memory_format());
   max_pool2d_with_indices_backward_out_cpu_template(
     gradInput,
     gradOutput_,
@@ -3,8 +3,11 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/Distance.h>
 
+#include <algorithm>
+
 namespace at { namespace native {
 
 DEFINE_DISPATCH(pdist_forward_stub);
@@ -29,12 +32,18 @@ Tensor _euclidean_dist(const Tensor& x1, const Tensor& x2) {
   /** This function does the fist part of the euclidean distance calculation
    * We divide it in two steps to simplify dealing with subgradients in the 
    * backward step */
-  Tensor x1_norm = x1.pow(2).sum(-1, true);
+  // |x1|^2 - 2 x1.x2 + |x2|^2 cancels catastrophically for points that are
+  // close to each other but far from the origin. Translating both inputs by
+  // the mean of x2 leaves the distances unchanged and keeps the norms small.
+  Tensor center = x2.mean(-2, true);
+  Tensor x1_c = x1 - center;
+  Tensor x2_c = x2 - center;
+  Tensor x1_norm = x1_c.pow(2).sum(-1, true);
   Tensor x1_pad = at::ones_like(x1_norm, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor x2_norm = x2.pow(2).sum(-1, true);
+  Tensor x2_norm = x2_c.pow(2).sum(-1, true);
   Tensor x2_pad = at::ones_like(x2_norm, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor x1_ = at::cat({x1.mul(-2), x1_norm, x1_pad}, -1);
-  Tensor x2_ = at::cat({x2, x2_pad, x2_norm}, -1);
+  Tensor x1_ = at::cat({x1_c.mul(-2), x1_norm, x1_pad}, -1);
+  Tensor x2_ = at::cat({x2_c, x2_pad, x2_norm}, -1);
   Tensor result = x1_.matmul(x2_.transpose(-2, -1));
   result.clamp_min_(0).sqrt_();
   return result;
@@ -135,6 +144,93 @@ Tensor _cdist_forward(const Tensor& x1, const Tensor& x2, const double p, c10::o
   return result;
 }
 
+// k nearest neighbours of every row of x1 among the rows of x2. Distances are
+// computed one kRowBlock x kColBlock tile at a time (through cdist, so p = 2
+// goes through GEMM) and folded into a bounded max-heap per row, so memory
+// stays O(kRowBlock * kColBlock) per thread instead of O(n * m).
+std::tuple<Tensor, Tensor> _cdist_topk_cpu(const Tensor& x1, const Tensor& x2, int64_t k, double p) {
+  TORCH_CHECK(x1.dim() == x2.dim() && (x1.dim() == 2 || x1.dim() == 3),
+      "_cdist_topk expects two 2D or two 3D tensors, got: ", x1.dim(), "D and ", x2.dim(), "D");
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()) && x1.scalar_type() == x2.scalar_type(),
+      "_cdist_topk expects X1 and X2 of the same floating-point dtype, got: ", x1.scalar_type(),
+      " and ", x2.scalar_type());
+  TORCH_CHECK(x1.size(-1) == x2.size(-1),
+      "X1 and X2 must have the same number of columns. X1: ", x1.size(-1), " X2: ", x2.size(-1));
+  TORCH_CHECK(x1.dim() == 2 || x1.size(0) == x2.size(0),
+      "X1 and X2 must have the same batch size. X1: ", x1.size(0), " X2: ", x2.size(0));
+  TORCH_CHECK(p >= 0, "_cdist_topk only supports non-negative p values");
+  TORCH_CHECK(k >= 0 && k <= x2.size(-2), "k (", k, ") must be between 0 and the number of rows of X2 (",
+      x2.size(-2), ")");
+
+  const Tensor x1_b = (x1.dim() == 2 ? x1.unsqueeze(0) : x1).contiguous();
+  const Tensor x2_b = (x2.dim() == 2 ? x2.unsqueeze(0) : x2).contiguous();
+  const int64_t batch = x1_b.size(0);
+  const int64_t n = x1_b.size(1);
+  const int64_t m = x2_b.size(1);
+  Tensor values = at::empty({batch, n, k}, x1.options());
+  Tensor indices = at::empty({batch, n, k}, x1.options().dtype(kLong));
+
+  constexpr int64_t kRowBlock = 64;
+  constexpr int64_t kColBlock = 2048;
+  const int64_t row_blocks = (n + kRowBlock - 1) / kRowBlock;
+  if (k > 0 && n > 0) {
+    AT_DISPATCH_FLOATING_TYPES(x1.scalar_type(), "_cdist_topk", [&] {
+      using entry_t = std::pair<scalar_t, int64_t>;
+      auto values_data = values.data_ptr<scalar_t>();
+      auto indices_data = indices.data_ptr<int64_t>();
+      at::parallel_for(0, batch * row_blocks, 1, [&](int64_t begin, int64_t end) {
+        // heaps[i * k, (i + 1) * k) is a max-heap of the k best candidates of row i
+        std::vector<entry_t> heaps(kRowBlock * k);
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t b = block / row_blocks;
+          const int64_t r0 = (block % row_blocks) * kRowBlock;
+          const int64_t rows = std::min(kRowBlock, n - r0);
+          const Tensor x1_rows = x1_b[b].narrow(0, r0, rows);
+          std::vector<int64_t> heap_sizes(rows, 0);
+
+          for (int64_t c0 = 0; c0 < m; c0 += kColBlock) {
+            const int64_t cols = std::min(kColBlock, m - c0);
+            const Tensor tile = at::cdist(x1_rows, x2_b[b].narrow(0, c0, cols), p).contiguous();
+            const scalar_t* tile_data = tile.data_ptr<scalar_t>();
+            for (int64_t i = 0; i < rows; ++i) {
+              entry_t* heap = heaps.data() + i * k;
+              int64_t& size = heap_sizes[i];
+              const scalar_t* dist = tile_data + i * cols;
+              for (int64_t j = 0; j < cols; ++j) {
+                const entry_t candidate(dist[j], c0 + j);
+                if (size < k) {
+                  heap[size++] = candidate;
+                  std::push_heap(heap, heap + size);
+                } else if (candidate < heap[0]) {
+                  std::pop_heap(heap, heap + k);
+                  heap[k - 1] = candidate;
+                  std::push_heap(heap, heap + k);
+                }
+              }
+            }
+          }
+
+          for (int64_t i = 0; i < rows; ++i) {
+            entry_t* heap = heaps.data() + i * k;
+            std::sort_heap(heap, heap + k);
+            const int64_t offset = (b * n + r0 + i) * k;
+            for (int64_t j = 0; j < k; ++j) {
+              values_data[offset + j] = heap[j].first;
+              indices_data[offset + j] = heap[j].second;
+            }
+          }
+        }
+      });
+    });
+  }
+
+  if (x1.dim() == 2) {
+    values.squeeze_(0);
+    indices.squeeze_(0);
+  }
+  return std::make_tuple(values, indices);
+}
+
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
@@ -898,5 +898,165 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+// Fused embedding_bag backward and optimizer step.
+//
+// Applies the gradient of the embedding_bag output, `grad`, straight to the
+// rows of `weight` that the bags looked up, without materializing the dense
+// or sparse gradient of `weight`. The positions of `indices` are grouped by
+// row, and every row is visited by one thread, which sums the gradient of the
+// row into a buffer of size embedding_dim and hands it to `update_row`. Rows
+// that are looked up several times get one update with their total gradient,
+// as with a coalesced sparse gradient.
+template <typename scalar_t, typename update_t>
+static void embedding_bag_fused_update(
+    const Tensor& weight,
+    const Tensor& grad_,
+    const Tensor& indices_,
+    const Tensor& offsets_,
+    int64_t mode,
+    const Tensor& per_sample_weights_,
+    bool include_last_offset,
+    const update_t& update_row) {
+  TORCH_CHECK(weight.dim() == 2 && weight.is_contiguous(),
+      "embedding_bag: expected a contiguous 2-D weight to update in place");
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      "embedding_bag: fused updates only support mode='sum' and mode='mean'");
+  auto indices_arg = TensorArg(indices_, "indices", 1);
+  checkScalarType("embedding_bag", indices_arg, kLong);
+  checkDim("embedding_bag", indices_arg, 1);
+  auto offsets_arg = TensorArg(offsets_, "offsets", 1);
+  checkScalarType("embedding_bag", offsets_arg, kLong);
+  checkDim("embedding_bag", offsets_arg, 1);
+
+  auto indices = indices_.contiguous();
+  auto offsets = offsets_.contiguous();
+  auto grad = grad_.contiguous();
+  const int64_t num_indices = indices.numel();
+  const int64_t num_bags =
+      include_last_offset ? offsets.numel() - 1 : offsets.numel();
+  const int64_t ddim = weight.size(1);
+  TORCH_CHECK(grad.dim() == 2 && grad.size(0) == num_bags && grad.size(1) == ddim,
+      "embedding_bag: expected grad of size [", num_bags, ", ", ddim,
+      "], but got ", grad.sizes());
+  TORCH_CHECK(grad.scalar_type() == weight.scalar_type(),
+      "embedding_bag: expected grad to have the dtype of weight");
+
+  const scalar_t* per_sample_weights_data = nullptr;
+  Tensor per_sample_weights;
+  if (per_sample_weights_.defined()) {
+    TORCH_CHECK(mode == MODE_SUM,
+        "embedding_bag: per_sample_weights only supported with mode='sum'");
+    per_sample_weights = per_sample_weights_.contiguous();
+    TORCH_CHECK(per_sample_weights.numel() == num_indices &&
+        per_sample_weights.scalar_type() == weight.scalar_type(),
+        "embedding_bag: expected one per_sample_weight per index, with the "
+        "dtype of weight");
+    per_sample_weights_data = per_sample_weights.data_ptr<scalar_t>();
+  }
+
+  // Bag of every position of indices, and the pooling scale of mode='mean'.
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  std::vector<int64_t> offset2bag(num_indices);
+  std::vector<scalar_t> bag_scale(num_bags, 1);
+  for (int64_t b = 0; b < num_bags; b++) {
+    const int64_t begin = offsets_data[b];
+    const int64_t end = b + 1 < offsets.numel() ? offsets_data[b + 1] : num_indices;
+    TORCH_CHECK(0 <= begin && begin <= end && end <= num_indices,
+        "embedding_bag: offsets must be increasing and within the indices");
+    std::fill(offset2bag.begin() + begin, offset2bag.begin() + end, b);
+    if (mode == MODE_MEAN && end > begin) {
+      bag_scale[b] = scalar_t(1) / (end - begin);
+    }
+  }
+
+  auto ind_sort = indices.sort();
+  const int64_t* sorted_data = std::get<0>(ind_sort).data_ptr<int64_t>();
+  const int64_t* perm_data = std::get<1>(ind_sort).data_ptr<int64_t>();
+  std::vector<int64_t> group_end;
+  for (int64_t i = 1; i <= num_indices; i++) {
+    if (i == num_indices || sorted_data[i] != sorted_data[i - 1]) {
+      group_end.push_back(i);
+    }
+  }
+  if (num_indices > 0) {
+    TORCH_CHECK(sorted_data[0] >= 0 && sorted_data[num_indices - 1] < weight.size(0),
+        "embedding_bag: index out of range in self");
+  }
+
+  const scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  const int64_t num_groups = group_end.size();
+  at::parallel_for(0, num_groups, 64, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> grad_row(ddim);
+    for (int64_t g = begin; g < end; g++) {
+      const int64_t first = g == 0 ? 0 : group_end[g - 1];
+      const int64_t row = sorted_data[first];
+      std::fill(grad_row.begin(), grad_row.end(), scalar_t(0));
+      for (int64_t k = first; k < group_end[g]; k++) {
+        const int64_t j = perm_data[k];
+        const int64_t bag = offset2bag[j];
+        scalar_t scale = bag_scale[bag];
+        if (per_sample_weights_data) {
+          scale *= per_sample_weights_data[j];
+        }
+        THBlas_axpy<scalar_t>(ddim, scale,
+            const_cast<scalar_t*>(grad_data) + bag * ddim, 1,
+            grad_row.data(), 1);
+      }
+      update_row(row, weight_data + row * ddim, grad_row.data());
+    }
+  });
+}
+
+void _embedding_bag_sgd_update_cpu_(
+    Tensor& weight, const Tensor& grad, const Tensor& indices,
+    const Tensor& offsets, int64_t mode, double lr,
+    const Tensor& per_sample_weights,
+    bool include_last_offset) {
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "_embedding_bag_sgd_update_", [&] {
+    const scalar_t neg_lr = -lr;
+    const int64_t ddim = weight.size(1);
+    embedding_bag_fused_update<scalar_t>(
+        weight, grad, indices, offsets, mode, per_sample_weights,
+        include_last_offset,
+        [&](int64_t /*row*/, scalar_t* w, scalar_t* g) {
+          THBlas_axpy<scalar_t>(ddim, neg_lr, g, 1, w, 1);
+        });
+  });
+}
+
+// Row-wise Adagrad keeps a single accumulator per row, momentum[row], which
+// sums the mean square of the row gradients:
+//   momentum[row] += mean(g * g)
+//   weight[row] -= lr * g / (sqrt(momentum[row]) + eps)
+void _embedding_bag_rowwise_adagrad_update_cpu_(
+    Tensor& weight, Tensor& momentum, const Tensor& grad,
+    const Tensor& indices, const Tensor& offsets, int64_t mode, double lr,
+    double eps, const Tensor& per_sample_weights,
+    bool include_last_offset) {
+  TORCH_CHECK(momentum.dim() == 1 && momentum.is_contiguous() &&
+      momentum.size(0) == weight.size(0) &&
+      momentum.scalar_type() == weight.scalar_type(),
+      "embedding_bag: expected a contiguous 1-D momentum with one value per "
+      "row of weight and the dtype of weight");
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "_embedding_bag_rowwise_adagrad_update_", [&] {
+    scalar_t* momentum_data = momentum.data_ptr<scalar_t>();
+    const int64_t ddim = weight.size(1);
+    embedding_bag_fused_update<scalar_t>(
+        weight, grad, indices, offsets, mode, per_sample_weights,
+        include_last_offset,
+        [&](int64_t row, scalar_t* w, scalar_t* g) {
+          scalar_t sum_sq = 0;
+          for (int64_t d = 0; d < ddim; d++) {
+            sum_sq += g[d] * g[d];
+          }
+          const scalar_t h = momentum_data[row] + sum_sq / ddim;
+          momentum_data[row] = h;
+          const scalar_t step = -lr / (std::sqrt(h) + eps);
+          THBlas_axpy<scalar_t>(ddim, step, g, 1, w, 1);
+        });
+  });
+}
 }
 } // namespace at::native
@@ -1,14 +1,171 @@
 #include <ATen/ATen.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/NativeFunctions.h>
+
 namespace at { namespace native {
 
-std::vector<Tensor> foreach_add_scalar_kernel_fallback(TensorList tensors, Scalar scalar) {
-  TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
+// Slow (per-tensor) implementations of the foreach ops. They are used for
+// CPU tensors, where each op already dispatches to a vectorized kernel, and
+// as the fallback of the CUDA kernels when a list can't use the fast route
+// (see can_use_fast_route).
+
+#define FOREACH_BINARY_OP_SCALAR(OP)                                                                      \
+void foreach_tensor_##OP##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {                     \
+  check_foreach_api_restrictions(tensors);                                                                \
+                                                                                                          \
+  for (auto& t: tensors) {                                                                                \
+    t.OP##_(scalar);                                                                                      \
+  }                                                                                                       \
+}                                                                                                         \
+                                                                                                          \
+std::vector<Tensor> foreach_tensor_##OP##_scalar_kernel_slow(TensorList tensors, Scalar scalar) {       \
+  check_foreach_api_restrictions(tensors);                                                                \
+                                                                                                          \
+  std::vector<Tensor> result;                                                                             \
+  result.reserve(tensors.size());                                                                         \
+  for (const auto& t: tensors) {                                                                          \
+    result.emplace_back(t.OP(scalar));                                                                    \
+  }                                                                                                       \
+                                                                                                          \
+  return result;                                                                                          \
+}
+
+#define FOREACH_BINARY_OP_LIST(OP)                                                                        \
+void foreach_tensor_##OP##_list_kernel_slow_(TensorList tensors1, TensorList tensors2) {                \
+  check_foreach_api_restrictions({tensors1, tensors2});                                                   \
+                                                                                                          \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                          \
+    tensors1[i].OP##_(tensors2[i]);                                                                       \
+  }                                                                                                       \
+}                                                                                                         \
+                                                                                                          \
+std::vector<Tensor> foreach_tensor_##OP##_list_kernel_slow(TensorList tensors1, TensorList tensors2) {  \
+  check_foreach_api_restrictions({tensors1, tensors2});                                                   \
+                                                                                                          \
+  std::vector<Tensor> result;                                                                             \
+  result.reserve(tensors1.size());                                                                        \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                          \
+    result.emplace_back(tensors1[i].OP(tensors2[i]));                                                     \
+  }                                                                                                       \
+                                                                                                          \
+  return result;                                                                                          \
+}
+
+#define FOREACH_BINARY_OP_LIST_ALPHA(OP)                                                                                \
+void foreach_tensor_##OP##_list_kernel_slow_(TensorList tensors1, TensorList tensors2, Scalar alpha) {                \
+  check_foreach_api_restrictions({tensors1, tensors2});                                                                 \
+                                                                                                                        \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                                        \
+    tensors1[i].OP##_(tensors2[i], alpha);                                                                              \
+  }                                                                                                                     \
+}                                                                                                                       \
+                                                                                                                        \
+std::vector<Tensor> foreach_tensor_##OP##_list_kernel_slow(TensorList tensors1, TensorList tensors2, Scalar alpha) {  \
+  check_foreach_api_restrictions({tensors1, tensors2});                                                                 \
+                                                                                                                        \
+  std::vector<Tensor> result;                                                                                           \
+  result.reserve(tensors1.size());                                                                                      \
+  for (size_t i = 0; i < tensors1.size(); i++) {                                                                        \
+    result.emplace_back(tensors1[i].OP(tensors2[i], alpha));                                                            \
+  }                                                                                                                     \
+                                                                                                                        \
+  return result;                                                                                                        \
+}
+
+#define FOREACH_UNARY_OP(OP)                                                  \
+void foreach_tensor_##OP##_slow_(TensorList tensors) {                      \
+  check_foreach_api_restrictions(tensors);                                    \
+                                                                              \
+  for (auto& t: tensors) {                                                    \
+    t.OP##_();                                                                \
+  }                                                                           \
+}                                                                             \
+                                                                              \
+std::vector<Tensor> foreach_tensor_##OP##_slow(TensorList tensors) {        \
+  check_foreach_api_restrictions(tensors);                                    \
+                                                                              \
+  std::vector<Tensor> result;                                                 \
+  result.reserve(tensors.size());                                             \
+  for (const auto& t: tensors) {                                              \
+    result.emplace_back(t.OP());                                              \
+  }                                                                           \
+                                                                              \
+  return result;                                                              \
+}
+
+#define FOREACH_POINTWISE_OP(OP)                                                                                              \
+void foreach_tensor_##OP##_slow_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar value) {                \
+  check_foreach_api_restrictions({input, tensors1, tensors2});                                                                \
+                                                                                                                              \
+  for (size_t i = 0; i < input.size(); i++) {                                                                                 \
+    input[i].OP##_(tensors1[i], tensors2[i], value);                                                                          \
+  }                                                                                                                           \
+}                                                                                                                             \
+                                                                                                                              \
+std::vector<Tensor> foreach_tensor_##OP##_slow(TensorList input, TensorList tensors1, TensorList tensors2, Scalar value) {  \
+  check_foreach_api_restrictions({input, tensors1, tensors2});                                                                \
+                                                                                                                              \
+  std::vector<Tensor> result;                                                                                                 \
+  result.reserve(input.size());                                                                                               \
+  for (size_t i = 0; i < input.size(); i++) {                                                                                 \
+    result.emplace_back(input[i].OP(tensors1[i], tensors2[i], value));                                                        \
+  }                                                                                                                           \
+                                                                                                                              \
+  return result;                                                                                                              \
+}
+
+FOREACH_BINARY_OP_SCALAR(add);
+FOREACH_BINARY_OP_SCALAR(mul);
+FOREACH_BINARY_OP_SCALAR(div);
+FOREACH_BINARY_OP_LIST_ALPHA(add);
+FOREACH_BINARY_OP_LIST(mul);
+FOREACH_BINARY_OP_LIST(div);
+FOREACH_UNARY_OP(sqrt);
+FOREACH_POINTWISE_OP(addcmul);
+FOREACH_POINTWISE_OP(addcdiv);
+
+void foreach_tensor_lerp_slow_(TensorList tensors1, TensorList tensors2, Scalar weight) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    tensors1[i].lerp_(tensors2[i], weight);
+  }
+}
+
+std::vector<Tensor> foreach_tensor_lerp_slow(TensorList tensors1, TensorList tensors2, Scalar weight) {
+  check_foreach_api_restrictions({tensors1, tensors2});
 
   std::vector<Tensor> result;
-  for (int i = 0; i < tensors.size(); i++) {
-    auto temp = tensors[i].add(scalar);
-    result.emplace_back(temp);
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.emplace_back(tensors1[i].lerp(tensors2[i], weight));
   }
+
   return result;
 }
+
+// `other` is a one-element tensor, so that a scale computed on the device
+// (e.g. by clip_grad_norm_) can be applied without reading it on the host.
+void foreach_tensor_mul_tensor_kernel_slow_(TensorList tensors, const Tensor& other) {
+  check_foreach_api_restrictions(tensors);
+  TORCH_CHECK(other.numel() == 1,
+              "_foreach_mul_ expects a one-element tensor, got ", other.numel(), " elements");
+
+  for (auto& t: tensors) {
+    t.mul_(other);
+  }
+}
+
+std::vector<Tensor> foreach_tensor_norm_slow(TensorList tensors, Scalar ord) {
+  check_foreach_api_restrictions(tensors);
+
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const auto& t: tensors) {
+    result.emplace_back(at::norm(t, ord));
+  }
+
+  return result;
+}
+
 }} // namespace at::native
@@ -0,0 +1,67 @@
+#pragma once
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// Set of foreach API restrictions
+// - All tensor lists must be non-empty and have the same length.
+// - Corresponding tensors in the lists must have the same sizes.
+inline void check_foreach_api_restrictions(TensorList tensors) {
+  TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
+}
+
+inline void check_foreach_api_restrictions(ArrayRef<TensorList> tensor_lists) {
+  TORCH_INTERNAL_ASSERT(tensor_lists.size() > 0);
+  auto tensors = tensor_lists[0];
+  check_foreach_api_restrictions(tensors);
+  for (size_t l = 1; l < tensor_lists.size(); l++) {
+    auto other = tensor_lists[l];
+    TORCH_CHECK(tensors.size() == other.size(),
+                "Tensor lists must have the same number of tensors, got ",
+                tensors.size(), " and ", other.size());
+    for (size_t i = 0; i < tensors.size(); i++) {
+      TORCH_CHECK(tensors[i].sizes() == other[i].sizes(),
+                  "Corresponding tensors in lists must have the same size, got ",
+                  tensors[i].sizes(), " and ", other[i].sizes());
+    }
+  }
+}
+
+// To go via the fast path (multi_tensor_apply), every tensor in every list
+// has to
+// - have the dtype and device of the first tensor,
+// - be strided, non-overlapping and dense,
+// - have the same strides as the corresponding tensors in the other lists,
+// and the scalar must not need type promotion to be applied to the tensors.
+// Anything else goes through the per-tensor (slow) path, which implements
+// the usual semantics of the underlying op.
+inline bool can_use_fast_route(ArrayRef<TensorList> tensor_lists, Scalar scalar = 1) {
+  auto expected_dtype = tensor_lists[0][0].dtype();
+  auto expected_device = tensor_lists[0][0].device();
+  auto scalar_type = tensor_lists[0][0].scalar_type();
+
+  if (scalar_type == at::kBool ||
+      (at::isIntegralType(scalar_type, /*includeBool=*/true) && scalar.isFloatingPoint()) ||
+      (!at::isComplexType(scalar_type) && scalar.isComplex())) {
+    return false;
+  }
+
+  for (size_t i = 0; i < tensor_lists[0].size(); i++) {
+    const auto& first = tensor_lists[0][i];
+    for (const auto& tensors : tensor_lists) {
+      const auto& t = tensors[i];
+      if (t.dtype() != expected_dtype ||
+          t.device() != expected_device ||
+          t.layout() != at::kStrided ||
+          !t.is_non_overlapping_and_dense() ||
+          t.strides() != first.strides()) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+}} // at::native
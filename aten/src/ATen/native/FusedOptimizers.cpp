@@ -0,0 +1,312 @@
+#include <ATen/native/FusedOptimizers.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+// Fused optimizer steps. Each step reads param, grad and the optimizer state
+// once and writes param and the state back once, instead of making a pass
+// over memory for every op of the unfused update. The math matches the
+// unfused updates in torch/csrc/api/src/optim/.
+
+namespace {
+
+Tensor unscale(const Tensor& grad, const Tensor& inv_scale) {
+  if (!inv_scale.defined()) {
+    return grad;
+  }
+  return grad.mul(inv_scale).to(grad.scalar_type());
+}
+
+bool step_skipped(const Tensor& found_inf) {
+  return found_inf.defined() && found_inf.item<float>() != 0.f;
+}
+
+// Whether the fused CPU loop can process tensor i of the lists.
+bool can_use_fused_cpu_loop(ArrayRef<TensorList> tensor_lists, size_t i) {
+  const auto& first = tensor_lists[0][i];
+  if (first.scalar_type() != kFloat && first.scalar_type() != kDouble) {
+    return false;
+  }
+  for (const auto& tensors : tensor_lists) {
+    const auto& t = tensors[i];
+    if (t.scalar_type() != first.scalar_type() || !t.is_contiguous() ||
+        t.layout() != at::kStrided) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename scalar_t>
+void adam_cpu_loop(
+    scalar_t* param,
+    const scalar_t* grad,
+    scalar_t* exp_avg,
+    scalar_t* exp_avg_sq,
+    scalar_t* max_exp_avg_sq,
+    int64_t numel,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    float inv_scale) {
+  const auto bias_correction1 = 1 - std::pow(beta1, step);
+  const auto bias_correction2 = 1 - std::pow(beta2, step);
+  const scalar_t step_size = lr / bias_correction1;
+  const scalar_t bias_correction2_sqrt = std::sqrt(bias_correction2);
+  const scalar_t param_decay = 1 - lr * weight_decay;
+  const scalar_t b1 = beta1;
+  const scalar_t b2 = beta2;
+  const scalar_t wd = weight_decay;
+  const scalar_t e = eps;
+  const scalar_t s = inv_scale;
+
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t g = grad[i] * s;
+      scalar_t p = param[i];
+      if (wd != 0) {
+        if (decoupled_weight_decay) {
+          p *= param_decay;
+        } else {
+          g += wd * p;
+        }
+      }
+      scalar_t m = exp_avg[i] * b1 + (1 - b1) * g;
+      scalar_t v = exp_avg_sq[i] * b2 + (1 - b2) * g * g;
+      scalar_t denom_src = v;
+      if (amsgrad) {
+        denom_src = std::max(max_exp_avg_sq[i], v);
+        max_exp_avg_sq[i] = denom_src;
+      }
+      scalar_t denom = std::sqrt(denom_src) / bias_correction2_sqrt + e;
+      param[i] = p - step_size * m / denom;
+      exp_avg[i] = m;
+      exp_avg_sq[i] = v;
+    }
+  });
+}
+
+template <typename scalar_t>
+void sgd_cpu_loop(
+    scalar_t* param,
+    const scalar_t* grad,
+    scalar_t* momentum_buffer,
+    int64_t numel,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool is_first_step,
+    float inv_scale) {
+  const scalar_t l = lr;
+  const scalar_t mo = momentum;
+  const scalar_t d = dampening;
+  const scalar_t wd = weight_decay;
+  const scalar_t s = inv_scale;
+
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t g = grad[i] * s;
+      scalar_t p = param[i];
+      if (wd != 0) {
+        g += wd * p;
+      }
+      if (mo != 0) {
+        scalar_t buf = is_first_step ? g : momentum_buffer[i] * mo + (1 - d) * g;
+        momentum_buffer[i] = buf;
+        g = nesterov ? g + mo * buf : buf;
+      }
+      param[i] = p - l * g;
+    }
+  });
+}
+
+} // namespace
+
+void fused_adam_fallback_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  if (step_skipped(found_inf)) {
+    return;
+  }
+  const auto bias_correction1 = 1 - std::pow(beta1, step);
+  const auto bias_correction2 = 1 - std::pow(beta2, step);
+  const auto step_size = lr / bias_correction1;
+
+  for (size_t i = 0; i < params.size(); i++) {
+    const auto& param = params[i];
+    auto grad = unscale(grads[i], inv_scale);
+    if (weight_decay != 0) {
+      if (decoupled_weight_decay) {
+        param.mul_(1 - lr * weight_decay);
+      } else {
+        grad = grad.add(param, weight_decay);
+      }
+    }
+    exp_avgs[i].mul_(beta1).add_(grad, 1 - beta1);
+    exp_avg_sqs[i].mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+
+    Tensor denom;
+    if (amsgrad) {
+      auto max_exp_avg_sq = max_exp_avg_sqs[i];
+      at::max_out(max_exp_avg_sq, exp_avg_sqs[i], max_exp_avg_sq);
+      denom = (max_exp_avg_sq.sqrt() / std::sqrt(bias_correction2)).add_(eps);
+    } else {
+      denom = (exp_avg_sqs[i].sqrt() / std::sqrt(bias_correction2)).add_(eps);
+    }
+    param.addcdiv_(exp_avgs[i], denom, -step_size);
+  }
+}
+
+void fused_sgd_fallback_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool is_first_step,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  if (step_skipped(found_inf)) {
+    return;
+  }
+  for (size_t i = 0; i < params.size(); i++) {
+    const auto& param = params[i];
+    auto d_p = unscale(grads[i], inv_scale);
+    if (weight_decay != 0) {
+      d_p = d_p.add(param, weight_decay);
+    }
+    if (momentum != 0) {
+      const auto& buf = momentum_buffers[i];
+      if (is_first_step) {
+        buf.copy_(d_p);
+      } else {
+        buf.mul_(momentum).add_(d_p, 1 - dampening);
+      }
+      if (nesterov) {
+        d_p = d_p.add(buf, momentum);
+      } else {
+        d_p = buf;
+      }
+    }
+    param.add_(d_p, -lr);
+  }
+}
+
+void fused_adam_kernel_cpu_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  check_fused_adam_args(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs, amsgrad, inv_scale, found_inf);
+  if (step_skipped(found_inf)) {
+    return;
+  }
+  const float inv_scale_val = inv_scale.defined() ? inv_scale.item<float>() : 1.f;
+
+  for (size_t i = 0; i < params.size(); i++) {
+    bool fused = amsgrad
+        ? can_use_fused_cpu_loop({params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs}, i)
+        : can_use_fused_cpu_loop({params, grads, exp_avgs, exp_avg_sqs}, i);
+    if (!fused) {
+      fused_adam_fallback_(
+          params[i], grads[i], exp_avgs[i], exp_avg_sqs[i],
+          amsgrad ? max_exp_avg_sqs[i] : TensorList(),
+          step, lr, beta1, beta2, weight_decay, eps, amsgrad, decoupled_weight_decay,
+          inv_scale, Tensor());
+      continue;
+    }
+    AT_DISPATCH_FLOATING_TYPES(params[i].scalar_type(), "fused_adam_kernel_cpu_", [&] {
+      adam_cpu_loop<scalar_t>(
+          params[i].data_ptr<scalar_t>(),
+          grads[i].data_ptr<scalar_t>(),
+          exp_avgs[i].data_ptr<scalar_t>(),
+          exp_avg_sqs[i].data_ptr<scalar_t>(),
+          amsgrad ? max_exp_avg_sqs[i].data_ptr<scalar_t>() : nullptr,
+          params[i].numel(),
+          step, lr, beta1, beta2, weight_decay, eps, amsgrad, decoupled_weight_decay,
+          inv_scale_val);
+    });
+  }
+}
+
+void fused_sgd_kernel_cpu_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool is_first_step,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  check_fused_sgd_args(params, grads, momentum_buffers, momentum, inv_scale, found_inf);
+  if (step_skipped(found_inf)) {
+    return;
+  }
+  const float inv_scale_val = inv_scale.defined() ? inv_scale.item<float>() : 1.f;
+
+  for (size_t i = 0; i < params.size(); i++) {
+    bool fused = momentum != 0
+        ? can_use_fused_cpu_loop({params, grads, momentum_buffers}, i)
+        : can_use_fused_cpu_loop({params, grads}, i);
+    if (!fused) {
+      fused_sgd_fallback_(
+          params[i], grads[i], momentum != 0 ? momentum_buffers[i] : TensorList(),
+          lr, momentum, dampening, weight_decay, nesterov, is_first_step,
+          inv_scale, Tensor());
+      continue;
+    }
+    AT_DISPATCH_FLOATING_TYPES(params[i].scalar_type(), "fused_sgd_kernel_cpu_", [&] {
+      sgd_cpu_loop<scalar_t>(
+          params[i].data_ptr<scalar_t>(),
+          grads[i].data_ptr<scalar_t>(),
+          momentum != 0 ? momentum_buffers[i].data_ptr<scalar_t>() : nullptr,
+          params[i].numel(),
+          lr, momentum, dampening, weight_decay, nesterov, is_first_step,
+          inv_scale_val);
+    });
+  }
+}
+
+}} // namespace at::native
@@ -0,0 +1,93 @@
+#pragma once
+#include <ATen/ATen.h>
+#include <ATen/native/ForeachUtils.h>
+
+namespace at {
+namespace native {
+
+// Checks shared by the CPU and CUDA implementations of the fused optimizer
+// steps. `inv_scale` and `found_inf` are optional (undefined when not used)
+// and follow the conventions of _amp_non_finite_check_and_unscale_: both are
+// single-element float tensors on the device of the parameters.
+inline void check_fused_optimizer_amp_args(
+    TensorList params,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  for (const auto& t : {inv_scale, found_inf}) {
+    if (!t.defined()) {
+      continue;
+    }
+    TORCH_CHECK(t.numel() == 1, "inv_scale and found_inf must be 1-element tensors.");
+    TORCH_CHECK(t.scalar_type() == at::ScalarType::Float,
+                "inv_scale and found_inf must be float tensors.");
+    TORCH_CHECK(t.device() == params[0].device(),
+                "inv_scale and found_inf must be on the same device as the parameters.");
+  }
+}
+
+inline void check_fused_adam_args(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    bool amsgrad,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  if (amsgrad) {
+    check_foreach_api_restrictions({params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs});
+  } else {
+    check_foreach_api_restrictions({params, grads, exp_avgs, exp_avg_sqs});
+  }
+  check_fused_optimizer_amp_args(params, inv_scale, found_inf);
+}
+
+inline void check_fused_sgd_args(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double momentum,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  if (momentum != 0) {
+    check_foreach_api_restrictions({params, grads, momentum_buffers});
+  } else {
+    check_foreach_api_restrictions({params, grads});
+  }
+  check_fused_optimizer_amp_args(params, inv_scale, found_inf);
+}
+
+// Unfused implementations, made of regular ops, for tensors the fused kernels
+// don't handle (e.g. non-contiguous or mixed-dtype lists). They read
+// found_inf on the host, so they synchronize with the device if it is set.
+void fused_adam_fallback_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    const Tensor& inv_scale,
+    const Tensor& found_inf);
+
+void fused_sgd_fallback_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool is_first_step,
+    const Tensor& inv_scale,
+    const Tensor& found_inf);
+
+}} // namespace at::native
@@ -370,6 +370,21 @@ Tensor &addmm_cpu_(Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar
   return addmm_cpu_out(self, self, mat1, mat2, beta, alpha);
 }
 
+Tensor& addmm_activation_out_cpu(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha, bool use_gelu) {
+  addmm_cpu_out(result, self, mat1, mat2, beta, alpha);
+  if (use_gelu) {
+    at::gelu_out(result, result);
+  } else {
+    at::relu_(result);
+  }
+  return result;
+}
+
+Tensor addmm_activation_cpu(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha, bool use_gelu) {
+  Tensor result = at::empty({0}, self.options());
+  return addmm_activation_out_cpu(result, self, mat1, mat2, beta, alpha, use_gelu);
+}
+
 Tensor& mm_cpu_out(Tensor & result, const Tensor & self, const Tensor & mat2) {
   TORCH_CHECK(self.dim() == 2, "self must be a matrix");
   TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix");
@@ -398,7 +413,7 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
   auto s0 = self.accessor<scalar_t, 3>();
   auto m0 = mat2.accessor<scalar_t, 3>();
 
-  int64_t grain_size = std::min(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
+  int64_t grain_size = std::max(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
   parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t b = b_begin; b < b_end; b++) {
         auto r1 = r0[b];
@@ -427,6 +442,9 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 }
 
 // This tries to apply some optimizations to bmm/baddbmm:
+// - When all the matrices are at most 32x32 (attention heads, graph ops and
+//   the like), cpublas::gemm_batched_small goes through the batch in parallel
+//   with kernels specialized for the number of columns.
 // - When the operand size is small, computation are parallelized over the batch
 //   dimension using OMP and naive matrix multiplication is applied.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
@@ -477,7 +495,24 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  if (res_rows <= cpublas::gemm_small_max_size && res_cols <= cpublas::gemm_small_max_size
+      && contraction_size <= cpublas::gemm_small_max_size) {
+    // the kernels take contiguous rows of batch2 and of the result, which
+    // are cheap to copy at these sizes
+    const Tensor b2 = batch2.stride(2) == 1 ? batch2 : batch2.contiguous();
+    Tensor result = self_or_result.stride(2) == 1 ? self_or_result : self_or_result.contiguous();
+    cpublas::gemm_batched_small_stub(
+        kCPU, result.scalar_type(),
+        bs, res_rows, res_cols, contraction_size,
+        alpha,
+        batch1.data_ptr(), batch1.stride(0), batch1.stride(1), batch1.stride(2),
+        b2.data_ptr(), b2.stride(0), b2.stride(1),
+        beta,
+        result.data_ptr(), result.stride(0), result.stride(1));
+    if (!result.is_same(self_or_result)) {
+      self_or_result.copy_(result);
+    }
+  } else if (contraction_size * res_rows * res_cols < 400) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES_AND_COMPLEX(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -1,5 +1,12 @@
 #include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/InferSize.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/native/Pool.h>
+
+#include <torch/library.h>
 
 namespace at {
 namespace native {
@@ -39,5 +46,528 @@ Tensor empty_meta(
   return tensor;
 }
 
+// Note [Meta kernels]
+// ~~~~~~~~~~~~~~~~~~~
+// The kernels below compute the sizes and dtype of the result of an operator
+// without allocating or touching any data, so a model can be "run" on meta
+// tensors to find the shape of every intermediate, e.g. to estimate peak
+// activation memory for a batch size or to plan allocator pools ahead of time.
+//
+// Meta has a higher priority than the other backends, so these kernels also
+// run when only some of the inputs are meta tensors (say, a meta input
+// going through a module whose parameters are real CPU tensors).
+//
+// Operators without a backend-specific implementation are covered for free
+// when they decompose into the operators below (e.g. transpose, reshape,
+// linear, conv2d).  Composite operators that allocate their result with
+// at::empty(..., self.options()) would produce a real tensor instead, so
+// those are registered directly.  Operators that are not registered here
+// raise the usual "Could not run ... with arguments from the 'Meta'
+// backend" error.
+namespace {
+
+Tensor meta_empty(const Tensor& like, IntArrayRef size, ScalarType dtype) {
+  return at::empty_meta(size, like.options().dtype(dtype));
+}
+
+Tensor meta_empty_like(const Tensor& self) {
+  return at::empty_meta(
+      self.sizes(), self.options(), self.suggest_memory_format());
+}
+
+// Aliases `self` with new geometry. Meta tensors have no storage to share.
+Tensor meta_alias(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef stride,
+    int64_t storage_offset) {
+  auto result = detail::make_tensor<TensorImpl>(
+      self.key_set(), self.dtype(), self.device());
+  result.unsafeGetTensorImpl()->set_storage_offset(storage_offset);
+  result.unsafeGetTensorImpl()->set_sizes_and_strides(size, stride);
+  return result;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~ factories and views ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+Tensor empty_like_meta(
+    const Tensor& self,
+    c10::optional<ScalarType> dtype,
+    c10::optional<Layout> layout,
+    c10::optional<Device> device,
+    c10::optional<bool> pin_memory,
+    c10::optional<MemoryFormat> optional_memory_format) {
+  auto memory_format =
+      optional_memory_format.value_or(MemoryFormat::Preserve);
+  if (memory_format == MemoryFormat::Preserve) {
+    memory_format = self.suggest_memory_format();
+  }
+  return at::empty_meta(
+      self.sizes(),
+      self.options().dtype(dtype.value_or(self.scalar_type())),
+      memory_format);
+}
+
+Tensor new_empty_meta(
+    const Tensor& self,
+    IntArrayRef size,
+    c10::optional<ScalarType> dtype,
+    c10::optional<Layout> layout,
+    c10::optional<Device> device,
+    c10::optional<bool> pin_memory) {
+  return meta_empty(self, size, dtype.value_or(self.scalar_type()));
+}
+
+Tensor as_strided_meta(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef stride,
+    c10::optional<int64_t> storage_offset) {
+  return meta_alias(
+      self, size, stride, storage_offset.value_or(self.storage_offset()));
+}
+
+Tensor view_meta(const Tensor& self, IntArrayRef size) {
+  auto inferred_size = at::infer_size(size, self.numel());
+  auto stride =
+      at::detail::computeStride(self.sizes(), self.strides(), inferred_size);
+  TORCH_CHECK(stride.has_value(), "view size is "
+    "not compatible with input tensor's size and stride (at least one dimension"
+    " spans across two contiguous subspaces). Use .reshape(...) instead.");
+  return meta_alias(self, inferred_size, *stride, self.storage_offset());
+}
+
+Tensor clone_meta(
+    const Tensor& self,
+    c10::optional<MemoryFormat> optional_memory_format) {
+  return empty_like_meta(
+      self, c10::nullopt, c10::nullopt, c10::nullopt, c10::nullopt,
+      optional_memory_format);
+}
+
+Tensor& resize_meta_(
+    Tensor& self,
+    IntArrayRef size,
+    c10::optional<MemoryFormat> optional_memory_format) {
+  self.unsafeGetTensorImpl()->set_sizes_contiguous(size);
+  self.unsafeGetTensorImpl()->empty_tensor_restride(
+      optional_memory_format.value_or(MemoryFormat::Contiguous));
+  return self;
+}
+
+Tensor& copy_meta_(Tensor& self, const Tensor& src, bool non_blocking) {
+  TORCH_CHECK(
+      at::infer_size(self.sizes(), src.sizes()) == self.sizes(),
+      "copy_: source of size ", src.sizes(),
+      " cannot be broadcast to destination of size ", self.sizes());
+  return self;
+}
+
+Tensor& fill_meta_(Tensor& self, Scalar value) {
+  return self;
+}
+
+Tensor& zero_meta_(Tensor& self) {
+  return self;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ pointwise ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Any trailing scalar arguments (alpha, negative_slope, ...) do not affect
+// the result's geometry.
+template <typename... Args>
+Tensor unary_meta(const Tensor& self, Args... /* unused */) {
+  return meta_empty_like(self);
+}
+
+template <typename... Args>
+Tensor& unary_meta_(Tensor& self, Args... /* unused */) {
+  return self;
+}
+
+// TODO: Doesn't do strides correctly
+template <typename... Args>
+Tensor binary_meta(const Tensor& self, const Tensor& other, Args... /* unused */) {
+  return meta_empty(
+      self, at::infer_size(self.sizes(), other.sizes()), at::result_type(self, other));
+}
+
+template <typename... Args>
+Tensor& binary_meta_(Tensor& self, const Tensor& other, Args... /* unused */) {
+  TORCH_CHECK(
+      at::infer_size(self.sizes(), other.sizes()) == self.sizes(),
+      "output with shape ", self.sizes(),
+      " doesn't match the broadcast shape ", other.sizes());
+  return self;
+}
+
+Tensor where_meta(const Tensor& condition, const Tensor& self, const Tensor& other) {
+  auto size = at::infer_size(
+      at::infer_size(condition.sizes(), self.sizes()), other.sizes());
+  return meta_empty(self, size, self.scalar_type());
+}
+
+Tensor masked_fill_meta(const Tensor& self, const Tensor& mask, Scalar value) {
+  TORCH_CHECK(
+      at::infer_size(self.sizes(), mask.sizes()) == self.sizes(),
+      "masked_fill: mask of size ", mask.sizes(),
+      " cannot be broadcast to ", self.sizes());
+  return meta_empty_like(self);
+}
+
+Tensor softmax_meta(const Tensor& self, int64_t dim, bool half_to_float) {
+  (void)maybe_wrap_dim(dim, self.dim());
+  return meta_empty(
+      self, self.sizes(), half_to_float ? ScalarType::Float : self.scalar_type());
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ reductions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::vector<int64_t> reduced_size(
+    const Tensor& self,
+    IntArrayRef dims,
+    bool keepdim) {
+  std::vector<bool> reduced(self.dim(), dims.empty());
+  for (auto d : dims) {
+    reduced[maybe_wrap_dim(d, self.dim())] = true;
+  }
+  std::vector<int64_t> size;
+  for (int64_t d = 0; d < self.dim(); ++d) {
+    if (!reduced[d]) {
+      size.push_back(self.size(d));
+    } else if (keepdim) {
+      size.push_back(1);
+    }
+  }
+  return size;
+}
+
+Tensor sum_dim_meta(
+    const Tensor& self,
+    IntArrayRef dims,
+    bool keepdim,
+    c10::optional<ScalarType> dtype) {
+  auto result_type = dtype.value_or(
+      isIntegralType(self.scalar_type(), /*includeBool=*/true)
+          ? ScalarType::Long
+          : self.scalar_type());
+  return meta_empty(self, reduced_size(self, dims, keepdim), result_type);
+}
+
+Tensor sum_meta(const Tensor& self, c10::optional<ScalarType> dtype) {
+  return sum_dim_meta(self, {}, false, dtype);
+}
+
+Tensor mean_dim_meta(
+    const Tensor& self,
+    IntArrayRef dims,
+    bool keepdim,
+    c10::optional<ScalarType> dtype) {
+  return meta_empty(
+      self, reduced_size(self, dims, keepdim), dtype.value_or(self.scalar_type()));
+}
+
+Tensor mean_meta(const Tensor& self, c10::optional<ScalarType> dtype) {
+  return mean_dim_meta(self, {}, false, dtype);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ linear algebra ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+Tensor mm_meta(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 2, "self must be a matrix");
+  TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix");
+  TORCH_CHECK(
+      self.size(1) == mat2.size(0), "size mismatch, m1: ", self.sizes(),
+      ", m2: ", mat2.sizes());
+  return meta_empty(self, {self.size(0), mat2.size(1)}, self.scalar_type());
+}
+
+Tensor addmm_meta(
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  auto result = mm_meta(mat1, mat2);
+  at::infer_size(self.sizes(), result.sizes());
+  return result;
+}
+
+Tensor bmm_meta(const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 3, "batch1 must be a 3D tensor");
+  TORCH_CHECK(mat2.dim() == 3, "batch2 must be a 3D tensor");
+  TORCH_CHECK(
+      self.size(0) == mat2.size(0) && self.size(2) == mat2.size(1),
+      "Expected size for first two dimensions of batch2 tensor to be: [",
+      self.size(0), ", ", self.size(2), "] but got: [", mat2.size(0), ", ",
+      mat2.size(1), "].");
+  return meta_empty(
+      self, {self.size(0), self.size(1), mat2.size(2)}, self.scalar_type());
+}
+
+Tensor baddbmm_meta(
+    const Tensor& self,
+    const Tensor& batch1,
+    const Tensor& batch2,
+    Scalar beta,
+    Scalar alpha) {
+  auto result = bmm_meta(batch1, batch2);
+  at::infer_size(self.sizes(), result.sizes());
+  return result;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ nn ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+int64_t expand_param(IntArrayRef param, int64_t d) {
+  return param.size() == 1 ? param[0] : param[d];
+}
+
+Tensor convolution_meta(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    bool benchmark,
+    bool deterministic,
+    bool cudnn_enabled) {
+  TORCH_CHECK(
+      input.dim() == weight.dim() && input.dim() >= 3,
+      "Expected ", weight.dim(), "-dimensional input for ", weight.dim(),
+      "-dimensional weight ", weight.sizes(), ", but got ", input.dim(),
+      "-dimensional input of size ", input.sizes() ," instead");
+  std::vector<int64_t> output_size(input.dim());
+  output_size[0] = input.size(0);
+  output_size[1] = transposed ? weight.size(1) * groups : weight.size(0);
+  for (int64_t d = 2; d < input.dim(); ++d) {
+    const auto k = d - 2;
+    const auto kernel = expand_param(dilation, k) * (weight.size(d) - 1) + 1;
+    if (transposed) {
+      output_size[d] = (input.size(d) - 1) * expand_param(stride, k) -
+          2 * expand_param(padding, k) + kernel + expand_param(output_padding, k);
+    } else {
+      output_size[d] =
+          (input.size(d) + 2 * expand_param(padding, k) - kernel) /
+              expand_param(stride, k) + 1;
+    }
+    TORCH_CHECK(
+        output_size[d] > 0,
+        "Calculated output size is too small for input of size ", input.sizes());
+  }
+  return at::empty_meta(
+      output_size, input.options(), input.suggest_memory_format());
+}
+
+std::vector<int64_t> pool2d_output_size(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode) {
+  TORCH_CHECK(
+      self.dim() == 3 || self.dim() == 4,
+      "non-empty 3D or 4D (batch mode) tensor expected for input");
+  auto size = self.sizes().vec();
+  for (int64_t k = 0; k < 2; ++k) {
+    const auto d = self.dim() - 2 + k;
+    const auto kernel = expand_param(kernel_size, k);
+    size[d] = pooling_output_shape<int64_t>(
+        self.size(d),
+        kernel,
+        expand_param(padding, k),
+        stride.empty() ? kernel : expand_param(stride, k),
+        dilation.empty() ? 1 : expand_param(dilation, k),
+        ceil_mode);
+  }
+  return size;
+}
+
+std::tuple<Tensor, Tensor> max_pool2d_with_indices_meta(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode) {
+  auto size =
+      pool2d_output_size(self, kernel_size, stride, padding, dilation, ceil_mode);
+  return std::make_tuple(
+      meta_empty(self, size, self.scalar_type()),
+      meta_empty(self, size, ScalarType::Long));
+}
+
+Tensor avg_pool2d_meta(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad,
+    c10::optional<int64_t> divisor_override) {
+  return meta_empty(
+      self,
+      pool2d_output_size(self, kernel_size, stride, padding, {}, ceil_mode),
+      self.scalar_type());
+}
+
+Tensor adaptive_avg_pool2d_meta(const Tensor& self, IntArrayRef output_size) {
+  TORCH_CHECK(output_size.size() == 2, "adaptive_avg_pool2d: output_size must be 2");
+  TORCH_CHECK(
+      self.dim() == 3 || self.dim() == 4,
+      "adaptive_avg_pool2d(): Expected 3D or 4D tensor, but got ", self.sizes());
+  auto size = self.sizes().vec();
+  size[self.dim() - 2] = output_size[0];
+  size[self.dim() - 1] = output_size[1];
+  return meta_empty(self, size, self.scalar_type());
+}
+
+std::tuple<Tensor, Tensor, Tensor> batch_norm_meta(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const Tensor& running_mean,
+    const Tensor& running_var,
+    bool training,
+    double momentum,
+    double eps) {
+  const int64_t stats_size = training ? input.size(1) : 0;
+  return std::make_tuple(
+      meta_empty_like(input),
+      meta_empty(input, {stats_size}, input.scalar_type()),
+      meta_empty(input, {stats_size}, input.scalar_type()));
+}
+
+std::tuple<Tensor, Tensor, Tensor> layer_norm_meta(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    int64_t M,
+    int64_t N,
+    double eps) {
+  return std::make_tuple(
+      meta_empty_like(input),
+      meta_empty(input, {M}, input.scalar_type()),
+      meta_empty(input, {M}, input.scalar_type()));
+}
+
+Tensor cat_meta(TensorList tensors, int64_t dim) {
+  TORCH_CHECK(!tensors.empty(), "expected a non-empty list of Tensors");
+  // Like cat, skip the legacy empty 1-D tensors.
+  const Tensor* first = nullptr;
+  int64_t cat_size = 0;
+  for (const auto& t : tensors) {
+    if (t.dim() == 1 && t.size(0) == 0) {
+      continue;
+    }
+    if (first == nullptr) {
+      first = &t;
+      dim = maybe_wrap_dim(dim, t.dim());
+    }
+    TORCH_CHECK(
+        t.dim() == first->dim(),
+        "Tensors must have same number of dimensions: got ", first->dim(),
+        " and ", t.dim());
+    for (int64_t d = 0; d < t.dim(); ++d) {
+      TORCH_CHECK(
+          d == dim || t.size(d) == first->size(d),
+          "Sizes of tensors must match except in dimension ", dim,
+          ". Got ", first->size(d), " and ", t.size(d), " in dimension ", d);
+    }
+    cat_size += t.size(dim);
+  }
+  if (first == nullptr) {
+    return meta_empty(tensors[0], {0}, tensors[0].scalar_type());
+  }
+  auto size = first->sizes().vec();
+  size[dim] = cat_size;
+  return meta_empty(*first, size, first->scalar_type());
+}
+
+Tensor index_select_meta(const Tensor& self, int64_t dim, const Tensor& index) {
+  TORCH_CHECK(index.dim() <= 1, "index_select(): Index is supposed to be a vector");
+  dim = maybe_wrap_dim(dim, self.dim());
+  auto size = self.sizes().vec();
+  if (self.dim() > 0) {
+    size[dim] = index.numel();
+  }
+  return meta_empty(self, size, self.scalar_type());
+}
+
+Tensor dropout_meta(const Tensor& input, double p, bool train) {
+  return meta_empty_like(input);
+}
+
+} // namespace
+
+TORCH_LIBRARY_IMPL(aten, Meta, m) {
+  // factories and views
+  m.impl("empty_like", TORCH_FN(empty_like_meta));
+  m.impl("new_empty", TORCH_FN(new_empty_meta));
+  m.impl("as_strided", TORCH_FN(as_strided_meta));
+  m.impl("view", TORCH_FN(view_meta));
+  m.impl("clone", TORCH_FN(clone_meta));
+  m.impl_UNBOXED("resize_", resize_meta_);
+  m.impl_UNBOXED("copy_", copy_meta_);
+  m.impl_UNBOXED("fill_.Scalar", fill_meta_);
+  m.impl_UNBOXED("zero_", zero_meta_);
+
+  // pointwise
+  m.impl("add.Tensor", TORCH_FN(binary_meta<Scalar>));
+  m.impl("sub.Tensor", TORCH_FN(binary_meta<Scalar>));
+  m.impl("mul.Tensor", TORCH_FN(binary_meta<>));
+  m.impl("div.Tensor", TORCH_FN(binary_meta<>));
+  m.impl_UNBOXED("add_.Tensor", binary_meta_<Scalar>);
+  m.impl_UNBOXED("sub_.Tensor", binary_meta_<Scalar>);
+  m.impl_UNBOXED("mul_.Tensor", binary_meta_<>);
+  m.impl_UNBOXED("div_.Tensor", binary_meta_<>);
+  m.impl("where.self", TORCH_FN(where_meta));
+  m.impl("masked_fill.Scalar", TORCH_FN(masked_fill_meta));
+  for (const char* name : {"abs", "neg", "exp", "log", "sqrt", "rsqrt", "sin",
+                           "cos", "sigmoid", "tanh", "relu", "gelu", "silu",
+                           "hardswish"}) {
+    m.impl(name, TORCH_FN(unary_meta<>));
+  }
+  m.impl("leaky_relu", TORCH_FN(unary_meta<Scalar>));
+  m.impl("threshold", unary_meta<Scalar, Scalar>);
+  m.impl("hardtanh", unary_meta<Scalar, Scalar>);
+  m.impl("elu", unary_meta<Scalar, Scalar, Scalar>);
+  m.impl("pow.Tensor_Scalar", TORCH_FN(unary_meta<Scalar>));
+  m.impl_UNBOXED("relu_", unary_meta_<>);
+  m.impl_UNBOXED("sigmoid_", unary_meta_<>);
+  m.impl_UNBOXED("tanh_", unary_meta_<>);
+  m.impl_UNBOXED("hardtanh_", unary_meta_<Scalar, Scalar>);
+  m.impl("_softmax", TORCH_FN(softmax_meta));
+  m.impl("_log_softmax", TORCH_FN(softmax_meta));
+
+  // reductions
+  m.impl("sum", TORCH_FN(sum_meta));
+  m.impl("sum.dim_IntList", TORCH_FN(sum_dim_meta));
+  m.impl("mean", TORCH_FN(mean_meta));
+  m.impl("mean.dim", TORCH_FN(mean_dim_meta));
+
+  // linear algebra
+  m.impl("mm", TORCH_FN(mm_meta));
+  m.impl("addmm", TORCH_FN(addmm_meta));
+  m.impl("bmm", TORCH_FN(bmm_meta));
+  m.impl("baddbmm", TORCH_FN(baddbmm_meta));
+
+  // nn
+  m.impl("_convolution", TORCH_FN(convolution_meta));
+  m.impl("max_pool2d_with_indices", TORCH_FN(max_pool2d_with_indices_meta));
+  m.impl("avg_pool2d", TORCH_FN(avg_pool2d_meta));
+  m.impl("_adaptive_avg_pool2d", TORCH_FN(adaptive_avg_pool2d_meta));
+  m.impl("native_batch_norm", TORCH_FN(batch_norm_meta));
+  m.impl("native_layer_norm", TORCH_FN(layer_norm_meta));
+  m.impl("cat", TORCH_FN(cat_meta));
+  m.impl("_cat", TORCH_FN(cat_meta));
+  m.impl("index_select", TORCH_FN(index_select_meta));
+  m.impl("dropout", TORCH_FN(dropout_meta));
+}
+
 } // namespace native
 } // namespace at
@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/core/grad_mode.h>
 
 #include <ATen/native/CPUBlas.h>
 #include <ATen/native/im2col.h>
@@ -141,9 +143,7 @@ void slow_conv_transpose2d_out_cpu_template(
     IntArrayRef stride,
     IntArrayRef padding,
     IntArrayRef output_padding,
-    IntArrayRef dilation,
-    Tensor& columns_,
-    Tensor& ones_) {
+    IntArrayRef dilation) {
   TORCH_CHECK(
       kernel_size.size() == 2,
       "It is expected kernel_size equals to 2, but got size ",
@@ -169,9 +169,6 @@ void slow_conv_transpose2d_out_cpu_template(
       "It is expected stride equals to 2, but got size ",
       output_padding.size());
 
-  Tensor columns = columns_;
-  Tensor ones = ones_;
-
   int64_t kernel_height = kernel_size[0];
   int64_t kernel_width = kernel_size[1];
   int64_t dilation_height = dilation[0];
@@ -205,15 +202,7 @@ void slow_conv_transpose2d_out_cpu_template(
 
   Tensor input = input_.contiguous();
   Tensor weight = weight_.contiguous();
-
-  TORCH_CHECK(columns.is_contiguous(), "columns needs to be contiguous");
-
-  Tensor bias = Tensor();
-
-  if (bias_.defined()) {
-    bias = bias_.contiguous();
-    TORCH_CHECK(ones.is_contiguous(), "ones needs to be contiguous");
-  }
+  Tensor bias = bias_.defined() ? bias_.contiguous() : Tensor();
 
   bool is_batch = false;
   if (input.dim() == 3) {
@@ -235,100 +224,74 @@ void slow_conv_transpose2d_out_cpu_template(
   // Resize output
   output.resize_({batch_size, n_output_plane, output_height, output_width});
 
-  // Resize temporary columns
-  columns.resize_({n_output_plane * kernel_width * kernel_height,
-                   input_height * input_width});
-  columns.zero_();
-
-  // Define a buffer of ones, for bias accumulation
-  // Note: this buffer can be shared with other modules, it only ever gets
-  // increased, and always contains ones.
-  if (ones.dim() != 2 ||
-      ones.size(0) * ones.size(1) < output_height * output_width) {
-    // Resize plane and fill with ones...
-    ones.resize_({output_height, output_width});
-    ones.fill_(1);
-  }
-
   AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Long,
       input.scalar_type(), "slow_conv_transpose2d_out_cpu", [&] {
-        // For each elt in batch, do:
-        for (int elt = 0; elt < batch_size; elt++) {
-          // Helpers
-          Tensor input_n;
-          Tensor output_n;
+        // M,N,K are dims of matrix A and B
+        // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+        const int64_t m = weight.size(1) * weight.size(2) * weight.size(3);
+        const int64_t n = input_height * input_width;
+        const int64_t k = weight.size(0);
+        const int64_t output_plane_size = output_height * output_width;
+
+        // Samples run in parallel, each task with its own columns buffer.
+        // col2im only touches the output of the sample, so nothing is shared
+        // between the tasks but the weight.
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor columns = at::empty({m, n}, input.options());
+          for (int64_t elt = start; elt < end; elt++) {
+            Tensor input_n = input.select(0, elt);
+            Tensor output_n = output.select(0, elt);
 
-          // Matrix mulitply per output:
-          input_n = input.select(0, elt);
-          output_n = output.select(0, elt);
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m = weight.size(1) * weight.size(2) * weight.size(3);
-          int64_t n = columns.size(1);
-          int64_t k = weight.size(0);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::Transpose,
-              n,
-              m,
-              k,
-              1,
-              input_n.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              m,
-              0,
-              columns.data_ptr<scalar_t>(),
-              n);
-
-          // Unpack columns back into input:
-          col2im<scalar_t>(
-              columns.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_height,
-              output_width,
-              input_height,
-              input_width,
-              kernel_height,
-              kernel_width,
-              pad_height,
-              pad_width,
-              stride_height,
-              stride_width,
-              dilation_height,
-              dilation_width,
-              output_n.data_ptr<scalar_t>());
-
-          // Do Bias after:
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m_ = n_output_plane;
-          int64_t n_ = output_height * output_width;
-          int64_t k_ = 1;
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          if (bias_.defined()) {
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
             cpublas::gemm(
-                cpublas::Transpose,
                 cpublas::NoTranspose,
-                n_,
-                m_,
-                k_,
-                1,
-                ones.data_ptr<scalar_t>(),
-                k_,
-                bias.data_ptr<scalar_t>(),
-                k_,
+                cpublas::Transpose,
+                n,
+                m,
+                k,
                 1,
-                output_n.data_ptr<scalar_t>(),
-                n_);
+                input_n.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                m,
+                0,
+                columns.data_ptr<scalar_t>(),
+                n);
+
+            // Unpack columns back into input:
+            col2im<scalar_t>(
+                columns.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_height,
+                output_width,
+                input_height,
+                input_width,
+                kernel_height,
+                kernel_width,
+                pad_height,
+                pad_width,
+                stride_height,
+                stride_width,
+                dilation_height,
+                dilation_width,
+                output_n.data_ptr<scalar_t>());
+
+            // Do Bias after, while the output of the sample is in cache
+            if (bias.defined()) {
+              const scalar_t* bias_data = bias.data_ptr<scalar_t>();
+              scalar_t* output_data = output_n.data_ptr<scalar_t>();
+              for (int64_t c = 0; c < n_output_plane; c++) {
+                scalar_t* output_plane = output_data + c * output_plane_size;
+                for (int64_t i = 0; i < output_plane_size; i++) {
+                  output_plane[i] += bias_data[c];
+                }
+              }
+            }
           }
-        }
+        });
 
         // Resize output
         if (is_batch) {
@@ -343,7 +306,6 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
     const Tensor& grad_output_,
     Tensor& grad_input,
     const Tensor& weight_,
-    const Tensor& grad_columns_,
     IntArrayRef kernel_size,
     IntArrayRef stride,
     IntArrayRef padding,
@@ -388,8 +350,6 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
   int64_t n_input_plane = weight_.size(0);
   int64_t n_output_plane = weight_.size(1);
 
-  Tensor grad_columns = grad_columns_;
-
   slow_conv_transpose2d_shape_check(
       input_,
       grad_output_,
@@ -411,9 +371,6 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
   Tensor grad_output = grad_output_.contiguous();
   Tensor weight = weight_.contiguous();
 
-  TORCH_CHECK(
-      grad_columns.is_contiguous(), "grad_columns needs to be contiguous");
-
   bool is_batch = false;
   if (input.dim() == 3) {
     // Force batch
@@ -435,65 +392,61 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
 
   // Resize output
   grad_input.resize_({batch_size, n_input_plane, input_height, input_width});
-  grad_input.zero_();
-
-  // Resize temporary columns
-  grad_columns.resize_({n_output_plane * kernel_width * kernel_height,
-                        input_height * input_width});
 
   AT_DISPATCH_FLOATING_TYPES(
       grad_output.scalar_type(), "slow_conv_transpose2d_backward_out_cpu", [&] {
-        // Helpers
-        Tensor grad_input_n = Tensor();
-        Tensor grad_output_n = Tensor();
+        // M,N,K are dims of matrix A and B
+        // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+        const int64_t m = weight.size(0);
+        const int64_t n = input_height * input_width;
+        const int64_t k = weight.size(1) * weight.size(2) * weight.size(3);
+
+        // Samples run in parallel, each task with its own columns buffer
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor grad_columns = at::empty({k, n}, grad_output.options());
+          for (int64_t elt = start; elt < end; elt++) {
+            // Matrix mulitply per sample:
+            Tensor grad_input_n = grad_input.select(0, elt);
+            Tensor grad_output_n = grad_output.select(0, elt);
 
-        // For each elt in batch, do:
-        for (int elt = 0; elt < batch_size; elt++) {
-          // Matrix mulitply per sample:
-          grad_input_n = grad_input.select(0, elt);
-          grad_output_n = grad_output.select(0, elt);
+            // Extract columns:
+            im2col<scalar_t>(
+                grad_output_n.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_height,
+                output_width,
+                input_height,
+                input_width,
+                kernel_height,
+                kernel_width,
+                pad_height,
+                pad_width,
+                stride_height,
+                stride_width,
+                dilation_height,
+                dilation_width,
+                grad_columns.data_ptr<scalar_t>());
 
-          // Extract columns:
-          im2col<scalar_t>(
-              grad_output_n.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_height,
-              output_width,
-              input_height,
-              input_width,
-              kernel_height,
-              kernel_width,
-              pad_height,
-              pad_width,
-              stride_height,
-              stride_width,
-              dilation_height,
-              dilation_width,
-              grad_columns.data_ptr<scalar_t>());
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m = weight.size(0);
-          int64_t n = grad_columns.size(1);
-          int64_t k = weight.size(1) * weight.size(2) * weight.size(3);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::NoTranspose,
-              n,
-              m,
-              k,
-              1,
-              grad_columns.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              k,
-              0,
-              grad_input_n.data_ptr<scalar_t>(),
-              n);
-        }
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            cpublas::gemm(
+                cpublas::NoTranspose,
+                cpublas::NoTranspose,
+                n,
+                m,
+                k,
+                1,
+                grad_columns.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                k,
+                0,
+                grad_input_n.data_ptr<scalar_t>(),
+                n);
+          }
+        });
 
         // Resize output
         if (is_batch) {
@@ -730,9 +683,6 @@ Tensor& slow_conv_transpose2d_out_cpu(
     IntArrayRef padding,
     IntArrayRef output_padding,
     IntArrayRef dilation) {
-  Tensor columns = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor ones = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-
   slow_conv_transpose2d_out_cpu_template(
       output,
       input,
@@ -742,9 +692,7 @@ Tensor& slow_conv_transpose2d_out_cpu(
       stride,
       padding,
       output_padding,
-      dilation,
-      columns,
-      ones);
+      dilation);
 
   return output;
 }
@@ -759,9 +707,6 @@ Tensor slow_conv_transpose2d_cpu(
     IntArrayRef output_padding,
     IntArrayRef dilation) {
   Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor columns = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor ones = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-
   slow_conv_transpose2d_out_cpu_template(
       output,
       input,
@@ -771,9 +716,7 @@ Tensor slow_conv_transpose2d_cpu(
       stride,
       padding,
       output_padding,
-      dilation,
-      columns,
-      ones);
+      dilation);
 
   return output;
 }
@@ -798,7 +741,6 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv_transpose2d_backward_out_cpu(
         grad_output,
         grad_input,
         weight,
-        columns,
         kernel_size,
         stride,
         padding,
@@ -876,7 +818,6 @@ std::tuple<Tensor, Tensor, Tensor> slow_conv_transpose2d_backward_cpu(
         grad_output,
         grad_input,
         weight,
-        columns,
         kernel_size,
         stride,
         padding,
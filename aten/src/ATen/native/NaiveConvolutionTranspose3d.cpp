@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/core/grad_mode.h>
 
 #include <ATen/native/CPUBlas.h>
 #include <ATen/native/vol2col.h>
@@ -171,9 +173,7 @@ void slow_conv_transpose3d_out_cpu_template(
     IntArrayRef stride,
     IntArrayRef padding,
     IntArrayRef output_padding,
-    IntArrayRef dilation,
-    Tensor& finput,
-    Tensor& fgrad_input) {
+    IntArrayRef dilation) {
   TORCH_CHECK(
       kernel_size.size() == 3,
       "It is expected kernel_size equals to 3, but got size ",
@@ -215,11 +215,6 @@ void slow_conv_transpose3d_out_cpu_template(
   int64_t output_padding_height = output_padding[1];
   int64_t output_padding_width = output_padding[2];
 
-  // internal columns buffer
-  Tensor& columns = finput;
-  // internal ones buffer
-  Tensor& ones = fgrad_input;
-
   slow_conv_transpose3d_shape_check(
       input_,
       Tensor(),
@@ -278,109 +273,82 @@ void slow_conv_transpose3d_out_cpu_template(
   output.resize_(
       {batch_size, n_output_plane, output_depth, output_height, output_width});
 
-  // Resize temporary columns
-  columns.resize_({n_output_plane * kernel_width * kernel_height * kernel_depth,
-                   input_depth * input_height * input_width});
-  columns.zero_();
-
-  // Define a buffer of ones, for bias accumulation
-  // Note: this buffer can be shared with other modules, it only ever gets
-  // increased, and always contains ones.
-  if (ones.dim() != 3 ||
-      ones.size(0) * ones.size(1) * ones.size(2) <
-          output_depth * output_height * output_width) {
-    // Resize plane and fill with ones...
-    ones.resize_({output_depth, output_height, output_width});
-    ones.fill_(1);
-  }
-
   AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Long,
       input.scalar_type(), "slow_conv_transpose3d_out_cpu", [&] {
-        // Helpers
-        Tensor input_n;
-        Tensor output_n;
+        // M,N,K are dims of matrix A and B
+        // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+        const int64_t m =
+            weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
+        const int64_t n = input_depth * input_height * input_width;
+        const int64_t k = weight.size(0);
+        const int64_t output_plane_size =
+            output_depth * output_height * output_width;
+
+        // Samples run in parallel, each task with its own columns buffer.
+        // col2vol only touches the output of the sample, so nothing is shared
+        // between the tasks but the weight.
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor columns = at::empty({m, n}, input.options());
+          for (int64_t elt = start; elt < end; ++elt) {
+            Tensor input_n = input.select(0, elt);
+            Tensor output_n = output.select(0, elt);
 
-        int elt;
-        // For each elt in batch, do:
-        for (elt = 0; elt < batch_size; ++elt) {
-          // Matrix mulitply per output:
-          input_n = input.select(0, elt);
-          output_n = output.select(0, elt);
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m =
-              weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
-          const int64_t n = columns.size(1);
-          const int64_t k = weight.size(0);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::Transpose,
-              n,
-              m,
-              k,
-              1,
-              input_n.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              m,
-              0,
-              columns.data_ptr<scalar_t>(),
-              n);
-
-          // Unpack columns back into input:
-          at::native::col2vol<scalar_t>(
-              columns.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_depth,
-              output_height,
-              output_width,
-              input_depth,
-              input_height,
-              input_width,
-              kernel_depth,
-              kernel_height,
-              kernel_width,
-              padding_depth,
-              padding_height,
-              padding_width,
-              stride_depth,
-              stride_height,
-              stride_width,
-              dilation_depth,
-              dilation_height,
-              dilation_width,
-              output_n.data_ptr<scalar_t>());
-
-          // Do Bias after:
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m_ = n_output_plane;
-          const int64_t n_ = output_depth * output_height * output_width;
-          const int64_t k_ = 1;
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          if (bias.defined()) {
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
             cpublas::gemm(
-                cpublas::Transpose,
                 cpublas::NoTranspose,
-                n_,
-                m_,
-                k_,
-                1,
-                ones.data_ptr<scalar_t>(),
-                k_,
-                bias.data_ptr<scalar_t>(),
-                k_,
+                cpublas::Transpose,
+                n,
+                m,
+                k,
                 1,
-                output_n.data_ptr<scalar_t>(),
-                n_);
+                input_n.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                m,
+                0,
+                columns.data_ptr<scalar_t>(),
+                n);
+
+            // Unpack columns back into input:
+            at::native::col2vol<scalar_t>(
+                columns.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_depth,
+                output_height,
+                output_width,
+                input_depth,
+                input_height,
+                input_width,
+                kernel_depth,
+                kernel_height,
+                kernel_width,
+                padding_depth,
+                padding_height,
+                padding_width,
+                stride_depth,
+                stride_height,
+                stride_width,
+                dilation_depth,
+                dilation_height,
+                dilation_width,
+                output_n.data_ptr<scalar_t>());
+
+            // Do Bias after, while the output of the sample is in cache
+            if (bias.defined()) {
+              const scalar_t* bias_data = bias.data_ptr<scalar_t>();
+              scalar_t* output_data = output_n.data_ptr<scalar_t>();
+              for (int64_t c = 0; c < n_output_plane; ++c) {
+                scalar_t* output_plane = output_data + c * output_plane_size;
+                for (int64_t i = 0; i < output_plane_size; ++i) {
+                  output_plane[i] += bias_data[c];
+                }
+              }
+            }
           }
-        }
+        });
 
         // Resize output
         if (is_batch) {
@@ -397,8 +365,6 @@ void slow_conv_transpose3d_backward_out_cpu_template(
     const Tensor& grad_output_,
     Tensor& grad_input,
     const Tensor& weight_,
-    const Tensor& finput,
-    const Tensor& fgrad_input,
     IntArrayRef kernel_size,
     IntArrayRef stride,
     IntArrayRef padding,
@@ -429,8 +395,6 @@ void slow_conv_transpose3d_backward_out_cpu_template(
       "It is expected stride equals to 3, but got size ",
       output_padding.size());
 
-  Tensor grad_columns = finput;
-
   int64_t kernel_depth = kernel_size[0];
   int64_t kernel_height = kernel_size[1];
   int64_t kernel_width = kernel_size[2];
@@ -511,74 +475,68 @@ void slow_conv_transpose3d_backward_out_cpu_template(
   // Resize output
   grad_input.resize_(
       {batch_size, n_input_plane, input_depth, input_height, input_width});
-  grad_input.zero_();
-
-  // Resize temporary columns
-  grad_columns.resize_(
-      {n_output_plane * kernel_width * kernel_height * kernel_depth,
-       input_depth * input_height * input_width});
 
   AT_DISPATCH_FLOATING_TYPES(
       input.scalar_type(), "slow_conv_transpose3d_backward_out_cpu", [&] {
-        // Helpers
-        Tensor grad_input_n;
-        Tensor grad_output_n;
+        // M,N,K are dims of matrix A and B
+        // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+        const int64_t m = weight.size(0);
+        const int64_t n = input_depth * input_height * input_width;
+        const int64_t k =
+            weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
+
+        // Samples run in parallel, each task with its own columns buffer
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor grad_columns = at::empty({k, n}, grad_output.options());
+          for (int64_t elt = start; elt < end; ++elt) {
+            // Matrix mulitply per sample:
+            Tensor grad_input_n = grad_input.select(0, elt);
+            Tensor grad_output_n = grad_output.select(0, elt);
 
-        int elt;
-        // For each elt in batch, do:
-        for (elt = 0; elt < batch_size; ++elt) {
-          // Matrix mulitply per sample:
-          grad_input_n = grad_input.select(0, elt);
-          grad_output_n = grad_output.select(0, elt);
+            // Extract columns:
+            at::native::vol2col<scalar_t>(
+                grad_output_n.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_depth,
+                output_height,
+                output_width,
+                input_depth,
+                input_height,
+                input_width,
+                kernel_depth,
+                kernel_height,
+                kernel_width,
+                padding_depth,
+                padding_height,
+                padding_width,
+                stride_depth,
+                stride_height,
+                stride_width,
+                dilation_depth,
+                dilation_height,
+                dilation_width,
+                grad_columns.data_ptr<scalar_t>());
 
-          // Extract columns:
-          at::native::vol2col<scalar_t>(
-              grad_output_n.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_depth,
-              output_height,
-              output_width,
-              input_depth,
-              input_height,
-              input_width,
-              kernel_depth,
-              kernel_height,
-              kernel_width,
-              padding_depth,
-              padding_height,
-              padding_width,
-              stride_depth,
-              stride_height,
-              stride_width,
-              dilation_depth,
-              dilation_height,
-              dilation_width,
-              grad_columns.data_ptr<scalar_t>());
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m = weight.size(0);
-          const int64_t n = grad_columns.size(1);
-          const int64_t k =
-              weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          cpublas::gemm(
-              cpublas::NoTranspose,
-              cpublas::NoTranspose,
-              n,
-              m,
-              k,
-              1,
-              grad_columns.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              k,
-              0,
-              grad_input_n.data_ptr<scalar_t>(),
-              n);
-        }
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            cpublas::gemm(
+                cpublas::NoTranspose,
+                cpublas::NoTranspose,
+                n,
+                m,
+                k,
+                1,
+                grad_columns.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                k,
+                0,
+                grad_input_n.data_ptr<scalar_t>(),
+                n);
+          }
+        });
 
         // Resize output
         if (is_batch) {
@@ -851,9 +809,6 @@ Tensor& slow_conv_transpose3d_out_cpu(
     IntArrayRef padding,
     IntArrayRef output_padding,
     IntArrayRef dilation) {
-  Tensor finput = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor fgrad = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-
   slow_conv_transpose3d_out_cpu_template(
       output,
       input,
@@ -863,9 +818,7 @@ Tensor& slow_conv_transpose3d_out_cpu(
       stride,
       padding,
       output_padding,
-      dilation,
-      finput,
-      fgrad);
+      dilation);
 
   return output;
 }
@@ -880,9 +833,6 @@ Tensor slow_conv_transpose3d_cpu(
     IntArrayRef output_padding,
     IntArrayRef dilation) {
   Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor finput = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor fgrad = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-
   slow_conv_transpose3d_out_cpu_template(
       output,
       input,
@@ -892,9 +842,7 @@ Tensor slow_conv_transpose3d_cpu(
       stride,
       padding,
       output_padding,
-      dilation,
-      finput,
-      fgrad);
+      dilation);
 
   return output;
 }
@@ -919,8 +867,6 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv_transpose3d_backward_out_cpu(
         grad_output,
         grad_input,
         weight,
-        finput,
-        fgrad,
         kernel_size,
         stride,
         padding,
@@ -998,8 +944,6 @@ std::tuple<Tensor, Tensor, Tensor> slow_conv_transpose3d_backward_cpu(
         grad_output,
         grad_input,
         weight,
-        finput,
-        fgrad,
         kernel_size,
         stride,
         padding,
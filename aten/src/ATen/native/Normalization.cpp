@@ -90,14 +90,14 @@ void batch_norm_cpu_inference_collect_linear_and_constant_terms(
   }
 }
 
-/// A fast path for CPU inference when all tensors are channels last contiguous.
+/// Applies the linear terms alpha and beta of every channel to a channels last
+/// contiguous input.
 /// This code achieves machine bandwidth peak without AVX support.
 /// If this changes for future architectures, we can move it to the cpu/
 /// directory.
 template<typename scalar_t>
-void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
-    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    const Tensor& mean, const Tensor& variance, double eps) {
+void batch_norm_cpu_channels_last_apply(Tensor& output, const Tensor& input,
+    const scalar_t* alpha_data, const scalar_t* beta_data) {
 
   int64_t n_batch = input.size(0);
   int64_t n_channel = input.size(1);
@@ -106,14 +106,6 @@ void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
   scalar_t* output_data = output.data_ptr<scalar_t>();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
 
-  Tensor alpha = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor beta = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
-  scalar_t* beta_data = beta.data_ptr<scalar_t>();
-
-  batch_norm_cpu_inference_collect_linear_and_constant_terms<scalar_t>(
-      alpha_data, beta_data, n_channel, weight, bias, mean, variance, eps);
-
   // Apply the linear terms to the input,
   // output(n, c, h, w) = input(n, c, h, w) * alpha(c) + beta(c)
   // No need to use parallel_for as this function is supposed to be
@@ -142,6 +134,44 @@ void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
   }
 }
 
+/// A fast path for CPU inference when all tensors are channels last contiguous.
+template<typename scalar_t>
+void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& mean, const Tensor& variance, double eps) {
+
+  Tensor alpha = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor beta = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+  scalar_t* beta_data = beta.data_ptr<scalar_t>();
+
+  batch_norm_cpu_inference_collect_linear_and_constant_terms<scalar_t>(
+      alpha_data, beta_data, input.size(1), weight, bias, mean, variance, eps);
+  batch_norm_cpu_channels_last_apply<scalar_t>(output, input, alpha_data, beta_data);
+}
+
+/// The same in training, with the mean and invstd of the batch.
+template<typename scalar_t>
+void batch_norm_cpu_train_channels_last(Tensor& output, const Tensor& input,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& save_mean, const Tensor& save_invstd) {
+
+  int64_t n_channel = input.size(1);
+  std::vector<scalar_t> alpha(n_channel);
+  std::vector<scalar_t> beta(n_channel);
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* mean_data = save_mean.data_ptr<scalar_t>();
+  const scalar_t* invstd_data = save_invstd.data_ptr<scalar_t>();
+  for (int64_t c = 0; c < n_channel; c++) {
+    scalar_t weight_v = weight_data ? weight_data[c] : 1;
+    scalar_t bias_v = bias_data ? bias_data[c] : 0;
+    alpha[c] = invstd_data[c] * weight_v;
+    beta[c] = bias_v - mean_data[c] * alpha[c];
+  }
+  batch_norm_cpu_channels_last_apply<scalar_t>(output, input, alpha.data(), beta.data());
+}
+
 template<typename scalar_t>
 std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -175,7 +205,19 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     return std::make_tuple(output, save_mean, save_invstd);
   }
 
-  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (train && input.is_contiguous(at::MemoryFormat::ChannelsLast)
+      && (!weight.defined() || weight.is_contiguous())
+      && (!bias.defined() || bias.is_contiguous())) {
+
+    Tensor output = at::empty_like(input, at::MemoryFormat::ChannelsLast);
+    batch_norm_cpu_train_channels_last<scalar_t>(
+      output, input, weight, bias, save_mean, save_invstd);
+    return std::make_tuple(output, save_mean, save_invstd);
+  }
+
+  // the loop below goes through any strides, so that the output keeps the
+  // memory format of the input
+  Tensor output = at::empty_like(input, input.suggest_memory_format());
 
   int64_t n_input = input.size(1);
 
@@ -230,6 +272,33 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  // Channels last, the planes are strided by the number of channels, so that
+  // the statistics are reduced over all the other dimensions at once instead.
+  if (input.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    std::vector<int64_t> reduce_dims = {0};
+    for (int64_t d = 2; d < input.dim(); d++) {
+      reduce_dims.push_back(d);
+    }
+    Tensor batch_var, batch_mean;
+    std::tie(batch_var, batch_mean) = at::var_mean(input, reduce_dims, /*unbiased=*/false);
+    auto batch_var_a = batch_var.accessor<scalar_t, 1>();
+    auto batch_mean_a = batch_mean.accessor<scalar_t, 1>();
+    for (int64_t f = 0; f < n_input; ++f) {
+      accscalar_t mean = batch_mean_a[f];
+      accscalar_t var = batch_var_a[f];
+      save_mean_a[f] = mean;
+      save_var_transform_a[f] = VarTransform<accscalar_t>{}(var, eps);
+      if (running_mean.defined()) {
+        running_mean_a[f] = momentum * mean + (1 - momentum) * running_mean_a[f];
+      }
+      if (running_var.defined()) {
+        accscalar_t unbiased_var = var * n / (n - 1);
+        running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
+      }
+    }
+    return std::make_tuple(save_mean, save_var_transform);
+  }
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -280,7 +349,7 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_weight;
   Tensor grad_bias;
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    grad_input = at::empty_like(input, input.suggest_memory_format());
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
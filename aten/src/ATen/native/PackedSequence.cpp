@@ -118,7 +118,95 @@ Tensor _pack_padded_sequence_backward(const Tensor& grad, at::IntArrayRef input_
   return grad_input;
 }
 
-std::tuple<Tensor, Tensor> _pad_packed_sequence(const Tensor& data, const Tensor& _batch_sizes, bool batch_first, Scalar padding_value, int64_t total_length) {
+// Same as _pack_padded_sequence, for a batch that isn't sorted by length:
+// `lengths` are the lengths sorted in decreasing order, and `sorted_indices`
+// the batch entries they belong to. Each block of steps is gathered from the
+// padded input straight into its place in the packed data, instead of
+// sorting the whole padded batch first and copying it again to pack it.
+std::tuple<Tensor, Tensor> _pack_padded_sequence_unsorted(const Tensor& _input, const Tensor& _lengths, const Tensor& sorted_indices, bool batch_first) {
+  auto input = batch_first ? _input.transpose(0, 1) : _input;
+  auto lengths_t = _lengths.contiguous();
+  checkLongTensor(lengths_t);
+
+  int64_t batch_size = input.size(1);
+  int64_t * lengths = lengths_t.data_ptr<int64_t>();
+  TORCH_CHECK(input.numel() > 0, "Cannot pack empty tensors.");
+  TORCH_CHECK(lengths_t.size(0) == batch_size,
+           "Expected `len(lengths)` to be equal to batch_size, but got ", lengths_t.size(0),
+           " (batch_size=", batch_size, ")");
+  TORCH_CHECK(sorted_indices.dim() == 1 && sorted_indices.size(0) == batch_size,
+           "Expected `sorted_indices` to be a 1D tensor of batch_size=", batch_size,
+           " indices, but got one of size ", sorted_indices.sizes());
+  TORCH_CHECK(lengths[batch_size - 1] > 0,
+           "Length of all samples has to be greater than 0, but found an element "
+           "in 'lengths' that is <= 0");
+  int64_t total_length = 0;
+  for (int64_t i = 0; i < batch_size; i++) {
+    TORCH_CHECK(i == 0 || lengths[i] <= lengths[i - 1],
+             "_pack_padded_sequence_unsorted: `lengths` must be sorted in decreasing order");
+    total_length += lengths[i];
+  }
+
+  at::Tensor batch_sizes_t = at::empty(lengths[0], _lengths.options());
+  int64_t * batch_sizes = batch_sizes_t.data_ptr<int64_t>();
+
+  std::vector<int64_t> data_shape = input.sizes().slice(1).vec(); // == [total_length, *input.shape[2:]]
+  data_shape[0] = total_length;
+  auto data = at::empty(data_shape, input.options());
+  std::vector<int64_t> block_shape = input.sizes().vec(); // == [steps, batch, *input.shape[2:]]
+
+  // Same scan as in _pack_padded_sequence, from the shortest sequence
+  int64_t prev_l = 0;
+  int64_t offset = 0;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    int64_t l = lengths[batch_size - 1 - i];
+    if (l > prev_l) {
+      auto current_batch_size = batch_size - i;
+      block_shape[0] = l - prev_l;
+      block_shape[1] = current_batch_size;
+      auto block = data.narrow(0, offset, (l - prev_l) * current_batch_size).view(block_shape);
+      at::index_select_out(
+          block, input.slice(0, prev_l, l), 1, sorted_indices.narrow(0, 0, current_batch_size));
+      offset += (l - prev_l) * current_batch_size;
+      for (int64_t j = 0; j < (l - prev_l); ++j) {
+        (*batch_sizes++) = current_batch_size;
+      }
+      prev_l = l;
+    }
+  }
+
+  return std::make_tuple(data, batch_sizes_t);
+}
+
+Tensor _pack_padded_sequence_unsorted_backward(const Tensor& grad, at::IntArrayRef input_size, const Tensor& _batch_sizes, const Tensor& sorted_indices, bool batch_first) {
+  std::vector<int64_t> input_size_after_t = input_size.vec();
+  if (batch_first) {
+    TORCH_CHECK(input_size.size() >= 2);
+    std::swap(input_size_after_t[0], input_size_after_t[1]);
+  }
+  auto grad_input = at::zeros(input_size_after_t, grad.options());
+  auto batch_sizes_t = _batch_sizes.contiguous();
+  checkLongTensor(batch_sizes_t);
+
+  int64_t offset = 0;
+  int64_t max_seq_len = batch_sizes_t.size(0);
+  int64_t * batch_sizes = batch_sizes_t.data_ptr<int64_t>();
+  for (int64_t i = 0; i < max_seq_len; ++i) {
+    grad_input[i].index_copy_(
+        0, sorted_indices.narrow(0, 0, batch_sizes[i]), grad.slice(0, offset, offset + batch_sizes[i]));
+    offset += batch_sizes[i];
+  }
+
+  if (batch_first) {
+    grad_input = grad_input.transpose(0, 1);
+  }
+
+  return grad_input;
+}
+
+// When sorted_indices is defined, the batch entries of the output are put
+// back in their original order as the blocks are copied.
+static std::tuple<Tensor, Tensor> pad_packed_sequence_impl(const Tensor& data, const Tensor& _batch_sizes, const Tensor& sorted_indices, bool batch_first, Scalar padding_value, int64_t total_length) {
   auto batch_sizes_t = _batch_sizes.contiguous();
   checkLongTensor(batch_sizes_t);
 
@@ -161,7 +249,12 @@ std::tuple<Tensor, Tensor> _pad_packed_sequence(const Tensor& data, const Tensor
       auto tmp = data.slice(0, data_offset, data_offset + l);
       tmp_view_size[0] = i - prev_i;
       tmp_view_size[1] = prev_batch_size;
-      output.slice(0, prev_i, i).slice(1, 0, prev_batch_size).copy_(tmp.view(tmp_view_size));
+      if (sorted_indices.defined()) {
+        output.slice(0, prev_i, i).index_copy_(
+            1, sorted_indices.narrow(0, 0, prev_batch_size), tmp.view(tmp_view_size));
+      } else {
+        output.slice(0, prev_i, i).slice(1, 0, prev_batch_size).copy_(tmp.view(tmp_view_size));
+      }
       data_offset += l;
       prev_i = i;
     }
@@ -174,6 +267,10 @@ std::tuple<Tensor, Tensor> _pad_packed_sequence(const Tensor& data, const Tensor
     prev_batch_size = batch_size;
   }
 
+  if (sorted_indices.defined()) {
+    lengths_t = at::empty_like(lengths_t).index_copy_(0, sorted_indices.cpu(), lengths_t);
+  }
+
   if (batch_first) {
     output = output.transpose(0, 1);
   }
@@ -181,4 +278,15 @@ std::tuple<Tensor, Tensor> _pad_packed_sequence(const Tensor& data, const Tensor
   return std::make_tuple(output, lengths_t);
 }
 
+std::tuple<Tensor, Tensor> _pad_packed_sequence(const Tensor& data, const Tensor& _batch_sizes, bool batch_first, Scalar padding_value, int64_t total_length) {
+  return pad_packed_sequence_impl(data, _batch_sizes, Tensor(), batch_first, padding_value, total_length);
+}
+
+std::tuple<Tensor, Tensor> _pad_packed_sequence_unsorted(const Tensor& data, const Tensor& _batch_sizes, const Tensor& sorted_indices, bool batch_first, Scalar padding_value, int64_t total_length) {
+  TORCH_CHECK(sorted_indices.dim() == 1 && sorted_indices.size(0) == _batch_sizes[0].item<int64_t>(),
+           "Expected `sorted_indices` to hold one index per batch entry, but got one of size ",
+           sorted_indices.sizes());
+  return pad_packed_sequence_impl(data, _batch_sizes, sorted_indices, batch_first, padding_value, total_length);
+}
+
 }} // namespace at::native
@@ -4,6 +4,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
@@ -654,6 +655,20 @@ tpair_of<Tensor> hidden_slice(const tpair_of<Tensor>& t, int64_t start, int64_t
 // It's a struct only because functional programming in C++ is a pain, and it's easier
 // to pass around "vtable pointers" than actual function pointers.
 
+// The fused pointwise kernels have no derivative, so they only replace the
+// chain of pointwise ops when none of their inputs requires grad, which is
+// the case for inference and for all quantized cells.
+bool use_fused_cell_pointwise(TensorList tensors) {
+  const auto dtype = tensors[0].scalar_type();
+  for (const auto& t : tensors) {
+    if (!t.device().is_cpu() || t.scalar_type() != dtype || t.dim() != 2 ||
+        (GradMode::is_enabled() && t.requires_grad())) {
+      return false;
+    }
+  }
+  return dtype == kFloat || dtype == kDouble;
+}
+
 template<typename hidden_type_tmpl, typename cell_params_tmpl>
 struct Cell {
   using hidden_type = hidden_type_tmpl;
@@ -707,6 +722,13 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
 
     const auto gates = params.linear_hh(hx).add_(
         pre_compute_input ? input : params.linear_ih(input));
+    if (use_fused_cell_pointwise({gates, cx})) {
+      auto cx_contig = cx.contiguous();
+      auto hy = at::empty_like(cx_contig, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      auto cy = at::empty_like(cx_contig, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      lstm_cell_pointwise_stub(kCPU, hy, cy, gates.contiguous(), cx_contig);
+      return std::make_tuple(std::move(hy), std::move(cy));
+    }
     auto chunked_gates = gates.unsafe_chunk(4, 1);
     auto ingate = chunked_gates[0].sigmoid_();
     auto forgetgate = chunked_gates[1].sigmoid_();
@@ -737,10 +759,17 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
-    const auto chunked_igates = pre_compute_input
-        ? input.unsafe_chunk(3, 1)
-        : params.linear_ih(input).unsafe_chunk(3, 1);
-    auto chunked_hgates = params.linear_hh(hidden).unsafe_chunk(3, 1);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    const auto hgates = params.linear_hh(hidden);
+    if (use_fused_cell_pointwise({igates, hgates, hidden})) {
+      auto hidden_contig = hidden.contiguous();
+      auto hy = at::empty_like(hidden_contig, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+      gru_cell_pointwise_stub(
+          kCPU, hy, igates.contiguous(), hgates.contiguous(), hidden_contig);
+      return hy;
+    }
+    const auto chunked_igates = igates.unsafe_chunk(3, 1);
+    auto chunked_hgates = hgates.unsafe_chunk(3, 1);
     const auto reset_gate =
         chunked_hgates[0].add_(chunked_igates[0]).sigmoid_();
     const auto input_gate =
@@ -751,6 +780,114 @@ struct GRUCell : Cell<Tensor, cell_params> {
   }
 };
 
+// Whole-sequence counterparts of the fused cells above for dense CPU LSTM and
+// GRU layers. The input projection of every step is computed up front, the
+// gates of a step go to a single preallocated buffer through addmm_out, and
+// each hidden state is written by the pointwise kernel straight into its
+// slot of the layer output, so the time loop doesn't allocate.
+// Return false if the layer doesn't qualify, in which case the cells are run
+// step by step.
+bool fused_cpu_layer_supported(const Tensor& input, const CellParams& params, TensorList hiddens) {
+  if (!input.device().is_cpu() || input.dim() != 3 || input.size(0) == 0) {
+    return false;
+  }
+  std::vector<Tensor> tensors = {input[0], params.w_ih, params.w_hh};
+  tensors.insert(tensors.end(), hiddens.begin(), hiddens.end());
+  for (const Tensor* bias : {&params.b_ih_, &params.b_hh_}) {
+    if (bias->defined() && (bias->scalar_type() != input.scalar_type() ||
+                            (GradMode::is_enabled() && bias->requires_grad()))) {
+      return false;
+    }
+  }
+  return use_fused_cell_pointwise(tensors);
+}
+
+template <typename hidden_type, typename cell_params>
+bool fused_cpu_layer(
+    const Cell<hidden_type, cell_params>& /* cell */,
+    const Tensor& /* input */,
+    const hidden_type& /* input_hidden */,
+    const cell_params& /* params */,
+    bool /* reverse */,
+    Tensor& /* output */,
+    hidden_type& /* final_hidden */) {
+  return false;
+}
+
+bool fused_cpu_layer(
+    const Cell<tpair_of<Tensor>, CellParams>& /* cell, always an LSTMCell */,
+    const Tensor& input,
+    const tpair_of<Tensor>& input_hidden,
+    const CellParams& params,
+    bool reverse,
+    Tensor& output,
+    tpair_of<Tensor>& final_hidden) {
+  const auto& hx = std::get<0>(input_hidden);
+  const auto cx = std::get<1>(input_hidden).contiguous();
+  if (!fused_cpu_layer_supported(input, params, {hx, cx})) {
+    return false;
+  }
+  const int64_t seq_len = input.size(0);
+  // b_hh is added once to the input projection of the whole sequence
+  auto inputs_w = params.linear_ih(input);
+  if (params.b_hh_.defined()) {
+    inputs_w.add_(params.b_hh_);
+  }
+  const auto w_hh_t = params.w_hh.t();
+  output = at::empty({seq_len, cx.size(0), cx.size(1)}, cx.options());
+  auto gates = at::empty({cx.size(0), 4 * cx.size(1)}, cx.options());
+  // cy alternates between two buffers, cx itself is never written
+  Tensor cy_buffers[2] = {at::empty_like(cx), at::empty_like(cx)};
+  Tensor h = hx;
+  Tensor c = cx;
+  for (int64_t step = 0; step < seq_len; step++) {
+    const int64_t t = reverse ? seq_len - 1 - step : step;
+    at::addmm_out(gates, inputs_w[t], h, w_hh_t);
+    auto hy = output[t];
+    auto& cy = cy_buffers[step % 2];
+    lstm_cell_pointwise_stub(kCPU, hy, cy, gates, c);
+    h = hy;
+    c = cy;
+  }
+  final_hidden = std::make_tuple(std::move(h), std::move(c));
+  return true;
+}
+
+bool fused_cpu_layer(
+    const Cell<Tensor, CellParams>& cell,
+    const Tensor& input,
+    const Tensor& input_hidden,
+    const CellParams& params,
+    bool reverse,
+    Tensor& output,
+    Tensor& final_hidden) {
+  const auto hx = input_hidden.contiguous();
+  if (dynamic_cast<const GRUCell<CellParams>*>(&cell) == nullptr ||
+      !fused_cpu_layer_supported(input, params, {hx})) {
+    return false;
+  }
+  const int64_t seq_len = input.size(0);
+  const auto inputs_w = params.linear_ih(input);
+  const auto w_hh_t = params.w_hh.t();
+  output = at::empty({seq_len, hx.size(0), hx.size(1)}, hx.options());
+  auto hgates = at::empty({hx.size(0), 3 * hx.size(1)}, hx.options());
+  Tensor h = hx;
+  for (int64_t step = 0; step < seq_len; step++) {
+    const int64_t t = reverse ? seq_len - 1 - step : step;
+    // b_hh stays in hgates, the reset gate multiplies its new gate part
+    if (params.b_hh_.defined()) {
+      at::addmm_out(hgates, params.b_hh_, h, w_hh_t);
+    } else {
+      at::mm_out(hgates, h, w_hh_t);
+    }
+    auto hy = output[t];
+    gru_cell_pointwise_stub(kCPU, hy, inputs_w[t], hgates, h);
+    h = hy;
+  }
+  final_hidden = std::move(h);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // LAYER IMPLEMENTATIONS
 //
@@ -808,6 +945,12 @@ struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
       const hidden_type& input_hidden,
       const cell_params& params) const override {
     if (inputs.device().is_cpu()) {
+      Tensor outputs;
+      hidden_type final_hidden;
+      if (fused_cpu_layer(cell_, inputs, input_hidden, params, /*reverse=*/false,
+                          outputs, final_hidden)) {
+        return {outputs, final_hidden};
+      }
       const auto inputs_w = params.linear_ih(inputs);
       auto unstacked_output =
           (*this)(inputs_w.unbind(0), input_hidden, params, true);
@@ -838,6 +981,15 @@ struct FullBidirectionalLayer
       const param_type& params) const override {
     std::vector<Tensor> step_inputs;
     if (input.device().is_cpu()) {
+      Tensor fw_output, rev_output;
+      dir_hidden_type fw_hidden, rev_hidden;
+      if (fused_cpu_layer(layer_.cell_, input, input_hidden.first, params.first,
+                          /*reverse=*/false, fw_output, fw_hidden) &&
+          fused_cpu_layer(layer_.cell_, input, input_hidden.second, params.second,
+                          /*reverse=*/true, rev_output, rev_hidden)) {
+        return {at::cat({fw_output, rev_output}, fw_output.dim() - 1),
+                std::make_pair(std::move(fw_hidden), std::move(rev_hidden))};
+      }
       auto input_w = params.first.linear_ih(input);
       step_inputs = input_w.unbind(0);
       auto fw_result = layer_(
@@ -1124,6 +1276,9 @@ bool _use_cudnn_rnn_flatten_weight() {
   return detail::getCUDAHooks().compiledWithCuDNN();
 }
 
+DEFINE_DISPATCH(lstm_cell_pointwise_stub);
+DEFINE_DISPATCH(gru_cell_pointwise_stub);
+
 ////////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,7 @@ DEFINE_DISPATCH(and_stub);
 DEFINE_DISPATCH(or_stub);
 DEFINE_DISPATCH(min_values_stub);
 DEFINE_DISPATCH(max_values_stub);
+DEFINE_DISPATCH(min_max_stub);
 DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
@@ -628,6 +629,20 @@ Tensor max_values(const Tensor& self, IntArrayRef dims, bool keepdim) {
   }
 }
 
+std::tuple<Tensor, Tensor> _min_max_dim(const Tensor& self, int64_t dim, bool keepdim) {
+  TORCH_CHECK(!self.is_complex(), "_min_max is not yet implemented for complex tensors.");
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(self.dim() == 0 || self.size(dim) > 0,
+      "_min_max(): cannot reduce over a zero-size dimension.");
+  Tensor min_result = at::empty({0}, self.options());
+  Tensor max_result = at::empty({0}, self.options());
+  auto iter = make_reduction("_min_max", min_result, max_result, self, dim, keepdim, self.scalar_type());
+  if (iter.numel() > 0) {
+    min_max_stub(iter.device_type(), iter);
+  }
+  return std::tuple<Tensor, Tensor>(min_result, max_result);
+}
+
 Tensor min_values(const Tensor& self, DimnameList dims, bool keepdim) {
   TORCH_CHECK(false, "NYI: min_values with names");
   return at::min_values(self, dimnames_to_positions(self, dims), keepdim);
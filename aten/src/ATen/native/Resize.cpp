@@ -95,5 +95,20 @@ Tensor& resize_(
   return self;
 }
 
+Tensor& resize_amortized_(Tensor& self, IntArrayRef size) {
+  if (self.has_names()) {
+    return resize_named_tensor_(self, size, c10::nullopt);
+  }
+  resize_impl_cpu_(
+      self.unsafeGetTensorImpl(), size, /*strides=*/c10::nullopt, /*amortized=*/true);
+  return self;
+}
+
+Tensor& reserve_cpu_(Tensor& self, int64_t capacity) {
+  TORCH_CHECK(capacity >= 0, "reserve_: capacity must be non-negative, got ", capacity);
+  maybe_resize_storage_cpu(self.unsafeGetTensorImpl(), capacity);
+  return self;
+}
+
 } // namespace native
 } // namespace at
@@ -19,7 +19,13 @@ void resize_output(Tensor& output, IntArrayRef shape);
 // They are not in TH/THTensor.cpp because the at namespace is easier
 // to benchmark than TH; I can't get gbenchmark to call fns from THTensor.cpp
 
-static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size) {
+// With amortized set, a storage that has to grow is grown to at least twice
+// its current size, so that growing a tensor step by step (e.g. appending to
+// a cache) copies each element amortized O(1) times, like std::vector.
+static inline void maybe_resize_storage_cpu(
+    TensorImpl* self,
+    int64_t new_size,
+    bool amortized = false) {
   // It does not make sense to try to resize a storage
   // to hold 0 elements, and this can break
   // if storage_offset is positive but
@@ -34,6 +40,10 @@ static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size)
     int64_t new_size_bytes =
         (new_size + self->storage_offset()) * self->dtype().itemsize();
     if (new_size_bytes > self->storage().nbytes()) {
+      if (amortized) {
+        new_size_bytes = std::max(
+            new_size_bytes, 2 * static_cast<int64_t>(self->storage().nbytes()));
+      }
       THStorage_resizeBytes(THTensor_getStoragePtr(self), new_size_bytes);
     }
   }
@@ -42,7 +52,8 @@ static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size)
 inline TensorImpl* resize_impl_cpu_(
     TensorImpl* self,
     IntArrayRef size,
-    c10::optional<IntArrayRef> stride) {
+    c10::optional<IntArrayRef> stride,
+    bool amortized = false) {
   if (self->sizes() == size && (!stride || self->strides() == stride)) {
     return self;
   }
@@ -64,7 +75,7 @@ inline TensorImpl* resize_impl_cpu_(
     self->set_sizes_contiguous(size);
     storage_size = self->numel();
   }
-  maybe_resize_storage_cpu(self, storage_size);
+  maybe_resize_storage_cpu(self, storage_size, amortized);
 
   return self;
 }
@@ -394,6 +394,38 @@ struct MaxOps :
   public detail::MinMaxReductionOps<detail::GreaterOrNan<scalar_t>> {
 };
 
+// Computes the minimum and the maximum in a single pass over the input, as
+// the two outputs of the reduction. NaNs propagate to both.
+template <typename scalar_t, typename acc_t, typename res_t>
+struct MinMaxOps {
+  using arg_t = detail::pair<acc_t, acc_t>;
+
+  inline C10_DEVICE arg_t reduce(arg_t acc, scalar_t data, int64_t /*idx*/) const {
+    return combine(acc, arg_t(acc_t(data), acc_t(data)));
+  }
+
+  inline C10_DEVICE arg_t combine(arg_t a, arg_t b) const {
+    return arg_t(
+        detail::LessOrNan<acc_t>{}(a.first, b.first) ? a.first : b.first,
+        detail::GreaterOrNan<acc_t>{}(a.second, b.second) ? a.second : b.second);
+  }
+
+  inline C10_DEVICE res_t project(arg_t a) const {
+    return res_t(scalar_t(a.first), scalar_t(a.second));
+  }
+
+  static C10_DEVICE arg_t translate_idx(arg_t a, int64_t /*base_idx*/) {
+    return a;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE arg_t warp_shfl_down(arg_t a, int offset) const {
+    return arg_t(WARP_SHFL_DOWN(a.first, offset),
+                 WARP_SHFL_DOWN(a.second, offset));
+  }
+#endif
+};
+
 }} // namespace at::native
 
 #undef MAX
@@ -4,6 +4,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/WrapDimUtils.h>
+#include <ATen/native/Resize.h>
 #include <ATen/native/cpu/SoftmaxKernel.h>
 #include <ATen/NamedTensorUtils.h>
 
@@ -117,30 +118,45 @@ void host_softmax_backward(
 }
 } // namespace
 
-Tensor softmax_cpu(const Tensor& input_, const int64_t dim_, const bool half_to_float) {
+Tensor& softmax_out_cpu(Tensor& output, const Tensor& input_, const int64_t dim_, const bool half_to_float) {
   AT_ASSERTM(!half_to_float, "softmax with half to float conversion is not supported on CPU");
+  TORCH_CHECK(
+      output.scalar_type() == input_.scalar_type(),
+      "softmax: expected out to have dtype ", input_.scalar_type(),
+      ", but got ", output.scalar_type());
   auto input = input_.contiguous();
-  Tensor output = at::native::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  resize_output(output, input.sizes());
+  TORCH_CHECK(output.is_contiguous(), "softmax: expected a contiguous out");
   int64_t dim = maybe_wrap_dim(dim_, input.dim());
 
   if (input.numel() == 0) {
     return output;
   }
- if (input.dim() == 0)
+  Tensor output_ = output;
+  if (input.dim() == 0) {
     input = input.view(1);
+    output_ = output.view(1);
+  }
   TORCH_CHECK(
       dim >= 0 && dim < input.dim(),
       "dim must be non-negative and less than input dimensions");
   if (input.ndimension() > 0 && dim == input.ndimension() - 1) {
-    softmax_lastdim_kernel(kCPU, output, input);
+    softmax_lastdim_kernel(kCPU, output_, input);
   } else {
-    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "softmax", [&] {
-      host_softmax<scalar_t, false>(output, input, dim);
-    });
+    AT_DISPATCH_FLOATING_TYPES_AND(
+        at::ScalarType::BFloat16, input.scalar_type(), "softmax", [&] {
+          host_softmax<scalar_t, false>(output_, input, dim);
+        });
   }
   return output;
 }
 
+Tensor softmax_cpu(const Tensor& input_, const int64_t dim_, const bool half_to_float) {
+  Tensor output = at::native::empty_like(input_, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  softmax_out_cpu(output, input_, dim_, half_to_float);
+  return output;
+}
+
 Tensor log_softmax_cpu(const Tensor& input_, const int64_t dim_, const bool half_to_float) {
   AT_ASSERTM(!half_to_float, "softmax with half to float conversion is not supported on CPU");
   auto input = input_.contiguous();
@@ -190,9 +206,10 @@ Tensor softmax_backward_cpu(
   if (grad.ndimension() > 0 && dim == grad.ndimension() - 1) {
     softmax_backward_lastdim_kernel(kCPU, grad_input, grad, output);
   } else {
-    AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "softmax_backward", [&] {
-      host_softmax_backward<scalar_t, false>(grad_input, grad, output, dim);
-    });
+    AT_DISPATCH_FLOATING_TYPES_AND(
+        at::ScalarType::BFloat16, grad.scalar_type(), "softmax_backward", [&] {
+          host_softmax_backward<scalar_t, false>(grad_input, grad, output, dim);
+        });
   }
   return grad_input;
 }
@@ -5,11 +5,35 @@
 namespace at {
 namespace native {
 
+// Selects the `it`-th 1-d slice along `dim` of each of the tensors, which
+// all have the sizes of tensors[0] outside of `dim`.
+inline void select_dim_slices(
+    TensorList tensors,
+    int64_t dim,
+    int64_t it,
+    std::vector<Tensor>& narrowed_tensors) {
+  auto sizes = tensors[0].sizes();
+  int64_t ndim = tensors[0].dim();
+  narrowed_tensors.clear();
+  for (auto ti : tensors) {
+    int64_t i = it;
+    Tensor nt = ti;
+    for (int64_t d = 0; d < ndim; d++) {
+      if (d != dim) {
+        // this could be avoided for slower-changing dimensions if done
+        // better
+        nt = nt.select((d > dim ? 1 : 0), i % sizes[d]);
+        i = i / sizes[d];
+      }
+    }
+    narrowed_tensors.emplace_back(nt);
+  }
+}
+
 template <typename Fn>
 void dim_apply(TensorList tensors, int64_t dim, Fn f) {
   AT_ASSERT(tensors.size() > 0);
   auto t = tensors[0];
-  auto sizes = t.sizes();
   int64_t ndim = t.dim();
   int64_t itersize = 1;
   for (int64_t i = 0; i < ndim; i++) {
@@ -21,20 +45,7 @@ void dim_apply(TensorList tensors, int64_t dim, Fn f) {
     std::vector<Tensor> narrowed_tensors;
     narrowed_tensors.reserve(tensors.size());
     for (int64_t it = i_begin; it < i_end; it++) {
-      narrowed_tensors.clear();
-      for (auto ti : tensors) {
-        int64_t i = it;
-        Tensor nt = ti;
-        for (int64_t d = 0; d < ndim; d++) {
-          if (d != dim) {
-            // this could be avoided for slower-changing dimensions if done
-            // better
-            nt = nt.select((d > dim ? 1 : 0), i % sizes[d]);
-            i = i / sizes[d];
-          }
-        }
-        narrowed_tensors.emplace_back(nt);
-      }
+      select_dim_slices(tensors, dim, it, narrowed_tensors);
       f(it, narrowed_tensors);
     }
   });
@@ -2,14 +2,53 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
 #include <tuple>
+#include <vector>
 
 namespace at { namespace native {
 
 ///////////////// bincount /////////////////
 namespace {
 
+// Adds weight(i) to the bin of every element i. When the input is large
+// enough, every chunk of it accumulates into bins of its own, which are summed
+// at the end, so that floating point weights may round differently with a
+// different number of threads.
+template <typename input_t, typename output_t, typename func_t>
+void _bincount_cpu_accumulate(
+    const input_t* self_p,
+    int64_t self_size,
+    int64_t nbins,
+    output_t* output_p,
+    const func_t& weight) {
+  const int64_t max_chunks = self_size / std::max<int64_t>(internal::GRAIN_SIZE, nbins);
+  const int64_t num_chunks = std::min<int64_t>(at::get_num_threads(), max_chunks);
+  if (num_chunks <= 1) {
+    for (int64_t i = 0; i < self_size; i++) {
+      output_p[self_p[i]] += weight(i);
+    }
+    return;
+  }
+  std::vector<output_t> chunk_bins(num_chunks * nbins, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      output_t* bins = chunk_bins.data() + chunk * nbins;
+      for (int64_t i = chunk * self_size / num_chunks; i < (chunk + 1) * self_size / num_chunks; i++) {
+        bins[self_p[i]] += weight(i);
+      }
+    }
+  });
+  at::parallel_for(0, nbins, internal::GRAIN_SIZE / num_chunks, [&](int64_t begin, int64_t end) {
+    for (int64_t bin = begin; bin < end; ++bin) {
+      for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+        output_p[bin] += chunk_bins[chunk * nbins + bin];
+      }
+    }
+  });
+}
+
 template <typename input_t, typename weights_t>
 Tensor _bincount_cpu_template(
     const Tensor& self,
@@ -40,15 +79,15 @@ Tensor _bincount_cpu_template(
     output = native::zeros({nbins}, weights.options());
     weights_t* output_p = output.data_ptr<weights_t>();
     const weights_t* weights_p = weights.data_ptr<weights_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
+    _bincount_cpu_accumulate(self_p, self_size, nbins, output_p, [weights_p](int64_t i) {
+      return weights_p[i];
+    });
   } else {
     output = native::zeros({nbins}, kLong);
     int64_t* output_p = output.data_ptr<int64_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += 1L;
-    }
+    _bincount_cpu_accumulate(self_p, self_size, nbins, output_p, [](int64_t /*i*/) {
+      return 1L;
+    });
   }
   return output;
 }
@@ -798,4 +798,22 @@ std::vector<Tensor> nonzero_numpy(const Tensor& self) {
   return self.nonzero().unbind(1);
 }
 
+std::tuple<Tensor, Tensor> _nonzero_static_cpu(const Tensor& self, int64_t size, int64_t fill_value) {
+  TORCH_CHECK(size >= 0, "_nonzero_static: expected a non-negative size, but got ", size);
+  Tensor indices = self.nonzero();
+  Tensor result = at::full({size, self.dim()}, fill_value, indices.options());
+  const int64_t count = indices.size(0);
+  result.narrow(0, 0, std::min(count, size)).copy_(indices.narrow(0, 0, std::min(count, size)));
+  return std::make_tuple(result, at::scalar_tensor(count, indices.options()));
+}
+
+std::tuple<Tensor, Tensor> _masked_select_static_cpu(const Tensor& self, const Tensor& mask, int64_t size) {
+  TORCH_CHECK(size >= 0, "_masked_select_static: expected a non-negative size, but got ", size);
+  Tensor values = at::masked_select(self, mask);
+  Tensor result = at::zeros({size}, self.options());
+  const int64_t count = values.numel();
+  result.narrow(0, 0, std::min(count, size)).copy_(values.narrow(0, 0, std::min(count, size)));
+  return std::make_tuple(result, at::scalar_tensor(count, self.options().dtype(kLong)));
+}
+
 }} // at::native
@@ -29,6 +29,14 @@ static inline Tensor to_impl(const Tensor& self, const TensorOptions& options, b
     return self;
   }
 
+  if (self.is_meta()) {
+    // The factories below would allocate a real tensor, see Note [Meta kernels]
+    if (memory_format == MemoryFormat::Preserve) {
+      memory_format = self.suggest_memory_format();
+    }
+    return at::empty_meta(self.sizes(), options.memory_format(memory_format));
+  }
+
   if (memory_format == MemoryFormat::Preserve) {
     if (self.is_non_overlapping_and_dense()) {
       // Copy all strides
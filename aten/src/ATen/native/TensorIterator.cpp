@@ -1132,6 +1132,132 @@ FastSetupType TensorIterator::compute_fast_setup_type(const TensorIteratorConfig
   return FastSetupType::NONE;
 }
 
+// Note [TensorIterator plan cache]
+// For small tensors the slow path of build() (compute_strides,
+// reorder_dimensions, allocate_outputs and coalesce_dimensions) is a
+// noticeable part of the cost of an op. Its result only depends on the
+// geometry of the operands: the broadcasted shape, each operand's sizes,
+// strides and element size, and which outputs still have to be allocated.
+// Loops that call the same op on the same geometry over and over (e.g.
+// inference) therefore recompute the same answer every time.
+//
+// We keep a small per-thread cache of recent results ("plans") keyed on
+// that geometry. On a hit, build() copies the computed shape and strides
+// out of the plan and allocates missing outputs with the recorded
+// sizes/strides directly. Everything that depends on more than geometry
+// (overlap checks, name inference, type computation) still runs on every
+// build(). The key records every input of the slow path, so a hit yields
+// exactly what the slow path would have computed.
+namespace {
+
+constexpr int kPlanCacheSize = 8;
+constexpr int kMaxPlanDims = 6;
+constexpr int kMaxPlanOperands = 8;
+
+struct IteratorPlan {
+  TensorIterator::PlanKey key;
+  DimVector shape;
+  DimVector perm;
+  SmallVector<StrideVector, 4> stride_bytes;
+  // Sizes and strides of the outputs once allocate_outputs() has run.
+  SmallVector<DimVector, 2> output_sizes;
+  SmallVector<DimVector, 2> output_strides;
+};
+
+struct PlanCache {
+  std::array<IteratorPlan, kPlanCacheSize> plans;
+  int size = 0;
+  int next = 0;
+
+  const IteratorPlan* find(const TensorIterator::PlanKey& key) const {
+    for (int i = 0; i < size; i++) {
+      if (plans[i].key == key) {
+        return &plans[i];
+      }
+    }
+    return nullptr;
+  }
+
+  IteratorPlan& insert() {
+    IteratorPlan& plan = plans[next];
+    next = (next + 1) % kPlanCacheSize;
+    size = std::min(size + 1, kPlanCacheSize);
+    return plan;
+  }
+};
+
+thread_local PlanCache plan_cache;
+
+} // namespace
+
+bool TensorIterator::compute_plan_key(const TensorIteratorConfig& config, PlanKey& key) {
+  if (ndim() > kMaxPlanDims || ntensors() > kMaxPlanOperands) {
+    return false;
+  }
+  key.push_back(config.static_shape_.has_value());
+  key.push_back(is_reduction_);
+  key.push_back(num_outputs_);
+  key.push_back(ntensors());
+  key.push_back(ndim());
+  key.append(shape_.begin(), shape_.end());
+  for (auto& op : operands_) {
+    key.push_back(op.is_output);
+    if (op.tensor.defined()) {
+      key.push_back(op.tensor.element_size());
+      key.push_back(op.tensor.dim());
+      auto sizes = op.tensor.sizes();
+      auto strides = op.tensor.strides();
+      key.append(sizes.begin(), sizes.end());
+      key.append(strides.begin(), strides.end());
+    } else {
+      // -1 marks an output that allocate_outputs() has to create
+      key.push_back(op.is_type_defined() ? elementSize(op.target_dtype) : 0);
+      key.push_back(-1);
+    }
+  }
+  return true;
+}
+
+bool TensorIterator::set_up_from_cached_plan(const PlanKey& key) {
+  const IteratorPlan* plan = plan_cache.find(key);
+  if (!plan) {
+    return false;
+  }
+  shape_ = plan->shape;
+  perm_ = plan->perm;
+  for (int i = 0; i < ntensors(); i++) {
+    auto& op = operands_[i];
+    op.stride_bytes = plan->stride_bytes[i];
+    if (!op.tensor.defined()) {
+      TORCH_INTERNAL_ASSERT(op.is_type_defined(), "no type for operand", i);
+      op.tensor = at::empty_strided(
+          plan->output_sizes[i], plan->output_strides[i], op.options());
+      op.current_dtype = op.target_dtype;
+    }
+  }
+  has_coalesced_dimensions_ = true;
+  return true;
+}
+
+void TensorIterator::cache_plan(const PlanKey& key) {
+  IteratorPlan& plan = plan_cache.insert();
+  plan.key = key;
+  plan.shape = shape_;
+  plan.perm = perm_;
+  plan.stride_bytes.resize(ntensors());
+  for (int i = 0; i < ntensors(); i++) {
+    plan.stride_bytes[i] = operands_[i].stride_bytes;
+  }
+  // Outputs that were already defined are part of the key and never
+  // reallocated from the plan, so recording every output is harmless.
+  plan.output_sizes.resize(num_outputs_);
+  plan.output_strides.resize(num_outputs_);
+  for (int i = 0; i < num_outputs_; i++) {
+    plan.output_sizes[i] = DimVector(operands_[i].tensor.sizes());
+    plan.output_strides[i] = DimVector(operands_[i].tensor.strides());
+  }
+}
+
 TensorIterator::TensorIterator(TensorIteratorConfig& config) {
   build(config);
 }
@@ -1157,14 +1283,22 @@ void TensorIterator::build(TensorIteratorConfig& config) {
   compute_types(config);
   // try fast setup output tensor, if failed, fallback to normal setup
   if (!fast_set_up(config)) {
-    // compute each tensor's stride after broadcasting
-    compute_strides(config);
-    // re-order dimensions to improve coalescing
-    reorder_dimensions(config);
-    // allocate the output tensor if it's not provided
-    allocate_outputs();
-    // coalesce adjacent dimensions when possible
-    coalesce_dimensions();
+    // reuse the geometry computed for an identical iterator, if any
+    PlanKey plan_key;
+    bool cacheable = compute_plan_key(config, plan_key);
+    if (!cacheable || !set_up_from_cached_plan(plan_key)) {
+      // compute each tensor's stride after broadcasting
+      compute_strides(config);
+      // re-order dimensions to improve coalescing
+      reorder_dimensions(config);
+      // allocate the output tensor if it's not provided
+      allocate_outputs();
+      // coalesce adjacent dimensions when possible
+      coalesce_dimensions();
+      if (cacheable) {
+        cache_plan(plan_key);
+      }
+    }
   }
   // perform name inference
   propagate_names_to_outputs();
@@ -317,6 +317,12 @@ protected:
   void propagate_names_to_outputs();
   void coalesce_dimensions();
 
+  // See Note [TensorIterator plan cache]
+  using PlanKey = SmallVector<int64_t, 64>;
+  bool compute_plan_key(const TensorIteratorConfig&, PlanKey&);
+  bool set_up_from_cached_plan(const PlanKey&);
+  void cache_plan(const PlanKey&);
+
   template <int dim, MemoryFormat memory_format> bool requires_channels_last_nd_output();
   bool requires_channels_last_2d_output();
   bool requires_channels_last_3d_output();
@@ -22,6 +22,7 @@ namespace at {
 namespace native {
 
 DEFINE_DISPATCH(cat_serial_stub);
+DEFINE_DISPATCH(cat_contig_stub);
 
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
   TORCH_CHECK(shape_tensor.dim() == 1);
@@ -184,6 +185,11 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
     cat_serial_stub(kCPU, result, tensors, dim);
     return result;
   }
+  // same without vectorization for other dtypes, and in parallel
+  if (allContiguous && no_type_promotion) {
+    cat_contig_stub(kCPU, result, tensors, dim);
+    return result;
+  }
 
   int64_t offset = 0;
   if (reuse_iterator &&
@@ -2,17 +2,72 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
-#include <set>
+#include <algorithm>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Number of chunks of the parallel loops over n elements, at least one
+int64_t num_chunks_for(int64_t n) {
+  const int64_t max_chunks = (n + internal::GRAIN_SIZE - 1) / internal::GRAIN_SIZE;
+  return std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), max_chunks));
+}
+
+// Sorts the chunks of v in parallel, then merges them pairwise
+template <typename T, typename Compare>
+void parallel_sort(std::vector<T>& v, const Compare& comp) {
+  const int64_t n = v.size();
+  const int64_t num_chunks = num_chunks_for(n);
+  if (num_chunks == 1) {
+    std::sort(v.begin(), v.end(), comp);
+    return;
+  }
+  auto chunk_begin = [&](int64_t chunk) {
+    return v.begin() + std::min(chunk, num_chunks) * n / num_chunks;
+  };
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      std::sort(chunk_begin(chunk), chunk_begin(chunk + 1), comp);
+    }
+  });
+  for (int64_t width = 1; width < num_chunks; width *= 2) {
+    const int64_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    at::parallel_for(0, num_merges, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t merge = begin; merge < end; ++merge) {
+        const int64_t first = merge * 2 * width;
+        if (first + width < num_chunks) {
+          std::inplace_merge(
+              chunk_begin(first), chunk_begin(first + width), chunk_begin(first + 2 * width), comp);
+        }
+      }
+    });
+  }
+}
+
+// Mixes the bits of std::hash, which is the identity for the integral types,
+// since the partitions of unique_cpu_template use the high bits and the hash
+// tables the low ones (finalizer of splitmix64)
+template <typename scalar_t>
+inline uint64_t unique_hash(scalar_t value) {
+  uint64_t h = std::hash<scalar_t>()(value);
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+// The elements are scattered by hash into partitions, which hold distinct
+// values and are deduplicated in parallel with an open addressing table each.
+// The unique values are numbered by partition, then renumbered by rank when
+// sorted, the inverse indices holding the number of the unique value in
+// between.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,53 +77,165 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
+  // Partition the element indices by hash, keeping them in order
+  const int64_t num_chunks = num_chunks_for(numel);
+  int partition_bits = 0;
+  while ((int64_t(1) << partition_bits) < 4 * num_chunks && numel >> partition_bits > internal::GRAIN_SIZE) {
+    ++partition_bits;
+  }
+  const int64_t num_partitions = int64_t(1) << partition_bits;
+  auto partition_of = [partition_bits](uint64_t hash) -> int64_t {
+    return partition_bits == 0 ? 0 : static_cast<int64_t>(hash >> (64 - partition_bits));
+  };
+  auto chunk_begin = [&](int64_t chunk) {
+    return chunk * numel / num_chunks;
+  };
+  std::vector<int64_t> partition_begin(num_partitions + 1, 0);
+  // Element indices by partition, in order, when there are several
+  std::vector<int64_t> order;
+  if (num_partitions == 1) {
+    partition_begin[1] = numel;
   } else {
-    std::copy(set.begin(), set.end(), output_data);
+    // Offsets of the elements of every chunk, by partition
+    std::vector<int64_t> offsets(num_chunks * num_partitions, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t chunk = begin; chunk < end; ++chunk) {
+        int64_t* chunk_offsets = offsets.data() + chunk * num_partitions;
+        for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+          ++chunk_offsets[partition_of(unique_hash(input_data[i]))];
+        }
+      }
+    });
+    int64_t offset = 0;
+    for (int64_t partition = 0; partition < num_partitions; ++partition) {
+      partition_begin[partition] = offset;
+      for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+        int64_t count = offsets[chunk * num_partitions + partition];
+        offsets[chunk * num_partitions + partition] = offset;
+        offset += count;
+      }
+    }
+    partition_begin[num_partitions] = offset;
+    order.resize(numel);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t chunk = begin; chunk < end; ++chunk) {
+        int64_t* chunk_offsets = offsets.data() + chunk * num_partitions;
+        for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+          order[chunk_offsets[partition_of(unique_hash(input_data[i]))]++] = i;
+        }
+      }
+    });
   }
 
-  if (return_inverse || return_counts) {
+  if (return_inverse) {
     inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
-    }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+  }
+  int64_t* inverse_indices_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+  std::vector<std::vector<scalar_t>> partition_values(num_partitions);
+  std::vector<std::vector<int64_t>> partition_counts(num_partitions);
+  at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    std::vector<int64_t> table;
+    for (int64_t partition = begin; partition < end; ++partition) {
+      const int64_t size = partition_begin[partition + 1] - partition_begin[partition];
+      const int64_t* indices = order.empty() ? nullptr : order.data() + partition_begin[partition];
+      int64_t capacity = 16;
+      while (capacity < 2 * size) {
+        capacity *= 2;
+      }
+      const uint64_t mask = capacity - 1;
+      table.assign(capacity, -1);
+      auto& values = partition_values[partition];
+      auto& value_counts = partition_counts[partition];
+      for (int64_t k = 0; k < size; ++k) {
+        const int64_t i = indices ? indices[k] : k;
+        const scalar_t value = input_data[i];
+        uint64_t slot = unique_hash(value) & mask;
+        while (table[slot] >= 0 && !(values[table[slot]] == value)) {
+          slot = (slot + 1) & mask;
+        }
+        if (table[slot] < 0) {
+          table[slot] = values.size();
+          values.push_back(value);
+          if (return_counts) {
+            value_counts.push_back(0);
+          }
+        }
+        if (return_inverse) {
+          inverse_indices_data[i] = table[slot];
+        }
+        if (return_counts) {
+          ++value_counts[table[slot]];
+        }
+      }
     }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+  });
+
+  std::vector<int64_t> unique_begin(num_partitions + 1, 0);
+  for (int64_t partition = 0; partition < num_partitions; ++partition) {
+    unique_begin[partition + 1] = unique_begin[partition] + partition_values[partition].size();
+  }
+  const int64_t num_unique = unique_begin[num_partitions];
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t *output_data = output.data_ptr<scalar_t>();
+  if (return_counts) {
+    counts.resize_({num_unique});
+  }
+  int64_t* counts_data = return_counts ? counts.data_ptr<int64_t>() : nullptr;
+
+  // Rank of every unique value, by its number
+  std::vector<int64_t> rank;
+  if (sorted) {
+    std::vector<std::pair<scalar_t, int64_t>> sorted_values(num_unique);
+    at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t partition = begin; partition < end; ++partition) {
+        const auto& values = partition_values[partition];
+        for (size_t j = 0; j < values.size(); ++j) {
+          sorted_values[unique_begin[partition] + j] = std::make_pair(values[j], unique_begin[partition] + j);
+        }
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    });
+    parallel_sort(sorted_values, [](const std::pair<scalar_t, int64_t>& a, const std::pair<scalar_t, int64_t>& b) {
+      return a.first < b.first;
+    });
+    rank.resize(num_unique);
+    at::parallel_for(0, num_unique, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; ++r) {
+        output_data[r] = sorted_values[r].first;
+        rank[sorted_values[r].second] = r;
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    });
+  }
+  auto final_index = [&](int64_t partition, int64_t j) {
+    return sorted ? rank[unique_begin[partition] + j] : unique_begin[partition] + j;
+  };
+
+  at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t partition = begin; partition < end; ++partition) {
+      const auto& values = partition_values[partition];
+      for (size_t j = 0; j < values.size(); ++j) {
+        if (!sorted) {
+          output_data[unique_begin[partition] + j] = values[j];
+        }
+        if (return_counts) {
+          counts_data[final_index(partition, j)] = partition_counts[partition][j];
+        }
+      }
+      if (return_inverse) {
+        for (int64_t k = partition_begin[partition]; k < partition_begin[partition + 1]; ++k) {
+          const int64_t i = order.empty() ? k : order[k];
+          inverse_indices_data[i] = final_index(partition, inverse_indices_data[i]);
+        }
       }
     }
-  }
+  });
   return std::make_tuple(output, inverse_indices, counts);
 }
 
+// Every chunk counts the runs that start in it, then writes their values,
+// starts and numbers from the offset of the chunk
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
     const Tensor& self,
@@ -87,33 +254,54 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
 
   if (numel > 0) {
     scalar_t *output_data = output.data_ptr<scalar_t>();
-    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();;
-    int64_t *counts_data = nullptr;
-    *output_data = *input_data;
-
-    if (return_counts) {
-      counts.resize_({numel});
-      counts_data = counts.data_ptr<int64_t>();
-    }
-    scalar_t *p = output_data;
-    int64_t *q = counts_data;
-    int64_t last = 0;
-    for (int64_t i = 0; i < numel; i++) {
-      if (input_data[i] != *p) {
-        *(++p) = input_data[i];
-        if (return_counts) {
-          *(q++) = i - last;
-          last = i;
+    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();
+    auto starts_run = [input_data](int64_t i) {
+      return i == 0 || input_data[i] != input_data[i - 1];
+    };
+    const int64_t num_chunks = num_chunks_for(numel);
+    auto chunk_begin = [&](int64_t chunk) {
+      return chunk * numel / num_chunks;
+    };
+    std::vector<int64_t> run_offsets(num_chunks + 1, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t chunk = begin; chunk < end; ++chunk) {
+        int64_t num_runs = 0;
+        for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+          num_runs += starts_run(i);
         }
+        run_offsets[chunk + 1] = num_runs;
       }
-      if (return_inverse) {
-        inverse_data[i] = p - output_data;
+    });
+    std::partial_sum(run_offsets.begin(), run_offsets.end(), run_offsets.begin());
+    const int64_t output_size = run_offsets[num_chunks];
+
+    // Start of every run, then the counts
+    std::vector<int64_t> run_starts(return_counts ? output_size + 1 : 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t chunk = begin; chunk < end; ++chunk) {
+        int64_t run = run_offsets[chunk] - 1;
+        for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+          if (starts_run(i)) {
+            output_data[++run] = input_data[i];
+            if (return_counts) {
+              run_starts[run] = i;
+            }
+          }
+          if (return_inverse) {
+            inverse_data[i] = run;
+          }
+        }
       }
-    }
-    int64_t output_size = p - output_data + 1;
+    });
     if (return_counts) {
-      *q = numel - last;
+      run_starts[output_size] = numel;
       counts.resize_({output_size});
+      int64_t *counts_data = counts.data_ptr<int64_t>();
+      at::parallel_for(0, output_size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t run = begin; run < end; ++run) {
+          counts_data[run] = run_starts[run + 1] - run_starts[run];
+        }
+      });
     }
     output.resize_({output_size});
   }
@@ -0,0 +1,105 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/WinogradConvKernel.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(winograd3x3_input_transform_stub);
+DEFINE_DISPATCH(winograd3x3_output_transform_stub);
+
+// NOTE [ Winograd convolution on CPU ]
+//
+// _winograd_conv2d computes a 3x3, stride 1 convolution with the F(2x2, 3x3)
+// Winograd algorithm: every 2x2 tile of the output is computed from a 4x4
+// tile of the input with 16 multiplications per input channel, instead of
+// 36. The input and output tiles are transformed by vectorized kernels (see
+// cpu/WinogradConvKernel.cpp), and the sums over the input channels are one
+// batched matrix product of the 16 elements of the tiles, so that the only
+// buffer besides the padded, channels-last copy of the input is the
+// (16, tiles, channels) transformed input, which is 4 / 9 of the im2col
+// buffer of thnn_conv2d.
+//
+// The larger F(4x4, 3x3) saves more multiplications but loses precision in
+// float, and is not used.
+
+namespace {
+
+void check_winograd_conv2d_args(const Tensor& input, const Tensor& weight, const Tensor& bias, IntArrayRef padding) {
+  TORCH_CHECK(input.dim() == 4, "_winograd_conv2d: expected a 4-dimensional input, but got size ", input.sizes());
+  TORCH_CHECK(weight.dim() == 4 && weight.size(1) == input.size(1) && weight.size(2) == 3 && weight.size(3) == 3,
+      "_winograd_conv2d: expected a (out_channels, ", input.size(1), ", 3, 3) weight, but got size ", weight.sizes());
+  TORCH_CHECK(padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+      "_winograd_conv2d: expected a nonnegative padding of 2 elements, but got ", padding);
+  TORCH_CHECK(input.scalar_type() == weight.scalar_type() && (!bias.defined() || bias.scalar_type() == input.scalar_type()),
+      "_winograd_conv2d: expected input, weight and bias to have the same dtype");
+  TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+      "_winograd_conv2d: expected a bias of ", weight.size(0), " elements, but got size ", bias.sizes());
+}
+
+// The (16, out_channels, in_channels) transformed kernels G g G^T.
+Tensor winograd3x3_weight_transform(const Tensor& weight) {
+  Tensor G = at::tensor({1.0, 0.0, 0.0, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, 0.0, 0.0, 1.0}, weight.options()).view({4, 3});
+  return at::matmul(at::matmul(G, weight), G.t())
+      .permute({2, 3, 0, 1})
+      .reshape({16, weight.size(0), weight.size(1)});
+}
+
+} // namespace
+
+Tensor winograd_conv2d_cpu(const Tensor& input, const Tensor& weight, const Tensor& bias, IntArrayRef padding) {
+  check_winograd_conv2d_args(input, weight, bias, padding);
+  const int64_t batch = input.size(0);
+  const int64_t out_channels = weight.size(0);
+  const int64_t out_h = input.size(2) + 2 * padding[0] - 2;
+  const int64_t out_w = input.size(3) + 2 * padding[1] - 2;
+  TORCH_CHECK(out_h > 0 && out_w > 0,
+      "_winograd_conv2d: the padded input of size ", input.sizes(), " is smaller than the 3x3 kernel");
+  const int64_t tiles_h = (out_h + 1) / 2;
+  const int64_t tiles_w = (out_w + 1) / 2;
+
+  // the input tiles cover the output tiles, which may stick out of the output
+  Tensor padded = at::constant_pad_nd(
+      input, {padding[1], padding[1] + 2 * tiles_w - out_w, padding[0], padding[0] + 2 * tiles_h - out_h}, 0)
+      .contiguous(MemoryFormat::ChannelsLast);
+  Tensor transformed_input = at::empty({16, batch * tiles_h * tiles_w, input.size(1)}, input.options());
+  winograd3x3_input_transform_stub(kCPU, transformed_input, padded, tiles_h, tiles_w);
+
+  // (16, tiles, out_channels)
+  Tensor products = at::bmm(transformed_input, winograd3x3_weight_transform(weight).transpose(1, 2)).contiguous();
+  Tensor output = at::empty({batch, out_channels, out_h, out_w}, input.options().memory_format(MemoryFormat::ChannelsLast));
+  winograd3x3_output_transform_stub(kCPU, output, products, bias.defined() ? bias.contiguous() : bias, tiles_h, tiles_w);
+  return output.contiguous(input.suggest_memory_format());
+}
+
+std::tuple<Tensor, Tensor, Tensor> winograd_conv2d_backward_cpu(
+    const Tensor& grad_output, const Tensor& input, const Tensor& weight, IntArrayRef padding, std::array<bool, 3> output_mask) {
+  TORCH_CHECK(padding.size() == 2 && padding[0] <= 2 && padding[1] <= 2,
+      "_winograd_conv2d_backward: expected a padding of at most 2, but got ", padding);
+  Tensor grad_input, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    // the gradient of a stride 1 convolution is the full convolution of the
+    // gradient with the flipped kernel
+    grad_input = winograd_conv2d_cpu(
+        grad_output, weight.flip({2, 3}).transpose(0, 1), Tensor(), {2 - padding[0], 2 - padding[1]});
+  }
+  if (output_mask[1]) {
+    // one product per element of the kernel, rather than one with the full
+    // im2col buffer
+    Tensor padded = at::constant_pad_nd(input, {padding[1], padding[1], padding[0], padding[0]}, 0);
+    const int64_t out_h = grad_output.size(2);
+    const int64_t out_w = grad_output.size(3);
+    grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    for (int64_t i = 0; i < 3; i++) {
+      for (int64_t j = 0; j < 3; j++) {
+        grad_weight.select(3, j).select(2, i).copy_(at::tensordot(
+            grad_output, padded.narrow(2, i, out_h).narrow(3, j, out_w), {0, 2, 3}, {0, 2, 3}));
+      }
+    }
+  }
+  if (output_mask[2]) {
+    grad_bias = grad_output.sum({0, 2, 3});
+  }
+  return std::make_tuple(grad_input, grad_weight, grad_bias);
+}
+
+}} // namespace at::native
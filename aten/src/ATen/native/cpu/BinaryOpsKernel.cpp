@@ -7,6 +7,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/native/Math.h>
@@ -30,10 +31,10 @@ void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
   } else {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, iter.dtype(), "add_cpu/sub_cpu", [&]() {
       auto alpha = alpha_scalar.to<scalar_t>();
-      auto alpha_vec = Vec256<scalar_t>(alpha);
+      auto alpha_vec = vec_t<scalar_t>(alpha);
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) __ubsan_ignore_undefined__ -> scalar_t { return a + alpha * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) __ubsan_ignore_undefined__ {
+        [=](vec_t<scalar_t> a, vec_t<scalar_t> b) __ubsan_ignore_undefined__ {
           return vec256::fmadd(b, alpha_vec, a);
         });
       });
@@ -43,16 +44,16 @@ void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
 void add_clamp_kernel(TensorIterator& iter, Scalar alpha_scalar, Scalar min_val, Scalar max_val) {
   AT_DISPATCH_ALL_TYPES(iter.dtype(), "add_clamp_cpu", [&]() {
     auto alpha = alpha_scalar.to<scalar_t>();
-    auto alpha_vec = Vec256<scalar_t>(alpha);
+    auto alpha_vec = vec_t<scalar_t>(alpha);
     auto min_scalar = min_val.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min_scalar);
+    auto min_vec = vec_t<scalar_t>(min_scalar);
     auto max_scalar = max_val.to<scalar_t>();
-    auto max_vec = Vec256<scalar_t>(max_scalar);
+    auto max_vec = vec_t<scalar_t>(max_scalar);
     cpu_kernel_vec(iter,
       [=](scalar_t a, scalar_t b) __ubsan_ignore_undefined__ -> scalar_t {
         return std::min(max_scalar, std::max(min_scalar, a + alpha * b));
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) __ubsan_ignore_undefined__ {
+      [=](vec_t<scalar_t> a, vec_t<scalar_t> b) __ubsan_ignore_undefined__ {
         auto add_clamp_res = vec256::fmadd(b, alpha_vec, a);
         add_clamp_res = vec256::clamp_min(add_clamp_res, min_vec);
         add_clamp_res = vec256::clamp_max(add_clamp_res, max_vec);
@@ -62,7 +63,7 @@ void add_clamp_kernel(TensorIterator& iter, Scalar alpha_scalar, Scalar min_val,
 }
 
 void atan2_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "atan2_cpu", [&]() {
+  AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, iter.dtype(), "atan2_cpu", [&]() {
     cpu_kernel_vec(iter, [=](scalar_t a, scalar_t b) -> scalar_t {
     return std::atan2(a, b);
   },
@@ -85,7 +86,7 @@ void mul_kernel(TensorIterator& iter) {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, iter.dtype(), "mul_cpu", [&]() {
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](vec_t<scalar_t> a, vec_t<scalar_t> b) {
           return a * b;
         });
     });
@@ -108,7 +109,7 @@ void div_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
           return a / b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [](vec_t<scalar_t> a, vec_t<scalar_t> b) {
           return a / b;
         });
     });
@@ -461,7 +462,7 @@ void max_elementwise_kernel(TensorIterator& iter) {
         [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::maximum(a, b); });
     });
   } else {
-    AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "max_elementwise_cpu", [&]() {
+    AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, iter.dtype(), "max_elementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t {
           if (_isnan<scalar_t>(a) || _isnan<scalar_t>(b)) {
@@ -488,7 +489,7 @@ void min_elementwise_kernel(TensorIterator& iter) {
         [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::minimum(a, b); });
     });
   } else {
-    AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "min_elementwise_cpu", [&]() {
+    AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, iter.dtype(), "min_elementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t {
           if (_isnan<scalar_t>(a) || _isnan<scalar_t>(b)) {
@@ -525,6 +526,25 @@ void smooth_l1_kernel(TensorIterator& iter) {
 }
 
 void sigmoid_backward_kernel(TensorIterator& iter) {
+  if (iter.dtype() == kBFloat16) {
+    // Computed in float and rounded once, see convert_bfloat16_float.
+    auto one_vec = Vec256<float>(1.0f);
+    cpu_kernel_vec(iter,
+      [=](BFloat16 a, BFloat16 b) -> BFloat16 {
+        float a0 = static_cast<float>(a);
+        float b0 = static_cast<float>(b);
+        return a0 * (1.0f - b0) * b0;
+      },
+      [=](Vec256<BFloat16> a, Vec256<BFloat16> b) {
+        Vec256<float> a0, a1, b0, b1;
+        std::tie(a0, a1) = convert_bfloat16_float(a);
+        std::tie(b0, b1) = convert_bfloat16_float(b);
+        a0 = a0 * (one_vec - b0) * b0;
+        a1 = a1 * (one_vec - b1) * b1;
+        return convert_float_bfloat16(a0, a1);
+      });
+    return;
+  }
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "sigmoid_backward_cpu", [&]() {
     auto one_vec = Vec256<scalar_t>((scalar_t)(1));
     cpu_kernel_vec(iter,
@@ -588,6 +608,25 @@ void logit_backward_kernel(TensorIterator& iter, Scalar eps_scalar) {
 }
 
 void tanh_backward_kernel(TensorIterator& iter) {
+  if (iter.dtype() == kBFloat16) {
+    // Computed in float and rounded once, see convert_bfloat16_float.
+    auto one_vec = Vec256<float>(1.0f);
+    cpu_kernel_vec(iter,
+      [=](BFloat16 a, BFloat16 b) -> BFloat16 {
+        float a0 = static_cast<float>(a);
+        float b0 = static_cast<float>(b);
+        return a0 * (1.0f - b0 * b0);
+      },
+      [=](Vec256<BFloat16> a, Vec256<BFloat16> b) {
+        Vec256<float> a0, a1, b0, b1;
+        std::tie(a0, a1) = convert_bfloat16_float(a);
+        std::tie(b0, b1) = convert_bfloat16_float(b);
+        a0 = a0 * (one_vec - b0 * b0);
+        a1 = a1 * (one_vec - b1 * b1);
+        return convert_float_bfloat16(a0, a1);
+      });
+    return;
+  }
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "tanh_backward_cpu", [&]() {
     auto one_vec = Vec256<scalar_t>(scalar_t{1});
     cpu_kernel_vec(
@@ -1,6 +1,9 @@
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/CPUBlas.h>
 
+#include <algorithm>
+
 namespace at {
 namespace native {
 namespace cpublas {
@@ -189,9 +192,100 @@ void cpublas_gemm_impl(
       });
 }
 
+// Row i of c is the sum of the rows of b scaled by the elements of row i of
+// a, accumulated in a local array which the compiler unrolls and keeps in
+// vector registers when the number of columns N is known at compile time
+// (and which has the runtime number of columns n when N is 0).
+template <typename scalar_t, int64_t N>
+inline void gemm_small_row_(
+    int64_t n, int64_t k,
+    scalar_t alpha,
+    const scalar_t *a, int64_t a_col_stride,
+    const scalar_t *b, int64_t ldb,
+    scalar_t beta,
+    scalar_t *c) {
+  constexpr int64_t size = N > 0 ? N : gemm_small_max_size;
+  const int64_t cols = N > 0 ? N : n;
+  scalar_t acc[size];
+  for (int64_t j = 0; j < cols; j++) {
+    acc[j] = scalar_t(0);
+  }
+  for (int64_t l = 0; l < k; l++) {
+    const scalar_t a_l = a[l * a_col_stride];
+    const scalar_t *b_l = b + l * ldb;
+    for (int64_t j = 0; j < cols; j++) {
+      acc[j] += a_l * b_l[j];
+    }
+  }
+  if (beta == scalar_t(0)) {
+    for (int64_t j = 0; j < cols; j++) {
+      c[j] = alpha * acc[j];
+    }
+  } else {
+    for (int64_t j = 0; j < cols; j++) {
+      c[j] = beta * c[j] + alpha * acc[j];
+    }
+  }
+}
+
+template <typename scalar_t, int64_t N>
+void gemm_batched_small_(
+    int64_t batch, int64_t m, int64_t n, int64_t k,
+    scalar_t alpha,
+    const scalar_t *a, int64_t a_batch_stride, int64_t a_row_stride, int64_t a_col_stride,
+    const scalar_t *b, int64_t b_batch_stride, int64_t ldb,
+    scalar_t beta,
+    scalar_t *c, int64_t c_batch_stride, int64_t ldc) {
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, m * n * k));
+  at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      for (int64_t r = 0; r < m; r++) {
+        gemm_small_row_<scalar_t, N>(
+            n, k, alpha,
+            a + i * a_batch_stride + r * a_row_stride, a_col_stride,
+            b + i * b_batch_stride, ldb,
+            beta,
+            c + i * c_batch_stride + r * ldc);
+      }
+    }
+  });
+}
+
+void cpublas_gemm_batched_small_impl(
+    at::ScalarType type,
+    int64_t batch, int64_t m, int64_t n, int64_t k,
+    Scalar alpha,
+    const void *a, int64_t a_batch_stride, int64_t a_row_stride, int64_t a_col_stride,
+    const void *b, int64_t b_batch_stride, int64_t ldb,
+    Scalar beta,
+    void *c, int64_t c_batch_stride, int64_t ldc) {
+  TORCH_INTERNAL_ASSERT(n <= gemm_small_max_size);
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(
+    type, "cpublas_gemm_batched_small_impl",
+      [&]{
+        // one variant per power of two columns, which attention heads and
+        // the like usually have
+        auto gemm = &gemm_batched_small_<scalar_t, 0>;
+        switch (n) {
+          case 4: gemm = &gemm_batched_small_<scalar_t, 4>; break;
+          case 8: gemm = &gemm_batched_small_<scalar_t, 8>; break;
+          case 16: gemm = &gemm_batched_small_<scalar_t, 16>; break;
+          case 32: gemm = &gemm_batched_small_<scalar_t, 32>; break;
+        }
+        gemm(
+            batch, m, n, k,
+            alpha.to<scalar_t>(),
+            static_cast<const scalar_t *>(a), a_batch_stride, a_row_stride, a_col_stride,
+            static_cast<const scalar_t *>(b), b_batch_stride, ldb,
+            beta.to<scalar_t>(),
+            static_cast<scalar_t *>(c), c_batch_stride, ldc);
+      });
+}
+
 }}  // namespace cpublas::(anonymous)
 
 
 REGISTER_DISPATCH(cpublas::gemm_stub, &cpublas::cpublas_gemm_impl);
+REGISTER_DISPATCH(cpublas::gemm_batched_small_stub, &cpublas::cpublas_gemm_batched_small_impl);
 
 }}  // namespace at::native
@@ -0,0 +1,131 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+#include <ATen/native/sparse/BlockSparseLinear.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec256;
+using block_sparse::PackedBlockSparseWeight;
+
+// Block rows are split across threads so that every task gets roughly
+// GRAIN_SIZE multiply-adds.
+int64_t block_rows_grain_size(const PackedBlockSparseWeight& weight, int64_t M) {
+  const int64_t block_rows = weight.row_offsets.numel() - 1;
+  const int64_t cost_per_block_row = weight.values.numel() /
+      std::max<int64_t>(block_rows, 1) * M;
+  return std::max<int64_t>(
+      1, internal::GRAIN_SIZE / std::max<int64_t>(cost_per_block_row, 1));
+}
+
+// The input is transposed to [K_padded, M] first, so that every stored block
+// multiplies col_block_size contiguous rows of M values and the products
+// vectorize along M whatever the block shape. The padding rows are zero.
+template <typename scalar_t, typename acc_t, typename Store>
+void block_sparse_linear_loop(
+    const Tensor& input_t,
+    const PackedBlockSparseWeight& weight,
+    const Store& store) {
+  using Vec = Vec256<acc_t>;
+  const int64_t M = input_t.size(1);
+  const int64_t N = weight.out_features;
+  const int64_t R = weight.row_block_size;
+  const int64_t C = weight.col_block_size;
+  const int64_t block_rows = weight.row_offsets.numel() - 1;
+  const acc_t* x = input_t.data_ptr<acc_t>();
+  const int32_t* row_offsets = weight.row_offsets.data_ptr<int32_t>();
+  const int32_t* col_indices = weight.col_indices.data_ptr<int32_t>();
+  const scalar_t* values = weight.values.data_ptr<scalar_t>();
+
+  at::parallel_for(
+      0, block_rows, block_rows_grain_size(weight, M), [&](int64_t begin, int64_t end) {
+        acc_t buf[Vec::size()];
+        for (int64_t rb = begin; rb < end; ++rb) {
+          const int64_t rows = std::min<int64_t>(R, N - rb * R);
+          for (int64_t m = 0; m < M; m += Vec::size()) {
+            const int64_t count = std::min<int64_t>(Vec::size(), M - m);
+            for (int64_t r = 0; r < rows; ++r) {
+              Vec acc(static_cast<acc_t>(0));
+              for (int32_t b = row_offsets[rb]; b < row_offsets[rb + 1]; ++b) {
+                const scalar_t* v = values + b * R * C + r * C;
+                const acc_t* xb = x + col_indices[b] * C * M + m;
+                for (int64_t c = 0; c < C; ++c) {
+                  acc = acc +
+                      Vec(static_cast<acc_t>(v[c])) * Vec::loadu(xb + c * M, count);
+                }
+              }
+              acc.store(buf, count);
+              store(rb * R + r, m, count, buf);
+            }
+          }
+        }
+      });
+}
+
+void block_sparse_linear_kernel(
+    const Tensor& input,
+    const PackedBlockSparseWeight& weight,
+    const Tensor& bias,
+    Tensor& output) {
+  const int64_t K = weight.in_features;
+  const int64_t N = weight.out_features;
+  const int64_t padded_K =
+      (K + weight.col_block_size - 1) / weight.col_block_size * weight.col_block_size;
+  Tensor input_t = at::zeros({padded_K, input.size(0)}, input.options());
+  input_t.narrow(0, 0, K).copy_(input.t());
+
+  const float* bias_data = bias.data_ptr<float>();
+  float* out = output.data_ptr<float>();
+  block_sparse_linear_loop<float, float>(
+      input_t, weight, [&](int64_t n, int64_t m, int64_t count, const float* acc) {
+        for (int64_t i = 0; i < count; ++i) {
+          out[(m + i) * N + n] = acc[i] + bias_data[n];
+        }
+      });
+}
+
+void qblock_sparse_linear_kernel(
+    const Tensor& input,
+    const PackedBlockSparseWeight& weight,
+    const Tensor& bias,
+    Tensor& output) {
+  const int64_t K = weight.in_features;
+  const int64_t N = weight.out_features;
+  const int64_t padded_K =
+      (K + weight.col_block_size - 1) / weight.col_block_size * weight.col_block_size;
+  // The input zero point is subtracted while transposing, and the weights are
+  // symmetric, so the int32 accumulators need no further correction.
+  Tensor input_t = at::zeros({padded_K, input.size(0)}, at::kInt);
+  input_t.narrow(0, 0, K).copy_(input.int_repr().t()).sub_(input.q_zero_point());
+
+  const double input_scale = input.q_scale();
+  const double output_scale = output.q_scale();
+  const int64_t output_zero_point = output.q_zero_point();
+  const float* scales = weight.scales.data_ptr<float>();
+  const float* bias_data = bias.data_ptr<float>();
+  auto* out = output.data_ptr<c10::quint8>();
+  block_sparse_linear_loop<int8_t, int32_t>(
+      input_t, weight, [&](int64_t n, int64_t m, int64_t count, const int32_t* acc) {
+        const float multiplier = static_cast<float>(input_scale * scales[n]);
+        for (int64_t i = 0; i < count; ++i) {
+          out[(m + i) * N + n] = quantize_val<c10::quint8>(
+              output_scale,
+              output_zero_point,
+              acc[i] * multiplier + bias_data[n]);
+        }
+      });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(block_sparse_linear_stub, &block_sparse_linear_kernel);
+REGISTER_DISPATCH(qblock_sparse_linear_stub, &qblock_sparse_linear_kernel);
+
+} // namespace native
+} // namespace at
@@ -1,10 +1,14 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace at { namespace native {
 
 namespace {
@@ -60,8 +64,53 @@ void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
   });
 }
 
+// The contiguous result is `outer` rows, each made of one contiguous chunk
+// per input. Threads split the result into equal byte ranges rather than by
+// input, so the work stays balanced for any number and sizes of inputs.
+void cat_contig_kernel(Tensor& result, TensorList tensors, int64_t dim) {
+  const int64_t element_size = result.element_size();
+  const int64_t outer = result.numel() / (result.size(dim) * result.stride(dim));
+  const int64_t ninputs = tensors.size();
+  std::vector<const char*> input_data(ninputs);
+  // chunk_offsets[j] is the byte offset of input j within a row of the result
+  std::vector<int64_t> chunk_offsets(ninputs + 1, 0);
+  for (int64_t j = 0; j < ninputs; j++) {
+    input_data[j] = static_cast<const char*>(tensors[j].data_ptr());
+    chunk_offsets[j + 1] = chunk_offsets[j] +
+        tensors[j].size(dim) * result.stride(dim) * element_size;
+  }
+  const int64_t row_size = chunk_offsets[ninputs];
+  char* result_data = static_cast<char*>(result.data_ptr());
+
+  at::parallel_for(0, outer * row_size, internal::GRAIN_SIZE * element_size,
+      [&](int64_t begin, int64_t end) {
+    int64_t row = begin / row_size;
+    int64_t pos = begin - row * row_size;
+    int64_t j = std::upper_bound(chunk_offsets.begin(), chunk_offsets.end(), pos) -
+        chunk_offsets.begin() - 1;
+    for (int64_t i = begin; i < end;) {
+      const int64_t chunk_size = chunk_offsets[j + 1] - chunk_offsets[j];
+      const int64_t pos_in_chunk = pos - chunk_offsets[j];
+      const int64_t n = std::min(chunk_size - pos_in_chunk, end - i);
+      std::memcpy(result_data + i, input_data[j] + row * chunk_size + pos_in_chunk, n);
+      i += n;
+      pos += n;
+      // move on to the next input, skipping inputs that are empty along dim
+      while (j < ninputs && pos == chunk_offsets[j + 1]) {
+        if (++j == ninputs) {
+          j = 0;
+          pos = 0;
+          row++;
+          break;
+        }
+      }
+    }
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_contig_stub, &cat_contig_kernel);
 
 }} // at::native
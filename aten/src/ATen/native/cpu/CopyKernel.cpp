@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -10,8 +12,193 @@ namespace at {
 namespace native {
 namespace {
 
+// Transposed copies, e.g. `t().contiguous()` or NCHW <-> NHWC conversions,
+// read one operand with unit stride and the other with a large stride, so the
+// elementwise loop touches a new cache line for every element of the strided
+// operand. Instead, the copy below is split into kTransposeTile^2 tiles that
+// fit in L1, which are themselves copied as 8x8 blocks, transposed in
+// registers for 4 byte types on AVX.
+constexpr int64_t kTransposeTile = 64;
+
+template <typename scalar_t>
+inline void transpose_8x8(
+    scalar_t* dst, int64_t dst_ld, const scalar_t* src, int64_t src_ld) {
+  for (int64_t c = 0; c < 8; ++c) {
+    for (int64_t r = 0; r < 8; ++r) {
+      dst[r + c * dst_ld] = src[c + r * src_ld];
+    }
+  }
+}
+
+#if (defined(CPU_CAPABILITY_AVX) || defined(CPU_CAPABILITY_AVX2)) && !defined(_MSC_VER)
+template <>
+inline void transpose_8x8<int32_t>(
+    int32_t* dst, int64_t dst_ld, const int32_t* src, int64_t src_ld) {
+  const float* s = reinterpret_cast<const float*>(src);
+  float* d = reinterpret_cast<float*>(dst);
+  __m256 r0 = _mm256_loadu_ps(s + 0 * src_ld);
+  __m256 r1 = _mm256_loadu_ps(s + 1 * src_ld);
+  __m256 r2 = _mm256_loadu_ps(s + 2 * src_ld);
+  __m256 r3 = _mm256_loadu_ps(s + 3 * src_ld);
+  __m256 r4 = _mm256_loadu_ps(s + 4 * src_ld);
+  __m256 r5 = _mm256_loadu_ps(s + 5 * src_ld);
+  __m256 r6 = _mm256_loadu_ps(s + 6 * src_ld);
+  __m256 r7 = _mm256_loadu_ps(s + 7 * src_ld);
+
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+  _mm256_storeu_ps(d + 0 * dst_ld, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(d + 1 * dst_ld, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(d + 2 * dst_ld, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(d + 3 * dst_ld, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(d + 4 * dst_ld, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(d + 5 * dst_ld, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(d + 6 * dst_ld, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(d + 7 * dst_ld, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+#endif
+
+// Copies the n_r x n_c block with dst[r + c * dst_ld] = src[c + r * src_ld]
+template <typename scalar_t>
+void transpose_copy_block(
+    scalar_t* dst, int64_t dst_ld, const scalar_t* src, int64_t src_ld,
+    int64_t n_r, int64_t n_c) {
+  for (int64_t r0 = 0; r0 < n_r; r0 += kTransposeTile) {
+    const int64_t r1 = std::min(r0 + kTransposeTile, n_r);
+    for (int64_t c0 = 0; c0 < n_c; c0 += kTransposeTile) {
+      const int64_t c1 = std::min(c0 + kTransposeTile, n_c);
+      int64_t r = r0;
+      for (; r + 8 <= r1; r += 8) {
+        int64_t c = c0;
+        for (; c + 8 <= c1; c += 8) {
+          transpose_8x8(dst + r + c * dst_ld, dst_ld, src + c + r * src_ld, src_ld);
+        }
+        for (; c < c1; ++c) {
+          for (int64_t i = r; i < r + 8; ++i) {
+            dst[i + c * dst_ld] = src[c + i * src_ld];
+          }
+        }
+      }
+      for (; r < r1; ++r) {
+        for (int64_t c = c0; c < c1; ++c) {
+          dst[r + c * dst_ld] = src[c + r * src_ld];
+        }
+      }
+    }
+  }
+}
+
+// True if the innermost two dimensions of `iter` are a transpose, i.e. one
+// operand has unit stride along dim 0 and the other along dim 1.
+static bool is_transpose_copy(const TensorIterator& iter) {
+  if (iter.ndim() < 2 || iter.shape()[0] < 8 || iter.shape()[1] < 8) {
+    return false;
+  }
+  const int64_t element_size = iter.element_size(0);
+  const auto out_strides = iter.strides(0);
+  const auto in_strides = iter.strides(1);
+  return (out_strides[0] == element_size && in_strides[1] == element_size) ||
+      (in_strides[0] == element_size && out_strides[1] == element_size);
+}
+
+// Same dtype copies are bitwise, so the transpose only depends on the size
+// of the elements.
+template <typename scalar_t>
+static void transpose_copy_kernel_impl(TensorIterator& iter) {
+  constexpr int64_t element_size = sizeof(scalar_t);
+  const bool out_contiguous_dim0 = iter.strides(0)[0] == element_size;
+  iter.for_each([&](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+    auto* dst = reinterpret_cast<scalar_t*>(data[0]);
+    const auto* src = reinterpret_cast<const scalar_t*>(data[1]);
+    // strides holds the byte strides of dim 0 for each operand, then dim 1
+    if (out_contiguous_dim0) {
+      transpose_copy_block(
+          dst, strides[2] / element_size, src, strides[1] / element_size, size0, size1);
+    } else {
+      transpose_copy_block(
+          dst, strides[0] / element_size, src, strides[3] / element_size, size1, size0);
+    }
+  });
+}
+
+static bool transpose_copy_kernel(TensorIterator& iter) {
+  switch (iter.element_size(0)) {
+    case 1:
+      transpose_copy_kernel_impl<int8_t>(iter);
+      return true;
+    case 2:
+      transpose_copy_kernel_impl<int16_t>(iter);
+      return true;
+    case 4:
+      transpose_copy_kernel_impl<int32_t>(iter);
+      return true;
+    case 8:
+      transpose_copy_kernel_impl<int64_t>(iter);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Conversions between float and Half / BFloat16, e.g. loading a reduced
+// precision checkpoint or an fp16 embedding table, use the vectorized
+// vec256::convert (F16C, NEON or AVX2 bit manipulation) on contiguous runs
+// instead of converting one element at a time.
+template <typename dest_t, typename src_t>
+static void reduced_float_convert_kernel(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    char* dst = data[0];
+    const char* src = data[1];
+    if (strides[0] == sizeof(dest_t) && strides[1] == sizeof(src_t)) {
+      vec256::convert(
+          reinterpret_cast<const src_t*>(src), reinterpret_cast<dest_t*>(dst), n);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<dest_t*>(dst + i * strides[0]) =
+          static_cast<dest_t>(*reinterpret_cast<const src_t*>(src + i * strides[1]));
+    }
+  });
+}
+
+static bool reduced_float_convert(TensorIterator& iter) {
+  const ScalarType dst_type = iter.dtype(0);
+  const ScalarType src_type = iter.dtype(1);
+  if (dst_type == ScalarType::Float && src_type == ScalarType::Half) {
+    reduced_float_convert_kernel<float, at::Half>(iter);
+  } else if (dst_type == ScalarType::Half && src_type == ScalarType::Float) {
+    reduced_float_convert_kernel<at::Half, float>(iter);
+  } else if (dst_type == ScalarType::Float && src_type == ScalarType::BFloat16) {
+    reduced_float_convert_kernel<float, at::BFloat16>(iter);
+  } else if (dst_type == ScalarType::BFloat16 && src_type == ScalarType::Float) {
+    reduced_float_convert_kernel<at::BFloat16, float>(iter);
+  } else {
+    return false;
+  }
+  return true;
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
+  if (dtype == iter.dtype(1) && is_transpose_copy(iter) && transpose_copy_kernel(iter)) {
+    return;
+  }
   if (dtype == iter.dtype(1)) {
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
@@ -39,7 +226,7 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
                 [=](Vec256<scalar_t> a) { return a; });
           });
     }
-  } else {
+  } else if (!reduced_float_convert(iter)) {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, dtype, "copy_", [&] {
       using dest_t = scalar_t;
       AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, iter.dtype(1), "copy_", [&] {
@@ -2,11 +2,16 @@
 
 #include <ATen/Dispatch.h>
 #include <ATen/CPUApplyUtils.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <algorithm>
 #include <limits>
 #include <mutex>
+#include <type_traits>
 
 #ifdef CPU_CAPABILITY_AVX2
 #include <ATen/native/cpu/avx_mathfun.h>
@@ -360,4 +365,168 @@ struct BernoulliKernel {
   }
 };
 
+// ============================================ Counter-based (Philox) ================================================
+
+/**
+ * Note [Parallel CPU random generation]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The mt19937 engine of CPUGeneratorImpl produces a single sequence, so the
+ * kernels above fill the tensors serially, holding the generator lock. When the
+ * generator is in philox mode (CPUGeneratorImpl::set_philox_mode), the uniform,
+ * normal and bernoulli kernels derive instead every random number from its
+ * position in the output: element i of a kernel draws from the philox engine at
+ * (seed, offset + i), where the offset is reserved from the generator with
+ * philox_engine_inputs. The chunks of at::parallel_for then generate
+ * independently, and the results don't depend on the number of threads. They
+ * differ from the results of the mt19937 engine for the same seed.
+ *
+ * Every element owns a 128 bit philox number, i.e. four 32 bit randoms, which
+ * is enough for any of the distributions of DistributionsHelper.h. The
+ * contiguous normal kernel rather transforms groups of 16 uniforms with
+ * Box-Muller, as normal_fill does, every group owning 4 philox numbers, or 8
+ * for double.
+ */
+
+// Generator of the distributions of DistributionsHelper.h, drawing from the
+// philox engine from the given offset
+struct PhiloxCPUGenerator {
+  PhiloxCPUGenerator(uint64_t seed, uint64_t offset) : engine_(seed, 0, offset) {}
+
+  uint32_t random() {
+    return engine_();
+  }
+
+  uint64_t random64() {
+    uint32_t random1 = engine_();
+    uint32_t random2 = engine_();
+    return (static_cast<uint64_t>(random1) << 32) | random2;
+  }
+
+ private:
+  at::Philox4_32_10 engine_;
+};
+
+template<typename RNG>
+std::pair<uint64_t, uint64_t> philox_engine_inputs(RNG generator, uint64_t increment) {
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  return generator->philox_engine_inputs(increment);
+}
+
+// Fills self with sample(&philox_generator, i) for every element i, in parallel
+template<typename scalar_t, typename RNG, typename func_t>
+void philox_fill(Tensor& self, RNG generator, const func_t& sample) {
+  const int64_t size = self.numel();
+  const auto seed_and_offset = philox_engine_inputs(generator, size);
+  const uint64_t seed = seed_and_offset.first;
+  const uint64_t offset = seed_and_offset.second;
+  Tensor out = self.is_contiguous() ? self : at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  scalar_t* data = out.data_ptr<scalar_t>();
+  parallel_for(0, size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      PhiloxCPUGenerator philox_generator(seed, offset + i);
+      data[i] = sample(&philox_generator, i);
+    }
+  });
+  if (!out.is_same(self)) {
+    self.copy_(out);
+  }
+}
+
+template <typename scalar_t>
+inline void philox_normal_fill_16(scalar_t *data, const scalar_t mean, const scalar_t std) {
+  normal_fill_16<scalar_t>(data, mean, std);
+}
+
+#ifdef CPU_CAPABILITY_AVX2
+template <>
+inline void philox_normal_fill_16<float>(float *data, const float mean, const float std) {
+  const __m256 two_pi = _mm256_set1_ps(2.0f * M_PI);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 minus_two = _mm256_set1_ps(-2.0f);
+  const __m256 mean_v = _mm256_set1_ps(mean);
+  const __m256 std_v = _mm256_set1_ps(std);
+  normal_fill_16_AVX2(data, &two_pi, &one, &minus_two, &mean_v, &std_v);
+}
+#endif
+
+template <typename scalar_t, typename RNG>
+void philox_normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, RNG generator) {
+  scalar_t *data = self.data_ptr<scalar_t>();
+  const int64_t size = self.numel();
+  const int64_t num_groups = (size + 15) / 16;
+  // 16 uniforms of 32 bits, or of 64 bits for double
+  const uint64_t group_increment = std::is_same<scalar_t, double>::value ? 8 : 4;
+  const auto seed_and_offset = philox_engine_inputs(generator, num_groups * group_increment);
+  const uint64_t seed = seed_and_offset.first;
+  const uint64_t offset = seed_and_offset.second;
+  parallel_for(0, num_groups, internal::GRAIN_SIZE / 16, [&](int64_t begin, int64_t end) {
+    scalar_t buffer[16];
+    for (int64_t group = begin; group < end; ++group) {
+      PhiloxCPUGenerator philox_generator(seed, offset + group * group_increment);
+      for (int64_t i = 0; i < 16; ++i) {
+        at::uniform_real_distribution<scalar_t> uniform(0, 1);
+        buffer[i] = uniform(&philox_generator);
+      }
+      philox_normal_fill_16<scalar_t>(buffer, mean, std);
+      const int64_t group_begin = group * 16;
+      std::copy(buffer, buffer + std::min<int64_t>(16, size - group_begin), data + group_begin);
+    }
+  });
+}
+
+template<typename RNG>
+void philox_normal_kernel(Tensor& self, double mean, double std, RNG generator) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "normal_kernel_cpu", [&] {
+    if (self.is_contiguous()) {
+      philox_normal_fill<scalar_t>(self, static_cast<scalar_t>(mean), static_cast<scalar_t>(std), generator);
+    } else {
+      philox_fill<scalar_t>(self, generator, [mean, std](PhiloxCPUGenerator* philox_generator, int64_t /*i*/) -> scalar_t {
+        at::normal_distribution<double> normal(mean, std);
+        return static_cast<scalar_t>(normal(philox_generator));
+      });
+    }
+  });
+}
+
+template<typename RNG>
+void philox_uniform_kernel(TensorIterator& iter, double from_, double to_, RNG generator) {
+  Tensor self = iter.tensor(0);
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, self.scalar_type(), "uniform_kernel_cpu", [&]() {
+    auto from = static_cast<scalar_t>(from_);
+    auto to = static_cast<scalar_t>(to_);
+    philox_fill<scalar_t>(self, generator, [from, to](PhiloxCPUGenerator* philox_generator, int64_t /*i*/) -> scalar_t {
+      at::uniform_real_distribution<scalar_t> uniform(from, to);
+      return static_cast<scalar_t>(uniform(philox_generator));
+    });
+  });
+}
+
+template<typename RNG>
+void philox_bernoulli_kernel(Tensor& self, const Tensor& p_, RNG generator) {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_tensor_cpu_self_", [&] {
+    using self_t = scalar_t;
+    auto p = std::get<0>(expand_inplace(self, p_.to(kCPU))).contiguous();
+    AT_DISPATCH_FLOATING_TYPES(p.scalar_type(), "bernoulli_tensor_cpu_p_", [&] {
+      using p_t = scalar_t;
+      using accscalar_t = typename std::conditional<std::is_same<p_t, double>::value, double, float>::type;
+      const p_t* p_data = p.data_ptr<p_t>();
+      philox_fill<self_t>(self, generator, [p_data](PhiloxCPUGenerator* philox_generator, int64_t i) -> self_t {
+        at::bernoulli_distribution<accscalar_t> bernoulli(p_data[i]);
+        return static_cast<self_t>(bernoulli(philox_generator));
+      });
+    });
+  });
+}
+
+template<typename RNG>
+void philox_bernoulli_kernel(Tensor& self, double p, RNG generator) {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+    philox_fill<scalar_t>(self, generator, [p](PhiloxCPUGenerator* philox_generator, int64_t /*i*/) -> scalar_t {
+      at::bernoulli_distribution<double> bernoulli(p);
+      return static_cast<scalar_t>(bernoulli(philox_generator));
+    });
+  });
+}
+
 }}}}}
@@ -0,0 +1,111 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/RNN.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(const Vec256<scalar_t>& x) {
+  const Vec256<scalar_t> one(static_cast<scalar_t>(1));
+  return one / (one + x.neg().exp());
+}
+
+// Rows are split across threads so that every task gets roughly GRAIN_SIZE
+// elements of the hidden state to update.
+inline int64_t rows_grain_size(int64_t hidden_size) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(hidden_size, 1));
+}
+
+// gates holds the pre-activation input, forget, cell and output gates of
+// every row back to back, as the (ih + hh) linear layers produce them.
+static void lstm_cell_pointwise_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& gates,
+    const Tensor& cx) {
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(gates.scalar_type(), "lstm_cell_pointwise_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* gates_data = gates.data_ptr<scalar_t>();
+    const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    scalar_t* cy_data = cy.data_ptr<scalar_t>();
+    at::parallel_for(0, batch_size, rows_grain_size(hidden_size), [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* ingate = gates_data + b * 4 * hidden_size;
+        const scalar_t* forgetgate = ingate + hidden_size;
+        const scalar_t* cellgate = forgetgate + hidden_size;
+        const scalar_t* outgate = cellgate + hidden_size;
+        const scalar_t* c = cx_data + b * hidden_size;
+        scalar_t* h_out = hy_data + b * hidden_size;
+        scalar_t* c_out = cy_data + b * hidden_size;
+        for (int64_t j = 0; j < hidden_size; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hidden_size - j);
+          const Vec i = sigmoid(Vec::loadu(ingate + j, n));
+          const Vec f = sigmoid(Vec::loadu(forgetgate + j, n));
+          const Vec g = Vec::loadu(cellgate + j, n).tanh();
+          const Vec o = sigmoid(Vec::loadu(outgate + j, n));
+          const Vec c_new = f * Vec::loadu(c + j, n) + i * g;
+          c_new.store(c_out + j, n);
+          (o * c_new.tanh()).store(h_out + j, n);
+        }
+      }
+    });
+  });
+}
+
+// igates and hgates hold the reset, update and new gates of every row back
+// to back, as the ih and hh linear layers produce them.
+static void gru_cell_pointwise_kernel(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  const int64_t batch_size = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_cell_pointwise_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* igates_data = igates.data_ptr<scalar_t>();
+    const scalar_t* hgates_data = hgates.data_ptr<scalar_t>();
+    const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+    scalar_t* hy_data = hy.data_ptr<scalar_t>();
+    at::parallel_for(0, batch_size, rows_grain_size(hidden_size), [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; ++b) {
+        const scalar_t* ig = igates_data + b * 3 * hidden_size;
+        const scalar_t* hg = hgates_data + b * 3 * hidden_size;
+        const scalar_t* h = hx_data + b * hidden_size;
+        scalar_t* h_out = hy_data + b * hidden_size;
+        for (int64_t j = 0; j < hidden_size; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hidden_size - j);
+          const Vec r = sigmoid(
+              Vec::loadu(ig + j, n) + Vec::loadu(hg + j, n));
+          const Vec z = sigmoid(
+              Vec::loadu(ig + hidden_size + j, n) +
+              Vec::loadu(hg + hidden_size + j, n));
+          const Vec new_gate = (Vec::loadu(ig + 2 * hidden_size + j, n) +
+                                r * Vec::loadu(hg + 2 * hidden_size + j, n))
+                                   .tanh();
+          ((Vec::loadu(h + j, n) - new_gate) * z + new_gate).store(h_out + j, n);
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_cell_pointwise_stub, &lstm_cell_pointwise_kernel);
+REGISTER_DISPATCH(gru_cell_pointwise_stub, &gru_cell_pointwise_kernel);
+
+} // namespace native
+} // namespace at
@@ -10,9 +10,9 @@ namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-#define VEC_LOOP_HEADER(func_t, data) \
+#define VEC_LOOP_HEADER(func_t, vec_func_t, data) \
   using scalar_t = typename function_traits<func_t>::result_type; \
-  using Vec = Vec256<scalar_t>; \
+  using Vec = typename function_traits<vec_func_t>::result_type; \
   char* out_ptr = data[0]; \
   (void) out_ptr;
 
@@ -33,7 +33,7 @@ static inline bool is_outer_reduction(const int64_t* strides) {
 
 template <typename func_t, typename vec_func_t>
 static inline void reduction128(char** data, int64_t n, int64_t stride, func_t op, vec_func_t vop, bool reduce) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   const char* in1_ptr = data[1];
   Vec acc[4];
   for  (int j = 0; j < 4; j++) {
@@ -76,7 +76,7 @@ static inline void UNARY_OUTER_LOOP(char* data[2], const int64_t strides[2], int
 // computes the reduction out = op(out, in)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_inner_reduction(char** data, int64_t n, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   int64_t vector_stride = 4 * Vec::size() * sizeof(scalar_t);
   int64_t count = n / (4 * Vec::size());
   if (count > 0) {
@@ -90,10 +90,12 @@ static inline void vectorized_inner_reduction(char** data, int64_t n, func_t op,
 // computes the reduction out = op(out, in)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_outer_reduction(char** data, int64_t inner_stride, int64_t size0, int64_t size1, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
 
-  // reduce down each column of 4 * Vec::size() elements (128 bytes)
-  int64_t outer_stride[2] = { 128, 128 };
+  // reduce down each column of 4 * Vec::size() elements (128 bytes, or 256
+  // bytes with Vec512)
+  int64_t outer_stride[2] = {
+      4 * Vec::size() * sizeof(scalar_t), 4 * Vec::size() * sizeof(scalar_t) };
   UNARY_OUTER_LOOP(data, outer_stride, size1 / (4 * Vec::size()), [&] {
     reduction128(data, size0, inner_stride, op, vop, /*reduce=*/false);
   });
@@ -3,7 +3,10 @@
 #include <algorithm>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
@@ -18,12 +21,75 @@ namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-template <typename scalar_t, typename func_t>
+// Scans one row in chunks: every chunk is first scanned independently and in
+// parallel, then each chunk but the first is combined with the running total
+// of the chunks before it. `f` scans `n` elements starting from `init_val` and
+// returns the last accumulated value.
+template <typename scalar_t, typename acc_t, typename func_t, typename combine_t, typename vec_combine_t>
+static inline void cpu_cum_parallel_row(
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride,
+    int64_t dim_size,
+    const func_t& f,
+    const combine_t& combine,
+    const vec_combine_t& vec_combine,
+    acc_t init_val) {
+  const int64_t num_chunks = std::min<int64_t>(
+      at::get_num_threads(), divup(dim_size, internal::GRAIN_SIZE));
+  const int64_t chunk_size = divup(dim_size, num_chunks);
+
+  std::vector<acc_t> offsets(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t start = c * chunk_size;
+      const int64_t n = std::min(chunk_size, dim_size - start);
+      offsets[c] = f(
+        result_data + start * result_dim_stride, result_dim_stride,
+        self_data + start * self_dim_stride, self_dim_stride, n, init_val
+      );
+    }
+  });
+
+  // Exclusive scan of the chunk totals.
+  acc_t running = init_val;
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    const acc_t total = offsets[c];
+    offsets[c] = running;
+    running = static_cast<acc_t>(combine(running, total));
+  }
+
+  at::parallel_for(1, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t start = c * chunk_size;
+      const int64_t n = std::min(chunk_size, dim_size - start);
+      const auto offset = static_cast<scalar_t>(offsets[c]);
+      scalar_t* out = result_data + start * result_dim_stride;
+      if (result_dim_stride == 1) {
+        vec256::map(
+            [&](Vec256<scalar_t> x) { return vec_combine(Vec256<scalar_t>(offset), x); },
+            out, out, n);
+      } else {
+        for (int64_t i = 0; i < n; ++i) {
+          out[i * result_dim_stride] =
+              static_cast<scalar_t>(combine(offset, out[i * result_dim_stride]));
+        }
+      }
+    }
+  });
+}
+
+// Rows are scanned independently and TensorIterator parallelizes over them.
+// When there are fewer rows than threads and the scanned dimension is long
+// (e.g. computing offsets from a 1-D tensor of lengths) that leaves most
+// threads idle, so each row is scanned with cpu_cum_parallel_row instead.
+template <typename scalar_t, typename acc_t, typename func_t, typename combine_t, typename vec_combine_t>
 static inline void cpu_cum_base_kernel(Tensor& result,
     const Tensor& self,
     int64_t dim,
     const func_t& f,
-    scalar_t init_val) {
+    const combine_t& combine,
+    const vec_combine_t& vec_combine,
+    acc_t init_val) {
   if (result.sizes() != self.sizes()) {
     result.resize_as_(self);
   }
@@ -46,80 +112,109 @@ static inline void cpu_cum_base_kernel(Tensor& result,
 
   auto result_dim_stride = ensure_nonempty_stride(result, dim);
   auto self_dim_stride = ensure_nonempty_stride(self, dim);
+  auto self_dim_size = ensure_nonempty_size(self, dim);
+
+  const bool parallel_rows = self_dim_size >= 2 * internal::GRAIN_SIZE &&
+      iter.numel() < at::get_num_threads() && !at::in_parallel_region();
 
   auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     auto* result_data_bytes = data[0];
     const auto* self_data_bytes = data[1];
 
     for (int64_t i = 0; i < n; ++i) {
-      f(
-        (scalar_t*)result_data_bytes, result_dim_stride,
-        (scalar_t*)self_data_bytes, self_dim_stride, init_val
-      );
+      if (parallel_rows) {
+        cpu_cum_parallel_row(
+          (scalar_t*)result_data_bytes, result_dim_stride,
+          (scalar_t*)self_data_bytes, self_dim_stride,
+          self_dim_size, f, combine, vec_combine, init_val
+        );
+      } else {
+        f(
+          (scalar_t*)result_data_bytes, result_dim_stride,
+          (scalar_t*)self_data_bytes, self_dim_stride, self_dim_size, init_val
+        );
+      }
       result_data_bytes += strides[0];
       self_data_bytes += strides[1];
     }
   };
 
-  iter.for_each(loop);
+  if (parallel_rows) {
+    iter.serial_for_each(loop, {0, iter.numel()});
+  } else {
+    iter.for_each(loop);
+  }
 }
 
 static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
+    using acc_t = at::acc_type<scalar_t, false>;
     cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
       scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
+      const scalar_t* self_data, auto self_dim_stride, int64_t n, acc_t init_val) {
+        auto cum_number = init_val;
+        for (int64_t i = 0; i < n; ++i) {
           cum_number += self_data[i * self_dim_stride];
           result_data[i * result_dim_stride] = (scalar_t)cum_number;
         }
-      }, /*init_val=*/ 0
+        return cum_number;
+      },
+      [](auto x, auto y) { return x + y; },
+      [](Vec256<scalar_t> x, Vec256<scalar_t> y) { return x + y; },
+      /*init_val=*/ acc_t(0)
     );
   });
 }
 
 static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
+    using acc_t = at::acc_type<scalar_t, false>;
     cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
       scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
+      const scalar_t* self_data, auto self_dim_stride, int64_t n, acc_t init_val) {
+        auto cum_number = init_val;
+        for (int64_t i = 0; i < n; ++i) {
           cum_number *= self_data[i * self_dim_stride];
           result_data[i * result_dim_stride] = (scalar_t)cum_number;
         }
-      }, /*init_val=*/ 1
+        return cum_number;
+      },
+      [](auto x, auto y) { return x * y; },
+      [](Vec256<scalar_t> x, Vec256<scalar_t> y) { return x * y; },
+      /*init_val=*/ acc_t(1)
     );
   });
 }
 
 static void logcumsumexp_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logcumsumexp_out_cpu", [&] {
+    // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
+    auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
+      return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
+    };
     cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
       scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        scalar_t cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
+      const scalar_t* self_data, auto self_dim_stride, int64_t n, scalar_t init_val) {
+        scalar_t cum_number = init_val;
+        for (int64_t i = 0; i < n; ++i) {
           scalar_t x = self_data[i * self_dim_stride];
-
-          // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
-          auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
-            return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
-          };
           cum_number = log_add_exp(x, cum_number);
           result_data[i * result_dim_stride] = static_cast<scalar_t>(cum_number);
         }
-      }, /*init_val=*/ -std::numeric_limits<scalar_t>::infinity()
+        return cum_number;
+      },
+      log_add_exp,
+      [](Vec256<scalar_t> x, Vec256<scalar_t> y) {
+        auto max = maximum(x, y);
+        return (minimum(x, y) - max).exp().log1p() + max;
+      },
+      /*init_val=*/ -std::numeric_limits<scalar_t>::infinity()
     );
   });
 }
@@ -136,7 +231,7 @@ static void mean_kernel_impl(TensorIterator& iter) {
 }
 
 static void std_var_kernel_impl(TensorIterator &iter, bool unbiased, bool take_sqrt) {
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "std_cpu", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, iter.dtype(), "std_cpu", [&] {
     binary_kernel_reduce(
       iter,
       WelfordOps<scalar_t, double, int64_t, double, std::tuple<scalar_t, scalar_t>> { unbiased, take_sqrt },
@@ -150,7 +245,7 @@ static void prod_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a * b; },
+      [=](vec_t<scalar_t> a, vec_t<scalar_t> b) { return a * b; },
       /*identity=*/1);
   });
 }
@@ -258,25 +353,25 @@ static void or_kernel_impl(TensorIterator& iter) {
 }
 
 static void min_values_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kHalf, iter.dtype(), "min_values_cpu", [&iter] {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kHalf, kBFloat16, iter.dtype(), "min_values_cpu", [&iter] {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return min_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return minimum(a, b); });
+      [](vec_t<scalar_t> a, vec_t<scalar_t> b) { return minimum(a, b); });
   });
 }
 
 static void max_values_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kHalf, iter.dtype(), "max_values_cpu", [&iter] {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kHalf, kBFloat16, iter.dtype(), "max_values_cpu", [&iter] {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return max_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return maximum(a, b); });
+      [](vec_t<scalar_t> a, vec_t<scalar_t> b) { return maximum(a, b); });
   });
 }
 
 static void argmax_kernel_impl(TensorIterator &iter) {
-  AT_DISPATCH_ALL_TYPES_AND(kHalf, iter.dtype(1), "argmax_cpu", [&] {
+  AT_DISPATCH_ALL_TYPES_AND2(kHalf, kBFloat16, iter.dtype(1), "argmax_cpu", [&] {
     binary_kernel_reduce(
       iter,
       ArgMaxOps<scalar_t>{},
@@ -285,7 +380,7 @@ static void argmax_kernel_impl(TensorIterator &iter) {
 }
 
 static void argmin_kernel_impl(TensorIterator &iter) {
-  AT_DISPATCH_ALL_TYPES_AND(kHalf, iter.dtype(1), "argmin_cpu", [&] {
+  AT_DISPATCH_ALL_TYPES_AND2(kHalf, kBFloat16, iter.dtype(1), "argmin_cpu", [&] {
     binary_kernel_reduce(
       iter,
       ArgMinOps<scalar_t>{},
@@ -293,6 +388,15 @@ static void argmin_kernel_impl(TensorIterator &iter) {
   });
 }
 
+static void min_max_kernel_impl(TensorIterator &iter) {
+  AT_DISPATCH_ALL_TYPES_AND2(kHalf, kBFloat16, iter.dtype(2), "_min_max_cpu", [&] {
+    binary_kernel_reduce(
+      iter,
+      MinMaxOps<scalar_t, scalar_t, std::tuple<scalar_t, scalar_t>>{},
+      std::pair<scalar_t, scalar_t>(upper_bound<scalar_t>(), lower_bound<scalar_t>()));
+  });
+}
+
 }  // anonymous namespace
 
 REGISTER_DISPATCH(std_var_stub, &std_var_kernel_impl);
@@ -303,6 +407,7 @@ REGISTER_DISPATCH(and_stub, &and_kernel_impl);
 REGISTER_DISPATCH(or_stub, &or_kernel_impl);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
+REGISTER_DISPATCH(min_max_stub, &min_max_kernel_impl);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
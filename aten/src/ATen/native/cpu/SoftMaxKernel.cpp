@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <numeric>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <c10/util/Optional.h>
 
 // [Note AVX-SSE transitions] In general we avoid calls into cmath for code
@@ -28,7 +30,7 @@ inline void _vec_log_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec256::vec_t<scalar_t>;
   static constexpr int64_t CHUNK_SIZE = (128 / sizeof(scalar_t)) * Vec::size();
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
   if (grain_size < CHUNK_SIZE)
@@ -98,7 +100,7 @@ inline void _vec_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec256::vec_t<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -132,14 +134,93 @@ inline void _vec_softmax_lastdim(
       });
 }
 
-template <typename scalar_t, bool log_softmax>
+// BFloat16 rows are converted to float once, so that the max, the sum of the
+// exponentials and the outputs are computed in float and rounded only once,
+// instead of after every Vec256<BFloat16> operation.
+template <bool log_softmax>
+inline void _vec_softmax_lastdim_bfloat16(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<float[]> buffer(new float[dim_size]);
+        float* row = buffer.get();
+        for (int64_t i = begin; i < end; i++) {
+          vec256::convert(input_data_base + i * dim_size, row, dim_size);
+          float max_input = vec256::reduce_all<float>(
+              [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+              row,
+              dim_size);
+          if (log_softmax) {
+            float tmp_sum = vec256::map_reduce_all<float>(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                [](Vec x, Vec y) { return x + y; },
+                row,
+                dim_size);
+            // See [Note AVX-SSE transitions]
+            vec256::map(
+                [](Vec x) { return x.log(); }, &tmp_sum, &tmp_sum, 1);
+            vec256::map(
+                [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
+                row,
+                row,
+                dim_size);
+          } else {
+            vec256::map(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                row,
+                row,
+                dim_size);
+            float tmp_sum = vec256::reduce_all<float>(
+                [](Vec x, Vec y) { return x + y; }, row, dim_size);
+            tmp_sum = 1 / tmp_sum;
+            vec256::map(
+                [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
+                row,
+                row,
+                dim_size);
+          }
+          vec256::convert(row, output_data_base + i * dim_size, dim_size);
+        }
+      });
+}
+
+inline void _vec_log_softmax_lastdim(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_softmax_lastdim_bfloat16<true>(
+      input_data_base, output_data_base, outer_size, dim_size);
+}
+
+inline void _vec_softmax_lastdim(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_softmax_lastdim_bfloat16<false>(
+      input_data_base, output_data_base, outer_size, dim_size);
+}
+
+template <bool log_softmax, typename scalar_t>
 inline void _vec_host_softmax_backward_lastdim(
     scalar_t* grad_input_data_base,
     scalar_t* grad_data_base,
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec256::vec_t<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -184,6 +265,59 @@ inline void _vec_host_softmax_backward_lastdim(
       });
 }
 
+// As for the forward, BFloat16 rows are converted to float once.
+template <bool log_softmax>
+inline void _vec_host_softmax_backward_lastdim(
+    BFloat16* grad_input_data_base,
+    BFloat16* grad_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<float[]> buffer(new float[2 * dim_size]);
+        float* grad_row = buffer.get();
+        float* output_row = grad_row + dim_size;
+        for (int64_t i = begin; i < end; i++) {
+          vec256::convert(grad_data_base + i * dim_size, grad_row, dim_size);
+          vec256::convert(output_data_base + i * dim_size, output_row, dim_size);
+          float sum;
+          if (log_softmax) {
+            sum = vec256::reduce_all<float>(
+                [](Vec& x, Vec& y) { return x + y; }, grad_row, dim_size);
+            vec256::map2(
+                [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
+                grad_row,
+                grad_row,
+                output_row,
+                dim_size);
+          } else {
+            sum = vec256::map2_reduce_all<float>(
+                [](Vec x, Vec y) { return x * y; },
+                [](Vec x, Vec y) { return x + y; },
+                grad_row,
+                output_row,
+                dim_size);
+            vec256::map2(
+                [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
+                grad_row,
+                grad_row,
+                output_row,
+                dim_size);
+          }
+          vec256::convert(grad_row, grad_input_data_base + i * dim_size, dim_size);
+        }
+      });
+}
+
 template <typename scalar_t, bool LogSoftMax>
 struct vec_host_softmax_lastdim {
   static void apply(Tensor& output, const Tensor& input) {
@@ -214,7 +348,7 @@ struct vec_host_softmax_backward_lastdim {
     scalar_t* grad_input_data_base = grad_input.data_ptr<scalar_t>();
     scalar_t* grad_data_base = grad.data_ptr<scalar_t>();
     scalar_t* output_data_base = output.data_ptr<scalar_t>();
-    _vec_host_softmax_backward_lastdim<scalar_t, LogSoftMax>(
+    _vec_host_softmax_backward_lastdim<LogSoftMax>(
         grad_input_data_base,
         grad_data_base,
         output_data_base,
@@ -224,9 +358,10 @@ struct vec_host_softmax_backward_lastdim {
 };
 
 static void softmax_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "softmax_lastdim_kernel_impl", [&] {
-    vec_host_softmax_lastdim<scalar_t, false>::apply(result, self);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_lastdim_kernel_impl",
+      [&] { vec_host_softmax_lastdim<scalar_t, false>::apply(result, self); });
 }
 
 static void log_softmax_lastdim_kernel_impl(
@@ -242,8 +377,9 @@ static void softmax_backward_lastdim_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad,
     const Tensor& output) {
-  AT_DISPATCH_FLOATING_TYPES(
-      grad.scalar_type(), "softmax_backward_lastdim_kernel_impl", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "softmax_backward_lastdim_kernel_impl", [&] {
         vec_host_softmax_backward_lastdim<scalar_t, false>::apply(
             grad_input, grad, output);
       });
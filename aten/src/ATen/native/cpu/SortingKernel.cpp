@@ -9,6 +9,122 @@ namespace at { namespace native {
 
 namespace {
 
+// Slices at least this long are split between the threads when there are
+// fewer slices than threads, e.g. for a single 1-d tensor.
+constexpr int64_t kParallelTopKMinSize = 1 << 16;
+constexpr int64_t kTopKMinChunkSize = 1 << 14;
+
+// Moves the top k elements of queue to its front, in order if `sorted`.
+template <typename scalar_t>
+void topk_select(
+    std::vector<std::pair<scalar_t, int64_t>>& queue,
+    int64_t k,
+    bool largest,
+    bool sorted) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  int64_t n = queue.size();
+  auto use_partial_sort = k * 64 <= n;
+
+  // we want NaN to be sorted as top for numpy compatibility
+  if (use_partial_sort) {
+    if (largest) {
+      std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+        });
+    } else {
+      std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+        });
+    }
+  } else {
+    if (largest) {
+      std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+        });
+      if (sorted) {
+        std::sort(queue.begin(), queue.begin() + k - 1,
+          [](const elem_t& x, const elem_t& y) -> bool {
+            return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+          });
+      }
+    } else {
+      std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+        });
+      if (sorted) {
+        std::sort(queue.begin(), queue.begin() + k -1,
+          [](const elem_t& x, const elem_t& y) -> bool {
+            return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+          });
+      }
+    }
+  }
+}
+
+// Computes the top k of the 1-d slice tl[0] into tl[1] and tl[2]. With
+// `parallel`, a long slice is split into chunks that select their own top k
+// on different threads, and the top k of the slice are selected among these
+// candidates.
+template <typename scalar_t>
+void topk_slice(TensorList tl, int64_t k, bool largest, bool sorted, bool parallel) {
+  auto tmp_values = tl[0].accessor<scalar_t, 1>();
+  auto mode_values = tl[1].accessor<scalar_t, 1>();
+  auto mode_indices = tl[2].accessor<int64_t, 1>();
+
+  auto n = tmp_values.size(0);
+  int64_t num_chunks = 1;
+  if (parallel) {
+    num_chunks = std::min<int64_t>(at::get_num_threads(), n / kTopKMinChunkSize);
+  }
+  const int64_t chunk_size = divup(n, std::max<int64_t>(num_chunks, 1));
+  // The candidates would not be much fewer than the elements.
+  if (k * 4 > chunk_size) {
+    num_chunks = 1;
+  }
+
+  using elem_t = std::pair<scalar_t, int64_t>;
+  std::vector<elem_t> queue;
+  if (num_chunks > 1) {
+    std::vector<std::vector<elem_t>> candidates(num_chunks);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        const int64_t start = c * chunk_size;
+        const int64_t stop = std::min(n, start + chunk_size);
+        auto& chunk = candidates[c];
+        chunk.resize(stop - start);
+        for (int64_t j = start; j < stop; j++) {
+          chunk[j - start].first = tmp_values[j];
+          chunk[j - start].second = j;
+        }
+        const int64_t chunk_k = std::min(k, stop - start);
+        topk_select(chunk, chunk_k, largest, /*sorted=*/false);
+        chunk.resize(chunk_k);
+      }
+    });
+    queue.reserve(num_chunks * k);
+    for (const auto& chunk : candidates) {
+      queue.insert(queue.end(), chunk.begin(), chunk.end());
+    }
+  } else {
+    queue.resize(n);
+    for (int64_t j = 0; j < n; j++) {
+      queue[j].first = tmp_values[j];
+      queue[j].second = j;
+    }
+  }
+
+  topk_select(queue, k, largest, sorted);
+
+  for (int64_t j = 0; j < k; j++) {
+    mode_values[j] = queue[j].first;
+    mode_indices[j] = queue[j].second;
+  }
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -18,68 +134,23 @@ static void topk_kernel(
     bool largest,
     bool sorted) {
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
-          }
-
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
-
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
-          }
-        });
+    const int64_t n = self.dim() > 0 ? self.size(dim) : 1;
+    const int64_t num_slices = n > 0 ? self.numel() / n : 0;
+    if (n >= kParallelTopKMinSize && num_slices < at::get_num_threads()) {
+      // Too few slices to keep the threads busy with one slice each.
+      std::vector<Tensor> tl;
+      for (int64_t i = 0; i < num_slices; i++) {
+        select_dim_slices({self, values, indices}, dim, i, tl);
+        topk_slice<scalar_t>(tl, k, largest, sorted, /*parallel=*/true);
+      }
+    } else {
+      dim_apply(
+          {self, values, indices},
+          dim,
+          [&](int64_t i, TensorList tl) {
+            topk_slice<scalar_t>(tl, k, largest, sorted, /*parallel=*/false);
+          });
+    }
   });
 }
 
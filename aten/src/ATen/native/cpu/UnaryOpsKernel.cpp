@@ -397,12 +397,20 @@ static void cauchy_kernel(TensorIterator& iter, double median, double sigma, c10
 
 void bernoulli_tensor_kernel(Tensor& self, const Tensor& p_, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
-  templates::cpu::bernoulli_kernel(self, p_, generator);
+  if (generator->philox_mode()) {
+    templates::cpu::philox_bernoulli_kernel(self, p_, generator);
+  } else {
+    templates::cpu::bernoulli_kernel(self, p_, generator);
+  }
 }
 
 void bernoulli_scalar_kernel_default(Tensor& self, double p, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
-  templates::cpu::bernoulli_kernel(self, p, generator);
+  if (generator->philox_mode()) {
+    templates::cpu::philox_bernoulli_kernel(self, p, generator);
+  } else {
+    templates::cpu::bernoulli_kernel(self, p, generator);
+  }
 }
 
 #if !AT_MKL_ENABLED()
@@ -411,8 +419,9 @@ void bernoulli_scalar_kernel(Tensor& self, double p, c10::optional<Generator> ge
 }
 #else
 void bernoulli_scalar_kernel(Tensor &self, double p, c10::optional<Generator> gen) {
-  if (cpuinfo_initialize() && cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
-    CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (!generator->philox_mode() &&
+      cpuinfo_initialize() && cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
     int64_t seed;
     {
       // See Note [Acquire lock when using random generators]
@@ -461,7 +470,8 @@ void bernoulli_scalar_kernel(Tensor &self, double p, c10::optional<Generator> ge
       }
     });
   } else {
-    // The situation of AMD, move to using the default version
+    // The situation of AMD, or of the philox mode (see
+    // Note [Parallel CPU random generation]), move to using the default version
     bernoulli_scalar_kernel_default(self, p, gen);
   }
 }
@@ -484,12 +494,20 @@ static void log_normal_kernel(TensorIterator& iter, double mean, double std, c10
 
 void uniform_kernel(TensorIterator& iter, double from, double to, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
-  templates::cpu::uniform_kernel(iter, from, to, generator);
+  if (generator->philox_mode()) {
+    templates::cpu::philox_uniform_kernel(iter, from, to, generator);
+  } else {
+    templates::cpu::uniform_kernel(iter, from, to, generator);
+  }
 }
 
 void normal_kernel(Tensor& self, double mean, double std, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
-  templates::cpu::normal_kernel(self, mean, std, generator);
+  if (generator->philox_mode()) {
+    templates::cpu::philox_normal_kernel(self, mean, std, generator);
+  } else {
+    templates::cpu::normal_kernel(self, mean, std, generator);
+  }
 }
 
 static void random_from_to_kernel(TensorIterator& iter, uint64_t range, int64_t base, c10::optional<Generator> gen) {
@@ -511,7 +529,7 @@ static void random_full_64_bits_range_kernel(TensorIterator& iter, c10::optional
 }
 
 static void rsqrt_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "rsqrt_cpu", [&] {
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "rsqrt_cpu", [&] {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t {
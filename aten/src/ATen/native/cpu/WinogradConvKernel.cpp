@@ -0,0 +1,160 @@
+#include <ATen/native/cpu/WinogradConvKernel.h>
+
+#include <algorithm>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+// The tiles are channels-last, so that each of their elements is a contiguous
+// run of channels, which the transforms below go through a vector at a time.
+//
+// With g the 3x3 kernel, d a 4x4 input tile and m the elementwise product of
+// their transforms, the 2x2 output tile is A^T m A, where m = (G g G^T) * (B^T d B)
+// and
+//
+//         | 1  0 -1  0 |         |  1    0    0  |
+//   B^T = | 0  1  1  0 |     G = | 1/2  1/2  1/2 |     A^T = | 1  1  1  0 |
+//         | 0 -1  1  0 |         | 1/2 -1/2  1/2 |           | 0  1 -1 -1 |
+//         | 0  1  0 -1 |         |  0    0    1  |
+//
+// The sums over the input channels of these products are left to a batched
+// matrix product, between the transforms.
+
+namespace at { namespace native {
+namespace {
+
+template <typename Vec, typename scalar_t>
+inline Vec load_channels(const scalar_t* ptr, int64_t count) {
+  return count == Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, count);
+}
+
+template <typename scalar_t>
+void winograd3x3_input_transform_impl(Tensor& output, const Tensor& input, int64_t tiles_h, int64_t tiles_w) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t channels = input.size(1);
+  const int64_t width = input.size(3);
+  const int64_t tiles = tiles_h * tiles_w;
+  const int64_t num_tiles = input.size(0) * tiles;
+  const int64_t row_stride = width * channels;
+  const int64_t image_stride = input.size(2) * row_stride;
+  const int64_t element_stride = num_tiles * channels;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, 16 * channels));
+  at::parallel_for(0, num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const int64_t n = p / tiles;
+      const int64_t th = (p % tiles) / tiles_w;
+      const int64_t tw = p % tiles_w;
+      const scalar_t* tile = input_data + n * image_stride + 2 * th * row_stride + 2 * tw * channels;
+      scalar_t* out = output_data + p * channels;
+      for (int64_t c = 0; c < channels; c += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+        Vec d[4][4];
+        for (int64_t i = 0; i < 4; i++) {
+          for (int64_t j = 0; j < 4; j++) {
+            d[i][j] = load_channels<Vec>(tile + i * row_stride + j * channels + c, count);
+          }
+        }
+        // B^T d
+        Vec t[4][4];
+        for (int64_t j = 0; j < 4; j++) {
+          t[0][j] = d[0][j] - d[2][j];
+          t[1][j] = d[1][j] + d[2][j];
+          t[2][j] = d[2][j] - d[1][j];
+          t[3][j] = d[1][j] - d[3][j];
+        }
+        // (B^T d) B
+        for (int64_t i = 0; i < 4; i++) {
+          scalar_t* row = out + 4 * i * element_stride + c;
+          (t[i][0] - t[i][2]).store(row, count);
+          (t[i][1] + t[i][2]).store(row + element_stride, count);
+          (t[i][2] - t[i][1]).store(row + 2 * element_stride, count);
+          (t[i][1] - t[i][3]).store(row + 3 * element_stride, count);
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void winograd3x3_output_transform_impl(Tensor& output, const Tensor& input, const Tensor& bias, int64_t tiles_h, int64_t tiles_w) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t channels = output.size(1);
+  const int64_t height = output.size(2);
+  const int64_t width = output.size(3);
+  const int64_t tiles = tiles_h * tiles_w;
+  const int64_t num_tiles = output.size(0) * tiles;
+  const int64_t row_stride = width * channels;
+  const int64_t element_stride = num_tiles * channels;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, 16 * channels));
+  at::parallel_for(0, num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const int64_t n = p / tiles;
+      const int64_t th = (p % tiles) / tiles_w;
+      const int64_t tw = p % tiles_w;
+      const int64_t rows = std::min<int64_t>(2, height - 2 * th);
+      const int64_t cols = std::min<int64_t>(2, width - 2 * tw);
+      const scalar_t* in = input_data + p * channels;
+      scalar_t* tile = output_data + (n * height + 2 * th) * row_stride + 2 * tw * channels;
+      for (int64_t c = 0; c < channels; c += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+        Vec m[4][4];
+        for (int64_t i = 0; i < 4; i++) {
+          for (int64_t j = 0; j < 4; j++) {
+            m[i][j] = load_channels<Vec>(in + (4 * i + j) * element_stride + c, count);
+          }
+        }
+        // A^T m
+        Vec s[2][4];
+        for (int64_t j = 0; j < 4; j++) {
+          s[0][j] = m[0][j] + m[1][j] + m[2][j];
+          s[1][j] = m[1][j] - m[2][j] - m[3][j];
+        }
+        // (A^T m) A
+        Vec y[2][2];
+        for (int64_t i = 0; i < 2; i++) {
+          y[i][0] = s[i][0] + s[i][1] + s[i][2];
+          y[i][1] = s[i][1] - s[i][2] - s[i][3];
+        }
+        if (bias_data != nullptr) {
+          const Vec b = load_channels<Vec>(bias_data + c, count);
+          for (int64_t i = 0; i < 2; i++) {
+            y[i][0] = y[i][0] + b;
+            y[i][1] = y[i][1] + b;
+          }
+        }
+        for (int64_t i = 0; i < rows; i++) {
+          for (int64_t j = 0; j < cols; j++) {
+            y[i][j].store(tile + i * row_stride + j * channels + c, count);
+          }
+        }
+      }
+    }
+  });
+}
+
+void winograd3x3_input_transform_kernel(Tensor& output, const Tensor& input, int64_t tiles_h, int64_t tiles_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "winograd3x3_input_transform", [&] {
+    winograd3x3_input_transform_impl<scalar_t>(output, input, tiles_h, tiles_w);
+  });
+}
+
+void winograd3x3_output_transform_kernel(Tensor& output, const Tensor& input, const Tensor& bias, int64_t tiles_h, int64_t tiles_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "winograd3x3_output_transform", [&] {
+    winograd3x3_output_transform_impl<scalar_t>(output, input, bias, tiles_h, tiles_w);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(winograd3x3_input_transform_stub, &winograd3x3_input_transform_kernel);
+REGISTER_DISPATCH(winograd3x3_output_transform_stub, &winograd3x3_output_transform_kernel);
+
+}} // namespace at::native
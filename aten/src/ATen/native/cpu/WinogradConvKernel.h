@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Tile transforms of the F(2x2, 3x3) Winograd convolution
+*/
+
+namespace at {
+namespace native {
+
+// Transforms the 4x4 tiles of the padded, channels-last (N, C, 2 * tiles_h + 2,
+// 2 * tiles_w + 2) input into the (16, N * tiles_h * tiles_w, C) output.
+using winograd3x3_input_transform_fn =
+    void (*)(Tensor& output, const Tensor& input, int64_t tiles_h, int64_t tiles_w);
+// Transforms the (16, N * tiles_h * tiles_w, K) tiles of products into the
+// 2x2 tiles of the channels-last (N, K, H, W) output, which are cut at its
+// last rows and columns, and adds bias to them if it is defined.
+using winograd3x3_output_transform_fn =
+    void (*)(Tensor& output, const Tensor& input, const Tensor& bias, int64_t tiles_h, int64_t tiles_w);
+
+DECLARE_DISPATCH(winograd3x3_input_transform_fn, winograd3x3_input_transform_stub);
+DECLARE_DISPATCH(winograd3x3_output_transform_fn, winograd3x3_output_transform_stub);
+
+}  // namespace native
+}  // namespace at
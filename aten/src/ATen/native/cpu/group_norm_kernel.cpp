@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <numeric>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
@@ -14,6 +15,92 @@ namespace native {
 
 namespace {
 
+template <typename T>
+inline T ActivationForward(T y, GroupNormActivation activation) {
+  return activation == GroupNormActivation::kSiLU
+      ? y / (T(1) + std::exp(-y))
+      : y;
+}
+
+template <typename T>
+inline vec256::Vec256<T> ActivationForward(
+    const vec256::Vec256<T>& y,
+    GroupNormActivation activation) {
+  return activation == GroupNormActivation::kSiLU
+      ? y / (vec256::Vec256<T>(1) + y.neg().exp())
+      : y;
+}
+
+// Gradient w.r.t. the pre-activation value z, given the gradient dy of the
+// activation output.
+template <typename T>
+inline T ActivationBackward(T dy, T z, GroupNormActivation activation) {
+  if (activation == GroupNormActivation::kSiLU) {
+    const T sigmoid = T(1) / (T(1) + std::exp(-z));
+    return dy * sigmoid * (T(1) + z * (T(1) - sigmoid));
+  }
+  return dy;
+}
+
+template <typename T>
+inline vec256::Vec256<T> ActivationBackward(
+    const vec256::Vec256<T>& dy,
+    const vec256::Vec256<T>& z,
+    GroupNormActivation activation) {
+  if (activation == GroupNormActivation::kSiLU) {
+    const vec256::Vec256<T> one(1);
+    const vec256::Vec256<T> sigmoid = one / (one + z.neg().exp());
+    return dy * sigmoid * (one + z * (one - sigmoid));
+  }
+  return dy;
+}
+
+// Y[i] = act(scale * X[i] + bias) for i in [0, n)
+template <typename T>
+void ApplyScaleBias(
+    const T* X,
+    int64_t n,
+    T scale,
+    T bias,
+    GroupNormActivation activation,
+    T* Y) {
+  using Vec = vec256::Vec256<T>;
+  constexpr int64_t K = Vec::size();
+  const int64_t inner_size = n / K * K;
+  const Vec scale_vec(scale);
+  const Vec bias_vec(bias);
+  for (int64_t i = 0; i < inner_size; i += K) {
+    const Vec y = Vec::loadu(X + i) * scale_vec + bias_vec;
+    ActivationForward(y, activation).store(Y + i);
+  }
+  for (int64_t i = inner_size; i < n; ++i) {
+    Y[i] = ActivationForward(scale * X[i] + bias, activation);
+  }
+}
+
+// Per (n, c) scale a and bias b such that the normalized value is a * x + b.
+template <typename T>
+void ComputeFusedParams(
+    int64_t N,
+    int64_t C,
+    int64_t group,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    const T* beta,
+    T* a,
+    T* b) {
+  const int64_t D = C / group;
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      const int64_t ng = n * group + c / D;
+      const T scale = rstd[ng] * (gamma == nullptr ? T(1) : gamma[c]);
+      a[n * C + c] = scale;
+      b[n * C + c] = -scale * mean[ng] + (beta == nullptr ? T(0) : beta[c]);
+    }
+  }
+}
+
 template <typename T>
 void GroupNormKernelImplInternal(
     const Tensor& X,
@@ -24,6 +111,7 @@ void GroupNormKernelImplInternal(
     int64_t HxW,
     int64_t group,
     T eps,
+    GroupNormActivation activation,
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
@@ -73,11 +161,13 @@ void GroupNormKernelImplInternal(
         const int64_t c = g * D + j;
         const T scale = rstd_val * (gamma_null ? T(1) : gamma_data[c]);
         const T bias = -scale * mean_val + (beta_null ? T(0) : beta_data[c]);
-        X_ptr = X_data + (i * D + j) * HxW;
-        T* Y_ptr = Y_data + (i * D + j) * HxW;
-        for (int64_t k = 0; k < HxW; ++k) {
-          Y_ptr[k] = scale * X_ptr[k] + bias;
-        }
+        ApplyScaleBias<T>(
+            X_data + (i * D + j) * HxW,
+            HxW,
+            scale,
+            bias,
+            activation,
+            Y_data + (i * D + j) * HxW);
       }
       mean_data[i] = mean_val;
       rstd_data[i] = rstd_val;
@@ -85,6 +175,106 @@ void GroupNormKernelImplInternal(
   });
 }
 
+// Channels last forward. The moments of a group are accumulated with a
+// Welford update per channel while walking its HxW rows of D channels, which
+// is a single read of the group that vectorizes over the channels since all
+// of them have seen the same number of values; the per channel moments are
+// merged into the group's at the end. Normalization and the activation are
+// then applied row by row with per (n, c) scale and bias.
+template <typename T>
+void GroupNormChannelsLastKernelImplInternal(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    T eps,
+    GroupNormActivation activation,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  TORCH_CHECK(X.numel() == N * C * HxW);
+  TORCH_CHECK(!gamma.defined() || gamma.numel() == C);
+  TORCH_CHECK(!beta.defined() || beta.numel() == C);
+  using Vec = vec256::Vec256<T>;
+  constexpr int64_t K = Vec::size();
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const T* X_data = X.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  T* Y_data = Y->data_ptr<T>();
+  T* mean_data = mean->data_ptr<T>();
+  T* rstd_data = rstd->data_ptr<T>();
+
+  at::parallel_for(0, N * G, 1, [&](int64_t start, int64_t end) {
+    const int64_t d = D / K * K;
+    std::vector<T> m1(D);
+    std::vector<T> m2(D);
+    for (int64_t i = start; i < end; ++i) {
+      const int64_t n = i / G;
+      const int64_t g = i % G;
+      std::fill(m1.begin(), m1.end(), T(0));
+      std::fill(m2.begin(), m2.end(), T(0));
+      for (int64_t hw = 0; hw < HxW; ++hw) {
+        const T* X_ptr = X_data + (n * HxW + hw) * C + g * D;
+        const T inv = T(1) / static_cast<T>(hw + 1);
+        const Vec inv_vec(inv);
+        for (int64_t j = 0; j < d; j += K) {
+          const Vec x_vec = Vec::loadu(X_ptr + j);
+          Vec m1_vec = Vec::loadu(m1.data() + j);
+          const Vec delta = x_vec - m1_vec;
+          m1_vec = m1_vec + delta * inv_vec;
+          const Vec m2_vec = Vec::loadu(m2.data() + j) + delta * (x_vec - m1_vec);
+          m1_vec.store(m1.data() + j);
+          m2_vec.store(m2.data() + j);
+        }
+        for (int64_t j = d; j < D; ++j) {
+          const T delta = X_ptr[j] - m1[j];
+          m1[j] += delta * inv;
+          m2[j] += delta * (X_ptr[j] - m1[j]);
+        }
+      }
+      const T mean_val =
+          std::accumulate(m1.cbegin(), m1.cend(), T(0)) / static_cast<T>(D);
+      T m2_val = std::accumulate(m2.cbegin(), m2.cend(), T(0));
+      for (int64_t j = 0; j < D; ++j) {
+        const T delta = m1[j] - mean_val;
+        m2_val += static_cast<T>(HxW) * delta * delta;
+      }
+      const T var_val = std::max(m2_val / static_cast<T>(D * HxW), T(0));
+      mean_data[i] = mean_val;
+      rstd_data[i] = T(1) / std::sqrt(var_val + eps);
+    }
+  });
+
+  std::vector<T> a(N * C);
+  std::vector<T> b(N * C);
+  ComputeFusedParams<T>(
+      N, C, G, mean_data, rstd_data, gamma_data, beta_data, a.data(), b.data());
+
+  at::parallel_for(0, N * HxW, 1, [&](int64_t start, int64_t end) {
+    const int64_t c_vec = C / K * K;
+    for (int64_t i = start; i < end; ++i) {
+      const int64_t n = i / HxW;
+      const T* X_ptr = X_data + i * C;
+      const T* a_ptr = a.data() + n * C;
+      const T* b_ptr = b.data() + n * C;
+      T* Y_ptr = Y_data + i * C;
+      for (int64_t c = 0; c < c_vec; c += K) {
+        const Vec y = Vec::loadu(X_ptr + c) * Vec::loadu(a_ptr + c) +
+            Vec::loadu(b_ptr + c);
+        ActivationForward(y, activation).store(Y_ptr + c);
+      }
+      for (int64_t c = c_vec; c < C; ++c) {
+        Y_ptr[c] = ActivationForward(a_ptr[c] * X_ptr[c] + b_ptr[c], activation);
+      }
+    }
+  });
+}
+
 void GroupNormKernelImpl(
     const Tensor& X,
     const Tensor& gamma,
@@ -94,25 +284,51 @@ void GroupNormKernelImpl(
     int64_t HxW,
     int64_t group,
     double eps,
+    GroupNormActivation activation,
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
+  const bool channels_last = !X.is_contiguous();
+  TORCH_CHECK(
+      !channels_last ||
+          X.is_contiguous(X.suggest_memory_format()),
+      "GroupNorm expects a contiguous or channels last input");
   AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "GroupNormKernelImpl", [&]() {
-    GroupNormKernelImplInternal<scalar_t>(
-        X,
-        gamma,
-        beta,
-        N,
-        C,
-        HxW,
-        group,
-        static_cast<scalar_t>(eps),
-        Y,
-        mean,
-        rstd);
+    if (channels_last) {
+      GroupNormChannelsLastKernelImplInternal<scalar_t>(
+          X,
+          gamma,
+          beta,
+          N,
+          C,
+          HxW,
+          group,
+          static_cast<scalar_t>(eps),
+          activation,
+          Y,
+          mean,
+          rstd);
+    } else {
+      GroupNormKernelImplInternal<scalar_t>(
+          X,
+          gamma,
+          beta,
+          N,
+          C,
+          HxW,
+          group,
+          static_cast<scalar_t>(eps),
+          activation,
+          Y,
+          mean,
+          rstd);
+    }
   });
 }
 
+// ds[n, c] = sum(dZ * X) and db[n, c] = sum(dZ) over HxW, where dZ is the
+// gradient of the pre-activation output, recomputed from X through the fused
+// params a and b when there is an activation.
 template <typename T>
 void ComputeInternalGradients(
     int64_t N,
@@ -120,21 +336,33 @@ void ComputeInternalGradients(
     int64_t HxW,
     const T* dY,
     const T* X,
+    const T* a,
+    const T* b,
+    GroupNormActivation activation,
     T* ds,
     T* db) {
   at::parallel_for(0, N * C, 1, [=](int64_t start, int64_t end) {
-    constexpr int64_t K = vec256::Vec256<T>::size();
+    using Vec = vec256::Vec256<T>;
+    constexpr int64_t K = Vec::size();
     const int64_t inner_size = HxW / K * K;
+    const bool has_activation = activation != GroupNormActivation::kNone;
     std::array<T, K> ds_arr;
     std::array<T, K> db_arr;
     for (int64_t i = start; i < end; ++i) {
       const T* dY_ptr = dY + i * HxW;
       const T* X_ptr = X + i * HxW;
-      vec256::Vec256<T> ds_vec(0);
-      vec256::Vec256<T> db_vec(0);
+      const T a_val = has_activation ? a[i] : T(1);
+      const T b_val = has_activation ? b[i] : T(0);
+      const Vec a_vec(a_val);
+      const Vec b_vec(b_val);
+      Vec ds_vec(0);
+      Vec db_vec(0);
       for (int64_t j = 0; j < inner_size; j += K) {
-        const vec256::Vec256<T> dy_vec = vec256::Vec256<T>::loadu(dY_ptr + j);
-        const vec256::Vec256<T> x_vec = vec256::Vec256<T>::loadu(X_ptr + j);
+        const Vec x_vec = Vec::loadu(X_ptr + j);
+        Vec dy_vec = Vec::loadu(dY_ptr + j);
+        if (has_activation) {
+          dy_vec = ActivationBackward(dy_vec, x_vec * a_vec + b_vec, activation);
+        }
         ds_vec = ds_vec + dy_vec * x_vec;
         db_vec = db_vec + dy_vec;
       }
@@ -143,8 +371,10 @@ void ComputeInternalGradients(
       T ds_val = std::accumulate(ds_arr.cbegin(), ds_arr.cend(), T(0));
       T db_val = std::accumulate(db_arr.cbegin(), db_arr.cend(), T(0));
       for (int64_t j = inner_size; j < HxW; ++j) {
-        ds_val += dY_ptr[j] * X_ptr[j];
-        db_val += dY_ptr[j];
+        const T dy = ActivationBackward(
+            dY_ptr[j], a_val * X_ptr[j] + b_val, activation);
+        ds_val += dy * X_ptr[j];
+        db_val += dy;
       }
       ds[i] = ds_val;
       db[i] = db_val;
@@ -152,20 +382,84 @@ void ComputeInternalGradients(
   });
 }
 
+// Channels last version of ComputeInternalGradients. A task accumulates a
+// block of the channels of one sample over its HxW rows, so that the loads
+// stay contiguous.
 template <typename T>
-void GroupNormInputBackward(
+void ComputeInternalGradientsChannelsLast(
     int64_t N,
     int64_t C,
     int64_t HxW,
-    int64_t group,
     const T* dY,
     const T* X,
+    const T* a,
+    const T* b,
+    GroupNormActivation activation,
+    T* ds,
+    T* db) {
+  using Vec = vec256::Vec256<T>;
+  constexpr int64_t K = Vec::size();
+  constexpr int64_t kChannelBlock = 8 * K;
+  const int64_t blocks = (C + kChannelBlock - 1) / kChannelBlock;
+  at::parallel_for(0, N * blocks, 1, [=](int64_t start, int64_t end) {
+    const bool has_activation = activation != GroupNormActivation::kNone;
+    std::array<T, kChannelBlock> ds_arr;
+    std::array<T, kChannelBlock> db_arr;
+    for (int64_t i = start; i < end; ++i) {
+      const int64_t n = i / blocks;
+      const int64_t c0 = (i % blocks) * kChannelBlock;
+      const int64_t cs = std::min(kChannelBlock, C - c0);
+      const int64_t c_vec = cs / K * K;
+      const T* a_ptr = has_activation ? a + n * C + c0 : nullptr;
+      const T* b_ptr = has_activation ? b + n * C + c0 : nullptr;
+      ds_arr.fill(T(0));
+      db_arr.fill(T(0));
+      for (int64_t hw = 0; hw < HxW; ++hw) {
+        const T* dY_ptr = dY + (n * HxW + hw) * C + c0;
+        const T* X_ptr = X + (n * HxW + hw) * C + c0;
+        for (int64_t c = 0; c < c_vec; c += K) {
+          const Vec x_vec = Vec::loadu(X_ptr + c);
+          Vec dy_vec = Vec::loadu(dY_ptr + c);
+          if (has_activation) {
+            dy_vec = ActivationBackward(
+                dy_vec,
+                x_vec * Vec::loadu(a_ptr + c) + Vec::loadu(b_ptr + c),
+                activation);
+          }
+          (Vec::loadu(ds_arr.data() + c) + dy_vec * x_vec)
+              .store(ds_arr.data() + c);
+          (Vec::loadu(db_arr.data() + c) + dy_vec).store(db_arr.data() + c);
+        }
+        for (int64_t c = c_vec; c < cs; ++c) {
+          const T dy = has_activation
+              ? ActivationBackward(
+                    dY_ptr[c], a_ptr[c] * X_ptr[c] + b_ptr[c], activation)
+              : dY_ptr[c];
+          ds_arr[c] += dy * X_ptr[c];
+          db_arr[c] += dy;
+        }
+      }
+      std::copy(ds_arr.cbegin(), ds_arr.cbegin() + cs, ds + n * C + c0);
+      std::copy(db_arr.cbegin(), db_arr.cbegin() + cs, db + n * C + c0);
+    }
+  });
+}
+
+// dX = c1 * dZ + c2 * X + c3, with c1 = rstd * gamma per (n, c), and c2, c3
+// per (n, g) computed here from ds and db.
+template <typename T>
+void ComputeBackwardFusedParams(
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
     const T* mean,
     const T* rstd,
     const T* gamma,
     const T* ds,
     const T* db,
-    T* dX) {
+    T* c2,
+    T* c3) {
   const int64_t G = group;
   const int64_t D = C / G;
   const T s = T(1) / static_cast<T>(D * HxW);
@@ -197,18 +491,130 @@ void GroupNormInputBackward(
         ds_val += ds_ptr[j] * gamma_v;
         db_val += db_ptr[j] * gamma_v;
       }
-      const T c2 =
-          (db_val * mean[i] - ds_val) * rstd[i] * rstd[i] * rstd[i] * s;
-      const T c3 = -c2 * mean[i] - db_val * rstd[i] * s;
-      for (int64_t j = 0; j < D; ++j) {
-        const int64_t c = g * D + j;
-        const T* dY_ptr = dY + (i * D + j) * HxW;
-        const T* X_ptr = X + (i * D + j) * HxW;
-        T* dX_ptr = dX + (i * D + j) * HxW;
-        const T c1 = rstd[i] * (gamma_null ? T(1) : gamma[c]);
-        for (int64_t k = 0; k < HxW; ++k) {
-          dX_ptr[k] = c1 * dY_ptr[k] + c2 * X_ptr[k] + c3;
+      c2[i] = (db_val * mean[i] - ds_val) * rstd[i] * rstd[i] * rstd[i] * s;
+      c3[i] = -c2[i] * mean[i] - db_val * rstd[i] * s;
+    }
+  });
+}
+
+template <typename T>
+void GroupNormInputBackward(
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    const T* dY,
+    const T* X,
+    const T* rstd,
+    const T* gamma,
+    const T* a,
+    const T* b,
+    const T* c2,
+    const T* c3,
+    GroupNormActivation activation,
+    T* dX) {
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const bool gamma_null = (gamma == nullptr);
+  at::parallel_for(0, N * C, 1, [=](int64_t start, int64_t end) {
+    using Vec = vec256::Vec256<T>;
+    constexpr int64_t K = Vec::size();
+    const int64_t inner_size = HxW / K * K;
+    const bool has_activation = activation != GroupNormActivation::kNone;
+    for (int64_t i = start; i < end; ++i) {
+      const int64_t ng = i / D;
+      const int64_t c = i % C;
+      const T* dY_ptr = dY + i * HxW;
+      const T* X_ptr = X + i * HxW;
+      T* dX_ptr = dX + i * HxW;
+      const T c1 = rstd[ng] * (gamma_null ? T(1) : gamma[c]);
+      const T a_val = has_activation ? a[i] : T(1);
+      const T b_val = has_activation ? b[i] : T(0);
+      const Vec c1_vec(c1);
+      const Vec c2_vec(c2[ng]);
+      const Vec c3_vec(c3[ng]);
+      for (int64_t j = 0; j < inner_size; j += K) {
+        const Vec x_vec = Vec::loadu(X_ptr + j);
+        Vec dy_vec = Vec::loadu(dY_ptr + j);
+        if (has_activation) {
+          dy_vec = ActivationBackward(
+              dy_vec, x_vec * Vec(a_val) + Vec(b_val), activation);
+        }
+        (c1_vec * dy_vec + c2_vec * x_vec + c3_vec).store(dX_ptr + j);
+      }
+      for (int64_t j = inner_size; j < HxW; ++j) {
+        const T dy = ActivationBackward(
+            dY_ptr[j], a_val * X_ptr[j] + b_val, activation);
+        dX_ptr[j] = c1 * dy + c2[ng] * X_ptr[j] + c3[ng];
+      }
+    }
+  });
+}
+
+template <typename T>
+void GroupNormInputBackwardChannelsLast(
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    const T* dY,
+    const T* X,
+    const T* rstd,
+    const T* gamma,
+    const T* a,
+    const T* b,
+    const T* c2,
+    const T* c3,
+    GroupNormActivation activation,
+    T* dX) {
+  const int64_t G = group;
+  const int64_t D = C / G;
+  // Expand the coefficients to (n, c) so that a row is a single vector loop
+  std::vector<T> c1_nc(N * C);
+  std::vector<T> c2_nc(N * C);
+  std::vector<T> c3_nc(N * C);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      const int64_t ng = n * G + c / D;
+      c1_nc[n * C + c] = rstd[ng] * (gamma == nullptr ? T(1) : gamma[c]);
+      c2_nc[n * C + c] = c2[ng];
+      c3_nc[n * C + c] = c3[ng];
+    }
+  }
+  at::parallel_for(0, N * HxW, 1, [&](int64_t start, int64_t end) {
+    using Vec = vec256::Vec256<T>;
+    constexpr int64_t K = Vec::size();
+    const int64_t c_vec = C / K * K;
+    const bool has_activation = activation != GroupNormActivation::kNone;
+    for (int64_t i = start; i < end; ++i) {
+      const int64_t n = i / HxW;
+      const T* dY_ptr = dY + i * C;
+      const T* X_ptr = X + i * C;
+      T* dX_ptr = dX + i * C;
+      const T* c1_ptr = c1_nc.data() + n * C;
+      const T* c2_ptr = c2_nc.data() + n * C;
+      const T* c3_ptr = c3_nc.data() + n * C;
+      const T* a_ptr = has_activation ? a + n * C : nullptr;
+      const T* b_ptr = has_activation ? b + n * C : nullptr;
+      for (int64_t c = 0; c < c_vec; c += K) {
+        const Vec x_vec = Vec::loadu(X_ptr + c);
+        Vec dy_vec = Vec::loadu(dY_ptr + c);
+        if (has_activation) {
+          dy_vec = ActivationBackward(
+              dy_vec,
+              x_vec * Vec::loadu(a_ptr + c) + Vec::loadu(b_ptr + c),
+              activation);
         }
+        (Vec::loadu(c1_ptr + c) * dy_vec + Vec::loadu(c2_ptr + c) * x_vec +
+         Vec::loadu(c3_ptr + c))
+            .store(dX_ptr + c);
+      }
+      for (int64_t c = c_vec; c < C; ++c) {
+        const T dy = has_activation
+            ? ActivationBackward(
+                  dY_ptr[c], a_ptr[c] * X_ptr[c] + b_ptr[c], activation)
+            : dY_ptr[c];
+        dX_ptr[c] = c1_ptr[c] * dy + c2_ptr[c] * X_ptr[c] + c3_ptr[c];
       }
     }
   });
@@ -264,10 +670,13 @@ void GroupNormBackwardKernelImplInternal(
     const Tensor& mean,
     const Tensor& rstd,
     const Tensor& gamma,
+    const Tensor& beta,
     int64_t N,
     int64_t C,
     int64_t HxW,
     int64_t group,
+    GroupNormActivation activation,
+    bool channels_last,
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
@@ -276,12 +685,14 @@ void GroupNormBackwardKernelImplInternal(
   TORCH_CHECK(mean.numel() == N * group);
   TORCH_CHECK(rstd.numel() == N * group);
   TORCH_CHECK(!gamma.defined() || gamma.numel() == C);
+  TORCH_CHECK(!beta.defined() || beta.numel() == C);
 
   const T* dY_data = dY.data_ptr<T>();
   const T* X_data = X.data_ptr<T>();
   const T* mean_data = mean.data_ptr<T>();
   const T* rstd_data = rstd.data_ptr<T>();
   const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->data_ptr<T>() : nullptr;
   T* dgamma_data = dgamma->defined() ? dgamma->data_ptr<T>() : nullptr;
   T* dbeta_data = dbeta->defined() ? dbeta->data_ptr<T>() : nullptr;
@@ -290,22 +701,80 @@ void GroupNormBackwardKernelImplInternal(
   T* ds_data = ds.data_ptr<T>();
   T* db_data = db.data_ptr<T>();
 
-  ComputeInternalGradients<T>(N, C, HxW, dY_data, X_data, ds_data, db_data);
+  // The pre-activation output is a * X + b
+  std::vector<T> a;
+  std::vector<T> b;
+  if (activation != GroupNormActivation::kNone) {
+    a.resize(N * C);
+    b.resize(N * C);
+    ComputeFusedParams<T>(
+        N,
+        C,
+        group,
+        mean_data,
+        rstd_data,
+        gamma_data,
+        beta_data,
+        a.data(),
+        b.data());
+  }
+
+  if (channels_last) {
+    ComputeInternalGradientsChannelsLast<T>(
+        N, C, HxW, dY_data, X_data, a.data(), b.data(), activation, ds_data, db_data);
+  } else {
+    ComputeInternalGradients<T>(
+        N, C, HxW, dY_data, X_data, a.data(), b.data(), activation, ds_data, db_data);
+  }
 
   if (dX_data != nullptr) {
-    GroupNormInputBackward<T>(
+    std::vector<T> c2(N * group);
+    std::vector<T> c3(N * group);
+    ComputeBackwardFusedParams<T>(
         N,
         C,
         HxW,
         group,
-        dY_data,
-        X_data,
         mean_data,
         rstd_data,
         gamma_data,
         ds_data,
         db_data,
-        dX_data);
+        c2.data(),
+        c3.data());
+    if (channels_last) {
+      GroupNormInputBackwardChannelsLast<T>(
+          N,
+          C,
+          HxW,
+          group,
+          dY_data,
+          X_data,
+          rstd_data,
+          gamma_data,
+          a.data(),
+          b.data(),
+          c2.data(),
+          c3.data(),
+          activation,
+          dX_data);
+    } else {
+      GroupNormInputBackward<T>(
+          N,
+          C,
+          HxW,
+          group,
+          dY_data,
+          X_data,
+          rstd_data,
+          gamma_data,
+          a.data(),
+          b.data(),
+          c2.data(),
+          c3.data(),
+          activation,
+          dX_data);
+    }
   }
   if (dgamma_data != nullptr) {
     GammaBackward<T>(
@@ -322,17 +791,39 @@ void GroupNormBackwardKernelImpl(
     const Tensor& mean,
     const Tensor& rstd,
     const Tensor& gamma,
+    const Tensor& beta,
     int64_t N,
     int64_t C,
     int64_t HxW,
     int64_t group,
+    GroupNormActivation activation,
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
+  const bool channels_last = !X.is_contiguous();
+  TORCH_CHECK(
+      !channels_last ||
+          (X.is_contiguous(X.suggest_memory_format()) &&
+           dY.is_contiguous(X.suggest_memory_format())),
+      "GroupNorm backward expects dY and X both contiguous or both channels last");
   AT_DISPATCH_FLOATING_TYPES(
       X.scalar_type(), "GroupNormBackwardKernelImpl", [&]() {
         GroupNormBackwardKernelImplInternal<scalar_t>(
-            dY, X, mean, rstd, gamma, N, C, HxW, group, dX, dgamma, dbeta);
+            dY,
+            X,
+            mean,
+            rstd,
+            gamma,
+            beta,
+            N,
+            C,
+            HxW,
+            group,
+            activation,
+            channels_last,
+            dX,
+            dgamma,
+            dbeta);
       });
 }
 
@@ -487,6 +487,12 @@ Tensor gelu_cuda(const Tensor& self) {
   return Y;
 }
 
+Tensor& gelu_out_cuda(Tensor& Y, const Tensor& self) {
+  auto it = TensorIterator::unary_op(Y, self);
+  GeluCUDAKernelImpl(it);
+  return Y;
+}
+
 Tensor gelu_backward_cuda(const Tensor& grad, const Tensor& self) {
   Tensor dX = at::native::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   auto it = TensorIterator::binary_op(dX, grad, self);
@@ -6,6 +6,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
 
 namespace {
 // Thin wrapper around https://docs.nvidia.com/cuda/cuda-math-api/group__CUDA__MATH__SINGLE.html#group__CUDA__MATH__SINGLE_1g57a3c8313f570282a1a7bcc78743b08e,
@@ -80,6 +81,80 @@ void _amp_non_finite_check_and_unscale_cuda_(Tensor& scaled_grad,
 }
 
 
+namespace {
+
+// Reads one chunk of a tensor list and sets *found_inf to 1.0 if any element
+// is inf or NaN. Unlike _amp_non_finite_check_and_unscale_cuda_, nothing is
+// written back, so the unscale can be folded into a later kernel.
+template<typename T>
+struct NonFiniteCheckFunctor {
+  __device__ void operator() (
+      int chunk_size,
+      TensorListMetadata<1>& tl,
+      float* found_inf_ptr) {
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.sizes[tensor_loc] - chunk_idx * chunk_size;
+    T* x = (T*)tl.addresses[0][tensor_loc] + chunk_idx * chunk_size;
+
+    bool found = false;
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      // See isfinite_ensure_cuda_math above.
+      if (!isfinite_ensure_cuda_math(static_cast<float>(x[i]))) {
+        found = true;
+      }
+    }
+    if (found) {
+      *found_inf_ptr = 1.f;
+    }
+  }
+};
+
+} // namespace
+
+// Sets found_inf to 1.0 if any element of any tensor in scaled_grads is inf or NaN.
+// scaled_grads are left untouched.
+//
+// Args:
+// scaled_grads:  A list of (scaled) gradient tensors.  May contain infs or NaNs.
+// found_inf:  A single-element float tensor to which 1.0 will be written if any gradients contain infs/nans.
+//             Pre-zeroing found_inf, if appropriate, is the responsibility of the caller.
+void _amp_foreach_non_finite_check_cuda_(TensorList scaled_grads,
+                                         Tensor& found_inf)
+{
+  if (scaled_grads.size() == 0) {
+    return;
+  }
+
+  TORCH_CHECK(found_inf.is_cuda(), "found_inf must be a CUDA tensor.");
+  TORCH_CHECK(found_inf.numel() == 1, "found_inf must be a 1-element tensor.");
+  TORCH_CHECK(found_inf.scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+  for (const auto& t : scaled_grads) {
+    TORCH_CHECK(t.is_cuda(), "scaled_grads must be CUDA tensors.");
+    TORCH_CHECK(t.layout() == at::kStrided, "scaled_grads must be strided (not sparse) Tensors.");
+  }
+
+  if (!can_use_fast_route({scaled_grads}) ||
+      !at::isFloatingType(scaled_grads[0].scalar_type()) ||
+      scaled_grads[0].device() != found_inf.device()) {
+    for (const auto& t : scaled_grads) {
+      found_inf.masked_fill_(at::logical_not(at::isfinite(t)).any(), 1.f);
+    }
+    return;
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(scaled_grads.vec());
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+    scaled_grads[0].scalar_type(),
+    "_amp_foreach_non_finite_check_cuda",
+    [&] {
+      multi_tensor_apply<1>(tensor_lists, NonFiniteCheckFunctor<scalar_t>(), found_inf.data_ptr<float>());
+    });
+}
+
+
 // amp_update_scale_cuda_kernel is launched with a single thread to compute the new scale.
 // The scale factor is maintained and updated on the GPU to avoid synchronization.
 __global__ void amp_update_scale_cuda_kernel(int* growth_tracker,
@@ -1,5 +1,6 @@
 #include <ATen/Context.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDABlas.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/PinnedMemoryAllocator.h>
@@ -528,6 +529,133 @@ void magmaLuSolveBatched<float>(
   auto storage_##name = pin_memory<type>(size); \
   name = static_cast<type*>(storage_##name.data());
 
+// Like batchCheckErrors for infos on the device, but only copies a single flag
+// to the host unless one of the matrices failed.
+static inline void batchCheckErrorsOnDevice(const Tensor& infos, const char* name, bool allow_singular=false) {
+  const auto failed = allow_singular ? infos.lt(0).any() : infos.ne(0).any();
+  if (failed.item<bool>()) {
+    batchCheckErrors(infos, name, allow_singular);
+  }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ cuBLAS batched LU ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifdef AT_CUDA_BLAS_BATCHED_LU_ENABLED
+// cuBLAS' batched LU routines factor each matrix within a single thread block
+// and are much faster than MAGMA for large batches of small matrices. Unlike
+// the MAGMA paths below, the matrix pointer arrays are built on the device and
+// the infos never leave it, so no host arrays have to be filled per matrix.
+constexpr int64_t cublas_batched_lu_max_size = 32;
+
+static inline bool use_cublas_batched_lu(const Tensor& self) {
+  return self.dim() > 2 && self.size(-1) == self.size(-2) &&
+      self.size(-1) <= cublas_batched_lu_max_size && self.numel() > 0;
+}
+
+template <typename scalar_t>
+__global__ void batch_pointers_kernel(
+    scalar_t** pointers, scalar_t* data, int64_t matrix_stride, int64_t batch_size) {
+  const int64_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < batch_size) {
+    pointers[i] = data + i * matrix_stride;
+  }
+}
+
+// Returns a tensor on the device of `self` holding the address of each matrix
+template <typename scalar_t>
+static Tensor batch_pointers(const Tensor& self) {
+  const int64_t batch_size = batchCount(self);
+  auto pointers = at::empty({batch_size}, self.options().dtype(at::kLong));
+  constexpr int64_t block_size = 256;
+  const int64_t grid_size = (batch_size + block_size - 1) / block_size;
+  batch_pointers_kernel<scalar_t>
+      <<<grid_size, block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
+          reinterpret_cast<scalar_t**>(pointers.data_ptr<int64_t>()),
+          self.data_ptr<scalar_t>(), matrixStride(self), batch_size);
+  AT_CUDA_CHECK(cudaGetLastError());
+  return pointers;
+}
+
+template <typename scalar_t>
+static inline scalar_t** pointers_data(const Tensor& pointers) {
+  return reinterpret_cast<scalar_t**>(pointers.data_ptr<int64_t>());
+}
+
+// The LU routines are numerically sensitive, so TF32 should be off
+// regardless of the global flag (see MAGMAQueue).
+struct CuBLASDefaultMathGuard {
+  CuBLASDefaultMathGuard() {
+#if CUDA_VERSION >= 11000
+    handle = at::cuda::getCurrentCUDABlasHandle();
+    TORCH_CUDABLAS_CHECK(cublasGetMathMode(handle, &original_math_mode));
+    TORCH_CUDABLAS_CHECK(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
+#endif
+  }
+
+  ~CuBLASDefaultMathGuard() {
+#if CUDA_VERSION >= 11000
+    cublasSetMathMode(handle, original_math_mode);
+#endif
+  }
+
+ private:
+#if CUDA_VERSION >= 11000
+  cublasHandle_t handle;
+  cublasMath_t original_math_mode;
+#endif
+};
+
+// Factors every matrix of the column major `self` in place. `pivots` and
+// `infos` must be contiguous int tensors on the same device; pivoting is
+// skipped when `pivots` is undefined.
+template <typename scalar_t>
+static void apply_cublas_lu_batched(Tensor& self, const Tensor& pivots, Tensor& infos) {
+  CuBLASDefaultMathGuard math_guard;
+  int n = cuda_int_cast(self.size(-1), "n");
+  int batch_size = cuda_int_cast(batchCount(self), "batchCount");
+  auto self_pointers = batch_pointers<scalar_t>(self);
+  at::cuda::blas::getrfBatched<scalar_t>(
+      n, pointers_data<scalar_t>(self_pointers), n,
+      pivots.defined() ? pivots.data_ptr<int>() : nullptr,
+      infos.data_ptr<int>(), batch_size);
+}
+
+template <typename scalar_t>
+static void apply_cublas_solve_batched(Tensor& b, Tensor& A, Tensor& infos) {
+  auto pivots = at::empty({batchCount(A), A.size(-1)}, infos.options());
+  apply_cublas_lu_batched<scalar_t>(A, pivots, infos);
+
+  CuBLASDefaultMathGuard math_guard;
+  int n = cuda_int_cast(A.size(-1), "n");
+  int nrhs = cuda_int_cast(b.size(-1), "nrhs");
+  int batch_size = cuda_int_cast(batchCount(A), "batchCount");
+  auto A_pointers = batch_pointers<scalar_t>(A);
+  auto b_pointers = batch_pointers<scalar_t>(b);
+  at::cuda::blas::getrsBatched<scalar_t>(
+      'n', n, nrhs, pointers_data<scalar_t>(A_pointers), n, pivots.data_ptr<int>(),
+      pointers_data<scalar_t>(b_pointers), n, batch_size);
+}
+
+template <typename scalar_t>
+static void apply_cublas_inverse_batched(Tensor& self, Tensor& self_inv, Tensor& infos) {
+  auto pivots = at::empty({batchCount(self), self.size(-1)}, infos.options());
+  apply_cublas_lu_batched<scalar_t>(self, pivots, infos);
+
+  // getri reports the same singular matrices as getrf, so its infos are not
+  // checked separately
+  CuBLASDefaultMathGuard math_guard;
+  auto getri_infos = at::empty_like(infos);
+  int n = cuda_int_cast(self.size(-1), "n");
+  int batch_size = cuda_int_cast(batchCount(self), "batchCount");
+  auto self_pointers = batch_pointers<scalar_t>(self);
+  auto self_inv_pointers = batch_pointers<scalar_t>(self_inv);
+  at::cuda::blas::getriBatched<scalar_t>(
+      n, pointers_data<scalar_t>(self_pointers), n, pivots.data_ptr<int>(),
+      pointers_data<scalar_t>(self_inv_pointers), n, getri_infos.data_ptr<int>(),
+      batch_size);
+}
+#endif // AT_CUDA_BLAS_BATCHED_LU_ENABLED
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template <typename scalar_t>
@@ -607,6 +735,16 @@ AT_ERROR("solve: MAGMA library not found in "
 std::tuple<Tensor, Tensor> _solve_helper_cuda(const Tensor& self, const Tensor& A) {
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
+#ifdef AT_CUDA_BLAS_BATCHED_LU_ENABLED
+  if (use_cublas_batched_lu(A_working_copy)) {
+    auto infos = at::zeros({batchCount(A)}, A.options().dtype(at::kInt));
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cuda", [&]{
+      apply_cublas_solve_batched<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+    batchCheckErrorsOnDevice(infos, "solve_cuda");
+    return std::tuple<Tensor, Tensor>(self_working_copy, A_working_copy);
+  }
+#endif
   std::vector<int64_t> infos(batchCount(self), 0);
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cuda", [&]{
     apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
@@ -715,6 +853,18 @@ AT_ERROR("inverse: MAGMA library not found in "
 
 Tensor _inverse_helper_cuda(const Tensor& self) {
   auto self_inv_working_copy = cloneBatchedColumnMajor(self);
+#ifdef AT_CUDA_BLAS_BATCHED_LU_ENABLED
+  if (use_cublas_batched_lu(self)) {
+    auto infos = at::zeros({batchCount(self)}, self.options().dtype(at::kInt));
+    auto self_working_copy = cloneBatchedColumnMajor(self);
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cuda", [&]{
+      apply_cublas_inverse_batched<scalar_t>(
+        self_working_copy, self_inv_working_copy, infos);
+    });
+    batchCheckErrorsOnDevice(infos, "inverse_cuda");
+    return self_inv_working_copy;
+  }
+#endif
   if (self.dim() > 2) {
     std::vector<int64_t> infos(batchCount(self), 0);
     auto self_working_copy = cloneBatchedColumnMajor(self);
@@ -984,15 +1134,25 @@ std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cuda(const Tensor& self, bool p
     self_working_copy = at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   } else {
     self_working_copy = cloneBatchedColumnMajor(self);
-    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
-        apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor, pivot);
-    });
+#ifdef AT_CUDA_BLAS_BATCHED_LU_ENABLED
+    if (use_cublas_batched_lu(self)) {
+      AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
+        apply_cublas_lu_batched<scalar_t>(
+          self_working_copy, pivot ? pivots_tensor : Tensor(), infos_tensor);
+      });
+    } else
+#endif
+    {
+      AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
+          apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor, pivot);
+      });
+    }
   }
   if (check_errors) {
     if (self.dim() == 2) {
       singleCheckErrors(infos_tensor.item<int64_t>(), "lu", /*allow_singular=*/true);
     } else {
-      batchCheckErrors(infos_tensor, "lu", /*allow_singular=*/true);
+      batchCheckErrorsOnDevice(infos_tensor, "lu", /*allow_singular=*/true);
     }
   }
   return std::make_tuple(self_working_copy, pivots_tensor, infos_tensor);
@@ -79,6 +79,37 @@ __global__ void vectorized_elementwise_kernel(int N, func_t f, array_t data) {
   }
 }
 
+// Note [Broadcast vectorized loops]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Non-contiguous iterations otherwise use an OffsetCalculator, which costs a
+// div/mod per dimension for every element, and no vectorized accesses. Most
+// of them are broadcasts such as bias additions and per-channel scales, or
+// channels-last tensors, where the innermost dimension of the iteration is
+// contiguous for the output and either contiguous or broadcast for every
+// input. We then process the iteration as a 2-D grid of rows: blockIdx.y
+// walks the rows, whose offsets are computed once with an OffsetCalculator
+// over the outer dimensions, and blockIdx.x the chunks of a row, which use
+// vectorized accesses for the contiguous operands and read the broadcast
+// operands once into registers.
+template<int vec_size, typename func_t, typename array_t, typename outer_calc_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void broadcast_vectorized_elementwise_kernel(
+    int inner_size, int outer_size, func_t f, array_t data,
+    outer_calc_t outer_calc, uint32_t inner_broadcast_mask) {
+  constexpr int ntensors = function_traits<func_t>::arity + 1;
+  int remaining = inner_size - block_work_size * blockIdx.x;
+  for (int row = blockIdx.y; row < outer_size; row += gridDim.y) {
+    auto offsets = outer_calc.get(row);
+    array_t row_data;
+    #pragma unroll
+    for (int i = 0; i < ntensors; i++) {
+      row_data[i] = data[i] + offsets[i];
+    }
+    elementwise_kernel_helper(f, memory::policies::broadcast_vectorized<vec_size, array_t>(
+      row_data, remaining, inner_broadcast_mask));
+  }
+}
+
 template<typename func_t, typename array_t, typename inp_calc_t, typename out_calc_t, typename loader_t, typename storer_t>
 C10_LAUNCH_BOUNDS_1(num_threads)
 __global__ void unrolled_elementwise_kernel(int N, func_t f, array_t data,
@@ -130,6 +161,89 @@ static inline void launch_unrolled_kernel(int64_t N, const func_t& f, array_t da
   AT_CUDA_CHECK(cudaGetLastError());
 }
 
+// See Note [Broadcast vectorized loops]. Returns false if the iteration does
+// not have that layout, or its rows are too short for the 2-D grid to pay off.
+template<typename func_t, typename array_t>
+static inline bool try_launch_broadcast_vectorized_kernel(TensorIterator& iter, const func_t& f, array_t data) {
+  using traits = function_traits<func_t>;
+  constexpr int ntensors = traits::arity + 1;
+  static_assert(ntensors <= 32, "inner_broadcast_mask holds one bit per input");
+
+  if (iter.ndim() < 2 || iter.shape()[0] < block_work_size / 2) {
+    return false;
+  }
+  uint32_t inner_broadcast_mask = 0;
+  for (int i = 0; i < ntensors; i++) {
+    int64_t inner_stride = iter.strides(i)[0];
+    if (i > 0 && inner_stride == 0) {
+      inner_broadcast_mask |= 1u << (i - 1);
+    } else if (inner_stride != iter.element_size(i)) {
+      return false;
+    }
+  }
+
+  // Broadcast operands are read one element at a time, so their alignment does
+  // not matter. For the others, every row has to start at an aligned address.
+  array_t aligned_data = data;
+  for (int i = 1; i < ntensors; i++) {
+    if ((inner_broadcast_mask >> (i - 1)) & 1) {
+      aligned_data[i] = nullptr;
+    }
+  }
+  const int64_t inner_size = iter.shape()[0];
+  const int64_t outer_size = iter.numel() / inner_size;
+  int vec_size = memory::can_vectorize_up_to<func_t>(aligned_data);
+  auto row_aligned = [&](int vec) {
+    if (inner_size % vec != 0) {
+      return false;
+    }
+    for (int i = 0; i < ntensors; i++) {
+      if (aligned_data[i] == nullptr) {
+        continue;
+      }
+      for (int dim = 1; dim < iter.ndim(); dim++) {
+        if (iter.strides(i)[dim] % (vec * iter.element_size(i)) != 0) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+  while (vec_size > 1 && !row_aligned(vec_size)) {
+    vec_size /= 2;
+  }
+
+  // The outer dimensions of the iteration, with strides in bytes.
+  std::array<const int64_t*, ntensors> outer_strides;
+  for (int i = 0; i < ntensors; i++) {
+    outer_strides[i] = iter.strides(i).data() + 1;
+  }
+  OffsetCalculator<ntensors> outer_calc(iter.ndim() - 1, iter.shape().data() + 1, outer_strides.data());
+
+  dim3 grid(
+      (inner_size + block_work_size - 1) / block_work_size,
+      std::min<int64_t>(outer_size, at::cuda::getCurrentDeviceProperties()->maxGridSize[1]));
+  auto stream = at::cuda::getCurrentCUDAStream();
+  switch (vec_size) {
+  case 4:
+    broadcast_vectorized_elementwise_kernel<4, func_t, array_t><<<grid, num_threads, 0, stream>>>(
+        inner_size, outer_size, f, data, outer_calc, inner_broadcast_mask);
+    break;
+  case 2:
+    broadcast_vectorized_elementwise_kernel<2, func_t, array_t><<<grid, num_threads, 0, stream>>>(
+        inner_size, outer_size, f, data, outer_calc, inner_broadcast_mask);
+    break;
+  case 1:
+    broadcast_vectorized_elementwise_kernel<1, func_t, array_t><<<grid, num_threads, 0, stream>>>(
+        inner_size, outer_size, f, data, outer_calc, inner_broadcast_mask);
+    break;
+  default:
+    TORCH_INTERNAL_ASSERT(false, "Unexpected vectorization size");
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+  return true;
+}
+
 template <typename func_t>
 void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   using traits = function_traits<func_t>;
@@ -153,6 +267,8 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   if (!dynamic_casting) {
     if (contiguous) {
       launch_vectorized_kernel(numel, f, data);
+    } else if (try_launch_broadcast_vectorized_kernel(iter, f, data)) {
+      // See Note [Broadcast vectorized loops]
     } else {
       auto input_offset_calculator = make_input_offset_calculator<traits::arity>(iter);
       auto output_offset_calculator = make_output_offset_calculator(iter);
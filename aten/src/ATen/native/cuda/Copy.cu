@@ -3,11 +3,17 @@
 #include <ATen/Dispatch.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDAEvent.h>
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <c10/cuda/CUDAStream.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
 #include <THC/THC.h>
+#include <THC/THCCachingHostAllocator.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 #ifdef __HIP_PLATFORM_HCC__
 #include <hip/hip_version.h>
@@ -125,6 +131,65 @@ static bool maybe_enable_p2p_access(Device dst_device, Device src_device) {
         globalContext().getTHCState(), src_device.index(), dst_device.index());
 }
 
+// Note [Staged pageable copies]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// cudaMemcpyAsync from pageable host memory returns only after the driver has
+// copied the data out of the source, so non_blocking copies of unpinned CPU
+// tensors to the GPU are effectively synchronous. Instead, we stage them
+// through a ring of pinned buffers from the caching host allocator: every
+// chunk is copied into a buffer on the host and then enqueued on the current
+// stream, so the host copy of one chunk overlaps the transfer of the previous
+// ones, and we return as soon as the last chunk is enqueued. A buffer is only
+// refilled once the event recorded after its previous transfer has completed,
+// and is handed back to the allocator with an event on the stream, so it is
+// not reused before the copy is done. Like for pinned sources, the caller has
+// to synchronize with the stream before reading the destination; unlike for
+// pinned sources, the source may be modified as soon as we return.
+//
+// Small copies are left to the driver, which already stages them internally
+// without blocking.
+static constexpr int64_t kStagingMinBytes = 64 * 1024;
+static constexpr int64_t kStagingChunkBytes = 4 * 1024 * 1024;
+static constexpr size_t kNumStagingBuffers = 4;
+
+static void copy_pageable_to_device_async(
+    void* dst,
+    const void* src,
+    int64_t nbytes,
+    CUDAStream stream) {
+  auto* allocator = getTHCCachingHostAllocator();
+  std::array<DataPtr, kNumStagingBuffers> buffers;
+  std::array<CUDAEvent, kNumStagingBuffers> events;
+
+  int64_t chunk = 0;
+  for (int64_t offset = 0; offset < nbytes; offset += kStagingChunkBytes, ++chunk) {
+    const int64_t size = std::min(kStagingChunkBytes, nbytes - offset);
+    const size_t slot = chunk % kNumStagingBuffers;
+    if (!buffers[slot]) {
+      buffers[slot] = allocator->allocate(std::min(kStagingChunkBytes, nbytes));
+    } else {
+      // Wait for the previous transfer out of this buffer.
+      events[slot].synchronize();
+    }
+
+    void* staging = buffers[slot].get();
+    std::memcpy(staging, static_cast<const char*>(src) + offset, size);
+    AT_CUDA_CHECK(cudaMemcpyAsync(
+        static_cast<char*>(dst) + offset,
+        staging,
+        size,
+        cudaMemcpyHostToDevice,
+        stream));
+    events[slot].record(stream);
+  }
+
+  for (auto& buffer : buffers) {
+    if (buffer) {
+      AT_CUDA_CHECK(THCCachingHostAllocator_recordEvent(buffer.get(), stream));
+    }
+  }
+}
+
 static void copy_kernel_cuda(TensorIterator& iter, bool non_blocking) {
   AT_ASSERT(iter.ntensors() == 2);
 
@@ -189,7 +254,12 @@ static void copy_kernel_cuda(TensorIterator& iter, bool non_blocking) {
   int64_t nbytes = iter.numel() * iter.element_size(0);
   CUDAStream stream = getCurrentCUDAStream();
 
-  if (non_blocking) {
+  if (non_blocking && kind == cudaMemcpyHostToDevice &&
+      nbytes >= kStagingMinBytes &&
+      !at::detail::getCUDAHooks().isPinnedPtr(src)) {
+    // See Note [Staged pageable copies]
+    copy_pageable_to_device_async(dst, src, nbytes, stream);
+  } else if (non_blocking) {
     AT_CUDA_CHECK(cudaMemcpyAsync(dst, src, nbytes, kind, stream));
     void* ptr = (dst_device == kCPU ? dst : src);
     AT_CUDA_CHECK(THCCachingHostAllocator_recordEvent(ptr, stream));
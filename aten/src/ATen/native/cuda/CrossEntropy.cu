@@ -0,0 +1,172 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/NumericLimits.cuh>
+#include <ATen/native/CrossEntropy.h>
+#include <c10/macros/Macros.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// One block per row of the logits
+constexpr int kCrossEntropyBlockSize = 256;
+
+// Running (max, sum of exp(x - max)) of an online log-sum-exp
+template <typename acc_t>
+struct LogSumExpState {
+  acc_t max;
+  acc_t sum;
+};
+
+template <typename acc_t>
+__device__ __forceinline__ LogSumExpState<acc_t> combine(LogSumExpState<acc_t> a, LogSumExpState<acc_t> b) {
+  if (a.max < b.max) {
+    LogSumExpState<acc_t> tmp = a;
+    a = b;
+    b = tmp;
+  }
+  // a.max >= b.max; a state whose max is -inf has a sum of 0
+  if (b.max == -at::numeric_limits<acc_t>::inf()) {
+    return a;
+  }
+  return {a.max, a.sum + b.sum * ::exp(b.max - a.max)};
+}
+
+template <typename scalar_t, typename acc_t>
+C10_LAUNCH_BOUNDS_1(kCrossEntropyBlockSize)
+__global__ void fused_cross_entropy_kernel(
+    const scalar_t* __restrict__ input, const int64_t* __restrict__ target,
+    acc_t* __restrict__ losses, acc_t* __restrict__ logsumexp,
+    int64_t n_classes, int64_t ignore_index) {
+  __shared__ acc_t smem_max[kCrossEntropyBlockSize];
+  __shared__ acc_t smem_sum[kCrossEntropyBlockSize];
+  const int64_t row_idx = blockIdx.x;
+  const scalar_t* row = input + row_idx * n_classes;
+
+  // Every thread runs an online log-sum-exp over its strided classes, so the
+  // row is read once
+  LogSumExpState<acc_t> state{-at::numeric_limits<acc_t>::inf(), 0};
+  for (int64_t j = threadIdx.x; j < n_classes; j += blockDim.x) {
+    const acc_t x = static_cast<acc_t>(row[j]);
+    if (x > state.max) {
+      state.sum = state.sum * ::exp(state.max - x) + 1;
+      state.max = x;
+    } else if (x != -at::numeric_limits<acc_t>::inf()) {
+      state.sum += ::exp(x - state.max);
+    }
+  }
+  smem_max[threadIdx.x] = state.max;
+  smem_sum[threadIdx.x] = state.sum;
+  __syncthreads();
+  for (int offset = blockDim.x / 2; offset > 0; offset /= 2) {
+    if (threadIdx.x < offset) {
+      LogSumExpState<acc_t> other{smem_max[threadIdx.x + offset], smem_sum[threadIdx.x + offset]};
+      state = combine(state, other);
+      smem_max[threadIdx.x] = state.max;
+      smem_sum[threadIdx.x] = state.sum;
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.x == 0) {
+    const acc_t lse = state.max + ::log(state.sum);
+    logsumexp[row_idx] = lse;
+    const int64_t cur_target = target[row_idx];
+    if (cur_target == ignore_index) {
+      losses[row_idx] = 0;
+    } else {
+      CUDA_KERNEL_ASSERT(cur_target >= 0 && cur_target < n_classes);
+      losses[row_idx] = lse - static_cast<acc_t>(row[cur_target]);
+    }
+  }
+}
+
+template <typename scalar_t, typename acc_t>
+C10_LAUNCH_BOUNDS_1(kCrossEntropyBlockSize)
+__global__ void fused_cross_entropy_backward_kernel(
+    scalar_t* __restrict__ grad_input, const acc_t* __restrict__ grad_scale,
+    const scalar_t* __restrict__ input, const int64_t* __restrict__ target,
+    const acc_t* __restrict__ logsumexp, int64_t n_classes, int64_t ignore_index) {
+  const int64_t row_idx = blockIdx.x;
+  const scalar_t* row = input + row_idx * n_classes;
+  scalar_t* grad_row = grad_input + row_idx * n_classes;
+  const int64_t cur_target = target[row_idx];
+  if (cur_target == ignore_index) {
+    for (int64_t j = threadIdx.x; j < n_classes; j += blockDim.x) {
+      grad_row[j] = scalar_t(0);
+    }
+    return;
+  }
+  CUDA_KERNEL_ASSERT(cur_target >= 0 && cur_target < n_classes);
+  const acc_t scale = grad_scale[row_idx];
+  const acc_t lse = logsumexp[row_idx];
+  for (int64_t j = threadIdx.x; j < n_classes; j += blockDim.x) {
+    const acc_t prob = ::exp(static_cast<acc_t>(row[j]) - lse);
+    grad_row[j] = static_cast<scalar_t>(scale * (j == cur_target ? prob - 1 : prob));
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> fused_cross_entropy_cuda(
+    const Tensor& self, const Tensor& target, int64_t reduction, int64_t ignore_index) {
+  check_fused_cross_entropy_inputs(self, target);
+  const auto input = self.contiguous();
+  const auto target_ = target.contiguous();
+  const auto acc_options = input.options().dtype(toAccumulateType(input.scalar_type(), /*is_cuda=*/true));
+  const int64_t batch_size = input.size(0);
+  auto losses = at::empty({batch_size}, acc_options);
+  auto logsumexp = at::empty({batch_size}, acc_options);
+  if (batch_size > 0) {
+    AT_DISPATCH_FLOATING_TYPES_AND2(ScalarType::Half, ScalarType::BFloat16, input.scalar_type(), "fused_cross_entropy_cuda", [&] {
+      AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "fused_cross_entropy_cuda", [&] {
+        using acc_t = acc_type<scalar_t, true>;
+        fused_cross_entropy_kernel<scalar_t, acc_t>
+            <<<batch_size, kCrossEntropyBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+                input.data_ptr<scalar_t>(), target_.data_ptr<int64_t>(),
+                losses.data_ptr<acc_t>(), logsumexp.data_ptr<acc_t>(),
+                input.size(1), ignore_index);
+      });
+    });
+    AT_CUDA_CHECK(cudaGetLastError());
+  }
+  return std::make_tuple(
+      fused_cross_entropy_reduce(losses, target_, reduction, ignore_index, self.scalar_type()),
+      logsumexp);
+}
+
+Tensor fused_cross_entropy_backward_cuda(
+    const Tensor& grad_output, const Tensor& self, const Tensor& target,
+    const Tensor& logsumexp, int64_t reduction, int64_t ignore_index) {
+  check_fused_cross_entropy_inputs(self, target);
+  TORCH_CHECK(logsumexp.dim() == 1 && logsumexp.size(0) == self.size(0),
+      "_fused_cross_entropy_backward: expected the logsumexp returned by _fused_cross_entropy");
+  const auto input = self.contiguous();
+  const auto target_ = target.contiguous();
+  const auto logsumexp_ = logsumexp.contiguous();
+  auto grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  const int64_t batch_size = input.size(0);
+  if (batch_size == 0) {
+    return grad_input;
+  }
+  const auto grad_scale = fused_cross_entropy_grad_scale(
+      grad_output, target_, reduction, ignore_index, logsumexp_.scalar_type());
+  AT_DISPATCH_FLOATING_TYPES_AND2(ScalarType::Half, ScalarType::BFloat16, input.scalar_type(), "fused_cross_entropy_backward_cuda", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "fused_cross_entropy_backward_cuda", [&] {
+      using acc_t = acc_type<scalar_t, true>;
+      fused_cross_entropy_backward_kernel<scalar_t, acc_t>
+          <<<batch_size, kCrossEntropyBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+              grad_input.data_ptr<scalar_t>(), grad_scale.data_ptr<acc_t>(),
+              input.data_ptr<scalar_t>(), target_.data_ptr<int64_t>(),
+              logsumexp_.data_ptr<acc_t>(), input.size(1), ignore_index);
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return grad_input;
+}
+
+} // namespace native
+} // namespace at
@@ -5,6 +5,8 @@
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <stdexcept>
@@ -335,10 +337,16 @@ public:
 
   int64_t workspace_size() const { return ws_size; }
 
+  // The stream and work area of the plan are set right before every
+  // execution, so that one plan can serve all streams. This mutex keeps them
+  // unchanged until the execution is enqueued.
+  std::mutex& exec_mutex() const { return exec_mutex_; }
+
 private:
   std::unique_ptr<cufftHandle, CuFFTHandleDeleter> plan_ptr;
   bool clone_input;
   int64_t ws_size;
+  mutable std::mutex exec_mutex_;
 };
 
 #if CUDA_VERSION < 10000
@@ -359,13 +367,15 @@ static_assert(CUFFT_DEFAULT_CACHE_SIZE >= 0 && CUFFT_DEFAULT_CACHE_SIZE <= CUFFT
               "CUFFT_DEFAULT_CACHE_SIZE not in [0, CUFFT_MAX_PLAN_NUM] range");
 
 // This cache assumes that the mapping from key to value never changes.
-// This is **NOT** thread-safe. Please use a mutex when using it **AND** the
-// value returned from try_emplace_value.
+// This is **NOT** thread-safe. Please use a mutex when using it. The configs
+// are shared, so that one returned from try_emplace_value stays valid after
+// the mutex is released, even if it is evicted in the meantime; executing it
+// only needs its exec_mutex().
 // The contract of using this cache is that try_emplace_value should only be
 // used when the max_size is positive.
 class CuFFTParamsLRUCache {
 public:
-  using kv_t = typename std::pair<CuFFTParams, CuFFTConfig>;
+  using kv_t = typename std::pair<CuFFTParams, std::shared_ptr<CuFFTConfig>>;
   using map_t = typename std::unordered_map<std::reference_wrapper<CuFFTParams>,
                                             typename std::list<kv_t>::iterator,
                                             ParamsHash<CuFFTParams>,
@@ -393,11 +403,11 @@ public:
 
   // If key is in this cache, return the cached config. Otherwise, emplace the
   // config in this cache using value_args and return it.
-  // Return const reference because CuFFTConfig shouldn't be tampered with once
-  // created.
+  // Return pointer to const because CuFFTConfig shouldn't be tampered with
+  // once created.
   // This is similar to c++ 17 try_emplace.
   template<typename K, class ...VArgs>
-  const CuFFTConfig &try_emplace_value(K&& key, VArgs&&... value_args) {
+  std::shared_ptr<const CuFFTConfig> try_emplace_value(K&& key, VArgs&&... value_args) {
     AT_ASSERT(_max_size > 0);
 
     map_kkv_iter_t map_it = _cache_map.find(key);
@@ -419,7 +429,7 @@ public:
     // construct new plan at list front, then insert into _cache_map
     _usage_list.emplace_front(std::piecewise_construct,
                        std::forward_as_tuple(key),
-                       std::forward_as_tuple(value_args...));
+                       std::forward_as_tuple(std::make_shared<CuFFTConfig>(value_args...)));
     auto kv_it = _usage_list.begin();
     _cache_map.emplace(std::piecewise_construct,
                 std::forward_as_tuple(kv_it->first),
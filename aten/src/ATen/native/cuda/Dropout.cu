@@ -2,11 +2,14 @@
 #include <ATen/AccumulateType.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <ATen/cuda/detail/TensorInfo.cuh>
 #include <c10/macros/Macros.h>
 #include <curand_kernel.h>
 
+#include <initializer_list>
+
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
 #include <ATen/native/cuda/MemoryAccess.cuh>
@@ -38,7 +41,7 @@ __global__ void
 fused_dropout_kernel_vec(at::cuda::detail::TensorInfo<scalar_t, IndexType> a,
                             at::cuda::detail::TensorInfo<scalar_t, IndexType> b,
                             at::cuda::detail::TensorInfo<uint8_t, IndexType> c,
-                            IndexType totalElements, accscalar_t p, std::pair<uint64_t, uint64_t> seeds
+                            IndexType totalElements, accscalar_t p, PhiloxCudaState philox_args
                            ) {
 
   // make sure we don't break assumption that we can't have > 4 elements / thread
@@ -48,12 +51,13 @@ fused_dropout_kernel_vec(at::cuda::detail::TensorInfo<scalar_t, IndexType> a,
   using MaskLoadT = memory::aligned_vector<uint8_t, VEC>;
 
   accscalar_t pinv = accscalar_t(1)/p;
+  auto seeds = at::cuda::philox::unpack(philox_args);
   IndexType idx = blockIdx.x * blockDim.x + threadIdx.x;
   curandStatePhilox4_32_10_t state;
   curand_init(
-      seeds.first,
+      std::get<0>(seeds),
       idx,
-      seeds.second,
+      std::get<1>(seeds),
       &state);
 
   // Note: Vectorized loads means we'll stride each thread by an additional VEC factor, as we'll load VEC elements at a time
@@ -112,16 +116,17 @@ __global__ void
 fused_dropout_kernel(cuda::detail::TensorInfo<scalar_t, IndexType> a,
                       cuda::detail::TensorInfo<scalar_t, IndexType> b,
                       cuda::detail::TensorInfo<uint8_t, IndexType> c,
-                      IndexType totalElements, accscalar_t p, std::pair<uint64_t, uint64_t> seeds
+                      IndexType totalElements, accscalar_t p, PhiloxCudaState philox_args
                       ) {
 
   accscalar_t pinv = accscalar_t(1)/p;
+  auto seeds = at::cuda::philox::unpack(philox_args);
   IndexType idx = blockIdx.x * blockDim.x + threadIdx.x;
   curandStatePhilox4_32_10_t state;
     curand_init(
-        seeds.first,
+        std::get<0>(seeds),
         idx,
-        seeds.second,
+        std::get<1>(seeds),
         &state);
   IndexType rounded_size = ((totalElements - 1)/(blockDim.x * gridDim.x * UNROLL)+1) *
         blockDim.x * gridDim.x * UNROLL;
@@ -194,6 +199,142 @@ int get_vector_size(at::Tensor self, at::Tensor ret, at::Tensor mask) {
   return can_vectorize ? vec_size : 1;
 }
 
+
+// Fused bias + dropout + residual add, output = residual + dropout(self + bias),
+// with bias broadcast along the last dimension.
+//
+// Every group of UNROLL consecutive elements draws its randoms from its own
+// Philox subsequence, so that the mask only depends on the seed, the offset
+// and the element index, not on the launch configuration. The forward writes
+// the seed and offset it used to rng_state, and the backward regenerates the
+// mask from them instead of reading a saved uint8 mask. Writing them from the
+// kernel keeps this correct when the forward is replayed in a CUDA graph.
+
+constexpr int kBiasDropoutAddBlockSize = 256;
+
+__device__ __forceinline__ float4 group_randoms(uint64_t seed, uint64_t group, uint64_t offset) {
+  curandStatePhilox4_32_10_t state;
+  curand_init(seed, group, offset, &state);
+  return curand_uniform4(&state);
+}
+
+template <typename scalar_t, bool kVectorized>
+__device__ __forceinline__ void load_group(
+    const scalar_t* data, int64_t base, int64_t nelem, memory::aligned_vector<scalar_t, UNROLL>& values) {
+  if (kVectorized) {
+    values = *reinterpret_cast<const memory::aligned_vector<scalar_t, UNROLL>*>(data + base);
+  } else {
+    #pragma unroll
+    for (int ii = 0; ii < UNROLL; ii++) {
+      if (base + ii < nelem) {
+        values.val[ii] = data[base + ii];
+      }
+    }
+  }
+}
+
+template <typename scalar_t, bool kVectorized>
+__device__ __forceinline__ void store_group(
+    scalar_t* data, int64_t base, int64_t nelem, const memory::aligned_vector<scalar_t, UNROLL>& values) {
+  if (kVectorized) {
+    *reinterpret_cast<memory::aligned_vector<scalar_t, UNROLL>*>(data + base) = values;
+  } else {
+    #pragma unroll
+    for (int ii = 0; ii < UNROLL; ii++) {
+      if (base + ii < nelem) {
+        data[base + ii] = values.val[ii];
+      }
+    }
+  }
+}
+
+template <typename scalar_t, typename accscalar_t, bool kVectorized>
+C10_LAUNCH_BOUNDS_1(kBiasDropoutAddBlockSize)
+__global__ void fused_bias_dropout_add_kernel(
+    const scalar_t* __restrict__ input,
+    const scalar_t* __restrict__ bias,
+    const scalar_t* __restrict__ residual,
+    scalar_t* __restrict__ output,
+    int64_t* __restrict__ rng_state,
+    int64_t nelem,
+    int64_t bias_size,
+    float keep,
+    accscalar_t scale,
+    PhiloxCudaState philox_args) {
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  const int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (idx == 0) {
+    rng_state[0] = static_cast<int64_t>(std::get<0>(seeds));
+    rng_state[1] = static_cast<int64_t>(std::get<1>(seeds));
+  }
+  const int64_t groups = (nelem + UNROLL - 1) / UNROLL;
+  for (int64_t group = idx; group < groups; group += gridDim.x * static_cast<int64_t>(blockDim.x)) {
+    // curand_uniform4 is in (0, 1], so that <= keeps exactly a keep fraction
+    const float4 rand = group_randoms(std::get<0>(seeds), group, std::get<1>(seeds));
+    const int64_t base = group * UNROLL;
+    memory::aligned_vector<scalar_t, UNROLL> src, res, out;
+    load_group<scalar_t, kVectorized>(input, base, nelem, src);
+    load_group<scalar_t, kVectorized>(residual, base, nelem, res);
+    int64_t column = base % bias_size;
+    #pragma unroll
+    for (int ii = 0; ii < UNROLL; ii++) {
+      const accscalar_t factor = (&rand.x)[ii] <= keep ? scale : accscalar_t(0);
+      out.val[ii] = static_cast<accscalar_t>(res.val[ii]) +
+          (static_cast<accscalar_t>(src.val[ii]) + static_cast<accscalar_t>(bias[column])) * factor;
+      column = column + 1 == bias_size ? 0 : column + 1;
+    }
+    store_group<scalar_t, kVectorized>(output, base, nelem, out);
+  }
+}
+
+template <typename scalar_t, typename accscalar_t, bool kVectorized>
+C10_LAUNCH_BOUNDS_1(kBiasDropoutAddBlockSize)
+__global__ void fused_bias_dropout_add_backward_kernel(
+    const scalar_t* __restrict__ grad,
+    const int64_t* __restrict__ rng_state,
+    scalar_t* __restrict__ grad_input,
+    int64_t nelem,
+    float keep,
+    accscalar_t scale) {
+  const uint64_t seed = static_cast<uint64_t>(rng_state[0]);
+  const uint64_t offset = static_cast<uint64_t>(rng_state[1]);
+  const int64_t idx = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  const int64_t groups = (nelem + UNROLL - 1) / UNROLL;
+  for (int64_t group = idx; group < groups; group += gridDim.x * static_cast<int64_t>(blockDim.x)) {
+    const float4 rand = group_randoms(seed, group, offset);
+    const int64_t base = group * UNROLL;
+    memory::aligned_vector<scalar_t, UNROLL> g, out;
+    load_group<scalar_t, kVectorized>(grad, base, nelem, g);
+    #pragma unroll
+    for (int ii = 0; ii < UNROLL; ii++) {
+      const accscalar_t factor = (&rand.x)[ii] <= keep ? scale : accscalar_t(0);
+      out.val[ii] = static_cast<accscalar_t>(g.val[ii]) * factor;
+    }
+    store_group<scalar_t, kVectorized>(grad_input, base, nelem, out);
+  }
+}
+
+dim3 bias_dropout_add_grid(int64_t nelem) {
+  const int64_t groups = (nelem + UNROLL - 1) / UNROLL;
+  const auto* prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t max_blocks = static_cast<int64_t>(prop->multiProcessorCount) *
+      (prop->maxThreadsPerMultiProcessor / kBiasDropoutAddBlockSize);
+  return dim3(std::min(max_blocks, (groups + kBiasDropoutAddBlockSize - 1) / kBiasDropoutAddBlockSize));
+}
+
+template <typename scalar_t>
+bool can_vectorize_groups(int64_t nelem, std::initializer_list<const Tensor*> tensors) {
+  if (nelem % UNROLL != 0) {
+    return false;
+  }
+  for (const Tensor* t : tensors) {
+    if (memory::can_vectorize_up_to<scalar_t>(static_cast<char*>(t->data_ptr())) < UNROLL) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } //anonymous namespace
 
 std::tuple<Tensor,Tensor>
@@ -211,11 +352,11 @@ fused_dropout_cuda(const Tensor& self, double p, c10::optional<Generator> gen_){
   grid.x = std::min((unsigned int)at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm, grid.x);
 //number of times random will be generated per thread, to offset philox counter in thc random state
   int64_t counter_offset = ((nelem - 1)/(block_size*grid.x*UNROLL)+1)*UNROLL;
-  std::pair<uint64_t, uint64_t> rng_engine_inputs;
+  PhiloxCudaState rng_engine_inputs;
   {
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(gen->mutex_);
-    rng_engine_inputs = gen->philox_engine_inputs(counter_offset);
+    rng_engine_inputs = gen->philox_cuda_state(counter_offset);
   }
   if (cuda::detail::canUse32BitIndexMath(self)){
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, self.scalar_type(), "fused_dropout", [&] {
@@ -303,5 +444,83 @@ Tensor masked_scale_cuda(const Tensor& self, const Tensor& mask, double scale){
   return ret;
 }
 
+std::tuple<Tensor,Tensor>
+fused_bias_dropout_add_cuda(const Tensor& self, const Tensor& bias, const Tensor& residual, double p, c10::optional<Generator> gen_){
+  TORCH_CHECK(p >= 0 && p <= 1, "_fused_bias_dropout_add: dropout probability has to be between 0 and 1, but got ", p);
+  TORCH_CHECK(self.dim() >= 1 && bias.dim() == 1 && bias.size(0) == self.size(-1),
+      "_fused_bias_dropout_add: expected a bias of the size of the last dimension of self ", self.sizes(),
+      ", but got ", bias.sizes());
+  TORCH_CHECK(residual.sizes() == self.sizes(),
+      "_fused_bias_dropout_add: expected a residual of size ", self.sizes(), ", but got ", residual.sizes());
+  TORCH_CHECK(bias.scalar_type() == self.scalar_type() && residual.scalar_type() == self.scalar_type(),
+      "_fused_bias_dropout_add: expected self, bias and residual of the same dtype, but got ",
+      self.scalar_type(), ", ", bias.scalar_type(), " and ", residual.scalar_type());
+  TORCH_CHECK(bias.device() == self.device() && residual.device() == self.device(),
+      "_fused_bias_dropout_add: expected self, bias and residual on the same device");
+  auto gen = get_generator_or_default<CUDAGeneratorImpl>(gen_, cuda::detail::getDefaultCUDAGenerator());
+  const Tensor self_ = self.contiguous();
+  const Tensor bias_ = bias.contiguous();
+  const Tensor residual_ = residual.contiguous();
+  Tensor ret = at::empty(self.sizes(), self.options());
+  Tensor rng_state = at::empty({2}, self.options().dtype(kLong));
+  const int64_t nelem = self.numel();
+  if (nelem == 0) return std::tuple<Tensor,Tensor>(ret, rng_state.zero_());
+  const dim3 grid = bias_dropout_add_grid(nelem);
+  PhiloxCudaState rng_engine_inputs;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    // Every group consumes one curand_uniform4 of its own subsequence
+    rng_engine_inputs = gen->philox_cuda_state(UNROLL);
+  }
+  const float keep = static_cast<float>(1 - p);
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, self.scalar_type(), "fused_bias_dropout_add", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "fused_bias_dropout_add", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      const accscalar_t scale = p == 1 ? accscalar_t(0) : accscalar_t(1. / (1 - p));
+      if (can_vectorize_groups<scalar_t>(nelem, {&self_, &residual_, &ret})) {
+        fused_bias_dropout_add_kernel<scalar_t, accscalar_t, true><<<grid, kBiasDropoutAddBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+            self_.data_ptr<scalar_t>(), bias_.data_ptr<scalar_t>(), residual_.data_ptr<scalar_t>(), ret.data_ptr<scalar_t>(),
+            rng_state.data_ptr<int64_t>(), nelem, bias.numel(), keep, scale, rng_engine_inputs);
+      } else {
+        fused_bias_dropout_add_kernel<scalar_t, accscalar_t, false><<<grid, kBiasDropoutAddBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+            self_.data_ptr<scalar_t>(), bias_.data_ptr<scalar_t>(), residual_.data_ptr<scalar_t>(), ret.data_ptr<scalar_t>(),
+            rng_state.data_ptr<int64_t>(), nelem, bias.numel(), keep, scale, rng_engine_inputs);
+      }
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return std::tuple<Tensor,Tensor>(ret, rng_state);
+}
+
+Tensor fused_bias_dropout_add_backward_cuda(const Tensor& grad, const Tensor& rng_state, double p){
+  TORCH_CHECK(rng_state.scalar_type() == at::ScalarType::Long && rng_state.numel() == 2,
+      "_fused_bias_dropout_add_backward: expected the rng_state returned by _fused_bias_dropout_add");
+  TORCH_CHECK(rng_state.device() == grad.device(),
+      "_fused_bias_dropout_add_backward: expected grad and rng_state on the same device");
+  const Tensor grad_ = grad.contiguous();
+  const Tensor rng_state_ = rng_state.contiguous();
+  Tensor grad_input = at::empty(grad.sizes(), grad.options());
+  const int64_t nelem = grad.numel();
+  if (nelem == 0) return grad_input;
+  const dim3 grid = bias_dropout_add_grid(nelem);
+  const float keep = static_cast<float>(1 - p);
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, grad.scalar_type(), "fused_bias_dropout_add_backward", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "fused_bias_dropout_add_backward", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      const accscalar_t scale = p == 1 ? accscalar_t(0) : accscalar_t(1. / (1 - p));
+      if (can_vectorize_groups<scalar_t>(nelem, {&grad_, &grad_input})) {
+        fused_bias_dropout_add_backward_kernel<scalar_t, accscalar_t, true><<<grid, kBiasDropoutAddBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+            grad_.data_ptr<scalar_t>(), rng_state_.data_ptr<int64_t>(), grad_input.data_ptr<scalar_t>(), nelem, keep, scale);
+      } else {
+        fused_bias_dropout_add_backward_kernel<scalar_t, accscalar_t, false><<<grid, kBiasDropoutAddBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+            grad_.data_ptr<scalar_t>(), rng_state_.data_ptr<int64_t>(), grad_input.data_ptr<scalar_t>(), nelem, keep, scale);
+      }
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return grad_input;
+}
+
 }
 }
@@ -12,10 +12,13 @@
 #include <THC/THCAtomics.cuh>
 
 #include <thrust/execution_policy.h>
+#include <thrust/sort.h>
 #include <thrust/unique.h>
 
 #include <c10/macros/Macros.h>
 
+#include <limits>
+
 namespace at {
 namespace native {
 
@@ -23,6 +26,8 @@ namespace {
 
 // The maximum block size in CUDA
 constexpr int MAX_BLOCK_SIZE = 1024;
+// The block size when rows are narrower than a warp
+constexpr int SMALL_STRIDE_BLOCK_SIZE = 256;
 /* This code computes the sum of the weights in two-steps:
   1) Each GPU warp sums `NROWS_PER_THREAD` number of row given by `indeces`
   2) Each partial-sum from 1) are summed and scatter into `grad_weight`
@@ -261,8 +266,12 @@ Tensor embedding_backward_cuda_kernel(
             num_of_segments);
   }
 
-  const int stride_warped = ceil_div(stride, C10_WARP_SIZE)*C10_WARP_SIZE;
-  const int block = std::min(stride_warped, MAX_BLOCK_SIZE);
+  // Rows narrower than a warp aren't padded to one, so that e.g. the one
+  // element rows of scatter_add_ don't leave most threads idle.
+  const int stride_warped = stride < C10_WARP_SIZE ?
+      stride : ceil_div(stride, C10_WARP_SIZE)*C10_WARP_SIZE;
+  const int block = stride < C10_WARP_SIZE ?
+      SMALL_STRIDE_BLOCK_SIZE : std::min(stride_warped, MAX_BLOCK_SIZE);
   const int grid = ceil_div(num_of_partial_segments*stride_warped, block);
 
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
@@ -323,4 +332,53 @@ Tensor embedding_backward_cuda_kernel(
   return grad_weight;
 }
 
+std::tuple<Tensor, Tensor> embedding_sort_indices_cuda(const Tensor &indices) {
+  auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto orig_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  const ptrdiff_t numel = indices.numel();
+  if (numel == 0) {
+    return std::make_tuple(sorted_indices, orig_indices);
+  }
+  using device_ptr = thrust::device_ptr<int64_t>;
+
+  sorted_indices.copy_(indices);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(stream);
+
+  // Fill sortedOrigIndices with sequential indices
+  auto count_iter = thrust::counting_iterator<int64_t>(0);
+  auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
+  thrust::copy(policy, count_iter, count_iter + numel, orig_data);
+
+  auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
+  thrust::stable_sort_by_key(policy, sorted_data, sorted_data + numel, orig_data,
+                             ThrustLTOp<int64_t>());
+  return std::make_tuple(sorted_indices, orig_indices);
+}
+
+Tensor embedding_segment_sum_cuda(
+        const Tensor &values,
+        const Tensor &indices,
+        int64_t num_rows) {
+  TORCH_INTERNAL_ASSERT(values.dim() == 2 && indices.dim() == 1 &&
+                        values.size(0) == indices.numel());
+  TORCH_CHECK(indices.numel() <= std::numeric_limits<int>::max(),
+              "embedding_segment_sum_cuda: more than INT_MAX indices are not supported");
+  if (indices.numel() == 0 || values.size(1) == 0) {
+    return at::zeros({num_rows, values.size(1)}, values.options());
+  }
+  Tensor sorted_indices, orig_indices;
+  std::tie(sorted_indices, orig_indices) = embedding_sort_indices_cuda(indices.contiguous());
+  // The first and last sorted indices are the smallest and largest ones
+  const auto bounds = at::stack({sorted_indices[0], sorted_indices[-1]}).cpu();
+  const int64_t min_index = bounds[0].item<int64_t>();
+  const int64_t max_index = bounds[1].item<int64_t>();
+  TORCH_CHECK_INDEX(min_index >= 0 && max_index < num_rows,
+                    "index ", min_index < 0 ? min_index : max_index,
+                    " is out of bounds for dimension 0 with size ", num_rows);
+  return embedding_backward_cuda_kernel(values.contiguous(), orig_indices,
+      sorted_indices, /*count=*/Tensor(), num_rows);
+}
+
 }}
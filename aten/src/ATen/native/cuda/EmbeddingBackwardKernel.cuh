@@ -33,4 +33,30 @@ Tensor embedding_backward_cuda_kernel(
     const Tensor &bag_size = Tensor(),
     const Tensor &per_sample_weights = Tensor());
 
+// Returns indices sorted, and for every sorted index the position it came
+// from. The sort is stable, so that the positions of equal indices stay in
+// increasing order and sums over them are done in a fixed order.
+std::tuple<Tensor, Tensor> embedding_sort_indices_cuda(const Tensor &indices);
+
+// Returns the [num_rows, values.size(1)] tensor whose row r is the sum of the
+// rows i of the 2-d values with indices[i] == r, and zero if no index is r.
+// The indices are sorted and every run of equal ones is reduced by the
+// embedding backward kernels, without atomics, so that the result is
+// deterministic. Used by index_add_ and scatter_add_ when deterministic
+// algorithms are requested.
+Tensor embedding_segment_sum_cuda(
+    const Tensor &values,
+    const Tensor &indices,
+    int64_t num_rows);
+
+// Whether embedding_segment_sum_cuda supports values of type t. It isn't
+// needed for integral types, whose atomic sums are deterministic.
+inline bool embedding_segment_sum_supports(ScalarType t) {
+#ifdef __HIP_PLATFORM_HCC__
+  return isFloatingType(t);
+#else
+  return isFloatingType(t) && t != kBFloat16;
+#endif
+}
+
 }}
\ No newline at end of file
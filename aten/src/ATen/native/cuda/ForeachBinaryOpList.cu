@@ -0,0 +1,104 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+template<typename T>
+struct AddListOp {
+  T alpha;
+  __device__ T operator()(const T* x) const { return x[0] + alpha * x[1]; }
+};
+
+template<typename T>
+struct MulListOp {
+  __device__ T operator()(const T* x) const { return x[0] * x[1]; }
+};
+
+template<typename T>
+struct DivListOp {
+  __device__ T operator()(const T* x) const { return x[0] / x[1]; }
+};
+
+// `scalars` are converted to the accumulate type and used to initialize Op.
+template<template<class> class Op, typename... Scalars>
+std::vector<Tensor> foreach_binary_op_list(TensorList tensors1, TensorList tensors2, Scalars... scalars) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors1.vec());
+  tensor_lists.emplace_back(tensors2.vec());
+
+  std::vector<Tensor> result;
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, tensors1[0].scalar_type(), "foreach_binary_op_list_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    result = foreach_apply<scalar_t, 2>(tensor_lists, Op<opmath_t>{scalars.template to<opmath_t>()...});
+  });
+  return result;
+}
+
+template<template<class> class Op, typename... Scalars>
+void foreach_binary_op_list_(TensorList tensors1, TensorList tensors2, Scalars... scalars) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors1.vec());
+  tensor_lists.emplace_back(tensors2.vec());
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, tensors1[0].scalar_type(), "foreach_binary_op_list_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply_<scalar_t, 2>(tensor_lists, Op<opmath_t>{scalars.template to<opmath_t>()...});
+  });
+}
+
+} // namespace
+
+std::vector<Tensor> foreach_tensor_add_list_kernel_cuda(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2}, alpha)) {
+    return at::native::foreach_tensor_add_list_kernel_slow(tensors1, tensors2, alpha);
+  }
+  return foreach_binary_op_list<AddListOp>(tensors1, tensors2, alpha);
+}
+
+void foreach_tensor_add_list_kernel_cuda_(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2}, alpha)) {
+    return at::native::foreach_tensor_add_list_kernel_slow_(tensors1, tensors2, alpha);
+  }
+  foreach_binary_op_list_<AddListOp>(tensors1, tensors2, alpha);
+}
+
+std::vector<Tensor> foreach_tensor_mul_list_kernel_cuda(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2})) {
+    return at::native::foreach_tensor_mul_list_kernel_slow(tensors1, tensors2);
+  }
+  return foreach_binary_op_list<MulListOp>(tensors1, tensors2);
+}
+
+void foreach_tensor_mul_list_kernel_cuda_(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2})) {
+    return at::native::foreach_tensor_mul_list_kernel_slow_(tensors1, tensors2);
+  }
+  foreach_binary_op_list_<MulListOp>(tensors1, tensors2);
+}
+
+// Integer division follows the semantics of at::div, so it always takes the slow route.
+std::vector<Tensor> foreach_tensor_div_list_kernel_cuda(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2}) ||
+      at::isIntegralType(tensors1[0].scalar_type(), /*includeBool=*/true)) {
+    return at::native::foreach_tensor_div_list_kernel_slow(tensors1, tensors2);
+  }
+  return foreach_binary_op_list<DivListOp>(tensors1, tensors2);
+}
+
+void foreach_tensor_div_list_kernel_cuda_(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2}) ||
+      at::isIntegralType(tensors1[0].scalar_type(), /*includeBool=*/true)) {
+    return at::native::foreach_tensor_div_list_kernel_slow_(tensors1, tensors2);
+  }
+  foreach_binary_op_list_<DivListOp>(tensors1, tensors2);
+}
+
+}} // namespace at::native
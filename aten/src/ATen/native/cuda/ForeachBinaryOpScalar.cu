@@ -0,0 +1,109 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+// NOTE: CUDA on Windows requires that the enclosing function
+// of a __device__ lambda not have internal linkage.
+
+namespace at { namespace native {
+
+namespace {
+
+template<typename T>
+struct AddScalarOp {
+  T scalar;
+  __device__ T operator()(const T* x) const { return x[0] + scalar; }
+};
+
+template<typename T>
+struct MulScalarOp {
+  T scalar;
+  __device__ T operator()(const T* x) const { return x[0] * scalar; }
+};
+
+template<typename T>
+struct DivScalarOp {
+  T scalar;
+  __device__ T operator()(const T* x) const { return x[0] / scalar; }
+};
+
+// Reads the scale from device memory, so applying it needs no host sync.
+template<typename T>
+struct MulTensorOp {
+  const T* scalar;
+  __device__ T operator()(const T* x) const { return x[0] * *scalar; }
+};
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_binary_op_scalar(TensorList tensors, Scalar scalar) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  std::vector<Tensor> result;
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    result = foreach_apply<scalar_t, 1>(tensor_lists, Op<opmath_t>{scalar.to<opmath_t>()});
+  });
+  return result;
+}
+
+template<template<class> class Op>
+void foreach_binary_op_scalar_(TensorList tensors, Scalar scalar) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(kBFloat16, kHalf, tensors[0].scalar_type(), "foreach_binary_op_scalar_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply_<scalar_t, 1>(tensor_lists, Op<opmath_t>{scalar.to<opmath_t>()});
+  });
+}
+
+} // namespace
+
+#define FOREACH_BINARY_OP_SCALAR(NAME, OP, DIVISION_OP)                                            \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_cuda(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                                           \
+  bool is_integral = at::isIntegralType(tensors[0].scalar_type(), /*includeBool=*/true);             \
+  if (!can_use_fast_route({tensors}, scalar) || (DIVISION_OP && is_integral)) {                      \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow(tensors, scalar);                  \
+  }                                                                                                  \
+  return foreach_binary_op_scalar<OP>(tensors, scalar);                                              \
+}                                                                                                    \
+                                                                                                     \
+void foreach_tensor_##NAME##_scalar_kernel_cuda_(TensorList tensors, Scalar scalar) {              \
+  check_foreach_api_restrictions(tensors);                                                           \
+  bool is_integral = at::isIntegralType(tensors[0].scalar_type(), /*includeBool=*/true);             \
+  if (!can_use_fast_route({tensors}, scalar) || (DIVISION_OP && is_integral)) {                      \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow_(tensors, scalar);                 \
+  }                                                                                                  \
+  foreach_binary_op_scalar_<OP>(tensors, scalar);                                                    \
+}
+
+FOREACH_BINARY_OP_SCALAR(add, AddScalarOp, /*division_op=*/false);
+FOREACH_BINARY_OP_SCALAR(mul, MulScalarOp, /*division_op=*/false);
+// Integer division follows the semantics of at::div, so it always takes the slow route.
+FOREACH_BINARY_OP_SCALAR(div, DivScalarOp, /*division_op=*/true);
+
+void foreach_tensor_mul_tensor_kernel_cuda_(TensorList tensors, const Tensor& other) {
+  check_foreach_api_restrictions(tensors);
+  TORCH_CHECK(other.numel() == 1,
+              "_foreach_mul_ expects a one-element tensor, got ", other.numel(), " elements");
+  const auto scalar_type = tensors[0].scalar_type();
+  if (!can_use_fast_route({tensors}) ||
+      !at::isFloatingType(scalar_type) ||
+      !at::isFloatingType(other.scalar_type()) ||
+      other.device() != tensors[0].device()) {
+    return at::native::foreach_tensor_mul_tensor_kernel_slow_(tensors, other);
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  // The scale is applied in the accumulate type, like mul_ with a 0-dim tensor.
+  auto scale = other.to(toAccumulateType(scalar_type, /*is_cuda=*/true));
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, scalar_type, "foreach_tensor_mul_tensor_kernel_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply_<scalar_t, 1>(tensor_lists, MulTensorOp<opmath_t>{scale.data_ptr<opmath_t>()});
+  });
+}
+
+}} // namespace at::native
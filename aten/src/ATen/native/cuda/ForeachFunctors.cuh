@@ -0,0 +1,125 @@
+#pragma once
+#include <ATen/AccumulateType.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cuda/ForeachUtils.cuh>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+// Applies `op` elementwise to chunks of `depth` tensor lists. The first
+// `r_args_depth` lists are inputs; the result is written to the list at
+// `res_arg_index`, which is the last list for out-of-place ops and the first
+// one for in-place ops.
+//
+// `op` is called with the values of the inputs at one index, converted to
+// the accumulate type of T, and returns the value to store.
+template<typename T, int depth, int r_args_depth, int res_arg_index>
+struct ElementwiseForeachFunctor {
+  template<typename Op>
+  __device__ void operator() (
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      Op op) {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.sizes[tensor_loc];
+
+    T* args[depth];
+    bool all_aligned = true;
+#pragma unroll
+    for (int d = 0; d < depth; d++) {
+      args[d] = (T*)tl.addresses[d][tensor_loc] + chunk_idx * chunk_size;
+      all_aligned = all_aligned && is_aligned(args[d]);
+    }
+
+    n -= chunk_idx * chunk_size;
+
+    T r_args[r_args_depth][kILP];
+    opmath_t x[r_args_depth];
+
+    // to make things simple, we put aligned case in a different code path
+    if (n % kILP == 0 && chunk_size % kILP == 0 && all_aligned) {
+      for (int i_start = threadIdx.x; i_start * kILP < n && i_start * kILP < chunk_size; i_start += blockDim.x) {
+        // load
+#pragma unroll
+        for (int d = 0; d < r_args_depth; d++) {
+          load_store(r_args[d], args[d], 0, i_start);
+        }
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+#pragma unroll
+          for (int d = 0; d < r_args_depth; d++) {
+            x[d] = static_cast<opmath_t>(r_args[d][ii]);
+          }
+          r_args[0][ii] = static_cast<T>(op(x));
+        }
+        // store
+        load_store(args[res_arg_index], r_args[0], i_start, 0);
+      }
+    } else {
+      // Non-divergent exit condition for __syncthreads, not necessary here
+      for (int i_start = 0; i_start < n && i_start < chunk_size; i_start += blockDim.x * kILP) {
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          int i = i_start + threadIdx.x + ii * blockDim.x;
+#pragma unroll
+          for (int d = 0; d < r_args_depth; d++) {
+            r_args[d][ii] = 0;
+            if (i < n && i < chunk_size) {
+              r_args[d][ii] = args[d][i];
+            }
+          }
+        }
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+#pragma unroll
+          for (int d = 0; d < r_args_depth; d++) {
+            x[d] = static_cast<opmath_t>(r_args[d][ii]);
+          }
+          r_args[0][ii] = static_cast<T>(op(x));
+        }
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          int i = i_start + threadIdx.x + ii * blockDim.x;
+          if (i < n && i < chunk_size) {
+            args[res_arg_index][i] = r_args[0][ii];
+          }
+        }
+      }
+    }
+  }
+};
+
+// Runs `op` over `tensor_lists`, writing into a freshly allocated list that
+// is returned. All lists must be able to use the fast route.
+template<typename scalar_t, int r_args_depth, typename Op>
+std::vector<Tensor> foreach_apply(std::vector<std::vector<at::Tensor>>& tensor_lists, Op op) {
+  std::vector<at::Tensor> vec_res;
+  vec_res.reserve(tensor_lists[0].size());
+  for (const auto& t: tensor_lists[0]) {
+    vec_res.emplace_back(at::native::empty_like(t));
+  }
+  tensor_lists.emplace_back(std::move(vec_res));
+
+  multi_tensor_apply<r_args_depth + 1>(
+      tensor_lists,
+      ElementwiseForeachFunctor<scalar_t, r_args_depth + 1, r_args_depth, r_args_depth>(),
+      op);
+  return tensor_lists[r_args_depth];
+}
+
+// Runs `op` over `tensor_lists`, writing the result into the first list.
+template<typename scalar_t, int r_args_depth, typename Op>
+void foreach_apply_(std::vector<std::vector<at::Tensor>>& tensor_lists, Op op) {
+  multi_tensor_apply<r_args_depth>(
+      tensor_lists,
+      ElementwiseForeachFunctor<scalar_t, r_args_depth, r_args_depth, 0>(),
+      op);
+}
+
+} // namespace
+
+}} // namespace at::native
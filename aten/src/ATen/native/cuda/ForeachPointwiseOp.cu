@@ -0,0 +1,108 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+template<typename T>
+struct AddcmulOp {
+  T value;
+  __device__ T operator()(const T* x) const { return x[0] + value * x[1] * x[2]; }
+};
+
+template<typename T>
+struct AddcdivOp {
+  T value;
+  __device__ T operator()(const T* x) const { return x[0] + value * x[1] / x[2]; }
+};
+
+// Matches the formulation used by at::lerp.
+template<typename T>
+struct LerpOp {
+  T weight;
+  __device__ T operator()(const T* x) const {
+    return (weight < 0.5) ? x[0] + weight * (x[1] - x[0])
+                          : x[1] - (x[1] - x[0]) * (1 - weight);
+  }
+};
+
+} // namespace
+
+#define FOREACH_POINTWISE_OP(NAME, OP)                                                                                        \
+std::vector<Tensor> foreach_tensor_##NAME##_cuda(TensorList input, TensorList tensors1, TensorList tensors2, Scalar value) { \
+  check_foreach_api_restrictions({input, tensors1, tensors2});                                                                \
+  if (!can_use_fast_route({input, tensors1, tensors2}, value)) {                                                              \
+    return at::native::foreach_tensor_##NAME##_slow(input, tensors1, tensors2, value);                                        \
+  }                                                                                                                           \
+                                                                                                                              \
+  std::vector<std::vector<at::Tensor>> tensor_lists;                                                                          \
+  tensor_lists.emplace_back(input.vec());                                                                                     \
+  tensor_lists.emplace_back(tensors1.vec());                                                                                  \
+  tensor_lists.emplace_back(tensors2.vec());                                                                                  \
+                                                                                                                              \
+  std::vector<Tensor> result;                                                                                                 \
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND2(kBFloat16, kHalf, input[0].scalar_type(), "foreach_" #NAME "_cuda", [&]() {    \
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;                                                                    \
+    result = foreach_apply<scalar_t, 3>(tensor_lists, OP<opmath_t>{value.to<opmath_t>()});                                    \
+  });                                                                                                                         \
+  return result;                                                                                                              \
+}                                                                                                                             \
+                                                                                                                              \
+void foreach_tensor_##NAME##_cuda_(TensorList input, TensorList tensors1, TensorList tensors2, Scalar value) {              \
+  check_foreach_api_restrictions({input, tensors1, tensors2});                                                                \
+  if (!can_use_fast_route({input, tensors1, tensors2}, value)) {                                                              \
+    return at::native::foreach_tensor_##NAME##_slow_(input, tensors1, tensors2, value);                                       \
+  }                                                                                                                           \
+                                                                                                                              \
+  std::vector<std::vector<at::Tensor>> tensor_lists;                                                                          \
+  tensor_lists.emplace_back(input.vec());                                                                                     \
+  tensor_lists.emplace_back(tensors1.vec());                                                                                  \
+  tensor_lists.emplace_back(tensors2.vec());                                                                                  \
+                                                                                                                              \
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND2(kBFloat16, kHalf, input[0].scalar_type(), "foreach_" #NAME "_cuda_", [&]() {   \
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;                                                                    \
+    foreach_apply_<scalar_t, 3>(tensor_lists, OP<opmath_t>{value.to<opmath_t>()});                                            \
+  });                                                                                                                         \
+}
+
+FOREACH_POINTWISE_OP(addcmul, AddcmulOp);
+FOREACH_POINTWISE_OP(addcdiv, AddcdivOp);
+
+std::vector<Tensor> foreach_tensor_lerp_cuda(TensorList tensors1, TensorList tensors2, Scalar weight) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2}, weight) ||
+      !at::isFloatingType(tensors1[0].scalar_type())) {
+    return at::native::foreach_tensor_lerp_slow(tensors1, tensors2, weight);
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors1.vec());
+  tensor_lists.emplace_back(tensors2.vec());
+
+  std::vector<Tensor> result;
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, tensors1[0].scalar_type(), "foreach_lerp_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    result = foreach_apply<scalar_t, 2>(tensor_lists, LerpOp<opmath_t>{weight.to<opmath_t>()});
+  });
+  return result;
+}
+
+void foreach_tensor_lerp_cuda_(TensorList tensors1, TensorList tensors2, Scalar weight) {
+  check_foreach_api_restrictions({tensors1, tensors2});
+  if (!can_use_fast_route({tensors1, tensors2}, weight) ||
+      !at::isFloatingType(tensors1[0].scalar_type())) {
+    return at::native::foreach_tensor_lerp_slow_(tensors1, tensors2, weight);
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors1.vec());
+  tensor_lists.emplace_back(tensors2.vec());
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, tensors1[0].scalar_type(), "foreach_lerp_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply_<scalar_t, 2>(tensor_lists, LerpOp<opmath_t>{weight.to<opmath_t>()});
+  });
+}
+
+}} // namespace at::native
@@ -0,0 +1,156 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+#include <limits>
+
+// NOTE: CUDA on Windows requires that the enclosing function
+// of a __device__ lambda not have internal linkage.
+
+namespace at { namespace native {
+
+namespace {
+
+enum class NormType { L1, L2, LInf };
+
+// Folds one element into a partial norm.
+template<NormType norm_type, typename opmath_t>
+__device__ __forceinline__ opmath_t norm_accumulate(opmath_t acc, opmath_t x) {
+  if (norm_type == NormType::L1) {
+    return acc + ::abs(x);
+  } else if (norm_type == NormType::L2) {
+    return acc + x * x;
+  }
+  return ::max(acc, ::abs(x));
+}
+
+// Combines two partial norms.
+template<NormType norm_type, typename opmath_t>
+__device__ __forceinline__ opmath_t norm_combine(opmath_t a, opmath_t b) {
+  return norm_type == NormType::LInf ? ::max(a, b) : a + b;
+}
+
+// Reduces `val` across the block. The result is only valid in thread 0.
+template<NormType norm_type, typename opmath_t>
+__device__ __forceinline__ opmath_t block_reduce_norm(opmath_t val, opmath_t* shared) {
+  shared[threadIdx.x] = val;
+  __syncthreads();
+  for (int s = blockDim.x / 2; s > 0; s >>= 1) {
+    if (threadIdx.x < s) {
+      shared[threadIdx.x] = norm_combine<norm_type>(shared[threadIdx.x], shared[threadIdx.x + s]);
+    }
+    __syncthreads();
+  }
+  return shared[0];
+}
+
+// Computes the partial norm of one chunk and writes it to
+// output_per_tensor[tensor * max_chunks_per_tensor + chunk].
+template<typename T, NormType norm_type>
+struct LpNormFunctor {
+  using opmath_t = acc_type<T, /*is_cuda=*/true>;
+
+  __device__ void operator() (
+      int chunk_size,
+      TensorListMetadata<1>& tl,
+      opmath_t* output_per_tensor,
+      int max_chunks_per_tensor) {
+    __shared__ opmath_t shared[kBlockSize];
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.sizes[tensor_loc] - chunk_idx * chunk_size;
+    T* x = (T*)tl.addresses[0][tensor_loc] + chunk_idx * chunk_size;
+
+    opmath_t val = 0;
+    for (int i = threadIdx.x; i < n && i < chunk_size; i += blockDim.x) {
+      val = norm_accumulate<norm_type>(val, static_cast<opmath_t>(x[i]));
+    }
+    val = block_reduce_norm<norm_type>(val, shared);
+    if (threadIdx.x == 0) {
+      output_per_tensor[(tl.start_tensor_this_launch + tensor_loc) * max_chunks_per_tensor + chunk_idx] = val;
+    }
+  }
+};
+
+// One block per tensor: combines the partial norms of its chunks.
+template<typename T, NormType norm_type, typename opmath_t>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void lpnorm_cleanup(
+    const opmath_t* output_per_tensor,
+    T* ret_per_tensor,
+    int max_chunks_per_tensor) {
+  __shared__ opmath_t shared[kBlockSize];
+  const opmath_t* partials = output_per_tensor + blockIdx.x * max_chunks_per_tensor;
+
+  opmath_t val = 0;
+  for (int i = threadIdx.x; i < max_chunks_per_tensor; i += blockDim.x) {
+    val = norm_combine<norm_type>(val, partials[i]);
+  }
+  val = block_reduce_norm<norm_type>(val, shared);
+  if (threadIdx.x == 0) {
+    ret_per_tensor[blockIdx.x] = static_cast<T>(norm_type == NormType::L2 ? ::sqrt(val) : val);
+  }
+}
+
+template<NormType norm_type>
+std::vector<Tensor> foreach_norm(TensorList tensors) {
+  int64_t max_chunks_per_tensor = 1;
+  for (const auto& t : tensors) {
+    max_chunks_per_tensor = std::max<int64_t>(max_chunks_per_tensor, (t.numel() + kChunkSize - 1) / kChunkSize);
+  }
+
+  const auto scalar_type = tensors[0].scalar_type();
+  const auto n_tensors = static_cast<int64_t>(tensors.size());
+  auto output_per_tensor = at::zeros(
+      {n_tensors * max_chunks_per_tensor},
+      tensors[0].options().dtype(toAccumulateType(scalar_type, /*is_cuda=*/true)));
+  auto ret_per_tensor = at::empty({n_tensors}, tensors[0].options());
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, scalar_type, "foreach_norm_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<1>(
+        tensor_lists,
+        LpNormFunctor<scalar_t, norm_type>(),
+        output_per_tensor.data_ptr<opmath_t>(),
+        static_cast<int>(max_chunks_per_tensor));
+    lpnorm_cleanup<scalar_t, norm_type><<<n_tensors, kBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+        output_per_tensor.data_ptr<opmath_t>(),
+        ret_per_tensor.data_ptr<scalar_t>(),
+        static_cast<int>(max_chunks_per_tensor));
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+
+  return ret_per_tensor.unbind(0);
+}
+
+} // namespace
+
+// Computes the p-norm of every tensor in two launches: a multi_tensor_apply
+// pass that reduces each chunk, and a cleanup kernel that combines the chunks
+// of each tensor. Only the 1, 2 and inf norms of floating point tensors take
+// this route.
+std::vector<Tensor> foreach_tensor_norm_cuda(TensorList tensors, Scalar ord) {
+  check_foreach_api_restrictions(tensors);
+  const double p = ord.to<double>();
+  bool has_empty = false;
+  for (const auto& t : tensors) {
+    has_empty = has_empty || t.numel() == 0;
+  }
+  if (!can_use_fast_route({tensors}) ||
+      !at::isFloatingType(tensors[0].scalar_type()) ||
+      has_empty ||
+      !(p == 1 || p == 2 || p == std::numeric_limits<double>::infinity())) {
+    return at::native::foreach_tensor_norm_slow(tensors, ord);
+  }
+
+  if (p == 1) {
+    return foreach_norm<NormType::L1>(tensors);
+  } else if (p == 2) {
+    return foreach_norm<NormType::L2>(tensors);
+  }
+  return foreach_norm<NormType::LInf>(tensors);
+}
+
+}} // namespace at::native
@@ -0,0 +1,62 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+template<typename T>
+struct SqrtOp {
+  __device__ T operator()(const T* x) const { return ::sqrt(x[0]); }
+};
+
+template<template<class> class Op>
+std::vector<Tensor> foreach_unary_op(TensorList tensors) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  std::vector<Tensor> result;
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, tensors[0].scalar_type(), "foreach_unary_op_cuda", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    result = foreach_apply<scalar_t, 1>(tensor_lists, Op<opmath_t>());
+  });
+  return result;
+}
+
+template<template<class> class Op>
+void foreach_unary_op_(TensorList tensors) {
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(tensors.vec());
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, tensors[0].scalar_type(), "foreach_unary_op_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    foreach_apply_<scalar_t, 1>(tensor_lists, Op<opmath_t>());
+  });
+}
+
+} // namespace
+
+// Only floating point lists take the fast route; everything else gets the
+// type handling of the regular op.
+#define FOREACH_UNARY_OP(NAME, OP)                                                 \
+std::vector<Tensor> foreach_tensor_##NAME##_cuda(TensorList tensors) {           \
+  check_foreach_api_restrictions(tensors);                                         \
+  if (!can_use_fast_route({tensors}) ||                                            \
+      !at::isFloatingType(tensors[0].scalar_type())) {                             \
+    return at::native::foreach_tensor_##NAME##_slow(tensors);                      \
+  }                                                                                \
+  return foreach_unary_op<OP>(tensors);                                            \
+}                                                                                  \
+                                                                                   \
+void foreach_tensor_##NAME##_cuda_(TensorList tensors) {                         \
+  check_foreach_api_restrictions(tensors);                                         \
+  if (!can_use_fast_route({tensors}) ||                                            \
+      !at::isFloatingType(tensors[0].scalar_type())) {                             \
+    return at::native::foreach_tensor_##NAME##_slow_(tensors);                     \
+  }                                                                                \
+  foreach_unary_op_<OP>(tensors);                                                  \
+}
+
+FOREACH_UNARY_OP(sqrt, SqrtOp);
+
+}} // namespace at::native
@@ -0,0 +1,242 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/DeviceUtils.cuh>
+#include <ATen/native/Attention.h>
+#include <c10/macros/Macros.h>
+
+#include <limits>
+
+// Fused attention: softmax(scale * Q K^T) V computed tile by tile, so that
+// the [L, S] attention matrix never leaves the chip.
+//
+// Every block computes kRowsPerBlock query rows of one batch entry n, a warp
+// per row. The keys and values are walked through in tiles of
+// kKeysPerTile = warp size rows, staged in shared memory and shared by the
+// warps of the block:
+//
+//   - lane j scores key j of the tile against the warp's query row, then the
+//     warp reduces the tile's maximum and sum of exponentials;
+//   - the running maximum m, running sum l and the output accumulator, which
+//     every lane holds kMaxHeadDim / warp size elements of, are rescaled by
+//     exp(m_old - m_new) ("online softmax"), and the tile's probabilities are
+//     broadcast a key at a time to accumulate p_j * V[j];
+//   - the output is acc / l once all tiles were seen.
+//
+// Masked keys get no probability at all, so that rows with every key masked
+// give NaN like the unfused softmax of -inf scores.
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kRowsPerBlock = 4;
+constexpr int kKeysPerTile = C10_WARP_SIZE;
+constexpr int kMaxHeadDim = 128;
+constexpr int kValuesPerLane = kMaxHeadDim / C10_WARP_SIZE;
+constexpr int kMaxSharedMemory = 48 * 1024;
+
+template <typename accscalar_t>
+__device__ __forceinline__ accscalar_t warp_max(accscalar_t value) {
+  for (int offset = C10_WARP_SIZE / 2; offset > 0; offset /= 2) {
+    value = ::max(value, WARP_SHFL_XOR(value, offset));
+  }
+  return value;
+}
+
+template <typename accscalar_t>
+__device__ __forceinline__ accscalar_t warp_sum(accscalar_t value) {
+  for (int offset = C10_WARP_SIZE / 2; offset > 0; offset /= 2) {
+    value += WARP_SHFL_XOR(value, offset);
+  }
+  return value;
+}
+
+// Shared memory of a block, in accscalar_t elements: the key tile, padded to
+// D + 1 columns so that lanes reading the same feature of different keys hit
+// different banks, the value tile and the scaled query rows.
+int64_t shared_memory_elements(int64_t D) {
+  return kKeysPerTile * (D + 1) + kKeysPerTile * D + kRowsPerBlock * D;
+}
+
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kRowsPerBlock * C10_WARP_SIZE)
+__global__ void fused_attention_kernel(
+    const scalar_t* __restrict__ query,
+    const scalar_t* __restrict__ key,
+    const scalar_t* __restrict__ value,
+    const bool* __restrict__ key_padding_mask,
+    scalar_t* __restrict__ output,
+    int64_t L,
+    int64_t S,
+    int D,
+    int64_t row_blocks,
+    int64_t heads_per_mask_row,
+    bool is_causal,
+    accscalar_t scale) {
+  extern __shared__ __align__(sizeof(double)) char smem_raw[];
+  accscalar_t* k_tile = reinterpret_cast<accscalar_t*>(smem_raw);
+  accscalar_t* v_tile = k_tile + kKeysPerTile * (D + 1);
+  accscalar_t* q_rows = v_tile + kKeysPerTile * D;
+
+  const int64_t n = blockIdx.x / row_blocks;
+  const int64_t row_begin = (blockIdx.x % row_blocks) * kRowsPerBlock;
+  const int warp = threadIdx.x / C10_WARP_SIZE;
+  const int lane = threadIdx.x % C10_WARP_SIZE;
+  const int64_t row = row_begin + warp;
+  const bool row_valid = row < L;
+
+  const scalar_t* q = query + (n * L + row) * D;
+  const scalar_t* k = key + n * S * D;
+  const scalar_t* v = value + n * S * D;
+  const bool* mask = key_padding_mask == nullptr
+      ? nullptr
+      : key_padding_mask + (n / heads_per_mask_row) * S;
+  accscalar_t* q_row = q_rows + warp * D;
+  for (int d = lane; d < D; d += C10_WARP_SIZE) {
+    q_row[d] = row_valid ? static_cast<accscalar_t>(q[d]) * scale : accscalar_t(0);
+  }
+
+  const accscalar_t neg_inf = -std::numeric_limits<accscalar_t>::infinity();
+  accscalar_t acc[kValuesPerLane];
+#pragma unroll
+  for (int t = 0; t < kValuesPerLane; t++) {
+    acc[t] = 0;
+  }
+  accscalar_t running_max = neg_inf;
+  accscalar_t running_sum = 0;
+
+  // Causal rows of this block don't attend past its last row
+  const int64_t key_end =
+      is_causal ? ::min(S, row_begin + kRowsPerBlock) : S;
+  for (int64_t tile_begin = 0; tile_begin < key_end; tile_begin += kKeysPerTile) {
+    __syncthreads();
+    for (int i = threadIdx.x; i < kKeysPerTile * D; i += blockDim.x) {
+      const int j = i / D;
+      const int d = i % D;
+      const bool in_range = tile_begin + j < S;
+      const int64_t offset = (tile_begin + j) * D + d;
+      k_tile[j * (D + 1) + d] =
+          in_range ? static_cast<accscalar_t>(k[offset]) : accscalar_t(0);
+      v_tile[j * D + d] =
+          in_range ? static_cast<accscalar_t>(v[offset]) : accscalar_t(0);
+    }
+    __syncthreads();
+
+    const int64_t s = tile_begin + lane;
+    const bool attended = row_valid && s < S && !(is_causal && s > row) &&
+        !(mask != nullptr && mask[s]);
+    accscalar_t score = neg_inf;
+    if (attended) {
+      score = 0;
+      const accscalar_t* k_row = k_tile + lane * (D + 1);
+      for (int d = 0; d < D; d++) {
+        score += q_row[d] * k_row[d];
+      }
+    }
+    const accscalar_t new_max = ::max(running_max, warp_max(score));
+    if (new_max == neg_inf) {
+      // Nothing attended yet, the same for the whole warp
+      continue;
+    }
+    const accscalar_t p = attended ? ::exp(score - new_max) : accscalar_t(0);
+    const accscalar_t correction = ::exp(running_max - new_max);
+    running_sum = running_sum * correction + warp_sum(p);
+    running_max = new_max;
+#pragma unroll
+    for (int t = 0; t < kValuesPerLane; t++) {
+      acc[t] *= correction;
+    }
+    for (int j = 0; j < kKeysPerTile; j++) {
+      const accscalar_t p_j = WARP_SHFL(p, j);
+      const accscalar_t* v_row = v_tile + j * D;
+#pragma unroll
+      for (int t = 0; t < kValuesPerLane; t++) {
+        const int d = lane + t * C10_WARP_SIZE;
+        if (d < D) {
+          acc[t] += p_j * v_row[d];
+        }
+      }
+    }
+  }
+
+  if (row_valid) {
+    scalar_t* out = output + (n * L + row) * D;
+#pragma unroll
+    for (int t = 0; t < kValuesPerLane; t++) {
+      const int d = lane + t * C10_WARP_SIZE;
+      if (d < D) {
+        out[d] = static_cast<scalar_t>(acc[t] / running_sum);
+      }
+    }
+  }
+}
+
+} // namespace
+
+Tensor fused_attention_cuda(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& key_padding_mask,
+    bool is_causal,
+    double scale) {
+  check_fused_attention_args(query, key, value, key_padding_mask);
+  const int64_t N = query.size(0);
+  const int64_t L = query.size(1);
+  const int64_t S = key.size(1);
+  const int64_t D = query.size(2);
+  const int64_t row_blocks = (L + kRowsPerBlock - 1) / kRowsPerBlock;
+  const int64_t smem_size = shared_memory_elements(D) *
+      (query.scalar_type() == kDouble ? sizeof(double) : sizeof(float));
+  if (D > kMaxHeadDim || smem_size > kMaxSharedMemory ||
+      N * row_blocks > std::numeric_limits<int>::max()) {
+    return fused_attention_math(query, key, value, key_padding_mask, is_causal, scale);
+  }
+
+  const Tensor query_ = query.contiguous();
+  const Tensor key_ = key.contiguous();
+  const Tensor value_ = value.contiguous();
+  const Tensor mask_ = key_padding_mask.defined()
+      ? key_padding_mask.to(query.device()).contiguous()
+      : key_padding_mask;
+  Tensor output = at::empty({N, L, D}, query_.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  if (S == 0) {
+    // Like multiplying the empty attention matrix with value
+    return output.zero_();
+  }
+
+  const int64_t heads_per_mask_row = mask_.defined() ? N / mask_.size(0) : 1;
+  const dim3 grid(N * row_blocks);
+  const dim3 block(kRowsPerBlock * C10_WARP_SIZE);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+      query_.scalar_type(), "fused_attention_cuda", [&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+        fused_attention_kernel<scalar_t, accscalar_t>
+            <<<grid, block, smem_size, stream>>>(
+                query_.data_ptr<scalar_t>(),
+                key_.data_ptr<scalar_t>(),
+                value_.data_ptr<scalar_t>(),
+                mask_.defined() ? mask_.data_ptr<bool>() : nullptr,
+                output.data_ptr<scalar_t>(),
+                L,
+                S,
+                D,
+                row_blocks,
+                heads_per_mask_row,
+                is_causal,
+                static_cast<accscalar_t>(scale));
+        AT_CUDA_CHECK(cudaGetLastError());
+      });
+  return output;
+}
+
+} // namespace native
+} // namespace at
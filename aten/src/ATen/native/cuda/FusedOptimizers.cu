@@ -0,0 +1,290 @@
+#include <ATen/Dispatch.h>
+#include <ATen/native/FusedOptimizers.h>
+#include <ATen/native/cuda/ForeachFunctors.cuh>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+// Loads the same chunk of all `depth` lists, lets `op` update the values at
+// each index in place, and writes back every list except the gradients,
+// which are list 1 and only read. The whole launch is a no-op if op.skip().
+template<typename T, int depth>
+struct FusedOptimizerFunctor {
+  template<typename Op>
+  __device__ void operator() (
+      int chunk_size,
+      TensorListMetadata<depth>& tl,
+      Op op) {
+    using opmath_t = acc_type<T, /*is_cuda=*/true>;
+    if (op.skip()) {
+      return;
+    }
+    int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    int chunk_idx = tl.block_to_chunk[blockIdx.x];
+    int n = tl.sizes[tensor_loc];
+
+    T* args[depth];
+    bool all_aligned = true;
+#pragma unroll
+    for (int d = 0; d < depth; d++) {
+      args[d] = (T*)tl.addresses[d][tensor_loc] + chunk_idx * chunk_size;
+      all_aligned = all_aligned && is_aligned(args[d]);
+    }
+
+    n -= chunk_idx * chunk_size;
+
+    T r_args[depth][kILP];
+    opmath_t x[depth];
+
+    if (n % kILP == 0 && chunk_size % kILP == 0 && all_aligned) {
+      for (int i_start = threadIdx.x; i_start * kILP < n && i_start * kILP < chunk_size; i_start += blockDim.x) {
+#pragma unroll
+        for (int d = 0; d < depth; d++) {
+          load_store(r_args[d], args[d], 0, i_start);
+        }
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            x[d] = static_cast<opmath_t>(r_args[d][ii]);
+          }
+          op(x);
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            r_args[d][ii] = static_cast<T>(x[d]);
+          }
+        }
+#pragma unroll
+        for (int d = 0; d < depth; d++) {
+          if (d != 1) {
+            load_store(args[d], r_args[d], i_start, 0);
+          }
+        }
+      }
+    } else {
+      for (int i_start = 0; i_start < n && i_start < chunk_size; i_start += blockDim.x * kILP) {
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          int i = i_start + threadIdx.x + ii * blockDim.x;
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            r_args[d][ii] = 0;
+            if (i < n && i < chunk_size) {
+              r_args[d][ii] = args[d][i];
+            }
+          }
+        }
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            x[d] = static_cast<opmath_t>(r_args[d][ii]);
+          }
+          op(x);
+#pragma unroll
+          for (int d = 0; d < depth; d++) {
+            r_args[d][ii] = static_cast<T>(x[d]);
+          }
+        }
+#pragma unroll
+        for (int ii = 0; ii < kILP; ii++) {
+          int i = i_start + threadIdx.x + ii * blockDim.x;
+          if (i < n && i < chunk_size) {
+#pragma unroll
+            for (int d = 0; d < depth; d++) {
+              if (d != 1) {
+                args[d][i] = r_args[d][ii];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+// x = {param, grad, exp_avg, exp_avg_sq[, max_exp_avg_sq]}
+template<typename T>
+struct AdamOp {
+  T lr;
+  T beta1;
+  T beta2;
+  T weight_decay;
+  T eps;
+  T step_size;
+  T bias_correction2_sqrt;
+  bool amsgrad;
+  bool decoupled_weight_decay;
+  const float* inv_scale;
+  const float* found_inf;
+
+  __device__ bool skip() const { return found_inf && *found_inf != 0.f; }
+
+  __device__ void operator()(T* x) const {
+    T g = inv_scale ? x[1] * static_cast<T>(*inv_scale) : x[1];
+    if (weight_decay != 0) {
+      if (decoupled_weight_decay) {
+        x[0] *= 1 - lr * weight_decay;
+      } else {
+        g += weight_decay * x[0];
+      }
+    }
+    x[2] = x[2] * beta1 + (1 - beta1) * g;
+    x[3] = x[3] * beta2 + (1 - beta2) * g * g;
+    T denom_src = x[3];
+    if (amsgrad) {
+      x[4] = x[4] < x[3] ? x[3] : x[4];
+      denom_src = x[4];
+    }
+    T denom = ::sqrt(denom_src) / bias_correction2_sqrt + eps;
+    x[0] -= step_size * x[2] / denom;
+  }
+};
+
+// x = {param, grad[, momentum_buffer]}
+template<typename T>
+struct SgdOp {
+  T lr;
+  T momentum;
+  T dampening;
+  T weight_decay;
+  bool nesterov;
+  bool is_first_step;
+  const float* inv_scale;
+  const float* found_inf;
+
+  __device__ bool skip() const { return found_inf && *found_inf != 0.f; }
+
+  __device__ void operator()(T* x) const {
+    T g = inv_scale ? x[1] * static_cast<T>(*inv_scale) : x[1];
+    if (weight_decay != 0) {
+      g += weight_decay * x[0];
+    }
+    if (momentum != 0) {
+      x[2] = is_first_step ? g : x[2] * momentum + (1 - dampening) * g;
+      g = nesterov ? g + momentum * x[2] : x[2];
+    }
+    x[0] -= lr * g;
+  }
+};
+
+const float* optional_float_ptr(const Tensor& t) {
+  return t.defined() ? t.data_ptr<float>() : nullptr;
+}
+
+} // namespace
+
+void fused_adam_kernel_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad,
+    bool decoupled_weight_decay,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  check_fused_adam_args(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs, amsgrad, inv_scale, found_inf);
+
+  bool fast_route = amsgrad
+      ? can_use_fast_route({params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs})
+      : can_use_fast_route({params, grads, exp_avgs, exp_avg_sqs});
+  if (!fast_route || !at::isFloatingType(params[0].scalar_type())) {
+    return fused_adam_fallback_(
+        params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs, step, lr, beta1, beta2,
+        weight_decay, eps, amsgrad, decoupled_weight_decay, inv_scale, found_inf);
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(params.vec());
+  tensor_lists.emplace_back(grads.vec());
+  tensor_lists.emplace_back(exp_avgs.vec());
+  tensor_lists.emplace_back(exp_avg_sqs.vec());
+  if (amsgrad) {
+    tensor_lists.emplace_back(max_exp_avg_sqs.vec());
+  }
+
+  const auto bias_correction1 = 1 - std::pow(beta1, step);
+  const auto bias_correction2 = 1 - std::pow(beta2, step);
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, params[0].scalar_type(), "fused_adam_kernel_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    AdamOp<opmath_t> op{
+        static_cast<opmath_t>(lr),
+        static_cast<opmath_t>(beta1),
+        static_cast<opmath_t>(beta2),
+        static_cast<opmath_t>(weight_decay),
+        static_cast<opmath_t>(eps),
+        static_cast<opmath_t>(lr / bias_correction1),
+        static_cast<opmath_t>(std::sqrt(bias_correction2)),
+        amsgrad,
+        decoupled_weight_decay,
+        optional_float_ptr(inv_scale),
+        optional_float_ptr(found_inf)};
+    if (amsgrad) {
+      multi_tensor_apply<5>(tensor_lists, FusedOptimizerFunctor<scalar_t, 5>(), op);
+    } else {
+      multi_tensor_apply<4>(tensor_lists, FusedOptimizerFunctor<scalar_t, 4>(), op);
+    }
+  });
+}
+
+void fused_sgd_kernel_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov,
+    bool is_first_step,
+    const Tensor& inv_scale,
+    const Tensor& found_inf) {
+  check_fused_sgd_args(params, grads, momentum_buffers, momentum, inv_scale, found_inf);
+
+  bool fast_route = momentum != 0
+      ? can_use_fast_route({params, grads, momentum_buffers})
+      : can_use_fast_route({params, grads});
+  if (!fast_route || !at::isFloatingType(params[0].scalar_type())) {
+    return fused_sgd_fallback_(
+        params, grads, momentum_buffers, lr, momentum, dampening, weight_decay,
+        nesterov, is_first_step, inv_scale, found_inf);
+  }
+
+  std::vector<std::vector<at::Tensor>> tensor_lists;
+  tensor_lists.emplace_back(params.vec());
+  tensor_lists.emplace_back(grads.vec());
+  if (momentum != 0) {
+    tensor_lists.emplace_back(momentum_buffers.vec());
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(kBFloat16, kHalf, params[0].scalar_type(), "fused_sgd_kernel_cuda_", [&]() {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    SgdOp<opmath_t> op{
+        static_cast<opmath_t>(lr),
+        static_cast<opmath_t>(momentum),
+        static_cast<opmath_t>(dampening),
+        static_cast<opmath_t>(weight_decay),
+        nesterov,
+        is_first_step,
+        optional_float_ptr(inv_scale),
+        optional_float_ptr(found_inf)};
+    if (momentum != 0) {
+      multi_tensor_apply<3>(tensor_lists, FusedOptimizerFunctor<scalar_t, 3>(), op);
+    } else {
+      multi_tensor_apply<2>(tensor_lists, FusedOptimizerFunctor<scalar_t, 2>(), op);
+    }
+  });
+}
+
+}} // namespace at::native
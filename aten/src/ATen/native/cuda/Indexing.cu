@@ -1,5 +1,6 @@
 #include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/native/IndexingUtils.h>
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
@@ -425,8 +426,6 @@ bool indexShouldBeMajor(cuda::detail::TensorInfo<scalar_t, unsigned int> &info,
 }
 
 Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
-  // Nondeterministic because of atomicAdd usage
-  globalContext().alertNotDeterministic("index_add_cuda_");
   dim = maybe_wrap_dim(dim, self.dim());
 
   TensorArg self_arg{self, "self", 1}, index_arg{index, "index", 3}, source_arg{source, "source", 4};
@@ -462,6 +461,18 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   if (sliceSize == 0) {
     return self;
   }
+  if (globalContext().deterministic() && embedding_segment_sum_supports(self.scalar_type())) {
+    // Sums the slices of source with the same index in a fixed order, with
+    // dim moved first so that every slice is a row.
+    auto self_rows = self_.transpose(0, dim);
+    auto sums = embedding_segment_sum_cuda(
+        source_.transpose(0, dim).reshape({numIndex, sliceSize}),
+        index.reshape(-1), selfAddDimSize);
+    self_rows.add_(sums.view(self_rows.sizes()));
+    return self;
+  }
+  // Nondeterministic because of atomicAdd usage
+  globalContext().alertNotDeterministic("index_add_cuda_");
   const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
   bool indContig = index.is_contiguous();
 
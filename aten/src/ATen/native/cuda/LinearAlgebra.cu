@@ -52,7 +52,30 @@ Tensor prepare_matrix_for_cublas(Tensor& tensor, bool& transpose_tensor) {
 
 namespace {
 
-Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha) {
+enum class Activation {
+  None,
+  RELU,
+  GELU,
+};
+
+#ifdef AT_CUDA_BLASLT_ENABLED
+// Whether result = beta * self + alpha * mat1 @ mat2 can add self in the
+// epilogue of a cublasLt GEMM: self must be a contiguous bias of one value
+// per column of the result, added as is. cublasLt does not handle every
+// degenerate shape, so those stay on the regular path.
+bool use_cublaslt_bias_epilogue(const Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta) {
+  const auto scalar_type = self.scalar_type();
+  return &result != &self && beta.to<double>() == 1.0 && self.dim() == 1 &&
+      self.is_contiguous() && self.size(0) == mat2.size(1) &&
+      mat1.size(0) > 1 && mat1.size(1) > 1 && mat2.size(1) > 1 &&
+      (scalar_type == at::ScalarType::Double ||
+       scalar_type == at::ScalarType::Float ||
+       scalar_type == at::ScalarType::Half) &&
+      mat1.scalar_type() == scalar_type && mat2.scalar_type() == scalar_type;
+}
+#endif
+
+Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta, Scalar alpha, Activation activation = Activation::None) {
   TORCH_CHECK(mat1.dim() == 2 && mat2.dim() == 2, "tensors must be 2-D");
 
   Tensor self_;
@@ -69,9 +92,14 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
   TORCH_CHECK(self__sizes[0] == mat1_sizes[0], "self_ dim 0 must match mat1 dim 0");
   TORCH_CHECK(self__sizes[1] == mat2_sizes[1], "self_ dim 1 must match mat2 dim 1");
 
+  bool use_bias_epilogue = false;
   if (&result != &self) {
     at::native::resize_as_(result, self_);
-    if (beta.to<double>() != 0.0) {
+#ifdef AT_CUDA_BLASLT_ENABLED
+    use_bias_epilogue = result.is_contiguous() &&
+        use_cublaslt_bias_epilogue(result, self, mat1, mat2, beta);
+#endif
+    if (beta.to<double>() != 0.0 && !use_bias_epilogue) {
       at::native::copy_(result, self_);
     }
   }
@@ -107,6 +135,34 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
   int64_t result_ld = result_.stride(transpose_result ? 0 : 1);
   at::ScalarType scalar_type = self_.scalar_type();
 
+#ifdef AT_CUDA_BLASLT_ENABLED
+  if (use_bias_epilogue) {
+    // The result is row-major, so cublas computes its transpose and the bias
+    // holds one value per row of that.
+    TORCH_INTERNAL_ASSERT(transpose_result && result_.is_same(result));
+    AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Half, scalar_type, "addmm_cuda_lt", [&] {
+      at::cuda::blas::gemm_and_bias<scalar_t>(
+        transpose_mat1,
+        transpose_mat2,
+        m, n, k,
+        alpha.to<at::acc_type<scalar_t, true>>(),
+        mat1_.data_ptr<scalar_t>(), mat1_ld,
+        mat2_.data_ptr<scalar_t>(), mat2_ld,
+        self.data_ptr<scalar_t>(),
+        result_.data_ptr<scalar_t>(), result_ld,
+        activation == Activation::RELU
+            ? at::cuda::blas::GEMMAndBiasActivationEpilogue::RELU
+            : at::cuda::blas::GEMMAndBiasActivationEpilogue::None);
+    });
+    // cublasLt only provides the tanh approximation of gelu, while at::gelu
+    // is exact.
+    if (activation == Activation::GELU) {
+      at::gelu_out(result, result);
+    }
+    return result;
+  }
+#endif
+
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, scalar_type, "addmm_cuda", [&] {
     scalar_t alpha_val = alpha.to<scalar_t>();
     scalar_t beta_val = beta.to<scalar_t>();
@@ -127,6 +183,16 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
   if (result.data_ptr() != result_.data_ptr()) {
     result.copy_(result_);
   }
+  switch (activation) {
+    case Activation::RELU:
+      at::relu_(result);
+      break;
+    case Activation::GELU:
+      at::gelu_out(result, result);
+      break;
+    default:
+      break;
+  }
   return result;
 }
 
@@ -166,6 +232,26 @@ Tensor& addmm__cuda(Tensor& self, const Tensor& mat1, const Tensor& mat2,
   return self;
 }
 
+Tensor& addmm_activation_out_cuda(Tensor& out, const Tensor& self,
+                                  const Tensor& mat1, const Tensor& mat2,
+                                  Scalar beta, Scalar alpha, bool use_gelu) {
+  {
+    at::NoNamesGuard guard;
+    addmm_out_cuda_impl(out, self, mat1, mat2, beta, alpha,
+                        use_gelu ? Activation::GELU : Activation::RELU);
+  }
+  at::namedinference::propagate_names_for_addmm(out, mat1, mat2, self);
+  return out;
+}
+
+Tensor addmm_activation_cuda(const Tensor& self, const Tensor& mat1,
+                             const Tensor& mat2, Scalar beta, Scalar alpha,
+                             bool use_gelu) {
+  Tensor out = at::empty({0}, self.options());
+  addmm_activation_out_cuda(out, self, mat1, mat2, beta, alpha, use_gelu);
+  return out;
+}
+
 template<typename scalar_t>
 void addr_impl_ger_cuda(Tensor &out, const Tensor &self,
                         const Tensor& vec1, const Tensor& vec2,
@@ -13,6 +13,7 @@
 #include <c10/macros/Macros.h>
 
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <ATen/Dispatch.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 
@@ -56,13 +57,16 @@ __device__ static inline int64_t get_target_prime(
 // target in parallel, even if it means more frequent __syncthreads.
 // In contrast to the cuDNN implementation, we allow large target lengths. For this we need that all previous `s` have been
 // computed when we start a new block_s. This is why we have our own for loop here.
-template<typename scalar_t, typename target_t>
+// When the augmented target fits in a single block_s (the common case), the row of the previous timestep is kept in
+// (double buffered) shared memory rather than being read back from log_alpha in global memory.
+// scalar_t is the type of the computation and of log_alpha, input_t the one of log_probs (e.g. half for float).
+template<typename scalar_t, typename target_t, typename input_t>
 __global__ void
 #if defined (__HIP_PLATFORM_HCC__)
 C10_LAUNCH_BOUNDS_2((std::is_same<scalar_t, float>::value ? 1024 : 896), 1)
 #endif
 ctc_loss_log_alpha_gpu_kernel(scalar_t* __restrict__ log_alpha_data,
-                                    const scalar_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
+                                    const input_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
                                     const target_t* __restrict__ targets_data, const int64_t* __restrict__ target_lengths, int64_t max_target_length,
                                     scalar_t* __restrict__ neg_log_likelihood_data,
                                     int64_t lp_input_stride, int64_t lp_batch_stride, int64_t lp_char_stride,
@@ -83,6 +87,10 @@ ctc_loss_log_alpha_gpu_kernel(scalar_t* __restrict__ log_alpha_data,
   if (b >= batch_size)
     return;
 
+  extern __shared__ char ctc_shared_mem[];
+  const bool use_shared_rows = 2*max_target_length+1 <= blockDim.x;
+  scalar_t* rows = reinterpret_cast<scalar_t*>(ctc_shared_mem) + 2 * blockDim.x * threadIdx.y;
+
   // first row (t=0), the three equations for alpha_1 above eq (6)
   for (int64_t block_s = 0; block_s < 2*max_target_length+1; block_s += blockDim.x) {
     int64_t s = threadIdx.x + block_s;
@@ -135,23 +143,32 @@ ctc_loss_log_alpha_gpu_kernel(scalar_t* __restrict__ log_alpha_data,
       current_char = BLANK;
       have_three = false;
     }
+    if (use_shared_rows) {
+      // this thread wrote the first row above
+      rows[s] = (s < 2*max_target_length+1) ? log_alpha_data[la_batch_offset + la_target_stride * s] : neginf;
+    }
     for (int64_t t=1; t < max_input_length; t++) {
       __syncthreads(); // on cuda 9 we might use partial synchronization of only the threads within the same batch
+      const scalar_t* prev_row = rows + ((t-1) & 1) * blockDim.x;
+      scalar_t* row = rows + (t & 1) * blockDim.x;
       if ((t < input_length) && (s < 2 * target_length + 1)) {
         // only for valid t, s. This is equation (6) and (7), la1, la2, la3 are the three summands,
         // lamax is the maximum for the logsumexp trick.
-        scalar_t la1 = log_alpha_data[la_batch_offset + la_input_stride * (t-1) + la_target_stride * s];
+        scalar_t la1 = use_shared_rows ? prev_row[s]
+                                       : log_alpha_data[la_batch_offset + la_input_stride * (t-1) + la_target_stride * s];
         scalar_t lamax = la1;
         scalar_t la2, la3;
         if (s > 0) {
-          la2 = log_alpha_data[la_batch_offset + la_input_stride * (t-1) + la_target_stride * (s-1)];
+          la2 = use_shared_rows ? prev_row[s-1]
+                                : log_alpha_data[la_batch_offset + la_input_stride * (t-1) + la_target_stride * (s-1)];
           if (la2 > lamax)
             lamax = la2;
         } else {
           la2 = neginf;
         }
         if (have_three) {
-          la3 = log_alpha_data[la_batch_offset + la_input_stride * (t-1) + la_target_stride * (s-2)];
+          la3 = use_shared_rows ? prev_row[s-2]
+                                : log_alpha_data[la_batch_offset + la_input_stride * (t-1) + la_target_stride * (s-2)];
           if (la3 > lamax)
             lamax = la3;
         } else {
@@ -160,12 +177,17 @@ ctc_loss_log_alpha_gpu_kernel(scalar_t* __restrict__ log_alpha_data,
         if (lamax == neginf) // when all are neginf. (then the whole thing is neginf, but we can pretend)
           lamax = 0;
 
-        log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * s] = std::log(std::exp(la1-lamax)+std::exp(la2-lamax)+std::exp(la3-lamax))+lamax
-          + log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * current_char];
+        scalar_t la = std::log(std::exp(la1-lamax)+std::exp(la2-lamax)+std::exp(la3-lamax))+lamax
+          + static_cast<scalar_t>(log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * current_char]);
+        log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * s] = la;
+        if (use_shared_rows)
+          row[s] = la;
       } else {
         // otherwise we just set to neginf
         if (s < 2*max_target_length+1)
           log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * s] = neginf;
+        if (use_shared_rows)
+          row[s] = neginf;
       }
     }
   }
@@ -195,7 +217,9 @@ ctc_loss_log_alpha_gpu_kernel(scalar_t* __restrict__ log_alpha_data,
 // to figure out where they begin).
 // We return log_alpha (currently, might change to (log_alpha+log_beta) to be passed to the
 // backward. The dispatch function will only return the loss.
-template<typename scalar_t, ScalarType target_scalar_type>
+// log_probs may be half, in which case the computation and log_alpha are in float (scalar_t), and only
+// the loss is returned as half.
+template<typename scalar_t, typename input_t, ScalarType target_scalar_type>
 std::tuple<Tensor, Tensor> ctc_loss_gpu_template(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK) {
   // log_probs: input_len x batch_size x num_labels
   // targets [int64]: batch_size x target_length OR sum(target_lengths)
@@ -258,8 +282,9 @@ std::tuple<Tensor, Tensor> ctc_loss_gpu_template(const Tensor& log_probs, const
   auto input_lengths_t = at::tensor(input_lengths, targets.options().dtype(kLong));
   tg_batch_offsets = tg_batch_offsets.cuda();
 
-  Tensor log_alpha = at::empty({batch_size, log_probs.size(0), 2*max_target_length+1}, log_probs.options());
-  Tensor neg_log_likelihood = at::empty({batch_size}, log_probs.options());
+  auto options = log_probs.options().dtype(c10::CppTypeToScalarType<scalar_t>::value);
+  Tensor log_alpha = at::empty({batch_size, log_probs.size(0), 2*max_target_length+1}, options);
+  Tensor neg_log_likelihood = at::empty({batch_size}, options);
 
   // Very likely, we could be more clever here, e.g. learning (or genralizing and reusing) from SoftMax.cu...
   constexpr int max_threads = std::is_same<scalar_t, float>::value ? 1024 : 896; // we need 72 or so 32 bit registers for double
@@ -270,11 +295,13 @@ std::tuple<Tensor, Tensor> ctc_loss_gpu_template(const Tensor& log_probs, const
   int threads_batch = std::min(max_threads / threads_target, (int) batch_size);
   dim3 block(threads_target, threads_batch);
   dim3 grid((2*max_target_length+1 + threads_target-1)/threads_target, (batch_size+threads_batch-1)/threads_batch);
+  // two rows per batch item, see the kernel
+  size_t shared_mem = threads_target >= 2*max_target_length+1 ? 2 * threads_target * threads_batch * sizeof(scalar_t) : 0;
   cudaStream_t stream = at::cuda::getCurrentCUDAStream();
 
-  ctc_loss_log_alpha_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>(
+  ctc_loss_log_alpha_gpu_kernel<scalar_t, target_t, input_t><<<grid, block, shared_mem, stream>>>(
                       log_alpha.data_ptr<scalar_t>(),
-                      log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+                      log_probs.data_ptr<input_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
                       targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
                       neg_log_likelihood.data_ptr<scalar_t>(),
                       log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
@@ -282,16 +309,17 @@ std::tuple<Tensor, Tensor> ctc_loss_gpu_template(const Tensor& log_probs, const
                       tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
                       batch_size, BLANK);
   AT_CUDA_CHECK(cudaGetLastError()); // catch launch errors
-  return std::make_tuple(neg_log_likelihood, log_alpha);
+  return std::make_tuple(neg_log_likelihood.to(log_probs.scalar_type()), log_alpha);
 }
 
 // The second (backward) half of the forward backward algorithm, (10) and (11). This is parallel to the
 // alpha kernel above. (As mentioned above, it might make sense do the calculation in the alpha kernel.)
-template<typename scalar_t, typename target_t>
+// It also keeps the row of the next timestep in shared memory when the augmented target fits in one block_s.
+template<typename scalar_t, typename target_t, typename input_t>
 __global__ void
 C10_LAUNCH_BOUNDS_2((std::is_same<scalar_t, float>::value ? 1024 : 896), 1)
 ctc_loss_backward_log_beta_gpu_kernel(scalar_t* __restrict__ log_beta_data,
-                                      const scalar_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
+                                      const input_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
                                       const target_t* __restrict__ targets_data, const int64_t* __restrict__ target_lengths, int64_t max_target_length,
                                       int64_t lp_input_stride, int64_t lp_batch_stride, int64_t lp_char_stride,
                                       int64_t lb_batch_stride, int64_t lb_input_stride, int64_t lb_target_stride,
@@ -310,6 +338,10 @@ ctc_loss_backward_log_beta_gpu_kernel(scalar_t* __restrict__ log_beta_data,
   if (b >= batch_size)
     return;
 
+  extern __shared__ char ctc_shared_mem[];
+  const bool use_shared_rows = 2*max_target_length+1 <= blockDim.x;
+  scalar_t* rows = reinterpret_cast<scalar_t*>(ctc_shared_mem) + 2 * blockDim.x * threadIdx.y;
+
   // "first" row, the beta initiaization before eq (10) (t=target_length - differes per batch)
   for (int64_t block_s = 2*max_target_length - (2*max_target_length % blockDim.x); block_s >= 0; block_s -= blockDim.x) {
     int64_t s = threadIdx.x + block_s;
@@ -356,23 +388,34 @@ ctc_loss_backward_log_beta_gpu_kernel(scalar_t* __restrict__ log_beta_data,
       current_target_prime = BLANK;
       have_three = false;
     }
+    if (use_shared_rows && max_input_length > 1) {
+      // the last row was either written by this thread above or filled with neginf
+      rows[((max_input_length-1) & 1) * blockDim.x + s] = (s < 2*max_target_length+1)
+          ? log_beta_data[lb_batch_offset + lb_input_stride * (max_input_length-1) + lb_target_stride * s]
+          : neginf;
+    }
     // now go backward in t. Note that we need to skip the last timestep that we did above.
     for (int64_t t=max_input_length-2; t>=0; t--) {
       __syncthreads(); // on cuda 9 we might use partial synchronization of only the threads within the same batch item
+      const scalar_t* next_row = rows + ((t+1) & 1) * blockDim.x;
+      scalar_t* row = rows + (t & 1) * blockDim.x;
       if ((t < input_length - 1) && (s < 2 * target_length + 1)) {
-        scalar_t lb1 = log_beta_data[lb_batch_offset + lb_input_stride * (t+1) + lb_target_stride * s];
+        scalar_t lb1 = use_shared_rows ? next_row[s]
+                                       : log_beta_data[lb_batch_offset + lb_input_stride * (t+1) + lb_target_stride * s];
         scalar_t lbmax = lb1;
         scalar_t lb2, lb3;
 
         if (s < 2*target_length) {
-          lb2 = log_beta_data[lb_batch_offset + lb_input_stride * (t+1) + lb_target_stride * (s+1)];
+          lb2 = use_shared_rows ? next_row[s+1]
+                                : log_beta_data[lb_batch_offset + lb_input_stride * (t+1) + lb_target_stride * (s+1)];
           if (lb2 > lbmax)
             lbmax = lb2;
         } else {
           lb2 = neginf;
         }
         if (have_three) {
-          lb3 = log_beta_data[lb_batch_offset + lb_input_stride * (t+1) + lb_target_stride * (s+2)];
+          lb3 = use_shared_rows ? next_row[s+2]
+                                : log_beta_data[lb_batch_offset + lb_input_stride * (t+1) + lb_target_stride * (s+2)];
           if (lb3 > lbmax)
             lbmax = lb3;
         } else {
@@ -382,16 +425,26 @@ ctc_loss_backward_log_beta_gpu_kernel(scalar_t* __restrict__ log_beta_data,
           lbmax = 0;
 
         scalar_t lb = std::log(std::exp(lb1-lbmax)+std::exp(lb2-lbmax)+std::exp(lb3-lbmax))+lbmax
-          + log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * current_target_prime];
+          + static_cast<scalar_t>(log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * current_target_prime]);
 
         log_beta_data[lb_batch_offset + lb_input_stride * t + lb_target_stride * s] = lb;
-      } else if (
+        if (use_shared_rows)
+          row[s] = lb;
+      } else {
+        if (
           (s < 2 * max_target_length + 1) &&
           (((target_length == 0) && (s > 0)) || (s >= 2 * target_length + 1) ||
            (t >= input_length))) {
-        log_beta_data
-            [lb_batch_offset + lb_input_stride * t + lb_target_stride * s] =
-                neginf;
+          log_beta_data
+              [lb_batch_offset + lb_input_stride * t + lb_target_stride * s] =
+                  neginf;
+        }
+        if (use_shared_rows) {
+          // the first row of this batch item, neginf or what was just written
+          row[s] = (s < 2*max_target_length+1)
+              ? log_beta_data[lb_batch_offset + lb_input_stride * t + lb_target_stride * s]
+              : neginf;
+        }
       }
     }
   }
@@ -412,7 +465,7 @@ ctc_loss_backward_log_beta_gpu_kernel(scalar_t* __restrict__ log_beta_data,
 // I took this trick from [2], for moderate alphabet sizes a log-space
 // calculation (with an atomic log add) is similarly in performance, but for large
 // alphabets the inplace nature is a considerable advantage.
-template<typename scalar_t, typename target_t>
+template<typename scalar_t, typename target_t, typename input_t>
 __global__ void
 #if defined (__HIP_PLATFORM_HCC__)
 C10_LAUNCH_BOUNDS_2((std::is_same<scalar_t, float>::value ? 1024 : 896), 1)
@@ -420,7 +473,7 @@ C10_LAUNCH_BOUNDS_2((std::is_same<scalar_t, float>::value ? 1024 : 896), 1)
 ctc_loss_backward_collect_nonblank_gpu_kernel(scalar_t* __restrict__ gradient_data,
                                                      const scalar_t* __restrict__ grad_out_data, int64_t grad_out_batch_stride,
                                                      const scalar_t* __restrict__ log_alpha_data, const scalar_t* __restrict__ log_beta_data,
-                                                     const scalar_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
+                                                     const input_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
                                                      const target_t* __restrict__ targets_data, const int64_t* __restrict__ target_lengths, int64_t max_target_length,
                                                      const scalar_t* __restrict__ neg_log_likelihood_data,
                                                      int64_t gr_input_stride, int64_t gr_batch_stride, int64_t gr_char_stride,
@@ -454,7 +507,7 @@ ctc_loss_backward_collect_nonblank_gpu_kernel(scalar_t* __restrict__ gradient_da
     return;
 
   for (int64_t t = 0; t < input_length; t++) {
-    scalar_t lp = log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * target];
+    scalar_t lp = static_cast<scalar_t>(log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * target]);
     gpuAtomicAdd(&gradient_data[gr_batch_offset + t * gr_input_stride + gr_char_stride * target],
               -std::exp(log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * (s*2+1)]
                         + log_beta_data[lb_batch_offset + lb_input_stride * t + lb_target_stride * (s*2+1)]
@@ -464,7 +517,7 @@ ctc_loss_backward_collect_nonblank_gpu_kernel(scalar_t* __restrict__ gradient_da
 
 // This is the naive implementation of equation (16). It is parallelised in batch and input timestep.
 // It appears to be faster than the above method for small batch sizes.
-template<typename scalar_t, typename target_t>
+template<typename scalar_t, typename target_t, typename input_t>
 __global__ void
 #if defined (__HIP_PLATFORM_HCC__)
 C10_LAUNCH_BOUNDS_2((std::is_same<scalar_t, float>::value ? 1024 : 896), 1)
@@ -472,7 +525,7 @@ C10_LAUNCH_BOUNDS_2((std::is_same<scalar_t, float>::value ? 1024 : 896), 1)
 ctc_loss_backward_collect_gpu_kernel(scalar_t* __restrict__ gradient_data,
                                                      const scalar_t* __restrict__ grad_out_data, int64_t grad_out_batch_stride,
                                                      const scalar_t* __restrict__ log_alpha_data, const scalar_t* __restrict__ log_beta_data,
-                                                     const scalar_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
+                                                     const input_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
                                                      const target_t* __restrict__ targets_data, const int64_t* __restrict__ target_lengths, int64_t max_target_length,
                                                      const scalar_t* __restrict__ neg_log_likelihood_data,
                                                      int64_t gr_input_stride, int64_t gr_batch_stride, int64_t gr_char_stride,
@@ -524,7 +577,7 @@ ctc_loss_backward_collect_gpu_kernel(scalar_t* __restrict__ gradient_data,
   for (int64_t c = 0; c < num_labels; c++) {
     scalar_t& res = gradient_data[gr_batch_offset + t * gr_input_stride + gr_char_stride * c];
     if (t < input_length && (! zero_infinity || nll != INFINITY)) {
-      scalar_t lp = log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * c];
+      scalar_t lp = static_cast<scalar_t>(log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * c]);
       res = (std::exp(lp)-std::exp(res + nll - lp)) * gr;
     }
     else {
@@ -567,12 +620,38 @@ ctc_loss_zero_padded_gradients(
   }
 
 
+// Recovers the negative log likelihood (eq (8)) from log_alpha. For half log_probs, the loss returned by the
+// forward is rounded too coarsely to normalize the gradient with.
+Tensor ctc_loss_neg_log_likelihood_from_alpha(const Tensor& log_alpha, IntArrayRef input_lengths, IntArrayRef target_lengths) {
+  int64_t batch_size = log_alpha.size(0);
+  int64_t alpha_row_size = log_alpha.size(2);
+  auto index = at::empty({batch_size, 2}, at::kLong);
+  auto valid = at::empty({batch_size, 2}, at::kBool);
+  auto index_data = index.data_ptr<int64_t>();
+  auto valid_data = valid.data_ptr<bool>();
+  for (int64_t b = 0; b < batch_size; b++) {
+    int64_t t = std::max<int64_t>(input_lengths[b] - 1, 0);
+    index_data[2 * b] = t * alpha_row_size + 2 * target_lengths[b];
+    index_data[2 * b + 1] = t * alpha_row_size + std::max<int64_t>(2 * target_lengths[b] - 1, 0);
+    valid_data[2 * b] = true;
+    valid_data[2 * b + 1] = target_lengths[b] > 0;
+  }
+  auto ends = log_alpha.reshape({batch_size, -1}).gather(1, index.to(log_alpha.device()));
+  ends.masked_fill_(valid.to(log_alpha.device()).logical_not(), -INFINITY);
+  return at::logsumexp(ends, 1).neg_();
+}
+
 // The backward. It essentially computes eq 16 by using the above kernels.
 // We don't do a lot of checking as we envision this to be called only when backpropagating through a (well-checked) forward.
-template<typename scalar_t, ScalarType target_scalar_type>
-Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
-                                      const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
+template<typename scalar_t, typename input_t, ScalarType target_scalar_type>
+Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out_, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
+                                      const Tensor& neg_log_likelihood_, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
   constexpr scalar_t neginf = -INFINITY;
+  constexpr bool is_reduced_input = !std::is_same<scalar_t, input_t>::value;
+  auto grad_out = grad_out_.to(log_alpha.scalar_type());
+  auto neg_log_likelihood = is_reduced_input
+      ? ctc_loss_neg_log_likelihood_from_alpha(log_alpha, input_lengths, target_lengths)
+      : neg_log_likelihood_;
   using target_t = typename std::conditional<target_scalar_type == kInt, int, int64_t>::type;
   int64_t batch_size = log_probs.size(1);
   int64_t num_labels = log_probs.size(2);
@@ -610,7 +689,7 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
   Tensor log_beta = at::empty_like(log_alpha, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   log_beta.fill_(neginf);
 
-  Tensor grad = at::full_like(log_probs, neginf, LEGACY_CONTIGUOUS_MEMORY_FORMAT); // initialization for log(sum (alpha beta))
+  Tensor grad = at::full(log_probs.sizes(), neginf, log_alpha.options()); // initialization for log(sum (alpha beta))
 
   // As above, there may be better configurations to use.
   constexpr int max_threads = std::is_same<scalar_t, float>::value ? 1024 : 896; // we need 72 or so 32 bit registers for double
@@ -625,9 +704,10 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
   {
     dim3 block(threads_target, threads_batch);
     dim3 grid((2*max_target_length+1 + threads_target-1)/threads_target, (batch_size+threads_batch-1)/threads_batch);
-    ctc_loss_backward_log_beta_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>
+    size_t shared_mem = threads_target >= 2*max_target_length+1 ? 2 * threads_target * threads_batch * sizeof(scalar_t) : 0;
+    ctc_loss_backward_log_beta_gpu_kernel<scalar_t, target_t, input_t><<<grid, block, shared_mem, stream>>>
       (log_beta.data_ptr<scalar_t>(),
-       log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+       log_probs.data_ptr<input_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
        log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
        log_beta.stride(0), log_beta.stride(1), log_beta.stride(2),
@@ -643,7 +723,11 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
   bool is_large = (2*log_probs.size(0)+(24*batch_size)/10+(2*num_labels)/10) > 450;
   if (is_large) { // large alphabet, large batch
     // this computes the probs, minuend in (16)
-    at::exp_out(grad, log_probs);
+    if (is_reduced_input) {
+      grad.copy_(log_probs).exp_();
+    } else {
+      at::exp_out(grad, log_probs);
+    }
     // now we compute the subtrahend for the blanks. It is a straightforward reduction because we know that
     // blanks are in every other position.
     // maybe we should kernelize this, too.
@@ -677,11 +761,11 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
             (max_target_length + threads_target - 1) / threads_target, 1),
         (batch_size + threads_batch - 1) / threads_batch,
         1);
-    ctc_loss_backward_collect_nonblank_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>
+    ctc_loss_backward_collect_nonblank_gpu_kernel<scalar_t, target_t, input_t><<<grid, block, 0, stream>>>
       (grad.data_ptr<scalar_t>(),
        grad_out.data_ptr<scalar_t>(), grad_out.stride(0),
        log_alpha.data_ptr<scalar_t>(), log_beta.data_ptr<scalar_t>(),
-       log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+       log_probs.data_ptr<input_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
        neg_log_likelihood.data_ptr<scalar_t>(),
        grad.stride(0), grad.stride(1), grad.stride(2),
@@ -700,11 +784,11 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
     threads_batch = std::min(max_threads / threads_input, (int) batch_size);
     dim3 block(threads_input, threads_batch);
     dim3 grid((log_probs.size(0) + threads_input-1)/threads_input, (batch_size+threads_batch-1)/threads_batch);
-    ctc_loss_backward_collect_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>
+    ctc_loss_backward_collect_gpu_kernel<scalar_t, target_t, input_t><<<grid, block, 0, stream>>>
       (grad.data_ptr<scalar_t>(),
        grad_out.data_ptr<scalar_t>(), grad_out.stride(0),
        log_alpha.data_ptr<scalar_t>(), log_beta.data_ptr<scalar_t>(),
-       log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+       log_probs.data_ptr<input_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
        neg_log_likelihood.data_ptr<scalar_t>(),
        grad.stride(0), grad.stride(1), grad.stride(2),
@@ -740,18 +824,19 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
     AT_CUDA_CHECK(cudaGetLastError());
   }
 
-  return grad;
+  return grad.to(log_probs.scalar_type());
 }
 
 } // namespace
 
 std::tuple<Tensor, Tensor> ctc_loss_gpu(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK, bool zero_infinity) {
   (void)zero_infinity; // only used for backward
-  return AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cuda", [&] {
+  return AT_DISPATCH_FLOATING_TYPES_AND_HALF(log_probs.scalar_type(), "ctc_loss_cuda", [&] {
+      using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
       if (targets.scalar_type() == kLong) {
-        return ctc_loss_gpu_template<scalar_t, kLong>(log_probs, targets, input_lengths, target_lengths, BLANK);
+        return ctc_loss_gpu_template<accscalar_t, scalar_t, kLong>(log_probs, targets, input_lengths, target_lengths, BLANK);
       } else {
-        return ctc_loss_gpu_template<scalar_t, kInt>(log_probs, targets, input_lengths, target_lengths, BLANK);
+        return ctc_loss_gpu_template<accscalar_t, scalar_t, kInt>(log_probs, targets, input_lengths, target_lengths, BLANK);
       }
     });
 }
@@ -760,11 +845,12 @@ Tensor ctc_loss_backward_gpu(const Tensor& grad, const Tensor& log_probs, const
                              const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
   // Nondeterministic because of atomicAdd usage
   globalContext().alertNotDeterministic("ctc_loss_backward_gpu");
-  return AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cuda", [&] {
+  return AT_DISPATCH_FLOATING_TYPES_AND_HALF(log_probs.scalar_type(), "ctc_loss_backward_cuda", [&] {
+      using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
       if (targets.scalar_type() == kLong) {
-        return ctc_loss_backward_gpu_template<scalar_t, kLong>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+        return ctc_loss_backward_gpu_template<accscalar_t, scalar_t, kLong>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
       } else {
-        return ctc_loss_backward_gpu_template<scalar_t, kInt>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+        return ctc_loss_backward_gpu_template<accscalar_t, scalar_t, kInt>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
       }
     });
 }
@@ -65,6 +65,23 @@ struct vectorized_load_helper {
   }
 };
 
+template<int arg_index>
+struct broadcast_vectorized_load_helper {
+  template <typename args_t, typename policy_t>
+  static __device__ void apply(policy_t &self, args_t *args, int idx) {
+    using arg_t = std::tuple_element_t<arg_index, args_t>;
+    // `data` hold the data_ptr for tensors [output, input0, input1, ...], so we
+    // need a +1 offset to get the input
+    auto ptr = reinterpret_cast<arg_t *>(self.data[arg_index + 1]);
+    auto args_accessor = [&args] __device__ (int thread_unroll_idx) -> arg_t & { return std::get<arg_index>(args[thread_unroll_idx]); };
+    if (self.is_inner_broadcast(arg_index)) {
+      self.broadcast_single_arg(args_accessor, ptr);
+    } else {
+      self.load_single_arg(args_accessor, ptr + block_work_size * idx);
+    }
+  }
+};
+
 template<int arg_index>
 struct unroll_load_helper {
   template <typename args_t, typename policy_t, typename offset_t, typename loader_t>
@@ -259,6 +276,113 @@ struct vectorized {
   }
 };
 
+// Assumption:
+// `data` points to the start of one row of the iteration space, along which
+// the output is contiguous and every input is either contiguous or broadcast
+// (stride 0). See Note [Broadcast vectorized loops].
+// Note:
+// Unlike the vectorized policy, this policy handles the reminder of the row
+// itself, with scalar accesses. Vectorized accesses are only used when the
+// whole block is within the row.
+template <int vec_size, typename data_t>  // vec_size: number of scalars, can be 1, 2, or 4.
+struct broadcast_vectorized {
+
+  static_assert(thread_work_size % vec_size == 0, "The workload per thread must be a multiple of vec_size");
+  static constexpr int loop_size = thread_work_size / vec_size;
+
+  data_t data;
+  int remaining;
+  // bit i is set if input i is broadcast along the row
+  uint32_t inner_broadcast_mask;
+
+  __device__ broadcast_vectorized(data_t data, int remaining, uint32_t inner_broadcast_mask) :
+    data(data), remaining(remaining), inner_broadcast_mask(inner_broadcast_mask) {}
+
+  __device__ inline bool check_inbounds(int thread_work_elem) {
+    int index = (threadIdx.x + (thread_work_elem / vec_size) * num_threads) * vec_size + thread_work_elem % vec_size;
+    return index < remaining;
+  }
+
+  __device__ inline bool is_inner_broadcast(int arg) const {
+    return (inner_broadcast_mask >> arg) & 1;
+  }
+
+  // Broadcast inputs are read once and reused from registers.
+  template<typename accessor_t, typename scalar_t>
+  __device__ inline void broadcast_single_arg(accessor_t to, scalar_t *from) {
+    scalar_t v = *from;
+    #pragma unroll
+    for (int i = 0; i < thread_work_size; i++) {
+      to(i) = v;
+    }
+  }
+
+  template<typename accessor_t, typename scalar_t>
+  __device__ inline void load_single_arg(accessor_t to, scalar_t *from) {
+    using vec_t = aligned_vector<scalar_t, vec_size>;
+    int thread_idx = threadIdx.x;
+    if (remaining >= block_work_size) {
+      vec_t *from_ = reinterpret_cast<vec_t *>(from);
+      #pragma unroll
+      for (int i = 0; i < loop_size; i++) {
+        int index = thread_idx + i * num_threads;
+        vec_t v = from_[index];
+        #pragma unroll
+        for (int j = 0; j < vec_size; j++) {
+          to(vec_size * i + j) = v.val[j];
+        }
+      }
+    } else {
+      #pragma unroll
+      for (int i = 0; i < loop_size; i++) {
+        #pragma unroll
+        for (int j = 0; j < vec_size; j++) {
+          int index = (thread_idx + i * num_threads) * vec_size + j;
+          if (index < remaining) {
+            to(vec_size * i + j) = from[index];
+          }
+        }
+      }
+    }
+  }
+
+  template<typename args_t>
+  __device__ inline void load(args_t *args, int idx) {
+    constexpr int arity = std::tuple_size<args_t>::value;
+    detail::static_unroll<detail::broadcast_vectorized_load_helper, arity>::with_args(*this, args, idx);
+  }
+
+  template<typename scalar_t>
+  __device__ inline void store(scalar_t *from, int idx) {
+    using vec_t = aligned_vector<scalar_t, vec_size>;
+    scalar_t *to = reinterpret_cast<scalar_t *>(data[0]) + block_work_size * idx;
+    int thread_idx = threadIdx.x;
+    if (remaining >= block_work_size) {
+      vec_t *to_ = reinterpret_cast<vec_t *>(to);
+      #pragma unroll
+      for (int i = 0; i < loop_size; i++) {
+        int index = thread_idx + i * num_threads;
+        vec_t v;
+        for (int j = 0; j < vec_size; j++) {
+          v.val[j] = from[vec_size * i + j];
+        }
+        to_[index] = v;
+      }
+    } else {
+      #pragma unroll
+      for (int i = 0; i < loop_size; i++) {
+        #pragma unroll
+        for (int j = 0; j < vec_size; j++) {
+          int index = (thread_idx + i * num_threads) * vec_size + j;
+          if (index < remaining) {
+            to[index] = from[vec_size * i + j];
+          }
+        }
+      }
+    }
+  }
+};
+
 template <typename data_t, typename inp_calc_t, typename out_calc_t, int num_outputs>
 struct multi_outputs_unroll : unroll<data_t, inp_calc_t, out_calc_t, LoadWithoutCast, StoreWithoutCast, num_outputs> {
 
@@ -17,6 +17,9 @@ template<int n> struct TensorListMetadata
   int sizes[depth_to_max_tensors[n-1]];
   unsigned char block_to_tensor[depth_to_max_blocks[n-1]];
   int block_to_chunk[depth_to_max_blocks[n-1]];
+  // Index in the full tensor lists of the tensor at position 0 of this launch,
+  // for functors that write per-tensor results.
+  int start_tensor_this_launch;
 };
 
 template<typename T, typename U, typename... ArgTypes>
@@ -43,6 +46,7 @@ void multi_tensor_apply(
 
         int loc_block_info = 0;
         int loc_tensor_info = 0;
+        tensorListMeta.start_tensor_this_launch = 0;
         for(size_t t = 0; t < n_tensors; t++) {
             tensorListMeta.sizes[loc_tensor_info] = tensor_lists[0][t].numel();
             for (int d = 0; d < depth; d++) {
@@ -73,8 +77,10 @@ void multi_tensor_apply(
                     loc_block_info = 0;
                     if(chunk == chunks - 1) {
                         loc_tensor_info = 0; 
+                        tensorListMeta.start_tensor_this_launch = static_cast<int>(t + 1);
                     }
                     else {
+                        tensorListMeta.start_tensor_this_launch = static_cast<int>(t);
                         tensorListMeta.sizes[0] = tensorListMeta.sizes[loc_tensor_info-1];
                         for(int d = 0; d < depth; d++) {
                             tensorListMeta.addresses[d][0] = tensorListMeta.addresses[d][loc_tensor_info-1];
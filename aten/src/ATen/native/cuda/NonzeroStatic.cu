@@ -0,0 +1,174 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/core/Array.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <THC/THCThrustAllocator.cuh>
+
+#ifdef __HIP_PLATFORM_HCC__
+#include <thrust/execution_policy.h>
+#include <thrust/scan.h>
+#else
+#include <cub/device/device_scan.cuh>
+#endif
+
+#include <limits>
+
+// nonzero and masked_select with an output size given up front.
+//
+// The output positions are an inclusive prefix sum of the selection flags,
+// computed on the device, and a second kernel writes every selected element
+// whose position is below size. The count, the last prefix sum, stays on the
+// device too, so that nothing is copied to the host and the ops can be
+// enqueued ahead of the device, or captured in CUDA graphs.
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kStaticSelectBlockSize = 256;
+constexpr int kMaxStaticSelectDims = 25;
+
+// positions[i] = flags[0] + ... + flags[i]
+void inclusive_sum(const Tensor& flags, Tensor& positions) {
+  const int64_t n = flags.numel();
+  TORCH_CHECK(n <= std::numeric_limits<int>::max(),
+      "_nonzero_static and _masked_select_static support at most INT_MAX elements");
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const int64_t* in = flags.data_ptr<int64_t>();
+  int64_t* out = positions.data_ptr<int64_t>();
+#ifdef __HIP_PLATFORM_HCC__
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  thrust::inclusive_scan(
+      thrust::cuda::par(allocator).on(stream),
+      thrust::device_ptr<const int64_t>(in),
+      thrust::device_ptr<const int64_t>(in + n),
+      thrust::device_ptr<int64_t>(out));
+#else
+  size_t temp_storage_bytes = 0;
+  AT_CUDA_CHECK(cub::DeviceScan::InclusiveSum(
+      nullptr, temp_storage_bytes, in, out, static_cast<int>(n), stream));
+  auto temp_storage = at::empty(
+      {static_cast<int64_t>(temp_storage_bytes)}, flags.options().dtype(kByte));
+  AT_CUDA_CHECK(cub::DeviceScan::InclusiveSum(
+      temp_storage.data_ptr(), temp_storage_bytes, in, out, static_cast<int>(n), stream));
+#endif
+}
+
+// Returns the positions of the selected elements of the flattened flags,
+// and the count of them as a 0-dim tensor.
+std::tuple<Tensor, Tensor> selection_positions(const Tensor& selected) {
+  Tensor flags = selected.reshape(-1).to(kLong);
+  Tensor positions = at::empty_like(flags);
+  inclusive_sum(flags, positions);
+  return std::make_tuple(positions, positions[-1].clone());
+}
+
+dim3 static_select_grid(int64_t n) {
+  const auto* prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t max_blocks = static_cast<int64_t>(prop->multiProcessorCount) *
+      (prop->maxThreadsPerMultiProcessor / kStaticSelectBlockSize);
+  return dim3(std::min(max_blocks, (n + kStaticSelectBlockSize - 1) / kStaticSelectBlockSize));
+}
+
+__global__ void nonzero_static_kernel(
+    const int64_t* __restrict__ positions,
+    int64_t* __restrict__ out,
+    int64_t n,
+    int64_t size,
+    int ndim,
+    at::detail::Array<int64_t, kMaxStaticSelectDims> sizes) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < n;
+       i += gridDim.x * static_cast<int64_t>(blockDim.x)) {
+    const int64_t position = positions[i] - 1;
+    const bool selected = i == 0 ? positions[0] == 1 : positions[i] != positions[i - 1];
+    if (!selected || position >= size) {
+      continue;
+    }
+    int64_t linear = i;
+    for (int d = ndim - 1; d >= 0; d--) {
+      out[position * ndim + d] = linear % sizes[d];
+      linear /= sizes[d];
+    }
+  }
+}
+
+template <typename scalar_t>
+__global__ void masked_select_static_kernel(
+    const scalar_t* __restrict__ self,
+    const int64_t* __restrict__ positions,
+    scalar_t* __restrict__ out,
+    int64_t n,
+    int64_t size) {
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x; i < n;
+       i += gridDim.x * static_cast<int64_t>(blockDim.x)) {
+    const int64_t position = positions[i] - 1;
+    const bool selected = i == 0 ? positions[0] == 1 : positions[i] != positions[i - 1];
+    if (selected && position < size) {
+      out[position] = self[i];
+    }
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> _nonzero_static_cuda(const Tensor& self, int64_t size, int64_t fill_value) {
+  TORCH_CHECK(size >= 0, "_nonzero_static: expected a non-negative size, but got ", size);
+  TORCH_CHECK(self.dim() <= kMaxStaticSelectDims,
+      "_nonzero_static: expected at most ", kMaxStaticSelectDims, " dimensions, but got ", self.dim());
+  const auto long_options = self.options().dtype(kLong);
+  Tensor result = at::full({size, self.dim()}, fill_value, long_options);
+  const int64_t n = self.numel();
+  if (n == 0) {
+    return std::make_tuple(result, at::zeros({}, long_options));
+  }
+  Tensor positions, count;
+  std::tie(positions, count) = selection_positions(self != 0);
+  if (size == 0 || self.dim() == 0) {
+    return std::make_tuple(result, count);
+  }
+
+  at::detail::Array<int64_t, kMaxStaticSelectDims> sizes;
+  for (int64_t d = 0; d < self.dim(); d++) {
+    sizes[d] = self.size(d);
+  }
+  nonzero_static_kernel<<<static_select_grid(n), kStaticSelectBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+      positions.data_ptr<int64_t>(), result.data_ptr<int64_t>(), n, size,
+      static_cast<int>(self.dim()), sizes);
+  AT_CUDA_CHECK(cudaGetLastError());
+  return std::make_tuple(result, count);
+}
+
+std::tuple<Tensor, Tensor> _masked_select_static_cuda(const Tensor& self, const Tensor& mask, int64_t size) {
+  TORCH_CHECK(size >= 0, "_masked_select_static: expected a non-negative size, but got ", size);
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Byte || mask.scalar_type() == ScalarType::Bool,
+      "_masked_select_static: expected BoolTensor or ByteTensor for mask");
+  Tensor result = at::zeros({size}, self.options());
+  Tensor _mask, _self;
+  std::tie(_mask, _self) = expand_outplace(mask, self);
+  const int64_t n = _self.numel();
+  if (n == 0) {
+    return std::make_tuple(result, at::zeros({}, self.options().dtype(kLong)));
+  }
+  Tensor positions, count;
+  std::tie(positions, count) = selection_positions(_mask);
+  if (size == 0) {
+    return std::make_tuple(result, count);
+  }
+
+  const Tensor values = _self.contiguous();
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
+      self.scalar_type(), "_masked_select_static_cuda", [&] {
+        masked_select_static_kernel<scalar_t><<<static_select_grid(n), kStaticSelectBlockSize, 0, at::cuda::getCurrentCUDAStream()>>>(
+            values.data_ptr<scalar_t>(), positions.data_ptr<int64_t>(),
+            result.data_ptr<scalar_t>(), n, size);
+        AT_CUDA_CHECK(cudaGetLastError());
+      });
+  return std::make_tuple(result, count);
+}
+
+} // namespace native
+} // namespace at
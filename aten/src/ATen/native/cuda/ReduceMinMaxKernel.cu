@@ -49,6 +49,25 @@ void min_values_kernel_cuda(TensorIterator& iter) {
   }
 }
 
+template <typename scalar_t, typename acc_t=scalar_t>
+void min_max_kernel_cuda_impl(TensorIterator& iter) {
+  gpu_reduce_kernel<scalar_t, scalar_t>(
+    iter,
+    MinMaxOps<scalar_t, acc_t, thrust::pair<scalar_t, scalar_t>>{},
+    thrust::pair<acc_t, acc_t>(at::numeric_limits<acc_t>::upper_bound(), at::numeric_limits<acc_t>::lower_bound()));
+}
+
+// Computes both outputs of _min_max with a single read of the input.
+void min_max_kernel_cuda(TensorIterator& iter) {
+  if (iter.dtype(2) == kHalf) {
+    min_max_kernel_cuda_impl<at::Half, float>(iter);
+  } else {
+    AT_DISPATCH_ALL_TYPES(iter.dtype(2), "_min_max_cuda", [&]() {
+      min_max_kernel_cuda_impl<scalar_t>(iter);
+    });
+  }
+}
+
 template <typename scalar_t, typename acc_t=scalar_t>
 void argmax_kernel_cuda_impl(TensorIterator& iter) {
   gpu_reduce_kernel<scalar_t, int64_t>(
@@ -125,7 +144,13 @@ static void max_all_kernel_impl(Tensor& result, const Tensor& input) {
   });
 }
 
+static void _min_max_all_kernel_impl(Tensor& min_result, Tensor& max_result, const Tensor& input) {
+  auto iter = make_reduction("_min_max_all", min_result, max_result, input, std::vector<int64_t>{}, false, input.scalar_type());
+  min_max_kernel_cuda(iter);
+}
+
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_cuda);
+REGISTER_DISPATCH(min_max_stub, &min_max_kernel_cuda);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_cuda);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_cuda);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_cuda);
@@ -133,5 +158,6 @@ REGISTER_DISPATCH(min_stub, &min_kernel_impl);
 REGISTER_DISPATCH(max_stub, &max_kernel_impl);
 REGISTER_DISPATCH(min_all_stub, &min_all_kernel_impl);
 REGISTER_DISPATCH(max_all_stub, &max_all_kernel_impl);
+REGISTER_DISPATCH(_min_max_all_stub, &_min_max_all_kernel_impl);
 
 }} // namespace at::native
@@ -27,5 +27,25 @@ Tensor& resize_cuda_(
   }
   return self;
 }
+
+Tensor& resize_amortized_cuda_(Tensor& self, IntArrayRef size) {
+  if (self.has_names()) {
+    return resize_named_tensor_(self, size, c10::nullopt);
+  }
+  resize_impl_cuda_(
+      self.unsafeGetTensorImpl(),
+      size,
+      /*strides=*/c10::nullopt,
+      /*device_guard=*/true,
+      /*amortized=*/true);
+  return self;
+}
+
+Tensor& reserve_cuda_(Tensor& self, int64_t capacity) {
+  TORCH_CHECK(capacity >= 0, "reserve_: capacity must be non-negative, got ", capacity);
+  cuda::OptionalCUDAGuard guard(self.device());
+  maybe_resize_storage_cuda(self.unsafeGetTensorImpl(), capacity);
+  return self;
+}
 } // namespace native
 } // namespace at
@@ -11,7 +11,11 @@ namespace at { namespace native {
 // They are not in THC/THCTensor.cpp because the at namespace is easier
 // to benchmark than THC; I can't get gbenchmark to call fns from THTensor.cpp
 
-static inline void maybe_resize_storage_cuda(TensorImpl* self, int64_t new_size) {
+// See maybe_resize_storage_cpu for amortized
+static inline void maybe_resize_storage_cuda(
+    TensorImpl* self,
+    int64_t new_size,
+    bool amortized = false) {
   // It does not make sense to try to resize a storage
   // to hold 0 elements, and this can break
   // if storage_offset is positive but
@@ -23,6 +27,10 @@ static inline void maybe_resize_storage_cuda(TensorImpl* self, int64_t new_size)
     }
     uint64_t new_size_bytes = (new_size + self->storage_offset()) * self->dtype().itemsize();
     if (new_size_bytes > self->storage().nbytes()) {
+      if (amortized) {
+        new_size_bytes = std::max(
+            new_size_bytes, 2 * static_cast<uint64_t>(self->storage().nbytes()));
+      }
       THCStorage_resizeBytes(
           globalContext().getTHCState(),
           THTensor_getStoragePtr(self),
@@ -36,7 +44,8 @@ inline TensorImpl* resize_impl_cuda_(
     TensorImpl* self,
     IntArrayRef size,
     c10::optional<IntArrayRef> stride,
-    bool device_guard = true) {
+    bool device_guard = true,
+    bool amortized = false) {
   if (self->sizes() == size && (!stride || self->strides() == stride)) {
     return self;
   }
@@ -64,7 +73,7 @@ inline TensorImpl* resize_impl_cuda_(
     self->set_sizes_contiguous(size);
     storage_size = self->numel();
   }
-  maybe_resize_storage_cuda(self, storage_size);
+  maybe_resize_storage_cuda(self, storage_size, amortized);
 
   return self;
 }
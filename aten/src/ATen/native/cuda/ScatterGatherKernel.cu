@@ -7,6 +7,7 @@
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
 
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
 #include <ATen/native/cuda/Loops.cuh>
 #include <ATen/cuda/detail/OffsetCalculator.cuh>
 #include <ATen/cuda/CUDAContext.h>
@@ -302,7 +303,51 @@ void scatter_fill_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, Sc
   );
 }
 
+// Adds src to self like scatter_add_, but sums the elements with the same
+// destination in a fixed order (see embedding_segment_sum_cuda) instead of
+// with atomics.
+static void scatter_add_deterministic_cuda(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  scatter_gather_dtype_check("scatter_add_cuda_", self, index, src);
+  scatter_shape_check(self, dim, index, src);
+
+  auto index_sizes = ensure_nonempty_vec(index.sizes().vec());
+  auto self_sizes = ensure_nonempty_vec(self.sizes().vec());
+  const int64_t ndim = index_sizes.size();
+  const int64_t self_dim_size = self_sizes[dim];
+  const auto bounds = at::stack({index.min(), index.max()}).cpu();
+  TORCH_CHECK_INDEX(bounds[0].item<int64_t>() >= 0 && bounds[1].item<int64_t>() < self_dim_size,
+                    "scatter_add_(): index out of bounds for dimension ", dim, " with size ", self_dim_size);
+
+  // The offset in a contiguous self of the destination of every element
+  std::vector<int64_t> contiguous_strides(ndim);
+  int64_t stride = 1;
+  for (int64_t d = ndim - 1; d >= 0; d--) {
+    contiguous_strides[d] = stride;
+    stride *= self_sizes[d];
+  }
+  auto target = index.reshape(index_sizes) * contiguous_strides[dim];
+  for (int64_t d = 0; d < ndim; d++) {
+    if (d != dim) {
+      std::vector<int64_t> shape(ndim, 1);
+      shape[d] = index_sizes[d];
+      target = target + at::arange(index_sizes[d], index.options()).mul_(contiguous_strides[d]).view(shape);
+    }
+  }
+  auto values = src.as_strided(index_sizes, ensure_nonempty_vec(src.strides().vec()));
+  auto sums = embedding_segment_sum_cuda(
+      values.reshape({-1, 1}), target.reshape(-1), self.numel());
+  self.add_(sums.view(self.sizes()));
+}
+
 void scatter_add_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  if (index.numel() == 0) {
+    return;
+  }
+  if (globalContext().deterministic() && embedding_segment_sum_supports(self.scalar_type())) {
+    scatter_add_deterministic_cuda(self, dim, index, src);
+    return;
+  }
   // Nondeterministic because of atomicAdd usage
   globalContext().alertNotDeterministic("scatter_add_cuda_kernel");
   cuda_scatter_gather_base_kernel</*is_scatter_like=*/true, /*cast_to_opaque=*/false>()(
@@ -12,17 +12,25 @@
 namespace at {
 namespace native {
 
-constexpr int CAT_ARRAY_BATCH_SIZE = 1024;
 constexpr int CAT_ARRAY_MAX_INPUT_DIMS = 4;
+constexpr int CAT_ARRAY_BLOCK_SIZE = 32 * 16;
 
 namespace {
 
-inline bool getCatGrid(ptrdiff_t nTensors, dim3& grid) {
+inline bool getCatGrid(ptrdiff_t nTensors, int64_t maxElements, dim3& grid) {
   const int numSM = at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const int64_t maxGridY = at::cuda::getCurrentDeviceProperties()->maxGridSize[1];
 
   //X dim of grid for cat array cooperates on a single tensor in the cat.
-  //Given half of the GPU, full utilization will always occur.
-  grid = dim3( 2LL * numSM, (long long) nTensors );
+  //Given half of the GPU, full utilization will always occur, but don't
+  //launch more blocks than the largest input needs.
+  const int64_t blocksForLargest =
+    (maxElements + CAT_ARRAY_BLOCK_SIZE - 1) / CAT_ARRAY_BLOCK_SIZE;
+  //Y dim of grid strides over the tensors, so any number of them are
+  //handled by a single launch.
+  grid = dim3(
+    std::max<int64_t>(1, std::min<int64_t>(2LL * numSM, blocksForLargest)),
+    std::min<int64_t>(nTensors, maxGridY));
 
   return true;
 }
@@ -72,13 +80,15 @@ struct OutputTensorSizeStride {
 };
 
 /**
-  * Kernel used to concatenated grimDim.y tensors into an output tensor. Uses a
-  * grid-stride loop based off of the blockIdx.x, threadIdx.x for each input to
-  * copy each element from each input tensor into the output.
+  * Kernel used to concatenate nTensors tensors into an output tensor. Each
+  * blockIdx.y handles every gridDim.y-th input and uses a grid-stride loop
+  * based off of the blockIdx.x, threadIdx.x to copy each element of the input
+  * into the output.
   *
   * output: base pointer to the storage associated with the output tensor
   * inputs: GPU-allocated array of input metadata for each input to concatenate
   *         in the kernel
+  * nTensors: number of entries in inputs
   * os: the size/stride vectors for the output tensor
   * concatDim: dimension along which we are concatenating
   * dimStride: the stride of the output tensor at the concatDim
@@ -92,28 +102,29 @@ C10_LAUNCH_BOUNDS_1(512)
 __global__ void CatArrayBatchedCopy(
     T* output,
     CatArrInputTensor<T, IndexType>* inputs,
+    int nTensors,
     OutputTensorSizeStride<IndexType, CAT_ARRAY_MAX_INPUT_DIMS> os,
     const int concatDim,
     IndexType dimStride) {
 
-    IndexType tid = blockIdx.x * blockDim.x + threadIdx.x;
-    IndexType nElements = inputs[blockIdx.y].nElements;
-
-    if(tid >= nElements) return;
+    IndexType stride = gridDim.x * blockDim.x;
 
-    T* data = inputs[blockIdx.y].input;
-    IndexType offset = inputs[blockIdx.y].offset;
-    IndexType dimSize = inputs[blockIdx.y].dimSize;
-    IndexType dataOffset = offset * dimStride;
+    for (int t = blockIdx.y; t < nTensors; t += gridDim.y) {
+      IndexType tid = blockIdx.x * blockDim.x + threadIdx.x;
+      IndexType nElements = inputs[t].nElements;
 
-    IndexType stride = gridDim.x * blockDim.x;
+      T* data = inputs[t].input;
+      IndexType offset = inputs[t].offset;
+      IndexType dimSize = inputs[t].dimSize;
+      IndexType dataOffset = offset * dimStride;
 
-    while( tid < nElements){
-    IndexType elementOffset = CatArrIndexToOffset<IndexType, Dims>::compute(
-                  os.outputSize, os.outputStride, dimSize, concatDim, tid);
-    output[dataOffset + elementOffset] = data[tid];
+      while( tid < nElements){
+      IndexType elementOffset = CatArrIndexToOffset<IndexType, Dims>::compute(
+                    os.outputSize, os.outputStride, dimSize, concatDim, tid);
+      output[dataOffset + elementOffset] = data[tid];
 
-    tid += stride;
+      tid += stride;
+      }
     }
 }
 
@@ -147,8 +158,9 @@ void parallel_cat(Tensor &out, const TensorList &inputs, int64_t dimension,
   scalar_t *data = out.data_ptr<scalar_t>();
 
   // Kernel Parameter
+  const int nTensors = inputs.size();
   long tensorMetadataSize =
-    sizeof(CatArrInputTensor<scalar_t, unsigned int>) * CAT_ARRAY_BATCH_SIZE;
+    sizeof(CatArrInputTensor<scalar_t, unsigned int>) * nTensors;
   auto d_inputs_storage = at::empty(
     {tensorMetadataSize}, out.options().dtype(at::kByte));
   auto d_inputs = static_cast<CatArrInputTensor<scalar_t, unsigned int> *>(
@@ -179,81 +191,75 @@ void parallel_cat(Tensor &out, const TensorList &inputs, int64_t dimension,
 
   at::cuda::CUDAStream stream = at::cuda::getCurrentCUDAStream();
 
-  // Now we loop
-  int batchCounter = 0;
-  int64_t offset = 0;
-  for (int i = 0; i < inputs.size() ; i += CAT_ARRAY_BATCH_SIZE) {
-    // Re-allocate stackInputs every iteration to avoid read-after-write hazard
-    {
-      auto stackInputs_storage = at::empty({tensorMetadataSize},
-          out.options().dtype(at::kByte).device(at::kCPU).pinned_memory(true));
-      auto stackInputs =
-        static_cast<CatArrInputTensor<scalar_t, unsigned int> *>(
-          stackInputs_storage.data_ptr());
-      for (batchCounter = 0;
-           batchCounter < CAT_ARRAY_BATCH_SIZE &&
-             (i+batchCounter) < inputs.size();
-           ++batchCounter) {
-        int64_t dimSize = at::native::size(inputs[i+batchCounter], dimension);
-
-        stackInputs[batchCounter].input =
-          inputs[i+batchCounter].data_ptr<scalar_t>();
-        stackInputs[batchCounter].offset = offset;
-        stackInputs[batchCounter].dimSize = dimSize;
-        stackInputs[batchCounter].nElements = inputs[i+batchCounter].numel();
-
-        // update offset
-        offset += dimSize;
-      }
-      at::native::copy_(d_inputs_storage, stackInputs_storage,
-                        /* non_blocking= */ true);
+  // Fill the metadata of all the inputs on the host and copy it to the
+  // device at once, so that a single launch handles any number of inputs.
+  int64_t maxElements = 0;
+  {
+    auto stackInputs_storage = at::empty({tensorMetadataSize},
+        out.options().dtype(at::kByte).device(at::kCPU).pinned_memory(true));
+    auto stackInputs =
+      static_cast<CatArrInputTensor<scalar_t, unsigned int> *>(
+        stackInputs_storage.data_ptr());
+    int64_t offset = 0;
+    for (int i = 0; i < nTensors; ++i) {
+      int64_t dimSize = at::native::size(inputs[i], dimension);
+
+      stackInputs[i].input = inputs[i].data_ptr<scalar_t>();
+      stackInputs[i].offset = offset;
+      stackInputs[i].dimSize = dimSize;
+      stackInputs[i].nElements = inputs[i].numel();
+      maxElements = std::max(maxElements, inputs[i].numel());
+
+      // update offset
+      offset += dimSize;
     }
+    at::native::copy_(d_inputs_storage, stackInputs_storage,
+                      /* non_blocking= */ true);
+  }
 
-    // Next, let's consider how we set our kernel launch parameters.
-    // We borrow from THCApply, which the kernel's internal indexing
-    // is based on.
-    dim3 applyBlock = dim3(32*16);
-
-    //Get grid where x dim fills half gpu and y dim is number of tensors.
-    //This will have cating two tensors fill the entire grid, but prevent
-    //many threads from needlessly load meta data if their sizes is small.
-    dim3 catGrid;
-    getCatGrid(batchCounter, catGrid);
-
-
-    if (memory_format != c10::MemoryFormat::Contiguous) {
-      switch (dimension) {
-      case 0:
-        break;
-      case 1:
-        dimension = nDims - dimension;
-        break;
-      default:
-        dimension--;
-      }
+  // Next, let's consider how we set our kernel launch parameters.
+  // We borrow from THCApply, which the kernel's internal indexing
+  // is based on.
+  dim3 applyBlock = dim3(CAT_ARRAY_BLOCK_SIZE);
+
+  //Get grid where x dim fills half gpu and y dim strides over the tensors.
+  //This will have cating two tensors fill the entire grid, but prevent
+  //many threads from needlessly load meta data if their sizes is small.
+  dim3 catGrid;
+  getCatGrid(nTensors, maxElements, catGrid);
+
+  if (memory_format != c10::MemoryFormat::Contiguous) {
+    switch (dimension) {
+    case 0:
+      break;
+    case 1:
+      dimension = nDims - dimension;
+      break;
+    default:
+      dimension--;
     }
-    // Template Declarations for dim = 1, 2, 3, 4
+  }
+  // Template Declarations for dim = 1, 2, 3, 4
 #define HANDLE_CASE(DIMS) \
-    CatArrayBatchedCopy<scalar_t, unsigned int, DIMS><<<\
-        catGrid, applyBlock, 0, stream.stream()>>>(\
-            data, d_inputs, param, dimension, param.outputStride[dimension]);
-    switch (nDims) {
-      case 1:
-        HANDLE_CASE(1);
-        break;
-      case 2:
-        HANDLE_CASE(2);
-        break;
-      case 3:
-        HANDLE_CASE(3);
-        break;
-      case 4:
-        HANDLE_CASE(4);
-        break;
-    }
-#undef HANDLE_CASE
-    AT_CUDA_CHECK(cudaGetLastError());
+  CatArrayBatchedCopy<scalar_t, unsigned int, DIMS><<<\
+      catGrid, applyBlock, 0, stream.stream()>>>(\
+          data, d_inputs, nTensors, param, dimension, param.outputStride[dimension]);
+  switch (nDims) {
+    case 1:
+      HANDLE_CASE(1);
+      break;
+    case 2:
+      HANDLE_CASE(2);
+      break;
+    case 3:
+      HANDLE_CASE(3);
+      break;
+    case 4:
+      HANDLE_CASE(4);
+      break;
   }
+#undef HANDLE_CASE
+  AT_CUDA_CHECK(cudaGetLastError());
 }
 
 } // namespace
@@ -0,0 +1,286 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/LegacyTHFunctionsCUDA.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+
+#ifndef __HIP_PLATFORM_HCC__
+#include <cub/device/device_radix_sort.cuh>
+#include <cub/device/device_segmented_radix_sort.cuh>
+#endif
+
+#include <limits>
+
+// Radix sorts for the slices that the legacy sort handles slowly.
+//
+// The legacy sort sorts every slice with an in-place bitonic sort in shared
+// memory, one block per slice, as long as slices have at most 2048 elements
+// (1024 for 8 byte types). Longer slices are sorted all at once by Thrust
+// with a comparator that orders by slice first, a merge sort of the whole
+// tensor. Instead, the long slices of the types cub radix sorts are sorted:
+//
+//   - with cub's segmented radix sort, a block per slice, when there are
+//     enough slices to fill the GPU or the slices are mid-size;
+//   - with a device-wide radix sort when there is one slice, or two of them
+//     for a few very long slices: the first sorts all the keys, the second,
+//     stable one sorts them by slice.
+//
+// topk uses them to sort its results when k is too large for the bitonic
+// sort, and for mid-size rows it sorts whole rows rather than selecting and
+// then sorting.
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Slices up to this size are sorted by the segmented sort even if there are
+// few of them.
+constexpr int64_t kMaxSegmentedSortSliceSize = 1 << 16;
+
+// The largest slices sorted by the legacy bitonic sort
+int64_t legacy_sort_max_slice_size(ScalarType dtype) {
+  return (dtype == kDouble || dtype == kLong) ? 1024 : 2048;
+}
+
+int64_t slice_size(const Tensor& self, int64_t dim) {
+  return self.dim() == 0 ? 1 : self.size(dim);
+}
+
+bool can_use_radix_sort(const Tensor& self) {
+#ifdef __HIP_PLATFORM_HCC__
+  return false;
+#else
+  // cub counts items with int
+  const auto dtype = self.scalar_type();
+  return self.numel() > 0 && self.numel() <= std::numeric_limits<int>::max() &&
+      (at::isIntegralType(dtype, /*includeBool=*/false) ||
+       dtype == kFloat || dtype == kDouble);
+#endif
+}
+
+bool should_use_segmented_sort(int64_t num_slices, int64_t size) {
+  return size <= kMaxSegmentedSortSliceSize ||
+      num_slices >= at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+}
+
+#ifndef __HIP_PLATFORM_HCC__
+
+template <typename key_t, typename value_t>
+void radix_sort_pairs(
+    const key_t* keys_in, key_t* keys_out,
+    const value_t* values_in, value_t* values_out,
+    int64_t n, bool descending, int end_bit, const TensorOptions& options) {
+  auto stream = at::cuda::getCurrentCUDAStream();
+  size_t temp_storage_bytes = 0;
+  auto sort = [&](void* temp_storage) {
+    if (descending) {
+      AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairsDescending(
+          temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+          values_out, static_cast<int>(n), 0, end_bit, stream));
+    } else {
+      AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+          temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+          values_out, static_cast<int>(n), 0, end_bit, stream));
+    }
+  };
+  sort(nullptr);
+  auto temp_storage = at::empty(
+      {static_cast<int64_t>(temp_storage_bytes)}, options.dtype(kByte));
+  sort(temp_storage.data_ptr());
+}
+
+template <typename scalar_t>
+void segmented_radix_sort_pairs(
+    const scalar_t* keys_in, scalar_t* keys_out,
+    const int64_t* values_in, int64_t* values_out,
+    int64_t num_slices, int64_t size, bool descending,
+    const TensorOptions& options) {
+  auto stream = at::cuda::getCurrentCUDAStream();
+  // The slice i is [offsets[i], offsets[i + 1])
+  const auto offsets = at::arange(
+      0, (num_slices + 1) * size, size, options.dtype(kInt));
+  const int* begin_offsets = offsets.data_ptr<int>();
+  const int* end_offsets = begin_offsets + 1;
+  size_t temp_storage_bytes = 0;
+  auto sort = [&](void* temp_storage) {
+    if (descending) {
+      AT_CUDA_CHECK(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+          temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+          values_out, static_cast<int>(num_slices * size),
+          static_cast<int>(num_slices), begin_offsets, end_offsets,
+          0, sizeof(scalar_t) * 8, stream));
+    } else {
+      AT_CUDA_CHECK(cub::DeviceSegmentedRadixSort::SortPairs(
+          temp_storage, temp_storage_bytes, keys_in, keys_out, values_in,
+          values_out, static_cast<int>(num_slices * size),
+          static_cast<int>(num_slices), begin_offsets, end_offsets,
+          0, sizeof(scalar_t) * 8, stream));
+    }
+  };
+  sort(nullptr);
+  auto temp_storage = at::empty(
+      {static_cast<int64_t>(temp_storage_bytes)}, options.dtype(kByte));
+  sort(temp_storage.data_ptr());
+}
+
+// Sorts every row of the contiguous [num_slices, size] keys into values and
+// indices, both contiguous and of the same size.
+void radix_sort_rows(
+    const Tensor& keys, Tensor& values, Tensor& indices, bool descending) {
+  const int64_t num_slices = keys.size(0);
+  const int64_t size = keys.size(1);
+  const auto options = keys.options();
+  AT_DISPATCH_ALL_TYPES(keys.scalar_type(), "radix_sort_rows", [&] {
+    const scalar_t* keys_in = keys.data_ptr<scalar_t>();
+    scalar_t* keys_out = values.data_ptr<scalar_t>();
+    if (num_slices > 1 && should_use_segmented_sort(num_slices, size)) {
+      const auto positions = at::arange(size, options.dtype(kLong))
+                                 .expand({num_slices, size})
+                                 .contiguous();
+      segmented_radix_sort_pairs<scalar_t>(
+          keys_in, keys_out, positions.data_ptr<int64_t>(),
+          indices.data_ptr<int64_t>(), num_slices, size, descending, options);
+      return;
+    }
+
+    const int64_t n = num_slices * size;
+    auto positions = at::arange(n, options.dtype(kLong));
+    if (num_slices == 1) {
+      radix_sort_pairs<scalar_t, int64_t>(
+          keys_in, keys_out, positions.data_ptr<int64_t>(),
+          indices.data_ptr<int64_t>(), n, descending, sizeof(scalar_t) * 8,
+          options);
+      return;
+    }
+    // Sorts all the keys, then stably by slice only looking at the bits
+    // that slice numbers use.
+    auto all_sorted_keys = at::empty({n}, options);
+    auto all_sorted_positions = at::empty({n}, options.dtype(kLong));
+    radix_sort_pairs<scalar_t, int64_t>(
+        keys_in, all_sorted_keys.data_ptr<scalar_t>(),
+        positions.data_ptr<int64_t>(), all_sorted_positions.data_ptr<int64_t>(),
+        n, descending, sizeof(scalar_t) * 8, options);
+    auto slice_of = all_sorted_positions.floor_divide(size);
+    auto slice_sorted_slices = at::empty_like(slice_of);
+    auto order = at::empty_like(positions);
+    int slice_bits = 1;
+    while ((int64_t(1) << slice_bits) < num_slices) {
+      slice_bits++;
+    }
+    radix_sort_pairs<int64_t, int64_t>(
+        slice_of.data_ptr<int64_t>(), slice_sorted_slices.data_ptr<int64_t>(),
+        positions.data_ptr<int64_t>(), order.data_ptr<int64_t>(),
+        n, /*descending=*/false, slice_bits, options);
+    values.view({n}).copy_(all_sorted_keys.take(order));
+    indices.view({n}).copy_(all_sorted_positions.take(order).remainder_(size));
+  });
+}
+
+#endif
+
+// Sorts self along dim into values and indices, already of the size of self.
+void radix_sort_out(
+    Tensor& values, Tensor& indices, const Tensor& self, int64_t dim,
+    bool descending) {
+#ifdef __HIP_PLATFORM_HCC__
+  TORCH_INTERNAL_ASSERT(false, "radix_sort_out: not supported on ROCm");
+#else
+  const int64_t last = self.dim() - 1;
+  const int64_t size = self.size(dim);
+  Tensor keys = self.transpose(dim, last).contiguous();
+  if (at::isFloatingType(keys.scalar_type())) {
+    // The radix sort orders NaNs by their sign bit while sort always takes
+    // them to be the largest values
+    keys = keys.masked_fill(keys.isnan(), std::numeric_limits<double>::quiet_NaN());
+  }
+  keys = keys.view({-1, size});
+  // cub doesn't sort in place
+  const bool write_directly = dim == last && values.is_contiguous() &&
+      indices.is_contiguous() && values.data_ptr() != keys.data_ptr();
+  Tensor values_ = write_directly ? values : at::empty_like(keys);
+  Tensor indices_ = write_directly ? indices : at::empty(keys.sizes(), indices.options());
+  Tensor values_rows = values_.view({-1, size});
+  Tensor indices_rows = indices_.view({-1, size});
+  radix_sort_rows(keys, values_rows, indices_rows, descending);
+  if (!write_directly) {
+    auto transposed_sizes = self.transpose(dim, last).sizes();
+    values.copy_(values_.view(transposed_sizes).transpose(dim, last));
+    indices.copy_(indices_.view(transposed_sizes).transpose(dim, last));
+  }
+#endif
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> sort_out_cuda(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  dim = maybe_wrap_dim(dim, self.dim(), /*wrap_scalar=*/true);
+  if (!can_use_radix_sort(self) || self.dim() == 0 ||
+      self.size(dim) <= legacy_sort_max_slice_size(self.scalar_type())) {
+    return legacy::cuda::_th_sort_out(values, indices, self, dim, descending);
+  }
+  TORCH_CHECK(values.scalar_type() == self.scalar_type(),
+      "sort(): expected values of dtype ", self.scalar_type(), ", but got ", values.scalar_type());
+  TORCH_CHECK(indices.scalar_type() == kLong,
+      "sort(): expected indices of dtype Long, but got ", indices.scalar_type());
+  values.resize_(self.sizes());
+  indices.resize_(self.sizes());
+  radix_sort_out(values, indices, self, dim, descending);
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cuda(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  sort_out_cuda(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> topk_out_cuda(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  dim = maybe_wrap_dim(dim, self.dim(), /*wrap_scalar=*/true);
+  const int64_t size = slice_size(self, dim);
+  TORCH_CHECK(k >= 0 && k <= size, "selected index k out of range");
+  // The legacy topk sorts with the legacy sort, which is slow from here on
+  if (!sorted || !can_use_radix_sort(self) || self.dim() == 0 ||
+      k <= legacy_sort_max_slice_size(self.scalar_type())) {
+    return legacy::cuda::_th_topk_out(values, indices, self, k, dim, largest, sorted);
+  }
+
+  const int64_t num_slices = self.numel() / size;
+  if (num_slices > 1 && should_use_segmented_sort(num_slices, size)) {
+    // A block sorts a whole row in about the time it takes to select the
+    // top k of it, so skip the selection.
+    Tensor sorted_values, sorted_indices;
+    std::tie(sorted_values, sorted_indices) = sort_cuda(self, dim, largest);
+    values.resize_as_(sorted_values.narrow(dim, 0, k)).copy_(sorted_values.narrow(dim, 0, k));
+    indices.resize_as_(sorted_indices.narrow(dim, 0, k)).copy_(sorted_indices.narrow(dim, 0, k));
+    return std::forward_as_tuple(values, indices);
+  }
+
+  legacy::cuda::_th_topk_out(values, indices, self, k, dim, largest, /*sorted=*/false);
+  Tensor sorted_values, order;
+  std::tie(sorted_values, order) = sort_cuda(values, dim, largest);
+  indices.copy_(indices.gather(dim, order));
+  values.copy_(sorted_values);
+  return std::forward_as_tuple(values, indices);
+}
+
+} // namespace native
+} // namespace at
@@ -172,26 +172,26 @@ static void _fft_fill_with_conjugate_symmetry_(Tensor& input,
 // tensors being contiguous, and that the strides at the innermost signal
 // dimension being unit (1) w.r.t. the corresponding data type.
 
-static inline Tensor _run_cufft(
-    const CuFFTConfig &config, Tensor& input, int64_t signal_ndim,
-    bool complex_input, bool complex_output, bool inverse,
-    IntArrayRef checked_signal_sizes, bool normalized, bool onesided,
-    IntArrayRef output_sizes, bool input_was_cloned
+// Enqueues the plan of config on the current stream. Every execution gets a
+// work area of its own from the caching allocator, on the current stream, so
+// that a plan shared by executions on different streams never shares scratch
+// memory; only setting the stream and work area and enqueuing are serialized
+// per plan.
+static inline void _exec_cufft(
+    const CuFFTConfig &config, Tensor& input, Tensor& output,
+    bool complex_input, bool complex_output, bool inverse, bool input_was_cloned
 ) {
   if (config.should_clone_input() && !input_was_cloned) {
     input = input.clone(at::MemoryFormat::Contiguous);
   }
 
-  auto& plan = config.plan();
-  auto& ctx = at::globalContext();
+  auto ws = at::empty({ config.workspace_size() }, input.options().dtype(at::kByte));
 
-  // set output
-  auto output = at::empty(output_sizes, input.options());
+  std::lock_guard<std::mutex> guard(config.exec_mutex());
+  auto& plan = config.plan();
 
   // set to current stream
   CUFFT_CHECK(cufftSetStream(plan, at::cuda::getCurrentCUDAStream()));
-
-  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
   CUFFT_CHECK(cufftSetWorkArea(plan, ws.data_ptr()));
 
   // run
@@ -234,31 +234,6 @@ static inline Tensor _run_cufft(
   CUFFT_CHECK(cufftXtExec(plan, input.data_ptr(), output.data_ptr(),
     inverse ? CUFFT_INVERSE : CUFFT_FORWARD));
 #endif
-
-  // rescale if needed by normalized flag or inverse transform
-  auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
-  if (normalized || inverse) {
-    auto signal_numel = at::prod_intlist(checked_signal_sizes);
-    double scale_denom;
-    if (normalized) {
-      scale_denom = std::sqrt(static_cast<double>(signal_numel));
-    } else {
-      scale_denom = static_cast<double>(signal_numel);
-    }
-    if (!complex_input && complex_output && !onesided) {
-      auto end_data_slice = infer_ft_real_to_complex_onesided_size(size_last_signal_dim);
-      output.narrow(signal_ndim, 0, end_data_slice).div_(scale_denom);
-    } else {
-      output.div_(scale_denom);
-    }
-  }
-
-  // if needed, fill out the other half using conjugate symmetry
-  if (!complex_input && complex_output && !onesided) {
-    auto start_slice = infer_ft_real_to_complex_onesided_size(size_last_signal_dim);
-    _fft_fill_with_conjugate_symmetry_(output, size_last_signal_dim, start_slice);
-  }
-  return output;
 }
 
 // The cuFFT plan cache
@@ -320,6 +295,58 @@ void cufft_clear_plan_cache_impl(int64_t device_index) {
 
 } // namespace at::native::detail
 
+// NOTE [ cuFFT Batch Chunking ]
+//
+// A cuFFT plan is made for one batch size, and making one synchronizes with
+// the device and costs far more than executing it for small signals. STFTs
+// of audio of different lengths, for example, run the same small transform
+// over a different number of frames every time, and would make a new plan
+// for every length.
+//
+// So if the plan cache is enabled, transforms of small signals are run in
+// chunks of power-of-two batch sizes, from the largest one that fits down,
+// e.g., 4 + 2 + 1 for a batch of 7. Each chunk is a transform of its own with
+// a cached plan, and any batch size is covered by at most log2(batch) + 1 of
+// them. Transforms of larger signals are limited by the device rather than by
+// the launches, and run in a single plan.
+//
+// The chunks are disjoint slices of the input and output along the batch
+// dimension, so they keep the layout of the whole, and their data pointers
+// stay aligned to complex type if the batch stride is a multiple of it.
+constexpr int64_t kCuFFTMaxChunkedSignalNumel = 4096;
+
+// Returns the config of a transform of input, from the plan cache if it is
+// enabled, or made just for this transform otherwise.
+static inline std::shared_ptr<const CuFFTConfig> _get_cufft_config(
+    CuFFTParamsLRUCache& plan_cache, Tensor& input, int64_t signal_ndim,
+    bool complex_input, bool complex_output, IntArrayRef checked_signal_sizes,
+    bool onesided, IntArrayRef output_sizes
+) {
+  // If plan caching is enabled, we check the cache. Note that this accesses
+  // plan_cache.max_size() and thus makes this function less functional.
+  // However, integrating additional arguments into the "public" level c++ APIs,
+  // e.g., irfft, is difficult as we have a long call sequence looking like
+  //   irfft --> _fft --> _fft_with_size --dispatching-to-> _fft_cufft
+
+  // This read is not locked for perf reason. Shouldn't matter too much because
+  // we check again after acquiring the lock.
+  if (plan_cache.max_size() > 0) {
+    CuFFTParams params;
+    setCuFFTParams(&params, input, signal_ndim, complex_input,
+      complex_output, checked_signal_sizes, onesided);
+    std::lock_guard<std::mutex> guard(plan_cache.mutex);
+    if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
+      return plan_cache.try_emplace_value(std::move(params),
+                                          input, signal_ndim, complex_input,
+                                          complex_output, checked_signal_sizes,
+                                          onesided, output_sizes);
+    }
+  }
+  return std::make_shared<const CuFFTConfig>(input, signal_ndim, complex_input,
+                                             complex_output, checked_signal_sizes,
+                                             onesided, output_sizes);
+}
+
 // cuFFT
 // Currently not utilizing multi GPUs so this can be potentially sped up.
 Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
@@ -357,35 +384,64 @@ Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
   // Now that we have done error check and data_ptr checks, we delegate all
   // further cuFFT parameter computation and plan creation to the helper class
   // CuFFTConfig in CuFFTPlanCache.h.
+  auto output = at::empty(output_sizes, input.options());
 
-  // If plan caching is enabled, we check the cache. Note that this accesses
-  // plan_cache.max_size() and thus makes this function less functional.
-  // However, integrating additional arguments into the "public" level c++ APIs,
-  // e.g., irfft, is difficult as we have a long call sequence looking like
-  //   irfft --> _fft --> _fft_with_size --dispatching-to-> _fft_cufft
+  // See NOTE [ cuFFT Batch Chunking ].
+  const int64_t batch = input.size(0);
+  const bool chunk_batch = plan_cache.max_size() > 0 && batch > 0 &&
+      !is_pow_of_two(batch) &&
+      at::prod_intlist(checked_signal_sizes) <= kCuFFTMaxChunkedSignalNumel &&
+      (input.stride(0) * input.element_size()) % complex_size_bytes == 0;
+  if (!chunk_batch) {
+    auto config = _get_cufft_config(plan_cache, input, signal_ndim, complex_input,
+                                    complex_output, checked_signal_sizes, onesided,
+                                    output_sizes);
+    _exec_cufft(*config, input, output, complex_input, complex_output, inverse,
+                input_was_cloned);
+  } else {
+    std::vector<int64_t> chunk_output_sizes(output_sizes.begin(), output_sizes.end());
+    for (int64_t offset = 0; offset < batch;) {
+      int64_t chunk = 1;
+      while (chunk * 2 <= batch - offset) {
+        chunk *= 2;
+      }
+      Tensor input_chunk = input.narrow(0, offset, chunk);
+      Tensor output_chunk = output.narrow(0, offset, chunk);
+      chunk_output_sizes[0] = chunk;
+      auto config = _get_cufft_config(plan_cache, input_chunk, signal_ndim,
+                                      complex_input, complex_output,
+                                      checked_signal_sizes, onesided,
+                                      chunk_output_sizes);
+      _exec_cufft(*config, input_chunk, output_chunk, complex_input,
+                  complex_output, inverse, input_was_cloned);
+      offset += chunk;
+    }
+  }
 
-  // This read is not locked for perf reason. Shouldn't matter too much because
-  // we check again after acquiring the lock.
-  if (plan_cache.max_size() > 0) {
-    CuFFTParams params;
-    setCuFFTParams(&params, input, signal_ndim, complex_input,
-      complex_output, checked_signal_sizes, onesided);
-    std::lock_guard<std::mutex> guard(plan_cache.mutex);
-    if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
-      const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(params),
-                                             input, signal_ndim, complex_input,
-                                             complex_output, checked_signal_sizes,
-                                             onesided, output_sizes);
-      return _run_cufft(config, input, signal_ndim, complex_input,
-                        complex_output, inverse, checked_signal_sizes, normalized,
-                        onesided, output_sizes, input_was_cloned);
+  // rescale if needed by normalized flag or inverse transform
+  auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
+  if (normalized || inverse) {
+    auto signal_numel = at::prod_intlist(checked_signal_sizes);
+    double scale_denom;
+    if (normalized) {
+      scale_denom = std::sqrt(static_cast<double>(signal_numel));
+    } else {
+      scale_denom = static_cast<double>(signal_numel);
+    }
+    if (!complex_input && complex_output && !onesided) {
+      auto end_data_slice = infer_ft_real_to_complex_onesided_size(size_last_signal_dim);
+      output.narrow(signal_ndim, 0, end_data_slice).div_(scale_denom);
+    } else {
+      output.div_(scale_denom);
     }
   }
-  CuFFTConfig config(input, signal_ndim, complex_input, complex_output,
-                     checked_signal_sizes, onesided, output_sizes);
-  return _run_cufft(config, input, signal_ndim, complex_input,
-                    complex_output, inverse, checked_signal_sizes, normalized,
-                    onesided, output_sizes, input_was_cloned);
+
+  // if needed, fill out the other half using conjugate symmetry
+  if (!complex_input && complex_output && !onesided) {
+    auto start_slice = infer_ft_real_to_complex_onesided_size(size_last_signal_dim);
+    _fft_fill_with_conjugate_symmetry_(output, size_last_signal_dim, start_slice);
+  }
+  return output;
 }
 
 }} // at::native
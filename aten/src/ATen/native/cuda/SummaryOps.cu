@@ -7,17 +7,24 @@
 
 namespace at {
 namespace cuda {
-#define THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM 100
+#define THRESH_NUMBER_BINS_FOR_WARP_MEM 256
 #define THRESH_NUMBER_BINS_FOR_GLOBAL_MEM 1000
+#define THRESH_NUMBER_PASSES_FOR_SHARED_MEM 8
 #define FOR_KERNEL_LOOP(i, lim)                                      \
   for (IndexType i = blockIdx.x * blockDim.x + threadIdx.x; i < lim; \
        i += gridDim.x * blockDim.x)
 
 /*
-  Memory types used for the 3 histogram implementations.
+  Memory types used for the histogram implementations.
   See `CUDA_tensor_histogram` below.
  */
-enum class CUDAHistogramMemoryType { SHARED, MULTI_BLOCK, GLOBAL };
+enum class CUDAHistogramMemoryType {
+  SHARED_WARP,
+  SHARED,
+  SHARED_MULTI_PASS,
+  MULTI_BLOCK,
+  GLOBAL
+};
 namespace {
   template<typename input_t, typename IndexType>
   __device__ static IndexType getBin(input_t bVal, input_t minvalue, input_t maxvalue, int64_t nbins) {
@@ -51,6 +58,7 @@ __global__ void kernelHistogram1D(
     detail::TensorInfo<output_t, IndexType> p, /* partial output */
     detail::TensorInfo<input_t, IndexType> b, /* input */
     int64_t nbins,
+    int64_t binsPerPass,
     input_t minvalue,
     input_t maxvalue,
     IndexType totalElements,
@@ -58,12 +66,26 @@ __global__ void kernelHistogram1D(
   extern __shared__ unsigned char my_smem[];
   output_t* smem = nullptr;
 
-  if (MemoryType == CUDAHistogramMemoryType::SHARED) {
+  if (MemoryType == CUDAHistogramMemoryType::SHARED_WARP ||
+      MemoryType == CUDAHistogramMemoryType::SHARED ||
+      MemoryType == CUDAHistogramMemoryType::SHARED_MULTI_PASS) {
     ////////////////////////// Shared memory //////////////////////////
-    // atomically add to block specific shared memory
-    // then atomically add to the global output tensor
+    // atomically add to block (or warp) specific shared memory
+    // then atomically add to the global output tensor.
+    // SHARED_WARP keeps one copy of the bins per warp, so that threads
+    // only contend with their own warp when the input is skewed.
+    // SHARED_MULTI_PASS splits the bins into ranges of `binsPerPass`,
+    // one range per blockIdx.y, and every range re-reads the input.
     smem = reinterpret_cast<output_t*>(my_smem);
-    for (IndexType i = threadIdx.x; i < a.sizes[0]; i += blockDim.x) {
+    const IndexType binBegin = blockIdx.y * binsPerPass;
+    const IndexType binEnd = ::min(static_cast<IndexType>(nbins), binBegin + binsPerPass);
+    const IndexType numBins = binEnd - binBegin;
+    const IndexType numCopies =
+        MemoryType == CUDAHistogramMemoryType::SHARED_WARP ? blockDim.x / C10_WARP_SIZE : 1;
+    output_t* hist = MemoryType == CUDAHistogramMemoryType::SHARED_WARP
+        ? smem + (threadIdx.x / C10_WARP_SIZE) * numBins
+        : smem;
+    for (IndexType i = threadIdx.x; i < numBins * numCopies; i += blockDim.x) {
       smem[i] = 0;
     }
     __syncthreads();
@@ -73,19 +95,28 @@ __global__ void kernelHistogram1D(
           detail::IndexToOffset<input_t, IndexType, BDims>::get(linearIndex, b);
       const auto bVal = b.data[bOffset];
       if (bVal >= minvalue && bVal <= maxvalue) {
-        // Use value at `b` as an offset of `smem`
+        // Use value at `b` as an offset of `hist`
         const IndexType bin = getBin<input_t, IndexType>(bVal, minvalue, maxvalue, nbins);
-        gpuAtomicAdd(&smem[bin], getOp(linearIndex));
+        if (bin >= binBegin && bin < binEnd) {
+          gpuAtomicAdd(&hist[bin - binBegin], getOp(linearIndex));
+        }
       }
     }
     __syncthreads();
     // NOTE: atomically update output bin count.
     //   Atomic update is imp since __syncthread() will only synchronize threads
     //   in a given block, not across blocks.
-    for (IndexType i = threadIdx.x; i < a.sizes[0]; i += blockDim.x) {
-      const IndexType aOffset =
-          detail::IndexToOffset<output_t, IndexType, ADims>::get(i, a);
-      gpuAtomicAdd(&a.data[aOffset], smem[i]);
+    for (IndexType i = threadIdx.x; i < numBins; i += blockDim.x) {
+      output_t count = smem[i];
+      for (IndexType copy = 1; copy < numCopies; ++copy) {
+        count += smem[copy * numBins + i];
+      }
+      // Skip empty bins, sparse inputs leave most of them untouched
+      if (count != output_t(0)) {
+        const IndexType aOffset =
+            detail::IndexToOffset<output_t, IndexType, ADims>::get(binBegin + i, a);
+        gpuAtomicAdd(&a.data[aOffset], count);
+      }
     }
 
   } else if (MemoryType == CUDAHistogramMemoryType::MULTI_BLOCK) {
@@ -146,14 +177,22 @@ __global__ void kernelHistogram1D(
          block,                                                            \
          SHARED_MEM,                                                       \
          getCurrentCUDAStream()>>>(                    \
-          aInfo, pInfo, bInfo, nbins, minvalue, maxvalue, totalElements, WEIGHTS_OP);        \
+          aInfo, pInfo, bInfo, nbins, binsPerPass, minvalue, maxvalue,     \
+          totalElements, WEIGHTS_OP);                                      \
   AT_ASSERTM(cudaGetLastError() == cudaSuccess, "kernelHistogram1D failed");
 
 #define HANDLE_SWITCH_CASE(mType, getOp)                                   \
   switch (mType) {                                                         \
+    case CUDAHistogramMemoryType::SHARED_WARP:                             \
+      HANDLE_CASE(CUDAHistogramMemoryType::SHARED_WARP, getOp, sharedMem); \
+      break;                                                               \
     case CUDAHistogramMemoryType::SHARED:                                  \
       HANDLE_CASE(CUDAHistogramMemoryType::SHARED, getOp, sharedMem);      \
       break;                                                               \
+    case CUDAHistogramMemoryType::SHARED_MULTI_PASS:                       \
+      HANDLE_CASE(                                                         \
+          CUDAHistogramMemoryType::SHARED_MULTI_PASS, getOp, sharedMem);   \
+      break;                                                               \
     case CUDAHistogramMemoryType::MULTI_BLOCK:                             \
       HANDLE_CASE(CUDAHistogramMemoryType::MULTI_BLOCK, getOp, 0);         \
       break;                                                               \
@@ -179,10 +218,18 @@ inline int64_t getFreeGlobalMemory() {
   `c` optionally contains the weight vector.
   See `help torch.bincount` for details on the math.
 
-  3 implementations based of input size and memory usage:
-    case: #bins < THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM and enough shared mem
+  5 implementations based of input size and memory usage:
+    case: #bins <= THRESH_NUMBER_BINS_FOR_WARP_MEM and enough shared mem
+        SHARED_WARP: Each warp atomically adds to it's own **shared** hist
+        copy, then the copies of a block are summed and atomically added to
+        the global tensor. Keeps contention low for skewed inputs.
+    case: enough shared mem for one copy of the hist
         SHARED: Each block atomically adds to it's own **shared** hist copy,
         then atomically updates the global tensor.
+    case: #passes <= THRESH_NUMBER_PASSES_FOR_SHARED_MEM, where #passes is
+        the number of shared hist copies needed to cover all bins
+        SHARED_MULTI_PASS: Like SHARED, but each of the #passes rows of blocks
+        (blockIdx.y) only counts its own range of bins.
     case: #bins < THRESH_NUMBER_BINS_FOR_GLOBAL_MEM and enough global mem
         MULTI_BLOCK: Each block atomically adds to it's own **global** hist
         copy, then atomically updates the global tensor.
@@ -218,14 +265,26 @@ bool CUDA_tensor_histogram(
   }
 
   CUDAHistogramMemoryType memType = CUDAHistogramMemoryType::GLOBAL;
-  auto maxSharedMem = getCurrentDeviceProperties()->sharedMemPerBlock;
-  auto sharedMem = nbins * sizeof(output_t) + 8; // 8 guard bytes
+  const int64_t maxSharedMem = getCurrentDeviceProperties()->sharedMemPerBlock;
+  const int64_t warpsPerBlock = block.x / warp_size();
+  const int64_t binsPerSharedMem = (maxSharedMem - 8) / sizeof(output_t); // 8 guard bytes
+  const int64_t numPasses = (nbins + binsPerSharedMem - 1) / binsPerSharedMem;
+  int64_t binsPerPass = nbins;
+  int64_t sharedMem = nbins * sizeof(output_t) + 8; // 8 guard bytes
   auto maxGlobalMem = getFreeGlobalMemory();
   auto multiBlockMem = nbins * grid.x * sizeof(output_t) + 8; // 8 guard bytes
   // determine memory type to use in the kernel
-  if (nbins < THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM &&
-      sharedMem < maxSharedMem) {
+  if (nbins <= THRESH_NUMBER_BINS_FOR_WARP_MEM &&
+      nbins * warpsPerBlock * sizeof(output_t) + 8 <= maxSharedMem) {
+    memType = CUDAHistogramMemoryType::SHARED_WARP;
+    sharedMem = nbins * warpsPerBlock * sizeof(output_t) + 8;
+  } else if (sharedMem <= maxSharedMem) {
     memType = CUDAHistogramMemoryType::SHARED;
+  } else if (numPasses <= THRESH_NUMBER_PASSES_FOR_SHARED_MEM) {
+    memType = CUDAHistogramMemoryType::SHARED_MULTI_PASS;
+    binsPerPass = (nbins + numPasses - 1) / numPasses;
+    sharedMem = binsPerPass * sizeof(output_t) + 8;
+    grid.y = numPasses;
   } else if (
       nbins < THRESH_NUMBER_BINS_FOR_GLOBAL_MEM &&
       multiBlockMem < (maxGlobalMem / 2)) {
@@ -263,8 +322,9 @@ bool CUDA_tensor_histogram(
 #undef HANDLE_CASE
 #undef HANDLE_SWITCH_CASE
 #undef FOR_KERNEL_LOOP
+#undef THRESH_NUMBER_PASSES_FOR_SHARED_MEM
 #undef THRESH_NUMBER_BINS_FOR_GLOBAL_MEM
-#undef THRESH_NUMBER_BINS_FOR_MULTI_BLOCK_MEM
+#undef THRESH_NUMBER_BINS_FOR_WARP_MEM
 } // namespace cuda
 
 namespace {
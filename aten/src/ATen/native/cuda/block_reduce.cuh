@@ -34,6 +34,69 @@ __inline__ __device__ T BlockReduceSum(T val, T* shared) {
   return val;
 }
 
+// Count, mean and sum of squared deviations of a set of values.
+template <typename T_ACC>
+struct WelfordStats {
+  T_ACC count;
+  T_ACC mean;
+  T_ACC m2;
+};
+
+template <typename T_ACC>
+__device__ __forceinline__ WelfordStats<T_ACC> WelfordCombine(
+    const WelfordStats<T_ACC>& a,
+    const WelfordStats<T_ACC>& b) {
+  const T_ACC count = a.count + b.count;
+  if (count == T_ACC(0)) {
+    return a;
+  }
+  const T_ACC delta = b.mean - a.mean;
+  const T_ACC b_ratio = b.count / count;
+  return {count,
+          a.mean + delta * b_ratio,
+          a.m2 + b.m2 + delta * delta * a.count * b_ratio};
+}
+
+template <typename T_ACC>
+__device__ __forceinline__ WelfordStats<T_ACC> WarpWelfordReduce(
+    WelfordStats<T_ACC> stats) {
+#pragma unroll
+  for (int offset = (C10_WARP_SIZE >> 1); offset > 0; offset >>= 1) {
+    const WelfordStats<T_ACC> other = {
+        WARP_SHFL_DOWN(stats.count, offset),
+        WARP_SHFL_DOWN(stats.mean, offset),
+        WARP_SHFL_DOWN(stats.m2, offset)};
+    stats = WelfordCombine(stats, other);
+  }
+  return stats;
+}
+
+// Unlike BlockReduceSum, the results are returned to all the
+// threads of the block.
+template <typename T_ACC>
+__device__ WelfordStats<T_ACC> BlockWelfordReduce(
+    WelfordStats<T_ACC> stats,
+    WelfordStats<T_ACC>* shared) {
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  stats = WarpWelfordReduce(stats);
+  __syncthreads();
+  if (lid == 0) {
+    shared[wid] = stats;
+  }
+  __syncthreads();
+  if (wid == 0) {
+    stats = lid < blockDim.x / C10_WARP_SIZE ? shared[lid]
+                                             : WelfordStats<T_ACC>{0, 0, 0};
+    stats = WarpWelfordReduce(stats);
+    if (lid == 0) {
+      shared[0] = stats;
+    }
+  }
+  __syncthreads();
+  return shared[0];
+}
+
 } // namespace cuda_utils
 } // namespace native
 } // namespace at
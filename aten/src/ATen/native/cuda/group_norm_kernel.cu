@@ -19,6 +19,26 @@ namespace {
 constexpr int kCUDANumThreads = 256;
 constexpr int kReduceTileSize = 32;
 
+template <typename T_ACC>
+__device__ __forceinline__ T_ACC
+ActivationForward(T_ACC y, GroupNormActivation activation) {
+  return activation == GroupNormActivation::kSiLU
+      ? y / (T_ACC(1) + c10::cuda::compat::exp(-y))
+      : y;
+}
+
+// Gradient w.r.t. the pre-activation value z, given the gradient dy of the
+// activation output.
+template <typename T_ACC>
+__device__ __forceinline__ T_ACC
+ActivationBackward(T_ACC dy, T_ACC z, GroupNormActivation activation) {
+  if (activation == GroupNormActivation::kSiLU) {
+    const T_ACC sigmoid = T_ACC(1) / (T_ACC(1) + c10::cuda::compat::exp(-z));
+    return dy * sigmoid * (T_ACC(1) + z * (T_ACC(1) - sigmoid));
+  }
+  return dy;
+}
+
 template <typename T>
 __global__ void RowwiseMomentsCUDAKernel(
     int64_t N,
@@ -48,6 +68,43 @@ __global__ void RowwiseMomentsCUDAKernel(
   }
 }
 
+// Moments of group blockIdx.x of a channels last input, whose D channels are
+// contiguous in each of its HxW rows. Consecutive threads read consecutive
+// elements of the group, accumulate them with Welford updates, and the
+// per-thread moments are merged with Welford's combination.
+template <typename T>
+__global__ void RowwiseMomentsChannelsLastCUDAKernel(
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    T eps,
+    const T* X,
+    T* mean,
+    T* rstd) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ cuda_utils::WelfordStats<T_ACC> stats_shared[C10_WARP_SIZE];
+  const int64_t D = C / group;
+  const int64_t ng = blockIdx.x;
+  const int64_t n = ng / group;
+  const int64_t g = ng % group;
+  const T* X_ptr = X + n * HxW * C + g * D;
+  cuda_utils::WelfordStats<T_ACC> stats = {0, 0, 0};
+  for (int64_t i = threadIdx.x; i < D * HxW; i += blockDim.x) {
+    const T_ACC x = static_cast<T_ACC>(X_ptr[(i / D) * C + i % D]);
+    stats.count += T_ACC(1);
+    const T_ACC delta = x - stats.mean;
+    stats.mean += delta / stats.count;
+    stats.m2 += delta * (x - stats.mean);
+  }
+  stats = cuda_utils::BlockWelfordReduce(stats, stats_shared);
+  if (threadIdx.x == 0) {
+    const T_ACC var =
+        c10::cuda::compat::max(stats.m2 / stats.count, T_ACC(0));
+    mean[ng] = stats.mean;
+    rstd[ng] = c10::cuda::compat::rsqrt(var + static_cast<T_ACC>(eps));
+  }
+}
+
 template <typename T>
 __global__ void ComputeFusedParamsCUDAKernel(
     int64_t N,
@@ -81,12 +138,14 @@ __global__ void GroupNormForwardSimpleCUDAKernel(
     const T* X,
     const acc_type<T, true>* a,
     const acc_type<T, true>* b,
+    GroupNormActivation activation,
     T* Y) {
   using T_ACC = acc_type<T, true>;
   const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
   if (index < N * C * HxW) {
     const int64_t nc = index / HxW;
-    Y[index] = a[nc] * static_cast<T_ACC>(X[index]) + b[nc];
+    Y[index] = ActivationForward(
+        a[nc] * static_cast<T_ACC>(X[index]) + b[nc], activation);
   }
 }
 
@@ -96,32 +155,64 @@ __global__ void GroupNormForwardCUDAKernel(
     const T* X,
     const acc_type<T, true>* a,
     const acc_type<T, true>* b,
+    GroupNormActivation activation,
     T* Y) {
   using T_ACC = acc_type<T, true>;
   const int64_t nc = blockIdx.x;
   for (int64_t hw = threadIdx.x; hw < HxW; hw += blockDim.x) {
     const int64_t index = nc * HxW + hw;
-    Y[index] = a[nc] * static_cast<T_ACC>(X[index]) + b[nc];
+    Y[index] = ActivationForward(
+        a[nc] * static_cast<T_ACC>(X[index]) + b[nc], activation);
   }
 }
 
+template <typename T>
+__global__ void GroupNormForwardChannelsLastCUDAKernel(
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
+    GroupNormActivation activation,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
+  if (index < N * HxW * C) {
+    const int64_t nc = index / (HxW * C) * C + index % C;
+    Y[index] = ActivationForward(
+        a[nc] * static_cast<T_ACC>(X[index]) + b[nc], activation);
+  }
+}
+
+// ds[n, c] = sum(dZ * X) and db[n, c] = sum(dZ) over HxW, where dZ is the
+// gradient of the pre-activation output, recomputed from X through the fused
+// params a and b (null without an activation).
 template <typename T>
 __global__ void ComputeInternalGradientsCUDAKernel(
     int64_t HxW,
     const T* dY,
     const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
+    GroupNormActivation activation,
     acc_type<T, true>* ds,
     acc_type<T, true>* db) {
   using T_ACC = acc_type<T, true>;
   __shared__ T_ACC ds_shared[C10_WARP_SIZE];
   __shared__ T_ACC db_shared[C10_WARP_SIZE];
   const int64_t nc = blockIdx.x;
+  const T_ACC a_v = a == nullptr ? T_ACC(1) : a[nc];
+  const T_ACC b_v = b == nullptr ? T_ACC(0) : b[nc];
   T_ACC sum1 = 0;
   T_ACC sum2 = 0;
   for (int64_t hw = threadIdx.x; hw < HxW; hw += blockDim.x) {
     const int64_t index = nc * HxW + hw;
-    sum1 += static_cast<T_ACC>(dY[index]) * static_cast<T_ACC>(X[index]);
-    sum2 += static_cast<T_ACC>(dY[index]);
+    const T_ACC x = static_cast<T_ACC>(X[index]);
+    const T_ACC dy =
+        ActivationBackward(static_cast<T_ACC>(dY[index]), a_v * x + b_v, activation);
+    sum1 += dy * x;
+    sum2 += dy;
   }
   sum1 = cuda_utils::BlockReduceSum<T_ACC>(sum1, ds_shared);
   sum2 = cuda_utils::BlockReduceSum<T_ACC>(sum2, db_shared);
@@ -131,6 +222,55 @@ __global__ void ComputeInternalGradientsCUDAKernel(
   }
 }
 
+// Channels last version of ComputeInternalGradientsCUDAKernel. A block sums
+// kReduceTileSize channels of one sample: the threads of a row read
+// consecutive channels and the rows of the block stride over HxW.
+template <typename T>
+__global__ void ComputeInternalGradientsChannelsLastCUDAKernel(
+    int64_t C,
+    int64_t HxW,
+    const T* dY,
+    const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
+    GroupNormActivation activation,
+    acc_type<T, true>* ds,
+    acc_type<T, true>* db) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC ds_shared[kReduceTileSize / 2][kReduceTileSize + 1];
+  __shared__ T_ACC db_shared[kReduceTileSize / 2][kReduceTileSize + 1];
+  const int64_t blocks_per_sample = (C + kReduceTileSize - 1) / kReduceTileSize;
+  const int64_t n = blockIdx.x / blocks_per_sample;
+  const int64_t c =
+      blockIdx.x % blocks_per_sample * kReduceTileSize + threadIdx.x;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  if (c < C) {
+    const int64_t nc = n * C + c;
+    const T_ACC a_v = a == nullptr ? T_ACC(1) : a[nc];
+    const T_ACC b_v = b == nullptr ? T_ACC(0) : b[nc];
+    for (int64_t hw = threadIdx.y; hw < HxW; hw += blockDim.y) {
+      const int64_t index = (n * HxW + hw) * C + c;
+      const T_ACC x = static_cast<T_ACC>(X[index]);
+      const T_ACC dy = ActivationBackward(
+          static_cast<T_ACC>(dY[index]), a_v * x + b_v, activation);
+      sum1 += dy * x;
+      sum2 += dy;
+    }
+  }
+  ds_shared[threadIdx.y][threadIdx.x] = sum1;
+  db_shared[threadIdx.y][threadIdx.x] = sum2;
+  __syncthreads();
+  if (threadIdx.y == 0 && c < C) {
+    for (int y = 1; y < blockDim.y; ++y) {
+      sum1 += ds_shared[y][threadIdx.x];
+      sum2 += db_shared[y][threadIdx.x];
+    }
+    ds[n * C + c] = sum1;
+    db[n * C + c] = sum2;
+  }
+}
+
 template <typename T>
 __global__ void ComputeGradOutputCoeffientCUDAKernel(
     int64_t N,
@@ -200,17 +340,24 @@ __global__ void GroupNormBackwardSimpleCUDAKernel(
     int64_t group,
     const T* dY,
     const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
     const acc_type<T, true>* c1,
     const acc_type<T, true>* c2,
     const acc_type<T, true>* c3,
+    GroupNormActivation activation,
     T* dX) {
   using T_ACC = acc_type<T, true>;
   const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
   if (index < N * C * HxW) {
     const int64_t nc = index / HxW;
     const int64_t ng = nc / (C / group);
-    dX[index] = c1[nc] * static_cast<T_ACC>(dY[index]) +
-        c2[ng] * static_cast<T_ACC>(X[index]) + c3[ng];
+    const T_ACC x = static_cast<T_ACC>(X[index]);
+    const T_ACC dy = a == nullptr
+        ? static_cast<T_ACC>(dY[index])
+        : ActivationBackward(
+              static_cast<T_ACC>(dY[index]), a[nc] * x + b[nc], activation);
+    dX[index] = c1[nc] * dy + c2[ng] * x + c3[ng];
   }
 }
 
@@ -221,18 +368,56 @@ __global__ void GroupNormBackwardCUDAKernel(
     int64_t group,
     const T* dY,
     const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
     const acc_type<T, true>* c1,
     const acc_type<T, true>* c2,
     const acc_type<T, true>* c3,
+    GroupNormActivation activation,
     T* dX) {
   using T_ACC = acc_type<T, true>;
   const int64_t D = C / group;
   const int64_t nc = blockIdx.x;
   const int64_t ng = nc / D;
+  const T_ACC a_v = a == nullptr ? T_ACC(1) : a[nc];
+  const T_ACC b_v = b == nullptr ? T_ACC(0) : b[nc];
   for (int64_t hw = threadIdx.x; hw < HxW; hw += blockDim.x) {
     const int64_t index = nc * HxW + hw;
-    dX[index] = c1[nc] * static_cast<T_ACC>(dY[index]) +
-        c2[ng] * static_cast<T_ACC>(X[index]) + c3[ng];
+    const T_ACC x = static_cast<T_ACC>(X[index]);
+    const T_ACC dy = ActivationBackward(
+        static_cast<T_ACC>(dY[index]), a_v * x + b_v, activation);
+    dX[index] = c1[nc] * dy + c2[ng] * x + c3[ng];
+  }
+}
+
+template <typename T>
+__global__ void GroupNormBackwardChannelsLastCUDAKernel(
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    const T* dY,
+    const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
+    const acc_type<T, true>* c1,
+    const acc_type<T, true>* c2,
+    const acc_type<T, true>* c3,
+    GroupNormActivation activation,
+    T* dX) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
+  if (index < N * HxW * C) {
+    const int64_t n = index / (HxW * C);
+    const int64_t c = index % C;
+    const int64_t nc = n * C + c;
+    const int64_t ng = n * group + c / (C / group);
+    const T_ACC x = static_cast<T_ACC>(X[index]);
+    const T_ACC dy = a == nullptr
+        ? static_cast<T_ACC>(dY[index])
+        : ActivationBackward(
+              static_cast<T_ACC>(dY[index]), a[nc] * x + b[nc], activation);
+    dX[index] = c1[nc] * dy + c2[ng] * x + c3[ng];
   }
 }
 
@@ -362,6 +547,8 @@ void GroupNormKernelImplInternal(
     int64_t HxW,
     int64_t group,
     T eps,
+    GroupNormActivation activation,
+    bool channels_last,
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
@@ -386,19 +573,30 @@ void GroupNormKernelImplInternal(
   T_ACC* a_data = a.data_ptr<T_ACC>();
   T_ACC* b_data = b.data_ptr<T_ACC>();
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
-  RowwiseMomentsCUDAKernel<T>
-      <<<N * G, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
-          D * HxW, eps, X_data, mean_data, rstd_data);
+  if (channels_last) {
+    RowwiseMomentsChannelsLastCUDAKernel<T>
+        <<<N * G, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            C, HxW, G, eps, X_data, mean_data, rstd_data);
+  } else {
+    RowwiseMomentsCUDAKernel<T>
+        <<<N * G, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            D * HxW, eps, X_data, mean_data, rstd_data);
+  }
   int64_t B = (N * C + kCUDANumThreads - 1) / kCUDANumThreads;
   ComputeFusedParamsCUDAKernel<T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
       N, C, G, mean_data, rstd_data, gamma_data, beta_data, a_data, b_data);
-  if (HxW < kCUDANumThreads) {
+  if (channels_last) {
+    B = (N * C * HxW + kCUDANumThreads - 1) / kCUDANumThreads;
+    GroupNormForwardChannelsLastCUDAKernel<T>
+        <<<B, kCUDANumThreads, 0, cuda_stream>>>(
+            N, C, HxW, X_data, a_data, b_data, activation, Y_data);
+  } else if (HxW < kCUDANumThreads) {
     B = (N * C * HxW + kCUDANumThreads - 1) / kCUDANumThreads;
     GroupNormForwardSimpleCUDAKernel<T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
-        N, C, HxW, X_data, a_data, b_data, Y_data);
+        N, C, HxW, X_data, a_data, b_data, activation, Y_data);
   } else {
     GroupNormForwardCUDAKernel<T><<<N * C, kCUDANumThreads, 0, cuda_stream>>>(
-        HxW, X_data, a_data, b_data, Y_data);
+        HxW, X_data, a_data, b_data, activation, Y_data);
   }
   AT_CUDA_CHECK(cudaGetLastError());
 }
@@ -412,9 +610,14 @@ void GroupNormKernelImpl(
     int64_t HxW,
     int64_t group,
     double eps,
+    GroupNormActivation activation,
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
+  const bool channels_last = !X.is_contiguous();
+  TORCH_CHECK(
+      !channels_last || X.is_contiguous(X.suggest_memory_format()),
+      "GroupNorm expects a contiguous or channels last input");
   AT_DISPATCH_FLOATING_TYPES_AND2(
       at::ScalarType::Half,
       at::ScalarType::BFloat16,
@@ -431,6 +634,8 @@ void GroupNormKernelImpl(
               HxW,
               group,
               static_cast<scalar_t>(eps),
+              activation,
+              channels_last,
               Y,
               mean,
               rstd);
@@ -445,10 +650,13 @@ void GroupNormBackwardKernelImplInternal(
     const Tensor& mean,
     const Tensor& rstd,
     const Tensor& gamma,
+    const Tensor& beta,
     int64_t N,
     int64_t C,
     int64_t HxW,
     int64_t group,
+    GroupNormActivation activation,
+    bool channels_last,
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
@@ -459,6 +667,7 @@ void GroupNormBackwardKernelImplInternal(
   TORCH_CHECK(mean.numel() == N * G);
   TORCH_CHECK(rstd.numel() == N * G);
   TORCH_CHECK(!gamma.defined() || gamma.numel() == C);
+  TORCH_CHECK(!beta.defined() || beta.numel() == C);
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
 
   if (N == 0) {
@@ -486,10 +695,50 @@ void GroupNormBackwardKernelImplInternal(
   Tensor db = at::empty({N, C}, X.options().dtype(kAccType));
   T_ACC* ds_data = ds.data_ptr<T_ACC>();
   T_ACC* db_data = db.data_ptr<T_ACC>();
-  ComputeInternalGradientsCUDAKernel<T>
-      <<<N * C, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
-          HxW, dY_data, X_data, ds_data, db_data);
-  if (dX != nullptr) {
+
+  // The pre-activation output is a * X + b; both stay null without an
+  // activation.
+  Tensor a;
+  Tensor b;
+  T_ACC* a_data = nullptr;
+  T_ACC* b_data = nullptr;
+  if (activation != GroupNormActivation::kNone) {
+    const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+    a = at::empty({N, C}, X.options().dtype(kAccType));
+    b = at::empty({N, C}, X.options().dtype(kAccType));
+    a_data = a.data_ptr<T_ACC>();
+    b_data = b.data_ptr<T_ACC>();
+    const int64_t B = (N * C + kCUDANumThreads - 1) / kCUDANumThreads;
+    ComputeFusedParamsCUDAKernel<T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
+        N, C, G, mean_data, rstd_data, gamma_data, beta_data, a_data, b_data);
+  }
+
+  if (channels_last) {
+    const int64_t B = N * ((C + kReduceTileSize - 1) / kReduceTileSize);
+    ComputeInternalGradientsChannelsLastCUDAKernel<T>
+        <<<B, dim3(kReduceTileSize, kReduceTileSize / 2), 0, cuda_stream>>>(
+            C,
+            HxW,
+            dY_data,
+            X_data,
+            a_data,
+            b_data,
+            activation,
+            ds_data,
+            db_data);
+  } else {
+    ComputeInternalGradientsCUDAKernel<T>
+        <<<N * C, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            HxW,
+            dY_data,
+            X_data,
+            a_data,
+            b_data,
+            activation,
+            ds_data,
+            db_data);
+  }
+  if (dX_data != nullptr) {
     Tensor c1 = at::empty({N, C}, X.options().dtype(kAccType));
     Tensor c2 = at::empty({N, G}, X.options().dtype(kAccType));
     Tensor c3 = at::empty({N, G}, X.options().dtype(kAccType));
@@ -515,15 +764,55 @@ void GroupNormBackwardKernelImplInternal(
             db_data,
             c2_data,
             c3_data);
-    if (HxW < kCUDANumThreads) {
+    if (channels_last) {
       B = (N * C * HxW + kCUDANumThreads - 1) / kCUDANumThreads;
-      GroupNormBackwardSimpleCUDAKernel<
-          T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
-          N, C, HxW, G, dY_data, X_data, c1_data, c2_data, c3_data, dX_data);
+      GroupNormBackwardChannelsLastCUDAKernel<T>
+          <<<B, kCUDANumThreads, 0, cuda_stream>>>(
+              N,
+              C,
+              HxW,
+              G,
+              dY_data,
+              X_data,
+              a_data,
+              b_data,
+              c1_data,
+              c2_data,
+              c3_data,
+              activation,
+              dX_data);
+    } else if (HxW < kCUDANumThreads) {
+      B = (N * C * HxW + kCUDANumThreads - 1) / kCUDANumThreads;
+      GroupNormBackwardSimpleCUDAKernel<T>
+          <<<B, kCUDANumThreads, 0, cuda_stream>>>(
+              N,
+              C,
+              HxW,
+              G,
+              dY_data,
+              X_data,
+              a_data,
+              b_data,
+              c1_data,
+              c2_data,
+              c3_data,
+              activation,
+              dX_data);
     } else {
       GroupNormBackwardCUDAKernel<T>
           <<<N * C, kCUDANumThreads, 0, cuda_stream>>>(
-              C, HxW, G, dY_data, X_data, c1_data, c2_data, c3_data, dX_data);
+              C,
+              HxW,
+              G,
+              dY_data,
+              X_data,
+              a_data,
+              b_data,
+              c1_data,
+              c2_data,
+              c3_data,
+              activation,
+              dX_data);
     }
   }
   if (dgamma->defined() || dbeta->defined()) {
@@ -569,13 +858,21 @@ void GroupNormBackwardKernelImpl(
     const Tensor& mean,
     const Tensor& rstd,
     const Tensor& gamma,
+    const Tensor& beta,
     int64_t N,
     int64_t C,
     int64_t HxW,
     int64_t group,
+    GroupNormActivation activation,
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
+  const bool channels_last = !X.is_contiguous();
+  TORCH_CHECK(
+      !channels_last ||
+          (X.is_contiguous(X.suggest_memory_format()) &&
+           dY.is_contiguous(X.suggest_memory_format())),
+      "GroupNorm backward expects dY and X both contiguous or both channels last");
   AT_DISPATCH_FLOATING_TYPES_AND2(
       at::ScalarType::Half,
       at::ScalarType::BFloat16,
@@ -590,10 +887,13 @@ void GroupNormBackwardKernelImpl(
                   mean,
                   rstd,
                   gamma,
+                  beta,
                   N,
                   C,
                   HxW,
                   group,
+                  activation,
+                  channels_last,
                   dX,
                   dgamma,
                   dbeta);
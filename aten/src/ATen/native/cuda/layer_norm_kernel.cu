@@ -4,13 +4,20 @@
 #include <ATen/AccumulateType.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/cuda/Autotune.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 #include <ATen/native/cuda/block_reduce.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
 namespace at {
 namespace native {
 
@@ -254,6 +261,295 @@ __global__ void GammaBetaBackwardCUDAKernel(
   }
 }
 
+// Fused kernels for rows whose N is a multiple of kFusedVecSize and of at
+// most kFusedMaxN elements, the common case of transformer hidden sizes. A
+// block handles a row at a time and holds it in registers, as up to
+// kFused*MaxVecsPerThread vectors of kFusedVecSize elements per thread, so
+// that the row is read from global memory once. The block size is the
+// smallest multiple of the warp size that fits the row, which is a single
+// warp for small rows.
+constexpr int kFusedVecSize = 4;
+constexpr int kFusedForwardMaxVecsPerThread = 8;
+constexpr int kFusedForwardMaxNumThreads = 256;
+constexpr int kFusedBackwardMaxVecsPerThread = 4;
+constexpr int kFusedBackwardMaxNumThreads = 512;
+
+template <typename T_ACC>
+__device__ void BlockAllReduceSum(T_ACC* a, T_ACC* b, T_ACC* shared) {
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  T_ACC sum_a = cuda_utils::WarpReduceSum(*a);
+  T_ACC sum_b = cuda_utils::WarpReduceSum(*b);
+  __syncthreads();
+  if (lid == 0) {
+    shared[wid] = sum_a;
+    shared[wid + C10_WARP_SIZE] = sum_b;
+  }
+  __syncthreads();
+  if (wid == 0) {
+    const bool valid = lid < blockDim.x / C10_WARP_SIZE;
+    sum_a = cuda_utils::WarpReduceSum(valid ? shared[lid] : T_ACC(0));
+    sum_b = cuda_utils::WarpReduceSum(
+        valid ? shared[lid + C10_WARP_SIZE] : T_ACC(0));
+    if (lid == 0) {
+      shared[0] = sum_a;
+      shared[C10_WARP_SIZE] = sum_b;
+    }
+  }
+  __syncthreads();
+  *a = shared[0];
+  *b = shared[C10_WARP_SIZE];
+}
+
+// Computes the moments of row blockIdx.x and normalizes it in one pass.
+template <typename T>
+__global__ void LayerNormFusedForwardCUDAKernel(
+    int64_t N,
+    acc_type<T, true> eps,
+    const T* X,
+    const T* gamma,
+    const T* beta,
+    T* Y,
+    T* mean,
+    T* rstd) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, kFusedVecSize>;
+  __shared__ cuda_utils::WelfordStats<T_ACC> stats_shared[C10_WARP_SIZE];
+  const int64_t i = blockIdx.x;
+  const int num_vecs = N / kFusedVecSize;
+  const vec_t* X_vec = reinterpret_cast<const vec_t*>(X + i * N);
+
+  T_ACC x[kFusedForwardMaxVecsPerThread][kFusedVecSize];
+  T_ACC sum = 0;
+  int count = 0;
+#pragma unroll
+  for (int c = 0; c < kFusedForwardMaxVecsPerThread; ++c) {
+    const int v = threadIdx.x + c * blockDim.x;
+    if (v < num_vecs) {
+      const vec_t data = X_vec[v];
+#pragma unroll
+      for (int k = 0; k < kFusedVecSize; ++k) {
+        x[c][k] = static_cast<T_ACC>(data.val[k]);
+        sum += x[c][k];
+      }
+      count += kFusedVecSize;
+    }
+  }
+  // The values of a thread are in registers, so their moments are computed
+  // in two passes; Welford's combination merges the moments of the threads.
+  cuda_utils::WelfordStats<T_ACC> stats = {
+      static_cast<T_ACC>(count),
+      count > 0 ? sum / static_cast<T_ACC>(count) : T_ACC(0),
+      T_ACC(0)};
+#pragma unroll
+  for (int c = 0; c < kFusedForwardMaxVecsPerThread; ++c) {
+    if (threadIdx.x + c * blockDim.x < num_vecs) {
+#pragma unroll
+      for (int k = 0; k < kFusedVecSize; ++k) {
+        const T_ACC delta = x[c][k] - stats.mean;
+        stats.m2 += delta * delta;
+      }
+    }
+  }
+  stats = cuda_utils::BlockWelfordReduce(stats, stats_shared);
+  const T_ACC row_mean = stats.mean;
+  const T_ACC row_rstd = c10::cuda::compat::rsqrt(
+      c10::cuda::compat::max(stats.m2 / static_cast<T_ACC>(N), T_ACC(0)) +
+      eps);
+  if (threadIdx.x == 0) {
+    mean[i] = row_mean;
+    rstd[i] = row_rstd;
+  }
+
+  const vec_t* gamma_vec = reinterpret_cast<const vec_t*>(gamma);
+  const vec_t* beta_vec = reinterpret_cast<const vec_t*>(beta);
+  vec_t* Y_vec = reinterpret_cast<vec_t*>(Y + i * N);
+#pragma unroll
+  for (int c = 0; c < kFusedForwardMaxVecsPerThread; ++c) {
+    const int v = threadIdx.x + c * blockDim.x;
+    if (v < num_vecs) {
+      vec_t gamma_v;
+      vec_t beta_v;
+      if (gamma != nullptr) {
+        gamma_v = gamma_vec[v];
+      }
+      if (beta != nullptr) {
+        beta_v = beta_vec[v];
+      }
+      vec_t out;
+#pragma unroll
+      for (int k = 0; k < kFusedVecSize; ++k) {
+        const T_ACC g =
+            gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma_v.val[k]);
+        const T_ACC b =
+            beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta_v.val[k]);
+        out.val[k] = static_cast<T>((x[c][k] - row_mean) * row_rstd * g + b);
+      }
+      Y_vec[v] = out;
+    }
+  }
+}
+
+// Computes dX of rows blockIdx.x, blockIdx.x + gridDim.x, ..., reading dY
+// and X once, and the sums of the dgamma and dbeta terms of these rows into
+// dgamma_partial[blockIdx.x] and dbeta_partial[blockIdx.x], when not null:
+//
+//   x_hat = (X - mean) * rstd
+//   g     = dY * gamma
+//   dX    = rstd * (g - mean(g) - x_hat * mean(g * x_hat))
+template <typename T>
+__global__ void LayerNormFusedBackwardCUDAKernel(
+    int64_t M,
+    int64_t N,
+    const T* dY,
+    const T* X,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    T* dX,
+    acc_type<T, true>* dgamma_partial,
+    acc_type<T, true>* dbeta_partial) {
+  using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, kFusedVecSize>;
+  __shared__ T_ACC sum_shared[2 * C10_WARP_SIZE];
+  const int num_vecs = N / kFusedVecSize;
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+  const vec_t* gamma_vec = reinterpret_cast<const vec_t*>(gamma);
+
+  T_ACC dgamma_sum[kFusedBackwardMaxVecsPerThread][kFusedVecSize];
+  T_ACC dbeta_sum[kFusedBackwardMaxVecsPerThread][kFusedVecSize];
+#pragma unroll
+  for (int c = 0; c < kFusedBackwardMaxVecsPerThread; ++c) {
+#pragma unroll
+    for (int k = 0; k < kFusedVecSize; ++k) {
+      dgamma_sum[c][k] = 0;
+      dbeta_sum[c][k] = 0;
+    }
+  }
+
+  for (int64_t i = blockIdx.x; i < M; i += gridDim.x) {
+    const vec_t* dY_vec = reinterpret_cast<const vec_t*>(dY + i * N);
+    const vec_t* X_vec = reinterpret_cast<const vec_t*>(X + i * N);
+    const T_ACC row_mean = static_cast<T_ACC>(mean[i]);
+    const T_ACC row_rstd = static_cast<T_ACC>(rstd[i]);
+    T_ACC x_hat[kFusedBackwardMaxVecsPerThread][kFusedVecSize];
+    T_ACC g[kFusedBackwardMaxVecsPerThread][kFusedVecSize];
+    T_ACC sum_g = 0;
+    T_ACC sum_g_x_hat = 0;
+#pragma unroll
+    for (int c = 0; c < kFusedBackwardMaxVecsPerThread; ++c) {
+      const int v = threadIdx.x + c * blockDim.x;
+      if (v < num_vecs) {
+        const vec_t dY_v = dY_vec[v];
+        const vec_t X_v = X_vec[v];
+        vec_t gamma_v;
+        if (gamma != nullptr) {
+          gamma_v = gamma_vec[v];
+        }
+#pragma unroll
+        for (int k = 0; k < kFusedVecSize; ++k) {
+          const T_ACC dy = static_cast<T_ACC>(dY_v.val[k]);
+          x_hat[c][k] = (static_cast<T_ACC>(X_v.val[k]) - row_mean) * row_rstd;
+          g[c][k] = gamma == nullptr
+              ? dy
+              : dy * static_cast<T_ACC>(gamma_v.val[k]);
+          sum_g += g[c][k];
+          sum_g_x_hat += g[c][k] * x_hat[c][k];
+          dgamma_sum[c][k] += dy * x_hat[c][k];
+          dbeta_sum[c][k] += dy;
+        }
+      }
+    }
+    BlockAllReduceSum(&sum_g, &sum_g_x_hat, sum_shared);
+    sum_g *= scale;
+    sum_g_x_hat *= scale;
+    vec_t* dX_vec = reinterpret_cast<vec_t*>(dX + i * N);
+#pragma unroll
+    for (int c = 0; c < kFusedBackwardMaxVecsPerThread; ++c) {
+      const int v = threadIdx.x + c * blockDim.x;
+      if (v < num_vecs) {
+        vec_t out;
+#pragma unroll
+        for (int k = 0; k < kFusedVecSize; ++k) {
+          out.val[k] = static_cast<T>(
+              row_rstd * (g[c][k] - sum_g - x_hat[c][k] * sum_g_x_hat));
+        }
+        dX_vec[v] = out;
+      }
+    }
+  }
+
+#pragma unroll
+  for (int c = 0; c < kFusedBackwardMaxVecsPerThread; ++c) {
+    const int v = threadIdx.x + c * blockDim.x;
+    if (v < num_vecs) {
+#pragma unroll
+      for (int k = 0; k < kFusedVecSize; ++k) {
+        const int64_t index = blockIdx.x * N + v * kFusedVecSize + k;
+        if (dgamma_partial != nullptr) {
+          dgamma_partial[index] = dgamma_sum[c][k];
+        }
+        if (dbeta_partial != nullptr) {
+          dbeta_partial[index] = dbeta_sum[c][k];
+        }
+      }
+    }
+  }
+}
+
+// Sums the G rows of partial sums left by LayerNormFusedBackwardCUDAKernel.
+template <typename T>
+__global__ void GammaBetaPartialsReduceCUDAKernel(
+    int64_t G,
+    int64_t N,
+    const acc_type<T, true>* dgamma_partial,
+    const acc_type<T, true>* dbeta_partial,
+    T* dg,
+    T* db) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t j = blockIdx.x * blockDim.x + threadIdx.x;
+  if (j < N) {
+    T_ACC sum1 = 0;
+    T_ACC sum2 = 0;
+    for (int64_t i = 0; i < G; ++i) {
+      sum1 += dg == nullptr ? T_ACC(0) : dgamma_partial[i * N + j];
+      sum2 += db == nullptr ? T_ACC(0) : dbeta_partial[i * N + j];
+    }
+    if (dg != nullptr) {
+      dg[j] = sum1;
+    }
+    if (db != nullptr) {
+      db[j] = sum2;
+    }
+  }
+}
+
+// Block size of the fused kernels for rows of N elements, as described
+// above, or 0 if they don't handle such rows.
+template <typename T>
+int FusedNumThreads(
+    int64_t N,
+    int max_vecs_per_thread,
+    int max_num_threads,
+    std::initializer_list<const void*> pointers) {
+  // double rows don't fit in the registers
+  if (std::is_same<T, double>::value || N % kFusedVecSize != 0) {
+    return 0;
+  }
+  for (const void* ptr : pointers) {
+    if (ptr != nullptr &&
+        reinterpret_cast<uintptr_t>(ptr) % (sizeof(T) * kFusedVecSize) != 0) {
+      return 0;
+    }
+  }
+  const int64_t num_vecs = N / kFusedVecSize;
+  const int64_t num_threads =
+      (num_vecs + max_vecs_per_thread - 1) / max_vecs_per_thread;
+  const int64_t num_warps = (num_threads + C10_WARP_SIZE - 1) / C10_WARP_SIZE;
+  const int64_t result = std::max<int64_t>(num_warps, 1) * C10_WARP_SIZE;
+  return result <= max_num_threads ? static_cast<int>(result) : 0;
+}
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -275,12 +571,31 @@ void LayerNormKernelImplInternal(
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  const int fused_num_threads = FusedNumThreads<T>(
+      N,
+      kFusedForwardMaxVecsPerThread,
+      kFusedForwardMaxNumThreads,
+      {X_data, gamma_data, beta_data, Y_data});
+  if (fused_num_threads > 0) {
+    LayerNormFusedForwardCUDAKernel<T>
+        <<<M, fused_num_threads, 0, cuda_stream>>>(
+            N, eps, X_data, gamma_data, beta_data, Y_data, mean_data, rstd_data);
+    AT_CUDA_CHECK(cudaGetLastError());
+    return;
+  }
   RowwiseMomentsCUDAKernel<T>
       <<<M, cuda_utils::kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
           N, eps, X_data, mean_data, rstd_data);
-  LayerNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
-      N, X_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
   AT_CUDA_CHECK(cudaGetLastError());
+  // The kernel loops over the N features of a row with the threads of its
+  // block, so the best block size depends on N.
+  static auto& forward_op = at::cuda::autotune::registerTunableOp(
+      "layer_norm_forward", {{"block_size", {kCUDANumThreads, 128, 512, 1024}}});
+  forward_op.run({M, N}, X.scalar_type(), [&](const at::cuda::autotune::Config& config) {
+    LayerNormForwardCUDAKernel<T><<<M, config[0], 0, cuda_stream>>>(
+        N, X_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
 }
 
 void LayerNormKernelImpl(
@@ -328,6 +643,61 @@ void LayerNormBackwardKernelImplInternal(
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  const int fused_num_threads = dX_data == nullptr
+      ? 0
+      : FusedNumThreads<T>(
+            N,
+            kFusedBackwardMaxVecsPerThread,
+            kFusedBackwardMaxNumThreads,
+            {dY_data, X_data, gamma_data, dX_data});
+  if (fused_num_threads > 0) {
+    // Enough blocks to fill the GPU, each summing the dgamma and dbeta terms
+    // of its rows into a row of partial sums
+    const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+    const int64_t G = std::min<int64_t>(
+        M,
+        static_cast<int64_t>(prop->multiProcessorCount) *
+            (prop->maxThreadsPerMultiProcessor / fused_num_threads));
+    const auto kAccType = (X.scalar_type() == kHalf || X.scalar_type() == kBFloat16) ? kFloat : X.scalar_type();
+    Tensor dgamma_partial = dgamma->defined()
+        ? at::empty({G, N}, X.options().dtype(kAccType))
+        : Tensor();
+    Tensor dbeta_partial = dbeta->defined()
+        ? at::empty({G, N}, X.options().dtype(kAccType))
+        : Tensor();
+    T_ACC* dgamma_partial_data = dgamma_partial.defined()
+        ? dgamma_partial.template data_ptr<T_ACC>()
+        : nullptr;
+    T_ACC* dbeta_partial_data = dbeta_partial.defined()
+        ? dbeta_partial.template data_ptr<T_ACC>()
+        : nullptr;
+    LayerNormFusedBackwardCUDAKernel<T>
+        <<<G, fused_num_threads, 0, cuda_stream>>>(
+            M,
+            N,
+            dY_data,
+            X_data,
+            mean_data,
+            rstd_data,
+            gamma_data,
+            dX_data,
+            dgamma_partial_data,
+            dbeta_partial_data);
+    AT_CUDA_CHECK(cudaGetLastError());
+    if (dgamma->defined() || dbeta->defined()) {
+      const int64_t B = (N + kCUDANumThreads - 1) / kCUDANumThreads;
+      GammaBetaPartialsReduceCUDAKernel<T>
+          <<<B, kCUDANumThreads, 0, cuda_stream>>>(
+              G,
+              N,
+              dgamma_partial_data,
+              dbeta_partial_data,
+              dgamma->defined() ? dgamma->template data_ptr<T>() : nullptr,
+              dbeta->defined() ? dbeta->template data_ptr<T>() : nullptr);
+      AT_CUDA_CHECK(cudaGetLastError());
+    }
+    return;
+  }
   if (dX_data != nullptr) {
     const auto kAccType = (X.scalar_type() == kHalf || X.scalar_type() == kBFloat16) ? kFloat : X.scalar_type();
     Tensor ds = at::empty({M}, X.options().dtype(kAccType));
@@ -7,6 +7,7 @@
 #include <ATen/cuda/CUDAConfig.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/cudnn/ConvAlgorithmCache.h>
 
 #if !AT_CUDNN_ENABLED()
 
@@ -70,6 +71,28 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
   AT_ERROR("cudnn_convolution_transpose_backward: ATen not compiled with cuDNN support");
 }
 
+at::Tensor cudnn_convolution_relu(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    int64_t groups) {
+  AT_ERROR("cudnn_convolution_relu: ATen not compiled with cuDNN support");
+}
+
+at::Tensor cudnn_convolution_add_relu(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& z,
+    Scalar alpha, const at::Tensor& bias, IntArrayRef stride,
+    IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  AT_ERROR("cudnn_convolution_add_relu: ATen not compiled with cuDNN support");
+}
+
+void cudnn_save_algorithm_cache(const std::string& path) {
+  AT_ERROR("cudnn_save_algorithm_cache: ATen not compiled with cuDNN support");
+}
+
+int64_t cudnn_load_algorithm_cache(const std::string& path) {
+  AT_ERROR("cudnn_load_algorithm_cache: ATen not compiled with cuDNN support");
+}
+
 }}
 
 #else  // AT_CUDNN_ENABLED
@@ -82,16 +105,28 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <ATen/cudnn/Utils.h>
 #include <ATen/native/utils/ParamsHash.h>
 
+#include <ATen/ExpandUtils.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
 
 #include <functional>
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
 #include <unordered_map>
+#include <utility>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 // Note [behavior of cudnnFind and cudnnGet]
 // You'll notice that by default, in the ConvolutionDescriptor, we do the following:
@@ -215,6 +250,9 @@ struct ConvolutionParams
   int dilation[max_dim];
   int64_t groups;
   bool deterministic;
+  // The best algorithm depends on the GPU, and the saved algorithm cache
+  // refers to it (see cudnn_load_algorithm_cache).
+  int device_id;
   // NB: transposed purposely omitted: transposed just swaps
   // forward and backward, so you can reuse the benchmark entry,
 };
@@ -250,6 +288,7 @@ void setConvolutionParams(
   // CuDNN, but it doesn't seem worth the effort to actually do this.
   params->groups = groups;
   params->deterministic = deterministic;
+  params->device_id = input.get_device();
 }
 
 // Convenience struct for passing around descriptors and data
@@ -292,12 +331,240 @@ struct BenchmarkCache {
     std::lock_guard<std::mutex> guard(mutex);
     map[params] = results;
   }
+
+  // Unlike insert, keeps the entry already cached for params, if any.
+  // Returns whether results was added.
+  bool insert_if_absent(const ConvolutionParams& params, const T& results) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return map.emplace(params, results).second;
+  }
+
+  std::vector<std::pair<ConvolutionParams, T>> entries() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return std::vector<std::pair<ConvolutionParams, T>>(map.begin(), map.end());
+  }
 };
 
 BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// ---------------------------------------------------------------------
+//
+// Algorithm cache serialization
+//
+// ---------------------------------------------------------------------
+
+// A saved algorithm cache holds, in native byte order:
+//
+//   AlgorithmCacheHeader
+//   num_devices x AlgorithmCacheDevice      (indexed by device_id)
+//   fwd, bwd data and bwd filter tables, each a uint64_t count followed by
+//   count x (ConvolutionParams, perf_t)
+//
+// ConvolutionParams and the perf structs are written as their raw bytes,
+// which is why the file records the cuDNN version and the struct sizes.
+
+constexpr uint32_t kAlgorithmCacheMagic = 0x6e647563;  // "cudn"
+// Bump whenever ConvolutionParams or the layout above change.
+constexpr uint32_t kAlgorithmCacheFormatVersion = 1;
+
+struct AlgorithmCacheHeader {
+  uint32_t magic;
+  uint32_t format_version;
+  uint64_t cudnn_version;
+  uint32_t params_size;
+  uint32_t fwd_perf_size;
+  uint32_t bwd_data_perf_size;
+  uint32_t bwd_filter_perf_size;
+  uint32_t num_devices;
+};
+
+struct AlgorithmCacheDevice {
+  char name[256];
+  int32_t major;
+  int32_t minor;
+};
+
+AlgorithmCacheHeader currentAlgorithmCacheHeader() {
+  AlgorithmCacheHeader header;
+  // Zero the padding too, so that saving the same cache gives the same file
+  memset(&header, 0, sizeof(header));
+  header.magic = kAlgorithmCacheMagic;
+  header.format_version = kAlgorithmCacheFormatVersion;
+  header.cudnn_version = cudnnGetVersion();
+  header.params_size = sizeof(ConvolutionParams);
+  header.fwd_perf_size = sizeof(cudnnConvolutionFwdAlgoPerf_t);
+  header.bwd_data_perf_size = sizeof(cudnnConvolutionBwdDataAlgoPerf_t);
+  header.bwd_filter_perf_size = sizeof(cudnnConvolutionBwdFilterAlgoPerf_t);
+  header.num_devices = at::cuda::device_count();
+  return header;
+}
+
+AlgorithmCacheDevice localAlgorithmCacheDevice(int device) {
+  const cudaDeviceProp* prop = at::cuda::getDeviceProperties(device);
+  AlgorithmCacheDevice result;
+  memset(&result, 0, sizeof(result));
+  strncpy(result.name, prop->name, sizeof(result.name) - 1);
+  result.major = prop->major;
+  result.minor = prop->minor;
+  return result;
+}
+
+template <typename T>
+void writePOD(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readPOD(std::istream& in, T* value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(value), sizeof(T)));
+}
+
+template <typename perf_t>
+void writeAlgorithmTable(std::ostream& out, BenchmarkCache<perf_t>& cache) {
+  auto entries = cache.entries();
+  writePOD(out, static_cast<uint64_t>(entries.size()));
+  for (const auto& entry : entries) {
+    writePOD(out, entry.first);
+    writePOD(out, entry.second);
+  }
+}
+
+// Reads a table into entries, dropping the ones of devices that are not
+// compatible or algorithms this build doesn't know about. Returns false if
+// the file is truncated.
+template <typename perf_t, typename algo_t>
+bool readAlgorithmTable(
+    std::istream& in,
+    const std::vector<bool>& compatible_devices,
+    algo_t algo_count,
+    std::vector<std::pair<ConvolutionParams, perf_t>>* entries) {
+  uint64_t count;
+  if (!readPOD(in, &count)) {
+    return false;
+  }
+  for (uint64_t i = 0; i < count; i++) {
+    std::pair<ConvolutionParams, perf_t> entry;
+    if (!readPOD(in, &entry.first) || !readPOD(in, &entry.second)) {
+      return false;
+    }
+    const int device = entry.first.device_id;
+    if (device < 0 || device >= static_cast<int>(compatible_devices.size()) ||
+        !compatible_devices[device] ||
+        entry.second.status != CUDNN_STATUS_SUCCESS ||
+        entry.second.algo < 0 || entry.second.algo >= algo_count) {
+      continue;
+    }
+    entries->push_back(entry);
+  }
+  return true;
+}
+
+template <typename perf_t>
+int64_t insertAlgorithms(
+    BenchmarkCache<perf_t>& cache,
+    const std::vector<std::pair<ConvolutionParams, perf_t>>& entries) {
+  int64_t inserted = 0;
+  for (const auto& entry : entries) {
+    // What this process benchmarked itself is at least as good a choice
+    inserted += cache.insert_if_absent(entry.first, entry.second);
+  }
+  return inserted;
+}
+
+
+void cudnn_save_algorithm_cache(const std::string& path) {
+  const AlgorithmCacheHeader header = currentAlgorithmCacheHeader();
+#ifdef _WIN32
+  const auto tmp_path = c10::str(path, ".tmp.", _getpid());
+#else
+  const auto tmp_path = c10::str(path, ".tmp.", getpid());
+#endif
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    TORCH_CHECK(out, "cudnn_save_algorithm_cache: can't open ", tmp_path, " for writing");
+    writePOD(out, header);
+    for (uint32_t device = 0; device < header.num_devices; device++) {
+      writePOD(out, localAlgorithmCacheDevice(device));
+    }
+    writeAlgorithmTable(out, fwd_algos);
+    writeAlgorithmTable(out, bwd_data_algos);
+    writeAlgorithmTable(out, bwd_filter_algos);
+    out.close();
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      TORCH_CHECK(false, "cudnn_save_algorithm_cache: failed to write ", tmp_path);
+    }
+  }
+  // Readers see either the previous cache or the whole new one
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+#ifdef _WIN32
+    // rename doesn't replace an existing file on Windows
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) == 0) {
+      return;
+    }
+#endif
+    std::remove(tmp_path.c_str());
+    TORCH_CHECK(false, "cudnn_save_algorithm_cache: failed to rename ", tmp_path, " to ", path);
+  }
+}
+
+int64_t cudnn_load_algorithm_cache(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return 0;
+  }
+  const AlgorithmCacheHeader expected = currentAlgorithmCacheHeader();
+  AlgorithmCacheHeader header;
+  if (!readPOD(in, &header) || header.magic != kAlgorithmCacheMagic) {
+    TORCH_WARN("Ignoring the cuDNN algorithm cache ", path, ": not an algorithm cache file");
+    return 0;
+  }
+  if (header.format_version != expected.format_version ||
+      header.cudnn_version != expected.cudnn_version ||
+      header.params_size != expected.params_size ||
+      header.fwd_perf_size != expected.fwd_perf_size ||
+      header.bwd_data_perf_size != expected.bwd_data_perf_size ||
+      header.bwd_filter_perf_size != expected.bwd_filter_perf_size) {
+    TORCH_WARN(
+        "Ignoring the cuDNN algorithm cache ", path, ": it was saved with cuDNN ",
+        header.cudnn_version, " (format ", header.format_version, "), but cuDNN ",
+        expected.cudnn_version, " (format ", expected.format_version, ") is in use");
+    return 0;
+  }
+
+  // Entries of a device index are only valid if it is the same kind of GPU
+  std::vector<bool> compatible_devices(header.num_devices, false);
+  for (uint32_t device = 0; device < header.num_devices; device++) {
+    AlgorithmCacheDevice saved;
+    if (!readPOD(in, &saved)) {
+      TORCH_WARN("Ignoring the cuDNN algorithm cache ", path, ": file is truncated");
+      return 0;
+    }
+    if (device < expected.num_devices) {
+      const AlgorithmCacheDevice local = localAlgorithmCacheDevice(device);
+      compatible_devices[device] = strncmp(saved.name, local.name, sizeof(saved.name)) == 0 &&
+          saved.major == local.major && saved.minor == local.minor;
+    }
+  }
+
+  // Only touch the caches once the whole file was read successfully
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionFwdAlgoPerf_t>> fwd;
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionBwdDataAlgoPerf_t>> bwd_data;
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionBwdFilterAlgoPerf_t>> bwd_filter;
+  if (!readAlgorithmTable(in, compatible_devices, CUDNN_CONVOLUTION_FWD_ALGO_COUNT, &fwd) ||
+      !readAlgorithmTable(in, compatible_devices, CUDNN_CONVOLUTION_BWD_DATA_ALGO_COUNT, &bwd_data) ||
+      !readAlgorithmTable(in, compatible_devices, CUDNN_CONVOLUTION_BWD_FILTER_ALGO_COUNT, &bwd_filter)) {
+    TORCH_WARN("Ignoring the cuDNN algorithm cache ", path, ": file is truncated");
+    return 0;
+  }
+  return insertAlgorithms(fwd_algos, fwd) +
+      insertAlgorithms(bwd_data_algos, bwd_data) +
+      insertAlgorithms(bwd_filter_algos, bwd_filter);
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
@@ -906,6 +1173,159 @@ Tensor cudnn_convolution(
   return output_t;
 }
 
+// ---------------------------------------------------------------------
+//
+// Convolution with bias, add and relu epilogue
+//
+// ---------------------------------------------------------------------
+
+// Computes output = relu(conv(input, weight) + alpha * z + bias) with a single
+// cudnnConvolutionBiasActivationForward call, reusing the forward algorithms
+// benchmarked for plain convolutions. z must have the sizes and the layout of
+// output and may be output itself, and bias must hold one value per output
+// channel. Like raw_cudnn_convolution_forward_out_32bit, this does no checks.
+void raw_cudnn_convolution_add_relu_out(
+    const Tensor& output, const Tensor& input, const Tensor& weight,
+    const Tensor& z, double alpha, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups,
+    bool benchmark, bool deterministic) {
+
+  auto dataType = getCudnnDataType(input);
+
+  ConvolutionArgs args{ input, output, weight };
+  args.handle = getCudnnHandle();
+  setConvolutionParams(&args.params, input, weight, padding, stride, dilation, groups, deterministic);
+  args.idesc.set(input);
+  args.wdesc.set(weight, 0, input.suggest_memory_format()==at::MemoryFormat::ChannelsLast);
+  args.odesc.set(output);
+  args.cdesc.set(dataType, input.dim() - 2, args.params.padding, args.params.stride, args.params.dilation, args.params.groups);
+
+  TensorDescriptor zdesc;
+  zdesc.set(z);
+  TensorDescriptor bdesc;
+  bdesc.set(reshape_bias(input.dim(), bias));
+  ActivationDescriptor adesc;
+  adesc.set(CUDNN_ACTIVATION_RELU);
+
+  AlgoIterator<cudnnConvolutionFwdAlgoPerf_t>(args, benchmark).try_all(
+    [&](const cudnnConvolutionFwdAlgoPerf_t &fwdAlgPerf){
+      Tensor workspace = allocate_workspace(fwdAlgPerf.memory, input);
+
+      // See Note [behavior of cudnnFind and cudnnGet]
+      AT_CUDNN_CHECK(cudnnSetConvolutionMathType(args.cdesc.mut_desc(), fwdAlgPerf.mathType));
+
+      Constant one(dataType, 1);
+      Constant alpha2(dataType, alpha);
+
+      AT_CUDNN_CHECK(cudnnConvolutionBiasActivationForward(
+        args.handle,
+        &one, args.idesc.desc(), input.data_ptr(),
+        args.wdesc.desc(), weight.data_ptr(),
+        args.cdesc.desc(), fwdAlgPerf.algo, workspace.data_ptr(), fwdAlgPerf.memory,
+        &alpha2, zdesc.desc(), z.data_ptr(),
+        bdesc.desc(), bias.data_ptr(),
+        adesc.desc(),
+        args.odesc.desc(), output.data_ptr()));
+      }
+  );
+}
+
+// The unfused equivalent, for the inputs the cuDNN epilogue can't take.
+Tensor cudnn_convolution_add_relu_fallback(
+    const Tensor& input, const Tensor& weight, const Tensor& z, Scalar alpha,
+    const Tensor& bias, IntArrayRef stride, IntArrayRef padding,
+    IntArrayRef dilation, int64_t groups) {
+  auto output = at::convolution(
+      input, weight, bias, stride, padding, dilation,
+      /*transposed=*/false, std::vector<int64_t>(stride.size(), 0), groups);
+  if (z.defined()) {
+    output = at::add(output, z, alpha);
+  }
+  return output.relu_();
+}
+
+// Shared by cudnn_convolution_relu (z undefined) and cudnn_convolution_add_relu
+Tensor cudnn_convolution_add_relu_impl(
+    CheckedFrom c,
+    const Tensor& input_t, const Tensor& weight_t, const Tensor& z_t,
+    Scalar alpha, const Tensor& bias_t, IntArrayRef stride,
+    IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  auto& ctx = at::globalContext();
+  auto output_sizes = conv_output_size(
+      input_t.sizes(), weight_t.sizes(), padding, stride, dilation);
+  const auto dtype = input_t.scalar_type();
+  // z has to be added as is, so the conv2d + add it replaces must not have
+  // broadcast the convolution or promoted its type
+  const bool z_fits = !z_t.defined() ||
+      (z_t.scalar_type() == dtype &&
+       infer_size(z_t.sizes(), output_sizes) == output_sizes);
+  if (!ctx.userEnabledCuDNN() || !z_fits ||
+      !(dtype == kFloat || dtype == kHalf || dtype == kDouble) ||
+      input_t.numel() > std::numeric_limits<int>::max() ||
+      prod_intlist(output_sizes) > std::numeric_limits<int>::max()) {
+    return cudnn_convolution_add_relu_fallback(
+        input_t, weight_t, z_t, alpha, bias_t, stride, padding, dilation, groups);
+  }
+
+  TensorArg input  { input_t,  "input",  1 },
+            weight { weight_t, "weight", 2 };
+  checkAllSameType(c, {input, weight});
+  checkAllSameGPU(c, {input, weight});
+
+  auto layout = cudnn_conv_use_channels_last(input_t, weight_t) ?
+      at::MemoryFormat::ChannelsLast : at::MemoryFormat::Contiguous;
+  auto output_t = at::empty(output_sizes, input_t.options(), layout);
+  if (output_t.numel() == 0) {
+    return output_t;
+  }
+
+  TensorArg output{ output_t, "result", 0 };
+  convolution_shape_check(c, input, weight, output, padding, stride, dilation, groups);
+
+  // See #4500
+  Tensor weight_contig = weight_t.contiguous(layout);
+  // Make sure that NC11 strides follow formula
+  weight_contig.resize_(weight_contig.sizes(), layout);
+  Tensor input_contig = input_t.contiguous(layout);
+  input_contig.resize_(input_contig.sizes(), layout);
+
+  // Without z, the output is passed as z and scaled by zero
+  Tensor z = output_t;
+  double z_alpha = 0;
+  if (z_t.defined()) {
+    z = z_t.expand(output_sizes).contiguous(layout);
+    z_alpha = alpha.toDouble();
+  }
+  Tensor bias = bias_t.defined() ?
+      bias_t.contiguous() : at::zeros({output_t.size(1)}, output_t.options());
+
+  raw_cudnn_convolution_add_relu_out(
+      output_t, input_contig, weight_contig, z, z_alpha, bias,
+      stride, padding, dilation, groups, ctx.benchmarkCuDNN(),
+      ctx.deterministicCuDNN() || ctx.deterministic());
+  return output_t;
+}
+
+Tensor cudnn_convolution_relu(
+    const Tensor& input_t, const Tensor& weight_t, const Tensor& bias_t,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    int64_t groups)
+{
+  return cudnn_convolution_add_relu_impl(
+      "cudnn_convolution_relu", input_t, weight_t, Tensor(), 0, bias_t,
+      stride, padding, dilation, groups);
+}
+
+Tensor cudnn_convolution_add_relu(
+    const Tensor& input_t, const Tensor& weight_t, const Tensor& z_t,
+    Scalar alpha, const Tensor& bias_t, IntArrayRef stride,
+    IntArrayRef padding, IntArrayRef dilation, int64_t groups)
+{
+  return cudnn_convolution_add_relu_impl(
+      "cudnn_convolution_add_relu", input_t, weight_t, z_t, alpha, bias_t,
+      stride, padding, dilation, groups);
+}
+
 // NB: output_padding not needed here, as there is no ambiguity to
 // resolve
 Tensor cudnn_convolution_transpose_backward_input(
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <cstdint>
+#include <string>
+
+namespace at { namespace native {
+
+// The algorithms picked for cuDNN convolutions (found by cudnnFind* when
+// benchmark=True, or by the cudnnGet* heuristics otherwise) are cached in
+// memory for the lifetime of the process. These functions persist that cache,
+// so that processes running the same model on the same hardware can skip the
+// benchmarking.
+//
+// Entries are keyed by the convolution parameters and the device they were
+// found on; a saved cache is only loaded by the same cuDNN version, and its
+// entries only for devices of the same name and compute capability.
+
+// Writes every cached algorithm to path, replacing it atomically.
+TORCH_CUDA_API void cudnn_save_algorithm_cache(const std::string& path);
+
+// Adds the algorithms saved at path to the cache, keeping the ones already
+// found by this process, and returns how many were added. Returns 0, with a
+// warning when it exists, if path can't be read or was saved by an
+// incompatible build.
+TORCH_CUDA_API int64_t cudnn_load_algorithm_cache(const std::string& path);
+
+}}  // namespace at::native
@@ -63,6 +63,12 @@ Tensor _cudnn_init_dropout_state(double dropout, bool train, int64_t dropout_see
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
 #include <ATen/cudnn/Utils.h>
+#include <ATen/native/utils/ParamsHash.h>
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace at { namespace native {
 
@@ -605,6 +611,158 @@ namespace {
     return dtype;
   }
 
+  // RNN plans
+  //
+  // The descriptors of an RNN call only depend on its configuration and on
+  // the shape of its input, yet setting them up (the RNN descriptor, the
+  // restore of the dropout state, one tensor descriptor per step) and
+  // querying the workspace size cost about as much as running a short
+  // sequence. RNNPlan keeps them alive across calls.
+  //
+  // Plans are keyed by cuDNN handle, and handles are per thread, so a plan is
+  // never used by two threads at once.
+
+  // NB: a POD so that it can be hashed with ParamsHash, must be zeroed
+  // before it's filled
+  struct RNNPlanParams {
+    cudnnHandle_t handle;
+    int64_t hidden_size;
+    int64_t num_layers;
+    cudnnDirectionMode_t bidirectional;
+    cudnnRNNMode_t mode;
+    cudnnDataType_t datatype;
+    cudnnDataType_t input_datatype;
+    cudnnRNNAlgo_t algo;
+    double dropout_p;
+    void* dropout_state;
+    int64_t seq_length;
+    int64_t mini_batch;
+    int64_t input_size;
+    bool has_cx;
+  };
+
+  struct RNNPlanKey {
+    RNNPlanParams params;
+    std::vector<int64_t> batch_sizes;
+
+    bool operator==(const RNNPlanKey& other) const {
+      return ParamsEqual<RNNPlanParams>()(params, other.params) &&
+             batch_sizes == other.batch_sizes;
+    }
+  };
+
+  struct RNNPlanKeyHash {
+    size_t operator()(const RNNPlanKey& key) const {
+      size_t hash = ParamsHash<RNNPlanParams>()(key.params);
+      for (auto batch_size : key.batch_sizes) {
+        hash = hash * 31 + std::hash<int64_t>()(batch_size);
+      }
+      return hash;
+    }
+  };
+
+  struct RNNPlan {
+    RNNPlan(const RNNParams& fn, cudnnHandle_t handle, const Tensor& x, const Tensor& y, const Tensor& hx, const Tensor& cx)
+      : descs(fn, handle, x, y, hx, cx),
+        x_descs_arr(descs.get_x_descs()),
+        y_descs_arr(descs.get_y_descs()) {
+      AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
+            handle,
+            descs.rnn_desc.desc(),
+            fn.tensors.seq_length,
+            x_descs_arr.data(),
+            &workspace_size
+            ));
+    }
+
+    size_t get_reserve_size(cudnnHandle_t handle, int64_t seq_length) {
+      if (!reserve_size) {
+        size_t size;
+        AT_CUDNN_CHECK(cudnnGetRNNTrainingReserveSize(
+              handle,
+              descs.rnn_desc.desc(),
+              seq_length,
+              x_descs_arr.data(),
+              &size
+              ));
+        reserve_size = size;
+      }
+      return *reserve_size;
+    }
+
+    RNNDescriptors descs;
+    std::vector<cudnnTensorDescriptor_t> x_descs_arr;
+    std::vector<cudnnTensorDescriptor_t> y_descs_arr;
+    size_t workspace_size;
+    // Only queried in training
+    c10::optional<size_t> reserve_size;
+  };
+
+  // Sequence lengths usually take a bounded set of values, the cap only
+  // guards against unbounded growth with arbitrary lengths
+  constexpr size_t kMaxRNNPlans = 4096;
+
+  struct RNNPlanCache {
+    std::mutex mutex;
+    std::unordered_map<RNNPlanKey, std::shared_ptr<RNNPlan>, RNNPlanKeyHash> plans;
+    // The workspace of each handle and the stream it was last used on. Calls
+    // on the same stream are ordered, so they can share it.
+    std::unordered_map<cudnnHandle_t, std::pair<cudaStream_t, Tensor>> workspaces;
+  };
+
+  RNNPlanCache& rnn_plan_cache() {
+    // Leaked on purpose: the cached tensors and descriptors must not be
+    // destroyed after CUDA and cuDNN are torn down at exit
+    static RNNPlanCache* cache = new RNNPlanCache();
+    return *cache;
+  }
+
+  std::shared_ptr<RNNPlan> get_rnn_plan(const RNNParams& fn, cudnnHandle_t handle, const Tensor& x, const Tensor& y, const Tensor& hx, const Tensor& cx) {
+    RNNPlanKey key;
+    memset(&key.params, 0, sizeof(key.params));
+    key.params.handle = handle;
+    key.params.hidden_size = fn.rnn.hidden_size;
+    key.params.num_layers = fn.rnn.num_layers;
+    key.params.bidirectional = fn.rnn.bidirectional;
+    key.params.mode = fn.rnn.mode;
+    key.params.datatype = fn.rnn.datatype;
+    key.params.input_datatype = fn.rnn.input_datatype;
+    key.params.algo = fn.rnn.algo;
+    key.params.dropout_p = fn.dropout.train ? fn.dropout.dropout : 0;
+    key.params.dropout_state = key.params.dropout_p != 0 ? fn.dropout.dropout_state.data_ptr() : nullptr;
+    key.params.seq_length = fn.tensors.seq_length;
+    key.params.mini_batch = fn.tensors.mini_batch;
+    key.params.input_size = fn.tensors.input_size;
+    key.params.has_cx = cx.defined();
+    key.batch_sizes = fn.tensors.batch_sizes.vec();
+
+    auto& cache = rnn_plan_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.plans.find(key);
+    if (it != cache.plans.end()) {
+      return it->second;
+    }
+    if (cache.plans.size() >= kMaxRNNPlans) {
+      cache.plans.clear();
+    }
+    auto plan = std::make_shared<RNNPlan>(fn, handle, x, y, hx, cx);
+    cache.plans.emplace(std::move(key), plan);
+    return plan;
+  }
+
+  Tensor get_rnn_workspace(cudnnHandle_t handle, size_t size, const TensorOptions& options) {
+    auto stream = cuda::getCurrentCUDAStream().stream();
+    auto& cache = rnn_plan_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto& workspace = cache.workspaces[handle];
+    if (workspace.first != stream || !workspace.second.defined() ||
+        static_cast<size_t>(workspace.second.numel()) < size) {
+      workspace.first = stream;
+      workspace.second = at::empty(size, options.dtype(kByte));
+    }
+    return workspace.second;
+  }
+
 } // anonymous namespace
 
 // NB: does inplace update into TensorList
@@ -725,7 +883,8 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
   auto handle = getCudnnHandle();
   cudnnRNNAlgo_t algo = get_algo(fn.rnn, fn.tensors, input);
   fn.rnn.set_algo(algo);
-  RNNDescriptors descs(fn, handle, x, y, hx, cx);
+  auto plan = get_rnn_plan(fn, handle, x, y, hx, cx);
+  auto& descs = plan->descs;
 
   FilterDescriptor w_desc;
   if (!weight_buf.defined()) {
@@ -745,30 +904,15 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
   TORCH_CHECK(!cx.defined() || cx.sizes().equals(hidden_size),
            "Expected cell size ", IntArrayRef{hidden_size}, ", got ", cx.sizes());
 
-  size_t workspace_size;
-  auto x_descs_arr = descs.get_x_descs();
-  auto y_descs_arr = descs.get_y_descs();
-  AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
-        handle,
-        descs.rnn_desc.desc(),
-        fn.tensors.seq_length,
-        x_descs_arr.data(),
-        &workspace_size
-        ));
-  Tensor workspace = at::empty(workspace_size, input.options().dtype(kByte));
+  const auto& x_descs_arr = plan->x_descs_arr;
+  const auto& y_descs_arr = plan->y_descs_arr;
+  Tensor workspace = get_rnn_workspace(handle, plan->workspace_size, input.options());
 
   Tensor reserve;
   // NB: Previously, the test was for fn.requires_grad, but we don't have
   // this information.  Use 'train' as a proxy.
   if (fn_train) {
-    size_t reserve_size;
-    AT_CUDNN_CHECK(cudnnGetRNNTrainingReserveSize(
-          handle,
-          descs.rnn_desc.desc(),
-          fn.tensors.seq_length,
-          x_descs_arr.data(),
-          &reserve_size
-          ));
+    size_t reserve_size = plan->get_reserve_size(handle, fn.tensors.seq_length);
     reserve = at::empty(reserve_size, input.options().dtype(kByte));
     AT_CUDNN_CHECK(cudnnRNNForwardTraining(
           handle,
@@ -887,23 +1031,16 @@ std::tuple<Tensor, Tensor, Tensor> _cudnn_rnn_backward_input(
 
   cudnnRNNAlgo_t algo = get_algo(fn.rnn, fn.tensors, input);
   fn.rnn.set_algo(algo);
-  RNNDescriptors descs(fn, handle, x, y, hx, cx);
+  auto plan = get_rnn_plan(fn, handle, x, y, hx, cx);
+  auto& descs = plan->descs;
 
   FilterDescriptor w_desc;
   w_desc.set(weight_buf, 3);
 
-  size_t workspace_size;
-  auto x_descs_arr = descs.get_x_descs();
-  auto y_descs_arr = descs.get_y_descs();
-  AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
-        handle,
-        descs.rnn_desc.desc(),
-        fn.tensors.seq_length,
-        x_descs_arr.data(),
-        &workspace_size
-        ));
+  const auto& x_descs_arr = plan->x_descs_arr;
+  const auto& y_descs_arr = plan->y_descs_arr;
   // TODO: put this in the correct device???
-  Tensor workspace = at::empty(workspace_size, input.options().dtype(kByte));
+  Tensor workspace = get_rnn_workspace(handle, plan->workspace_size, input.options());
   AT_CUDNN_CHECK(cudnnRNNBackwardData(
         handle,
         descs.rnn_desc.desc(),
@@ -991,22 +1128,15 @@ std::vector<Tensor> _cudnn_rnn_backward_weight(
 
   cudnnRNNAlgo_t algo = get_algo(fn.rnn, fn.tensors, input);
   fn.rnn.set_algo(algo);
-  RNNDescriptors descs(fn, handle, x, y, hx, cx);
+  auto plan = get_rnn_plan(fn, handle, x, y, hx, cx);
+  auto& descs = plan->descs;
 
   FilterDescriptor w_desc;
   w_desc.set(weight_buf, 3);
 
-  size_t workspace_size;
-  auto x_descs_arr = descs.get_x_descs();
-  auto y_descs_arr = descs.get_y_descs();
-  AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
-        handle,
-        descs.rnn_desc.desc(),
-        fn.tensors.seq_length,
-        x_descs_arr.data(),
-        &workspace_size
-        ));
-  Tensor workspace = at::empty(workspace_size, input.options().dtype(kByte));
+  const auto& x_descs_arr = plan->x_descs_arr;
+  const auto& y_descs_arr = plan->y_descs_arr;
+  Tensor workspace = get_rnn_workspace(handle, plan->workspace_size, input.options());
   AT_CUDNN_CHECK(cudnnRNNBackwardWeights(
         handle,
         descs.rnn_desc.desc(),
@@ -16,16 +16,21 @@
 namespace at {
 namespace native {
 
-std::tuple<Tensor, Tensor, Tensor> native_group_norm(
-    const Tensor& X,
-    const Tensor& gamma /* optional */,
-    const Tensor& beta /* optional */,
+namespace {
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_forward(
+    const Tensor& input,
+    const Tensor& gamma,
+    const Tensor& beta,
     int64_t N,
     int64_t C,
     int64_t HxW,
     int64_t group,
-    double eps) {
-  Tensor Y = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    double eps,
+    GroupNormActivation activation) {
+  const MemoryFormat memory_format = group_norm_memory_format(input);
+  const Tensor X = input.contiguous(memory_format);
+  Tensor Y = at::native::empty_like(X, memory_format);
   Tensor mean = at::empty({N, group}, X.options());
   Tensor rstd = at::empty({N, group}, X.options());
   GroupNormKernel(
@@ -38,34 +43,41 @@ std::tuple<Tensor, Tensor, Tensor> native_group_norm(
       HxW,
       group,
       eps,
+      activation,
       &Y,
       &mean,
       &rstd);
   return std::make_tuple(Y, mean, rstd);
 }
 
-std::tuple<Tensor, Tensor, Tensor> native_group_norm_backward(
-    const Tensor& dY,
-    const Tensor& X,
+std::tuple<Tensor, Tensor, Tensor> group_norm_backward(
+    const Tensor& grad_out,
+    const Tensor& input,
     const Tensor& mean,
     const Tensor& rstd,
     const Tensor& gamma,
+    const Tensor& beta,
     int64_t N,
     int64_t C,
     int64_t HxW,
     int64_t group,
+    GroupNormActivation activation,
     std::array<bool, 3> grad_input_mask) {
+  // dY is brought to the layout of X, so that both are indexed alike
+  const MemoryFormat memory_format = group_norm_memory_format(input);
+  const Tensor X = input.contiguous(memory_format);
+  const Tensor dY = grad_out.contiguous(memory_format);
   Tensor dX;
   Tensor dgamma;
   Tensor dbeta;
   if (grad_input_mask[0]) {
-    dX = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    dX = at::native::empty_like(X, memory_format);
   }
   if (grad_input_mask[1]) {
-    dgamma = at::native::empty_like(gamma, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    dgamma = at::empty({C}, X.options());
   }
   if (grad_input_mask[2]) {
-    dbeta = at::native::empty_like(gamma, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    dbeta = at::empty({C}, X.options());
   }
   GroupNormBackwardKernel(
       X.device().type(),
@@ -74,16 +86,99 @@ std::tuple<Tensor, Tensor, Tensor> native_group_norm_backward(
       mean,
       rstd,
       gamma,
+      beta,
       N,
       C,
       HxW,
       group,
+      activation,
       &dX,
       &dgamma,
       &dbeta);
   return std::make_tuple(dX, dgamma, dbeta);
 }
 
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor> native_group_norm(
+    const Tensor& X,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps) {
+  return group_norm_forward(
+      X, gamma, beta, N, C, HxW, group, eps, GroupNormActivation::kNone);
+}
+
+std::tuple<Tensor, Tensor, Tensor> native_group_norm_backward(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    std::array<bool, 3> grad_input_mask) {
+  return group_norm_backward(
+      dY,
+      X,
+      mean,
+      rstd,
+      gamma,
+      Tensor(),
+      N,
+      C,
+      HxW,
+      group,
+      GroupNormActivation::kNone,
+      grad_input_mask);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_silu(
+    const Tensor& X,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps) {
+  return group_norm_forward(
+      X, gamma, beta, N, C, HxW, group, eps, GroupNormActivation::kSiLU);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_silu_backward(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    std::array<bool, 3> grad_input_mask) {
+  return group_norm_backward(
+      dY,
+      X,
+      mean,
+      rstd,
+      gamma,
+      beta,
+      N,
+      C,
+      HxW,
+      group,
+      GroupNormActivation::kSiLU,
+      grad_input_mask);
+}
+
 Tensor group_norm(
     const Tensor& input,
     int64_t num_groups,
@@ -123,7 +218,8 @@ Tensor group_norm(
       1LL,
       std::multiplies<int64_t>());
 
-  const auto& X = input.is_contiguous() ? input : input.contiguous();
+  // Channels last inputs stay channels last, see group_norm_memory_format
+  const auto X = input.contiguous(group_norm_memory_format(input));
   const auto& gamma = weight.is_contiguous() ? weight : weight.contiguous();
   const auto& beta = bias.is_contiguous() ? bias : bias.contiguous();
   return std::get<0>(
@@ -6,6 +6,21 @@
 namespace at {
 namespace native {
 
+// Elementwise activation applied to the normalized output by the same pass
+// that normalizes it. The backward kernels recompute the pre-activation value
+// from X, mean, rstd, gamma and beta instead of saving it.
+enum class GroupNormActivation {
+  kNone,
+  kSiLU,
+};
+
+// The kernels handle X (and dY) either contiguous, or channels last
+// contiguous (NHWC / NDHWC), in which case Y and dX share that layout.
+inline MemoryFormat group_norm_memory_format(const Tensor& X) {
+  return X.is_contiguous() ? MemoryFormat::Contiguous
+                           : X.suggest_memory_format();
+}
+
 using forward_fn = void (*)(
     const Tensor& /* X */,
     const Tensor& /* gamma */,
@@ -15,6 +30,7 @@ using forward_fn = void (*)(
     int64_t /* HxW */,
     int64_t /* group */,
     double /* eps */,
+    GroupNormActivation /* activation */,
     Tensor* /* Y */,
     Tensor* /* mean */,
     Tensor* /* rstd */);
@@ -25,10 +41,12 @@ using backward_fn = void (*)(
     const Tensor& /* mean */,
     const Tensor& /* rstd */,
     const Tensor& /* gamma */,
+    const Tensor& /* beta */,
     int64_t /* N */,
     int64_t /* C */,
     int64_t /* HxW */,
     int64_t /* group */,
+    GroupNormActivation /* activation */,
     Tensor* /* dX */,
     Tensor* /* dgamma */,
     Tensor* /* dbeta */);
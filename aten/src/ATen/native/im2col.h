@@ -2,9 +2,12 @@
 
 #include <ATen/ATen.h>
 #include <ATen/LegacyTHFunctionsCPU.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/Utils.h>
 
+#include <algorithm>
+
 namespace at {
 namespace native {
 
@@ -28,24 +31,28 @@ static void im2col(
   const int64_t height_col = output_height;
   const int64_t width_col = output_width;
   const int64_t channels_col = channels * kernel_h * kernel_w;
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, height_col * width_col));
 
-  for (int64_t c_col = 0; c_col < channels_col; ++c_col) {
-    int64_t w_offset = c_col % kernel_w;
-    int64_t h_offset = (c_col / kernel_w) % kernel_h;
-    int64_t c_im = c_col / kernel_h / kernel_w;
+  at::parallel_for(0, channels_col, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t c_col = begin; c_col < end; ++c_col) {
+      int64_t w_offset = c_col % kernel_w;
+      int64_t h_offset = (c_col / kernel_w) % kernel_h;
+      int64_t c_im = c_col / kernel_h / kernel_w;
 
-    for (int64_t h_col = 0; h_col < height_col; ++h_col) {
-      int64_t h_im = h_col * stride_h - pad_h + h_offset * dilation_h;
+      for (int64_t h_col = 0; h_col < height_col; ++h_col) {
+        int64_t h_im = h_col * stride_h - pad_h + h_offset * dilation_h;
 
-      for (int64_t w_col = 0; w_col < width_col; ++w_col) {
-        int64_t w_im = w_col * stride_w - pad_w + w_offset * dilation_w;
-        data_col[(c_col * height_col + h_col) * width_col + w_col] =
-            (h_im >= 0 && w_im >= 0 && h_im < height && w_im < width)
-            ? data_im[(c_im * height + h_im) * width + w_im]
-            : static_cast<T>(0);
+        for (int64_t w_col = 0; w_col < width_col; ++w_col) {
+          int64_t w_im = w_col * stride_w - pad_w + w_offset * dilation_w;
+          data_col[(c_col * height_col + h_col) * width_col + w_col] =
+              (h_im >= 0 && w_im >= 0 && h_im < height && w_im < width)
+              ? data_im[(c_im * height + h_im) * width + w_im]
+              : static_cast<T>(0);
+        }
       }
     }
-  }
+  });
 }
 
 template <typename T>
@@ -65,29 +72,42 @@ static void col2im(
     const int64_t dilation_h,
     const int64_t dilation_w,
     T* data_im) {
-  memset(data_im, 0, sizeof(T) * height * width * channels);
-
   const int64_t height_col = output_height;
   const int64_t width_col = output_width;
-  const int64_t channels_col = channels * kernel_h * kernel_w;
+  const int64_t kernel_size = kernel_h * kernel_w;
+  const int64_t grain_size = std::max<int64_t>(
+      1,
+      at::internal::GRAIN_SIZE /
+          std::max<int64_t>(1, kernel_size * height_col * width_col));
 
-  for (int64_t c_col = 0; c_col < channels_col; ++c_col) {
-    int64_t w_offset = c_col % kernel_w;
-    int64_t h_offset = (c_col / kernel_w) % kernel_h;
-    int64_t c_im = c_col / kernel_h / kernel_w;
+  // Every channel of the image only gathers from its own kernel_h * kernel_w
+  // rows of columns, so the channels are independent and run in parallel.
+  at::parallel_for(0, channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t c_im = begin; c_im < end; ++c_im) {
+      T* im = data_im + c_im * height * width;
+      memset(im, 0, sizeof(T) * height * width);
 
-    for (int64_t h_col = 0; h_col < height_col; ++h_col) {
-      int64_t h_im = h_col * stride_h - pad_h + h_offset * dilation_h;
+      for (int64_t h_offset = 0; h_offset < kernel_h; ++h_offset) {
+        for (int64_t w_offset = 0; w_offset < kernel_w; ++w_offset) {
+          const int64_t c_col = (c_im * kernel_h + h_offset) * kernel_w + w_offset;
+          const T* col = data_col + c_col * height_col * width_col;
 
-      for (int64_t w_col = 0; w_col < width_col; ++w_col) {
-        int64_t w_im = w_col * stride_w - pad_w + w_offset * dilation_w;
+          for (int64_t h_col = 0; h_col < height_col; ++h_col) {
+            int64_t h_im = h_col * stride_h - pad_h + h_offset * dilation_h;
+            if (h_im < 0 || h_im >= height) {
+              continue;
+            }
 
-        if (h_im >= 0 && h_im < height && w_im >= 0 && w_im < width)
-          data_im[(c_im * height + h_im) * width + w_im] +=
-              data_col[(c_col * height_col + h_col) * width_col + w_col];
+            for (int64_t w_col = 0; w_col < width_col; ++w_col) {
+              int64_t w_im = w_col * stride_w - pad_w + w_offset * dilation_w;
+              if (w_im >= 0 && w_im < width)
+                im[h_im * width + w_im] += col[h_col * width_col + w_col];
+            }
+          }
+        }
       }
     }
-  }
+  });
 }
 
 } // native
@@ -12,6 +12,7 @@
 #include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/Resize.h>
 #include <torch/library.h>
 
 namespace at {
@@ -27,10 +28,27 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_cpu(
   Tensor Y = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   Tensor mean = at::empty({M}, X.options());
   Tensor rstd = at::empty({M}, X.options());
+  layer_norm_cpu_out(Y, mean, rstd, X, gamma, beta, M, N, eps);
+  return std::make_tuple(std::move(Y), std::move(mean), std::move(rstd));
+}
+
+void layer_norm_cpu_out(
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd,
+    const Tensor& X,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double eps) {
+  resize_output(Y, X.sizes());
+  TORCH_CHECK(Y.is_contiguous(), "layer_norm: expected a contiguous output");
+  resize_output(mean, {M});
+  resize_output(rstd, {M});
   if (M > 0) {
     LayerNormKernel(kCPU, X, gamma, beta, M, N, eps, &Y, &mean, &rstd);
   }
-  return std::make_tuple(std::move(Y), std::move(mean), std::move(rstd));
 }
 
 std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cpu(
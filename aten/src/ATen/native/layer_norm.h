@@ -95,6 +95,20 @@ using backward_fn = void (*)(
     Tensor* /* dgamma */,
     Tensor* /* dbeta */);
 
+// Computes the layer norm of the contiguous M x N input X into Y, mean and
+// rstd, which are resized if needed. Lets callers that keep their output
+// buffers across calls reuse them.
+CAFFE2_API void layer_norm_cpu_out(
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd,
+    const Tensor& X,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double eps);
+
 DECLARE_DISPATCH(forward_fn, LayerNormKernel);
 DECLARE_DISPATCH(backward_fn, LayerNormBackwardKernel);
 
@@ -0,0 +1,115 @@
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/native/mkl/LinearPrePack.h>
+
+#include <limits>
+
+#if AT_MKL_ENABLED()
+#include <mkl.h>
+#endif
+
+namespace at {
+namespace native {
+namespace mkl {
+
+c10::intrusive_ptr<LinearOpContext> LinearOpContext::create_context(
+    Tensor&& weight,
+    c10::optional<Tensor>&& bias) {
+  TORCH_CHECK(weight.dim() == 2,
+      "mkl_prepack::linear_prepack: expected a 2-dimensional weight, but got size ", weight.sizes());
+  TORCH_CHECK(weight.device().is_cpu(),
+      "mkl_prepack::linear_prepack: expected a CPU weight, but got a weight on ", weight.device());
+  TORCH_CHECK(!bias || (bias->dim() == 1 && bias->size(0) == weight.size(0)),
+      "mkl_prepack::linear_prepack: expected a bias of ", weight.size(0), " elements, but got size ", bias->sizes());
+  TORCH_CHECK(!bias || bias->scalar_type() == weight.scalar_type(),
+      "mkl_prepack::linear_prepack: expected weight and bias to have the same dtype, but got ",
+      weight.scalar_type(), " and ", bias->scalar_type());
+  return c10::make_intrusive<LinearOpContext>(weight.contiguous(), bias ? c10::optional<Tensor>(bias->contiguous()) : bias);
+}
+
+#if AT_MKL_ENABLED()
+
+Tensor LinearOpContext::packed_weight(int64_t m) {
+  const int64_t n = orig_weight_.size(0);
+  const int64_t k = orig_weight_.size(1);
+  constexpr int64_t int_max = std::numeric_limits<MKL_INT>::max();
+  if (orig_weight_.scalar_type() != kFloat || m == 0 || n == 0 || k == 0 ||
+      m > int_max || n > int_max || k > int_max) {
+    return Tensor();
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = packed_weights_.find(m);
+  if (it != packed_weights_.end()) {
+    return it->second;
+  }
+  if (packed_weights_.size() >= kMaxPackedBatchSizes) {
+    return Tensor();
+  }
+  // op(B) is the k x n transpose of the row-major n x k weight
+  const size_t size = cblas_sgemm_pack_get_size(CblasBMatrix, m, n, k);
+  Tensor packed = at::empty({static_cast<int64_t>(size)}, orig_weight_.options().dtype(kByte));
+  cblas_sgemm_pack(
+      CblasRowMajor, CblasBMatrix, CblasTrans, m, n, k, 1.0f,
+      orig_weight_.data_ptr<float>(), k,
+      reinterpret_cast<float*>(packed.data_ptr<uint8_t>()));
+  packed_weights_.emplace(m, packed);
+  return packed;
+}
+
+Tensor LinearOpContext::run(const Tensor& input) {
+  const int64_t n = orig_weight_.size(0);
+  const int64_t k = orig_weight_.size(1);
+  if (input.scalar_type() != kFloat || !input.device().is_cpu() || input.dim() == 0 || input.size(-1) != k) {
+    return at::linear(input, orig_weight_, orig_bias_ ? *orig_bias_ : Tensor());
+  }
+  const int64_t m = input.numel() / k;
+  Tensor packed = packed_weight(m);
+  if (!packed.defined()) {
+    return at::linear(input, orig_weight_, orig_bias_ ? *orig_bias_ : Tensor());
+  }
+
+  std::vector<int64_t> output_sizes = input.sizes().vec();
+  output_sizes.back() = n;
+  Tensor output = at::empty({m, n}, input.options());
+  float beta = 0.0f;
+  if (orig_bias_) {
+    output.copy_(orig_bias_->expand({m, n}));
+    beta = 1.0f;
+  }
+  Tensor input_ = input.reshape({m, k}).contiguous();
+  cblas_sgemm_compute(
+      CblasRowMajor, CblasNoTrans, CblasPacked, m, n, k,
+      input_.data_ptr<float>(), k,
+      reinterpret_cast<const float*>(packed.data_ptr<uint8_t>()), n,
+      beta, output.data_ptr<float>(), n);
+  return output.view(output_sizes);
+}
+
+#else
+
+Tensor LinearOpContext::packed_weight(int64_t m) {
+  return Tensor();
+}
+
+Tensor LinearOpContext::run(const Tensor& input) {
+  return at::linear(input, orig_weight_, orig_bias_ ? *orig_bias_ : Tensor());
+}
+
+#endif // AT_MKL_ENABLED()
+
+c10::intrusive_ptr<LinearOpContext> createLinearPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias) {
+  return LinearOpContext::create_context(std::move(weight), std::move(bias));
+}
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<LinearOpContext>& op_context) {
+  return op_context->run(input);
+}
+
+} // namespace mkl
+} // namespace native
+} // namespace at
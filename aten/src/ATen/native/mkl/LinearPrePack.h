@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/Tensor.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace at {
+namespace native {
+namespace mkl {
+
+using SerializationTypeLinearPrePack = std::tuple<Tensor, c10::optional<Tensor>>;
+
+// NOTE [ Prepacked fp32 linear on CPU ]
+//
+// MKL's sgemm repacks its operands into its blocked layout on every call,
+// which for the small batches of server inference costs about as much as the
+// product itself. LinearOpContext packs the weight of a frozen linear once
+// with cblas_sgemm_pack, and runs the products on the packed weight with
+// cblas_sgemm_compute. The packed layout depends on the number of rows of the
+// input, so the context keeps one packed weight for each of the first
+// kMaxPackedBatchSizes batch sizes it sees, and the others go through
+// at::linear, as do inputs that aren't float and builds without MKL.
+class LinearOpContext : public torch::jit::CustomClassHolder {
+ private:
+  static constexpr size_t kMaxPackedBatchSizes = 8;
+
+  Tensor orig_weight_;
+  c10::optional<Tensor> orig_bias_;
+  // batch size -> kByte buffer of the weight packed by MKL
+  std::unordered_map<int64_t, Tensor> packed_weights_;
+  std::mutex mutex_;
+
+  // The weight packed for batches of m rows, or an undefined tensor if it
+  // can't be packed for them.
+  Tensor packed_weight(int64_t m);
+
+ public:
+  LinearOpContext(Tensor&& weight, c10::optional<Tensor>&& bias)
+      : orig_weight_(std::move(weight)), orig_bias_(std::move(bias)) {}
+
+  SerializationTypeLinearPrePack unpack() {
+    return std::make_tuple(orig_weight_, orig_bias_);
+  }
+
+  Tensor run(const Tensor& input);
+
+  static c10::intrusive_ptr<LinearOpContext> create_context(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias);
+};
+
+c10::intrusive_ptr<LinearOpContext> createLinearPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias);
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<LinearOpContext>& op_context);
+
+} // namespace mkl
+} // namespace native
+} // namespace at
@@ -0,0 +1,37 @@
+#include <torch/library.h>
+#include <ATen/native/mkl/LinearPrePack.h>
+#include <ATen/Tensor.h>
+#include <torch/custom_class.h>
+
+namespace at {
+namespace native {
+namespace mkl {
+
+TORCH_LIBRARY(mkl, m) {
+  m.class_<LinearOpContext>("LinearOpContext")
+    .def_pickle(
+        [](const c10::intrusive_ptr<LinearOpContext>& op_context)
+            -> SerializationTypeLinearPrePack { // __getstate__
+          return op_context->unpack();
+        },
+        [](SerializationTypeLinearPrePack state)
+            -> c10::intrusive_ptr<LinearOpContext> { // __setstate__
+          return createLinearPrePackOpContext(
+              std::move(std::get<0>(state)),
+              std::move(std::get<1>(state)));
+        });
+}
+
+TORCH_LIBRARY(mkl_prepack, m) {
+  m.def("linear_prepack(Tensor W, Tensor? B=None) -> __torch__.torch.classes.mkl.LinearOpContext");
+  m.def("linear_run(Tensor X, __torch__.torch.classes.mkl.LinearOpContext W_prepack) -> Tensor Y");
+}
+
+TORCH_LIBRARY_IMPL(mkl_prepack, CPU, m) {
+  m.impl("linear_prepack", TORCH_FN(createLinearPrePackOpContext));
+  m.impl("linear_run", TORCH_FN(linear_run));
+}
+
+} // namespace mkl
+} // namespace native
+} // namespace at
@@ -61,6 +61,10 @@ Tensor& mkldnn_add_out(
 }
 
 Tensor mkldnn_add(const Tensor& self, const Tensor& other, Scalar alpha) {
+  // ideep::sum doesn't broadcast
+  if (self.sizes() != other.sizes()) {
+    return at::add(self.to_dense(), other.to_dense(), alpha).to_mkldnn();
+  }
   ideep::tensor& x = itensor_from_mkldnn(self);
   ideep::tensor& y = itensor_from_mkldnn(other);
 
@@ -9,6 +9,8 @@
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 
 #include <cmath>
+#include <cstring>
+#include <numeric>
 #ifdef USE_FBGEMM
 #include <fbgemm/QuantUtils.h>
 #endif
@@ -1285,7 +1287,7 @@ void _qadaptive_avg_pool_kernel(
     int64_t istrideD,  // Set to 1 for 2d
     int64_t istrideH,
     int64_t istrideW) {
-  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), fn_name, [&]() {
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "adaptive_avg_pool_nhwc", [&]() {
     scalar_t* idata = static_cast<scalar_t*>(qx.data_ptr());
     scalar_t* odata = static_cast<scalar_t*>(qy.data_ptr());
     auto* i_p =
@@ -1464,7 +1466,7 @@ void _qavg_pool_nhwc_kernel(
     int padD,
     bool count_include_pad,
     c10::optional<int64_t> divisor_override) {
-  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), fn_name, [&]() {
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "avg_pool_nhwc", [&]() {
     scalar_t* idata = static_cast<scalar_t*>(qx.data_ptr());
     scalar_t* odata = static_cast<scalar_t*>(qy.data_ptr());
     int strideC = 1;
@@ -2027,6 +2029,34 @@ void fake_quantize_tensor_kernel(
   });
 }
 
+void fake_quantize_tensor_cachemask_kernel(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  float inv_scale = 1.0f / sc;
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(output)
+    .add_output(mask)
+    .add_input(input)
+    .build();
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      float* output_val = (float*)(data[0] + i * strides[0]);
+      bool* mask_val = (bool*)(data[1] + i * strides[1]);
+      float* input_val = (float*)(data[2] + i * strides[2]);
+
+      const auto qval = static_cast<int64_t>(z_point + std::nearbyint(*input_val * inv_scale));
+      *output_val = (std::fmin(std::fmax(qval, quant_min), quant_max) - z_point) * sc;
+      *mask_val = ((quant_min <= qval) && (qval <= quant_max));
+    }
+  });
+}
+
 void fake_quantize_grad_tensor_kernel(
     Tensor& input_grad,
     const Tensor& input,
@@ -2108,6 +2138,29 @@ void fake_quant_per_channel_cpu(
   });
 }
 
+void fake_quant_per_channel_cachemask_cpu(
+    TensorIterator& iter,
+    int64_t quant_min,
+    int64_t quant_max) {
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      float* output_val = (float*)(data[0] + i * strides[0]);
+      bool* mask_val = (bool*)(data[1] + i * strides[1]);
+      float* input_val = (float*)(data[2] + i * strides[2]);
+      float* scale_val = (float*)(data[3] + i * strides[3]);
+      int64_t* zero_point_val = (int64_t*)(data[4] + i * strides[4]);
+
+      const float inv_scale = 1.0f / (*scale_val);
+      const auto qval = static_cast<int64_t>(
+          *zero_point_val + std::nearbyint(*input_val * inv_scale));
+      *output_val =
+          (std::fmin(std::fmax(qval, quant_min), quant_max) - *zero_point_val) *
+          (*scale_val);
+      *mask_val = ((quant_min <= qval) && (qval <= quant_max));
+    }
+  });
+}
+
 void fake_quant_grad_per_channel_cpu(
     TensorIterator& iter,
     int64_t quant_min,
@@ -2121,50 +2174,40 @@ void fake_quant_grad_per_channel_cpu(
       });
 }
 
-void fake_quantize_learnable_scale_grad_channel_kernel(
-    Tensor& input_grad,
-    const Tensor& input,
-    const Tensor& output_grad,
-    float scale,
-    int64_t zero_point,
-    int64_t quant_min,
-    int64_t quant_max) {
-  float inv_scale = 1.0f / scale;
-  float grad_small = quant_min - zero_point;
-  float grad_big = quant_max - zero_point;
-  auto iter_scale = TensorIterator::binary_op(input_grad, input, output_grad);
-  // TODO: Implement the vectorized per channel version for the learnable backprop kernel on scale.
-  cpu_kernel(iter_scale, [&](float x, float dy) -> float {
-    int64_t xq = static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
-    xq = std::max(std::min(xq, quant_max), quant_min);
-    float x_fq = static_cast<float>((xq - zero_point) * scale);
-    if (xq == quant_min) {
-      return dy * grad_small;
-    } else if (xq == quant_max) {
-      return dy * grad_big;
-    }
-    return dy * (x_fq - x) * inv_scale;
-  });
-}
-
-void fake_quantize_learnable_zero_point_grad_channel_kernel(
-    Tensor& input_grad,
-    const Tensor& input,
-    const Tensor& output_grad,
-    float scale,
-    int64_t zero_point,
+// Computes the input, scale and zero point gradients of the learnable per
+// channel fake quantize in one pass. The scale and zero point gradients are
+// written per element and reduced over the non-channel dimensions by the
+// caller.
+void fake_quantize_learnable_channel_grad_kernel_cpu(
+    TensorIterator& iter,
     int64_t quant_min,
     int64_t quant_max) {
-  float inv_scale = 1.0f / scale;
-  auto iter_zero_point = TensorIterator::binary_op(input_grad, input, output_grad);
-  // TODO: Implement the vectorized per channel version for the learnable backprop kernel on zero point.
-  cpu_kernel(iter_zero_point, [&](float x, float dy) -> float {
-    int64_t xq = static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
-    xq = std::max(std::min(xq, quant_max), quant_min);
-    if (xq == quant_min || xq == quant_max) {
-      return dy * (-1) * scale;
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      float* dx_output = (float*)(data[0] + i * strides[0]);
+      float* dscale_output = (float*)(data[1] + i * strides[1]);
+      float* dzero_point_output = (float*)(data[2] + i * strides[2]);
+      float* x_input = (float*)(data[3] + i * strides[3]);
+      float* dy_input = (float*)(data[4] + i * strides[4]);
+      float* scale_input = (float*)(data[5] + i * strides[5]);
+      int64_t* zero_point_input = (int64_t*)(data[6] + i * strides[6]);
+
+      const float scale = *scale_input;
+      const float inv_scale = 1.0f / scale;
+      const int64_t zero_point = *zero_point_input;
+      int64_t xq = static_cast<int64_t>(
+          zero_point + std::nearbyint(*x_input * inv_scale));
+      *dx_output = (*dy_input) * (xq >= quant_min && xq <= quant_max);
+      xq = std::max(std::min(xq, quant_max), quant_min);
+      if (xq == quant_min || xq == quant_max) {
+        *dzero_point_output = (*dy_input) * (-1) * scale;
+        *dscale_output = (*dy_input) * static_cast<float>(xq - zero_point);
+      } else {
+        const float x_fq = static_cast<float>((xq - zero_point) * scale);
+        *dzero_point_output = 0;
+        *dscale_output = (*dy_input) * (x_fq - (*x_input)) * inv_scale;
+      }
     }
-    return 0;
   });
 }
 
@@ -2331,96 +2374,43 @@ void quantized_normalize_kernel(
   });
 }
 
-#ifdef USE_FBGEMM
-void quantize_tensor_per_tensor_affine_cpu(
-    Tensor rtensor,
-    Tensor qtensor,
-    double scale,
-    int64_t zero_point) {
-  AT_DISPATCH_QINT_TYPES(
-      qtensor.scalar_type(), "quantize_tensor_per_tensor_affine_cpu", [&]() {
-        const float* rd = rtensor.data_ptr<float>();
-        auto qd = reinterpret_cast<underlying_t*>(qtensor.data_ptr<scalar_t>());
-        fbgemm::TensorQuantizationParams qparams;
-        qparams.scale = scale;
-        qparams.zero_point = zero_point;
-        qparams.precision = CHAR_BIT * sizeof(underlying_t);
-        int num_tasks = at::get_num_threads();
-        at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
-          for (int task_id = begin; task_id < end; ++task_id) {
-            fbgemm::Quantize<underlying_t, false /*LEGACY*/>(
-                rd, /*src=*/
-                qd, /*dst=*/
-                rtensor.numel(), /*len*/
-                qparams, /*qparams=*/
-                task_id, /*thread_id*/
-                num_tasks /*num_threads*/);
-          }
-        });
-      });
-}
-
-void dequantize_tensor_per_tensor_affine_cpu(
-    Tensor qtensor,
-    Tensor rtensor,
-    double scale,
-    int64_t zero_point) {
-  AT_DISPATCH_QINT_TYPES(
-      qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine_cpu", [&]() {
-        const auto* qd =
-            reinterpret_cast<const underlying_t*>(qtensor.data_ptr<scalar_t>());
-        fbgemm::TensorQuantizationParams qparams;
-        qparams.scale = scale;
-        qparams.zero_point = zero_point;
-        qparams.precision = CHAR_BIT * sizeof(underlying_t);
-        float* rd = rtensor.data_ptr<float>();
-        int num_tasks = at::get_num_threads();
-        at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
-          for (int task_id = begin; task_id < end; ++task_id) {
-            fbgemm::Dequantize<underlying_t>(
-                qd, /*src=*/
-                rd, /*dst=*/
-                qtensor.numel(), /*len=*/
-                qparams, /*qparams=*/
-                task_id, /*thread_id*/
-                num_tasks /*num_threads*/);
-          }
-        });
-      });
-}
-#else // USE_FBGEMM
-
 #if defined(__ARM_NEON__) || defined(__aarch64__)
 // Generic template defaults to naive quantize implementation
 template <typename T>
 void quantize_tensor_arm(
     const float* in,
-    Tensor qtensor,
+    T* out,
     const int64_t N,
     const float scale,
     const int32_t zero_point) {
-  auto out = qtensor.data_ptr<T>();
-  for (int i = 0; i < N; ++i) {
+  for (int64_t i = 0; i < N; ++i) {
     out[i] = at::native::quantize_val<T>(scale, zero_point, in[i]);
   }
 }
 
-// Specialized implementation from caffe2::Int8Quantize.
+// Narrows the saturated int16 lanes of `v` to the 8-bit type of `out`.
+inline void vst1_q8(uint8_t* out, int16x8_t v) {
+  vst1_u8(out, vqmovun_s16(v));
+}
+
+inline void vst1_q8(int8_t* out, int16x8_t v) {
+  vst1_s8(out, vqmovn_s16(v));
+}
+
+// Specialized implementation from caffe2::Int8Quantize, for quint8 and qint8.
 // There may be slight accuracy difference between this and implementation of
 // quantize_val
 // TODO Update quantize_tensor_arm implementation to follow quantize_val,
 // i.e. f = Round(value/scale + zero_point)
-// TODO Make quantize_tensor_arm work for other datatypes too (int8, int32).
-template <>
-void quantize_tensor_arm<c10::quint8>(
+template <typename underlying_t>
+void quantize_tensor_arm_q8(
     const float* in,
-    Tensor qtensor,
+    underlying_t* out,
     const int64_t N,
     const float scale,
     const int32_t zero_point) {
   const float inv_scale = 1.0f / scale;
-  uint32_t i = 0;
-  auto out = (uint8_t*)qtensor.data_ptr<c10::quint8>();
+  int64_t i = 0;
   const float32x4_t vinv_scale = vdupq_n_f32(inv_scale);
 #if defined(__ARM_NEON__)
   // magic float and magic int to take care of rounding
@@ -2451,15 +2441,11 @@ void quantize_tensor_arm<c10::quint8>(
             vaddq_f32(vmagic_float, vmulq_f32(vin4567, vinv_scale))));
     const int16x8_t vraw01234567 =
         vcombine_s16(vqmovn_s32(vraw0123), vqmovn_s32(vraw4567));
-    const uint8x8_t vout01234567 = vqmovun_s16(vraw01234567);
-    vst1_u8(out, vout01234567);
+    vst1_q8(out, vraw01234567);
     out += 8;
   }
-  for (; i < N; ++i) {
-    (*out++) = at::native::quantize_val_arm(scale, zero_point, (*in++));
-  }
 #else
-  const int16x8_t vzero_point = vdupq_n_s16((int16_t)(uint16_t)zero_point);
+  const int16x8_t vzero_point = vdupq_n_s16((int16_t)zero_point);
   for (i = 0; i + 8 < N; i += 8) {
     const float32x4_t vin0123 = vld1q_f32(in);
     in += 4;
@@ -2469,46 +2455,171 @@ void quantize_tensor_arm<c10::quint8>(
     const int32x4_t v4567_rounded = vcvtnq_s32_f32(vmulq_f32(vin4567, vinv_scale));
     const int16x8_t v01234567_packed = vqaddq_s16(
         vqmovn_high_s32(vqmovn_s32(v0123_rounded), v4567_rounded), vzero_point);
-    const uint8x8_t vout01234567 = vqmovun_s16(v01234567_packed);
-    vst1_u8(out, vout01234567);
+    vst1_q8(out, v01234567_packed);
     out += 8;
   }
+#endif
   for (; i < N; ++i) {
-    (*out++) = at::native::quantize_val_arm(scale, zero_point, (*in++));
+    (*out++) = at::native::quantize_val_arm<underlying_t>(scale, zero_point, (*in++));
   }
-#endif
+}
+
+template <>
+void quantize_tensor_arm<c10::quint8>(
+    const float* in,
+    c10::quint8* out,
+    const int64_t N,
+    const float scale,
+    const int32_t zero_point) {
+  quantize_tensor_arm_q8(
+      in, reinterpret_cast<uint8_t*>(out), N, scale, zero_point);
+}
+
+template <>
+void quantize_tensor_arm<c10::qint8>(
+    const float* in,
+    c10::qint8* out,
+    const int64_t N,
+    const float scale,
+    const int32_t zero_point) {
+  quantize_tensor_arm_q8(
+      in, reinterpret_cast<int8_t*>(out), N, scale, zero_point);
 }
 
 #endif // defined(__ARM_NEON__) || defined(__aarch64__)
 
+// Quantizes `N` contiguous floats with one scale and zero point, using the
+// vectorized kernel of the build: fbgemm's, NEON or Vec256.
+template <typename scalar_t>
+void quantize_span(
+    const float* in,
+    scalar_t* out,
+    int64_t N,
+    double scale,
+    int64_t zero_point) {
+#if defined(USE_FBGEMM)
+  constexpr int precision = CHAR_BIT * sizeof(typename scalar_t::underlying);
+  quantize_vec<scalar_t, precision>(scale, zero_point, in, out, N);
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  quantize_tensor_arm<scalar_t>(in, out, N, scale, zero_point);
+#else
+  using Vec = Vec256<scalar_t>;
+  const float inv_scale = 1.0f / static_cast<float>(scale);
+  int64_t i = 0;
+  for (; i + Vec::size() <= N; i += Vec::size()) {
+    typename Vec::float_vec_return_type float_vals;
+    for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+      float_vals[j] = Vec256<float>::loadu(in + i + j * Vec256<float>::size());
+    }
+    Vec::quantize(float_vals, scale, zero_point, inv_scale).store(out + i);
+  }
+  for (; i < N; ++i) {
+    out[i] = quantize_val<scalar_t>(scale, zero_point, in[i]);
+  }
+#endif
+}
+
+// Dequantizes `N` contiguous values with one scale and zero point.
+template <typename scalar_t>
+void dequantize_span(
+    const scalar_t* in,
+    float* out,
+    int64_t N,
+    double scale,
+    int64_t zero_point) {
+  using Vec = Vec256<scalar_t>;
+  const Vec256<float> scale_vec(scale);
+  const Vec256<float> zero_point_vec(zero_point);
+  const Vec256<float> scale_zp_premul_vec(-zero_point * scale);
+  int64_t i = 0;
+  for (; i + Vec::size() <= N; i += Vec::size()) {
+    const auto float_vals = Vec::loadu(in + i).dequantize(
+        scale_vec, zero_point_vec, scale_zp_premul_vec);
+    for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+      float_vals[j].store(out + i + j * Vec256<float>::size());
+    }
+  }
+  for (; i < N; ++i) {
+    out[i] = dequantize_val<scalar_t>(scale, zero_point, in[i]);
+  }
+}
+
+#ifdef USE_FBGEMM
 void quantize_tensor_per_tensor_affine_cpu(
     Tensor rtensor,
     Tensor qtensor,
     double scale,
     int64_t zero_point) {
-#if defined(__ARM_NEON__) || defined(__aarch64__)
   AT_DISPATCH_QINT_TYPES(
       qtensor.scalar_type(), "quantize_tensor_per_tensor_affine_cpu", [&]() {
-        TORCH_CHECK(
-            rtensor.is_contiguous(), "Float tensor should be contiguous");
-        const float* const rdata = rtensor.data_ptr<float>();
-        quantize_tensor_arm<scalar_t>(
-            rdata, qtensor, rtensor.numel(), scale, zero_point);
+        const float* rd = rtensor.data_ptr<float>();
+        auto qd = reinterpret_cast<underlying_t*>(qtensor.data_ptr<scalar_t>());
+        fbgemm::TensorQuantizationParams qparams;
+        qparams.scale = scale;
+        qparams.zero_point = zero_point;
+        qparams.precision = CHAR_BIT * sizeof(underlying_t);
+        int num_tasks = at::get_num_threads();
+        at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+          for (int task_id = begin; task_id < end; ++task_id) {
+            fbgemm::Quantize<underlying_t, false /*LEGACY*/>(
+                rd, /*src=*/
+                qd, /*dst=*/
+                rtensor.numel(), /*len*/
+                qparams, /*qparams=*/
+                task_id, /*thread_id*/
+                num_tasks /*num_threads*/);
+          }
+        });
       });
-#else
-  // Fallback path
+}
+
+void dequantize_tensor_per_tensor_affine_cpu(
+    Tensor qtensor,
+    Tensor rtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine_cpu", [&]() {
+        const auto* qd =
+            reinterpret_cast<const underlying_t*>(qtensor.data_ptr<scalar_t>());
+        fbgemm::TensorQuantizationParams qparams;
+        qparams.scale = scale;
+        qparams.zero_point = zero_point;
+        qparams.precision = CHAR_BIT * sizeof(underlying_t);
+        float* rd = rtensor.data_ptr<float>();
+        int num_tasks = at::get_num_threads();
+        at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+          for (int task_id = begin; task_id < end; ++task_id) {
+            fbgemm::Dequantize<underlying_t>(
+                qd, /*src=*/
+                rd, /*dst=*/
+                qtensor.numel(), /*len=*/
+                qparams, /*qparams=*/
+                task_id, /*thread_id*/
+                num_tasks /*num_threads*/);
+          }
+        });
+      });
+}
+#else // USE_FBGEMM
+
+void quantize_tensor_per_tensor_affine_cpu(
+    Tensor rtensor,
+    Tensor qtensor,
+    double scale,
+    int64_t zero_point) {
   AT_DISPATCH_QINT_TYPES(
       qtensor.scalar_type(), "quantize_tensor_per_tensor_affine_cpu", [&]() {
         TORCH_CHECK(
             rtensor.is_contiguous(), "Float tensor should be contiguous");
         const float* const rdata = rtensor.data_ptr<float>();
         auto qdata = qtensor.data_ptr<scalar_t>();
-        auto numel = rtensor.numel();
-        for (int i = 0; i < numel; ++i) {
-          qdata[i] = quantize_val<scalar_t>(scale, zero_point, rdata[i]);
-        }
+        at::parallel_for(
+            0, rtensor.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+              quantize_span<scalar_t>(
+                  rdata + begin, qdata + begin, end - begin, scale, zero_point);
+            });
       });
-#endif // __ARM_NEON__
 }
 
 void dequantize_tensor_per_tensor_affine_cpu(
@@ -2520,15 +2631,17 @@ void dequantize_tensor_per_tensor_affine_cpu(
       qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine_cpu", [&]() {
         const auto* qd = qtensor.data_ptr<scalar_t>();
         float* rd = rtensor.data_ptr<float>();
-        auto numel = qtensor.numel();
-        for (auto i = 0; i < numel; ++i) {
-          rd[i] = dequantize_val<scalar_t>(scale, zero_point, qd[i]);
-        }
+        at::parallel_for(
+            0, qtensor.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+              dequantize_span<scalar_t>(
+                  qd + begin, rd + begin, end - begin, scale, zero_point);
+            });
       });
 }
 #endif // USE_FBGEMM
 
-// TODO: add fbgemm for per channel
+// The per channel kernels process the tensor as rows of the
+// `elements_per_channel` contiguous values sharing a channel, in parallel.
 void quantize_tensor_per_channel_affine_cpu(
     Tensor rtensor,
     Tensor qtensor,
@@ -2545,16 +2658,21 @@ void quantize_tensor_per_channel_affine_cpu(
         auto zero_points_data = zero_points.data_ptr<int64_t>();
         const float* rdata = rtensor.data_ptr<float>();
         auto qdata = qtensor.data_ptr<scalar_t>();
-        for (auto b = 0; b < batches; ++b) {
-          for (auto c = 0; c < channel; ++c) {
-            for (auto e = 0; e < elements_per_channel; ++e) {
-              auto i = b * channel * elements_per_channel +
-                  c * elements_per_channel + e;
-              qdata[i] = quantize_val<scalar_t>(
-                  scales_data[c], zero_points_data[c], rdata[i]);
-            }
-          }
-        }
+        const int64_t grain_size = std::max<int64_t>(
+            1, internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1));
+        at::parallel_for(
+            0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; ++row) {
+                const auto c = row % channel;
+                const auto offset = row * elements_per_channel;
+                quantize_span<scalar_t>(
+                    rdata + offset,
+                    qdata + offset,
+                    elements_per_channel,
+                    scales_data[c],
+                    zero_points_data[c]);
+              }
+            });
       });
 }
 
@@ -2574,38 +2692,187 @@ void dequantize_tensor_per_channel_affine_cpu(
         auto zero_points_data = zero_points.data_ptr<int64_t>();
         const auto* qd = qtensor.data_ptr<scalar_t>();
         float* rd = rtensor.data_ptr<float>();
-        for (auto b = 0; b < batches; ++b) {
-          for (auto c = 0; c < channel; ++c) {
-            for (auto e = 0; e < elements_per_channel; ++e) {
-              auto i = b * channel * elements_per_channel +
-                  c * elements_per_channel + e;
-              // We need to convert the qint8 value to float to ensure the
-              // subtraction subexpression returns a float
-              rd[i] = (static_cast<float>(qd[i].val_) - zero_points_data[c]) *
-                  scales_data[c];
-            }
-          }
-        }
+        const int64_t grain_size = std::max<int64_t>(
+            1, internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1));
+        at::parallel_for(
+            0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; ++row) {
+                const auto c = row % channel;
+                const auto offset = row * elements_per_channel;
+                dequantize_span<scalar_t>(
+                    qd + offset,
+                    rd + offset,
+                    elements_per_channel,
+                    scales_data[c],
+                    zero_points_data[c]);
+              }
+            });
       });
 }
 
+// Returns sum_k x[k] * w[k] for weights stored in BIT_RATE bits each. 4-bit
+// weights are packed two to a byte, the even element in the lower 4 bits.
+// The weights are widened to float in registers, so they are only ever read
+// from memory in their packed form.
+template <int BIT_RATE>
+float weight_only_dot(const float* x, const uint8_t* w, int64_t K) {
+  static_assert(BIT_RATE == 8 || BIT_RATE == 4, "Unsupported bit rate");
+  float sum = 0;
+  int64_t k = 0;
+
+#ifdef CPU_CAPABILITY_AVX2
+  __m256 acc_v[4] = {
+      _mm256_setzero_ps(),
+      _mm256_setzero_ps(),
+      _mm256_setzero_ps(),
+      _mm256_setzero_ps()};
+  const __m128i low_nibbles_v = _mm_set1_epi8(0x0F);
+  // vectorized, four independent accumulators to hide the FMA latency
+  for (; k < K / 32 * 32; k += 32) {
+    for (int j = 0; j < 4; ++j) {
+      __m128i w_v;
+      if (BIT_RATE == 8) {
+        w_v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + k + 8 * j));
+      } else {
+        int32_t packed;
+        std::memcpy(&packed, w + (k + 8 * j) / 2, sizeof(packed));
+        const __m128i bytes_v = _mm_cvtsi32_si128(packed);
+        w_v = _mm_unpacklo_epi8(
+            _mm_and_si128(bytes_v, low_nibbles_v),
+            _mm_and_si128(_mm_srli_epi16(bytes_v, 4), low_nibbles_v));
+      }
+      acc_v[j] = _mm256_fmadd_ps(
+          _mm256_loadu_ps(x + k + 8 * j),
+          _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(w_v)),
+          acc_v[j]);
+    }
+  }
+  alignas(32) float temp[8];
+  _mm256_store_ps(
+      temp,
+      _mm256_add_ps(
+          _mm256_add_ps(acc_v[0], acc_v[1]), _mm256_add_ps(acc_v[2], acc_v[3])));
+  for (int j = 0; j < 8; ++j) {
+    sum += temp[j];
+  }
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+  float32x4_t acc_v[4] = {
+      vdupq_n_f32(0), vdupq_n_f32(0), vdupq_n_f32(0), vdupq_n_f32(0)};
+  // vectorized, 16 weights per iteration
+  for (; k < K / 16 * 16; k += 16) {
+    uint8x8_t w_v[2];
+    if (BIT_RATE == 8) {
+      w_v[0] = vld1_u8(w + k);
+      w_v[1] = vld1_u8(w + k + 8);
+    } else {
+      const uint8x8_t bytes_v = vld1_u8(w + k / 2);
+      const uint8x8x2_t nibbles_v =
+          vzip_u8(vand_u8(bytes_v, vdup_n_u8(0x0F)), vshr_n_u8(bytes_v, 4));
+      w_v[0] = nibbles_v.val[0];
+      w_v[1] = nibbles_v.val[1];
+    }
+    for (int j = 0; j < 2; ++j) {
+      const uint16x8_t w_u16_v = vmovl_u8(w_v[j]);
+      acc_v[2 * j] = vmlaq_f32(
+          acc_v[2 * j],
+          vld1q_f32(x + k + 8 * j),
+          vcvtq_f32_u32(vmovl_u16(vget_low_u16(w_u16_v))));
+      acc_v[2 * j + 1] = vmlaq_f32(
+          acc_v[2 * j + 1],
+          vld1q_f32(x + k + 8 * j + 4),
+          vcvtq_f32_u32(vmovl_u16(vget_high_u16(w_u16_v))));
+    }
+  }
+  float temp[4];
+  vst1q_f32(
+      temp,
+      vaddq_f32(vaddq_f32(acc_v[0], acc_v[1]), vaddq_f32(acc_v[2], acc_v[3])));
+  for (int j = 0; j < 4; ++j) {
+    sum += temp[j];
+  }
+#endif
+
+  // scalar
+  for (; k < K; ++k) {
+    const uint8_t w_k =
+        BIT_RATE == 8 ? w[k] : (w[k / 2] >> ((k % 2) * 4)) & 0x0F;
+    sum += x[k] * w_k;
+  }
+  return sum;
+}
+
+// Computes output = input * dequantize(packed_weight)^T + bias for a float
+// input of [M, K]. Every row of packed_weight holds the BIT_RATE-bit weights
+// of one output channel followed by its scale and minimum, laid out as
+// quantized::embedding_bag_byte_prepack and quantized::embedding_bag_4bit_prepack
+// produce them. As w = scale * q + minimum, the minimum only needs the row
+// sums of the input, and every weight row is streamed once for all M inputs.
+template <int BIT_RATE>
+void qlinear_weight_only_kernel(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& bias,
+    Tensor& output) {
+  const int64_t M = input.size(0);
+  const int64_t K = input.size(1);
+  const int64_t N = packed_weight.size(0);
+  const int64_t row_bytes = packed_weight.size(1);
+  const int64_t data_bytes = BIT_RATE == 8 ? K : (K + 1) / 2;
+  const float* input_data = input.data_ptr<float>();
+  const uint8_t* weight_data = packed_weight.data_ptr<uint8_t>();
+  const float* bias_data = bias.defined() ? bias.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+
+  std::vector<float> input_sums(M);
+  for (int64_t m = 0; m < M; ++m) {
+    const float* x = input_data + m * K;
+    input_sums[m] = std::accumulate(x, x + K, 0.0f);
+  }
+
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(K * M, 1));
+  at::parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; ++n) {
+      const uint8_t* w_row = weight_data + n * row_bytes;
+      float scale, minimum;
+      if (BIT_RATE == 8) {
+        std::memcpy(&scale, w_row + data_bytes, sizeof(float));
+        std::memcpy(&minimum, w_row + data_bytes + sizeof(float), sizeof(float));
+      } else {
+        at::Half scale_and_minimum[2];
+        std::memcpy(scale_and_minimum, w_row + data_bytes, sizeof(scale_and_minimum));
+        scale = scale_and_minimum[0];
+        minimum = scale_and_minimum[1];
+      }
+      const float b = bias_data ? bias_data[n] : 0.0f;
+      for (int64_t m = 0; m < M; ++m) {
+        output_data[m * N + n] = scale *
+                weight_only_dot<BIT_RATE>(input_data + m * K, w_row, K) +
+            minimum * input_sums[m] + b;
+      }
+    }
+  });
+}
+
 } // namespace
 
 REGISTER_DISPATCH(dequantize_tensor_per_channel_affine_stub,
                   &dequantize_tensor_per_channel_affine_cpu);
 REGISTER_DISPATCH(dequantize_tensor_per_tensor_affine_stub,
                   &dequantize_tensor_per_tensor_affine_cpu);
-REGISTER_DISPATCH(fake_quant_grad_learnable_scale_channel_stub,
-                  &fake_quantize_learnable_scale_grad_channel_kernel);
+REGISTER_DISPATCH(fake_quant_grad_learnable_channel_stub,
+                  &fake_quantize_learnable_channel_grad_kernel_cpu);
 REGISTER_DISPATCH(fake_quant_grad_learnable_tensor_stub,
                   &fake_quantize_learnable_tensor_grad_kernel_cpu);
-REGISTER_DISPATCH(fake_quant_grad_learnable_zero_point_channel_stub,
-                  &fake_quantize_learnable_zero_point_grad_channel_kernel);
 REGISTER_DISPATCH(fake_quant_grad_per_channel_stub,
                   &fake_quant_grad_per_channel_cpu);
 REGISTER_DISPATCH(fake_quant_grad_tensor_stub,
                   &fake_quantize_grad_tensor_kernel);
+REGISTER_DISPATCH(fake_quant_per_channel_cachemask_stub,
+                  &fake_quant_per_channel_cachemask_cpu);
 REGISTER_DISPATCH(fake_quant_per_channel_stub, &fake_quant_per_channel_cpu);
+REGISTER_DISPATCH(fake_quant_tensor_cachemask_stub,
+                  &fake_quantize_tensor_cachemask_kernel);
 REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel);
 REGISTER_DISPATCH(qadaptive_avg_pool2d_nhwc_stub,
                   &qadaptive_avg_pool2d_nhwc_kernel);
@@ -2625,6 +2892,10 @@ REGISTER_DISPATCH(qclamp_stub, &qclamp_kernel);
 REGISTER_DISPATCH(qelu_stub, &qelu_kernel);
 REGISTER_DISPATCH(qhardsigmoid_stub, &qhardsigmoid_kernel);
 REGISTER_DISPATCH(qhardswish_stub, &qhardswish_kernel);
+REGISTER_DISPATCH(qlinear_weight_only_4bit_stub,
+                  &qlinear_weight_only_kernel<4>);
+REGISTER_DISPATCH(qlinear_weight_only_byte_stub,
+                  &qlinear_weight_only_kernel<8>);
 REGISTER_DISPATCH(qmaxpool_2d_nhwc_stub, &qmaxpool_2d_nhwc_kernel);
 REGISTER_DISPATCH(qmul_relu_stub, &qmul_kernel<true>);
 REGISTER_DISPATCH(qmul_stub, &qmul_kernel<false>);
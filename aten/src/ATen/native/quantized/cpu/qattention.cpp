@@ -0,0 +1,354 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+#include <torch/library.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Products of two 8-bit values with their zero points removed are at most
+// 255 * 255, so dot products of up to this many of them fit in int32.
+constexpr int64_t kMaxReductionSize =
+    std::numeric_limits<int32_t>::max() / (255 * 255);
+
+inline void check_per_tensor_operands(
+    const char* op_name,
+    const Tensor& qa,
+    const Tensor& qb) {
+  TORCH_CHECK(
+      qa.qscheme() == kPerTensorAffine && qb.qscheme() == kPerTensorAffine,
+      op_name,
+      ": Only per tensor quantization is supported.");
+  TORCH_CHECK(
+      qa.scalar_type() == qb.scalar_type(),
+      op_name,
+      ": Operands should have the same data type.");
+  TORCH_CHECK(
+      qa.scalar_type() == kQUInt8 || qa.scalar_type() == kQInt8,
+      op_name,
+      ": Only quint8 and qint8 operands are supported, got ",
+      toString(qa.scalar_type()));
+}
+
+// Returns sum_k (a[k] - a_zero_point) * (b[k] - b_zero_point). Both rows are
+// contiguous, so the loop vectorizes.
+template <typename underlying_t>
+inline int32_t centered_dot(
+    const underlying_t* a,
+    const underlying_t* b,
+    int32_t a_zero_point,
+    int32_t b_zero_point,
+    int64_t size) {
+  int32_t acc = 0;
+  for (int64_t k = 0; k < size; ++k) {
+    acc += (static_cast<int32_t>(a[k]) - a_zero_point) *
+        (static_cast<int32_t>(b[k]) - b_zero_point);
+  }
+  return acc;
+}
+
+class QBmm final {
+ public:
+  // qa is [B, M, K], qb is [B, K, N]. The products are accumulated in int32
+  // and requantized straight to the output scale, without going through
+  // float.
+  static Tensor run(
+      Tensor qa,
+      Tensor qb,
+      double output_scale,
+      int64_t output_zero_point) {
+    check_per_tensor_operands("quantized::bmm", qa, qb);
+    TORCH_CHECK(
+        qa.dim() == 3 && qb.dim() == 3,
+        "quantized::bmm: Expected 3-D operands, got ",
+        qa.dim(),
+        "-D and ",
+        qb.dim(),
+        "-D");
+    TORCH_CHECK(
+        qa.size(0) == qb.size(0) && qa.size(2) == qb.size(1),
+        "quantized::bmm: Operand sizes ",
+        qa.sizes(),
+        " and ",
+        qb.sizes(),
+        " do not match");
+    const int64_t batch = qa.size(0);
+    const int64_t M = qa.size(1);
+    const int64_t K = qa.size(2);
+    const int64_t N = qb.size(2);
+    TORCH_CHECK(
+        K <= kMaxReductionSize,
+        "quantized::bmm: Reduction size ",
+        K,
+        " is too large, at most ",
+        kMaxReductionSize,
+        " is supported");
+
+    // Rows of qa and columns of qb are both needed contiguously.
+    const Tensor a = qa.contiguous();
+    const Tensor bt = qb.transpose(1, 2).contiguous();
+    Tensor out = at::_empty_affine_quantized(
+        {batch, M, N}, qa.options(), output_scale, output_zero_point);
+
+    const int32_t a_zero_point = qa.q_zero_point();
+    const int32_t b_zero_point = qb.q_zero_point();
+    const double multiplier = qa.q_scale() * qb.q_scale() / output_scale;
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(N * K, 1));
+
+    AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qbmm", [&]() {
+      const auto* a_data =
+          reinterpret_cast<const underlying_t*>(a.data_ptr<scalar_t>());
+      const auto* bt_data =
+          reinterpret_cast<const underlying_t*>(bt.data_ptr<scalar_t>());
+      auto* out_data = out.data_ptr<scalar_t>();
+      at::parallel_for(0, batch * M, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const underlying_t* a_row = a_data + row * K;
+          const underlying_t* bt_batch = bt_data + (row / M) * N * K;
+          scalar_t* out_row = out_data + row * N;
+          for (int64_t n = 0; n < N; ++n) {
+            const int32_t acc = centered_dot(
+                a_row, bt_batch + n * K, a_zero_point, b_zero_point, K);
+            out_row[n] = requantize_from_int<scalar_t>(
+                multiplier, output_zero_point, acc);
+          }
+        }
+      });
+    });
+    return out;
+  }
+};
+
+class QSoftmax final {
+ public:
+  // Softmax only depends on differences to the row maximum. For 8-bit inputs
+  // there are just 256 of those, so the exponentials come from a table.
+  static Tensor run(
+      Tensor qx,
+      int64_t dim,
+      double output_scale,
+      int64_t output_zero_point) {
+    TORCH_CHECK(
+        qx.qscheme() == kPerTensorAffine,
+        "quantized::softmax: Only per tensor quantization is supported.");
+    TORCH_CHECK(
+        qx.scalar_type() == kQUInt8 || qx.scalar_type() == kQInt8,
+        "quantized::softmax: Only quint8 and qint8 inputs are supported, got ",
+        toString(qx.scalar_type()));
+    dim = maybe_wrap_dim(dim, qx.dim());
+    const int64_t last = std::max<int64_t>(qx.dim() - 1, 0);
+    const Tensor input =
+        (dim == last ? qx : qx.transpose(dim, last)).contiguous();
+    Tensor out = at::_empty_affine_quantized(
+        input.sizes(), qx.options(), output_scale, output_zero_point);
+    if (input.numel() == 0) {
+      return dim == last ? out : out.transpose(dim, last).contiguous();
+    }
+
+    const int64_t row_size = qx.dim() > 0 ? input.size(-1) : 1;
+    const int64_t rows = input.numel() / row_size;
+    std::array<float, 256> exp_table;
+    for (size_t d = 0; d < exp_table.size(); ++d) {
+      exp_table[d] = std::exp(-static_cast<float>(d * qx.q_scale()));
+    }
+    const float inv_output_scale = 1.0f / output_scale;
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / row_size);
+
+    AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qsoftmax", [&]() {
+      const auto* in_data =
+          reinterpret_cast<const underlying_t*>(input.data_ptr<scalar_t>());
+      auto* out_data = out.data_ptr<scalar_t>();
+      constexpr int32_t qmin = std::numeric_limits<underlying_t>::min();
+      constexpr int32_t qmax = std::numeric_limits<underlying_t>::max();
+      at::parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const underlying_t* x = in_data + row * row_size;
+          scalar_t* y = out_data + row * row_size;
+          const int32_t max = *std::max_element(x, x + row_size);
+          float sum = 0;
+          for (int64_t j = 0; j < row_size; ++j) {
+            sum += exp_table[max - x[j]];
+          }
+          const float multiplier = inv_output_scale / sum;
+          for (int64_t j = 0; j < row_size; ++j) {
+            const int32_t q = output_zero_point +
+                static_cast<int32_t>(
+                    std::nearbyint(exp_table[max - x[j]] * multiplier));
+            y[j] = static_cast<scalar_t>(std::min(std::max(q, qmin), qmax));
+          }
+        }
+      });
+    });
+    return dim == last ? out : out.transpose(dim, last).contiguous();
+  }
+};
+
+class QScaledDotProductAttention final {
+ public:
+  // Computes softmax(scaling * q k^T + attn_mask) v for q of [B, Lq, D], k of
+  // [B, Lk, D] and v of [B, Lk, Dv], where B usually folds batch and heads as
+  // in multi_head_attention_forward. Every row of attention weights is built,
+  // normalized and applied in one pass, so the [B, Lq, Lk] score matrix is
+  // never materialized. The q k^T products are accumulated in int32 and the
+  // weights are applied to v without dequantizing it.
+  static Tensor run(
+      Tensor q,
+      Tensor k,
+      Tensor v,
+      c10::optional<Tensor> attn_mask,
+      double scaling,
+      double output_scale,
+      int64_t output_zero_point) {
+    check_per_tensor_operands("quantized::scaled_dot_product_attention", q, k);
+    check_per_tensor_operands("quantized::scaled_dot_product_attention", q, v);
+    TORCH_CHECK(
+        q.dim() == 3 && k.dim() == 3 && v.dim() == 3,
+        "quantized::scaled_dot_product_attention: Expected 3-D q, k and v");
+    const int64_t batch = q.size(0);
+    const int64_t Lq = q.size(1);
+    const int64_t D = q.size(2);
+    const int64_t Lk = k.size(1);
+    const int64_t Dv = v.size(2);
+    TORCH_CHECK(
+        k.size(0) == batch && v.size(0) == batch && k.size(2) == D &&
+            v.size(1) == Lk,
+        "quantized::scaled_dot_product_attention: Sizes of q ",
+        q.sizes(),
+        ", k ",
+        k.sizes(),
+        " and v ",
+        v.sizes(),
+        " do not match");
+    TORCH_CHECK(
+        D <= kMaxReductionSize,
+        "quantized::scaled_dot_product_attention: Head size ",
+        D,
+        " is too large, at most ",
+        kMaxReductionSize,
+        " is supported");
+
+    // Masks follow multi_head_attention_forward: boolean masks are true where
+    // attention is not allowed, float masks are added to the scores. Either
+    // is [Lq, Lk] or [B, Lq, Lk].
+    Tensor mask;
+    if (attn_mask.has_value() && attn_mask->defined()) {
+      TORCH_CHECK(
+          attn_mask->dim() == 2 || attn_mask->dim() == 3,
+          "quantized::scaled_dot_product_attention: Expected a 2-D or 3-D "
+          "attn_mask, got ",
+          attn_mask->dim(),
+          "-D");
+      if (attn_mask->scalar_type() == kBool) {
+        mask = at::zeros(attn_mask->sizes(), attn_mask->options().dtype(kFloat))
+                   .masked_fill_(
+                       *attn_mask, -std::numeric_limits<float>::infinity());
+      } else {
+        mask = attn_mask->to(kFloat);
+      }
+      mask = (mask.dim() == 2 ? mask.unsqueeze(0) : mask).expand({batch, Lq, Lk});
+    }
+
+    const Tensor q_contig = q.contiguous();
+    const Tensor k_contig = k.contiguous();
+    const Tensor v_contig = v.contiguous();
+    Tensor out = at::_empty_affine_quantized(
+        {batch, Lq, Dv}, q.options(), output_scale, output_zero_point);
+
+    const int32_t q_zero_point = q.q_zero_point();
+    const int32_t k_zero_point = k.q_zero_point();
+    const float v_zero_point = v.q_zero_point();
+    const float score_scale = scaling * q.q_scale() * k.q_scale();
+    const float v_scale = v.q_scale();
+    const int64_t grain_size = std::max<int64_t>(
+        1, internal::GRAIN_SIZE / std::max<int64_t>(Lk * (D + Dv), 1));
+
+    AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qscaled_dot_product_attention", [&]() {
+      const auto* q_data =
+          reinterpret_cast<const underlying_t*>(q_contig.data_ptr<scalar_t>());
+      const auto* k_data =
+          reinterpret_cast<const underlying_t*>(k_contig.data_ptr<scalar_t>());
+      const auto* v_data =
+          reinterpret_cast<const underlying_t*>(v_contig.data_ptr<scalar_t>());
+      const float* mask_data = mask.defined() ? mask.data_ptr<float>() : nullptr;
+      const int64_t mask_strides[3] = {
+          mask.defined() ? mask.stride(0) : 0,
+          mask.defined() ? mask.stride(1) : 0,
+          mask.defined() ? mask.stride(2) : 0};
+      auto* out_data = out.data_ptr<scalar_t>();
+      at::parallel_for(0, batch * Lq, grain_size, [&](int64_t begin, int64_t end) {
+        std::vector<float> weights(Lk);
+        std::vector<float> acc(Dv);
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t b = row / Lq;
+          const int64_t i = row % Lq;
+          const underlying_t* q_row = q_data + row * D;
+          const underlying_t* k_batch = k_data + b * Lk * D;
+          const underlying_t* v_batch = v_data + b * Lk * Dv;
+
+          float max = -std::numeric_limits<float>::infinity();
+          for (int64_t j = 0; j < Lk; ++j) {
+            float score = score_scale *
+                centered_dot(q_row, k_batch + j * D, q_zero_point, k_zero_point, D);
+            if (mask_data) {
+              score += mask_data
+                  [b * mask_strides[0] + i * mask_strides[1] +
+                   j * mask_strides[2]];
+            }
+            weights[j] = score;
+            max = std::max(max, score);
+          }
+          // A fully masked row has no valid weights; it comes out as the
+          // value of a zero vector rather than NaN.
+          float sum = 0;
+          for (int64_t j = 0; j < Lk; ++j) {
+            weights[j] = max == -std::numeric_limits<float>::infinity()
+                ? 0.0f
+                : std::exp(weights[j] - max);
+            sum += weights[j];
+          }
+          const float inv_sum = sum > 0 ? 1.0f / sum : 0.0f;
+
+          std::fill(acc.begin(), acc.end(), 0.0f);
+          for (int64_t j = 0; j < Lk; ++j) {
+            const float w = weights[j] * inv_sum;
+            const underlying_t* v_row = v_batch + j * Dv;
+            for (int64_t e = 0; e < Dv; ++e) {
+              acc[e] += w * static_cast<float>(v_row[e]);
+            }
+          }
+          // The weights of a row sum to one (or zero), so the zero point of v
+          // is removed once per output.
+          const float v_offset = sum > 0 ? v_zero_point : 0.0f;
+          scalar_t* out_row = out_data + row * Dv;
+          for (int64_t e = 0; e < Dv; ++e) {
+            out_row[e] = quantize_val<scalar_t>(
+                output_scale, output_zero_point, v_scale * (acc[e] - v_offset));
+          }
+        }
+      });
+    });
+    return out;
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
+  m.impl("bmm", TORCH_FN(QBmm::run));
+  m.impl("softmax", TORCH_FN(QSoftmax::run));
+  m.impl(
+      "scaled_dot_product_attention",
+      TORCH_FN(QScaledDotProductAttention::run));
+}
+
+} // namespace
+} // namespace native
+} // namespace at
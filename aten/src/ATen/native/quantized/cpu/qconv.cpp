@@ -9,6 +9,7 @@
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/native/quantized/cpu/quant_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
 #include <caffe2/utils/threadpool/pthreadpool-cpp.h>
 
@@ -704,6 +705,77 @@ class QConv1dInt8 final {
   }
 };
 
+// conv(act) + accum, optionally followed by relu, as produced by the
+// conv - add(- relu) pattern of residual blocks.
+//
+// The fbgemm and QNNPACK convolutions only requantize into their own output
+// processors, so the sum is not folded into the conv epilogue. Instead the
+// conv is requantized into an intermediate range wide enough for every value
+// that can still land inside the final output range once accum is added, and
+// a single pass of the quantized add then writes the output, instead of the
+// float tensors materialized by the dequantize - add - quantize of the
+// unfused graph.
+template <int kSpatialDim, bool kReluFused>
+class QConvAddInt8 final {
+ public:
+  static Tensor run(
+      Tensor act,
+      Tensor accum,
+      const c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>>& packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    const char* op_name = kReluFused ? "quantized::conv2d_add_relu"
+                                     : "quantized::conv2d_add";
+    TORCH_CHECK(
+        accum.scalar_type() == c10::kQUInt8 &&
+            accum.qscheme() == kPerTensorAffine,
+        op_name,
+        ": Expected a per-tensor quantized quint8 accumulation tensor, got ",
+        accum.scalar_type());
+
+    // Float range of accum and of the final output.
+    const double accum_scale = accum.q_scale();
+    const int64_t accum_zero_point = accum.q_zero_point();
+    const double accum_lo = -accum_zero_point * accum_scale;
+    const double accum_hi = (255 - accum_zero_point) * accum_scale;
+    double out_lo = -output_zero_point * output_scale;
+    const double out_hi = (255 - output_zero_point) * output_scale;
+    if (kReluFused) {
+      out_lo = std::max(out_lo, 0.0);
+    }
+    // conv values outside [lo, hi] saturate the output whatever accum holds,
+    // so clamping them in the intermediate does not change the result.
+    const double lo = std::min(out_lo - accum_hi, 0.0);
+    const double hi = std::max(out_hi - accum_lo, 0.0);
+    const double conv_scale = hi > lo ? (hi - lo) / 255 : output_scale;
+    const int64_t conv_zero_point = std::min<int64_t>(
+        255, std::max<int64_t>(0, std::nearbyint(-lo / conv_scale)));
+
+    const Tensor conv =
+        packed_weight->apply(act, conv_scale, conv_zero_point);
+    TORCH_CHECK(
+        accum.sizes() == conv.sizes(),
+        op_name,
+        ": Expected an accumulation tensor of sizes ",
+        conv.sizes(),
+        ", got ",
+        accum.sizes());
+    Tensor output = at::_empty_affine_quantized(
+        conv.sizes(),
+        at::device(c10::kCPU)
+            .dtype(c10::kQUInt8)
+            .memory_format(conv.suggest_memory_format()),
+        output_scale,
+        output_zero_point);
+    if (kReluFused) {
+      qadd_relu_stub(c10::kCPU, output, conv, accum);
+    } else {
+      qadd_stub(c10::kCPU, output, conv, accum);
+    }
+    return output;
+  }
+};
+
 // kernel for maintaining backward compatibility
 template <int kSpatialDim, bool kReluFused>
 class QConvInt8ForBC final {
@@ -740,6 +812,8 @@ TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("conv2d_relu.new", QConvInt8<2, true>::run);
   m.impl("conv3d.new",      QConvInt8<3, false>::run);
   m.impl("conv3d_relu.new", QConvInt8<3, true>::run);
+  m.impl("conv2d_add",      QConvAddInt8<2, false>::run);
+  m.impl("conv2d_add_relu", QConvAddInt8<2, true>::run);
   // for backward compatibility
   m.impl("conv2d", QConvInt8ForBC<2, false>::run);
   m.impl("conv2d_relu", QConvInt8ForBC<2, true>::run);
@@ -0,0 +1,333 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+
+#ifdef USE_FBGEMM
+#include <fbgemm/Fbgemm.h>
+#include <fbgemm/FbgemmEmbedding.h>
+#else
+#include <caffe2/perfkernels/embedding_lookup_idx.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup_idx.h>
+#include <caffe2/perfkernels/fused_nbit_rowwise_conversion.h>
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+constexpr int prefetch_distance = 16;
+
+// Looks up the bags [begin, end) of one table and writes the pooled rows to
+// the matching rows of its output. Returns false on an out of range index.
+using TableLookup = std::function<bool(int64_t begin, int64_t end)>;
+
+// Number of bytes per row, past the data, that hold the row-wise scale and
+// bias of a table with the given bit rate. 8-bit tables store them as floats
+// (see embedding_bag_byte_prepack), 4 and 2-bit tables as halfs (see
+// embedding_bag_4bit_prepack).
+int64_t scale_bias_bytes(int64_t bit_rate) {
+  return bit_rate == 8 ? 2 * sizeof(float) : 2 * sizeof(at::Half);
+}
+
+#ifndef USE_FBGEMM
+// Reference lookup for the 4 and 2-bit tables, which the caffe2 perfkernels
+// only convert row by row.
+bool nbit_rowwise_lookup(
+    int bit_rate,
+    int64_t block_size,
+    int64_t output_size,
+    int64_t data_size,
+    int64_t row_bytes,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int64_t* offsets,
+    const float* weights,
+    float* out) {
+  std::vector<float> row(block_size);
+  const int64_t index_size = offsets[output_size] - offsets[0];
+  int64_t current = 0;
+  for (int64_t m = 0; m < output_size; ++m, out += block_size) {
+    std::fill(out, out + block_size, 0.f);
+    for (int64_t i = offsets[m]; i < offsets[m + 1]; ++i, ++current) {
+      const int64_t idx = indices[current];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+#ifdef __GNUC__
+      if (current + prefetch_distance < index_size) {
+        const int64_t next = indices[current + prefetch_distance];
+        if (next >= 0 && next < data_size) {
+          __builtin_prefetch(input + next * row_bytes, 0, 1);
+        }
+      }
+#endif
+      caffe2::FusedNBitRowwiseQuantizedSBHalfToFloat(
+          bit_rate, input + idx * row_bytes, 1, row_bytes, row.data());
+      const float w = weights ? weights[current] : 1.f;
+      for (int64_t j = 0; j < block_size; ++j) {
+        out[j] += w * row[j];
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+// Builds the lookup for table `t`. `offsets` includes the last offset and
+// must outlive the returned function, as must the tensors.
+TableLookup make_table_lookup(
+    int64_t bit_rate,
+    const Tensor& weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& offsets,
+    const float* per_sample_weights,
+    const Tensor& output) {
+  const int64_t N = weight.size(0);
+  const int64_t row_bytes = weight.size(1);
+  const int64_t D = output.size(1);
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+  const int64_t* offsets_data = offsets.data();
+  float* output_data = output.data_ptr<float>();
+  const float* w = per_sample_weights;
+
+#ifdef USE_FBGEMM
+  (void)row_bytes;
+  if (bit_rate == 32 || bit_rate == 16 || bit_rate == 8) {
+    auto run = [=](auto kernel, auto* input) -> TableLookup {
+      return [=](int64_t begin, int64_t end) {
+        return kernel(
+            /*output_size=*/end - begin,
+            /*index_size=*/offsets_data[end] - offsets_data[begin],
+            /*data_size=*/N,
+            /*input=*/input,
+            /*indices=*/indices_data + offsets_data[begin],
+            /*offsets_or_lengths=*/offsets_data + begin,
+            /*weights=*/w ? w + offsets_data[begin] : nullptr,
+            /*out=*/output_data + begin * D);
+      };
+    };
+    const bool has_weight = w != nullptr;
+    if (bit_rate == 32) {
+      return run(
+          fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
+              D, has_weight, /*normalize_by_lengths=*/false, prefetch_distance,
+              /*is_weight_positional=*/false, /*use_offsets=*/true),
+          weight.data_ptr<float>());
+    } else if (bit_rate == 16) {
+      return run(
+          fbgemm::GenerateEmbeddingSpMDM<fbgemm::float16, int64_t, int64_t>(
+              D, has_weight, /*normalize_by_lengths=*/false, prefetch_distance,
+              /*is_weight_positional=*/false, /*use_offsets=*/true),
+          reinterpret_cast<const fbgemm::float16*>(weight.data_ptr<at::Half>()));
+    }
+    return run(
+        fbgemm::GenerateEmbeddingSpMDM<uint8_t, int64_t, int64_t>(
+            D, has_weight, /*normalize_by_lengths=*/false, prefetch_distance,
+            /*is_weight_positional=*/false, /*use_offsets=*/true),
+        weight.data_ptr<uint8_t>());
+  }
+  // The n-bit kernels take int offsets.
+  auto offsets_int = std::make_shared<std::vector<int>>(
+      offsets.begin(), offsets.end());
+  auto kernel = fbgemm::GenerateEmbeddingSpMDMNBit<int64_t>(
+      bit_rate, D, w != nullptr, /*normalize_by_lengths=*/false,
+      prefetch_distance, /*is_weight_positional=*/false, /*use_offsets=*/true);
+  const uint8_t* input = weight.data_ptr<uint8_t>();
+  return [=](int64_t begin, int64_t end) {
+    const int* o = offsets_int->data();
+    return kernel(
+        /*output_size=*/end - begin,
+        /*index_size=*/o[end] - o[begin],
+        /*data_size=*/N,
+        /*input=*/input,
+        /*indices=*/indices_data + o[begin],
+        /*offsets=*/o + begin,
+        /*weights=*/w ? w + o[begin] : nullptr,
+        /*output=*/output_data + begin * D);
+  };
+#else
+  if (bit_rate == 32 || bit_rate == 16) {
+    const bool is_float = bit_rate == 32;
+    const float* input_float = is_float ? weight.data_ptr<float>() : nullptr;
+    const at::Half* input_half = is_float ? nullptr : weight.data_ptr<at::Half>();
+    return [=](int64_t begin, int64_t end) {
+      const int64_t index_size = offsets_data[end] - offsets_data[begin];
+      const int64_t* idx = indices_data + offsets_data[begin];
+      const float* weights = w ? w + offsets_data[begin] : nullptr;
+      if (is_float) {
+        caffe2::EmbeddingLookupIdx(
+            D, end - begin, index_size, N, input_float, idx,
+            offsets_data + begin, weights, /*scale_bias=*/nullptr,
+            /*normalize_by_lengths=*/false, output_data + begin * D);
+      } else {
+        caffe2::EmbeddingLookupIdx(
+            D, end - begin, index_size, N, input_half, idx,
+            offsets_data + begin, weights, /*scale_bias=*/nullptr,
+            /*normalize_by_lengths=*/false, output_data + begin * D);
+      }
+      return true;
+    };
+  }
+  const uint8_t* input = weight.data_ptr<uint8_t>();
+  if (bit_rate == 8) {
+    return [=](int64_t begin, int64_t end) {
+      caffe2::Fused8BitRowwiseEmbeddingLookupIdx(
+          D, end - begin, offsets_data[end] - offsets_data[begin], N, input,
+          indices_data + offsets_data[begin], offsets_data + begin,
+          w ? w + offsets_data[begin] : nullptr,
+          /*normalize_by_lengths=*/false, output_data + begin * D);
+      return true;
+    };
+  }
+  return [=](int64_t begin, int64_t end) {
+    return nbit_rowwise_lookup(
+        bit_rate, D, end - begin, N, row_bytes, input,
+        indices_data + offsets_data[begin], offsets_data + begin,
+        w ? w + offsets_data[begin] : nullptr, output_data + begin * D);
+  };
+#endif
+}
+
+// Sum-pools several embedding tables in one call. Table t has the layout
+// given by bit_rates[t]: 32 and 16 for float and half tables, 8 for tables
+// packed by embedding_bag_byte_prepack and 4 (or 2) for tables packed by
+// embedding_bag_4bit_prepack. indices[t] and offsets[t] are the inputs
+// embedding_bag takes for that table, and per_sample_weights is either empty
+// or has one tensor per table. Returns the pooled float [num_bags, D] output
+// of every table.
+//
+// The bags of all the tables are spread over the threads in a single parallel
+// region, so that models with many small tables don't pay for one parallel
+// region (and one kernel setup) per table.
+std::vector<Tensor> embedding_bag_grouped_rowwise_offsets(
+    TensorList weights,
+    IntArrayRef bit_rates,
+    TensorList indices,
+    TensorList offsets,
+    TensorList per_sample_weights,
+    bool include_last_offset) {
+  const int64_t num_tables = weights.size();
+  TORCH_CHECK(
+      static_cast<int64_t>(bit_rates.size()) == num_tables &&
+          static_cast<int64_t>(indices.size()) == num_tables &&
+          static_cast<int64_t>(offsets.size()) == num_tables,
+      "embedding_bag_grouped_rowwise_offsets: expected as many bit_rates, "
+      "indices and offsets as weights, but got ", bit_rates.size(), ", ",
+      indices.size(), " and ", offsets.size(), " for ", num_tables, " weights");
+  TORCH_CHECK(
+      per_sample_weights.empty() ||
+          static_cast<int64_t>(per_sample_weights.size()) == num_tables,
+      "embedding_bag_grouped_rowwise_offsets: expected per_sample_weights to "
+      "be empty or to have one tensor per table, but got ",
+      per_sample_weights.size(), " for ", num_tables, " tables");
+
+  std::vector<Tensor> weights_contig(num_tables);
+  std::vector<Tensor> indices_contig(num_tables);
+  std::vector<Tensor> weights_per_sample(num_tables);
+  std::vector<std::vector<int64_t>> offsets_include_last(num_tables);
+  std::vector<Tensor> outputs(num_tables);
+  std::vector<TableLookup> lookups(num_tables);
+  // bag_begin[t] is the index of the first bag of table t over all tables.
+  std::vector<int64_t> bag_begin(num_tables + 1, 0);
+
+  for (int64_t t = 0; t < num_tables; ++t) {
+    const int64_t bit_rate = bit_rates[t];
+    const Tensor& weight = weights[t];
+    TORCH_CHECK(weight.dim() == 2, "embedding_bag_grouped_rowwise_offsets: "
+        "expected weights[", t, "] to be 2-D, but got ", weight.dim(), "-D");
+    TORCH_CHECK(
+        indices[t].dim() == 1 && offsets[t].dim() == 1,
+        "embedding_bag_grouped_rowwise_offsets: expected 1-D indices and "
+        "offsets for table ", t);
+    TORCH_CHECK(
+        indices[t].scalar_type() == kLong && offsets[t].scalar_type() == kLong,
+        "embedding_bag_grouped_rowwise_offsets: expected Long indices and "
+        "offsets for table ", t);
+
+    int64_t D = 0;
+    if (bit_rate == 32 || bit_rate == 16) {
+      const auto expected = bit_rate == 32 ? kFloat : kHalf;
+      TORCH_CHECK(weight.scalar_type() == expected,
+          "embedding_bag_grouped_rowwise_offsets: expected weights[", t,
+          "] to be ", expected, " for bit rate ", bit_rate, ", but got ",
+          weight.scalar_type());
+      D = weight.size(1);
+    } else if (bit_rate == 8 || bit_rate == 4 || bit_rate == 2) {
+      TORCH_CHECK(weight.scalar_type() == kByte,
+          "embedding_bag_grouped_rowwise_offsets: expected the packed "
+          "weights[", t, "] to be Byte, but got ", weight.scalar_type());
+      D = (weight.size(1) - scale_bias_bytes(bit_rate)) * (8 / bit_rate);
+      TORCH_CHECK(D > 0, "embedding_bag_grouped_rowwise_offsets: weights[",
+          t, "] has too few columns for a packed table");
+    } else {
+      TORCH_CHECK(false, "embedding_bag_grouped_rowwise_offsets: unsupported "
+          "bit rate ", bit_rate, " for table ", t,
+          "; expected 32, 16, 8, 4 or 2");
+    }
+
+    weights_contig[t] = weight.contiguous();
+    indices_contig[t] = indices[t].contiguous();
+    const int64_t num_indices = indices_contig[t].numel();
+
+    const Tensor offsets_t = offsets[t].contiguous();
+    const int64_t* offsets_data = offsets_t.data_ptr<int64_t>();
+    auto& offs = offsets_include_last[t];
+    offs.assign(offsets_data, offsets_data + offsets_t.numel());
+    if (!include_last_offset || offs.empty()) {
+      offs.push_back(num_indices);
+    }
+    TORCH_CHECK(
+        offs.front() == 0 && offs.back() == num_indices,
+        "embedding_bag_grouped_rowwise_offsets: the offsets of table ", t,
+        " must start at 0 and end at the number of indices");
+    const int64_t num_bags = offs.size() - 1;
+
+    const float* w = nullptr;
+    if (!per_sample_weights.empty()) {
+      weights_per_sample[t] = per_sample_weights[t].contiguous();
+      TORCH_CHECK(
+          weights_per_sample[t].scalar_type() == kFloat &&
+              weights_per_sample[t].numel() == num_indices,
+          "embedding_bag_grouped_rowwise_offsets: expected per_sample_weights[",
+          t, "] to be a Float tensor with one weight per index");
+      w = weights_per_sample[t].data_ptr<float>();
+    }
+
+    outputs[t] = at::empty({num_bags, D}, weight.options().dtype(kFloat));
+    lookups[t] = make_table_lookup(
+        bit_rate, weights_contig[t], indices_contig[t], offs, w, outputs[t]);
+    bag_begin[t + 1] = bag_begin[t] + num_bags;
+  }
+
+  at::parallel_for(0, bag_begin[num_tables], 1, [&](int64_t begin, int64_t end) {
+    // Each thread takes a contiguous range of bags, which may span several
+    // tables.
+    auto t = std::upper_bound(bag_begin.begin(), bag_begin.end(), begin) -
+        bag_begin.begin() - 1;
+    for (; t < num_tables && bag_begin[t] < end; ++t) {
+      const int64_t first = std::max(begin, bag_begin[t]) - bag_begin[t];
+      const int64_t last = std::min(end, bag_begin[t + 1]) - bag_begin[t];
+      if (first >= last) {
+        continue;
+      }
+      TORCH_CHECK(
+          lookups[t](first, last),
+          "embedding_bag_grouped_rowwise_offsets: index out of range in "
+          "table ", t);
+    }
+  });
+  return outputs;
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_grouped_rowwise_offsets", embedding_bag_grouped_rowwise_offsets);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
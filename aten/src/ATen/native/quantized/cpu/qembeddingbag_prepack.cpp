@@ -57,7 +57,7 @@ Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
 
   Tensor weight_contig = weight.contiguous(weight.suggest_memory_format());
 
-  const auto weight_data = weight.data_ptr<float>();
+  const auto weight_data = weight_contig.data_ptr<float>();
   constexpr int BIT_RATE = 4;
   constexpr int NUM_ELEM_PER_BYTE = 8 / BIT_RATE;
   TORCH_CHECK(
@@ -136,6 +136,11 @@ Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
   m.impl("embedding_bag_byte_prepack", qembeddingbag_byte_prepack);
   m.impl("embedding_bag_4bit_prepack", qembeddingbag_4bit_prepack);
+  // Row-wise quantizing a [out_features, in_features] linear weight gives one
+  // scale and minimum per output channel, so weight-only quantized linear
+  // layers share the packed format of embedding tables.
+  m.impl("linear_weight_only_byte_prepack", qembeddingbag_byte_prepack);
+  m.impl("linear_weight_only_4bit_prepack", qembeddingbag_4bit_prepack);
 }
 
 } // namespace
@@ -0,0 +1,100 @@
+#include <ATen/ATen.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+#include <torch/library.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qlinear_weight_only_4bit_stub);
+DEFINE_DISPATCH(qlinear_weight_only_byte_stub);
+
+namespace {
+
+// Weight-only quantized linear: the weights are stored row-wise (one scale and
+// minimum per output channel) in 8 or 4 bits and dequantized on the fly, while
+// activations and the output stay in floating point. This saves 4x (8x) of
+// the weight bandwidth, which is what bounds small batch inference of large
+// linear layers.
+template <int BIT_RATE>
+Tensor qlinear_weight_only(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const c10::optional<Tensor>& bias) {
+  const char* op_name = BIT_RATE == 8 ? "quantized::linear_weight_only_byte"
+                                      : "quantized::linear_weight_only_4bit";
+  TORCH_CHECK(
+      input.scalar_type() == kFloat || input.scalar_type() == kBFloat16,
+      op_name,
+      ": Expected a float or bfloat16 input, got ",
+      input.scalar_type());
+  TORCH_CHECK(input.dim() >= 1, op_name, ": Expected at least a 1-D input");
+  TORCH_CHECK(
+      packed_weight.scalar_type() == kByte && packed_weight.dim() == 2,
+      op_name,
+      ": Expected a 2-D uint8 packed weight, as returned by the matching "
+      "prepack function");
+  const int64_t K = input.size(-1);
+  const int64_t N = packed_weight.size(0);
+  const int64_t expected_row_bytes = BIT_RATE == 8
+      ? K + 2 * static_cast<int64_t>(sizeof(float))
+      : (K + 1) / 2 + 2 * static_cast<int64_t>(sizeof(at::Half));
+  TORCH_CHECK(
+      packed_weight.size(1) == expected_row_bytes,
+      op_name,
+      ": Packed weight rows of ",
+      packed_weight.size(1),
+      " bytes do not match an input of ",
+      K,
+      " features");
+  Tensor bias_float;
+  if (bias.has_value() && bias->defined()) {
+    TORCH_CHECK(
+        bias->dim() == 1 && bias->size(0) == N,
+        op_name,
+        ": Expected a bias of ",
+        N,
+        " elements, got sizes ",
+        bias->sizes());
+    bias_float = bias->to(kFloat).contiguous();
+  }
+
+  const Tensor input_2d = input.reshape({-1, K}).to(kFloat).contiguous();
+  Tensor output = at::empty({input_2d.size(0), N}, input_2d.options());
+  const Tensor weight_contig = packed_weight.contiguous();
+  if (BIT_RATE == 8) {
+    qlinear_weight_only_byte_stub(
+        kCPU, input_2d, weight_contig, bias_float, output);
+  } else {
+    qlinear_weight_only_4bit_stub(
+        kCPU, input_2d, weight_contig, bias_float, output);
+  }
+
+  std::vector<int64_t> output_sizes(input.sizes().begin(), input.sizes().end() - 1);
+  output_sizes.push_back(N);
+  return output.view(output_sizes).to(input.scalar_type());
+}
+
+Tensor qlinear_weight_only_byte(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const c10::optional<Tensor>& bias) {
+  return qlinear_weight_only<8>(input, packed_weight, bias);
+}
+
+Tensor qlinear_weight_only_4bit(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const c10::optional<Tensor>& bias) {
+  return qlinear_weight_only<4>(input, packed_weight, bias);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("linear_weight_only_byte", qlinear_weight_only_byte);
+  m.impl("linear_weight_only_4bit", qlinear_weight_only_4bit);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -149,6 +149,12 @@ def main(args):
                     build.cc("q8gemm/8x8-aarch64-neon.S"),
                     build.cc("q8conv/8x8-aarch64-neon.S"),
                 ]
+                with build.options(extra_cflags=["-march=armv8.2-a+dotprod"]):
+                    qnnpytorch_pack_objects += [
+                        build.cc("q8conv/8x8c4-neondot.c"),
+                        build.cc("q8gemm/8x8c4-dq-neondot.c"),
+                        build.cc("q8gemm/8x8c4-neondot.c"),
+                    ]
             if build.target.is_x86 or build.target.is_x86_64:
                 with build.options(isa=x86.sse2):
                     qnnpytorch_pack_objects += [
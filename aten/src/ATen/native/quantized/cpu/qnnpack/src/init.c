@@ -145,6 +145,20 @@ static void init(void) {
       .nr = 8,
       .kr = 1,
   };
+#if defined(PYTORCH_QNNPACK_NEONDOT_UKERNELS) || defined(__ARM_FEATURE_DOTPROD)
+  /* Cores with the ARMv8.2 dot product extension do 4 multiply-adds per
+   * lane and instruction, so prefer the UDOT microkernels where available. */
+  if (cpuinfo_has_arm_neon_dot()) {
+    pytorch_qnnp_params.q8conv = (struct pytorch_q8conv_parameters){
+        .gemm = pytorch_q8gemm_ukernel_8x8c4__neondot,
+        .conv = pytorch_q8conv_ukernel_8x8c4__neondot,
+        .gemm_dq = pytorch_q8gemm_dq_ukernel_8x8c4__neondot,
+        .mr = 8,
+        .nr = 8,
+        .kr = 4,
+    };
+  }
+#endif
   pytorch_qnnp_params.q8conv_xzp = (struct pytorch_q8conv_xzp_parameters){
       .kthreshold = SIZE_MAX,
   };
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <arm_neon.h>
+
+#include <q8gemm/8x8c4-neondot.h>
+#include <qnnpack/q8gemm.h>
+
+void pytorch_q8gemm_dq_ukernel_8x8c4__neondot(
+    size_t mr,
+    size_t nr,
+    size_t k,
+    const uint8_t* restrict a,
+    size_t a_stride,
+    const void* restrict w,
+    const float* restrict b,
+    float* restrict c,
+    size_t c_stride,
+    size_t output_channel_index,
+    const struct pytorch_qnnp_conv_dynamic_quantization_params
+        quantization_params[RESTRICT_STATIC 1]) {
+  const uint8_t input_zero_point =
+      (uint8_t)quantization_params->input_zero_point;
+
+  /* As in the other dynamic quantization kernels, the integer bias slots of
+   * the packed weights are skipped and the float bias is added at the end. */
+  static const int32_t zero_bias[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  struct pytorch_q8_neondot_acc acc;
+  pytorch_q8_neondot_init(&acc, zero_bias);
+  const uint8_t* wb = (const uint8_t*)((uintptr_t)w + 8 * sizeof(int32_t));
+
+  const uint8_t* a_rows[8];
+  a_rows[0] = a;
+  for (size_t m = 1; m < 8; m++) {
+    a_rows[m] = m < mr ? (const uint8_t*)((uintptr_t)a_rows[m - 1] + a_stride)
+                       : a_rows[m - 1];
+  }
+
+  for (; k >= 8; k -= 8) {
+    uint8x8_t va[8];
+    for (size_t m = 0; m < 8; m++) {
+      va[m] = vld1_u8(a_rows[m]);
+      a_rows[m] += 8;
+    }
+    pytorch_q8_neondot_k8(&acc, va, wb);
+    wb += 64;
+  }
+  if (k != 0) {
+    pytorch_q8_neondot_tail(&acc, a_rows, k, input_zero_point, wb);
+  }
+
+  int32x4_t vacc[8][2];
+  pytorch_q8_neondot_finish(
+      &acc,
+      input_zero_point,
+      &quantization_params->kernel_zero_points[output_channel_index],
+      vacc);
+
+  const float32x4_t vmultiplier[2] = {
+      vld1q_f32(&quantization_params->multipliers[output_channel_index]),
+      vld1q_f32(&quantization_params->multipliers[output_channel_index + 4]),
+  };
+  const float32x4_t vbias[2] = {
+      vld1q_f32(b),
+      vld1q_f32(b + 4),
+  };
+  float32x4_t vout[8][2];
+  for (size_t m = 0; m < 8; m++) {
+    for (size_t h = 0; h < 2; h++) {
+      vout[m][h] = vaddq_f32(
+          vmulq_f32(vmultiplier[h], vcvtq_f32_s32(vacc[m][h])), vbias[h]);
+    }
+  }
+
+  float* c_rows[8];
+  c_rows[0] = c;
+  for (size_t m = 1; m < 8; m++) {
+    c_rows[m] = m < mr ? c_rows[m - 1] + c_stride : c_rows[m - 1];
+  }
+  size_t h = 0;
+  for (; nr >= 4; nr -= 4) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1q_f32(c_rows[m], vout[m][h]);
+      c_rows[m] += 4;
+    }
+    h++;
+  }
+  if (nr >= 2) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1_f32(c_rows[m], vget_low_f32(vout[m][h]));
+      c_rows[m] += 2;
+      vout[m][h] = vextq_f32(vout[m][h], vout[m][h], 2);
+    }
+    nr -= 2;
+  }
+  if (nr != 0) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1q_lane_f32(c_rows[m], vout[m][h], 0);
+    }
+  }
+}
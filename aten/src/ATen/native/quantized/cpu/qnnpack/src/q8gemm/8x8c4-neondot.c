@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <arm_neon.h>
+
+#include <q8gemm/8x8c4-neondot.h>
+#include <qnnpack/q8gemm.h>
+
+void pytorch_q8gemm_ukernel_8x8c4__neondot(
+    size_t mr,
+    size_t nr,
+    size_t k,
+    const uint8_t* restrict a,
+    size_t a_stride,
+    const void* restrict w,
+    uint8_t* restrict c,
+    size_t c_stride,
+    size_t output_channel_index,
+    const union pytorch_qnnp_conv_quantization_params
+        quantization_params[restrict static 1]) {
+  const uint8_t input_zero_point =
+      (uint8_t)quantization_params->neon.input_zero_point;
+
+  struct pytorch_q8_neondot_acc acc;
+  pytorch_q8_neondot_init(&acc, (const int32_t*)w);
+  const uint8_t* wb = (const uint8_t*)((uintptr_t)w + 8 * sizeof(int32_t));
+
+  const uint8_t* a_rows[8];
+  a_rows[0] = a;
+  for (size_t m = 1; m < 8; m++) {
+    a_rows[m] = m < mr ? (const uint8_t*)((uintptr_t)a_rows[m - 1] + a_stride)
+                       : a_rows[m - 1];
+  }
+
+  for (; k >= 8; k -= 8) {
+    uint8x8_t va[8];
+    for (size_t m = 0; m < 8; m++) {
+      va[m] = vld1_u8(a_rows[m]);
+      a_rows[m] += 8;
+    }
+    pytorch_q8_neondot_k8(&acc, va, wb);
+    wb += 64;
+  }
+  if (k != 0) {
+    pytorch_q8_neondot_tail(&acc, a_rows, k, input_zero_point, wb);
+  }
+
+  int32x4_t vacc[8][2];
+  pytorch_q8_neondot_finish(
+      &acc,
+      input_zero_point,
+      &quantization_params->neon.kernel_zero_points[output_channel_index],
+      vacc);
+  pytorch_q8_neondot_requantize_store(
+      vacc, mr, nr, c, c_stride, output_channel_index, quantization_params);
+}
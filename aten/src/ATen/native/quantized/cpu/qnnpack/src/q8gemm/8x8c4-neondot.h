@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <arm_neon.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <qnnpack/params.h>
+
+/*
+ * Shared building blocks of the 8x8c4 microkernels for the ARMv8.2 dot
+ * product extension. Weights are packed with kr = 4, so every 32 bytes hold
+ * 4 consecutive K elements of each of the 8 output channels, and one UDOT
+ * lane instruction accumulates 4 products per output.
+ *
+ * UDOT multiplies the raw unsigned values, so the zero points are applied
+ * once at the end using
+ *
+ *   sum (a - za) * (b - zb) = sum a * b - zb * sum a - za * sum b + K * za * zb
+ *
+ * where the row sums of A and the column sums of B are accumulated with UDOT
+ * against a vector of ones along the way. When K is not a multiple of 4 the
+ * last block of A is padded with za, which makes the padded products vanish
+ * whatever the packed weights hold there.
+ */
+
+struct pytorch_q8_neondot_acc {
+  /* vacc[m][h]: output row m, output channels 4h to 4h + 3 */
+  uint32x4_t vacc[8][2];
+  /* va_sum[p]: per 4-element block sums of rows 2p and 2p + 1 */
+  uint32x4_t va_sum[4];
+  /* vb_sum[h]: sums of output channels 4h to 4h + 3 */
+  uint32x4_t vb_sum[2];
+  /* Number of K elements accumulated, including padding */
+  size_t k;
+};
+
+static inline void pytorch_q8_neondot_init(
+    struct pytorch_q8_neondot_acc* acc,
+    const int32_t* bias) {
+  const uint32x4_t vbias0123 = vreinterpretq_u32_s32(vld1q_s32(bias));
+  const uint32x4_t vbias4567 = vreinterpretq_u32_s32(vld1q_s32(bias + 4));
+  for (size_t m = 0; m < 8; m++) {
+    acc->vacc[m][0] = vbias0123;
+    acc->vacc[m][1] = vbias4567;
+  }
+  for (size_t p = 0; p < 4; p++) {
+    acc->va_sum[p] = vdupq_n_u32(0);
+  }
+  acc->vb_sum[0] = vdupq_n_u32(0);
+  acc->vb_sum[1] = vdupq_n_u32(0);
+  acc->k = 0;
+}
+
+/*
+ * Accumulates 8 K elements of every row: va[m] holds K elements j to j + 7 of
+ * row m, and w points to the 64 packed bytes of the weights for them.
+ */
+static inline void pytorch_q8_neondot_k8(
+    struct pytorch_q8_neondot_acc* acc,
+    const uint8x8_t va[8],
+    const uint8_t* w) {
+  const uint8x16_t vones = vdupq_n_u8(1);
+  const uint8x16_t vb0x0123 = vld1q_u8(w);
+  const uint8x16_t vb0x4567 = vld1q_u8(w + 16);
+  const uint8x16_t vb1x0123 = vld1q_u8(w + 32);
+  const uint8x16_t vb1x4567 = vld1q_u8(w + 48);
+  for (size_t m = 0; m < 8; m++) {
+    acc->vacc[m][0] = vdotq_lane_u32(acc->vacc[m][0], vb0x0123, va[m], 0);
+    acc->vacc[m][1] = vdotq_lane_u32(acc->vacc[m][1], vb0x4567, va[m], 0);
+    acc->vacc[m][0] = vdotq_lane_u32(acc->vacc[m][0], vb1x0123, va[m], 1);
+    acc->vacc[m][1] = vdotq_lane_u32(acc->vacc[m][1], vb1x4567, va[m], 1);
+  }
+  for (size_t p = 0; p < 4; p++) {
+    acc->va_sum[p] = vdotq_u32(
+        acc->va_sum[p], vcombine_u8(va[2 * p], va[2 * p + 1]), vones);
+  }
+  acc->vb_sum[0] = vdotq_u32(acc->vb_sum[0], vb0x0123, vones);
+  acc->vb_sum[1] = vdotq_u32(acc->vb_sum[1], vb0x4567, vones);
+  acc->vb_sum[0] = vdotq_u32(acc->vb_sum[0], vb1x0123, vones);
+  acc->vb_sum[1] = vdotq_u32(acc->vb_sum[1], vb1x4567, vones);
+  acc->k += 8;
+}
+
+/*
+ * Accumulates the remaining 1 to 7 K elements of rows a[0..7], padding them
+ * to a multiple of 4 with the input zero point. Returns the weights pointer
+ * past the consumed blocks.
+ */
+static inline const uint8_t* pytorch_q8_neondot_tail(
+    struct pytorch_q8_neondot_acc* acc,
+    const uint8_t* const a[8],
+    size_t k,
+    uint8_t input_zero_point,
+    const uint8_t* w) {
+  const uint8x16_t vones = vdupq_n_u8(1);
+  uint8x8_t va[8];
+  for (size_t m = 0; m < 8; m++) {
+    uint8_t padded[8];
+    memset(padded, input_zero_point, sizeof(padded));
+    memcpy(padded, a[m], k);
+    va[m] = vld1_u8(padded);
+  }
+  const uint8x16_t vb0x0123 = vld1q_u8(w);
+  const uint8x16_t vb0x4567 = vld1q_u8(w + 16);
+  w += 32;
+  for (size_t m = 0; m < 8; m++) {
+    acc->vacc[m][0] = vdotq_lane_u32(acc->vacc[m][0], vb0x0123, va[m], 0);
+    acc->vacc[m][1] = vdotq_lane_u32(acc->vacc[m][1], vb0x4567, va[m], 0);
+  }
+  acc->vb_sum[0] = vdotq_u32(acc->vb_sum[0], vb0x0123, vones);
+  acc->vb_sum[1] = vdotq_u32(acc->vb_sum[1], vb0x4567, vones);
+  acc->k += 4;
+  if (k > 4) {
+    const uint8x16_t vb1x0123 = vld1q_u8(w);
+    const uint8x16_t vb1x4567 = vld1q_u8(w + 16);
+    w += 32;
+    for (size_t m = 0; m < 8; m++) {
+      acc->vacc[m][0] = vdotq_lane_u32(acc->vacc[m][0], vb1x0123, va[m], 1);
+      acc->vacc[m][1] = vdotq_lane_u32(acc->vacc[m][1], vb1x4567, va[m], 1);
+    }
+    acc->vb_sum[0] = vdotq_u32(acc->vb_sum[0], vb1x0123, vones);
+    acc->vb_sum[1] = vdotq_u32(acc->vb_sum[1], vb1x4567, vones);
+    acc->k += 4;
+  } else {
+    /* The second block of the rows only holds padding; keep the row sums
+     * consistent with the products accumulated above. */
+    for (size_t m = 0; m < 8; m++) {
+      va[m] = vreinterpret_u8_u32(
+          vset_lane_u32(0, vreinterpret_u32_u8(va[m]), 1));
+    }
+  }
+  for (size_t p = 0; p < 4; p++) {
+    acc->va_sum[p] = vdotq_u32(
+        acc->va_sum[p], vcombine_u8(va[2 * p], va[2 * p + 1]), vones);
+  }
+  return w;
+}
+
+/*
+ * Applies the zero point corrections and returns the accumulators of
+ * sum (a - za) * (b - zb) + bias in vout.
+ */
+static inline void pytorch_q8_neondot_finish(
+    const struct pytorch_q8_neondot_acc* acc,
+    uint8_t input_zero_point,
+    const uint8_t* kernel_zero_points,
+    int32x4_t vout[8][2]) {
+  const uint16x8_t vb_zero_point = vmovl_u8(vld1_u8(kernel_zero_points));
+  const int32x4_t vzb[2] = {
+      vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vb_zero_point))),
+      vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vb_zero_point))),
+  };
+  const int32_t za = (int32_t)input_zero_point;
+  int32x4_t vcorrection[2];
+  for (size_t h = 0; h < 2; h++) {
+    vcorrection[h] = vmlsq_n_s32(
+        vmulq_n_s32(vzb[h], (int32_t)acc->k * za),
+        vreinterpretq_s32_u32(acc->vb_sum[h]),
+        za);
+  }
+  int32_t a_sum[8];
+  vst1q_s32(
+      a_sum,
+      vreinterpretq_s32_u32(vpaddq_u32(acc->va_sum[0], acc->va_sum[1])));
+  vst1q_s32(
+      a_sum + 4,
+      vreinterpretq_s32_u32(vpaddq_u32(acc->va_sum[2], acc->va_sum[3])));
+  for (size_t m = 0; m < 8; m++) {
+    for (size_t h = 0; h < 2; h++) {
+      vout[m][h] = vmlsq_n_s32(
+          vaddq_s32(vreinterpretq_s32_u32(acc->vacc[m][h]), vcorrection[h]),
+          vzb[h],
+          a_sum[m]);
+    }
+  }
+}
+
+/*
+ * Requantizes an 8x8 tile of accumulators and stores the first mr rows and
+ * nr columns of it, as the 8x8 NEON microkernels do.
+ */
+static inline void pytorch_q8_neondot_requantize_store(
+    int32x4_t vacc[8][2],
+    size_t mr,
+    size_t nr,
+    uint8_t* c,
+    size_t c_stride,
+    size_t output_channel_index,
+    const union pytorch_qnnp_conv_quantization_params* quantization_params) {
+  const float32x4_t vscale[2] = {
+      vld1q_f32(
+          &quantization_params->neon
+               .requantization_scales[output_channel_index]),
+      vld1q_f32(
+          &quantization_params->neon
+               .requantization_scales[output_channel_index + 4]),
+  };
+  const int16x8_t voutput_zero_point =
+      vld1q_dup_s16(&quantization_params->neon.output_zero_point);
+  const uint8x8_t voutput_min =
+      vld1_dup_u8(&quantization_params->neon.output_min);
+  const uint8x8_t voutput_max =
+      vld1_dup_u8(&quantization_params->neon.output_max);
+
+  uint8x8_t vout[8];
+  for (size_t m = 0; m < 8; m++) {
+    const int32x4_t vacc0123 =
+        vcvtnq_s32_f32(vmulq_f32(vcvtq_f32_s32(vacc[m][0]), vscale[0]));
+    const int32x4_t vacc4567 =
+        vcvtnq_s32_f32(vmulq_f32(vcvtq_f32_s32(vacc[m][1]), vscale[1]));
+    const int16x8_t vacc01234567 = vqaddq_s16(
+        vqmovn_high_s32(vqmovn_s32(vacc0123), vacc4567), voutput_zero_point);
+    vout[m] = vmin_u8(
+        vmax_u8(vqmovun_s16(vacc01234567), voutput_min), voutput_max);
+  }
+
+  uint8_t* c_rows[8];
+  c_rows[0] = c;
+  for (size_t m = 1; m < 8; m++) {
+    c_rows[m] = m < mr ? (uint8_t*)((uintptr_t)c_rows[m - 1] + c_stride)
+                       : c_rows[m - 1];
+  }
+  if (nr == 8) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1_u8(c_rows[m], vout[m]);
+    }
+    return;
+  }
+  if (nr >= 4) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1_lane_u32(
+          __builtin_assume_aligned(c_rows[m], 1),
+          vreinterpret_u32_u8(vout[m]),
+          0);
+      c_rows[m] += 4;
+      vout[m] = vext_u8(vout[m], vout[m], 4);
+    }
+    nr -= 4;
+  }
+  if (nr >= 2) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1_lane_u16(
+          __builtin_assume_aligned(c_rows[m], 1),
+          vreinterpret_u16_u8(vout[m]),
+          0);
+      c_rows[m] += 2;
+      vout[m] = vext_u8(vout[m], vout[m], 2);
+    }
+    nr -= 2;
+  }
+  if (nr != 0) {
+    for (size_t m = 0; m < 8; m++) {
+      vst1_lane_u8(c_rows[m], vout[m], 0);
+    }
+  }
+}
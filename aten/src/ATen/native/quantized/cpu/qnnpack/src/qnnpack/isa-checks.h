@@ -24,6 +24,13 @@
     }                                                       \
   } while (0)
 
+#define TEST_REQUIRES_ARM_NEON_DOT                              \
+  do {                                                          \
+    if (!cpuinfo_initialize() || !cpuinfo_has_arm_neon_dot()) { \
+      return;                                                   \
+    }                                                           \
+  } while (0)
+
 #define TEST_REQUIRES_ARM_NEON_FP16_ARITH                              \
   do {                                                                 \
     if (!cpuinfo_initialize() || !cpuinfo_has_arm_neon_fp16_arith()) { \
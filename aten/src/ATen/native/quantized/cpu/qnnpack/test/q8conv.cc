@@ -434,6 +434,182 @@ TEST(Q8CONV_8x8__AARCH64_NEON, k_div_8_subtile) {
 }
 #endif
 
+#if CPUINFO_ARCH_ARM64 && \
+    (defined(PYTORCH_QNNPACK_NEONDOT_UKERNELS) || defined(__ARM_FEATURE_DOTPROD))
+TEST(Q8CONV_8x8c4__NEONDOT, k_eq_8) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  GemmMicrokernelTester()
+      .mr(8)
+      .nr(8)
+      .np(8)
+      .kr(4)
+      .m(8)
+      .n(8)
+      .k(8)
+      .aStride(37)
+      .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_eq_8_strided_c) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  GemmMicrokernelTester()
+      .mr(8)
+      .nr(8)
+      .np(8)
+      .kr(4)
+      .m(8)
+      .n(8)
+      .k(8)
+      .aStride(37)
+      .cStride(17)
+      .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_eq_8_qmin128) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  GemmMicrokernelTester()
+      .mr(8)
+      .nr(8)
+      .np(8)
+      .kr(4)
+      .m(8)
+      .n(8)
+      .k(8)
+      .qmin(128)
+      .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_eq_8_qmax128) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  GemmMicrokernelTester()
+      .mr(8)
+      .nr(8)
+      .np(8)
+      .kr(4)
+      .m(8)
+      .n(8)
+      .k(8)
+      .qmax(128)
+      .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_eq_8_azp0) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  GemmMicrokernelTester()
+      .mr(8)
+      .nr(8)
+      .np(8)
+      .kr(4)
+      .m(8)
+      .n(8)
+      .k(8)
+      .aStride(37)
+      .aZeroPoint(0)
+      .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_eq_8_bzp0) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  GemmMicrokernelTester()
+      .mr(8)
+      .nr(8)
+      .np(8)
+      .kr(4)
+      .m(8)
+      .n(8)
+      .k(8)
+      .aStride(37)
+      .bZeroPoint(0)
+      .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_lt_8) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  for (size_t k = 4; k < 8; k++) {
+    GemmMicrokernelTester()
+        .mr(8)
+        .nr(8)
+        .np(8)
+        .kr(4)
+        .m(8)
+        .n(8)
+        .k(k)
+        .aStride(37)
+        .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+  }
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_gt_8) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  for (size_t k = 9; k < 16; k++) {
+    GemmMicrokernelTester()
+        .mr(8)
+        .nr(8)
+        .np(8)
+        .kr(4)
+        .m(8)
+        .n(8)
+        .k(k)
+        .aStride(37)
+        .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+  }
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_gt_8_azp0) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  for (size_t k = 9; k < 16; k++) {
+    GemmMicrokernelTester()
+        .mr(8)
+        .nr(8)
+        .np(8)
+        .kr(4)
+        .m(8)
+        .n(8)
+        .k(k)
+        .aStride(37)
+        .aZeroPoint(0)
+        .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+  }
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_gt_8_subtile) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  for (size_t k = 9; k < 16; k++) {
+    for (uint32_t m = 1; m <= 8; m++) {
+      for (uint32_t n = 1; n <= 8; n++) {
+        GemmMicrokernelTester()
+            .mr(8)
+            .nr(8)
+            .np(8)
+            .kr(4)
+            .m(m)
+            .n(n)
+            .k(k)
+            .aStride(37)
+            .iterations(3)
+            .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+      }
+    }
+  }
+}
+
+TEST(Q8CONV_8x8c4__NEONDOT, k_div_8) {
+  TEST_REQUIRES_ARM_NEON_DOT;
+  for (size_t k = 16; k < 128; k += 8) {
+    GemmMicrokernelTester()
+        .mr(8)
+        .nr(8)
+        .np(8)
+        .kr(4)
+        .m(8)
+        .n(8)
+        .k(k)
+        .aStride(37)
+        .test(pytorch_q8conv_ukernel_8x8c4__neondot);
+  }
+}
+#endif
+
 #if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
 TEST(Q8CONV_4x8__NEON, k_eq_8) {
   TEST_REQUIRES_ARM_NEON;
@@ -140,6 +140,12 @@ using qtopk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool
 
 using qbatch_norm_fn = void(*)(int64_t, int64_t, int64_t, int64_t, int64_t, const Tensor&, const Tensor&, const Tensor&, Tensor&);
 
+using qlinear_weight_only_fn = void (*)(
+    const Tensor& /* input */,
+    const Tensor& /* packed_weight */,
+    const Tensor& /* bias */,
+    Tensor& /* output */);
+
 using qnormalize_fn = void (*)(
     const Tensor& /* X */,
     const Tensor& /* gamma */,
@@ -170,6 +176,8 @@ DECLARE_DISPATCH(qclamp_fn, qclamp_stub);
 DECLARE_DISPATCH(qelu_fn, qelu_stub);
 DECLARE_DISPATCH(qhardsigmoid_fn, qhardsigmoid_stub);
 DECLARE_DISPATCH(qhardswish_fn, qhardswish_stub);
+DECLARE_DISPATCH(qlinear_weight_only_fn, qlinear_weight_only_4bit_stub);
+DECLARE_DISPATCH(qlinear_weight_only_fn, qlinear_weight_only_byte_stub);
 DECLARE_DISPATCH(qmaxpool_2d_fn, qmaxpool_2d_nhwc_stub);
 DECLARE_DISPATCH(qnormalize_fn, quantized_normalize_stub);
 DECLARE_DISPATCH(qrelu_fn, qrelu6_stub);
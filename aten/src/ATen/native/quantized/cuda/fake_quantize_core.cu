@@ -47,6 +47,34 @@ void fake_quantize_tensor_kernel_cuda(
     });
 }
 
+void fake_quantize_tensor_cachemask_kernel_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  // scalar type of this function is guaranteed to be float
+  float inv_scale = 1.0f / scale;
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(output)
+    .add_output(mask)
+    .add_input(input)
+    .build();
+  gpu_kernel_multiple_outputs(
+    iter, [=] GPU_LAMBDA (float input_val) -> thrust::tuple<float, bool> {
+      const auto qval = static_cast<int64_t>(std::nearbyint(input_val * inv_scale + zero_point));
+      return {
+        // fake_quantized value
+        (fminf(quant_max, fmaxf(quant_min, qval)) - zero_point) * scale,
+        // mask for grad
+        ((quant_min <= qval) && (qval <= quant_max))
+      };
+    });
+}
+
 void fake_quantize_grad_tensor_kernel_cuda(
     Tensor& input_grad,
     const Tensor& input,
@@ -98,6 +126,7 @@ void _fake_quantize_grad_learnable_tensor_kernel_cuda(
 }
 
 REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_tensor_cachemask_stub, &fake_quantize_tensor_cachemask_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quantize_grad_tensor_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_learnable_tensor_stub, &_fake_quantize_grad_learnable_tensor_kernel_cuda);
 
@@ -118,6 +147,20 @@ void fake_quant_per_channel_cuda(TensorIterator &iter, int64_t quant_min, int64_
     });
 }
 
+void fake_quant_per_channel_cachemask_cuda(TensorIterator &iter, int64_t quant_min, int64_t quant_max) {
+  gpu_kernel_multiple_outputs(iter,
+    [=] GPU_LAMBDA (float input_val, float scale, int64_t zero_point) -> thrust::tuple<float, bool> {
+      float inv_scale = 1.0f / scale;
+      const auto qval = static_cast<int64_t>(std::nearbyint(input_val * inv_scale + zero_point));
+      return {
+        // fake_quantized value
+        (fminf(quant_max, fmaxf(quant_min, qval)) - zero_point) * scale,
+        // mask for grad
+        ((quant_min <= qval) && (qval <= quant_max))
+      };
+    });
+}
+
 void fake_quant_grad_per_channel_cuda(TensorIterator &iter, int64_t quant_min, int64_t quant_max) {
   gpu_kernel(iter,
     [=] GPU_LAMBDA (float x, float dy, float scale, int64_t zero_point) -> float {
@@ -127,60 +170,25 @@ void fake_quant_grad_per_channel_cuda(TensorIterator &iter, int64_t quant_min, i
     });
 }
 
-void _fake_quantize_grad_learnable_scale_channel_kernel_cuda(
-    Tensor& input_grad,
-    const Tensor& input,
-    const Tensor& output_grad,
-    float scale,
-    int64_t zero_point,
-    int64_t quant_min,
-    int64_t quant_max) {
-  // scalar type of this function is guaranteed to be float
-  float inv_scale = 1.0f / scale;
-  float grad_small = quant_min - zero_point;
-  float grad_big = quant_max - zero_point;
-
-  auto iter = TensorIterator::binary_op(input_grad, input, output_grad);
-  gpu_kernel(iter,
-    [=] GPU_LAMBDA (float x, float dy) -> float {
-      int64_t xq = static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
-      xq = std::max(std::min(xq, quant_max), quant_min);
-      float x_fq = static_cast<float>((xq - zero_point) * scale);
-      if (xq == quant_min) {
-        return dy * grad_small;
-      } else if (xq == quant_max) {
-        return dy * grad_big;
-      }
-      return dy * (x_fq - x) * inv_scale;
-    });
-}
-
-void _fake_quantize_grad_learnable_zero_point_channel_kernel_cuda(
-    Tensor& input_grad,
-    const Tensor& input,
-    const Tensor& output_grad,
-    float scale,
-    int64_t zero_point,
-    int64_t quant_min,
-    int64_t quant_max) {
-  // scalar type of this function is guaranteed to be float
-  float inv_scale = 1.0f / scale;
-  auto iter = TensorIterator::binary_op(input_grad, input, output_grad);
-  gpu_kernel(iter,
-    [=] GPU_LAMBDA (float x, float dy) -> float {
+void _fake_quantize_grad_learnable_channel_kernel_cuda(TensorIterator &iter, int64_t quant_min, int64_t quant_max) {
+  gpu_kernel_multiple_outputs(iter,
+    [=] GPU_LAMBDA (float x, float dy, float scale, int64_t zero_point) -> thrust::tuple<float, float, float> {
+      float inv_scale = 1.0f / scale;
       int64_t xq = static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
-      xq = std::max(std::min(xq, quant_max), quant_min);
+      float dx = dy * (xq >= quant_min && xq <= quant_max);
+      xq = ::max(::min(xq, quant_max), quant_min);
       if (xq == quant_min || xq == quant_max) {
-        return dy * (-1) * scale;
+        return {dx, dy * static_cast<float>(xq - zero_point), dy * (-1) * scale};
       }
-      return 0;
+      float x_fq = static_cast<float>((xq - zero_point) * scale);
+      return {dx, dy * (x_fq - x) * inv_scale, 0};
     });
 }
 
 REGISTER_DISPATCH(fake_quant_per_channel_stub, &fake_quant_per_channel_cuda);
+REGISTER_DISPATCH(fake_quant_per_channel_cachemask_stub, &fake_quant_per_channel_cachemask_cuda);
 REGISTER_DISPATCH(fake_quant_grad_per_channel_stub, &fake_quant_grad_per_channel_cuda);
-REGISTER_DISPATCH(fake_quant_grad_learnable_scale_channel_stub, &_fake_quantize_grad_learnable_scale_channel_kernel_cuda);
-REGISTER_DISPATCH(fake_quant_grad_learnable_zero_point_channel_stub, &_fake_quantize_grad_learnable_zero_point_channel_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_grad_learnable_channel_stub, &_fake_quantize_grad_learnable_channel_kernel_cuda);
 
 } // namespace native
 } // namespace at
@@ -11,9 +11,9 @@ namespace native {
 
 // Use REGISTER_DISPATCH to run CPU and CUDA backend.
 DEFINE_DISPATCH(fake_quant_per_channel_stub);
+DEFINE_DISPATCH(fake_quant_per_channel_cachemask_stub);
 DEFINE_DISPATCH(fake_quant_grad_per_channel_stub);
-DEFINE_DISPATCH(fake_quant_grad_learnable_scale_channel_stub);
-DEFINE_DISPATCH(fake_quant_grad_learnable_zero_point_channel_stub);
+DEFINE_DISPATCH(fake_quant_grad_learnable_channel_stub);
 
 /* Per channel fake-quantizes the 'inputs' tensor.
 Args:
@@ -82,6 +82,67 @@ Tensor fake_quantize_per_channel_affine(
   return Y;
 }
 
+/* Per channel fake-quantizes the 'inputs' tensor, saving a mask for the
+backward pass. See `fake_quantize_per_tensor_affine_cachemask`.
+
+Returns:
+  Fake quantized tensor (float dtype), and a boolean mask that is true
+  where the input was not clamped.
+*/
+std::tuple<Tensor, Tensor> fake_quantize_per_channel_affine_cachemask(
+    const Tensor& self,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max) {
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+  TORCH_CHECK(scale.scalar_type() == ScalarType::Float,
+              "Scale must be Float, found ", scale.scalar_type());
+  TORCH_CHECK(zero_point.scalar_type() == ScalarType::Long,
+              "Zero-point must be Long, found ", zero_point.scalar_type());
+  TORCH_CHECK(scale.dim() == 1, "scale should be a 1-D tensor");
+  TORCH_CHECK(zero_point.dim() == 1, "zero point should be a 1-D tensor");
+  TORCH_CHECK(
+      scale.numel() == zero_point.numel(),
+      "scale and zero-point need to have the same dimensions");
+  TORCH_CHECK(
+      axis >= 0 && axis < self.dim(),
+      "`axis` must be between 0 and number of dimensions of input");
+  TORCH_CHECK(
+      scale.numel() == self.size(axis),
+      "dimensions of scale and zero-point are not consistent with input tensor")
+
+  TORCH_CHECK(
+      quant_min <= quant_max,
+      "`quant_min` should be less than or \
+        equal to `quant_max`.");
+
+  TORCH_CHECK(
+      at::min(zero_point).item().toLong() >= quant_min &&
+          at::max(zero_point).item().toLong() <= quant_max,
+      "`zero_point` must be between `quant_min` and `quant_max`.");
+
+  auto Y = at::empty_like(self, self.options(), MemoryFormat::Preserve);
+  auto mask = at::empty_like(self, at::kBool, MemoryFormat::Preserve);
+
+  std::vector<int64_t> expected_shape(self.dim(), 1);
+  expected_shape[axis] = self.size(axis);
+
+  TensorIterator iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(Y)
+    .add_output(mask)
+    .add_input(self)
+    .add_input(native::_unsafe_view(scale, expected_shape))
+    .add_input(native::_unsafe_view(zero_point, expected_shape))
+    .build();
+
+  fake_quant_per_channel_cachemask_stub(iter.device_type(), iter, quant_min, quant_max);
+
+  return std::make_tuple(Y, mask);
+}
+
 /* Backward path for per-channel fake-quantization of the 'inputs' tensor.
 
 Args:
@@ -163,72 +224,6 @@ Tensor fake_quantize_per_channel_affine_backward(
   return dX;
 }
 
-TensorIterator _build_iterator(
-    const Tensor& dX,
-    const Tensor& X,
-    const Tensor& dY,
-    const Tensor& scale,
-    const Tensor& zero_point,
-    std::vector<int64_t> expected_shape) {
-  TensorIterator iter = TensorIteratorConfig()
-    .check_all_same_dtype(false)
-    .add_output(dX)
-    .add_input(X)
-    .add_input(dY)
-    .add_input(native::_unsafe_view(scale, expected_shape))
-    .add_input(native::_unsafe_view(zero_point, expected_shape))
-    .build();
-  return iter;
-}
-
-Tensor _get_rounded_zero_point(
-    const Tensor& zero_point,
-    int64_t quant_min,
-    int64_t quant_max) {
-  // This assumes the per channel zero point vector is single-dimensioned.
-  for (int i = 0; i < zero_point.sizes()[0]; ++i) {
-    zero_point[i] = static_cast<int64_t>(zero_point[i].item<float>() + 0.5);
-  }
-  return zero_point.clamp(quant_min, quant_max).to(at::kLong);
-}
-
-std::tuple<Tensor, Tensor> _get_scale_zero_point_per_channel_iter_grads(
-    const Tensor& dY,
-    const Tensor& X,
-    const Tensor& scale,
-    const Tensor& zero_point,
-    int64_t axis,
-    int64_t quant_min,
-    int64_t quant_max) {
-
-  int64_t axis_size = X.size(axis);
-  std::vector<Tensor> X_flattened = at::unbind(X, axis);
-  std::vector<Tensor> dY_flattened = at::unbind(dY, axis);
-
-  Tensor dScale = at::zeros({scale.sizes()[0]});
-  Tensor dZeroPoint = at::zeros({zero_point.sizes()[0]});
-
-  for (int i = 0; i < X_flattened.size(); ++i) {
-    Tensor X_i = X_flattened[i];
-    Tensor dY_i = dY_flattened[i];
-    auto dScale_item_vec = at::empty_like(X_i, X_i.options(), MemoryFormat::Preserve);
-    auto dZeroPoint_item_vec = at::empty_like(X_i, X_i.options(), MemoryFormat::Preserve);
-
-    float scale_i = scale[i].item<float>();
-    int64_t zero_point_i = static_cast<int64_t>(std::min(std::max(zero_point[i].item<float>() + 0.5f, quant_min), quant_max));
-    fake_quant_grad_learnable_scale_channel_stub(
-      scale.device().type(), dScale_item_vec, X_i, dY_i, scale_i, zero_point_i, quant_min, quant_max);
-    fake_quant_grad_learnable_zero_point_channel_stub(
-      zero_point.device().type(), dZeroPoint_item_vec, X_i, dY_i, scale_i, zero_point_i, quant_min, quant_max);
-    float scale_item = dScale_item_vec.sum().unsqueeze(0).item<float>();
-    float zero_point_item = dZeroPoint_item_vec.sum().unsqueeze(0).item<float>();
-
-    dScale[i] = scale_item;
-    dZeroPoint[i] = zero_point_item;
-  }
-  return std::make_tuple(dScale, dZeroPoint);
-}
-
 Tensor _fake_quantize_learnable_per_channel_affine(
     const Tensor& self,
     const Tensor& scale,
@@ -298,22 +293,41 @@ std::tuple<Tensor, Tensor, Tensor> _fake_quantize_learnable_per_channel_affine_b
     return std::make_tuple(X, scale, zero_point);
   }
 
-  auto zero_point_rounded = _get_rounded_zero_point(zero_point, quant_min, quant_max);
+  // Same rounding as the per tensor variant, without modifying `zero_point`.
+  auto zero_point_rounded =
+      (zero_point + 0.5f).to(at::kLong).clamp(quant_min, quant_max);
   auto dX = at::empty_like(X, X.options(), MemoryFormat::Preserve);
+  auto dScale_vec = at::empty_like(X, X.options(), MemoryFormat::Preserve);
+  auto dZeroPoint_vec = at::empty_like(X, X.options(), MemoryFormat::Preserve);
 
-  std::vector<int64_t> expected_shape_X(X.dim(), 1);
-  expected_shape_X[axis] = X.size(axis);
-
-  TensorIterator iter_X = native::_build_iterator(
-    dX, X, dY, scale, zero_point_rounded, expected_shape_X);
+  std::vector<int64_t> expected_shape(X.dim(), 1);
+  expected_shape[axis] = X.size(axis);
 
-  fake_quant_grad_per_channel_stub(iter_X.device_type(), iter_X, quant_min, quant_max);
+  // All three gradients are computed in a single pass over X and dY.
+  TensorIterator iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .add_output(dX)
+    .add_output(dScale_vec)
+    .add_output(dZeroPoint_vec)
+    .add_input(X)
+    .add_input(dY)
+    .add_input(native::_unsafe_view(scale, expected_shape))
+    .add_input(native::_unsafe_view(zero_point_rounded, expected_shape))
+    .build();
 
-  std::tuple<Tensor, Tensor> dScaleZeroPoints = native::_get_scale_zero_point_per_channel_iter_grads(
-    dY, X, scale, zero_point, axis, quant_min, quant_max);
+  fake_quant_grad_learnable_channel_stub(iter.device_type(), iter, quant_min, quant_max);
 
-  Tensor dScale = std::get<0>(dScaleZeroPoints).to(scale.device());
-  Tensor dZeroPoint = std::get<1>(dScaleZeroPoints).to(zero_point.device());
+  // The scale and zero point gradients are the sums over every dimension but
+  // `axis`.
+  std::vector<int64_t> reduce_dims;
+  for (int64_t d = 0; d < X.dim(); ++d) {
+    if (d != axis) {
+      reduce_dims.push_back(d);
+    }
+  }
+  Tensor dScale = reduce_dims.empty() ? dScale_vec : dScale_vec.sum(reduce_dims);
+  Tensor dZeroPoint =
+      reduce_dims.empty() ? dZeroPoint_vec : dZeroPoint_vec.sum(reduce_dims);
 
   return std::make_tuple(dX, dScale, dZeroPoint);
 }
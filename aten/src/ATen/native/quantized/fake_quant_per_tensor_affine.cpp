@@ -11,6 +11,7 @@ namespace native {
 
 // Use REGISTER_DISPATCH to run CPU and CUDA backend.
 DEFINE_DISPATCH(fake_quant_tensor_stub);
+DEFINE_DISPATCH(fake_quant_tensor_cachemask_stub);
 DEFINE_DISPATCH(fake_quant_grad_tensor_stub);
 DEFINE_DISPATCH(fake_quant_grad_learnable_tensor_stub);
 
@@ -95,6 +96,67 @@ Tensor fake_quantize_per_tensor_affine_backward(
   return dX;
 }
 
+/* Fake-quantizes the 'inputs' tensor, saving a mask for the backward pass.
+
+This is numerically equivalent to `fake_quantize_per_tensor_affine`,
+but the output and the straight-through mask are computed in a single
+pass, and the backward pass only needs the mask instead of recomputing
+the quantization of the input.
+
+Args:
+  self: Forward input tensor.
+  scale: scale of per tensor affine quantization
+  zero_point: zero_point of per tensor affine quantization
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+
+Returns:
+  Fake quantized tensor (float dtype), and a boolean mask that is true
+  where the input was not clamped.
+*/
+std::tuple<Tensor, Tensor> fake_quantize_per_tensor_affine_cachemask(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+  TORCH_CHECK(
+      quant_min <= quant_max,
+      "`quant_min` should be less than or \
+        equal to `quant_max`.");
+  TORCH_CHECK(
+      zero_point >= quant_min && zero_point <= quant_max,
+      "`zero_point` must be between `quant_min` and `quant_max`.");
+
+  auto Y = at::empty_like(self, self.options(), MemoryFormat::Preserve);
+  auto mask = at::empty_like(self, at::kBool, MemoryFormat::Preserve);
+  fake_quant_tensor_cachemask_stub(
+      self.device().type(), Y, mask, self, scale, zero_point, quant_min, quant_max);
+  return std::make_tuple(Y, mask);
+}
+
+/* Backward path of the cachemask fake-quantize ops, shared by the per
+tensor and per channel variants.
+
+Args:
+  dY: output grad.
+  mask: mask tensor from the forward pass.
+
+Returns:
+  dX (input grad).
+*/
+Tensor fake_quantize_per_tensor_affine_cachemask_backward(
+    const Tensor& dY,
+    const Tensor& mask) {
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Bool);
+  TORCH_CHECK(mask.sizes() == dY.sizes(), "`mask` and `dY` are not the same size");
+  if (dY.numel() <= 0) {
+    return dY;
+  }
+  return dY * mask;
+}
+
 int64_t _get_zero_point_from_tensor(
     const Tensor& zero_point,
     int64_t quant_min,
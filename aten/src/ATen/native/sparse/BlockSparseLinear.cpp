@@ -0,0 +1,261 @@
+#include <ATen/native/sparse/BlockSparseLinear.h>
+
+#include <ATen/quantized/Quantizer.h>
+#include <torch/custom_class.h>
+#include <torch/library.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(block_sparse_linear_stub);
+DEFINE_DISPATCH(qblock_sparse_linear_stub);
+
+namespace block_sparse {
+
+PackedBlockSparseWeight pack_block_sparse_weight(
+    const Tensor& weight,
+    int64_t row_block_size,
+    int64_t col_block_size) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "block_sparse::linear_prepack: Expected a 2-D weight, got ",
+      weight.dim(),
+      " dimensions");
+  TORCH_CHECK(
+      row_block_size > 0 && col_block_size > 0,
+      "block_sparse::linear_prepack: Block sizes must be positive, got ",
+      row_block_size,
+      "x",
+      col_block_size);
+  const int64_t N = weight.size(0);
+  const int64_t K = weight.size(1);
+  const int64_t block_rows = (N + row_block_size - 1) / row_block_size;
+  const int64_t block_cols = (K + col_block_size - 1) / col_block_size;
+
+  PackedBlockSparseWeight packed;
+  packed.out_features = N;
+  packed.in_features = K;
+  packed.row_block_size = row_block_size;
+  packed.col_block_size = col_block_size;
+
+  Tensor dense;
+  if (weight.is_quantized()) {
+    TORCH_CHECK(
+        weight.scalar_type() == kQInt8,
+        "block_sparse::linear_prepack: Expected a qint8 quantized weight, got ",
+        weight.scalar_type());
+    if (weight.qscheme() == kPerTensorAffine) {
+      TORCH_CHECK(
+          weight.q_zero_point() == 0,
+          "block_sparse::linear_prepack: Expected symmetric quantized weights "
+          "with a zero point of 0, got ",
+          weight.q_zero_point());
+      packed.scales = at::full({N}, weight.q_scale(), at::kFloat);
+    } else {
+      TORCH_CHECK(
+          weight.qscheme() == kPerChannelAffine && weight.q_per_channel_axis() == 0,
+          "block_sparse::linear_prepack: Expected per-tensor or per output "
+          "channel quantized weights");
+      TORCH_CHECK(
+          weight.q_per_channel_zero_points().eq(0).all().item<bool>(),
+          "block_sparse::linear_prepack: Expected symmetric quantized weights "
+          "with zero points of 0");
+      packed.scales = weight.q_per_channel_scales().to(kFloat).contiguous();
+    }
+    dense = weight.int_repr();
+  } else {
+    TORCH_CHECK(
+        weight.scalar_type() == kFloat,
+        "block_sparse::linear_prepack: Expected a float or qint8 weight, got ",
+        weight.scalar_type());
+    dense = weight;
+  }
+
+  Tensor padded = at::zeros(
+      {block_rows * row_block_size, block_cols * col_block_size}, dense.options());
+  padded.narrow(0, 0, N).narrow(1, 0, K).copy_(dense);
+  // [block_rows, block_cols, row_block_size, col_block_size]
+  const Tensor blocks =
+      padded.view({block_rows, row_block_size, block_cols, col_block_size})
+          .permute({0, 2, 1, 3})
+          .contiguous();
+  const Tensor nonzero_blocks = blocks.ne(0).flatten(2).any(2);
+  const Tensor stored = nonzero_blocks.flatten().nonzero().squeeze(1);
+
+  Tensor row_offsets = at::zeros({block_rows + 1}, at::kInt);
+  row_offsets.narrow(0, 1, block_rows)
+      .copy_(nonzero_blocks.sum(1).cumsum(0));
+  packed.row_offsets = row_offsets;
+  packed.col_indices = stored.remainder(block_cols).to(at::kInt).contiguous();
+  packed.values =
+      blocks.view({block_rows * block_cols, row_block_size * col_block_size})
+          .index_select(0, stored);
+  return packed;
+}
+
+BlockSparseLinearOpContext::BlockSparseLinearOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias,
+    int64_t row_block_size,
+    int64_t col_block_size)
+    : orig_weight_(std::move(weight)),
+      orig_bias_(std::move(bias)),
+      row_block_size_(row_block_size),
+      col_block_size_(col_block_size),
+      packed_(pack_block_sparse_weight(
+          orig_weight_,
+          row_block_size_,
+          col_block_size_)) {
+  const int64_t N = packed_.out_features;
+  if (orig_bias_ && orig_bias_->defined()) {
+    TORCH_CHECK(
+        orig_bias_->dim() == 1 && orig_bias_->size(0) == N,
+        "block_sparse::linear_prepack: Expected a bias of ",
+        N,
+        " elements, got sizes ",
+        orig_bias_->sizes());
+    bias_ = orig_bias_->to(kFloat).contiguous();
+  } else {
+    bias_ = at::zeros({N}, at::kFloat);
+  }
+}
+
+double BlockSparseLinearOpContext::density() const {
+  const int64_t block_rows = packed_.row_offsets.numel() - 1;
+  const int64_t block_cols =
+      (packed_.in_features + col_block_size_ - 1) / col_block_size_;
+  if (block_rows == 0 || block_cols == 0) {
+    return 0;
+  }
+  return static_cast<double>(packed_.col_indices.numel()) /
+      (block_rows * block_cols);
+}
+
+Tensor BlockSparseLinearOpContext::run(const Tensor& input) {
+  TORCH_CHECK(
+      !orig_weight_.is_quantized(),
+      "block_sparse::linear_run: The packed weight is quantized, use "
+      "block_sparse::qlinear_run instead");
+  TORCH_CHECK(
+      input.scalar_type() == kFloat,
+      "block_sparse::linear_run: Expected a float input, got ",
+      input.scalar_type());
+  const int64_t K = packed_.in_features;
+  TORCH_CHECK(
+      input.dim() >= 1 && input.size(-1) == K,
+      "block_sparse::linear_run: Expected an input of ",
+      K,
+      " features, got sizes ",
+      input.sizes());
+
+  const Tensor input_2d = input.reshape({-1, K}).contiguous();
+  std::vector<int64_t> output_sizes(input.sizes().begin(), input.sizes().end() - 1);
+  output_sizes.push_back(packed_.out_features);
+  Tensor output = at::empty(output_sizes, input_2d.options());
+  block_sparse_linear_stub(kCPU, input_2d, packed_, bias_, output);
+  return output;
+}
+
+Tensor BlockSparseLinearOpContext::run_quantized(
+    const Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      orig_weight_.is_quantized(),
+      "block_sparse::qlinear_run: The packed weight is not quantized, use "
+      "block_sparse::linear_run instead");
+  TORCH_CHECK(
+      input.scalar_type() == kQUInt8 && input.qscheme() == kPerTensorAffine,
+      "block_sparse::qlinear_run: Expected a per-tensor quantized quint8 "
+      "input, got ",
+      input.scalar_type());
+  const int64_t K = packed_.in_features;
+  TORCH_CHECK(
+      input.dim() >= 1 && input.size(-1) == K,
+      "block_sparse::qlinear_run: Expected an input of ",
+      K,
+      " features, got sizes ",
+      input.sizes());
+
+  const Tensor input_2d = input.reshape({-1, K}).contiguous();
+  std::vector<int64_t> output_sizes(input.sizes().begin(), input.sizes().end() - 1);
+  output_sizes.push_back(packed_.out_features);
+  Tensor output = at::_empty_affine_quantized(
+      output_sizes,
+      at::device(kCPU).dtype(kQUInt8),
+      output_scale,
+      output_zero_point);
+  qblock_sparse_linear_stub(kCPU, input_2d, packed_, bias_, output);
+  return output;
+}
+
+c10::intrusive_ptr<BlockSparseLinearOpContext> createBlockSparseLinearPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias,
+    int64_t out_features_block_size,
+    int64_t in_features_block_size) {
+  return c10::make_intrusive<BlockSparseLinearOpContext>(
+      std::move(weight),
+      std::move(bias),
+      out_features_block_size,
+      in_features_block_size);
+}
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<BlockSparseLinearOpContext>& op_context) {
+  return op_context->run(input);
+}
+
+Tensor qlinear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<BlockSparseLinearOpContext>& op_context,
+    double output_scale,
+    int64_t output_zero_point) {
+  return op_context->run_quantized(input, output_scale, output_zero_point);
+}
+
+double linear_density(
+    const c10::intrusive_ptr<BlockSparseLinearOpContext>& op_context) {
+  return op_context->density();
+}
+
+TORCH_LIBRARY(block_sparse, m) {
+  m.class_<BlockSparseLinearOpContext>("LinearOpContext")
+    .def_pickle(
+        [](const c10::intrusive_ptr<BlockSparseLinearOpContext>& op_context)
+            -> SerializationTypeBlockSparseLinearPrePack { // __getstate__
+          return op_context->unpack();
+        },
+        [](SerializationTypeBlockSparseLinearPrePack state)
+            -> c10::intrusive_ptr<BlockSparseLinearOpContext> { // __setstate__
+          return createBlockSparseLinearPrePackOpContext(
+              std::move(std::get<0>(state)),
+              std::move(std::get<1>(state)),
+              std::get<2>(state),
+              std::get<3>(state));
+        });
+
+  m.def("linear_prepack(Tensor W, Tensor? B=None, int out_features_block_size=1, int in_features_block_size=4) -> __torch__.torch.classes.block_sparse.LinearOpContext");
+  m.def("linear_run(Tensor X, __torch__.torch.classes.block_sparse.LinearOpContext W_prepack) -> Tensor Y");
+  m.def("qlinear_run(Tensor X, __torch__.torch.classes.block_sparse.LinearOpContext W_prepack, float Y_scale, int Y_zero_point) -> Tensor Y");
+  m.def(
+      "linear_density(__torch__.torch.classes.block_sparse.LinearOpContext W_prepack) -> float",
+      TORCH_FN(linear_density));
+}
+
+TORCH_LIBRARY_IMPL(block_sparse, CPU, m) {
+  m.impl("linear_prepack", TORCH_FN(createBlockSparseLinearPrePackOpContext));
+  m.impl("linear_run", TORCH_FN(linear_run));
+}
+
+TORCH_LIBRARY_IMPL(block_sparse, QuantizedCPU, m) {
+  m.impl("linear_prepack", TORCH_FN(createBlockSparseLinearPrePackOpContext));
+  m.impl("qlinear_run", TORCH_FN(qlinear_run));
+}
+
+} // namespace block_sparse
+} // namespace native
+} // namespace at
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+namespace block_sparse {
+
+// Weight of a linear layer in block compressed sparse row (BCSR) form. The
+// [N, K] weight is tiled into blocks of row_block_size x col_block_size
+// elements and only blocks holding a nonzero are stored:
+//
+//   row_offsets    row_offsets[i]..row_offsets[i + 1] index the blocks of
+//                  block row i (output features i * R to i * R + R - 1)
+//   col_indices    block column of every stored block (input features
+//                  j * C to j * C + C - 1)
+//   values         R x C row-major values of every stored block, float for
+//                  fp32 weights and int8 for quantized ones
+//
+// Blocks reaching past N or K are zero padded; the kernels read padded
+// input features as zeros and never write padded output features.
+struct PackedBlockSparseWeight {
+  int64_t out_features;
+  int64_t in_features;
+  int64_t row_block_size;
+  int64_t col_block_size;
+  Tensor row_offsets;
+  Tensor col_indices;
+  Tensor values;
+  // Quantized weights only: per output feature scales (per-tensor weights
+  // are broadcast) used to requantize the int32 accumulators.
+  Tensor scales;
+};
+
+PackedBlockSparseWeight pack_block_sparse_weight(
+    const Tensor& weight,
+    int64_t row_block_size,
+    int64_t col_block_size);
+
+using SerializationTypeBlockSparseLinearPrePack =
+    std::tuple<Tensor, c10::optional<Tensor>, int64_t, int64_t>;
+
+class BlockSparseLinearOpContext : public torch::jit::CustomClassHolder {
+ public:
+  BlockSparseLinearOpContext(
+      Tensor weight,
+      c10::optional<Tensor> bias,
+      int64_t row_block_size,
+      int64_t col_block_size);
+
+  SerializationTypeBlockSparseLinearPrePack unpack() {
+    return std::make_tuple(
+        orig_weight_, orig_bias_, row_block_size_, col_block_size_);
+  }
+
+  // Fraction of the weight blocks that are stored.
+  double density() const;
+
+  // fp32 weights: input [*, K] float, returns [*, N] float.
+  Tensor run(const Tensor& input);
+
+  // qint8 weights: input [*, K] quint8, returns [*, N] quint8 requantized to
+  // output_scale and output_zero_point.
+  Tensor run_quantized(
+      const Tensor& input,
+      double output_scale,
+      int64_t output_zero_point);
+
+ private:
+  Tensor orig_weight_;
+  c10::optional<Tensor> orig_bias_;
+  int64_t row_block_size_;
+  int64_t col_block_size_;
+  PackedBlockSparseWeight packed_;
+  // Float bias of N elements, zero when there is none.
+  Tensor bias_;
+};
+
+c10::intrusive_ptr<BlockSparseLinearOpContext> createBlockSparseLinearPrePackOpContext(
+    Tensor weight,
+    c10::optional<Tensor> bias,
+    int64_t out_features_block_size,
+    int64_t in_features_block_size);
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<BlockSparseLinearOpContext>& op_context);
+
+Tensor qlinear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<BlockSparseLinearOpContext>& op_context,
+    double output_scale,
+    int64_t output_zero_point);
+
+// output[m, n] = bias[n] + sum_k weight[n, k] * input[m, k] over the stored
+// blocks, for a contiguous [M, K] float input and a contiguous float output
+// of M * N elements.
+using block_sparse_linear_fn = void (*)(
+    const Tensor& /*input*/,
+    const PackedBlockSparseWeight& /*weight*/,
+    const Tensor& /*bias*/,
+    Tensor& /*output*/);
+
+// Same for a contiguous [M, K] quint8 input and quint8 output, with
+// the zero points and scales taken from the tensors and weight.scales.
+using qblock_sparse_linear_fn = void (*)(
+    const Tensor& /*input*/,
+    const PackedBlockSparseWeight& /*weight*/,
+    const Tensor& /*bias*/,
+    Tensor& /*output*/);
+
+} // namespace block_sparse
+
+DECLARE_DISPATCH(block_sparse::block_sparse_linear_fn, block_sparse_linear_stub);
+DECLARE_DISPATCH(block_sparse::qblock_sparse_linear_fn, qblock_sparse_linear_stub);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,109 @@
+// Products of block-sparse and dense matrices, for structured-sparse
+// attention
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at { namespace native {
+
+// NOTE [ Block-sparse matrices ]
+//
+// A block-sparse matrix with Bm x Bk blocks is given by block_indices, a
+// 2 x nblocks int64 tensor of the block row and block column of each of its
+// specified blocks, and values, a (*, nblocks, Bm, Bk) tensor of these blocks,
+// with optional batch dimensions in front, shared by all of them. The other
+// blocks are zero, and repeated blocks add up.
+//
+// Both products gather the blocks each of them needs from the dense operands
+// and multiply them all with one batched matmul, which takes cuBLAS's tensor
+// core kernels for half precision on CUDA, rather than launching a product
+// per block. They are made of differentiable ops, so that autograd goes
+// through them, and their backward only touches the same blocks.
+
+namespace {
+
+void check_block_indices(const Tensor& block_indices, const char* fn) {
+  TORCH_CHECK(block_indices.dim() == 2 && block_indices.size(0) == 2,
+      fn, ": expected block_indices to be a 2 x nblocks tensor, but got size ", block_indices.sizes());
+  TORCH_CHECK(block_indices.scalar_type() == kLong,
+      fn, ": expected block_indices to be an int64 tensor, but got ", block_indices.scalar_type());
+}
+
+// sizes with the last two dimensions replaced by the given ones
+std::vector<int64_t> with_matrix_sizes(IntArrayRef sizes, IntArrayRef matrix_sizes) {
+  std::vector<int64_t> result(sizes.begin(), sizes.end() - 2);
+  result.insert(result.end(), matrix_sizes.begin(), matrix_sizes.end());
+  return result;
+}
+
+} // namespace
+
+// The (*, rows, N) product of the block-sparse (*, rows, K) matrix given by
+// values and block_indices, and the dense (*, K, N) matrix dense.
+Tensor _block_sparse_dense_mm(const Tensor& values, const Tensor& block_indices, int64_t rows, const Tensor& dense) {
+  check_block_indices(block_indices, "block_sparse_mm");
+  TORCH_CHECK(values.dim() >= 3,
+      "block_sparse_mm: expected values to be a (*, nblocks, Bm, Bk) tensor, but got size ", values.sizes());
+  TORCH_CHECK(dense.dim() >= 2,
+      "block_sparse_mm: expected dense to be at least 2-dimensional, but got size ", dense.sizes());
+  const int64_t nblocks = values.size(-3);
+  const int64_t block_rows = values.size(-2);
+  const int64_t block_cols = values.size(-1);
+  const int64_t inner = dense.size(-2);
+  const int64_t cols = dense.size(-1);
+  TORCH_CHECK(block_indices.size(1) == nblocks,
+      "block_sparse_mm: expected ", nblocks, " block indices for the ", nblocks, " blocks, but got ", block_indices.size(1));
+  TORCH_CHECK(block_rows > 0 && block_cols > 0 && rows % block_rows == 0 && inner % block_cols == 0,
+      "block_sparse_mm: expected the ", rows, " x ", inner, " block-sparse matrix to be made of its ",
+      block_rows, " x ", block_cols, " blocks");
+
+  // (*, K / Bk, Bk, N), and the row of blocks of dense that each block multiplies
+  Tensor dense_blocks = dense.reshape(with_matrix_sizes(dense.sizes(), {inner / block_cols, block_cols, cols}))
+      .index_select(dense.dim() - 2, block_indices.select(0, 1));
+  // (*, nblocks, Bm, N)
+  Tensor products = at::matmul(values, dense_blocks);
+
+  const int64_t block_dim = products.dim() - 3;
+  std::vector<int64_t> result_sizes = products.sizes().vec();
+  result_sizes[block_dim] = rows / block_rows;
+  Tensor result = at::zeros(result_sizes, products.options())
+      .index_add_(block_dim, block_indices.select(0, 0), products);
+  result_sizes.resize(block_dim);
+  result_sizes.push_back(rows);
+  result_sizes.push_back(cols);
+  return result.view(result_sizes);
+}
+
+// The blocks of the (*, M, N) product of the dense (*, M, K) and (*, K, N)
+// matrices mat1 and mat2 given by block_indices and blocksize, as the
+// (*, nblocks, Bm, Bn) values of a block-sparse matrix. The others are not
+// computed.
+Tensor _block_sparse_masked_mm(const Tensor& mat1, const Tensor& mat2, const Tensor& block_indices, IntArrayRef blocksize) {
+  check_block_indices(block_indices, "block_sparse_masked_mm");
+  TORCH_CHECK(blocksize.size() == 2, "block_sparse_masked_mm: expected a blocksize of 2 elements, but got ", blocksize);
+  TORCH_CHECK(mat1.dim() >= 2 && mat2.dim() >= 2,
+      "block_sparse_masked_mm: expected mat1 and mat2 to be at least 2-dimensional, but got sizes ",
+      mat1.sizes(), " and ", mat2.sizes());
+  const int64_t rows = mat1.size(-2);
+  const int64_t inner = mat1.size(-1);
+  const int64_t cols = mat2.size(-1);
+  const int64_t block_rows = blocksize[0];
+  const int64_t block_cols = blocksize[1];
+  TORCH_CHECK(mat2.size(-2) == inner,
+      "block_sparse_masked_mm: mat1 and mat2 shapes cannot be multiplied (", rows, "x", inner, " and ",
+      mat2.size(-2), "x", cols, ")");
+  TORCH_CHECK(block_rows > 0 && block_cols > 0 && rows % block_rows == 0 && cols % block_cols == 0,
+      "block_sparse_masked_mm: expected the ", rows, " x ", cols, " product to be made of its ",
+      block_rows, " x ", block_cols, " blocks");
+
+  // (*, nblocks, Bm, K), the rows of mat1 that each block takes
+  Tensor mat1_blocks = mat1.reshape(with_matrix_sizes(mat1.sizes(), {rows / block_rows, block_rows, inner}))
+      .index_select(mat1.dim() - 2, block_indices.select(0, 0));
+  // (*, nblocks, K, Bn), the columns of mat2 that each block takes
+  Tensor mat2_blocks = mat2.reshape(with_matrix_sizes(mat2.sizes(), {inner, cols / block_cols, block_cols}))
+      .index_select(mat2.dim() - 1, block_indices.select(0, 1))
+      .transpose(-3, -2);
+  return at::matmul(mat1_blocks, mat2_blocks);
+}
+
+}} // namespace at::native
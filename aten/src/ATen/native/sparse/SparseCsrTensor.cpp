@@ -0,0 +1,219 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/InitialTensorOptions.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <c10/core/DeviceGuard.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+// NOTE [ Sparse CSR layout ]
+//
+// A sparse CSR tensor is a 2-dimensional rows x cols matrix stored as three
+// strided tensors: crow_indices, the rows + 1 offsets into col_indices and
+// values at which each row starts, and col_indices and values, the column and
+// value of each of the nnz specified elements, row after row. This is the
+// format MKL and cuSPARSE take, so that addmm, mm and mv give them the members
+// as they are, whereas a COO matrix has its row indices compressed on every
+// product.
+//
+// The conversions from COO and dense tensors produce int32 indices whenever
+// the matrix allows it (see csr_index_dtype), and sort the columns of every
+// row. sparse_csr_tensor also takes int64 indices, and does not require sorted
+// columns, which the products don't rely on.
+//
+// For now, a CSR tensor has scalar values (no dense dimensions), and autograd
+// doesn't go through its constructors.
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+Tensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+void _validate_sparse_csr_tensor_args(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size) {
+  // the shapes are also checked in SparseCsrTensorImpl::set_member_tensors_unsafe,
+  // but we need them to check the contents of the indices.
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-dimensional, but got size ", size);
+  TORCH_CHECK(!crow_indices.is_sparse() && !col_indices.is_sparse() && !values.is_sparse(),
+      "expected crow_indices, col_indices and values to be dense tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.numel() == size[0] + 1,
+      "crow_indices must be a 1-dimensional tensor of rows + 1 = ", size[0] + 1, " elements, but got size ", crow_indices.sizes());
+  TORCH_CHECK(col_indices.dim() == 1 && values.dim() == 1 && col_indices.numel() == values.numel(),
+      "col_indices and values must be 1-dimensional tensors of the same size, but got sizes ",
+      col_indices.sizes(), " and ", values.sizes());
+
+  // Gather everything we check about the indices, so that they are copied to
+  // the host at once.
+  const int64_t rows = size[0];
+  const int64_t nnz = col_indices.numel();
+  Tensor crow = crow_indices.to(kLong);
+  std::vector<Tensor> stats = {crow[0], crow[rows]};
+  if (rows > 0) {
+    stats.push_back((crow.narrow(0, 1, rows) - crow.narrow(0, 0, rows)).min());
+  }
+  if (nnz > 0) {
+    Tensor col = col_indices.to(kLong);
+    stats.push_back(col.min());
+    stats.push_back(col.max());
+  }
+  Tensor cpu_stats = at::stack(stats).to(kCPU);
+  auto cpu_stats_accessor = cpu_stats.accessor<int64_t, 1>();
+
+  TORCH_CHECK(cpu_stats_accessor[0] == 0, "crow_indices[0] must be 0, but got ", cpu_stats_accessor[0]);
+  TORCH_CHECK(cpu_stats_accessor[1] == nnz,
+      "crow_indices[-1] must be the number of specified elements ", nnz, ", but got ", cpu_stats_accessor[1]);
+  int64_t i = 2;
+  if (rows > 0) {
+    TORCH_CHECK(cpu_stats_accessor[i] >= 0, "crow_indices must be nondecreasing");
+    i++;
+  }
+  if (nnz > 0) {
+    TORCH_CHECK(cpu_stats_accessor[i] >= 0 && cpu_stats_accessor[i + 1] < size[1],
+        "col_indices must be in the range [0, ", size[1], "), but found ", cpu_stats_accessor[i], " to ", cpu_stats_accessor[i + 1]);
+  }
+}
+
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size, const TensorOptions& options) {
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr, "expected sparse CSR layout, but got layout ", options.layout());
+
+  Tensor crow = crow_indices;
+  Tensor col = col_indices;
+  Tensor vals = values;
+  if (options.has_dtype()) {
+    vals = vals.to(typeMetaToScalarType(options.dtype()));
+  }
+  if (options.has_device()) {
+    crow = crow.to(options.device());
+    col = col.to(options.device());
+    vals = vals.to(options.device());
+  }
+  at::native::_validate_sparse_csr_tensor_args(crow, col, vals, size);
+  return at::_sparse_csr_tensor_unsafe(crow, col, vals, size, vals.options().layout(kSparseCsr));
+}
+
+// NOTE: _sparse_csr_tensor_unsafe() differs from sparse_csr_tensor() in that
+// it doesn't check the contents of the indices, thus avoiding a copy from CUDA
+// to CPU. It should ONLY be used where the indices are known to be valid.
+//
+// It is also registered for the dense backends, so that it can be called
+// without giving the layout, which is always CSR.
+SparseCsrTensor new_with_tensors_sparse_csr(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size, const TensorOptions& options) {
+  TORCH_INTERNAL_ASSERT(impl::variable_excluded_from_dispatch());
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr, "expected sparse CSR layout, but got layout ", options.layout());
+  TORCH_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+  TORCH_CHECK(values.device().is_cpu() || values.is_cuda(), "sparse CSR tensors are supported on CPU and CUDA, but got values on ", values.device());
+  DispatchKey dispatch_key = values.is_cuda() ? DispatchKey::SparseCsrCUDA : DispatchKey::SparseCsrCPU;
+
+  // The members the tensor is created with are replaced right away, but they
+  // decide its device.
+  const DeviceGuard device_guard(values.device());
+  SparseCsrTensor self = detail::make_tensor<SparseCsrTensorImpl>(DispatchKeySet(dispatch_key), values.dtype());
+
+  // Like the members of a COO tensor, those of a CSR tensor don't contain
+  // AutogradMeta, see NOTE [ Sparse: autograd and API ].
+  auto shallow_copy = [](const Tensor& t) {
+    return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+        /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+        /*allow_tensor_metadata_change=*/true));
+  };
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(
+      shallow_copy(crow_indices), shallow_copy(col_indices), shallow_copy(values), size);
+  return self;
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+namespace {
+
+// The offsets at which each of the rows starts, given the nondecreasing
+// row index of every element.
+Tensor compress_row_indices(const Tensor& row_indices, int64_t rows, ScalarType index_dtype) {
+  if (row_indices.numel() == 0) {
+    return at::zeros({rows + 1}, row_indices.options().dtype(index_dtype));
+  }
+  return at::searchsorted(
+      row_indices, at::arange(rows + 1, row_indices.options()),
+      /*out_int32=*/index_dtype == kInt, /*right=*/false);
+}
+
+// The int64 row index of every element of a CSR tensor.
+Tensor expand_row_indices(const SparseCsrTensor& self) {
+  Tensor crow_indices = get_sparse_csr_impl(self)->crow_indices();
+  return at::searchsorted(
+      crow_indices, at::arange(self._nnz(), crow_indices.options()),
+      /*out_int32=*/false, /*right=*/true).sub_(1);
+}
+
+} // namespace
+
+SparseCsrTensor sparse_coo_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: expected a 2-dimensional sparse COO tensor with scalar values, but got sparse_dim ",
+      self.sparse_dim(), " and dense_dim ", self.dense_dim());
+  // coalescing sorts the elements by row, then column
+  Tensor coalesced = self.coalesce();
+  Tensor indices = coalesced._indices();
+  Tensor values = coalesced._values();
+  const int64_t rows = self.size(0);
+  ScalarType index_dtype = csr_index_dtype(rows, self.size(1), coalesced._nnz());
+
+  Tensor crow_indices = compress_row_indices(indices.select(0, 0), rows, index_dtype);
+  Tensor col_indices = indices.select(0, 1).to(index_dtype);
+  return at::_sparse_csr_tensor_unsafe(
+      crow_indices, col_indices, values, self.sizes(), values.options().layout(kSparseCsr));
+}
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: expected a 2-dimensional tensor, but got ", self.dim(), " dimensions");
+  return self.to_sparse().to_sparse_csr();
+}
+
+Tensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  Tensor col_indices = get_sparse_csr_impl(self)->col_indices();
+  Tensor values = get_sparse_csr_impl(self)->values();
+  Tensor indices = at::stack({expand_row_indices(self), col_indices.to(kLong)});
+  // The columns of a row may be unsorted or repeated, so the result is not
+  // marked coalesced.
+  return at::_sparse_coo_tensor_unsafe(indices, values, self.sizes(), values.options().layout(kSparse));
+}
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self) {
+  Tensor values = get_sparse_csr_impl(self)->values();
+  Tensor dense = at::zeros(self.sizes(), values.options());
+  if (self._nnz() == 0) {
+    return dense;
+  }
+  Tensor flat_indices = expand_row_indices(self)
+      .mul_(self.size(1))
+      .add_(get_sparse_csr_impl(self)->col_indices());
+  // index_add_ accumulates repeated columns, the way coalesce does
+  dense.view(-1).index_add_(0, flat_indices, values);
+  return dense;
+}
+
+}} // namespace at::native
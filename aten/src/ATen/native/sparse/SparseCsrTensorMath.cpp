@@ -0,0 +1,251 @@
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Config.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+#if AT_MKL_ENABLED()
+#include <mkl_spblas.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+void addmm_sparse_csr_prepare_out(Tensor& result, const Tensor& self, const SparseCsrTensor& mat1, const Tensor& mat2, Scalar beta) {
+  TORCH_CHECK(mat1.is_sparse_csr(), "addmm: expected mat1 to be a sparse CSR matrix");
+  TORCH_CHECK(mat2.layout() == kStrided && mat2.dim() == 2,
+      "addmm: expected mat2 to be a strided matrix, but got a ", mat2.dim(), "D tensor of layout ", mat2.layout());
+  TORCH_CHECK(self.layout() == kStrided && result.layout() == kStrided,
+      "addmm: expected self and out to be strided tensors when mat1 is a sparse CSR matrix");
+  TORCH_CHECK(mat1.size(1) == mat2.size(0),
+      "addmm: mat1 and mat2 shapes cannot be multiplied (", mat1.size(0), "x", mat1.size(1),
+      " and ", mat2.size(0), "x", mat2.size(1), ")");
+  TORCH_CHECK(mat2.scalar_type() == mat1.scalar_type() && self.scalar_type() == mat1.scalar_type() &&
+      result.scalar_type() == mat1.scalar_type(),
+      "addmm: expected self, mat1, mat2 and out to have the same dtype, but got ", self.scalar_type(), ", ",
+      mat1.scalar_type(), ", ", mat2.scalar_type(), " and ", result.scalar_type());
+  TORCH_CHECK(mat2.device() == mat1.device() && self.device() == mat1.device() && result.device() == mat1.device(),
+      "addmm: expected self, mat1, mat2 and out to be on the same device, but got ", self.device(), ", ",
+      mat1.device(), ", ", mat2.device(), " and ", result.device());
+
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  const bool in_place = sparse::is_same_tensor(result, self);
+  result.resize_({mat1.size(0), mat2.size(1)});
+
+  // as with dense addmm, self is ignored when beta is zero, even if it holds nans
+  if (beta.to<double>() == 0) {
+    result.zero_();
+  } else if (in_place) {
+    if (beta.to<double>() != 1) {
+      result.mul_(beta);
+    }
+  } else {
+    at::mul_out(result, b_self, at::scalar_tensor(beta, result.options()));
+  }
+}
+
+namespace {
+
+// r[i, :] += alpha * values[p] * dense[col_indices[p], :] for every element p
+// of row i, with rows split among the threads, so that no two of them write
+// the same row of r. dense and r are row-major.
+template <typename scalar_t, typename index_t>
+void csr_mm_native(
+    int64_t rows, int64_t cols, int64_t nnz, scalar_t alpha,
+    const index_t* crow_indices, const index_t* col_indices, const scalar_t* values,
+    const scalar_t* dense, scalar_t* r) {
+  const int64_t work_per_row = std::max<int64_t>(1, cols * (nnz / std::max<int64_t>(1, rows) + 1));
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_row);
+  at::parallel_for(0, rows, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* r_row = r + i * cols;
+      for (index_t p = crow_indices[i]; p < crow_indices[i + 1]; p++) {
+        const scalar_t val = alpha * values[p];
+        const scalar_t* dense_row = dense + static_cast<int64_t>(col_indices[p]) * cols;
+        for (int64_t j = 0; j < cols; j++) {
+          r_row[j] += val * dense_row[j];
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void csr_mm_native(
+    int64_t rows, int64_t cols, int64_t nnz, scalar_t alpha,
+    const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values,
+    const Tensor& dense, Tensor& r) {
+  if (crow_indices.scalar_type() == kInt) {
+    csr_mm_native<scalar_t, int32_t>(
+        rows, cols, nnz, alpha, crow_indices.data_ptr<int32_t>(), col_indices.data_ptr<int32_t>(),
+        values.data_ptr<scalar_t>(), dense.data_ptr<scalar_t>(), r.data_ptr<scalar_t>());
+  } else {
+    csr_mm_native<scalar_t, int64_t>(
+        rows, cols, nnz, alpha, crow_indices.data_ptr<int64_t>(), col_indices.data_ptr<int64_t>(),
+        values.data_ptr<scalar_t>(), dense.data_ptr<scalar_t>(), r.data_ptr<scalar_t>());
+  }
+}
+
+template <typename scalar_t>
+using is_mkl_sparse_type = std::integral_constant<bool,
+    std::is_same<scalar_t, float>::value || std::is_same<scalar_t, double>::value>;
+
+// Returns whether MKL did the product, which it does for float and double
+// values and MKL_INT indices.
+template <typename scalar_t>
+typename std::enable_if<!is_mkl_sparse_type<scalar_t>::value, bool>::type csr_mm_mkl(
+    int64_t rows, int64_t inner, int64_t cols, scalar_t alpha,
+    const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values,
+    const Tensor& dense, Tensor& r) {
+  return false;
+}
+
+#if !AT_MKL_ENABLED()
+
+template <typename scalar_t>
+typename std::enable_if<is_mkl_sparse_type<scalar_t>::value, bool>::type csr_mm_mkl(
+    int64_t rows, int64_t inner, int64_t cols, scalar_t alpha,
+    const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values,
+    const Tensor& dense, Tensor& r) {
+  return false;
+}
+
+#else
+
+sparse_status_t mkl_create_csr(sparse_matrix_t* A, MKL_INT rows, MKL_INT cols, MKL_INT* crow_indices, MKL_INT* col_indices, float* values) {
+  return mkl_sparse_s_create_csr(A, SPARSE_INDEX_BASE_ZERO, rows, cols, crow_indices, crow_indices + 1, col_indices, values);
+}
+
+sparse_status_t mkl_create_csr(sparse_matrix_t* A, MKL_INT rows, MKL_INT cols, MKL_INT* crow_indices, MKL_INT* col_indices, double* values) {
+  return mkl_sparse_d_create_csr(A, SPARSE_INDEX_BASE_ZERO, rows, cols, crow_indices, crow_indices + 1, col_indices, values);
+}
+
+sparse_status_t mkl_mm(sparse_matrix_t A, float alpha, const float* dense, MKL_INT cols, float* r) {
+  matrix_descr descr;
+  descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+  return mkl_sparse_s_mm(SPARSE_OPERATION_NON_TRANSPOSE, alpha, A, descr, SPARSE_LAYOUT_ROW_MAJOR,
+                         dense, cols, cols, 1.0f, r, cols);
+}
+
+sparse_status_t mkl_mm(sparse_matrix_t A, double alpha, const double* dense, MKL_INT cols, double* r) {
+  matrix_descr descr;
+  descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+  return mkl_sparse_d_mm(SPARSE_OPERATION_NON_TRANSPOSE, alpha, A, descr, SPARSE_LAYOUT_ROW_MAJOR,
+                         dense, cols, cols, 1.0, r, cols);
+}
+
+// Owns an MKL sparse matrix handle, which only points to the members of the
+// CSR tensor, so that they are not copied.
+struct MklSparseMatrix {
+  sparse_matrix_t handle = nullptr;
+  ~MklSparseMatrix() {
+    if (handle) {
+      mkl_sparse_destroy(handle);
+    }
+  }
+};
+
+template <typename scalar_t>
+typename std::enable_if<is_mkl_sparse_type<scalar_t>::value, bool>::type csr_mm_mkl(
+    int64_t rows, int64_t inner, int64_t cols, scalar_t alpha,
+    const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values,
+    const Tensor& dense, Tensor& r) {
+  constexpr int64_t mkl_int_max = std::numeric_limits<MKL_INT>::max();
+  if (crow_indices.element_size() != sizeof(MKL_INT) ||
+      rows > mkl_int_max || inner > mkl_int_max || cols > mkl_int_max) {
+    return false;
+  }
+  MklSparseMatrix A;
+  sparse_status_t status = mkl_create_csr(
+      &A.handle, rows, inner, static_cast<MKL_INT*>(crow_indices.data_ptr()), static_cast<MKL_INT*>(col_indices.data_ptr()),
+      values.data_ptr<scalar_t>());
+  TORCH_CHECK(status == SPARSE_STATUS_SUCCESS, "addmm: MKL failed to create a sparse CSR matrix, status ", status);
+  status = mkl_mm(A.handle, alpha, dense.data_ptr<scalar_t>(), cols, r.data_ptr<scalar_t>());
+  TORCH_CHECK(status == SPARSE_STATUS_SUCCESS, "addmm: MKL sparse matrix product failed, status ", status);
+  return true;
+}
+
+#endif // AT_MKL_ENABLED()
+
+} // namespace
+
+// result = beta * self + alpha * (mat1 @ mat2)
+//
+// With MKL, float and double products go to mkl_sparse_?_mm whenever the
+// indices have the width of MKL_INT, which the conversions to CSR arrange;
+// anything else takes a loop over the rows of mat1.
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(mat1.device().is_cpu(), "addmm: expected mat1 to be a CPU tensor, but got a tensor on ", mat1.device());
+  addmm_sparse_csr_prepare_out(result, self, mat1, mat2, beta);
+  const int64_t nnz = mat1._nnz();
+  if (nnz == 0 || result.numel() == 0) {
+    return result;
+  }
+
+  const int64_t rows = mat1.size(0);
+  const int64_t inner = mat1.size(1);
+  const int64_t cols = mat2.size(1);
+  Tensor crow_indices = get_sparse_csr_impl(mat1)->crow_indices();
+  Tensor col_indices = get_sparse_csr_impl(mat1)->col_indices();
+  Tensor values = get_sparse_csr_impl(mat1)->values();
+  Tensor dense = mat2.contiguous();
+  Tensor r = result.is_contiguous() ? result : result.contiguous();
+
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "addmm_sparse_csr_dense", [&] {
+    const scalar_t cast_alpha = alpha.to<scalar_t>();
+    if (!csr_mm_mkl<scalar_t>(rows, inner, cols, cast_alpha, crow_indices, col_indices, values, dense, r)) {
+      csr_mm_native<scalar_t>(rows, cols, nnz, cast_alpha, crow_indices, col_indices, values, dense, r);
+    }
+  });
+
+  if (!r.is_same(result)) {
+    result.copy_(r);
+  }
+  return result;
+}
+
+Tensor addmm_sparse_csr_dense(
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  Tensor result = at::empty({0}, self.options());
+  return at::addmm_out(result, self, mat1, mat2, beta, alpha);
+}
+
+Tensor mm_sparse_csr(const SparseCsrTensor& self, const Tensor& mat2) {
+  Tensor t = at::zeros({}, mat2.options());
+  return at::addmm(t, self, mat2, 0, 1);
+}
+
+Tensor& mm_out_sparse_csr(Tensor& result, const SparseCsrTensor& self, const Tensor& mat2) {
+  Tensor t = at::zeros({}, mat2.options());
+  return at::addmm_out(result, t, self, mat2, 0, 1);
+}
+
+// A product with a single column, same kernels as mm.
+Tensor mv_sparse_csr(const SparseCsrTensor& self, const Tensor& vec) {
+  TORCH_CHECK(vec.dim() == 1, "mv: expected a 1-dimensional vector, but got a ", vec.dim(), "D tensor");
+  return at::mm(self, vec.unsqueeze(1)).squeeze_(1);
+}
+
+}} // namespace at::native
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorUtils.h>
+
+namespace at { namespace native {
+
+// Checks the arguments of addmm with a CSR mat1 and a strided mat2, and sets
+// result to beta * self, with the rows x cols shape of the product. The
+// kernels then only have to accumulate alpha * mat1 @ mat2 into result.
+TORCH_API void addmm_sparse_csr_prepare_out(
+    Tensor& result, const Tensor& self, const sparse_csr::SparseCsrTensor& mat1, const Tensor& mat2, Scalar beta);
+
+}}
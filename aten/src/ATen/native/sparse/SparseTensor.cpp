@@ -8,7 +8,9 @@
 #include <ATen/InitialTensorOptions.h>
 #include <ATen/SparseTensorUtils.h>
 
-#include <TH/THBlasUtils.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 namespace at { namespace native {
 
@@ -353,6 +355,118 @@ SparseTensor& copy_sparse_(SparseTensor& self, const SparseTensor& src, bool non
   return self._coalesced_(src.is_coalesced());
 }
 
+// NOTE [ Parallel coalesce ]
+//
+// coalesce_sparse_cpu sorts the flattened indices with a parallel LSD radix
+// sort of (index, position) pairs, kRadixBits bits per pass and only as many
+// passes as the largest flattened index needs. The sort is stable, so that the
+// values of a repeated index are summed in the order they were given. The runs
+// of equal indices then write disjoint rows of the result, and are summed in
+// parallel.
+namespace {
+
+constexpr int kRadixBits = 8;
+constexpr int64_t kRadixBuckets = int64_t(1) << kRadixBits;
+// Below this many elements per thread, the histograms cost more than the
+// threads save.
+constexpr int64_t kMinRadixSortChunk = 1 << 14;
+
+// Splits [0, n) into the chunks the passes of the sort share, so that every
+// chunk scatters its elements to the same offsets it counted.
+int64_t radix_sort_num_chunks(int64_t n) {
+  return std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), n / kMinRadixSortChunk));
+}
+
+// Sorts keys[0, n), which must be in [0, max_key], in place, and permutes
+// positions along with them.
+void radix_sort_indices(int64_t* keys, int64_t* positions, int64_t n, int64_t max_key) {
+  if (max_key <= 0) {
+    return;
+  }
+  std::vector<int64_t> keys_buffer(n);
+  std::vector<int64_t> positions_buffer(n);
+  int64_t* keys_in = keys;
+  int64_t* positions_in = positions;
+  int64_t* keys_out = keys_buffer.data();
+  int64_t* positions_out = positions_buffer.data();
+
+  const int64_t num_chunks = radix_sort_num_chunks(n);
+  const int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  // offsets[c * kRadixBuckets + b]: where chunk c writes its next element of bucket b
+  std::vector<int64_t> offsets(num_chunks * kRadixBuckets);
+
+  for (int shift = 0; shift < 64 && (max_key >> shift) > 0; shift += kRadixBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* counts = offsets.data() + c * kRadixBuckets;
+        for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); i++) {
+          counts[(keys_in[i] >> shift) & (kRadixBuckets - 1)]++;
+        }
+      }
+    });
+    int64_t offset = 0;
+    for (int64_t b = 0; b < kRadixBuckets; b++) {
+      for (int64_t c = 0; c < num_chunks; c++) {
+        const int64_t count = offsets[c * kRadixBuckets + b];
+        offsets[c * kRadixBuckets + b] = offset;
+        offset += count;
+      }
+    }
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* chunk_offsets = offsets.data() + c * kRadixBuckets;
+        for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); i++) {
+          const int64_t j = chunk_offsets[(keys_in[i] >> shift) & (kRadixBuckets - 1)]++;
+          keys_out[j] = keys_in[i];
+          positions_out[j] = positions_in[i];
+        }
+      }
+    });
+    std::swap(keys_in, keys_out);
+    std::swap(positions_in, positions_out);
+  }
+
+  if (keys_in != keys) {
+    at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      std::copy(keys_in + begin, keys_in + end, keys + begin);
+      std::copy(positions_in + begin, positions_in + end, positions + begin);
+    });
+  }
+}
+
+// The offsets at which each run of equal keys of the sorted keys[0, n) starts.
+std::vector<int64_t> equal_key_run_starts(const int64_t* keys, int64_t n) {
+  const int64_t num_chunks = radix_sort_num_chunks(n);
+  const int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  auto is_run_start = [&](int64_t i) { return i == 0 || keys[i] != keys[i - 1]; };
+
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); i++) {
+        chunk_offsets[c + 1] += is_run_start(i);
+      }
+    }
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+
+  std::vector<int64_t> run_starts(chunk_offsets[num_chunks]);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t run = chunk_offsets[c];
+      for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); i++) {
+        if (is_run_start(i)) {
+          run_starts[run++] = i;
+        }
+      }
+    }
+  });
+  return run_starts;
+}
+
+} // namespace
+
 SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   AT_ASSERT(self.defined());
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
@@ -384,44 +498,58 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   Tensor newValues = at::empty(values.sizes(), values.options());
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
-  // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
-  auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
-  auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
-
-  int64_t i = -1;
-  AT_DISPATCH_ALL_TYPES(
-      values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
-        int64_t blockSize = values.stride(0);
-        scalar_t* values_ptr = values.data_ptr<scalar_t>();
-        scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
-            for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
-            }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+  // See NOTE [ Parallel coalesce ]
+  LongTensor indicesBuffer = indices_scalar.contiguous().clone();
+  LongTensor indicesPermutation = at::arange(nnz, indices.options());
+  int64_t* keys = indicesBuffer.data_ptr<int64_t>();
+  int64_t* permutation = indicesPermutation.data_ptr<int64_t>();
+  radix_sort_indices(keys, permutation, nnz, indicesBuffer.max().item<int64_t>());
+  std::vector<int64_t> run_starts = equal_key_run_starts(keys, nnz);
+  const int64_t num_runs = run_starts.size();
+
+  const int64_t* indices_ptr = indices.data_ptr<int64_t>();
+  const int64_t indices_stride0 = indices.stride(0);
+  const int64_t indices_stride1 = indices.stride(1);
+  int64_t* newIndices_ptr = newIndices.data_ptr<int64_t>();
+  const int64_t newIndices_stride0 = newIndices.stride(0);
+  at::parallel_for(0, num_runs, at::internal::GRAIN_SIZE / std::max<int64_t>(1, sparse_dim), [&](int64_t start, int64_t end) {
+    for (int64_t run = start; run < end; run++) {
+      const int64_t pos = permutation[run_starts[run]];
+      for (int64_t d = 0; d < sparse_dim; d++) {
+        newIndices_ptr[d * newIndices_stride0 + run] = indices_ptr[d * indices_stride0 + pos * indices_stride1];
+      }
+    }
+  });
+
+  // if values is an empty tensor, there are no elements to copy
+  if (values.numel() > 0) {
+    AT_DISPATCH_ALL_TYPES(
+        values.scalar_type(), "coalesce", [&] {
+          const int64_t blockSize = values.stride(0);
+          const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+          scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
+          // the runs write disjoint blocks of newValues
+          at::parallel_for(0, num_runs, std::max<int64_t>(1, at::internal::GRAIN_SIZE / blockSize), [&](int64_t start, int64_t end) {
+            for (int64_t run = start; run < end; run++) {
+              const int64_t run_end = run + 1 < num_runs ? run_starts[run + 1] : nnz;
+              scalar_t* dst_ptr = newValues_ptr + run * blockSize;
+              const scalar_t* src_ptr = values_ptr + permutation[run_starts[run]] * blockSize;
+              for (int64_t k = 0; k < blockSize; k++) {
+                dst_ptr[k] = src_ptr[k];
+              }
+              for (int64_t j = run_starts[run] + 1; j < run_end; j++) {
+                src_ptr = values_ptr + permutation[j] * blockSize;
+                for (int64_t k = 0; k < blockSize; k++) {
+                  dst_ptr[k] += src_ptr[k];
+                }
+              }
             }
-          }
-          prev = curr;
-        }
-    });
+          });
+      });
+  }
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
+  get_sparse_impl(dst)->set_nnz_and_narrow(num_runs);
 
   return dst;
 }
@@ -445,12 +573,14 @@ void inline sparse_mask_out_cpu_kernel(
   auto r_values_accessor = r_values.accessor<scalar_t, 1>();
   auto mask_indices_accessor = mask_indices.accessor<int64_t, 2>();
   scalar_t* t_ptr = t.data_ptr<scalar_t>();
+  // read the strides once, rather than through t for every element
+  const std::vector<int64_t> t_strides(t.strides().begin(), t.strides().begin() + sparse_dim);
 
   at::parallel_for(0, r_nnz, 1000, [&](int64_t start, int64_t end) {
     for (auto i = start; i < end; i++) {
       int64_t idx = 0;
       for (int64_t d = 0; d < sparse_dim; d++) {
-        idx += mask_indices_accessor[d][i] * t.stride(d);
+        idx += mask_indices_accessor[d][i] * t_strides[d];
       }
       r_values_accessor[i] = t_ptr[idx];
     }
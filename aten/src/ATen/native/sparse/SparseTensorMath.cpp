@@ -590,25 +590,61 @@ SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const S
 //    formerly known as spcadd
 // --------------------------------------------------------------------
 
+// The indices of a coalesced sparse tensor are unique, so that its elements
+// add to disjoint elements (or, with dense dimensions, slices) of r, and the
+// workers split them among threads.
+
 template <typename scalar_t>
 void add_dense_sparse_worker_cpu(Tensor& r, Scalar value, const SparseTensor& sparse, const Tensor& indices, const Tensor& values) {
   auto indices_accessor = indices.accessor<int64_t, 2>();
   auto values_accessor = values.accessor<scalar_t, 1>();
 
+  // data_ptr already accounts for the storage offset of r
   scalar_t* r_ptr = r.data_ptr<scalar_t>();
   scalar_t cast_value = value.to<scalar_t>();
+  const int64_t sparse_dim = sparse.sparse_dim();
+  const std::vector<int64_t> r_strides(r.strides().begin(), r.strides().begin() + sparse_dim);
 
   at::parallel_for(0, sparse._nnz(), 0, [&](int64_t start, int64_t end) {
     for (auto k = start; k < end; k++) {
-      int64_t index = r.storage_offset();
-      for (int64_t d = 0; d < sparse.sparse_dim(); d++) {
-        index += r.stride(d) * indices_accessor[d][k];
+      int64_t index = 0;
+      for (int64_t d = 0; d < sparse_dim; d++) {
+        index += r_strides[d] * indices_accessor[d][k];
       }
       r_ptr[index] += cast_value * values_accessor[k];
     }
   });
 }
 
+// r += value * sparse, for a sparse tensor with dense dimensions, a contiguous
+// r and contiguous values: every element adds a contiguous block of values to
+// a contiguous slice of r.
+template <typename scalar_t>
+void add_dense_sparse_hybrid_worker_cpu(Tensor& r, Scalar value, const SparseTensor& sparse, const Tensor& indices, const Tensor& values) {
+  const int64_t nnz = sparse._nnz();
+  const int64_t block_size = values.numel() / nnz;
+  auto indices_accessor = indices.accessor<int64_t, 2>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+  scalar_t cast_value = value.to<scalar_t>();
+  const int64_t sparse_dim = sparse.sparse_dim();
+  const std::vector<int64_t> r_strides(r.strides().begin(), r.strides().begin() + sparse_dim);
+
+  at::parallel_for(0, nnz, std::max<int64_t>(1, at::internal::GRAIN_SIZE / block_size), [&](int64_t start, int64_t end) {
+    for (auto k = start; k < end; k++) {
+      int64_t index = 0;
+      for (int64_t d = 0; d < sparse_dim; d++) {
+        index += r_strides[d] * indices_accessor[d][k];
+      }
+      scalar_t* dst_ptr = r_ptr + index;
+      const scalar_t* src_ptr = values_ptr + k * block_size;
+      for (int64_t j = 0; j < block_size; j++) {
+        dst_ptr[j] += cast_value * src_ptr[j];
+      }
+    }
+  });
+}
+
 Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTensor& sparse_, Scalar value) {
   AT_ASSERT(!r.is_sparse());
   AT_ASSERT(!dense.is_sparse());
@@ -646,7 +682,15 @@ Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTen
   }
 
   // accessors rely on nnz test
-  if (nDim > nDimI) {
+  if (nDim > nDimI && resultBuffer.is_contiguous()) {
+    if (valuesBuffer.numel() > 0) {
+      Tensor valuesContiguous = valuesBuffer.contiguous();
+      AT_DISPATCH_ALL_TYPES(
+          commonDtype, "add_dense_sparse", [&] {
+            add_dense_sparse_hybrid_worker_cpu<scalar_t>(resultBuffer, value, sparse, indices, valuesContiguous);
+          });
+    }
+  } else if (nDim > nDimI) {
     auto indices_accessor = indices.accessor<int64_t, 2>();
     for (int64_t k = 0; k < sparse._nnz(); k++) {
       Tensor dstBuffer = resultBuffer;
@@ -0,0 +1,85 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
+#include <ATen/native/sparse/cuda/SparseCUDABlas.cuh>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+// result = beta * self + alpha * (mat1 @ mat2)
+//
+// The members of mat1 go to cuSPARSE as they are when its indices are int32,
+// which the conversions to CSR produce whenever they fit; int64 indices are
+// narrowed on every call.
+Tensor& addmm_out_sparse_csr_dense_cuda(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(mat1.is_cuda(), "addmm: expected mat1 to be a CUDA tensor, but got a tensor on ", mat1.device());
+  TORCH_CHECK(cuda::check_device({mat1, mat2, self, result}));
+  addmm_sparse_csr_prepare_out(result, self, mat1, mat2, beta);
+  const int64_t nnz = mat1._nnz();
+  if (nnz == 0 || result.numel() == 0) {
+    return result;
+  }
+
+  const int64_t m = mat1.size(0);
+  const int64_t k = mat1.size(1);
+  const int64_t n = mat2.size(1);
+  Tensor crow_indices = get_sparse_csr_impl(mat1)->crow_indices().to(kInt);
+  Tensor col_indices = get_sparse_csr_impl(mat1)->col_indices().to(kInt);
+  Tensor values = get_sparse_csr_impl(mat1)->values();
+
+  // cuSPARSE writes a column-major result, and reads mat2 either way
+  Tensor r;
+  if (result.stride(0) == 1 && result.stride(1) == m) {
+    r = result;
+  } else {
+    r = result.transpose(0, 1).clone(at::MemoryFormat::Contiguous).transpose_(0, 1);
+  }
+  Tensor dense;
+  char transpose_dense;
+  if (mat2.stride(0) == 1 && mat2.stride(1) == k) {
+    transpose_dense = 'n';
+    dense = mat2;
+  } else {
+    transpose_dense = 't';
+    dense = mat2.contiguous();
+  }
+
+  // No half support, as in the COO addmm
+  AT_DISPATCH_FLOATING_TYPES(values.scalar_type(), "addmm_sparse_csr_dense_cuda", [&] {
+    sparse::cuda::csrmm2(
+      'n',
+      transpose_dense,
+      m,
+      n,
+      k,
+      nnz,
+      alpha.to<scalar_t>(),
+      values.data_ptr<scalar_t>(),
+      crow_indices.data_ptr<int32_t>(),
+      col_indices.data_ptr<int32_t>(),
+      dense.data_ptr<scalar_t>(),
+      (transpose_dense == 'n' ? dense.stride(1) : dense.stride(0)),
+      /*beta=*/static_cast<scalar_t>(1),
+      r.data_ptr<scalar_t>(),
+      r.stride(1));
+  });
+
+  if (!r.is_same(result)) {
+    result.copy_(r);
+  }
+  return result;
+}
+
+}} // namespace at::native
@@ -2,9 +2,12 @@
 
 #include <ATen/ATen.h>
 #include <ATen/LegacyTHFunctionsCPU.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/Utils.h>
 
+#include <algorithm>
+
 namespace at {
 namespace native {
 
@@ -82,33 +85,45 @@ static void col2vol(
     const int64_t dilationH,
     const int64_t dilationW,
     T* data_vol) {
-  int64_t c, t, h, w;
-  memset(data_vol, 0, sizeof(T) * depth * height * width * channels);
   int64_t depth_col = out_depth;
   int64_t height_col = out_height;
   int64_t width_col = out_width;
-  int64_t channels_col = channels * kT * kernel_height * kernel_width;
-  for (c = 0; c < channels_col; ++c) {
-    int64_t w_offset = c % kernel_width;
-    int64_t h_offset = (c / kernel_width) % kernel_height;
-    int64_t t_offset = (c / kernel_width / kernel_height) % kT;
-    int64_t c_vol = c / kT / kernel_height / kernel_width;
-    for (t = 0; t < depth_col; ++t) {
-      int64_t t_pad = t * dT - pT + t_offset * dilationT;
-      for (h = 0; h < height_col; ++h) {
-        int64_t h_pad = h * dH - pH + h_offset * dilationH;
-        for (w = 0; w < width_col; ++w) {
-          int64_t w_pad = w * dW - pW + w_offset * dilationW;
-          if (t_pad >= 0 && t_pad < depth && h_pad >= 0 && h_pad < height &&
-              w_pad >= 0 && w_pad < width)
-            data_vol
-                [((c_vol * depth + t_pad) * height + h_pad) * width + w_pad] +=
-                data_col
-                    [((c * depth_col + t) * height_col + h) * width_col + w];
+  int64_t kernel_size = kT * kernel_height * kernel_width;
+  int64_t col_size = depth_col * height_col * width_col;
+  int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, kernel_size * col_size));
+  // Every channel of the volume only gathers from its own kernel_size rows
+  // of columns, so the channels are independent and run in parallel.
+  at::parallel_for(0, channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t c_vol = begin; c_vol < end; ++c_vol) {
+      T* vol = data_vol + c_vol * depth * height * width;
+      memset(vol, 0, sizeof(T) * depth * height * width);
+      for (int64_t c = c_vol * kernel_size; c < (c_vol + 1) * kernel_size; ++c) {
+        int64_t w_offset = c % kernel_width;
+        int64_t h_offset = (c / kernel_width) % kernel_height;
+        int64_t t_offset = (c / kernel_width / kernel_height) % kT;
+        const T* col = data_col + c * col_size;
+        for (int64_t t = 0; t < depth_col; ++t) {
+          int64_t t_pad = t * dT - pT + t_offset * dilationT;
+          if (t_pad < 0 || t_pad >= depth) {
+            continue;
+          }
+          for (int64_t h = 0; h < height_col; ++h) {
+            int64_t h_pad = h * dH - pH + h_offset * dilationH;
+            if (h_pad < 0 || h_pad >= height) {
+              continue;
+            }
+            for (int64_t w = 0; w < width_col; ++w) {
+              int64_t w_pad = w * dW - pW + w_offset * dilationW;
+              if (w_pad >= 0 && w_pad < width)
+                vol[(t_pad * height + h_pad) * width + w_pad] +=
+                    col[(t * height_col + h) * width_col + w];
+            }
+          }
         }
       }
     }
-  }
+  });
 }
 
 } // namespace native
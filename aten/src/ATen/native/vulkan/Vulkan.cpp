@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <unistd.h>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <numeric>
 
 #include <c10/util/ArrayRef.h>
@@ -42,6 +45,7 @@ VContext::VContext(const bool enableValidationLayers)
   createDevice();
 
   computeUnitFactory_ = std::make_unique<ComputeUnitFactory>(device_);
+  bufferPool_ = std::make_unique<VBufferPool>(device_);
 }
 
 VContext::~VContext() {
@@ -56,6 +60,7 @@ VContext::~VContext() {
   // ComputeUnitFactory_ owns ComputeUnits and VkPipelineCache, need valid
   // VkDevice for destructing, destructing before vkDestroyDevice
   computeUnitFactory_.reset();
+  bufferPool_.reset();
 
   vkDestroyCommandPool(device_, commandPool_, nullptr);
   vkDestroyDevice(device_, nullptr);
@@ -304,11 +309,68 @@ void VBuffer::MapMemory::flushWriteToHost() {
   VK_CHECK(vkInvalidateMappedMemoryRanges(context().device(), 1, &range));
 }
 
+VBufferPool::~VBufferPool() {
+  purge();
+}
+
+bool VBufferPool::acquire(
+    const VkDeviceSize size,
+    const VkBufferUsageFlags usage,
+    Entry* const entry) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  const auto it = free_.find({size, usage});
+  if (it == free_.end() || it->second.empty()) {
+    return false;
+  }
+  *entry = it->second.back();
+  it->second.pop_back();
+  cachedBytes_ -= size;
+  return true;
+}
+
+void VBufferPool::release(
+    const VkDeviceSize size,
+    const VkBufferUsageFlags usage,
+    const Entry entry) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (cachedBytes_ + size <= kMaxCachedBytes) {
+      free_[{size, usage}].push_back(entry);
+      cachedBytes_ += size;
+      return;
+    }
+  }
+  vkFreeMemory(device_, entry.memory, nullptr);
+  vkDestroyBuffer(device_, entry.buffer, nullptr);
+}
+
+void VBufferPool::purge() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (const auto& it : free_) {
+    for (const auto& entry : it.second) {
+      vkFreeMemory(device_, entry.memory, nullptr);
+      vkDestroyBuffer(device_, entry.buffer, nullptr);
+    }
+  }
+  free_.clear();
+  cachedBytes_ = 0;
+}
+
 VBuffer::VBuffer(
     const VkDeviceSize bufferSizeBytes,
     const VkBufferUsageFlags bufferUsageFlags,
     const VkDescriptorType descriptorType)
-    : bufferSizeBytes_(bufferSizeBytes), descriptorType_(descriptorType) {
+    : bufferSizeBytes_(bufferSizeBytes),
+      bufferUsageFlags_(bufferUsageFlags),
+      descriptorType_(descriptorType) {
+  VBufferPool::Entry entry{};
+  if (context().bufferPool().acquire(
+          bufferSizeBytes_, bufferUsageFlags_, &entry)) {
+    buffer_ = entry.buffer;
+    bufferMemory_ = entry.memory;
+    return;
+  }
+
   const auto device = context().device();
   const auto physicalDevice = context().physicalDevice();
   VkBufferCreateInfo bufferCreateInfo{};
@@ -331,9 +393,42 @@ VBuffer::VBuffer(
   VK_CHECK(vkBindBufferMemory(device, buffer_, bufferMemory_, 0));
 }
 
+VBuffer::VBuffer(VBuffer&& other) noexcept
+    : bufferSizeBytes_(other.bufferSizeBytes_),
+      bufferUsageFlags_(other.bufferUsageFlags_),
+      descriptorType_(other.descriptorType_),
+      buffer_(other.buffer_),
+      bufferMemory_(other.bufferMemory_) {
+  other.buffer_ = VK_NULL_HANDLE;
+  other.bufferMemory_ = VK_NULL_HANDLE;
+}
+
+VBuffer& VBuffer::operator=(VBuffer&& other) noexcept {
+  if (this != &other) {
+    release();
+    bufferSizeBytes_ = other.bufferSizeBytes_;
+    bufferUsageFlags_ = other.bufferUsageFlags_;
+    descriptorType_ = other.descriptorType_;
+    buffer_ = other.buffer_;
+    bufferMemory_ = other.bufferMemory_;
+    other.buffer_ = VK_NULL_HANDLE;
+    other.bufferMemory_ = VK_NULL_HANDLE;
+  }
+  return *this;
+}
+
 VBuffer::~VBuffer() {
-  vkFreeMemory(context().device(), bufferMemory_, nullptr);
-  vkDestroyBuffer(context().device(), buffer_, nullptr);
+  release();
+}
+
+void VBuffer::release() {
+  if (buffer_ == VK_NULL_HANDLE) {
+    return;
+  }
+  context().bufferPool().release(
+      bufferSizeBytes_, bufferUsageFlags_, {buffer_, bufferMemory_});
+  buffer_ = VK_NULL_HANDLE;
+  bufferMemory_ = VK_NULL_HANDLE;
 }
 
 void VBuffer::copy_from_device_to_host(
@@ -962,20 +1057,62 @@ VBuffer makeUniformConstBuffer(const void* const ptr, const VkDeviceSize size) {
 
 ComputeUnitFactory::ComputeUnitFactory(const VkDevice device)
     : device_(device) {
+  // The driver checks the header of the data, and starts from an empty cache
+  // if it was saved by another device or driver version.
+  std::vector<char> initialData;
+  loadPipelineCacheData(initialData);
   VkPipelineCacheCreateInfo createInfo{};
   createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
   createInfo.pNext = nullptr;
   createInfo.flags = 0;
-  createInfo.initialDataSize = 0;
-  createInfo.pInitialData = nullptr;
+  createInfo.initialDataSize = initialData.size();
+  createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
   VK_CHECK(vkCreatePipelineCache(
       device_, &createInfo, nullptr /* allocator */, &pipelineCache_));
 }
 
 ComputeUnitFactory::~ComputeUnitFactory() {
+  savePipelineCacheData();
   vkDestroyPipelineCache(device_, pipelineCache_, nullptr /* allocator */);
 }
 
+void ComputeUnitFactory::loadPipelineCacheData(std::vector<char>& data) const {
+  const char* const path = std::getenv("PYTORCH_VULKAN_PIPELINE_CACHE");
+  if (!path) {
+    return;
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return;
+  }
+  data.assign(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void ComputeUnitFactory::savePipelineCacheData() const {
+  const char* const path = std::getenv("PYTORCH_VULKAN_PIPELINE_CACHE");
+  if (!path) {
+    return;
+  }
+  size_t size = 0;
+  if (vkGetPipelineCacheData(device_, pipelineCache_, &size, nullptr) !=
+          VK_SUCCESS ||
+      size == 0) {
+    return;
+  }
+  std::vector<char> data(size);
+  if (vkGetPipelineCacheData(device_, pipelineCache_, &size, data.data()) !=
+      VK_SUCCESS) {
+    return;
+  }
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    TORCH_WARN("Vulkan: Failed to save the pipeline cache to ", path);
+    return;
+  }
+  file.write(data.data(), size);
+}
+
 std::string ComputeUnitFactory::getCacheKey(
     const char* const key,
     const WorkGroupSize workGroupSize) {
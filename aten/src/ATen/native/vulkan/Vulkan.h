@@ -3,7 +3,9 @@
 #include <c10/util/Optional.h>
 #include <array>
 #include <cstring>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #ifdef USE_VULKAN_WRAPPER
@@ -147,6 +149,39 @@ class VulkanTensor final {
 };
 
 class ComputeUnitFactory;
+
+// Keeps the VkBuffers of destroyed VBuffers with their device memory, to be
+// reused by the next VBuffers of the same size and usage instead of
+// allocating device memory for each of them. Ops wait for their command
+// buffers to complete, so a released buffer is no longer used by the device.
+// At most kMaxCachedBytes are kept, the rest are freed.
+class VBufferPool final {
+ public:
+  struct Entry {
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+  };
+
+  explicit VBufferPool(VkDevice device) : device_(device) {}
+  ~VBufferPool();
+  VBufferPool(const VBufferPool&) = delete;
+  VBufferPool& operator=(const VBufferPool&) = delete;
+
+  // Returns false if there is no free buffer of this size and usage.
+  bool acquire(VkDeviceSize size, VkBufferUsageFlags usage, Entry* entry);
+  void release(VkDeviceSize size, VkBufferUsageFlags usage, Entry entry);
+  void purge();
+
+ private:
+  static constexpr VkDeviceSize kMaxCachedBytes = 64 * 1024 * 1024;
+
+  VkDevice device_;
+  std::mutex mutex_;
+  std::map<std::pair<VkDeviceSize, VkBufferUsageFlags>, std::vector<Entry>>
+      free_;
+  VkDeviceSize cachedBytes_ = 0;
+};
+
 class VContext final {
  public:
   explicit VContext(bool enableValidationLayers);
@@ -174,6 +209,9 @@ class VContext final {
   ComputeUnitFactory& computeUnitFactory() const {
     return *(computeUnitFactory_.get());
   }
+  VBufferPool& bufferPool() const {
+    return *(bufferPool_.get());
+  }
 
  private:
   void createInstance();
@@ -192,6 +230,7 @@ class VContext final {
   bool enableValidationLayers_;
   VkCommandPool commandPool_;
   std::unique_ptr<ComputeUnitFactory> computeUnitFactory_;
+  std::unique_ptr<VBufferPool> bufferPool_;
 };
 
 class VBuffer final {
@@ -243,8 +282,8 @@ class VBuffer final {
 
   VBuffer(const VBuffer&) = delete;
   VBuffer& operator=(const VBuffer&) = delete;
-  VBuffer(VBuffer&&) = default;
-  VBuffer& operator=(VBuffer&&) = default;
+  VBuffer(VBuffer&& other) noexcept;
+  VBuffer& operator=(VBuffer&& other) noexcept;
 
   static inline VBuffer makeUniformBuffer(const VkDeviceSize bufferSize) {
     return VBuffer{bufferSize,
@@ -282,10 +321,13 @@ class VBuffer final {
   }
 
  private:
+  void release();
+
   VkDeviceSize bufferSizeBytes_;
+  VkBufferUsageFlags bufferUsageFlags_;
   VkDescriptorType descriptorType_;
-  VkBuffer buffer_;
-  VkDeviceMemory bufferMemory_;
+  VkBuffer buffer_ = VK_NULL_HANDLE;
+  VkDeviceMemory bufferMemory_ = VK_NULL_HANDLE;
 };
 
 VBuffer makeUniformConstBuffer(const void* ptr, VkDeviceSize size);
@@ -517,6 +559,12 @@ class ComputeUnitFactory {
       const std::string& cacheKey,
       std::function<std::shared_ptr<ComputeUnit>()> factoryFn);
 
+  // The pipeline cache is loaded from and saved to the file named by the
+  // PYTORCH_VULKAN_PIPELINE_CACHE environment variable, if it is set, so that
+  // the shaders aren't compiled again by the driver on every run.
+  void loadPipelineCacheData(std::vector<char>& data) const;
+  void savePipelineCacheData() const;
+
   VkDevice device_;
   VkPipelineCache pipelineCache_;
   std::unordered_map<std::string, std::shared_ptr<ComputeUnit>> computeUnits_;
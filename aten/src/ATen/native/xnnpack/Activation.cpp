@@ -0,0 +1,108 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// Supports contiguous FP32 inputs of any shape, as batches of single
+// elements.
+bool use_elementwise(const Tensor& input) {
+  return xnnpack::internal::available() &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      !input.has_names() &&
+      input.is_contiguous() &&
+      (input.numel() > 0) &&
+      true;
+}
+
+Tensor run_unary(
+    const Tensor& input,
+    xnn_status (*create)(size_t, size_t, size_t, uint32_t, xnn_operator_t*),
+    xnn_status (*setup)(xnn_operator_t, size_t, const float*, float*, pthreadpool_t),
+    const char* name) {
+  using namespace internal;
+
+  const Tensor padded_input = allocate_padded_contiguous_if_needed(
+      input, MemoryFormat::Contiguous);
+
+  Tensor output = empty_with_tail_padding(
+      padded_input.sizes(),
+      padded_input.options().dtype(),
+      MemoryFormat::Contiguous,
+      padded_input.names());
+
+  xnn_operator_t unary_op{};
+
+  const xnn_status create_status = create(
+      1u,               // channels
+      1u,               // input_stride
+      1u,               // output_stride
+      0u,               // flags
+      &unary_op);       // operator
+
+  Operator unary_scoped_op(unary_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nc_f32 failed!");
+
+  const xnn_status setup_status = setup(
+      unary_op,                         // operator
+      padded_input.numel(),             // batch_size
+      padded_input.data_ptr<float>(),   // input
+      output.data_ptr<float>(),         // output
+      internal::threadpool());          // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      unary_op,                 // operator
+      internal::threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output;
+}
+
+} // namespace
+
+bool use_hardswish(const Tensor& input) {
+  return use_elementwise(input);
+}
+
+Tensor hardswish(const Tensor& input) {
+  return run_unary(
+      input,
+      xnn_create_hardswish_nc_f32,
+      xnn_setup_hardswish_nc_f32,
+      "hardswish");
+}
+
+bool use_sigmoid(const Tensor& input) {
+  return use_elementwise(input);
+}
+
+Tensor sigmoid(const Tensor& input) {
+  return run_unary(
+      input,
+      xnn_create_sigmoid_nc_f32,
+      xnn_setup_sigmoid_nc_f32,
+      "sigmoid");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
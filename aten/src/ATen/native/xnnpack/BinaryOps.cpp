@@ -0,0 +1,144 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/ExpandUtils.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace {
+
+// Supports contiguous FP32 operands of up to XNN_MAX_TENSOR_DIMS dimensions,
+// which XNNPACK broadcasts the way ATen does.
+bool use_binary(const Tensor& self, const Tensor& other) {
+  auto usable = [](const Tensor& input) {
+    return (c10::DeviceType::CPU == input.device().type()) &&
+        (kFloat == input.scalar_type()) &&
+        !input.requires_grad() &&
+        !input.has_names() &&
+        input.is_contiguous() &&
+        (input.dim() > 0) &&
+        (input.dim() <= XNN_MAX_TENSOR_DIMS);
+  };
+  if (!xnnpack::internal::available() || !usable(self) || !usable(other)) {
+    return false;
+  }
+  // Trailing dimensions must match, or be 1 in either of the operands.
+  for (int64_t i = 1; i <= std::min(self.dim(), other.dim()); ++i) {
+    const int64_t self_size = self.size(-i);
+    const int64_t other_size = other.size(-i);
+    if ((self_size != other_size) && (self_size != 1) && (other_size != 1)) {
+      return false;
+    }
+  }
+  return (self.numel() > 0) && (other.numel() > 0);
+}
+
+Tensor run_binary(
+    const Tensor& self,
+    const Tensor& other,
+    xnn_status (*create)(float, float, uint32_t, xnn_operator_t*),
+    xnn_status (*setup)(
+        xnn_operator_t,
+        size_t,
+        const size_t*,
+        size_t,
+        const size_t*,
+        const float*,
+        const float*,
+        float*,
+        pthreadpool_t),
+    const char* name) {
+  using namespace internal;
+
+  const Tensor padded_self = allocate_padded_contiguous_if_needed(
+      self, MemoryFormat::Contiguous);
+  const Tensor padded_other = allocate_padded_contiguous_if_needed(
+      other, MemoryFormat::Contiguous);
+
+  Tensor output = empty_with_tail_padding(
+      infer_size(padded_self.sizes(), padded_other.sizes()),
+      padded_self.options().dtype(),
+      MemoryFormat::Contiguous,
+      DimnameList{});
+
+  xnn_operator_t binary_op{};
+
+  const xnn_status create_status = create(
+      -std::numeric_limits<float>::infinity(),  // output_min
+      +std::numeric_limits<float>::infinity(),  // output_max
+      0u,                                       // flags
+      &binary_op);                              // operator
+
+  Operator binary_scoped_op(binary_op);
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_", name, "_nd_f32 failed!");
+
+  const std::vector<size_t> self_shape(
+      padded_self.sizes().cbegin(), padded_self.sizes().cend());
+  const std::vector<size_t> other_shape(
+      padded_other.sizes().cbegin(), padded_other.sizes().cend());
+
+  const xnn_status setup_status = setup(
+      binary_op,                        // operator
+      self_shape.size(),                // num_input1_dims
+      self_shape.data(),                // input1_shape
+      other_shape.size(),               // num_input2_dims
+      other_shape.data(),               // input2_shape
+      padded_self.data_ptr<float>(),    // input1
+      padded_other.data_ptr<float>(),   // input2
+      output.data_ptr<float>(),         // output
+      internal::threadpool());          // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_", name, "_nd_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      binary_op,                // operator
+      internal::threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output;
+}
+
+} // namespace
+
+bool use_add(const Tensor& self, const Tensor& other, const Scalar alpha) {
+  return use_binary(self, other) && (alpha.toDouble() == 1.0);
+}
+
+Tensor add(const Tensor& self, const Tensor& other) {
+  return run_binary(
+      self,
+      other,
+      xnn_create_add_nd_f32,
+      xnn_setup_add_nd_f32,
+      "add");
+}
+
+bool use_mul(const Tensor& self, const Tensor& other) {
+  return use_binary(self, other);
+}
+
+Tensor mul(const Tensor& self, const Tensor& other) {
+  return run_binary(
+      self,
+      other,
+      xnn_create_multiply_nd_f32,
+      xnn_setup_multiply_nd_f32,
+      "multiply");
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
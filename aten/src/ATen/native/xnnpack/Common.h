@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 
 #ifdef USE_XNNPACK
 
@@ -114,6 +115,13 @@ struct Layout final {
 
 bool available();
 
+// XNNPACK runs on caffe2's pthreadpool, which on mobile also runs ATen's
+// parallel_for. Inside a parallel region the pool is busy, and the operators
+// run on the calling thread instead.
+inline pthreadpool_t threadpool() {
+  return at::in_parallel_region() ? nullptr : caffe2::pthreadpool_();
+}
+
 } // namespace internal
 } // namespace xnnpack
 } // namespace native
@@ -208,7 +208,7 @@ Tensor run(
       padded_input_nhwc.size(Layout::Activation4D::width),   // input_width
       padded_input_nhwc.data_ptr<float>(),                   // input
       output.data_ptr<float>(),                              // output
-      caffe2::pthreadpool_());                               // threadpool
+      internal::threadpool());                               // threadpool
 
   TORCH_CHECK(
       xnn_status_success == setup_status,
@@ -216,7 +216,7 @@ Tensor run(
 
   const xnn_status run_status = xnn_run_operator(
       context.op.get(),         // operator
-      caffe2::pthreadpool_());  // threadpool
+      internal::threadpool());  // threadpool
 
   TORCH_INTERNAL_ASSERT(
       xnn_status_success == run_status,
@@ -66,6 +66,38 @@ Tensor max_pool2d(
     float output_min = -std::numeric_limits<float>::infinity(),
     float output_max = +std::numeric_limits<float>::infinity());
 
+//
+// Activations
+//
+
+bool use_hardswish(const Tensor& input);
+
+Tensor hardswish(const Tensor& input);
+
+bool use_sigmoid(const Tensor& input);
+
+Tensor sigmoid(const Tensor& input);
+
+//
+// Binary Ops
+//
+
+bool use_add(const Tensor& self, const Tensor& other, Scalar alpha);
+
+Tensor add(const Tensor& self, const Tensor& other);
+
+bool use_mul(const Tensor& self, const Tensor& other);
+
+Tensor mul(const Tensor& self, const Tensor& other);
+
+//
+// Channel Shuffle
+//
+
+bool use_channel_shuffle(const Tensor& input, int64_t groups);
+
+Tensor channel_shuffle(const Tensor& input, int64_t groups);
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
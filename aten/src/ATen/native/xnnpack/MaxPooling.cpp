@@ -221,7 +221,7 @@ Tensor max_pool2d(
       input_padded_contig_nhwc.size(Layout::Activation4D::width),   // input_width
       input_padded_contig_nhwc.data_ptr<float>(),                   // input
       output_padded_contig_nhwc.data_ptr<float>(),                  // output
-      caffe2::pthreadpool_());                                      // threadpool
+      internal::threadpool());                                      // threadpool
 
   TORCH_CHECK(
       xnn_status_success == setup_status,
@@ -229,7 +229,7 @@ Tensor max_pool2d(
 
   const xnn_status run_status = xnn_run_operator(
       max_pool_op,              // operator
-      caffe2::pthreadpool_());  // threadpool
+      internal::threadpool());  // threadpool
 
   TORCH_INTERNAL_ASSERT(
       xnn_status_success == run_status,
@@ -88,6 +88,46 @@ Tensor max_pool2d(
   TORCH_CHECK(false, internal::kError);
 }
 
+bool use_hardswish(const Tensor&) {
+  return false;
+}
+
+Tensor hardswish(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_sigmoid(const Tensor&) {
+  return false;
+}
+
+Tensor sigmoid(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_add(const Tensor&, const Tensor&, Scalar) {
+  return false;
+}
+
+Tensor add(const Tensor&, const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_mul(const Tensor&, const Tensor&) {
+  return false;
+}
+
+Tensor mul(const Tensor&, const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_channel_shuffle(const Tensor&, const int64_t) {
+  return false;
+}
+
+Tensor channel_shuffle(const Tensor&, const int64_t) {
+  TORCH_CHECK(false, internal::kError);
+}
+
 } // namespace xnnpack
 
 } // namespace native
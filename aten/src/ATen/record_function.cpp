@@ -18,25 +18,127 @@ RecordFunctionHandle next_unique_record_function_handle() {
   return RecordFunctionHandle(++unique_rf_id);
 }
 
-// Thread local vector of callbacks, holds pairs (callbacks, unique_id);
-// must be sorted in increasing handles order
-thread_local RecordFunctionCallbacks sorted_tls_callbacks_;
+// Number of global callbacks plus number of thread local callbacks
+// registered on all threads; when zero, RecordFunction skips everything
+// else (see shouldRunRecordFunction)
+std::atomic<int64_t> num_registered_callbacks_ {0};
+
+// Returns the probability with which at least one of the callbacks may
+// want to run for a range, 0 for an empty list; callbacks with should_run
+// count as always running
+double maxSamplingProb(const RecordFunctionCallbacks& cbs) {
+  double prob = 0.0;
+  for (const auto& cb : cbs) {
+    prob = std::max(
+        prob, cb.first.hasShouldRun() ? 1.0 : cb.first.samplingProb());
+  }
+  return prob;
+}
+
+struct ThreadLocalCallbacks {
+  ~ThreadLocalCallbacks() {
+    num_registered_callbacks_ -= callbacks.size();
+  }
+
+  // to be called after every change to the callbacks
+  void update(size_t old_size) {
+    num_registered_callbacks_ +=
+        static_cast<int64_t>(callbacks.size()) - static_cast<int64_t>(old_size);
+    sampling_prob = maxSamplingProb(callbacks);
+  }
+
+  // Holds pairs (callbacks, unique_id);
+  // must be sorted in increasing handles order
+  RecordFunctionCallbacks callbacks;
+  double sampling_prob = 0.0;
+};
+
+thread_local ThreadLocalCallbacks tls_callbacks_;
 
 std::atomic<int64_t> defaultNodeId(-1);
 
+// Low probability constant
+const double kLowProb = 0.001;
+thread_local int tries_left_ = 0;
+
+std::mt19937& thread_generator() {
+  static thread_local auto gen =
+      std::make_unique<std::mt19937>(std::random_device()());
+  return *gen;
+}
+
+int sample_geometric(double prob = kLowProb) {
+  std::geometric_distribution<int> dist(prob);
+  return dist(thread_generator());
+}
+
+double sample_zero_one() {
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  return dist(thread_generator());
+}
+
+// Picks events with a given probability, drawing a random number only
+// for the picked events: the number of events to skip before the next
+// picked one follows the geometric distribution
+struct SamplingCountdown {
+  bool sample(double prob) {
+    if (prob != prob_) {
+      prob_ = prob;
+      tries_left_ = sample_geometric(prob);
+    }
+    if (tries_left_ > 0) {
+      --tries_left_;
+      return false;
+    }
+    tries_left_ = sample_geometric(prob);
+    return true;
+  }
+
+ private:
+  double prob_ = 0.0;
+  int tries_left_ = 0;
+};
+
+// Decides whether any callback runs, see shouldRunRecordFunction
+thread_local SamplingCountdown gate_countdown_;
+
+// Countdowns of the sampled callbacks on this thread; entries of removed
+// callbacks are dropped by clearing all of them every now and then, which
+// does not bias the sampling since the geometric distribution is memoryless
+constexpr size_t kMaxCallbackCountdowns = 32;
+thread_local std::vector<std::pair<CallbackHandle, SamplingCountdown>>
+    callback_countdowns_;
+
+SamplingCountdown& callbackCountdown(CallbackHandle handle) {
+  for (auto& el : callback_countdowns_) {
+    if (el.first == handle) {
+      return el.second;
+    }
+  }
+  if (callback_countdowns_.size() >= kMaxCallbackCountdowns) {
+    callback_countdowns_.clear();
+  }
+  callback_countdowns_.emplace_back(handle, SamplingCountdown());
+  return callback_countdowns_.back().second;
+}
+
 class CallbackManager {
  public:
   CallbackHandle addThreadLocalCallback(RecordFunctionCallback cb) {
     // note: monotonically increasing callbacks_unique_id keeps
-    // sorted_tls_callbacks_ sorted
+    // tls_callbacks_.callbacks sorted
     auto handle = next_unique_callback_handle();
-    sorted_tls_callbacks_.emplace_back(std::move(cb), handle);
+    auto old_size = tls_callbacks_.callbacks.size();
+    tls_callbacks_.callbacks.emplace_back(std::move(cb), handle);
+    tls_callbacks_.update(old_size);
     return handle;
   }
 
   CallbackHandle addGlobalCallback(RecordFunctionCallback cb) {
     auto handle = next_unique_callback_handle();
     sorted_global_callbacks_.emplace_back(std::move(cb), handle);
+    ++num_registered_callbacks_;
+    updateGlobalSamplingProb();
     return handle;
   }
 
@@ -57,9 +159,16 @@ class CallbackManager {
       }
       return false;
     };
-    auto found = find_and_remove(sorted_tls_callbacks_);
-    if (!found) {
+    auto old_size = tls_callbacks_.callbacks.size();
+    auto found = find_and_remove(tls_callbacks_.callbacks);
+    if (found) {
+      tls_callbacks_.update(old_size);
+    } else {
       found = find_and_remove(sorted_global_callbacks_);
+      if (found) {
+        --num_registered_callbacks_;
+        updateGlobalSamplingProb();
+      }
     }
     if (!found) {
       LOG(WARNING) << "Requested callback is not found";
@@ -67,11 +176,23 @@ class CallbackManager {
   }
 
   void clearGlobalCallbacks() {
+    num_registered_callbacks_ -= sorted_global_callbacks_.size();
     sorted_global_callbacks_.clear();
+    updateGlobalSamplingProb();
   }
 
   void clearThreadLocalCallbacks() {
-    sorted_tls_callbacks_.clear();
+    auto old_size = tls_callbacks_.callbacks.size();
+    tls_callbacks_.callbacks.clear();
+    tls_callbacks_.update(old_size);
+  }
+
+  // Probability with which at least one of the global and thread local
+  // callbacks may want to run for a range
+  inline double samplingGateProb() const {
+    return std::max(
+        global_sampling_prob_.load(std::memory_order_relaxed),
+        tls_callbacks_.sampling_prob);
   }
 
   inline bool hasGlobalCallbacks() const {
@@ -79,23 +200,27 @@ class CallbackManager {
   }
 
   inline bool hasThreadLocalCallbacks() const {
-    return !sorted_tls_callbacks_.empty();
+    return !tls_callbacks_.callbacks.empty();
   }
 
   // init is called by RecordFunction in constructor to
   // determine which thread local and global callbacks are going
-  // to be executed and whether any of them need inputs
-  inline void init(RecordFunction& rec_fn) {
+  // to be executed and whether any of them need inputs;
+  // pre_sampled - whether shouldRunRecordFunction picked this range
+  // with the probability returned by samplingGateProb
+  inline void init(RecordFunction& rec_fn, bool pre_sampled) {
     auto scope = rec_fn.scope();
+    const double gate_prob = pre_sampled ? samplingGateProb() : 1.0;
     bool found_active_cb = false;
     bool found_needs_inputs = false;
     bool found_needs_ids = false;
     auto init_handles = [
-        scope, &found_active_cb, &found_needs_inputs, &found_needs_ids](
+        scope, pre_sampled, gate_prob,
+        &found_active_cb, &found_needs_inputs, &found_needs_ids](
           CallbackHandles& handles, RecordFunctionCallbacks& cbs) {
       handles.clear();
       for (const auto& cb : cbs) {
-        if (cb.first.shouldRun(scope)) {
+        if (shouldRunCallback(cb, scope, pre_sampled, gate_prob)) {
           handles.push_back(cb.second);
           found_active_cb = true;
           if (cb.first.needsInputs()) {
@@ -108,7 +233,7 @@ class CallbackManager {
       }
     };
 
-    init_handles(rec_fn.sorted_active_tls_handles_, sorted_tls_callbacks_);
+    init_handles(rec_fn.sorted_active_tls_handles_, tls_callbacks_.callbacks);
     init_handles(rec_fn.sorted_active_global_handles_, sorted_global_callbacks_);
     rec_fn.active = found_active_cb;
     rec_fn.needs_inputs = found_needs_inputs;
@@ -124,7 +249,7 @@ class CallbackManager {
         /* is_start */ true,
         rf);
     mergeRunCallbacks(
-        sorted_tls_callbacks_,
+        tls_callbacks_.callbacks,
         rf.sorted_active_tls_handles_,
         /* is_start */ true,
         rf);
@@ -138,13 +263,43 @@ class CallbackManager {
         /* is_start */ false,
         rf);
     mergeRunCallbacks(
-        sorted_tls_callbacks_,
+        tls_callbacks_.callbacks,
         rf.sorted_active_tls_handles_,
         /* is_start */ false,
         rf);
   }
 
  private:
+  static bool shouldRunCallback(
+      const std::pair<RecordFunctionCallback, CallbackHandle>& cb,
+      RecordScope scope,
+      bool pre_sampled,
+      double gate_prob) {
+    const auto& callback = cb.first;
+    if (!callback.checkScope(scope)) {
+      return false;
+    }
+    if (pre_sampled) {
+      // all the callbacks are sampled and the range was already picked
+      // with gate_prob >= callback.samplingProb()
+      const double prob = callback.samplingProb();
+      return prob >= gate_prob || sample_zero_one() < prob / gate_prob;
+    }
+    if (callback.hasShouldRun() || callback.samplingProb() == 1.0) {
+      return callback.shouldRun(scope);
+    }
+    if (callback.samplingProb() <= 0.0) {
+      return false;
+    }
+    return callbackCountdown(cb.second).sample(callback.samplingProb());
+  }
+
+  void updateGlobalSamplingProb() {
+    global_sampling_prob_.store(
+        maxSamplingProb(sorted_global_callbacks_),
+        std::memory_order_relaxed);
+  }
+
   bool tryRunCallback(
       const std::function<void(const RecordFunction&)>& fn,
       RecordFunction& rf) {
@@ -197,6 +352,7 @@ class CallbackManager {
 
   // Global callbacks; must be sorted in increasing handle order
   RecordFunctionCallbacks sorted_global_callbacks_;
+  std::atomic<double> global_sampling_prob_ {0.0};
 };
 
 // Enumerates thread ids logically;
@@ -212,24 +368,6 @@ inline CallbackManager& manager() {
 
 thread_local bool tls_record_function_enabled_ = true;
 
-// Low probability constant
-const double kLowProb = 0.001;
-thread_local int tries_left_ = 0;
-
-int sample_geometric() {
-  static thread_local auto gen =
-      std::make_unique<std::mt19937>(std::random_device()());
-  std::geometric_distribution<int> dist(kLowProb);
-  return dist(*gen);
-}
-
-double sample_zero_one() {
-  static thread_local auto gen =
-      std::make_unique<std::mt19937>(std::random_device()());
-  std::uniform_real_distribution<double> dist(0.0, 1.0);
-  return dist(*gen);
-}
-
 } // namespace
 
 bool RecordFunctionCallback::shouldRun(RecordScope scope) const {
@@ -265,19 +403,21 @@ bool RecordFunctionCallback::shouldRun(RecordScope scope) const {
 }
 
 RecordFunctionCallbacks _getTLSCallbacks() {
-  return sorted_tls_callbacks_;
+  return tls_callbacks_.callbacks;
 }
 
 void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
   // keep the original handles
-  sorted_tls_callbacks_ = callbacks;
+  auto old_size = tls_callbacks_.callbacks.size();
+  tls_callbacks_.callbacks = callbacks;
   std::sort(
-      sorted_tls_callbacks_.begin(),
-      sorted_tls_callbacks_.end(),
+      tls_callbacks_.callbacks.begin(),
+      tls_callbacks_.callbacks.end(),
       [](const std::pair<RecordFunctionCallback, CallbackHandle>& l,
           const std::pair<RecordFunctionCallback, CallbackHandle>& r) {
         return l.second < r.second;
   });
+  tls_callbacks_.update(old_size);
 }
 
 bool hasCallbacks() {
@@ -329,9 +469,28 @@ void enableRecordFunction(bool enable) {
   tls_record_function_enabled_ = enable;
 }
 
-RecordFunction::RecordFunction(RecordScope scope) : scope_(scope) {
-  if (hasCallbacks() && isRecordFunctionEnabled()) {
-    manager().init(*this);
+bool shouldRunRecordFunction(bool* pre_sampled) {
+  *pre_sampled = false;
+  if (num_registered_callbacks_.load(std::memory_order_relaxed) == 0 ||
+      !tls_record_function_enabled_) {
+    return false;
+  }
+  const double prob = manager().samplingGateProb();
+  if (prob >= 1.0) {
+    return true;
+  }
+  if (prob <= 0.0) {
+    // only other threads have callbacks
+    return false;
+  }
+  *pre_sampled = gate_countdown_.sample(prob);
+  return *pre_sampled;
+}
+
+RecordFunction::RecordFunction(RecordScope scope, bool pre_sampled)
+    : scope_(scope) {
+  if (pre_sampled || shouldRunRecordFunction(&pre_sampled)) {
+    manager().init(*this, pre_sampled);
   }
 }
 
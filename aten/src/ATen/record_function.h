@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/core/ivalue.h>
+#include <c10/core/DispatchKey.h>
 #include <c10/util/SmallVector.h>
 #include <c10/macros/Export.h>
 #include <memory>
@@ -81,8 +82,11 @@ typedef uint64_t RecordFunctionHandle;
 struct TORCH_API RecordFunction {
   // Default constructor is used with before function called afterwards:
   //  scope - record scope that this function tracks
+  //  pre_sampled - whether shouldRunRecordFunction returned true and set
+  //    its pre_sampled argument for this range
   RecordFunction(
-      RecordScope scope = RecordScope::FUNCTION);
+      RecordScope scope = RecordScope::FUNCTION,
+      bool pre_sampled = false);
 
   template <typename F>
   void before(
@@ -122,6 +126,17 @@ struct TORCH_API RecordFunction {
     return scope_;
   }
 
+  // Dispatch key the op call recorded by this range was dispatched to,
+  // Undefined for the ranges that aren't op calls
+  inline c10::DispatchKey dispatchKey() const {
+    return dispatch_key_;
+  }
+
+  // Set by the dispatcher before calling before()
+  inline void setDispatchKey(c10::DispatchKey dispatch_key) {
+    dispatch_key_ = dispatch_key;
+  }
+
   // Returns logical thread_id for the current thread
   static uint64_t currentThreadId();
 
@@ -190,6 +205,8 @@ struct TORCH_API RecordFunction {
   // Kind of scope this RecordFunction is observing
   const RecordScope scope_;
 
+  c10::DispatchKey dispatch_key_ = c10::DispatchKey::Undefined;
+
   // The logical thread_id that this RecordFunction was created with
   uint64_t thread_id_ = 0;
 
@@ -276,6 +293,10 @@ class TORCH_API RecordFunctionCallback {
     return sampling_prob_;
   }
 
+  inline bool hasShouldRun() const {
+    return (bool)should_run_;
+  }
+
   inline bool checkScope(RecordScope sc) const {
     return scopes_[(size_t)sc];
   }
@@ -406,6 +427,17 @@ TORCH_API void clearGlobalCallbacks();
 
 // for both thread local and global callbacks
 TORCH_API bool hasCallbacks();
+
+/**
+ * shouldRunRecordFunction returns whether a RecordFunction created on this
+ * thread may run callbacks; hot paths check it before constructing one.
+ * The check is a single relaxed atomic load when no callbacks are
+ * registered on any thread. When all the callbacks are sampled, it also
+ * does the sampling, using a thread local countdown instead of a random
+ * number per range, and sets pre_sampled if the range is picked; pass
+ * pre_sampled to the RecordFunction constructor then.
+ */
+TORCH_API bool shouldRunRecordFunction(bool* pre_sampled);
 TORCH_API void clearCallbacks(); // not thread safe
 
 /**
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <ATen/Utils.h>
 #include <ATen/CPUGeneratorImpl.h>
 #include <ATen/core/PhiloxRNGEngine.h>
@@ -200,6 +201,64 @@ TEST(CPUGeneratorImpl, TestPhiloxEngineIndex) {
   ASSERT_NE(engine1(), engine2());
 }
 
+TEST(CPUGeneratorImpl, TestPhiloxModeOffset) {
+  // Test Description:
+  //   Check that the philox mode reserves the offsets of the kernels
+  //   and restarts from offset 0 when seeded.
+  //   See Note [Parallel CPU random generation]
+  auto gen = at::detail::createCPUGenerator(123);
+  auto cpu_gen = check_generator<CPUGeneratorImpl>(gen);
+  ASSERT_FALSE(cpu_gen->philox_mode());
+  cpu_gen->set_philox_mode(true);
+  auto inputs = cpu_gen->philox_engine_inputs(10);
+  ASSERT_EQ(inputs.first, 123);
+  ASSERT_EQ(inputs.second, 0);
+  ASSERT_EQ(cpu_gen->philox_offset(), 10);
+  auto x = at::empty({1000}).uniform_(0, 1, gen);
+  ASSERT_EQ(cpu_gen->philox_offset(), 1010);
+  auto clone = check_generator<CPUGeneratorImpl>(gen.clone());
+  ASSERT_TRUE(clone->philox_mode());
+  ASSERT_EQ(clone->philox_offset(), 1010);
+  cpu_gen->set_current_seed(123);
+  ASSERT_EQ(cpu_gen->philox_offset(), 0);
+}
+
+TEST(CPUGeneratorImpl, TestPhiloxModeReproducibility) {
+  // Test Description:
+  //   Check that the results of the philox mode don't depend on the
+  //   number of threads, and that consecutive calls give different results.
+  //   See Note [Parallel CPU random generation]
+  auto sample = [](int num_threads) {
+    at::set_num_threads(num_threads);
+    auto gen = at::detail::createCPUGenerator(42);
+    check_generator<CPUGeneratorImpl>(gen)->set_philox_mode(true);
+    std::vector<Tensor> results;
+    results.push_back(at::empty({100003}).normal_(0, 1, gen));
+    results.push_back(at::empty({100003}, at::kDouble).normal_(0, 1, gen));
+    results.push_back(at::empty({317, 211}).t().normal_(1, 2, gen));
+    results.push_back(at::empty({100003}).uniform_(-1, 1, gen));
+    results.push_back(at::empty({100003}).bernoulli_(0.3, gen));
+    results.push_back(at::empty({100003}).bernoulli_(at::full({100003}, 0.7), gen));
+    return results;
+  };
+  const int num_threads = at::get_num_threads();
+  auto serial = sample(1);
+  auto parallel = sample(4);
+  at::set_num_threads(num_threads);
+  for (size_t i = 0; i < serial.size(); ++i) {
+    ASSERT_TRUE(at::equal(serial[i], parallel[i]));
+  }
+  ASSERT_FALSE(at::equal(serial[0], serial[3]));
+  auto normal = serial[0];
+  ASSERT_NEAR(normal.mean().item<double>(), 0, 0.02);
+  ASSERT_NEAR(normal.std().item<double>(), 1, 0.02);
+  auto uniform = serial[3];
+  ASSERT_GE(uniform.min().item<double>(), -1);
+  ASSERT_LT(uniform.max().item<double>(), 1);
+  ASSERT_NEAR(serial[4].mean().item<double>(), 0.3, 0.01);
+  ASSERT_NEAR(serial[5].mean().item<double>(), 0.7, 0.01);
+}
+
 /**
  * MT19937 CPU Engine Tests
  */
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <ATen/cuda/Autotune.h>
+#include <ATen/cuda/CUDAContext.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace at::cuda::autotune;
+
+namespace {
+
+// Restores the global autotuning state on exit.
+struct AutotuneGuard {
+  AutotuneGuard() : was_enabled(enabled()) {
+    clear_cache();
+  }
+  ~AutotuneGuard() {
+    set_enabled(was_enabled);
+    clear_cache();
+  }
+  bool was_enabled;
+};
+
+} // namespace
+
+TEST(TestAutotune, Configs) {
+  TunableOp op("test_configs", {{"a", {1, 2}}, {"b", {10, 20, 30}}});
+  ASSERT_EQ(op.configs().size(), 6);
+  ASSERT_EQ(op.configs()[0], Config({1, 10}));
+  ASSERT_EQ(op.configs()[1], Config({1, 20}));
+  ASSERT_EQ(op.configs()[5], Config({2, 30}));
+}
+
+TEST(TestAutotune, Registration) {
+  auto& op = registerTunableOp("test_registration", {{"block_size", {256, 128}}});
+  ASSERT_EQ(&registerTunableOp("test_registration", {{"block_size", {256, 128}}}), &op);
+  ASSERT_ANY_THROW(registerTunableOp("test_registration", {{"block_size", {128}}}));
+}
+
+TEST(TestAutotune, Disabled) {
+  if (!at::cuda::is_available()) return;
+  AutotuneGuard guard;
+  set_enabled(false);
+  TunableOp op("test_disabled", {{"block_size", {256, 128, 512}}});
+  std::vector<Config> launched;
+  const auto config = op.run({4, 100}, at::kFloat, [&](const Config& c) {
+    launched.push_back(c);
+  });
+  ASSERT_EQ(config, Config({256}));
+  ASSERT_EQ(launched, std::vector<Config>({Config({256})}));
+}
+
+TEST(TestAutotune, TunesOncePerBucket) {
+  if (!at::cuda::is_available()) return;
+  AutotuneGuard guard;
+  set_enabled(true);
+  TunableOp op("test_buckets", {{"block_size", {256, 128, 512}}});
+  int launches = 0;
+  auto launch = [&](const Config& c) {
+    // The default configuration doesn't fit this kernel
+    if (c[0] == 256) {
+      TORCH_CHECK(false, "too many threads");
+    }
+    launches++;
+  };
+  const auto config = op.run({4, 100}, at::kFloat, launch);
+  ASSERT_NE(config[0], 256);
+  ASSERT_GT(launches, 1);
+
+  // 4 x 100 and 3 x 120 share the 4 x 128 bucket
+  launches = 0;
+  ASSERT_EQ(op.run({3, 120}, at::kFloat, launch), config);
+  ASSERT_EQ(launches, 1);
+
+  // Another dtype is tuned separately
+  launches = 0;
+  op.run({3, 120}, at::kHalf, launch);
+  ASSERT_GT(launches, 1);
+}
+
+TEST(TestAutotune, SaveAndLoad) {
+  if (!at::cuda::is_available()) return;
+  AutotuneGuard guard;
+  set_enabled(true);
+  TunableOp op("test_save_and_load", {{"block_size", {256, 128}}});
+  const auto config = op.run({8, 8}, at::kFloat, [](const Config&) {});
+
+  const std::string path = testing::TempDir() + "cuda_autotune_test_cache";
+  save_cache(path);
+  clear_cache();
+  ASSERT_EQ(load_cache(path), 1);
+  // Loaded configurations are used without benchmarking
+  int launches = 0;
+  ASSERT_EQ(op.run({8, 8}, at::kFloat, [&](const Config&) { launches++; }), config);
+  ASSERT_EQ(launches, 1);
+  // and don't replace the ones already known
+  ASSERT_EQ(load_cache(path), 0);
+  std::remove(path.c_str());
+  ASSERT_EQ(load_cache(path), 0);
+}
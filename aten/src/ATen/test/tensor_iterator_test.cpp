@@ -210,3 +210,27 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   config.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(config.build());
 }
+
+// Building iterators with identical geometry repeatedly goes through the plan
+// cache; the result must match what the first build computed.
+TEST(TensorIteratorTest, CachedPlanMatchesFirstBuild) {
+  std::vector<std::pair<Tensor, Tensor>> inputs = {
+    {at::randn({3, 4}).t(), at::randn({3})},
+    {at::randn({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast),
+     at::randn({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast)},
+    {at::randn({2, 3}), at::randn({3, 2}).t()},
+    {at::randn({3, 2}), at::randn({3, 2})},
+  };
+  for (auto& in : inputs) {
+    Tensor out0, out1;
+    auto iter0 = TensorIterator::binary_op(out0, in.first, in.second);
+    auto iter1 = TensorIterator::binary_op(out1, in.first, in.second);
+    ASSERT_EQ(iter0.shape(), iter1.shape());
+    for (int i = 0; i < iter0.ntensors(); i++) {
+      ASSERT_EQ(iter0.strides(i), iter1.strides(i));
+    }
+    ASSERT_EQ(iter0.output().sizes(), iter1.output().sizes());
+    ASSERT_EQ(iter0.output().strides(), iter1.output().strides());
+    ASSERT_NE(iter0.output().data_ptr(), iter1.output().data_ptr());
+  }
+}
@@ -4,9 +4,11 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
 #include <iostream>
 #include <string.h>
 #include <sstream>
+#include <vector>
 
 using namespace at;
 
@@ -36,6 +38,99 @@ TEST(TestParallel, NestedParallel) {
   });
 }
 
+TEST(TestParallel, UnevenWork) {
+  // The cost per element grows with the index; every element must still be
+  // visited exactly once, and thread numbers must stay below get_num_threads().
+  const int64_t n = 4096;
+  std::vector<std::atomic<int>> visits(n);
+  std::atomic<bool> bad_thread_num{false};
+  at::parallel_for(0, n, 1, [&](int64_t begin, int64_t end) {
+    if (at::get_thread_num() >= at::get_num_threads()) {
+      bad_thread_num = true;
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      volatile int64_t sink = 0;
+      for (int64_t j = 0; j < i; ++j) {
+        sink += j;
+      }
+      visits[i]++;
+    }
+  });
+  ASSERT_FALSE(bad_thread_num);
+  for (int64_t i = 0; i < n; ++i) {
+    ASSERT_EQ(visits[i], 1);
+  }
+}
+
+TEST(TestParallel, NestedParallelFor) {
+  const int64_t outer = 8;
+  const int64_t inner = 1000;
+  std::vector<std::atomic<int>> visits(outer * inner);
+  at::parallel_for(0, outer, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      int thread_num = at::get_thread_num();
+      at::parallel_for(0, inner, 1, [&](int64_t b, int64_t e) {
+        for (int64_t j = b; j < e; ++j) {
+          visits[i * inner + j]++;
+        }
+      });
+      // The enclosing region's thread number survives the nested one.
+      ASSERT_EQ(at::get_thread_num(), thread_num);
+      ASSERT_TRUE(at::in_parallel_region());
+    }
+  });
+  for (int64_t i = 0; i < outer * inner; ++i) {
+    ASSERT_EQ(visits[i], 1);
+  }
+}
+
+TEST(TestParallel, ParallelReduce) {
+  const int64_t n = 100000;
+  int64_t sum = at::parallel_reduce(0, n, 1, (int64_t)0,
+    [](int64_t begin, int64_t end, int64_t ident) {
+      int64_t partial = ident;
+      for (int64_t i = begin; i < end; ++i) {
+        partial += i;
+      }
+      return partial;
+    },
+    [](int64_t a, int64_t b) { return a + b; });
+  ASSERT_EQ(sum, n * (n - 1) / 2);
+}
+
+TEST(TestParallel, ThreadBudget) {
+  at::set_thread_budget(4);
+  {
+    // The calling thread takes one slot, leaving three helpers.
+    at::internal::ThreadBudgetGuard outer(8);
+    ASSERT_EQ(outer.helpers(), 3);
+    {
+      // Nested regions on the same thread are not charged for the caller
+      // again, and the budget is used up.
+      at::internal::ThreadBudgetGuard inner(8);
+      ASSERT_EQ(inner.helpers(), 0);
+    }
+  }
+  {
+    at::internal::ThreadBudgetGuard guard(2);
+    ASSERT_EQ(guard.helpers(), 2);
+  }
+
+  // Parallel work still covers the whole range under a tight budget.
+  at::set_thread_budget(1);
+  std::atomic<int64_t> sum{0};
+  at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      sum += i;
+    }
+  });
+  ASSERT_EQ(sum, 999 * 1000 / 2);
+
+  at::set_thread_budget(0);
+  at::internal::ThreadBudgetGuard unlimited(8);
+  ASSERT_EQ(unlimited.helpers(), 8);
+}
+
 TEST(TestParallel, Exceptions) {
   // parallel case
   ASSERT_THROW(
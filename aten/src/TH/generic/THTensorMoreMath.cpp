@@ -30,6 +30,9 @@ ptrdiff_t THTensor_(numel)(THTensor *t)
 */
 #define MAX_LEVELS  300
 #define M_SMALL 10 /* Limit for small subfiles */
+/* Slices are sorted by several threads when there are fewer of them than
+   threads and they have at least twice this many elements. */
+#define PARALLEL_SORT_MIN_CHUNK 32768
 
 #define ARR(III) arr[(III)*stride]
 #define IDX(III) idx[(III)*stride]
@@ -227,6 +230,68 @@ static void THTensor_(quicksortdescend)(scalar_t *arr, int64_t *idx, int64_t ele
   }
 }
 
+/* Sorts a single long slice with all threads: every thread sorts chunks of
+   it with the quicksort above, then the sorted runs are merged pairwise.
+   idx must already hold the positions of the elements. */
+static void THTensor_(parallelsort)(scalar_t *arr, int64_t *idx, int64_t elements, int64_t stride, int descendingOrder)
+{
+  int64_t num_chunks = std::min<int64_t>(at::get_num_threads(), elements / PARALLEL_SORT_MIN_CHUNK);
+  int64_t chunk_size = at::divup(elements, num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t start = c * chunk_size;
+      int64_t n = std::min(chunk_size, elements - start);
+      if (n <= 0) {
+        continue;
+      }
+      if (descendingOrder) {
+        THTensor_(quicksortdescend)(arr + start * stride, idx + start * stride, n, stride);
+      } else {
+        THTensor_(quicksortascend)(arr + start * stride, idx + start * stride, n, stride);
+      }
+    }
+  });
+
+  std::vector<scalar_t> tmp_arr(elements);
+  std::vector<int64_t> tmp_idx(elements);
+  for (int64_t width = chunk_size; width < elements; width *= 2) {
+    int64_t num_merges = at::divup(elements, 2 * width);
+    at::parallel_for(0, num_merges, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t m = begin; m < end; m++) {
+        int64_t lo = m * 2 * width;
+        int64_t mid = std::min(lo + width, elements);
+        int64_t hi = std::min(lo + 2 * width, elements);
+        int64_t i = lo, j = mid, o = lo;
+        while (i < mid && j < hi) {
+          /* Ties are taken from the left run. */
+          bool right_first = descendingOrder
+              ? GT_OR_NAN(ARR(j), ARR(i))
+              : GT_OR_NAN(ARR(i), ARR(j));
+          if (right_first) {
+            tmp_arr[o] = ARR(j);
+            tmp_idx[o++] = IDX(j++);
+          } else {
+            tmp_arr[o] = ARR(i);
+            tmp_idx[o++] = IDX(i++);
+          }
+        }
+        for (; i < mid; i++, o++) {
+          tmp_arr[o] = ARR(i);
+          tmp_idx[o] = IDX(i);
+        }
+        for (; j < hi; j++, o++) {
+          tmp_arr[o] = ARR(j);
+          tmp_idx[o] = IDX(j);
+        }
+        for (o = lo; o < hi; o++) {
+          ARR(o) = tmp_arr[o];
+          IDX(o) = tmp_idx[o];
+        }
+      }
+    });
+  }
+}
+
 #undef MAX_LEVELS
 #undef M_SMALL
 
@@ -242,13 +307,20 @@ void THTensor_(sort)(THTensor *rt_, THLongTensor *ri_, THTensor *t, int dimensio
   at::native::copy_(rt__wrap, t_wrap);
   THLongTensor_resize(ri_, t->sizes(), {});
 
+  int64_t sort_size = THTensor_sizeLegacyNoScalars(t, dimension);
+  int64_t num_slices = sort_size > 0 ? THTensor_(nElement)(t) / sort_size : 0;
+  bool parallel = sort_size >= 2 * PARALLEL_SORT_MIN_CHUNK && num_slices < at::get_num_threads();
+
   if(descendingOrder)
   {
     TH_TENSOR_DIM_APPLY2(scalar_t, rt_, int64_t, ri_, dimension,
                          int64_t i;
                          for(i = 0; i < ri__size; i++)
                            ri__data[i*ri__stride] = i;
-                         THTensor_(quicksortdescend)(rt__data, ri__data, rt__size, rt__stride);)
+                         if (parallel)
+                           THTensor_(parallelsort)(rt__data, ri__data, rt__size, rt__stride, descendingOrder);
+                         else
+                           THTensor_(quicksortdescend)(rt__data, ri__data, rt__size, rt__stride);)
       }
   else
   {
@@ -256,10 +328,15 @@ void THTensor_(sort)(THTensor *rt_, THLongTensor *ri_, THTensor *t, int dimensio
                          int64_t i;
                          for(i = 0; i < ri__size; i++)
                            ri__data[i*ri__stride] = i;
-                         THTensor_(quicksortascend)(rt__data, ri__data, rt__size, rt__stride);)
+                         if (parallel)
+                           THTensor_(parallelsort)(rt__data, ri__data, rt__size, rt__stride, descendingOrder);
+                         else
+                           THTensor_(quicksortascend)(rt__data, ri__data, rt__size, rt__stride);)
       }
 }
 
+#undef PARALLEL_SORT_MIN_CHUNK
+
 #endif
 
 #if !defined(TH_REAL_IS_BFLOAT16) && !defined(TH_REAL_IS_HALF)
@@ -4,17 +4,58 @@
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <deque>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
+constexpr size_t kMinBlockSize = 512; // smallest pinned block, in bytes
+// how often the background thread polls the events of freed blocks
+constexpr std::chrono::milliseconds kPollInterval(1);
+
+// Rounds a request up to one of four size classes per power of two, so that
+// a block is at most 25% larger than the request it serves.
+size_t roundSize(size_t size)
+{
+  if (size <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  size_t power = kMinBlockSize;
+  while (power < size / 2 + size % 2) {
+    power *= 2;
+  }
+  // size is in (power, 2 * power]
+  size_t step = power / 4;
+  return (size + step - 1) / step * step;
+}
+
+// Pinned memory pointers allocated by any device can be directly used by any
+// other device, regardless of the current device at the time of allocation,
+// since we assume unified addressing.
+// So we grab any existing primary context, if available.
+// See pytorch/pytorch#21081.
+void usePrimaryContext(at::OptionalDeviceGuard& device_guard)
+{
+  auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
+  if (primary_ctx_device_index.has_value()) {
+    device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
+  }
+}
+
 struct BlockSize
 {
   size_t  size; // allocation size
@@ -58,7 +99,37 @@ struct HostAllocator
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
-  HostAllocator() : available(BlockComparator) {}
+  THCCachingHostAllocatorStats stats;
+
+  // bytes of the blocks in 'available'
+  size_t cached_bytes = 0;
+  size_t cache_limit = std::numeric_limits<size_t>::max();
+
+  // background thread that processes cuda_events and enforces cache_limit
+  std::thread poller;
+  std::condition_variable poller_cv;
+  bool stop_poller = false;
+  // set when the poller failed to query an event; the error is reported by
+  // the next malloc or free, and the poller waits for new events
+  bool poll_failed = false;
+
+  HostAllocator() : available(BlockComparator) {
+    const char* limit_mb = std::getenv("PYTORCH_CUDA_HOST_CACHE_LIMIT_MB");
+    if (limit_mb) {
+      cache_limit = std::strtoull(limit_mb, nullptr, 10) << 20;
+    }
+  }
+
+  ~HostAllocator() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop_poller = true;
+    }
+    poller_cv.notify_all();
+    if (poller.joinable()) {
+      poller.join();
+    }
+  }
 
   cudaError_t malloc(void** ptr, size_t size)
   {
@@ -70,30 +141,31 @@ struct HostAllocator
       return err;
     }
 
-    // search for the smallest block which can hold this allocation
+    stats.num_allocs++;
+    if (size == 0) {
+      *ptr = nullptr;
+      return cudaSuccess;
+    }
+    size = roundSize(size);
+
+    // search for a cached block of the same size class
     BlockSize search_key(size);
     auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
+    if (it != available.end() && it->size == size) {
       Block& block = blocks.at(it->ptr);
       THAssert(!block.allocated && block.event_count == 0);
       block.allocated = true;
       *ptr = block.ptr;
       available.erase(it);
+      cached_bytes -= size;
+      stats.num_cache_hits++;
+      addAllocated(size);
       return cudaSuccess;
     }
 
-    // Pinned memory pointers allocated by any device can be directly used by any
-    // other device, regardless of the current device at the time of allocation,
-    // since we assume unified addressing.
-    // So we grab any existing primary context, if available.
-    // See pytorch/pytorch#21081.
     at::OptionalDeviceGuard device_guard;
-    auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
-    if (primary_ctx_device_index.has_value()) {
-      device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
-    }
+    usePrimaryContext(device_guard);
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
     *ptr = 0;
 
     // allocate a new block if no cached allocation is found
@@ -103,6 +175,10 @@ struct HostAllocator
     }
 
     blocks.insert({*ptr, Block(size, *ptr, true)});
+    stats.num_host_allocs++;
+    stats.reserved_bytes += size;
+    stats.peak_reserved_bytes = std::max(stats.peak_reserved_bytes, stats.reserved_bytes);
+    addAllocated(size);
     return cudaSuccess;
   }
 
@@ -129,6 +205,7 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    stats.allocated_bytes -= block.size;
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -138,7 +215,7 @@ struct HostAllocator
 
     if (block.event_count == 0) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      makeAvailable(block);
     }
     return cudaSuccess;
   }
@@ -185,13 +262,104 @@ struct HostAllocator
       Block& block = blocks.at(e.second);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+        makeAvailable(block);
       }
       cuda_events.pop_front();
     }
     return cudaSuccess;
   }
 
+  void addAllocated(size_t size)
+  {
+    stats.allocated_bytes += size;
+    stats.peak_allocated_bytes = std::max(stats.peak_allocated_bytes, stats.allocated_bytes);
+  }
+
+  void makeAvailable(Block& block)
+  {
+    available.insert(block);
+    cached_bytes += block.size;
+    if (cached_bytes > cache_limit) {
+      wakePoller();
+    }
+  }
+
+  // Starts the background thread on first use and wakes it up.
+  void wakePoller()
+  {
+    if (!poller.joinable()) {
+      poller = std::thread([this] { pollEvents(); });
+    }
+    poller_cv.notify_one();
+  }
+
+  void pollEvents()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop_poller) {
+      if (!cuda_events.empty() && processEvents() != cudaSuccess) {
+        poll_failed = true;
+      }
+      releaseOverLimit(lock);
+      if (cuda_events.empty() || poll_failed) {
+        poller_cv.wait(lock);
+      } else {
+        poller_cv.wait_for(lock, kPollInterval);
+      }
+    }
+  }
+
+  // Releases cached blocks, largest first, until the cache fits in
+  // cache_limit. cudaFreeHost synchronizes with the device, so it is called
+  // without holding the lock.
+  void releaseOverLimit(std::unique_lock<std::mutex>& lock)
+  {
+    std::vector<void*> to_free;
+    while (cached_bytes > cache_limit && !available.empty()) {
+      auto it = std::prev(available.end());
+      to_free.push_back(it->ptr);
+      cached_bytes -= it->size;
+      stats.reserved_bytes -= it->size;
+      stats.num_host_frees++;
+      blocks.erase(it->ptr);
+      available.erase(it);
+    }
+    if (to_free.empty()) {
+      return;
+    }
+    lock.unlock();
+    {
+      at::OptionalDeviceGuard device_guard;
+      usePrimaryContext(device_guard);
+      for (void* ptr : to_free) {
+        THCudaCheckWarn(cudaFreeHost(ptr));
+      }
+    }
+    lock.lock();
+  }
+
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+  }
+
+  void resetPeakStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.peak_allocated_bytes = stats.allocated_bytes;
+    stats.peak_reserved_bytes = stats.reserved_bytes;
+  }
+
+  void setCacheLimit(size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache_limit = bytes;
+    if (cached_bytes > cache_limit) {
+      wakePoller();
+    }
+  }
+
   void emptyCache()
   {
     std::lock_guard<std::mutex> lock(mutex);
@@ -211,12 +379,15 @@ struct HostAllocator
 
     // clear list of available blocks
     available.clear();
+    cached_bytes = 0;
 
     // free and erase non-allocated blocks
     for (auto it = blocks.begin(); it != blocks.end();) {
       Block& block = it->second;
       if (!block.allocated) {
         THCudaCheckWarn(cudaFreeHost(block.ptr));
+        stats.reserved_bytes -= block.size;
+        stats.num_host_frees++;
         it = blocks.erase(it);
       } else {
         ++it;
@@ -249,6 +420,10 @@ struct HostAllocator
     }
 
     cudaSetDevice(prev_device);
+    if (block.event_count > 0) {
+      poll_failed = false;
+      wakePoller();
+    }
     return err;
   }
 };
@@ -267,6 +442,21 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
+void THCCachingHostAllocator_resetPeakStats()
+{
+  allocator.resetPeakStats();
+}
+
+void THCCachingHostAllocator_setCacheLimit(size_t bytes)
+{
+  allocator.setCacheLimit(bytes);
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
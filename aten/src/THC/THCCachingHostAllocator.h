@@ -19,7 +19,17 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Instead, requests are rounded
+// up to one of four size classes per power of two, so that at most 25% of a
+// block is wasted, and a cached block is only handed out for requests of its
+// power of two.
+//
+// Freed blocks wait for the events recorded on their streams before they are
+// cached. A background thread polls these events, so blocks become reusable
+// without waiting for the next allocation, and it releases cached blocks when
+// their total size goes above the cache limit. The limit is unbounded by
+// default; it can be set with THCCachingHostAllocator_setCacheLimit or the
+// PYTORCH_CUDA_HOST_CACHE_LIMIT_MB environment variable.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -30,4 +40,29 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+struct THCCachingHostAllocatorStats {
+  // bytes of pinned memory handed out to callers (rounded up to size classes)
+  size_t allocated_bytes = 0;
+  size_t peak_allocated_bytes = 0;
+  // bytes of pinned memory allocated with cudaHostAlloc, including the
+  // cached blocks and the blocks waiting for their events
+  size_t reserved_bytes = 0;
+  size_t peak_reserved_bytes = 0;
+  // number of allocation requests, and how many of them reused a block
+  uint64_t num_allocs = 0;
+  uint64_t num_cache_hits = 0;
+  // number of cudaHostAlloc and cudaFreeHost calls
+  uint64_t num_host_allocs = 0;
+  uint64_t num_host_frees = 0;
+};
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+
+// Resets the peak statistics to their current values.
+THC_API void THCCachingHostAllocator_resetPeakStats(void);
+
+// Sets the maximum number of bytes of pinned memory kept in the cache for
+// reuse. Blocks in use are not counted.
+THC_API void THCCachingHostAllocator_setCacheLimit(size_t bytes);
+
 #endif
@@ -0,0 +1,68 @@
+import argparse
+import sys
+import torch
+import torch.utils._benchmark as benchmark_utils
+
+
+def make_graph(num_ops):
+    # A long chain of ops with in-place writes and list containers, so that the
+    # passes have to build an AliasDb with many elements and answer many
+    # mayAlias / mayContainAlias queries.
+    lines = ["def f(x, y):", "    acc = [x]", "    a = x + y"]
+    for i in range(num_ops):
+        lines.append("    b = a * y + {}".format(i))
+        lines.append("    c = b.relu()")
+        lines.append("    c.add_(a)")
+        lines.append("    acc.append(c)")
+        lines.append("    a = c + b")
+    lines.append("    return torch.cat(acc) + a")
+    cu = torch.jit.CompilationUnit("\n".join(lines))
+    return cu.f.graph
+
+
+PASSES = {
+    'cse': torch._C._jit_pass_cse,
+    'dce': torch._C._jit_pass_dce,
+    'constant_propagation': torch._C._jit_pass_constant_propagation,
+}
+
+
+def run_bench(pass_names, bench_args):
+    results = []
+    for num_ops in bench_args.num_ops:
+        graph = make_graph(num_ops)
+        for pass_name in pass_names:
+            print("Running {} on a graph with {} nodes ...".format(
+                pass_name, len(list(graph.nodes()))), end=" ")
+            sys.stdout.flush()
+            timer = benchmark_utils.Timer(
+                stmt="run_pass(graph.copy())",
+                globals={"run_pass": PASSES[pass_name], "graph": graph},
+                description=pass_name,
+                label="JIT pass time",
+                sub_label="{} ops".format(num_ops))
+            result = timer.blocked_autorange(min_run_time=bench_args.timer_min_run_time)
+            print("finished")
+            print(result)
+            sys.stdout.flush()
+            results.append(result)
+
+    comparison = benchmark_utils.Compare(results)
+    comparison.trim_significant_figures()
+    comparison.print()
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description='Benchmark alias analysis heavy TorchScript passes on large graphs')
+
+    parser.add_argument('--passes', nargs='*', default=list(PASSES.keys()),
+                        help='What passes to run: ' + str(PASSES.keys()))
+    parser.add_argument('--num_ops', nargs='*', default=[100, 1000, 5000], type=int)
+    parser.add_argument('--timer_min_run_time', default=10, type=int)
+
+    args = parser.parse_args()
+
+    for p in args.passes:
+        assert p in PASSES
+    run_bench(args.passes, args)
@@ -0,0 +1,19 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import torch
+from utils import NUM_LOOP_ITERS
+
+def overloaded_methods_loop(x, y):
+    # Tensor methods with many overloads, called positionally, to measure
+    # Python argument parsing overhead
+    z = x.add(y)
+    for i in range(NUM_LOOP_ITERS):
+        z = z.max(y).min(x).sub(x).pow(2).view(-1).view(x.size())
+    return z
+
+class OverloadedMethodsModule(torch.nn.Module):
+    def __init__(self, ops_fn):
+        super(OverloadedMethodsModule, self).__init__()
+        self.ops_fn = ops_fn
+
+    def forward(self, x, y):
+        return self.ops_fn(x, y)
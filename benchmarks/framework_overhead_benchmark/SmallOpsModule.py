@@ -0,0 +1,17 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import torch
+from utils import NUM_LOOP_ITERS
+
+def small_ops_loop(x, y):
+    z = torch.add(x, y)
+    for i in range(NUM_LOOP_ITERS):
+        z = torch.relu(torch.mul(torch.add(z, x), y))
+    return z
+
+class SmallOpsModule(torch.nn.Module):
+    def __init__(self, ops_fn):
+        super(SmallOpsModule, self).__init__()
+        self.ops_fn = ops_fn
+
+    def forward(self, x, y):
+        return self.ops_fn(x, y)
@@ -1,14 +1,19 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 from utils import ms_to_us, benchmark_module, BenchmarkConfig, ModuleConfig
 import argparse
+import torch
 from C2Module import C2SimpleNet
 
 from SimpleAddModule import SimpleAddModule, add_tensors_loop
+from SmallOpsModule import SmallOpsModule, small_ops_loop
+from OverloadedMethodsModule import OverloadedMethodsModule, overloaded_methods_loop
 from pt_wrapper_module import WrapperModule
 
 """ Framework overhead benchmark script.
 Benchmark framework overhead.
-Currently supported ops: add.
+Currently supported ops: add, small_ops (a chain of add, mul and relu),
+overloaded_methods (a chain of heavily overloaded tensor methods, dominated by
+Python argument parsing in eager mode).
 As of now runs only forward pass.
 Supports both graph mode and eager mode. In graph mode the module is traced via JIT tracing.
 Debug option prints the traced graph is graph_mode is enabled.
@@ -19,12 +24,18 @@ buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_ben
  --add_op --graph_mode --eager_mode (Runs both graph mode and eager mode)
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --graph_mode (Runs only graph mode)
+To measure the dispatcher's fast path for calls that record no autograd graph:
+buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
+ --op small_ops --eager_mode (and again with --disable_autograd_fast_path)
+To measure Python argument parsing of overloaded tensor methods:
+buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
+ --op overloaded_methods --eager_mode
 To run C2 benchmark:
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --benchmark_c2_net
 """
 
-SUPPORTED_OPS = {"add_op"}
+SUPPORTED_OPS = {"add_op", "small_ops", "overloaded_methods"}
 
 def parse_op_args(op):
     op_list = ops.split(",")
@@ -70,6 +81,8 @@ def main():
     parser.add_argument("--debug", default=False, dest="debug", action="store_true")
     parser.add_argument("--save", default=False, dest="save", action="store_true")
     parser.add_argument("--eager_mode", default=False, dest="eager_mode", action="store_true")
+    parser.add_argument("--disable_autograd_fast_path", default=False, dest="disable_autograd_fast_path",
+                        action="store_true")
     parser.add_argument("--num_warmup_iters", type=int, default=100)
     parser.add_argument("--num_iters", type=int, default=1000)
     args = parser.parse_args()
@@ -80,6 +93,9 @@ def main():
     assert not (args.benchmark_c2_net and args.use_throughput_benchmark), \
         "Benchmarking of C2 net via throughput benchmarking is not yet supported"
 
+    if args.disable_autograd_fast_path:
+        torch._C._dispatch_set_autograd_fast_path_enabled(False)
+
     num_warmup_iters = args.num_warmup_iters
     num_iters = args.num_iters
     config = BenchmarkConfig(num_warmup_iters, num_iters)
@@ -94,6 +110,16 @@ def main():
         else:
             module_config = ModuleConfig(add_tensors_loop, None, num_params, graph_mode)
         benchmark_simple_fn(args, config, module_config, SimpleAddModule, result)
+    elif args.op == "small_ops":
+        num_params = 2
+        assert not args.benchmark_c2_net, "small_ops has no C2 equivalent"
+        module_config = ModuleConfig(small_ops_loop, None, num_params, graph_mode)
+        benchmark_simple_fn(args, config, module_config, SmallOpsModule, result)
+    elif args.op == "overloaded_methods":
+        num_params = 2
+        assert not args.benchmark_c2_net, "overloaded_methods has no C2 equivalent"
+        module_config = ModuleConfig(overloaded_methods_loop, None, num_params, graph_mode)
+        benchmark_simple_fn(args, config, module_config, OverloadedMethodsModule, result)
     print_results(result)
 
 if __name__ == "__main__":
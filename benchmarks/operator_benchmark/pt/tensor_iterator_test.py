@@ -0,0 +1,44 @@
+import operator_benchmark as op_bench
+import torch
+
+"""Microbenchmarks for the fixed cost of building a TensorIterator.
+
+The tensors are tiny so the time is dominated by iterator set-up rather than
+by the kernel. Running the same op on the same geometry repeatedly exercises
+the iterator plan cache.
+"""
+
+tensor_iterator_configs = op_bench.config_list(
+    attr_names=["shape_one", "shape_two"],
+    attrs=[
+        [(1,), (1,)],
+        [(16, 16), (16, 16)],
+        [(16, 16), (16,)],
+        [(4, 8, 8), (8, 1)],
+        [(2, 4, 8, 8), (4, 1, 1)],
+    ],
+    cross_product_configs={
+        'device': ['cpu'],
+        'transpose': [False, True],
+    },
+    tags=["short"],
+)
+
+
+class TensorIteratorOverheadBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, shape_one, shape_two, device, transpose):
+        self.input_one = torch.rand(shape_one, device=device)
+        if transpose and self.input_one.dim() > 1:
+            self.input_one = self.input_one.transpose(0, -1)
+        self.input_two = torch.rand(shape_two, device=device)
+        self.set_module_name("tensor_iterator_add")
+
+    def forward(self):
+        return torch.add(self.input_one, self.input_two)
+
+
+op_bench.generate_pt_test(tensor_iterator_configs, TensorIteratorOverheadBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
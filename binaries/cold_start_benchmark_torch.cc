@@ -0,0 +1,373 @@
+/**
+ * Measures the latency from process start to the first inference of a model,
+ * broken down into its phases:
+ *
+ *   library_init     exec, dynamic linking and the static initializers of
+ *                    the torch libraries (operator registration etc.), up to
+ *                    main()
+ *   read             reading the model file into memory
+ *   load             torch::jit::load / _load_for_mobile of that data:
+ *                    archive parsing, unpickling, tensor records and, for
+ *                    TorchScript, importing the code
+ *   freeze           torch::jit::freeze_module (--freeze)
+ *   optimize         the frozen-graph passes (--optimize)
+ *   run_1 ... run_n  the first runs, during which the profiling executor
+ *                    profiles, optimizes and compiles the graph
+ *   first_inference  process start to the end of run_1
+ *
+ * Every iteration runs in a fresh process, so that nothing is warm but what
+ * the OS caches. With --page_cache=cold the model file is evicted from the
+ * page cache before each process starts; the pages of the shared libraries
+ * stay cached since this process maps them as well.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ATen/ATen.h"
+#include "c10/core/CPUAllocator.h"
+#include "torch/csrc/jit/mobile/import.h"
+#include "torch/csrc/jit/mobile/module.h"
+#include "torch/csrc/jit/passes/freeze_module.h"
+#include "torch/csrc/jit/passes/frozen_conv_add_relu_fusion.h"
+#include "torch/csrc/jit/passes/frozen_ops_to_mkldnn.h"
+#include "torch/csrc/jit/runtime/graph_executor.h"
+#include "torch/csrc/jit/serialization/import.h"
+#include "torch/script.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define COLD_START_USE_SPAWN
+extern char** environ;
+#endif
+
+C10_DEFINE_string(model, "", "The model to benchmark.");
+C10_DEFINE_string(
+    loader,
+    "jit",
+    "'jit' loads a TorchScript model with torch::jit::load, 'mobile' a "
+    "bytecode model with the lite interpreter.");
+C10_DEFINE_string(
+    load_mode,
+    "buffer",
+    "For --loader=mobile: 'file', 'mmap' or 'buffer', see "
+    "lite_interpreter_model_load. The jit loader always reads into a buffer.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "Dimensions of the float inputs, comma separated, with ';' between "
+    "inputs. Empty for a model without inputs.");
+C10_DEFINE_string(device, "cpu", "Device to run on (cpu/cuda), jit only.");
+C10_DEFINE_bool(freeze, false, "Freeze the module after loading, jit only.");
+C10_DEFINE_bool(
+    optimize,
+    false,
+    "Run the frozen-graph optimization passes after freezing, jit only.");
+C10_DEFINE_bool(
+    profiling_executor,
+    true,
+    "Use the profiling executor, which compiles the graph during the first "
+    "runs, jit only.");
+C10_DEFINE_int(runs, 3, "The number of runs measured in each process.");
+C10_DEFINE_int(iter, 10, "The number of processes to start.");
+C10_DEFINE_string(
+    page_cache,
+    "hot",
+    "'hot' leaves the model file in the page cache, 'cold' evicts it before "
+    "each process starts.");
+C10_DEFINE_int64(
+    child_start_ns,
+    0,
+    "Internal: steady clock time at which the parent started this process.");
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             clock_type::now().time_since_epoch())
+      .count();
+}
+
+double ms_since(int64_t start_ns) {
+  return (now_ns() - start_ns) / 1e6;
+}
+
+std::vector<std::string> split(char separator, const std::string& string) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(string);
+  std::string item;
+  while (getline(ss, item, separator)) {
+    if (!item.empty()) {
+      pieces.push_back(std::move(item));
+    }
+  }
+  return pieces;
+}
+
+std::vector<c10::IValue> create_inputs(const at::Device& device) {
+  std::vector<c10::IValue> inputs;
+  for (const auto& dims_str : split(';', FLAGS_input_dims)) {
+    std::vector<int64_t> dims;
+    for (const auto& s : split(',', dims_str)) {
+      dims.push_back(c10::stoi(s));
+    }
+    inputs.emplace_back(at::ones(dims, at::TensorOptions(device)));
+  }
+  return inputs;
+}
+
+// Waits for the kernels of a CUDA run by copying its tensor output back.
+void sync_output(const c10::IValue& output) {
+  if (output.isTensor() && !output.toTensor().device().is_cpu()) {
+    output.toTensor().cpu();
+  }
+}
+
+void report(const std::string& phase, double ms) {
+  std::cout << phase << " " << ms << std::endl;
+}
+
+// Runs one cold start in this process, started at start_ns and entering
+// main() at main_ns, and prints "<phase> <ms>" lines.
+void run_child(int64_t start_ns, int64_t main_ns) {
+  report("library_init", (main_ns - start_ns) / 1e6);
+
+  torch::jit::getProfilingMode() = FLAGS_profiling_executor;
+  const at::Device device(FLAGS_device);
+
+  // The buffer comes from the CPU allocator, so it is aligned like the
+  // tensors that alias it in the mobile buffer mode.
+  std::shared_ptr<void> buffer;
+  size_t buffer_size = 0;
+  const bool read_buffer =
+      FLAGS_loader == "jit" || FLAGS_load_mode == "buffer";
+  if (read_buffer) {
+    int64_t t = now_ns();
+    std::ifstream file(FLAGS_model, std::ios::binary | std::ios::ate);
+    CAFFE_ENFORCE(file, "Failed to open ", FLAGS_model);
+    buffer_size = static_cast<size_t>(file.tellg());
+    buffer = std::shared_ptr<void>(c10::alloc_cpu(buffer_size), c10::free_cpu);
+    file.seekg(0);
+    file.read(static_cast<char*>(buffer.get()), buffer_size);
+    report("read", ms_since(t));
+  }
+
+  auto inputs = create_inputs(device);
+  if (FLAGS_loader == "mobile") {
+    torch::AutoNonVariableTypeMode non_var_guard{true};
+    int64_t t = now_ns();
+    torch::jit::mobile::Module module;
+    if (FLAGS_load_mode == "mmap") {
+      module = torch::jit::_load_for_mobile_mmapped(FLAGS_model);
+    } else if (FLAGS_load_mode == "buffer") {
+      module = torch::jit::_load_for_mobile_from_buffer(
+          buffer.get(), buffer_size, c10::nullopt, buffer);
+    } else {
+      module = torch::jit::_load_for_mobile(FLAGS_model);
+    }
+    report("load", ms_since(t));
+    for (int i = 0; i < FLAGS_runs; ++i) {
+      t = now_ns();
+      module.forward(inputs);
+      report("run_" + std::to_string(i + 1), ms_since(t));
+      if (i == 0) {
+        report("first_inference", ms_since(start_ns));
+      }
+    }
+    return;
+  }
+
+  torch::NoGradGuard no_grad;
+  int64_t t = now_ns();
+  std::istringstream stream(std::string(
+      static_cast<const char*>(buffer.get()), buffer_size));
+  torch::jit::Module module = torch::jit::load(stream, device);
+  module.eval();
+  report("load", ms_since(t));
+  if (FLAGS_freeze) {
+    t = now_ns();
+    module = torch::jit::freeze_module(module);
+    report("freeze", ms_since(t));
+    if (FLAGS_optimize) {
+      t = now_ns();
+      auto graph = module.get_method("forward").graph();
+      if (device.is_cpu()) {
+        torch::jit::ConvertFrozenOpsToMKLDNN(graph);
+      } else {
+        torch::jit::FuseFrozenConvAddRelu(graph);
+      }
+      report("optimize", ms_since(t));
+    }
+  }
+  for (int i = 0; i < FLAGS_runs; ++i) {
+    t = now_ns();
+    sync_output(module.forward(inputs));
+    report("run_" + std::to_string(i + 1), ms_since(t));
+    if (i == 0) {
+      report("first_inference", ms_since(start_ns));
+    }
+  }
+}
+
+#ifdef COLD_START_USE_SPAWN
+
+void evict_from_page_cache(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  CAFFE_ENFORCE(fd >= 0, "Failed to open ", path);
+#ifdef __linux__
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#else
+  fcntl(fd, F_NOCACHE, 1);
+#endif
+  close(fd);
+}
+
+// Starts this binary again with the same flags plus --child_start_ns and
+// collects the phases it reports.
+void run_parent(const std::vector<std::string>& argv) {
+#ifdef __linux__
+  const std::string binary = "/proc/self/exe";
+#else
+  const std::string binary = argv[0];
+#endif
+  std::map<std::string, std::vector<double>> phases;
+  std::vector<std::string> order;
+  for (int iter = 0; iter < FLAGS_iter; ++iter) {
+    if (FLAGS_page_cache == "cold") {
+      evict_from_page_cache(FLAGS_model);
+    }
+    int fds[2];
+    CAFFE_ENFORCE_EQ(pipe(fds), 0);
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+
+    std::vector<std::string> args(argv);
+    args.push_back("--child_start_ns=" + std::to_string(now_ns()));
+    std::vector<char*> child_argv;
+    for (auto& arg : args) {
+      child_argv.push_back(&arg[0]);
+    }
+    child_argv.push_back(nullptr);
+    pid_t pid;
+    CAFFE_ENFORCE_EQ(
+        posix_spawn(
+            &pid,
+            binary.c_str(),
+            &actions,
+            nullptr,
+            child_argv.data(),
+            environ),
+        0,
+        "Failed to start ",
+        binary);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    std::string output;
+    char chunk[4096];
+    ssize_t n;
+    while ((n = read(fds[0], chunk, sizeof(chunk))) > 0) {
+      output.append(chunk, n);
+    }
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    CAFFE_ENFORCE(
+        WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "Benchmark process failed:\n",
+        output);
+
+    std::istringstream lines(output);
+    std::string phase;
+    double ms;
+    while (lines >> phase >> ms) {
+      if (!phases.count(phase)) {
+        order.push_back(phase);
+      }
+      phases[phase].push_back(ms);
+    }
+  }
+
+  std::cout << "Cold start of " << FLAGS_model << " (" << FLAGS_loader
+            << ", " << FLAGS_device << ", page cache " << FLAGS_page_cache
+            << ") over " << FLAGS_iter << " processes, in ms:" << std::endl;
+  std::printf("%-16s %10s %10s %10s\n", "phase", "min", "median", "max");
+  for (const auto& phase : order) {
+    auto& values = phases[phase];
+    std::sort(values.begin(), values.end());
+    std::printf(
+        "%-16s %10.3f %10.3f %10.3f\n",
+        phase.c_str(),
+        values.front(),
+        values[values.size() / 2],
+        values.back());
+  }
+}
+
+#endif // COLD_START_USE_SPAWN
+
+} // namespace
+
+int main(int argc, char** argv) {
+  // Taken before anything else so the first phase doesn't include flag
+  // parsing.
+  const int64_t main_ns = now_ns();
+  // Flag parsing may drop the flags it consumed from argv.
+  const std::vector<std::string> original_argv(argv, argv + argc);
+  c10::SetUsageMessage(
+      "Measure the latency from process start to the first inference.\n"
+      "Example usage:\n"
+      "./cold_start_benchmark_torch"
+      " --model=<model_file>"
+      " --input_dims=1,3,224,224"
+      " [--loader=jit|mobile]"
+      " [--page_cache=hot|cold]"
+      " [--freeze --optimize]"
+      " [--iter=<processes>]");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags!" << std::endl;
+    return 1;
+  }
+  if (FLAGS_model.empty()) {
+    std::cerr << "Model file is not provided" << std::endl;
+    return 1;
+  }
+  CAFFE_ENFORCE(
+      FLAGS_loader == "jit" || FLAGS_loader == "mobile",
+      "Unknown loader ",
+      FLAGS_loader);
+  CAFFE_ENFORCE(
+      FLAGS_page_cache == "hot" || FLAGS_page_cache == "cold",
+      "Unknown page cache mode ",
+      FLAGS_page_cache);
+
+  if (FLAGS_child_start_ns > 0) {
+    run_child(FLAGS_child_start_ns, main_ns);
+    return 0;
+  }
+#ifdef COLD_START_USE_SPAWN
+  run_parent(original_argv);
+#else
+  // Without process spawning only a single in-process start is measured, and
+  // library_init is not.
+  (void)original_argv;
+  run_child(main_ns, main_ns);
+#endif
+  return 0;
+}
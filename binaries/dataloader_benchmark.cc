@@ -0,0 +1,111 @@
+#include <torch/torch.h>
+
+#include "c10/util/Flags.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+C10_DEFINE_int(batches, 100000, "Number of batches per run");
+C10_DEFINE_int(max_workers, 16, "Largest number of worker threads to run");
+C10_DEFINE_int(batch_size, 1, "Number of examples per DataLoader batch");
+
+namespace {
+using torch::data::detail::BoundedQueue;
+using torch::data::detail::DataShuttle;
+using torch::data::detail::Queue;
+
+struct TinyDataset : torch::data::datasets::BatchDataset<
+                         TinyDataset,
+                         std::vector<int64_t>> {
+  std::vector<int64_t> get_batch(torch::ArrayRef<size_t> indices) override {
+    return std::vector<int64_t>(indices.begin(), indices.end());
+  }
+  torch::optional<size_t> size() const override {
+    return FLAGS_batches * FLAGS_batch_size;
+  }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Moves `FLAGS_batches` jobs through a shuttle the way the DataLoader does:
+// the main thread keeps `2 * workers` jobs in flight and the workers turn
+// every job into a result right away, so only the queues are measured.
+template <template <typename> class QueueType>
+double shuttle_batches_per_second(DataShuttle<int, int, QueueType>& shuttle,
+                                  int workers) {
+  const int max_jobs = 2 * workers;
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; ++w) {
+    threads.emplace_back([&shuttle] {
+      while (true) {
+        const int job = shuttle.pop_job();
+        if (job < 0) {
+          break;
+        }
+        shuttle.push_result(job);
+      }
+    });
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  int pushed = 0;
+  for (; pushed < max_jobs && pushed < FLAGS_batches; ++pushed) {
+    shuttle.push_job(pushed);
+  }
+  while (shuttle.pop_result()) {
+    if (pushed < FLAGS_batches) {
+      shuttle.push_job(pushed++);
+    }
+  }
+  const double elapsed = seconds_since(start);
+
+  for (int w = 0; w < workers; ++w) {
+    shuttle.push_job(-1);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return FLAGS_batches / elapsed;
+}
+
+double dataloader_batches_per_second(int workers) {
+  auto data_loader = torch::data::make_data_loader(
+      TinyDataset{},
+      torch::data::samplers::SequentialSampler(
+          FLAGS_batches * FLAGS_batch_size),
+      torch::data::DataLoaderOptions(FLAGS_batch_size).workers(workers));
+  const auto start = std::chrono::steady_clock::now();
+  size_t batches = 0;
+  for (auto& batch : *data_loader) {
+    (void)batch;
+    ++batches;
+  }
+  return batches / seconds_since(start);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+
+  std::cout << "workers\tlocked shuttle\tlock-free shuttle\tDataLoader"
+            << " (batches/s)" << std::endl;
+  for (int workers = 1; workers <= FLAGS_max_workers; workers *= 2) {
+    DataShuttle<int, int, Queue> locked;
+    DataShuttle<int, int, BoundedQueue> lock_free(2 * workers);
+    const double locked_rate = shuttle_batches_per_second(locked, workers);
+    const double lock_free_rate =
+        shuttle_batches_per_second(lock_free, workers);
+    const double dataloader_rate = dataloader_batches_per_second(workers);
+    std::cout << workers << "\t" << locked_rate << "\t" << lock_free_rate
+              << "\t" << dataloader_rate << std::endl;
+  }
+  return 0;
+}
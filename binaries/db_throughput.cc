@@ -32,6 +32,14 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    readahead_threads,
+    0,
+    "If positive, the number of threads the reader reads ahead with.");
+C10_DEFINE_int(
+    readahead_buffer_size,
+    64,
+    "The number of records each readahead thread buffers.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -82,6 +90,10 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
 
 void TestThroughputWithReader() {
   caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  if (FLAGS_readahead_threads > 0) {
+    reader.EnableReadahead(
+        FLAGS_readahead_threads, FLAGS_readahead_buffer_size);
+  }
   std::vector<std::unique_ptr<std::thread>> reading_threads(
       FLAGS_num_read_threads);
   for (int i = 0; i < reading_threads.size(); ++i) {
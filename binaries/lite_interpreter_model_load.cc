@@ -1,4 +1,5 @@
 #include "ATen/ATen.h"
+#include <c10/core/CPUAllocator.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/mobile/import.h>
@@ -6,14 +7,43 @@
 #include <torch/csrc/jit/serialization/import.h>
 #include "torch/script.h"
 
+#include <chrono>
+#include <fstream>
+
 C10_DEFINE_string(model, "", "The given bytecode model to check if it is supported by lite_interpreter.");
+C10_DEFINE_string(
+    load_mode,
+    "file",
+    "How to load the model: 'file' reads it, copying the tensors out, "
+    "'mmap' maps the file and 'buffer' reads the file into memory first and "
+    "loads from the buffer; the last two do not copy the tensors.");
+C10_DEFINE_int(iter, 1, "The number of times to load the model.");
+
+namespace {
+
+torch::jit::mobile::Module load(
+    const std::string& mode,
+    const std::shared_ptr<void>& buffer,
+    size_t buffer_size) {
+  if (mode == "mmap") {
+    return torch::jit::_load_for_mobile_mmapped(FLAGS_model);
+  } else if (mode == "buffer") {
+    return torch::jit::_load_for_mobile_from_buffer(
+        buffer.get(), buffer_size, c10::nullopt, buffer);
+  }
+  return torch::jit::_load_for_mobile(FLAGS_model);
+}
+
+} // namespace
 
 int main(int argc, char** argv) {
   c10::SetUsageMessage(
     "Check if exported bytecode model is runnable by lite_interpreter.\n"
     "Example usage:\n"
     "./lite_interpreter_model_load"
-    " --model=<model_file>");
+    " --model=<model_file>"
+    " [--load_mode=file|mmap|buffer]"
+    " [--iter=<n>]");
 
   if (!c10::ParseCommandLineFlags(&argc, &argv)) {
     std::cerr << "Failed to parse command line flags!" << std::endl;
@@ -24,10 +54,41 @@ int main(int argc, char** argv) {
     std::cerr << FLAGS_model <<  ":Model file is not provided\n";
     return -1;
   }
-  
+  if (FLAGS_load_mode != "file" && FLAGS_load_mode != "mmap" &&
+      FLAGS_load_mode != "buffer") {
+    std::cerr << "Unknown load mode " << FLAGS_load_mode << std::endl;
+    return -1;
+  }
+
+  // The buffer comes from the CPU allocator, so it is aligned like the
+  // tensors that alias it.
+  std::shared_ptr<void> buffer;
+  size_t buffer_size = 0;
+  if (FLAGS_load_mode == "buffer") {
+    std::ifstream file(FLAGS_model, std::ios::binary | std::ios::ate);
+    if (!file) {
+      std::cerr << "Failed to open " << FLAGS_model << std::endl;
+      return -1;
+    }
+    buffer_size = static_cast<size_t>(file.tellg());
+    buffer = std::shared_ptr<void>(c10::alloc_cpu(buffer_size), c10::free_cpu);
+    file.seekg(0);
+    file.read(static_cast<char*>(buffer.get()), buffer_size);
+  }
+
   // TODO: avoid having to set this guard for custom mobile build with mobile
   // interpreter.
   torch::AutoNonVariableTypeMode non_var_guard{true};
-  torch::jit::mobile::Module bc = torch::jit::_load_for_mobile(FLAGS_model);
+
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::microseconds us;
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    std::chrono::time_point<clock> start_time = clock::now();
+    torch::jit::mobile::Module bc = load(FLAGS_load_mode, buffer, buffer_size);
+    auto duration = static_cast<float>(
+        std::chrono::duration_cast<us>(clock::now() - start_time).count());
+    std::cout << "Load time (" << FLAGS_load_mode << "): " << duration / 1000
+              << " ms." << std::endl;
+  }
   return 0;
 }
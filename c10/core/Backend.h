@@ -40,6 +40,8 @@ enum class Backend {
   QuantizedCUDA,
   Undefined,
   MkldnnCPU,
+  SparseCsrCPU,
+  SparseCsrCUDA,
   NumOptions
 };
 
@@ -114,6 +116,10 @@ static inline Backend dispatchKeyToBackend(DispatchKey t) {
     return Backend::SparseHIP;
   } else if (t == DispatchKey::MkldnnCPU) {
     return Backend::MkldnnCPU;
+  } else if (t == DispatchKey::SparseCsrCPU) {
+    return Backend::SparseCsrCPU;
+  } else if (t == DispatchKey::SparseCsrCUDA) {
+    return Backend::SparseCsrCUDA;
   } else if (t == DispatchKey::QuantizedCPU) {
     return Backend::QuantizedCPU;
   } else if (t == DispatchKey::QuantizedCUDA) {
@@ -147,6 +153,10 @@ static inline DispatchKey backendToDispatchKey(Backend b) {
       return DispatchKey::SparseHIP;
     case Backend::MkldnnCPU:
       return DispatchKey::MkldnnCPU;
+    case Backend::SparseCsrCPU:
+      return DispatchKey::SparseCsrCPU;
+    case Backend::SparseCsrCUDA:
+      return DispatchKey::SparseCsrCUDA;
     case Backend::Vulkan:
       return DispatchKey::Vulkan;
     case Backend::QuantizedCPU:
@@ -182,8 +192,10 @@ static inline DeviceType backendToDeviceType(Backend b) {
       return DeviceType::HIP;
     case Backend::MkldnnCPU:
     case Backend::QuantizedCPU:
+    case Backend::SparseCsrCPU:
       return DeviceType::CPU;
     case Backend::QuantizedCUDA:
+    case Backend::SparseCsrCUDA:
       return DeviceType::CUDA;
     case Backend::Vulkan:
       return DeviceType::Vulkan;
@@ -219,6 +231,9 @@ static inline Backend backendToCPU(Backend b) {
       return Backend::QuantizedCPU;
     case Backend::QuantizedCUDA:
       return Backend::QuantizedCPU;
+    case Backend::SparseCsrCPU:
+    case Backend::SparseCsrCUDA:
+      return Backend::SparseCsrCPU;
     case Backend::Undefined:
       return Backend::Undefined;
     default:
@@ -239,6 +254,9 @@ static inline Backend backendToCUDA(Backend b) {
     case Backend::SparseCUDA:
     case Backend::SparseHIP:
       return Backend::SparseCUDA;
+    case Backend::SparseCsrCPU:
+    case Backend::SparseCsrCUDA:
+      return Backend::SparseCsrCUDA;
     case Backend::Undefined:
       return Backend::Undefined;
     default:
@@ -289,6 +307,10 @@ static inline const char* toString(Backend b) {
       return "SparseHIP";
     case Backend::MkldnnCPU:
       return "MkldnnCPU";
+    case Backend::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case Backend::SparseCsrCUDA:
+      return "SparseCsrCUDA";
     case Backend::Vulkan:
       return "Vulkan";
     case Backend::QuantizedCPU:
@@ -1,6 +1,18 @@
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#ifdef MADV_HUGEPAGE
+#define C10_HAS_TRANSPARENT_HUGE_PAGES
+#endif
+#endif
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -17,6 +29,12 @@ C10_DEFINE_bool(
     false,
     "If set, fill memory with deterministic junk when allocating on CPU");
 
+C10_DEFINE_int64(
+    caffe2_cpu_allocator_huge_page_threshold,
+    0,
+    "If positive, CPU allocations of at least this many bytes are aligned to "
+    "2MB and advised to use transparent huge pages (Linux only)");
+
 namespace c10 {
 
 void memset_junk(void* data, size_t num) {
@@ -52,7 +70,17 @@ void* alloc_cpu(size_t nbytes) {
 #elif defined(_MSC_VER)
   data = _aligned_malloc(nbytes, gAlignment);
 #else
-  int err = posix_memalign(&data, gAlignment, nbytes);
+  size_t alignment = gAlignment;
+#ifdef C10_HAS_TRANSPARENT_HUGE_PAGES
+  const bool use_huge_pages =
+      FLAGS_caffe2_cpu_allocator_huge_page_threshold > 0 &&
+      nbytes >= static_cast<size_t>(FLAGS_caffe2_cpu_allocator_huge_page_threshold);
+  if (use_huge_pages) {
+    // The kernel can only back 2MB-aligned ranges with a huge page.
+    alignment = kHugePageSize;
+  }
+#endif
+  int err = posix_memalign(&data, alignment, nbytes);
   if (err != 0) {
     CAFFE_THROW(
         "DefaultCPUAllocator: can't allocate memory: you tried to allocate ",
@@ -71,8 +99,17 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+#ifdef C10_HAS_TRANSPARENT_HUGE_PAGES
+  if (use_huge_pages) {
+    // Must happen before the pages are first touched below. This is only
+    // advice: it fails harmlessly if THP is disabled on the system.
+    madvise(data, nbytes, MADV_HUGEPAGE);
+  }
+#endif
+
+  // move data to the preferred NUMA node, or to the thread's node if none
+  // is set
+  NUMAMove(data, nbytes, GetNUMAAllocationNode());
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -94,6 +131,42 @@ void free_cpu(void* data) {
 #endif
 }
 
+int64_t GetTransparentHugePageBytes(const void* ptr) {
+#ifdef C10_HAS_TRANSPARENT_HUGE_PAGES
+  // /proc/self/smaps lists each mapping as a header line
+  // "start-end perms offset dev inode path" followed by "Field: value kB"
+  // lines, one of which is AnonHugePages.
+  std::ifstream smaps("/proc/self/smaps");
+  if (!smaps) {
+    return -1;
+  }
+  const auto addr = reinterpret_cast<uintptr_t>(ptr);
+  bool in_mapping = false;
+  std::string line;
+  while (std::getline(smaps, line)) {
+    std::istringstream fields(line);
+    std::string key;
+    fields >> key;
+    if (key.empty()) {
+      continue;
+    }
+    if (key.back() != ':') {
+      uintptr_t start = 0, end = 0;
+      if (sscanf(key.c_str(), "%" SCNxPTR "-%" SCNxPTR, &start, &end) == 2) {
+        in_mapping = start <= addr && addr < end;
+      }
+    } else if (in_mapping && key == "AnonHugePages:") {
+      int64_t kb = 0;
+      fields >> kb;
+      return kb * 1024;
+    }
+  }
+  return in_mapping ? 0 : -1;
+#else
+  return -1;
+#endif
+}
+
 struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
@@ -11,6 +11,7 @@
 C10_DECLARE_bool(caffe2_report_cpu_memory_usage);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_zero_fill);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_junk_fill);
+C10_DECLARE_int64(caffe2_cpu_allocator_huge_page_threshold);
 
 namespace c10 {
 
@@ -37,6 +38,16 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// Size of the transparent huge pages alloc_cpu aligns large allocations to
+// when FLAGS_caffe2_cpu_allocator_huge_page_threshold is set.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Returns how many bytes of the memory mapping containing ptr are currently
+// backed by transparent huge pages, or -1 if this can't be determined on
+// this platform. Useful to check whether a large storage allocated above the
+// huge page threshold actually got huge pages from the kernel.
+C10_API int64_t GetTransparentHugePageBytes(const void* ptr);
+
 // A simple struct that is used to report C10's memory allocation and
 // deallocation status to the profiler
 class C10_API ProfiledCPUMemoryReporter {
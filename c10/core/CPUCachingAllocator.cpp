@@ -0,0 +1,353 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/DeviceType.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+C10_DEFINE_int64(
+    caffe2_cpu_caching_allocator_thread_cache_bytes,
+    4 << 20,
+    "Bytes each thread may keep in its CPU caching allocator free lists "
+    "before spilling blocks into the global pool");
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+namespace {
+
+// Size classes are powers of two between 2^kMinSizeClassShift and
+// kMaxCachedSize bytes.
+constexpr size_t kMinSizeClassShift = 6;
+constexpr size_t kMaxSizeClassShift = 20;
+constexpr size_t kNumSizeClasses = kMaxSizeClassShift - kMinSizeClassShift + 1;
+static_assert(
+    (size_t(1) << kMaxSizeClassShift) == kMaxCachedSize,
+    "kMaxCachedSize must match the largest size class");
+
+// Marks blocks that are larger than kMaxCachedSize and never cached.
+constexpr uint32_t kUncachedSizeClass = kNumSizeClasses;
+
+// Number of blocks a thread moves from the global pool into its own cache
+// when it misses.
+constexpr size_t kRefillBatch = 8;
+
+// Every block is preceded by a header recording how to free it. Keeping the
+// header in front of the data (instead of in a separate map) lets the deleter
+// find it from the data pointer alone, without taking a lock, and keeps
+// data == context in the returned DataPtr.
+struct BlockHeader {
+  size_t size; // usable bytes after the header
+  uint32_t size_class;
+};
+constexpr size_t kHeaderSize = gAlignment;
+static_assert(
+    sizeof(BlockHeader) <= kHeaderSize,
+    "BlockHeader does not fit in the space reserved for it");
+
+// While a block is cached, its first bytes link it into a free list.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+inline BlockHeader* header_of(void* data) {
+  return reinterpret_cast<BlockHeader*>(
+      static_cast<char*>(data) - kHeaderSize);
+}
+
+inline size_t size_class_bytes(uint32_t size_class) {
+  return size_t(1) << (size_class + kMinSizeClassShift);
+}
+
+inline uint32_t size_class_of(size_t nbytes) {
+  auto shift = static_cast<size_t>(llvm::Log2_64_Ceil(nbytes));
+  return shift <= kMinSizeClassShift ? 0 : shift - kMinSizeClassShift;
+}
+
+struct AtomicStats {
+  std::atomic<int64_t> allocated_bytes{0};
+  std::atomic<int64_t> peak_allocated_bytes{0};
+  std::atomic<int64_t> reserved_bytes{0};
+  std::atomic<int64_t> cached_bytes{0};
+  std::atomic<int64_t> num_allocs{0};
+  std::atomic<int64_t> num_cache_hits{0};
+  std::atomic<int64_t> num_system_allocs{0};
+  std::atomic<int64_t> num_system_frees{0};
+
+  void add_allocated(int64_t nbytes) {
+    int64_t current = allocated_bytes.fetch_add(nbytes) + nbytes;
+    int64_t peak = peak_allocated_bytes.load();
+    while (current > peak &&
+           !peak_allocated_bytes.compare_exchange_weak(peak, current)) {
+    }
+  }
+};
+
+AtomicStats& stats() {
+  static AtomicStats stats_;
+  return stats_;
+}
+
+void* system_alloc(size_t size, uint32_t size_class) {
+  void* base = alloc_cpu(kHeaderSize + size);
+  auto* header = static_cast<BlockHeader*>(base);
+  header->size = size;
+  header->size_class = size_class;
+  stats().reserved_bytes += size;
+  stats().num_system_allocs++;
+  return static_cast<char*>(base) + kHeaderSize;
+}
+
+void system_free(void* data) {
+  auto* header = header_of(data);
+  stats().reserved_bytes -= header->size;
+  stats().num_system_frees++;
+  free_cpu(header);
+}
+
+struct FreeList {
+  FreeBlock* head = nullptr;
+  size_t count = 0;
+
+  void push(void* data) {
+    auto* block = static_cast<FreeBlock*>(data);
+    block->next = head;
+    head = block;
+    count++;
+  }
+
+  void* pop() {
+    FreeBlock* block = head;
+    if (block) {
+      head = block->next;
+      count--;
+    }
+    return block;
+  }
+};
+
+// Blocks spilled by thread caches, shared by all threads.
+struct GlobalPool {
+  struct SizeClass {
+    std::mutex mutex;
+    FreeList blocks;
+  };
+  std::array<SizeClass, kNumSizeClasses> size_classes;
+
+  void push(uint32_t size_class, FreeList& list) {
+    if (list.count == 0) {
+      return;
+    }
+    auto& sc = size_classes[size_class];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    while (void* data = list.pop()) {
+      sc.blocks.push(data);
+    }
+  }
+
+  // Moves up to max_blocks blocks into list; returns how many were moved.
+  size_t pop(uint32_t size_class, FreeList& list, size_t max_blocks) {
+    auto& sc = size_classes[size_class];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    size_t moved = 0;
+    while (moved < max_blocks) {
+      void* data = sc.blocks.pop();
+      if (!data) {
+        break;
+      }
+      list.push(data);
+      moved++;
+    }
+    return moved;
+  }
+
+  void release_all() {
+    for (auto& sc : size_classes) {
+      std::lock_guard<std::mutex> lock(sc.mutex);
+      while (void* data = sc.blocks.pop()) {
+        stats().cached_bytes -= header_of(data)->size;
+        system_free(data);
+      }
+    }
+  }
+};
+
+GlobalPool& global_pool() {
+  // Leaked on purpose: thread caches flush into the pool when their threads
+  // exit, which may happen during static destruction.
+  static GlobalPool* pool = new GlobalPool();
+  return *pool;
+}
+
+// Trivially destructible, so it stays valid after tls_cache is destroyed.
+// Frees that happen later in thread teardown go to the global pool.
+thread_local bool tls_cache_destroyed = false;
+
+struct ThreadCache {
+  std::array<FreeList, kNumSizeClasses> free_lists;
+  size_t cached_bytes = 0;
+
+  ~ThreadCache() {
+    flush();
+    tls_cache_destroyed = true;
+  }
+
+  void* pop(uint32_t size_class) {
+    auto& list = free_lists[size_class];
+    if (list.count == 0) {
+      global_pool().pop(size_class, list, kRefillBatch);
+      cached_bytes += list.count * size_class_bytes(size_class);
+    }
+    void* data = list.pop();
+    if (data) {
+      cached_bytes -= size_class_bytes(size_class);
+    }
+    return data;
+  }
+
+  void push(void* data, uint32_t size_class) {
+    free_lists[size_class].push(data);
+    cached_bytes += size_class_bytes(size_class);
+    auto limit =
+        static_cast<size_t>(FLAGS_caffe2_cpu_caching_allocator_thread_cache_bytes);
+    if (cached_bytes > limit) {
+      spill(size_class, limit / 2);
+    }
+  }
+
+  // Spills blocks, starting with the given size class, until at most target
+  // bytes remain cached in this thread.
+  void spill(uint32_t first, size_t target) {
+    for (uint32_t i = 0; i < kNumSizeClasses && cached_bytes > target; i++) {
+      uint32_t size_class = (first + i) % kNumSizeClasses;
+      auto& list = free_lists[size_class];
+      cached_bytes -= list.count * size_class_bytes(size_class);
+      global_pool().push(size_class, list);
+    }
+  }
+
+  void flush() {
+    for (uint32_t size_class = 0; size_class < kNumSizeClasses; size_class++) {
+      global_pool().push(size_class, free_lists[size_class]);
+    }
+    cached_bytes = 0;
+  }
+};
+
+thread_local ThreadCache tls_cache;
+
+void fill(void* data, size_t nbytes) {
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+}
+
+struct CachingCPUAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    void* data = nullptr;
+    if (nbytes > 0) {
+      data = nbytes > kMaxCachedSize ? allocate_uncached(nbytes)
+                                     : allocate_cached(nbytes);
+      stats().num_allocs++;
+      profiledCPUMemoryReporter().New(data, nbytes);
+    }
+    return {data, data, &Delete, at::Device(at::DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &Delete;
+  }
+
+  static void Delete(void* data) {
+    if (!data) {
+      return;
+    }
+    profiledCPUMemoryReporter().Delete(data);
+    auto* header = header_of(data);
+    stats().allocated_bytes -= header->size;
+    if (header->size_class == kUncachedSizeClass) {
+      system_free(data);
+      return;
+    }
+    stats().cached_bytes += header->size;
+    if (tls_cache_destroyed) {
+      FreeList list;
+      list.push(data);
+      global_pool().push(header->size_class, list);
+    } else {
+      tls_cache.push(data, header->size_class);
+    }
+  }
+
+ private:
+  static void* allocate_cached(size_t nbytes) {
+    uint32_t size_class = size_class_of(nbytes);
+    size_t size = size_class_bytes(size_class);
+    void* data = nullptr;
+    if (!tls_cache_destroyed) {
+      data = tls_cache.pop(size_class);
+    } else {
+      FreeList list;
+      if (global_pool().pop(size_class, list, 1) > 0) {
+        data = list.pop();
+      }
+    }
+    if (data) {
+      stats().cached_bytes -= size;
+      stats().num_cache_hits++;
+      // alloc_cpu applies these to fresh blocks; do the same for reused ones.
+      fill(data, nbytes);
+    } else {
+      data = system_alloc(size, size_class);
+    }
+    stats().add_allocated(size);
+    return data;
+  }
+
+  static void* allocate_uncached(size_t nbytes) {
+    void* data = system_alloc(nbytes, kUncachedSizeClass);
+    stats().add_allocated(nbytes);
+    return data;
+  }
+};
+
+CachingCPUAllocator g_caching_cpu_allocator;
+
+} // namespace
+
+at::Allocator* get() {
+  return &g_caching_cpu_allocator;
+}
+
+Stats getStats() {
+  auto& s = stats();
+  Stats result;
+  result.allocated_bytes = s.allocated_bytes;
+  result.peak_allocated_bytes = s.peak_allocated_bytes;
+  result.reserved_bytes = s.reserved_bytes;
+  result.cached_bytes = s.cached_bytes;
+  result.num_allocs = s.num_allocs;
+  result.num_cache_hits = s.num_cache_hits;
+  result.num_system_allocs = s.num_system_allocs;
+  result.num_system_frees = s.num_system_frees;
+  return result;
+}
+
+void resetPeakStats() {
+  stats().peak_allocated_bytes = stats().allocated_bytes.load();
+}
+
+void emptyCache() {
+  if (!tls_cache_destroyed) {
+    tls_cache.flush();
+  }
+  global_pool().release_all();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/util/Flags.h>
+
+#include <cstddef>
+#include <cstdint>
+
+C10_DECLARE_int64(caffe2_cpu_caching_allocator_thread_cache_bytes);
+
+namespace c10 {
+
+// Caching allocator for CPU tensors.
+//
+// The default CPU allocator goes to posix_memalign/free for every tensor,
+// which shows up in profiles of inference workloads that create many small
+// intermediates. This allocator keeps freed blocks around and hands them out
+// again for later requests of the same size class:
+//
+// - Requests up to kMaxCachedSize bytes are rounded up to a power of two
+//   (with a minimum of gAlignment bytes). Larger requests bypass the cache.
+//
+// - Each thread keeps a free list per size class and serves allocations from
+//   it without taking any lock. Blocks are returned to the free lists of the
+//   thread that frees them.
+//
+// - Once a thread caches more than
+//   FLAGS_caffe2_cpu_caching_allocator_thread_cache_bytes bytes, blocks spill
+//   into a global pool shared by all threads; threads that miss in their own
+//   cache refill from it before asking the system for memory. A thread's
+//   cache is returned to the global pool when the thread exits.
+//
+// Cached memory is never returned to the system unless emptyCache() is
+// called. The allocator is opt-in; enable it with
+//
+//   c10::SetCPUAllocator(c10::CPUCachingAllocator::get());
+//
+// DataPtrs produced by this allocator keep data == context, so it also
+// supports raw_allocate()/raw_deallocate().
+namespace CPUCachingAllocator {
+
+// Largest request (in bytes) that is served from the cache.
+constexpr size_t kMaxCachedSize = 1 << 20;
+
+struct Stats {
+  // bytes handed out to live allocations, after rounding to the size class
+  int64_t allocated_bytes = 0;
+  int64_t peak_allocated_bytes = 0;
+  // bytes obtained from the system and not yet returned to it
+  int64_t reserved_bytes = 0;
+  // bytes sitting in thread-local free lists or the global pool
+  int64_t cached_bytes = 0;
+  // number of allocate() calls that returned memory
+  int64_t num_allocs = 0;
+  // number of allocations served from a free list
+  int64_t num_cache_hits = 0;
+  // number of calls to the system allocator and deallocator
+  int64_t num_system_allocs = 0;
+  int64_t num_system_frees = 0;
+};
+
+C10_API at::Allocator* get();
+
+C10_API Stats getStats();
+
+// Resets peak_allocated_bytes to the current allocated_bytes.
+C10_API void resetPeakStats();
+
+// Returns cached blocks in the global pool and in the calling thread's cache
+// to the system. Caches of other threads are left untouched.
+C10_API void emptyCache();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -52,6 +52,10 @@ const char* toString(DispatchKey t) {
       return "SparseCUDA";
     case DispatchKey::SparseHIP:
       return "SparseHIP";
+    case DispatchKey::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case DispatchKey::SparseCsrCUDA:
+      return "SparseCsrCUDA";
 
     case DispatchKey::PrivateUse1:
       return "PrivateUse1";
@@ -79,6 +83,8 @@ const char* toString(DispatchKey t) {
 
     case DispatchKey::Autocast:
       return "Autocast";
+    case DispatchKey::AutocastCPU:
+      return "AutocastCPU";
 
     case DispatchKey::PrivateUse1_PreAutograd:
       return "PrivateUse1_PreAutograd";
@@ -99,6 +99,8 @@ enum class DispatchKey : uint8_t {
   SparseCUDA, // registered at build/aten/src/ATen/SparseCUDAType.cpp
   SparseHIP, // TODO: I think this is not actually used, due to Note
              // [Masquerading as CUDA]
+  SparseCsrCPU, // registered at build/aten/src/ATen/SparseCsrCPUType.cpp
+  SparseCsrCUDA, // registered at build/aten/src/ATen/SparseCsrCUDAType.cpp
 
   // Here are reserved backends for user-defined backends, see Note [Private use
   // DispatchKey]
@@ -206,7 +208,9 @@ enum class DispatchKey : uint8_t {
 
   // Autocasting precedes VariableTypeId, to ensure casts are autograd-exposed
   // and inputs are saved for backward in the post-autocast type.
+  // Autocast handles CUDA tensors, AutocastCPU handles CPU tensors.
   Autocast,
+  AutocastCPU,
 
   // Here are some reserved pre-autograd keys for user-defined backends, see
   // Note [Private use DispatchKey]
@@ -139,4 +139,16 @@ static inline DispatchKeySet XLA() {
   return DispatchKeySet{DispatchKey::XLA, DispatchKey::XLAPreAutograd};
 }
 
+// The keys of the autograd layer, which AutoNonVariableTypeMode and
+// InferenceMode exclude from dispatch
+static inline DispatchKeySet autograd_dispatch_keyset() {
+  return DispatchKeySet{
+    DispatchKey::Autograd,
+    DispatchKey::XLAPreAutograd,
+    DispatchKey::PrivateUse1_PreAutograd,
+    DispatchKey::PrivateUse2_PreAutograd,
+    DispatchKey::PrivateUse3_PreAutograd,
+  };
+}
+
 }
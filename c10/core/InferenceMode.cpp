@@ -0,0 +1,45 @@
+#include <c10/core/InferenceMode.h>
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+
+namespace c10 {
+
+namespace {
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+thread_local bool inference_mode_enabled = false;
+#else
+bool inference_mode_enabled = false;
+#endif
+
+void set_excluded(DispatchKeySet excluded) {
+  auto local = impl::tls_local_dispatch_key_set();
+  local.excluded_ = excluded;
+  impl::_force_tls_local_dispatch_key_set(local);
+}
+
+} // anonymous namespace
+
+InferenceMode::InferenceMode(bool enabled)
+    : prev_mode_(inference_mode_enabled),
+      prev_excluded_(impl::tls_local_dispatch_key_set().excluded_) {
+  inference_mode_enabled = enabled;
+  if (enabled) {
+    set_excluded(prev_excluded_ | autograd_dispatch_keyset());
+  } else if (prev_mode_) {
+    set_excluded(prev_excluded_ - autograd_dispatch_keyset());
+  }
+}
+
+InferenceMode::~InferenceMode() {
+  inference_mode_enabled = prev_mode_;
+  set_excluded(prev_excluded_);
+}
+
+bool InferenceMode::is_enabled() {
+  return inference_mode_enabled;
+}
+
+} // namespace c10
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <c10/core/DispatchKeySet.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// Note [Inference mode]
+// ~~~~~~~~~~~~~~~~~~~~~
+// A RAII, thread local (!) guard for code that is known to run inference
+// only, e.g. in serving.  While it is enabled:
+//
+//  - the autograd dispatch keys are excluded, so operators go straight to
+//    their backend kernels, as under AutoNonVariableTypeMode: outputs get
+//    no AutogradMeta and no view tracking, and in-place operators don't bump
+//    version counters;
+//
+//  - newly created tensors ("inference tensors") don't allocate a version
+//    counter at all.  Asking for the version of an inference tensor is an
+//    error; in particular, they can't be saved for backward by a graph that
+//    is recorded after leaving inference mode (clone them first).
+//
+// Unlike NoGradGuard, which only stops graphs from being recorded, nothing
+// that autograd would need later is maintained, so tensors that are modified
+// in place in inference mode must not be used by a graph recorded outside
+// of it.
+struct C10_API InferenceMode {
+  explicit InferenceMode(bool enabled = true);
+  ~InferenceMode();
+
+  InferenceMode(const InferenceMode&) = delete;
+  InferenceMode& operator=(const InferenceMode&) = delete;
+
+  static bool is_enabled();
+
+ private:
+  bool prev_mode_;
+  DispatchKeySet prev_excluded_;
+};
+
+} // namespace c10
@@ -3,6 +3,7 @@
 #include <c10/core/Allocator.h>
 #include <c10/core/ScalarType.h>
 
+#include <c10/util/ThreadLocalFreeList.h>
 #include <c10/util/intrusive_ptr.h>
 
 namespace c10 {
@@ -47,6 +48,14 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  // Freed StorageImpls are cached per thread, as for TensorImpl.
+  static void* operator new(size_t size) {
+    return ThreadLocalFreeList<sizeof(StorageImpl)>::allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ThreadLocalFreeList<sizeof(StorageImpl)>::deallocate(ptr, size);
+  }
+
   void reset() {
     data_ptr_.clear();
     size_bytes_ = 0;
@@ -9,11 +9,13 @@
 #include <c10/core/Storage.h>
 #include <c10/core/TensorOptions.h>
 #include <c10/core/DispatchKeySet.h>
+#include <c10/core/InferenceMode.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/core/CopyBytes.h>
 
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
+#include <c10/util/ThreadLocalFreeList.h>
 #include <c10/util/Flags.h>
 #include <c10/util/Logging.h>
 #include <c10/util/python_stub.h>
@@ -219,25 +221,52 @@ struct C10_API VariableVersion {
  private:
   struct VersionCounter : intrusive_ptr_target {
     VersionCounter(uint32_t version) : version_(version) {}
+    static void* operator new(size_t size) {
+      return ThreadLocalFreeList<sizeof(VersionCounter)>::allocate(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+      ThreadLocalFreeList<sizeof(VersionCounter)>::deallocate(ptr, size);
+    }
     std::atomic<uint32_t> version_;
   };
+  // nullptr for inference tensors, see Note [Inference mode]
   c10::intrusive_ptr<VersionCounter> version_counter_;
 
  public:
+  enum Disabled { DISABLED };
+
   bool unique() const {
-    return 1 == version_counter_.use_count();
+    return !version_counter_ || 1 == version_counter_.use_count();
   }
   // NOTE: As of C++11 and 14, default-constructing a std::atomic variable
   // leaves it in a persistently undefined state. See
   // https://cplusplus.github.io/LWG/issue2334.
   VariableVersion(uint32_t version = 0)
       : version_counter_(c10::make_intrusive<VersionCounter>(version)) {}
+  // A version that isn't tracked; doesn't allocate
+  explicit VariableVersion(Disabled) {}
+
+  // The version a new tensor starts with: untracked in inference mode
+  static VariableVersion for_new_tensor() {
+    return InferenceMode::is_enabled() ? VariableVersion(DISABLED) : VariableVersion();
+  }
+
+  // False for inference tensors
+  bool enabled() const noexcept {
+    return static_cast<bool>(version_counter_);
+  }
 
   void bump() noexcept {
-    ++version_counter_->version_;
+    if (version_counter_) {
+      ++version_counter_->version_;
+    }
   }
 
-  uint32_t current_version() const noexcept {
+  uint32_t current_version() const {
+    TORCH_CHECK(
+        version_counter_,
+        "Inference tensors do not track version counter. If you need to "
+        "save a tensor created in inference mode for backward, save a clone of it.");
     return version_counter_->version_;
   }
 };
@@ -355,6 +384,17 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   TensorImpl(TensorImpl&&) = default;
   TensorImpl& operator=(TensorImpl&&) = default;
 
+  /**
+   * Every op output allocates a TensorImpl, so freed ones are cached per
+   * thread.  Subclasses, which have another size, bypass the cache.
+   */
+  static void* operator new(size_t size) {
+    return ThreadLocalFreeList<sizeof(TensorImpl)>::allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ThreadLocalFreeList<sizeof(TensorImpl)>::deallocate(ptr, size);
+  }
+
   /**
    * Release (decref) storage, and any other external allocations.  This
    * override is for `intrusive_ptr_target` and is used to implement weak
@@ -437,6 +477,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
            key_set_.has(DispatchKey::SparseHIP);
   }
 
+  bool is_sparse_csr() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::SparseCsrCPU) ||
+           key_set_.has(DispatchKey::SparseCsrCUDA);
+  }
+
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::QuantizedCPU) ||
@@ -452,6 +498,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::CUDA) ||
         key_set_.has(DispatchKey::SparseCUDA) ||
+        key_set_.has(DispatchKey::SparseCsrCUDA) ||
         key_set_.has(DispatchKey::QuantizedCUDA);
   }
 
@@ -489,6 +536,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for perf.
     if (is_sparse()) {
       return kSparse;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
     } else if (is_mkldnn()) {
       return kMkldnn;
     } else {
@@ -1608,7 +1657,7 @@ private:
 protected:
   std::unique_ptr<c10::NamedTensorMetaInterface> named_tensor_meta_ = nullptr;
 
-  c10::VariableVersion version_counter_;
+  c10::VariableVersion version_counter_ = c10::VariableVersion::for_new_tensor();
 
   // This field contains a weak reference to a PyObject representing
   // this Tensor.  It MUST NOT be a strong reference, as that would
@@ -40,6 +40,9 @@ public:
   Stream getDefaultStream(Device d) const override {
     return impl_->getDefaultStream(d);
   }
+  Stream getStreamFromGlobalPool(Device d, bool isHighPriority = false) const override {
+    return impl_->getStreamFromGlobalPool(d, isHighPriority);
+  }
   Stream exchangeStream(Stream s) const noexcept override {
     return impl_->exchangeStream(s);
   }
@@ -62,6 +65,11 @@ public:
   bool queryEvent(void* event) const override {
     return impl_->queryEvent(event);
   }
+  void recordDataPtrOnStream(
+    const c10::DataPtr& data_ptr,
+    const Stream& stream) const override {
+    impl_->recordDataPtrOnStream(data_ptr, stream);
+  }
   void destroyEvent(
     void* event,
     const DeviceIndex device_index) const noexcept override {
@@ -7,9 +7,13 @@
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -18,6 +22,22 @@
 #include <unordered_set>
 #include <vector>
 
+// Expandable segments are built on the CUDA virtual memory management API
+// (cuMemCreate / cuMemMap), which was introduced in CUDA 10.2. The driver
+// entry points are resolved at runtime so that c10_cuda does not need to
+// link against libcuda directly.
+#if !defined(__HIP_PLATFORM_HCC__) && !defined(_WIN32) && \
+    defined(CUDA_VERSION) && CUDA_VERSION >= 10020
+#define C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+#include <dlfcn.h>
+#endif
+
+// Stream capture (CUDA graphs) needs cudaStreamGetCaptureInfo and
+// cudaThreadExchangeStreamCaptureMode.
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+#define C10_CUDA_HAS_GRAPHS
+#endif
+
 namespace c10 {
 
 C10_DEFINE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -40,6 +60,22 @@ namespace CUDACachingAllocator {
 //   smallest available free block or allocate a new block using cudaMalloc.
 //   To reduce fragmentation, requests between 1MB and 10MB will allocate and
 //   split a 20MB block, if no free block of sufficient size is available.
+// - The splitting and rounding policy can be tuned at runtime through the
+//   PYTORCH_CUDA_ALLOC_CONF environment variable (see CachingAllocatorConfig).
+// - Optionally (PYTORCH_CUDA_ALLOC_CONF=expandable_segments:True), large
+//   requests are served from an "expandable segment" instead: a per-stream
+//   virtual address range, sized to the device memory, into which physical
+//   pages are mapped on demand. Since every large block of a stream then lives
+//   in the same segment, neighbouring free blocks can always be coalesced and
+//   the segment can grow in place instead of requesting a new cudaMalloc.
+// - While a CUDA graph is captured, allocations on the capturing stream are
+//   served from a private memory pool of the graph. Blocks of a private pool
+//   are only reused by the same graph (or graphs sharing the pool), so the
+//   addresses baked into the graph stay valid for its replays. The pool is
+//   released once all graphs using it are destroyed.
+// - For debugging, recordHistory() makes the allocator keep the context (e.g.
+//   stack trace) of each live allocation and a ring buffer of recent events,
+//   both of which are included in snapshot().
 //
 // With this allocator, allocations and frees should logically be considered
 // "usages" of the memory segment associated with streams, just like kernel
@@ -97,9 +133,337 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
   }
 }
 
+// Options parsed from the PYTORCH_CUDA_ALLOC_CONF environment variable, a
+// comma-separated list of <option>:<value> pairs, e.g.
+//   PYTORCH_CUDA_ALLOC_CONF=max_split_size_mb:128,roundup_power2_divisions:4
+//
+// - max_split_size_mb: cached blocks larger than this are never split, and
+//   requests smaller than this never use them. Avoids that big free blocks get
+//   chipped away by small requests and no longer fit the next big one.
+// - roundup_power2_divisions: round requests up to one of this many evenly
+//   spaced sizes between consecutive powers of two, so that variable-sized
+//   requests map to fewer distinct block sizes and reuse each other's blocks.
+// - garbage_collection_threshold: fraction of device memory in (0, 1). Once
+//   the reserved memory exceeds it, cached blocks that have not been reused
+//   for the longest time are released before calling cudaMalloc, instead of
+//   waiting for cudaMalloc to fail and then releasing all cached blocks.
+// - expandable_segments: see ExpandableSegment.
+class CachingAllocatorConfig {
+ public:
+  static size_t max_split_size() {
+    return instance().m_max_split_size;
+  }
+
+  static size_t roundup_power2_divisions() {
+    return instance().m_roundup_power2_divisions;
+  }
+
+  static double garbage_collection_threshold() {
+    return instance().m_garbage_collection_threshold;
+  }
+
+  static bool expandable_segments() {
+    return instance().m_expandable_segments;
+  }
+
+ private:
+  static CachingAllocatorConfig& instance() {
+    static CachingAllocatorConfig* s_instance = new CachingAllocatorConfig();
+    return *s_instance;
+  }
+
+  CachingAllocatorConfig() :
+      m_max_split_size(std::numeric_limits<size_t>::max()),
+      m_roundup_power2_divisions(0),
+      m_garbage_collection_threshold(0),
+      m_expandable_segments(false) {
+    parseArgs(getenv("PYTORCH_CUDA_ALLOC_CONF"));
+  }
+
+  static double parseDouble(const std::string& key, const std::string& value) {
+    double result = 0;
+    size_t pos = 0;
+    try {
+      result = std::stod(value, &pos);
+    } catch (const std::exception&) {
+      pos = 0;
+    }
+    TORCH_CHECK(pos > 0 && pos == value.size(),
+        "Expected a number for CUDA caching allocator option ", key,
+        ", got ", value);
+    return result;
+  }
+
+  static bool parseBool(const std::string& key, const std::string& value) {
+    if (value == "True" || value == "true" || value == "1") {
+      return true;
+    }
+    TORCH_CHECK(value == "False" || value == "false" || value == "0",
+        "Expected True or False for CUDA caching allocator option ", key,
+        ", got ", value);
+    return false;
+  }
+
+  void parseArgs(const char* env) {
+    if (env == nullptr) {
+      return;
+    }
+    std::string config(env);
+    size_t begin = 0;
+    while (begin < config.size()) {
+      size_t end = config.find(',', begin);
+      if (end == std::string::npos) {
+        end = config.size();
+      }
+      const std::string option = config.substr(begin, end - begin);
+      begin = end + 1;
+      if (option.empty()) {
+        continue;
+      }
+      const size_t colon = option.find(':');
+      TORCH_CHECK(colon != std::string::npos,
+          "Expected <option>:<value> in PYTORCH_CUDA_ALLOC_CONF, got ", option);
+      const std::string key = option.substr(0, colon);
+      const std::string value = option.substr(colon + 1);
+      if (key == "max_split_size_mb") {
+        const double mb = parseDouble(key, value);
+        // Splitting blocks is never disabled for the small pool.
+        TORCH_CHECK(mb > kLargeBuffer / 1048576,
+            "max_split_size_mb must be larger than ", kLargeBuffer / 1048576,
+            ", got ", value);
+        m_max_split_size = static_cast<size_t>(mb * 1048576);
+      } else if (key == "roundup_power2_divisions") {
+        const double divisions = parseDouble(key, value);
+        const size_t n = static_cast<size_t>(divisions);
+        TORCH_CHECK(n == divisions && n > 0 && (n & (n - 1)) == 0,
+            "roundup_power2_divisions must be a power of two, got ", value);
+        m_roundup_power2_divisions = n;
+      } else if (key == "garbage_collection_threshold") {
+        const double threshold = parseDouble(key, value);
+        TORCH_CHECK(threshold > 0 && threshold < 1,
+            "garbage_collection_threshold must be in (0.0, 1.0), got ", value);
+        m_garbage_collection_threshold = threshold;
+      } else if (key == "expandable_segments") {
+        m_expandable_segments = parseBool(key, value);
+      } else {
+        TORCH_CHECK(false, "Unrecognized CUDA caching allocator option: ", key);
+      }
+    }
+  }
+
+  size_t m_max_split_size;
+  size_t m_roundup_power2_divisions;
+  double m_garbage_collection_threshold;
+  bool m_expandable_segments;
+};
+
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+
+#define C10_FORALL_EXPANDABLE_SEGMENT_DRIVER_API(_) \
+  _(cuGetErrorString)                               \
+  _(cuMemAddressReserve)                            \
+  _(cuMemAddressFree)                               \
+  _(cuMemCreate)                                    \
+  _(cuMemRelease)                                   \
+  _(cuMemMap)                                       \
+  _(cuMemUnmap)                                     \
+  _(cuMemSetAccess)                                 \
+  _(cuMemGetAllocationGranularity)
+
+// Driver API entry points used by expandable segments, looked up once from
+// the libcuda already loaded by the runtime.
+struct DriverAPI {
+#define CREATE_MEMBER(name) decltype(&name) name##_ = nullptr;
+  C10_FORALL_EXPANDABLE_SEGMENT_DRIVER_API(CREATE_MEMBER)
+#undef CREATE_MEMBER
+  bool available = false;
+
+  // Returns nullptr if the driver could not be loaded.
+  static const DriverAPI* get() {
+    static DriverAPI* s_api = []() {
+      auto api = new DriverAPI();
+      void* handle = dlopen("libcuda.so.1", RTLD_LAZY | RTLD_NOLOAD);
+      if (!handle) {
+        handle = dlopen("libcuda.so.1", RTLD_LAZY);
+      }
+      if (!handle) {
+        return api;
+      }
+      api->available = true;
+#define LOOKUP_ENTRY(name)                                          \
+      api->name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+      api->available = api->available && api->name##_ != nullptr;
+      C10_FORALL_EXPANDABLE_SEGMENT_DRIVER_API(LOOKUP_ENTRY)
+#undef LOOKUP_ENTRY
+      return api;
+    }();
+    return s_api->available ? s_api : nullptr;
+  }
+};
+
+#undef C10_FORALL_EXPANDABLE_SEGMENT_DRIVER_API
+
+#define C10_CUDA_DRIVER_CHECK(api, EXPR)                          \
+  do {                                                            \
+    CUresult __err = EXPR;                                        \
+    if (__err != CUDA_SUCCESS) {                                  \
+      const char* err_str = nullptr;                              \
+      api->cuGetErrorString_(__err, &err_str);                    \
+      TORCH_CHECK(false, "CUDA driver error: ", err_str ? err_str : "unknown"); \
+    }                                                             \
+  } while (0)
+
+#endif // C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+
 struct Block;
+struct PrivatePool;
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+
+struct BlockPool {
+  BlockPool(Comparison comparator, bool small, PrivatePool* private_pool = nullptr) :
+    blocks(comparator), is_small(small), owner_PrivatePool(private_pool) { }
+  std::set<Block*, Comparison> blocks;
+  const bool is_small;
+  PrivatePool* owner_PrivatePool;  // null for the default pools
+};
+
+// A virtual address range, large enough to hold all of device memory, whose
+// prefix [ptr, ptr + mapped_size) is backed by physical pages of page_size
+// bytes. The blocks of the segment form a single prev/next chain starting at
+// ptr, and tail is the last of them. The segment only ever grows or shrinks
+// at its end, so the mapped range is always contiguous.
+struct ExpandableSegment {
+  int           device;
+  char*         ptr;          // base of the reserved address range
+  size_t        max_size;     // size of the reserved address range
+  size_t        page_size;    // granularity of physical allocations
+  size_t        mapped_size;  // bytes currently backed by physical memory
+  Block*        tail;         // block ending at ptr + mapped_size, if any
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+  std::vector<CUmemGenericAllocationHandle> handles; // one per mapped page
+#endif
+
+  ExpandableSegment(int device, char* ptr, size_t max_size, size_t page_size) :
+    device(device), ptr(ptr), max_size(max_size), page_size(page_size),
+    mapped_size(0), tail(nullptr) { }
+
+  // Reserves the address range for a new segment on the current device.
+  // Returns nullptr if the driver does not support virtual memory management.
+  static ExpandableSegment* create(int device, size_t min_page_size) {
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+    const DriverAPI* api = DriverAPI::get();
+    if (!api) {
+      return nullptr;
+    }
+    CUmemAllocationProp prop = physical_properties(device);
+    size_t granularity = 0;
+    if (api->cuMemGetAllocationGranularity_(
+            &granularity, &prop, CU_MEM_ALLOC_GRANULARITY_RECOMMENDED) != CUDA_SUCCESS
+        || granularity == 0) {
+      return nullptr;
+    }
+    const size_t page_size =
+        granularity * ((min_page_size + granularity - 1) / granularity);
+
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    const size_t max_size =
+        page_size * ((device_total + page_size - 1) / page_size);
+
+    CUdeviceptr base = 0;
+    if (api->cuMemAddressReserve_(&base, max_size, 0, 0, 0) != CUDA_SUCCESS) {
+      return nullptr;
+    }
+    return new ExpandableSegment(
+        device, reinterpret_cast<char*>(base), max_size, page_size);
+#else
+    return nullptr;
+#endif
+  }
+
+  // Backs [ptr + mapped_size, ptr + mapped_size + size) with physical memory.
+  // size must be a multiple of page_size. Returns cudaErrorMemoryAllocation
+  // if the device does not have enough free memory.
+  cudaError_t grow(size_t size) {
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+    const DriverAPI* api = DriverAPI::get();
+    TORCH_INTERNAL_ASSERT(api && size % page_size == 0);
+    if (mapped_size + size > max_size) {
+      return cudaErrorMemoryAllocation;
+    }
+    const CUmemAllocationProp prop = physical_properties(device);
+    const size_t begin = handles.size();
+    for (size_t offset = 0; offset < size; offset += page_size) {
+      CUmemGenericAllocationHandle handle;
+      CUresult status = api->cuMemCreate_(&handle, page_size, &prop, 0);
+      if (status == CUDA_SUCCESS) {
+        status = api->cuMemMap_(page_address(handles.size()), page_size, 0, handle, 0);
+        if (status != CUDA_SUCCESS) {
+          C10_CUDA_DRIVER_CHECK(api, api->cuMemRelease_(handle));
+        }
+      }
+      if (status != CUDA_SUCCESS) {
+        // roll back the pages mapped by this call
+        unmap_pages(handles.size() - begin);
+        if (status == CUDA_ERROR_OUT_OF_MEMORY) {
+          return cudaErrorMemoryAllocation;
+        }
+        C10_CUDA_DRIVER_CHECK(api, status);
+      }
+      handles.push_back(handle);
+    }
+
+    CUmemAccessDesc desc;
+    desc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    desc.location.id = device;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(api, api->cuMemSetAccess_(
+        page_address(begin), size, &desc, 1));
+    mapped_size += size;
+    return cudaSuccess;
+#else
+    return cudaErrorMemoryAllocation;
+#endif
+  }
+
+  // Releases the physical memory of the last size bytes of the segment.
+  void shrink(size_t size) {
+    TORCH_INTERNAL_ASSERT(size % page_size == 0 && size <= mapped_size);
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+    // Pages may still be in use by kernels that touched the freed blocks.
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    unmap_pages(size / page_size);
+#endif
+    mapped_size -= size;
+  }
+
+ private:
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+  static CUmemAllocationProp physical_properties(int device) {
+    CUmemAllocationProp prop;
+    memset(&prop, 0, sizeof(prop));
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    return prop;
+  }
+
+  CUdeviceptr page_address(size_t page) const {
+    return reinterpret_cast<CUdeviceptr>(ptr) + page * page_size;
+  }
+
+  void unmap_pages(size_t count) {
+    const DriverAPI* api = DriverAPI::get();
+    for (size_t i = 0; i < count; ++i) {
+      const size_t page = handles.size() - 1;
+      C10_CUDA_DRIVER_CHECK(api, api->cuMemUnmap_(page_address(page), page_size));
+      C10_CUDA_DRIVER_CHECK(api, api->cuMemRelease_(handles[page]));
+      handles.pop_back();
+    }
+  }
+#endif
+};
 
 struct Block {
   int           device;      // gpu
@@ -112,15 +476,20 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  int           gc_count;    // pool searches since the block was cached
+  ExpandableSegment* expandable_segment; // owning segment if not from cudaMalloc
+  std::shared_ptr<Context> context_when_allocated; // only if history is recorded
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    gc_count(0), expandable_segment(nullptr) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    gc_count(0), expandable_segment(nullptr) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
@@ -176,8 +545,42 @@ struct AllocParams {
   Block* block;
   StatTypes stat_types;
   cudaError_t err;
+  std::shared_ptr<Context> context;
+};
+
+// The memory pool of one or more CUDA graphs, see notifyCaptureBegin().
+struct PrivatePool {
+  PrivatePool() :
+    use_count(1),
+    cudaMalloc_count(0),
+    large_blocks(BlockComparator, /*is_small=*/false, this),
+    small_blocks(BlockComparator, /*is_small=*/true, this) { }
+  PrivatePool(const PrivatePool&) = delete;
+  PrivatePool& operator=(const PrivatePool&) = delete;
+  // number of live graphs using this pool
+  int use_count;
+  // number of unfreed cudaMallocs made for this pool. When use_count and
+  // cudaMalloc_count drop to zero, the pool can be deleted.
+  int cudaMalloc_count;
+  BlockPool large_blocks;
+  BlockPool small_blocks;
 };
 
+cudaError_t cudaMallocMaybeCapturing(void** ptr, size_t size, bool capture_underway) {
+#ifdef C10_CUDA_HAS_GRAPHS
+  if (capture_underway) {
+    // cudaMalloc is not a stream operation, but is prohibited during a
+    // global mode capture unless this thread relaxes the restriction.
+    cudaStreamCaptureMode mode = cudaStreamCaptureModeRelaxed;
+    C10_CUDA_CHECK(cudaThreadExchangeStreamCaptureMode(&mode));
+    cudaError_t err = cudaMalloc(ptr, size);
+    C10_CUDA_CHECK(cudaThreadExchangeStreamCaptureMode(&mode));
+    return err;
+  }
+#endif
+  return cudaMalloc(ptr, size);
+}
+
 } // namespace
 
 class DeviceCachingAllocator {
@@ -202,26 +605,74 @@ class DeviceCachingAllocator {
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // total memory of the device, queried lazily for garbage collection
+  size_t device_total_memory = 0;
+
+  // expandable segments backing the large pool, one per stream
+  std::unordered_map<cudaStream_t, std::unique_ptr<ExpandableSegment>> expandable_segments;
+
+  // IPC handles of the segments exported through getIpcMemHandle, by segment
+  // base address; dropped when the segment is cudaFree'd.
+  std::unordered_map<void*, cudaIpcMemHandle_t> ipc_mem_handles;
+
+  // history recording, see recordHistory(). The context recorder is read
+  // without holding the lock, since it must be called before acquiring it.
+  std::atomic<CreateContextFn> context_recorder;
+  bool record_history = false;
+  size_t alloc_trace_max_entries = 1;
+  size_t alloc_trace_next = 0;
+  std::vector<TraceEntry> alloc_trace;
+
+  // private pools of CUDA graphs, see notifyCaptureBegin()
+  std::map<MempoolId_t, std::unique_ptr<PrivatePool>> graph_pools;
+
+  // pools no longer used by any graph, whose cached blocks are freed by
+  // free_cached_blocks()
+  std::map<MempoolId_t, PrivatePool*> graph_pools_freeable;
+
+  // private pool of each capture currently underway
+  std::unordered_map<CaptureId_t, PrivatePool*> capture_to_pool_map;
+
+  // number of captures currently underway
+  int captures_underway = 0;
+
+  // blocks freed during a capture whose stream uses can only be recorded
+  // once no capture is underway
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
  public:
 
   DeviceCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(BlockComparator, /*is_small=*/false),
+      small_blocks(BlockComparator, /*is_small=*/true),
+      context_recorder(nullptr) {}
 
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
 
   Block* malloc(int device, size_t size, cudaStream_t stream)
   {
+    // The recorder may e.g. need the GIL, so it is called before locking to
+    // avoid lock inversions.
+    std::shared_ptr<Context> context = maybe_gather_context();
+
     std::unique_lock<std::recursive_mutex> lock(mutex);
 
-    // process outstanding cudaEvents
-    process_events();
+    if (C10_LIKELY(captures_underway == 0)) {
+      // Processes end-of-life events for outstanding allocations used on
+      // multiple streams (checks if their GPU-side uses are complete and
+      // recycles their memory if so). Querying events is not allowed during
+      // a capture, so freed blocks of multi-stream allocations are only
+      // recycled once it ends.
+      insert_events_deferred_until_no_capture();
+      process_events();
+    }
 
     size = round_size(size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
+    params.context = context;
     params.stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
     params.stat_types[static_cast<size_t>(get_stat_type_for_pool(pool))] = true;
 
@@ -229,11 +680,23 @@ class DeviceCachingAllocator {
       // Search pool
       get_free_block(params)
       // Trigger callbacks and retry search
-      || (trigger_free_memory_callbacks(params) && get_free_block(params))
-      // Attempt allocate
-      || alloc_block(params, false)
-      // Free all non-split cached blocks and retry alloc.
-      || (free_cached_blocks() && alloc_block(params, true));
+      || (trigger_free_memory_callbacks(params) && get_free_block(params));
+
+    if (!block_found && captures_underway > 0) {
+      // Freeing memory synchronizes the device, which a capture forbids.
+      block_found = alloc_block(params, false);
+    } else if (!block_found) {
+      // Release long-unused cached blocks before reserving more memory.
+      garbage_collect_cached_blocks(params);
+
+      block_found =
+        // Attempt allocate
+        alloc_block(params, false)
+        // Free enough oversize cached blocks to satisfy the request and retry alloc.
+        || (release_available_cached_blocks(params) && alloc_block(params, false))
+        // Free all non-split cached blocks and retry alloc.
+        || (free_cached_blocks() && alloc_block(params, true));
+    }
 
     TORCH_INTERNAL_ASSERT((!block_found && params.err != cudaSuccess) || params.block);
     if (!block_found) {
@@ -244,6 +707,8 @@ class DeviceCachingAllocator {
 
         stats.num_ooms += 1;
 
+        record_trace(TraceEntry::OOM, device_free, alloc_size, stream, context);
+
         // "total capacity": total global memory on GPU
         // "already allocated": memory allocated by the program using the
         //                      caching allocator
@@ -284,6 +749,7 @@ class DeviceCachingAllocator {
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->expandable_segment = remaining->expandable_segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -293,7 +759,7 @@ class DeviceCachingAllocator {
       remaining->prev = block;
       remaining->ptr = static_cast<char*>(remaining->ptr) + size;
       remaining->size -= size;
-      pool.insert(remaining);
+      pool.blocks.insert(remaining);
 
       if (already_split) {
         // An already-split inactive block is being shrunk by size bytes.
@@ -311,7 +777,10 @@ class DeviceCachingAllocator {
     }
 
     block->allocated = true;
+    block->context_when_allocated = std::move(context);
     active_blocks.insert(block);
+    record_trace(TraceEntry::ALLOC, reinterpret_cast<int64_t>(block->ptr),
+                 block->size, stream, block->context_when_allocated);
 
     c10::reportMemoryUsageToProfiler(
         block, block->size, c10::Device(c10::DeviceType::CUDA, device));
@@ -330,6 +799,10 @@ class DeviceCachingAllocator {
 
     block->allocated = false;
 
+    record_trace(TraceEntry::FREE, reinterpret_cast<int64_t>(block->ptr),
+                 block->size, block->stream, block->context_when_allocated);
+    block->context_when_allocated.reset();
+
     c10::reportMemoryUsageToProfiler(
         block, -block->size, c10::Device(c10::DeviceType::CUDA, block->device));
 
@@ -340,7 +813,12 @@ class DeviceCachingAllocator {
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      if (C10_UNLIKELY(captures_underway > 0)) {
+        // Recording events on the stream uses would add them to the graph.
+        needs_events_deferred_until_no_capture.push_back(block);
+      } else {
+        insert_events(block);
+      }
     } else {
       free_block(block);
     }
@@ -363,6 +841,20 @@ class DeviceCachingAllocator {
     return basePtr;
   }
 
+  std::string getIpcMemHandle(Block* block, ptrdiff_t* offset_bytes) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    void* base_ptr = getBaseAllocation(block, nullptr);
+    *offset_bytes = static_cast<char*>(block->ptr) - static_cast<char*>(base_ptr);
+    auto it = ipc_mem_handles.find(base_ptr);
+    if (it == ipc_mem_handles.end()) {
+      cudaIpcMemHandle_t handle;
+      C10_CUDA_CHECK(cudaIpcGetMemHandle(&handle, base_ptr));
+      it = ipc_mem_handles.emplace(base_ptr, handle).first;
+    }
+    return std::string(
+        reinterpret_cast<const char*>(&it->second), sizeof(cudaIpcMemHandle_t));
+  }
+
   void recordStream(Block* block, cuda::CUDAStream stream) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     if (stream.stream() == block->stream) {
@@ -433,6 +925,29 @@ class DeviceCachingAllocator {
     }
   }
 
+  /** Starts or stops recording allocation history for the device **/
+  void recordHistory(
+      bool enabled,
+      CreateContextFn recorder,
+      size_t max_entries) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    record_history = enabled;
+    context_recorder.store(enabled ? recorder : nullptr);
+    alloc_trace_max_entries = std::max(size_t(1), max_entries);
+    alloc_trace_next = 0;
+    alloc_trace.clear();
+  }
+
+  /** Returns the recorded history of the device, oldest entry first **/
+  std::vector<TraceEntry> trace() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<TraceEntry> result;
+    result.reserve(alloc_trace.size());
+    result.insert(result.end(), alloc_trace.begin() + alloc_trace_next, alloc_trace.end());
+    result.insert(result.end(), alloc_trace.begin(), alloc_trace.begin() + alloc_trace_next);
+    return result;
+  }
+
   /** Dump a complete snapshot of the memory held by the allocator. Potentially VERY expensive. **/
   std::vector<SegmentInfo> snapshot() const {
     std::lock_guard<std::recursive_mutex> lock(mutex);
@@ -448,7 +963,8 @@ class DeviceCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.stream = head_block->stream;
+      segment_info.is_large = !head_block->pool->is_small;
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -458,6 +974,7 @@ class DeviceCachingAllocator {
         block_info.size = block->size;
         block_info.allocated = block->allocated;
         block_info.active = block->allocated || (block->event_count > 0);
+        block_info.context_when_allocated = block->context_when_allocated;
 
         segment_info.total_size += block_info.size;
         if (block_info.allocated) {
@@ -478,22 +995,114 @@ class DeviceCachingAllocator {
     return result;
   }
 
+  /** Directs allocations on the capturing stream of graph_id to a private pool **/
+  void notifyCaptureBegin(CaptureId_t graph_id, MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    captures_underway++;
+    auto it = graph_pools.find(mempool_id);
+    if (it == graph_pools.end()) {
+      // mempool_id does not reference an existing pool. Make a new pool for
+      // this capture.
+      it = graph_pools.emplace(
+          mempool_id, std::unique_ptr<PrivatePool>(new PrivatePool())).first;
+    } else {
+      // mempool_id references an existing pool, which the current capture
+      // will share.
+      TORCH_INTERNAL_ASSERT(it->second->use_count > 0);
+      it->second->use_count++;
+      graph_pools_freeable.erase(mempool_id);
+    }
+    capture_to_pool_map[graph_id] = it->second.get();
+  }
+
+  /** Stops directing allocations of graph_id's capture to its private pool **/
+  void notifyCaptureEnd(CaptureId_t graph_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    captures_underway--;
+    auto it = capture_to_pool_map.find(graph_id);
+    TORCH_INTERNAL_ASSERT(it != capture_to_pool_map.end());
+    capture_to_pool_map.erase(it);
+  }
+
+  /** Called by a graph's destructor; the pool is freed once no graph uses it **/
+  void notifyCaptureDestroy(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    TORCH_INTERNAL_ASSERT(it != graph_pools.end());
+    auto uc = --(it->second->use_count);
+    TORCH_INTERNAL_ASSERT(uc >= 0);
+    if (uc == 0) {
+      // Allows free_cached_blocks to cudaFree the pool's cached blocks.
+      graph_pools_freeable[mempool_id] = it->second.get();
+    }
+  }
+
   static size_t round_size(size_t size) {
     if (size < kMinBlockSize) {
       return kMinBlockSize;
-    } else {
-      return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
     }
+    const size_t divisions = CachingAllocatorConfig::roundup_power2_divisions();
+    if (divisions > 0 && size > kSmallSize) {
+      size = roundup_power2_next_division(size, divisions);
+    }
+    return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
+  }
+
+  // Rounds size up to the next multiple of (power2_floor(size) / divisions),
+  // e.g. with 4 divisions, 1200 becomes 1280, out of 1024, 1280, 1536, 1792.
+  static size_t roundup_power2_next_division(size_t size, size_t divisions) {
+    if ((size & (size - 1)) == 0) {
+      return size;
+    }
+    size_t power2_floor = 1;
+    while (power2_floor <= size / 2) {
+      power2_floor <<= 1;
+    }
+    const size_t step = power2_floor / divisions;
+    if (step == 0) {
+      return power2_floor << 1;
+    }
+    return step * ((size + step - 1) / step);
   }
 
  private:
 
   // All private methods do not acquire the allocator mutex.
 
+  std::shared_ptr<Context> maybe_gather_context() {
+    CreateContextFn recorder = context_recorder.load();
+    return recorder ? recorder() : nullptr;
+  }
+
+  void record_trace(
+      TraceEntry::Action action,
+      int64_t addr,
+      size_t size,
+      cudaStream_t stream,
+      std::shared_ptr<Context> context) {
+    if (!record_history) {
+      return;
+    }
+    TraceEntry entry(action, addr, size, stream, std::move(context));
+    if (alloc_trace.size() < alloc_trace_max_entries) {
+      alloc_trace.emplace_back(std::move(entry));
+    } else {
+      alloc_trace[alloc_trace_next++] = std::move(entry);
+      if (alloc_trace_next == alloc_trace_max_entries) {
+        alloc_trace_next = 0;
+      }
+    }
+  }
+
   std::vector<const Block*> get_all_blocks() const {
     std::vector<const Block*> blocks;
-    blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
-    blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    blocks.insert(blocks.end(), small_blocks.blocks.begin(), small_blocks.blocks.end());
+    blocks.insert(blocks.end(), large_blocks.blocks.begin(), large_blocks.blocks.end());
+    for (const auto& gp : graph_pools) {
+      const PrivatePool* pool = gp.second.get();
+      blocks.insert(blocks.end(), pool->small_blocks.blocks.begin(), pool->small_blocks.blocks.end());
+      blocks.insert(blocks.end(), pool->large_blocks.blocks.begin(), pool->large_blocks.blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
     return blocks;
   }
@@ -519,7 +1128,7 @@ class DeviceCachingAllocator {
     }
 
     active_blocks.erase(block);
-    pool.insert(block);
+    pool.blocks.insert(block);
 
     if (block->is_split()) {
       net_change_inactive_split_blocks += 1;
@@ -557,15 +1166,33 @@ class DeviceCachingAllocator {
       }
     }
 
+    if (src->expandable_segment && src->expandable_segment->tail == src) {
+      src->expandable_segment->tail = dst;
+    }
+
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
-    pool.erase(src);
+    pool.blocks.erase(src);
     delete src;
 
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, cudaStream_t stream) {
+#ifdef C10_CUDA_HAS_GRAPHS
+    if (C10_UNLIKELY(captures_underway > 0)) {
+      CaptureId_t id;
+      cudaStreamCaptureStatus status;
+      C10_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &id));
+      if (status != cudaStreamCaptureStatusNone) {
+        auto it = capture_to_pool_map.find(id);
+        TORCH_INTERNAL_ASSERT(it != capture_to_pool_map.end(),
+            "allocation on a stream captured without notifyCaptureBegin");
+        PrivatePool* pool = it->second;
+        return (size <= kSmallSize) ? pool->small_blocks : pool->large_blocks;
+      }
+    }
+#endif
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -574,23 +1201,16 @@ class DeviceCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return (size < CachingAllocatorConfig::max_split_size()) &&
+          (remaining > kSmallSize);
     }
   }
 
@@ -605,11 +1225,25 @@ class DeviceCachingAllocator {
   }
 
   bool get_free_block(AllocParams& p) {
-    BlockPool& pool = *p.pool;
+    auto& pool = p.pool->blocks;
+    if (CachingAllocatorConfig::garbage_collection_threshold() > 0) {
+      // Age the cached blocks; only tracked when garbage collection is enabled.
+      for (Block* block : pool) {
+        ++block->gc_count;
+      }
+    }
     auto it = pool.lower_bound(&p.search_key);
     if (it == pool.end() || (*it)->stream != p.stream())
       return false;
+    const size_t max_split_size = CachingAllocatorConfig::max_split_size();
+    // Do not let small requests use (and split) oversize blocks.
+    if ((p.size() < max_split_size) && ((*it)->size >= max_split_size))
+      return false;
+    // Do not waste too much of an oversize block on a smaller oversize request.
+    if ((p.size() >= max_split_size) && ((*it)->size >= p.size() + kLargeBuffer))
+      return false;
     p.block = *it;
+    p.block->gc_count = 0;
     pool.erase(it);
     return true;
   }
@@ -631,20 +1265,152 @@ class DeviceCachingAllocator {
       stats.num_alloc_retries += 1;
     }
 
-    p.err = cudaMalloc(&ptr, size);
+    if (p.pool == &large_blocks && CachingAllocatorConfig::expandable_segments()) {
+      ExpandableSegment* segment = get_expandable_segment(p.device(), p.stream());
+      if (segment) {
+        return expand_segment(segment, p);
+      }
+    }
+
+    p.err = cudaMallocMaybeCapturing(&ptr, size, captures_underway > 0);
     if (p.err != cudaSuccess) {
       if (!isRetry || p.err == cudaErrorMemoryAllocation)
         cudaGetLastError();  // clear CUDA error
       return false;
     }
 
+    if (p.pool->owner_PrivatePool) {
+      // The block is for a CUDA graph's private pool.
+      p.pool->owner_PrivatePool->cudaMalloc_count++;
+    }
+
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
     update_stat_array(stats.segment, 1, p.stat_types);
     update_stat_array(stats.reserved_bytes, size, p.stat_types);
+    record_trace(TraceEntry::SEGMENT_ALLOC, reinterpret_cast<int64_t>(ptr),
+                 size, p.stream(), p.context);
 
     return (p.block != nullptr);
   }
 
+  ExpandableSegment* get_expandable_segment(int device, cudaStream_t stream) {
+    auto it = expandable_segments.find(stream);
+    if (it == expandable_segments.end()) {
+      ExpandableSegment* segment = ExpandableSegment::create(device, kRoundLarge);
+      if (!segment) {
+        TORCH_WARN_ONCE(
+            "expandable_segments is not supported by this CUDA driver; "
+            "falling back to cudaMalloc for large allocations.");
+      }
+      // A null entry remembers that the driver lacks support.
+      it = expandable_segments.emplace(
+          stream, std::unique_ptr<ExpandableSegment>(segment)).first;
+    }
+    return it->second.get();
+  }
+
+  /** maps enough pages at the end of the segment to serve p.size() bytes */
+  bool expand_segment(ExpandableSegment* segment, AllocParams& p) {
+    // If the last block of the segment is free it is grown in place,
+    // otherwise a new block is appended behind it.
+    Block* tail = segment->tail;
+    const bool grow_tail = tail && !tail->allocated && tail->event_count == 0;
+    const size_t available = grow_tail ? tail->size : 0;
+    const size_t page_size = segment->page_size;
+    const size_t grow_size =
+        page_size * ((p.size() - available + page_size - 1) / page_size);
+
+    const bool was_empty = segment->mapped_size == 0;
+    p.err = segment->grow(grow_size);
+    if (p.err != cudaSuccess) {
+      return false;
+    }
+
+    if (was_empty) {
+      update_stat_array(stats.segment, 1, p.stat_types);
+    }
+    update_stat_array(stats.reserved_bytes, grow_size, p.stat_types);
+    record_trace(TraceEntry::SEGMENT_ALLOC,
+                 reinterpret_cast<int64_t>(segment->ptr + segment->mapped_size - grow_size),
+                 grow_size, p.stream(), p.context);
+
+    if (grow_tail) {
+      p.pool->blocks.erase(tail);
+      tail->size += grow_size;
+      if (tail->is_split()) {
+        update_stat_array(stats.inactive_split_bytes, grow_size, p.stat_types);
+      }
+      p.block = tail;
+    } else {
+      Block* block = new Block(p.device(), p.stream(), grow_size, p.pool,
+                               segment->ptr + segment->mapped_size - grow_size);
+      block->expandable_segment = segment;
+      block->prev = tail;
+      if (tail) {
+        tail->next = block;
+        // malloc() treats the new block as an inactive split block
+        update_stat_array(stats.inactive_split, 1, p.stat_types);
+        update_stat_array(stats.inactive_split_bytes, grow_size, p.stat_types);
+      }
+      segment->tail = block;
+      p.block = block;
+    }
+    return true;
+  }
+
+  /** unmaps the physical pages covered by the free tail of each segment */
+  void release_expandable_segments()
+  {
+    for (auto& entry : expandable_segments) {
+      ExpandableSegment* segment = entry.second.get();
+      Block* tail = segment ? segment->tail : nullptr;
+      if (!tail || tail->allocated || tail->event_count > 0) {
+        continue;
+      }
+
+      const size_t page_size = segment->page_size;
+      const size_t tail_begin = static_cast<char*>(tail->ptr) - segment->ptr;
+      const size_t release_begin =
+          page_size * ((tail_begin + page_size - 1) / page_size);
+      const size_t release_size = segment->mapped_size - release_begin;
+      if (release_size == 0) {
+        continue;
+      }
+
+      StatTypes stat_types;
+      stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+      stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+
+      large_blocks.blocks.erase(tail);
+      if (release_begin == tail_begin) {
+        if (tail->is_split()) {
+          update_stat_array(stats.inactive_split, -1, stat_types);
+          update_stat_array(stats.inactive_split_bytes, -tail->size, stat_types);
+        }
+        segment->tail = tail->prev;
+        if (tail->prev) {
+          tail->prev->next = nullptr;
+        }
+        delete tail;
+      } else {
+        tail->size -= release_size;
+        if (tail->is_split()) {
+          update_stat_array(stats.inactive_split_bytes, -release_size, stat_types);
+        }
+        large_blocks.blocks.insert(tail);
+      }
+
+      segment->shrink(release_size);
+      update_stat_array(stats.reserved_bytes, -release_size, stat_types);
+      record_trace(TraceEntry::SEGMENT_FREE,
+                   reinterpret_cast<int64_t>(segment->ptr + segment->mapped_size),
+                   release_size, entry.first, nullptr);
+      if (segment->mapped_size == 0) {
+        update_stat_array(stats.segment, -1, stat_types);
+      }
+    }
+  }
+
   bool free_cached_blocks()
   {
     // First ensure that all blocks that can't currently be allocated due to
@@ -654,30 +1420,153 @@ class DeviceCachingAllocator {
     // Free all non-split cached blocks
     free_blocks(large_blocks);
     free_blocks(small_blocks);
+    release_expandable_segments();
+
+    // Free the cached blocks of private pools no longer used by any graph,
+    // and the pools themselves once all of their memory is released.
+    for (auto it = graph_pools_freeable.begin(); it != graph_pools_freeable.end(); ) {
+      PrivatePool* pool = it->second;
+      TORCH_INTERNAL_ASSERT(pool->use_count == 0);
+      free_blocks(pool->large_blocks);
+      free_blocks(pool->small_blocks);
+      if (pool->cudaMalloc_count == 0) {
+        graph_pools.erase(it->first);
+        it = graph_pools_freeable.erase(it);
+      } else {
+        ++it;
+      }
+    }
     return true;
   }
 
-  void free_blocks(BlockPool& blocks)
+  static bool is_releasable(const Block* block) {
+    return !block->prev && !block->next && !block->expandable_segment;
+  }
+
+  /** frees the segment of a cached, non-split block with cudaFree */
+  void release_block(Block* block)
+  {
+    C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+    ipc_mem_handles.erase(block->ptr);
+
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
+    update_stat_array(stats.segment, -1, stat_types);
+    update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+    record_trace(TraceEntry::SEGMENT_FREE, reinterpret_cast<int64_t>(block->ptr),
+                 block->size, block->stream, nullptr);
+
+    if (block->pool->owner_PrivatePool) {
+      // The cudaFreed block belonged to a CUDA graph's private pool.
+      TORCH_INTERNAL_ASSERT(block->pool->owner_PrivatePool->cudaMalloc_count > 0);
+      block->pool->owner_PrivatePool->cudaMalloc_count--;
+    }
+
+    block->pool->blocks.erase(block);
+    delete block;
+  }
+
+  void free_blocks(BlockPool& pool)
   {
     // Frees all non-split blocks
+    auto& blocks = pool.blocks;
     auto it = blocks.begin();
     while (it != blocks.end()) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
-        C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+      ++it;
+      if (is_releasable(block)) {
+        release_block(block);
+      }
+    }
+  }
 
-        StatTypes stat_types;
-        stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
-        stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
-        update_stat_array(stats.segment, -1, stat_types);
-        update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+  /** frees the oversize cached blocks of the stream until p.size() bytes are released */
+  bool release_available_cached_blocks(AllocParams& p)
+  {
+    const size_t max_split_size = CachingAllocatorConfig::max_split_size();
+    if (max_split_size == std::numeric_limits<size_t>::max()) {
+      return false;
+    }
+    auto& pool = p.pool->blocks;
+    Block key = p.search_key;
+    key.size = std::max(key.size, max_split_size);
+    auto it = pool.lower_bound(&key);
+    if (it != pool.end() && (*it)->stream == p.stream() && is_releasable(*it)) {
+      // a single block is large enough
+      release_block(*it);
+      return true;
+    }
 
-        auto cur = it;
-        ++it;
-        blocks.erase(cur);
-        delete block;
-      } else {
+    // Otherwise free the largest oversize blocks until enough is released.
+    size_t total_released = 0;
+    while (total_released < key.size && it != pool.begin()) {
+      --it;
+      Block* block = *it;
+      if (block->stream != p.stream() || block->size < max_split_size) {
+        break;
+      }
+      if (is_releasable(block)) {
+        total_released += block->size;
+        // advancing first keeps 'it' valid; the loop decrements it again
         ++it;
+        release_block(block);
+      }
+    }
+    return total_released >= key.size;
+  }
+
+  /** frees cached blocks that have not been reused for a long time */
+  void garbage_collect_cached_blocks(AllocParams& p)
+  {
+    const double threshold = CachingAllocatorConfig::garbage_collection_threshold();
+    if (threshold <= 0) {
+      return;
+    }
+    if (device_total_memory == 0) {
+      size_t device_free;
+      C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total_memory));
+    }
+    const size_t gc_threshold = static_cast<size_t>(threshold * device_total_memory);
+    const size_t reserved = static_cast<size_t>(
+        stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current);
+    if (reserved + p.alloc_size <= gc_threshold) {
+      return;
+    }
+    const size_t target_size = reserved + p.alloc_size - gc_threshold;
+
+    // Blocks aged at least the average of all releasable blocks are freed
+    // first, oldest pool first, until enough memory is reclaimed.
+    size_t gc_reclaimed = 0;
+    bool block_freed = true;
+    while (gc_reclaimed < target_size && block_freed) {
+      double total_age = 0;
+      int freeable_blocks = 0;
+      for (BlockPool* pool : {&large_blocks, &small_blocks}) {
+        for (const Block* block : pool->blocks) {
+          if (is_releasable(block)) {
+            total_age += block->gc_count;
+            ++freeable_blocks;
+          }
+        }
+      }
+      if (freeable_blocks == 0) {
+        break;
+      }
+      const double age_threshold = total_age / freeable_blocks;
+
+      block_freed = false;
+      for (BlockPool* pool : {&large_blocks, &small_blocks}) {
+        auto it = pool->blocks.begin();
+        while (it != pool->blocks.end() && gc_reclaimed < target_size) {
+          Block* block = *it;
+          ++it;
+          if (is_releasable(block) && block->gc_count >= age_threshold) {
+            block_freed = true;
+            gc_reclaimed += block->size;
+            release_block(block);
+          }
+        }
       }
     }
   }
@@ -731,6 +1620,17 @@ class DeviceCachingAllocator {
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
   }
 
+  void insert_events_deferred_until_no_capture()
+  {
+    if (C10_UNLIKELY(!needs_events_deferred_until_no_capture.empty())) {
+      for (Block* block : needs_events_deferred_until_no_capture) {
+        TORCH_INTERNAL_ASSERT(!block->stream_uses.empty());
+        insert_events(block);
+      }
+      needs_events_deferred_until_no_capture.clear();
+    }
+  }
+
   void process_events()
   {
     // Process outstanding cudaEvents. Events that are completed are removed
@@ -763,9 +1663,9 @@ class DeviceCachingAllocator {
   }
 
   // Accumulates sizes of all memory blocks for given device in given pool
-  void cache_info_aux(BlockPool& blocks, size_t* total, size_t* largest)
+  void cache_info_aux(const BlockPool& pool, size_t* total, size_t* largest)
   {
-    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    for (auto it = pool.blocks.begin(); it != pool.blocks.end(); ++it) {
       size_t blocksize = (*it)->size;
       *total += blocksize;
       if (blocksize > *largest) {
@@ -861,6 +1761,15 @@ class THCCachingAllocator {
     return device_allocator[block->device]->getBaseAllocation(block, outSize);
   }
 
+  std::string getIpcMemHandle(void* ptr, ptrdiff_t* offset_bytes)
+  {
+    Block* block = get_allocated_block(ptr);
+    if (!block) {
+      AT_ERROR("invalid device pointer: ", ptr);
+    }
+    return device_allocator[block->device]->getIpcMemHandle(block, offset_bytes);
+  }
+
   void recordStream(const DataPtr& ptr, cuda::CUDAStream stream) {
     // Empty tensor's storage().data() might be a null ptr. As there is no
     // blocks associated with those tensors, it is fine to do nothing here.
@@ -882,16 +1791,28 @@ class THCCachingAllocator {
     device_allocator[block->device]->recordStream(block, stream);
   }
 
-  std::vector<SegmentInfo> snapshot() {
-    std::vector<SegmentInfo> result;
+  SnapshotInfo snapshot() {
+    SnapshotInfo result;
     int count = device_allocator.size();
     for (int i = 0; i < count; i++) {
       auto snap = device_allocator[i]->snapshot();
-      result.insert(result.end(), snap.begin(), snap.end());
+      result.segments.insert(result.segments.end(), snap.begin(), snap.end());
+      result.device_traces.emplace_back(device_allocator[i]->trace());
     }
 
     return result;
   }
+
+  void recordHistory(
+      bool enabled,
+      CreateContextFn context_recorder,
+      size_t alloc_trace_max_entries) {
+    int count = device_allocator.size();
+    for (int i = 0; i < count; i++) {
+      device_allocator[i]->recordHistory(
+          enabled, context_recorder, alloc_trace_max_entries);
+    }
+  }
 };
 
 THCCachingAllocator caching_allocator;
@@ -938,6 +1859,11 @@ void* getBaseAllocation(void *ptr, size_t *size)
   return caching_allocator.getBaseAllocation(ptr, size);
 }
 
+std::string getIpcMemHandle(void *ptr, ptrdiff_t *offset_bytes)
+{
+  return caching_allocator.getIpcMemHandle(ptr, offset_bytes);
+}
+
 void recordStream(const DataPtr& ptr, cuda::CUDAStream stream)
 {
   caching_allocator.recordStream(ptr, stream);
@@ -968,10 +1894,33 @@ void resetPeakStats(int device) {
   caching_allocator.device_allocator[device]->resetPeakStats();
 }
 
-std::vector<SegmentInfo> snapshot() {
+SnapshotInfo snapshot() {
   return caching_allocator.snapshot();
 }
 
+void recordHistory(
+    bool enabled,
+    CreateContextFn context_recorder,
+    size_t alloc_trace_max_entries) {
+  caching_allocator.recordHistory(
+      enabled, context_recorder, alloc_trace_max_entries);
+}
+
+void notifyCaptureBegin(int device, CaptureId_t graph_id, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureBegin(graph_id, mempool_id);
+}
+
+void notifyCaptureEnd(int device, CaptureId_t graph_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureEnd(graph_id);
+}
+
+void notifyCaptureDestroy(int device, MempoolId_t mempool_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureDestroy(mempool_id);
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
@@ -7,7 +7,11 @@
 #include <c10/util/Registry.h>
 
 #include <array>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace c10 {
 
@@ -87,11 +91,20 @@ struct DeviceStats {
   int64_t num_ooms = 0;
 };
 
+// Opaque information attached to allocations and trace entries while history
+// recording is enabled, e.g. the stack trace of the code that allocated.
+struct C10_CUDA_API Context {
+  virtual ~Context() {}
+};
+
+typedef std::shared_ptr<Context> (*CreateContextFn)(void);
+
 // Struct containing info of an allocation block (i.e. a fractional part of a cudaMalloc)..
 struct BlockInfo {
   int64_t size = 0;
   bool allocated = false;
   bool active = false;
+  std::shared_ptr<Context> context_when_allocated;  // only if recorded
 };
 
 // Struct containing info of a memory segment (i.e. one contiguous cudaMalloc).
@@ -101,10 +114,45 @@ struct SegmentInfo {
   int64_t total_size = 0;
   int64_t allocated_size = 0;
   int64_t active_size = 0;
+  cudaStream_t stream = 0;
   bool is_large = false;
   std::vector<BlockInfo> blocks;
 };
 
+// An event in the recorded allocation history of a device.
+struct TraceEntry {
+  enum Action {
+    ALLOC,          // client code asked for memory
+    FREE,           // client code returned memory
+    SEGMENT_ALLOC,  // the allocator reserved memory from CUDA
+    SEGMENT_FREE,   // the allocator returned memory to CUDA
+    OOM             // the allocator failed to get memory; addr is the free device memory
+  };
+  TraceEntry(
+      Action action,
+      int64_t addr,
+      size_t size,
+      cudaStream_t stream,
+      std::shared_ptr<Context> context = nullptr)
+      : action(action),
+        addr(addr),
+        size(size),
+        stream(stream),
+        context(std::move(context)) {}
+  Action action;
+  int64_t addr;
+  int64_t size;
+  cudaStream_t stream;
+  std::shared_ptr<Context> context;
+};
+
+// Segments of all devices, plus the recorded history of each device, oldest
+// entry first.
+struct SnapshotInfo {
+  std::vector<SegmentInfo> segments;
+  std::vector<std::vector<TraceEntry>> device_traces;
+};
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -114,14 +162,42 @@ C10_CUDA_API void init(int device_count);
 C10_CUDA_API void emptyCache();
 C10_CUDA_API void cacheInfo(int dev_id, size_t* cachedAndFree, size_t* largestBlock);
 C10_CUDA_API void* getBaseAllocation(void *ptr, size_t *size);
+// cudaIpcMemHandle_t (as bytes) of the segment containing ptr, and the offset
+// of ptr within it. The handle is exported once per segment and cached until
+// the segment is freed, so sharing many tensors of a segment is cheap.
+C10_CUDA_API std::string getIpcMemHandle(void *ptr, ptrdiff_t *offset_bytes);
 C10_CUDA_API void recordStream(const DataPtr&, CUDAStream stream);
 C10_CUDA_API DeviceStats getDeviceStats(int device);
 C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
-C10_CUDA_API std::vector<SegmentInfo> snapshot();
+C10_CUDA_API SnapshotInfo snapshot();
+
+// Starts (or stops) recording, for all devices, the context of each live
+// allocation and a ring buffer of the last alloc_trace_max_entries allocator
+// events. context_recorder may be null, in which case no context is kept. It
+// is called outside of the allocator lock for every allocation, so it should
+// be cheap.
+C10_CUDA_API void recordHistory(
+    bool enabled,
+    CreateContextFn context_recorder,
+    size_t alloc_trace_max_entries);
 
 C10_CUDA_API std::mutex* getFreeMutex();
 
+// CUDA graphs support. A capture id identifies a stream capture, and a
+// MempoolId_t the private memory pool used by one or more graphs.
+typedef unsigned long long CaptureId_t;
+typedef std::pair<CaptureId_t, CaptureId_t> MempoolId_t;
+
+// Until notifyCaptureEnd, allocations on the stream being captured as
+// graph_id are served from the private pool mempool_id (created if it does
+// not exist yet).
+C10_CUDA_API void notifyCaptureBegin(int device, CaptureId_t graph_id, MempoolId_t mempool_id);
+C10_CUDA_API void notifyCaptureEnd(int device, CaptureId_t graph_id);
+// Called when a graph using mempool_id is destroyed; the pool's memory is
+// released by emptyCache() once no graph uses it anymore.
+C10_CUDA_API void notifyCaptureDestroy(int device, MempoolId_t mempool_id);
+
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
 } // namespace CUDACachingAllocator
 
@@ -6,7 +6,10 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include <iostream>
@@ -35,13 +38,18 @@ struct LeakyStreamInternals {
   DeviceIndex device_index = -1;
   int32_t stream_id = -1;
   cudaStream_t stream = nullptr;
+  // Number of live reservations of this stream, see reserveStreamFromPool
+  std::atomic<int> reservations{0};
 };
 
 // Global stream state and constants
 static DeviceIndex num_gpus = -1;
-static constexpr int kStreamsPerPoolBits = 5;
-static constexpr int kStreamsPerPool = 1 << kStreamsPerPoolBits;
+static constexpr int kStreamsPerPoolBits = 10;
+static constexpr int kMaxStreamsPerPool = 1 << kStreamsPerPoolBits;
+static constexpr int kDefaultStreamsPerPool = 32;
 static constexpr unsigned int kDefaultFlags = cudaStreamNonBlocking;
+// Set from PYTORCH_CUDA_STREAMS_PER_POOL when the stream state is initialized
+static int streams_per_pool = kDefaultStreamsPerPool;
 
 // Note: stream priority is not supported by HIP
 // Note: lower numbers are higher priorities, zero is default priority
@@ -68,16 +76,16 @@ static LeakyStreamInternals default_streams[C10_COMPILE_TIME_MAX_GPUS];
 static std::once_flag device_flags[C10_COMPILE_TIME_MAX_GPUS];
 static std::atomic<uint32_t> low_priority_counters[C10_COMPILE_TIME_MAX_GPUS];
 static std::atomic<uint32_t> high_priority_counters[C10_COMPILE_TIME_MAX_GPUS];
-static std::array<LeakyStreamInternals, kStreamsPerPool>
+static std::unique_ptr<LeakyStreamInternals[]>
     low_priority_streams[C10_COMPILE_TIME_MAX_GPUS];
-static std::array<LeakyStreamInternals, kStreamsPerPool>
+static std::unique_ptr<LeakyStreamInternals[]>
     high_priority_streams[C10_COMPILE_TIME_MAX_GPUS];
 
 // Note [StreamId assignment]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // How do we assign stream IDs?
 //
-// -- 25 bits -- -- 2 bits --  -- 5 bits -----
+// -- 20 bits -- -- 2 bits --  -- 10 bits -----
 // zeros         StreamIdType  stream id index
 //
 // Where StreamIdType:
@@ -141,10 +149,10 @@ StreamId makeStreamId(StreamIdType st, size_t si) {
       static_cast<StreamId>(si);
 }
 
-template <typename T, typename A>
-static bool pointer_within(const T* ptr, const A& arr) {
-  return std::greater_equal<const T*>()(ptr, arr.data()) &&
-      std::less<const T*>()(ptr, arr.data() + arr.size());
+template <typename T>
+static bool pointer_within(const T* ptr, const T* data, size_t size) {
+  return data != nullptr && std::greater_equal<const T*>()(ptr, data) &&
+      std::less<const T*>()(ptr, data + size);
 }
 
 static StreamId CUDAStream_getStreamId(const LeakyStreamInternals* ptr) {
@@ -166,16 +174,16 @@ static StreamId CUDAStream_getStreamId(const LeakyStreamInternals* ptr) {
   // std::less and similar templates to avoid UB that arises when
   // doing an operator< comparison.
   if (pointer_within<LeakyStreamInternals>(
-          ptr, low_priority_streams[device_index])) {
+          ptr, low_priority_streams[device_index].get(), streams_per_pool)) {
     return makeStreamId(
-        StreamIdType::LOW, ptr - low_priority_streams[device_index].data());
+        StreamIdType::LOW, ptr - low_priority_streams[device_index].get());
   }
 
   // Check if it's a high priority stream
   if (pointer_within<LeakyStreamInternals>(
-          ptr, high_priority_streams[device_index])) {
+          ptr, high_priority_streams[device_index].get(), streams_per_pool)) {
     return makeStreamId(
-        StreamIdType::HIGH, ptr - high_priority_streams[device_index].data());
+        StreamIdType::HIGH, ptr - high_priority_streams[device_index].get());
   }
 
   AT_ASSERTM(
@@ -207,6 +215,16 @@ static void initGlobalStreamState() {
       C10_COMPILE_TIME_MAX_GPUS,
       "). Increase that and recompile.");
 
+  if (const char* env = getenv("PYTORCH_CUDA_STREAMS_PER_POOL")) {
+    streams_per_pool = std::stoi(env);
+    TORCH_CHECK(
+        streams_per_pool >= 1 && streams_per_pool <= kMaxStreamsPerPool,
+        "PYTORCH_CUDA_STREAMS_PER_POOL must be between 1 and ",
+        kMaxStreamsPerPool,
+        ", got ",
+        env);
+  }
+
   // Initializes default streams
   for (auto i = decltype(num_gpus){0}; i < num_gpus; ++i) {
     default_streams[i].device_index = i;
@@ -222,7 +240,11 @@ static void initDeviceStreamState(DeviceIndex device_index) {
   // with it.
   CUDAGuard device_guard{device_index};
 
-  for (auto i = decltype(kStreamsPerPool){0}; i < kStreamsPerPool; ++i) {
+  low_priority_streams[device_index].reset(
+      new LeakyStreamInternals[streams_per_pool]);
+  high_priority_streams[device_index].reset(
+      new LeakyStreamInternals[streams_per_pool]);
+  for (auto i = decltype(streams_per_pool){0}; i < streams_per_pool; ++i) {
     auto& lowpri_stream = low_priority_streams[device_index][i];
     auto& hipri_stream = high_priority_streams[device_index][i];
 
@@ -265,11 +287,43 @@ static inline void check_gpu(DeviceIndex device_index) {
   AT_ASSERT(device_index >= 0 && device_index < num_gpus);
 }
 
-// Helper to determine the index of the stream to return
-// Note: Streams are returned round-robin (see note in CUDAStream.h)
-static uint32_t get_idx(std::atomic<uint32_t>& counter) {
+// Helper to determine the stream to return
+// Note: Streams are returned round-robin (see note in CUDAStream.h), skipping
+// reserved streams unless all of them are reserved.
+static LeakyStreamInternals* get_pool_stream(
+    LeakyStreamInternals* pool,
+    std::atomic<uint32_t>& counter) {
+  auto raw_idx = counter++;
+  for (auto i = decltype(streams_per_pool){0}; i < streams_per_pool; ++i) {
+    auto* stream = &pool[(raw_idx + i) % streams_per_pool];
+    if (stream->reservations.load() == 0) {
+      return stream;
+    }
+  }
+  return &pool[raw_idx % streams_per_pool];
+}
+
+// Helper to determine the stream to reserve: the one with the fewest
+// reservations, starting the search round-robin so that ties are spread.
+static LeakyStreamInternals* get_reserved_pool_stream(
+    LeakyStreamInternals* pool,
+    std::atomic<uint32_t>& counter) {
   auto raw_idx = counter++;
-  return raw_idx % kStreamsPerPool;
+  LeakyStreamInternals* best = nullptr;
+  int best_reservations = 0;
+  for (auto i = decltype(streams_per_pool){0}; i < streams_per_pool; ++i) {
+    auto* stream = &pool[(raw_idx + i) % streams_per_pool];
+    const int reservations = stream->reservations.load();
+    if (!best || reservations < best_reservations) {
+      best = stream;
+      best_reservations = reservations;
+      if (reservations == 0) {
+        break;
+      }
+    }
+  }
+  best->reservations++;
+  return best;
 }
 
 // See Note [StreamId assignment]
@@ -337,12 +391,58 @@ CUDAStream getStreamFromPool(
       device_flags[device_index], initDeviceStreamState, device_index);
 
   if (isHighPriority) {
-    const auto idx = get_idx(high_priority_counters[device_index]);
-    return CUDAStream_fromInternals(&high_priority_streams[device_index][idx]);
+    return CUDAStream_fromInternals(get_pool_stream(
+        high_priority_streams[device_index].get(),
+        high_priority_counters[device_index]));
   }
 
-  const auto idx = get_idx(low_priority_counters[device_index]);
-  return CUDAStream_fromInternals(&low_priority_streams[device_index][idx]);
+  return CUDAStream_fromInternals(get_pool_stream(
+      low_priority_streams[device_index].get(),
+      low_priority_counters[device_index]));
+}
+
+CUDAStream reserveStreamFromPool(
+    const bool isHighPriority,
+    DeviceIndex device_index) {
+  initCUDAStreamsOnce();
+  if (device_index == -1)
+    device_index = current_device();
+  check_gpu(device_index);
+
+  // Initializes the stream pools (once)
+  std::call_once(
+      device_flags[device_index], initDeviceStreamState, device_index);
+
+  if (isHighPriority) {
+    return CUDAStream_fromInternals(get_reserved_pool_stream(
+        high_priority_streams[device_index].get(),
+        high_priority_counters[device_index]));
+  }
+
+  return CUDAStream_fromInternals(get_reserved_pool_stream(
+      low_priority_streams[device_index].get(),
+      low_priority_counters[device_index]));
+}
+
+void releaseStreamToPool(CUDAStream stream) {
+  auto ptr = CUDAStream_internals(stream);
+  TORCH_CHECK(
+      streamIdType(stream.unwrap().id()) != StreamIdType::DEFAULT,
+      "releaseStreamToPool: the default stream cannot be reserved");
+  int reservations = ptr->reservations.load();
+  do {
+    TORCH_CHECK(
+        reservations > 0,
+        "releaseStreamToPool: stream ",
+        stream.unwrap(),
+        " was not reserved");
+  } while (!ptr->reservations.compare_exchange_weak(
+      reservations, reservations - 1));
+}
+
+int getStreamsPerPool() {
+  initCUDAStreamsOnce();
+  return streams_per_pool;
 }
 
 CUDAStream getDefaultCUDAStream(DeviceIndex device_index) {
@@ -25,7 +25,9 @@
 *
 * The second pool is the "low priority" or "default priority" streams. In
 * HIP builds there is no distinction between streams in this pool and streams
-* in the third pool (below). There are 32 of these streams per device, and
+* in the third pool (below). By default there are 32 of these streams per
+* device (configurable up to 1024 with the PYTORCH_CUDA_STREAMS_PER_POOL
+* environment variable, read once when the pools are first used), and
 * when a stream is requested one of these streams is returned round-robin.
 * That is, the first stream requested is at index 0, the second at index 1...
 * to index 31, then index 0 again.
@@ -39,10 +41,12 @@
 *
 * These pools suggest that stream users should prefer many short-lived streams,
 * as the cost of acquiring and releasing streams is effectively zero. If
-* many longer-lived streams are required in performance critical scenarios
-* then the functionality here may need to be extended to allow, for example,
-* "reserving" a subset of the pool so that other streams do not accidentally
-* overlap the performance critical streams.
+* longer-lived streams are required in performance critical scenarios (e.g.
+* serving a latency critical request next to batch traffic), a stream can be
+* reserved with reserveStreamFromPool (or CUDAStreamReservation). Reservation
+* picks the least reserved stream of the pool, and round-robin
+* getStreamFromPool skips reserved streams as long as an unreserved one is
+* left, so other users do not accidentally overlap the reserved stream.
 *
 * Note: although the notion of "current stream for device" is thread local
 * (every OS thread has a separate current stream, as one might expect),
@@ -190,6 +194,50 @@ private:
 CAFFE2_API CUDAStream
 getStreamFromPool(const bool isHighPriority = false, DeviceIndex device = -1);
 
+/**
+ * Reserve a stream from the CUDA stream pool until it is released with
+ * releaseStreamToPool.  The least reserved stream of the requested pool is
+ * returned, and getStreamFromPool will not hand out reserved streams while
+ * unreserved ones are available.  Prefer CUDAStreamReservation, which
+ * releases the stream when it goes out of scope.
+ */
+CAFFE2_API CUDAStream
+reserveStreamFromPool(const bool isHighPriority = false, DeviceIndex device = -1);
+
+/**
+ * Release a stream previously returned by reserveStreamFromPool.
+ */
+CAFFE2_API void releaseStreamToPool(CUDAStream stream);
+
+/**
+ * Number of streams in each of the low and high priority pools of a device.
+ */
+CAFFE2_API int getStreamsPerPool();
+
+/**
+ * RAII wrapper around reserveStreamFromPool/releaseStreamToPool.
+ */
+struct CUDAStreamReservation {
+  explicit CUDAStreamReservation(
+      const bool isHighPriority = false,
+      DeviceIndex device = -1)
+      : stream_(reserveStreamFromPool(isHighPriority, device)) {}
+
+  ~CUDAStreamReservation() {
+    releaseStreamToPool(stream_);
+  }
+
+  CUDAStreamReservation(const CUDAStreamReservation&) = delete;
+  CUDAStreamReservation& operator=(const CUDAStreamReservation&) = delete;
+
+  CUDAStream stream() const {
+    return stream_;
+  }
+
+ private:
+  CUDAStream stream_;
+};
+
 /**
  * Get the default CUDA stream, for the passed CUDA device, or for the
  * current device if no device index is passed.  The default stream is
@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+
+#include <cstring>
+
+TEST(CPUAllocatorTest, HugePageThreshold) {
+  auto prev = FLAGS_caffe2_cpu_allocator_huge_page_threshold;
+  FLAGS_caffe2_cpu_allocator_huge_page_threshold = c10::kHugePageSize;
+
+  constexpr size_t nbytes = 4 * c10::kHugePageSize;
+  void* large = c10::alloc_cpu(nbytes);
+  memset(large, 1, nbytes);
+  void* small = c10::alloc_cpu(1024);
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % c10::kHugePageSize, 0);
+  // Whether the kernel grants huge pages depends on the system THP setting.
+  EXPECT_GE(c10::GetTransparentHugePageBytes(large), 0);
+#endif
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % c10::gAlignment, 0);
+
+  c10::free_cpu(small);
+  c10::free_cpu(large);
+  FLAGS_caffe2_cpu_allocator_huge_page_threshold = prev;
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <thread>
+
+using namespace c10;
+
+TEST(CPUCachingAllocatorTest, ReusesFreedBlocks) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  void* first = nullptr;
+  {
+    auto ptr = allocator->allocate(1000);
+    first = ptr.get();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  auto before = CPUCachingAllocator::getStats();
+  // Rounded up to the same 1024-byte size class.
+  auto ptr = allocator->allocate(600);
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(ptr.get(), first);
+  ASSERT_EQ(after.num_cache_hits, before.num_cache_hits + 1);
+  ASSERT_EQ(after.num_system_allocs, before.num_system_allocs);
+  ASSERT_EQ(after.allocated_bytes, before.allocated_bytes + 1024);
+}
+
+TEST(CPUCachingAllocatorTest, LargeAllocationsBypassCache) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  auto before = CPUCachingAllocator::getStats();
+  {
+    auto ptr = allocator->allocate(CPUCachingAllocator::kMaxCachedSize + 1);
+    ASSERT_NE(ptr.get(), nullptr);
+  }
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.num_system_allocs, before.num_system_allocs + 1);
+  ASSERT_EQ(after.num_system_frees, before.num_system_frees + 1);
+  ASSERT_EQ(after.cached_bytes, before.cached_bytes);
+}
+
+TEST(CPUCachingAllocatorTest, EmptyCacheReleasesMemory) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  auto before = CPUCachingAllocator::getStats();
+  {
+    auto a = allocator->allocate(64);
+    auto b = allocator->allocate(4096);
+  }
+  ASSERT_EQ(CPUCachingAllocator::getStats().cached_bytes, before.cached_bytes + 64 + 4096);
+  CPUCachingAllocator::emptyCache();
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.cached_bytes, 0);
+  ASSERT_EQ(after.reserved_bytes, before.reserved_bytes - before.cached_bytes);
+}
+
+TEST(CPUCachingAllocatorTest, ThreadExitReturnsBlocksToGlobalPool) {
+  auto* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  void* freed_by_thread = nullptr;
+  std::thread t([&]() {
+    auto ptr = allocator->allocate(256);
+    freed_by_thread = ptr.get();
+  });
+  t.join();
+  auto ptr = allocator->allocate(256);
+  ASSERT_EQ(ptr.get(), freed_by_thread);
+}
+
+TEST(CPUCachingAllocatorTest, RawAllocate) {
+  auto* allocator = CPUCachingAllocator::get();
+  void* data = allocator->raw_allocate(128);
+  ASSERT_NE(data, nullptr);
+  allocator->raw_deallocate(data);
+}
@@ -0,0 +1,68 @@
+#include <c10/util/ThreadLocalFreeList.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+using c10::ThreadLocalFreeList;
+
+namespace {
+
+struct Pooled {
+  static void* operator new(size_t size) {
+    return ThreadLocalFreeList<sizeof(Pooled)>::allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ThreadLocalFreeList<sizeof(Pooled)>::deallocate(ptr, size);
+  }
+  virtual ~Pooled() = default;
+  int64_t value[4] = {0, 1, 2, 3};
+};
+
+struct Bigger : Pooled {
+  int64_t more[8];
+};
+
+} // namespace
+
+TEST(ThreadLocalFreeListTest, givenFreedObject_whenAllocatingAgain_thenReusesBlock) {
+  auto* first = new Pooled();
+  void* block = first;
+  delete first;
+  auto* second = new Pooled();
+  EXPECT_EQ(block, second);
+  EXPECT_EQ(3, second->value[3]);
+  delete second;
+}
+
+TEST(ThreadLocalFreeListTest, givenSubclass_whenFreeing_thenBypassesCache) {
+  auto* pooled = new Pooled();
+  void* block = pooled;
+  delete pooled;
+  Pooled* bigger = new Bigger();
+  EXPECT_NE(block, bigger);
+  delete bigger;
+  auto* again = new Pooled();
+  EXPECT_EQ(block, again);
+  delete again;
+}
+
+TEST(ThreadLocalFreeListTest, givenObjectFromOtherThread_whenFreeing_thenMovesToThisThread) {
+  Pooled* pooled = nullptr;
+  std::thread([&] { pooled = new Pooled(); }).join();
+  void* block = pooled;
+  delete pooled;
+  auto* again = new Pooled();
+  EXPECT_EQ(block, again);
+  delete again;
+}
+
+TEST(ThreadLocalFreeListTest, givenExitingThread_whenFreeingAfterDrain_thenDoesNotCrash) {
+  std::thread([] {
+    // Constructed before the cache registers its drain, so destroyed after it.
+    static thread_local std::unique_ptr<Pooled> late;
+    delete new Pooled();
+    late.reset(new Pooled());
+  }).join();
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/numa.h>
+
+#include <cstring>
+
+namespace {
+
+struct NUMAFlagGuard {
+  NUMAFlagGuard() : prev_(FLAGS_caffe2_cpu_numa_enabled) {
+    FLAGS_caffe2_cpu_numa_enabled = true;
+  }
+  ~NUMAFlagGuard() {
+    c10::SetPreferredNUMANode(-1);
+    FLAGS_caffe2_cpu_numa_enabled = prev_;
+  }
+  bool prev_;
+};
+
+} // namespace
+
+TEST(NUMATest, PreferredNodeDisabledWithoutNUMA) {
+  FLAGS_caffe2_cpu_numa_enabled = false;
+  c10::SetPreferredNUMANode(0);
+  EXPECT_EQ(c10::GetPreferredNUMANode(), -1);
+  EXPECT_EQ(c10::GetNUMAAllocationNode(), -1);
+  c10::SetPreferredNUMANode(-1);
+}
+
+TEST(NUMATest, AllocationsFollowPreferredNode) {
+  NUMAFlagGuard guard;
+  if (!c10::IsNUMAEnabled()) {
+    return;
+  }
+  EXPECT_EQ(c10::GetPreferredNUMANode(), -1);
+  EXPECT_EQ(c10::GetNUMAAllocationNode(), c10::GetCurrentNUMANode());
+
+  c10::SetPreferredNUMANode(0);
+  EXPECT_EQ(c10::GetPreferredNUMANode(), 0);
+  EXPECT_EQ(c10::GetNUMAAllocationNode(), 0);
+
+  constexpr size_t nbytes = 1 << 20;
+  void* data = c10::alloc_cpu(nbytes);
+  memset(data, 0, nbytes);
+  EXPECT_EQ(c10::GetNUMANode(data), 0);
+  c10::free_cpu(data);
+
+  c10::SetPreferredNUMANode(-1);
+  EXPECT_EQ(c10::GetPreferredNUMANode(), -1);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace c10 {
+
+/**
+ * A per-thread cache of freed memory blocks of `Size` bytes, for objects that
+ * are created and destroyed at a high rate (one TensorImpl, StorageImpl and
+ * version counter per op output).  Classes use it from their class specific
+ * operator new and operator delete:
+ *
+ *   static void* operator new(size_t size) {
+ *     return ThreadLocalFreeList<sizeof(Foo)>::allocate(size);
+ *   }
+ *   static void operator delete(void* ptr, size_t size) {
+ *     ThreadLocalFreeList<sizeof(Foo)>::deallocate(ptr, size);
+ *   }
+ *
+ * Requests of another size, e.g. for a subclass, go to the global operator
+ * new and delete.  Blocks are obtained from the global operator new too, so a
+ * block may be freed on another thread than the one it was allocated on, in
+ * which case it moves to the cache of that thread.  Each cache keeps at most
+ * `kCapacity` blocks and frees them when its thread exits.
+ */
+template <size_t Size>
+class ThreadLocalFreeList {
+  static_assert(Size >= sizeof(void*), "Blocks must be able to hold a pointer");
+
+ public:
+  static constexpr size_t kCapacity = 1024;
+
+  static void* allocate(size_t size) {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+    auto& list = state();
+    if (size == Size && list.head != nullptr) {
+      auto* block = list.head;
+      list.head = block->next;
+      list.length--;
+      return block;
+    }
+#endif
+    return ::operator new(size);
+  }
+
+  static void deallocate(void* ptr, size_t size) noexcept {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+    auto& list = state();
+    if (size == Size && list.length < list.capacity) {
+      if (list.capacity == kCapacity) {
+        // Frees the cache when the thread exits.
+        static thread_local Drain drain;
+        (void)drain;
+      }
+      auto* block = static_cast<Block*>(ptr);
+      block->next = list.head;
+      list.head = block;
+      list.length++;
+      return;
+    }
+#endif
+    ::operator delete(ptr);
+  }
+
+ private:
+  struct Block {
+    Block* next;
+  };
+
+  // Trivially destructible, so that it stays usable for the objects that are
+  // destroyed after Drain during thread exit.
+  struct State {
+    Block* head;
+    size_t length;
+    size_t capacity;
+  };
+
+  static State& state() {
+    static thread_local State state_ = {nullptr, 0, kCapacity};
+    return state_;
+  }
+
+  struct Drain {
+    ~Drain() {
+      auto& list = state();
+      while (list.head != nullptr) {
+        auto* block = list.head;
+        list.head = block->next;
+        ::operator delete(block);
+      }
+      list.length = 0;
+      // Blocks freed from now on go straight to the global operator delete.
+      list.capacity = 0;
+    }
+  };
+};
+
+} // namespace c10
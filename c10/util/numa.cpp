@@ -1,6 +1,12 @@
 #include <c10/util/numa.h>
 
 C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
+C10_DEFINE_int(
+    caffe2_cpu_numa_node,
+    -1,
+    "If NUMA is enabled and this is non-negative, place CPU allocations and "
+    "thread pool threads on this NUMA node instead of the node of the "
+    "allocating thread.");
 
 #if defined(__linux__) && defined(C10_USE_NUMA) && !defined(C10_MOBILE)
 #include <numa.h>
@@ -9,11 +15,20 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 #define C10_ENABLE_NUMA
 #endif
 
+#include <atomic>
+
 // This code used to have a lot of VLOGs. However, because allocation might be
 // triggered during static initialization, it's unsafe to invoke VLOG here
 
 namespace c10 {
 
+namespace {
+// Preferred node set through SetPreferredNUMANode; kNUMANodeUnset means
+// FLAGS_caffe2_cpu_numa_node decides.
+constexpr int kNUMANodeUnset = -2;
+std::atomic<int> preferred_numa_node{kNUMANodeUnset};
+} // namespace
+
 #ifdef C10_ENABLE_NUMA
 bool IsNUMAEnabled() {
   return FLAGS_caffe2_cpu_numa_enabled && numa_available() >= 0;
@@ -103,6 +118,33 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+void SetPreferredNUMANode(int numa_node_id) {
+  if (numa_node_id >= 0 && IsNUMAEnabled()) {
+    TORCH_CHECK(
+        numa_node_id <= numa_max_node(),
+        "NUMA node id ",
+        numa_node_id,
+        " is unavailable");
+  }
+  preferred_numa_node = numa_node_id < 0 ? -1 : numa_node_id;
+}
+
+int GetPreferredNUMANode() {
+  if (!IsNUMAEnabled()) {
+    return -1;
+  }
+  int node = preferred_numa_node.load();
+  if (node == kNUMANodeUnset) {
+    node = FLAGS_caffe2_cpu_numa_node;
+  }
+  return node < 0 ? -1 : node;
+}
+
+int GetNUMAAllocationNode() {
+  int node = GetPreferredNUMANode();
+  return node >= 0 ? node : GetCurrentNUMANode();
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +169,18 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+void SetPreferredNUMANode(int numa_node_id) {
+  preferred_numa_node = numa_node_id < 0 ? -1 : numa_node_id;
+}
+
+int GetPreferredNUMANode() {
+  return -1;
+}
+
+int GetNUMAAllocationNode() {
+  return -1;
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
@@ -4,6 +4,7 @@
 #include <c10/util/Optional.h>
 
 C10_DECLARE_bool(caffe2_cpu_numa_enabled);
+C10_DECLARE_int(caffe2_cpu_numa_node);
 
 namespace c10 {
 
@@ -37,4 +38,25 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Set the NUMA node that CPU allocations and newly created intra-op and
+ * inter-op pool threads of this process should use. -1 clears the setting, so
+ * that each allocation is placed on the node of the allocating thread.
+ * Defaults to FLAGS_caffe2_cpu_numa_node. Threads that already exist are not
+ * moved; use NUMABind for that.
+ */
+C10_API void SetPreferredNUMANode(int numa_node_id);
+
+/**
+ * Get the NUMA node set by SetPreferredNUMANode, or -1 if none is set or NUMA
+ * is disabled
+ */
+C10_API int GetPreferredNUMANode();
+
+/**
+ * Get the NUMA node a CPU allocation made by the calling thread should be
+ * placed on: the preferred node if one is set, the current node otherwise
+ */
+C10_API int GetNUMAAllocationNode();
+
 } // namespace c10
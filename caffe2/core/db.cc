@@ -171,6 +171,110 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+DBReadahead::DBReadahead(
+    std::vector<Cursor*> cursors,
+    uint32_t num_shards,
+    uint32_t shard_id,
+    size_t buffer_size)
+    : num_shards_(num_shards),
+      shard_id_(shard_id),
+      buffer_size_(buffer_size),
+      cursors_(std::move(cursors)) {
+  CAFFE_ENFORCE(!cursors_.empty());
+  CAFFE_ENFORCE_GT(buffer_size_, 0u);
+  for (size_t i = 0; i < cursors_.size(); ++i) {
+    buffers_.push_back(make_unique<Buffer>());
+  }
+  for (size_t i = 0; i < cursors_.size(); ++i) {
+    threads_.emplace_back(&DBReadahead::ReadLoop, this, i);
+  }
+}
+
+DBReadahead::~DBReadahead() {
+  stopped_ = true;
+  for (auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->not_full.notify_all();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void DBReadahead::Read(string* key, string* value) {
+  auto& buffer = *buffers_[next_buffer_];
+  std::unique_lock<std::mutex> lock(buffer.mutex);
+  buffer.not_empty.wait(
+      lock, [&buffer] { return !buffer.records.empty() || buffer.error; });
+  if (buffer.records.empty()) {
+    std::rethrow_exception(buffer.error);
+  }
+  *key = std::move(buffer.records.front().first);
+  *value = std::move(buffer.records.front().second);
+  buffer.records.pop_front();
+  lock.unlock();
+  buffer.not_full.notify_one();
+  next_buffer_ = (next_buffer_ + 1) % buffers_.size();
+}
+
+void DBReadahead::ReadLoop(size_t thread_id) {
+  auto& buffer = *buffers_[thread_id];
+  auto* cursor = cursors_[thread_id];
+  // Records of the thread, in the records of the shard
+  const size_t first = shard_id_ + thread_id * num_shards_;
+  const size_t stride = num_shards_ * cursors_.size();
+  auto moveToFirst = [&]() {
+    cursor->SeekToFirst();
+    for (size_t s = 0; s < first; s++) {
+      CAFFE_ENFORCE(
+          cursor->Valid(),
+          "Db has fewer rows than the first row of readahead thread ",
+          thread_id,
+          ": ",
+          first);
+      cursor->Next();
+    }
+    CAFFE_ENFORCE(
+        cursor->Valid(),
+        "Db has fewer rows than the first row of readahead thread ",
+        thread_id,
+        ": ",
+        first);
+  };
+
+  try {
+    moveToFirst();
+    for (;;) {
+      auto record = std::make_pair(cursor->key(), cursor->value());
+      {
+        std::unique_lock<std::mutex> lock(buffer.mutex);
+        buffer.not_full.wait(lock, [this, &buffer] {
+          return stopped_ || buffer.records.size() < buffer_size_;
+        });
+        if (stopped_) {
+          return;
+        }
+        buffer.records.push_back(std::move(record));
+      }
+      buffer.not_empty.notify_one();
+
+      for (size_t s = 0; s < stride; s++) {
+        cursor->Next();
+        if (!cursor->Valid()) {
+          moveToFirst();
+          break;
+        }
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(buffer.mutex);
+      buffer.error = std::current_exception();
+    }
+    buffer.not_empty.notify_one();
+  }
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
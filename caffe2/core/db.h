@@ -1,7 +1,12 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "c10/util/Registry.h"
 #include "caffe2/core/blob_serialization.h"
@@ -95,6 +100,13 @@ class CAFFE2_API DB {
    * ownership of the pointer.
    */
   virtual std::unique_ptr<Transaction> NewTransaction() = 0;
+  /**
+   * Whether several cursors of the database can be used at the same time,
+   * from different threads.
+   */
+  virtual bool SupportsConcurrentCursors() {
+    return false;
+  }
 
  protected:
   Mode mode_;
@@ -138,6 +150,53 @@ inline bool DBExists(const string& db_type, const string& full_db_name) {
   }
 }
 
+/**
+ * Reads the records of a db ahead of their use, with one thread per cursor.
+ *
+ * With n cursors, the thread of cursor t reads the records t, t + n, t + 2n...
+ * of the shard into its own bounded buffer, and Read() takes the records
+ * from the buffers in turn, so that they come in the order of the db, until
+ * the shard is read again from its beginning.
+ */
+class CAFFE2_API DBReadahead {
+ public:
+  DBReadahead(
+      std::vector<Cursor*> cursors,
+      uint32_t num_shards,
+      uint32_t shard_id,
+      size_t buffer_size);
+  ~DBReadahead();
+
+  /**
+   * Returns the next record, waiting for it to be read if needed. Not thread
+   * safe.
+   */
+  void Read(string* key, string* value);
+
+ private:
+  struct Buffer {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<std::pair<string, string>> records;
+    // Set when the thread of the buffer fails
+    std::exception_ptr error;
+  };
+
+  void ReadLoop(size_t thread_id);
+
+  const uint32_t num_shards_;
+  const uint32_t shard_id_;
+  const size_t buffer_size_;
+  std::vector<Cursor*> cursors_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+  size_t next_buffer_{0};
+  std::atomic<bool> stopped_{false};
+  std::vector<std::thread> threads_;
+
+  C10_DISABLE_COPY_AND_ASSIGN(DBReadahead);
+};
+
 /**
  * A reader wrapper for DB that also allows us to serialize it.
  */
@@ -182,6 +241,7 @@ class CAFFE2_API DBReader {
       const int32_t shard_id = 0) {
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
+    StopReadahead();
     cursor_.reset();
     db_.reset();
     db_type_ = db_type;
@@ -201,6 +261,7 @@ class CAFFE2_API DBReader {
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    StopReadahead();
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
@@ -228,6 +289,10 @@ class CAFFE2_API DBReader {
   void Read(string* key, string* value) const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    if (readahead_) {
+      readahead_->Read(key, value);
+      return;
+    }
     *key = cursor_->key();
     *value = cursor_->value();
 
@@ -247,9 +312,36 @@ class CAFFE2_API DBReader {
   void SeekToFirst() const {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    if (readahead_) {
+      StartReadahead();
+      return;
+    }
     MoveToBeginning();
   }
 
+  /**
+   * Reads the records ahead in num_threads threads, with cursors of their
+   * own, which buffer up to buffer_size records each. For the dbs that don't
+   * support concurrent cursors, a single thread reads ahead with the cursor
+   * of the reader. The reading resumes from the first record of the shard.
+   * num_threads 0 stops reading ahead.
+   *
+   * While reading ahead, the position of the cursor of the reader, and so of
+   * a serialized reader, is not the position of the next record read.
+   */
+  void EnableReadahead(int num_threads, int buffer_size) {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    CAFFE_ENFORCE_GE(num_threads, 0);
+    CAFFE_ENFORCE_GT(buffer_size, 0);
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    StopReadahead();
+    readahead_threads_ = num_threads;
+    readahead_buffer_size_ = buffer_size;
+    if (num_threads > 0) {
+      StartReadahead();
+    }
+  }
+
   /**
    * Returns the underlying cursor of the db reader.
    *
@@ -274,6 +366,33 @@ class CAFFE2_API DBReader {
     SeekToFirst();
   }
 
+  void StartReadahead() const {
+    readahead_.reset();
+    readahead_cursors_.clear();
+    std::vector<Cursor*> cursors;
+    if (db_->SupportsConcurrentCursors()) {
+      for (int i = 0; i < readahead_threads_; ++i) {
+        readahead_cursors_.push_back(db_->NewCursor());
+        cursors.push_back(readahead_cursors_.back().get());
+      }
+    } else {
+      if (readahead_threads_ > 1) {
+        LOG(WARNING) << "Db " << source_ << " of type " << db_type_
+                     << " doesn't support concurrent cursors, reading ahead "
+                     << "in a single thread";
+      }
+      cursors.push_back(cursor_.get());
+    }
+    readahead_ = make_unique<DBReadahead>(
+        std::move(cursors), num_shards_, shard_id_, readahead_buffer_size_);
+  }
+
+  void StopReadahead() {
+    readahead_.reset();
+    readahead_cursors_.clear();
+    readahead_threads_ = 0;
+  }
+
   void MoveToBeginning() const {
     cursor_->SeekToFirst();
     for (uint32_t s = 0; s < shard_id_; s++) {
@@ -290,6 +409,11 @@ class CAFFE2_API DBReader {
   mutable std::mutex reader_mutex_;
   uint32_t num_shards_{};
   uint32_t shard_id_{};
+  int readahead_threads_{0};
+  int readahead_buffer_size_{0};
+  mutable std::vector<unique_ptr<Cursor>> readahead_cursors_;
+  // Declared last to be destroyed before the cursors it reads
+  mutable unique_ptr<DBReadahead> readahead_;
 
   C10_DISABLE_COPY_AND_ASSIGN(DBReader);
 };
@@ -1,6 +1,7 @@
 #include "caffe2/core/net_async_base.h"
 
 #include "caffe2/core/net_async_tracing.h"
+#include "caffe2/core/net_async_work_stealing_pool.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
 
@@ -51,6 +52,12 @@ C10_DEFINE_bool(
     false,
     "Use per net thread pools");
 
+C10_DEFINE_bool(
+    caffe2_net_async_priority_scheduling,
+    false,
+    "Run the CPU tasks of async_scheduling nets on work stealing pools, "
+    "the tasks on the longest paths of the net first");
+
 C10_DEFINE_bool(
     caffe2_net_async_run_root_tasks_inline,
     false,
@@ -86,6 +93,10 @@ AsyncNetBase::AsyncNetBase(
     chains_.push_back(kv.second);
   }
   chain_nodes_ = dag_utils::prepareChainGraphNodes(operator_nodes_, chains_);
+  if (options_.use_priority_scheduling_) {
+    chain_priorities_ =
+        dag_utils::computeCriticalPathLengths(chain_nodes_, chains_);
+  }
 
   events_.reserve(chains_.size());
   for (const auto& chain : chains_) {
@@ -103,6 +114,16 @@ AsyncNetBase::AsyncNetBase(
     }
   }
 
+  if (NetMemoryPlanner::enabled(*net_def)) {
+    std::vector<std::vector<int>> op_parents;
+    op_parents.reserve(operator_nodes_.size());
+    for (const auto& node : operator_nodes_) {
+      op_parents.push_back(node.parents_);
+    }
+    memory_planner_ = std::make_unique<NetMemoryPlanner>(
+        *net_def, operators_, ws, op_parents);
+  }
+
   num_workers_ = net_def->has_num_workers() ? net_def->num_workers() : -1;
 
   tracer_ = tracing::create(this, net_def->name());
@@ -156,8 +177,12 @@ TaskThreadPoolBase* AsyncNetBase::poolGetter(
   std::unique_lock<std::mutex> pools_lock(pools_mutex_);
   auto pool = pools[device_id][pool_size];
   if (!pool) {
+    std::string pool_type = DeviceTypeName(device_type);
+    if (options_.use_priority_scheduling_ && IsCPUDeviceType(device_type)) {
+      pool_type = "CPU_WORK_STEALING";
+    }
     pool = c10::ThreadPoolRegistry()->Create(
-        DeviceTypeName(device_type),
+        pool_type,
         device_id,
         pool_size,
         options_.use_per_net_pools_);
@@ -166,6 +191,22 @@ TaskThreadPoolBase* AsyncNetBase::poolGetter(
   return pool.get();
 }
 
+void AsyncNetBase::runInPool(int task_id, std::function<void()> func) {
+  auto* task_pool = pool(event(task_id).GetDeviceOption());
+  if (options_.use_priority_scheduling_) {
+    if (auto* work_stealing_pool =
+            dynamic_cast<WorkStealingTaskThreadPool*>(task_pool)) {
+      work_stealing_pool->runWithPriority(std::move(func), priority(task_id));
+      return;
+    }
+  }
+  task_pool->run(std::move(func));
+}
+
+int AsyncNetBase::priority(int task_id) const {
+  return chain_priorities_.empty() ? 0 : chain_priorities_[task_id];
+}
+
 TaskThreadPoolBase* AsyncNetBase::pool() {
   // By default using a non-pinned CPU option
   DeviceOption dev;
@@ -366,6 +407,9 @@ void AsyncNetBase::reset() {
     task_op_node.runtime_parent_count_ = parents(task_id).size();
     task_op_node.scheduled_.clear();
   }
+  if (memory_planner_) {
+    memory_planner_->startRun();
+  }
 
   success_ = true;
 }
@@ -405,6 +449,9 @@ bool AsyncNetBase::run(int task_id, int stream_id) noexcept {
     }
     for (auto& op_id : chains_[task_id]) {
       op = operators_[op_id];
+      if (memory_planner_) {
+        memory_planner_->beforeOp(op_id);
+      }
       bool success = false;
       if (!options_.report_stats_) {
         TRACE_EVENT(
@@ -430,6 +477,9 @@ bool AsyncNetBase::run(int task_id, int stream_id) noexcept {
         handleChainError(task_id, op, "Failed to execute an op");
         return false;
       }
+      if (memory_planner_) {
+        memory_planner_->afterOp(op_id);
+      }
     }
 
     op = nullptr;
@@ -585,6 +635,7 @@ ExecutionOptions::ExecutionOptions(
     use_per_net_pools_ = FLAGS_caffe2_net_async_use_per_net_pools;
     is_blocking_ = false;
     report_stats_ = false;
+    use_priority_scheduling_ = FLAGS_caffe2_net_async_priority_scheduling;
   }
 
   use_dfs_scheduling_ = false;
@@ -599,6 +650,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "priority_scheduling") {
+      CAFFE_ENFORCE(arg.has_i(), "priority_scheduling should be an int");
+      use_priority_scheduling_ = arg.i() == 1;
+    }
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
@@ -615,6 +670,12 @@ C10_REGISTER_CREATOR(
     ThreadPoolRegistry,
     CPU,
     caffe2::GetAsyncNetThreadPool<TaskThreadPool, caffe2::PROTO_CPU>);
+C10_REGISTER_CREATOR(
+    ThreadPoolRegistry,
+    CPU_WORK_STEALING,
+    caffe2::GetAsyncNetThreadPool<
+        caffe2::WorkStealingTaskThreadPool,
+        caffe2::PROTO_CPU>);
 C10_REGISTER_CREATOR(
     ThreadPoolRegistry,
     CUDA,
@@ -7,6 +7,7 @@
 #include "caffe2/core/common.h"
 #include "caffe2/core/net.h"
 #include "caffe2/core/net_dag_utils.h"
+#include "caffe2/core/net_memory_planner.h"
 #include "caffe2/core/prof_dag_counters.h"
 #include "caffe2/core/stats.h"
 #include "caffe2/core/timer.h"
@@ -24,6 +25,7 @@ C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
 C10_DECLARE_bool(caffe2_net_async_profile_operators);
+C10_DECLARE_bool(caffe2_net_async_priority_scheduling);
 
 namespace caffe2 {
 
@@ -55,6 +57,9 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // run the CPU tasks on work stealing pools, the tasks with the longest
+  // path of ops left to run first
+  bool use_priority_scheduling_ = false;
 };
 
 struct CAFFE2_API AsyncNetCancelled : public std::exception {
@@ -82,6 +87,11 @@ class CAFFE2_API AsyncNetBase : public NetBase {
     return execution_chains_;
   }
 
+  // nullptr unless the dynamic memonger is enabled for the net
+  const NetMemoryPlanner* TEST_memoryPlanner() const {
+    return memory_planner_.get();
+  }
+
   ProfDAGProtos GetOperatorStats() const;
   ProfDAGProtos GetPerOperatorCost() const;
   ProfDAGReport GetProfReport() const;
@@ -118,6 +128,10 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   int stream(int task_id);
   TaskThreadPoolBase* pool(const DeviceOption& device_option);
   TaskThreadPoolBase* pool();
+  // Runs func in the pool of the task's device, with the priority of the task
+  // when priority scheduling is enabled
+  void runInPool(int task_id, std::function<void()> func);
+  int priority(int task_id) const;
 
   void finishTasks(const std::unordered_set<int>& task_ids);
   void finalizeEvents();
@@ -134,6 +148,9 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   std::vector<std::vector<int>> chains_;
   std::vector<dag_utils::OpGraphNode> chain_nodes_; // chains' parents/children
   dag_utils::ExecutionChains execution_chains_; // for testing
+  // Critical path lengths of the chains, with priority scheduling only
+  std::vector<int> chain_priorities_;
+  std::unique_ptr<NetMemoryPlanner> memory_planner_;
 
   // Pools and streams
   std::mutex pools_mutex_;
@@ -1,5 +1,7 @@
 #include "caffe2/core/net_async_scheduling.h"
 
+#include <algorithm>
+
 #include "caffe2/core/net_async_tracing.h"
 
 namespace caffe2 {
@@ -127,10 +129,9 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
             } else if (parent_needs_polling) {
               // some parents are blocking us from scheduling a child and don't
               // support callbacks, using polling
-              const auto& child_device_option =
-                  event(child_id).GetDeviceOption();
-              pool(child_device_option)
-                  ->run(std::bind(
+              runInPool(
+                  child_id,
+                  std::bind(
                       &AsyncSchedulingNet::pollAndSchedule, this, child_id));
             } else if (!parents_with_callback.empty()) {
               // some parents are blocking us from scheduling a child and they
@@ -173,8 +174,7 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
   if (run_inline) {
     schedule_func();
   } else {
-    const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)->run(schedule_func);
+    runInPool(task_id, schedule_func);
   }
 }
 
@@ -205,9 +205,9 @@ void AsyncSchedulingNet::pollAndSchedule(int task_id) {
   if (can_schedule || !success_ || parent_failed) {
     schedule(task_id);
   } else {
-    const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)
-        ->run(std::bind(&AsyncSchedulingNet::pollAndSchedule, this, task_id));
+    runInPool(
+        task_id,
+        std::bind(&AsyncSchedulingNet::pollAndSchedule, this, task_id));
   }
 }
 
@@ -251,11 +251,22 @@ bool AsyncSchedulingNet::RunAsync() {
 
   // schedule() is not expected to throw, at this moment all the initial tasks
   // will be scheduled and the full graph of tasks will be executed
+  std::vector<int> root_tasks;
   for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
     if (parents(task_id).empty()) {
-      schedule(task_id, options_.run_root_tasks_inline_);
+      root_tasks.push_back(task_id);
     }
   }
+  if (options_.use_priority_scheduling_) {
+    // Start the longest paths first, also when the root tasks run inline
+    std::stable_sort(
+        root_tasks.begin(), root_tasks.end(), [this](int a, int b) {
+          return priority(a) > priority(b);
+        });
+  }
+  for (auto task_id : root_tasks) {
+    schedule(task_id, options_.run_root_tasks_inline_);
+  }
 
   if (tasksNum() == 0) {
     finishRun();
@@ -0,0 +1,144 @@
+#include "caffe2/core/net_async_work_stealing_pool.h"
+
+#include <algorithm>
+
+#include "c10/util/numa.h"
+#include "c10/util/thread_name.h"
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+namespace {
+// Pool and queue of the worker running on the current thread, if any
+thread_local const WorkStealingTaskThreadPool* current_pool = nullptr;
+thread_local size_t current_queue_idx = 0;
+} // namespace
+
+WorkStealingTaskThreadPool::WorkStealingTaskThreadPool(
+    int pool_size,
+    int numa_node_id) {
+  const size_t num_threads =
+      pool_size < 0 ? defaultNumThreads() : static_cast<size_t>(pool_size);
+  num_available_ = num_threads;
+  queues_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i, numa_node_id]() {
+      c10::setThreadName("CaffeTaskThread");
+      c10::NUMABind(numa_node_id);
+      mainLoop(i);
+    });
+  }
+}
+
+WorkStealingTaskThreadPool::~WorkStealingTaskThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    try {
+      thread.join();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+void WorkStealingTaskThreadPool::run(std::function<void()> func) {
+  runWithPriority(std::move(func), 0);
+}
+
+void WorkStealingTaskThreadPool::runWithPriority(
+    std::function<void()> func,
+    int priority) {
+  CAFFE_ENFORCE(!threads_.empty(), "No threads to run a task");
+  const size_t queue_idx = current_pool == this
+      ? current_queue_idx
+      : next_queue_++ % queues_.size();
+  auto& queue = *queues_[queue_idx];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(Task{priority, next_seq_++, std::move(func)});
+    std::push_heap(queue.tasks.begin(), queue.tasks.end(), taskOrder);
+  }
+  ++num_pending_;
+  // Taking the lock orders the update of num_pending_ with a worker that is
+  // about to wait, so that it doesn't miss the notification
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  cv_.notify_one();
+}
+
+size_t WorkStealingTaskThreadPool::size() const {
+  return threads_.size();
+}
+
+size_t WorkStealingTaskThreadPool::numAvailable() const {
+  return num_available_;
+}
+
+bool WorkStealingTaskThreadPool::inThreadPool() const {
+  return current_pool == this;
+}
+
+bool WorkStealingTaskThreadPool::taskOrder(const Task& a, const Task& b) {
+  // std::push_heap keeps the largest element at the front
+  if (a.priority != b.priority) {
+    return a.priority < b.priority;
+  }
+  return a.seq > b.seq;
+}
+
+bool WorkStealingTaskThreadPool::popTask(size_t queue_idx, Task* task) {
+  auto& queue = *queues_[queue_idx];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  std::pop_heap(queue.tasks.begin(), queue.tasks.end(), taskOrder);
+  *task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  --num_pending_;
+  return true;
+}
+
+void WorkStealingTaskThreadPool::mainLoop(size_t worker_idx) {
+  current_pool = this;
+  current_queue_idx = worker_idx;
+  const size_t num_queues = queues_.size();
+  while (true) {
+    Task task;
+    bool found = popTask(worker_idx, &task);
+    // Steal from the other queues, starting with the next one so that the
+    // thieves spread over the queues
+    for (size_t i = 1; !found && i < num_queues; ++i) {
+      found = popTask((worker_idx + i) % num_queues, &task);
+    }
+
+    if (found) {
+      --num_available_;
+      try {
+        task.func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Exception in thread pool task: " << e.what();
+      } catch (...) {
+        LOG(ERROR) << "Exception in thread pool task: unknown";
+      }
+      // Destroy the task, and what it holds, before waiting for the next one
+      task.func = nullptr;
+      ++num_available_;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !running_ || num_pending_ > 0; });
+    if (!running_) {
+      break;
+    }
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,76 @@
+#ifndef CAFFE2_CORE_NET_ASYNC_WORK_STEALING_POOL_H_
+#define CAFFE2_CORE_NET_ASYNC_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "c10/core/thread_pool.h"
+#include "caffe2/core/common.h"
+
+namespace caffe2 {
+
+// CPU thread pool of the async nets with a task queue per worker, used with
+// priority scheduling (see ExecutionOptions::use_priority_scheduling_).
+//
+// A task run from a worker goes to the queue of this worker, so that the
+// children of a task tend to run on the thread that holds their inputs in its
+// caches, other tasks go to the queues in turn. A worker runs the tasks of its
+// own queue first, and steals those of the other queues when it has none.
+// In any queue, the tasks of higher priority run first, then the oldest ones.
+class CAFFE2_API WorkStealingTaskThreadPool : public TaskThreadPoolBase {
+ public:
+  explicit WorkStealingTaskThreadPool(int pool_size, int numa_node_id = -1);
+  ~WorkStealingTaskThreadPool() override;
+
+  void run(std::function<void()> func) override;
+
+  void runWithPriority(std::function<void()> func, int priority);
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+ private:
+  struct Task {
+    int priority;
+    uint64_t seq;
+    std::function<void()> func;
+  };
+
+  struct TaskQueue {
+    std::mutex mutex;
+    // Heap of the tasks, see taskOrder
+    std::vector<Task> tasks;
+  };
+
+  static bool taskOrder(const Task& a, const Task& b);
+
+  bool popTask(size_t queue_idx, Task* task);
+  void mainLoop(size_t worker_idx);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  // For the idle workers to wait for tasks
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool running_ = true;
+
+  std::atomic<size_t> num_pending_{0};
+  std::atomic<size_t> num_available_;
+  std::atomic<uint64_t> next_seq_{0};
+  std::atomic<size_t> next_queue_{0};
+
+  C10_DISABLE_COPY_AND_ASSIGN(WorkStealingTaskThreadPool);
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_CORE_NET_ASYNC_WORK_STEALING_POOL_H_
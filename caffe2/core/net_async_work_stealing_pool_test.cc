@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/net_async_work_stealing_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace caffe2 {
+
+TEST(WorkStealingTaskThreadPoolTest, RunsAllTasks) {
+  std::atomic<int> counter{0};
+  std::promise<void> done;
+  const int num_tasks = 1000;
+  {
+    WorkStealingTaskThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_FALSE(pool.inThreadPool());
+    for (int i = 0; i < num_tasks; ++i) {
+      pool.run([&]() {
+        if (++counter == num_tasks) {
+          done.set_value();
+        }
+      });
+    }
+    done.get_future().wait();
+  }
+  EXPECT_EQ(counter, num_tasks);
+}
+
+TEST(WorkStealingTaskThreadPoolTest, RunsHigherPriorityFirst) {
+  WorkStealingTaskThreadPool pool(1);
+  std::promise<void> started;
+  std::promise<void> release;
+  auto release_future = release.get_future();
+  // Keep the only worker busy while the tasks are queued
+  pool.run([&]() {
+    started.set_value();
+    release_future.wait();
+  });
+  started.get_future().wait();
+
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  const std::vector<int> priorities = {1, 3, 0, 3, 2};
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    pool.runWithPriority(
+        [&, i]() {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(i);
+          if (order.size() == priorities.size()) {
+            done.set_value();
+          }
+        },
+        priorities[i]);
+  }
+  release.set_value();
+  done.get_future().wait();
+
+  // Oldest first among the tasks of the same priority
+  std::vector<int> expected = {1, 3, 4, 0, 2};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(WorkStealingTaskThreadPoolTest, StealsTasksOfBusyWorkers) {
+  WorkStealingTaskThreadPool pool(2);
+  std::promise<void> stolen;
+  std::promise<bool> result;
+  pool.run([&]() {
+    EXPECT_TRUE(pool.inThreadPool());
+    // Goes to the queue of this worker, which waits for it, so only the
+    // other worker can run it
+    pool.run([&]() { stolen.set_value(); });
+    auto status = stolen.get_future().wait_for(std::chrono::seconds(10));
+    result.set_value(status == std::future_status::ready);
+  });
+  EXPECT_TRUE(result.get_future().get());
+}
+
+} // namespace caffe2
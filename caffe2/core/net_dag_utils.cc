@@ -1,5 +1,6 @@
 #include "caffe2/core/net_dag_utils.h"
 
+#include <algorithm>
 #include <set>
 #include <stack>
 #include <unordered_map>
@@ -512,5 +513,41 @@ std::vector<OpGraphNode> prepareChainGraphNodes(
   return chain_nodes;
 }
 
+std::vector<int> computeCriticalPathLengths(
+    const std::vector<OpGraphNode>& chain_nodes,
+    const std::vector<std::vector<int>>& execution_chains) {
+  CAFFE_ENFORCE_EQ(chain_nodes.size(), execution_chains.size());
+  const int num_chains = chain_nodes.size();
+
+  // Topological order of the chains, parents first
+  std::vector<int> order;
+  order.reserve(num_chains);
+  std::vector<int> num_parents(num_chains);
+  for (int chain_idx = 0; chain_idx < num_chains; ++chain_idx) {
+    num_parents[chain_idx] = chain_nodes[chain_idx].parents_.size();
+    if (num_parents[chain_idx] == 0) {
+      order.push_back(chain_idx);
+    }
+  }
+  for (int i = 0; i < (int)order.size(); ++i) {
+    for (const auto& child_idx : chain_nodes[order[i]].children_) {
+      if (--num_parents[child_idx] == 0) {
+        order.push_back(child_idx);
+      }
+    }
+  }
+  CAFFE_ENFORCE_EQ((int)order.size(), num_chains, "Chain graph has a cycle");
+
+  std::vector<int> lengths(num_chains, 0);
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    int longest_child_path = 0;
+    for (const auto& child_idx : chain_nodes[*it].children_) {
+      longest_child_path = std::max(longest_child_path, lengths[child_idx]);
+    }
+    lengths[*it] = (int)execution_chains[*it].size() + longest_child_path;
+  }
+  return lengths;
+}
+
 } // namespace dag_utils
 } // namespace caffe2
@@ -63,6 +63,13 @@ std::vector<OpGraphNode> prepareChainGraphNodes(
     const std::vector<dag_utils::OperatorNode>& operator_nodes,
     const std::vector<std::vector<int>>& execution_chains);
 
+// Returns, for every chain, the number of ops on the longest path of chains
+// that starts with it, the chain included, i.e. how much of the graph is left
+// to run at least once the chain starts
+C10_EXPORT std::vector<int> computeCriticalPathLengths(
+    const std::vector<OpGraphNode>& chain_nodes,
+    const std::vector<std::vector<int>>& execution_chains);
+
 } // namespace dag_utils
 } // namespace caffe2
 
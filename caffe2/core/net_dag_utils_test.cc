@@ -1,3 +1,5 @@
+#include <map>
+
 #include <gtest/gtest.h>
 #include "caffe2/core/net_dag_utils.h"
 #include "caffe2/core/operator.h"
@@ -51,6 +53,18 @@ class DagUtilTestContext {
     return dag_utils::computeGroups(operator_nodes_);
   }
 
+  std::vector<int> computeCriticalPathLengths(
+      const dag_utils::ExecutionChains& chains) {
+    std::map<int, std::vector<int>> sorted_chains(chains.begin(), chains.end());
+    std::vector<std::vector<int>> chains_vec;
+    for (const auto& kv : sorted_chains) {
+      chains_vec.push_back(kv.second);
+    }
+    auto chain_nodes =
+        dag_utils::prepareChainGraphNodes(operator_nodes_, chains_vec);
+    return dag_utils::computeCriticalPathLengths(chain_nodes, chains_vec);
+  }
+
  private:
   std::shared_ptr<NetDef> net_def_{nullptr};
   std::vector<dag_utils::OperatorNode> operator_nodes_;
@@ -293,4 +307,50 @@ TEST(DagUtilTest, Mixed2) {
       {0, {0}}, {1, {1}}, {3, {3, 6}}, {4, {4, 2, 5}}, {7, {7}}, {8, {8}}};
   EXPECT_EQ(chains, expected);
 }
+// A path of 4 ops, the second one sync, next to a single async op. * means
+// async
+//  0* -> 1 -> 2* -> 3*
+//  4*
+TEST(DagUtilTest, CriticalPathLengths) {
+  const auto spec = R"DOC(
+    name: "test6"
+    type: "async_scheduling"
+    external_input: "in"
+    op {
+      input: "in"
+      output: "n1"
+      type: "DagUtilTestDummyAsync"
+    }
+    op {
+      input: "n1"
+      output: "n2"
+      type: "DagUtilTestDummySync"
+    }
+    op {
+      input: "n2"
+      output: "n3"
+      type: "DagUtilTestDummyAsync"
+    }
+    op {
+      input: "n3"
+      output: "out"
+      type: "DagUtilTestDummyAsync"
+    }
+    op {
+      input: "in"
+      output: "side"
+      type: "DagUtilTestDummyAsync"
+    }
+    )DOC";
+  Workspace ws;
+  ws.CreateBlob("in");
+  DagUtilTestContext t(spec, &ws);
+  auto chains = t.computeChains();
+  dag_utils::ExecutionChains expected{
+      {0, {0}}, {1, {1}}, {2, {2}}, {3, {3}}, {4, {4}}};
+  EXPECT_EQ(chains, expected);
+  std::vector<int> expected_lengths{4, 3, 2, 1, 1};
+  EXPECT_EQ(t.computeCriticalPathLengths(chains), expected_lengths);
+}
+
 } // namespace caffe2
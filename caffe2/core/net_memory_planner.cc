@@ -0,0 +1,374 @@
+#include "caffe2/core/net_memory_planner.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "caffe2/core/logging.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/utils/proto_utils.h"
+
+C10_DEFINE_bool(
+    caffe2_net_dynamic_memonger,
+    false,
+    "If set, serve the intermediate CPU blobs of simple and async nets from an "
+    "arena laid out from the blob sizes of their first runs");
+
+C10_DEFINE_int(
+    caffe2_net_dynamic_memonger_profiling_runs,
+    2,
+    "Number of runs of a net that record the blob sizes before the dynamic "
+    "memonger lays out its arena");
+
+namespace caffe2 {
+
+namespace {
+constexpr size_t kRegionAlignment = 64;
+
+size_t alignedSize(size_t nbytes) {
+  return (nbytes + kRegionAlignment - 1) / kRegionAlignment *
+      kRegionAlignment;
+}
+
+const void* tensorData(const Tensor& tensor) {
+  return tensor.storage().data();
+}
+} // namespace
+
+struct NetMemoryPlanner::Arena {
+  at::DataPtr data;
+};
+
+namespace {
+// Deleter of the tensors pointing to the arena, which keep it alive until they
+// are given other memory
+void releaseArena(void* ctx) {
+  delete static_cast<std::shared_ptr<void>*>(ctx);
+}
+} // namespace
+
+bool NetMemoryPlanner::enabled(const NetDef& net_def) {
+  ArgumentHelper helper(net_def);
+  return helper.GetSingleArgument<int>(
+             "dynamic_memonger", FLAGS_caffe2_net_dynamic_memonger ? 1 : 0) ==
+      1;
+}
+
+NetMemoryPlanner::NetMemoryPlanner(
+    const NetDef& net_def,
+    const std::vector<OperatorBase*>& ops,
+    Workspace* ws,
+    const std::vector<std::vector<int>>& op_parents)
+    : op_blobs_(ops.size()), sequential_(op_parents.empty()) {
+  CAFFE_ENFORCE_EQ((int)ops.size(), net_def.op_size());
+  std::unordered_map<std::string, int> blob_ids;
+  auto blobId = [&](const std::string& name) {
+    auto it = blob_ids.find(name);
+    if (it != blob_ids.end()) {
+      return it->second;
+    }
+    const int id = blobs_.size();
+    blob_ids.emplace(name, id);
+    blobs_.emplace_back();
+    blobs_.back().name = name;
+    blobs_.back().blob = ws->GetBlob(name);
+    return id;
+  };
+
+  for (int op_idx = 0; op_idx < (int)ops.size(); ++op_idx) {
+    const auto& op_def = net_def.op(op_idx);
+    for (const auto& arg : op_def.arg()) {
+      if (arg.has_n() || arg.nets_size() > 0) {
+        LOG(INFO) << "Not planning the memory of net " << net_def.name()
+                  << ", op " << op_def.type() << " has a subnet";
+        disabled_ = true;
+        return;
+      }
+    }
+    // Async and non-CPU ops may use their blobs after they return
+    const bool sync_cpu_op =
+        ops[op_idx]->device_option().device_type() == PROTO_CPU &&
+        !ops[op_idx]->HasAsyncPart();
+    auto& op_blobs = op_blobs_[op_idx];
+    for (const auto& name : op_def.input()) {
+      const int id = blobId(name);
+      auto& readers = blobs_[id].readers;
+      if (readers.empty() || readers.back() != op_idx) {
+        readers.push_back(op_idx);
+      }
+      op_blobs.inputs.push_back(id);
+      blobs_[id].plannable &= sync_cpu_op;
+    }
+    for (const auto& name : op_def.output()) {
+      const int id = blobId(name);
+      auto& writers = blobs_[id].writers;
+      if (writers.empty() || writers.back() != op_idx) {
+        writers.push_back(op_idx);
+      }
+      op_blobs.outputs.push_back(id);
+      blobs_[id].plannable &= sync_cpu_op;
+    }
+  }
+  for (const auto& name : net_def.external_input()) {
+    blobs_[blobId(name)].plannable = false;
+  }
+  for (const auto& name : net_def.external_output()) {
+    blobs_[blobId(name)].plannable = false;
+  }
+
+  if (!sequential_) {
+    CAFFE_ENFORCE_EQ(op_parents.size(), ops.size());
+    const size_t num_words = (ops.size() + 63) / 64;
+    op_ancestors_.assign(ops.size(), std::vector<uint64_t>(num_words, 0));
+    for (int op_idx = 0; op_idx < (int)ops.size(); ++op_idx) {
+      auto& ancestors = op_ancestors_[op_idx];
+      for (int parent : op_parents[op_idx]) {
+        CAFFE_ENFORCE_LT(parent, op_idx, "Ops must be in topological order");
+        const auto& parent_ancestors = op_ancestors_[parent];
+        for (size_t w = 0; w < num_words; ++w) {
+          ancestors[w] |= parent_ancestors[w];
+        }
+        ancestors[parent / 64] |= uint64_t(1) << (parent % 64);
+      }
+    }
+  }
+
+  for (auto& info : blobs_) {
+    if (!info.plannable || !info.blob || info.writers.empty()) {
+      info.plannable = false;
+      continue;
+    }
+    // The first writer of the blob must happen before all its other uses, and
+    // not read it
+    int first_writer = info.writers.front();
+    for (int writer : info.writers) {
+      if (happensBefore(writer, first_writer)) {
+        first_writer = writer;
+      }
+    }
+    bool dominates = std::find(
+                         info.readers.begin(),
+                         info.readers.end(),
+                         first_writer) == info.readers.end();
+    for (int op_idx : info.writers) {
+      dominates &= op_idx == first_writer || happensBefore(first_writer, op_idx);
+    }
+    for (int op_idx : info.readers) {
+      dominates &= happensBefore(first_writer, op_idx);
+    }
+    if (dominates) {
+      info.first_writer = first_writer;
+    } else {
+      info.plannable = false;
+    }
+  }
+}
+
+NetMemoryPlanner::~NetMemoryPlanner() = default;
+
+bool NetMemoryPlanner::happensBefore(int op_a, int op_b) const {
+  if (sequential_) {
+    return op_a < op_b;
+  }
+  return (op_ancestors_[op_b][op_a / 64] >> (op_a % 64)) & 1;
+}
+
+bool NetMemoryPlanner::usedBefore(const BlobInfo& a, const BlobInfo& b) const {
+  for (int op_idx : a.writers) {
+    if (!happensBefore(op_idx, b.first_writer)) {
+      return false;
+    }
+  }
+  for (int op_idx : a.readers) {
+    if (!happensBefore(op_idx, b.first_writer)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void NetMemoryPlanner::observe(int blob_idx) {
+  auto& info = blobs_[blob_idx];
+  if (!info.plannable) {
+    return;
+  }
+  if (!BlobIsTensorType(*info.blob, CPU)) {
+    info.plannable = false;
+    return;
+  }
+  const auto& tensor = info.blob->Get<Tensor>();
+  const auto dtype = tensor.dtype();
+  if (dtype.placementNew() != nullptr ||
+      (info.dtype != TypeMeta() && info.dtype != dtype)) {
+    info.plannable = false;
+    return;
+  }
+  info.dtype = dtype;
+  info.max_nbytes = std::max(info.max_nbytes, tensor.nbytes());
+}
+
+void NetMemoryPlanner::startRun() {
+  if (disabled_) {
+    return;
+  }
+  if (!arena_) {
+    if (num_profiling_runs_ <
+        std::max(FLAGS_caffe2_net_dynamic_memonger_profiling_runs, 1)) {
+      ++num_profiling_runs_;
+    } else {
+      // Blobs that share a buffer, e.g. the outputs of Alias or in-place
+      // Reshape, can't be planned separately. Only checked before the first
+      // plan, later the blobs that share a region have the same data.
+      std::unordered_map<const void*, int> num_blobs_by_data;
+      for (auto& info : blobs_) {
+        if (info.blob && BlobIsTensorType(*info.blob, CPU)) {
+          info.data = tensorData(info.blob->Get<Tensor>());
+          if (info.data) {
+            ++num_blobs_by_data[info.data];
+          }
+        }
+      }
+      for (auto& info : blobs_) {
+        if (info.data && num_blobs_by_data[info.data] > 1) {
+          info.plannable = false;
+        }
+      }
+      plan();
+    }
+  } else if (needs_replan_.exchange(false)) {
+    plan();
+  }
+}
+
+void NetMemoryPlanner::plan() {
+  std::vector<int> candidates;
+  for (int blob_idx = 0; blob_idx < (int)blobs_.size(); ++blob_idx) {
+    auto& info = blobs_[blob_idx];
+    info.offset = -1;
+    if (info.plannable && info.max_nbytes > 0) {
+      info.region_nbytes = alignedSize(info.max_nbytes);
+      candidates.push_back(blob_idx);
+    }
+  }
+  for (auto& op_blobs : op_blobs_) {
+    op_blobs.first_writes.clear();
+  }
+  if (candidates.empty()) {
+    LOG(INFO) << "No blob to plan the memory of";
+    arena_.reset();
+    disabled_ = true;
+    return;
+  }
+
+  // Greedy by size: every blob, largest first, takes the lowest offset that
+  // doesn't overlap with the placed blobs that are used at the same time
+  std::stable_sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+    return blobs_[a].region_nbytes > blobs_[b].region_nbytes;
+  });
+  std::vector<int> placed;
+  size_t arena_nbytes = 0;
+  for (int blob_idx : candidates) {
+    auto& info = blobs_[blob_idx];
+    std::vector<std::pair<size_t, size_t>> taken;
+    for (int placed_idx : placed) {
+      const auto& other = blobs_[placed_idx];
+      if (!usedBefore(info, other) && !usedBefore(other, info)) {
+        taken.emplace_back(other.offset, other.offset + other.region_nbytes);
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+    size_t offset = 0;
+    for (const auto& range : taken) {
+      if (range.first >= offset + info.region_nbytes) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    info.offset = offset;
+    arena_nbytes = std::max(arena_nbytes, offset + info.region_nbytes);
+    placed.push_back(blob_idx);
+    op_blobs_[info.first_writer].first_writes.push_back(blob_idx);
+  }
+
+  // The tensors still pointing to the previous arena keep it alive until
+  // their first writers give them their new region
+  arena_ = std::make_shared<Arena>();
+  arena_->data = GetCPUAllocator()->allocate(arena_nbytes);
+  arena_nbytes_ = arena_nbytes;
+  LOG(INFO) << "Planned " << placed.size() << " blobs of "
+            << plannedBytes() << " bytes in an arena of " << arena_nbytes
+            << " bytes";
+}
+
+void NetMemoryPlanner::beforeOp(int op_idx) {
+  if (!arena_) {
+    return;
+  }
+  for (int blob_idx : op_blobs_[op_idx].first_writes) {
+    const auto& info = blobs_[blob_idx];
+    void* region = static_cast<char*>(arena_->data.get()) + info.offset;
+    auto* tensor = BlobGetMutableTensor(info.blob, CPU);
+    if (tensor->storage().data() == region &&
+        tensor->storage().nbytes() >= info.region_nbytes) {
+      continue;
+    }
+    tensor->ShareExternalPointer(
+        at::DataPtr(
+            region,
+            new std::shared_ptr<void>(arena_),
+            &releaseArena,
+            at::Device(CPU)),
+        info.dtype,
+        info.region_nbytes);
+  }
+}
+
+void NetMemoryPlanner::afterOp(int op_idx) {
+  if (disabled_) {
+    return;
+  }
+  if (!arena_) {
+    for (int blob_idx : op_blobs_[op_idx].outputs) {
+      observe(blob_idx);
+    }
+    return;
+  }
+  for (int blob_idx : op_blobs_[op_idx].outputs) {
+    auto& info = blobs_[blob_idx];
+    if (info.offset < 0) {
+      continue;
+    }
+    const void* region = static_cast<char*>(arena_->data.get()) + info.offset;
+    if (!BlobIsTensorType(*info.blob, CPU) ||
+        tensorData(info.blob->Get<Tensor>()) != region) {
+      // Outgrew its region, or changed type
+      observe(blob_idx);
+      needs_replan_ = true;
+    }
+  }
+}
+
+size_t NetMemoryPlanner::arenaBytes() const {
+  return arena_ ? arena_nbytes_ : 0;
+}
+
+size_t NetMemoryPlanner::plannedBytes() const {
+  size_t nbytes = 0;
+  for (const auto& info : blobs_) {
+    if (info.offset >= 0) {
+      nbytes += info.region_nbytes;
+    }
+  }
+  return nbytes;
+}
+
+bool NetMemoryPlanner::isPlanned(const std::string& blob_name) const {
+  for (const auto& info : blobs_) {
+    if (info.name == blob_name) {
+      return info.offset >= 0;
+    }
+  }
+  return false;
+}
+
+} // namespace caffe2
@@ -0,0 +1,123 @@
+#ifndef CAFFE2_CORE_NET_MEMORY_PLANNER_H_
+#define CAFFE2_CORE_NET_MEMORY_PLANNER_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "c10/util/Flags.h"
+#include "caffe2/core/common.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+C10_DECLARE_bool(caffe2_net_dynamic_memonger);
+C10_DECLARE_int(caffe2_net_dynamic_memonger_profiling_runs);
+
+namespace caffe2 {
+
+// Runtime memonger: serves the intermediate CPU tensors of a net from a single
+// arena, laid out from the sizes and the lifetimes of the blobs observed in the
+// first runs of the net.
+//
+// Unlike memonger::optimize_inference_net, which renames blobs when the net is
+// built, the planner doesn't change the net. Its first runs (see
+// --caffe2_net_dynamic_memonger_profiling_runs) record the largest size of
+// every blob. Then two blobs share memory when all the ops that use the first
+// one happen before the op that first writes the second one, in the op order
+// of a sequential net, or in the dependencies of the ops of a parallel net.
+// Before an op first writes a blob, the planner points the tensor of the blob
+// to its region of the arena. A tensor that outgrows its region is allocated as
+// usual, and the arena is laid out again at the start of the next run.
+//
+// Only the blobs written and used by the ops of the net are planned: not the
+// external inputs and outputs, not the outputs of async or non-CPU ops, nor
+// blobs that share a buffer with another blob. Intermediate blobs fetched after a
+// run may have been overwritten by other blobs. Nets with subnets (e.g. If,
+// While) are not planned, since the planner can't see the blobs they use.
+class CAFFE2_API NetMemoryPlanner {
+ public:
+  // ops are the ops of net_def, in the same order. op_parents are the ops
+  // that every op depends on when the ops may run in parallel, empty for the
+  // nets that run the ops in order.
+  NetMemoryPlanner(
+      const NetDef& net_def,
+      const std::vector<OperatorBase*>& ops,
+      Workspace* ws,
+      const std::vector<std::vector<int>>& op_parents = {});
+  ~NetMemoryPlanner();
+
+  // Whether the planner is enabled for the net, with
+  // --caffe2_net_dynamic_memonger or the dynamic_memonger argument of the net
+  static bool enabled(const NetDef& net_def);
+
+  // Must be called before each run, not concurrently with it
+  void startRun();
+  // Can be called concurrently for ops without dependencies between them
+  void beforeOp(int op_idx);
+  void afterOp(int op_idx);
+
+  bool hasPlan() const {
+    return arena_ != nullptr;
+  }
+  size_t arenaBytes() const;
+  // Total size of the planned blobs, what they would take without sharing
+  size_t plannedBytes() const;
+  bool isPlanned(const std::string& blob_name) const;
+
+ private:
+  struct Arena;
+
+  struct BlobInfo {
+    std::string name;
+    Blob* blob = nullptr;
+    std::vector<int> writers;
+    std::vector<int> readers;
+    // First writer, which all the other users of the blob depend on, or -1
+    int first_writer = -1;
+    bool plannable = true;
+
+    // Observed while profiling, or when the blob outgrows its region
+    size_t max_nbytes = 0;
+    TypeMeta dtype;
+    const void* data = nullptr;
+
+    // Region of the blob in the arena, offset -1 when not planned
+    int64_t offset = -1;
+    size_t region_nbytes = 0;
+  };
+
+  // Planned blobs that an op writes first, and all the blobs it writes and reads
+  struct OpBlobs {
+    std::vector<int> first_writes;
+    std::vector<int> outputs;
+    std::vector<int> inputs;
+  };
+
+  bool happensBefore(int op_a, int op_b) const;
+  // Whether all the uses of blob a happen before blob b is written
+  bool usedBefore(const BlobInfo& a, const BlobInfo& b) const;
+  void observe(int blob_idx);
+  void plan();
+
+  std::vector<BlobInfo> blobs_;
+  std::vector<OpBlobs> op_blobs_;
+  bool sequential_;
+  // With parallel ops, bitset of the ops that every op depends on,
+  // transitively
+  std::vector<std::vector<uint64_t>> op_ancestors_;
+
+  int num_profiling_runs_ = 0;
+  bool disabled_ = false;
+  std::shared_ptr<Arena> arena_;
+  size_t arena_nbytes_ = 0;
+  // Set when a planned blob outgrew its region
+  std::atomic<bool> needs_replan_{false};
+
+  C10_DISABLE_COPY_AND_ASSIGN(NetMemoryPlanner);
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_CORE_NET_MEMORY_PLANNER_H_
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/net.h"
+#include "caffe2/core/net_async_base.h"
+#include "caffe2/core/net_memory_planner.h"
+#include "caffe2/core/net_simple.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/workspace.h"
+
+#include <google/protobuf/text_format.h>
+
+namespace caffe2 {
+
+namespace {
+
+// X -> a -> b -> c -> out, a and c can share their memory
+NetDef chainNet(const std::string& type) {
+  const auto spec = R"DOC(
+      name: "example"
+      arg {
+        name: "dynamic_memonger"
+        i: 1
+      }
+      external_input: "X"
+      external_output: "out"
+      op {
+        input: "X"
+        output: "a"
+        type: "Scale"
+        arg { name: "scale" f: 2.0 }
+      }
+      op {
+        input: "a"
+        output: "b"
+        type: "Scale"
+        arg { name: "scale" f: 2.0 }
+      }
+      op {
+        input: "b"
+        output: "c"
+        type: "Scale"
+        arg { name: "scale" f: 2.0 }
+      }
+      op {
+        input: "c"
+        output: "out"
+        type: "Scale"
+        arg { name: "scale" f: 2.0 }
+      }
+)DOC";
+  NetDef net_def;
+  CAFFE_ENFORCE(
+      ::google::protobuf::TextFormat::ParseFromString(spec, &net_def));
+  net_def.set_type(type);
+  return net_def;
+}
+
+void feedInput(Workspace* ws, int64_t size, float value) {
+  auto* tensor = BlobGetMutableTensor(ws->CreateBlob("X"), CPU);
+  tensor->Resize(size);
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = value;
+  }
+}
+
+void checkOutput(Workspace* ws, int64_t size, float value) {
+  const auto& tensor = ws->GetBlob("out")->Get<TensorCPU>();
+  ASSERT_EQ(tensor.numel(), size);
+  for (int64_t i = 0; i < size; ++i) {
+    ASSERT_EQ(tensor.data<float>()[i], value);
+  }
+}
+
+template <typename Net>
+void testChainNet(const std::string& type) {
+  Workspace ws;
+  feedInput(&ws, 1000, 1);
+  std::unique_ptr<NetBase> net(CreateNet(chainNet(type), &ws));
+  auto* typed_net = dynamic_cast<Net*>(net.get());
+  ASSERT_NE(typed_net, nullptr);
+  const auto* planner = typed_net->TEST_memoryPlanner();
+  ASSERT_NE(planner, nullptr);
+
+  for (int run = 0; run < FLAGS_caffe2_net_dynamic_memonger_profiling_runs;
+       ++run) {
+    ASSERT_TRUE(net->Run());
+    checkOutput(&ws, 1000, 16);
+    EXPECT_FALSE(planner->hasPlan());
+  }
+  for (int run = 0; run < 2; ++run) {
+    feedInput(&ws, 1000, run + 1);
+    ASSERT_TRUE(net->Run());
+    checkOutput(&ws, 1000, 16 * (run + 1));
+  }
+  EXPECT_TRUE(planner->hasPlan());
+  EXPECT_TRUE(planner->isPlanned("a"));
+  EXPECT_TRUE(planner->isPlanned("b"));
+  EXPECT_TRUE(planner->isPlanned("c"));
+  EXPECT_FALSE(planner->isPlanned("X"));
+  EXPECT_FALSE(planner->isPlanned("out"));
+  EXPECT_EQ(planner->plannedBytes(), 3 * planner->arenaBytes() / 2);
+
+  // The blobs outgrow their regions, and get new ones in the next runs
+  const auto arena_nbytes = planner->arenaBytes();
+  for (int run = 0; run < 2; ++run) {
+    feedInput(&ws, 3000, 1);
+    ASSERT_TRUE(net->Run());
+    checkOutput(&ws, 3000, 16);
+  }
+  EXPECT_TRUE(planner->hasPlan());
+  EXPECT_GT(planner->arenaBytes(), 2 * arena_nbytes);
+}
+
+} // namespace
+
+TEST(NetMemoryPlannerTest, SimpleNet) {
+  testChainNet<SimpleNet>("simple");
+}
+
+TEST(NetMemoryPlannerTest, AsyncNet) {
+  testChainNet<AsyncNetBase>("async_scheduling");
+}
+
+TEST(NetMemoryPlannerTest, DisabledByDefault) {
+  Workspace ws;
+  feedInput(&ws, 10, 1);
+  auto net_def = chainNet("simple");
+  net_def.clear_arg();
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* simple_net = dynamic_cast<SimpleNet*>(net.get());
+  ASSERT_NE(simple_net, nullptr);
+  EXPECT_EQ(simple_net->TEST_memoryPlanner(), nullptr);
+}
+
+} // namespace caffe2
@@ -49,12 +49,20 @@ SimpleNet::SimpleNet(
     }
     operators_.emplace_back(std::move(op));
   }
+  if (NetMemoryPlanner::enabled(*net_def)) {
+    memory_planner_ = std::make_unique<NetMemoryPlanner>(
+        *net_def, GetOperators(), ws);
+  }
 }
 
 bool SimpleNet::Run() {
   StartAllObservers();
   VLOG(1) << "Running net " << name_;
-  for (auto& op : operators_) {
+  if (memory_planner_) {
+    memory_planner_->startRun();
+  }
+  for (int op_idx = 0; op_idx < (int)operators_.size(); ++op_idx) {
+    auto& op = operators_[op_idx];
     VLOG(1) << "Running operator " << op->debug_def().name() << "("
             << op->debug_def().type() << ").";
 #ifdef CAFFE2_ENABLE_SDT
@@ -64,6 +72,9 @@ bool SimpleNet::Run() {
     const auto& net_name = name_.c_str();
     CAFFE_SDT(operator_start, net_name, op_name, op_type, op_ptr);
 #endif
+    if (memory_planner_) {
+      memory_planner_->beforeOp(op_idx);
+    }
     bool res = op->Run();
 #ifdef CAFFE2_ENABLE_SDT
     CAFFE_SDT(operator_done, net_name, op_name, op_type, op_ptr);
@@ -78,6 +89,9 @@ bool SimpleNet::Run() {
       LOG(ERROR) << "Operator failed: " << ProtoDebugString(op->debug_def());
       return false;
     }
+    if (memory_planner_) {
+      memory_planner_->afterOp(op_idx);
+    }
   }
   StopAllObservers();
   return true;
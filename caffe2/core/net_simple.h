@@ -7,6 +7,7 @@
 #include "caffe2/core/common.h"
 #include "caffe2/core/logging.h"
 #include "caffe2/core/net.h"
+#include "caffe2/core/net_memory_planner.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/core/workspace.h"
 #include "caffe2/proto/caffe2_pb.h"
@@ -42,11 +43,17 @@ class CAFFE2_API SimpleNet : public NetBase {
     return op_list;
   }
 
+  // nullptr unless the dynamic memonger is enabled for the net
+  const NetMemoryPlanner* TEST_memoryPlanner() const {
+    return memory_planner_.get();
+  }
+
  protected:
   bool Run() override;
   bool RunAsync() override;
 
   vector<unique_ptr<OperatorBase>> operators_;
+  std::unique_ptr<NetMemoryPlanner> memory_planner_;
 
   C10_DISABLE_COPY_AND_ASSIGN(SimpleNet);
 };
@@ -697,6 +697,62 @@ TEST(NetTest, AsyncEmptyNet) {
   }
 }
 
+TEST(NetTest, AsyncPrioritySchedulingNet) {
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        arg {
+          name: "priority_scheduling"
+          i: 1
+        }
+        external_input: "in"
+        op {
+          input: "in"
+          output: "a1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "a1"
+          output: "a2"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "a2"
+          output: "a3"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "in"
+          output: "b1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "in"
+          output: "c1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "a3"
+          input: "b1"
+          input: "c1"
+          output: "out"
+          type: "NetTestDummy"
+        }
+  )DOC";
+
+  Workspace ws;
+  ws.CreateBlob("in");
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  net_def.set_num_workers(kTestPoolSize);
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  for (int i = 0; i < 3; ++i) {
+    counter.exchange(0);
+    ASSERT_TRUE(net->Run());
+    ASSERT_EQ(6, counter.load());
+  }
+}
+
 TEST(NetTest, DISABLED_RunAsyncFailure) {
   const auto spec = R"DOC(
         name: "example"
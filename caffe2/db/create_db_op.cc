@@ -3,7 +3,20 @@
 namespace caffe2 {
 REGISTER_CPU_OPERATOR(CreateDB, CreateDBOp<CPUContext>);
 
-OPERATOR_SCHEMA(CreateDB).NumInputs(0).NumOutputs(1);
+OPERATOR_SCHEMA(CreateDB)
+    .NumInputs(0)
+    .NumOutputs(1)
+    .Arg("db_type", "Type of the db, leveldb by default")
+    .Arg("db", "Path of the db")
+    .Arg("num_shards", "Number of shards the records are split into")
+    .Arg("shard_id", "Shard of the records that the reader reads")
+    .Arg(
+        "readahead_threads",
+        "If positive, number of threads that read the records ahead, each "
+        "with its own cursor. The records are still read in order.")
+    .Arg(
+        "readahead_buffer_size",
+        "Number of records each readahead thread buffers, 64 by default");
 
 NO_GRADIENT(CreateDB);
 }  // namespace caffe2
@@ -19,13 +19,22 @@ class CreateDBOp final : public Operator<Context> {
         num_shards_(
             OperatorBase::template GetSingleArgument<int>("num_shards", 1)),
         shard_id_(
-            OperatorBase::template GetSingleArgument<int>("shard_id", 0)) {
+            OperatorBase::template GetSingleArgument<int>("shard_id", 0)),
+        readahead_threads_(OperatorBase::template GetSingleArgument<int>(
+            "readahead_threads",
+            0)),
+        readahead_buffer_size_(OperatorBase::template GetSingleArgument<int>(
+            "readahead_buffer_size",
+            64)) {
     CAFFE_ENFORCE_GT(db_name_.size(), 0, "Must specify a db name.");
   }
 
   bool RunOnDevice() final {
-    OperatorBase::Output<db::DBReader>(0)->Open(
-        db_type_, db_name_, num_shards_, shard_id_);
+    auto* reader = OperatorBase::Output<db::DBReader>(0);
+    reader->Open(db_type_, db_name_, num_shards_, shard_id_);
+    if (readahead_threads_ > 0) {
+      reader->EnableReadahead(readahead_threads_, readahead_buffer_size_);
+    }
     return true;
   }
 
@@ -34,6 +43,8 @@ class CreateDBOp final : public Operator<Context> {
   string db_name_;
   uint32_t num_shards_;
   uint32_t shard_id_;
+  int readahead_threads_;
+  int readahead_buffer_size_;
   C10_DISABLE_COPY_AND_ASSIGN(CreateDBOp);
 };
 
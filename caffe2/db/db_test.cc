@@ -200,5 +200,59 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBReaderReadaheadTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name));
+  reader->EnableReadahead(3, 2);
+  string key;
+  string value;
+  // Records come in the order of the db
+  for (int i = 0; i < kMaxItems; ++i) {
+    std::stringstream ss;
+    ss << std::setw(2) << std::setfill('0') << i;
+    reader->Read(&key, &value);
+    EXPECT_EQ(key, ss.str());
+    EXPECT_EQ(value, ss.str());
+  }
+  reader->Read(&key, &value);
+  reader->Read(&key, &value);
+  reader->SeekToFirst();
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "00");
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "01");
+  reader->EnableReadahead(0, 1);
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "00");
+
+  CreateAndFill("leveldb", name + "1");
+  std::unique_ptr<DBReader> sharded_reader(
+      new DBReader("leveldb", name + "1", 3, 1));
+  sharded_reader->EnableReadahead(2, 4);
+  sharded_reader->Read(&key, &value);
+  EXPECT_EQ(key, "01");
+  sharded_reader->Read(&key, &value);
+  EXPECT_EQ(key, "04");
+  sharded_reader->Read(&key, &value);
+  EXPECT_EQ(key, "07");
+}
+
+TEST(DBReaderReadaheadTest, SingleCursorDB) {
+  // minidb doesn't support concurrent cursors, a single thread reads ahead
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("minidb", name);
+  std::unique_ptr<DBReader> reader(new DBReader("minidb", name));
+  reader->EnableReadahead(4, 1);
+  string key;
+  string value;
+  for (int i = 0; i < kMaxItems; ++i) {
+    reader->Read(&key, &value);
+  }
+  EXPECT_EQ(key, "09");
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "00");
+}
+
 } // namespace db
 } // namespace caffe2
@@ -135,6 +135,9 @@ class LMDB : public DB {
   unique_ptr<Transaction> NewTransaction() override {
     return make_unique<LMDBTransaction>(mdb_env_);
   }
+  bool SupportsConcurrentCursors() override {
+    return true;
+  }
 
  private:
   MDB_env* mdb_env_;
@@ -95,6 +95,9 @@ class ProtoDB : public DB {
   unique_ptr<Transaction> NewTransaction() override {
     return make_unique<ProtoDBTransaction>(&proto_);
   }
+  bool SupportsConcurrentCursors() override {
+    return true;
+  }
 
  private:
   TensorProtos proto_;
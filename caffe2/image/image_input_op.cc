@@ -14,6 +14,16 @@ bool ImageInputOp<CPUContext>::ApplyTransformOnGPU(
   return false;
 }
 
+template <>
+void ImageInputOp<CPUContext>::InitGPUDecoder() {
+  CAFFE_THROW("use_gpu_decode can only be used in a CUDAContext");
+}
+
+template <>
+bool ImageInputOp<CPUContext>::DecodeBatchOnGPU() {
+  return false;
+}
+
 REGISTER_CPU_OPERATOR(ImageInput, ImageInputOp<CPUContext>);
 
 OPERATOR_SCHEMA(ImageInput)
@@ -130,6 +140,15 @@ The dimension of the output image will always be cropxcrop
         "use_gpu_transform",
         "1 if GPU acceleration should be used."
         " Defaults to 0. Can only be 1 in a CUDAContext")
+    .Arg(
+        "use_gpu_decode",
+        "1 if JPEGs should be decoded, resized and cropped on the GPU with "
+        "nvJPEG. Defaults to 0. Requires use_gpu_transform and a build with "
+        "USE_NVJPEG; images that are not JPEGs still go through OpenCV")
+    .Arg(
+        "gpu_decode_backend",
+        "hybrid (Huffman decode on the CPU, IDCT on the GPU) or gpu (all "
+        "of the decode on the GPU). Defaults to hybrid")
     .Arg(
         "decode_threads",
         "Number of CPU decode/transform threads."
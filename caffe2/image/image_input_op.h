@@ -10,6 +10,7 @@
 #include "c10/core/thread_pool.h"
 #include "caffe2/core/common.h"
 #include "caffe2/core/db.h"
+#include "caffe2/image/jpeg_decoder_gpu.h"
 #include "caffe2/image/transform_gpu.h"
 #include "caffe2/operators/prefetch_op.h"
 #include "caffe2/proto/caffe2_legacy.pb.h"
@@ -79,7 +80,8 @@ class ImageInputOp final : public PrefetchOperator<Context> {
       cv::Mat* img,
       PerImageArg& info,
       int item_id,
-      std::mt19937* randgen);
+      std::mt19937* randgen,
+      GPUJpegItem* gpu_jpeg = nullptr);
   void DecodeAndTransform(
       const std::string& value,
       float* image_data,
@@ -95,6 +97,20 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool ApplyTransformOnGPU(
       const std::vector<std::int64_t>& dims,
       const c10::Device& type);
+  // GPU decode path: the CPU threads only parse the record and pick the crop
+  // window, the JPEG itself is decoded and resized in one batch on the GPU.
+  void DecodeForGPU(
+      const std::string& value,
+      uint8_t* image_data,
+      int item_id,
+      const int channels,
+      std::size_t thread_index);
+  void SampleGPUCropWindow(
+      const PerImageArg& info,
+      GPUJpegItem* jpeg,
+      std::mt19937* randgen);
+  void InitGPUDecoder();
+  bool DecodeBatchOnGPU();
 
   unique_ptr<db::DBReader> owned_reader_;
   const db::DBReader* reader_;
@@ -135,8 +151,15 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool is_test_;
   bool use_caffe_datum_;
   bool gpu_transform_;
+  bool gpu_decode_;
+  std::string gpu_decode_backend_;
   bool mean_std_copied_ = false;
 
+  // Batched JPEG decoder and the per-batch images it decodes, only set up
+  // with use_gpu_decode
+  std::shared_ptr<GPUJpegDecoder> gpu_decoder_;
+  std::vector<GPUJpegItem> gpu_jpegs_;
+
   // thread pool for parse + decode
   int num_decode_threads_;
   int additional_inputs_offset_;
@@ -205,6 +228,11 @@ ImageInputOp<Context>::ImageInputOp(
       gpu_transform_(OperatorBase::template GetSingleArgument<int>(
           "use_gpu_transform",
           0)),
+      gpu_decode_(
+          OperatorBase::template GetSingleArgument<int>("use_gpu_decode", 0)),
+      gpu_decode_backend_(OperatorBase::template GetSingleArgument<string>(
+          "gpu_decode_backend",
+          "hybrid")),
       num_decode_threads_(
           OperatorBase::template GetSingleArgument<int>("decode_threads", 4)),
       additional_output_sizes_(
@@ -328,6 +356,17 @@ ImageInputOp<Context>::ImageInputOp(
     default_arg_.bounding_params.valid = true;
   }
 
+  if (gpu_decode_) {
+    CAFFE_ENFORCE(
+        gpu_transform_, "use_gpu_decode requires use_gpu_transform to be set");
+    CAFFE_ENFORCE(
+        gpu_decode_backend_ == "hybrid" || gpu_decode_backend_ == "gpu",
+        "gpu_decode_backend must be either hybrid or gpu, got ",
+        gpu_decode_backend_);
+    gpu_jpegs_.resize(batch_size_);
+    InitGPUDecoder();
+  }
+
   if (mean_.size() == 1) {
     // We are going to extend to 3 using the first value
     mean_.resize(3, mean_[0]);
@@ -339,6 +378,10 @@ ImageInputOp<Context>::ImageInputOp(
   if (gpu_transform_) {
     LOG(INFO) << "    Performing transformation on GPU";
   }
+  if (gpu_decode_) {
+    LOG(INFO) << "    Decoding JPEGs on GPU with the " << gpu_decode_backend_
+              << " backend";
+  }
   LOG(INFO) << "    Outputting in batches of " << batch_size_ << " images;";
   LOG(INFO) << "    Treating input image as "
             << (color_ ? "color " : "grayscale ") << "image;";
@@ -467,7 +510,13 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     CAFFE_ENFORCE(datum.ParseFromString(value));
 
     prefetched_label_.mutable_data<int>()[item_id] = datum.label();
-    if (datum.encoded()) {
+    if (datum.encoded() && gpu_jpeg != nullptr &&
+        GetJpegImageSize(
+            datum.data(), &gpu_jpeg->height, &gpu_jpeg->width)) {
+      // Leave the decode to the GPU, see DecodeForGPU
+      gpu_jpeg->data = datum.data();
+      gpu_jpeg->valid = true;
+    } else if (datum.encoded()) {
       // encoded image in datum.
       // count the number of exceptions from opencv imdecode
       try {
@@ -543,23 +592,31 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
       DCHECK_EQ(image_proto.string_data_size(), 1);
       const string& encoded_image_str = image_proto.string_data(0);
       int encoded_size = encoded_image_str.size();
-      // We use a cv::Mat to wrap the encoded str so we do not need a copy.
-      // count the number of exceptions from opencv imdecode
-      try {
-        src = cv::imdecode(
-            cv::Mat(
-                1,
-                &encoded_size,
-                CV_8UC1,
-                const_cast<char*>(encoded_image_str.data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
-        if (src.rows == 0 || src.cols == 0) {
+      if (gpu_jpeg != nullptr &&
+          GetJpegImageSize(
+              encoded_image_str, &gpu_jpeg->height, &gpu_jpeg->width)) {
+        // Leave the decode to the GPU, see DecodeForGPU
+        gpu_jpeg->data = encoded_image_str;
+        gpu_jpeg->valid = true;
+      } else {
+        // We use a cv::Mat to wrap the encoded str so we do not need a copy.
+        // count the number of exceptions from opencv imdecode
+        try {
+          src = cv::imdecode(
+              cv::Mat(
+                  1,
+                  &encoded_size,
+                  CV_8UC1,
+                  const_cast<char*>(encoded_image_str.data())),
+              color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+          if (src.rows == 0 || src.cols == 0) {
+            num_decode_errors_in_batch_++;
+            src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
+          }
+        } catch (cv::Exception& e) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
         }
-      } catch (cv::Exception& e) {
-        num_decode_errors_in_batch_++;
-        src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
       }
     } else if (image_proto.data_type() == TensorProto::BYTE) {
       // raw image content.
@@ -687,6 +744,11 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     }
   }
 
+  if (gpu_jpeg != nullptr && gpu_jpeg->valid) {
+    // Bounding box and scaling are folded into the GPU crop window
+    return true;
+  }
+
   //
   // convert source to the color format requested from Op
   //
@@ -1146,6 +1208,130 @@ void ImageInputOp<Context>::DecodeAndTransposeOnly(
       is_test_);
 }
 
+template <class Context>
+void ImageInputOp<Context>::DecodeForGPU(
+    const std::string& value,
+    uint8_t* image_data,
+    int item_id,
+    const int channels,
+    std::size_t thread_index) {
+  CAFFE_ENFORCE((int)thread_index < num_decode_threads_);
+
+  std::bernoulli_distribution mirror_this_image(0.5f);
+  std::mt19937* randgen = &(randgen_per_thread_[thread_index]);
+
+  GPUJpegItem* jpeg = &gpu_jpegs_[item_id];
+  jpeg->valid = false;
+  cv::Mat img;
+  PerImageArg info;
+  CHECK(GetImageAndLabelAndInfoFromDBValue(
+      value, &img, info, item_id, randgen, jpeg));
+
+  if (jpeg->valid) {
+    SampleGPUCropWindow(info, jpeg, randgen);
+  } else {
+    // Not a JPEG nvJPEG can handle, crop on the CPU and upload with the batch
+    CropTransposeImage<Context>(
+        img,
+        channels,
+        image_data,
+        crop_,
+        mirror_,
+        randgen,
+        &mirror_this_image,
+        is_test_);
+  }
+}
+
+// Picks the same window of the source image that bounding, scaling and
+// cropping select on the OpenCV path, expressed in source pixels so that the
+// GPU can go from the decoded image to the crop in a single resize.
+template <class Context>
+void ImageInputOp<Context>::SampleGPUCropWindow(
+    const PerImageArg& info,
+    GPUJpegItem* jpeg,
+    std::mt19937* randgen) {
+  float region_x = 0, region_y = 0;
+  int im_height = jpeg->height, im_width = jpeg->width;
+  if (info.bounding_params.valid &&
+      im_height >= info.bounding_params.ymin + info.bounding_params.height &&
+      im_width >= info.bounding_params.xmin + info.bounding_params.width) {
+    region_x = info.bounding_params.xmin;
+    region_y = info.bounding_params.ymin;
+    im_height = info.bounding_params.height;
+    im_width = info.bounding_params.width;
+  }
+  jpeg->mirror =
+      !is_test_ && mirror_ && std::bernoulli_distribution(0.5f)(*randgen);
+
+  if (scale_jitter_type_ == INCEPTION_STYLE && !is_test_) {
+    // Same sampling as RandomSizedCropping
+    int area = im_height * im_width;
+    std::uniform_real_distribution<> area_dis(0.08, 1.0);
+    std::uniform_real_distribution<> aspect_ratio_dis(3.0 / 4.0, 4.0 / 3.0);
+    for (int i = 0; i < 10; ++i) {
+      int target_area = int(ceil(area_dis(*randgen) * area));
+      float aspect_ratio = aspect_ratio_dis(*randgen);
+      int nh = floor(std::sqrt(((float)target_area / aspect_ratio)));
+      int nw = floor(std::sqrt(((float)target_area * aspect_ratio)));
+      if (nh >= 1 && nh <= im_height && nw >= 1 && nw <= im_width) {
+        jpeg->crop_y = region_y +
+            std::uniform_int_distribution<>(0, im_height - nh)(*randgen);
+        jpeg->crop_x = region_x +
+            std::uniform_int_distribution<>(0, im_width - nw)(*randgen);
+        jpeg->crop_h = nh;
+        jpeg->crop_w = nw;
+        return;
+      }
+    }
+  }
+
+  int scaled_width, scaled_height;
+  int scale_to_use = scale_ > 0 ? scale_ : minsize_;
+  if (random_scaling_) {
+    scale_to_use = std::uniform_int_distribution<>(
+        random_scale_[0], random_scale_[1])(*randgen);
+  }
+  if (warp_) {
+    scaled_width = scale_to_use;
+    scaled_height = scale_to_use;
+  } else if (im_height > im_width) {
+    scaled_width = scale_to_use;
+    scaled_height = static_cast<float>(im_height) * scale_to_use / im_width;
+  } else {
+    scaled_height = scale_to_use;
+    scaled_width = static_cast<float>(im_width) * scale_to_use / im_height;
+  }
+  if (!((scale_ > 0 &&
+         (scaled_height != im_height || scaled_width != im_width)) ||
+        (scaled_height > im_height || scaled_width > im_width))) {
+    // minsize_ only ever scales up
+    scaled_height = im_height;
+    scaled_width = im_width;
+  }
+  CAFFE_ENFORCE_GE(
+      scaled_height, crop_, "Image height must be bigger than crop.");
+  CAFFE_ENFORCE_GE(
+      scaled_width, crop_, "Image width must be bigger than crop.");
+
+  int width_offset, height_offset;
+  if (is_test_) {
+    width_offset = (scaled_width - crop_) / 2;
+    height_offset = (scaled_height - crop_) / 2;
+  } else {
+    width_offset =
+        std::uniform_int_distribution<>(0, scaled_width - crop_)(*randgen);
+    height_offset =
+        std::uniform_int_distribution<>(0, scaled_height - crop_)(*randgen);
+  }
+  const float scale_x = static_cast<float>(im_width) / scaled_width;
+  const float scale_y = static_cast<float>(im_height) / scaled_height;
+  jpeg->crop_x = region_x + width_offset * scale_x;
+  jpeg->crop_y = region_y + height_offset * scale_y;
+  jpeg->crop_w = crop_ * scale_x;
+  jpeg->crop_h = crop_ * scale_y;
+}
+
 template <class Context>
 bool ImageInputOp<Context>::Prefetch() {
   if (!owned_reader_.get()) {
@@ -1218,7 +1404,19 @@ bool ImageInputOp<Context>::Prefetch() {
 
     // launch into thread pool for processing
     // TODO: support color jitter and color lighting in gpu_transform
-    if (gpu_transform_) {
+    if (gpu_decode_) {
+      // only images that cannot be decoded on the GPU land in image_data
+      uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
+          crop_ * crop_ * channels * item_id;
+      thread_pool_->runTaskWithID(std::bind(
+          &ImageInputOp<Context>::DecodeForGPU,
+          this,
+          std::string(value),
+          image_data,
+          item_id,
+          channels,
+          std::placeholders::_1));
+    } else if (gpu_transform_) {
       // output of decode will still be int8
       uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
           crop_ * crop_ * channels * item_id;
@@ -1259,8 +1457,12 @@ bool ImageInputOp<Context>::Prefetch() {
   auto device = at::device(Context::GetDeviceType());
   if (!std::is_same<Context, CPUContext>::value) {
     // do sync copies
-    ReinitializeAndCopyFrom(
-        &prefetched_image_on_device_, device, prefetched_image_);
+    if (gpu_decode_) {
+      CAFFE_ENFORCE(DecodeBatchOnGPU());
+    } else {
+      ReinitializeAndCopyFrom(
+          &prefetched_image_on_device_, device, prefetched_image_);
+    }
     ReinitializeAndCopyFrom(
         &prefetched_label_on_device_, device, prefetched_label_);
 
@@ -33,6 +33,47 @@ bool ImageInputOp<CUDAContext>::ApplyTransformOnGPU(
   return true;
 }
 
+template <>
+void ImageInputOp<CUDAContext>::InitGPUDecoder() {
+#ifdef CAFFE2_USE_NVJPEG
+  CUDAGuard guard(context_.device_id());
+  gpu_decoder_ = std::make_shared<GPUJpegDecoder>(
+      gpu_decode_backend_ == "gpu" ? GPUJpegDecoder::GPU
+                                   : GPUJpegDecoder::HYBRID,
+      color_ ? 3 : 1);
+#else
+  CAFFE_THROW("use_gpu_decode requires caffe2 to be built with USE_NVJPEG");
+#endif
+}
+
+template <>
+bool ImageInputOp<CUDAContext>::DecodeBatchOnGPU() {
+#ifdef CAFFE2_USE_NVJPEG
+  const bool all_on_gpu = std::all_of(
+      gpu_jpegs_.begin(), gpu_jpegs_.end(), [](const GPUJpegItem& jpeg) {
+        return jpeg.valid;
+      });
+  if (all_on_gpu) {
+    // Nothing was cropped on the CPU, so there is nothing to upload
+    ReinitializeTensor(
+        &prefetched_image_on_device_,
+        prefetched_image_.sizes(),
+        at::dtype<uint8_t>().device(CUDA));
+  } else {
+    ReinitializeAndCopyFrom(
+        &prefetched_image_on_device_, at::device(CUDA), prefetched_image_);
+  }
+  gpu_decoder_->DecodeResizeCrop(
+      gpu_jpegs_,
+      crop_,
+      prefetched_image_on_device_.mutable_data<uint8_t>(),
+      &context_);
+  return true;
+#else
+  return false;
+#endif
+}
+
 REGISTER_CUDA_OPERATOR(ImageInput, ImageInputOp<CUDAContext>);
 
 } // namespace caffe2
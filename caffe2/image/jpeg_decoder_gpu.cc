@@ -0,0 +1,190 @@
+#include "caffe2/image/jpeg_decoder_gpu.h"
+
+#ifdef CAFFE2_USE_NVJPEG
+
+#include <nvjpeg.h>
+
+#include "caffe2/core/context_gpu.h"
+#include "caffe2/image/transform_gpu.h"
+
+namespace caffe2 {
+
+#define NVJPEG_ENFORCE(condition)                 \
+  do {                                            \
+    nvjpegStatus_t status = condition;            \
+    CAFFE_ENFORCE_EQ(                             \
+        status,                                   \
+        NVJPEG_STATUS_SUCCESS,                    \
+        "Error at: ",                             \
+        __FILE__,                                 \
+        ":",                                      \
+        __LINE__,                                 \
+        ": nvJPEG error ",                        \
+        static_cast<int>(status));                \
+  } while (0)
+
+namespace {
+
+// Grow-only page-locked host buffer. Staging the bitstreams and the resize
+// parameters here lets the GPU Huffman backend and the parameter upload run
+// as async copies instead of going through a pageable bounce buffer.
+class PinnedBuffer {
+ public:
+  ~PinnedBuffer() {
+    if (data_) {
+      cudaFreeHost(data_);
+    }
+  }
+
+  void* Reserve(size_t nbytes) {
+    if (nbytes > capacity_) {
+      if (data_) {
+        CUDA_ENFORCE(cudaFreeHost(data_));
+      }
+      CUDA_ENFORCE(cudaHostAlloc(&data_, nbytes, cudaHostAllocDefault));
+      capacity_ = nbytes;
+    }
+    return data_;
+  }
+
+ private:
+  void* data_ = nullptr;
+  size_t capacity_ = 0;
+};
+
+int PinnedMalloc(void** ptr, size_t size, unsigned int flags) {
+  return cudaHostAlloc(ptr, size, flags) == cudaSuccess ? 0 : 1;
+}
+
+int PinnedFree(void* ptr) {
+  return cudaFreeHost(ptr) == cudaSuccess ? 0 : 1;
+}
+
+} // namespace
+
+struct GPUJpegDecoder::Impl {
+  nvjpegHandle_t handle = nullptr;
+  nvjpegJpegState_t state = nullptr;
+  nvjpegPinnedAllocator_t pinned_allocator = {&PinnedMalloc, &PinnedFree};
+  nvjpegOutputFormat_t format;
+  int channels;
+  // Batch size the decode state was last initialized for
+  int batch_size = 0;
+
+  PinnedBuffer bitstreams;
+  PinnedBuffer params;
+  Tensor decoded{CUDA};
+  Tensor params_on_device{CUDA};
+};
+
+GPUJpegDecoder::GPUJpegDecoder(Backend backend, int channels)
+    : impl_(new Impl()) {
+  CAFFE_ENFORCE(channels == 3 || channels == 1);
+  impl_->channels = channels;
+  // Interleaved BGR matches the channel order cv::imdecode produces
+  impl_->format = channels == 3 ? NVJPEG_OUTPUT_BGRI : NVJPEG_OUTPUT_Y;
+  NVJPEG_ENFORCE(nvjpegCreateEx(
+      backend == HYBRID ? NVJPEG_BACKEND_HYBRID : NVJPEG_BACKEND_GPU_HYBRID,
+      nullptr,
+      &impl_->pinned_allocator,
+      0,
+      &impl_->handle));
+  NVJPEG_ENFORCE(nvjpegJpegStateCreate(impl_->handle, &impl_->state));
+}
+
+GPUJpegDecoder::~GPUJpegDecoder() {
+  if (impl_->state) {
+    nvjpegJpegStateDestroy(impl_->state);
+  }
+  if (impl_->handle) {
+    nvjpegDestroy(impl_->handle);
+  }
+}
+
+void GPUJpegDecoder::DecodeResizeCrop(
+    const std::vector<GPUJpegItem>& items,
+    int crop,
+    uint8_t* output,
+    CUDAContext* context) {
+  const int channels = impl_->channels;
+  std::vector<int> indices;
+  size_t total_bytes = 0;
+  int64_t total_pixels = 0;
+  for (int i = 0; i < items.size(); ++i) {
+    if (items[i].valid) {
+      indices.push_back(i);
+      total_bytes += items[i].data.size();
+      total_pixels += static_cast<int64_t>(items[i].height) * items[i].width;
+    }
+  }
+  const int n = indices.size();
+  if (n == 0) {
+    return;
+  }
+
+  if (n != impl_->batch_size) {
+    NVJPEG_ENFORCE(nvjpegDecodeBatchedInitialize(
+        impl_->handle, impl_->state, n, 1, impl_->format));
+    impl_->batch_size = n;
+  }
+
+  auto* bitstreams =
+      static_cast<unsigned char*>(impl_->bitstreams.Reserve(total_bytes));
+  auto* params = static_cast<ResizeCropParam*>(
+      impl_->params.Reserve(n * sizeof(ResizeCropParam)));
+  impl_->decoded.Resize(total_pixels * channels);
+  uint8_t* decoded = impl_->decoded.mutable_data<uint8_t>();
+
+  std::vector<const unsigned char*> data(n);
+  std::vector<size_t> lengths(n);
+  std::vector<nvjpegImage_t> destinations(n);
+  size_t byte_offset = 0;
+  int64_t pixel_offset = 0;
+  for (int k = 0; k < n; ++k) {
+    const GPUJpegItem& item = items[indices[k]];
+    memcpy(bitstreams + byte_offset, item.data.data(), item.data.size());
+    data[k] = bitstreams + byte_offset;
+    lengths[k] = item.data.size();
+    byte_offset += item.data.size();
+
+    destinations[k] = nvjpegImage_t();
+    destinations[k].channel[0] = decoded + pixel_offset;
+    destinations[k].pitch[0] = item.width * channels;
+
+    params[k] = ResizeCropParam{pixel_offset,
+                                item.height,
+                                item.width,
+                                item.crop_x,
+                                item.crop_y,
+                                item.crop_w,
+                                item.crop_h,
+                                indices[k],
+                                item.mirror};
+    pixel_offset += static_cast<int64_t>(item.height) * item.width * channels;
+  }
+
+  NVJPEG_ENFORCE(nvjpegDecodeBatched(
+      impl_->handle,
+      impl_->state,
+      data.data(),
+      lengths.data(),
+      destinations.data(),
+      context->cuda_stream()));
+
+  impl_->params_on_device.Resize(n * sizeof(ResizeCropParam));
+  auto* params_on_device = reinterpret_cast<ResizeCropParam*>(
+      impl_->params_on_device.mutable_data<uint8_t>());
+  CUDA_ENFORCE(cudaMemcpyAsync(
+      params_on_device,
+      params,
+      n * sizeof(ResizeCropParam),
+      cudaMemcpyHostToDevice,
+      context->cuda_stream()));
+
+  ResizeCropOnGPU(
+      decoded, params_on_device, n, crop, channels, output, context);
+}
+
+} // namespace caffe2
+
+#endif // CAFFE2_USE_NVJPEG
@@ -0,0 +1,110 @@
+#ifndef CAFFE2_IMAGE_JPEG_DECODER_GPU_H_
+#define CAFFE2_IMAGE_JPEG_DECODER_GPU_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "caffe2/core/common.h"
+
+namespace caffe2 {
+
+class CUDAContext;
+
+// An encoded JPEG handed to the GPU decoder, together with the window of the
+// decoded image (in source pixels) that gets resized into its crop x crop
+// output slot. The window already folds in the bounding box, scaling and
+// random cropping that the OpenCV path applies one step at a time.
+struct GPUJpegItem {
+  bool valid = false;
+  std::string data;
+  int height = 0;
+  int width = 0;
+  float crop_x = 0;
+  float crop_y = 0;
+  float crop_w = 0;
+  float crop_h = 0;
+  bool mirror = false;
+};
+
+// Reads the frame size from the SOF marker of a baseline, extended or
+// progressive JPEG without decoding it. Returns false for anything else
+// (other codings, non-JPEG data, truncated headers) so that those images
+// stay on the OpenCV path.
+inline bool GetJpegImageSize(const std::string& data, int* height, int* width) {
+  const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+  const size_t n = data.size();
+  if (n < 4 || p[0] != 0xFF || p[1] != 0xD8) {
+    return false;
+  }
+  size_t i = 2;
+  while (i + 3 < n) {
+    if (p[i] != 0xFF) {
+      return false;
+    }
+    const unsigned char marker = p[i + 1];
+    if (marker == 0xFF) {
+      // Fill byte
+      ++i;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      // Markers without a payload
+      i += 2;
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      // EOI or SOS before any frame header
+      return false;
+    }
+    if (marker == 0xC0 || marker == 0xC1 || marker == 0xC2) {
+      if (i + 8 >= n) {
+        return false;
+      }
+      *height = (p[i + 5] << 8) | p[i + 6];
+      *width = (p[i + 7] << 8) | p[i + 8];
+      return *height > 0 && *width > 0;
+    }
+    if (marker >= 0xC3 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+        marker != 0xCC) {
+      // Lossless, hierarchical or arithmetic coded frames
+      return false;
+    }
+    i += 2 + ((p[i + 2] << 8) | p[i + 3]);
+  }
+  return false;
+}
+
+// Batched JPEG decoder built on nvJPEG. In HYBRID mode Huffman decoding runs
+// on the CPU and the IDCT / color conversion on the GPU, which is usually
+// fastest for small images; GPU mode moves Huffman decoding onto the GPU as
+// well and pays off for large images and batches. Only available when caffe2
+// is built with USE_NVJPEG.
+class GPUJpegDecoder {
+ public:
+  enum Backend {
+    HYBRID = 0,
+    GPU = 1,
+  };
+
+  GPUJpegDecoder(Backend backend, int channels);
+  ~GPUJpegDecoder();
+
+  // Decodes every valid item on the context's stream and writes its resized,
+  // cropped and optionally mirrored window into
+  // output[item_index * crop * crop * channels] as uint8 HWC. Slots of
+  // invalid items are left untouched.
+  void DecodeResizeCrop(
+      const std::vector<GPUJpegItem>& items,
+      int crop,
+      uint8_t* output,
+      CUDAContext* context);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_IMAGE_JPEG_DECODER_GPU_H_
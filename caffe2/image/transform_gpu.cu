@@ -46,6 +46,70 @@ __global__ void transform_kernel(
   }
 }
 
+// One block per image, output pixels are strided over the thread block.
+// Shrinking averages the covered source box like cv::INTER_AREA, enlarging
+// interpolates bilinearly.
+__global__ void resize_crop_kernel(
+    const int crop,
+    const int C,
+    const ResizeCropParam* params,
+    const uint8_t* src,
+    uint8_t* dst) {
+  const ResizeCropParam p = params[blockIdx.x];
+  const uint8_t* in = src + p.src_offset;
+  uint8_t* out = dst + static_cast<int64_t>(p.dst_index) * crop * crop * C;
+  const int H = p.src_height, W = p.src_width;
+  const float sx = p.crop_w / crop;
+  const float sy = p.crop_h / crop;
+  const bool area = sx > 1.f || sy > 1.f;
+
+  for (int h = threadIdx.y; h < crop; h += blockDim.y) {
+    const float cy = p.crop_y + (h + 0.5f) * sy;
+    for (int w = threadIdx.x; w < crop; w += blockDim.x) {
+      const float cx = p.crop_x + (w + 0.5f) * sx;
+      float value[3] = {0.f, 0.f, 0.f};
+      if (area) {
+        const float bx = fmaxf(sx, 1.f) * 0.5f, by = fmaxf(sy, 1.f) * 0.5f;
+        const float x0 = fmaxf(cx - bx, 0.f), x1 = fminf(cx + bx, (float)W);
+        const float y0 = fmaxf(cy - by, 0.f), y1 = fminf(cy + by, (float)H);
+        float total = 0.f;
+        for (int y = (int)y0; y < (int)ceilf(y1); ++y) {
+          const float wy = fminf(y + 1.f, y1) - fmaxf((float)y, y0);
+          for (int x = (int)x0; x < (int)ceilf(x1); ++x) {
+            const float wxy = (fminf(x + 1.f, x1) - fmaxf((float)x, x0)) * wy;
+            for (int c = 0; c < C; ++c) {
+              value[c] += wxy * in[(y * W + x) * C + c];
+            }
+            total += wxy;
+          }
+        }
+        for (int c = 0; c < C; ++c) {
+          value[c] /= total;
+        }
+      } else {
+        const float fy = fminf(fmaxf(cy - 0.5f, 0.f), H - 1.f);
+        const float fx = fminf(fmaxf(cx - 0.5f, 0.f), W - 1.f);
+        const int y0 = (int)fy, x0 = (int)fx;
+        const int y1 = min(y0 + 1, H - 1), x1 = min(x0 + 1, W - 1);
+        const float dy = fy - y0, dx = fx - x0;
+        for (int c = 0; c < C; ++c) {
+          value[c] = (1.f - dy) *
+                  ((1.f - dx) * in[(y0 * W + x0) * C + c] +
+                   dx * in[(y0 * W + x1) * C + c]) +
+              dy *
+                  ((1.f - dx) * in[(y1 * W + x0) * C + c] +
+                   dx * in[(y1 * W + x1) * C + c]);
+        }
+      }
+      const int out_w = p.mirror ? crop - 1 - w : w;
+      for (int c = 0; c < C; ++c) {
+        out[(h * crop + out_w) * C + c] =
+            static_cast<uint8_t>(fminf(fmaxf(value[c], 0.f), 255.f) + 0.5f);
+      }
+    }
+  }
+}
+
 }
 
 template <typename T_IN, typename T_OUT, class Context>
@@ -81,4 +145,19 @@ template bool TransformOnGPU<uint8_t, at::Half, CUDAContext>(
     Tensor& std,
     CUDAContext* context);
 
+void ResizeCropOnGPU(
+    const uint8_t* src,
+    const ResizeCropParam* params,
+    const int num_images,
+    const int crop,
+    const int channels,
+    uint8_t* dst,
+    CUDAContext* context) {
+  if (num_images == 0) {
+    return;
+  }
+  resize_crop_kernel<<<num_images, dim3(16, 16), 0, context->cuda_stream()>>>(
+      crop, channels, params, src, dst);
+}
+
 }  // namespace caffe2
@@ -30,6 +30,8 @@
 
 namespace caffe2 {
 
+class CUDAContext;
+
 template <typename T_IN, typename T_OUT, class Context>
 bool TransformOnGPU(
     Tensor& X,
@@ -38,6 +40,32 @@ bool TransformOnGPU(
     Tensor& std,
     Context* context);
 
+// Per-image parameters of ResizeCropOnGPU. The crop window is given in pixels
+// of the decoded source image, which starts at src + src_offset.
+struct ResizeCropParam {
+  int64_t src_offset;
+  int src_height;
+  int src_width;
+  float crop_x;
+  float crop_y;
+  float crop_w;
+  float crop_h;
+  int dst_index;
+  int mirror;
+};
+
+// Resizes the crop window of each decoded uint8 HWC image to crop x crop
+// (area averaging when shrinking, bilinear when enlarging) and writes it to
+// dst[dst_index * crop * crop * channels]. params must live on the device.
+void ResizeCropOnGPU(
+    const uint8_t* src,
+    const ResizeCropParam* params,
+    const int num_images,
+    const int crop,
+    const int channels,
+    uint8_t* dst,
+    CUDAContext* context);
+
 }  // namespace caffe2
 
 #endif
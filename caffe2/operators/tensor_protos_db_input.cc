@@ -19,6 +19,9 @@ corresponding index in the TensorProtos objects in the DB.
   .Arg("batch_size", "(int, default 0) the number of samples in a batch. The "
        "default value of 0 means that the operator will attempt to insert the "
        "entire data in a single output blob.")
+  .Arg("decode_threads", "(int, default 1) the number of threads that decode "
+       "the records of a batch. The records of a batch must have the same "
+       "shapes when more than 1.")
   .Input(0, "data", "A pre-initialized DB reader. Typically, this is obtained "
          "by calling CreateDB operator with a db_name and a db_type. The "
          "resulting output blob is a DB Reader tensor")
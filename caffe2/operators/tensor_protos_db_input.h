@@ -1,9 +1,11 @@
 #ifndef CAFFE2_OPERATORS_TENSOR_PROTOS_DB_INPUT_H_
 #define CAFFE2_OPERATORS_TENSOR_PROTOS_DB_INPUT_H_
 
+#include <exception>
 #include <iostream>
 #include <mutex>
 
+#include "c10/core/thread_pool.h"
 #include "caffe2/core/db.h"
 #include "caffe2/operators/prefetch_op.h"
 
@@ -23,12 +25,18 @@ class TensorProtosDBInput final : public PrefetchOperator<Context> {
   bool CopyPrefetched() override;
 
  private:
+  // Decodes the records of a batch in the decode pool
+  void DecodeBatch();
+
   // Prefetch will always just happen on the CPU side.
   vector<Blob> prefetched_blobs_;
   int batch_size_;
   bool shape_inferred_ = false;
   string key_;
   string value_;
+  int decode_threads_;
+  std::unique_ptr<TaskThreadPool> decode_pool_;
+  vector<string> values_;
 };
 
 template <class Context>
@@ -38,7 +46,13 @@ TensorProtosDBInput<Context>::TensorProtosDBInput(
     : PrefetchOperator<Context>(operator_def, ws),
       prefetched_blobs_(operator_def.output_size()),
       batch_size_(
-          this->template GetSingleArgument<int>("batch_size", 0)) {}
+          this->template GetSingleArgument<int>("batch_size", 0)),
+      decode_threads_(
+          this->template GetSingleArgument<int>("decode_threads", 1)) {
+  if (decode_threads_ > 1 && batch_size_ > 0) {
+    decode_pool_ = make_unique<TaskThreadPool>(decode_threads_);
+  }
+}
 
 template <class Context>
 bool TensorProtosDBInput<Context>::Prefetch() {
@@ -61,6 +75,8 @@ bool TensorProtosDBInput<Context>::Prefetch() {
       //     protos.protos(i), BlobGetMutableTensor(&prefetched_blobs_[i],
       //     CPU));
     }
+  } else if (decode_pool_) {
+    DecodeBatch();
   } else {
     for (int item_id = 0; item_id < batch_size_; ++item_id) {
       reader.Read(&key_, &value_);
@@ -92,6 +108,68 @@ bool TensorProtosDBInput<Context>::Prefetch() {
   return true;
 }
 
+template <class Context>
+void TensorProtosDBInput<Context>::DecodeBatch() {
+  // Read the records in order, then decode them in parallel into their rows
+  // of the batch. The first record gives the shapes of the batch.
+  const db::DBReader& reader = this->template Input<db::DBReader>(0);
+  values_.resize(batch_size_);
+  for (auto& value : values_) {
+    reader.Read(&key_, &value);
+  }
+
+  auto decode = [this](int item_id) {
+    TensorProtos protos;
+    CAFFE_ENFORCE(protos.ParseFromString(values_[item_id]));
+    CAFFE_ENFORCE(protos.protos_size() == OutputSize());
+    TensorDeserializer deserializer;
+    CPUContext context;
+    for (int i = 0; i < protos.protos_size(); ++i) {
+      if (protos.protos(i).has_device_detail()) {
+        protos.mutable_protos(i)->clear_device_detail();
+      }
+      Tensor src = deserializer.Deserialize(protos.protos(i));
+      if (item_id == 0) {
+        vector<int64_t> dims = src.sizes().vec();
+        dims.insert(dims.begin(), batch_size_);
+        BlobGetMutableTensor(
+            &prefetched_blobs_[i], dims, at::dtype(src.dtype()).device(CPU))
+            ->raw_mutable_data(src.dtype());
+      }
+      // The other records only write to their rows of the batch
+      const auto& dst = prefetched_blobs_[i].template Get<Tensor>();
+      CAFFE_ENFORCE(
+          src.dtype() == dst.dtype(), "Records of different types in a batch");
+      CAFFE_ENFORCE(
+          src.sizes() == dst.sizes().slice(1),
+          "Records of different shapes in a batch");
+      context.CopyItemsSameDevice(
+          src.dtype(),
+          src.numel(),
+          src.raw_data(),
+          static_cast<char*>(dst.raw_data()) + src.nbytes() * item_id);
+    }
+  };
+  decode(0);
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  for (int item_id = 1; item_id < batch_size_; ++item_id) {
+    decode_pool_->run([&, item_id]() {
+      try {
+        decode(item_id);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        error = std::current_exception();
+      }
+    });
+  }
+  decode_pool_->waitWorkComplete();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 template <class Context>
 bool TensorProtosDBInput<Context>::CopyPrefetched() {
   for (int i = 0; i < OutputSize(); ++i) {
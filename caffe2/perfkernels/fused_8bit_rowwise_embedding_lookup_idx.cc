@@ -111,6 +111,9 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlowIdx(
   decltype(                                                                                 \
       Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false__base)     \
       Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false__avx2_fma; \
+  decltype(                                                                                 \
+      Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false__avx512;   \
   bool Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType(                  \
       const int64_t block_size,                                                             \
       const int64_t output_size,                                                            \
@@ -127,6 +130,18 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlowIdx(
         reinterpret_cast<const uint8_t*>(&one)[0],                                          \
         1,                                                                                  \
         "Fused8BitRowwiseEmbeddingLookup is not supported on this platform");               \
+    AVX512_DO(                                                                              \
+        Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                         \
+        output_size,                                                                        \
+        index_size,                                                                         \
+        data_size,                                                                          \
+        input,                                                                              \
+        indices,                                                                            \
+        offsets,                                                                            \
+        weights,                                                                            \
+        normalize_by_lengths,                                                               \
+        out);                                                                               \
     AVX2_FMA_DO(                                                                            \
         Fused8BitRowwiseEmbeddingLookupIdx_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                         \
@@ -7,30 +7,74 @@ import sys
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
 
+class Isa(object):
+    """Vector type and intrinsics of an instruction set"""
+
+    def __init__(self, name, suffix, width, half_load, half_vec, uint8_load):
+        self.name = name
+        # Suffix of the kernels, matching the DO macros of common.h
+        self.suffix = suffix
+        # Number of floats in a vector
+        self.width = width
+        self.vec = "__m%d" % (32 * width)
+        self.prefix = "_mm%d" % (32 * width)
+        # Loads of width halves and width uint8_t
+        self.half_load = half_load
+        self.half_vec = half_vec
+        self.uint8_load = uint8_load
+
+
+isas = {
+    "avx2": Isa("AVX2", "__avx2_fma", 8, "_mm_loadu_si128", "__m128i", "_mm_loadl_epi64"),
+    "avx512": Isa(
+        "AVX512", "__avx512", 16, "_mm256_loadu_si256", "__m256i", "_mm_loadu_si128"
+    ),
+}
+
+
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s_fmadd_ps(vwgt, %s_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                % (regid, isa.prefix, isa.prefix, regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s_cvtph_ps(\n"
+                "                %s(reinterpret_cast<const %s*>(ip + (%d)))),\n"  # noqa
+                "            vop%d);"
+                % (
+                    regid,
+                    isa.prefix,
+                    isa.prefix,
+                    isa.half_load,
+                    isa.half_vec,
+                    regid,
+                    regid,
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s_cvtepi32_ps(%s_cvtepu8_epi32(\n"
+                "                %s(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
+                "            %s_add_ps(vop%d, vbio));"
+                % (
+                    regid,
+                    isa.prefix,
+                    isa.prefix,
+                    isa.prefix,
+                    isa.uint8_load,
+                    regid,
+                    isa.prefix,
+                    regid,
+                )
             )
         else:
             assert False
@@ -66,8 +110,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa.width * i
+        code.append(
+            "      " + isa.vec + " vop" + str(j) + " = " + isa.prefix + "_setzero_ps();"
+        )
 
     # inner loop
     if use_offsets:
@@ -120,7 +166,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(isa.vec, isa.prefix))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +174,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa.vec, isa.prefix))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,7 +196,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -162,20 +208,34 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa.width * i
+        code.append(
+            "        " + isa.prefix + "_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");"
+        )
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / length);".format(
+                isa.vec, isa.prefix
+            )
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+                isa.vec, isa.prefix
+            )
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         code.append(
-            "        _mm256_storeu_ps(&op["
+            "        "
+            + isa.prefix
+            + "_storeu_ps(&op["
             + str(j)
-            + "], _mm256_mul_ps("
+            + "], "
+            + isa.prefix
+            + "_mul_ps("
             + "vop"
             + str(j)
             + ", vlen_inv));"
@@ -191,30 +251,36 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         code = []
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          {p}_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              {p}_fmadd_ps(\n"
+                "                  vwgt, {p}_loadu_ps(&ip[j]), {p}_loadu_ps(&op[j])));".format(  # noqa
+                    p=isa.prefix
+                )
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          {p}_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              {p}_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  {p}_cvtph_ps({load}(\n"
+                "                      reinterpret_cast<const {vec}*>(&ip[j]))),\n"
+                "                  {p}_loadu_ps(&op[j])));".format(
+                    p=isa.prefix, load=isa.half_load, vec=isa.half_vec
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          {p}_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              {p}_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
+                "                  {p}_cvtepi32_ps({p}_cvtepu8_epi32({load}(\n"  # noqa
                 "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  {p}_add_ps({p}_loadu_ps(&op[j]), vbio)));".format(
+                    p=isa.prefix, load=isa.uint8_load
+                )
             )
         else:
             assert False
@@ -249,8 +315,12 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {w} <= block_size; j += {w}) {{".format(w=isa.width)
+    )
+    code.append(
+        "        {p}_storeu_ps(op + j, {p}_setzero_ps());".format(p=isa.prefix)
+    )
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -307,7 +377,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(isa.vec, isa.prefix))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +385,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa.vec, isa.prefix))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,7 +407,9 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {w} <= block_size; j += {w}) {{".format(w=isa.width)
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -366,12 +438,18 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append(
+        "        {} vlen_inv = {}_set1_ps(len_inv);".format(isa.vec, isa.prefix)
+    )
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {w} <= block_size; j += {w}) {{".format(w=isa.width)
+    )
+    code.append(
+        "          {p}_storeu_ps(\n"
+        "              &op[j], {p}_mul_ps({p}_loadu_ps(&op[j]), vlen_inv));".format(
+            p=isa.prefix
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -389,19 +467,27 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
+parser.add_argument(
+    "--prefetch-distance",
+    type=int,
+    default=16,
+    help="number of indices ahead of the current one to prefetch the rows of",
+)
 opts = parser.parse_args()
+isa = isas[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -438,7 +524,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa.suffix
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -460,7 +546,9 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const " + IndexType + " prefdist_T0 = {};".format(opts.prefetch_distance)
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -474,17 +562,24 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    # Fully unrolled kernels for the common block sizes
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            block_size // isa.width,
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+            opts.use_offsets,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
@@ -0,0 +1,137 @@
+#include "caffe2/predictor/predictor_pool.h"
+
+#include <set>
+#include <unordered_set>
+
+#include "caffe2/core/memonger.h"
+
+namespace caffe2 {
+
+PredictorPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), instance_(std::move(other.instance_)) {}
+
+PredictorPool::Lease::~Lease() {
+  if (instance_) {
+    pool_->giveBack(std::move(instance_));
+  }
+}
+
+PredictorPool::PredictorPool(
+    PredictorConfig config,
+    size_t max_instances,
+    bool optimize_memory)
+    : config_(std::move(config)), max_instances_(max_instances) {
+  CAFFE_ENFORCE_GT(max_instances_, 0, "Expected at least one instance");
+  CAFFE_ENFORCE(config_.ws, "Expected the workspace of the parameters");
+  const auto& net = *config_.predict_net;
+
+  std::unordered_set<std::string> written;
+  for (const auto& op : net.op()) {
+    written.insert(op.output().begin(), op.output().end());
+  }
+  if (!config_.parameter_names.empty()) {
+    for (const auto& name : config_.parameter_names) {
+      CAFFE_ENFORCE(
+          !written.count(name), "Parameter written by the net: ", name);
+      shared_blobs_[name] = name;
+    }
+  } else {
+    const std::unordered_set<std::string> inputs(
+        config_.input_names.begin(), config_.input_names.end());
+    for (const auto& name : config_.ws->Blobs()) {
+      if (!written.count(name) && !inputs.count(name)) {
+        shared_blobs_[name] = name;
+      }
+    }
+  }
+
+  if (optimize_memory) {
+    std::set<std::string> static_blobs(
+        net.external_input().begin(), net.external_input().end());
+    static_blobs.insert(
+        net.external_output().begin(), net.external_output().end());
+    static_blobs.insert(
+        config_.output_names.begin(), config_.output_names.end());
+    for (const auto& kv : shared_blobs_) {
+      static_blobs.insert(kv.first);
+    }
+    config_.predict_net = std::make_shared<NetDef>(
+        memonger::optimize_inference_net(net, static_blobs));
+  }
+}
+
+PredictorPool::Lease PredictorPool::checkout() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() {
+      return !idle_instances_.empty() || num_instances_ < max_instances_;
+    });
+    if (!idle_instances_.empty()) {
+      auto instance = std::move(idle_instances_.back());
+      idle_instances_.pop_back();
+      return Lease(this, std::move(instance));
+    }
+    // Create the instance without holding the lock, the other threads can
+    // still check out the idle ones
+    ++num_instances_;
+  }
+  try {
+    return Lease(this, createInstance());
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --num_instances_;
+    cv_.notify_one();
+    throw;
+  }
+}
+
+std::unique_ptr<Predictor> PredictorPool::createInstance() {
+  PredictorConfig instance_config = config_;
+  instance_config.ws =
+      std::make_shared<Workspace>(config_.ws.get(), shared_blobs_);
+  return std::make_unique<Predictor>(std::move(instance_config));
+}
+
+void PredictorPool::giveBack(std::unique_ptr<Predictor> instance) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_instances_.push_back(std::move(instance));
+  }
+  cv_.notify_one();
+}
+
+size_t PredictorPool::numInstances() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_instances_;
+}
+
+bool PredictorPool::operator()(
+    const Predictor::TensorList& inputs,
+    Predictor::TensorList* outputs) {
+  auto instance = checkout();
+  Predictor::TensorList instance_outputs;
+  if (!(*instance)(inputs, &instance_outputs)) {
+    return false;
+  }
+  outputs->clear();
+  for (const auto& output : instance_outputs) {
+    outputs->push_back(output.Clone());
+  }
+  return true;
+}
+
+bool PredictorPool::operator()(
+    const Predictor::TensorMap& inputs,
+    Predictor::TensorMap* outputs) {
+  auto instance = checkout();
+  Predictor::TensorMap instance_outputs;
+  if (!(*instance)(inputs, &instance_outputs)) {
+    return false;
+  }
+  for (const auto& kv : instance_outputs) {
+    outputs->emplace(kv.first, kv.second.Clone());
+  }
+  return true;
+}
+
+} // namespace caffe2
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/predictor_config.h"
+
+namespace caffe2 {
+
+/**
+ * Runs a model from several threads at a time, with a single copy of its
+ * parameters.
+ *
+ * The parameters stay in the workspace of the config, which no net runs in
+ * once the pool is created. Every instance of the pool is a Predictor with its
+ * own workspace, in which the parameters are forwarded from the shared one,
+ * and which holds the inputs, the outputs and the activations of a request.
+ * The parameters are the `parameter_names` of the config if given, otherwise
+ * the blobs of the shared workspace that the predict net doesn't write.
+ *
+ * With `optimize_memory`, the activations of an instance share blobs (see
+ * memonger::optimize_inference_net), for the nets of type "simple" only.
+ */
+class CAFFE2_API PredictorPool {
+ public:
+  // An instance checked out of the pool, given back when destroyed. The
+  // outputs of the instance are only valid until then.
+  class CAFFE2_API Lease {
+   public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&&) = delete;
+    ~Lease();
+
+    Predictor& operator*() const {
+      return *instance_;
+    }
+    Predictor* operator->() const {
+      return instance_.get();
+    }
+
+   private:
+    Lease(PredictorPool* pool, std::unique_ptr<Predictor> instance)
+        : pool_(pool), instance_(std::move(instance)) {}
+
+    PredictorPool* pool_;
+    std::unique_ptr<Predictor> instance_;
+
+    friend class PredictorPool;
+  };
+
+  PredictorPool(
+      PredictorConfig config,
+      size_t max_instances,
+      bool optimize_memory = true);
+
+  // Returns an idle instance. When all are busy, creates a new one, or past
+  // max_instances, waits for one to be given back.
+  Lease checkout();
+
+  // Runs the model on an instance. The outputs are copied so that they stay
+  // valid once the instance is given back.
+  bool operator()(
+      const Predictor::TensorList& inputs,
+      Predictor::TensorList* outputs);
+  bool operator()(
+      const Predictor::TensorMap& inputs,
+      Predictor::TensorMap* outputs);
+
+  size_t numInstances() const;
+
+  size_t maxInstances() const {
+    return max_instances_;
+  }
+
+  const std::unordered_map<std::string, std::string>& sharedBlobs() const {
+    return shared_blobs_;
+  }
+
+ private:
+  std::unique_ptr<Predictor> createInstance();
+  void giveBack(std::unique_ptr<Predictor> instance);
+
+  // Parameters, and the predict net of the instances
+  PredictorConfig config_;
+  const size_t max_instances_;
+  // Forwarded blobs of the instance workspaces, by name
+  std::unordered_map<std::string, std::string> shared_blobs_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<Predictor>> idle_instances_;
+  size_t num_instances_ = 0;
+
+  C10_DISABLE_COPY_AND_ASSIGN(PredictorPool);
+};
+
+} // namespace caffe2
@@ -2,10 +2,13 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/predictor_pool.h"
 #include "caffe2/utils/math.h"
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -131,6 +134,36 @@ const char* metaSpec = R"DOC(
   }
 )DOC";
 
+const char* simplePredictSpec = R"DOC(
+        name: "predict"
+        type: "simple"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          output: "scaled"
+          type: "Scale"
+          arg {
+            name: "scale"
+            f: 2.0
+          }
+        }
+        op {
+          input: "scaled"
+          output: "relu"
+          type: "Relu"
+        }
+        op {
+          input: "relu"
+          input: "W"
+          input: "b"
+          output: "y"
+          type: "FC"
+        }
+)DOC";
+
 std::unique_ptr<Blob> randomTensor(
     const std::vector<int64_t>& dims,
     CPUContext* ctx) {
@@ -205,4 +238,64 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST_F(PredictorTest, PoolSharesParameters) {
+  PredictorPool pool(
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec)),
+      /*max_instances=*/2);
+  auto first = pool.checkout();
+  auto second = pool.checkout();
+  EXPECT_EQ(pool.numInstances(), 2);
+  EXPECT_EQ(pool.sharedBlobs().size(), 2);
+  for (const std::string& name : {"W", "b"}) {
+    EXPECT_EQ(first->ws()->GetBlob(name), second->ws()->GetBlob(name));
+  }
+  EXPECT_NE(first->ws()->GetBlob("data"), second->ws()->GetBlob("data"));
+  EXPECT_NE(first->ws()->GetBlob("y"), second->ws()->GetBlob("y"));
+}
+
+TEST_F(PredictorTest, PoolConcurrentRuns) {
+  const auto init_net = parseNetDef(initSpec);
+  const auto predict_net = parseNetDef(simplePredictSpec);
+  Predictor reference(makePredictorConfig(init_net, predict_net));
+  PredictorPool pool(makePredictorConfig(init_net, predict_net), 3);
+
+  const int num_threads = 8;
+  const int num_runs = 20;
+  std::vector<std::unique_ptr<Blob>> blobs;
+  std::vector<Predictor::TensorList> inputs(num_threads);
+  std::vector<std::vector<float>> expected;
+  for (int i = 0; i < num_threads; ++i) {
+    blobs.push_back(randomTensor({2, 4}, ctx_.get()));
+    inputs[i].emplace_back(
+        BlobGetMutableTensor(blobs.back().get(), CPU)->Alias());
+    Predictor::TensorList output;
+    ASSERT_TRUE(reference(inputs[i], &output));
+    expected.emplace_back(
+        output.front().data<float>(),
+        output.front().data<float>() + output.front().numel());
+  }
+
+  std::vector<std::thread> threads;
+  std::atomic<int> num_mismatches{0};
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int run = 0; run < num_runs; ++run) {
+        Predictor::TensorList output;
+        if (!pool(inputs[i], &output) ||
+            std::vector<float>(
+                output.front().data<float>(),
+                output.front().data<float>() + output.front().numel()) !=
+                expected[i]) {
+          ++num_mismatches;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_mismatches, 0);
+  EXPECT_LE(pool.numInstances(), 3);
+}
+
 } // namespace caffe2
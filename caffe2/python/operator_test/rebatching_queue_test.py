@@ -165,6 +165,71 @@ class TestReBatchingQueue(TestCase):
                 workspace.FetchBlob(tensors[idx])[:5]
             )
 
+    def test_rebatching_queue_max_bytes(self):
+        net = core.Net('net')
+        workspace.FeedBlob(
+            "tensors", np.array([[x, x] for x in range(10)], np.int32)
+        )
+
+        queue = net.CreateRebatchingQueue([], 1, capacity=10, num_blobs=1)
+
+        net.EnqueueRebatchingQueue([queue, "tensors"], [], enqueue_batch=True)
+
+        # Rows of 8 bytes
+        results = [
+            net.DequeueRebatchingQueue(
+                [queue], 1, num_elements=10, max_bytes=24),
+            net.DequeueRebatchingQueue(
+                [queue], 1, num_elements=10, max_bytes=4),
+            net.DequeueRebatchingQueue([queue], 1, num_elements=10),
+        ]
+
+        workspace.RunNetOnce(net)
+
+        npt.assert_array_equal(
+            workspace.FetchBlob(results[0]), workspace.FetchBlob("tensors")[:3]
+        )
+        npt.assert_array_equal(
+            workspace.FetchBlob(results[1]), workspace.FetchBlob("tensors")[3:4]
+        )
+        npt.assert_array_equal(
+            workspace.FetchBlob(results[2]), workspace.FetchBlob("tensors")[4:]
+        )
+
+    def test_rebatching_queue_single_and_batch_elements(self):
+        enqueue_net = core.Net('enqueue_net')
+        workspace.FeedBlob("single", np.array(42, np.int32))
+        workspace.FeedBlob(
+            "tensors", np.array([x for x in range(10)], np.int32)
+        )
+
+        queue = enqueue_net.CreateRebatchingQueue(
+            [], 1, capacity=20, num_blobs=1
+        )
+
+        enqueue_net.EnqueueRebatchingQueue([queue, "single"], [])
+        enqueue_net.EnqueueRebatchingQueue(
+            [queue, "tensors"], [], enqueue_batch=True
+        )
+
+        workspace.RunNetOnce(enqueue_net)
+
+        # The queue holds a copy of the enqueued batch
+        workspace.FeedBlob("tensors", np.zeros(10, np.int32))
+
+        dequeue_net = core.Net('dequeue_net')
+        results = [
+            dequeue_net.DequeueRebatchingQueue([queue], 1, num_elements=4),
+            dequeue_net.DequeueRebatchingQueue([queue], 1, num_elements=3),
+            dequeue_net.DequeueRebatchingQueue([queue], 1, num_elements=4),
+        ]
+
+        workspace.RunNetOnce(dequeue_net)
+
+        npt.assert_array_equal(workspace.FetchBlob(results[0]), [42, 0, 1, 2])
+        npt.assert_array_equal(workspace.FetchBlob(results[1]), [3, 4, 5])
+        npt.assert_array_equal(workspace.FetchBlob(results[2]), [6, 7, 8, 9])
+
     @given(
         num_producers=st.integers(1, 5),
         num_consumers=st.integers(1, 5),
@@ -1,96 +1,179 @@
 #include "rebatching_queue.h"
-#include "caffe2/utils/smart_tensor_printer.h"
 
 namespace caffe2 {
 
 namespace {
 
+using Element = RebatchingQueue::Element;
+using Batch = std::vector<TensorCPU>;
+
+size_t rowBytes(const TensorCPU& batchTensor) {
+  return batchTensor.size_from_dim(1) * batchTensor.itemsize();
+}
+
+size_t numTensors(const Element& element) {
+  return element.batch ? element.batch->size() : element.tensors.size();
+}
+
+// Dims and data of the j-th tensor of the element
+std::vector<int64_t> elementDims(const Element& element, size_t j) {
+  if (!element.batch) {
+    return element.tensors[j].sizes().vec();
+  }
+  auto dims = (*element.batch)[j].sizes().vec();
+  dims.erase(dims.begin());
+  return dims;
+}
+
+const void* elementData(const Element& element, size_t j) {
+  if (!element.batch) {
+    return element.tensors[j].raw_data();
+  }
+  const auto& batchTensor = (*element.batch)[j];
+  return (const char*)batchTensor.raw_data() +
+      element.row * rowBytes(batchTensor);
+}
+
+const TypeMeta elementDtype(const Element& element, size_t j) {
+  return element.batch ? (*element.batch)[j].dtype()
+                       : element.tensors[j].dtype();
+}
+
+// Deleter of the outputs that are slices of a batch, which keep it alive
+void releaseBatch(void* ctx) {
+  delete static_cast<std::shared_ptr<const Batch>*>(ctx);
+}
+
+// Whether the elements are consecutive rows of the same batch
+bool isBatchSlice(const std::vector<Element>& elements) {
+  const auto& batch = elements[0].batch;
+  if (!batch) {
+    return false;
+  }
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (elements[i].batch != batch ||
+        elements[i].row != elements[0].row + (int64_t)i) {
+      return false;
+    }
+  }
+  for (const auto& batchTensor : *batch) {
+    if (batchTensor.numel() == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void slice(
+    const std::vector<Element>& elements,
+    const std::vector<TensorCPU*>& outputs) {
+  const auto& batch = elements[0].batch;
+  CAFFE_ENFORCE_EQ(outputs.size(), batch->size());
+  for (size_t i = 0; i < batch->size(); ++i) {
+    const auto& batchTensor = (*batch)[i];
+    auto outputDims = batchTensor.sizes().vec();
+    outputDims[0] = elements.size();
+    const auto nbytes = elements.size() * rowBytes(batchTensor);
+    outputs[i]->Resize(outputDims);
+    outputs[i]->ShareExternalPointer(
+        at::DataPtr(
+            (char*)batchTensor.raw_data() +
+                elements[0].row * rowBytes(batchTensor),
+            new std::shared_ptr<const Batch>(batch),
+            &releaseBatch,
+            at::Device(CPU)),
+        batchTensor.dtype(),
+        nbytes);
+  }
+}
+
 // This concat function will always create a new first dimension to concat
 void concat(
     CPUContext& context,
-    const std::vector<std::vector<TensorCPU>>& inputs,
+    const std::vector<Element>& inputs,
     const std::vector<TensorCPU*>& outputs) {
   CAFFE_ENFORCE(!inputs.empty());
 
   const auto& inputZero = inputs[0];
-  const auto numTensors = inputZero.size();
+  const auto numTensors = caffe2::numTensors(inputZero);
   const auto numRows = inputs.size();
+  CAFFE_ENFORCE_EQ(outputs.size(), numTensors);
 
   // Precompute the output sizes to avoid resizing
+  std::vector<std::vector<int64_t>> inputDims(numTensors);
   std::vector<std::vector<int64_t>> outputDims(numTensors);
+  std::vector<TypeMeta> dtypes(numTensors);
 
   for (size_t i = 0; i < numTensors; ++i) {
-    SmartTensorPrinter::PrintTensor(inputZero.at(i));
-    outputDims[i] = inputZero.at(i).sizes().vec();
+    inputDims[i] = elementDims(inputZero, i);
+    outputDims[i] = inputDims[i];
     outputDims[i].insert(outputDims[i].begin(), numRows);
+    dtypes[i] = elementDtype(inputZero, i);
   }
 
   // Resize to the final output size
   std::vector<void*> destinations(numTensors);
   for (size_t i = 0; i < numTensors; ++i) {
+    // Don't write to the batch that a previous output is a slice of
+    if (outputs[i]->storage().data_ptr().get_deleter() == &releaseBatch) {
+      *outputs[i] = Tensor(CPU);
+    }
     outputs[i]->Resize(outputDims[i]);
-    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
+    destinations[i] = outputs[i]->raw_mutable_data(dtypes[i]);
   }
 
   for (size_t i = 0; i < numRows; ++i) {
-    CAFFE_ENFORCE_EQ(inputs[i].size(), numTensors);
+    CAFFE_ENFORCE_EQ(caffe2::numTensors(inputs[i]), numTensors);
 
     for (int j = 0; j < numTensors; ++j) {
-      const auto& input = inputs[i][j];
-
-      CAFFE_ENFORCE(inputZero[j].meta() == input.dtype());
-      CAFFE_ENFORCE_EQ(inputZero[j].itemsize(), input.itemsize());
-      CAFFE_ENFORCE_EQ(inputZero[j].ndim(), input.dim());
-      for (int k = 0; k < input.dim(); ++k) {
-        CAFFE_ENFORCE_EQ(input.sizes()[k], inputZero[j].size(k));
-      }
+      CAFFE_ENFORCE(dtypes[j] == elementDtype(inputs[i], j));
+      const auto dims = elementDims(inputs[i], j);
+      CAFFE_ENFORCE(dims == inputDims[j]);
+      const auto numel = size_from_dim_(0, dims);
 
       // Skip empty tensors
-      if (input.numel() == 0) {
+      if (numel == 0) {
         continue;
       }
 
       context.CopyItemsToCPU(
-          input.dtype(),
-          input.numel(),
-          input.raw_data() /* src */,
+          dtypes[j],
+          numel,
+          elementData(inputs[i], j) /* src */,
           destinations[j] /* dst */
       );
 
-      destinations[j] =
-          (char*)destinations[j] + input.numel() * input.itemsize();
+      destinations[j] = (char*)destinations[j] + numel * dtypes[j].itemsize();
     }
   }
 }
 
-std::vector<std::vector<TensorCPU>> split(
-    CPUContext& context,
-    const std::vector<const TensorCPU*>& inputs) {
+// Copies the inputs once, and makes an element of each of their rows
+std::vector<Element> split(const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE(!inputs.empty());
+  CAFFE_ENFORCE(inputs[0]);
+  CAFFE_ENFORCE_GE(inputs[0]->dim(), 1);
 
   const auto outputSize = inputs[0]->sizes().at(0);
-  std::vector<std::vector<TensorCPU>> outputs(outputSize);
+  auto batch = std::make_shared<Batch>();
+  batch->reserve(inputs.size());
+  size_t nbytes = 0;
 
   for (const auto* inputPtr : inputs) {
     CAFFE_ENFORCE(inputPtr);
 
     const auto& input = *inputPtr;
-    const auto innerSize = input.size_from_dim(1);
-    const auto itemSize = input.dtype().itemsize();
-
-    auto outputDims = input.sizes().vec();
-    CAFFE_ENFORCE(!outputDims.empty());
-    outputDims.erase(outputDims.begin());
+    CAFFE_ENFORCE_GE(input.dim(), 1);
     CAFFE_ENFORCE_EQ(input.sizes().at(0), outputSize);
+    batch->push_back(input.Clone());
+    nbytes += rowBytes(input);
+  }
 
-    for (int i = 0; i < outputSize; ++i) {
-      outputs[i].push_back(Tensor(outputDims, CPU));
-      context.CopyItemsToCPU(
-          input.dtype(),
-          innerSize,
-          (char*)input.raw_data() + i * innerSize * itemSize /* src */,
-          outputs[i].back().raw_mutable_data(input.dtype()) /* dst */);
-    }
+  std::vector<Element> outputs(outputSize);
+  for (int i = 0; i < outputSize; ++i) {
+    outputs[i].batch = batch;
+    outputs[i].row = i;
+    outputs[i].nbytes = nbytes;
   }
 
   return outputs;
@@ -111,12 +194,15 @@ bool RebatchingQueue::canRead() const {
 bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
-    const std::vector<TensorCPU*>& outputs) {
-  std::vector<std::vector<TensorCPU>> results;
+    const std::vector<TensorCPU*>& outputs,
+    size_t maxBytes) {
+  std::vector<Element> results;
   results.reserve(numElements);
+  size_t numBytes = 0;
+  bool isFull = false;
 
   for (;;) {
-    if (results.size() == numElements) {
+    if (results.size() == numElements || isFull) {
       break;
     }
 
@@ -131,7 +217,15 @@ bool RebatchingQueue::dequeue(
       }
 
       do {
-        results.push_back(std::move(queue_[tail_++ % capacity()]));
+        auto& element = queue_[tail_ % capacity()];
+        if (maxBytes > 0 && !results.empty() &&
+            numBytes + element.nbytes > maxBytes) {
+          isFull = true;
+          break;
+        }
+        numBytes += element.nbytes;
+        results.push_back(std::move(element));
+        ++tail_;
       } while (canRead() && results.size() < numElements);
     }
 
@@ -146,7 +240,11 @@ bool RebatchingQueue::dequeue(
     return false;
   }
 
-  concat(context, results, outputs);
+  if (isBatchSlice(results)) {
+    slice(results, outputs);
+  } else {
+    concat(context, results, outputs);
+  }
 
   return true;
 }
@@ -158,29 +256,27 @@ bool RebatchingQueue::canWrite() const {
 bool RebatchingQueue::enqueueOne(
     CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs.emplace_back();
-  auto& tensorVector = splittedInputs.back();
-  tensorVector.reserve(inputs.size());
+  std::vector<Element> splittedInputs(1);
+  auto& element = splittedInputs.back();
+  element.tensors.reserve(inputs.size());
   for (const auto* tensorPtr : inputs) {
-    tensorVector.push_back(tensorPtr->Clone());
+    element.tensors.push_back(tensorPtr->Clone());
+    element.nbytes += tensorPtr->nbytes();
   }
 
   return enqueue(std::move(splittedInputs));
 }
 
 bool RebatchingQueue::enqueueMany(
-    CPUContext& context,
+    CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
 
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs = split(context, inputs);
+  std::vector<Element> splittedInputs = split(inputs);
   return enqueue(std::move(splittedInputs));
 }
 
-bool RebatchingQueue::enqueue(
-    std::vector<std::vector<TensorCPU>> splittedInputs) {
+bool RebatchingQueue::enqueue(std::vector<Element> splittedInputs) {
   int idx = 0;
   for (;;) {
     if (idx >= splittedInputs.size()) {
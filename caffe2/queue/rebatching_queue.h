@@ -19,6 +19,19 @@ namespace caffe2 {
 
 class RebatchingQueue {
  public:
+  // An element of the queue. The elements enqueued together by enqueueMany
+  // are the rows of a single copy of the input batch, instead of one copy
+  // per row.
+  struct Element {
+    // One tensor per blob, for the elements enqueued by enqueueOne
+    std::vector<TensorCPU> tensors;
+    // One tensor per blob and row in them, for the elements of a batch
+    std::shared_ptr<const std::vector<TensorCPU>> batch;
+    int64_t row{0};
+    // Total size of the tensors of the element
+    size_t nbytes{0};
+  };
+
   RebatchingQueue(size_t capacity, size_t numBlobs);
 
   ~RebatchingQueue();
@@ -31,10 +44,14 @@ class RebatchingQueue {
       CPUContext& context,
       const std::vector<const TensorCPU*>& inputs);
 
+  // Dequeues up to numElements elements, and when maxBytes is not 0, no more
+  // than maxBytes of them (but at least one element). Consecutive rows of the
+  // same enqueued batch are returned without copy, as slices of the batch.
   bool dequeue(
       CPUContext& context,
       size_t numElements,
-      const std::vector<TensorCPU*>& outputs);
+      const std::vector<TensorCPU*>& outputs,
+      size_t maxBytes = 0);
 
   size_t capacity() const;
 
@@ -45,7 +62,7 @@ class RebatchingQueue {
   void close();
 
  private:
-  bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
+  bool enqueue(std::vector<Element> splittedInputs);
 
   bool canWrite() const;
   bool canRead() const;
@@ -63,6 +80,6 @@ class RebatchingQueue {
   std::condition_variable cvEmpty_;
   std::condition_variable cvOverflow_;
 
-  std::vector<std::vector<TensorCPU>> queue_;
+  std::vector<Element> queue_;
 };
 } // caffe2
@@ -61,12 +61,17 @@ OPERATOR_SCHEMA(DequeueRebatchingQueue)
 Dequeue Tensors from the Queue.
 If the Queue is closed this might return less elements than asked.
 If num_elements > 1 the returned elements will be concatenated into one
-tensor per component.
+tensor per component. Consecutive elements enqueued by the same batch are
+returned as slices of it, without copy.
 )DOC")
     .Input(0, "rebatching_queue", "object representing the queue")
     .Input(1, "tensor", "First tensor to enqueue")
     .Arg(
         "num_elements",
-        "Number of elements to dequeue. By default we dequeue one element.");
+        "Number of elements to dequeue. By default we dequeue one element.")
+    .Arg(
+        "max_bytes",
+        "If set, dequeue fewer elements than num_elements to return no more "
+        "than max_bytes in total, but always at least one element.");
 }
 }
@@ -48,7 +48,8 @@ class DequeueRebatchingQueueOp : public Operator<CPUContext> {
  public:
   DequeueRebatchingQueueOp(const OperatorDef& operator_def, Workspace* ws)
       : Operator(operator_def, ws),
-        numElements_(OperatorBase::GetSingleArgument<int>("num_elements", 1)) {}
+        numElements_(OperatorBase::GetSingleArgument<int>("num_elements", 1)),
+        maxBytes_(OperatorBase::GetSingleArgument<int64_t>("max_bytes", 0)) {}
 
   bool RunOnDevice() override {
     auto& queue = Inputs()[0]->template Get<RebatchingQueuePtr>();
@@ -60,11 +61,12 @@ class DequeueRebatchingQueueOp : public Operator<CPUContext> {
       outputTensors.push_back(Output(i));
     }
 
-    return queue->dequeue(context_, numElements_, outputTensors);
+    return queue->dequeue(context_, numElements_, outputTensors, maxBytes_);
   }
 
  private:
   int numElements_;
+  int64_t maxBytes_;
 };
 
 class CloseRebatchingQueueOp : public Operator<CPUContext> {
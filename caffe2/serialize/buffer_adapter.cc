@@ -0,0 +1,67 @@
+#include "caffe2/serialize/buffer_adapter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <c10/util/Exception.h>
+
+namespace caffe2 {
+namespace serialize {
+
+namespace {
+
+void deleteOwner(void* ctx) {
+  delete static_cast<std::shared_ptr<const void>*>(ctx);
+}
+
+} // namespace
+
+BufferAdapter::BufferAdapter(
+    const void* data,
+    size_t size,
+    std::shared_ptr<const void> owner)
+    : data_(static_cast<const char*>(data)),
+      size_(size),
+      owner_(std::move(owner)) {
+  TORCH_CHECK(data_ != nullptr || size_ == 0, "buffer is null");
+}
+
+size_t BufferAdapter::size() const {
+  return size_;
+}
+
+size_t BufferAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= size_) {
+    return 0;
+  }
+  n = std::min(n, static_cast<size_t>(size_ - pos));
+  memcpy(buf, data_ + pos, n);
+  return n;
+}
+
+at::DataPtr BufferAdapter::getAliasedData(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos <= size_ && n <= size_ - pos,
+      "record at offset ",
+      pos,
+      " with size ",
+      n,
+      " does not fit in a buffer of size ",
+      size_);
+  void* data = const_cast<char*>(data_) + pos;
+  if (!owner_) {
+    // the caller keeps the buffer alive, nothing to release.
+    return at::DataPtr(data, at::DeviceType::CPU);
+  }
+  return at::DataPtr(
+      data,
+      new std::shared_ptr<const void>(owner_),
+      &deleteOwner,
+      at::DeviceType::CPU);
+}
+
+BufferAdapter::~BufferAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// this is a reader over an archive that the caller already holds in memory,
+// e.g. an asset of an app or a buffer it received. like MmapFileAdapter,
+// records read from it through PyTorchStreamReader::getRecord alias the
+// buffer instead of being copied out.
+//
+// the buffer is not copied: it must stay alive, and unchanged, for as long as
+// the adapter and any record or tensor read from it. pass owner to have them
+// share ownership of the buffer instead; it is released once the last of them
+// is gone. records are 64 byte aligned relative to the start of the archive,
+// so the buffer should be at least as aligned as the data types stored in it.
+class CAFFE2_API BufferAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(BufferAdapter);
+  BufferAdapter(
+      const void* data,
+      size_t size,
+      std::shared_ptr<const void> owner = nullptr);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr getAliasedData(uint64_t pos, size_t n) const override;
+  ~BufferAdapter();
+
+ private:
+  const char* data_;
+  size_t size_;
+  std::shared_ptr<const void> owner_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -5,10 +5,13 @@
 #include <ostream>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/Backend.h>
+#include <ATen/Parallel.h>
 
 #include "caffe2/core/common.h"
 #include "caffe2/core/logging.h"
@@ -48,6 +51,128 @@ static std::string basename(const std::string& name) {
   return name.substr(start, end - start);
 }
 
+namespace {
+
+// see Note [Chunked records]
+constexpr size_t kChunkedRecordFooterSize = 24;
+
+std::mutex& chunkedCompressionMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+c10::optional<ChunkedCompressionOptions>& defaultChunkedCompression() {
+  static c10::optional<ChunkedCompressionOptions> options;
+  return options;
+}
+
+void validateChunkedCompressionOptions(
+    const c10::optional<ChunkedCompressionOptions>& options) {
+  if (!options) {
+    return;
+  }
+  TORCH_CHECK(
+      options->codec == RecordCodec::DEFLATE,
+      "unsupported record codec ",
+      static_cast<uint32_t>(options->codec));
+  TORCH_CHECK(options->chunk_size > 0, "chunk_size must be positive");
+  TORCH_CHECK(
+      options->level >= 0 && options->level <= MZ_UBER_COMPRESSION,
+      "compression level must be between 0 and ",
+      MZ_UBER_COMPRESSION,
+      ", but got ",
+      options->level);
+}
+
+void write_le_64(char* buf, uint64_t value) {
+  for (size_t i = 0; i < 8; i++) {
+    buf[i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+uint64_t read_le_64(const char* buf) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; i++) {
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(buf[i])) << (8 * i);
+  }
+  return value;
+}
+
+bool isChunkedRecord(const mz_zip_archive_file_stat& stat) {
+  return stat.m_comment_size == strlen(kChunkedRecordComment) &&
+      memcmp(stat.m_comment, kChunkedRecordComment, stat.m_comment_size) == 0;
+}
+
+struct ChunkedRecordLayout {
+  uint64_t uncompressed_size;
+  uint64_t chunk_size;
+  uint64_t num_chunks;
+  // offset of chunk_end[0] in the record
+  uint64_t table_offset;
+
+  uint64_t uncompressedChunkSize(uint64_t chunk) const {
+    return std::min(chunk_size, uncompressed_size - chunk * chunk_size);
+  }
+};
+
+ChunkedRecordLayout parseChunkedRecordFooter(
+    const char* footer,
+    uint64_t record_size,
+    const std::string& name) {
+  ChunkedRecordLayout layout;
+  layout.uncompressed_size = read_le_64(footer);
+  layout.chunk_size = read_le_64(footer + 8);
+  uint32_t codec = static_cast<uint32_t>(read_le_64(footer + 16));
+  TORCH_CHECK(
+      codec == static_cast<uint32_t>(RecordCodec::DEFLATE),
+      "unsupported codec ",
+      codec,
+      " in chunked record ",
+      name);
+  TORCH_CHECK(
+      layout.chunk_size > 0, "invalid chunk size in chunked record ", name);
+  layout.num_chunks = (layout.uncompressed_size + layout.chunk_size - 1) /
+      layout.chunk_size;
+  TORCH_CHECK(
+      layout.num_chunks <= (record_size - kChunkedRecordFooterSize) / 8,
+      "chunked record ",
+      name,
+      " is truncated");
+  layout.table_offset =
+      record_size - kChunkedRecordFooterSize - 8 * layout.num_chunks;
+  return layout;
+}
+
+void decodeChunk(
+    const char* src,
+    size_t src_size,
+    char* dst,
+    size_t dst_size,
+    const std::string& name) {
+  if (src_size == dst_size) {
+    // stored as is, see writeChunkedRecord
+    memcpy(dst, src, dst_size);
+    return;
+  }
+  size_t decoded = tinfl_decompress_mem_to_mem(dst, dst_size, src, src_size, 0);
+  TORCH_CHECK(
+      decoded == dst_size, "failed to decompress chunked record ", name);
+}
+
+} // namespace
+
+void setDefaultChunkedCompression(
+    c10::optional<ChunkedCompressionOptions> options) {
+  validateChunkedCompressionOptions(options);
+  std::lock_guard<std::mutex> guard(chunkedCompressionMutex());
+  defaultChunkedCompression() = options;
+}
+
+c10::optional<ChunkedCompressionOptions> getDefaultChunkedCompression() {
+  std::lock_guard<std::mutex> guard(chunkedCompressionMutex());
+  return defaultChunkedCompression();
+}
+
 size_t PyTorchStreamReader::read(uint64_t pos, char* buf, size_t n) {
   return in_->read(pos, buf, n, "reading file");
 }
@@ -182,6 +307,7 @@ static size_t getPadding(
 }
 
 bool PyTorchStreamReader::hasRecord(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   std::string ss = archive_name_plus_slash_ + name;
   mz_zip_reader_locate_file(ar_.get(), ss.c_str(), nullptr, 0);
   bool result = ar_->m_last_error != MZ_ZIP_FILE_NOT_FOUND;
@@ -193,6 +319,7 @@ bool PyTorchStreamReader::hasRecord(const std::string& name) {
 }
 
 std::vector<std::string> PyTorchStreamReader::getAllRecords() {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   mz_uint num_files = mz_zip_reader_get_num_files(ar_.get());
   std::vector<std::string> out;
   char buf[MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE];
@@ -215,15 +342,157 @@ size_t PyTorchStreamReader::getRecordID(const std::string& name) {
 
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  std::unique_lock<std::mutex> guard(reader_lock_);
+  size_t key = getRecordID(name);
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), key, &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  at::DataPtr retval;
+  // stored (i.e. uncompressed) records can alias the input if it is in
+  // memory. this skips the crc check that extracting the record does.
+  if (stat.m_method == 0) {
+    retval = in_->getAliasedData(
+        getRecordDataOffset(stat.m_local_header_ofs), stat.m_uncomp_size);
+  }
+  if (!retval) {
+    retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
+    mz_zip_reader_extract_to_mem(
+        ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
+    valid("reading file ", name.c_str());
+  }
+  if (!isChunkedRecord(stat)) {
+    return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+  }
+
+  // the chunks are decompressed without holding the lock
+  guard.unlock();
+  TORCH_CHECK(
+      stat.m_uncomp_size >= kChunkedRecordFooterSize,
+      "chunked record ",
+      name,
+      " is truncated");
+  const char* record = static_cast<const char*>(retval.get());
+  auto layout = parseChunkedRecordFooter(
+      record + stat.m_uncomp_size - kChunkedRecordFooterSize,
+      stat.m_uncomp_size,
+      name);
+  const char* table = record + layout.table_offset;
+  at::DataPtr output =
+      c10::GetCPUAllocator()->allocate(layout.uncompressed_size);
+  char* out = static_cast<char*>(output.get());
+  at::parallel_for(0, layout.num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      uint64_t chunk_begin = i == 0 ? 0 : read_le_64(table + 8 * (i - 1));
+      uint64_t chunk_end = read_le_64(table + 8 * i);
+      TORCH_CHECK(
+          chunk_begin <= chunk_end && chunk_end <= layout.table_offset,
+          "invalid chunk table in chunked record ",
+          name);
+      decodeChunk(
+          record + chunk_begin,
+          chunk_end - chunk_begin,
+          out + i * layout.chunk_size,
+          layout.uncompressedChunkSize(i),
+          name);
+    }
+  });
+  return std::make_tuple(std::move(output), layout.uncompressed_size);
+}
+
+size_t PyTorchStreamReader::getRecordRange(
+    const std::string& name,
+    size_t offset,
+    void* buf,
+    size_t n) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   size_t key = getRecordID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
-  at::DataPtr retval = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
-  mz_zip_reader_extract_to_mem(ar_.get(), key, retval.get(), stat.m_uncomp_size, 0);
-  valid("reading file ", name.c_str());
 
-  return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+  // reads bytes of the record as it is stored in the archive (i.e. before
+  // decoding chunks). only records compressed by zip itself are read whole.
+  at::DataPtr extracted;
+  size_t data_offset = 0;
+  if (stat.m_method == 0) {
+    data_offset = getRecordDataOffset(stat.m_local_header_ofs);
+  } else {
+    extracted = c10::GetCPUAllocator()->allocate(stat.m_uncomp_size);
+    mz_zip_reader_extract_to_mem(
+        ar_.get(), key, extracted.get(), stat.m_uncomp_size, 0);
+    valid("reading file ", name.c_str());
+  }
+  auto read_stored = [&](uint64_t pos, char* dst, size_t len) {
+    if (extracted) {
+      memcpy(dst, static_cast<const char*>(extracted.get()) + pos, len);
+    } else {
+      in_->read(data_offset + pos, dst, len, "reading file");
+    }
+  };
+
+  if (!isChunkedRecord(stat)) {
+    if (offset >= stat.m_uncomp_size) {
+      return 0;
+    }
+    n = std::min(n, static_cast<size_t>(stat.m_uncomp_size - offset));
+    read_stored(offset, static_cast<char*>(buf), n);
+    return n;
+  }
+
+  TORCH_CHECK(
+      stat.m_uncomp_size >= kChunkedRecordFooterSize,
+      "chunked record ",
+      name,
+      " is truncated");
+  char footer[kChunkedRecordFooterSize];
+  read_stored(
+      stat.m_uncomp_size - kChunkedRecordFooterSize,
+      footer,
+      kChunkedRecordFooterSize);
+  auto layout = parseChunkedRecordFooter(footer, stat.m_uncomp_size, name);
+  if (offset >= layout.uncompressed_size) {
+    return 0;
+  }
+  n = std::min(n, static_cast<size_t>(layout.uncompressed_size - offset));
+  if (n == 0) {
+    return 0;
+  }
+
+  const uint64_t first = offset / layout.chunk_size;
+  const uint64_t last = (offset + n - 1) / layout.chunk_size;
+  // chunk_end of the chunk before `first` too, where the first chunk starts
+  const uint64_t table_begin = first == 0 ? 0 : first - 1;
+  std::vector<char> table(8 * (last - table_begin + 1));
+  read_stored(
+      layout.table_offset + 8 * table_begin, table.data(), table.size());
+
+  std::vector<char> compressed;
+  std::vector<char> chunk;
+  char* out = static_cast<char*>(buf);
+  for (uint64_t i = first; i <= last; i++) {
+    uint64_t chunk_begin =
+        i == 0 ? 0 : read_le_64(table.data() + 8 * (i - 1 - table_begin));
+    uint64_t chunk_end = read_le_64(table.data() + 8 * (i - table_begin));
+    TORCH_CHECK(
+        chunk_begin <= chunk_end && chunk_end <= layout.table_offset,
+        "invalid chunk table in chunked record ",
+        name);
+    compressed.resize(chunk_end - chunk_begin);
+    read_stored(chunk_begin, compressed.data(), compressed.size());
+    chunk.resize(layout.uncompressedChunkSize(i));
+    decodeChunk(
+        compressed.data(), compressed.size(), chunk.data(), chunk.size(), name);
+
+    // part of [offset, offset + n) in this chunk
+    uint64_t chunk_start = i * layout.chunk_size;
+    uint64_t copy_begin = std::max<uint64_t>(offset, chunk_start);
+    uint64_t copy_end = std::min<uint64_t>(offset + n, chunk_start + chunk.size());
+    memcpy(
+        out + (copy_begin - offset),
+        chunk.data() + (copy_begin - chunk_start),
+        copy_end - copy_begin);
+  }
+  return n;
 }
 
 static int64_t read_le_16(uint8_t* buf) {
@@ -231,18 +500,23 @@ static int64_t read_le_16(uint8_t* buf) {
 }
 
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  return getRecordDataOffset(stat.m_local_header_ofs);
+}
+
+size_t PyTorchStreamReader::getRecordDataOffset(uint64_t local_header_offset) {
   uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
   in_->read(
-      stat.m_local_header_ofs,
+      local_header_offset,
       local_header,
       MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
       "reading file header");
   size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
   size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
-  return stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+  return local_header_offset + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
 }
 
 
@@ -300,6 +574,8 @@ void PyTorchStreamWriter::setup(const string& file_name) {
     };
   }
 
+  chunked_compression_ = getDefaultChunkedCompression();
+
   ar_->m_pIO_opaque = this;
   ar_->m_pWrite = ostream_write_func;
 
@@ -311,24 +587,99 @@ void PyTorchStreamWriter::setMinVersion(const uint64_t version) {
   version_ = std::max(version, version_);
 }
 
+void PyTorchStreamWriter::setChunkedCompression(
+    c10::optional<ChunkedCompressionOptions> options) {
+  validateChunkedCompressionOptions(options);
+  chunked_compression_ = options;
+}
+
 void PyTorchStreamWriter::writeRecord(
     const std::string& name,
     const void* data,
     size_t size,
     bool compress) {
+  if (!compress && chunked_compression_ &&
+      size >= chunked_compression_->min_record_size) {
+    writeChunkedRecord(name, data, size);
+  } else {
+    writeRecordWithFlags(name, data, size, compress ? MZ_BEST_COMPRESSION : 0);
+  }
+}
+
+void PyTorchStreamWriter::writeChunkedRecord(
+    const std::string& name,
+    const void* data,
+    size_t size) {
+  const auto& options = *chunked_compression_;
+  const size_t chunk_size = options.chunk_size;
+  const size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+  const mz_uint flags = tdefl_create_comp_flags_from_zip_params(
+      options.level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+  const char* src = static_cast<const char*>(data);
+
+  std::vector<std::vector<char>> chunks(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const char* chunk = src + i * chunk_size;
+      size_t n = std::min(chunk_size, size - i * chunk_size);
+      auto& out = chunks[i];
+      out.resize(n);
+      // a chunk that does not shrink is stored as is. tdefl returns 0 if the
+      // output does not fit, which the smaller buffer guarantees in that case.
+      size_t compressed =
+          n > 1 ? tdefl_compress_mem_to_mem(out.data(), n - 1, chunk, n, flags)
+                : 0;
+      if (compressed == 0) {
+        memcpy(out.data(), chunk, n);
+      } else {
+        out.resize(compressed);
+      }
+    }
+  });
+
+  size_t total = 8 * num_chunks + kChunkedRecordFooterSize;
+  for (const auto& chunk : chunks) {
+    total += chunk.size();
+  }
+  std::vector<char> record(total);
+  char* table = record.data() + total - kChunkedRecordFooterSize -
+      8 * num_chunks;
+  size_t pos = 0;
+  for (size_t i = 0; i < num_chunks; i++) {
+    memcpy(record.data() + pos, chunks[i].data(), chunks[i].size());
+    pos += chunks[i].size();
+    write_le_64(table + 8 * i, pos);
+    // frees the compressed chunk early
+    std::vector<char>().swap(chunks[i]);
+  }
+  char* footer = record.data() + total - kChunkedRecordFooterSize;
+  write_le_64(footer, size);
+  write_le_64(footer + 8, chunk_size);
+  write_le_64(footer + 16, static_cast<uint32_t>(options.codec));
+
+  writeRecordWithFlags(
+      name, record.data(), record.size(), 0, kChunkedRecordComment);
+  setMinVersion(kChunkedRecordVersion);
+}
+
+void PyTorchStreamWriter::writeRecordWithFlags(
+    const std::string& name,
+    const void* data,
+    size_t size,
+    uint32_t flags,
+    const char* comment) {
   AT_ASSERT(!finalized_);
   AT_ASSERT(!archive_name_plus_slash_.empty());
   std::string full_name = archive_name_plus_slash_ + name;
   size_t padding_size =
       getPadding(ar_->m_archive_size, full_name.size(), size, padding_);
-  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
   mz_zip_writer_add_mem_ex_v2(
       ar_.get(),
       full_name.c_str(),
       data,
       size,
-      nullptr,
-      0,
+      comment,
+      comment ? static_cast<mz_uint16>(strlen(comment)) : 0,
       flags,
       0,
       0,
@@ -5,10 +5,12 @@
 #include <cstring>
 #include <fstream>
 #include <istream>
+#include <mutex>
 #include <ostream>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
+#include <c10/util/Optional.h>
 
 #include "caffe2/serialize/istream_adapter.h"
 #include "caffe2/serialize/read_adapter_interface.h"
@@ -52,6 +54,8 @@ typedef struct mz_zip_archive mz_zip_archive;
 // 2. It provides a getRecordOffset function which returns the offset into the
 //    raw file where file data lives. If the file was written with
 //    PyTorchStreamWriter it is guaranteed to be 64 byte aligned.
+// 3. When it reads through a MmapFileAdapter, getRecord returns records that
+//    alias the mapped file instead of copies of them.
 
 // PyTorchReader/Writer handle checking the version number on the archive format
 // and ensure that all files are written to a archive_name directory so they
@@ -91,7 +95,7 @@ namespace caffe2 {
 namespace serialize {
 
 constexpr uint64_t kMinSupportedFileFormatVersion = 0x1L;
-constexpr uint64_t kMaxSupportedFileFormatVersion = 0x5L;
+constexpr uint64_t kMaxSupportedFileFormatVersion = 0x6L;
 
 // Versions (i.e. why was the version number bumped?)
 
@@ -131,6 +135,8 @@ constexpr uint64_t kMaxSupportedFileFormatVersion = 0x5L;
 //      (a versioned symbol preserves the historic behavior of versions 1--3)
 // 5. (Dynamic) Stops torch.full inferring a floating point dtype
 //      when given bool or integer fill values.
+// 6. (Dynamic) Records may be chunked and compressed
+//      (see Note [Chunked records])
 constexpr uint64_t kProducedFileFormatVersion = 0x3L;
 
 // the version we write when the archive contains bytecode.
@@ -148,6 +154,60 @@ static_assert(kProducedBytecodeVersion >= kProducedFileFormatVersion,
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
 
+// Note [Chunked records]
+//
+// Large records can be split into chunks that are compressed independently
+// of each other, on the intra-op thread pool. A chunked record is stored in
+// the zip archive as is (so it is still aligned) and is marked by the file
+// comment kChunkedRecordComment. Its contents are, with all integers in
+// little-endian order:
+//
+//   chunk_0 ... chunk_{n-1}    the compressed chunks
+//   uint64 chunk_end[n]        offset of the end of each compressed chunk
+//   uint64 uncompressed_size
+//   uint64 chunk_size          every chunk but the last has this many bytes
+//   uint32 codec               a RecordCodec
+//   uint32 reserved
+//
+// A chunk that does not get smaller when compressed is stored as is; its
+// compressed and uncompressed sizes are then equal. Since chunks are
+// independent, the reader decompresses them in parallel, and reading a byte
+// range of a record (getRecordRange) only decompresses the chunks it covers.
+// getRecordOffset of a chunked record is the offset of its compressed
+// contents.
+//
+// Archives with chunked records have version kChunkedRecordVersion, so
+// readers that do not know about them refuse to load them.
+constexpr const char* kChunkedRecordComment = "pytorch-chunked-record";
+constexpr uint64_t kChunkedRecordVersion = 0x6L;
+
+enum class RecordCodec : uint32_t {
+  // raw deflate, through miniz
+  DEFLATE = 1,
+};
+
+struct CAFFE2_API ChunkedCompressionOptions {
+  RecordCodec codec = RecordCodec::DEFLATE;
+  // Size of the uncompressed chunks. This is the unit of parallelism for
+  // compressing and decompressing a record.
+  size_t chunk_size = 4 << 20;
+  // Compression level of the codec, from 0 (store) to 10 for deflate.
+  int level = 1;
+  // Records smaller than this are written without chunking.
+  size_t min_record_size = 1 << 20;
+};
+
+// Makes PyTorchStreamWriters created afterwards write records of at least
+// options->min_record_size bytes as chunked records, e.g. for torch.save and
+// Module::save. c10::nullopt (the default) turns this off.
+CAFFE2_API void setDefaultChunkedCompression(
+    c10::optional<ChunkedCompressionOptions> options);
+CAFFE2_API c10::optional<ChunkedCompressionOptions>
+getDefaultChunkedCompression();
+
+// The reader is thread-safe. Records may be read from several threads at once,
+// but copying them out of the adapter is serialized; records that alias the
+// adapter's memory (see MmapFileAdapter) are not copied at all.
 class CAFFE2_API PyTorchStreamReader final {
  public:
   explicit PyTorchStreamReader(const std::string& file_name);
@@ -157,6 +217,15 @@ class CAFFE2_API PyTorchStreamReader final {
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
   size_t getRecordOffset(const std::string& name);
+  // reads n bytes starting at offset of the (uncompressed) record into buf,
+  // without reading the rest of the record if it is chunked or stored.
+  // returns the number of bytes read, which is less than n if the record ends
+  // first.
+  size_t getRecordRange(
+      const std::string& name,
+      size_t offset,
+      void* buf,
+      size_t n);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
 
@@ -170,6 +239,7 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what, const char* info = "");
   size_t getRecordID(const std::string& name);
+  size_t getRecordDataOffset(uint64_t local_header_offset);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
@@ -178,6 +248,8 @@ class CAFFE2_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::unique_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  // guards ar_ and in_, neither of which is thread-safe
+  std::mutex reader_lock_;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
@@ -187,6 +259,8 @@ class CAFFE2_API PyTorchStreamWriter final {
       const std::function<size_t(const void*, size_t)>& writer_func);
 
   void setMinVersion(const uint64_t version);
+  // overrides getDefaultChunkedCompression() for this writer.
+  void setChunkedCompression(c10::optional<ChunkedCompressionOptions> options);
 
   void writeRecord(
       const std::string& name,
@@ -208,6 +282,16 @@ class CAFFE2_API PyTorchStreamWriter final {
  private:
   void setup(const std::string& file_name);
   void valid(const char* what, const char* info = "");
+  void writeRecordWithFlags(
+      const std::string& name,
+      const void* data,
+      size_t size,
+      uint32_t flags,
+      const char* comment = nullptr);
+  void writeChunkedRecord(
+      const std::string& name,
+      const void* data,
+      size_t size);
   size_t current_pos_ = 0;
   std::unique_ptr<mz_zip_archive> ar_;
   std::string archive_name_;
@@ -216,6 +300,7 @@ class CAFFE2_API PyTorchStreamWriter final {
   std::ofstream file_stream_;
   std::function<size_t(const void*, size_t)> writer_func_;
   uint64_t version_ = kProducedFileFormatVersion;
+  c10::optional<ChunkedCompressionOptions> chunked_compression_;
   bool finalized_ = false;
   bool err_seen_ = false;
   friend size_t ostream_write_func(
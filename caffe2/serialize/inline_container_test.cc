@@ -1,10 +1,12 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +65,108 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, LoadFromMmapFileAdapter) {
+  const std::string file_name = "output_mmap.zip";
+  std::array<char, 127> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = data1.size() - i;
+  }
+  std::array<char, 64> data2;
+  for (int i = 0; i < data2.size(); ++i) {
+    data2[i] = data2.size() - i;
+  }
+  {
+    PyTorchStreamWriter writer(file_name);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeRecord("key2", data2.data(), data2.size());
+    writer.writeEndOfFile();
+  }
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    auto adapter = std::make_unique<MmapFileAdapter>(file_name);
+    auto aliased = adapter->getAliasedData(0, adapter->size());
+    ASSERT_NE(aliased.get(), nullptr);
+    auto base = static_cast<const char*>(aliased.get());
+
+    PyTorchStreamReader reader(std::move(adapter));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(size, data1.size());
+    ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+    // the record aliases the mapped file instead of being copied out of it
+    ASSERT_EQ(
+        static_cast<const char*>(data_ptr.get()),
+        base + reader.getRecordOffset("key1"));
+  }
+  // records keep the mapping alive after the reader is gone
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  // writes are private to this process
+  static_cast<char*>(data_ptr.get())[0] = 0;
+  PyTorchStreamReader reader(file_name);
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  std::tie(data_ptr, size) = reader.getRecord("key2");
+  ASSERT_EQ(memcmp(data_ptr.get(), data2.data(), data2.size()), 0);
+  std::remove(file_name.c_str());
+}
+
+TEST(PyTorchStreamWriterAndReader, ChunkedRecords) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  ChunkedCompressionOptions options;
+  options.chunk_size = 1000;
+  options.min_record_size = 2048;
+  writer.setChunkedCompression(options);
+
+  // the first half compresses well, the second half is stored as is
+  std::vector<char> data1(10000);
+  uint32_t state = 12345;
+  for (size_t i = 0; i < data1.size(); ++i) {
+    if (i < data1.size() / 2) {
+      data1[i] = i % 7;
+    } else {
+      state = state * 1103515245 + 12345;
+      data1[i] = static_cast<char>(state >> 16);
+    }
+  }
+  writer.writeRecord("key1", data1.data(), data1.size());
+  // below min_record_size
+  std::array<char, 127> data2;
+  for (int i = 0; i < data2.size(); ++i) {
+    data2[i] = data2.size() - i;
+  }
+  writer.writeRecord("key2", data2.data(), data2.size());
+  writer.writeEndOfFile();
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  ASSERT_EQ(reader.version(), kChunkedRecordVersion);
+  at::DataPtr data_ptr;
+  int64_t size;
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(size, data1.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  std::tie(data_ptr, size) = reader.getRecord("key2");
+  ASSERT_EQ(size, data2.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data2.data(), data2.size()), 0);
+
+  // ranges within a chunk, across chunks and past the end
+  std::vector<char> buf(3000);
+  ASSERT_EQ(reader.getRecordRange("key1", 100, buf.data(), 500), 500);
+  ASSERT_EQ(memcmp(buf.data(), data1.data() + 100, 500), 0);
+  ASSERT_EQ(reader.getRecordRange("key1", 4500, buf.data(), 2100), 2100);
+  ASSERT_EQ(memcmp(buf.data(), data1.data() + 4500, 2100), 0);
+  ASSERT_EQ(reader.getRecordRange("key1", 9000, buf.data(), 3000), 1000);
+  ASSERT_EQ(memcmp(buf.data(), data1.data() + 9000, 1000), 0);
+  ASSERT_EQ(reader.getRecordRange("key1", 10000, buf.data(), 10), 0);
+  ASSERT_EQ(reader.getRecordRange("key2", 27, buf.data(), 200), 100);
+  ASSERT_EQ(memcmp(buf.data(), data2.data() + 27, 100), 0);
+}
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
@@ -0,0 +1,109 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+namespace {
+
+void deleteMapping(void* ctx) {
+  delete static_cast<std::shared_ptr<THMapAllocator>*>(ctx);
+}
+
+} // namespace
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name) {
+  std::ifstream file_stream(
+      file_name, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+  if (!file_stream) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  size_ = static_cast<size_t>(file_stream.tellg());
+  file_stream.close();
+  // THMapAllocator does not map empty files; there is nothing to read then.
+  if (size_ > 0) {
+    // no flags: open read-only and map privately.
+    mapping_ = std::make_shared<THMapAllocator>(file_name.c_str(), 0, size_);
+  }
+}
+
+const char* MmapFileAdapter::data() const {
+  return mapping_ ? static_cast<const char*>(mapping_->data()) : nullptr;
+}
+
+size_t MmapFileAdapter::size() const {
+  return size_;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= size_) {
+    return 0;
+  }
+  n = std::min(n, static_cast<size_t>(size_ - pos));
+  memcpy(buf, data() + pos, n);
+  return n;
+}
+
+at::DataPtr MmapFileAdapter::getAliasedData(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos <= size_ && n <= size_ - pos,
+      "record at offset ",
+      pos,
+      " with size ",
+      n,
+      " does not fit in a file of size ",
+      size_);
+  if (!mapping_) {
+    return at::DataPtr();
+  }
+  return at::DataPtr(
+      const_cast<char*>(data()) + pos,
+      new std::shared_ptr<THMapAllocator>(mapping_),
+      &deleteMapping,
+      at::DeviceType::CPU);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+bool isMmapFileData(const at::DataPtr& data) {
+  return data.get_deleter() == &deleteMapping;
+}
+
+size_t evictMmapFileData(const at::DataPtr& data, size_t nbytes) {
+  TORCH_CHECK(
+      isMmapFileData(data), "data does not alias a file mapped for reading");
+#ifndef _WIN32
+  const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto start = reinterpret_cast<uintptr_t>(data.get());
+  const auto begin = (start + page_size - 1) / page_size * page_size;
+  const auto end = (start + nbytes) / page_size * page_size;
+  if (end <= begin) {
+    return 0;
+  }
+  // the mapping is private, so this discards this process's copies of the
+  // pages and the next access reads them from the page cache (or the file).
+  TORCH_CHECK(
+      madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED) == 0,
+      "madvise failed: ",
+      strerror(errno));
+  return end - begin;
+#else
+  return 0;
+#endif
+}
+
+} // namespace serialize
+} // namespace caffe2
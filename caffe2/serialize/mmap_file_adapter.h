@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+class THMapAllocator;
+
+namespace caffe2 {
+namespace serialize {
+
+// this is a reader that maps the whole file into memory. records read from it
+// through PyTorchStreamReader::getRecord alias the mapping instead of being
+// copied out, so loading does not touch the data until it is used, and
+// processes loading the same file share its pages in the page cache.
+//
+// the mapping is private (copy-on-write): writing to a record only changes
+// this process's copy. the file must not be truncated while records read from
+// it are alive; accessing pages past the new end of file raises SIGBUS.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr getAliasedData(uint64_t pos, size_t n) const override;
+  ~MmapFileAdapter();
+
+ private:
+  const char* data() const;
+
+  size_t size_;
+  // shared with the DataPtrs returned by getAliasedData, so the mapping
+  // outlives the adapter (and the reader) while records are in use.
+  std::shared_ptr<THMapAllocator> mapping_;
+};
+
+// returns whether data aliases a file mapped by a MmapFileAdapter.
+CAFFE2_API bool isMmapFileData(const at::DataPtr& data);
+
+// drops the pages that lie entirely within the first nbytes of data, which
+// must alias a file mapped by a MmapFileAdapter, from memory. they are read
+// from the file again when they are next accessed, so any changes made to them
+// are lost. returns the number of bytes dropped; this is always 0 on platforms
+// without madvise.
+CAFFE2_API size_t evictMmapFileData(const at::DataPtr& data, size_t nbytes);
+
+} // namespace serialize
+} // namespace caffe2
@@ -3,6 +3,11 @@
 namespace caffe2 {
 namespace serialize {
 
+at::DataPtr ReadAdapterInterface::getAliasedData(uint64_t pos, size_t n)
+    const {
+  return at::DataPtr();
+}
+
 ReadAdapterInterface::~ReadAdapterInterface() {}
 
 } // namespace serialize
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,11 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // readers that keep the whole file in memory (e.g. MmapFileAdapter) can
+  // return a DataPtr aliasing bytes [pos, pos + n) of it, which lets
+  // PyTorchStreamReader::getRecord skip the copy. the DataPtr must keep the
+  // memory alive on its own. the default returns an empty DataPtr.
+  virtual at::DataPtr getAliasedData(uint64_t pos, size_t n) const;
   virtual ~ReadAdapterInterface();
 };
 
@@ -106,10 +106,20 @@ if(INTERN_BUILD_ATEN_OPS)
     if(MSVC)
       list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG}/arch:AVX2")
     else(MSVC)
-      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx2 -mfma ${CPU_NO_AVX256_SPLIT_FLAGS}")
+      list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx2 -mfma -mf16c ${CPU_NO_AVX256_SPLIT_FLAGS}")
     endif(MSVC)
   endif(CXX_AVX2_FOUND)
 
+  # Vec512 is only implemented for GCC and Clang, so MSVC builds skip the
+  # AVX512 copy of the kernels.
+  if(CXX_AVX512_FOUND AND NOT MSVC)
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_AVX512_CPU_DEFINITION")
+    list(APPEND CPU_CAPABILITY_NAMES "AVX512")
+    # The AVX512 kernels also define CPU_CAPABILITY_AVX2 so that the Vec256
+    # code paths they still use are the AVX2 ones.
+    list(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx512f -mavx512bw -mavx512vl -mavx512dq -mfma -mf16c ${CPU_NO_AVX256_SPLIT_FLAGS} -DCPU_CAPABILITY_AVX2")
+  endif()
+
   list(LENGTH CPU_CAPABILITY_NAMES NUM_CPU_CAPABILITY_NAMES)
   math(EXPR NUM_CPU_CAPABILITY_NAMES "${NUM_CPU_CAPABILITY_NAMES}-1")
 
@@ -183,6 +193,20 @@ if(INTERN_BUILD_ATEN_OPS)
       --force_schema_registration
       --op_registration_whitelist ${OP_REGISTRATION_WHITELIST})
   endif()
+
+  if(INTERN_BUILD_MOBILE AND NOT "${SELECTED_KERNEL_DTYPES}" STREQUAL "")
+    execute_process(
+      COMMAND
+      "${PYTHON_EXECUTABLE}" ${CMAKE_CURRENT_LIST_DIR}/../tools/code_analyzer/gen_selected_kernel_dtypes.py
+      --selected-dtypes "${SELECTED_KERNEL_DTYPES}"
+      --output "${CMAKE_BINARY_DIR}/aten/src/ATen/selected_mobile_ops.h"
+      RESULT_VARIABLE RETURN_VALUE
+    )
+    if(NOT RETURN_VALUE EQUAL 0)
+      message(FATAL_ERROR "Failed to generate ATen/selected_mobile_ops.h from ${SELECTED_KERNEL_DTYPES}")
+    endif()
+    message(STATUS "Custom build with kernel dtypes selected by: ${SELECTED_KERNEL_DTYPES}")
+  endif()
   if(USE_VULKAN)
     set(GEN_VULKAN_FLAGS --vulkan)
   endif()
@@ -804,6 +804,25 @@ if(USE_OPENCV)
   endif()
 endif()
 
+# ---[ nvJPEG
+if(USE_NVJPEG)
+  find_library(NVJPEG_LIBRARY nvjpeg
+      HINTS ${CUDA_TOOLKIT_ROOT_DIR}
+      PATH_SUFFIXES lib64 lib lib/x64)
+  find_path(NVJPEG_INCLUDE_DIR nvjpeg.h
+      HINTS ${CUDA_TOOLKIT_ROOT_DIR}
+      PATH_SUFFIXES include)
+  if(USE_OPENCV AND NVJPEG_LIBRARY AND NVJPEG_INCLUDE_DIR)
+    include_directories(SYSTEM ${NVJPEG_INCLUDE_DIR})
+    list(APPEND Caffe2_CUDA_DEPENDENCY_LIBS ${NVJPEG_LIBRARY})
+    set(CAFFE2_USE_NVJPEG 1)
+    message(STATUS "nvJPEG found (${NVJPEG_LIBRARY})")
+  else()
+    message(WARNING "Not compiling with nvJPEG. Suppress this warning with -DUSE_NVJPEG=OFF")
+    caffe2_update_option(USE_NVJPEG OFF)
+  endif()
+endif()
+
 # ---[ FFMPEG
 if(USE_FFMPEG)
   find_package(FFmpeg REQUIRED)
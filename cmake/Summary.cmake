@@ -120,6 +120,7 @@ function(caffe2_print_configuration_summary)
   message(STATUS "  USE_OPENCV            : ${USE_OPENCV}")
   if(${USE_OPENCV})
     message(STATUS "    OpenCV version      : ${OpenCV_VERSION}")
+    message(STATUS "    USE_NVJPEG          : ${USE_NVJPEG}")
   endif()
   message(STATUS "  USE_OPENMP            : ${USE_OPENMP}")
   message(STATUS "  USE_TBB               : ${USE_TBB}")
@@ -139,6 +140,9 @@ function(caffe2_print_configuration_summary)
   if(NOT "${SELECTED_OP_LIST}" STREQUAL "")
     message(STATUS "  SELECTED_OP_LIST    : ${SELECTED_OP_LIST}")
   endif()
+  if(NOT "${SELECTED_KERNEL_DTYPES}" STREQUAL "")
+    message(STATUS "  SELECTED_KERNEL_DTYPES : ${SELECTED_KERNEL_DTYPES}")
+  endif()
   message(STATUS "  Public Dependencies  : ${Caffe2_PUBLIC_DEPENDENCY_LIBS}")
   message(STATUS "  Private Dependencies : ${Caffe2_DEPENDENCY_LIBS}")
 endfunction()
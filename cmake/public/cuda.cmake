@@ -343,6 +343,17 @@ else()
     set_property(
         TARGET caffe2::cublas PROPERTY INTERFACE_LINK_LIBRARIES
         ${CUDA_CUBLAS_LIBRARIES})
+    # cublasLt backs the GEMMs with fused epilogues (at::cuda::blas::gemm_and_bias)
+    if(CUDA_VERSION VERSION_GREATER_EQUAL 11.0 AND NOT WIN32)
+      find_library(CUDA_CUBLASLT_LIBRARY cublasLt
+          PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+          PATH_SUFFIXES lib lib64)
+      if(CUDA_CUBLASLT_LIBRARY)
+        set_property(
+            TARGET caffe2::cublas APPEND PROPERTY INTERFACE_LINK_LIBRARIES
+            ${CUDA_CUBLASLT_LIBRARY})
+      endif()
+    endif()
 endif()
 set_property(
     TARGET caffe2::cublas PROPERTY INTERFACE_INCLUDE_DIRECTORIES
@@ -27,6 +27,16 @@ if [ -z "${BUILD_CAFFE2_MOBILE:-}" ]; then
     fi
     CMAKE_ARGS+=("-DSELECTED_OP_LIST=${SELECTED_OP_LIST}")
   fi
+  # custom build with selected kernel dtypes
+  if [ -n "${SELECTED_KERNEL_DTYPES}" ]; then
+    SELECTED_KERNEL_DTYPES="$(cd $(dirname $SELECTED_KERNEL_DTYPES); pwd -P)/$(basename $SELECTED_KERNEL_DTYPES)"
+    echo "Choose SELECTED_KERNEL_DTYPES file: $SELECTED_KERNEL_DTYPES"
+    if [ ! -r ${SELECTED_KERNEL_DTYPES} ]; then
+      echo "Error: SELECTED_KERNEL_DTYPES file ${SELECTED_KERNEL_DTYPES} not found."
+      exit 1
+    fi
+    CMAKE_ARGS+=("-DSELECTED_KERNEL_DTYPES=${SELECTED_KERNEL_DTYPES}")
+  fi
   # bitcode
   if [ "${ENABLE_BITCODE:-}" == '1' ]; then
     CMAKE_ARGS+=("-DCMAKE_C_FLAGS=-fembed-bitcode")
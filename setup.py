@@ -845,6 +845,7 @@ if __name__ == '__main__':
                 'include/torch/csrc/jit/passes/quantization/*.h',
                 'include/torch/csrc/jit/passes/utils/*.h',
                 'include/torch/csrc/jit/runtime/*.h',
+                'include/torch/csrc/jit/runtime/static/*.h',
                 'include/torch/csrc/jit/ir/*.h',
                 'include/torch/csrc/jit/frontend/*.h',
                 'include/torch/csrc/jit/api/*.h',
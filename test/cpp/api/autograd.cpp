@@ -2,6 +2,8 @@
 
 #include <torch/torch.h>
 
+#include <torch/csrc/autograd/engine.h>
+
 #include <test/cpp/api/support.h>
 
 using namespace torch::autograd;
@@ -614,6 +616,152 @@ TEST(CustomAutogradTest, ReentrantPriority) {
   ASSERT_EQ(order.back(), 0);
 }
 
+TEST(CustomAutogradTest, MultithreadedCPUBackward) {
+  struct Fail : public Function<Fail> {
+    static Variable forward(AutogradContext*, Variable x) {
+      return x;
+    }
+
+    static variable_list backward(AutogradContext*, variable_list grad_output) {
+      throw std::runtime_error("backward failed");
+    }
+  };
+
+  struct Reenter : public Function<Reenter> {
+    static Variable forward(AutogradContext *ctx, Variable x) {
+      {
+        at::AutoGradMode enable_grad(true);
+        ctx->saved_data["x"] = make_variable(x.tensor_data(), true);
+      }
+      return x;
+    }
+
+    static variable_list backward(AutogradContext *ctx, variable_list grad_output) {
+      {
+        at::AutoGradMode enable_grad(true);
+        auto x = ctx->saved_data["x"].toTensor();
+        (x * x).sum().backward();
+        return {x.grad() * grad_output[0]};
+      }
+    }
+  };
+
+  auto& engine = Engine::get_default_engine();
+  engine.set_num_cpu_workers(3);
+
+  // Many independent branches, so that the workers run some of them
+  auto x = torch::randn({4, 4}, torch::requires_grad());
+  std::vector<Variable> branches;
+  for (int i = 0; i < 16; ++i) {
+    branches.push_back((x * (i + 1)).sin());
+  }
+  torch::stack(branches).sum().backward();
+  auto expected = torch::zeros({4, 4});
+  for (int i = 0; i < 16; ++i) {
+    expected += (x * (i + 1)).cos() * (i + 1);
+  }
+  ASSERT_VARIABLE_EQ(x.grad(), expected);
+
+  auto y = torch::randn({4, 4}, torch::requires_grad());
+  torch::stack({Reenter::apply(y) * 2, y.cos(), y.sin()}).sum().backward();
+  ASSERT_VARIABLE_EQ(y.grad(), 4 * y - y.sin() + y.cos());
+
+  // Errors in any worker are reported to the caller, and the engine can run
+  // the next backward afterwards.
+  auto z = torch::randn({4, 4}, torch::requires_grad());
+  ASSERT_THROWS_WITH(
+      torch::stack({Fail::apply(z), z.sin(), z.cos()}).sum().backward(),
+      "backward failed");
+  auto w = torch::randn({4, 4}, torch::requires_grad());
+  (w * w).sum().backward();
+  ASSERT_VARIABLE_EQ(w.grad(), 2 * w);
+
+  engine.set_num_cpu_workers(0);
+  ASSERT_EQ(engine.num_cpu_workers(), 0);
+}
+
+TEST(CustomAutogradTest, BackwardPlanCache) {
+  struct Fail : public Function<Fail> {
+    static Variable forward(AutogradContext*, Variable x) {
+      return x;
+    }
+
+    static variable_list backward(AutogradContext*, variable_list grad_output) {
+      throw std::runtime_error("backward failed");
+    }
+  };
+
+  auto& engine = Engine::get_default_engine();
+  engine.set_backward_plan_cache_enabled(true);
+
+  auto x = torch::randn({3, 3}, torch::requires_grad());
+  auto w = torch::randn({3, 3}, torch::requires_grad());
+  int hook_calls = 0;
+  for (int i = 0; i < 3; ++i) {
+    // The same structure every iteration, with a shared subexpression and a
+    // leaf used twice.
+    auto h = x.mm(w);
+    auto out = (h.sin() + h * x).sum();
+    h.register_hook([&hook_calls](Variable grad) { ++hook_calls; });
+    out.backward();
+  }
+  ASSERT_EQ(hook_calls, 3);
+  auto h = x.mm(w);
+  auto grad_h = h.cos() + x;
+  ASSERT_VARIABLE_EQ(x.grad(), 3 * (grad_h.mm(w.t()) + h));
+  ASSERT_VARIABLE_EQ(w.grad(), 3 * x.t().mm(grad_h));
+
+  // A graph with a different structure gets its own plan.
+  auto y = torch::randn({3}, torch::requires_grad());
+  (y * y * y).sum().backward({}, /*keep_graph=*/true);
+  ASSERT_VARIABLE_EQ(y.grad(), 3 * y * y);
+
+  // Errors are reported as without plans.
+  ASSERT_THROWS_WITH(Fail::apply(y).sum().backward(), "backward failed");
+
+  engine.set_backward_plan_cache_enabled(false);
+  ASSERT_FALSE(engine.is_backward_plan_cache_enabled());
+}
+
+TEST(CustomAutogradTest, SavedVariableHooks) {
+  struct CountingHooks : public SavedVariableHooks {
+    explicit CountingHooks(int* unpacks) : unpacks_(unpacks) {}
+    void call_pack_hook(const at::Tensor& tensor) override {
+      data_ = tensor.clone();
+    }
+    at::Tensor call_unpack_hook() override {
+      ++*unpacks_;
+      return data_;
+    }
+    int* unpacks_;
+    at::Tensor data_;
+  };
+
+  int unpacks = 0;
+  auto x = torch::randn({3, 3}, torch::requires_grad());
+  Variable y;
+  {
+    SavedVariableHooksGuard guard([&unpacks]() -> std::unique_ptr<SavedVariableHooks> {
+      return torch::make_unique<CountingHooks>(&unpacks);
+    });
+    y = (x.exp() * x.exp()).sum();
+  }
+  y.backward();
+  // Two exp results, saved by ExpBackward and by MulBackward. x is a leaf
+  // that requires grad and is saved as is.
+  ASSERT_EQ(unpacks, 4);
+  ASSERT_VARIABLE_EQ(x.grad(), 2 * x.exp() * x.exp());
+  ASSERT_EQ(current_saved_variable_hooks(), nullptr);
+
+  auto z = torch::randn({3, 3}, torch::requires_grad());
+  {
+    SavedVariableHooksGuard guard(make_compressed_saved_variable_hooks(at::kHalf));
+    (z.sin() * z.sin()).sum().backward();
+  }
+  auto s = z.sin().to(at::kHalf).to(at::kFloat);
+  ASSERT_TRUE(torch::allclose(z.grad(), 2 * s * z.cos(), 1e-3, 1e-3));
+}
+
 TEST(CustomAutogradTest, Hooks) {
   Variable x = torch::ones({5,5}, torch::requires_grad());
   Variable y = torch::ones({5,5})*4;
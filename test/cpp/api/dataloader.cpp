@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -639,6 +640,75 @@ TEST(DataTest, MapDoesNotCopy) {
   ASSERT_EQ(data[0].item<float>(), 7);
 }
 
+namespace {
+void write_bytes(const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+} // namespace
+
+TEST(DataTest, RecordFileDatasetWithFixedSizeRecords) {
+  auto tempfile = c10::make_tempfile();
+  std::vector<uint8_t> bytes(26);
+  std::iota(bytes.begin(), bytes.end(), 0);
+  write_bytes(tempfile.name, bytes);
+
+  datasets::RecordFileDataset dataset(
+      tempfile.name,
+      /*record_size=*/4,
+      datasets::RecordFileOptions().access(
+          datasets::RecordFileOptions::Access::kRandom));
+  // The two trailing bytes do not make up a record.
+  ASSERT_EQ(dataset.size().value(), 6);
+
+  auto record = dataset.get(2);
+  ASSERT_EQ(record.dtype(), torch::kUInt8);
+  ASSERT_TRUE(record.equal(torch::arange(8, 12, torch::kUInt8)));
+  // Records are views into the mapped file.
+  ASSERT_EQ(
+      record.data_ptr<uint8_t>(), dataset.data().data_ptr<uint8_t>() + 8);
+  ASSERT_THROWS_WITH(dataset.get(6), "out of range");
+}
+
+TEST(DataTest, RecordFileDatasetWithIndexFile) {
+  auto tempfile = c10::make_tempfile();
+  write_bytes(tempfile.name, {1, 2, 3, 4, 5, 6});
+
+  // Records [1], [], [2, 3, 4, 5] and [6].
+  auto index = c10::make_tempfile();
+  std::vector<uint8_t> index_bytes;
+  for (uint64_t offset : {0, 1, 1, 5, 6}) {
+    for (int i = 0; i < 8; ++i) {
+      index_bytes.push_back((offset >> (8 * i)) & 0xff);
+    }
+  }
+  write_bytes(index.name, index_bytes);
+
+  datasets::RecordFileDataset dataset(
+      tempfile.name,
+      index.name,
+      datasets::RecordFileOptions().will_need(true));
+  ASSERT_EQ(dataset.size().value(), 4);
+  auto batch = dataset.get_batch({3, 1, 2});
+  ASSERT_EQ(batch.size(), 3);
+  ASSERT_TRUE(batch[0].equal(torch::tensor({6}, torch::kUInt8)));
+  ASSERT_EQ(batch[1].numel(), 0);
+  ASSERT_TRUE(batch[2].equal(torch::tensor({2, 3, 4, 5}, torch::kUInt8)));
+
+  // Writing to a record never reaches the file.
+  batch[2].fill_(0);
+  ASSERT_TRUE(datasets::RecordFileDataset(tempfile.name, 6)
+                  .get(0)
+                  .equal(torch::tensor({1, 2, 3, 4, 5, 6}, torch::kUInt8)));
+
+  ASSERT_THROWS_WITH(
+      datasets::RecordFileDataset(tempfile.name, std::vector<int64_t>{0, 7}),
+      "only 6 bytes long");
+  ASSERT_THROWS_WITH(
+      datasets::RecordFileDataset(tempfile.name, std::vector<int64_t>{2, 1}),
+      "non-decreasing");
+}
+
 TEST(DataTest, QueuePushAndPopFromSameThread) {
   torch::data::detail::Queue<int> queue;
   queue.push(1);
@@ -688,6 +758,81 @@ TEST(DataTest, QueueClearEmptiesTheQueue) {
   ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, BoundedQueuePushAndPopFromSameThread) {
+  torch::data::detail::BoundedQueue<int> queue(4);
+  ASSERT_EQ(queue.capacity(), 4);
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      queue.push(i);
+    }
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_EQ(queue.pop(), i);
+    }
+  }
+}
+
+TEST(DataTest, BoundedQueuePopWithTimeoutThrowsUponTimeout) {
+  torch::data::detail::BoundedQueue<int> queue(2);
+  ASSERT_THROWS_WITH(
+      queue.pop(10 * kMillisecond),
+      "Timeout in DataLoader queue while waiting for next batch "
+      "(timeout was 10 ms)");
+}
+
+TEST(DataTest, BoundedQueuePushBlocksWhileFull) {
+  torch::data::detail::BoundedQueue<int> queue(2);
+  queue.push(1);
+  queue.push(2);
+  std::thread thread([&queue] {
+    std::this_thread::sleep_for(20 * kMillisecond);
+    ASSERT_EQ(queue.pop(), 1);
+  });
+  queue.push(3);
+  thread.join();
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_EQ(queue.pop(), 3);
+}
+
+TEST(DataTest, BoundedQueueClearEmptiesTheQueue) {
+  torch::data::detail::BoundedQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+  ASSERT_EQ(queue.clear(), 3);
+  ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
+}
+
+TEST(DataTest, BoundedQueueManyProducersAndConsumers) {
+  const int kThreads = 4;
+  const int kValuesPerThread = 10000;
+  torch::data::detail::BoundedQueue<int> queue(8);
+  std::vector<std::thread> producers;
+  std::vector<std::future<int64_t>> consumers;
+  for (int t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&queue, t] {
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        queue.push(t * kValuesPerThread + i);
+      }
+    });
+    consumers.push_back(std::async(std::launch::async, [&queue] {
+      int64_t sum = 0;
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        sum += queue.pop();
+      }
+      return sum;
+    }));
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  int64_t sum = 0;
+  for (auto& consumer : consumers) {
+    sum += consumer.get();
+  }
+  const int64_t n = kThreads * kValuesPerThread;
+  ASSERT_EQ(sum, n * (n - 1) / 2);
+}
+
 TEST(DataTest, DataShuttleCanPushAndPopJob) {
   torch::data::detail::DataShuttle<int, int> shuttle;
   shuttle.push_job(1);
@@ -736,6 +881,19 @@ TEST(DataTest, DataShuttlePopResultTimesOut) {
   ASSERT_THROWS_WITH(shuttle.pop_result(10 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, DataShuttleWithBoundedQueues) {
+  using torch::data::detail::BoundedQueue;
+  torch::data::detail::DataShuttle<int, int, BoundedQueue> shuttle(2);
+  shuttle.push_job(1);
+  shuttle.push_job(2);
+  ASSERT_EQ(shuttle.pop_job(), 1);
+  shuttle.push_result(1);
+  ASSERT_EQ(shuttle.pop_result().value(), 1);
+  shuttle.drain();
+  ASSERT_EQ(shuttle.in_flight_jobs(), 0);
+  ASSERT_FALSE(shuttle.pop_result().has_value());
+}
+
 struct UncopyableDataset : datasets::Dataset<UncopyableDataset, int> {
   UncopyableDataset(const std::string& /* unused */) {}
 
@@ -1030,6 +1188,9 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.pin_memory);
+  ASSERT_FALSE(full_options.prefetch_to_device.has_value());
+  ASSERT_FALSE(full_options.worker_processes);
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1455,6 +1616,122 @@ TEST(DataLoaderTest, TestExceptionsArePropagatedFromWorkers) {
   }
 }
 
+struct RangeTensorDataset
+    : datasets::BatchDataset<RangeTensorDataset, torch::Tensor> {
+  torch::Tensor get_batch(torch::ArrayRef<size_t> indices) override {
+    std::vector<int64_t> values(indices.begin(), indices.end());
+    return torch::tensor(values);
+  }
+  torch::optional<size_t> size() const override {
+    return 100;
+  }
+};
+
+TEST(DataLoaderTest, PrefetchToCPUWithWorkers) {
+  auto data_loader = torch::data::make_data_loader(
+      RangeTensorDataset{},
+      samplers::SequentialSampler(100),
+      DataLoaderOptions(10).workers(2).prefetch_to_device(torch::kCPU));
+
+  int64_t expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.device().is_cpu());
+    ASSERT_TRUE(batch.equal(torch::arange(expected, expected + 10)));
+    expected += 10;
+  }
+  ASSERT_EQ(expected, 100);
+}
+
+TEST(DataLoaderTest, PinMemoryAndPrefetchToDevice_CUDA) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        RangeTensorDataset{},
+        samplers::SequentialSampler(100),
+        DataLoaderOptions(10)
+            .workers(workers)
+            .pin_memory(true)
+            .prefetch_to_device(torch::kCUDA));
+
+    int64_t expected = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.device().is_cuda());
+      ASSERT_TRUE(batch.cpu().equal(torch::arange(expected, expected + 10)));
+      expected += 10;
+    }
+    ASSERT_EQ(expected, 100);
+  }
+}
+
+#ifndef _WIN32
+struct ExampleRangeDataset : datasets::Dataset<ExampleRangeDataset> {
+  Example<> get(size_t index) override {
+    if (index == throw_at) {
+      throw std::invalid_argument("badness");
+    }
+    if (index == exit_at) {
+      std::_Exit(3);
+    }
+    return {torch::full({2, 3}, static_cast<float>(index)),
+            torch::tensor(static_cast<int64_t>(index))};
+  }
+  torch::optional<size_t> size() const override {
+    return 100;
+  }
+  size_t throw_at = 100;
+  size_t exit_at = 100;
+};
+
+TEST(DataLoaderTest, WorkerProcessesLoadBatches) {
+  auto data_loader = torch::data::make_data_loader(
+      ExampleRangeDataset{},
+      samplers::SequentialSampler(100),
+      DataLoaderOptions(10).workers(3).worker_processes(true));
+
+  for (int epoch = 0; epoch < 2; ++epoch) {
+    size_t index = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_EQ(batch.size(), 10);
+      for (auto& example : batch) {
+        ASSERT_TRUE(example.data.equal(torch::full({2, 3}, float(index))));
+        ASSERT_EQ(example.target.item<int64_t>(), index);
+        ++index;
+      }
+    }
+    ASSERT_EQ(index, 100);
+  }
+}
+
+TEST(DataLoaderTest, WorkerProcessesPropagateExceptions) {
+  ExampleRangeDataset dataset;
+  dataset.throw_at = 42;
+  auto data_loader = torch::data::make_data_loader(
+      dataset,
+      samplers::SequentialSampler(100),
+      DataLoaderOptions(10).workers(2).worker_processes(true));
+  try {
+    for (auto& batch : *data_loader) {
+      (void)batch;
+    }
+    FAIL() << "Expected a WorkerException";
+  } catch (torch::data::WorkerException& e) {
+    ASSERT_EQ(
+        e.what(),
+        std::string("Caught exception in DataLoader worker thread. "
+                    "Original message: badness"));
+  }
+}
+
+TEST(DataLoaderTest, WorkerProcessCrashFailsItsBatches) {
+  ExampleRangeDataset dataset;
+  dataset.exit_at = 0;
+  auto data_loader = torch::data::make_data_loader(
+      dataset,
+      samplers::SequentialSampler(100),
+      DataLoaderOptions(10).workers(1).worker_processes(true));
+  ASSERT_THROWS_WITH(*data_loader->begin(), "exited unexpectedly");
+}
+#endif
+
 TEST(DataLoaderTest, StatefulDatasetWithNoWorkers) {
   const int kNumberOfExamplesAfterWhichTheDatasetExhausts = 10;
 
@@ -2223,6 +2500,73 @@ TEST(DataLoaderTest, ChunkDatasetCrossChunkShuffle) {
   }
 }
 
+TEST(DataLoaderTest, ChunkDatasetShuffleBufferAndReadahead) {
+  const size_t batch_size = 5;
+  const size_t total_example_count = 35;
+  const size_t shuffle_buffer_sizes[] = {0, 1, 8, 64};
+  const size_t chunk_readaheads[] = {0, 2};
+  const size_t prefetch_counts[] = {1, 2};
+
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+
+  for (auto shuffle_buffer_size : shuffle_buffer_sizes) {
+    for (auto chunk_readahead : chunk_readaheads) {
+      for (auto prefetch_count : prefetch_counts) {
+        datasets::SharedBatchDataset<datasets::ChunkDataset<
+            DummyChunkDataReader,
+            samplers::SequentialSampler,
+            samplers::SequentialSampler>>
+            dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+                DummyChunkDataReader,
+                samplers::SequentialSampler,
+                samplers::SequentialSampler>>(
+                data_reader,
+                sampler,
+                sampler,
+                datasets::ChunkDatasetOptions(
+                    prefetch_count,
+                    batch_size,
+                    /*cache_size=*/10,
+                    /*cross_chunk_shuffle_count=*/1,
+                    shuffle_buffer_size,
+                    chunk_readahead));
+
+        auto data_loader = torch::data::make_data_loader(
+            dataset, DataLoaderOptions(batch_size).workers(0));
+
+        // test functionality across epoch boundary
+        for (int epoch_index = 0; epoch_index < 2; ++epoch_index) {
+          std::vector<int> result;
+          for (auto iterator = data_loader->begin();
+               iterator != data_loader->end();
+               ++iterator) {
+            auto batch_result = *iterator;
+            ASSERT_EQ(batch_result.size(), batch_size);
+            std::copy(
+                batch_result.begin(),
+                batch_result.end(),
+                std::back_inserter(result));
+          }
+
+          ASSERT_EQ(result.size(), total_example_count);
+          // Without the reservoir a single preloader keeps chunk order, even
+          // when reading ahead.
+          if (shuffle_buffer_size == 0 && prefetch_count == 1) {
+            for (size_t i = 0; i < total_example_count; ++i) {
+              ASSERT_EQ(result[i], i);
+            }
+          }
+          std::sort(result.begin(), result.end());
+          for (size_t i = 0; i < total_example_count; ++i) {
+            ASSERT_EQ(result[i], i);
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(DataLoaderTest, CustomPreprocessPolicy) {
   const size_t chunk_size = 5;
   const size_t batch_size = 10;
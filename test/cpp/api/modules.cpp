@@ -3496,6 +3496,53 @@ TEST_F(ModulesTest, MultiheadAttention) {
   );
 }
 
+TEST_F(ModulesTest, MultiheadAttentionIncremental) {
+  const int64_t embed_dim = 8, num_heads = 2, bsz = 3, seq_len = 5;
+  MultiheadAttention model(MultiheadAttentionOptions(embed_dim, num_heads));
+  model->eval();
+  torch::NoGradGuard no_grad;
+  const auto x = torch::randn({seq_len, bsz, embed_dim});
+  const auto causal_mask = torch::full({seq_len, seq_len}, -std::numeric_limits<float>::infinity())
+    .triu(/*diagonal=*/1);
+  const auto expected = std::get<0>(model(x, x, x, {}, false, causal_mask));
+
+  // one position at a time
+  MultiheadAttentionCache cache;
+  std::vector<torch::Tensor> outputs;
+  for (int64_t i = 0; i < seq_len; i++) {
+    outputs.push_back(std::get<0>(model->forward_incremental(x.narrow(0, i, 1), cache)));
+  }
+  ASSERT_EQ(cache.length(), seq_len);
+  ASSERT_TRUE(torch::allclose(torch::cat(outputs), expected, 1e-5, 1e-6));
+
+  // a prompt, then single positions, with attention weights
+  cache.clear();
+  ASSERT_EQ(cache.length(), 0);
+  auto prompt = model->forward_incremental(x.narrow(0, 0, 3), cache, {}, /*need_weights=*/true);
+  ASSERT_TRUE(torch::allclose(std::get<0>(prompt), expected.narrow(0, 0, 3), 1e-5, 1e-6));
+  ASSERT_EQ(std::get<1>(prompt).sizes(), std::vector<int64_t>({bsz, 3, 3}));
+  auto step = model->forward_incremental(x.narrow(0, 3, 2), cache);
+  ASSERT_TRUE(torch::allclose(std::get<0>(step), expected.narrow(0, 3, 2), 1e-5, 1e-6));
+
+  // reordering the cache follows the batch entries
+  const auto new_order = torch::tensor({2, 0, 0}, torch::kLong);
+  const auto x_reordered = x.index_select(1, new_order);
+  const auto expected_reordered = std::get<0>(model(
+    x_reordered, x_reordered, x_reordered, {}, false, causal_mask));
+  cache.clear();
+  for (int64_t i = 0; i < seq_len - 1; i++) {
+    model->forward_incremental(x.narrow(0, i, 1), cache);
+  }
+  cache.reorder(new_order);
+  auto last = std::get<0>(model->forward_incremental(
+    x_reordered.narrow(0, seq_len - 1, 1), cache));
+  ASSERT_TRUE(torch::allclose(last, expected_reordered.narrow(0, seq_len - 1, 1), 1e-5, 1e-6));
+
+  ASSERT_THROWS_WITH(
+    model->forward_incremental(torch::randn({1, bsz + 1, embed_dim}), cache),
+    "the cache holds a batch of 3");
+}
+
 TEST_F(ModulesTest, PrettyPrintIdentity) {
   ASSERT_EQ(c10::str(Identity()), "torch::nn::Identity()");
 }
@@ -283,6 +283,17 @@ TEST(OptimTest, ProducesPyTorchValues_AdamWithWeightDecayAndAMSGrad) {
       expected_parameters::Adam_with_weight_decay_and_amsgrad());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_AdamFused) {
+  check_exact_values<Adam>(
+      AdamOptions(1.0).fused(true), expected_parameters::Adam());
+}
+
+TEST(OptimTest, ProducesPyTorchValues_AdamWithWeightDecayAndAMSGradFused) {
+  check_exact_values<Adam>(
+      AdamOptions(1.0).weight_decay(1e-6).amsgrad(true).fused(true),
+      expected_parameters::Adam_with_weight_decay_and_amsgrad());
+}
+
 TEST(OptimTest, XORConvergence_AdamW) {
   ASSERT_TRUE(test_optimizer_xor<AdamW>(AdamWOptions(0.1)));
 }
@@ -308,6 +319,11 @@ TEST(OptimTest, ProducesPyTorchValues_AdamWWithAMSGrad) {
       expected_parameters::AdamW_with_amsgrad());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_AdamWFused) {
+  check_exact_values<AdamW>(
+      AdamWOptions(1.0).fused(true), expected_parameters::AdamW());
+}
+
 TEST(OptimTest, ProducesPyTorchValues_Adagrad) {
   check_exact_values<Adagrad>(
       AdagradOptions(1.0), expected_parameters::Adagrad());
@@ -373,6 +389,18 @@ TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum) {
       expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndMomentumFused) {
+  check_exact_values<SGD>(
+      SGDOptions(0.1).weight_decay(1e-2).momentum(0.9).fused(true),
+      expected_parameters::SGD_with_weight_decay_and_momentum());
+}
+
+TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentumFused) {
+  check_exact_values<SGD>(
+      SGDOptions(0.1).weight_decay(1e-6).momentum(0.9).nesterov(true).fused(true),
+      expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
+}
+
 TEST(OptimTest, ProducesPyTorchValues_LBFGS) {
   check_exact_values<LBFGS>(
       LBFGSOptions(1.0),
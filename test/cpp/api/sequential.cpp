@@ -667,3 +667,56 @@ TEST_F(SequentialTest, ModuleForwardMethodOptionalArg) {
     ASSERT_TRUE(torch::allclose(rnn_output, expected_output, 1e-05, 2e-04));
   }
 }
+
+TEST_F(SequentialTest, StaticSequentialForwardMatchesSequential) {
+  Linear linear1(3, 4), linear2(4, 2);
+  Sequential sequential(linear1, ReLU(), linear2);
+  auto static_sequential = make_static_sequential(linear1, ReLU(), linear2);
+  ASSERT_EQ(static_sequential->size(), 3);
+  ASSERT_EQ(static_sequential->parameters().size(), 4);
+  ASSERT_EQ(static_sequential->ptr<0>(), linear1.ptr());
+  ASSERT_EQ(static_sequential->at<2>().weight.size(0), 2);
+
+  auto x = torch::randn({5, 3});
+  torch::Tensor output = static_sequential->forward(x);
+  ASSERT_TRUE(torch::equal(output, sequential->forward(x)));
+}
+
+TEST_F(SequentialTest, StaticSequentialForwardsTypedOutputs) {
+  struct M : torch::nn::Module {
+    explicit M(int value_) : value(value_) {}
+    int value;
+    int forward(int x) {
+      return x + value;
+    }
+  };
+  struct ToString : torch::nn::Module {
+    std::string forward(int x) {
+      return c10::to_string(x);
+    }
+  };
+  auto static_sequential =
+      make_static_sequential(M(1), std::make_shared<M>(2), ToString());
+  std::string output = static_sequential->forward(3);
+  ASSERT_EQ(output, "6");
+
+  // Trailing default arguments of a module's forward() may be omitted.
+  auto rnn = make_static_sequential(Identity(), GRUCell(2, 3));
+  ASSERT_EQ(rnn->forward(torch::ones({2, 2})).sizes(), std::vector<int64_t>({2, 3}));
+}
+
+TEST_F(SequentialTest, StaticSequentialIsCloneable) {
+  auto static_sequential = make_static_sequential(Linear(3, 4), BatchNorm1d(4));
+  auto clone = std::dynamic_pointer_cast<
+      StaticSequentialImpl<LinearImpl, BatchNorm1dImpl>>(
+      static_sequential->clone());
+  ASSERT_TRUE(clone != nullptr);
+  ASSERT_NE(clone->ptr<0>(), static_sequential->ptr<0>());
+  auto params1 = static_sequential->named_parameters();
+  auto params2 = clone->named_parameters();
+  ASSERT_EQ(params1.size(), params2.size());
+  for (auto& param : params1) {
+    ASSERT_FALSE(pointer_equal(param.value(), params2[param.key()]));
+    ASSERT_TRUE(param->equal(params2[param.key()]));
+  }
+}
@@ -1185,6 +1185,39 @@ void testMemoryDAG() {
       AT_ASSERT(!dag->mayContainAlias(e, elem));
     }
   }
+  {
+    // The contained memory locations are cached per element; make sure
+    // queries in any order (and through elements whose closure was cached
+    // while computing another one) give the same answers.
+    // c(b(a)), e -> b, f(g)
+    auto t = std::make_unique<MemoryDAGBuilder>();
+    auto a = t->makeFreshValue(aValue);
+    auto b = t->makeFreshValue(bValue);
+    auto c = t->makeFreshValue(cValue);
+    auto e = t->makeFreshValue(eValue);
+    auto f = t->makeFreshValue(fValue);
+    auto g = t->makeFreshValue(gValue);
+    t->addToContainedElements(a, b);
+    t->addToContainedElements(b, c);
+    t->makePointerTo(e, b);
+    t->addToContainedElements(g, f);
+
+    auto dag = std::make_unique<MemoryDAG>(std::move(t));
+    for (int i = 0; i < 2; ++i) {
+      AT_ASSERT(dag->mayContainAlias(a, c));
+      AT_ASSERT(dag->mayContainAlias(e, a));
+      AT_ASSERT(dag->mayContainAlias(c, e));
+      AT_ASSERT(!dag->mayContainAlias(c, f));
+      AT_ASSERT(!dag->mayContainAlias(g, e));
+      std::vector<Element*> as = {f, e};
+      std::vector<Element*> bs = {g};
+      AT_ASSERT(dag->mayContainAlias(as, bs));
+      bs = {a};
+      AT_ASSERT(dag->mayContainAlias(as, bs));
+      as = {f};
+      AT_ASSERT(!dag->mayContainAlias(as, bs));
+    }
+  }
 }
 
 void testAliasRegistration() {
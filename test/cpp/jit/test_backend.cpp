@@ -1,3 +1,4 @@
+#include <ATen/Parallel.h>
 #include <torch/csrc/jit/backends/backend.h>
 
 namespace torch {
@@ -67,8 +68,30 @@ class TestBackend : public PyTorchBackendInterface {
   }
 };
 
+// Same as TestBackend, but runs execute() on the inter-op thread pool so that
+// the asynchronous path through execute_async is exercised.
+class TestBackendAsync : public TestBackend {
+ public:
+  c10::intrusive_ptr<c10::ivalue::Future> executeAsync(
+      c10::IValue handle,
+      c10::impl::GenericList inputs) override {
+    auto future = c10::make_intrusive<c10::ivalue::Future>(
+        c10::ListType::create(c10::AnyType::get()));
+    at::launch([this, future, handle, inputs]() {
+      try {
+        future->markCompleted(execute(handle, inputs));
+      } catch (const std::exception& e) {
+        future->setError(e.what());
+      }
+    });
+    return future;
+  }
+};
+
 namespace {
 static auto cls = torch::jit::backend<TestBackend>("test_backend");
+static auto cls_async =
+    torch::jit::backend<TestBackendAsync>("test_backend_async");
 }
 
 } // namespace jit
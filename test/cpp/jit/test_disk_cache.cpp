@@ -0,0 +1,92 @@
+#include "test/cpp/jit/test_base.h"
+
+#include "torch/csrc/jit/codegen/disk_cache.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+
+namespace torch {
+namespace jit {
+
+#ifndef _WIN32
+namespace {
+
+size_t countEntries(const std::string& directory) {
+  size_t count = 0;
+  DIR* dir = opendir(directory.c_str());
+  while (struct dirent* dirent = readdir(dir)) {
+    if (std::string(dirent->d_name).find(".kernel") != std::string::npos) {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+void removeDirectory(const std::string& directory) {
+  DIR* dir = opendir(directory.c_str());
+  while (struct dirent* dirent = readdir(dir)) {
+    const std::string name = dirent->d_name;
+    if (name != "." && name != "..") {
+      unlink((directory + "/" + name).c_str());
+    }
+  }
+  closedir(dir);
+  rmdir(directory.c_str());
+}
+
+} // namespace
+#endif
+
+void testKernelDiskCache() {
+#ifndef _WIN32
+  const auto old_directory = getKernelDiskCacheDirectory();
+  const auto old_max_bytes = getKernelDiskCacheMaxBytes();
+
+  char root_template[] = "/tmp/torch-kernel-cache-XXXXXX";
+  const std::string root = mkdtemp(root_template);
+  // The cache creates missing directories.
+  const auto directory = root + "/kernels";
+  setKernelDiskCacheDirectory(directory);
+  setKernelDiskCacheMaxBytes(int64_t(1) << 20);
+
+  ASSERT_FALSE(loadCachedKernel("a"));
+  const std::string binary("\x7f" "ELF\0kernel", 11);
+  storeCachedKernel("a", binary);
+  auto cached = loadCachedKernel("a");
+  ASSERT_TRUE(cached);
+  ASSERT_EQ(*cached, binary);
+  ASSERT_FALSE(loadCachedKernel("b"));
+
+  // Storing under the same key replaces the entry.
+  storeCachedKernel("a", "new");
+  ASSERT_EQ(*loadCachedKernel("a"), "new");
+  ASSERT_EQ(countEntries(directory), 1);
+
+  // Entries beyond the size limit are evicted.
+  setKernelDiskCacheMaxBytes(0);
+  storeCachedKernel("b", binary);
+  ASSERT_EQ(countEntries(directory), 0);
+  ASSERT_FALSE(loadCachedKernel("a"));
+
+  // An empty directory disables the cache.
+  setKernelDiskCacheMaxBytes(int64_t(1) << 20);
+  setKernelDiskCacheDirectory("");
+  storeCachedKernel("a", binary);
+  ASSERT_FALSE(loadCachedKernel("a"));
+  ASSERT_EQ(countEntries(directory), 0);
+
+  removeDirectory(directory);
+  rmdir(root.c_str());
+  setKernelDiskCacheDirectory(old_directory);
+  setKernelDiskCacheMaxBytes(old_max_bytes);
+#endif
+}
+
+} // namespace jit
+} // namespace torch
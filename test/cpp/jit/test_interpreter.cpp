@@ -1,6 +1,14 @@
 #include "test/cpp/jit/test_base.h"
 #include "test/cpp/jit/test_utils.h"
 
+#include <torch/csrc/jit/runtime/priority_task_pool.h>
+#include <torch/jit.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
 namespace torch {
 namespace jit {
 
@@ -27,5 +35,75 @@ void testInterp() {
   ASSERT_TRUE(exactlyEqual(outputs[0], hx));
   ASSERT_TRUE(exactlyEqual(outputs[1], cx));
 }
+
+void testInterpreterTaskLauncher() {
+  auto cu = compile(R"JIT(
+    def add_one(x):
+        return x + 1
+
+    def add_two(x):
+        fut = torch.jit._fork(add_one, x)
+        return torch.jit._wait(fut) + 1
+
+    def forks(x):
+        a = torch.jit._fork(add_two, x)
+        b = torch.jit._fork(add_one, x)
+        return torch.jit._wait(a) + torch.jit._wait(b)
+  )JIT");
+
+  // The nested forks run through the launcher of the run too.
+  std::atomic<int> launched{0};
+  TaskLauncher launcher = [&launched](std::function<void()> fn) {
+    ++launched;
+    at::launch(std::move(fn));
+  };
+  Stack stack = {at::ones({2})};
+  auto future = cu->get_function("forks").runAsync(stack, launcher);
+  future->wait();
+  ASSERT_FALSE(future->hasError());
+  ASSERT_TRUE(future->value().toTensor().equal(at::full({2}, 5.)));
+  ASSERT_TRUE(launched.load() >= 3);
+
+  // And so do they on a PriorityTaskPool.
+  PriorityTaskPool pool(2);
+  stack = {at::ones({2})};
+  future = cu->get_function("forks").runAsync(stack, pool.launcher(1));
+  future->wait();
+  ASSERT_FALSE(future->hasError());
+  ASSERT_TRUE(future->value().toTensor().equal(at::full({2}, 5.)));
+}
+
+void testPriorityTaskPool() {
+  PriorityTaskPool pool(1);
+  std::promise<void> unblock;
+  auto blocked = unblock.get_future().share();
+  std::promise<void> started;
+  pool.run([blocked, &started]() {
+    started.set_value();
+    blocked.wait();
+  });
+  started.get_future().wait();
+
+  // The only thread is busy, so the tasks queue up.
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  auto record = [&](int value) {
+    std::lock_guard<std::mutex> guard(mutex);
+    order.push_back(value);
+    if (order.size() == 4) {
+      done.set_value();
+    }
+  };
+  pool.run([&]() { record(0); }, 0);
+  pool.launcher(2)([&]() { record(2); });
+  pool.run([&]() { record(1); }, 1);
+  pool.run([&]() { record(3); }, 2);
+  unblock.set_value();
+  done.get_future().wait();
+
+  // By priority, then first in first out.
+  ASSERT_EQ(order, (std::vector<int>{2, 3, 1, 0}));
+}
 } // namespace jit
 } // namespace torch
@@ -1,13 +1,22 @@
+#include <c10/core/CPUAllocator.h>
 #include <c10/core/TensorOptions.h>
 #include <test/cpp/jit/test_base.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
 #include <torch/torch.h>
 
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+
 // Tests go in torch::jit
 namespace torch {
 namespace jit {
@@ -300,6 +309,177 @@ void testLiteInterpreterBuiltinFunction() {
   AT_ASSERT(str == expected);
 }
 
+void testLiteInterpreterRegisterCalls() {
+  // Exercises the operators the mobile interpreter calls unboxed, with
+  // register, moved and constant arguments and in-place variants.
+  Module m("m");
+  m.register_parameter("conv_weight", torch::rand({4, 3, 3, 3}), false);
+  m.register_parameter("conv_bias", torch::rand({4}), false);
+  m.register_parameter("fc_weight", torch::rand({5, 16}), false);
+  m.register_parameter("fc_bias", torch::rand({5}), false);
+  m.define(R"(
+    def forward(self, x, y):
+      a = torch.conv2d(x, self.conv_weight, self.conv_bias, [1, 1], [1, 1])
+      b = torch.conv2d(x, self.conv_weight, None, [1, 1], [1, 1])
+      c = torch.add(a, b, alpha=2)
+      c.add_(b)
+      c = torch.relu(c)
+      c = torch.max_pool2d(c, [2, 2], [2, 2], [0, 0], [1, 1], False)
+      c = torch.adaptive_avg_pool2d(c, [2, 2])
+      d = torch.flatten(c, 1)
+      e = torch.linear(d, self.fc_weight, self.fc_bias)
+      e = torch.mul(e, y)
+      f = torch.cat([e, torch.sigmoid(e)], 1)
+      f = torch.hardtanh_(f, -0.5, 0.5)
+      return torch.relu_(f.view([-1]))
+  )");
+
+  std::vector<IValue> inputs{torch::rand({2, 3, 8, 8}), torch::rand({2, 5})};
+  auto ref = m.forward(inputs).toTensor();
+
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  for (int i = 0; i < 2; ++i) {
+    auto res = bc.forward(inputs).toTensor();
+    ASSERT_TRUE(res.equal(ref));
+  }
+}
+
+void testLiteInterpreterLazyMethods() {
+  Module m("m");
+  m.register_parameter("foo", torch::ones({}), false);
+  m.define(R"(
+    def forward(self, x):
+      return self.foo + x
+
+    def scaled(self, x, scale: float):
+      return (self.foo + x) * scale
+  )");
+  auto input = torch::rand({3});
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+
+  // Methods are only built when they first run.
+  ASSERT_FALSE(bc.find_method("forward")->initialized());
+  ASSERT_FALSE(bc.find_method("scaled")->initialized());
+  auto res = bc.forward({input}).toTensor();
+  ASSERT_TRUE(res.equal(m.forward({input}).toTensor()));
+  ASSERT_TRUE(bc.find_method("forward")->initialized());
+  ASSERT_FALSE(bc.find_method("scaled")->initialized());
+
+  std::vector<IValue> inputs{input, 2.0};
+  auto ref = m.run_method("scaled", input, 2.0).toTensor();
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(bc.run_method("scaled", inputs).toTensor().equal(ref));
+  }
+  ASSERT_TRUE(bc.find_method("scaled")->initialized());
+}
+
+void testLiteInterpreterOpLatencies() {
+  Module m("m");
+  m.register_parameter("weight", torch::rand({8, 8}), false);
+  m.define(R"(
+    def forward(self, x):
+      y = torch.mm(x, self.weight)
+      return torch.relu(y + x)
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  auto input = torch::rand({8, 8});
+
+  // Nothing is recorded while profiling is off.
+  bc.forward({input});
+  ASSERT_TRUE(bc.op_latencies().empty());
+
+  const int runs = 3;
+  torch::observerConfig().setOpLatencyProfiling(true);
+  for (int i = 0; i < runs; ++i) {
+    bc.forward({input});
+  }
+  torch::observerConfig().setOpLatencyProfiling(false);
+  bc.forward({input});
+
+  auto latencies = bc.op_latencies();
+  std::set<std::string> ops;
+  for (size_t i = 0; i < latencies.size(); ++i) {
+    const auto& latency = latencies[i];
+    ASSERT_EQ(latency.method_name, "forward");
+    ASSERT_EQ(latency.count, static_cast<uint64_t>(runs));
+    if (i > 0) {
+      ASSERT_LE(latency.ticks, latencies[i - 1].ticks);
+    }
+    ops.insert(latency.op_name);
+  }
+  ASSERT_TRUE(ops.count("aten::mm"));
+  ASSERT_TRUE(ops.count("aten::add.Tensor"));
+  ASSERT_TRUE(ops.count("aten::relu"));
+
+  bc.reset_op_latencies();
+  ASSERT_TRUE(bc.op_latencies().empty());
+}
+
+void testLiteInterpreterZeroCopyLoad() {
+  Module m("m");
+  m.register_parameter("weight", torch::rand({16, 16}), false);
+  m.define(R"(
+    def forward(self, x):
+      return self.weight * x
+
+    def get_weight(self):
+      return self.weight
+  )");
+  auto input = torch::rand({16, 16});
+  auto ref = m.forward({input}).toTensor();
+
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  const std::string model = ss.str();
+  auto within = [](const at::Tensor& t, const char* begin, size_t size) {
+    auto data = static_cast<const char*>(t.storage().data());
+    return data >= begin && data + t.nbytes() <= begin + size;
+  };
+
+  // A buffer owned by the caller; the module aliases it.
+  {
+    std::shared_ptr<void> buffer(c10::alloc_cpu(model.size()), c10::free_cpu);
+    std::memcpy(buffer.get(), model.data(), model.size());
+    mobile::Module bc =
+        _load_for_mobile_from_buffer(buffer.get(), model.size());
+    ASSERT_TRUE(bc.forward({input}).toTensor().equal(ref));
+    auto weight = bc.run_method("get_weight", {}).toTensor();
+    ASSERT_TRUE(within(
+        weight, static_cast<const char*>(buffer.get()), model.size()));
+  }
+
+  // A buffer shared with the module, which keeps it alive.
+  at::Tensor weight;
+  {
+    std::shared_ptr<void> buffer(c10::alloc_cpu(model.size()), c10::free_cpu);
+    std::memcpy(buffer.get(), model.data(), model.size());
+    mobile::Module bc = _load_for_mobile_from_buffer(
+        buffer.get(), model.size(), c10::nullopt, buffer);
+    weight = bc.run_method("get_weight", {}).toTensor();
+  }
+  ASSERT_TRUE(weight.mul(input).equal(ref));
+
+  // A mapped file.
+  const std::string file_name = "lite_interpreter_zero_copy_load.ptl";
+  {
+    std::ofstream file(file_name, std::ios::binary);
+    file << model;
+  }
+  {
+    mobile::Module bc = _load_for_mobile_mmapped(file_name);
+    ASSERT_TRUE(bc.forward({input}).toTensor().equal(ref));
+    ASSERT_TRUE(caffe2::serialize::isMmapFileData(
+        bc.run_method("get_weight", {}).toTensor().storage().data_ptr()));
+  }
+  std::remove(file_name.c_str());
+}
+
 namespace {
 static auto reg =
     torch::class_<TorchBindLiteInterpreterTestStruct>(
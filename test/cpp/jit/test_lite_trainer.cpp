@@ -6,6 +6,7 @@
 #include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/mobile/import_data.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/optim/adam.h>
 #include <torch/csrc/jit/mobile/optim/sgd.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/torch.h>
@@ -183,5 +184,104 @@ void testLiteSGD() {
   AT_ASSERT(parameters[0].item<float>() == bc_parameters[0].item<float>());
 }
 
+namespace {
+// Trains y = foo * x + 1 towards y = 2 x + 1 with the lite interpreter and
+// returns the trained parameter. Every step accumulates the gradients of two
+// micro-batches, and the parameter and gradient buffers must not move.
+template <typename Optimizer, typename Options>
+Tensor trainLiteModel(const Options& options) {
+  Module m("m");
+  m.register_parameter("foo", torch::ones({4}, at::requires_grad()), false);
+  m.define(R"(
+    def forward(self, x):
+      b = 1.0
+      return self.foo * x + b
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  std::vector<at::Tensor> bc_parameters = bc.parameters();
+  Optimizer optimizer(bc_parameters, options);
+  const void* param_data = bc_parameters[0].data_ptr();
+  const void* grad_data = nullptr;
+  for (int epoc = 0; epoc < 10; ++epoc) {
+    optimizer.zero_grad();
+    for (int micro_batch = 0; micro_batch < 2; ++micro_batch) {
+      auto source = torch::arange(1, 5, at::kFloat) * (micro_batch + 1);
+      std::vector<IValue> train_inputs{source};
+      auto output = bc.forward(train_inputs).toTensor();
+      auto loss = ::torch::mse_loss(output, 2 * source + 1);
+      loss.backward();
+    }
+    if (grad_data == nullptr) {
+      grad_data = bc_parameters[0].grad().data_ptr();
+    }
+    AT_ASSERT(bc_parameters[0].grad().data_ptr() == grad_data);
+    optimizer.step();
+    AT_ASSERT(bc_parameters[0].data_ptr() == param_data);
+  }
+  return bc_parameters[0].detach().clone();
+}
+} // namespace
+
+void testLiteAdam() {
+  double learning_rate = 0.1, weight_decay = 0.01;
+  // Reference: Full jit and torch::optim::Adam
+  Module m("m");
+  m.register_parameter("foo", torch::ones({4}, at::requires_grad()), false);
+  m.define(R"(
+    def forward(self, x):
+      b = 1.0
+      return self.foo * x + b
+  )");
+  std::stringstream ms;
+  m.save(ms);
+  auto mm = load(ms);
+  std::vector<at::Tensor> parameters;
+  for (auto parameter : mm.parameters()) {
+    parameters.emplace_back(parameter);
+  }
+  ::torch::optim::Adam optimizer(
+      parameters,
+      ::torch::optim::AdamOptions(learning_rate).weight_decay(weight_decay));
+  for (int epoc = 0; epoc < 10; ++epoc) {
+    optimizer.zero_grad();
+    for (int micro_batch = 0; micro_batch < 2; ++micro_batch) {
+      auto source = torch::arange(1, 5, at::kFloat) * (micro_batch + 1);
+      std::vector<IValue> train_inputs{source};
+      auto output = mm.forward(train_inputs).toTensor();
+      auto loss = ::torch::mse_loss(output, 2 * source + 1);
+      loss.backward();
+    }
+    optimizer.step();
+  }
+
+  auto options =
+      mobile::AdamOptions(learning_rate).weight_decay(weight_decay);
+  auto trained = trainLiteModel<mobile::Adam>(options);
+  AT_ASSERT(torch::allclose(parameters[0], trained));
+  auto trained_fused =
+      trainLiteModel<mobile::Adam>(mobile::AdamOptions(options).fused(true));
+  AT_ASSERT(torch::allclose(parameters[0], trained_fused));
+  auto trained_amsgrad = trainLiteModel<mobile::Adam>(
+      mobile::AdamOptions(options).amsgrad(true));
+  auto trained_amsgrad_fused = trainLiteModel<mobile::Adam>(
+      mobile::AdamOptions(options).amsgrad(true).fused(true));
+  AT_ASSERT(torch::allclose(trained_amsgrad, trained_amsgrad_fused));
+}
+
+void testLiteFusedSGD() {
+  auto options = mobile::SGDOptions(0.01).momentum(0.9).weight_decay(0.01);
+  auto trained = trainLiteModel<mobile::SGD>(options);
+  auto trained_fused =
+      trainLiteModel<mobile::SGD>(mobile::SGDOptions(options).fused(true));
+  AT_ASSERT(torch::allclose(trained, trained_fused));
+  auto trained_nesterov = trainLiteModel<mobile::SGD>(
+      mobile::SGDOptions(options).nesterov(true));
+  auto trained_nesterov_fused = trainLiteModel<mobile::SGD>(
+      mobile::SGDOptions(options).nesterov(true).fused(true));
+  AT_ASSERT(torch::allclose(trained_nesterov, trained_nesterov_fused));
+}
+
 } // namespace jit
 } // namespace torch
@@ -64,6 +64,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -106,6 +107,38 @@ void testInternedStrings() {
   ASSERT_EQ(Symbol(symstart + 2).toUnqualString(), std::string("What2"));
 }
 
+void testInternedStringsConcurrent() {
+  // lookups of existing symbols don't lock and must see a consistent table
+  // while other threads intern new ones
+  constexpr int kThreads = 8;
+  constexpr int kSymbolsPerThread = 200;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<Symbol>> symbols(kThreads);
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([i, &symbols]() {
+      for (int j = 0; j < kSymbolsPerThread; ++j) {
+        // every thread also interns the shared names to race on the slow path
+        std::string name = "interned_concurrent_" + std::to_string(j % 2 == 0 ? j : i * kSymbolsPerThread + j);
+        Symbol sym = Symbol::aten(name);
+        ASSERT_EQ(sym.toUnqualString(), name);
+        ASSERT_EQ(prim::Param, Symbol::prim("Param"));
+        symbols[i].push_back(sym);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (int i = 0; i < kThreads; ++i) {
+    for (int j = 0; j < kSymbolsPerThread; ++j) {
+      std::string name = "interned_concurrent_" + std::to_string(j % 2 == 0 ? j : i * kSymbolsPerThread + j);
+      ASSERT_EQ(symbols[i][j], Symbol::fromQualString("aten::" + name));
+      ASSERT_EQ(symbols[i][j].toQualString(), "aten::" + name);
+      ASSERT_EQ(symbols[i][j].ns(), namespaces::aten);
+    }
+  }
+}
+
 void testFromQualString() {
   ASSERT_EQ(Symbol::fromQualString("prim::Param"), Symbol::prim("Param"));
   ASSERT_EQ(Symbol::fromQualString("aten::mm"), Symbol::aten("mm"));
@@ -929,6 +962,37 @@ void testRecordFunction() {
   TORCH_CHECK(sampled_cb_ctr == 1000);
   clearCallbacks();
 
+  // test the checks done before constructing RecordFunction
+  bool pre_sampled = false;
+  TORCH_CHECK(!shouldRunRecordFunction(&pre_sampled));
+  std::thread tls_thread([]() {
+    addThreadLocalCallback(RecordFunctionCallback(
+        [](const RecordFunction&) {}, [](const RecordFunction&) {}));
+    bool tls_pre_sampled = false;
+    TORCH_CHECK(shouldRunRecordFunction(&tls_pre_sampled));
+    TORCH_CHECK(!tls_pre_sampled);
+  });
+  tls_thread.join();
+  // callbacks of the other thread are gone with it
+  TORCH_CHECK(!shouldRunRecordFunction(&pre_sampled));
+
+  // test sampling when all the callbacks are sampled
+  sampled_cb_ctr = 0;
+  int other_sampled_cb_ctr = 0;
+  setup_sampled_callback(0.5);
+  addGlobalCallback(RecordFunctionCallback(
+                        [&other_sampled_cb_ctr](const RecordFunction& fn) {
+                          if (std::string(fn.name().str()) == "test") {
+                            ++other_sampled_cb_ctr;
+                          }
+                        },
+                        [](const RecordFunction&) {})
+                        .samplingProb(0.1));
+  run_test_function();
+  TORCH_CHECK(sampled_cb_ctr > 300 && sampled_cb_ctr < 700);
+  TORCH_CHECK(other_sampled_cb_ctr > 0 && other_sampled_cb_ctr < 300);
+  clearCallbacks();
+
   // test the scope of the callbacks
   checkScopeCallbacks();
   clearCallbacks();
@@ -1,5 +1,6 @@
 #include <test/cpp/jit/test_base.h>
 #include <test/cpp/jit/test_utils.h>
+#include <cstdio>
 #include <sstream>
 
 #include <torch/csrc/jit/serialization/export.h>
@@ -8,6 +9,7 @@
 #include <torch/torch.h>
 
 #include "caffe2/serialize/istream_adapter.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 namespace torch {
 namespace jit {
@@ -121,5 +123,124 @@ void testTypeTags() {
   }
 }
 
+void testPickleSavePackedStorages() {
+  auto dict = c10::Dict<std::string, at::Tensor>();
+  for (int64_t i = 0; i < 8; i++) {
+    dict.insert("small" + std::to_string(i), torch::rand({i + 1}));
+  }
+  auto base = torch::rand({4, 4});
+  dict.insert("view", base.slice(/*dim=*/0, 1, 3));
+  dict.insert("base", base);
+  dict.insert("large", torch::rand({4, 4096}));
+  dict.insert("int", torch::arange(5));
+
+  auto loaded =
+      torch::pickle_load(torch::pickle_save(dict, /*pack_storages_below=*/1024))
+          .toGenericDict();
+  ASSERT_EQ(loaded.size(), dict.size());
+  for (const auto& entry : dict) {
+    auto loaded_tensor = loaded.at(entry.key()).toTensor();
+    ASSERT_EQ(loaded_tensor.sizes(), entry.value().sizes());
+    ASSERT_EQ(loaded_tensor.strides(), entry.value().strides());
+    ASSERT_TRUE(loaded_tensor.equal(entry.value()));
+  }
+
+  // Small float storages share one, views keep sharing theirs, and storages
+  // that are too large or alone in their dtype are saved as they are.
+  auto storage_of = [&](const std::string& key) {
+    return loaded.at(key).toTensor().storage().unsafeGetStorageImpl();
+  };
+  for (int64_t i = 1; i < 8; i++) {
+    ASSERT_EQ(storage_of("small" + std::to_string(i)), storage_of("small0"));
+  }
+  ASSERT_EQ(storage_of("base"), storage_of("small0"));
+  ASSERT_EQ(storage_of("view"), storage_of("base"));
+  ASSERT_NE(storage_of("large"), storage_of("small0"));
+  ASSERT_EQ(
+      loaded.at("int").toTensor().storage().nbytes(),
+      dict.at("int").storage().nbytes());
+
+  // Without a limit nothing is packed.
+  auto unpacked = torch::pickle_load(torch::pickle_save(dict)).toGenericDict();
+  ASSERT_NE(
+      unpacked.at("small0").toTensor().storage().unsafeGetStorageImpl(),
+      unpacked.at("small1").toTensor().storage().unsafeGetStorageImpl());
+}
+
+void testLoadMmapped() {
+  const std::string file_name = "load_mmapped.pt";
+  Module m("m");
+  // Large enough to span whole pages, which are what eviction drops.
+  auto weight = torch::rand({4, 4096});
+  m.register_parameter("weight", weight, false);
+  m.define(R"(
+    def forward(self, x):
+        return self.weight * x
+  )");
+  m.save(file_name);
+
+  {
+    auto loaded = load_mmapped(file_name);
+    auto loaded_weight = loaded.attr("weight").toTensor();
+    ASSERT_TRUE(caffe2::serialize::isMmapFileData(
+        loaded_weight.storage().data_ptr()));
+    ASSERT_TRUE(loaded_weight.equal(weight));
+
+    // Evicted tensors are read from the file again.
+    ASSERT_NE(evict_mmapped_tensors(loaded), 0);
+    ASSERT_TRUE(loaded_weight.equal(weight));
+    auto x = torch::rand({4, 4096});
+    ASSERT_TRUE(loaded.forward({x}).toTensor().equal(weight * x));
+
+    // Changes are private to the module.
+    loaded_weight.zero_();
+    auto reloaded = torch::jit::load(file_name);
+    ASSERT_TRUE(reloaded.attr("weight").toTensor().equal(weight));
+  }
+  std::remove(file_name.c_str());
+}
+
+void testTensorRecordSharing() {
+#ifdef __linux__
+  // Large enough to be shared.
+  auto weight = torch::rand({4, 4096});
+  auto save = [&](const at::Tensor& bias) {
+    Module m("m");
+    m.register_parameter("weight", weight, false);
+    m.register_parameter("bias", bias, false);
+    std::stringstream ss;
+    m.save(ss);
+    return ss;
+  };
+  auto ss_a = save(torch::rand({4, 4096}));
+  auto ss_b = save(torch::rand({4, 4096}));
+
+  const bool old_state = getTensorRecordSharing();
+  getTensorRecordSharing() = true;
+  const size_t old_bytes = sharedTensorRecordBytes();
+  {
+    auto a = torch::jit::load(ss_a);
+    auto b = torch::jit::load(ss_b);
+    // The weights are shared, the biases are not identical.
+    ASSERT_EQ(
+        sharedTensorRecordBytes() - old_bytes, 3 * weight.nbytes());
+    auto weight_a = a.attr("weight").toTensor();
+    auto weight_b = b.attr("weight").toTensor();
+    ASSERT_TRUE(weight_a.equal(weight));
+    ASSERT_TRUE(weight_b.equal(weight));
+
+    // Changes are private to the module.
+    weight_a.zero_();
+    ASSERT_TRUE(weight_b.equal(weight));
+    ss_b.seekg(0);
+    auto c = torch::jit::load(ss_b);
+    ASSERT_TRUE(c.attr("weight").toTensor().equal(weight));
+  }
+  // Records are freed with the modules that use them.
+  ASSERT_EQ(sharedTensorRecordBytes(), old_bytes);
+  getTensorRecordSharing() = old_state;
+#endif
+}
+
 } // namespace jit
 } // namespace torch
@@ -0,0 +1,130 @@
+#include <test/cpp/jit/test_base.h>
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+#include <torch/torch.h>
+
+namespace torch {
+namespace jit {
+
+void testStaticRuntime() {
+  Module m("m");
+  m.register_parameter("w", torch::randn({4, 3}), false);
+  m.register_parameter("b", torch::randn({3}), false);
+  m.define(R"(
+    def forward(self, x):
+        h = torch.relu(torch.addmm(self.b, x, self.w))
+        y = torch.sigmoid(h) * h + x.mm(self.w)
+        return y, h.t()
+  )");
+  m.eval();
+
+  StaticRuntime runtime(m);
+  // addmm, relu, sigmoid, mul, mm and add
+  ASSERT_EQ(runtime.numOutVariantNodes(), 6);
+
+  auto x1 = torch::randn({2, 4});
+  auto expected1 = m.forward({x1}).toTuple()->elements();
+  auto outputs1 = runtime.run(std::vector<at::Tensor>{x1});
+  ASSERT_EQ(outputs1.size(), 2);
+  ASSERT_TRUE(outputs1[0].allclose(expected1[0].toTensor()));
+  ASSERT_TRUE(outputs1[1].allclose(expected1[1].toTensor()));
+
+  // the outputs of the first run, including the view of an intermediate,
+  // are not written to by the second
+  std::vector<at::Tensor> copies1 = {outputs1[0].clone(), outputs1[1].clone()};
+  auto x2 = torch::randn({2, 4});
+  auto expected2 = m.forward({x2}).toTuple()->elements();
+  auto outputs2 = runtime.run(std::vector<at::Tensor>{x2});
+  ASSERT_TRUE(outputs2[0].allclose(expected2[0].toTensor()));
+  ASSERT_TRUE(outputs2[1].allclose(expected2[1].toTensor()));
+  ASSERT_TRUE(outputs1[0].equal(copies1[0]));
+  ASSERT_TRUE(outputs1[1].equal(copies1[1]));
+
+  // shapes may change between runs
+  auto x3 = torch::randn({5, 4});
+  auto expected3 = m.forward({x3}).toTuple()->elements();
+  auto outputs3 = runtime.run(std::vector<at::Tensor>{x3});
+  ASSERT_TRUE(outputs3[0].allclose(expected3[0].toTensor()));
+}
+
+void testStaticRuntimeOutVariants() {
+  Module m("m");
+  m.register_parameter("w", torch::randn({4}), false);
+  m.register_parameter("b", torch::randn({4}), false);
+  m.define(R"(
+    def forward(self, x, y):
+        a = torch.layer_norm(x, [4], self.w, self.b)
+        b = torch._C._nn.gelu(torch.softmax(a, 1))
+        c = torch.cat([torch.clamp(b, 0.1, 0.9), y], 1)
+        return c / (c * c)
+  )");
+  m.eval();
+
+  StaticRuntime runtime(m);
+  // all but the list construction
+  ASSERT_EQ(runtime.numOutVariantNodes(), 7);
+  for (int i = 0; i < 3; i++) {
+    auto x = torch::randn({3, 4});
+    auto y = torch::rand({3, 2}) + 1;
+    auto expected = m.forward({x, y}).toTensor();
+    auto output = runtime.run(std::vector<at::Tensor>{x, y});
+    ASSERT_TRUE(output[0].allclose(expected));
+  }
+}
+
+void testStaticRuntimeMemoryPlanning() {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+        a = torch.relu(x + x)
+        b = torch.tanh(torch.sigmoid(a))
+        return (b * b).sum()
+  )");
+  m.eval();
+
+  StaticRuntime runtime(m);
+  // the first run learns the sizes
+  ASSERT_EQ(runtime.plannedArenaBytes(), 0);
+  auto x = torch::randn({64, 64});
+  auto expected = m.forward({x}).toTensor();
+  ASSERT_TRUE(runtime.run(std::vector<at::Tensor>{x})[0].allclose(expected));
+  // the five intermediates fit in two tensors, as each only lives until the
+  // next op
+  const size_t nbytes = x.numel() * x.element_size();
+  ASSERT_EQ(runtime.plannedArenaBytes(), 2 * nbytes);
+  for (int i = 0; i < 2; i++) {
+    x = torch::randn({64, 64});
+    expected = m.forward({x}).toTensor();
+    ASSERT_TRUE(runtime.run(std::vector<at::Tensor>{x})[0].allclose(expected));
+    ASSERT_EQ(runtime.plannedArenaBytes(), 2 * nbytes);
+  }
+
+  // larger inputs grow the arena
+  x = torch::randn({128, 64});
+  expected = m.forward({x}).toTensor();
+  ASSERT_TRUE(runtime.run(std::vector<at::Tensor>{x})[0].allclose(expected));
+  ASSERT_EQ(runtime.plannedArenaBytes(), 4 * nbytes);
+  ASSERT_TRUE(runtime.run(std::vector<at::Tensor>{x})[0].allclose(expected));
+
+  StaticRuntimeOptions options;
+  options.plan_memory = false;
+  StaticRuntime unplanned(m, options);
+  ASSERT_TRUE(unplanned.run(std::vector<at::Tensor>{x})[0].allclose(expected));
+  ASSERT_EQ(unplanned.plannedArenaBytes(), 0);
+}
+
+void testStaticRuntimeControlFlow() {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+        if bool(x.sum() > 0):
+            x = x + 1
+        return x
+  )");
+  m.eval();
+  ASSERT_THROWS_WITH(StaticRuntime(m), "control flow");
+}
+
+} // namespace jit
+} // namespace torch
@@ -26,6 +26,7 @@ namespace jit {
   _(DifferentiateWithRequiresGrad)     \
   _(FromQualString)                    \
   _(InternedStrings)                   \
+  _(InternedStringsConcurrent)         \
   _(PassManagement)                    \
   _(Proto)                             \
   _(RegisterFusionCachesKernel)        \
@@ -54,6 +55,8 @@ namespace jit {
   _(PeepholeOptimize)                  \
   _(RecordFunction)                    \
   _(ThreadLocalDebugInfo)              \
+  _(InterpreterTaskLauncher)           \
+  _(PriorityTaskPool)                  \
   _(SubgraphMatching)                  \
   _(SubgraphRewriter)                  \
   _(ModuleClone)                       \
@@ -69,7 +72,14 @@ namespace jit {
   _(ScriptObject)                      \
   _(ExtraFilesHookPreference)          \
   _(SaveExtraFilesHook)                \
+  _(LoadMmapped)                       \
+  _(TensorRecordSharing)               \
+  _(StaticRuntime)                     \
+  _(StaticRuntimeOutVariants)          \
+  _(StaticRuntimeMemoryPlanning)       \
+  _(StaticRuntimeControlFlow)          \
   _(TypeTags)                          \
+  _(PickleSavePackedStorages)          \
   _(DCE)                               \
   _(CustomFusionNestedBlocks)          \
   _(ClassDerive)                       \
@@ -97,10 +107,17 @@ namespace jit {
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
   _(LiteInterpreterDict)               \
+  _(LiteInterpreterZeroCopyLoad)       \
+  _(LiteInterpreterRegisterCalls)      \
+  _(LiteInterpreterOpLatencies)        \
+  _(LiteInterpreterLazyMethods)        \
   _(MobileNamedParameters)             \
   _(MobileSaveLoadData)                \
   _(LiteSGD)                           \
-  _(FusionAliasing)
+  _(LiteAdam)                          \
+  _(LiteFusedSGD)                      \
+  _(FusionAliasing)                    \
+  _(KernelDiskCache)
 
 #if defined(USE_CUDA)
 #define TH_FORALL_TESTS_CUDA(_)   \
@@ -150,3 +150,26 @@ TEST(TensorpipeSerialize, NoDeleterTensors) {
           t2.storage().data(),
           sendingTpMessage.tensors[1].length) == 0);
 }
+
+TEST(TensorpipeSerialize, TargetDevices) {
+  at::Tensor t1 = torch::ones({16}, at::ScalarType::Float);
+  at::Tensor t2 = torch::ones({16}, at::ScalarType::Float);
+  std::vector<at::Tensor> tensors{t1, t2};
+  std::vector<char> payload = {'1', '2', '3'};
+  torch::distributed::rpc::Message sendingRpcMessage(
+      std::move(payload),
+      std::move(tensors),
+      torch::distributed::rpc::MessageType::UNKNOWN);
+
+  tensorpipe::Message sendingTpMessage;
+  torch::distributed::rpc::TensorpipeWriteBuffers tpBuffers;
+  std::tie(sendingTpMessage, tpBuffers) =
+      torch::distributed::rpc::tensorpipeSerialize(
+          std::move(sendingRpcMessage),
+          {c10::Device(c10::kCUDA, 1), c10::Device(c10::kCPU)});
+
+  // Only tensors that go to a GPU carry their target device.
+  EXPECT_EQ(sendingTpMessage.tensors.size(), 2);
+  EXPECT_EQ(sendingTpMessage.tensors[0].metadata, "cuda:1");
+  EXPECT_EQ(sendingTpMessage.tensors[1].metadata, "");
+}
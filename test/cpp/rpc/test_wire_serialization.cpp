@@ -49,6 +49,45 @@ TEST(WireSerialize, RecopySparseTensors) {
   EXPECT_LT(ser.size(), (tiny.element_size() * k1K) + k1K);
 }
 
+TEST(WireSerialize, Segments) {
+  auto run = [](const std::string& payload,
+                const std::vector<at::Tensor>& tensors) {
+    std::vector<char> mpayload(payload.begin(), payload.end());
+    auto ser = torch::distributed::rpc::wireSerializeSegments(mpayload, tensors);
+    auto sizes = torch::distributed::rpc::wireSegmentSizes(
+        ser.header.data(), ser.header.size());
+    EXPECT_EQ(ser.segments.size(), sizes.size());
+    // The segments alias the storages, and the header doesn't hold them.
+    for (size_t i = 0; i < ser.segments.size(); ++i) {
+      EXPECT_EQ(ser.segments[i].numel(), sizes[i]);
+      EXPECT_EQ(ser.segments[i].data_ptr(), tensors[i].storage().data());
+    }
+    EXPECT_LT(ser.header.size(), payload.size() + 1024);
+
+    // As a transport would receive them.
+    std::vector<at::Tensor> received;
+    std::vector<void*> receivedData;
+    for (auto size : sizes) {
+      received.push_back(torch::empty({size}, {torch::kByte}));
+      received.back().copy_(ser.segments[received.size() - 1]);
+      receivedData.push_back(received.back().data_ptr());
+    }
+    auto deser = torch::distributed::rpc::wireDeserializeSegments(
+        ser.header.data(), ser.header.size(), std::move(received));
+    EXPECT_EQ(payload, std::string(deser.first.begin(), deser.first.end()));
+    EXPECT_EQ(tensors.size(), deser.second.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      EXPECT_TRUE(torch::equal(tensors[i], deser.second[i]));
+      EXPECT_EQ(deser.second[i].storage().data(), receivedData[i]);
+    }
+  };
+  run("", {});
+  run("hi", {});
+  run("", {torch::randn({5, 5})});
+  run("more", {torch::randn({5, 5}), torch::rand({10, 10})});
+  run("empty", {torch::randn({0}), torch::randn({3})});
+}
+
 TEST(WireSerialize, CloneSparseTensors) {
   constexpr size_t k1K = 1024;
   at::Tensor big = torch::randn({k1K, k1K});
@@ -261,5 +261,114 @@ void testKernel_4() {
   }
 }
 
+void testKernelSymbolicBatchDim() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%0 : Float(5:3,3:1, device=cpu),
+            %1 : Float(5:3,3:1, device=cpu)):
+        %2 : Float(5:3,3:1) = aten::mul(%0, %1)
+        %3 : Float(5:3,3:1) = aten::add(%0, %2, %0)
+        return (%3))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  TensorExprKernel k(graph);
+  ASSERT_TRUE(k.hasSymbolicBatchDim());
+  for (int64_t batch : {5, 1, 17}) {
+    auto a = at::rand({batch, 3}, TensorOptions(kCPU).dtype(at::kFloat));
+    auto b = at::rand({batch, 3}, TensorOptions(kCPU).dtype(at::kFloat));
+    auto ref = a + a * a * b;
+    std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{a, b});
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_EQ(o.size(0), batch);
+    ASSERT_EQ(o.size(1), 3);
+    ASSERT_TRUE(at::allclose(o, ref));
+  }
+  // Other batch sizes do not need another kernel.
+  ASSERT_EQ(k.numSpecializations(), 0);
+}
+
+void testKernelSpecializations() {
+  KernelScope kernel_scope;
+
+  // The batch size could be broadcast, so it is not made symbolic.
+  const auto graph_string = R"IR(
+      graph(%0 : Float(1:3,3:1, device=cpu),
+            %1 : Float(1:3,3:1, device=cpu)):
+        %2 : Float(1:3,3:1) = aten::mul(%0, %1)
+        return (%2))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto oldCacheSize = getTEKernelCacheSize();
+  getTEKernelCacheSize() = 2;
+  TensorExprKernel k(graph);
+  ASSERT_FALSE(k.hasSymbolicBatchDim());
+  auto runWithSizes = [&](at::IntArrayRef sizes) {
+    auto a = at::rand(sizes, TensorOptions(kCPU).dtype(at::kFloat));
+    auto b = at::rand(sizes, TensorOptions(kCPU).dtype(at::kFloat));
+    std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{a, b});
+    k.run(stack);
+    auto o = stack[0].toTensor();
+    ASSERT_EQ(o.sizes(), sizes);
+    ASSERT_TRUE(at::allclose(o, a * b));
+  };
+  runWithSizes({1, 3});
+  ASSERT_EQ(k.numSpecializations(), 0);
+  runWithSizes({4, 7});
+  runWithSizes({4, 7});
+  ASSERT_EQ(k.numSpecializations(), 1);
+  runWithSizes({2, 2});
+  runWithSizes({6, 6});
+  // The least recently used specialization was evicted.
+  ASSERT_EQ(k.numSpecializations(), 2);
+  runWithSizes({4, 7});
+  ASSERT_EQ(k.numSpecializations(), 2);
+  getTEKernelCacheSize() = oldCacheSize;
+}
+
+void testKernelReductions() {
+  KernelScope kernel_scope;
+
+  const auto graph_string = R"IR(
+      graph(%x : Float(4:8, 8:1, device=cpu),
+            %w : Float(8:1, device=cpu),
+            %b : Float(8:1, device=cpu)):
+        %one : int = prim::Constant[value=1]()
+        %last : int = prim::Constant[value=-1]()
+        %dims : int[] = prim::Constant[value=[1]]()
+        %keepdim : bool = prim::Constant[value=1]()
+        %normalized_shape : int[] = prim::Constant[value=[8]]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %cudnn_enable : bool = prim::Constant[value=0]()
+        %none : NoneType = prim::Constant()
+        %y : Float(4:8, 8:1) = aten::add(%x, %b, %one)
+        %n : Float(4:8, 8:1) = aten::layer_norm(%y, %normalized_shape, %w, %b, %eps, %cudnn_enable)
+        %r : Float(4:8, 8:1) = aten::relu(%n)
+        %s : Float(4:8, 8:1) = aten::softmax(%y, %last, %none)
+        %m : Float(4:1, 1:1) = aten::mean(%y, %dims, %keepdim, %none)
+        %c : Float(4:8, 8:1) = aten::sub(%y, %m, %one)
+        return (%r, %s, %c))IR";
+  auto graph = std::make_shared<Graph>();
+  parseIR(graph_string, &*graph);
+
+  auto x = at::rand({4, 8}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto w = at::rand({8}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto b = at::rand({8}, TensorOptions(kCPU).dtype(at::kFloat));
+  auto y = x + b;
+  auto ref_r = at::relu(at::layer_norm(y, {8}, w, b));
+  auto ref_s = at::softmax(y, -1);
+  auto ref_c = y - y.mean({1}, /*keepdim=*/true);
+
+  TensorExprKernel k(graph);
+  std::vector<IValue> stack = fmap<IValue>(std::vector<at::Tensor>{x, w, b});
+  k.run(stack);
+  ASSERT_TRUE(at::allclose(stack[0].toTensor(), ref_r, 1e-5, 1e-5));
+  ASSERT_TRUE(at::allclose(stack[1].toTensor(), ref_s, 1e-5, 1e-5));
+  ASSERT_TRUE(at::allclose(stack[2].toTensor(), ref_c, 1e-5, 1e-5));
+}
+
 } // namespace jit
 } // namespace torch
@@ -1211,6 +1211,37 @@ void testLLVMDynamicShape2D() {
   testWithSize(37, 11);
 }
 
+void testLLVMParallelFor() {
+  KernelScope kernel_scope;
+  auto testWithSize = [](int32_t M, int32_t N) {
+    VarHandle m("m", kInt);
+    VarHandle n("n", kInt);
+    Buffer a(BufHandle("a", {m, n}, kFloat));
+    Tensor* b = Compute(
+        "b", {{m, "m"}, {n, "n"}}, [&](const VarHandle& i, const VarHandle& j) {
+          return a(i, j) * 2.0f + i;
+        });
+    LoopNest l({b});
+    std::vector<For*> loops = l.getLoopStmtsFor(b);
+    l.setParallel(loops[0]);
+    l.prepareForCodegen();
+    Stmt* s = l.root_stmt();
+    LLVMCodeGen cg(s, {a, b, m, n});
+    std::vector<float> aData(M * N, 1.0f);
+    std::vector<float> bData(M * N, 0.0f);
+    cg.call({aData, bData, M, N});
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        ASSERT_EQ(bData[i * N + j], 2.0f + i);
+      }
+    }
+  };
+  testWithSize(1, 8);
+  testWithSize(37, 11);
+  // Large enough to be split between threads.
+  testWithSize(20000, 8);
+}
+
 void testLLVMEmptyStmt() {
   KernelScope kernel_scope;
   Stmt* s = new Block({});
@@ -61,5 +61,36 @@ void testFuserPass_2() {
       ->run(*g);
 }
 
+void testFuserPass_Reductions() {
+  KernelScope kernel_scope;
+  const auto graph_string = R"IR(
+    graph(%x : Float(4:8, 8:1, device=cpu),
+          %w : Float(8:1, device=cpu),
+          %b : Float(8:1, device=cpu)):
+      %one : int = prim::Constant[value=1]()
+      %normalized_shape : int[] = prim::Constant[value=[8]]()
+      %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+      %cudnn_enable : bool = prim::Constant[value=0]()
+      %y : Float(4:8, 8:1, device=cpu) = aten::add(%x, %b, %one)
+      %n : Float(4:8, 8:1, device=cpu) = aten::layer_norm(%y, %normalized_shape, %w, %b, %eps, %cudnn_enable)
+      %r : Float(4:8, 8:1, device=cpu) = aten::relu(%n)
+      return (%r))IR";
+  auto g = std::make_shared<Graph>();
+  torch::jit::parseIR(graph_string, g.get());
+
+  g->lint();
+  FuseTensorExprs(g);
+
+  // The bias add, the layer norm and the relu end up in one kernel.
+  size_t groups = 0;
+  for (Node* n : g->nodes()) {
+    ASSERT_TRUE(n->kind() != aten::layer_norm);
+    if (n->kind() == Symbol::fromQualString("tensorexpr::Group")) {
+      groups++;
+    }
+  }
+  ASSERT_EQ(groups, 1);
+}
+
 } // namespace jit
 } // namespace torch
@@ -213,8 +213,12 @@ namespace jit {
   _(Kernel_2)                               \
   _(Kernel_3)                               \
   _(Kernel_4)                               \
+  _(KernelSymbolicBatchDim)                 \
+  _(KernelSpecializations)                  \
+  _(KernelReductions)                       \
   _(FuserPass_1)                            \
-  _(FuserPass_2)
+  _(FuserPass_2)                            \
+  _(FuserPass_Reductions)
 
 #define TH_FORALL_TENSOREXPR_TESTS_LLVM(_) \
   _(LLVMByteImmTest)                       \
@@ -332,6 +336,7 @@ namespace jit {
   _(LLVMBindDynamicShapeAdd)               \
   _(LLVMTensorDynamicShapeAdd)             \
   _(LLVMDynamicShape2D)                    \
+  _(LLVMParallelFor)                       \
   _(LLVMEmptyStmt)                         \
   _(LLVMEliminatedStmt)                    \
   _(LLVMIfThenElseTest)                    \
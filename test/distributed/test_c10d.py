@@ -215,6 +215,15 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_get_set(self, fs):
+        fs.multi_set(["mkey0", "mkey1"], ["value0", "value1"])
+        fs.set("mkey2", "value2")
+        self.assertEqual([b"value0", b"value1", b"value2"], fs.multi_get(["mkey0", "mkey1", "mkey2"]))
+        self.assertEqual([], fs.multi_get([]))
+
+    def test_multi_get_set(self):
+        self._test_multi_get_set(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -273,6 +282,16 @@ class TCPStoreTest(TestCase, StoreTestBase):
             store1 = c10d.TCPStore(addr, port, 1, True)  # noqa: F841
             store2 = c10d.TCPStore(addr, port, 1, True)  # noqa: F841
 
+    def test_compare_set(self):
+        store = self._create_store()
+        self.assertEqual(b"value0", store.compare_set("cs_key", "", "value0"))
+        self.assertEqual(b"value0", store.compare_set("cs_key", "wrong", "value1"))
+        self.assertEqual(b"value1", store.compare_set("cs_key", "value0", "value1"))
+        self.assertEqual(b"value1", store.get("cs_key"))
+        # A key that isn't set is only set for an empty expected value
+        self.assertEqual(b"expected", store.compare_set("cs_missing", "expected", "value"))
+        self.assertEqual([b"value1"], store.multi_get(["cs_key"]))
+
 
 class PrefixTCPStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -608,6 +627,29 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         for work in [pg.allreduce(torch.ones(i + 1)) for i in range(4)]:
             work.wait()
 
+    def test_striped_allreduce(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = c10d.ProcessGroupGloo.Options()
+        opts.timeout = 5.0
+        opts.devices = [
+            c10d.ProcessGroupGloo.create_device(interface=LOOPBACK)
+            for _ in range(3)
+        ]
+        opts.threads = 4
+        opts.allreduce_stripe_min_bytes = 16
+        opts.allreduce_ring_min_bytes = 64
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Sizes that split evenly and unevenly in 3 stripes, both below and
+        # above the stripe and ring thresholds
+        for numel in [1, 6, 7, 100, 1001]:
+            x = torch.arange(numel, dtype=torch.float) + self.rank
+            work = pg.allreduce(x)
+            work.wait()
+            expected = (torch.arange(numel, dtype=torch.float) * self.world_size
+                        + sum(range(self.world_size)))
+            self.assertEqual(expected, x)
+
     def test_empty_tensors(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -894,6 +936,21 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         inputs = [2 * [torch.tensor([i + self.rank])] for i in range(1000)]
         self._test_allreduce_coalesced_stress(inputs)
 
+    def test_broadcast_coalesced_basics(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        with self.assertRaisesRegex(ValueError, "tensors must all have the same type"):
+            pg.broadcast_coalesced([torch.zeros(1), torch.zeros(1, dtype=torch.float64)])
+
+        for root in range(self.world_size):
+            tensors = [torch.full((i + 1, 2), float(self.rank)) for i in range(5)]
+            opts = c10d.BroadcastOptions()
+            opts.rootRank = root
+            pg.broadcast_coalesced(tensors, opts).wait()
+            for i, tensor in enumerate(tensors):
+                self.assertEqual(tensor, torch.full((i + 1, 2), float(root)))
+
     def test_sparse_allreduce_checks(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -2422,6 +2479,58 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         )
         run_and_verify_grad(gpu_model)
 
+    @requires_gloo()
+    def test_adaptive_bucketing_cpu(self):
+        """
+        Re-planning buckets while training must not change the gradients. The
+        module takes a different branch every other iteration, so the ready
+        order changes and so does the plan.
+        """
+        class BranchModule(nn.Module):
+            def __init__(self):
+                super(BranchModule, self).__init__()
+                self.fc1 = nn.Linear(8, 8, bias=False)
+                self.fc2 = nn.Linear(8, 8, bias=False)
+                self.fc3 = nn.Linear(8, 4, bias=False)
+
+            def forward(self, x, branch):
+                x = self.fc1(x) if branch else self.fc2(x)
+                return self.fc3(F.relu(x))
+
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        torch.manual_seed(0)
+        model = BranchModule()
+        ddp_model = DistributedDataParallel(
+            copy.deepcopy(model),
+            process_group=process_group,
+            find_unused_parameters=True,
+            # One parameter per bucket.
+            bucket_cap_mb=1e-7,
+        )
+        ddp_model._enable_adaptive_bucketing(rebuild_interval=2)
+
+        for iteration in range(8):
+            branch = iteration % 4 < 2
+            input = torch.randn(2, 8)
+            model.zero_grad()
+            ddp_model.zero_grad()
+            model(input, branch).sum().backward()
+            ddp_model(input, branch).sum().backward()
+            for p, ddp_p in zip(model.parameters(), ddp_model.parameters()):
+                if p.grad is None:
+                    self.assertTrue(ddp_p.grad is None or not ddp_p.grad.any())
+                else:
+                    self.assertEqual(ddp_p.grad, p.grad)
+
+        with self.assertRaisesRegex(
+            RuntimeError, "Adaptive bucketing requires find_unused_parameters=True"
+        ):
+            DistributedDataParallel(
+                BranchModule(), process_group=process_group
+            )._enable_adaptive_bucketing()
+
     @requires_gloo()
     @skip_if_lt_x_gpu(2)
     def test_find_unused_parameters_when_unused_parameters_empty(self):
@@ -3039,6 +3148,55 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         # without the comm_hook, result would be 0.25 * torch.ones(2, 2).
         self._run_and_verify_hook(cpu_model, 8, 2 * torch.ones(2, 2))
 
+    @requires_gloo()
+    def test_ddp_builtin_comm_hooks_cpu(self):
+        """
+        This unit test verifies that the built-in C++ hooks give the same
+        result as DDP without a hook. The bucket of TestDdpCommHook is too
+        small for PowerSGD to compress, so it is allreduced as is.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        for hook_type in (
+            dist.BuiltinCommHookType.ALLREDUCE,
+            dist.BuiltinCommHookType.FP16_COMPRESS,
+            dist.BuiltinCommHookType.POWER_SGD,
+        ):
+            cpu_model = DistributedDataParallel(
+                TestDdpCommHook().cpu(), process_group=process_group
+            )
+            cpu_model._register_builtin_comm_hook(hook_type)
+            self._run_and_verify_hook(cpu_model, 8, 0.25 * torch.ones(2, 2))
+
+    @requires_gloo()
+    def test_ddp_powersgd_comm_hook_cpu(self):
+        """
+        This unit test verifies that PowerSGD reconstructs gradients exactly
+        when their rank does not exceed matrix_approximation_rank. With the
+        same input everywhere, the gradient of a Linear weight is an outer
+        product, i.e. of rank one.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        torch.manual_seed(0)
+        model = nn.Linear(64, 64, bias=False)
+        ddp_model = DistributedDataParallel(
+            copy.deepcopy(model), process_group=process_group
+        )
+        options = dist.PowerSGDOptions()
+        options.matrix_approximation_rank = 1
+        options.start_powerSGD_iter = 0
+        ddp_model._register_builtin_comm_hook(
+            dist.BuiltinCommHookType.POWER_SGD, options
+        )
+
+        input = torch.randn(1, 64)
+        model(input).sum().backward()
+        ddp_model(input).sum().backward()
+        self.assertEqual(ddp_model.module.weight.grad, model.weight.grad)
+
     def _gpu_model_with_ddp_comm_hook(self, process_group, hook=None):
         device_id = gpus_for_rank(self.world_size)[self.rank][0]
         gpu_model = DistributedDataParallel(
@@ -3419,6 +3577,37 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def test_forward_backward_gradient_as_bucket_view(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference = copy.deepcopy(model)
+        parameters = [list(model.parameters())]
+        group_by_dtype = groupby(
+            range(len(parameters[0])),
+            key=lambda i: parameters[0][i].dtype)
+        buckets = [list(indices) for _, indices in group_by_dtype]
+        reducer = dist.Reducer(parameters, buckets, self.process_group,
+                               gradient_as_bucket_view=True)
+        loss = nn.CrossEntropyLoss()
+        data_ptrs = None
+        for i in range(3):
+            model.zero_grad()
+            reference.zero_grad()
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            loss(reference(input), target).backward()
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            # With a single process, the reduced gradients are the local ones.
+            for p, ref_p in zip(model.parameters(), reference.parameters()):
+                self.assertEqual(p.grad, ref_p.grad)
+            # After the first iteration, the gradients are bucket views and
+            # keep their storage.
+            if data_ptrs is not None:
+                self.assertEqual(data_ptrs, [p.grad.data_ptr() for p in model.parameters()])
+            data_ptrs = [p.grad.data_ptr() for p in model.parameters()]
+
     def test_ddp_comm_hook_multiple_replica_check(self):
         """
         DDP communication hook does not support single process multiple device mode.
@@ -3672,6 +3861,121 @@ class NcclErrorHandlingTest(MultiProcessTestCase):
 
 
 @unittest.skipIf(TEST_WITH_TSAN, "TSAN is not fork-safe since we're forking in a multi-threaded environment")
+class HierarchicalAllreduceTest(MultiProcessTestCase):
+    def setUp(self):
+        super(HierarchicalAllreduceTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(HierarchicalAllreduceTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 4
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(4)
+    def test_hierarchical_allreduce_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupNCCL.Options()
+        # Two "nodes" of two ranks each.
+        options.hierarchical_allreduce_local_size = 2
+        options.hierarchical_allreduce_min_bytes = 0
+        process_group = c10d.ProcessGroupNCCL(
+            store, self.rank, self.world_size, options)
+        device = torch.device('cuda:%d' % self.rank)
+
+        # Odd sizes exercise the padding of the node-local shards.
+        for numel in [1, 7, 64, 1001]:
+            for dtype in [torch.float, torch.half, torch.int]:
+                tensor = torch.arange(numel, device=device).to(dtype) * (self.rank + 1)
+                expected = torch.arange(numel, device=device).to(dtype) * 10
+                process_group.allreduce(tensor).wait()
+                self.assertEqual(tensor, expected)
+
+        tensor = torch.full((5, 3), self.rank + 1.0, device=device)
+        opts = c10d.AllreduceOptions()
+        opts.reduceOp = c10d.ReduceOp.MAX
+        process_group.allreduce([tensor], opts).wait()
+        self.assertEqual(tensor, torch.full((5, 3), 4.0, device=device))
+
+
+class ProcessGroupNCCLSplitTest(MultiProcessTestCase):
+    def setUp(self):
+        super(ProcessGroupNCCLSplitTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(ProcessGroupNCCLSplitTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 4
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(4)
+    def test_lightweight_work(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupNCCL.Options()
+        options.lightweight_work = True
+        process_group = c10d.ProcessGroupNCCL(
+            store, self.rank, self.world_size, options)
+        device = torch.device('cuda:%d' % self.rank)
+
+        # The events of finished works are reused by later ones.
+        for i in range(10):
+            tensor = torch.full((10,), float(self.rank + i), device=device)
+            work = process_group.allreduce(tensor)
+            work.wait()
+            self.assertTrue(work.is_completed())
+            self.assertEqual(tensor, torch.full((10,), float(6 + 4 * i), device=device))
+
+        with self.assertRaisesRegex(RuntimeError, "not supported"):
+            process_group.allreduce(tensor).get_future()
+
+    @requires_nccl()
+    @skip_if_lt_x_gpu(4)
+    def test_split(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(
+            store, self.rank, self.world_size)
+        torch.cuda.set_device(self.rank)
+        device = torch.device('cuda:%d' % self.rank)
+
+        groups = [[0, 1], [2, 3]]
+        subgroups = [
+            process_group._split(
+                c10d.PrefixStore(str(i), store),
+                ranks,
+                self.rank,
+                c10d.ProcessGroupNCCL.Options())
+            for i, ranks in enumerate(groups)
+        ]
+        member = self.rank // 2
+        self.assertIsNone(subgroups[1 - member])
+        subgroup = subgroups[member]
+        self.assertEqual(subgroup.size(), 2)
+        self.assertEqual(subgroup.rank(), self.rank % 2)
+
+        tensor = torch.full((10,), float(self.rank), device=device)
+        subgroup.allreduce(tensor).wait()
+        expected = float(sum(groups[member]))
+        self.assertEqual(tensor, torch.full((10,), expected, device=device))
+
+        # The parent group still works after the split.
+        tensor = torch.ones(10, device=device)
+        process_group.allreduce(tensor).wait()
+        self.assertEqual(tensor, torch.full((10,), 4.0, device=device))
+
+
 class CommTest(MultiProcessTestCase):
     def setUp(self):
         super(CommTest, self).setUp()
@@ -3728,6 +4032,44 @@ class CommTest(MultiProcessTestCase):
         device = torch.device('cuda:%d' % self.rank)
         self._test_broadcast_coalesced(process_group, device)
 
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_coalesced_collectives_nccl(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device = torch.device('cuda:%d' % self.rank)
+        shapes = [(3,), (2, 5), (1,), (4, 4)]
+        dtypes = [torch.float, torch.half, torch.int, torch.double]
+
+        tensors = [
+            torch.full(shape, self.rank + 1, dtype=dtype, device=device)
+            for shape, dtype in zip(shapes, dtypes)
+        ]
+        process_group.allreduce_coalesced(tensors).wait()
+        expected = sum(range(1, self.world_size + 1))
+        for tensor, shape, dtype in zip(tensors, shapes, dtypes):
+            self.assertEqual(tensor, torch.full(shape, expected, dtype=dtype, device=device))
+
+        tensors = [
+            torch.full(shape, self.rank, dtype=dtype, device=device)
+            for shape, dtype in zip(shapes, dtypes)
+        ]
+        opts = c10d.BroadcastOptions()
+        opts.rootRank = 1
+        process_group.broadcast_coalesced(tensors, opts).wait()
+        for tensor, shape, dtype in zip(tensors, shapes, dtypes):
+            self.assertEqual(tensor, torch.full(shape, 1, dtype=dtype, device=device))
+
+        inputs = [
+            torch.full(shape, self.rank, dtype=dtype, device=device)
+            for shape, dtype in zip(shapes, dtypes)
+        ]
+        outputs = [[torch.empty_like(t) for t in inputs] for _ in range(self.world_size)]
+        process_group.allgather_coalesced(outputs, inputs).wait()
+        for rank, output_list in enumerate(outputs):
+            for tensor, shape, dtype in zip(output_list, shapes, dtypes):
+                self.assertEqual(tensor, torch.full(shape, rank, dtype=dtype, device=device))
+
     @requires_gloo()
     @skip_if_not_multigpu
     def test_broadcast_coalesced_gloo_cuda(self):
@@ -3748,6 +4090,65 @@ class CommTest(MultiProcessTestCase):
         self._test_broadcast_coalesced(process_group, device)
 
 
+class ZeroRedundancyOptimizerTest(MultiProcessTestCase):
+    def setUp(self):
+        super(ZeroRedundancyOptimizerTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(ZeroRedundancyOptimizerTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 2
+
+    def _test_step(self, overlap):
+        from torch.distributed.optim import ZeroRedundancyOptimizer
+
+        c10d.init_process_group(
+            "gloo", init_method="file://{}".format(self.file_name),
+            rank=self.rank, world_size=self.world_size)
+        torch.manual_seed(0)
+        model = nn.Sequential(nn.Linear(4, 8), nn.ReLU(), nn.Linear(8, 2))
+        local_model = copy.deepcopy(model)
+        ddp = DistributedDataParallel(model)
+        optimizer = ZeroRedundancyOptimizer(
+            ddp.parameters(), torch.optim.Adam, module=ddp if overlap else None, lr=0.1)
+        local_optimizer = torch.optim.Adam(local_model.parameters(), lr=0.1)
+
+        # Each rank only keeps the states of its shard.
+        num_params = len(list(model.parameters()))
+        num_local_params = len(optimizer.param_groups[0]["params"])
+        self.assertLess(num_local_params, num_params)
+
+        for _ in range(3):
+            inputs = [torch.rand(3, 4) for _ in range(self.world_size)]
+            optimizer.zero_grad()
+            ddp(inputs[self.rank]).sum().backward()
+            optimizer.step()
+            local_optimizer.zero_grad()
+            (local_model(torch.cat(inputs)).sum() / self.world_size).backward()
+            local_optimizer.step()
+            # The first submodule waits for the broadcast of its own
+            # parameters before its forward.
+            with torch.no_grad():
+                ddp(inputs[self.rank])
+            for param, local_param in zip(model.parameters(), local_model.parameters()):
+                self.assertEqual(param, local_param)
+        self.assertEqual(num_local_params, len(optimizer.state_dict()["state"]))
+        c10d.destroy_process_group()
+
+    def test_step(self):
+        self._test_step(overlap=False)
+
+    def test_step_overlap_with_forward(self):
+        self._test_step(overlap=True)
+
+
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
 
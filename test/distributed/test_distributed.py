@@ -1621,6 +1621,46 @@ class _DistTestBase(object):
             rank_to_GPU,
         )
 
+    @unittest.skipIf(
+        BACKEND not in ("gloo", "mpi"), "Only Gloo and MPI support CPU all_to_all_single"
+    )
+    def test_sharded_embedding_bag(self):
+        from torch.distributed.nn import ShardedEmbeddingBag
+
+        group, group_id, rank = self._init_global_test()
+        num_embeddings, embedding_dim, num_bags = 23, 4, 6
+        torch.manual_seed(0)
+        full_weight = torch.randn(num_embeddings, embedding_dim)
+
+        def rank_inputs(r):
+            gen = torch.Generator().manual_seed(r)
+            input = torch.randint(num_embeddings, (num_bags * 3,), generator=gen)
+            # Includes an empty bag.
+            offsets = torch.tensor([0, 2, 2, 5, 9, 14])
+            grad = torch.randn(num_bags, embedding_dim, generator=gen)
+            return input, offsets, grad
+
+        for mode in ["sum", "mean"]:
+            for num_chunks in [1, 3]:
+                emb = ShardedEmbeddingBag(
+                    num_embeddings, embedding_dim, mode=mode, num_chunks=num_chunks)
+                start, end = emb.shard_offsets[rank], emb.shard_offsets[rank + 1]
+                with torch.no_grad():
+                    emb.weight.copy_(full_weight[start:end])
+
+                input, offsets, grad = rank_inputs(rank)
+                output = emb(input, offsets)
+                self.assertEqual(output, F.embedding_bag(input, full_weight, offsets, mode=mode))
+                output.backward(grad)
+
+                # The gradient of the shard accumulates the bags of every rank.
+                expected_weight = full_weight.clone().requires_grad_()
+                for r in group:
+                    r_input, r_offsets, r_grad = rank_inputs(r)
+                    F.embedding_bag(r_input, expected_weight, r_offsets, mode=mode).backward(r_grad)
+                self.assertEqual(emb.weight.grad, expected_weight.grad[start:end])
+        self._barrier()
+
     @unittest.skipIf(BACKEND != "mpi", "Only MPI supports all_to_all")
     def test_all_to_all(self):
         group, group_id, rank = self._init_global_test()
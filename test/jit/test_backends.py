@@ -177,6 +177,40 @@ class NestedModuleTest(JitBackendTestCase):
         self.test_execution()
 
 
+class AsyncModuleTest(JitBackendTestCase):
+    """
+    Tests for BasicModule lowered to a backend that completes execute_async
+    on the inter-op thread pool.
+    """
+
+    def setUp(self):
+        super().setUp()
+        self.module = BasicModule()
+        self.scripted_module = torch.jit.script(BasicModule())
+        self.lowered_module = torch._C._jit_to_backend(
+            "test_backend_async",
+            self.scripted_module._c,
+            {"accum": {"": ""}, "sub_accum": {"": ""}, "forward": {"": ""}},
+        )
+
+    def test_execution(self):
+        input = torch.randn(5)
+
+        self.check_function("accum", input)
+        self.check_function("sub_accum", input)
+        self.check_function("forward", input)
+
+        # Calls forked from TorchScript should be able to overlap on the backend.
+        lowered_module = self.lowered_module
+
+        def fork_accum(x):
+            futs = [torch.jit._fork(lowered_module.accum, x, x) for _ in range(4)]
+            return [torch.jit._wait(fut) for fut in futs]
+
+        for output in fork_accum(input):
+            self.assertEqual(output, input + input)
+
+
 class TestBackends(JitTestCase):
     """
     This class wraps and invokes all subclasses of JitBackendTestCase so that each one
@@ -187,17 +221,20 @@ class TestBackends(JitTestCase):
         super().__init__(name)
         self.basic_module_test = BasicModuleTest(name)
         self.nested_module_test = NestedModuleTest(name)
+        self.async_module_test = AsyncModuleTest(name)
 
     def setUp(self):
         super().setUp()
         if not TEST_WITH_ROCM:
             self.basic_module_test.setUp()
             self.nested_module_test.setUp()
+            self.async_module_test.setUp()
 
     @skipIfRocm
     def test_execution(self):
         self.basic_module_test.test_execution()
         self.nested_module_test.test_execution()
+        self.async_module_test.test_execution()
 
     @skipIfRocm
     def test_save_load(self):
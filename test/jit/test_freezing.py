@@ -4,6 +4,7 @@ import torch.nn as nn
 from torch.testing._internal.jit_utils import JitTestCase
 
 from torch.testing import FileCheck
+from torch.testing._internal.common_cuda import TEST_CUDNN
 
 import io
 
@@ -1026,3 +1027,103 @@ class TestFreezing(JitTestCase):
         fm = torch._C._freeze_module(m._c, ["modify_a"])
         FileCheck().check('prim::GetAttr[name="a"]').run(fm.forward.graph)
         FileCheck().check('prim::GetAttr[name="b"]').run(fm.modify_a.graph)
+
+    def test_freeze_module_mkl_prepacked_linear(self):
+        class Module(nn.Module):
+            def __init__(self):
+                super(Module, self).__init__()
+                self.linear1 = nn.Linear(16, 8)
+                self.linear2 = nn.Linear(8, 4, bias=False)
+
+            def forward(self, x):
+                return self.linear2(torch.relu(self.linear1(x)))
+
+        m = torch.jit.script(Module())
+        m.eval()
+        om = torch._C._jit_pass_mkl_optimize_for_inference(m._c, [])
+        FileCheck().check_not("aten::linear") \
+                   .check_not("mkl_prepack::linear_prepack") \
+                   .check_count("mkl_prepack::linear_run", 2, exactly=True) \
+                   .run(om.forward.graph)
+        # the context keeps packed weights for a few batch sizes, and runs
+        # the others through aten::linear
+        for batch in [1, 3, 1, 7, 2, 5, 11, 13, 17, 19, 3]:
+            input = torch.randn(batch, 16)
+            self.assertEqual(om.forward(input), m.forward(input))
+        input = torch.randn(2, 3, 16)
+        self.assertEqual(om.forward(input), m.forward(input))
+
+        # the contexts are saved as their original weights
+        buffer = io.BytesIO()
+        torch.jit.save(torch.jit._recursive.wrap_cpp_module(om), buffer)
+        buffer.seek(0)
+        loaded = torch.jit.load(buffer)
+        input = torch.randn(6, 16)
+        self.assertEqual(loaded(input), m.forward(input))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_module_convert_frozen_ops_to_mkldnn(self):
+        class Module(nn.Module):
+            def __init__(self):
+                super(Module, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1, bias=False)
+                self.conv3 = nn.Conv2d(8, 8, 1, groups=2)
+
+            def forward(self, x):
+                y = torch.relu(self.conv1(x))
+                z = self.conv3(torch.relu_(self.conv2(y)))
+                out = torch.max_pool2d(y + z, 2)
+                return out, torch.adaptive_avg_pool2d(out, (1, 1)).flatten(1)
+
+        m = torch.jit.script(Module())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        graph = fm._get_method("forward").graph
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(graph)
+        # one conversion for the input, and one for each of the outputs
+        FileCheck().check_count("aten::to_mkldnn", 1, exactly=True) \
+                   .check_count("aten::to_dense", 2, exactly=True) \
+                   .run(graph)
+        for shape in [(1, 3, 8, 8), (2, 3, 7, 9)]:
+            input = torch.randn(shape)
+            expected = m.forward(input)
+            out = fm.forward(input)
+            self.assertEqual(out[0], expected[0], atol=1e-4, rtol=1e-4)
+            self.assertEqual(out[1], expected[1], atol=1e-4, rtol=1e-4)
+
+    @unittest.skipIf(not TEST_CUDNN, "requires CUDNN")
+    def test_freeze_module_fuse_frozen_conv_add_relu(self):
+        class Module(nn.Module):
+            def __init__(self):
+                super(Module, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1, bias=False)
+                self.conv3 = nn.Conv2d(8, 8, 1)
+                self.linear = nn.Linear(8, 4)
+
+            def forward(self, x):
+                y = torch.relu(self.conv1(x))
+                z = torch.relu_(self.conv2(y) + y)
+                # the residual is broadcast to the output of the convolution
+                w = torch.relu(self.conv3(z) + x.mean(1, keepdim=True))
+                return torch.relu(self.linear(z.mean([2, 3]))), w
+
+        m = torch.jit.script(Module().cuda())
+        m.eval()
+        fm = torch._C._freeze_module(m._c)
+        graph = fm._get_method("forward").graph
+        torch._C._jit_pass_fuse_frozen_conv_add_relu(graph)
+        FileCheck().check_not("aten::conv2d").run(graph)
+        FileCheck().check_not("aten::relu").run(graph)
+        FileCheck().check_count("aten::cudnn_convolution_relu", 1, exactly=True) \
+                   .check_count("aten::cudnn_convolution_add_relu", 2, exactly=True) \
+                   .check("aten::_addmm_activation") \
+                   .run(graph)
+        with torch.no_grad():
+            for shape in [(1, 3, 8, 8), (2, 3, 7, 9)]:
+                input = torch.randn(shape, device="cuda")
+                expected = m.forward(input)
+                out = fm.forward(input)
+                self.assertEqual(out[0], expected[0], atol=1e-4, rtol=1e-4)
+                self.assertEqual(out[1], expected[1], atol=1e-4, rtol=1e-4)
@@ -0,0 +1,87 @@
+import os
+import sys
+
+import torch
+from torch.nn import functional as F
+from torch.testing import FileCheck
+
+# Make the helper files in test/ importable
+pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
+sys.path.append(pytorch_test_dir)
+from torch.testing._internal.jit_utils import JitTestCase
+
+if __name__ == '__main__':
+    raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
+                       "\tpython test/test_jit.py TESTNAME\n\n"
+                       "instead.")
+
+class TestHorizontalBatching(JitTestCase):
+    def _batch(self, fn):
+        graph = fn.graph.copy()
+        self.run_pass('inline', graph)
+        self.run_pass('constant_propagation', graph)
+        self.run_pass('batch_independent_ops', graph)
+        return graph, self.createFunctionFromGraph(graph)
+
+    def test_towers(self):
+        def towers(x1, x2, x3, w1, w2, w3, b1, b2, b3, g1, g2, g3):
+            y1 = torch.relu(torch.addmm(b1, x1, w1.t()))
+            y2 = torch.relu(torch.addmm(b2, x2, w2.t()))
+            y3 = torch.relu(torch.addmm(b3, x3, w3.t()))
+            z1 = F.layer_norm(y1, [6], g1, b1)
+            z2 = F.layer_norm(y2, [6], g2, b2)
+            z3 = F.layer_norm(y3, [6], g3, b3)
+            return z1 + z2 + z3
+
+        scripted = torch.jit.script(towers)
+        graph, batched = self._batch(scripted)
+        # one addmm, one relu and one layer_norm for the three towers
+        FileCheck().check_count("prim::HorizontalBatch", 3, exactly=True) \
+            .check_not("aten::addmm").check_not("aten::layer_norm").run(graph)
+
+        inputs = [torch.rand(4, 5) for _ in range(3)] + \
+            [torch.rand(6, 5) for _ in range(3)] + \
+            [torch.rand(6) for _ in range(6)]
+        self.assertEqual(towers(*inputs), batched(*inputs))
+
+        # Inputs of different shapes run the ops one by one.
+        inputs[0] = torch.rand(3, 5)
+        self.assertEqual(towers(*inputs), batched(*inputs))
+
+    def test_linear(self):
+        def linears(x1, x2, w1, w2):
+            return torch._C._nn.linear(x1, w1), torch._C._nn.linear(x2, w2)
+
+        graph, batched = self._batch(torch.jit.script(linears))
+        FileCheck().check("prim::HorizontalBatch").check_not("aten::linear").run(graph)
+        inputs = [torch.rand(2, 3, 5), torch.rand(2, 3, 5), torch.rand(4, 5), torch.rand(4, 5)]
+        self.assertEqual(linears(*inputs), batched(*inputs))
+
+    def test_embedding(self):
+        def lookups(table, i1, i2, i3):
+            return F.embedding(i1, table), F.embedding(i2, table), F.embedding(i3, table)
+
+        graph, batched = self._batch(torch.jit.script(lookups))
+        FileCheck().check("prim::HorizontalBatch").check_not("aten::embedding").run(graph)
+        table = torch.rand(10, 3)
+        inputs = [table, torch.tensor([1, 2]), torch.tensor([[3], [4]]), torch.tensor([0, 9, 5])]
+        self.assertEqual(lookups(*inputs), batched(*inputs))
+
+    def test_dependent_ops(self):
+        def chain(x, w1, w2):
+            y = torch.mm(x, w1)
+            return torch.relu(torch.relu(y) + torch.relu(x))
+
+        graph, batched = self._batch(torch.jit.script(chain))
+        # The outer relu depends on the others, which are batched.
+        FileCheck().check_count("prim::HorizontalBatch", 1, exactly=True) \
+            .check("aten::relu").run(graph)
+        inputs = [torch.rand(3, 3), torch.rand(3, 3), torch.rand(3, 3)]
+        self.assertEqual(chain(*inputs), batched(*inputs))
+
+    def test_different_constants(self):
+        def norms(x1, x2):
+            return F.layer_norm(x1, [4], eps=1e-5), F.layer_norm(x2, [4], eps=1e-3)
+
+        graph, _ = self._batch(torch.jit.script(norms))
+        FileCheck().check_not("prim::HorizontalBatch").run(graph)
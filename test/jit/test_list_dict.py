@@ -416,6 +416,25 @@ class TestList(JitTestCase):
             return a == [0, 1, 2, 3]
         self.checkScript(test_append, ())
 
+    def test_mutable_list_ops_aliasing(self):
+        # the list ops update the list in place on the interpreter stack, so
+        # check that aliases see the changes they should, and only those
+        def test_aliasing():
+            # type: () -> Tuple[List[int], List[int], List[int], List[int], int]
+            x = [1, 2]
+            a = x
+            a.append(5)
+            a[0] = 7
+            b = a + [1]
+            c = [2] + [3]
+            c += b
+            a *= 2
+            d = a[1:3]
+            e, f = d
+            return x, b, c, a * 2, len(a) + e + f
+
+        self.checkScript(test_aliasing, ())
+
     def test_comprehensions_basic(self):
         def comp(l):
             # type: (List[int]) -> List[int]
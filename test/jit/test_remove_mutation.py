@@ -200,3 +200,59 @@ class TestRemoveMutation(JitTestCase):
         # it is possible to remove the append here but don't currently have the logic for it
         FileCheck().check_not("append").run(graph)
         self.assertEqual(intermediary_use(), fn())
+
+    def test_functionalize(self):
+        def mutate_input(x):
+            x.add_(1)
+            y = x * 2
+            x.mul_(3)
+            return y
+
+        fn = torch.jit.script(mutate_input)
+        graph = fn.graph
+        self.run_pass('functionalize', graph)
+        # a single copy back into the input at the end of the graph
+        FileCheck().check_not("aten::add_").check_not("aten::mul_").check("aten::copy_") \
+            .check_next("return").run(graph)
+        FileCheck().check_count("aten::copy_", 1, exactly=True).run(graph)
+        x1, x2 = torch.rand(3), torch.rand(3)
+        x2.copy_(x1)
+        self.assertEqual(mutate_input(x1), fn(x2))
+        self.assertEqual(x1, x2)
+
+        def intermediary_use():
+            x = torch.tensor([2, 2])
+            x.add_(1)
+            y = x + 4
+            x.add_(3)
+            return x, y
+
+        fn = torch.jit.script(intermediary_use)
+        graph = fn.graph
+        self.run_pass('functionalize', graph)
+        FileCheck().check_not("aten::add_").check_not("aten::copy_").run(graph)
+        self.assertEqual(intermediary_use(), fn())
+
+        def other_input_used(x, y):
+            x.add_(1)
+            return x + y
+
+        # y may alias x, so it would see the stale value
+        fn = torch.jit.script(other_input_used)
+        graph = fn.graph
+        self.run_pass('functionalize', graph)
+        FileCheck().check("aten::add_").check_not("aten::copy_").run(graph)
+        x = torch.rand(3)
+        self.assertEqual(fn(x.clone(), x.clone()), other_input_used(x.clone(), x.clone()))
+
+        def view_used_later(x):
+            y = x.view(-1)
+            x.relu_()
+            return y + 1
+
+        fn = torch.jit.script(view_used_later)
+        graph = fn.graph
+        self.run_pass('functionalize', graph)
+        FileCheck().check("aten::relu_").run(graph)
+        x = torch.randn(2, 3)
+        self.assertEqual(fn(x.clone()), view_used_later(x.clone()))
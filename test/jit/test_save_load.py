@@ -2,6 +2,7 @@ import os
 import io
 import sys
 import random
+import unittest
 import torch
 from itertools import product as product
 from torch import Tensor
@@ -874,3 +875,46 @@ class TestSaveLoad(JitTestCase):
         torch.jit.save(sm, contains_both)
         contains_both.seek(0)
         sm = torch.jit.load(contains_both)
+
+    def _test_parallel_tensor_loading(self, map_location):
+        class Foo(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.linears = torch.nn.ModuleList(
+                    [torch.nn.Linear(4, 4) for _ in range(8)])
+                # Shares a storage with the first weight.
+                self.register_buffer("shared", self.linears[0].weight.detach()[1:])
+
+            def forward(self, x):
+                for linear in self.linears:
+                    x = linear(x)
+                return x + self.shared.sum()
+
+        m = torch.jit.script(Foo())
+        buffer = io.BytesIO()
+        torch.jit.save(m, buffer)
+
+        old_state = torch._C._jit_set_parallel_tensor_loading(True)
+        try:
+            buffer.seek(0)
+            loaded = torch.jit.load(buffer, map_location=map_location)
+        finally:
+            torch._C._jit_set_parallel_tensor_loading(old_state)
+
+        self.assertEqual(
+            [p.device.type for p in loaded.parameters()],
+            [torch.device(map_location).type] * len(list(m.parameters())))
+        for expected, actual in zip(m.state_dict().values(), loaded.state_dict().values()):
+            self.assertEqual(expected, actual.cpu())
+        self.assertEqual(
+            loaded.shared.storage().data_ptr(),
+            loaded.linears[0].weight.storage().data_ptr())
+        x = torch.rand(2, 4)
+        self.assertEqual(m(x), loaded(x.to(map_location)).cpu())
+
+    def test_parallel_tensor_loading(self):
+        self._test_parallel_tensor_loading("cpu")
+
+    @unittest.skipIf(not torch.cuda.is_available(), "requires CUDA")
+    def test_parallel_tensor_loading_cuda(self):
+        self._test_parallel_tensor_loading("cuda")
@@ -501,3 +501,48 @@ class TestTypeSharing(JitTestCase):
         c = Foo({'bar': A()})
         self.assertDifferentType(a, b)
         self.assertSameType(b, c)
+
+    def test_shared_type_compiles_once(self):
+        """
+        Submodules sharing a type should only have their methods inferred and
+        compiled for the first instance.
+        """
+        class Sub(torch.nn.Module):
+            def __init__(self):
+                super(Sub, self).__init__()
+                self.linear = torch.nn.Linear(4, 4)
+
+            def forward(self, x):
+                """docstring of forward"""
+                return self.linear(x).relu()
+
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.subs = torch.nn.ModuleList([Sub() for _ in range(10)])
+
+            def forward(self, x):
+                for sub in self.subs:
+                    x = sub(x)
+                return x
+
+        calls = []
+        infer_methods_to_compile = torch.jit._recursive.infer_methods_to_compile
+
+        def counting_infer(nn_module):
+            calls.append(type(nn_module))
+            return infer_methods_to_compile(nn_module)
+
+        torch.jit._recursive.infer_methods_to_compile = counting_infer
+        try:
+            m = M()
+            sm = torch.jit.script(m)
+        finally:
+            torch.jit._recursive.infer_methods_to_compile = infer_methods_to_compile
+
+        self.assertEqual(calls.count(Sub), 1)
+        for sub in sm.subs:
+            self.assertEqual(sub.forward.__doc__, "docstring of forward")
+        self.assertSameType(sm.subs[0], sm.subs[9])
+        x = torch.rand(2, 4)
+        self.assertEqual(sm(x), m(x))
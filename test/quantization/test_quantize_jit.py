@@ -1446,7 +1446,10 @@ class TestQuantizeJitOps(QuantizationTestCase):
                  torch.randn(1, 2, 5, 5, dtype=torch.float)]]
         for tracing in [True, False]:
             m = self.checkGraphModeOp(QuantizedAdd(), data, "quantized::add", tracing)
-            FileCheck().check_count("quantized::add", 3, exactly=True) \
+            # x + y is fused with conv1, y is used twice so conv2 is not
+            FileCheck().check_count("quantized::add(", 2, exactly=True) \
+                       .run(m.graph)
+            FileCheck().check_count("quantized::conv2d_add(", 1, exactly=True) \
                        .run(m.graph)
             FileCheck().check_not("aten::add") \
                        .check_not("aten::add_") \
@@ -1551,7 +1554,10 @@ class TestQuantizeJitOps(QuantizationTestCase):
                        AddInplaceFunctionalRelu(), InplaceAddInplaceFunctionalRelu()]:
             for tracing in [True, False]:
                 m = self.checkGraphModeOp(m_orig, data, "quantized::add_relu(", tracing=tracing)
-                FileCheck().check_count("quantized::add_relu(", 2, exactly=True) \
+                # the first add - relu is fused with conv1
+                FileCheck().check_count("quantized::add_relu(", 1, exactly=True) \
+                           .run(m.graph)
+                FileCheck().check_count("quantized::conv2d_add_relu(", 1, exactly=True) \
                            .run(m.graph)
                 FileCheck().check_not("aten::add(") \
                            .check_not("aten::add_(") \
@@ -1608,7 +1614,8 @@ class TestQuantizeJitOps(QuantizationTestCase):
                              (NonQuantizedAdd(), False),
                              (NonQuantizedInplaceAdd(), False)]:
             for tracing in [True, False]:
-                op = "quantized::add" if quantized else "aten::add"
+                # the add of a conv output is fused with the conv
+                op = "quantized::conv2d_add" if quantized else "aten::add"
                 m = self.checkGraphModeOp(m, data, op, tracing)
                 # TODO: remove after refactor of checkGraphModeOp
                 if quantized:
@@ -1757,7 +1764,8 @@ class TestQuantizeJitOps(QuantizationTestCase):
                   AddFunctionalRelu(), InplaceAddFunctionalRelu(),
                   AddInplaceFunctionalRelu(), InplaceAddInplaceFunctionalRelu()]:
             for tracing in [True, False]:
-                m = self.checkGraphModeOp(m, data, "quantized::add_relu(", tracing)
+                # the add - relu of a conv output is fused with the conv
+                m = self.checkGraphModeOp(m, data, "quantized::conv2d_add_relu(", tracing)
                 FileCheck().check_not("aten::add(") \
                            .check_not("aten::add_(") \
                            .check_not("aten::relu(") \
@@ -352,6 +352,107 @@ class TestQuantizedOps(TestCase):
                          msg="F.celu failed ({} vs {})".format(qY, qY_hat))
 
 
+    def _assert_within_one_step(self, qY, qY_ref):
+        # Integer accumulation and float references round differently, so
+        # outputs may differ by one quantization step.
+        self.assertEqual(qY.q_scale(), qY_ref.q_scale())
+        self.assertEqual(qY.q_zero_point(), qY_ref.q_zero_point())
+        diff = (qY.int_repr().to(torch.int32) - qY_ref.int_repr().to(torch.int32)).abs()
+        self.assertLessEqual(diff.max().item(), 1)
+
+    """Tests the correctness of the quantized::bmm op."""
+    def test_qbmm(self):
+        for torch_type, (B, M, K, N) in itertools.product(
+                (torch.quint8, torch.qint8), ((1, 1, 1, 1), (3, 5, 17, 9), (2, 33, 64, 7))):
+            A, A_scale, A_zero_point = _get_random_tensor_and_q_params((B, M, K), 2.0, torch_type)
+            Bm, B_scale, B_zero_point = _get_random_tensor_and_q_params((B, K, N), 2.0, torch_type)
+            qA = torch.quantize_per_tensor(A, A_scale, A_zero_point, torch_type)
+            qB = torch.quantize_per_tensor(Bm, B_scale, B_zero_point, torch_type)
+            Y = torch.bmm(qA.dequantize(), qB.dequantize())
+            Y_scale = max(float(Y.max() - Y.min()) / 255, 1e-5)
+            Y_zero_point = 0 if torch_type == torch.qint8 else 128
+            qY_ref = torch.quantize_per_tensor(Y, Y_scale, Y_zero_point, torch_type)
+            qY = torch.ops.quantized.bmm(qA, qB, Y_scale, Y_zero_point)
+            self._assert_within_one_step(qY, qY_ref)
+            # Non-contiguous inputs give the same result.
+            qY_t = torch.ops.quantized.bmm(
+                qA.transpose(1, 2).contiguous().transpose(1, 2), qB.transpose(1, 2).contiguous().transpose(1, 2),
+                Y_scale, Y_zero_point)
+            self.assertEqual(qY_t.int_repr(), qY.int_repr())
+
+    """Tests the correctness of the quantized::softmax op."""
+    def test_qsoftmax(self):
+        for torch_type, dim in itertools.product((torch.quint8, torch.qint8), (-1, 0, 1)):
+            X, X_scale, X_zero_point = _get_random_tensor_and_q_params((4, 7, 33), 8.0, torch_type)
+            qX = torch.quantize_per_tensor(X, X_scale, X_zero_point, torch_type)
+            Y_zero_point = 0 if torch_type == torch.quint8 else -128
+            Y_scale = 1.0 / 256
+            Y = torch.softmax(qX.dequantize(), dim)
+            qY_ref = torch.quantize_per_tensor(Y, Y_scale, Y_zero_point, torch_type)
+            qY = torch.ops.quantized.softmax(qX, dim, Y_scale, Y_zero_point)
+            self.assertEqual(qY.shape, qX.shape)
+            self._assert_within_one_step(qY, qY_ref)
+
+    """Tests the correctness of the quantized::scaled_dot_product_attention op."""
+    def test_qscaled_dot_product_attention(self):
+        B, L, S, E = 6, 5, 7, 16
+        scaling = E ** -0.5
+        bool_mask = torch.zeros(L, S, dtype=torch.bool)
+        bool_mask[:, -2:] = True
+        bool_mask[0, :] = True
+        float_mask = torch.randn(B, L, S)
+        for torch_type, attn_mask in itertools.product(
+                (torch.quint8, torch.qint8), (None, bool_mask, float_mask)):
+            qs = []
+            for shape in ((B, L, E), (B, S, E), (B, S, E)):
+                X, X_scale, X_zero_point = _get_random_tensor_and_q_params(shape, 4.0, torch_type)
+                qs.append(torch.quantize_per_tensor(X, X_scale, X_zero_point, torch_type))
+            q, k, v = [x.dequantize() for x in qs]
+            scores = torch.bmm(q, k.transpose(1, 2)) * scaling
+            if attn_mask is not None:
+                if attn_mask.dtype == torch.bool:
+                    scores = scores.masked_fill(attn_mask, float('-inf'))
+                else:
+                    scores = scores + attn_mask
+            weights = torch.softmax(scores, -1)
+            # Fully masked rows produce zeros instead of NaN.
+            weights = torch.where(torch.isnan(weights), torch.zeros_like(weights), weights)
+            Y = torch.bmm(weights, v)
+            Y_scale = max(float(Y.max() - Y.min()) / 255, 1e-5)
+            Y_zero_point = 0 if torch_type == torch.qint8 else 128
+            qY_ref = torch.quantize_per_tensor(Y, Y_scale, Y_zero_point, torch_type)
+            qY = torch.ops.quantized.scaled_dot_product_attention(
+                qs[0], qs[1], qs[2], attn_mask, scaling, Y_scale, Y_zero_point)
+            self._assert_within_one_step(qY, qY_ref)
+
+    """Tests the correctness of the weight-only quantized linear ops."""
+    def test_qlinear_weight_only(self):
+        ops = {
+            8: (torch.ops.quantized.linear_weight_only_byte_prepack,
+                torch.ops.quantized.embedding_bag_byte_unpack,
+                torch.ops.quantized.linear_weight_only_byte),
+            4: (torch.ops.quantized.linear_weight_only_4bit_prepack,
+                torch.ops.quantized.embedding_bag_4bit_unpack,
+                torch.ops.quantized.linear_weight_only_4bit),
+        }
+        for bit_rate, batch_shape, K, N, use_bias, dtype in itertools.product(
+                (8, 4), ((), (1,), (3, 5)), (2, 38, 256), (1, 17), (True, False),
+                (torch.float, torch.bfloat16)):
+            prepack, unpack, linear = ops[bit_rate]
+            W = torch.randn(N, K)
+            X = torch.randn(*batch_shape, K).to(dtype)
+            bias = torch.randn(N) if use_bias else None
+            packed = prepack(W)
+            Y = linear(X, packed, bias)
+            Y_ref = F.linear(X.float(), unpack(packed), bias)
+            self.assertEqual(Y.dtype, dtype)
+            self.assertEqual(Y.shape, Y_ref.shape)
+            tolerance = 1e-3 if dtype == torch.float else 2e-2
+            self.assertEqual(Y.float(), Y_ref, atol=tolerance * K ** 0.5, rtol=tolerance)
+        with self.assertRaisesRegex(RuntimeError, "do not match"):
+            torch.ops.quantized.linear_weight_only_byte(
+                torch.randn(2, 7), torch.ops.quantized.linear_weight_only_byte_prepack(torch.randn(3, 8)))
+
     """Tests the correctness of the quantized::qlayer_norm op."""
     @skipIfNoFBGEMM
     def test_qlayer_norm(self):
@@ -2878,6 +2979,51 @@ class TestQuantizedEmbeddingBag(TestCase):
                                                include_last_offset, atol=0.1,
                                                rtol=1e-2)
 
+    """ Tests the grouped embedding_bag operator against the per-table ones """
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(5, 50).filter(lambda x: x % 4 == 0),
+           enable_per_sample_weights=st.booleans(),
+           include_last_offset=st.booleans())
+    def test_embedding_bag_grouped_rowwise_offsets(self, num_embeddings,
+                                                   embedding_dim,
+                                                   enable_per_sample_weights,
+                                                   include_last_offset):
+        bit_rates = [32, 16, 8, 4]
+        weights = [torch.rand(num_embeddings, embedding_dim) + 1 for _ in bit_rates]
+        tables = [weights[0], weights[1].half(),
+                  torch.ops.quantized.embedding_bag_byte_prepack(weights[2]),
+                  torch.ops.quantized.embedding_bag_4bit_prepack(weights[3])]
+        indices, offsets, per_sample_weights = [], [], []
+        for _ in bit_rates:
+            lengths = torch.randint(0, 20, (np.random.randint(1, 6),))
+            offsets.append(torch.cat((torch.zeros(1, dtype=torch.long), lengths.cumsum(0))))
+            if not include_last_offset:
+                offsets[-1] = offsets[-1][:-1]
+            indices.append(torch.randint(0, num_embeddings, (int(lengths.sum()),)))
+            per_sample_weights.append(torch.rand(indices[-1].numel()))
+        if not enable_per_sample_weights:
+            per_sample_weights = []
+
+        results = torch.ops.quantized.embedding_bag_grouped_rowwise_offsets(
+            tables, bit_rates, indices, offsets, per_sample_weights,
+            include_last_offset=include_last_offset)
+        self.assertEqual(len(results), len(bit_rates))
+        for t, result in enumerate(results):
+            psw = per_sample_weights[t] if enable_per_sample_weights else None
+            if bit_rates[t] == 8:
+                expected = torch.ops.quantized.embedding_bag_byte_rowwise_offsets(
+                    tables[t], indices[t], offsets[t], per_sample_weights=psw,
+                    include_last_offset=include_last_offset)
+            elif bit_rates[t] == 4:
+                expected = torch.ops.quantized.embedding_bag_4bit_rowwise_offsets(
+                    tables[t], indices[t], offsets[t], per_sample_weights=psw,
+                    include_last_offset=include_last_offset)
+            else:
+                expected = torch.nn.functional.embedding_bag(
+                    indices[t], tables[t].float(), offsets[t], mode='sum',
+                    per_sample_weights=psw, include_last_offset=include_last_offset)
+            torch.testing.assert_allclose(result, expected, atol=1e-4, rtol=1e-4)
+
 
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
@@ -3155,6 +3301,40 @@ class TestQuantizedConv(unittest.TestCase):
             qconv_prepack, qconv_unpack, inputs, (stride_h, stride_w),
             (pad_h, pad_w), channelwise)
 
+    """Tests the correctness of the fused conv2d - add(- relu) ops against
+    a float conv and add of the dequantized operands."""
+    @override_qengines
+    def test_qconv2d_add(self):
+        torch.manual_seed(0)
+        X = torch.rand(2, 4, 8, 8) * 2 - 1
+        W = torch.randn(6, 4, 3, 3) * 0.2
+        b = torch.randn(6)
+        accum = torch.rand(2, 6, 6, 6) * 4 - 2
+        qX = torch.quantize_per_tensor(X, 2. / 255, 128, torch.quint8)
+        qW = torch.quantize_per_tensor(
+            W, W.abs().max().item() / 127, 0, torch.qint8)
+        qaccum = torch.quantize_per_tensor(accum, 4. / 255, 128, torch.quint8)
+        packed_weight = torch.ops.quantized.conv2d_prepack(
+            qW, b, [1, 1], [0, 0], [1, 1], 1)
+        Y_scale, Y_zero_point = 12. / 255, 128
+
+        for op, relu in [(torch.ops.quantized.conv2d_add, False),
+                         (torch.ops.quantized.conv2d_add_relu, True)]:
+            Y_ref = F.conv2d(qX.dequantize(), qW.dequantize(), b) + \
+                qaccum.dequantize()
+            if relu:
+                Y_ref = F.relu(Y_ref)
+            qY_ref = torch.quantize_per_tensor(
+                Y_ref, Y_scale, Y_zero_point, torch.quint8)
+            qY = op(qX, qaccum, packed_weight, Y_scale, Y_zero_point)
+            self.assertEqual(qY.q_scale(), Y_scale)
+            self.assertEqual(qY.q_zero_point(), Y_zero_point)
+            # The conv result is requantized once before the add, so allow an
+            # extra output step of error.
+            np.testing.assert_allclose(
+                qY.dequantize().numpy(), qY_ref.dequantize().numpy(),
+                atol=2 * Y_scale, rtol=0)
+
     @given(
         inputs=hu.tensor_conv(
             spatial_dim=1, batch_size_range=(1, 3),
@@ -232,6 +232,27 @@ class TestQuantizedTensor(TestCase):
         self.assertTrue(np.allclose(qr.int_repr(), quantize_c(r, scales, zero_points)))
         self.assertTrue(np.allclose(r.numpy(), rqr.numpy(), atol=2 / np.min(scales.numpy())))
 
+    def test_qtensor_quantize_per_channel_vectorized(self):
+        # Rows that are not a multiple of the vector width exercise the
+        # scalar tails of the vectorized kernels.
+        r = torch.rand(4, 3, 37, dtype=torch.float) * 4 - 2
+        scales = torch.tensor([0.2, 0.03, 0.1], dtype=torch.double)
+        zero_points = torch.tensor([5, -3, 0], dtype=torch.long)
+        axis = 1
+        for dtype in [torch.qint8, torch.quint8, torch.qint32]:
+            info = torch.iinfo(dtype)
+            s = scales.float().view(1, 3, 1)
+            zp = zero_points.float().view(1, 3, 1)
+            ref = torch.clamp(torch.round(r / s) + zp, info.min, info.max)
+            qr = torch.quantize_per_channel(r, scales, zero_points, axis, dtype)
+            self.assertTrue(np.allclose(qr.int_repr().float().numpy(), ref.numpy(), atol=1))
+            self.assertEqual(qr.dequantize(), (qr.int_repr().float() - zp) * s)
+
+            qr = torch.quantize_per_tensor(r, 0.03, 2, dtype)
+            ref = torch.clamp(torch.round(r / 0.03) + 2, info.min, info.max)
+            self.assertTrue(np.allclose(qr.int_repr().float().numpy(), ref.numpy(), atol=1))
+            self.assertEqual(qr.dequantize(), (qr.int_repr().float() - 2) * 0.03)
+
     def test_qtensor_permute(self):
         scale = 0.02
         zero_point = 1
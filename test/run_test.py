@@ -20,6 +20,7 @@ import torch.distributed as dist
 
 TESTS = [
     'test_autograd',
+    'test_autocast',
     'test_bundled_inputs',
     'test_complex',
     'test_cpp_api_parity',
@@ -55,6 +56,8 @@ TESTS = [
     'test_vulkan',
     'test_quantization',
     'test_sparse',
+    'test_sparse_csr',
+    'test_block_sparse',
     'test_spectral_ops',
     'test_serialization',
     'test_show_pickle',
@@ -125,6 +128,7 @@ RUN_PARALLEL_BLOCKLIST = [
 SLOW_TESTS = [
     'test_nn',
     'test_autograd',
+    'test_autocast',
     'test_cpp_extensions_jit',
     'test_jit_legacy',
     'test_dataloader',
@@ -0,0 +1,64 @@
+import torch
+from torch.testing._internal.common_utils import TestCase, run_tests
+
+
+class TestAutocastCPU(TestCase):
+    def tearDown(self):
+        torch.set_autocast_cache_persistent(False)
+        torch.clear_autocast_cache()
+        super(TestAutocastCPU, self).tearDown()
+
+    def test_autocast_enabled_state(self):
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+        with torch.cpu.amp.autocast():
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+            self.assertFalse(torch.is_autocast_enabled())
+            with torch.cpu.amp.autocast(enabled=False):
+                self.assertFalse(torch.is_autocast_cpu_enabled())
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+
+    def test_autocast_lower_precision_fp(self):
+        a = torch.randn(4, 5)
+        b = torch.randn(5, 3)
+        with torch.cpu.amp.autocast():
+            out = torch.mm(a, b)
+            self.assertEqual(out.dtype, torch.bfloat16)
+            self.assertEqual(out, torch.mm(a.bfloat16(), b.bfloat16()))
+            # double and integral tensors are not eligible
+            self.assertEqual(torch.mm(a.double(), b.double()).dtype, torch.float64)
+        self.assertEqual(torch.mm(a, b).dtype, torch.float32)
+
+    def test_autocast_fp32(self):
+        x = torch.randn(4, 5).bfloat16()
+        with torch.cpu.amp.autocast():
+            self.assertEqual(torch.exp(x).dtype, torch.float32)
+            self.assertEqual(torch.softmax(x, 0).dtype, torch.float32)
+            self.assertEqual(torch.sum(x, dtype=torch.bfloat16).dtype, torch.bfloat16)
+
+    def test_autocast_promote(self):
+        a = torch.randn(4, 5)
+        b = torch.randn(4, 5).bfloat16()
+        with torch.cpu.amp.autocast():
+            self.assertEqual(torch.cat((a, b)).dtype, torch.float32)
+            self.assertEqual(torch.cat((b, b)).dtype, torch.bfloat16)
+
+    def test_autocast_persistent_weight_cache(self):
+        weight = torch.randn(3, 5, requires_grad=True)
+        x = torch.randn(4, 5)
+        torch.set_autocast_cache_persistent(True)
+        self.assertTrue(torch.is_autocast_cache_persistent())
+        with torch.no_grad():
+            with torch.cpu.amp.autocast():
+                out = torch.nn.functional.linear(x, weight)
+            with torch.cpu.amp.autocast():
+                self.assertEqual(torch.nn.functional.linear(x, weight), out)
+            # An in-place update of the weight invalidates its cached cast
+            weight.mul_(2)
+            with torch.cpu.amp.autocast():
+                out = torch.nn.functional.linear(x, weight)
+            self.assertEqual(out, torch.nn.functional.linear(x.bfloat16(), weight.bfloat16()))
+
+
+if __name__ == '__main__':
+    run_tests()
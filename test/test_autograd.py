@@ -293,6 +293,28 @@ class TestAutograd(TestCase):
                 not create_graph,
                 create_graph)
 
+    def test_accumulate_grad_in_place(self):
+        x = torch.randn(5, 5, requires_grad=True)
+        accumulate_grad = x.expand_as(x).grad_fn.next_functions[0][0]
+        self.assertFalse(accumulate_grad.accumulate_in_place)
+        accumulate_grad.accumulate_in_place = True
+        self.assertTrue(accumulate_grad.accumulate_in_place)
+        with self.assertRaisesRegex(TypeError, "must be a bool"):
+            accumulate_grad.accumulate_in_place = 1
+
+        x.grad = torch.zeros(5, 5)
+        grad_saved = x.grad
+        (x * 2).sum().backward(create_graph=True)
+        (x * 3).sum().backward(create_graph=True)
+        self.assertIs(x.grad, grad_saved)
+        self.assertEqual(x.grad, torch.full((5, 5), 5.))
+
+        # The sum must stay differentiable if new_grad requires grad.
+        (x * x).sum().backward(create_graph=True)
+        self.assertIsNot(x.grad, grad_saved)
+        self.assertTrue(x.grad.requires_grad)
+        self.assertEqual(x.grad, 5 + 2 * x)
+
     @skipIfNoLapack
     def test_slogdet_sign(self):
         a = torch.randn(3, 3, requires_grad=True)
@@ -934,6 +956,45 @@ class TestAutograd(TestCase):
             w = adder(x, y)
             self.assertFalse(torch.is_grad_enabled())
 
+    def test_inference_mode(self):
+        x = torch.ones(5, 5, requires_grad=True)
+        y = torch.ones(5, 5) * 4
+        with torch.inference_mode():
+            self.assertTrue(torch.autograd._is_inference_mode_enabled())
+            self.assertFalse(torch.is_grad_enabled())
+            w = x + y
+            w.add_(1)
+            v = w.view(-1)
+            with torch.inference_mode(False):
+                self.assertFalse(torch.autograd._is_inference_mode_enabled())
+        self.assertFalse(torch.autograd._is_inference_mode_enabled())
+        self.assertTrue(torch.is_grad_enabled())
+
+        self.assertFalse(w.requires_grad)
+        self.assertIsNone(w.grad_fn)
+        self.assertFalse(v._is_view())
+        with self.assertRaisesRegex(RuntimeError, "Inference tensors do not track version counter"):
+            w._version
+
+        @torch.inference_mode()
+        def adder(x, y):
+            return x + y
+
+        z = adder(x, y)
+        self.assertFalse(z.requires_grad)
+        self.assertIsNone(z.grad_fn)
+
+        # Inference tensors can't be saved for backward, clones can
+        with self.assertRaisesRegex(RuntimeError, "Inference tensors do not track version counter"):
+            x * w
+        (x * w.clone()).sum().backward()
+        self.assertEqual(x.grad, w)
+
+        # Views of inference tensors can still be taken outside of inference mode
+        u = w.view(-1)
+        self.assertTrue(u._is_view())
+        self.assertEqual(u, w.view(-1))
+
     def test_set_grad_generator_functions(self):
         @torch.no_grad()
         def gen_no_grad():
@@ -2041,6 +2102,41 @@ class TestAutograd(TestCase):
         self.assertRaisesRegex(RuntimeError, 'modified by an inplace operation',
                                lambda: z.backward())
 
+    def test_autograd_fast_path(self):
+        # Calls that record no graph skip the Autograd kernel, see
+        # Note [Autograd fast path]; they must behave as if it ran.
+        self.assertTrue(torch._C._dispatch_autograd_fast_path_enabled())
+
+        def run():
+            x = torch.randn(5, 5)
+            w = torch.randn(5, 5, requires_grad=True)
+            out = torch.mm(x, x)
+            self.assertFalse(out.requires_grad)
+            self.assertIsNone(out.grad_fn)
+            # Only one of the inputs requires grad
+            out = torch.mm(x, w)
+            self.assertIsNotNone(out.grad_fn)
+            out.sum().backward()
+            self.assertEqual(w.grad, x.t().mm(torch.ones(5, 5)))
+            with torch.no_grad():
+                out = torch.mm(x, w)
+                self.assertIsNone(out.grad_fn)
+                # Views and in-place ops still go through autograd
+                view = w.view(25)
+                self.assertIs(view._base, w)
+                version = x._version
+                x.add_(1)
+                self.assertEqual(x._version, version + 1)
+            return out
+
+        expected = run()
+        try:
+            torch._C._dispatch_set_autograd_fast_path_enabled(False)
+            run()
+        finally:
+            torch._C._dispatch_set_autograd_fast_path_enabled(True)
+        self.assertEqual(expected.shape, (5, 5))
+
     def test_no_grad_input(self):
         class MyFunction(Function):
             @staticmethod
@@ -2751,6 +2847,68 @@ class TestAutograd(TestCase):
         self.assertTrue(found_bwd_sum)
         self.assertTrue(found_empty)
 
+    def test_sampling_profiler(self):
+        x = torch.randn(10, 10, requires_grad=True)
+
+        def run(buffer_size):
+            # With a probability of 1, every range is recorded.
+            with torch.autograd.profiler.sampling_profile(
+                    sampling_prob=1.0, buffer_size=buffer_size) as prof:
+                self.assertTrue(torch.autograd._sampling_profiler_enabled())
+                for _ in range(10):
+                    (x * 2).sum().backward()
+            self.assertFalse(torch.autograd._sampling_profiler_enabled())
+            with tempfile.NamedTemporaryFile(mode="w+") as f:
+                prof.export_chrome_trace(f.name)
+                return json.load(f)
+
+        trace = run(buffer_size=4096)
+        names = [event["name"] for event in trace]
+        self.assertEqual(names.count("aten::sum"), 10)
+        self.assertEqual(names.count("MulBackward0"), 10)
+        for event in trace:
+            self.assertGreaterEqual(event["dur"], 0)
+
+        # Only the last ranges of every thread are kept.
+        trace = run(buffer_size=4)
+        threads = {event["tid"] for event in trace}
+        self.assertLessEqual(len(trace), 4 * len(threads))
+
+        with self.assertRaisesRegex(RuntimeError, "Sampling probability"):
+            torch.autograd._enable_sampling_profiler(0., 8)
+
+    def test_operator_stats(self):
+        x = torch.randn(10, 10)
+        torch.autograd._enable_operator_stats(True)
+        try:
+            self.assertTrue(torch.autograd._operator_stats_enabled())
+            for _ in range(10):
+                torch.add(x, x)
+        finally:
+            torch.autograd._disable_operator_stats()
+        self.assertFalse(torch.autograd._operator_stats_enabled())
+
+        add_stats = [
+            op_stats for key, op_stats in torch.autograd._get_operator_stats().items()
+            if key.startswith("aten::add/")]
+        self.assertEqual(sum(op_stats.count for op_stats in add_stats), 10)
+        self.assertEqual(
+            sum(op_stats.input_bytes for op_stats in add_stats),
+            10 * 2 * x.numel() * x.element_size())
+        for op_stats in add_stats:
+            self.assertGreaterEqual(op_stats.total_time_ns, 0)
+
+        exported = torch.autograd._export_operator_stats("ops")
+        self.assertEqual(
+            sum(value for key, value in exported.items()
+                if key.startswith("ops/aten::add/") and key.endswith("/count")),
+            10)
+
+        # Enabling again discards the earlier stats.
+        torch.autograd._enable_operator_stats(False)
+        torch.autograd._disable_operator_stats()
+        self.assertEqual(torch.autograd._get_operator_stats(), {})
+
     def test_profiler_unboxed_only(self):
         x = torch.rand(3, 4)
 
@@ -2923,6 +3081,28 @@ class TestAutograd(TestCase):
                 self.assertEqual(event.input_shapes, input_shape_expected)
                 last_end = event.cpu_interval.end
 
+    def test_profiler_hw_counters(self):
+        x = torch.randn(256, 256)
+        with profile(record_hw_counters=True) as prof:
+            torch.mm(x, x)
+
+        mm_events = [evt for evt in prof.function_events if evt.name == 'aten::mm']
+        self.assertEqual(len(mm_events), 1)
+        counters = mm_events[0].hw_counters
+        self.assertIsNotNone(counters)
+        self.assertEqual(set(counters.keys()), set(torch.autograd.profiler.HW_COUNTER_NAMES))
+        if counters['instructions'] is None:
+            self.skipTest("Hardware counters are not available")
+        # A 256x256 matmul runs millions of instructions
+        self.assertGreater(counters['instructions'], 1e6)
+        self.assertGreater(counters['cycles'], 0)
+        self.assertIn('Self IPC', prof.key_averages().table())
+
+        with profile() as prof:
+            torch.mm(x, x)
+        self.assertTrue(all(evt.hw_counters is None for evt in prof.function_events))
+        self.assertNotIn('Self IPC', prof.table())
+
     def test_profiler_no_cuda(self):
         print("")
         layer = torch.nn.Linear(20, 30)
@@ -3349,6 +3529,44 @@ class TestAutograd(TestCase):
         d, = torch.autograd.grad(c, a, retain_graph=True, create_graph=True)
         self.assertTrue(d.requires_grad)
 
+    def test_saved_tensors_hooks(self):
+        packed = []
+
+        def pack_hook(x):
+            packed.append(x)
+            return len(packed) - 1
+
+        def unpack_hook(i):
+            return packed[i]
+
+        a = torch.randn(5, 5, requires_grad=True)
+        with torch.autograd.saved_tensors_hooks(pack_hook, unpack_hook):
+            b = a.exp()
+            y = (b * b).sum()
+        # a itself is a leaf that requires grad and is not packed
+        self.assertEqual(len(packed), 3)
+        y.backward(retain_graph=True)
+        self.assertEqual(a.grad, 2 * a.exp() ** 2)
+        y.backward()
+        self.assertEqual(a.grad, 4 * a.exp() ** 2)
+
+        with torch.autograd.saved_tensors_hooks(lambda x: x, lambda x: 1):
+            y = a.exp()
+        with self.assertRaisesRegex(RuntimeError, "expected to be a Tensor"):
+            y.sum().backward()
+
+    def test_save_compressed(self):
+        a = torch.randn(5, 5, requires_grad=True)
+        with torch.autograd.save_compressed(torch.bfloat16):
+            y = (a.exp() * a.exp()).sum()
+        y.backward()
+        expected = 2 * a.exp().to(torch.bfloat16).float() ** 2
+        self.assertEqual(a.grad, expected)
+
+        with self.assertRaisesRegex(RuntimeError, "Half or BFloat16"):
+            with torch.autograd.save_compressed(torch.int8):
+                pass
+
     def test_anomaly_detect_nan(self):
         size = 10
 
@@ -5719,6 +5937,25 @@ class TestAutogradFunctional(TestCase):
 # Generic device type autograd tests.
 class TestAutogradDeviceType(TestCase):
 
+    def test_save_on_cpu(self, device):
+        a = torch.randn(5, 5, device=device, requires_grad=True)
+        with torch.autograd.save_on_cpu(prefetch=1):
+            y = a
+            for _ in range(4):
+                y = y.sin() * y
+        y.sum().backward(retain_graph=True)
+        grad = a.grad.clone()
+        a.grad = None
+        y.sum().backward()
+        self.assertEqual(a.grad, grad)
+
+        b = a.detach().requires_grad_()
+        y = b
+        for _ in range(4):
+            y = y.sin() * y
+        y.sum().backward()
+        self.assertEqual(b.grad, grad)
+
     def test_min_max_median_backprops_to_single_value(self, device):
         for f in [torch.min, torch.max, torch.median]:
             x = torch.tensor([1., 0., 1., 0., 1., 0.], device=device, requires_grad=True)
@@ -6726,6 +6963,71 @@ class TestMultithreadAutograd(TestCase):
         # result should equal to num_thread * gradients
         self.assertEqual(x_retain.grad, 5 * (4 * x_retain ** 3 + 6 * (x_retain ** 2) + 4 * x_retain + 1))
 
+    def test_cpu_workers(self):
+        # ready CPU tasks of a backward call run on a pool of worker threads
+        engine = Variable._execution_engine
+        engine.set_num_cpu_workers(3)
+        try:
+            self.assertEqual(engine.get_num_cpu_workers(), 3)
+
+            class MyFunction(Function):
+                @staticmethod
+                def forward(ctx, x):
+                    return x * 2
+
+                @staticmethod
+                def backward(ctx, grad):
+                    return grad * 2
+
+            x = torch.randn(5, 5, requires_grad=True)
+            branches = [MyFunction.apply(x * i).sin() for i in range(8)]
+            torch.stack(branches).sum().backward()
+            expected = sum(2 * i * (2 * i * x).cos() for i in range(8))
+            self.assertEqual(x.grad, expected)
+
+            # backward calls from several threads share the pool
+            def train_fn():
+                y = torch.ones(5, 5, requires_grad=True)
+                z = torch.stack([(y + 3) * (y + 4) * 0.5, y.sin(), y.cos()]).sum()
+                z.backward()
+                self.assertEqual(y.grad, y + 3.5 + y.cos() - y.sin())
+
+            self._run_py_multithread_fn(train_fn)
+
+            with self.assertRaisesRegex(RuntimeError, "must not be negative"):
+                engine.set_num_cpu_workers(-1)
+        finally:
+            engine.set_num_cpu_workers(0)
+
+    def test_backward_plan_cache(self):
+        engine = Variable._execution_engine
+        engine.set_backward_plan_cache_enabled(True)
+        try:
+            self.assertTrue(engine.is_backward_plan_cache_enabled())
+
+            class MyFunction(Function):
+                @staticmethod
+                def forward(ctx, x):
+                    return x * 2
+
+                @staticmethod
+                def backward(ctx, grad):
+                    return grad * 2
+
+            x = torch.randn(5, 5, requires_grad=True)
+            for _ in range(3):
+                y = MyFunction.apply(x)
+                (y.sin() + y * x).sum().backward()
+            y = 2 * x
+            self.assertEqual(x.grad, 3 * (2 * y.cos() + 2 * x + y))
+
+            # grad() does not use plans, but still works
+            z = torch.randn(5, requires_grad=True)
+            grad, = torch.autograd.grad((z * z).sum(), z)
+            self.assertEqual(grad, 2 * z)
+        finally:
+            engine.set_backward_plan_cache_enabled(False)
+
     def test_fork_join_in_middle(self):
         # multiple backward with jit threads (fork/join primitive)
         # similar to test_python_thread_in_middle, we test with retain_graph=False/True
@@ -0,0 +1,88 @@
+import io
+import itertools
+
+import torch
+from torch.nn import functional as F
+from torch.testing._internal.common_utils import TestCase, run_tests
+
+
+def _block_prune(weight, row_block_size, col_block_size, density):
+    """Zeroes all but a `density` fraction of the row x col blocks of weight."""
+    out_features, in_features = weight.shape
+    block_rows = (out_features + row_block_size - 1) // row_block_size
+    block_cols = (in_features + col_block_size - 1) // col_block_size
+    keep = torch.rand(block_rows, block_cols) < density
+    mask = keep.repeat_interleave(row_block_size, 0).repeat_interleave(col_block_size, 1)
+    return weight * mask[:out_features, :in_features].to(weight.dtype), keep
+
+
+class TestBlockSparseLinear(TestCase):
+    block_sizes = [(1, 4), (8, 1), (1, 1), (4, 4)]
+
+    def test_linear(self):
+        for (row_block_size, col_block_size), batch_shape, in_features, out_features, use_bias in itertools.product(
+                self.block_sizes, [(1,), (5,), (3, 17)], [7, 32], [5, 16], [True, False]):
+            weight, keep = _block_prune(torch.randn(out_features, in_features),
+                                        row_block_size, col_block_size, 0.3)
+            bias = torch.randn(out_features) if use_bias else None
+            x = torch.randn(*batch_shape, in_features)
+            packed = torch.ops.block_sparse.linear_prepack(weight, bias, row_block_size, col_block_size)
+            self.assertAlmostEqual(torch.ops.block_sparse.linear_density(packed),
+                                   keep.float().mean().item())
+            self.assertEqual(torch.ops.block_sparse.linear_run(x, packed),
+                             F.linear(x, weight, bias), atol=1e-4, rtol=1e-4)
+
+    def test_qlinear(self):
+        for (row_block_size, col_block_size), per_channel, use_bias in itertools.product(
+                self.block_sizes, [True, False], [True, False]):
+            batch_size, in_features, out_features = 9, 30, 13
+            weight, _ = _block_prune(torch.randn(out_features, in_features),
+                                     row_block_size, col_block_size, 0.25)
+            if per_channel:
+                scales = weight.abs().max(1)[0].clamp(min=1e-3) / 127
+                qweight = torch.quantize_per_channel(
+                    weight, scales.double(), torch.zeros(out_features, dtype=torch.long), 0, torch.qint8)
+            else:
+                qweight = torch.quantize_per_tensor(weight, weight.abs().max().item() / 127, 0, torch.qint8)
+            bias = torch.randn(out_features) if use_bias else None
+            qx = torch.quantize_per_tensor(torch.rand(batch_size, in_features), 1. / 255, 3, torch.quint8)
+            output_scale, output_zero_point = 0.05, 128
+
+            packed = torch.ops.block_sparse.linear_prepack(qweight, bias, row_block_size, col_block_size)
+            qy = torch.ops.block_sparse.qlinear_run(qx, packed, output_scale, output_zero_point)
+            ref = torch.quantize_per_tensor(
+                F.linear(qx.dequantize(), qweight.dequantize(), bias),
+                output_scale, output_zero_point, torch.quint8)
+            self.assertEqual(qy.q_scale(), output_scale)
+            self.assertEqual(qy.q_zero_point(), output_zero_point)
+            # Rounding of the float reference may differ by one step.
+            diff = (qy.int_repr().int() - ref.int_repr().int()).abs()
+            self.assertLessEqual(diff.max().item(), 1)
+
+    def test_rejects_asymmetric_weights(self):
+        qweight = torch.quantize_per_tensor(torch.randn(4, 8), 0.1, 2, torch.qint8)
+        with self.assertRaisesRegex(RuntimeError, "symmetric"):
+            torch.ops.block_sparse.linear_prepack(qweight, None, 1, 4)
+
+    def test_serialization(self):
+        class BlockSparseLinear(torch.nn.Module):
+            def __init__(self, weight, bias):
+                super(BlockSparseLinear, self).__init__()
+                self.packed = torch.ops.block_sparse.linear_prepack(weight, bias, 1, 4)
+
+            def forward(self, x):
+                return torch.ops.block_sparse.linear_run(x, self.packed)
+
+        weight, _ = _block_prune(torch.randn(12, 20), 1, 4, 0.5)
+        bias = torch.randn(12)
+        x = torch.randn(3, 20)
+        module = torch.jit.script(BlockSparseLinear(weight, bias))
+        buffer = io.BytesIO()
+        torch.jit.save(module, buffer)
+        buffer.seek(0)
+        loaded = torch.jit.load(buffer)
+        self.assertEqual(loaded(x), F.linear(x, weight, bias), atol=1e-4, rtol=1e-4)
+
+
+if __name__ == '__main__':
+    run_tests()
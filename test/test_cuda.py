@@ -3,12 +3,13 @@ import io
 import tempfile
 import unittest
 import sys
-from itertools import repeat, chain
+from itertools import repeat, chain, product
 import os
 import gc
 import threading
 import queue
 import pickle
+import time
 
 import torch
 import torch.cuda
@@ -287,6 +288,67 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             self._check_memory_stat_consistency()
 
+    def test_expandable_segments(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_ALLOC_CONF="expandable_segments:True")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+torch.cuda.empty_cache()
+mb = 1024 * 1024 // 4
+a, b, c = [torch.empty(30 * mb, device='cuda') for _ in range(3)]
+reserved = torch.cuda.memory_reserved()
+del a, b
+# the two freed neighbours coalesce, so this fits without growing the segment
+d = torch.empty(60 * mb, device='cuda')
+assert torch.cuda.memory_reserved() == reserved, (torch.cuda.memory_reserved(), reserved)
+del c, d
+torch.cuda.empty_cache()
+assert torch.cuda.memory_reserved() == 0, torch.cuda.memory_reserved()
+stats = torch.cuda.memory_stats()
+assert stats['segment.all.current'] == 0
+assert stats['inactive_split.all.current'] == 0
+"""], env=env)
+
+    def test_allocator_settings(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_ALLOC_CONF=(
+            "max_split_size_mb:40,roundup_power2_divisions:4,garbage_collection_threshold:0.9"))
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+# 5 MiB + 4 bytes is rounded up to the next quarter between 4 and 8 MiB
+x = torch.empty(5 * 1024 * 1024 + 4, dtype=torch.uint8, device='cuda')
+assert torch.cuda.memory_allocated() == 6 * 1024 * 1024, torch.cuda.memory_allocated()
+"""], env=env)
+
+        env["PYTORCH_CUDA_ALLOC_CONF"] = "roundup_power2_divisions:3"
+        with self.assertRaises(subprocess.CalledProcessError):
+            subprocess.check_call([sys.executable, '-c', "import torch; torch.empty(1, device='cuda')"],
+                                  env=env, stderr=subprocess.DEVNULL)
+
+    def test_memory_snapshot_history(self):
+        try:
+            torch.cuda.memory.empty_cache()
+            torch.cuda.memory._record_memory_history(True, trace_alloc_max_entries=100)
+            x = torch.rand(311, 411, device='cuda')
+            ptr = x.data_ptr()
+
+            ss = torch.cuda.memory._snapshot()
+            found_it = False
+            for seg in ss['segments']:
+                for b in seg['blocks']:
+                    if 'history' in b and any(f['name'] == 'test_memory_snapshot_history'
+                                              for f in b['history']['frames']):
+                        found_it = True
+            self.assertTrue(found_it)
+
+            del x
+            trace = torch.cuda.memory._snapshot()['device_traces'][torch.cuda.current_device()]
+            actions = [e['action'] for e in trace if e['addr'] == ptr]
+            self.assertIn('alloc', actions)
+            self.assertEqual(actions[-1], 'free')
+        finally:
+            torch.cuda.memory._record_memory_history(False)
+
     def test_memory_allocation(self):
         gc.collect()
         torch.cuda.empty_cache()
@@ -493,6 +555,46 @@ class TestCuda(TestCase):
         y = torch.ones(10000000, dtype=torch.uint8).cuda()
         _test_copy_non_blocking(x, y)
 
+    def test_elementwise_broadcast_layouts(self):
+        # Inner-contiguous broadcasts take the 2-D vectorized loop, see
+        # Note [Broadcast vectorized loops]. Odd and offset shapes exercise
+        # the unaligned and partial rows.
+        for dtype in [torch.float, torch.half, torch.int]:
+            for rows, cols in [(3, 1000), (70000, 256), (5, 4099), (1000, 130)]:
+                x = torch.randn(rows, cols + 1).mul(10).to(dtype)
+                bias = torch.randn(cols).mul(10).to(dtype)
+                scale = torch.randn(rows, 1).mul(10).to(dtype)
+                for a, b in [(x, bias), (x, scale), (x[:, 1:], bias), (x[:, 1:], scale)]:
+                    self.assertEqual((a.cuda() + b.cuda()).cpu(), (a.float() + b.float()).to(dtype))
+                    self.assertEqual((a.cuda() * b.cuda()).cpu(), (a.float() * b.float()).to(dtype))
+
+            # Per-channel scales of NCHW and channels-last tensors.
+            x = torch.randn(4, 32, 17, 19).mul(10).to(dtype)
+            scale = torch.randn(1, 32, 1, 1).mul(10).to(dtype)
+            for memory_format in [torch.contiguous_format, torch.channels_last]:
+                a = x.contiguous(memory_format=memory_format)
+                self.assertEqual((a.cuda() * scale.cuda()).cpu(), (a.float() * scale.float()).to(dtype))
+
+    def test_copy_non_blocking_pageable(self):
+        # Copies from pageable memory are staged through pinned buffers, see
+        # Note [Staged pageable copies]. Odd sizes leave a partial last chunk.
+        for numel in [10, 100001, 10000001]:
+            src = torch.arange(numel, dtype=torch.float)
+            dst = torch.zeros(numel, device='cuda')
+            dst.copy_(src, non_blocking=True)
+            expected = src.clone()
+            # The source can be reused right away.
+            src.zero_()
+            torch.cuda.current_stream().synchronize()
+            self.assertEqual(dst.cpu(), expected)
+
+        # Non-contiguous and type-converting copies go through temporaries.
+        src = torch.randn(300, 500, dtype=torch.double).t()
+        dst = torch.cuda.FloatTensor(500, 300)
+        dst.copy_(src, non_blocking=True)
+        torch.cuda.current_stream().synchronize()
+        self.assertEqual(dst.cpu(), src.float())
+
     @unittest.skip("skipped because test could be flaky, see #35144")
     def test_to_non_blocking(self):
         def _test_to_non_blocking(a, non_blocking):
@@ -961,6 +1063,19 @@ class TestCuda(TestCase):
         self.assertEqual(high, s1.priority)
         self.assertEqual(torch.device('cuda:1'), s1.device)
 
+    def test_reserved_stream(self):
+        prev = torch.cuda.current_stream()
+        with torch.cuda.reserved_stream(priority=-1) as s:
+            self.assertEqual(torch.cuda.current_stream(), s)
+            self.assertNotEqual(s, prev)
+            # round-robin pool streams skip the reserved stream
+            for _ in range(64):
+                self.assertNotEqual(torch.cuda.Stream(priority=-1), s)
+            x = torch.ones(1000, device='cuda') * 2
+        s.synchronize()
+        self.assertEqual(x.sum().item(), 2000)
+        self.assertEqual(torch.cuda.current_stream(), prev)
+
     @unittest.skipIf(not TEST_MULTIGPU, "multi-GPU not supported")
     def test_tensor_device(self):
         self.assertEqual(torch.cuda.FloatTensor(1).get_device(), 0)
@@ -983,6 +1098,120 @@ class TestCuda(TestCase):
         self.assertTrue(event.query())
         self.assertGreater(start_event.elapsed_time(event), 0)
 
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_capture_simple(self):
+        s = torch.cuda.Stream()
+
+        with torch.cuda.stream(s):
+            a = torch.full((1000,), 1, device="cuda")
+            g = torch.cuda.CUDAGraph()
+            torch.cuda.empty_cache()
+            g.capture_begin()
+            b = a
+            for _ in range(10):
+                b = b + 1
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        g.replay()
+
+        self.assertTrue(b.sum().item() == 11000.)
+
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_rng_functional(self):
+        a = torch.randn((10000,), device="cuda", dtype=torch.float)
+        ops = (lambda t: torch.nn.functional.dropout(t, p=0.1),
+               lambda t: torch.bernoulli(t.sigmoid()))
+
+        for op in ops:
+            # Runs a "control" with eager execution
+            torch.cuda.manual_seed(5)
+            eager_outs = [op(a) for _ in range(3)]
+
+            torch.cuda.manual_seed(5)
+            s = torch.cuda.Stream()
+            s.wait_stream(torch.cuda.current_stream())
+            with torch.cuda.stream(s):
+                g = torch.cuda.CUDAGraph()
+                g.capture_begin()
+                graph_out = op(a)
+                g.capture_end()
+            torch.cuda.current_stream().wait_stream(s)
+
+            # Each replay should consume the same philox offsets as the
+            # corresponding eager call.
+            for eager_out in eager_outs:
+                g.replay()
+                self.assertEqual(graph_out, eager_out)
+
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_error(self):
+        g = torch.cuda.CUDAGraph()
+        with self.assertRaisesRegex(RuntimeError, "non-default stream"):
+            g.capture_begin()
+        # The failed capture must not leave the default generator expecting a graph.
+        torch.rand(10, device="cuda")
+
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_nonzero_masked_select_static(self):
+        # Unlike nonzero and masked_select, the static size variants don't
+        # synchronize, so they can be captured
+        s = torch.cuda.Stream()
+        x = torch.zeros(1000, device="cuda")
+        with torch.cuda.stream(s):
+            torch.cuda.empty_cache()
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            indices, count = torch._nonzero_static(x, 10)
+            values, value_count = torch._masked_select_static(x, x > 0, 10)
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        for positions in ([3, 500, 999], list(range(0, 1000, 50))):
+            x.zero_()
+            x[positions] = torch.arange(1., len(positions) + 1, device="cuda")
+            g.replay()
+            used = min(len(positions), 10)
+            self.assertEqual(count.item(), len(positions))
+            self.assertEqual(indices[:used, 0].tolist(), positions[:used])
+            self.assertTrue((indices[used:] == -1).all())
+            self.assertEqual(value_count.item(), len(positions))
+            self.assertEqual(values[:used].tolist(), list(range(1, used + 1)))
+
+    @unittest.skipIf((not TEST_CUDA) or
+                     TEST_WITH_ROCM or
+                     int(torch.version.cuda.split(".")[0]) < 11, "CUDA >= 11.0 required for graphs")
+    def test_graph_memory_pool_sharing(self):
+        s = torch.cuda.Stream()
+        s.wait_stream(torch.cuda.current_stream())
+        with torch.cuda.stream(s):
+            a = torch.ones((1000,), device="cuda")
+            pool = torch.cuda.graph_pool_handle()
+            g0 = torch.cuda.CUDAGraph()
+            g0.capture_begin(pool)
+            b = a * 2
+            g0.capture_end()
+            g1 = torch.cuda.CUDAGraph()
+            g1.capture_begin(pool)
+            c = b + 1
+            g1.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        g0.replay()
+        g1.replay()
+        self.assertEqual(c.sum().item(), 3000.)
+
+        del g0, g1
+        torch.cuda.synchronize()
+
     @staticmethod
     def _stream_synchronize(self, spin_time_cycles):
         s = torch.cuda.current_stream()
@@ -1284,6 +1513,34 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, msg='allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_caching_pinned_memory_stats(self):
+        # 1000 bytes are rounded up to the 1024 bytes size class
+        t = torch.empty(1000, dtype=torch.uint8).pin_memory()
+        stats = torch.cuda.host_memory_stats()
+        self.assertGreaterEqual(stats["allocated_bytes.current"], 1024)
+        self.assertGreaterEqual(stats["reserved_bytes.peak"], stats["reserved_bytes.current"])
+        allocated = stats["allocated_bytes.current"]
+        del t
+        self.assertEqual(torch.cuda.host_memory_stats()["allocated_bytes.current"], allocated - 1024)
+
+        # a request of the same size class reuses the cached block
+        hits = torch.cuda.host_memory_stats()["num_cache_hits"]
+        t = torch.empty(1020, dtype=torch.uint8).pin_memory()
+        self.assertEqual(torch.cuda.host_memory_stats()["num_cache_hits"], hits + 1)
+
+        # once over the cache limit, cached blocks are released in the background
+        try:
+            frees = torch.cuda.host_memory_stats()["num_host_frees"]
+            torch.cuda.set_host_memory_cache_limit(0)
+            del t
+            for _ in range(100):
+                if torch.cuda.host_memory_stats()["num_host_frees"] > frees:
+                    break
+                time.sleep(0.01)
+            self.assertGreater(torch.cuda.host_memory_stats()["num_host_frees"], frees)
+        finally:
+            torch.cuda.set_host_memory_cache_limit(sys.maxsize)
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -1772,6 +2029,55 @@ t2.start()
         self.assertEqual(growth_tracker, 0)
         self.assertEqual(scale, 2.0)
 
+
+    def test_grad_scaling_foreach_non_finite_check(self, device="cuda", dtype=torch.float):
+        grads = [torch.full((1000,), 4.0, dtype=dtype, device=device) for _ in range(3)]
+        found_inf = torch.tensor([0.0], dtype=torch.float, device=device)
+        torch._amp_foreach_non_finite_check_(grads, found_inf)
+        self.assertEqual(found_inf, 0.0)
+        # The gradients are only read.
+        self.assertEqual(grads[0], torch.full((1000,), 4.0, dtype=dtype, device=device))
+
+        for bad in (float('inf'), float('nan')):
+            found_inf.zero_()
+            grads[2][777] = bad
+            torch._amp_foreach_non_finite_check_(grads, found_inf)
+            self.assertEqual(found_inf, 1.0)
+            grads[2][777] = 4.0
+
+    def test_fused_optimizer_steps_with_grad_scaling(self, device="cuda"):
+        def make(n):
+            torch.manual_seed(0)
+            return [torch.randn(37 * i + 5, device=device) for i in range(1, n + 1)]
+
+        inv_scale = torch.tensor([0.25], dtype=torch.float, device=device)
+        found_inf = torch.tensor([0.0], dtype=torch.float, device=device)
+
+        for amsgrad, decoupled in product((False, True), (False, True)):
+            params, grads = make(4), [g * 4 for g in make(4)]
+            exp_avgs = [torch.zeros_like(p) for p in params]
+            exp_avg_sqs = [torch.zeros_like(p) for p in params]
+            max_exp_avg_sqs = [torch.zeros_like(p) for p in params] if amsgrad else []
+            ref = [p.clone() for p in params]
+            ref_state = [torch.zeros_like(p) for p in params]
+            torch._fused_adam_(ref, [g * 0.25 for g in grads], ref_state, [torch.zeros_like(p) for p in params],
+                               [torch.zeros_like(p) for p in params] if amsgrad else [],
+                               1, 1e-3, 0.9, 0.999, 1e-2, 1e-8, amsgrad, decoupled)
+            torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs,
+                               1, 1e-3, 0.9, 0.999, 1e-2, 1e-8, amsgrad, decoupled,
+                               inv_scale=inv_scale, found_inf=found_inf)
+            self.assertEqual(params, ref)
+            self.assertEqual(exp_avgs, ref_state)
+
+        params, grads = make(4), make(4)
+        bufs = [torch.zeros_like(p) for p in params]
+        before = [p.clone() for p in params]
+        found_inf.fill_(1.0)
+        torch._fused_sgd_(params, grads, bufs, 0.1, 0.9, 0.0, 0.0, False, True,
+                          inv_scale=inv_scale, found_inf=found_inf)
+        # A step with found_inf set leaves everything untouched.
+        self.assertEqual(params, before)
+        self.assertEqual(bufs, [torch.zeros_like(p) for p in params])
     def test_grad_scaling_unscale_sparse(self, device="cuda", dtype=torch.float):
         scaler = torch.cuda.amp.GradScaler()
 
@@ -1,7 +1,7 @@
 import torch
 import torch.cuda
 from torch.testing._internal.common_utils import TestCase, run_tests
-from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes
+from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, dtypesIfCUDA
 
 class TestForeach(TestCase):
     @dtypes(*torch.testing.get_all_dtypes())
@@ -96,6 +96,117 @@ class TestForeach(TestCase):
         res = torch._foreach_add(tensors, scalar)
         self.assertEqual(res, [torch.tensor([1.1], device=device)])
 
+    def _get_test_data(self, device, dtype, N=20):
+        if dtype in [torch.bfloat16, torch.bool, torch.float16]:
+            return [torch.randn(N, N, device=device).to(dtype) for _ in range(N)]
+        if dtype in torch.testing.get_all_int_dtypes():
+            return [torch.randint(1, 100, (N, N), device=device, dtype=dtype) for _ in range(N)]
+        return [torch.randn(N, N, device=device, dtype=dtype) for _ in range(N)]
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(*torch.testing.get_all_fp_dtypes())
+    def test_binary_ops_scalar(self, device, dtype):
+        for foreach_op, foreach_op_, torch_op in [
+                (torch._foreach_add, torch._foreach_add_, torch.add),
+                (torch._foreach_mul, torch._foreach_mul_, torch.mul),
+                (torch._foreach_div, torch._foreach_div_, torch.div)]:
+            tensors = self._get_test_data(device, dtype)
+            expected = [torch_op(t, 3) for t in tensors]
+            self.assertEqual(foreach_op(tensors, 3), expected)
+            foreach_op_(tensors, 3)
+            self.assertEqual(tensors, expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(*torch.testing.get_all_fp_dtypes())
+    def test_binary_ops_list(self, device, dtype):
+        for foreach_op, foreach_op_, torch_op in [
+                (torch._foreach_mul, torch._foreach_mul_, torch.mul),
+                (torch._foreach_div, torch._foreach_div_, torch.div)]:
+            tensors1 = self._get_test_data(device, dtype)
+            tensors2 = self._get_test_data(device, dtype)
+            expected = [torch_op(t1, t2) for t1, t2 in zip(tensors1, tensors2)]
+            self.assertEqual(foreach_op(tensors1, tensors2), expected)
+            foreach_op_(tensors1, tensors2)
+            self.assertEqual(tensors1, expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(*torch.testing.get_all_fp_dtypes())
+    def test_add_list_alpha(self, device, dtype):
+        tensors1 = self._get_test_data(device, dtype)
+        tensors2 = self._get_test_data(device, dtype)
+        expected = [torch.add(t1, t2, alpha=2) for t1, t2 in zip(tensors1, tensors2)]
+        self.assertEqual(torch._foreach_add(tensors1, tensors2, alpha=2), expected)
+        torch._foreach_add_(tensors1, tensors2, alpha=2)
+        self.assertEqual(tensors1, expected)
+
+    @dtypes(torch.float, torch.double)
+    def test_sqrt(self, device, dtype):
+        tensors = [t.abs() for t in self._get_test_data(device, dtype)]
+        expected = [torch.sqrt(t) for t in tensors]
+        self.assertEqual(torch._foreach_sqrt(tensors), expected)
+        torch._foreach_sqrt_(tensors)
+        self.assertEqual(tensors, expected)
+
+    @dtypes(torch.float, torch.double)
+    def test_pointwise_ops(self, device, dtype):
+        for foreach_op, foreach_op_, torch_op in [
+                (torch._foreach_addcmul, torch._foreach_addcmul_, torch.addcmul),
+                (torch._foreach_addcdiv, torch._foreach_addcdiv_, torch.addcdiv)]:
+            inputs = self._get_test_data(device, dtype)
+            tensors1 = self._get_test_data(device, dtype)
+            tensors2 = self._get_test_data(device, dtype)
+            expected = [torch_op(i, t1, t2, value=0.5) for i, t1, t2 in zip(inputs, tensors1, tensors2)]
+            self.assertEqual(foreach_op(inputs, tensors1, tensors2, 0.5), expected)
+            foreach_op_(inputs, tensors1, tensors2, 0.5)
+            self.assertEqual(inputs, expected)
+
+    @dtypes(torch.float, torch.double)
+    def test_lerp(self, device, dtype):
+        for weight in [0.25, 0.75]:
+            tensors1 = self._get_test_data(device, dtype)
+            tensors2 = self._get_test_data(device, dtype)
+            expected = [torch.lerp(t1, t2, weight) for t1, t2 in zip(tensors1, tensors2)]
+            self.assertEqual(torch._foreach_lerp(tensors1, tensors2, weight), expected)
+            torch._foreach_lerp_(tensors1, tensors2, weight)
+            self.assertEqual(tensors1, expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(*torch.testing.get_all_fp_dtypes())
+    def test_mul_tensor(self, device, dtype):
+        tensors = self._get_test_data(device, dtype)
+        scale = torch.tensor(0.5, device=device)
+        expected = [t * scale for t in tensors]
+        torch._foreach_mul_(tensors, scale)
+        self.assertEqual(tensors, expected)
+
+        with self.assertRaisesRegex(RuntimeError, "one-element tensor"):
+            torch._foreach_mul_(tensors, torch.ones(2, device=device))
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(*torch.testing.get_all_fp_dtypes())
+    def test_norm(self, device, dtype):
+        # Sizes that span several chunks of the CUDA kernel, mixed with small ones.
+        tensors = [(torch.randn(n, device=device) * 0.01).to(dtype) for n in [1, 7, 65536 * 2 + 3, 100]]
+        for ord in [1, 2, float('inf'), 3]:
+            expected = [torch.norm(t, ord) for t in tensors]
+            self.assertEqual(torch._foreach_norm(tensors, ord), expected)
+
+    def test_list_ops_with_mixed_layouts(self, device):
+        # Non-contiguous and expanded tensors go through the slow route.
+        tensors1 = [torch.randn(4, 3, device=device).t(), torch.randn(3, 1, device=device).expand(3, 4)]
+        tensors2 = [torch.randn(3, 4, device=device), torch.randn(3, 4, device=device)]
+        expected = [t1.add(t2, alpha=2) for t1, t2 in zip(tensors1, tensors2)]
+        self.assertEqual(torch._foreach_add(tensors1, tensors2, alpha=2), expected)
+
+    def test_list_ops_errors(self, device):
+        tensors1 = [torch.zeros(2, 2, device=device) for _ in range(3)]
+        with self.assertRaisesRegex(RuntimeError, "same number of tensors"):
+            torch._foreach_mul(tensors1, tensors1[:2])
+        with self.assertRaisesRegex(RuntimeError, "same size"):
+            torch._foreach_mul(tensors1, [torch.zeros(3, device=device) for _ in range(3)])
+        with self.assertRaisesRegex(RuntimeError, "at least one tensor"):
+            torch._foreach_mul_([], [])
+
 instantiate_device_type_tests(TestForeach, globals())
 
 if __name__ == '__main__':
@@ -31,6 +31,7 @@ from jit.test_module_interface import TestModuleInterface  # noqa: F401
 from jit.test_onnx_export import TestONNXExport  # noqa: F401
 from jit.test_with import TestWith  # noqa: F401
 from jit.test_enum import TestEnum, TestEnumFeatureGuard  # noqa: F401
+from jit.test_horizontal_batching import TestHorizontalBatching  # noqa: F401
 
 # Torch
 from torch import Tensor
@@ -51,7 +52,8 @@ from torch.testing._internal import jit_utils
 from torch.testing._internal.common_utils import run_tests, IS_WINDOWS, TEST_WITH_UBSAN, \
     suppress_warnings, IS_SANDCASTLE, GRAPH_EXECUTOR, ProfilingMode, \
     freeze_rng_state, set_rng_seed, slowTest, TemporaryFileName, skipIfCompiledWithoutNumpy, \
-    enable_profiling_mode_for_profiling_tests, TEST_MKL, set_default_dtype, num_profiled_runs
+    enable_profiling_mode_for_profiling_tests, TEST_MKL, set_default_dtype, num_profiled_runs, \
+    num_specialized_plans
 from torch.testing._internal.jit_utils import JitTestCase, enable_cpu_fuser, disable_autodiff_subgraph_inlining, \
     _trace, enable_cpu_fuser_if, do_input_map, get_execution_plan, \
     execWrapper, _inline_everything, _tmp_donotuse_dont_inline_everything, \
@@ -672,6 +674,42 @@ class TestJit(JitTestCase):
         # a_copy is modified
         torch.testing.assert_allclose(orig_res, a_copy)
 
+    def test_addmm_activation_fusion(self):
+        class M(torch.nn.Module):
+            def __init__(self, activation):
+                super(M, self).__init__()
+                self.activation = activation
+
+            def forward(self, bias, x, w):
+                return self.activation(torch.addmm(bias, x, w))
+
+        bias = torch.randn(11)
+        x = torch.randn(7, 5)
+        w = torch.randn(5, 11)
+        for activation, use_gelu in ((torch.relu, False), (torch.relu_, False),
+                                     (torch.nn.functional.gelu, True)):
+            m = torch.jit.script(M(activation))
+            orig_res = m(bias, x, w)
+            torch._C._jit_pass_fuse_addmm_activation(m.graph)
+            FileCheck().check_not("aten::addmm(") \
+                .check("aten::_addmm_activation(") \
+                .run(m.graph)
+            new_res = m(bias, x, w)
+            torch.testing.assert_allclose(orig_res, new_res)
+            self.assertEqual(new_res, torch._addmm_activation(bias, x, w, use_gelu=use_gelu))
+
+        # The addmm result is used elsewhere, so it has to stay
+        class MultiUse(torch.nn.Module):
+            def forward(self, bias, x, w):
+                y = torch.addmm(bias, x, w)
+                return torch.relu(y) + y
+
+        m = torch.jit.script(MultiUse())
+        torch._C._jit_pass_fuse_addmm_activation(m.graph)
+        FileCheck().check("aten::addmm(") \
+            .check_not("aten::_addmm_activation(") \
+            .run(m.graph)
+
     @unittest.skipIf(GRAPH_EXECUTOR == ProfilingMode.SIMPLE, "Simple executor doesn't have shape information")
     def test_peephole_optimize_shape_ops(self):
         def test_input(func, input, result):
@@ -2746,6 +2784,36 @@ class TestScript(JitTestCase):
                 FileCheck().check("Double(*:2, 2:1, requires_grad=0, device=cpu) = ").run(graph_str)
                 FileCheck().check_not("Double(1:2, 2:1, requires_grad=0, device=cpu) = ").run(graph_str)
 
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "skip if profiling isn't enabled")
+    def test_profiling_specialized_plans(self):
+        @torch.jit.script
+        def test_add(x):
+            return x + x
+
+        with enable_profiling_mode_for_profiling_tests():
+            with num_specialized_plans(2):
+                for _ in range(2):
+                    test_add(torch.rand([2, 2]))
+                for _ in range(2):
+                    test_add(torch.rand([3, 3]))
+
+                # every shape gets its own plan
+                test_add(torch.rand([2, 2]))
+                graph_str = torch.jit.last_executed_optimized_graph()
+                FileCheck().check("Double(2:2, 2:1, requires_grad=0, device=cpu) = ").run(graph_str)
+                test_add(torch.rand([3, 3]))
+                graph_str = torch.jit.last_executed_optimized_graph()
+                FileCheck().check("Double(3:3, 3:1, requires_grad=0, device=cpu) = ").run(graph_str)
+
+                # a third shape evicts the plan of the least recently used one
+                for _ in range(2):
+                    test_add(torch.rand([4, 4]))
+                graph_str = torch.jit.last_executed_optimized_graph()
+                FileCheck().check("Double(4:4, 4:1, requires_grad=0, device=cpu) = ").run(graph_str)
+                test_add(torch.rand([3, 3]))
+                graph_str = torch.jit.last_executed_optimized_graph()
+                FileCheck().check("Double(3:3, 3:1, requires_grad=0, device=cpu) = ").run(graph_str)
+
 
     def test_nested_bailouts(self):
         @torch.jit.script
@@ -93,6 +93,26 @@ class TestCudaFuser(JitTestCase):
         self.assertEqual(o, jit_o)
         self.assertGraphContains(t_jit.graph_for(x, y), FUSION_GROUP)
 
+    @unittest.skipIf(not RUN_CUDA, "requires CUDA")
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING and GRAPH_EXECUTOR !=
+                     ProfilingMode.LEGACY, "Requires fusion optimization pass to be effective")
+    def test_changing_sizes(self):
+        def t(x, y):
+            o = x + y
+            o = o * 2.0
+            return o
+        t_jit = torch.jit.script(t)
+        # same rank, so the same kernel is reused; outputs are allocated from
+        # the (cached) shape inference of each size
+        for rows in (4, 16, 4, 33, 16):
+            x = torch.randn(rows, 8, dtype=torch.float, device="cuda")
+            y = torch.randn(rows, 8, dtype=torch.float, device="cuda")
+            jit_o = t_jit(x, y)
+            jit_o = t_jit(x, y)
+            o = t(x, y)
+            self.assertEqual(o, jit_o)
+        self.assertGraphContains(t_jit.graph_for(x, y), FUSION_GROUP)
+
     @unittest.skipIf(not RUN_CUDA, "requires CUDA")
     @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING and GRAPH_EXECUTOR !=
                      ProfilingMode.LEGACY, "Requires fusion optimization pass to be effective")
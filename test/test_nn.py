@@ -44,7 +44,7 @@ from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, NewCrit
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, \
     dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
     skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, \
-    deviceCountAtLeast, expectedAlertNondeterministic, largeTensorTest
+    deviceCountAtLeast, expectedAlertNondeterministic, largeTensorTest, onlyCPU
 from torch.nn import MultiheadAttention
 
 from hypothesis import given
@@ -3910,6 +3910,33 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_algorithm_cache(self):
+        x = torch.randn(2, 3, 9, 9, device='cuda', dtype=torch.float, requires_grad=True)
+        m = nn.Conv2d(3, 5, 3).to(device='cuda', dtype=torch.float)
+        with cudnn.flags(enabled=True, benchmark=True):
+            m(x).sum().backward()
+        with TemporaryFileName() as fname:
+            cudnn.save_algorithm_cache(fname)
+            with open(fname, 'rb') as f:
+                saved = f.read()
+            self.assertGreater(len(saved), 0)
+            # Saving is deterministic, and the algorithms of this process are
+            # kept when loading
+            cudnn.save_algorithm_cache(fname)
+            with open(fname, 'rb') as f:
+                self.assertEqual(f.read(), saved)
+            self.assertEqual(cudnn.load_algorithm_cache(fname), 0)
+
+            with open(fname, 'wb') as f:
+                f.write(saved[:len(saved) - 1])
+            self.assertEqual(cudnn.load_algorithm_cache(fname), 0)
+            with open(fname, 'wb') as f:
+                f.write(b'not a cache')
+            self.assertEqual(cudnn.load_algorithm_cache(fname), 0)
+        self.assertEqual(cudnn.load_algorithm_cache(fname), 0)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4037,6 +4064,25 @@ class TestNN(NNTestCase):
         i = torch.rand(1, 2, 1, 1, 1)
         out = m(i, output_size=(1, 2, 2, 2, 2))
 
+    def test_ConvTranspose_batch_matches_single(self):
+        # The CPU slow path processes samples in parallel; each sample has to
+        # come out the same as when it goes through alone.
+        with torch.backends.mkldnn.flags(enabled=False):
+            for m, shape in [(nn.ConvTranspose2d(3, 5, 3, stride=2, padding=1, output_padding=1, dilation=2), (7, 3, 6, 5)),
+                             (nn.ConvTranspose3d(3, 4, 3, stride=(1, 2, 2), padding=1, dilation=(2, 1, 1)), (5, 3, 3, 4, 5))]:
+                m = m.double()
+                x = torch.randn(shape, dtype=torch.double, requires_grad=True)
+                out = m(x)
+                grad = torch.randn_like(out)
+                out.backward(grad)
+                for n in range(shape[0]):
+                    x_n = x[n:n + 1].detach().requires_grad_()
+                    out_n = m(x_n)
+                    self.assertEqual(out[n:n + 1], out_n)
+                    out_n.backward(grad[n:n + 1])
+                    self.assertEqual(x.grad[n:n + 1], x_n.grad)
+                self.assertTrue(gradcheck(lambda x: m(x), (x[:2].detach().requires_grad_(),)))
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_ConvTranspose2d_half_cublas_gemm(self):
         with torch.backends.cudnn.flags(enabled=False):
@@ -4426,6 +4472,30 @@ class TestNN(NNTestCase):
         self.assertEqual(g1, g2, atol=1e-4, rtol=0)
         self.assertTrue((g1 == g1).all().item())  # check that we don't have NaN
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    def test_CTCLoss_half_cuda(self):
+        # short targets use the shared memory rows in the kernels, long ones the global memory path
+        for target_length, vocab_size in [(20, 500), (600, 50)]:
+            input_length = 2 * target_length + 10
+            batch_size = 3
+            targets = torch.randint(1, vocab_size, (batch_size, target_length), dtype=torch.long, device='cuda')
+            input_lengths = [input_length, input_length - 5, input_length - 10]
+            target_lengths = [target_length, target_length - 3, target_length // 2]
+            log_probs = torch.randn(input_length, batch_size, vocab_size, device='cuda').log_softmax(2)
+            log_probs_half = log_probs.half().requires_grad_()
+            log_probs = log_probs_half.detach().float().requires_grad_()
+            with torch.backends.cudnn.flags(enabled=False):
+                res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths, reduction='none')
+                res_half = torch.nn.functional.ctc_loss(log_probs_half, targets, input_lengths, target_lengths,
+                                                        reduction='none')
+            self.assertEqual(res_half.dtype, torch.half)
+            self.assertEqual(res, res_half.float(), atol=0, rtol=1e-3)
+            grad_out = torch.rand_like(res)
+            grad, = torch.autograd.grad(res, log_probs, grad_out)
+            grad_half, = torch.autograd.grad(res_half, log_probs_half, grad_out.half())
+            self.assertEqual(grad_half.dtype, torch.half)
+            self.assertEqual(grad, grad_half.float(), atol=2e-3, rtol=0)
+
     def test_RNN_cell_no_broadcasting(self):
         def test(cell_module, input, hx, input_size, hidden_size):
             cell = cell_module(input_size, hidden_size)
@@ -4653,6 +4723,38 @@ class TestNN(NNTestCase):
         with self.assertRaisesRegex(RuntimeError, 'empty tensor'):
             packed = rnn_utils.pack_padded_sequence(torch.randn(0, 0), [])
 
+    def test_pack_padded_sequence_unsorted(self):
+        # Unsorted batches are gathered straight into the packed data; they
+        # must match sorting the padded batch first
+        lengths = torch.tensor([3, 7, 1, 7, 4])
+        for batch_first in (True, False):
+            padded = torch.randn(7, 5, 2, 3, dtype=torch.double, requires_grad=True)
+            src = padded.transpose(0, 1) if batch_first else padded
+            packed = rnn_utils.pack_padded_sequence(src, lengths, batch_first=batch_first,
+                                                    enforce_sorted=False)
+            sorted_lengths, sorted_indices = torch.sort(lengths, descending=True)
+            expected = rnn_utils.pack_padded_sequence(
+                src.index_select(0 if batch_first else 1, sorted_indices), sorted_lengths,
+                batch_first=batch_first)
+            self.assertEqual(packed.data, expected.data)
+            self.assertEqual(packed.batch_sizes, expected.batch_sizes)
+
+            unpacked, unpacked_lengths = rnn_utils.pad_packed_sequence(
+                packed, batch_first=batch_first, padding_value=-1, total_length=8)
+            self.assertEqual(unpacked_lengths, lengths)
+            self.assertEqual(unpacked.size(0 if batch_first else 1), 5)
+            for i, l in enumerate(lengths.tolist()):
+                seq = unpacked[i] if batch_first else unpacked[:, i]
+                self.assertEqual(seq[:l], padded[:l, i])
+                self.assertTrue((seq[l:] == -1).all())
+
+            def pack_unpack(padded):
+                src = padded.transpose(0, 1) if batch_first else padded
+                packed = rnn_utils.pack_padded_sequence(src, lengths, batch_first=batch_first,
+                                                        enforce_sorted=False)
+                return rnn_utils.pad_packed_sequence(packed, batch_first=batch_first)[0]
+            self.assertTrue(gradcheck(pack_unpack, (padded,)))
+
     def test_LSTM_cell(self):
         # this is just a smoke test; these modules are implemented through
         # autograd so no Jacobian test is needed
@@ -4666,6 +4768,41 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_rnn_fused_pointwise_cpu(self):
+        # Without grad, the CPU cells apply their nonlinearities in one fused
+        # kernel; they must agree with the autograd path. A hidden size that
+        # is not a multiple of the vector width covers the tail.
+        for dtype in (torch.float, torch.double):
+            for module in (nn.LSTM, nn.GRU):
+                rnn = module(10, 21, num_layers=2, bidirectional=True).to(dtype)
+                input = torch.randn(5, 3, 10, dtype=dtype)
+                expected, expected_hidden = rnn(input)
+                with torch.no_grad():
+                    actual, actual_hidden = rnn(input)
+                self.assertEqual(actual, expected)
+                self.assertEqual(actual_hidden, expected_hidden)
+
+                # Whole layers run in one preallocated loop; initial hidden
+                # states, possibly non-contiguous, must be left untouched
+                rnn = module(10, 21, bias=False).to(dtype)
+                h0 = torch.randn(3, 1, 21, dtype=dtype).transpose(0, 1)
+                hidden = (h0, h0.clone()) if module is nn.LSTM else h0
+                hidden_copy = [h.clone() for h in hidden] if module is nn.LSTM else h0.clone()
+                expected, expected_hidden = rnn(input, hidden)
+                with torch.no_grad():
+                    actual, actual_hidden = rnn(input, hidden)
+                self.assertEqual(actual, expected)
+                self.assertEqual(actual_hidden, expected_hidden)
+                self.assertEqual(list(hidden) if module is nn.LSTM else hidden, hidden_copy)
+
+            for cell in (nn.LSTMCell(10, 21), nn.GRUCell(10, 21)):
+                cell = cell.to(dtype)
+                input = torch.randn(3, 10, dtype=dtype)
+                expected = cell(input)
+                with torch.no_grad():
+                    actual = cell(input)
+                self.assertEqual(actual, expected)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -5162,6 +5299,37 @@ class TestNN(NNTestCase):
             weight_data[:] = 4
             self.assertEqual(weight_data, all_vars[4].data)
 
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    @skipIfRocm
+    def test_cudnn_weight_format_after_assignment(self):
+        rnn = nn.LSTM(10, 20).cuda()
+        input = torch.randn(5, 4, 10, device="cuda")
+        rnn.weight_hh_l0 = nn.Parameter(rnn.weight_hh_l0.detach().clone())
+        with warnings.catch_warnings(record=True) as w:
+            warnings.simplefilter("always")
+            output = rnn(input)
+        self.assertFalse(any('weights are not part of single contiguous chunk of memory' in str(x.message)
+                             for x in w))
+        storage_ptrs = set(p.storage().data_ptr() for p in rnn.parameters())
+        self.assertEqual(len(storage_ptrs), 1)
+
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_rnn_plan_reuse(self):
+        # Descriptors and workspaces are cached per configuration and shape;
+        # alternating shapes and modes must still give the results of fresh runs
+        for module in (nn.LSTM, nn.GRU):
+            rnn = module(10, 20, num_layers=2, dropout=0.5).cuda()
+            inputs = [torch.randn(seq_len, 3, 10, device="cuda") for seq_len in (5, 7, 5, 1)]
+            rnn.eval()
+            expected = [rnn(input)[0] for input in inputs]
+            rnn.train()
+            packed = rnn_utils.pack_sequence([torch.randn(n, 10, device="cuda") for n in (6, 4, 1)])
+            rnn(packed)[0].data.sum().backward()
+            rnn.eval()
+            for _ in range(2):
+                for input, out in zip(inputs, expected):
+                    self.assertEqual(rnn(input)[0], out)
+
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_cudnn_weight_tying(self):
         rnns = [
@@ -5984,6 +6152,10 @@ class TestNN(NNTestCase):
             self.assertEqual(res, ref)
             gradcheck(F.gelu, [X], eps=1e-4)
 
+            out = torch.empty(0, dtype=dtype)
+            torch._C._nn.gelu(X.detach(), out=out)
+            self.assertEqual(out, ref)
+
             if TEST_CUDA:
                 X_cuda = X.cuda()
                 res_cuda = F.gelu(X_cuda)
@@ -7918,6 +8090,32 @@ class TestNN(NNTestCase):
         out = conv(input)
         self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
 
+    def test_winograd_conv2d(self):
+        def reference(input, weight, bias, padding):
+            # the im2col convolution
+            out_h = input.size(2) + 2 * padding[0] - 2
+            out_w = input.size(3) + 2 * padding[1] - 2
+            cols = F.unfold(input, 3, padding=padding)
+            out = weight.view(weight.size(0), -1).matmul(cols).view(input.size(0), -1, out_h, out_w)
+            return out if bias is None else out + bias.view(1, -1, 1, 1)
+
+        # odd output sizes, which cut the last tiles, and a single channel
+        for n, c, k, h, w, padding, use_bias in [(2, 3, 4, 5, 7, (1, 1), True), (1, 8, 5, 6, 6, (0, 2), False),
+                                                 (3, 1, 2, 4, 3, (2, 0), True), (1, 2, 3, 3, 3, (0, 0), True)]:
+            input = torch.randn(n, c, h, w, dtype=torch.double, requires_grad=True)
+            weight = torch.randn(k, c, 3, 3, dtype=torch.double, requires_grad=True)
+            bias = torch.randn(k, dtype=torch.double, requires_grad=True) if use_bias else None
+            self.assertEqual(torch._winograd_conv2d(input, weight, bias, padding), reference(input, weight, bias, padding))
+            inputs = (input, weight, bias) if use_bias else (input, weight)
+            fn = lambda input, weight, bias=None: torch._winograd_conv2d(input, weight, bias, padding)  # noqa: E731
+            self.assertTrue(gradcheck(fn, inputs))
+            self.assertTrue(gradgradcheck(fn, inputs))
+
+        # the CPU convolutions that are picked for it
+        input = torch.randn(2, 8, 9, 10).contiguous(memory_format=torch.channels_last)
+        conv = nn.Conv2d(8, 16, 3, padding=1)
+        self.assertEqual(conv(input), reference(input, conv.weight, conv.bias, (1, 1)), atol=1e-4, rtol=1e-4)
+
     def test_conv_double_backward(self):
         batch_size = 2
         for kern, inp_size, dilations in [(3, 6, [1, 2]), (3, 7, [1]), (4, 9, [1])]:
@@ -8193,6 +8391,21 @@ class TestNN(NNTestCase):
         self.assertEqual(input.grad.dtype, dtype)
         self.assertEqual(input.grad, inputf.grad.to(dtype), atol=0.1, rtol=0)
 
+    def test_softmax_cpu(self, dtype=torch.bfloat16):
+        for dim in (-1, 0):
+            inputf = torch.rand(32, 100, device="cpu", dtype=torch.float, requires_grad=True)
+            input = inputf.to(dtype).detach().requires_grad_(True)
+            outf = F.softmax(inputf, dim=dim)
+            out = F.softmax(input, dim=dim)
+            self.assertEqual(out.dtype, dtype)
+            self.assertEqual(out, outf.to(dtype), atol=1e-2, rtol=0)
+
+            grad = torch.randn_like(outf)
+            out.backward(grad.to(dtype))
+            outf.backward(grad)
+            self.assertEqual(input.grad.dtype, dtype)
+            self.assertEqual(input.grad, inputf.grad.to(dtype), atol=1e-2, rtol=0)
+
     def test_adaptive_log_softmax(self):
         # args validation
         with self.assertRaises(ValueError):
@@ -9508,6 +9721,97 @@ class TestNNDeviceType(NNTestCase):
         input = torch.Tensor(num_features, b, d, w, h)
         self._test_dropout(nn.Dropout3d, device, input)
 
+    @onlyOnCPUAndCUDA
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_fused_cross_entropy(self, device, dtype):
+        prec = 1e-2 if dtype == torch.half else 1e-5
+        # More classes than a chunk of the CPU kernel, and a row of -inf logits
+        # but the target
+        for n, c in ((16, 10), (5, 5000), (0, 7)):
+            logits = torch.randn(n, c, device=device, dtype=dtype) * 5
+            target = torch.randint(c, (n,), device=device)
+            if n > 1:
+                target[0] = -100
+                logits[1] = float('-inf')
+                logits[1, target[1]] = 0
+            for reduction in ('none', 'sum', 'mean'):
+                x = logits.clone().requires_grad_()
+                loss, logsumexp = torch._fused_cross_entropy(x, target, torch.nn._reduction.get_enum(reduction))
+                x_ref = logits.float().clone().requires_grad_()
+                loss_ref = F.cross_entropy(x_ref, target, reduction=reduction)
+                self.assertEqual(loss.dtype, dtype)
+                self.assertEqual(loss.float(), loss_ref, atol=prec, rtol=prec, exact_dtype=False)
+                self.assertEqual(logsumexp, torch.logsumexp(logits.float(), 1), atol=prec, rtol=prec, exact_dtype=False)
+                if n == 0:
+                    continue
+                grad = torch.randn_like(loss)
+                loss.backward(grad)
+                loss_ref.backward(grad.float())
+                self.assertEqual(x.grad.float(), x_ref.grad, atol=prec, rtol=prec, exact_dtype=False)
+
+        if dtype == torch.double:
+            x = torch.randn(4, 6, device=device, dtype=dtype, requires_grad=True)
+            target = torch.tensor([0, 5, -100, 2], device=device)
+            self.assertTrue(gradcheck(lambda x: torch._fused_cross_entropy(x, target)[0], (x,)))
+
+        with self.assertRaisesRegex(RuntimeError, "expected 2-D logits"):
+            torch._fused_cross_entropy(torch.randn(2, 3, 4, device=device, dtype=dtype),
+                                       torch.zeros(2, 4, dtype=torch.long, device=device))
+
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_fused_bias_dropout_add(self, device, dtype):
+        # Sizes with and without vectorized access; the backward must
+        # regenerate exactly the mask of the forward.
+        prec = 1e-2 if dtype == torch.half else 1e-5
+        for shape, p in product(((64, 128), (3, 5, 7), (1,), (0, 16)), (0., 0.3, 1.)):
+            x = torch.randn(shape, device=device, dtype=dtype).abs_().add_(1).requires_grad_()
+            bias = torch.rand(shape[-1], device=device, dtype=dtype, requires_grad=True)
+            residual = torch.randn(shape, device=device, dtype=dtype, requires_grad=True)
+            out, rng_state = torch._fused_bias_dropout_add(x, bias, residual, p)
+            # x + bias is positive, so that the dropped elements are the zeros
+            kept = (out - residual).detach() != 0
+            scale = 0. if p == 1 else 1. / (1 - p)
+            expected = residual + (x + bias) * kept.to(dtype) * scale
+            self.assertEqual(out, expected, atol=prec, rtol=prec)
+            if p == 0:
+                self.assertTrue(kept.all())
+            elif p == 1:
+                self.assertFalse(kept.any())
+
+            grad = torch.randn_like(out)
+            out.backward(grad)
+            grad_x = grad * kept.to(dtype) * scale
+            self.assertEqual(x.grad, grad_x, atol=prec, rtol=prec)
+            self.assertEqual(bias.grad, grad_x.reshape(-1, shape[-1]).sum(0), atol=prec * 10, rtol=prec)
+            self.assertEqual(residual.grad, grad)
+
+        # Masks differ between calls but only depend on the generator state
+        x = torch.ones(1000, device=device, dtype=dtype)
+        bias = torch.zeros(1000, device=device, dtype=dtype)
+        residual = torch.zeros(1000, device=device, dtype=dtype)
+        torch.manual_seed(0)
+        out1, _ = torch._fused_bias_dropout_add(x, bias, residual, 0.5)
+        out2, _ = torch._fused_bias_dropout_add(x, bias, residual, 0.5)
+        torch.manual_seed(0)
+        out3, _ = torch._fused_bias_dropout_add(x, bias, residual, 0.5)
+        self.assertNotEqual(out1, out2)
+        self.assertEqual(out1, out3)
+        self.assertLess(abs((out1 != 0).double().mean().item() - 0.5), 0.1)
+
+        if dtype == torch.double:
+            x = torch.randn(4, 6, device=device, dtype=dtype, requires_grad=True)
+            bias = torch.randn(6, device=device, dtype=dtype, requires_grad=True)
+            residual = torch.randn(4, 6, device=device, dtype=dtype, requires_grad=True)
+
+            def fn(x, bias, residual):
+                # Fixes the mask across the gradcheck evaluations
+                torch.manual_seed(0)
+                return torch._fused_bias_dropout_add(x, bias, residual, 0.4)[0]
+            gradcheck(fn, (x, bias, residual))
+            gradgradcheck(fn, (x, bias, residual))
+
     def test_InstanceNorm1d_general(self, device):
         b = random.randint(3, 5)
         c = random.randint(3, 5)
@@ -9558,6 +9862,36 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float)
+    def test_LayerNorm_fused(self, device, dtype):
+        # Hidden sizes handled by the fused kernels, from one warp to the
+        # largest block per row, and ones that fall back to the unfused
+        # kernels (not a multiple of the vector size, or too large). The
+        # fused backward loops over rows when there are more rows than blocks.
+        prec = 1e-2 if dtype == torch.half else 1e-4
+        shapes = ((37, 32), (37, 768), (37, 1024), (37, 4096), (2000, 8192), (37, 770), (37, 8196))
+        for (M, N), elementwise_affine in product(shapes, (True, False)):
+            x = torch.randn(M, N, device=device, dtype=dtype, requires_grad=True)
+            ln = nn.LayerNorm(N, elementwise_affine=elementwise_affine).to(device, dtype)
+            if elementwise_affine:
+                ln.weight.data.uniform_(0.5, 1.5)
+                ln.bias.data.uniform_(-1, 1)
+            x_ref = x.detach().double().requires_grad_(True)
+            ln_ref = deepcopy(ln).double()
+            out = ln(x)
+            out_ref = ln_ref(x_ref)
+            self.assertEqual(out.double(), out_ref, atol=prec, rtol=prec)
+
+            grad = torch.randn_like(out)
+            out.backward(grad)
+            out_ref.backward(grad.double())
+            self.assertEqual(x.grad.double(), x_ref.grad, atol=prec, rtol=prec)
+            if elementwise_affine:
+                # Summed over the M rows
+                self.assertEqual(ln.weight.grad.double(), ln_ref.weight.grad, atol=prec * M, rtol=prec)
+                self.assertEqual(ln.bias.grad.double(), ln_ref.bias.grad, atol=prec * M, rtol=prec)
+
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
 
@@ -9577,6 +9911,55 @@ class TestNNDeviceType(NNTestCase):
             with torch.backends.cudnn.flags(enabled=False):
                 self._test_module_empty_input(mod, inp)
 
+    def test_GroupNorm_channels_last(self, device):
+        for shape, g, memory_format in [((2, 8, 5, 7), 4, torch.channels_last),
+                                        ((3, 64, 2, 3), 32, torch.channels_last),
+                                        ((2, 6, 3, 4, 5), 3, torch.channels_last_3d)]:
+            gn = nn.GroupNorm(g, shape[1]).to(device, torch.double)
+            gn.weight.data.uniform_(0.5, 2)
+            gn.bias.data.uniform_(-1, 1)
+            gn_ref = deepcopy(gn)
+            x = torch.randn(*shape, device=device, dtype=torch.double) * 3 + 10
+            x = x.contiguous(memory_format=memory_format).requires_grad_()
+            x_ref = x.detach().contiguous().requires_grad_()
+
+            out = gn(x)
+            out_ref = gn_ref(x_ref)
+            self.assertTrue(out.is_contiguous(memory_format=memory_format))
+            self.assertEqual(out, out_ref)
+
+            grad = torch.randn_like(out_ref).contiguous(memory_format=memory_format)
+            out.backward(grad)
+            out_ref.backward(grad.contiguous())
+            self.assertTrue(x.grad.is_contiguous(memory_format=memory_format))
+            self.assertEqual(x.grad, x_ref.grad)
+            self.assertEqual(gn.weight.grad, gn_ref.weight.grad)
+            self.assertEqual(gn.bias.grad, gn_ref.bias.grad)
+
+    def test_group_norm_silu(self, device):
+        N, C, H, W, G = 2, 12, 5, 3, 4
+        for memory_format, affine in product([torch.contiguous_format, torch.channels_last], [True, False]):
+            x = torch.randn(N, C, H, W, device=device, dtype=torch.double)
+            x = x.contiguous(memory_format=memory_format).requires_grad_()
+            x_ref = x.detach().contiguous().requires_grad_()
+            weight = torch.rand(C, device=device, dtype=torch.double, requires_grad=True) + 0.5 if affine else None
+            bias = torch.randn(C, device=device, dtype=torch.double, requires_grad=True) if affine else None
+
+            out, mean, rstd = torch._group_norm_silu(x, weight, bias, N, C, H * W, G, 1e-5)
+            out_ref = F.silu(F.group_norm(x_ref, G, weight, bias, 1e-5))
+            self.assertTrue(out.is_contiguous(memory_format=memory_format))
+            self.assertEqual(out, out_ref)
+            x_groups = x_ref.detach().view(N, G, -1)
+            self.assertEqual(mean, x_groups.mean(-1))
+            self.assertEqual(rstd, (x_groups.var(-1, unbiased=False) + 1e-5).rsqrt())
+
+            grad = torch.randn_like(out_ref)
+            params = [x] + ([weight, bias] if affine else [])
+            grads = torch.autograd.grad(out, params, grad)
+            grads_ref = torch.autograd.grad(out_ref, [x_ref] + params[1:], grad)
+            for g, g_ref in zip(grads, grads_ref):
+                self.assertEqual(g, g_ref)
+
     @onlyOnCPUAndCUDA
     def test_ReflectionPad_empty(self, device):
         for mod, inp in [
@@ -9863,6 +10246,38 @@ class TestNNDeviceType(NNTestCase):
         helper(10, 512, 31, 31, 3, stride=2)
         helper(1, 129, 8, 8, 3, stride=2)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_nhwc_cpu(self, device, dtype):
+        def helper(module, n, c, h, w):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            ref_input = input.detach().clone().contiguous().requires_grad_()
+            ref_module = deepcopy(module)
+
+            out = module(input)
+            grad = torch.randn_like(out)
+            out.backward(grad)
+            ref_out = ref_module(ref_input)
+            ref_out.backward(grad.contiguous())
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(input.grad.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(input.grad, ref_input.grad)
+            for p, ref_p in zip(module.parameters(), ref_module.parameters()):
+                self.assertEqual(p.grad, ref_p.grad)
+            for b, ref_b in zip(module.buffers(), ref_module.buffers()):
+                self.assertEqual(b, ref_b)
+
+        for n, c, h, w in [(2, 3, 7, 9), (1, 17, 8, 8)]:
+            helper(torch.nn.MaxPool2d(3, stride=2, padding=1), n, c, h, w)
+            helper(torch.nn.MaxPool2d(2, dilation=2, ceil_mode=True), n, c, h, w)
+            helper(torch.nn.AdaptiveAvgPool2d((5, 3)), n, c, h, w)
+            helper(torch.nn.AdaptiveAvgPool2d((1, 1)), n, c, h, w)
+            helper(torch.nn.BatchNorm2d(c).to(dtype), n, c, h, w)
+            helper(torch.nn.BatchNorm2d(c).to(dtype).eval(), n, c, h, w)
+
     @onlyCUDA
     def test_max_pool2d_indices(self, device):
         def helper(n, c, h, w, ks):
@@ -11009,6 +11424,40 @@ class TestNNDeviceType(NNTestCase):
         self._test_EmbeddingBag(device, 'sum', True, dtype=torch.bfloat16, test_backward=True)
         self._test_EmbeddingBag(device, 'mean', True, dtype=torch.bfloat16, test_backward=True)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_embedding_bag_fused_update(self, device, dtype):
+        num_embeddings, embedding_dim, lr, eps = 50, 7, 0.1, 1e-10
+        indices = torch.randint(0, 10, (40,), device=device)  # with repeats
+        offsets = torch.tensor([0, 3, 3, 17, 30], device=device)
+        for mode, use_weights in (('sum', False), ('sum', True), ('mean', False)):
+            weight = torch.randn(num_embeddings, embedding_dim, device=device, dtype=dtype)
+            psw = torch.rand(indices.numel(), device=device, dtype=dtype) if use_weights else None
+            ref = weight.clone().requires_grad_()
+            out = F.embedding_bag(indices, ref, offsets, mode=mode, per_sample_weights=psw)
+            grad = torch.randn_like(out)
+            out.backward(grad)
+            mode_id = 0 if mode == 'sum' else 1
+
+            w = weight.clone()
+            with torch.no_grad():
+                torch._embedding_bag_sgd_update_(w, grad, indices, offsets, mode_id, lr, psw)
+            self.assertEqual(w, ref.detach() - lr * ref.grad)
+
+            w = weight.clone()
+            momentum = torch.rand(num_embeddings, device=device, dtype=dtype)
+            expected_momentum = momentum + ref.grad.pow(2).mean(1)
+            ref_step = lr * ref.grad / (expected_momentum.sqrt() + eps).unsqueeze(1)
+            with torch.no_grad():
+                torch._embedding_bag_rowwise_adagrad_update_(
+                    w, momentum, grad, indices, offsets, mode_id, lr, eps, psw)
+            # Rows that were not looked up keep their weight and momentum.
+            touched = torch.zeros(num_embeddings, dtype=torch.bool, device=device)
+            touched[indices] = True
+            self.assertEqual(w[touched], (ref.detach() - ref_step)[touched])
+            self.assertEqual(w[~touched], weight[~touched])
+            self.assertEqual(momentum[touched], expected_momentum[touched])
+
 
     @onlyCUDA
     @dtypes(torch.half, torch.float, torch.double)
@@ -738,6 +738,43 @@ class TestSerialization(TestCase, SerializationMixin):
             torch.save(model, path)
             torch.load(path)
 
+    @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile on windows")
+    def test_save_async(self):
+        def test(device, name_or_buffer):
+            a = torch.randn(5, 5, device=device)
+            data = {'a': a, 'view': a[1:3], 'b': torch.arange(10, device=device)}
+            expected = copy.deepcopy(data)
+            fut = torch.save_async(data, name_or_buffer)
+            # the snapshot was taken, in-place updates are not saved
+            a.add_(1)
+            self.assertIsNone(fut.wait())
+
+            if hasattr(name_or_buffer, 'seek'):
+                name_or_buffer.seek(0)
+            result = torch.load(name_or_buffer)
+            self.assertEqual(result, expected)
+            self.assertEqual(result['a'].device, a.device)
+            # storage sharing is preserved
+            self.assertEqual(result['view'].storage().data_ptr(), result['a'].storage().data_ptr())
+
+        devices = ['cpu'] + (['cuda'] if torch.cuda.is_available() else [])
+        for device in devices:
+            with tempfile.NamedTemporaryFile() as f:
+                test(device, f.name)
+            test(device, io.BytesIO())
+
+    def test_save_async_error(self):
+        class NotWritable(object):
+            def write(self, data):
+                raise RuntimeError("disk full")
+
+            def flush(self):
+                pass
+
+        fut = torch.save_async(torch.ones(3), NotWritable())
+        with self.assertRaisesRegex(RuntimeError, "disk full"):
+            fut.wait()
+
     def run(self, *args, **kwargs):
         with serialization_method(use_zip=True):
             return super(TestSerialization, self).run(*args, **kwargs)
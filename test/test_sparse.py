@@ -202,6 +202,22 @@ class TestSparse(TestCase):
             t, _, _ = self._gen_sparse(len(sparse_size), nnz, sparse_size + dense_size)
             self.safeCoalesce(t)  # this tests correctness
 
+    def test_coalesce_large(self):
+        # enough elements for the CPU sort to split them among threads, and a
+        # range of indices that takes it several passes
+        for sparse_size, dense_size in [([300, 400], []), ([70000, 3], [2])]:
+            nnz = 50000
+            i = torch.stack([torch.randint(s, (nnz,), device=self.device) for s in sparse_size])
+            # repeat elements, so that there are duplicates to sum
+            i = i.repeat(1, 2)
+            v = torch.randn([2 * nnz] + dense_size, dtype=self.value_dtype, device=self.device)
+            t = self.sparse_tensor(i, v, torch.Size(sparse_size + dense_size))
+            tc = t.coalesce()
+            self.assertTrue(tc.is_coalesced())
+            self.assertEqual(tc.to_dense(), t.to_dense())
+            flat_indices = tc._indices()[0] * sparse_size[1] + tc._indices()[1]
+            self.assertTrue((flat_indices[1:] > flat_indices[:-1]).all())
+
     def test_ctor_size_checks(self):
         indices = self.index_tensor([
             [0, 0, 0],
@@ -1121,6 +1137,69 @@ class TestSparse(TestCase):
         test_shape(7, 8, 9, 20, False)
         test_shape(7, 8, 9, 20, True)
 
+    def _block_sparse_to_dense(self, values, block_indices, rows, cols):
+        # scatter the blocks into a zero matrix, summing repeated ones
+        block_rows, block_cols = values.shape[-2:]
+        dense = values.new_zeros(values.shape[:-3] + (rows, cols))
+        for k, (i, j) in enumerate(block_indices.t().tolist()):
+            dense[..., i * block_rows:(i + 1) * block_rows, j * block_cols:(j + 1) * block_cols] += values[..., k, :, :]
+        return dense
+
+    def test_block_sparse_mm(self):
+        def test_shape(batch, rows, inner, cols, blocksize, block_indices):
+            block_indices = torch.tensor(block_indices, dtype=torch.int64, device=self.device)
+            nblocks = block_indices.size(1)
+            values = torch.randn(batch + [nblocks] + blocksize, dtype=torch.double, device=self.device)
+            dense = torch.randn(batch + [inner, cols], dtype=torch.double, device=self.device)
+            expected = self._block_sparse_to_dense(values, block_indices, rows, inner) @ dense
+            self.assertEqual(torch.sparse.block_sparse_mm(values, block_indices, rows, dense), expected)
+
+            values.requires_grad_(True)
+            dense.requires_grad_(True)
+            gradcheck(lambda v, d: torch.sparse.block_sparse_mm(v, block_indices, rows, d), (values, dense))
+
+        test_shape([], 6, 4, 5, [2, 2], [[0, 2, 1], [1, 0, 1]])
+        test_shape([3], 6, 8, 2, [3, 4], [[0, 1], [1, 1]])
+        # repeated and missing blocks
+        test_shape([], 4, 4, 3, [2, 2], [[1, 1], [0, 0]])
+        test_shape([2], 4, 4, 3, [2, 2], [[], []])
+
+        values = torch.randn(1, 2, 2, device=self.device)
+        with self.assertRaisesRegex(RuntimeError, "to be made of its 2 x 2 blocks"):
+            torch.sparse.block_sparse_mm(values, torch.zeros(2, 1, dtype=torch.int64, device=self.device), 3,
+                                         torch.randn(4, 3, device=self.device))
+
+    def test_block_sparse_masked_mm(self):
+        def test_shape(batch, rows, inner, cols, blocksize, block_indices):
+            block_indices = torch.tensor(block_indices, dtype=torch.int64, device=self.device)
+            mat1 = torch.randn(batch + [rows, inner], dtype=torch.double, device=self.device)
+            mat2 = torch.randn(batch + [inner, cols], dtype=torch.double, device=self.device)
+            values = torch.sparse.block_sparse_masked_mm(mat1, mat2, block_indices, blocksize)
+            product = mat1 @ mat2
+            self.assertEqual(values.shape, tuple(batch + [block_indices.size(1)] + blocksize))
+            for k, (i, j) in enumerate(block_indices.t().tolist()):
+                self.assertEqual(values[..., k, :, :],
+                                 product[..., i * blocksize[0]:(i + 1) * blocksize[0], j * blocksize[1]:(j + 1) * blocksize[1]])
+
+            mat1.requires_grad_(True)
+            mat2.requires_grad_(True)
+            gradcheck(lambda a, b: torch.sparse.block_sparse_masked_mm(a, b, block_indices, blocksize), (mat1, mat2))
+
+        test_shape([], 4, 3, 6, [2, 3], [[0, 1, 1], [1, 0, 1]])
+        test_shape([2], 6, 5, 4, [3, 2], [[1], [1]])
+        test_shape([], 4, 3, 4, [2, 2], [[], []])
+
+        # the masked product feeds the block-sparse product, as in sparse attention
+        q = torch.randn(8, 4, dtype=torch.double, device=self.device)
+        k = torch.randn(8, 4, dtype=torch.double, device=self.device)
+        v = torch.randn(8, 4, dtype=torch.double, device=self.device)
+        block_indices = torch.tensor([[0, 1, 1], [0, 0, 1]], device=self.device)
+        scores = torch.sparse.block_sparse_masked_mm(q, k.t(), block_indices, (4, 4))
+        out = torch.sparse.block_sparse_mm(scores, block_indices, 8, v)
+        mask = torch.tensor([[1., 0.], [1., 1.]], dtype=torch.double, device=self.device)
+        mask = mask.repeat_interleave(4, 0).repeat_interleave(4, 1)
+        self.assertEqual(out, ((q @ k.t()) * mask) @ v)
+
     def test_dsmm(self):
         def test_shape(di, dj, dk, nnz):
             x = self._gen_sparse(2, nnz, [di, dj])[0]
@@ -1467,6 +1546,19 @@ class TestSparse(TestCase):
         expected = self.safeToDense(x) + self.safeToDense(x)
         self.assertEqual(self.safeToDense(y), expected)
 
+    def test_add_dense_sparse_hybrid(self):
+        for shape_i, shape_v, nnz in [([10, 10], [5, 3], 20), ([100, 100], [4], 3000), ([10], [0], 5)]:
+            x = torch.randn(shape_i + shape_v, dtype=self.value_dtype, device=self.device)
+            y, _, _ = self._gen_sparse(len(shape_i), nnz, shape_i + shape_v)
+            expected = x + self.safeToDense(y)
+            self.assertEqual(x + y, expected)
+            self.assertEqual(torch.add(x, y, alpha=2), x + 2 * self.safeToDense(y))
+            # non-contiguous result
+            out = torch.empty(list(reversed(shape_i + shape_v)), dtype=self.value_dtype, device=self.device)
+            out = out.permute(*reversed(range(out.dim())))
+            torch.add(x, y, out=out)
+            self.assertEqual(out, expected)
+
     def _test_sparse_mask_shape(self, nnz_x1, nnz_x2, shape_i, shape_v=None):
         shape = shape_i + (shape_v or [])
         x1, _, _ = self._gen_sparse(len(shape_i), nnz_x1, shape)
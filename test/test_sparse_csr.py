@@ -0,0 +1,118 @@
+import itertools
+
+import torch
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests
+from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+def _random_sparse_matrix(rows, cols, density, dtype, device):
+    dense = torch.randn(rows, cols, device=device).to(dtype)
+    return dense * (torch.rand(rows, cols, device=device) < density).to(dtype)
+
+
+class TestSparseCSR(TestCase):
+    def test_layout(self, device):
+        self.assertEqual(str(torch.sparse_csr), 'torch.sparse_csr')
+        x = torch.eye(3, device=device).to_sparse_csr()
+        self.assertEqual(x.layout, torch.sparse_csr)
+        self.assertTrue(x.is_sparse_csr)
+        self.assertFalse(x.is_sparse)
+        self.assertFalse(torch.eye(3, device=device).is_sparse_csr)
+
+    def test_constructor(self, device):
+        crow_indices = torch.tensor([0, 2, 2, 3], device=device)
+        col_indices = torch.tensor([1, 3, 0], device=device)
+        values = torch.tensor([1., 2., 3.], device=device)
+        x = torch.sparse_csr_tensor(crow_indices, col_indices, values, (3, 4))
+        self.assertEqual(x.shape, (3, 4))
+        self.assertEqual(x._nnz(), 3)
+        self.assertEqual(x.crow_indices(), crow_indices)
+        self.assertEqual(x.col_indices(), col_indices)
+        self.assertEqual(x.values(), values)
+        self.assertEqual(x.to_dense(), torch.tensor([[0., 1., 0., 2.],
+                                                     [0., 0., 0., 0.],
+                                                     [3., 0., 0., 0.]], device=device))
+        self.assertEqual(torch.sparse_csr_tensor(crow_indices, col_indices, values, (3, 4),
+                                                 dtype=torch.float64).values().dtype, torch.float64)
+
+    def test_constructor_errors(self, device):
+        col_indices = torch.tensor([1, 3, 0], device=device)
+        values = torch.tensor([1., 2., 3.], device=device)
+        with self.assertRaisesRegex(RuntimeError, "crow_indices\\[0\\] must be 0"):
+            torch.sparse_csr_tensor(torch.tensor([1, 2, 2, 3], device=device), col_indices, values, (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "number of specified elements"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 2, 2], device=device), col_indices, values, (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "nondecreasing"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 1, 3], device=device), col_indices, values, (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "col_indices must be in the range"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 2, 3], device=device), col_indices, values, (3, 3))
+        with self.assertRaisesRegex(RuntimeError, "rows \\+ 1"):
+            torch.sparse_csr_tensor(torch.tensor([0, 3], device=device), col_indices, values, (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "same dtype"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 2, 3], device=device, dtype=torch.int32),
+                                    col_indices, values, (3, 4))
+
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_conversions(self, device, dtype):
+        for rows, cols, density in itertools.product([0, 1, 7], [0, 1, 5], [0., 0.3, 1.]):
+            dense = _random_sparse_matrix(rows, cols, density, dtype, device)
+            for csr in (dense.to_sparse_csr(), dense.to_sparse().to_sparse_csr()):
+                self.assertEqual(csr.crow_indices().dtype, torch.int32)
+                self.assertEqual(csr.col_indices().dtype, torch.int32)
+                self.assertEqual(csr.values().dtype, dtype)
+                self.assertEqual(csr._nnz(), dense.count_nonzero().item())
+                self.assertEqual(csr.to_dense(), dense)
+                self.assertEqual(csr.to_sparse().to_dense(), dense)
+
+        # COO duplicates are summed when converting
+        coo = torch.sparse_coo_tensor(torch.tensor([[1, 0, 1], [2, 1, 2]]),
+                                      torch.tensor([1, 2, 3], dtype=dtype), (2, 3), device=device)
+        csr = coo.to_sparse_csr()
+        self.assertEqual(csr._nnz(), 2)
+        self.assertEqual(csr.to_dense(), coo.to_dense())
+
+    @dtypes(torch.float, torch.double)
+    def test_matmul(self, device, dtype):
+        def check(rows, inner, cols, density, index_dtype):
+            dense = _random_sparse_matrix(rows, inner, density, dtype, device)
+            csr = dense.to_sparse_csr()
+            if index_dtype == torch.int64:
+                csr = torch.sparse_csr_tensor(csr.crow_indices().long(), csr.col_indices().long(),
+                                              csr.values(), csr.shape)
+            mat2 = torch.randn(inner, cols, device=device, dtype=dtype)
+            t = torch.randn(rows, cols, device=device, dtype=dtype)
+            vec = torch.randn(inner, device=device, dtype=dtype)
+            self.assertEqual(torch.mm(csr, mat2), dense.mm(mat2))
+            self.assertEqual(csr.mv(vec), dense.mv(vec))
+            self.assertEqual(torch.addmm(t, csr, mat2, beta=0.5, alpha=2.),
+                             torch.addmm(t, dense, mat2, beta=0.5, alpha=2.))
+            # self is ignored when beta is zero
+            self.assertEqual(torch.addmm(torch.full_like(t, float('nan')), csr, mat2, beta=0),
+                             dense.mm(mat2))
+            # non-contiguous mat2 and out
+            out = torch.empty(cols, rows, device=device, dtype=dtype).t()
+            torch.addmm(t, csr, mat2.t().contiguous().t(), out=out)
+            self.assertEqual(out, torch.addmm(t, dense, mat2))
+
+        for rows, inner, cols, density, index_dtype in itertools.product(
+                [1, 13], [1, 9], [1, 6], [0., 0.4, 1.], [torch.int32, torch.int64]):
+            check(rows, inner, cols, density, index_dtype)
+
+    def test_printing(self, device):
+        x = torch.tensor([[0., 0., 0.], [9., 0., 10.], [0., 0., 0.]], device=device).to_sparse_csr()
+        printed = str(x)
+        self.assertIn('crow_indices=tensor([0, 0, 2, 2], dtype=torch.int32)', printed)
+        self.assertIn('col_indices=tensor([0, 2], dtype=torch.int32)', printed)
+        self.assertIn('values=tensor([ 9., 10.]', printed)
+        self.assertIn('size=(3, 3), nnz=2', printed)
+        self.assertIn('layout=torch.sparse_csr', printed)
+
+
+instantiate_device_type_tests(TestSparseCSR, globals())
+
+if __name__ == '__main__':
+    run_tests()
@@ -263,6 +263,27 @@ class TestFFT(TestCase):
                             self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 10)  # default is cuda:0
                         self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 11)  # default is cuda:1
 
+    @skipCUDAIfRocm
+    @onlyCUDA
+    @dtypes(torch.double)
+    def test_cufft_plan_cache_batch_chunks(self, device, dtype):
+        # Small transforms run in chunks of power-of-two batch sizes, so that
+        # batches 4, 6 and 7 only need plans for batches 4, 2 and 1
+        plan_cache = torch.backends.cuda.cufft_plan_cache[device]
+        original = plan_cache.max_size
+        plan_cache.max_size = 10
+        try:
+            plan_cache.clear()
+            inputs = [torch.randn(batch, 64, device=device, dtype=dtype) for batch in (4, 6, 7)]
+            outputs = [x.rfft(1) for x in inputs]
+            self.assertEqual(plan_cache.size, 3)
+
+            for x, y in zip(inputs, outputs):
+                self.assertEqual(y, torch.stack([row.rfft(1) for row in x]))
+                self.assertEqual(y.irfft(1, signal_sizes=(64,)), x)
+        finally:
+            plan_cache.max_size = original
+
     # passes on ROCm w/ python 2.7, fails w/ python 3.6
     @skipCUDAIfRocm
     @skipCPUIfNoMkl
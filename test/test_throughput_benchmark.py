@@ -1,7 +1,10 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 
-import torch
+import sys
 import tempfile
+import unittest
+
+import torch
 from torch.utils import ThroughputBenchmark
 from torch.testing import assert_allclose
 
@@ -35,7 +38,7 @@ class TwoLayerNetModule(torch.nn.Module):
         return y_pred
 
 class TestThroughputBenchmark(TestCase):
-    def linear_test(self, Module, profiler_output_path=""):
+    def linear_test(self, Module, profiler_output_path="", **kwargs):
         D_in = 10
         H = 5
         D_out = 15
@@ -65,9 +68,16 @@ class TestThroughputBenchmark(TestCase):
             num_warmup_iters=100,
             num_iters=1000,
             profiler_output_path=profiler_output_path,
+            **kwargs
         )
 
         print(stats)
+        self.assertLessEqual(stats.latency_p50_ms, stats.latency_p90_ms)
+        self.assertLessEqual(stats.latency_p90_ms, stats.latency_p99_ms)
+        self.assertLessEqual(stats.latency_p99_ms, stats.latency_p999_ms)
+        self.assertGreater(stats.cold_latency_ms, 0)
+        self.assertGreater(stats.warmup_latency_avg_ms, 0)
+        return stats
 
 
     def test_script_module(self):
@@ -80,6 +90,20 @@ class TestThroughputBenchmark(TestCase):
         with tempfile.NamedTemporaryFile(delete=False) as f:
             self.linear_test(TwoLayerNetModule, profiler_output_path=f.name)
 
+    def test_open_loop(self):
+        stats = self.linear_test(TwoLayerNet, target_qps=10000)
+        # 1000 requests arriving at 10000 QPS take at least 0.1s
+        self.assertGreaterEqual(stats.total_time_seconds, 0.099)
+
+    @unittest.skipIf(not sys.platform.startswith('linux'), "CPU affinity is only supported on Linux")
+    def test_cpu_affinity(self):
+        self.linear_test(TwoLayerNet, cpu_affinity=[0])
+
+    def test_profile_memory(self):
+        stats = self.linear_test(TwoLayerNet, profile_memory=True)
+        self.assertGreater(stats.allocations_per_iter, 0)
+        self.assertGreater(stats.allocated_bytes_per_iter, 0)
+
 
 if __name__ == '__main__':
     run_tests()
@@ -738,6 +738,53 @@ class AbstractTestCases:
             self.assertEqual(y[:, 0], range(100))
             self.assertEqual(y[:, 40], range(4000, 4100))
 
+        def test_copy_transpose_tiled(self):
+            # transposed copies are done in tiles, check sizes that don't
+            # divide evenly, every element size and NCHW <-> NHWC
+            for dtype in (torch.bool, torch.uint8, torch.half, torch.bfloat16, torch.float,
+                          torch.int32, torch.double, torch.complex64, torch.complex128):
+                for n, m in ((8, 8), (13, 70), (200, 129)):
+                    x = torch.arange(n * m).reshape(n, m).to(dtype)
+                    expected = torch.stack([x[:, j] for j in range(m)])
+                    self.assertEqual(x.t().contiguous(), expected)
+                    y = torch.empty(n, m, dtype=dtype).t()
+                    y.copy_(expected)
+                    self.assertEqual(y, expected)
+
+                x = torch.arange(2 * 19 * 7 * 9).reshape(2, 19, 7, 9).to(dtype)
+                nhwc = x.contiguous(memory_format=torch.channels_last)
+                self.assertTrue(nhwc.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(nhwc, x)
+                self.assertEqual(nhwc.contiguous(), x)
+                self.assertEqual(x.permute(0, 2, 3, 1).contiguous(),
+                                 torch.stack([x[:, c] for c in range(19)], dim=-1))
+
+        def test_copy_float_reduced_precision(self):
+            # float <-> half / bfloat16 copies are vectorized on contiguous
+            # runs, check the tails, strided operands and the rounding
+            for n in (1, 7, 8, 33, 1000):
+                x = torch.randn(n) * 1000
+                x[0] = float('inf')
+                x[-1] = 2 ** -20
+                expected = torch.from_numpy(x.numpy().astype(np.float16))
+                self.assertEqual(x.half(), expected, atol=0, rtol=0)
+                self.assertEqual(expected.float(), torch.from_numpy(expected.numpy().astype(np.float32)),
+                                 atol=0, rtol=0)
+                self.assertEqual(x[::2].half(), expected[::2], atol=0, rtol=0)
+                y = torch.empty(n, 2, dtype=torch.half)[:, 0]
+                y.copy_(x)
+                self.assertEqual(y, expected, atol=0, rtol=0)
+
+                # round to nearest even on the upper 16 bits
+                bits = x.view(torch.int32).long() & 0xffffffff
+                rounded = ((bits + 0x7fff + ((bits >> 16) & 1)) >> 16) << 16
+                expected = rounded.int().view(torch.float)
+                self.assertEqual(x.bfloat16().float(), expected, atol=0, rtol=0)
+                self.assertEqual(x[::2].bfloat16().float(), expected[::2], atol=0, rtol=0)
+                y = torch.empty(n, 2, dtype=torch.float)[:, 0]
+                y.copy_(x.bfloat16())
+                self.assertEqual(y, expected, atol=0, rtol=0)
+
         def test_device(self):
             cpu = torch.device('cpu')
             self.assertEqual('cpu', str(cpu))
@@ -5072,6 +5119,49 @@ tensor([[[1.+1.j, 1.+1.j, 1.+1.j,  ..., 1.+1.j, 1.+1.j, 1.+1.j],
             z = x + y
             self.assertEqual(z.size(), (2 ** 20, 2 ** 20))
 
+        def test_meta_ops(self):
+            x = torch.empty_meta(4, 6)
+            y = torch.empty_meta(6, dtype=torch.double)
+            self.assertTrue((x * y).is_meta)
+            self.assertEqual((x * y).dtype, torch.double)
+            self.assertEqual(x.t().size(), (6, 4))
+            self.assertEqual(x.view(2, 12).size(), (2, 12))
+            self.assertEqual(x.t().reshape(24).size(), (24,))
+            self.assertEqual(x.unsqueeze(1).expand(4, 3, 6).size(), (4, 3, 6))
+            self.assertEqual(torch.relu(x).size(), (4, 6))
+            self.assertEqual(x.sum(1, keepdim=True).size(), (4, 1))
+            self.assertEqual(torch.mm(x, x.t()).size(), (4, 4))
+            self.assertEqual(torch.cat([x, x], dim=1).size(), (4, 12))
+            self.assertEqual(torch.softmax(x, 1).size(), (4, 6))
+            self.assertEqual(x.to(torch.half).dtype, torch.half)
+            with self.assertRaisesRegex(RuntimeError, "size mismatch"):
+                torch.mm(x, x)
+
+        def test_meta_module_forward(self):
+            # A meta input through a module with real parameters gives the
+            # shape of every activation without computing any of them.
+            model = torch.nn.Sequential(
+                torch.nn.Conv2d(3, 8, 3, stride=2, padding=1),
+                torch.nn.BatchNorm2d(8),
+                torch.nn.ReLU(inplace=True),
+                torch.nn.MaxPool2d(2),
+                torch.nn.AdaptiveAvgPool2d((2, 2)),
+                torch.nn.Flatten(),
+                torch.nn.Linear(32, 10),
+                torch.nn.LogSoftmax(dim=1),
+            ).eval()
+            activations = []
+            for module in model:
+                module.register_forward_hook(lambda m, i, o: activations.append(o))
+            with torch.no_grad():
+                model(torch.randn(5, 3, 32, 32))
+                expected = [o.size() for o in activations]
+                activations.clear()
+                out = model(torch.empty_meta(5, 3, 32, 32))
+            self.assertTrue(out.is_meta)
+            self.assertEqual([o.size() for o in activations], expected)
+            self.assertTrue(all(o.is_meta for o in activations))
+
         def test_tensor_grad_warnings(self):
             dummy = torch.empty(1)
 
@@ -7218,6 +7308,28 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(res1, res2)
         self.assertTrue(res2.is_contiguous(memory_format=torch.channels_last))
 
+    def test_cat_many_inputs(self, device):
+        # hundreds of inputs of different sizes, large enough to be split
+        # across threads on CPU and to need many blocks along grid y on CUDA
+        for dtype in (torch.bool, torch.int8, torch.half, torch.float, torch.complex64):
+            sizes = [(i * 7) % 13 for i in range(300)]
+            inputs = [torch.arange(4 * s * 50, device=device).reshape(4, s, 50).to(dtype)
+                      for s in sizes]
+            for dim in range(3):
+                permuted = [t.transpose(1, dim).contiguous() for t in inputs]
+                res = torch.cat(permuted, dim=dim)
+                offset = 0
+                for t in permuted:
+                    size = t.size(dim)
+                    self.assertEqual(res.narrow(dim, offset, size), t)
+                    offset += size
+
+        inputs = [torch.randn(2, 3 + i % 5, 6, 7, device=device).contiguous(memory_format=torch.channels_last)
+                  for i in range(200)]
+        res = torch.cat(inputs, dim=1)
+        self.assertTrue(res.is_contiguous(memory_format=torch.channels_last))
+        self.assertEqual(res, torch.cat([t.contiguous() for t in inputs], dim=1))
+
     @onlyCUDA
     @deviceCountAtLeast(2)
     def test_cat_different_devices(self, devices):
@@ -7425,6 +7537,33 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(torch.matmul(matrices, matrices_inverse),
                          torch.eye(3, dtype=torch.float64).to(device).expand_as(matrices))
 
+    @onlyCUDA
+    @dtypes(torch.float, torch.double)
+    def test_batched_small_matrices_cublas(self, device, dtype):
+        # batches of matrices up to 32x32 use cuBLAS' batched LU routines
+        from torch.testing._internal.common_utils import random_fullrank_matrix_distinct_singular_value
+        prec = 1e-3 if dtype == torch.float else 1e-8
+        for n in (1, 6, 32):
+            A = random_fullrank_matrix_distinct_singular_value(n, 4000, dtype=dtype).to(device)
+            eye = torch.eye(n, dtype=dtype, device=device).expand_as(A)
+            self.assertEqual(torch.matmul(torch.inverse(A), A), eye, atol=prec, rtol=0)
+
+            b = torch.randn(4000, n, 3, dtype=dtype, device=device)
+            x = torch.solve(b, A)[0]
+            self.assertEqual(torch.matmul(A, x), b, atol=prec, rtol=0)
+
+            LU, pivots = torch.lu(A)
+            P, L, U = torch.lu_unpack(LU, pivots)
+            self.assertEqual(torch.matmul(P, torch.matmul(L, U)), A, atol=prec, rtol=0)
+
+        A = torch.eye(6, dtype=dtype, device=device).repeat(5, 1, 1)
+        A[3, 2, 2] = 0
+        with self.assertRaisesRegex(RuntimeError, r'inverse_cuda: For batch 3: U\(3,3\) is zero'):
+            torch.inverse(A)
+        with self.assertRaisesRegex(RuntimeError, r'solve_cuda: For batch 3: U\(3,3\) is zero'):
+            torch.solve(torch.randn(5, 6, 1, dtype=dtype, device=device), A)
+        self.assertEqual(torch.lu(A, get_infos=True)[2], torch.tensor([0, 0, 0, 3, 0], dtype=torch.int32))
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -11695,6 +11834,32 @@ class TestTorchDeviceType(TestCase):
             expected = self._brute_cdist(x, y, p=2)
             self.assertEqual(expected, actual)
 
+    def test_cdist_euclidean_large_offset(self, device):
+        # Points that are close together but far from the origin
+        x = torch.randn(50, 10, device=device, dtype=torch.double) + 1e4
+        y = torch.randn(60, 10, device=device, dtype=torch.double) + 1e4
+        actual = torch.cdist(x.float(), y.float(), p=2, compute_mode='use_mm_for_euclid_dist')
+        expected = self._brute_cdist(x, y, p=2).float()
+        self.assertEqual(expected, actual, atol=1e-3, rtol=1e-4)
+
+    @onlyCPU
+    def test_cdist_topk(self, device):
+        for shape1, shape2 in [((70, 5), (3000, 5)), ((2, 130, 4), (2, 50, 4)), ((0, 3), (8, 3))]:
+            x = torch.randn(shape1, device=device, dtype=torch.double)
+            y = torch.randn(shape2, device=device, dtype=torch.double)
+            for p in [0, 1, 2, 3.5, float('inf')]:
+                dist = torch.cdist(x, y, p=p)
+                for k in [0, 1, 7, shape2[-2]]:
+                    values, indices = torch._cdist_topk(x, y, k, p)
+                    expected = dist.topk(k, dim=-1, largest=False).values
+                    self.assertEqual(expected, values)
+                    self.assertEqual(dist.gather(-1, indices), values)
+
+        x = torch.randn(4, 3, device=device)
+        y = torch.randn(5, 3, device=device)
+        with self.assertRaisesRegex(RuntimeError, "k \\(6\\) must be between"):
+            torch._cdist_topk(x, y, 6)
+
     @tf32_on_and_off(0.005)
     def test_cdist_non_contiguous(self, device):
         for cm in ['use_mm_for_euclid_dist', 'donot_use_mm_for_euclid_dist']:
@@ -12143,6 +12308,34 @@ class TestTorchDeviceType(TestCase):
         x[2::3] = .5
         self._test_large_cum_fn_helper(x, lambda x: torch.cumprod(x, 0))
 
+    @onlyCPU
+    @unittest.skipIf(not TEST_NUMPY, 'NumPy not found')
+    def test_cumulative_ops_long_dim(self, device):
+        # Long scans over few rows take the chunked parallel path
+        n = 200003
+        for dtype in (torch.int64, torch.int32, torch.float, torch.double):
+            x = torch.randint(-3, 4, (n,), device=device, dtype=dtype)
+            expected = torch.from_numpy(np.cumsum(x.numpy(), 0))
+            self.assertEqual(torch.cumsum(x, 0), expected.to(dtype))
+            # strided input and output, and two rows along the scanned dim
+            x2 = torch.randint(-3, 4, (n, 2), device=device, dtype=dtype)
+            expected = torch.from_numpy(np.cumsum(x2.numpy(), 0)).to(dtype)
+            self.assertEqual(torch.cumsum(x2, 0), expected)
+            out = torch.empty(2, n, device=device, dtype=dtype).t()
+            torch.cumsum(x2, 0, out=out)
+            self.assertEqual(out, expected)
+
+        x = torch.ones(n, device=device, dtype=torch.double)
+        x[::7] = -1
+        x[5::11] = 2
+        x[6::11] = .5
+        self.assertEqual(torch.cumprod(x, 0), torch.from_numpy(np.cumprod(x.numpy(), 0)))
+
+        for dtype in (torch.float, torch.double):
+            x = torch.randn(n, 3, device=device, dtype=dtype)
+            expected = torch.from_numpy(np.logaddexp.accumulate(x.double().numpy(), axis=0))
+            self.assertEqual(torch.logcumsumexp(x, 0), expected.to(dtype), atol=1e-4, rtol=1e-4)
+
     def test_discontiguous_out_cumsum(self, device):
         x = torch.randn(4, 8, device=device)
         y = torch.empty(4, 16, device=device)[:, ::2]
@@ -12427,6 +12620,35 @@ class TestTorchDeviceType(TestCase):
             x.resize_as_(y)
             self.assertEqual(y.shape, x.shape)
 
+    def test_resize_amortized(self, device):
+        x = torch.empty(0, device=device)
+        reallocations = 0
+        ptr = x.data_ptr()
+        for i in range(1000):
+            x.resize_amortized_(i + 1)[i] = i
+            if x.data_ptr() != ptr:
+                reallocations += 1
+                ptr = x.data_ptr()
+        self.assertEqual(x, torch.arange(1000., device=device))
+        self.assertLessEqual(reallocations, 12)
+        self.assertGreaterEqual(x.storage().size(), 1000)
+        self.assertLess(x.storage().size(), 2000)
+
+    def test_reserve(self, device):
+        x = torch.arange(10., device=device)
+        y = x[2:]
+        self.assertIs(y.reserve_(100), y)
+        self.assertEqual(y.shape, (8,))
+        self.assertEqual(x.storage().size(), 102)
+        self.assertEqual(y, torch.arange(2., 10., device=device))
+        ptr = y.data_ptr()
+        y.resize_(100)
+        self.assertEqual(y.data_ptr(), ptr)
+        # never shrinks
+        y.reserve_(1)
+        self.assertEqual(x.storage().size(), 102)
+        self.assertRaises(RuntimeError, lambda: y.reserve_(-1))
+
     def test_view_all_dtypes_and_devices(self, device):
         for dt in torch.testing.get_all_dtypes():
             x = torch.tensor([[1, 2], [3, 4], [5, 6]], dtype=dt, device=device)
@@ -13085,6 +13307,51 @@ class TestTorchDeviceType(TestCase):
                                             [False, True, False, True, False],
                                             [True, False, True, False, True]], device=device))
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_index_add_scatter_add_deterministic(self, device, dtype):
+        prec = 1e-2 if dtype == torch.half else 1e-5
+
+        def run_deterministic(fn):
+            deterministic = torch.is_deterministic()
+            torch.set_deterministic(True)
+            try:
+                return fn(), fn()
+            finally:
+                torch.set_deterministic(deterministic)
+
+        # Many collisions, including a destination every source adds to
+        for dim in (0, 1, 2):
+            self_sizes = [5, 6, 7]
+            source_sizes = list(self_sizes)
+            source_sizes[dim] = 300
+            x = torch.randn(self_sizes, device=device, dtype=dtype)
+            source = torch.randn(source_sizes, device=device, dtype=dtype)
+            index = torch.randint(self_sizes[dim], (300,), device=device)
+            index[:100] = 1
+            out1, out2 = run_deterministic(lambda: x.clone().index_add_(dim, index, source))
+            expected = x.double().cpu().index_add_(dim, index.cpu(), source.double().cpu())
+            self.assertEqual(out1, out2, atol=0, rtol=0)
+            self.assertEqual(out1.double(), expected, atol=prec * 10, rtol=prec)
+
+            index = torch.randint(self_sizes[dim], source_sizes, device=device)
+            out1, out2 = run_deterministic(lambda: x.clone().scatter_add_(dim, index, source))
+            expected = x.double().cpu().scatter_add_(dim, index.cpu(), source.double().cpu())
+            self.assertEqual(out1, out2, atol=0, rtol=0)
+            self.assertEqual(out1.double(), expected, atol=prec * 10, rtol=prec)
+
+        # Non-contiguous self, and a src larger than index
+        x = torch.randn(8, 6, device=device, dtype=dtype).t()
+        source = torch.randn(10, 8, device=device, dtype=dtype)
+        index = torch.randint(6, (4, 5), device=device)
+        out1, _ = run_deterministic(lambda: x.clone().scatter_add_(0, index, source))
+        expected = x.double().cpu().scatter_add_(0, index.cpu(), source.double().cpu())
+        self.assertEqual(out1.double(), expected, atol=prec, rtol=prec)
+
+        with self.assertRaisesRegex(IndexError, "out of bounds"):
+            run_deterministic(lambda: x.clone().index_add_(0, torch.tensor([6], device=device),
+                                                           torch.randn(1, 8, device=device, dtype=dtype)))
+
     def test_masked_scatter_bool_tensor(self, device):
         src = torch.tensor([True, True, True], device=device)
         dst = torch.tensor([False, False, False], device=device)
@@ -13465,6 +13732,35 @@ class TestTorchDeviceType(TestCase):
         nz = x.nonzero()
         self.assertFalse(nz.requires_grad)
 
+    @dtypes(torch.bool, torch.int32, torch.float)
+    def test_nonzero_masked_select_static(self, device, dtype):
+        for shape in ((0,), (), (17,), (5, 6), (3, 4, 5)):
+            x = torch.randint(0, 2, shape, device=device).to(dtype)
+            expected = x.nonzero()
+            count = expected.size(0)
+            selected = torch.randn(shape, device=device)
+            expected_values = selected.masked_select(x != 0)
+            for size in (0, count // 2, count, count + 3):
+                out, n = torch._nonzero_static(x, size, fill_value=-7)
+                self.assertEqual(n.device, x.device)
+                self.assertEqual(n.item(), count)
+                self.assertEqual(out.shape, (size, x.dim()))
+                used = min(size, count)
+                self.assertEqual(out[:used], expected[:used])
+                self.assertTrue((out[used:] == -7).all())
+
+                out, n = torch._masked_select_static(selected, x != 0, size)
+                self.assertEqual(n.item(), count)
+                self.assertEqual(out[:used], expected_values[:used])
+                self.assertTrue((out[used:] == 0).all())
+
+        # Broadcasting mask
+        x = torch.randn(4, 5, device=device)
+        mask = torch.tensor([True, False, True, True, False], device=device)
+        out, n = torch._masked_select_static(x, mask, 20)
+        self.assertEqual(n.item(), 12)
+        self.assertEqual(out[:12], x.masked_select(mask))
+
     def _brute_pdist(self, inp, p=2):
         """Computes the same as torch.pdist using primitives"""
         n = inp.shape[-2]
@@ -14674,6 +14970,64 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.int64)
+    def test_sort_topk_long_slices(self, device, dtype):
+        # Long slices are split between threads when there are only a few.
+        for shape in ((300001,), (2, 100003)):
+            x = torch.randint(-1000, 1000, shape, device=device).to(dtype)
+            if dtype.is_floating_point:
+                x[..., 5] = float('nan')
+            for descending in (False, True):
+                val, ind = x.sort(descending=descending)
+                self.assertEqual(x.gather(-1, ind), val, atol=0, rtol=0)
+                nan = val != val
+                if descending:
+                    # NaNs come first in descending order, and last in ascending order.
+                    self.assertTrue((val[..., :-1] >= val[..., 1:]).logical_or(nan[..., :-1]).all())
+                else:
+                    self.assertTrue((val[..., :-1] <= val[..., 1:]).logical_or(nan[..., 1:]).all())
+                self.assertEqual(ind.sort()[0], torch.arange(shape[-1], device=device).expand(shape))
+            for k in (1, 10, 1000):
+                for largest in (True, False):
+                    val, ind = x.topk(k, largest=largest)
+                    self.assertEqual(val, x.sort(descending=largest)[0][..., :k], atol=0, rtol=0)
+                    self.assertEqual(x.gather(-1, ind), val, atol=0, rtol=0)
+
+    @onlyCUDA
+    @dtypes(torch.float, torch.double, torch.int32, torch.int64)
+    def test_sort_topk_radix_sort(self, device, dtype):
+        # Slices too long for the bitonic sort: many mid-size ones (segmented
+        # sort), one long one, a few long ones, and slices along a
+        # non-innermost dimension.
+        for shape, dim in (((64, 5000), -1), ((300001,), -1), ((3, 100003), -1), ((5000, 7), 0)):
+            x = torch.randint(-1000, 1000, shape, device=device).to(dtype)
+            if dtype.is_floating_point:
+                x.select(dim, 5).fill_(float('nan'))
+                x.select(dim, 7).fill_(-float('nan'))
+            x_cpu = x.cpu()
+            for descending in (False, True):
+                val, ind = x.sort(dim, descending=descending)
+                self.assertEqual(val, x_cpu.sort(dim, descending=descending)[0], atol=0, rtol=0)
+                self.assertEqual(x.gather(dim, ind), val, atol=0, rtol=0)
+                positions = torch.arange(shape[dim], device=device)
+                self.assertEqual(ind.sort(dim)[0], positions.view([-1 if d == dim % len(shape) else 1 for d in range(len(shape))]).expand(shape))
+            for largest in (True, False):
+                val, ind = x.topk(3000, dim, largest=largest)
+                self.assertEqual(val, x.sort(dim, descending=largest)[0].narrow(dim, 0, 3000), atol=0, rtol=0)
+                self.assertEqual(x.gather(dim, ind), val, atol=0, rtol=0)
+
+        # In place, and into non-contiguous outputs
+        x = torch.randn(4, 3000, device=device).to(dtype)
+        expected = x.sort()
+        values = torch.empty(3000, 4, device=device, dtype=dtype).t()
+        indices = torch.empty(3000, 4, device=device, dtype=torch.long).t()
+        torch.sort(x, out=(values, indices))
+        self.assertEqual(values, expected[0], atol=0, rtol=0)
+        self.assertEqual(indices, expected[1], atol=0, rtol=0)
+        torch.sort(x, out=(x, indices))
+        self.assertEqual(x, expected[0], atol=0, rtol=0)
+
 
 
 
@@ -15132,6 +15486,31 @@ class TestTorchDeviceType(TestCase):
             self._test_unique_with_expects(device, dtype, f, x, expected_unique, expected_inverse, expected_counts, (3, 3))
             self._test_unique_scalar_empty(dtype, device, f)
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @dtypes(torch.int64, torch.float)
+    def test_unique_large(self, device, dtype):
+        # large enough for the parallel CPU implementations
+        x = torch.randint(0, 5000, (300000,), device=device).to(dtype)
+        expected_unique, expected_inverse, expected_counts = np.unique(
+            x.cpu().numpy(), return_inverse=True, return_counts=True)
+        x_unique, x_inverse, x_counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(x_unique, torch.from_numpy(expected_unique))
+        self.assertEqual(x_inverse, torch.from_numpy(expected_inverse))
+        self.assertEqual(x_counts, torch.from_numpy(expected_counts))
+
+        x_unique, x_inverse, x_counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(x_unique[x_inverse], x)
+        self.assertEqual(x_unique.sort()[0], torch.from_numpy(expected_unique))
+        self.assertEqual(x_counts, torch.bincount(x_inverse))
+
+        y = x.sort()[0][torch.randint(0, 2, (300000,), device=device).cumsum(0) // 2]
+        expected_unique = y[torch.cat([torch.ones(1, dtype=torch.bool, device=device), y[1:] != y[:-1]])]
+        y_unique, y_inverse, y_counts = torch.unique_consecutive(y, return_inverse=True, return_counts=True)
+        self.assertEqual(y_unique, expected_unique)
+        self.assertEqual(y_unique[y_inverse], y)
+        self.assertEqual(y_counts.sum(), y.numel())
+        self.assertEqual(y_counts, torch.bincount(y_inverse))
+
     @dtypesIfCUDA(torch.half, torch.float, torch.double)
     @dtypes(torch.float, torch.double)
     def test_erfinv(self, device, dtype):
@@ -15190,6 +15569,30 @@ class TestTorchDeviceType(TestCase):
         z = from_dlpack(to_dlpack(x))
         self.assertEqual(z, x)
 
+    def test_dlpack_protocol_strided(self, device):
+        x = torch.randn(4, 6, 8, device=device)
+        for view in (x[1:, ::2], x.transpose(0, 2), x[2, 3:]):
+            z = from_dlpack(view)
+            self.assertEqual(z, view)
+            self.assertEqual(z.stride(), view.stride())
+            self.assertEqual(z.data_ptr(), view.data_ptr())
+        self.assertEqual(x.__dlpack_device__()[1], x.get_device() if x.is_cuda else 0)
+
+    @onlyCUDA
+    def test_dlpack_stream_handshake(self, device):
+        producer = torch.cuda.Stream()
+        consumer = torch.cuda.Stream()
+        with torch.cuda.stream(producer):
+            x = torch.ones(1 << 20, device=device)
+            torch.cuda._sleep(1000000)
+            x.mul_(2)
+            capsule = to_dlpack(x, stream=consumer.cuda_stream)
+        with torch.cuda.stream(consumer):
+            self.assertEqual(from_dlpack(capsule).sum().item(), 2 << 20)
+        with torch.cuda.stream(consumer):
+            y = from_dlpack(x)
+            self.assertEqual(y.sum().item(), 2 << 20)
+
     @onlyCUDA
     @unittest.skipIf(PYTORCH_CUDA_MEMCHECK, "is_pinned uses failure to detect pointer property")
     def test_pin_memory_from_constructor(self, device):
@@ -15389,15 +15792,32 @@ class TestTorchDeviceType(TestCase):
     @dtypesIfCUDA(torch.half, torch.float)
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_minmax(self, device, dtype):
-        if self.device_type == "cuda":
-            # FIXME when minmax is implemented on cuda
-            with self.assertRaises(RuntimeError):
-                self._test_minmax_helper(lambda x: torch._min_max(x)[0], np.min, device, dtype, skip_indices=True)
-            return
-
         self._test_minmax_helper(lambda x: torch._min_max(x)[0], np.min, device, dtype, skip_indices=True)
         self._test_minmax_helper(lambda x: torch._min_max(x)[1], np.max, device, dtype, skip_indices=True)
 
+    @onlyOnCPUAndCUDA
+    @dtypesIfCPU(torch.float, torch.double, torch.long)
+    @dtypesIfCUDA(torch.half, torch.float, torch.long)
+    def test_minmax_dim(self, device, dtype):
+        if dtype.is_floating_point:
+            x = torch.randn(7, 33, 65, device=device, dtype=dtype)
+        else:
+            x = torch.randint(-1000, 1000, (7, 33, 65), device=device, dtype=dtype)
+        for xinp in (x, x.transpose(0, 2)):
+            for dim, keepdim in product(range(-3, 3), (False, True)):
+                min_val, max_val = torch._min_max(xinp, dim, keepdim)
+                self.assertEqual(min_val, torch.min(xinp, dim, keepdim)[0], atol=0, rtol=0)
+                self.assertEqual(max_val, torch.max(xinp, dim, keepdim)[0], atol=0, rtol=0)
+
+        if dtype.is_floating_point:
+            x[2, 5, 7] = nan
+            min_val, max_val = torch._min_max(x, 1)
+            self.assertTrue(min_val[2, 7].isnan() and max_val[2, 7].isnan())
+            self.assertEqual(min_val.isnan().sum(), 1)
+
+        with self.assertRaisesRegex(RuntimeError, "zero-size dimension"):
+            torch._min_max(torch.empty(3, 0, device=device, dtype=dtype), 1)
+
     def test_bincount(self, device):
         # negative input throws
         with self.assertRaisesRegex(RuntimeError, '1-d non-negative integral'):
@@ -15481,6 +15901,25 @@ class TestTorchDeviceType(TestCase):
         big_exp[1] = 1000000
         big_out = torch.ones(1000000, dtype=torch.int8, device=device).bincount()
         self.assertEqual(big_exp, big_out)
+        # test large input size with weights and several bins
+        big_in = torch.arange(1000000, device=device) % 1000
+        big_out = big_in.bincount(torch.full((1000000,), 0.5, dtype=torch.double, device=device))
+        self.assertEqual(torch.full((1000,), 500., dtype=torch.double, device=device), big_out)
+
+    @onlyCUDA
+    def test_bincount_histc_skewed(self, device):
+        # nbins picks between per-warp, per-block and multi-pass shared
+        # memory histograms, and global memory for the largest
+        for nbins in (7, 1000, 40000, 1000000):
+            # half of the values land in bin 0
+            x = torch.randint(nbins, (200000,), device=device)
+            x[::2] = 0
+            x[-1] = nbins - 1
+            w = torch.rand(x.shape, device=device, dtype=torch.double)
+            self.assertEqual(x.bincount(), x.cpu().bincount())
+            self.assertEqual(x.bincount(w), x.cpu().bincount(w.cpu()))
+            xf = x.double()
+            self.assertEqual(xf.histc(nbins, 0, nbins), xf.cpu().histc(nbins, 0, nbins))
 
     @onlyCUDA
     @expectedAlertNondeterministic('_bincount_cuda', fn_has_device_arg=False)
@@ -16439,6 +16878,83 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
         for use_out, row_major, incx, incy, lda_tail in product((False, True), (False, True), (1, 2), (1, 2), (0, 1)):
             _test(use_out, row_major, incx, incy, lda_tail)
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_addmm_activation(self, device, dtype):
+        prec = 1e-2 if dtype == torch.half else 1e-4
+        for transpose_m1, transpose_m2, bias_1d in product((False, True), repeat=3):
+            m1 = torch.randn(10, 50, device=device, dtype=dtype)
+            m2 = torch.randn(50, 25, device=device, dtype=dtype)
+            if transpose_m1:
+                m1 = m1.t().contiguous().t()
+            if transpose_m2:
+                m2 = m2.t().contiguous().t()
+            M = torch.randn(25 if bias_1d else (10, 25), device=device, dtype=dtype)
+            # addmm with a 1-D bias takes the fused bias epilogue on CUDA
+            expected = torch.addmm(M.float(), m1.float(), m2.float(), alpha=0.5)
+            self.assertEqual(torch.addmm(M, m1, m2, alpha=0.5).float(), expected, atol=prec, rtol=prec)
+            res = torch._addmm_activation(M, m1, m2, alpha=0.5)
+            self.assertEqual(res.float(), expected.relu(), atol=prec, rtol=prec)
+            res = torch._addmm_activation(M, m1, m2, alpha=0.5, use_gelu=True)
+            self.assertEqual(res.float(), torch.nn.functional.gelu(expected), atol=prec, rtol=prec)
+            out = torch.empty(0, device=device, dtype=dtype)
+            torch._addmm_activation(M, m1, m2, alpha=0.5, out=out)
+            self.assertEqual(out.float(), expected.relu(), atol=prec, rtol=prec)
+
+    @dtypes(torch.double)
+    def test_addmm_activation_backward(self, device, dtype):
+        M = torch.randn(4, device=device, dtype=dtype, requires_grad=True)
+        m1 = torch.randn(3, 5, device=device, dtype=dtype, requires_grad=True)
+        m2 = torch.randn(5, 4, device=device, dtype=dtype, requires_grad=True)
+        self.assertTrue(torch.autograd.gradcheck(
+            lambda M, m1, m2: torch._addmm_activation(M, m1, m2, beta=0.5), (M, m1, m2)))
+
+    def _attention_reference(self, q, k, v, key_padding_mask, is_causal, scale):
+        attn = torch.bmm(q.float(), k.float().transpose(1, 2)) * scale
+        if is_causal:
+            attn.masked_fill_(torch.ones(attn.shape[1:], dtype=torch.bool, device=q.device).triu(1), float('-inf'))
+        if key_padding_mask is not None:
+            B = key_padding_mask.size(0)
+            attn = attn.view(B, -1, *attn.shape[1:]).masked_fill(
+                key_padding_mask[:, None, None, :], float('-inf')).view(attn.shape)
+        return torch.bmm(attn.softmax(-1), v.float())
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.bfloat16, torch.float, torch.double)
+    def test_fused_attention(self, device, dtype):
+        prec = 1e-2 if dtype in (torch.half, torch.bfloat16) else 1e-4
+        # Head dims below, at and above the warp size; the last one exceeds the
+        # kernel's limit and takes the unfused path
+        for L, S, E in ((1, 1, 8), (7, 50, 32), (70, 33, 64), (5, 9, 160)):
+            q = torch.randn(6, L, E, device=device, dtype=dtype)
+            k = torch.randn(6, S, E, device=device, dtype=dtype)
+            v = torch.randn(6, S, E, device=device, dtype=dtype)
+            # 2 batches of 3 heads, key 0 is never masked
+            mask = torch.rand(2, S, device=device) > 0.7
+            mask[:, 0] = False
+            for key_padding_mask, is_causal in product((None, mask), (False, True)):
+                res = torch._fused_attention(q, k, v, key_padding_mask, is_causal, 0.25)
+                expected = self._attention_reference(q, k, v, key_padding_mask, is_causal, 0.25)
+                self.assertEqual(res.float(), expected, atol=prec, rtol=prec)
+
+        # Rows with every key masked are NaN, like a softmax of -inf scores
+        q = torch.randn(2, 3, 8, device=device, dtype=dtype)
+        kv = torch.randn(2, 4, 8, device=device, dtype=dtype)
+        mask = torch.tensor([[True] * 4, [False] * 4], device=device)
+        res = torch._fused_attention(q, kv, kv, mask)
+        self.assertTrue(res[0].isnan().all())
+        self.assertFalse(res[1].isnan().any())
+
+    @dtypes(torch.double)
+    def test_fused_attention_backward(self, device, dtype):
+        q = torch.randn(4, 5, 8, device=device, dtype=dtype, requires_grad=True)
+        k = torch.randn(4, 6, 8, device=device, dtype=dtype, requires_grad=True)
+        v = torch.randn(4, 6, 8, device=device, dtype=dtype, requires_grad=True)
+        mask = torch.tensor([[False, True, False, False, True, False]] * 2, device=device)
+        for key_padding_mask, is_causal in product((None, mask), (False, True)):
+            self.assertTrue(torch.autograd.gradcheck(
+                lambda q, k, v: torch._fused_attention(q, k, v, key_padding_mask, is_causal, 0.5), (q, k, v)))
+
     @slowTest
     @onlyCPU
     def test_addmm(self, device):
@@ -17249,6 +17765,34 @@ fn(*args)
         res6 = torch.addbmm(res2, b1, b2, beta=.1, alpha=.5)
         self.assertEqual(res6, res2 * .1 + .5 * res.sum(0)),
 
+    @onlyCPU
+    @dtypes(*(torch.testing.get_all_complex_dtypes() + [torch.float, torch.double, torch.long]))
+    def test_bmm_small(self, device, dtype):
+        # matrices of at most 32x32, which take the batched small gemm kernels
+        def gen(*shape):
+            if dtype.is_floating_point or dtype.is_complex:
+                return torch.randn(*shape, dtype=dtype, device=device)
+            return torch.randint(-5, 5, shape, dtype=dtype, device=device)
+
+        for M, N, O in [(4, 4, 4), (8, 16, 8), (32, 32, 32), (5, 7, 3), (1, 32, 16), (13, 1, 32)]:
+            b1 = gen(50, M, N)
+            b2 = gen(50, N, O)
+            expected = torch.stack([torch.mm(b1[i], b2[i]) for i in range(50)])
+            self.assertEqual(torch.bmm(b1, b2), expected)
+            # transposed operands and a result with non-contiguous rows
+            self.assertEqual(torch.bmm(b1.transpose(1, 2).contiguous().transpose(1, 2),
+                                       b2.transpose(1, 2).contiguous().transpose(1, 2)), expected)
+            out = torch.empty(50, O, M, dtype=dtype, device=device).transpose(1, 2)
+            torch.bmm(b1, b2, out=out)
+            self.assertEqual(out, expected)
+
+            c = gen(50, M, O)
+            self.assertEqual(torch.baddbmm(c, b1, b2, beta=2, alpha=3), 2 * c + 3 * expected)
+            if dtype.is_floating_point or dtype.is_complex:
+                # self is ignored when beta is 0
+                nan = torch.full_like(c, float('nan'))
+                self.assertEqual(torch.baddbmm(nan, b1, b2, beta=0), expected)
+
     @onlyCPU
     @dtypes(*(torch.testing.get_all_complex_dtypes() + [torch.float, torch.double]))
     def test_baddbmm(self, device, dtype):
@@ -18068,6 +18612,33 @@ fn(*args)
         test_output_dtype(torch.int32, False)
         test_output_dtype(torch.int64, True)
 
+    @dtypes(torch.int32, torch.float)
+    def test_bucketization_large_boundaries(self, device, dtype):
+        # boundaries long enough for the CPU Eytzinger search, with repeated values
+        boundaries = torch.randint(-50, 50, (300,), device=device).sort().values.to(dtype)
+        values = torch.randint(-60, 60, (3, 400), device=device).to(dtype)
+        if dtype.is_floating_point:
+            values[0, :5] = float('nan')
+            values[1, :5] = float('inf')
+            values[2, :5] = -float('inf')
+
+        def reference(boundaries, values, right):
+            below = boundaries.unsqueeze(-2) <= values.unsqueeze(-1) if right else \
+                boundaries.unsqueeze(-2) < values.unsqueeze(-1)
+            # NaN values land past the last boundary
+            return below.sum(-1) + values.isnan().long() * boundaries.size(-1)
+
+        for right in [False, True]:
+            expected = reference(boundaries, values, right)
+            self.assertEqual(torch.bucketize(values, boundaries, right=right), expected, atol=0, rtol=0)
+            self.assertEqual(torch.bucketize(values, boundaries, right=right, out_int32=True),
+                             expected.int(), atol=0, rtol=0)
+
+            # one boundary row per row of values
+            boundaries_2d = torch.randint(-50, 50, (3, 300), device=device).sort().values.to(dtype)
+            expected = reference(boundaries_2d, values, right)
+            self.assertEqual(torch.searchsorted(boundaries_2d, values, right=right), expected, atol=0, rtol=0)
+
     def test_pickle_gradscaler(self, device):
         # This test is not in test_cuda.py because it should pass in 3 cases:
         #  1. cuda is not available.
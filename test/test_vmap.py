@@ -1,6 +1,7 @@
 from torch.testing._internal.common_utils import TestCase, run_tests
 import torch
 from torch import vmap
+import torch.nn.functional as F
 import warnings
 
 class TestVmapAPI(TestCase):
@@ -445,32 +446,32 @@ class TestVmapAPI(TestCase):
             self.assertRegex(str(wa[-1].message),
                              r'falling back to slow \(for loop and stack\) implementation')
 
-    def test_fallback_sub(self):
-        # NB: One day we will implement a batching rule for torch.sub.
+    def test_fallback_atan2(self):
+        # NB: One day we will implement a batching rule for torch.atan2.
         # If/when we do, this test should be replaced to test the fallback
         # path on another operator to avoid bitrot.
         x = torch.randn(5, 7, 11)
         y = torch.randn(5, 7, 11)
 
-        self._assert_uses_vmap_fallback((torch.sub,), (x, y))
+        self._assert_uses_vmap_fallback((torch.atan2,), (x, y))
 
-        # fallback on torch.sub
+        # fallback on torch.atan2
         x = torch.randn(7, 11, 5)
         y = torch.randn(5, 7, 11)
-        result = vmap(torch.sub, (2, 0))(x, y)
-        self.assertEqual(result, x.permute(2, 0, 1) - y)
+        result = vmap(torch.atan2, (2, 0))(x, y)
+        self.assertEqual(result, torch.atan2(x.permute(2, 0, 1), y))
 
-        # fallback on torch.sub, nested vmap
+        # fallback on torch.atan2, nested vmap
         x = torch.randn(7, 11, 5)
         y = torch.randn(5, 7, 11)
-        result = vmap(vmap(torch.sub), (2, 0))(x, y)
-        self.assertEqual(result, x.permute(2, 0, 1) - y)
+        result = vmap(vmap(torch.atan2), (2, 0))(x, y)
+        self.assertEqual(result, torch.atan2(x.permute(2, 0, 1), y))
 
         # big batch size (total 10000)
         x = torch.randn(100, 10, 10, 5)
         y = torch.randn(100, 10, 10)
-        result = vmap(vmap(vmap(torch.sub)))(x, y)
-        self.assertEqual(result, x - y.view(100, 10, 10, 1))
+        result = vmap(vmap(vmap(torch.atan2)))(x, y)
+        self.assertEqual(result, torch.atan2(x, y.view(100, 10, 10, 1)))
 
     def test_fallback_masked_fill(self):
         # NB: One day we will implement a batching rule for masked_fill
@@ -584,6 +585,113 @@ class TestVmapOperators(TestCase):
     def _vmap_view_test(self, *args, **kwargs):
         self._vmap_test(*args, **kwargs, check_view=True)
 
+    def test_unary_pointwise_ops(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+        for op in (torch.abs, torch.cos, torch.exp, torch.neg, torch.relu,
+                   torch.sigmoid, torch.sin, torch.tanh):
+            test(op, (torch.randn(B0, 3),))
+            test(op, (torch.randn(2, B0),), in_dims=1)
+            test(vmap(op), (torch.randn(B0, B1, 3),))
+        for op in (torch.log, torch.rsqrt, torch.sqrt):
+            test(op, (torch.rand(B0, 3) + 0.1,))
+
+    def test_binary_pointwise_ops(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+        for op in (torch.add, torch.sub, torch.mul, torch.div):
+            test(op, (torch.randn(B0, 3), torch.randn(B0, 3)))
+            test(op, (torch.randn(B0, 3), torch.randn(3)), in_dims=(0, None))
+            test(op, (torch.randn(B0, 2, 3), torch.randn(B0, 3)))
+            test(op, (torch.randn(B0, 3), torch.randn(3, B0)), in_dims=(0, 1))
+            # logical scalars and 0-dim tensors
+            test(op, (torch.randn(B0), torch.randn(B0, 3)))
+            test(op, (torch.randn(B0, 3), torch.tensor(2.)), in_dims=(0, None))
+            test(op, (torch.randn(B0, 3), torch.randn(B0, dtype=torch.double)))
+            test(vmap(op), (torch.randn(B0, B1, 3), torch.randn(B1, 3)), in_dims=(0, None))
+        test(lambda x, y: torch.add(x, y, alpha=2), (torch.randn(B0, 3), torch.randn(B0, 3)))
+
+    def test_reductions(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+        x = torch.randn(B0, 2, 3)
+        test(torch.sum, (x,))
+        test(torch.mean, (x,))
+        test(torch.prod, (x,))
+        test(lambda t: t.sum([]), (x,))
+        test(lambda t: t.sum(0), (x,))
+        test(lambda t: t.mean((0, -1), keepdim=True), (x,))
+        test(lambda t: t.prod(1, keepdim=True), (x,))
+        test(lambda t: t.logsumexp(-1), (x,))
+        test(lambda t: t.softmax(0), (x,))
+        test(lambda t: t.log_softmax(-1), (x,))
+        test(torch.sum, (torch.randn(B0),))
+        test(lambda t: t.sum(0), (torch.randn(B0),))
+        test(lambda t: t.softmax(0), (torch.randn(B0),))
+        test(vmap(lambda t: t.sum(-1)), (torch.randn(B0, B1, 3),))
+
+    def test_matrix_products(self):
+        test = self._vmap_test
+        B0, B1 = 7, 11
+        test(torch.mm, (torch.randn(B0, 2, 5), torch.randn(B0, 5, 3)))
+        test(torch.mm, (torch.randn(B0, 2, 5), torch.randn(5, 3)), in_dims=(0, None))
+        test(torch.mm, (torch.randn(2, 5), torch.randn(B0, 5, 3)), in_dims=(None, 0))
+        test(torch.bmm, (torch.randn(B0, 4, 2, 5), torch.randn(B0, 4, 5, 3)))
+        test(torch.bmm, (torch.randn(4, 2, 5), torch.randn(B0, 4, 5, 3)), in_dims=(None, 0))
+        test(torch.mv, (torch.randn(B0, 2, 5), torch.randn(B0, 5)))
+        test(torch.mv, (torch.randn(B0, 2, 5), torch.randn(5)), in_dims=(0, None))
+        test(torch.dot, (torch.randn(B0, 5), torch.randn(B0, 5)))
+        test(torch.dot, (torch.randn(5), torch.randn(B0, 5)), in_dims=(None, 0))
+        test(torch.matmul, (torch.randn(B0, 5), torch.randn(B0, 5)))
+        test(torch.matmul, (torch.randn(B0, 5), torch.randn(4, 5, 3)), in_dims=(0, None))
+        test(torch.matmul, (torch.randn(B0, 4, 2, 5), torch.randn(5)), in_dims=(0, None))
+        test(torch.matmul, (torch.randn(6, 4, 2, 5), torch.randn(B0, 5, 3)), in_dims=(None, 0))
+        test(vmap(torch.mm), (torch.randn(B0, B1, 2, 5), torch.randn(B1, 5, 3)), in_dims=(0, None))
+
+    def test_conv(self):
+        test = self._vmap_test
+        B0 = 7
+        x = torch.randn(B0, 2, 4, 5, 5)
+        weight = torch.randn(6, 4, 3, 3)
+        bias = torch.randn(6)
+        test(torch.conv2d, (x, weight, bias), in_dims=(0, None, None))
+        test(lambda x, w: torch.conv2d(x, w, padding=1, groups=2),
+             (x, torch.randn(6, 2, 3, 3)), in_dims=(0, None))
+        test(torch.conv2d, (x, torch.randn(B0, 6, 4, 3, 3), bias), in_dims=(0, 0, None))
+        test(torch.conv2d, (x[0], torch.randn(B0, 6, 4, 3, 3)), in_dims=(None, 0))
+        test(torch.conv2d, (x, weight, torch.randn(B0, 6)), in_dims=(0, None, 0))
+        test(torch.conv1d, (torch.randn(B0, 2, 4, 5), torch.randn(B0, 6, 4, 3)))
+        test(torch.conv3d, (torch.randn(B0, 2, 4, 5, 5, 5), torch.randn(6, 4, 3, 3, 3)),
+             in_dims=(0, None))
+
+    def test_index_select_and_gather(self):
+        test = self._vmap_test
+        B0 = 7
+        x = torch.randn(B0, 5, 3)
+        index = torch.tensor([0, 4, 2])
+        test(torch.index_select, (x, 0, index), in_dims=(0, None, None))
+        test(torch.index_select, (x, 1, torch.randint(3, (B0, 2))), in_dims=(0, None, 0))
+        test(torch.index_select, (x[0], 0, torch.randint(5, (B0, 2))), in_dims=(None, None, 0))
+        test(torch.gather, (x, 1, torch.randint(3, (B0, 5, 2))), in_dims=(0, None, 0))
+        test(torch.gather, (x, 0, torch.randint(5, (2, 3))), in_dims=(0, None, None))
+
+    def test_normalizations(self):
+        test = self._vmap_test
+        B0 = 7
+        x = torch.randn(B0, 2, 4, 5)
+        test(lambda x: F.layer_norm(x, (4, 5)), (x,))
+        test(lambda x, w, b: F.layer_norm(x, (5,), w, b),
+             (x, torch.randn(5), torch.randn(5)), in_dims=(0, None, None))
+        test(lambda x, w, b: F.layer_norm(x, (5,), w, b),
+             (x, torch.randn(B0, 5), torch.randn(5)), in_dims=(0, 0, None))
+        test(lambda w, x: F.layer_norm(x, (5,), w),
+             (torch.randn(B0, 5), x[0]), in_dims=(0, None))
+        test(lambda x: F.batch_norm(x, None, None, training=True), (x,))
+        test(lambda x, w, b: F.batch_norm(x, None, None, w, b, training=True),
+             (x, torch.randn(4), torch.randn(4)), in_dims=(0, None, None))
+        test(lambda x, m, v: F.batch_norm(x, m, v), (x, torch.randn(4), torch.rand(4)),
+             in_dims=(0, None, None))
+
     def test_chunk(self):
         test = self._vmap_view_test
         op = torch.chunk
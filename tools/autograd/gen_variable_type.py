@@ -139,6 +139,8 @@ DONT_REQUIRE_DERIVATIVE = {
     'quantize_per_tensor', 'quantize_per_channel',
     # Functions that return integers should not have output that require gradients
     'argmax', 'argmin', 'argsort',
+    # These only change the size or capacity of the storage, like resize_
+    'resize_amortized_', 'reserve_',
 }
 
 # Some operators invalidate the grad_accumulator. Let's reset it.
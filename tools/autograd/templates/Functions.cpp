@@ -622,6 +622,63 @@ Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor &
   }
 }
 
+// Gradient with respect to the addmm output, from the one of the activation
+// output. gelu can't be inverted, so only relu supports backward.
+Tensor addmm_activation_backward(const Tensor & grad, const Tensor & result, bool use_gelu) {
+  if (use_gelu) {
+    return not_implemented("_addmm_activation with use_gelu=True");
+  }
+  return at::threshold_backward(grad, result, 0);
+}
+
+// The attention probabilities are recomputed, so unlike the forward the
+// backward of _fused_attention materializes the [N, L, S] attention matrix.
+std::tuple<Tensor, Tensor, Tensor> fused_attention_backward(
+    const Tensor & grad,
+    const Tensor & query,
+    const Tensor & key,
+    const Tensor & value,
+    const c10::optional<Tensor> & key_padding_mask,
+    bool is_causal,
+    double scale,
+    std::array<bool, 3> grad_input_mask) {
+  if (!grad.defined()) {
+    return std::tuple<Tensor, Tensor, Tensor>();
+  }
+  const int64_t N = query.size(0);
+  const int64_t L = query.size(1);
+  const int64_t S = key.size(1);
+  const auto neg_inf = -std::numeric_limits<double>::infinity();
+  Tensor attn = at::bmm(query, key.transpose(1, 2)).mul_(scale);
+  if (is_causal) {
+    attn.masked_fill_(at::ones({L, S}, query.options().dtype(at::kBool)).triu_(1), neg_inf);
+  }
+  if (key_padding_mask.has_value() && key_padding_mask->defined()) {
+    const int64_t B = key_padding_mask->size(0);
+    attn = attn.view({B, N / B, L, S})
+               .masked_fill_(key_padding_mask->to(attn.device()).reshape({B, 1, 1, S}), neg_inf)
+               .view({N, L, S});
+  }
+  const Tensor probs = at::softmax(attn, -1);
+
+  Tensor grad_query, grad_key, grad_value;
+  if (grad_input_mask[2]) {
+    grad_value = at::bmm(probs.transpose(1, 2), grad);
+  }
+  if (grad_input_mask[0] || grad_input_mask[1]) {
+    const Tensor grad_probs = at::bmm(grad, value.transpose(1, 2));
+    // softmax backward, scaled back to the unscaled scores
+    const Tensor grad_attn = at::_softmax_backward_data(grad_probs, probs, -1, probs).mul_(scale);
+    if (grad_input_mask[0]) {
+      grad_query = at::bmm(grad_attn, key);
+    }
+    if (grad_input_mask[1]) {
+      grad_key = at::bmm(grad_attn.transpose(1, 2), query);
+    }
+  }
+  return std::make_tuple(grad_query, grad_key, grad_value);
+}
+
 Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
   // if input was column-major, return grad as column-order for efficiency
   if (strides[0] == 1 && strides[1] == sizes[0]) {
@@ -712,6 +769,23 @@ Tensor _fused_dropout_backward(Tensor grad, Tensor mask, double p1m) {
   }
 }
 
+std::tuple<Tensor, Tensor> fused_bias_dropout_add_backward(
+    const Tensor & grad,
+    const Tensor & rng_state,
+    double p,
+    std::array<bool, 2> grad_input_mask) {
+  if (!grad.defined()) {
+    return std::tuple<Tensor, Tensor>();
+  }
+  // Differentiable itself, so that this also supports double backward
+  Tensor grad_self = at::_fused_bias_dropout_add_backward(grad, rng_state, p);
+  Tensor grad_bias;
+  if (grad_input_mask[1]) {
+    grad_bias = grad_self.reshape({-1, grad.size(-1)}).sum(0);
+  }
+  return std::make_tuple(grad_input_mask[0] ? grad_self : Tensor(), grad_bias);
+}
+
 Tensor select_first_equal_backward(Tensor grad, const Tensor & input, const Tensor & value) {
   auto grad_input = at::zeros_like(input);
 
@@ -0,0 +1,113 @@
+"""
+This util is invoked from cmake to produce `ATen/selected_mobile_ops.h` for
+dtype selective mobile build.
+It takes a yaml file listing the dtypes the model needs, either for all kernels
+or per kernel tag (the NAME passed to the AT_DISPATCH_* macros), e.g.:
+
+    # dtypes kept for every kernel tag not listed below; all dtypes are kept
+    # when omitted
+    dtypes: [Float, Long, Bool]
+    kernel_dtypes:
+      add_cpu/sub_cpu: [Float]
+      copy_: [Float, Long, Byte, Bool]
+
+and outputs a header defining the constexpr `at::should_include_kernel_dtype`
+consumed by `ATen/Dispatch.h` when TEMPLATE_SELECTIVE_BUILD is defined.
+"""
+
+import argparse
+import os
+import yaml
+
+
+# Must match the names of c10::ScalarType.
+SCALAR_TYPES = [
+    'Byte', 'Char', 'Short', 'Int', 'Long', 'Half', 'Float', 'Double',
+    'ComplexHalf', 'ComplexFloat', 'ComplexDouble', 'Bool', 'QInt8', 'QUInt8',
+    'QInt32', 'BFloat16',
+]
+
+HEADER_TEMPLATE = """\
+#pragma once
+
+// @generated by tools/code_analyzer/gen_selected_kernel_dtypes.py
+
+#include <c10/core/ScalarType.h>
+
+namespace at {{
+namespace selective_build {{
+
+constexpr bool kernel_tag_equals(const char* a, const char* b) {{
+  return *a == *b && (*a == '\\0' || kernel_tag_equals(a + 1, b + 1));
+}}
+
+}} // namespace selective_build
+
+constexpr bool should_include_kernel_dtype(
+    const char* kernel_tag_str,
+    at::ScalarType scalar_type) {{
+  return {body};
+}}
+
+}} // namespace at
+"""
+
+
+def load_selected_dtypes(fname):
+    with open(fname, 'r') as stream:
+        config = yaml.safe_load(stream) or {}
+    default_dtypes = config.get('dtypes')
+    kernel_dtypes = config.get('kernel_dtypes') or {}
+    for dtypes in [default_dtypes or []] + list(kernel_dtypes.values()):
+        for dtype in dtypes:
+            if dtype not in SCALAR_TYPES:
+                raise ValueError(
+                    "Unknown dtype '{}' in {}, expected one of: {}".format(
+                        dtype, fname, ', '.join(SCALAR_TYPES)))
+    return default_dtypes, kernel_dtypes
+
+
+def dtype_condition(dtypes):
+    if not dtypes:
+        return 'false'
+    return ' || '.join(
+        'scalar_type == at::ScalarType::{}'.format(dtype) for dtype in dtypes)
+
+
+def gen_header(default_dtypes, kernel_dtypes):
+    default = 'true' if default_dtypes is None else dtype_condition(default_dtypes)
+    body = ''
+    for tag in sorted(kernel_dtypes):
+        body += 'selective_build::kernel_tag_equals(kernel_tag_str, "{}")\n' \
+            '      ? ({})\n      : '.format(tag, dtype_condition(kernel_dtypes[tag]))
+    body += '({})'.format(default)
+    return HEADER_TEMPLATE.format(body=body)
+
+
+def write_if_changed(fname, content):
+    # Keep the timestamp when nothing changed so that the kernels are not
+    # rebuilt on every cmake run.
+    if os.path.exists(fname):
+        with open(fname, 'r') as f:
+            if f.read() == content:
+                return
+    dirname = os.path.dirname(fname)
+    if dirname and not os.path.exists(dirname):
+        os.makedirs(dirname)
+    with open(fname, 'w') as f:
+        f.write(content)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description='Generate the dtype selective build header')
+    parser.add_argument(
+        '--selected-dtypes', required=True,
+        help='yaml file listing the dtypes to keep')
+    parser.add_argument(
+        '--output', required=True,
+        help='path of the generated selected_mobile_ops.h')
+    args = parser.parse_args()
+
+    default_dtypes, kernel_dtypes = load_selected_dtypes(args.selected_dtypes)
+    write_if_changed(args.output, gen_header(default_dtypes, kernel_dtypes))
@@ -8,6 +8,8 @@ is_cuda: _bool
 def getRuntimeVersion() -> Tuple[int, int, int]: ...
 def getCompileVersion() -> Tuple[int, int, int]: ...
 def getVersionInt() -> int: ...
+def save_algorithm_cache(path: str) -> None: ...
+def load_algorithm_cache(path: str) -> int: ...
 
 class RNNMode(int, Enum):
     value: int
@@ -1401,6 +1401,27 @@ See also :meth:`Tensor.values`.
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR matrix (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of its compressed row indices: the offsets in
+:meth:`Tensor.col_indices` and :meth:`Tensor.values` at which each row starts.
+Otherwise, this throws an error.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR matrix (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the column indices of its elements. Otherwise, this
+throws an error.
+
+See also :meth:`Tensor.crow_indices`.
+""")
+
 add_docstr_all('get_device',
                r"""
 get_device() -> Device ordinal (Integer)
@@ -2585,6 +2606,52 @@ Example::
             [ 3,  4]])
 """)
 
+add_docstr_all('resize_amortized_',
+               r"""
+resize_amortized_(*sizes) -> Tensor
+
+Resizes :attr:`self` tensor like :meth:`~Tensor.resize_`, except that when
+the underlying storage has to grow, it is grown to at least twice its current
+size. Growing a tensor step by step (e.g. appending to a cache in a decoding
+loop) thus only reallocates and copies its storage a logarithmic number of
+times, like ``std::vector``. Shrinking never releases memory.
+
+Args:
+    sizes (torch.Size or int...): the desired size
+
+Example::
+
+    >>> x = torch.empty(0)
+    >>> for i in range(5):
+    ...     x.resize_amortized_(i + 1)[i] = i
+    >>> x
+    tensor([0., 1., 2., 3., 4.])
+    >>> x.storage().size()
+    8
+""")
+
+add_docstr_all('reserve_',
+               r"""
+reserve_(capacity) -> Tensor
+
+Grows the underlying storage of :attr:`self` so that it can hold at least
+:attr:`capacity` elements past :meth:`~Tensor.storage_offset`, preserving its
+contents. The size and strides of :attr:`self` are unchanged; later calls to
+:meth:`~Tensor.resize_` up to :attr:`capacity` elements don't reallocate.
+
+Args:
+    capacity (int): the number of elements to reserve
+
+Example::
+
+    >>> x = torch.zeros(2)
+    >>> x.reserve_(100).size()
+    torch.Size([2])
+    >>> ptr = x.data_ptr()
+    >>> x.resize_(100).data_ptr() == ptr
+    True
+""")
+
 add_docstr_all('resize_as_',
                r"""
 resize_as_(tensor, memory_format=torch.contiguous_format) -> Tensor
@@ -3351,6 +3418,23 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of a 2-D strided or sparse COO tensor as a sparse CSR matrix,
+see :func:`torch.sparse_csr_tensor`. The indices are int32 when they fit, and
+int64 otherwise.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2], dtype=torch.int32),
+           col_indices=tensor([0, 2], dtype=torch.int32),
+           values=tensor([ 9, 10]), size=(3, 3), nnz=2,
+           layout=torch.sparse_csr)
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -3940,6 +4024,12 @@ add_docstr_all('is_quantized',
 Is ``True`` if the Tensor is quantized, ``False`` otherwise.
 """)
 
+add_docstr_all('is_sparse_csr',
+               r"""
+Is ``True`` if the Tensor is a sparse CSR matrix (i.e., with ``torch.sparse_csr``
+layout), ``False`` otherwise.
+""")
+
 add_docstr_all('is_meta',
                r"""
 Is ``True`` if the Tensor is a meta tensor, ``False`` otherwise.  Meta tensors
@@ -5929,6 +5929,41 @@ Example::
 .. _torch.sparse: https://pytorch.org/docs/stable/sparse.html
 """.format(**factory_common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size, dtype=None, device=None) -> Tensor
+
+Constructs a sparse matrix in CSR (Compressed Sparse Row) format: the elements
+of row ``i`` are ``values[crow_indices[i]:crow_indices[i + 1]]``, in the columns
+``col_indices[crow_indices[i]:crow_indices[i + 1]]``. :meth:`~Tensor.addmm`,
+:meth:`~Tensor.mm` and :meth:`~Tensor.mv` of a CSR matrix and a dense one use
+MKL on CPU and cuSPARSE on CUDA.
+
+Args:
+    crow_indices (Tensor): 1-D int32 or int64 tensor of ``size[0] + 1`` elements, the
+        nondecreasing offsets at which each row starts, from 0 to the number of
+        specified elements.
+    col_indices (Tensor): 1-D tensor of the column of every element, of the
+        same dtype as :attr:`crow_indices`.
+    values (Tensor): 1-D tensor of the value of every element.
+    size (list, tuple, or :class:`torch.Size`): the 2-D size of the matrix.
+    dtype (:class:`torch.dtype`, optional): the desired data type of returned tensor.
+        Default: if None, the data type of :attr:`values`.
+    device (:class:`torch.device`, optional): the desired device of returned tensor.
+        Default: if None, the device of :attr:`values`.
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 2, 3], dtype=torch.int32)
+    >>> col_indices = torch.tensor([0, 2, 1], dtype=torch.int32)
+    >>> values = torch.tensor([1., 2., 3.])
+    >>> torch.sparse_csr_tensor(crow_indices, col_indices, values, (2, 3))
+    tensor(crow_indices=tensor([0, 2, 3], dtype=torch.int32),
+           col_indices=tensor([0, 2, 1], dtype=torch.int32),
+           values=tensor([1., 2., 3.]), size=(2, 3), nnz=3,
+           layout=torch.sparse_csr)
+""")
+
 add_docstr(torch.sqrt,
            r"""
 sqrt(input, out=None) -> Tensor
@@ -14,8 +14,9 @@ from torch.types import _TensorOrTensors
 from .variable import Variable
 from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
-from .grad_mode import no_grad, enable_grad, set_grad_enabled
+from .grad_mode import no_grad, enable_grad, set_grad_enabled, inference_mode
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
+from .saved_tensors import saved_tensors_hooks, save_on_cpu, save_compressed
 from . import profiler
 from . import functional
 
@@ -107,6 +107,55 @@ class enable_grad(_DecoratorContextManager):
         torch.set_grad_enabled(self.prev)
 
 
+class inference_mode(_DecoratorContextManager):
+    r"""Context-manager that enables or disables inference mode.
+
+    Inference mode is like :class:`no_grad`, but it also skips the autograd
+    bookkeeping altogether: operators call their backend kernels directly,
+    outputs carry no autograd metadata, and tensors created in this mode
+    have no version counter. It is meant for code that is known to run
+    inference only, where it removes most of the per-operator overhead
+    autograd has under :class:`no_grad`.
+
+    Tensors created in inference mode can't be saved for backward by a graph
+    that is recorded outside of it; clone them first. Tensors that are
+    modified in place in inference mode must not be used by such a graph
+    either.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator. (Make sure to instantiate with parenthesis.)
+
+    Arguments:
+        mode (bool): Flag whether to enable inference mode (``True``), or
+                     disable it (``False``). Default: ``True``.
+
+    Example::
+
+        >>> x = torch.ones(1, 2, 3, requires_grad=True)
+        >>> with torch.inference_mode():
+        ...   y = x * x
+        >>> y.requires_grad
+        False
+        >>> y._version
+        RuntimeError: Inference tensors do not track version counter.
+
+    """
+    def __init__(self, mode=True):
+        self.mode = mode
+
+    def __enter__(self):
+        self.prev = torch.is_grad_enabled()
+        if self.mode:
+            torch._C.set_grad_enabled(False)
+        self._guard = torch.autograd._InferenceMode(self.mode)
+
+    def __exit__(self, *args):
+        del self._guard
+        torch.set_grad_enabled(self.prev)
+
+
 class set_grad_enabled(object):
     r"""Context-manager that sets gradient calculation to on or off.
 
@@ -25,10 +25,12 @@ class EventList(list):
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
         profile_memory = kwargs.pop('profile_memory', False)
+        record_hw_counters = kwargs.pop('record_hw_counters', False)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
         self._profile_memory = profile_memory
+        self._record_hw_counters = record_hw_counters
 
     def __str__(self):
         return self.table()
@@ -124,7 +126,8 @@ class EventList(list):
             row_limit=row_limit,
             header=header,
             use_cuda=self._use_cuda,
-            profile_memory=self._profile_memory)
+            profile_memory=self._profile_memory,
+            record_hw_counters=self._record_hw_counters)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
@@ -216,7 +219,11 @@ class EventList(list):
         for evt in self:
             stats[get_key(evt, group_by_input_shapes)].add(
                 evt, group_by_input_shapes)
-        return EventList(stats.values(), use_cuda=self._use_cuda, profile_memory=self._profile_memory)
+        return EventList(
+            stats.values(),
+            use_cuda=self._use_cuda,
+            profile_memory=self._profile_memory,
+            record_hw_counters=self._record_hw_counters)
 
     def total_average(self):
         """Averages all events.
@@ -260,9 +267,21 @@ class profile(object):
 
         profile_memory (bool, optional): Whether to report memory usage, default: ``False``
 
+        record_hw_counters (bool, optional): Whether to read the hardware counters
+            of the CPU (cycles, instructions, last level cache references and misses)
+            at the start and the end of every range, with Linux perf events. The
+            table then reports the IPC, the LLC misses per thousand instructions and
+            an estimate of the memory bandwidth of every function, from its LLC misses.
+            The counters need perf events to be allowed, see
+            ``/proc/sys/kernel/perf_event_paranoid``, and are only recorded on Linux.
+            Default: ``False``
+
     .. warning:
         Enabling memory profiling incurs additional profiler overhead
 
+    .. warning:
+        Recording the hardware counters costs a syscall per range start and end
+
     .. warning:
         This context managers should not be called recursively, i.e. no nested
         instances are allowed
@@ -297,7 +316,8 @@ class profile(object):
             enabled=True,
             use_cuda=False,
             record_shapes=False,
-            profile_memory=False):
+            profile_memory=False,
+            record_hw_counters=False):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
@@ -306,6 +326,7 @@ class profile(object):
         self.entered = False
         self.record_shapes = record_shapes
         self.profile_memory = profile_memory
+        self.record_hw_counters = record_hw_counters
 
     def __enter__(self):
         if not self.enabled:
@@ -316,7 +337,8 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
 
-        config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory)
+        config = torch.autograd.ProfilerConfig(
+            profiler_kind, self.record_shapes, self.profile_memory, self.record_hw_counters)
         torch.autograd._enable_profiler(config)
         return self
 
@@ -327,7 +349,8 @@ class profile(object):
         self.function_events = EventList(
             parse_cpu_trace(records),
             use_cuda=self.use_cuda,
-            profile_memory=self.profile_memory)
+            profile_memory=self.profile_memory,
+            record_hw_counters=self.record_hw_counters)
         return False
 
     def __repr__(self):
@@ -376,6 +399,53 @@ class profile(object):
         return self.function_events.self_cpu_time_total
 
 
+class sampling_profile(object):
+    """Context manager that samples the ranges the profiler would record, with
+    an overhead low enough to be left on in production.
+
+    Each op, autograd node run during backward, TorchScript function and
+    :class:`record_function` range is recorded with probability
+    ``sampling_prob``, on every thread. Every thread keeps the last
+    ``buffer_size`` ranges it sampled in a ring buffer that is written without
+    locks. Forward ops and the autograd nodes that compute their gradients have
+    the same sequence number, exported as the ``seq`` argument of each range.
+    Only CPU time is recorded.
+
+    Unlike :class:`profile`, the sampling profiler is global: it must be
+    entered and exited while no other thread runs ops, and it can't be nested.
+
+    Arguments:
+        sampling_prob (float, optional): Probability of recording a range.
+            Default: ``1e-3``.
+
+        buffer_size (int, optional): Number of ranges kept per thread.
+            Default: ``4096``.
+
+    Example:
+        >>> with torch.autograd.profiler.sampling_profile(sampling_prob=0.01) as prof:
+        >>>     for _ in range(100):
+        >>>         model(x).sum().backward()
+        >>> prof.export_chrome_trace("trace.json")
+    """
+    def __init__(self, sampling_prob=1e-3, buffer_size=4096):
+        self.sampling_prob = sampling_prob
+        self.buffer_size = buffer_size
+
+    def __enter__(self):
+        torch.autograd._enable_sampling_profiler(self.sampling_prob, self.buffer_size)
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        torch.autograd._disable_sampling_profiler()
+        return False
+
+    def export_chrome_trace(self, path):
+        """Exports the ranges sampled so far as a Chrome trace. It can be called
+        while the profiler is running.
+        """
+        torch.autograd._export_sampled_chrome_trace(path)
+
+
 class record_function(ContextDecorator):
     """Context manager/function decorator that adds a label to a block of
     Python code (or function) when running autograd profiler. It is
@@ -593,6 +663,32 @@ def format_time_share(time_us, total_time_us):
         return "NaN"
     return '{:.2f}%'.format(time_us * 100.0 / total_time_us)
 
+# Bytes that a last level cache miss loads from memory, the usual size of a
+# cache line
+LLC_MISS_BYTES = 64
+
+
+def format_hw_counters(counters, cpu_time_us):
+    """Returns the formatted IPC, LLC misses per thousand instructions and the
+    memory bandwidth estimated from the LLC misses, given hardware counters"""
+    def get(name):
+        return None if counters is None else counters[name]
+
+    cycles = get('cycles')
+    instructions = get('instructions')
+    llc_misses = get('llc_misses')
+    ipc = 'N/A'
+    if cycles and instructions is not None:
+        ipc = '{:.2f}'.format(float(instructions) / cycles)
+    mpki = 'N/A'
+    if instructions and llc_misses is not None:
+        mpki = '{:.2f}'.format(1000.0 * llc_misses / instructions)
+    bandwidth = 'N/A'
+    if cpu_time_us > 0 and llc_misses is not None:
+        bandwidth = format_memory(int(llc_misses * LLC_MISS_BYTES * 1e6 / cpu_time_us)) + '/s'
+    return [ipc, mpki, bandwidth]
+
+
 def format_memory(nbytes):
     """Returns a formatted memory size string"""
     KB = 1024
@@ -642,13 +738,27 @@ class Interval(object):
 
 Kernel = namedtuple('Kernel', ['name', 'device', 'interval'])
 
+# Names of the hardware counters, in the order of ProfilerEvent.hw_counters()
+HW_COUNTER_NAMES = ['cycles', 'instructions', 'llc_references', 'llc_misses']
+
+
+def _sum_hw_counters(counters, others):
+    # Sums the hardware counters of `others` into `counters`, None stays None
+    if counters is None or others is None:
+        return None
+    return {
+        name: None if counters[name] is None or others[name] is None
+        else counters[name] + others[name]
+        for name in HW_COUNTER_NAMES
+    }
+
 
 class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
     def __init__(
             self, id, node_id, name, thread, cpu_start, cpu_end, input_shapes=None,
             cpu_memory_usage=0, cuda_memory_usage=0, is_async=False, is_remote=True,
-            sequence_nr=-1):
+            sequence_nr=-1, hw_counters=None):
         self.id = id
         self.node_id = node_id
         self.name = name
@@ -663,6 +773,9 @@ class FunctionEvent(FormattedTimesMixin):
         self.is_async = is_async
         self.is_remote = is_remote
         self.sequence_nr = sequence_nr
+        # Counter name -> value over the range, None for the counters that
+        # couldn't be read, or None when they weren't recorded
+        self.hw_counters = hw_counters
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -702,6 +815,19 @@ class FunctionEvent(FormattedTimesMixin):
             [child.cpu_time_total for child in self.cpu_children]
         )
 
+    @property
+    def self_hw_counters(self):
+        if self.hw_counters is None or self.is_async:
+            return None
+        counters = dict(self.hw_counters)
+        for child in self.cpu_children:
+            if child.hw_counters is None:
+                continue
+            for name in HW_COUNTER_NAMES:
+                if counters[name] is not None and child.hw_counters[name] is not None:
+                    counters[name] -= child.hw_counters[name]
+        return counters
+
     @property
     def cuda_time_total(self):
         return sum(kinfo.interval.elapsed_us() for kinfo in self.kernels)
@@ -754,6 +880,8 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_memory_usage = 0
         self.self_cpu_memory_usage = 0
         self.self_cuda_memory_usage = 0
+        self.hw_counters = None
+        self.self_hw_counters = None
 
     def add(self, other, group_by_input_shapes=False):
         if self.key is None:
@@ -765,6 +893,9 @@ class FunctionEventAvg(FormattedTimesMixin):
             self.is_remote = other.is_remote
             if group_by_input_shapes:
                 self.input_shapes = other.input_shapes
+            if other.hw_counters is not None:
+                self.hw_counters = dict.fromkeys(HW_COUNTER_NAMES, 0)
+                self.self_hw_counters = dict.fromkeys(HW_COUNTER_NAMES, 0)
 
         assert (
             not group_by_input_shapes or
@@ -779,6 +910,8 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_memory_usage += other.cuda_memory_usage
         self.self_cpu_memory_usage += other.self_cpu_memory_usage
         self.self_cuda_memory_usage += other.self_cuda_memory_usage
+        self.hw_counters = _sum_hw_counters(self.hw_counters, other.hw_counters)
+        self.self_hw_counters = _sum_hw_counters(self.self_hw_counters, other.self_hw_counters)
         self.count += other.count
         return self
 
@@ -910,6 +1043,14 @@ def parse_cpu_trace(thread_records):
                 cuda_memory_usage = cuda_memory_allocs[record_key]
                 is_async = start.thread_id() != record.thread_id()
                 is_remote_event = record.is_remote()
+                hw_counters = None
+                start_counters = start.hw_counters()
+                end_counters = record.hw_counters()
+                if start_counters is not None and end_counters is not None:
+                    hw_counters = {
+                        name: end - begin if begin >= 0 and end >= 0 else None
+                        for name, begin, end in zip(HW_COUNTER_NAMES, start_counters, end_counters)
+                    }
 
                 fe = FunctionEvent(
                     id=record.handle(),
@@ -924,6 +1065,7 @@ def parse_cpu_trace(thread_records):
                     is_async=is_async,
                     is_remote=is_remote_event,
                     sequence_nr=start.sequence_nr(),
+                    hw_counters=hw_counters,
                 )
                 # note: async events have only cpu total time
                 if not is_async and start.has_cuda():
@@ -1043,7 +1185,8 @@ def build_table(
         header=None,
         row_limit=100,
         use_cuda=True,
-        profile_memory=False):
+        profile_memory=False,
+        record_hw_counters=False):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
@@ -1051,7 +1194,8 @@ def build_table(
     if sort_by is not None:
         events = EventList(sorted(
             events, key=lambda evt: getattr(evt, sort_by), reverse=True
-        ), use_cuda=use_cuda, profile_memory=profile_memory)
+        ), use_cuda=use_cuda, profile_memory=profile_memory,
+            record_hw_counters=record_hw_counters)
 
     has_input_shapes = any(
         [event.input_shapes is not None for event in events])
@@ -1083,6 +1227,12 @@ def build_table(
                 'CUDA Mem',
                 'Self CUDA Mem',
             ])
+    if record_hw_counters:
+        headers.extend([
+            'Self IPC',
+            'Self LLC MPKI',
+            'Self Est. Mem BW',
+        ])
     headers.append(
         'Number of Calls'
     )
@@ -1167,6 +1317,9 @@ def build_table(
                     # Self CUDA Mem Total
                     format_memory(evt.self_cuda_memory_usage),
                 ])
+        if record_hw_counters:
+            row_values.extend(format_hw_counters(
+                evt.self_hw_counters, evt.self_cpu_time_total))
         row_values.append(
             evt.count,  # Number of calls
         )
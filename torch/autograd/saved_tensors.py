@@ -0,0 +1,95 @@
+import torch
+
+from typing import Any, Callable
+
+
+class saved_tensors_hooks(object):
+    r"""Context-manager that sets pack/unpack hooks for the tensors that
+    autograd saves for backward.
+
+    Inside the context, ``pack_hook`` is called with each tensor that an
+    operation saves for backward, and whatever it returns is kept instead of
+    the tensor. When backward needs the tensor, ``unpack_hook`` is called with
+    the value ``pack_hook`` returned, and must return a tensor with the same
+    content as the original one. ``unpack_hook`` is called again for each
+    backward pass through a retained graph. Leaf tensors that require grad
+    (e.g. parameters) are saved as they are.
+
+    Hooks only apply to tensors saved on the current thread.
+
+    Arguments:
+        pack_hook (Callable): called with each saved tensor.
+        unpack_hook (Callable): called with the output of ``pack_hook``.
+
+    Example::
+
+        >>> def pack_hook(x):
+        ...     return x.cpu()
+        >>> def unpack_hook(x):
+        ...     return x.cuda()
+        >>> a = torch.randn(5, requires_grad=True, device="cuda")
+        >>> with torch.autograd.saved_tensors_hooks(pack_hook, unpack_hook):
+        ...     y = (a * 2).sin()
+        >>> y.sum().backward()
+    """
+
+    def __init__(self, pack_hook: Callable[[torch.Tensor], Any],
+                 unpack_hook: Callable[[Any], torch.Tensor]) -> None:
+        self.pack_hook = pack_hook
+        self.unpack_hook = unpack_hook
+
+    def __enter__(self) -> None:
+        torch.autograd._push_saved_tensors_hooks(self.pack_hook, self.unpack_hook)
+
+    def __exit__(self, *args: Any) -> None:
+        torch.autograd._pop_saved_tensors_hooks()
+
+
+class save_on_cpu(object):
+    r"""Context-manager that keeps the CUDA tensors saved for backward in
+    pinned CPU memory instead of GPU memory.
+
+    Tensors are copied to the host on a side stream, so the copies overlap
+    with the rest of the forward pass. During backward, when a saved tensor
+    is used, the ``prefetch`` tensors saved right before it are copied back
+    to the GPU on the side stream, so that they are ready when backward
+    reaches them. This trades host-device bandwidth for GPU memory, to train
+    larger models or batch sizes.
+
+    Arguments:
+        prefetch (int): how many tensors to copy back ahead of their use.
+            Default: 2
+    """
+
+    def __init__(self, prefetch: int = 2) -> None:
+        self.prefetch = prefetch
+
+    def __enter__(self) -> None:
+        torch.autograd._push_saved_tensors_offload_hooks(self.prefetch)
+
+    def __exit__(self, *args: Any) -> None:
+        torch.autograd._pop_saved_tensors_hooks()
+
+
+class save_compressed(object):
+    r"""Context-manager that keeps the floating point tensors saved for
+    backward in a narrower dtype.
+
+    Saved tensors with a wider floating point dtype than ``dtype`` are
+    converted to it, and converted back when backward uses them. This halves
+    the memory used by saved ``float`` tensors, but gradients are computed
+    from rounded values.
+
+    Arguments:
+        dtype (torch.dtype): ``torch.float16`` or ``torch.bfloat16``.
+            Default: ``torch.float16``
+    """
+
+    def __init__(self, dtype: torch.dtype = torch.float16) -> None:
+        self.dtype = dtype
+
+    def __enter__(self) -> None:
+        torch.autograd._push_saved_tensors_compression_hooks(self.dtype)
+
+    def __exit__(self, *args: Any) -> None:
+        torch.autograd._pop_saved_tensors_hooks()
@@ -83,6 +83,28 @@ def is_acceptable(tensor):
     return True
 
 
+def save_algorithm_cache(path):
+    r"""Saves the convolution algorithms cuDNN picked in this process (see
+    ``torch.backends.cudnn.benchmark``) to the file at :attr:`path`, replacing
+    it atomically."""
+    if not _init() or not _cudnn.is_cuda:
+        raise RuntimeError("save_algorithm_cache requires PyTorch built with cuDNN")
+    _cudnn.save_algorithm_cache(path)
+
+
+def load_algorithm_cache(path):
+    r"""Loads the convolution algorithms saved by :func:`save_algorithm_cache`
+    at :attr:`path`, so that convolutions of the same shapes skip benchmarking.
+
+    Algorithms are only loaded when saved with the same cuDNN version, and
+    only for devices of the same name and compute capability. Algorithms
+    already picked by this process are kept. Returns the number of loaded
+    algorithms, 0 if :attr:`path` doesn't exist or is incompatible."""
+    if not _init() or not _cudnn.is_cuda:
+        raise RuntimeError("load_algorithm_cache requires PyTorch built with cuDNN")
+    return _cudnn.load_algorithm_cache(path)
+
+
 def set_flags(_enabled, _benchmark, _deterministic):
     orig_flags = (torch._C._get_cudnn_enabled(),
                   torch._C._get_cudnn_benchmark(),
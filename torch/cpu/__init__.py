@@ -0,0 +1,5 @@
+r"""
+This package holds CPU specific utilities, such as CPU autocasting.
+"""
+
+from . import amp  # noqa: F401
@@ -0,0 +1,53 @@
+import torch
+import functools
+
+
+class autocast(object):
+    r"""
+    Instances of :class:`autocast` serve as context managers or decorators that
+    allow regions of your script to run in mixed precision on the CPU.
+
+    In these regions, CPU ops run in an op-specific dtype chosen by autocast.
+    Ops that :class:`torch.cuda.amp.autocast` runs in ``float16`` run in ``torch.bfloat16``
+    on the CPU, and the other op lists of the :ref:`Autocast Op Reference<autocast-op-reference>`
+    apply unchanged.  CUDA ops are not affected; use :class:`torch.cuda.amp.autocast` for them.
+
+    Example::
+
+        model = Net().eval()
+
+        with torch.cpu.amp.autocast():
+            output = model(input)
+
+    Casts of ``float32`` model weights are cached for the duration of the autocast region.
+    For inference loops, ``torch.set_autocast_cache_persistent(True)`` keeps them cached across
+    regions, so the weights aren't casted again on every call.  A cached cast is dropped when its
+    weight is modified in place, and ``torch.clear_autocast_cache()`` drops all of them.
+
+    The autocast state is thread-local, like the one of :class:`torch.cuda.amp.autocast`.
+
+    Arguments:
+        enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+    """
+    def __init__(self, enabled=True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_cpu_enabled()
+        torch.set_autocast_cpu_enabled(self._enabled)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # Drop the cache when we exit to a nesting level that's outside any instance of autocast,
+        # unless it was made persistent with torch.set_autocast_cache_persistent(True).
+        if torch.autocast_decrement_nesting() == 0 and not torch.is_autocast_cache_persistent():
+            torch.clear_autocast_cache()
+        torch.set_autocast_cpu_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
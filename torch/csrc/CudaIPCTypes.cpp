@@ -4,6 +4,7 @@
 #include <map>
 #include <mutex>
 #include <random>
+#include <unordered_map>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -228,6 +229,65 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
   return at::DataPtr(data, sent_data, CudaIPCSentDataDelete, device);
 }
 
+namespace {
+std::mutex received_ref_counters_mutex;
+std::unordered_map<std::string, std::weak_ptr<at::DataPtr>>
+    received_ref_counters_files;
+} // namespace
+
+std::shared_ptr<at::DataPtr> GetReceivedRefCountersFile(
+    const std::string& handle) {
+  std::lock_guard<std::mutex> lock(received_ref_counters_mutex);
+  auto iter = received_ref_counters_files.find(handle);
+  if (iter != received_ref_counters_files.end()) {
+    auto file = iter->second.lock();
+    if (file) {
+      return file;
+    }
+  }
+  // We don't want to break existing code, so resource deletion is best
+  // effort basis. Exception expected if producer process terminated
+  // before consumer released data.
+  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+  std::shared_ptr<at::DataPtr> file;
+  try {
+    file = std::shared_ptr<at::DataPtr>(
+        new at::DataPtr(THRefcountedMapAllocator::makeDataPtr(
+            handle.c_str(),
+            flags,
+            sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+            nullptr)),
+        [handle](at::DataPtr* ptr) {
+          delete ptr;
+          std::lock_guard<std::mutex> deleter_lock(
+              received_ref_counters_mutex);
+          auto iter = received_ref_counters_files.find(handle);
+          // The entry may have been reopened meanwhile
+          if (iter != received_ref_counters_files.end() &&
+              iter->second.expired()) {
+            received_ref_counters_files.erase(iter);
+          }
+        });
+  } catch (c10::Error& err) {
+    // Already warned inside of producer process
+    return nullptr;
+  }
+  if (iter != received_ref_counters_files.end()) {
+    iter->second = file;
+  } else {
+    received_ref_counters_files.emplace(handle, file);
+  }
+  return file;
+}
+
+void ReleaseReceivedRefCounter(
+    const std::shared_ptr<at::DataPtr>& ref_counters_file,
+    int64_t offset) {
+  if (ref_counters_file) {
+    *(static_cast<int64_t*>(ref_counters_file->get()) + offset) -= 1;
+  }
+}
+
 bool CudaIPCCollect() {
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
@@ -19,6 +19,19 @@ struct CudaIPCReceivedData final {
   std::shared_ptr<void> shared_ptr_;
 };
 
+// Consumer side mapping of a producer's ref counters file. It is opened once
+// and shared by all tensors received with counters in that file, so releasing
+// a tensor only decrements its counter instead of mapping the file again.
+// Returns nullptr if the file no longer exists (producer terminated).
+std::shared_ptr<at::DataPtr> GetReceivedRefCountersFile(
+    const std::string& handle);
+
+// Decrements the received counter at offset of ref_counters_file (best effort,
+// no-op if the file could not be opened).
+void ReleaseReceivedRefCounter(
+    const std::shared_ptr<at::DataPtr>& ref_counters_file,
+    int64_t offset);
+
 struct CudaIPCSentData final {
   std::string handle_;
   int64_t offset_;
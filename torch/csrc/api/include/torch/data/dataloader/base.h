@@ -2,7 +2,9 @@
 
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
+#include <torch/data/detail/map_tensors.h>
 #include <torch/data/detail/sequencers.h>
+#include <torch/data/detail/worker_process.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
 #include <torch/data/worker_exception.h>
@@ -11,8 +13,12 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/variadic.h>
 
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 #include <c10/util/Exception.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <memory>
@@ -37,6 +43,7 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
+        shuttle_(std::max(options_.max_jobs, options_.workers)),
         sequencer_(new_sequencer()) {}
 
   virtual ~DataLoaderBase() {
@@ -122,10 +129,15 @@ class DataLoaderBase {
     Result() = default;
     Result(optional<Batch>&& b, size_t sqn)
         : Sequenced(sqn), batch(std::move(b)) {}
+    Result(optional<Batch>&& b, std::shared_ptr<c10::Event> e, size_t sqn)
+        : Sequenced(sqn), batch(std::move(b)), copied(std::move(e)) {}
     Result(std::exception_ptr exception, size_t sqn)
         : Sequenced(sqn), exception(std::move(exception)) {}
     optional<Batch> batch;
     std::exception_ptr exception;
+    /// Recorded after the copy of `batch` to `prefetch_to_device`, if a worker
+    /// made it on a side stream.
+    std::shared_ptr<c10::Event> copied;
   };
 
   /// Subclass hook for getting the next batch request. The stateless case will
@@ -169,25 +181,97 @@ class DataLoaderBase {
           throw WorkerException(result->exception);
         } else if (result->batch) {
           prefetch(1);
+          if (result->copied) {
+            wait_for_copy(*result->batch, *result->copied);
+          }
           return std::move(result->batch);
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      return transfer(
+          this->main_thread_dataset_->get_batch(std::move(*batch_request)),
+          /*side_stream=*/false);
     }
     return nullopt;
   }
 
+  /// Applies the `pin_memory` and `prefetch_to_device` options to a batch.
+  /// With `side_stream`, the copy to the device is made on a stream from the
+  /// pool of the device and an event recorded after it is returned. Copies to
+  /// the CPU are synchronous and never use a side stream.
+  template <typename B>
+  B transfer(
+      B batch,
+      bool side_stream,
+      std::shared_ptr<c10::Event>* copied = nullptr) {
+    if (options_.pin_memory) {
+      batch = detail::map_tensors(std::move(batch), [](Tensor tensor) {
+        return tensor.is_pinned() ? tensor : tensor.pin_memory();
+      });
+    }
+    if (!options_.prefetch_to_device) {
+      return batch;
+    }
+    const Device device = *options_.prefetch_to_device;
+    const auto move_to_device = [&](Tensor tensor) {
+      return tensor.to(device, /*non_blocking=*/options_.pin_memory);
+    };
+    if (!side_stream || device.is_cpu()) {
+      return detail::map_tensors(std::move(batch), move_to_device);
+    }
+    const c10::impl::VirtualGuardImpl impl(device.type());
+    const c10::StreamGuard stream_guard(impl.getStreamFromGlobalPool(device));
+    batch = detail::map_tensors(std::move(batch), move_to_device);
+    *copied = std::make_shared<c10::Event>(device.type());
+    (*copied)->record(stream_guard.current_stream());
+    return batch;
+  }
+
+  /// Makes the current stream wait for the copy of a batch made by a worker,
+  /// and keeps the caching allocator from reusing the memory of its tensors
+  /// before the work enqueued on the current stream is done.
+  void wait_for_copy(Batch& batch, const c10::Event& copied) {
+    const Device device(copied.device_type(), copied.device_index());
+    const c10::impl::VirtualGuardImpl impl(device.type());
+    const c10::Stream stream = impl.getStream(device);
+    copied.block(stream);
+    batch = detail::map_tensors(std::move(batch), [&](Tensor tensor) {
+      impl.recordDataPtrOnStream(tensor.storage().data_ptr(), stream);
+      return tensor;
+    });
+  }
+
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
+    worker_loop([&dataset](BatchRequest request) {
+      return dataset.get_batch(std::move(request));
+    });
+  }
+
+  /// The function that worker threads run when the work is done by a worker
+  /// process, for which this thread acts as a proxy.
+  void worker_process_thread(detail::WorkerProcess& process) {
+    worker_loop([&process](BatchRequest request) {
+      return process.get_batch<Batch>(request);
+    });
+  }
+
+  /// Serves jobs from the shuttle with `get_batch` until told to quit.
+  template <typename GetBatch>
+  void worker_loop(const GetBatch& get_batch) {
     while (true) {
       auto job = shuttle_.pop_job();
       if (job.quit) {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
-        shuttle_.push_result({std::move(batch), job.sequence_number});
+        std::shared_ptr<c10::Event> copied;
+        auto batch = transfer(
+            get_batch(std::move(*job.batch_request)),
+            /*side_stream=*/true,
+            &copied);
+        shuttle_.push_result(
+            {std::move(batch), std::move(copied), job.sequence_number});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
       }
@@ -233,8 +317,10 @@ class DataLoaderBase {
   /// The worker threads, running the `worker_thread()` method.
   std::vector<std::thread> workers_;
 
-  /// The `DataShuttle` which takes care of the life cycle of a job.
-  detail::DataShuttle<Job, Result> shuttle_;
+  /// The `DataShuttle` which takes care of the life cycle of a job. At most
+  /// `max_jobs` jobs are in flight, plus one quit message per worker on
+  /// shutdown, so its lock-free queues never fill up.
+  detail::DataShuttle<Job, Result, detail::BoundedQueue> shuttle_;
 
   /// The `Sequencer`, which handles optional ordering of batches.
   std::unique_ptr<detail::sequencers::Sequencer<Result>> sequencer_;
@@ -38,6 +38,11 @@ class StatefulDataLoader : public DataLoaderBase<
       : super(
             std::move(options),
             torch::make_unique<Dataset>(std::move(dataset))) {
+    // Worker processes would each advance their own copy of the dataset's
+    // state, and never see it being reset.
+    TORCH_CHECK(
+        !this->options_.worker_processes,
+        "Worker processes are not supported for stateful datasets");
     for (size_t w = 0; w < this->options_.workers; ++w) {
       // As opposed to the stateless case, here all worker threads access the
       // same underlying dataset.
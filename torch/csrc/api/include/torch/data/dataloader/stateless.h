@@ -8,8 +8,10 @@
 #include <c10/util/Exception.h>
 
 #include <cstddef>
+#include <memory>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace torch {
 namespace data {
@@ -40,13 +42,31 @@ class StatelessDataLoader : public DataLoaderBase<
       Sampler sampler,
       DataLoaderOptions options)
       : super(std::move(options)), sampler_(std::move(sampler)) {
-    for (size_t w = 0; w < this->options_.workers; ++w) {
-      // Here we copy the dataset into the worker thread closure. Each worker
-      // has its own copy of the dataset. This means the dataset must be
-      // trivially copiable, or else we don't expect more than one worker to
-      // be in use.
-      this->workers_.emplace_back(
-          [this, dataset]() mutable { this->worker_thread(dataset); });
+    if (this->options_.worker_processes) {
+      // Fork all worker processes before starting any thread, so that no
+      // child inherits a thread's state halfway through.
+      for (size_t w = 0; w < this->options_.workers; ++w) {
+        worker_processes_.push_back(torch::make_unique<detail::WorkerProcess>(
+            [&dataset](int socket) {
+              detail::serve_batches<BatchRequestType>(dataset, socket);
+            },
+            worker_processes_));
+      }
+      for (auto& process : worker_processes_) {
+        auto* worker_process = process.get();
+        this->workers_.emplace_back([this, worker_process] {
+          this->worker_process_thread(*worker_process);
+        });
+      }
+    } else {
+      for (size_t w = 0; w < this->options_.workers; ++w) {
+        // Here we copy the dataset into the worker thread closure. Each worker
+        // has its own copy of the dataset. This means the dataset must be
+        // trivially copiable, or else we don't expect more than one worker to
+        // be in use.
+        this->workers_.emplace_back(
+            [this, dataset]() mutable { this->worker_thread(dataset); });
+      }
     }
     if (this->options_.workers == 0) {
       this->main_thread_dataset_ =
@@ -54,6 +74,12 @@ class StatelessDataLoader : public DataLoaderBase<
     }
   }
 
+  ~StatelessDataLoader() override {
+    // The worker threads use `worker_processes_`, which is destroyed before
+    // the destructor of the base class gets to join them.
+    this->join();
+  }
+
  private:
   /// Resets the internal state of the dataloader and the sampler.
   void reset() override {
@@ -77,6 +103,10 @@ class StatelessDataLoader : public DataLoaderBase<
 
   /// The `Sampler` used to produce batch requests.
   Sampler sampler_;
+
+  /// The worker processes, if `worker_processes` is set. Each is served by
+  /// one of the worker threads.
+  std::vector<std::unique_ptr<detail::WorkerProcess>> worker_processes_;
 };
 } // namespace data
 } // namespace torch
@@ -37,6 +37,29 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// Whether to copy the tensors of each batch into pinned (page-locked)
+  /// memory, so that they can be copied to a CUDA device asynchronously.
+  /// With worker threads, the workers do the copy.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// A device to move the tensors of each batch to before they are returned.
+  /// With worker threads, the workers copy the batches they loaded ahead of
+  /// time (see `max_jobs`) on a side stream of the device, so the copies
+  /// overlap with the work of the main thread. The stream that is current
+  /// when a batch is returned waits for its copy to finish. Combine with
+  /// `pin_memory` for asynchronous copies to CUDA devices.
+  TORCH_ARG(optional<Device>, prefetch_to_device);
+
+  /// Whether to run each of the `workers` in a separate process forked from
+  /// the DataLoader, instead of a thread. Each worker process has its own copy
+  /// of the dataset and sends back the batches it loads in shared memory,
+  /// which the returned tensors view without a copy. A crashing worker
+  /// process fails its batches with a `WorkerException`. Only supported for
+  /// stateless datasets on POSIX systems, whose batches are made of CPU
+  /// tensors, arithmetic values, strings, and `Example`s, vectors and
+  /// optionals of these.
+  TORCH_ARG(bool, worker_processes) = false;
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +75,10 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory()),
+        prefetch_to_device(options.prefetch_to_device()),
+        worker_processes(options.worker_processes()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +86,9 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
+  optional<Device> prefetch_to_device;
+  bool worker_processes;
 };
 } // namespace data
 } // namespace torch
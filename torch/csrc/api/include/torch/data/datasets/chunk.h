@@ -4,7 +4,11 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/data/datasets/stateful.h>
 #include <torch/data/samplers.h>
+#include <deque>
+#include <future>
+#include <limits>
 #include <queue>
+#include <random>
 #include <thread>
 
 #include <torch/serialize.h>
@@ -43,6 +47,12 @@ namespace detail {
 /// queue. When get_batch is called from data loader, it pops cached batches and
 /// return. If the cache is empty, it either waits to load more chunks or return
 /// null if all chunks are loaded.
+///
+/// Preloader threads sample and reorder their chunk before taking the queue
+/// lock, so they only serialize on moving finished examples into batches. If
+/// `shuffle_buffer_size` is non-zero, examples additionally pass through a
+/// fixed-size reservoir that mixes examples across chunks without having to
+/// hold several chunks in memory at once.
 template <
     typename UnwrappedBatch,
     typename ExampleSampler = samplers::RandomSampler>
@@ -55,10 +65,20 @@ class BatchDataBuffer {
   BatchDataBuffer(
       size_t batch_size,
       ExampleSampler& example_sampler,
-      size_t queue_capacity)
+      size_t queue_capacity,
+      size_t shuffle_buffer_size = 0)
       : batch_size_(batch_size),
         example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+        queue_capacity_(queue_capacity),
+        shuffle_buffer_size_(shuffle_buffer_size) {
+    if (shuffle_buffer_size_ > 0) {
+      shuffle_buffer_.reserve(shuffle_buffer_size_);
+      // Seed from the global generator so torch::manual_seed applies.
+      shuffle_generator_.seed(static_cast<std::mt19937::result_type>(
+          torch::randint(std::numeric_limits<int32_t>::max(), {1}, torch::kLong)
+              .item<int64_t>()));
+    }
+  }
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
@@ -87,68 +107,51 @@ class BatchDataBuffer {
     lock.unlock();
     cv_write_.notify_all();
 
-    return batch.batch_data;
+    return std::move(batch.batch_data);
   }
 
   /// Push preloaded chunks to batch queue. Called from the ChunkDataset worker
   /// threads.
   void add_chunk_data(UnwrappedBatchType data) {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
-    cv_write_.wait(lock, [this] {
-      // stop loading if we have preloaded enough data.
-      return this->total_example_count_in_queue_ < this->queue_capacity_ ||
-          this->stop_;
-    });
-    if (stop_) {
-      // When stop_ is true, it means no further chunk loading is necessary.
-      // Return without any further processing.
-      return;
-    }
-
     auto data_size = data.size();
-    auto remaining_size = data_size;
-    example_sampler_.reset(data_size);
-
-    auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
-      auto batch_example_indices = this->example_sampler_.next(example_count);
-      AT_ASSERT(
-          batch_example_indices &&
-          batch_example_indices.value().size() == example_count);
-      BatchRequestType& indices = batch_example_indices.value();
-      for (size_t i : indices) {
-        TORCH_CHECK(i < data_size, "Index out of range");
-        batch.emplace_back(std::move(data[i]));
-      }
-      remaining_size -= example_count;
-    };
-
-    if (!batch_queue_.empty()) {
-      // if the queue has existing data, and the last batch doesn't have enough
-      // examples to fill a batch_size batch, add more example to this batch first.
-      auto& batch = batch_queue_.back();
-      size_t current_count = batch.batch_data.size();
-      if (current_count < batch_size_) {
-        auto example_count =
-            std::min(remaining_size, batch_size_ - current_count);
-        fill_batch(example_count, batch.batch_data);
-      }
+    BatchRequestType indices;
+    {
+      std::lock_guard<std::mutex> lock(sampler_mutex_);
+      example_sampler_.reset(data_size);
+      auto chunk_indices = example_sampler_.next(data_size);
+      AT_ASSERT(chunk_indices && chunk_indices.value().size() == data_size);
+      indices = std::move(chunk_indices.value());
     }
 
-    // If we still have data remaining after filling the last pushed batch, add
-    // them to the queue too.
-    while (remaining_size > 0) {
-      UnwrappedBatchType current_batch;
+    UnwrappedBatchType examples;
+    examples.reserve(data_size);
+    for (size_t i : indices) {
+      TORCH_CHECK(i < data_size, "Index out of range");
+      examples.emplace_back(std::move(data[i]));
+    }
 
-      // Allocate the batch memory ahead of time.
-      current_batch.reserve(batch_size_);
+    if (shuffle_buffer_size_ > 0) {
+      examples = pass_through_shuffle_buffer(std::move(examples));
+    }
+    if (!examples.empty()) {
+      enqueue_examples(std::move(examples));
+    }
+  }
 
-      auto example_count = std::min(remaining_size, batch_size_);
-      fill_batch(example_count, current_batch);
-      batch_queue_.emplace(std::move(current_batch));
+  /// Push the examples left in the shuffle reservoir, in random order. Called
+  /// by the last ChunkDataset worker thread once all chunks are loaded.
+  void flush_shuffle_buffer() {
+    UnwrappedBatchType examples;
+    {
+      std::lock_guard<std::mutex> lock(shuffle_mutex_);
+      std::shuffle(
+          shuffle_buffer_.begin(), shuffle_buffer_.end(), shuffle_generator_);
+      examples = std::move(shuffle_buffer_);
+      shuffle_buffer_ = UnwrappedBatchType();
+    }
+    if (!examples.empty()) {
+      enqueue_examples(std::move(examples));
     }
-    total_example_count_in_queue_ += data_size;
-    lock.unlock();
-    cv_read_.notify_all();
   }
 
   /// Push exceptions thrown during preloading into batch queue. Called from
@@ -195,6 +198,80 @@ class BatchDataBuffer {
     // notify all readers too.
     cv_read_.notify_all();
   }
+
+  /// Fills the examples into batches, topping up the last queued batch first,
+  /// and pushes them to the queue.
+  void enqueue_examples(UnwrappedBatchType examples) {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    cv_write_.wait(lock, [this] {
+      // stop loading if we have preloaded enough data.
+      return this->total_example_count_in_queue_ < this->queue_capacity_ ||
+          this->stop_;
+    });
+    if (stop_) {
+      // When stop_ is true, it means no further chunk loading is necessary.
+      // Return without any further processing.
+      return;
+    }
+
+    auto data_size = examples.size();
+    auto next_example = examples.begin();
+
+    auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
+      std::move(
+          next_example,
+          next_example + example_count,
+          std::back_inserter(batch));
+      next_example += example_count;
+    };
+
+    if (!batch_queue_.empty()) {
+      // if the queue has existing data, and the last batch doesn't have enough
+      // examples to fill a batch_size batch, add more example to this batch first.
+      auto& batch = batch_queue_.back();
+      size_t current_count = batch.batch_data.size();
+      if (current_count < batch_size_) {
+        auto example_count =
+            std::min(data_size, batch_size_ - current_count);
+        fill_batch(example_count, batch.batch_data);
+      }
+    }
+
+    // If we still have data remaining after filling the last pushed batch, add
+    // them to the queue too.
+    while (next_example != examples.end()) {
+      UnwrappedBatchType current_batch;
+
+      // Allocate the batch memory ahead of time.
+      current_batch.reserve(batch_size_);
+
+      auto example_count = std::min(
+          static_cast<size_t>(examples.end() - next_example), batch_size_);
+      fill_batch(example_count, current_batch);
+      batch_queue_.emplace(std::move(current_batch));
+    }
+    total_example_count_in_queue_ += data_size;
+    lock.unlock();
+    cv_read_.notify_all();
+  }
+
+  /// Swaps each incoming example with a random resident of the shuffle
+  /// reservoir once it is full, and returns the examples that were evicted.
+  UnwrappedBatchType pass_through_shuffle_buffer(UnwrappedBatchType examples) {
+    UnwrappedBatchType evicted;
+    std::lock_guard<std::mutex> lock(shuffle_mutex_);
+    for (auto& example : examples) {
+      if (shuffle_buffer_.size() < shuffle_buffer_size_) {
+        shuffle_buffer_.emplace_back(std::move(example));
+        continue;
+      }
+      auto victim = std::uniform_int_distribution<size_t>(
+          0, shuffle_buffer_size_ - 1)(shuffle_generator_);
+      evicted.emplace_back(std::move(shuffle_buffer_[victim]));
+      shuffle_buffer_[victim] = std::move(example);
+    }
+    return evicted;
+  }
   /// The batch size is needed to create batches from the chunk data. Similar to
   /// regular dataloader where the batches are created with prefetches,
   /// BatchDataBuffer perform the batch creation using the provided batch size.
@@ -225,6 +302,9 @@ class BatchDataBuffer {
   // sync batch_queue_ update.
   std::mutex queue_mutex_;
 
+  // sync example_sampler_ access between preloaders.
+  std::mutex sampler_mutex_;
+
   std::condition_variable cv_read_;
   std::condition_variable cv_write_;
 
@@ -233,6 +313,14 @@ class BatchDataBuffer {
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
+  // capacity of the cross-chunk shuffle reservoir. 0 disables it.
+  size_t shuffle_buffer_size_;
+
+  // examples held back for cross-chunk shuffling, guarded by shuffle_mutex_.
+  UnwrappedBatchType shuffle_buffer_;
+  std::mt19937 shuffle_generator_;
+  std::mutex shuffle_mutex_;
+
   // When set to true, it wakes the writer threads from the wait and exit current
   // function call. This is needed when ChunkDataSet.Reset is called while the
   // previous epoch is not exhausted yet. When ChunkDataset is waiting its
@@ -250,11 +338,15 @@ struct ChunkDatasetOptions {
       size_t preloader_count,
       size_t batch_size,
       size_t cache_size = 2048,
-      size_t cross_chunk_shuffle_count = 1)
+      size_t cross_chunk_shuffle_count = 1,
+      size_t shuffle_buffer_size = 0,
+      size_t chunk_readahead = 0)
       : preloader_count_(preloader_count),
         batch_size_(batch_size),
         cache_size_(cache_size),
-        cross_chunk_shuffle_count_(cross_chunk_shuffle_count) {
+        cross_chunk_shuffle_count_(cross_chunk_shuffle_count),
+        shuffle_buffer_size_(shuffle_buffer_size),
+        chunk_readahead_(chunk_readahead) {
     TORCH_CHECK(
         preloader_count_ > 0,
         "Preloader count is 0. At least one preloader needs to be specified.");
@@ -292,6 +384,21 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  /// The number of examples held in a reservoir that shuffles examples across
+  /// chunk boundaries as they stream through. Default to 0 meaning no
+  /// reservoir. Unlike `cross_chunk_shuffle_count`, only this many examples
+  /// are held back in addition to the batch cache, so chunks do not need to be
+  /// loaded together.
+  TORCH_ARG(size_t, shuffle_buffer_size) = 0;
+
+  /// The number of chunk reads each preloader keeps in flight ahead of the
+  /// chunk it is currently batching. Default to 0 meaning chunks are read
+  /// synchronously on the preloader thread. When it is greater than 0, reads
+  /// run asynchronously, including the reads of the chunks merged for
+  /// cross-chunk shuffling, so `ChunkReader::read_chunk` needs to be safe to
+  /// call concurrently.
+  TORCH_ARG(size_t, chunk_readahead) = 0;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -387,7 +494,8 @@ class ChunkDataset final
         detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
         options_.batch_size(),
         example_sampler_,
-        options_.cache_size());
+        options_.cache_size(),
+        options_.shuffle_buffer_size());
 
     // create new workers for this new epoch.
     quit_worker_ = false;
@@ -424,20 +532,32 @@ class ChunkDataset final
  private:
   /// running on worker thread to preload chunk data.
   void preloader(size_t id) {
+    // Reads of the chunks sampled ahead of time, oldest first. Each entry holds
+    // the reads of the chunks merged for one cross-chunk shuffle.
+    std::deque<std::vector<std::future<UnwrappedBatchType>>> pending_reads;
     while (!quit_worker_.load()) {
       try {
-        std::vector<size_t> chunk_idx;
-        {
-          std::lock_guard<std::mutex> lock(chunk_index_guard_);
-          if (auto chunk_sampler_result = chunk_sampler_.next(this->options_.cross_chunk_shuffle_count())) {
-            chunk_idx = chunk_sampler_result.value();
-          } else {
-            break;
+        while (pending_reads.size() <= options_.chunk_readahead()) {
+          std::vector<size_t> chunk_idx;
+          {
+            std::lock_guard<std::mutex> lock(chunk_index_guard_);
+            if (auto chunk_sampler_result = chunk_sampler_.next(this->options_.cross_chunk_shuffle_count())) {
+              chunk_idx = chunk_sampler_result.value();
+            } else {
+              break;
+            }
           }
+          pending_reads.push_back(read_chunks(chunk_idx));
         }
-        UnwrappedBatchType data = chunk_reader_.read_chunk(chunk_idx[0]);
-        for (size_t i = 1; i < chunk_idx.size(); ++i) {
-          auto chunk_data = chunk_reader_.read_chunk(chunk_idx[i]);
+        if (pending_reads.empty()) {
+          break;
+        }
+        auto chunk_reads = std::move(pending_reads.front());
+        pending_reads.pop_front();
+
+        UnwrappedBatchType data = chunk_reads[0].get();
+        for (size_t i = 1; i < chunk_reads.size(); ++i) {
+          auto chunk_data = chunk_reads[i].get();
           std::move(
               chunk_data.begin(), chunk_data.end(), std::back_inserter(data));
         }
@@ -452,13 +572,30 @@ class ChunkDataset final
       }
     }
     AT_ASSERT(running_preloaders_.load() > 0);
-    --running_preloaders_;
-    if (running_preloaders_.load() == 0) {
+    if (--running_preloaders_ == 0) {
       // all preloaders are completed, so we can notify the batch_buffer.
+      if (!quit_worker_.load()) {
+        batch_buffer_->flush_shuffle_buffer();
+      }
       batch_buffer_->stop();
     }
   }
 
+  /// Starts reading the given chunks. Without readahead the reads are
+  /// deferred and run on the preloader thread when their result is requested.
+  std::vector<std::future<UnwrappedBatchType>> read_chunks(
+      const std::vector<size_t>& chunk_idx) {
+    const auto policy = options_.chunk_readahead() > 0 ? std::launch::async
+                                                       : std::launch::deferred;
+    std::vector<std::future<UnwrappedBatchType>> reads;
+    reads.reserve(chunk_idx.size());
+    for (size_t index : chunk_idx) {
+      reads.push_back(std::async(
+          policy, [this, index]() { return chunk_reader_.read_chunk(index); }));
+    }
+    return reads;
+  }
+
   /// Block the current thread until the workers finish execution and exit.
   void free_workers() {
     if (!quit_worker_.load()) {
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <torch/arg.h>
+#include <torch/data/datasets/base.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+
+/// Options for a `RecordFileDataset`.
+struct TORCH_API RecordFileOptions {
+  /// How the records of the file are going to be accessed. This is passed to
+  /// the operating system as a hint for its readahead (`madvise` on POSIX
+  /// systems, ignored elsewhere).
+  enum class Access { kNormal, kSequential, kRandom };
+
+  /// The access pattern hint for the whole file.
+  TORCH_ARG(Access, access) = Access::kNormal;
+
+  /// If true, `get_batch` asks the operating system to start reading all
+  /// records of the batch before any of them is touched, so that the page
+  /// faults of a randomly sampled batch are serviced in parallel.
+  TORCH_ARG(bool, will_need) = false;
+};
+
+/// A dataset over a memory-mapped file of records.
+///
+/// The file holds the records back to back, either all of the same
+/// `record_size` or of varying size described by an index of offsets. The
+/// whole file is mapped into memory once, and every example is a
+/// one-dimensional `kUInt8` tensor viewing the bytes of the record inside the
+/// mapping, so reading a record involves no system call and no copy. The
+/// mapping stays alive for as long as any of these tensors does. Use
+/// `Tensor::view` to reinterpret the bytes, and `Tensor::clone` if the record
+/// must be written to.
+class TORCH_API RecordFileDataset : public Dataset<RecordFileDataset, Tensor> {
+ public:
+  /// Maps the file at `path` as consecutive records of `record_size` bytes.
+  /// Trailing bytes that do not make up a full record are ignored.
+  RecordFileDataset(
+      const std::string& path,
+      size_t record_size,
+      RecordFileOptions options = {});
+
+  /// Maps the file at `path` as records of varying size. Record `i` spans the
+  /// bytes `[offsets[i], offsets[i + 1])`, so `offsets` holds one more entry
+  /// than there are records and must be non-decreasing.
+  RecordFileDataset(
+      const std::string& path,
+      std::vector<int64_t> offsets,
+      RecordFileOptions options = {});
+
+  /// Maps the file at `path` as records of varying size, with the offsets read
+  /// from the file at `index_path`. The index is a flat array of little-endian
+  /// 64-bit offsets, laid out as described for the constructor above.
+  RecordFileDataset(
+      const std::string& path,
+      const std::string& index_path,
+      RecordFileOptions options = {});
+
+  /// Returns a view of the record at the given `index`.
+  Tensor get(size_t index) override;
+
+  /// Returns views of the records at the given `indices`, issuing a
+  /// `will_need` hint for all of them first if requested.
+  std::vector<Tensor> get_batch(ArrayRef<size_t> indices) override;
+
+  /// Returns the number of records.
+  optional<size_t> size() const override;
+
+  /// Returns the whole mapped file as a `kUInt8` tensor.
+  const Tensor& data() const;
+
+ private:
+  /// Maps the file and applies the access hint. Called by all constructors
+  /// once `offsets_` (or `record_size_`) is set.
+  void map(const std::string& path);
+
+  /// Returns the byte range of the record at `index`.
+  std::pair<int64_t, int64_t> span(size_t index) const;
+
+  RecordFileOptions options_;
+  Tensor data_;
+  /// The size of every record, or zero if `offsets_` describe the records.
+  int64_t record_size_ = 0;
+  std::vector<int64_t> offsets_;
+  size_t size_ = 0;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/Optional.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// A bounded, lock-free MPMC queue with a blocking fallback.
+///
+/// Elements live in a ring buffer of `capacity` cells (rounded up to a power
+/// of two). Every cell carries a sequence number which tells producers and
+/// consumers whether it is free to be written or ready to be read, so `push`
+/// and `pop` only contend on a single compare-and-swap of the tail or head
+/// counter. When the queue is full (for `push`) or empty (for `pop`), the
+/// calling thread yields for a little while and then goes to sleep on a
+/// condition variable. Threads on the other side only take the mutex to wake
+/// it up when somebody is actually sleeping.
+///
+/// The `push`, `pop` and `clear` methods behave like those of `Queue`, except
+/// that `push` blocks while the queue is full.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity)
+      : capacity_(round_up_to_power_of_two(std::max<size_t>(capacity, 2))),
+        mask_(capacity_ - 1),
+        cells_(new Cell[capacity_]) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Pushes a new value to the back of the `BoundedQueue`, blocking while the
+  /// queue is full, and wakes up any thread waiting inside `pop()`.
+  void push(T value) {
+    wait([this, &value] { return this->try_push(value); }, nullopt);
+    notify();
+  }
+
+  /// Blocks until at least one element is ready to be popped from the front of
+  /// the queue. An optional `timeout` in seconds can be used to limit the time
+  /// spent waiting for an element. If the wait times out, an exception is
+  /// raised.
+  T pop(optional<std::chrono::milliseconds> timeout = nullopt) {
+    optional<T> value;
+    if (!wait([this, &value] { return this->try_pop(value); }, timeout)) {
+      // clang-format off
+      AT_ERROR(
+          "Timeout in DataLoader queue while waiting for next batch"
+          " (timeout was ", timeout->count(), " ms)");
+      // clang-format on
+    }
+    notify();
+    return std::move(*value);
+  }
+
+  /// Empties the queue and returns the number of elements that were removed.
+  /// Threads blocked inside `push()` are woken up, as there is room now.
+  size_t clear() {
+    size_t size = 0;
+    optional<T> value;
+    while (try_pop(value)) {
+      ++size;
+    }
+    if (size > 0) {
+      notify();
+    }
+    return size;
+  }
+
+  /// The number of elements the queue can hold.
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    optional<T> value;
+  };
+
+  /// The number of times a blocked `push` or `pop` retries, yielding in
+  /// between, before it goes to sleep on the condition variable.
+  static constexpr size_t kSpinCount = 128;
+
+  static size_t round_up_to_power_of_two(size_t n) {
+    size_t power = 1;
+    while (power < n) {
+      power <<= 1;
+    }
+    return power;
+  }
+
+  /// Moves `value` into the queue if there is room. `value` is left untouched
+  /// otherwise.
+  bool try_push(T& value) {
+    size_t position = tail_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[position & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<intptr_t>(sequence) -
+          static_cast<intptr_t>(position);
+      if (difference == 0) {
+        if (tail_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Moves the front of the queue into `value` if there is one.
+  bool try_pop(optional<T>& value) {
+    size_t position = head_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[position & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<intptr_t>(sequence) -
+          static_cast<intptr_t>(position + 1);
+      if (difference == 0) {
+        if (head_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = head_.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    cell->value.reset();
+    cell->sequence.store(position + capacity_, std::memory_order_release);
+    return true;
+  }
+
+  /// Retries `ready` until it succeeds, first yielding and then sleeping on
+  /// the condition variable. Returns false if `timeout` expired first.
+  template <typename Predicate>
+  bool wait(Predicate ready, optional<std::chrono::milliseconds> timeout) {
+    for (size_t spin = 0; spin < kSpinCount; ++spin) {
+      if (ready()) {
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleepers_.fetch_add(1);
+    // Pairs with the fence in `notify()`: either we see the other side's
+    // update of the ring buffer, or it sees us sleeping.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool done = true;
+    if (timeout) {
+      done = cv_.wait_for(lock, *timeout, ready);
+    } else {
+      cv_.wait(lock, ready);
+    }
+    sleepers_.fetch_sub(1);
+    return done;
+  }
+
+  /// Wakes up sleeping threads after the ring buffer changed.
+  void notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+      // Taking the mutex ensures a thread that evaluated its predicate is
+      // inside `wait()` by the time we notify.
+      { std::lock_guard<std::mutex> lock(mutex_); }
+      cv_.notify_all();
+    }
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<size_t> sleepers_{0};
+};
+
+template <typename T>
+constexpr size_t BoundedQueue<T>::kSpinCount;
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <torch/data/detail/bounded_queue.h>
 #include <torch/data/detail/queue.h>
 #include <torch/types.h>
 
@@ -22,9 +23,24 @@ namespace detail {
 /// dequeues a result is the count of in-flight jobs decremented. When the main
 /// thread attempts to dequeue a job but no jobs are in-flight, that means the
 /// epoch is complete and `pop_result` returns an empty optional.
-template <typename Job, typename Result>
+///
+/// Jobs and results are passed through queues of type `QueueType`. With the
+/// default `Queue` they are unbounded; with `BoundedQueue` the shuttle must be
+/// constructed with a capacity of at least the number of jobs that can be in
+/// flight at once, or `push_job` and `push_result` will block until there is
+/// room.
+template <
+    typename Job,
+    typename Result,
+    template <typename> class QueueType = Queue>
 class DataShuttle {
  public:
+  DataShuttle() = default;
+
+  /// Constructs a `DataShuttle` whose queues hold up to `capacity` elements.
+  explicit DataShuttle(size_t capacity)
+      : new_jobs_(capacity), results_(capacity) {}
+
   /// Pushes a new job. Called by the main thread.
   void push_job(Job job) {
     new_jobs_.push(std::move(job));
@@ -74,12 +90,12 @@ class DataShuttle {
 
  private:
   /// The queue for jobs that are not yet in flight.
-  Queue<Job> new_jobs_;
+  QueueType<Job> new_jobs_;
   /// The number of in-flight jobs.
   /// NOTE: Not atomic because only manipulated by the main thread.
   size_t in_flight_jobs_ = 0;
   /// The queue for results of finished jobs.
-  Queue<Result> results_;
+  QueueType<Result> results_;
 };
 
 } // namespace detail
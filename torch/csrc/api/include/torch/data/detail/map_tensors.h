@@ -0,0 +1,80 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Applies `function` to every tensor in a batch and returns the resulting
+/// batch. Batches may be tensors, `Example`s, vectors and optionals of these,
+/// nested arbitrarily. Any other value is returned unchanged.
+template <typename F>
+Tensor map_tensors(Tensor tensor, const F& function);
+
+template <typename T, typename F>
+T map_tensors(T value, const F& function);
+
+template <typename Data, typename Target, typename F>
+Example<Data, Target> map_tensors(
+    Example<Data, Target> example,
+    const F& function);
+
+template <typename Data, typename F>
+Example<Data, example::NoTarget> map_tensors(
+    Example<Data, example::NoTarget> example,
+    const F& function);
+
+template <typename T, typename F>
+std::vector<T> map_tensors(std::vector<T> values, const F& function);
+
+template <typename T, typename F>
+optional<T> map_tensors(optional<T> value, const F& function);
+
+template <typename F>
+Tensor map_tensors(Tensor tensor, const F& function) {
+  return function(std::move(tensor));
+}
+
+template <typename T, typename F>
+T map_tensors(T value, const F& /*function*/) {
+  return value;
+}
+
+template <typename Data, typename Target, typename F>
+Example<Data, Target> map_tensors(
+    Example<Data, Target> example,
+    const F& function) {
+  return {map_tensors(std::move(example.data), function),
+          map_tensors(std::move(example.target), function)};
+}
+
+template <typename Data, typename F>
+Example<Data, example::NoTarget> map_tensors(
+    Example<Data, example::NoTarget> example,
+    const F& function) {
+  return {map_tensors(std::move(example.data), function)};
+}
+
+template <typename T, typename F>
+std::vector<T> map_tensors(std::vector<T> values, const F& function) {
+  for (auto& value : values) {
+    value = map_tensors(std::move(value), function);
+  }
+  return values;
+}
+
+template <typename T, typename F>
+optional<T> map_tensors(optional<T> value, const F& function) {
+  if (value) {
+    value = map_tensors(std::move(*value), function);
+  }
+  return value;
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <c10/core/Allocator.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Type.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Serializes a batch (or batch request) for a `WorkerProcess`. Plain values
+/// are appended to a byte buffer. The bytes of tensors are written to a
+/// shared memory segment instead, so the receiving process can build tensors
+/// over the segment without copying them.
+class TORCH_API BatchWriter {
+ public:
+  template <typename T>
+  void write(const T& value) {
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "Only trivially copyable values can be written as raw bytes");
+    write_bytes(&value, sizeof(T));
+  }
+
+  void write_bytes(const void* data, size_t size);
+
+  void write_tensor(const Tensor& tensor);
+
+  /// Returns the finished message for a batch. Any tensors are copied into a
+  /// new shared memory segment, whose name is part of the message.
+  std::string finish() const;
+
+  /// Returns a message that makes the receiving `BatchReader` throw an
+  /// exception with the given `what()`.
+  static std::string error(const std::string& what);
+
+ private:
+  std::string buffer_;
+  std::vector<Tensor> tensors_;
+  /// The size of the shared memory segment needed for `tensors_`.
+  int64_t segment_size_ = 0;
+};
+
+/// Deserializes what a `BatchWriter` wrote, on the other side of the process
+/// boundary.
+class TORCH_API BatchReader {
+ public:
+  /// Parses a message returned by `BatchWriter::finish()`, mapping the shared
+  /// memory segment holding its tensors.
+  explicit BatchReader(std::string message);
+
+  template <typename T>
+  T read() {
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "Only trivially copyable values can be read as raw bytes");
+    T value;
+    read_bytes(&value, sizeof(T));
+    return value;
+  }
+
+  void read_bytes(void* data, size_t size);
+
+  /// Returns a tensor viewing the shared memory segment. The segment stays
+  /// mapped for as long as any of these tensors is alive.
+  Tensor read_tensor();
+
+ private:
+  std::string buffer_;
+  size_t position_ = 0;
+  std::shared_ptr<at::DataPtr> segment_;
+  int64_t segment_size_ = 0;
+  int64_t segment_offset_ = 0;
+};
+
+template <typename T>
+struct Tag {};
+
+/// Encodes arithmetic values as raw bytes. Other types that no overload of
+/// `encode` and `decode` covers fail at runtime rather than at compile time,
+/// so that DataLoaders over such batches still compile as long as they do not
+/// use worker processes.
+template <typename T, typename Enable = void>
+struct ValueCodec {
+  static void encode(BatchWriter& /*writer*/, const T& /*value*/) {
+    C10_THROW_ERROR(
+        Error,
+        c10::str(
+            "DataLoader worker processes cannot send values of type ",
+            c10::demangle_type<T>()));
+  }
+  static T decode(BatchReader& /*reader*/) {
+    C10_THROW_ERROR(
+        Error,
+        c10::str(
+            "DataLoader worker processes cannot receive values of type ",
+            c10::demangle_type<T>()));
+  }
+};
+
+template <typename T>
+struct ValueCodec<
+    T,
+    typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  static void encode(BatchWriter& writer, const T& value) {
+    writer.write(value);
+  }
+  static T decode(BatchReader& reader) {
+    return reader.read<T>();
+  }
+};
+
+// Batches are encoded recursively, following their type. Every overload is
+// declared before any is defined so that nested types resolve.
+void encode(BatchWriter& writer, const Tensor& tensor);
+void encode(BatchWriter& writer, const std::string& value);
+template <typename T>
+void encode(BatchWriter& writer, const T& value);
+template <typename Data, typename Target>
+void encode(BatchWriter& writer, const Example<Data, Target>& example);
+template <typename Data>
+void encode(
+    BatchWriter& writer,
+    const Example<Data, example::NoTarget>& example);
+template <typename T>
+void encode(BatchWriter& writer, const std::vector<T>& values);
+template <typename T>
+void encode(BatchWriter& writer, const optional<T>& value);
+
+Tensor decode(BatchReader& reader, Tag<Tensor>);
+std::string decode(BatchReader& reader, Tag<std::string>);
+template <typename T>
+T decode(BatchReader& reader, Tag<T>);
+template <typename Data, typename Target>
+Example<Data, Target> decode(BatchReader& reader, Tag<Example<Data, Target>>);
+template <typename Data>
+Example<Data, example::NoTarget> decode(
+    BatchReader& reader,
+    Tag<Example<Data, example::NoTarget>>);
+template <typename T>
+std::vector<T> decode(BatchReader& reader, Tag<std::vector<T>>);
+template <typename T>
+optional<T> decode(BatchReader& reader, Tag<optional<T>>);
+
+inline void encode(BatchWriter& writer, const Tensor& tensor) {
+  writer.write_tensor(tensor);
+}
+
+inline void encode(BatchWriter& writer, const std::string& value) {
+  writer.write<uint64_t>(value.size());
+  writer.write_bytes(value.data(), value.size());
+}
+
+template <typename T>
+void encode(BatchWriter& writer, const T& value) {
+  ValueCodec<T>::encode(writer, value);
+}
+
+template <typename Data, typename Target>
+void encode(BatchWriter& writer, const Example<Data, Target>& example) {
+  encode(writer, example.data);
+  encode(writer, example.target);
+}
+
+template <typename Data>
+void encode(
+    BatchWriter& writer,
+    const Example<Data, example::NoTarget>& example) {
+  encode(writer, example.data);
+}
+
+template <typename T>
+void encode(BatchWriter& writer, const std::vector<T>& values) {
+  writer.write<uint64_t>(values.size());
+  for (const auto& value : values) {
+    encode(writer, value);
+  }
+}
+
+template <typename T>
+void encode(BatchWriter& writer, const optional<T>& value) {
+  writer.write<uint8_t>(value.has_value());
+  if (value) {
+    encode(writer, *value);
+  }
+}
+
+inline Tensor decode(BatchReader& reader, Tag<Tensor>) {
+  return reader.read_tensor();
+}
+
+inline std::string decode(BatchReader& reader, Tag<std::string>) {
+  std::string value(reader.read<uint64_t>(), '\0');
+  reader.read_bytes(&value[0], value.size());
+  return value;
+}
+
+template <typename T>
+T decode(BatchReader& reader, Tag<T>) {
+  return ValueCodec<T>::decode(reader);
+}
+
+template <typename Data, typename Target>
+Example<Data, Target> decode(BatchReader& reader, Tag<Example<Data, Target>>) {
+  auto data = decode(reader, Tag<Data>());
+  auto target = decode(reader, Tag<Target>());
+  return {std::move(data), std::move(target)};
+}
+
+template <typename Data>
+Example<Data, example::NoTarget> decode(
+    BatchReader& reader,
+    Tag<Example<Data, example::NoTarget>>) {
+  return {decode(reader, Tag<Data>())};
+}
+
+template <typename T>
+std::vector<T> decode(BatchReader& reader, Tag<std::vector<T>>) {
+  std::vector<T> values;
+  const auto size = reader.read<uint64_t>();
+  values.reserve(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    values.push_back(decode(reader, Tag<T>()));
+  }
+  return values;
+}
+
+template <typename T>
+optional<T> decode(BatchReader& reader, Tag<optional<T>>) {
+  if (reader.read<uint8_t>()) {
+    return decode(reader, Tag<T>());
+  }
+  return nullopt;
+}
+
+/// A DataLoader worker running in a child process.
+///
+/// The child is forked from the process creating the `WorkerProcess`, so it
+/// starts out with a copy of the dataset. It serves batch requests sent over a
+/// socket, and replies with messages written by a `BatchWriter`, which hold
+/// the tensors of the batch in shared memory. If the child crashes, requests
+/// fail with an error instead of taking down the main process. Worker
+/// processes are only available on POSIX systems.
+class TORCH_API WorkerProcess {
+ public:
+  /// Forks a child process which calls `serve` with its end of the socket and
+  /// exits once `serve` returns. The child closes the sockets of `siblings`,
+  /// so that it does not keep them open after they are closed by this
+  /// process.
+  WorkerProcess(
+      const std::function<void(int)>& serve,
+      const std::vector<std::unique_ptr<WorkerProcess>>& siblings);
+
+  /// Closes the socket, which makes the child exit, and waits for it.
+  ~WorkerProcess();
+
+  WorkerProcess(const WorkerProcess&) = delete;
+  WorkerProcess& operator=(const WorkerProcess&) = delete;
+
+  /// Sends `request` to the child and returns the batch it replies with.
+  /// Errors raised by the child are rethrown here.
+  template <typename Batch, typename BatchRequest>
+  Batch get_batch(const BatchRequest& request) {
+    BatchWriter writer;
+    encode(writer, request);
+    BatchReader reader(exchange(writer.finish()));
+    return decode(reader, Tag<Batch>());
+  }
+
+  /// Reads a message sent over `socket`, or returns `nullopt` once the other
+  /// end is closed.
+  static optional<std::string> receive(int socket);
+
+  /// Sends a message over `socket`. Returns false if the other end is closed.
+  static bool send(int socket, const std::string& message);
+
+ private:
+  /// Sends a request to the child and returns its reply.
+  std::string exchange(const std::string& request);
+
+  int pid_ = -1;
+  int socket_ = -1;
+};
+
+/// Runs in a worker process: serves batch requests from `dataset` until the
+/// socket is closed.
+template <typename BatchRequest, typename Dataset>
+void serve_batches(Dataset& dataset, int socket) {
+  while (auto message = WorkerProcess::receive(socket)) {
+    std::string reply;
+    try {
+      BatchReader reader(std::move(*message));
+      auto batch = dataset.get_batch(decode(reader, Tag<BatchRequest>()));
+      BatchWriter writer;
+      encode(writer, batch);
+      reply = writer.finish();
+    } catch (const std::exception& e) {
+      reply = BatchWriter::error(e.what());
+    }
+    if (!WorkerProcess::send(socket, reply)) {
+      return;
+    }
+  }
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
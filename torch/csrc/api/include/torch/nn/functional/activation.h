@@ -795,6 +795,16 @@ inline std::tuple<Tensor, Tensor> multi_head_attention_forward(
         }, /*dim=*/1);
     }
   }
+  if (!need_weights && !attn_mask_.defined() && (dropout_p == 0 || !training) &&
+      (!key_padding_mask_.defined() || key_padding_mask_.scalar_type() == kBool)) {
+    // The fused kernel doesn't materialize the attention weights, so that
+    // memory grows linearly with the sequence lengths
+    auto attn_output = torch::_fused_attention(q, k, v, key_padding_mask_);
+    TORCH_CHECK(attn_output.sizes() == IntArrayRef({bsz * num_heads, tgt_len, head_dim}));
+    attn_output = attn_output.transpose(0, 1).contiguous().view({tgt_len, bsz, embed_dim});
+    attn_output = F::linear(attn_output, out_proj_weight, out_proj_bias);
+    return std::make_tuple(attn_output, Tensor());
+  }
   auto attn_output_weights = torch::bmm(q, k.transpose(1, 2));
   TORCH_CHECK(attn_output_weights.sizes() == IntArrayRef({bsz * num_heads, tgt_len, src_len}));
   if (attn_mask_.defined()) {
@@ -760,6 +760,31 @@ TORCH_MODULE(Threshold);
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ MultiheadAttention ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+/// Keys and values of the positions decoded so far by a `MultiheadAttention`,
+/// see `MultiheadAttentionImpl::forward_incremental`.
+///
+/// The projected keys and values are stored as
+/// `(length, batch * num_heads, head_dim)` tensors that grow in place with
+/// amortized reallocation, so that each decoding step only projects and
+/// attends the new positions.
+struct TORCH_API MultiheadAttentionCache {
+  /// Number of positions in the cache.
+  int64_t length() const;
+
+  /// Reorders the batch entries of the cache, e.g. to follow the surviving
+  /// beams after a beam search step: entry `i` becomes the former entry
+  /// `new_order[i]`. `new_order` may select fewer or more entries than the
+  /// current batch size.
+  void reorder(const Tensor& new_order);
+
+  /// Empties the cache, keeping its memory for the next sequence.
+  void clear();
+
+  Tensor k;
+  Tensor v;
+  int64_t num_heads = 0;
+};
+
 /// Applies the MultiheadAttention function element-wise.
 /// See https://pytorch.org/docs/master/nn.html#torch.nn.MultiheadAttention
 /// to learn about the exact behavior of this module.
@@ -781,6 +806,21 @@ class TORCH_API MultiheadAttentionImpl
   std::tuple<Tensor, Tensor> forward(const Tensor& query, const Tensor& key,
                  const Tensor& value, const Tensor& key_padding_mask = {},
                  bool need_weights = true, const Tensor& attn_mask = {});
+
+  /// Self-attention for autoregressive decoding: the new positions `query`, of
+  /// shape `(new_len, batch, embed_dim)`, attend the positions in `cache` and,
+  /// causally, each other. Their keys and values are appended to `cache`, so a
+  /// step costs O(length) instead of recomputing the whole prefix.
+  /// `key_padding_mask` is of shape `(batch, length + new_len)`.
+  ///
+  /// Meant for inference: the cached keys and values are detached from the
+  /// autograd graph. Not supported with `add_bias_kv`, `add_zero_attn` or
+  /// `kdim`/`vdim` different from `embed_dim`.
+  std::tuple<Tensor, Tensor> forward_incremental(
+      const Tensor& query,
+      MultiheadAttentionCache& cache,
+      const Tensor& key_padding_mask = {},
+      bool need_weights = false);
  protected:
   FORWARD_HAS_DEFAULT_ARGS({3, AnyValue(Tensor())}, {4, AnyValue(true)}, {5, AnyValue(Tensor())})
 
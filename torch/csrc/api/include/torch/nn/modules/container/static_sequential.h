@@ -0,0 +1,202 @@
+#pragma once
+
+#include <torch/nn/cloneable.h>
+#include <torch/nn/module.h>
+#include <torch/nn/pimpl.h>
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace torch {
+namespace nn {
+namespace detail {
+/// Converts the ways a module can be passed to a container (a `shared_ptr`, a
+/// `ModuleHolder` or a concrete module value) into a `shared_ptr` to the
+/// module.
+template <typename M>
+std::shared_ptr<M> to_module_ptr(std::shared_ptr<M> module_ptr) {
+  return module_ptr;
+}
+
+template <typename M>
+std::shared_ptr<M> to_module_ptr(const ModuleHolder<M>& module_holder) {
+  return module_holder.ptr();
+}
+
+template <typename M, typename = torch::detail::enable_if_module_t<M>>
+std::shared_ptr<typename std::decay<M>::type> to_module_ptr(M&& module) {
+  using Type = typename std::decay<M>::type;
+  return std::make_shared<Type>(std::forward<M>(module));
+}
+
+/// The module type stored for an argument of type `T` passed to
+/// `make_static_sequential()`.
+template <typename T>
+using static_sequential_module_t = typename decltype(
+    to_module_ptr(std::declval<T>()))::element_type;
+} // namespace detail
+
+/// A `Sequential` whose module types are fixed at compile time.
+///
+/// `Sequential` stores its modules as `AnyModule`s, so every call to
+/// `forward()` goes through a virtual call and boxes each intermediate result
+/// into an `AnyValue`. `StaticSequential` instead stores the modules in a
+/// `std::tuple` and chains their `forward()` methods directly, passing each
+/// output to the next module with its static type. The return type of
+/// `forward()` is deduced from the last module, and modules whose `forward()`
+/// takes default arguments can be called with those arguments omitted.
+///
+/// The modules are registered as submodules named "0", "1", ... exactly like
+/// in `Sequential`, so parameters, serialization and device moves behave the
+/// same way.
+///
+/// \rst
+/// .. code-block:: cpp
+///
+///   auto seq = torch::nn::make_static_sequential(
+///     torch::nn::Linear(3, 4),
+///     torch::nn::ReLU(),
+///     torch::nn::Linear(4, 2)
+///   );
+///
+///   torch::Tensor output = seq->forward(torch::ones({8, 3}));
+///
+/// \endrst
+///
+/// Since the set of modules is part of the type, `StaticSequential` does not
+/// support `push_back()` or `extend()`; use `Sequential` when the modules are
+/// only known at runtime.
+template <typename... Modules>
+class StaticSequentialImpl : public Cloneable<StaticSequentialImpl<Modules...>> {
+  static_assert(
+      sizeof...(Modules) > 0,
+      "StaticSequential must contain at least one module");
+
+ public:
+  /// Constructs the `StaticSequential` from one module per element of
+  /// `Modules`, each given as a `shared_ptr`, a `ModuleHolder` or a module
+  /// value.
+  template <
+      typename... Args,
+      typename = typename std::enable_if<
+          sizeof...(Args) == sizeof...(Modules) &&
+          !std::is_same<
+              std::tuple<typename std::decay<Args>::type...>,
+              std::tuple<StaticSequentialImpl>>::value>::type>
+  explicit StaticSequentialImpl(Args&&... modules)
+      : modules_(detail::to_module_ptr(std::forward<Args>(modules))...) {
+    register_modules(std::index_sequence_for<Modules...>());
+  }
+
+  /// Special cloning function for `StaticSequential` because it does not use
+  /// `reset()`.
+  std::shared_ptr<Module> clone(
+      const optional<Device>& device = nullopt) const override {
+    return clone_modules(device, std::index_sequence_for<Modules...>());
+  }
+
+  /// `reset()` is empty for `StaticSequential`, since it does not have
+  /// parameters of its own.
+  void reset() override {}
+
+  /// Pretty prints the `StaticSequential` module into the given `stream`.
+  void pretty_print(std::ostream& stream) const override {
+    stream << "torch::nn::StaticSequential";
+  }
+
+  /// Feeds `inputs` to the first module and then chains outputs to inputs,
+  /// returning the output of the last module.
+  template <typename... InputTypes>
+  auto forward(InputTypes&&... inputs) {
+    return forward_from<0>(is_last<0>(), std::forward<InputTypes>(inputs)...);
+  }
+
+  /// Returns the module at the given index.
+  template <size_t Index>
+  auto& at() {
+    return *std::get<Index>(modules_);
+  }
+
+  /// Returns the module at the given index.
+  template <size_t Index>
+  const auto& at() const {
+    return *std::get<Index>(modules_);
+  }
+
+  /// Returns a `std::shared_ptr` to the module at the given index.
+  template <size_t Index>
+  const auto& ptr() const {
+    return std::get<Index>(modules_);
+  }
+
+  /// The number of modules in the `StaticSequential`.
+  static constexpr size_t size() noexcept {
+    return sizeof...(Modules);
+  }
+
+ private:
+  template <size_t Index>
+  using is_last = std::integral_constant<bool, Index + 1 == sizeof...(Modules)>;
+
+  template <size_t Index, typename... InputTypes>
+  auto forward_from(std::true_type /*last*/, InputTypes&&... inputs) {
+    return std::get<Index>(modules_)->forward(
+        std::forward<InputTypes>(inputs)...);
+  }
+
+  template <size_t Index, typename... InputTypes>
+  auto forward_from(std::false_type /*last*/, InputTypes&&... inputs) {
+    return forward_from<Index + 1>(
+        is_last<Index + 1>(),
+        std::get<Index>(modules_)->forward(std::forward<InputTypes>(inputs)...));
+  }
+
+  template <size_t... Indices>
+  void register_modules(std::index_sequence<Indices...>) {
+    (void)std::initializer_list<int>{
+        (this->register_module(
+             c10::to_string(Indices), std::get<Indices>(modules_)),
+         0)...};
+  }
+
+  template <size_t... Indices>
+  std::shared_ptr<Module> clone_modules(
+      const optional<Device>& device,
+      std::index_sequence<Indices...>) const {
+    return std::make_shared<StaticSequentialImpl>(
+        std::dynamic_pointer_cast<Modules>(
+            std::get<Indices>(modules_)->clone(device))...);
+  }
+
+  std::tuple<std::shared_ptr<Modules>...> modules_;
+};
+
+/// A `ModuleHolder` subclass for `StaticSequentialImpl`.
+/// See the documentation for `StaticSequentialImpl` class to learn what methods
+/// it provides, or the documentation for `ModuleHolder` to learn about
+/// PyTorch's module storage semantics.
+template <typename... Modules>
+class StaticSequential
+    : public torch::nn::ModuleHolder<StaticSequentialImpl<Modules...>> {
+ public:
+  using torch::nn::ModuleHolder<StaticSequentialImpl<Modules...>>::ModuleHolder;
+};
+
+/// Creates a `StaticSequential`, deducing the module types from the arguments.
+template <typename... Args>
+StaticSequential<detail::static_sequential_module_t<Args>...>
+make_static_sequential(Args&&... modules) {
+  return std::make_shared<
+      StaticSequentialImpl<detail::static_sequential_module_t<Args>...>>(
+      std::forward<Args>(modules)...);
+}
+} // namespace nn
+} // namespace torch
@@ -2,6 +2,8 @@
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace nn {
 namespace utils {
@@ -14,37 +16,47 @@ inline double clip_grad_norm_(
     std::vector<Tensor> parameters,
     double max_norm,
     double norm_type = 2.0) {
-  std::vector<Tensor> params_with_grad;
-
+  std::vector<Tensor> grads;
   for (const auto& param : parameters) {
     auto& grad = param.grad();
     if (grad.defined()) {
-      params_with_grad.push_back(param);
+      grads.push_back(grad.detach());
     }
   }
-  double total_norm = 0.0;
-  if (norm_type == std::numeric_limits<double>::infinity()) {
-    for (const auto& param : params_with_grad) {
-      auto param_max = param.grad().data().abs().max().item().toDouble();
-      if (param_max > total_norm) {
-        total_norm = param_max;
-      }
-    }
+  if (grads.empty()) {
+    return 0.0;
+  }
+
+  // The norms and the clipping coefficient stay on the device, so the grads
+  // are scaled without waiting for the total norm. When all grads live on
+  // one device this is one foreach norm and one foreach mul.
+  const auto device = grads[0].device();
+  const bool same_device = std::all_of(
+      grads.begin(), grads.end(), [&](const Tensor& grad) {
+        return grad.device() == device;
+      });
+  std::vector<Tensor> norms;
+  if (same_device) {
+    norms = at::_foreach_norm(grads, norm_type);
   } else {
-    for (const auto& param : params_with_grad) {
-      auto param_norm = param.grad().data().norm(norm_type);
-      total_norm += std::pow(param_norm.item().toDouble(), norm_type);
+    for (const auto& grad : grads) {
+      norms.push_back(grad.norm(norm_type).to(device));
     }
-    total_norm = std::pow(total_norm, 1.0 / norm_type);
   }
+  auto stacked_norms = at::stack(norms);
+  auto total_norm = norm_type == std::numeric_limits<double>::infinity()
+      ? stacked_norms.max()
+      : stacked_norms.norm(norm_type);
 
-  auto clip_coef = max_norm / (total_norm + 1e-6);
-  if (clip_coef < 1) {
-    for (auto& param : params_with_grad) {
-      param.grad().data().mul_(clip_coef);
+  auto clip_coef = (max_norm / (total_norm + 1e-6)).clamp_max(1.0);
+  if (same_device) {
+    at::_foreach_mul_(grads, clip_coef);
+  } else {
+    for (auto& grad : grads) {
+      grad.mul_(clip_coef.to(grad.device()));
     }
   }
-  return total_norm;
+  return total_norm.item().toDouble();
 }
 
 // A wrapper around clip_grad_norm_ that allows us to call the function with a
@@ -26,6 +26,9 @@ struct TORCH_API AdamOptions : public OptimizerCloneableOptions<AdamOptions> {
   TORCH_ARG(double, eps) = 1e-8;
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(bool, amsgrad) = false;
+  // Runs the whole update of each step in one fused kernel per device
+  // (see at::_fused_adam_) instead of a sequence of foreach ops.
+  TORCH_ARG(bool, fused) = false;
 public:
   void serialize(torch::serialize::InputArchive& archive) override;
   void serialize(torch::serialize::OutputArchive& archive) const override;
@@ -256,6 +256,16 @@ std::deque<T> list_to_deque(const c10::List<T>& list) {
   } \
 }
 
+// Like _TORCH_OPTIM_DESERIALIZE_TORCH_ARG, but keeps the default value when
+// `name` is missing, for options added after archives were first written.
+#define _TORCH_OPTIM_DESERIALIZE_TORCH_ARG_IF_PRESENT(T, name) { \
+  c10::IValue ivalue; \
+  bool exists = archive.try_read(#name, ivalue); \
+  if (exists) { \
+    name(ivalue.to<T>()); \
+  } \
+}
+
 #define _TORCH_OPTIM_DESERIALIZE_TORCH_ARG_OPTIONAL(T, name) { \
   c10::IValue ivalue; \
   bool exists = archive.try_read(#name, ivalue); \
@@ -28,6 +28,9 @@ struct TORCH_API SGDOptions : public OptimizerCloneableOptions<SGDOptions> {
   TORCH_ARG(double, dampening) = 0;
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(bool, nesterov) = false;
+  // Runs the whole update in one fused kernel per device (see
+  // at::_fused_sgd_) instead of a sequence of foreach ops.
+  TORCH_ARG(bool, fused) = false;
 public:
   void serialize(torch::serialize::InputArchive& archive) override;
   void serialize(torch::serialize::OutputArchive& archive) const override;
@@ -64,6 +67,13 @@ class TORCH_API SGD : public Optimizer {
   void load(serialize::InputArchive& archive) override;
 
  private:
+  // Applies the update for the given parameters with at::_fused_sgd_.
+  void fused_step(
+      const std::vector<Tensor>& params,
+      const std::vector<Tensor>& params_data,
+      const std::vector<Tensor>& grads,
+      const SGDOptions& options);
+
   template <typename Self, typename Archive>
   static void serialize(Self& self, Archive& archive) {
     _TORCH_OPTIM_SERIALIZE_WITH_TEMPLATE_ARG(SGD);
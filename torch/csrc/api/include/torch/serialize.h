@@ -73,7 +73,9 @@ void save(const std::vector<torch::Tensor>& tensor_vec, SaveToArgs&&... args) {
   archive.save_to(std::forward<SaveToArgs>(args)...);
 }
 
-TORCH_API std::vector<char> pickle_save(const torch::IValue& ivalue);
+TORCH_API std::vector<char> pickle_save(
+    const torch::IValue& ivalue,
+    size_t pack_storages_below = 0);
 TORCH_API torch::IValue pickle_load(const std::vector<char>& data);
 
 /// Deserializes the given `value`.
@@ -2,6 +2,7 @@
 
 #include <ATen/Parallel.h>
 #include <ATen/record_function.h>
+#include <c10/core/InferenceMode.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/api/include/torch/types.h>
 #include <cstdint>
@@ -66,6 +67,28 @@ using NoGradGuard = at::NoGradGuard;
 /// @endcode
 using AutoGradMode = at::AutoGradMode;
 
+/// A RAII, thread-local guard that enables inference mode.
+///
+/// Like ``NoGradGuard``, but it also skips the autograd kernels altogether:
+/// computations don't record any autograd metadata and tensors created under
+/// it have no version counter. Such tensors can't be saved for backward later
+/// on; clone them first. See Note [Inference mode] in
+/// `c10/core/InferenceMode.h`.
+///
+/// This context manager is thread-local; it will not affect computation
+/// in other threads.
+///
+/// Example:
+/// @code
+/// auto x = torch::ones({2, 2});
+/// {
+///   torch::InferenceMode guard;
+///   auto y = x * 2;
+///   std::cout << y.requires_grad() << std::endl; // prints `false`
+/// }
+/// @endcode
+using InferenceMode = c10::InferenceMode;
+
 /// Sets the global random seed for all newly created CPU and CUDA tensors.
 using at::manual_seed;
 
@@ -0,0 +1,177 @@
+#include <torch/data/datasets/record_file.h>
+
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+int64_t file_size(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  TORCH_CHECK(file, "Error opening records file at ", path);
+  return file.tellg();
+}
+
+std::vector<int64_t> read_offsets(const std::string& index_path) {
+  std::ifstream index(index_path, std::ios::binary);
+  TORCH_CHECK(index, "Error opening records index at ", index_path);
+  std::vector<int64_t> offsets;
+  uint8_t bytes[8];
+  while (index.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+    uint64_t offset = 0;
+    for (int i = 7; i >= 0; --i) {
+      offset = (offset << 8u) | bytes[i];
+    }
+    offsets.push_back(static_cast<int64_t>(offset));
+  }
+  TORCH_CHECK(
+      index.gcount() == 0,
+      "Records index at ",
+      index_path,
+      " is not a multiple of 8 bytes long");
+  return offsets;
+}
+
+#ifndef _WIN32
+/// Passes `advice` for the bytes `[begin, end)` of `data` to `madvise`,
+/// widening the range to page boundaries. Advice is only a hint, so errors
+/// are ignored.
+void advise(const Tensor& data, int64_t begin, int64_t end, int advice) {
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const auto base = reinterpret_cast<uintptr_t>(data.data_ptr());
+  const uintptr_t first = (base + begin) & ~(page_size - 1);
+  const uintptr_t last = base + end;
+  if (last > first) {
+    (void)madvise(reinterpret_cast<void*>(first), last - first, advice);
+  }
+}
+#endif
+} // namespace
+
+RecordFileDataset::RecordFileDataset(
+    const std::string& path,
+    size_t record_size,
+    RecordFileOptions options)
+    : options_(std::move(options)),
+      record_size_(static_cast<int64_t>(record_size)) {
+  TORCH_CHECK(record_size > 0, "Record size must be positive");
+  map(path);
+  size_ = data_.numel() / record_size_;
+}
+
+RecordFileDataset::RecordFileDataset(
+    const std::string& path,
+    std::vector<int64_t> offsets,
+    RecordFileOptions options)
+    : options_(std::move(options)), offsets_(std::move(offsets)) {
+  TORCH_CHECK(
+      !offsets_.empty(),
+      "Record offsets must hold one more entry than there are records");
+  for (size_t i = 1; i < offsets_.size(); ++i) {
+    TORCH_CHECK(
+        offsets_[i - 1] <= offsets_[i],
+        "Record offsets must be non-decreasing, but offset ",
+        i - 1,
+        " is ",
+        offsets_[i - 1],
+        " and offset ",
+        i,
+        " is ",
+        offsets_[i]);
+  }
+  TORCH_CHECK(offsets_.front() >= 0, "Record offsets must not be negative");
+  map(path);
+  TORCH_CHECK(
+      offsets_.back() <= data_.numel(),
+      "Record offsets reach byte ",
+      offsets_.back(),
+      " but the records file at ",
+      path,
+      " is only ",
+      data_.numel(),
+      " bytes long");
+  size_ = offsets_.size() - 1;
+}
+
+RecordFileDataset::RecordFileDataset(
+    const std::string& path,
+    const std::string& index_path,
+    RecordFileOptions options)
+    : RecordFileDataset(path, read_offsets(index_path), std::move(options)) {}
+
+void RecordFileDataset::map(const std::string& path) {
+  const int64_t bytes = file_size(path);
+  TORCH_CHECK(bytes > 0, "Records file at ", path, " is empty");
+  // A private mapping: reading shares the page cache, writes to a view are
+  // copy-on-write and never reach the file.
+  data_ = torch::from_file(path, /*shared=*/false, bytes, torch::kUInt8);
+#ifndef _WIN32
+  switch (options_.access()) {
+    case RecordFileOptions::Access::kSequential:
+      advise(data_, 0, bytes, MADV_SEQUENTIAL);
+      break;
+    case RecordFileOptions::Access::kRandom:
+      advise(data_, 0, bytes, MADV_RANDOM);
+      break;
+    case RecordFileOptions::Access::kNormal:
+      break;
+  }
+#endif
+}
+
+std::pair<int64_t, int64_t> RecordFileDataset::span(size_t index) const {
+  TORCH_CHECK(
+      index < size_,
+      "Record index ",
+      index,
+      " is out of range for a dataset of ",
+      size_,
+      " records");
+  if (record_size_ > 0) {
+    const int64_t begin = static_cast<int64_t>(index) * record_size_;
+    return {begin, begin + record_size_};
+  }
+  return {offsets_[index], offsets_[index + 1]};
+}
+
+Tensor RecordFileDataset::get(size_t index) {
+  const auto range = span(index);
+  return data_.narrow(0, range.first, range.second - range.first);
+}
+
+std::vector<Tensor> RecordFileDataset::get_batch(ArrayRef<size_t> indices) {
+#ifndef _WIN32
+  if (options_.will_need()) {
+    for (const auto index : indices) {
+      const auto range = span(index);
+      advise(data_, range.first, range.second, MADV_WILLNEED);
+    }
+  }
+#endif
+  return Dataset::get_batch(indices);
+}
+
+optional<size_t> RecordFileDataset::size() const {
+  return size_;
+}
+
+const Tensor& RecordFileDataset::data() const {
+  return data_;
+}
+} // namespace datasets
+} // namespace data
+} // namespace torch
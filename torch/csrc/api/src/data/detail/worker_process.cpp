@@ -0,0 +1,314 @@
+#include <torch/data/detail/worker_process.h>
+
+#include <torch/types.h>
+
+#include <ATen/Parallel.h>
+#include <ATen/Utils.h>
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace data {
+namespace detail {
+namespace {
+/// Tensors in a shared memory segment start at multiples of this, which keeps
+/// every element type aligned and lets vectorized kernels use them directly.
+constexpr int64_t kTensorAlignment = 64;
+
+constexpr uint8_t kReplyError = 0;
+constexpr uint8_t kReplyBatch = 1;
+
+int64_t align(int64_t offset) {
+  return (offset + kTensorAlignment - 1) / kTensorAlignment * kTensorAlignment;
+}
+
+#ifndef _WIN32
+/// Creates the shared memory segment `name` of `size` bytes, fills it through
+/// `fill` and unmaps it again. The segment outlives this process until the
+/// receiving side unlinks it.
+void create_segment(
+    const std::string& name,
+    int64_t size,
+    const std::function<void(uint8_t*)>& fill) {
+  const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  TORCH_CHECK(fd != -1, "Could not create shared memory segment ", name);
+  if (ftruncate(fd, size) == -1) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    TORCH_CHECK(false, "Could not resize shared memory segment ", name);
+  }
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    TORCH_CHECK(false, "Could not map shared memory segment ", name);
+  }
+  fill(static_cast<uint8_t*>(data));
+  munmap(data, size);
+}
+
+bool read_exactly(int socket, void* data, size_t size) {
+  auto* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::read(socket, bytes, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    bytes += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool write_exactly(int socket, const void* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+  // A crashed peer must not kill this process with SIGPIPE. Where there is no
+  // MSG_NOSIGNAL, the sockets are created with SO_NOSIGPIPE instead.
+  constexpr int kFlags = MSG_NOSIGNAL;
+#else
+  constexpr int kFlags = 0;
+#endif
+  const auto* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::send(socket, bytes, size, kFlags);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    bytes += n;
+    size -= n;
+  }
+  return true;
+}
+#endif
+} // namespace
+
+void BatchWriter::write_bytes(const void* data, size_t size) {
+  buffer_.append(static_cast<const char*>(data), size);
+}
+
+void BatchWriter::write_tensor(const Tensor& tensor) {
+  TORCH_CHECK(
+      tensor.device().is_cpu(),
+      "DataLoader worker processes can only send CPU tensors, but got a "
+      "tensor on ",
+      tensor.device());
+  auto contiguous = tensor.contiguous();
+  write<int8_t>(static_cast<int8_t>(contiguous.scalar_type()));
+  write<int64_t>(contiguous.dim());
+  for (const auto size : contiguous.sizes()) {
+    write<int64_t>(size);
+  }
+  segment_size_ =
+      align(segment_size_) + contiguous.numel() * contiguous.element_size();
+  tensors_.push_back(std::move(contiguous));
+}
+
+std::string BatchWriter::finish() const {
+  std::string name;
+#ifndef _WIN32
+  if (segment_size_ > 0) {
+    static std::atomic<uint64_t> counter{0};
+    name = "/torch_dataloader_" + std::to_string(getpid()) + "_" +
+        std::to_string(counter++);
+    create_segment(name, segment_size_, [this](uint8_t* data) {
+      int64_t offset = 0;
+      for (const auto& tensor : tensors_) {
+        offset = align(offset);
+        const int64_t bytes = tensor.numel() * tensor.element_size();
+        std::memcpy(data + offset, tensor.data_ptr(), bytes);
+        offset += bytes;
+      }
+    });
+  }
+#else
+  TORCH_CHECK(
+      tensors_.empty(),
+      "DataLoader worker processes are not supported on Windows");
+#endif
+  BatchWriter header;
+  header.write<uint8_t>(kReplyBatch);
+  encode(header, name);
+  header.write<int64_t>(segment_size_);
+  return header.buffer_ + buffer_;
+}
+
+std::string BatchWriter::error(const std::string& what) {
+  BatchWriter writer;
+  writer.write<uint8_t>(kReplyError);
+  encode(writer, what);
+  return writer.buffer_;
+}
+
+BatchReader::BatchReader(std::string message) : buffer_(std::move(message)) {
+  if (read<uint8_t>() == kReplyError) {
+    // Rethrow with the message of the original exception only, so that
+    // `WorkerException` reads the same as for worker threads.
+    throw std::runtime_error(decode(*this, Tag<std::string>()));
+  }
+  const auto name = decode(*this, Tag<std::string>());
+  segment_size_ = read<int64_t>();
+  if (!name.empty()) {
+    // The segment is unlinked as soon as it is mapped, so that it disappears
+    // along with the last tensor viewing it.
+    segment_ = std::make_shared<at::DataPtr>(THMapAllocator::makeDataPtr(
+        name.c_str(),
+        TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE |
+            TH_ALLOCATOR_MAPPED_UNLINK,
+        segment_size_,
+        nullptr));
+  }
+}
+
+void BatchReader::read_bytes(void* data, size_t size) {
+  TORCH_CHECK(
+      position_ + size <= buffer_.size(),
+      "Truncated message from DataLoader worker process");
+  std::memcpy(data, buffer_.data() + position_, size);
+  position_ += size;
+}
+
+Tensor BatchReader::read_tensor() {
+  const auto dtype = static_cast<ScalarType>(read<int8_t>());
+  std::vector<int64_t> sizes(read<int64_t>());
+  for (auto& size : sizes) {
+    size = read<int64_t>();
+  }
+  const auto options = torch::TensorOptions().dtype(dtype);
+  segment_offset_ = align(segment_offset_);
+  const int64_t bytes = at::prod_intlist(sizes) * c10::elementSize(dtype);
+  if (bytes == 0) {
+    return torch::empty(sizes, options);
+  }
+  TORCH_CHECK(
+      segment_ && segment_offset_ + bytes <= segment_size_,
+      "Truncated shared memory segment from DataLoader worker process");
+  auto* data = static_cast<uint8_t*>(segment_->get()) + segment_offset_;
+  segment_offset_ += bytes;
+  auto segment = segment_;
+  return torch::from_blob(
+      data, sizes, [segment](void*) mutable { segment.reset(); }, options);
+}
+
+#ifndef _WIN32
+WorkerProcess::WorkerProcess(
+    const std::function<void(int)>& serve,
+    const std::vector<std::unique_ptr<WorkerProcess>>& siblings) {
+  int sockets[2];
+  TORCH_CHECK(
+      socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0,
+      "Could not create a socket for a DataLoader worker process");
+#ifdef SO_NOSIGPIPE
+  for (const int socket : sockets) {
+    const int enable = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+  }
+#endif
+  pid_ = fork();
+  if (pid_ == -1) {
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+    TORCH_CHECK(false, "Could not fork a DataLoader worker process");
+  }
+  if (pid_ == 0) {
+    ::close(sockets[0]);
+    for (const auto& sibling : siblings) {
+      ::close(sibling->socket_);
+    }
+    // Intra-op thread pools do not survive a fork, and several workers
+    // competing for the cores gain nothing from them anyway.
+    at::set_num_threads(1);
+    int status = 0;
+    try {
+      serve(sockets[1]);
+    } catch (...) {
+      status = 1;
+    }
+    // Never unwind into the parent's stack or run its static destructors.
+    _exit(status);
+  }
+  ::close(sockets[1]);
+  socket_ = sockets[0];
+}
+
+WorkerProcess::~WorkerProcess() {
+  ::close(socket_);
+  int status;
+  while (waitpid(pid_, &status, 0) == -1 && errno == EINTR) {
+  }
+}
+
+optional<std::string> WorkerProcess::receive(int socket) {
+  uint64_t size;
+  if (!read_exactly(socket, &size, sizeof(size))) {
+    return nullopt;
+  }
+  std::string message(size, '\0');
+  if (!read_exactly(socket, &message[0], size)) {
+    return nullopt;
+  }
+  return message;
+}
+
+bool WorkerProcess::send(int socket, const std::string& message) {
+  const uint64_t size = message.size();
+  return write_exactly(socket, &size, sizeof(size)) &&
+      write_exactly(socket, message.data(), size);
+}
+#else
+WorkerProcess::WorkerProcess(
+    const std::function<void(int)>& /*serve*/,
+    const std::vector<std::unique_ptr<WorkerProcess>>& /*siblings*/) {
+  TORCH_CHECK(false, "DataLoader worker processes are not supported on Windows");
+}
+
+WorkerProcess::~WorkerProcess() = default;
+
+optional<std::string> WorkerProcess::receive(int /*socket*/) {
+  return nullopt;
+}
+
+bool WorkerProcess::send(int /*socket*/, const std::string& /*message*/) {
+  return false;
+}
+#endif
+
+std::string WorkerProcess::exchange(const std::string& request) {
+  auto reply = send(socket_, request) ? receive(socket_) : nullopt;
+  TORCH_CHECK(
+      reply.has_value(),
+      "DataLoader worker process (pid ",
+      pid_,
+      ") exited unexpectedly");
+  return std::move(*reply);
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -393,6 +393,36 @@ void ThresholdImpl::pretty_print(std::ostream& stream) const {
 
 // ============================================================================
 
+int64_t MultiheadAttentionCache::length() const {
+  return k.defined() ? k.size(0) : 0;
+}
+
+void MultiheadAttentionCache::reorder(const Tensor& new_order) {
+  if (!k.defined()) {
+    return;
+  }
+  // Batch entry b of the cache spans rows b * num_heads ... (b + 1) * num_heads - 1
+  const auto index = (new_order.to(k.device(), kLong).unsqueeze(1) * num_heads +
+                      torch::arange(num_heads, k.options().dtype(kLong))).view(-1);
+  auto new_k = k.index_select(/*dim=*/1, index);
+  auto new_v = v.index_select(/*dim=*/1, index);
+  if (new_k.sizes() == k.sizes()) {
+    // Keep the capacity of the cache
+    k.copy_(new_k);
+    v.copy_(new_v);
+  } else {
+    k = std::move(new_k);
+    v = std::move(new_v);
+  }
+}
+
+void MultiheadAttentionCache::clear() {
+  if (k.defined()) {
+    k.resize_({0, k.size(1), k.size(2)});
+    v.resize_({0, v.size(1), v.size(2)});
+  }
+}
+
 MultiheadAttentionImpl::MultiheadAttentionImpl(const MultiheadAttentionOptions& options_)
     : Module("torch::nn::MultiheadAttention"), options(options_) {
   reset();
@@ -447,6 +477,94 @@ std::tuple<Tensor, Tensor> MultiheadAttentionImpl::forward(
   }
 }
 
+std::tuple<Tensor, Tensor> MultiheadAttentionImpl::forward_incremental(
+    const Tensor& query,
+    MultiheadAttentionCache& cache,
+    const Tensor& key_padding_mask,
+    bool need_weights) {
+  TORCH_CHECK(_qkv_same_embed_dim && !bias_k.defined() && !options.add_zero_attn(),
+              "forward_incremental does not support kdim/vdim different from "
+              "embed_dim, add_bias_kv or add_zero_attn");
+  TORCH_CHECK(query.dim() == 3 && query.size(2) == options.embed_dim(),
+              "forward_incremental: expected query of shape (new_len, batch, ",
+              options.embed_dim(), "), got ", query.sizes());
+  const auto tgt_len = query.size(0);
+  const auto bsz = query.size(1);
+  const auto embed_dim = options.embed_dim();
+  const auto num_heads = options.num_heads();
+  const auto scaling = 1 / std::sqrt(head_dim);
+
+  // Only the new positions are projected
+  const auto chunks =
+    F::linear(query, in_proj_weight, in_proj_bias).chunk(3, /*dim=*/-1);
+  auto q = chunks[0];
+  const auto k = chunks[1].detach().reshape({tgt_len, bsz * num_heads, head_dim});
+  const auto v = chunks[2].detach().reshape({tgt_len, bsz * num_heads, head_dim});
+
+  if (!cache.k.defined()) {
+    cache.k = torch::empty({0, bsz * num_heads, head_dim}, k.options());
+    cache.v = torch::empty({0, bsz * num_heads, head_dim}, v.options());
+  } else if (cache.length() == 0) {
+    cache.k.resize_({0, bsz * num_heads, head_dim});
+    cache.v.resize_({0, bsz * num_heads, head_dim});
+  }
+  cache.num_heads = num_heads;
+  TORCH_CHECK(cache.k.size(1) == bsz * num_heads,
+              "forward_incremental: the cache holds a batch of ",
+              cache.k.size(1) / num_heads, ", got a query batch of ", bsz);
+  const auto past_len = cache.length();
+  const auto src_len = past_len + tgt_len;
+  cache.k.resize_amortized_({src_len, bsz * num_heads, head_dim});
+  cache.v.resize_amortized_({src_len, bsz * num_heads, head_dim});
+  cache.k.narrow(/*dim=*/0, past_len, tgt_len).copy_(k);
+  cache.v.narrow(/*dim=*/0, past_len, tgt_len).copy_(v);
+  if (key_padding_mask.defined()) {
+    TORCH_CHECK(key_padding_mask.size(0) == bsz && key_padding_mask.size(1) == src_len,
+                "forward_incremental: expected key_padding_mask of shape (",
+                bsz, ", ", src_len, "), got ", key_padding_mask.sizes());
+  }
+
+  q = (q * scaling).contiguous().view({tgt_len, bsz * num_heads, head_dim}).transpose(0, 1);
+  const auto keys = cache.k.transpose(0, 1);
+  const auto values = cache.v.transpose(0, 1);
+  // New positions only attend each other causally, a single one attends all
+  const bool causal = tgt_len > 1;
+  const double dropout_p = is_training() ? options.dropout() : 0;
+  Tensor attn_output;
+  Tensor attn_output_weights;
+  if (!need_weights && !causal && dropout_p == 0 &&
+      (!key_padding_mask.defined() || key_padding_mask.scalar_type() == kBool)) {
+    attn_output = torch::_fused_attention(q, keys, values, key_padding_mask);
+  } else {
+    const auto neg_inf = -std::numeric_limits<double>::infinity();
+    attn_output_weights = torch::bmm(q, keys.transpose(1, 2));
+    if (causal) {
+      // New position i is at position past_len + i of the sequence
+      attn_output_weights.masked_fill_(
+        torch::ones({tgt_len, src_len}, q.options().dtype(kBool)).triu_(past_len + 1),
+        neg_inf);
+    }
+    if (key_padding_mask.defined()) {
+      attn_output_weights = attn_output_weights
+        .view({bsz, num_heads, tgt_len, src_len})
+        .masked_fill_(key_padding_mask.to(kBool).unsqueeze(1).unsqueeze(2), neg_inf)
+        .view({bsz * num_heads, tgt_len, src_len});
+    }
+    attn_output_weights = F::softmax(attn_output_weights, /*dim=*/-1);
+    attn_output_weights = F::dropout(
+      attn_output_weights, F::DropoutFuncOptions().p(dropout_p).training(is_training()));
+    attn_output = torch::bmm(attn_output_weights, values);
+  }
+  attn_output = attn_output.transpose(0, 1).contiguous().view({tgt_len, bsz, embed_dim});
+  attn_output = out_proj(attn_output);
+  if (need_weights) {
+    // average attention weights over heads
+    attn_output_weights = attn_output_weights.view({bsz, num_heads, tgt_len, src_len});
+    return std::make_tuple(attn_output, attn_output_weights.sum(/*dim=*/1) / num_heads);
+  }
+  return std::make_tuple(attn_output, Tensor());
+}
+
 void MultiheadAttentionImpl::reset() {
   _qkv_same_embed_dim = options.kdim() == options.embed_dim() &&
                         options.vdim() == options.embed_dim();
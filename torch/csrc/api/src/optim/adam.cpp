@@ -9,6 +9,7 @@
 
 #include <cmath>
 #include <functional>
+#include <map>
 
 namespace torch {
 namespace optim {
@@ -21,7 +22,8 @@ bool operator==(const AdamOptions& lhs, const AdamOptions& rhs) {
          (std::get<1>(lhs.betas()) == std::get<1>(rhs.betas())) &&
          (lhs.eps() == rhs.eps()) &&
          (lhs.weight_decay() == rhs.weight_decay() &&
-         (lhs.amsgrad() == rhs.amsgrad()));
+         (lhs.amsgrad() == rhs.amsgrad())) &&
+         (lhs.fused() == rhs.fused());
 }
 
 void AdamOptions::serialize(torch::serialize::OutputArchive& archive) const {
@@ -30,6 +32,7 @@ void AdamOptions::serialize(torch::serialize::OutputArchive& archive) const {
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(eps);
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(weight_decay);
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(amsgrad);
+  _TORCH_OPTIM_SERIALIZE_TORCH_ARG(fused);
 }
 
 void AdamOptions::serialize(torch::serialize::InputArchive& archive) {
@@ -38,6 +41,7 @@ void AdamOptions::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, eps);
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, weight_decay);
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(bool, amsgrad);
+  _TORCH_OPTIM_DESERIALIZE_TORCH_ARG_IF_PRESENT(bool, fused);
 }
 
 bool operator==(const AdamParamState& lhs, const AdamParamState& rhs) {
@@ -61,6 +65,17 @@ void AdamParamState::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(Tensor, max_exp_avg_sq);
 }
 
+namespace {
+// Tensors of the parameters in a param group that are at the same step.
+struct AdamBatch {
+  std::vector<Tensor> params;
+  std::vector<Tensor> grads;
+  std::vector<Tensor> exp_avgs;
+  std::vector<Tensor> exp_avg_sqs;
+  std::vector<Tensor> max_exp_avg_sqs;
+};
+} // namespace
+
 Tensor Adam::step(LossClosure closure)  {
   NoGradGuard no_grad;
   Tensor loss = {};
@@ -69,6 +84,10 @@ Tensor Adam::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdamOptions&>(group.options());
+    // Parameters are updated in batches that share a step count (and so the
+    // bias corrections), using multi-tensor (foreach) kernels for the math.
+    std::map<int64_t, AdamBatch> batches;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -76,7 +95,6 @@ Tensor Adam::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "Adam does not support sparse gradients"/*, please consider SparseAdam instead*/);
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<AdamOptions&>(group.options());
 
       // State initialization
       if(param_state == state_.end()) {
@@ -94,37 +112,63 @@ Tensor Adam::step(LossClosure closure)  {
       }
 
       auto& state = static_cast<AdamParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& exp_avg = state.exp_avg();
-      auto& exp_avg_sq = state.exp_avg_sq();
-      auto& max_exp_avg_sq = state.max_exp_avg_sq();
-
       state.step(state.step()+1);
-      auto beta1 = std::get<0>(options.betas());
-      auto beta2 = std::get<1>(options.betas());
 
-      auto bias_correction1 = 1 - std::pow(beta1, state.step());
-      auto bias_correction2 = 1 - std::pow(beta2, state.step());
+      auto& batch = batches[state.step()];
+      batch.params.push_back(p);
+      batch.grads.push_back(grad);
+      batch.exp_avgs.push_back(state.exp_avg());
+      batch.exp_avg_sqs.push_back(state.exp_avg_sq());
+      if(options.amsgrad()) {
+        batch.max_exp_avg_sqs.push_back(state.max_exp_avg_sq());
+      }
+    }
+
+    auto beta1 = std::get<0>(options.betas());
+    auto beta2 = std::get<1>(options.betas());
+    for (auto& step_and_batch : batches) {
+      auto step = step_and_batch.first;
+      auto& batch = step_and_batch.second;
+
+      if(options.fused()) {
+        at::_fused_adam_(
+            batch.params, batch.grads, batch.exp_avgs, batch.exp_avg_sqs,
+            batch.max_exp_avg_sqs, step, options.lr(), beta1, beta2,
+            options.weight_decay(), options.eps(), options.amsgrad(),
+            /*decoupled_weight_decay=*/false);
+        continue;
+      }
 
+      auto bias_correction1 = 1 - std::pow(beta1, step);
+      auto bias_correction2 = 1 - std::pow(beta2, step);
+
+      auto grads = batch.grads;
       if(options.weight_decay() != 0) {
-        grad = grad.add(p, options.weight_decay());
+        grads = at::_foreach_add(grads, batch.params, options.weight_decay());
       }
 
       // Decay the first and second moment running average coefficient
-      exp_avg.mul_(beta1).add_(grad, 1 - beta1);
-      exp_avg_sq.mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+      at::_foreach_mul_(batch.exp_avgs, beta1);
+      at::_foreach_add_(batch.exp_avgs, grads, 1 - beta1);
+      at::_foreach_mul_(batch.exp_avg_sqs, beta2);
+      at::_foreach_addcmul_(batch.exp_avg_sqs, grads, grads, 1 - beta2);
 
-      Tensor denom;
+      std::vector<Tensor> denom;
       if(options.amsgrad()) {
         // Maintains the maximum of all 2nd moment running avg. till now
-        torch::max_out(max_exp_avg_sq, exp_avg_sq, max_exp_avg_sq);
+        for (size_t i = 0; i < batch.max_exp_avg_sqs.size(); i++) {
+          torch::max_out(batch.max_exp_avg_sqs[i], batch.exp_avg_sqs[i], batch.max_exp_avg_sqs[i]);
+        }
         // Use the max. for normalizing running avg. of gradient
-        denom = (max_exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
+        denom = at::_foreach_sqrt(batch.max_exp_avg_sqs);
       } else {
-        denom = (exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
+        denom = at::_foreach_sqrt(batch.exp_avg_sqs);
       }
+      at::_foreach_div_(denom, sqrt(bias_correction2));
+      at::_foreach_add_(denom, options.eps());
 
       auto step_size = options.lr() / bias_correction1;
-      p.addcdiv_(exp_avg, denom, -step_size);
+      at::_foreach_addcdiv_(batch.params, batch.exp_avgs, denom, -step_size);
     }
   }
   return loss;
@@ -71,6 +71,14 @@ Tensor RMSprop::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<RMSpropOptions&>(group.options());
+    // The math for all parameters of the group runs as multi-tensor
+    // (foreach) kernels.
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> square_avgs;
+    std::vector<Tensor> momentum_buffers;
+    std::vector<Tensor> grad_avgs;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -78,7 +86,6 @@ Tensor RMSprop::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "RMSprop does not support sparse gradients");
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<RMSpropOptions&>(group.options());
 
       // State initialization
       if (param_state == state_.end()) {
@@ -95,35 +102,50 @@ Tensor RMSprop::step(LossClosure closure)  {
       }
 
       auto& state = static_cast<RMSpropParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& square_avg = state.square_avg();
-      auto alpha = options.alpha();
-
       state.step(state.step() + 1);
 
-      if (options.weight_decay() != 0) {
-        grad = grad.add(p, options.weight_decay());
+      params.push_back(p);
+      grads.push_back(grad);
+      square_avgs.push_back(state.square_avg());
+      if (options.momentum() > 0) {
+        momentum_buffers.push_back(state.momentum_buffer());
       }
-
-      square_avg.mul_(alpha).addcmul_(grad, grad, 1 - alpha);
-
-      Tensor avg;
       if (options.centered()) {
-        auto& grad_avg = state.grad_avg();
-        grad_avg.mul_(alpha).add_(grad, 1-alpha);
-        avg = square_avg.addcmul(grad_avg, grad_avg, -1).sqrt_().add_(options.eps());
-      } else {
-        avg = square_avg.sqrt().add_(options.eps());
+        grad_avgs.push_back(state.grad_avg());
       }
+    }
+    if (params.empty()) {
+      continue;
+    }
 
-      if (options.momentum() > 0) {
-        auto& buf = state.momentum_buffer();
-        buf.mul_(options.momentum()).addcdiv_(grad, avg);
-        // Need to avoid version tracking for parameter.
-        p.add_(buf, -options.lr());
-      } else {
-        // Need to avoid version tracking for parameter.
-        p.addcdiv_(grad, avg, -options.lr());
-      }
+    auto alpha = options.alpha();
+
+    if (options.weight_decay() != 0) {
+      grads = at::_foreach_add(grads, params, options.weight_decay());
+    }
+
+    at::_foreach_mul_(square_avgs, alpha);
+    at::_foreach_addcmul_(square_avgs, grads, grads, 1 - alpha);
+
+    std::vector<Tensor> avg;
+    if (options.centered()) {
+      at::_foreach_mul_(grad_avgs, alpha);
+      at::_foreach_add_(grad_avgs, grads, 1-alpha);
+      avg = at::_foreach_addcmul(square_avgs, grad_avgs, grad_avgs, -1);
+      at::_foreach_sqrt_(avg);
+    } else {
+      avg = at::_foreach_sqrt(square_avgs);
+    }
+    at::_foreach_add_(avg, options.eps());
+
+    if (options.momentum() > 0) {
+      at::_foreach_mul_(momentum_buffers, options.momentum());
+      at::_foreach_addcdiv_(momentum_buffers, grads, avg);
+      // Need to avoid version tracking for parameter.
+      at::_foreach_add_(params, momentum_buffers, -options.lr());
+    } else {
+      // Need to avoid version tracking for parameter.
+      at::_foreach_addcdiv_(params, grads, avg, -options.lr());
     }
   }
   return loss;
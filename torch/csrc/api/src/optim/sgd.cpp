@@ -21,7 +21,8 @@ bool operator==(const SGDOptions& lhs, const SGDOptions& rhs) {
           (lhs.momentum() == rhs.momentum()) &&
           (lhs.dampening() == rhs.dampening()) &&
           (lhs.weight_decay() == rhs.weight_decay()) &&
-          (lhs.nesterov() == rhs.nesterov());
+          (lhs.nesterov() == rhs.nesterov()) &&
+          (lhs.fused() == rhs.fused());
 }
 
 void SGDOptions::serialize(torch::serialize::OutputArchive& archive) const {
@@ -30,6 +31,7 @@ void SGDOptions::serialize(torch::serialize::OutputArchive& archive) const {
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(dampening);
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(weight_decay);
   _TORCH_OPTIM_SERIALIZE_TORCH_ARG(nesterov);
+  _TORCH_OPTIM_SERIALIZE_TORCH_ARG(fused);
 }
 
 void SGDOptions::serialize(torch::serialize::InputArchive& archive) {
@@ -38,6 +40,7 @@ void SGDOptions::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, dampening);
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(double, weight_decay);
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(bool, nesterov);
+  _TORCH_OPTIM_DESERIALIZE_TORCH_ARG_IF_PRESENT(bool, fused);
 }
 
 bool operator==(const SGDParamState& lhs, const SGDParamState& rhs) {
@@ -52,6 +55,53 @@ void SGDParamState::serialize(torch::serialize::InputArchive& archive) {
   _TORCH_OPTIM_DESERIALIZE_TORCH_ARG(Tensor, momentum_buffer);
 }
 
+void SGD::fused_step(
+    const std::vector<Tensor>& params,
+    const std::vector<Tensor>& params_data,
+    const std::vector<Tensor>& grads,
+    const SGDOptions& options) {
+  auto momentum = options.momentum();
+  if (momentum == 0) {
+    at::_fused_sgd_(
+        params_data, grads, {}, options.lr(), momentum, options.dampening(),
+        options.weight_decay(), options.nesterov(), /*is_first_step=*/false);
+    return;
+  }
+  // Parameters seen for the first time get a fresh buffer that the kernel
+  // initializes to d_p; the others update the buffer they already have.
+  std::vector<Tensor> new_params_data, new_grads, new_bufs;
+  std::vector<Tensor> old_params_data, old_grads, old_bufs;
+  for (size_t i = 0; i < params.size(); i++) {
+    auto key = c10::guts::to_string(params[i].unsafeGetTensorImpl());
+    auto param_state = state_.find(key);
+    if (param_state == state_.end()) {
+      auto buf = torch::zeros_like(params_data[i], MemoryFormat::Preserve);
+      auto state = std::make_unique<SGDParamState>();
+      state->momentum_buffer(buf);
+      state_[key] = std::move(state);
+      new_params_data.push_back(params_data[i]);
+      new_grads.push_back(grads[i]);
+      new_bufs.push_back(buf);
+    } else {
+      old_params_data.push_back(params_data[i]);
+      old_grads.push_back(grads[i]);
+      old_bufs.push_back(static_cast<SGDParamState&>(*param_state->second).momentum_buffer());
+    }
+  }
+  if (!new_params_data.empty()) {
+    at::_fused_sgd_(
+        new_params_data, new_grads, new_bufs, options.lr(), momentum,
+        options.dampening(), options.weight_decay(), options.nesterov(),
+        /*is_first_step=*/true);
+  }
+  if (!old_params_data.empty()) {
+    at::_fused_sgd_(
+        old_params_data, old_grads, old_bufs, options.lr(), momentum,
+        options.dampening(), options.weight_decay(), options.nesterov(),
+        /*is_first_step=*/false);
+  }
+}
+
 Tensor SGD::step(LossClosure closure)  {
   NoGradGuard no_grad;
   Tensor loss = {};
@@ -66,34 +116,64 @@ Tensor SGD::step(LossClosure closure)  {
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
 
+    // The math for all parameters of the group runs as multi-tensor
+    // (foreach) kernels.
+    std::vector<Tensor> params;
+    std::vector<Tensor> params_data;
+    std::vector<Tensor> grads;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
       }
-      auto d_p = p.grad().data();
-      if (weight_decay != 0) {
-        d_p = d_p.add(p.data(), weight_decay);
-      }
-      if (momentum != 0) {
+      params.push_back(p);
+      params_data.push_back(p.data());
+      grads.push_back(p.grad().data());
+    }
+    if (params.empty()) {
+      continue;
+    }
+
+    if (options.fused()) {
+      fused_step(params, params_data, grads, options);
+      continue;
+    }
+
+    auto d_ps = grads;
+    if (weight_decay != 0) {
+      d_ps = at::_foreach_add(grads, params_data, weight_decay);
+    }
+    if (momentum != 0) {
+      std::vector<Tensor> bufs;
+      // Buffers that existed before this step, and the matching d_p.
+      std::vector<Tensor> old_bufs;
+      std::vector<Tensor> old_bufs_d_ps;
+      for (size_t i = 0; i < params.size(); i++) {
+        auto& p = params[i];
         Tensor buf;
         auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
         if(param_state == state_.end()) {
-          buf = torch::clone(d_p).detach();
+          buf = torch::clone(d_ps[i]).detach();
           auto state = std::make_unique<SGDParamState>();
           state->momentum_buffer(buf);
           state_[c10::guts::to_string(p.unsafeGetTensorImpl())] = std::move(state);
         } else {
           buf = static_cast<SGDParamState&>(*param_state->second).momentum_buffer();
-          buf.mul_(momentum).add_(d_p, 1 - dampening);
-        }
-        if (nesterov) {
-          d_p = d_p.add(buf, momentum);
-        } else {
-          d_p = buf;
+          old_bufs.push_back(buf);
+          old_bufs_d_ps.push_back(d_ps[i]);
         }
+        bufs.push_back(buf);
+      }
+      if (!old_bufs.empty()) {
+        at::_foreach_mul_(old_bufs, momentum);
+        at::_foreach_add_(old_bufs, old_bufs_d_ps, 1 - dampening);
+      }
+      if (nesterov) {
+        d_ps = at::_foreach_add(d_ps, bufs, momentum);
+      } else {
+        d_ps = bufs;
       }
-      p.data().add_(d_p, -1 * options.lr());
     }
+    at::_foreach_add_(params_data, d_ps, -1 * options.lr());
   }
   return loss;
 }
@@ -6,8 +6,10 @@
 
 namespace torch {
 
-std::vector<char> pickle_save(const at::IValue& ivalue) {
-  return jit::pickle_save(ivalue);
+std::vector<char> pickle_save(
+    const at::IValue& ivalue,
+    size_t pack_storages_below) {
+  return jit::pickle_save(ivalue, pack_storages_below);
 }
 
 torch::IValue pickle_load(const std::vector<char>& data) {
@@ -6,6 +6,7 @@
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/utils/hash.h>
 #include <torch/csrc/utils/memory.h>
 
 #include <ATen/DeviceGuard.h>
@@ -97,6 +98,10 @@ static thread_local std::shared_ptr<GraphTask> current_graph_task = nullptr;
 // see Note [Reentrant backwards] for more details.
 static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 
+// True for the threads of the CPU worker pool.
+// See Note [Multithreaded CPU backward]
+static thread_local bool is_cpu_worker = false;
+
 // Note [Reentrant backwards]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // To understand the reentrant backwards problem, we have to notice two
@@ -127,6 +132,45 @@ static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 // When the GraphTask is finished, the parent worker thread that is waiting on
 // the task is notified and the current thread returns to the pool.
 
+// Note [Multithreaded CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default all the CPU work of a backward call runs on the thread that
+// called it. With Engine::set_num_cpu_workers(n), n threads from a pool of
+// CPU workers join the calling thread and pop tasks from the same
+// cpu_ready_queue_, so independent branches of the graph run concurrently.
+// Nothing else changes: dependencies_ and not_ready_ are already guarded by
+// the GraphTask mutex, and every thread evaluates a ready task in the same way.
+//
+// Any of these threads may be sleeping on the queue when the GraphTask
+// completes, so the thread that completes it pushes one dummy task for each
+// of them. Dummy tasks left over in the queue are no-ops, as they are when a
+// device thread completes a GraphTask. A reentrant backward that shares the
+// queue inherits cpu_workers_ from the GraphTask that started it, since the
+// workers may pick up and complete its tasks too.
+
+// Note [Backward plans]
+// ~~~~~~~~~~~~~~~~~~~~~~
+// Training loops usually build a graph with the same structure in every
+// iteration, but the engine rediscovers its dependencies, allocates its input
+// buffers and schedules its tasks through the ready queue every time. With
+// Engine::set_backward_plan_cache_enabled(true) the engine records, once per
+// graph structure, an order to run the nodes in and where each output goes,
+// and replays it on the calling thread for later graphs with the same
+// structure.
+//
+// The structure of a graph is its signature: for each node in breadth-first
+// order from the GraphRoot, the number of inputs of the node, its number of
+// outputs and, for each output, the position of the next node in that order
+// and the input_nr of the edge. Two graphs with the same signature have the
+// same dependencies, so the order recorded for one is valid for the other.
+// The order is the one the ready queue would produce, i.e. ready nodes with
+// the largest sequence_nr first.
+//
+// Plans only cover what the ready queue does on a single CPU thread: they are
+// used for backward() (not grad(), which needs exec_info_) on graphs whose
+// inputs are all on CPU, outside of reentrant backwards, anomaly mode and
+// the CPU worker pool. Everything else runs as before.
+
 // Note [Streaming backwards]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // On CUDA devices the autograd engine's device operations are run on the
@@ -211,7 +255,11 @@ bool ReadyQueue::empty() const {
   return heap_.empty();
 }
 
-Engine::Engine() : max_recursion_depth_(MAX_DEPTH), non_reentrant_device_thread_count_(0) {}
+Engine::Engine()
+    : max_recursion_depth_(MAX_DEPTH),
+      num_cpu_workers_(0),
+      backward_plan_cache_enabled_(false),
+      non_reentrant_device_thread_count_(0) {}
 
 // Send shutdown tasks to all device_ready_queues_ if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest priority
@@ -398,7 +446,17 @@ auto Engine::thread_main(const std::shared_ptr<GraphTask>& graph_task) -> void {
       // before it gets to the task, but it's a no-op anyway.
       //
       // NB: This is not necessary if the current thread is the owning thread.
-      if (worker_device != base_owner) {
+      if (local_graph_task->cpu_workers_ > 0) {
+        // The owning thread and all CPU workers share cpu_ready_queue_.
+        // See Note [Multithreaded CPU backward]
+        if (!local_graph_task->cpu_workers_notified_.exchange(true)) {
+          std::atomic_thread_fence(std::memory_order_release);
+          for (int i = 0; i <= local_graph_task->cpu_workers_; ++i) {
+            local_graph_task->cpu_ready_queue_->push(
+                NodeTask(local_graph_task, nullptr, InputBuffer(0)));
+          }
+        }
+      } else if (worker_device != base_owner || is_cpu_worker) {
         // Synchronize outstanding_tasks_ with queue mutex
         std::atomic_thread_fence(std::memory_order_release);
         ready_queue_by_index(local_graph_task->cpu_ready_queue_, base_owner)
@@ -437,6 +495,34 @@ void Engine::reentrant_thread_init() {
   }
 }
 
+// CPU workers run the CPU tasks of a GraphTask on its owner's ready queue
+// until the GraphTask completes. See Note [Multithreaded CPU backward]
+void Engine::cpu_worker_thread_init() {
+  at::init_num_threads();
+  is_cpu_worker = true;
+  auto pool = cpu_worker_pool_shared_;
+  while(true) {
+    std::unique_lock<std::mutex> lk(pool->mutex_);
+    ++pool->num_workers_;
+    pool->work_.wait(lk, [&pool]{ return !pool->graphtasks_queue_.empty();});
+    --pool->num_workers_;
+    auto task = pool->graphtasks_queue_.front();
+    pool->graphtasks_queue_.pop();
+    lk.unlock();
+    std::shared_ptr<GraphTask> graph_task;
+    if (!(graph_task = task.lock())) {
+      continue;
+    }
+    set_device(CPU_DEVICE);
+    local_ready_queue = graph_task->cpu_ready_queue_;
+    total_depth = graph_task->reentrant_depth_;
+    thread_main(graph_task);
+    // Don't keep the owner's ready queue alive while waiting for more work.
+    local_ready_queue = nullptr;
+    worker_device = NO_DEVICE;
+  }
+}
+
 void Engine::thread_on_exception(
     std::shared_ptr<GraphTask> graph_task,
     const std::shared_ptr<Node>& fn,
@@ -840,6 +926,184 @@ auto Engine::compute_dependencies(Node* root, GraphTask& task) -> void {
   }
 }
 
+struct BackwardPlan {
+  // See Note [Backward plans]
+  std::vector<uint64_t> signature;
+  // Number of inputs of each node, by position.
+  std::vector<uint32_t> num_inputs;
+  // The outputs of the node at position i go to edges[edge_offsets[i]]
+  // to edges[edge_offsets[i + 1] - 1], as (position of the next node or -1
+  // for an invalid edge, input_nr).
+  std::vector<size_t> edge_offsets;
+  std::vector<std::pair<int64_t, uint32_t>> edges;
+  // Positions of the nodes in the order they run.
+  std::vector<uint32_t> order;
+};
+
+// Maximum number of recorded backward plans. The cache is cleared when it is
+// full, which only happens if the graph structure keeps changing.
+static constexpr size_t MAX_BACKWARD_PLANS = 64;
+
+// Collects the nodes of the graph in breadth-first order and its signature.
+// Returns false if the graph can't be run from a plan.
+static bool discover_graph(
+    Node* graph_root,
+    std::vector<Node*>& nodes,
+    std::vector<uint64_t>& signature) {
+  std::unordered_map<Node*, uint64_t> positions;
+  nodes.push_back(graph_root);
+  positions.emplace(graph_root, 0);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    Node* fn = nodes[i];
+    const auto num_inputs = fn->num_inputs();
+    for (uint32_t j = 0; j < num_inputs; ++j) {
+      if (fn->input_metadata(j).device().type() != at::kCPU) {
+        return false;
+      }
+    }
+    signature.push_back(num_inputs);
+    signature.push_back(fn->num_outputs());
+    for (const auto& edge : fn->next_edges()) {
+      uint64_t position = 0;
+      if (auto next_ptr = edge.function.get()) {
+        auto it = positions.emplace(next_ptr, nodes.size());
+        if (it.second) {
+          nodes.push_back(next_ptr);
+        }
+        position = it.first->second + 1;
+      }
+      signature.push_back(position);
+      signature.push_back(edge.input_nr);
+    }
+  }
+  return true;
+}
+
+static std::shared_ptr<BackwardPlan> make_backward_plan(
+    const std::vector<Node*>& nodes,
+    std::vector<uint64_t> signature) {
+  auto plan = std::make_shared<BackwardPlan>();
+  const auto num_nodes = nodes.size();
+  std::vector<uint32_t> dependencies(num_nodes, 0);
+  size_t pos = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    plan->num_inputs.push_back(signature[pos++]);
+    const auto num_outputs = signature[pos++];
+    plan->edge_offsets.push_back(plan->edges.size());
+    for (uint64_t j = 0; j < num_outputs; ++j) {
+      const int64_t next = static_cast<int64_t>(signature[pos++]) - 1;
+      const uint32_t input_nr = signature[pos++];
+      plan->edges.emplace_back(next, input_nr);
+      if (next >= 0) {
+        ++dependencies[next];
+      }
+    }
+  }
+  plan->edge_offsets.push_back(plan->edges.size());
+  plan->signature = std::move(signature);
+
+  // Same priority as ReadyQueue: the largest sequence_nr runs first.
+  auto compare = [&nodes](uint32_t a, uint32_t b) {
+    return nodes[a]->sequence_nr() < nodes[b]->sequence_nr();
+  };
+  std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(compare)>
+      ready(compare);
+  ready.push(0);
+  plan->order.reserve(num_nodes);
+  while (!ready.empty()) {
+    const auto i = ready.top();
+    ready.pop();
+    plan->order.push_back(i);
+    for (size_t e = plan->edge_offsets[i]; e < plan->edge_offsets[i + 1]; ++e) {
+      const auto next = plan->edges[e].first;
+      if (next >= 0 && --dependencies[next] == 0) {
+        ready.push(next);
+      }
+    }
+  }
+  TORCH_INTERNAL_ASSERT(plan->order.size() == num_nodes);
+  return plan;
+}
+
+std::shared_ptr<BackwardPlan> Engine::get_backward_plan(
+    const std::vector<Node*>& nodes,
+    std::vector<uint64_t> signature) {
+  const auto key = torch::hash<std::vector<uint64_t>>()(signature);
+  std::lock_guard<std::mutex> lock(backward_plans_mutex_);
+  auto it = backward_plans_.find(key);
+  if (it != backward_plans_.end() && it->second->signature == signature) {
+    return it->second;
+  }
+  if (backward_plans_.size() >= MAX_BACKWARD_PLANS) {
+    backward_plans_.clear();
+  }
+  auto plan = make_backward_plan(nodes, std::move(signature));
+  backward_plans_[key] = plan;
+  return plan;
+}
+
+// Does what thread_main and evaluate_function do for the graph, in the order
+// recorded in the plan. See Note [Backward plans]
+variable_list Engine::execute_backward_plan(
+    const std::shared_ptr<GraphTask>& graph_task,
+    const std::vector<Node*>& nodes,
+    const BackwardPlan& plan) {
+  initialize_device_threads_pool();
+  // Reentrant backwards from the nodes run as they would from thread_main.
+  set_device(CPU_DEVICE);
+  graph_task->owner_ = worker_device;
+
+  std::vector<InputBuffer> buffers;
+  buffers.reserve(nodes.size());
+  for (const auto num_inputs : plan.num_inputs) {
+    buffers.emplace_back(num_inputs);
+  }
+
+  auto local_graph_task = graph_task;
+  {
+    AutoGradMode grad_mode(graph_task->grad_mode_);
+    GraphTaskGuard guard(graph_task);
+    for (const auto i : plan.order) {
+      Node* fn = nodes[i];
+      try {
+        auto outputs = call_function(local_graph_task, fn, buffers[i]);
+        if (!graph_task->keep_graph_) {
+          fn->release_variables();
+        }
+        const auto first_edge = plan.edge_offsets[i];
+        for (size_t j = 0; j < outputs.size(); ++j) {
+          const auto& edge = plan.edges[first_edge + j];
+          if (edge.first >= 0) {
+            buffers[edge.first].add(
+                edge.second, std::move(outputs[j]), c10::nullopt, c10::nullopt);
+          }
+        }
+      } catch (std::exception& e) {
+        thread_on_exception(graph_task, fn->shared_from_this(), e);
+        break;
+      }
+    }
+  }
+
+  if (!graph_task->has_error_.load()) {
+    graph_task->mark_as_completed_and_run_post_processing();
+  }
+  worker_device = NO_DEVICE;
+  return graph_task->future_result_->wait();
+}
+
+void Engine::set_backward_plan_cache_enabled(bool enabled) {
+  backward_plan_cache_enabled_.store(enabled);
+  if (!enabled) {
+    std::lock_guard<std::mutex> lock(backward_plans_mutex_);
+    backward_plans_.clear();
+  }
+}
+
+bool Engine::is_backward_plan_cache_enabled() const {
+  return backward_plan_cache_enabled_.load();
+}
+
 auto Engine::execute(const edge_list& roots,
                      const variable_list& inputs,
                      bool keep_graph,
@@ -863,8 +1127,21 @@ auto Engine::execute(const edge_list& roots,
       /* depth */ not_reentrant_backward_call ? 0 : total_depth + 1,
       /* cpu_ready_queue */ local_ready_queue);
 
-  // Now compute the dependencies for all executable functions and queue the root
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
+
+  // See Note [Backward plans]
+  if (backward_plan_cache_enabled_.load() && outputs.empty() &&
+      not_reentrant_backward_call && num_cpu_workers_.load() == 0 &&
+      !AnomalyMode::is_enabled()) {
+    std::vector<Node*> nodes;
+    std::vector<uint64_t> signature;
+    if (discover_graph(graph_root.get(), nodes, signature)) {
+      auto plan = get_backward_plan(nodes, std::move(signature));
+      return execute_backward_plan(graph_task, nodes, *plan);
+    }
+  }
+
+  // Now compute the dependencies for all executable functions and queue the root
   compute_dependencies(graph_root.get(), *graph_task);
 
   if (!outputs.empty()) {
@@ -902,10 +1179,14 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
 
     // set the graph_task owner to the current device
     graph_task->owner_ = worker_device;
+    graph_task->cpu_workers_ = num_cpu_workers_.load();
 
     // The owning thread start to drive the engine execution with the GraphTask
     // that has already been pushed to the current CPU thread's ready_queue
     lock.unlock();
+    if (graph_task->cpu_workers_ > 0) {
+      add_cpu_worker_tasks(graph_task, graph_task->cpu_workers_);
+    }
     thread_main(graph_task);
     TORCH_INTERNAL_ASSERT(graph_task->future_result_->completed());
     // reset the worker_device after the completion of the graph_task, this is so
@@ -917,6 +1198,11 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
     // If worker_device is any devices (i.e. CPU, CUDA): this is a re-entrant
     //    backward call from that device.
     graph_task->owner_ = worker_device;
+    // See Note [Multithreaded CPU backward]
+    if (current_graph_task &&
+        current_graph_task->cpu_ready_queue_ == graph_task->cpu_ready_queue_) {
+      graph_task->cpu_workers_ = current_graph_task->cpu_workers_;
+    }
     if (current_depth >= max_recursion_depth_) {
       // See Note [Reentrant backwards]
       // If reached the max depth, switch to a different thread
@@ -1042,6 +1328,7 @@ auto Engine::start_device_threads() -> void {
   }
 
   thread_pool_shared_ = std::make_shared<ThreadPoolShared>();
+  cpu_worker_pool_shared_ = std::make_shared<ThreadPoolShared>();
 
   for (int i = 0; i < num_devices; ++i) {
     std::thread t(&Engine::thread_init, this, i, device_ready_queues_[i], true);
@@ -1074,6 +1361,40 @@ void Engine::add_thread_pool_task(const std::weak_ptr<GraphTask>& graph_task) {
   thread_pool_shared_->work_.notify_one();
 }
 
+void Engine::add_cpu_worker_tasks(
+    const std::shared_ptr<GraphTask>& graph_task,
+    int num_workers) {
+  std::unique_lock<std::mutex> lck(cpu_worker_pool_shared_->mutex_);
+  int threads_to_create = 0;
+  for (int i = 0; i < num_workers; ++i) {
+    // Same as in add_thread_pool_task: start a thread unless an idle one
+    // will get to the task.
+    if (cpu_worker_pool_shared_->num_workers_ + threads_to_create <=
+        cpu_worker_pool_shared_->graphtasks_queue_.size()) {
+      ++threads_to_create;
+    }
+    cpu_worker_pool_shared_->graphtasks_queue_.push(graph_task);
+  }
+  lck.unlock();
+  for (int i = 0; i < threads_to_create; ++i) {
+    std::thread t(&Engine::cpu_worker_thread_init, this);
+    t.detach();
+  }
+  cpu_worker_pool_shared_->work_.notify_all();
+}
+
+void Engine::set_num_cpu_workers(int num_workers) {
+  TORCH_CHECK(
+      num_workers >= 0,
+      "Number of autograd CPU workers must not be negative, but got ",
+      num_workers);
+  num_cpu_workers_.store(num_workers);
+}
+
+int Engine::num_cpu_workers() const {
+  return num_cpu_workers_.load();
+}
+
 void GraphTask::init_to_execute(Node& graph_root, const edge_list& outputs) {
   exec_info_[&graph_root].needed_ = true;
 
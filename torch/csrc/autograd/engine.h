@@ -23,6 +23,7 @@
 #include <thread>
 
 namespace torch { namespace autograd {
+struct BackwardPlan;
 struct ReadyQueue;
 }} // namespace torch::autograd
 
@@ -120,6 +121,13 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // The number of parent graph tasks for this graph task
   const int reentrant_depth_;
 
+  // The number of CPU worker threads that pop tasks from cpu_ready_queue_
+  // alongside the owning thread, see Note [Multithreaded CPU backward].
+  // Safe to read without synchronization once the task is executing.
+  int cpu_workers_;
+  // Set by the thread that wakes up the CPU workers once the task completes.
+  std::atomic_bool cpu_workers_notified_{false};
+
   bool can_checkpoint() {
     return exec_info_.empty();
   }
@@ -171,6 +179,7 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
         grad_mode_(grad_mode),
         owner_(NO_DEVICE),
         reentrant_depth_(reentrant_depth),
+        cpu_workers_(0),
         exit_on_error_(exit_on_error),
         cpu_ready_queue_(std::move(cpu_ready_queue)),
         future_result_(std::make_shared<FutureVariableList>()) {}
@@ -312,6 +321,18 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Sets the number of worker threads that run ready CPU tasks of a backward
+  // call alongside the thread that called it. 0, the default, runs all CPU
+  // work on the calling thread. See Note [Multithreaded CPU backward]
+  void set_num_cpu_workers(int num_workers);
+  int num_cpu_workers() const;
+
+  // When enabled, backward() calls on CPU graphs run from a plan that is
+  // recorded once per graph structure and replayed whenever a graph with the
+  // same structure is seen again. See Note [Backward plans]
+  void set_backward_plan_cache_enabled(bool enabled);
+  bool is_backward_plan_cache_enabled() const;
+
   // Initializes a device thread for the autograd engine.
   virtual void thread_init(
       int device,
@@ -341,6 +362,17 @@ struct TORCH_API Engine {
   virtual void thread_main(const std::shared_ptr<GraphTask>& task);
   void reentrant_thread_init();
   void add_thread_pool_task(const std::weak_ptr<GraphTask>& graph_task);
+  void cpu_worker_thread_init();
+  void add_cpu_worker_tasks(
+      const std::shared_ptr<GraphTask>& graph_task,
+      int num_workers);
+  std::shared_ptr<BackwardPlan> get_backward_plan(
+      const std::vector<Node*>& nodes,
+      std::vector<uint64_t> signature);
+  variable_list execute_backward_plan(
+      const std::shared_ptr<GraphTask>& graph_task,
+      const std::vector<Node*>& nodes,
+      const BackwardPlan& plan);
 
   // Ensures device_ready_queues_ are initialized only once
   std::once_flag start_device_threads_flag_;
@@ -377,6 +409,18 @@ struct TORCH_API Engine {
  // for the graphtasks_queue_ to be nonempty.
  std::shared_ptr<ThreadPoolShared> thread_pool_shared_;
 
+ // Same as ThreadPoolShared, for the threads that help run the CPU work of
+ // backward calls. See Note [Multithreaded CPU backward]
+ std::shared_ptr<ThreadPoolShared> cpu_worker_pool_shared_;
+ std::atomic<int> num_cpu_workers_;
+
+ // Recorded backward plans, keyed by the hash of their graph signature.
+ // See Note [Backward plans]
+ std::atomic<bool> backward_plan_cache_enabled_;
+ std::unordered_map<size_t, std::shared_ptr<BackwardPlan>> backward_plans_;
+ // To protect reads and writes to backward_plans_
+ std::mutex backward_plans_mutex_;
+
 private:
   // Number of non-reentrant threads
   std::atomic<uint32_t> non_reentrant_device_thread_count_;
@@ -45,6 +45,13 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
 
   at::Tensor& grad = variable.mutable_grad();
 
+  if (accumulate_in_place && grad.defined() && !grad.is_sparse() &&
+      !new_grad.is_sparse() && !grad.requires_grad() &&
+      !new_grad.requires_grad()) {
+    grad += new_grad;
+    return variable_list();
+  }
+
   // If the function has post hooks (for example, a DDP allreduce hook),
   // call_function in Engine.cpp will temporarily bump the expected refcount
   // by one, hence the addition of !post_hooks().empty() for 'num_expected_refs'
@@ -5,6 +5,7 @@
 #include <torch/csrc/autograd/utils/grad_layout_contract.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <atomic>
 #include <mutex>
 
 namespace torch { namespace autograd {
@@ -207,6 +208,13 @@ struct TORCH_API AccumulateGrad : public Node {
   }
 
   Variable variable;
+
+  // If set, a dense grad that is already defined is accumulated in place even
+  // when setting up for double backward, as long as neither it nor new_grad
+  // requires grad (so the out-of-place sum wouldn't be differentiable
+  // either). This keeps .grad on the same storage across backward passes,
+  // e.g. when it was preallocated once or is a view into a DDP bucket.
+  std::atomic<bool> accumulate_in_place{false};
 };
 
 #undef CHECK_RESULT
@@ -87,9 +87,32 @@ static PyObject* accumulateGradVar(PyObject *_self, void* _unused)
   return THPVariable_Wrap(grad_acc->variable);
 }
 
+static PyObject* accumulateGradInPlace(PyObject *_self, void* _unused)
+{
+  THPCppFunction* self = (THPCppFunction*)_self;
+  auto grad_acc = (AccumulateGrad*)self->cdata.get();
+  if (grad_acc->accumulate_in_place) {
+    Py_RETURN_TRUE;
+  }
+  Py_RETURN_FALSE;
+}
+
+static int accumulateGradSetInPlace(PyObject *_self, PyObject *value, void* _unused)
+{
+  HANDLE_TH_ERRORS
+  TORCH_CHECK_TYPE(
+      value && PyBool_Check(value), "accumulate_in_place must be a bool");
+  THPCppFunction* self = (THPCppFunction*)_self;
+  auto grad_acc = (AccumulateGrad*)self->cdata.get();
+  grad_acc->accumulate_in_place = value == Py_True;
+  return 0;
+  END_HANDLE_TH_ERRORS_RET(-1)
+}
+
 static struct PyGetSetDef accumulate_grad_properties[] = {
   THP_FUNCTION_DEFAULT_PROPERTIES,
   {(char*)"variable", accumulateGradVar, nullptr, nullptr, nullptr},
+  {(char*)"accumulate_in_place", accumulateGradInPlace, accumulateGradSetInPlace, nullptr, nullptr},
   {nullptr}
 };
 
@@ -4,10 +4,17 @@
 #include <torch/csrc/utils/pybind.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <ATen/autocast_mode.h>
+#include <c10/core/InferenceMode.h>
+#include <torch/csrc/autograd/operator_stats.h>
 #include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/sampling_profiler.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+#include <torch/csrc/Dtype.h>
 #include <torch/csrc/autograd/function.h>
 
+#include <fstream>
+
 PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   using namespace torch::autograd::profiler;
   auto tensor_module = THPObjectPtr(PyImport_ImportModule("torch.tensor"));
@@ -37,7 +44,8 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("NVTX", ProfilerState::NVTX);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool, bool>());
+      .def(py::init<ProfilerState, bool, bool>())
+      .def(py::init<ProfilerState, bool, bool, bool>());
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -53,11 +61,37 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("handle", &Event::handle)
       .def("node_id", &Event::node_id)
       .def("is_remote", &Event::isRemote)
-      .def("sequence_nr", &Event::sequence_nr);
+      .def("sequence_nr", &Event::sequence_nr)
+      // The values of HwCounter, in order, or None when the counters weren't
+      // recorded
+      .def("hw_counters", [](const Event& e) -> c10::optional<std::vector<int64_t>> {
+        if (!e.has_hw_counters()) {
+          return c10::nullopt;
+        }
+        return std::vector<int64_t>(
+            e.hw_counters().begin(), e.hw_counters().end());
+      });
 
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
   m.def("_profiler_enabled", profilerEnabled);
+  m.def("_enable_sampling_profiler", enableSamplingProfiler);
+  m.def("_disable_sampling_profiler", disableSamplingProfiler);
+  m.def("_sampling_profiler_enabled", samplingProfilerEnabled);
+  m.def("_export_sampled_chrome_trace", [](const std::string& path) {
+    std::ofstream out(path);
+    writeSampledRangesToChromeTrace(out);
+  });
+  py::class_<OperatorStats>(m, "OperatorStats")
+      .def_readonly("count", &OperatorStats::count)
+      .def_readonly("total_time_ns", &OperatorStats::total_time_ns)
+      .def_readonly("input_bytes", &OperatorStats::input_bytes);
+
+  m.def("_enable_operator_stats", enableOperatorStats);
+  m.def("_disable_operator_stats", disableOperatorStats);
+  m.def("_operator_stats_enabled", operatorStatsEnabled);
+  m.def("_get_operator_stats", getOperatorStats);
+  m.def("_export_operator_stats", exportOperatorStats);
   m.def("_enable_record_function", [](bool enable) {
     at::enableRecordFunction(enable);
   });
@@ -77,6 +111,27 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
     at::clearCallbacks();
   });
 
+  m.def("_push_saved_tensors_hooks", [](py::function pack_hook, py::function unpack_hook) {
+    torch::autograd::push_saved_variable_hooks(
+        torch::autograd::make_py_saved_variable_hooks(std::move(pack_hook), std::move(unpack_hook)));
+  });
+  m.def("_push_saved_tensors_offload_hooks", [](int64_t prefetch) {
+    torch::autograd::push_saved_variable_hooks(
+        torch::autograd::make_offload_saved_variable_hooks(prefetch));
+  });
+  m.def("_push_saved_tensors_compression_hooks", [](py::object dtype) {
+    TORCH_CHECK_TYPE(THPDtype_Check(dtype.ptr()), "dtype must be a torch.dtype, but got ",
+        THPUtils_typename(dtype.ptr()));
+    torch::autograd::push_saved_variable_hooks(
+        torch::autograd::make_compressed_saved_variable_hooks(
+            reinterpret_cast<THPDtype*>(dtype.ptr())->scalar_type));
+  });
+  m.def("_pop_saved_tensors_hooks", &torch::autograd::pop_saved_variable_hooks);
+
+  py::class_<c10::InferenceMode>(m, "_InferenceMode")
+      .def(py::init<bool>());
+  m.def("_is_inference_mode_enabled", &c10::InferenceMode::is_enabled);
+
   Py_RETURN_TRUE;
 }
 
@@ -102,6 +157,46 @@ static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cpu_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cpu_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autocast_cache_persistent(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("persistent must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cache_persistent(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cache_persistent(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cache_persistent()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   at::autocast::clear_cache();
@@ -167,6 +262,10 @@ static PyMethodDef methods[] = { // NOLINT
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
   {"set_autocast_enabled", (PyCFunction)set_autocast_enabled, METH_O, nullptr},
   {"is_autocast_enabled", (PyCFunction)is_autocast_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cpu_enabled", (PyCFunction)set_autocast_cpu_enabled, METH_O, nullptr},
+  {"is_autocast_cpu_enabled", (PyCFunction)is_autocast_cpu_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cache_persistent", (PyCFunction)set_autocast_cache_persistent, METH_O, nullptr},
+  {"is_autocast_cache_persistent", (PyCFunction)is_autocast_cache_persistent, METH_NOARGS, nullptr},
   {"clear_autocast_cache", (PyCFunction)clear_autocast_cache, METH_NOARGS, nullptr},
   {"autocast_increment_nesting", (PyCFunction)autocast_increment_nesting, METH_NOARGS, nullptr},
   {"autocast_decrement_nesting", (PyCFunction)autocast_decrement_nesting, METH_NOARGS, nullptr},
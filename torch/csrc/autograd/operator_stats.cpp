@@ -0,0 +1,191 @@
+#include <torch/csrc/autograd/operator_stats.h>
+
+#include <ATen/record_function.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+constexpr size_t kMergeIntervalCalls = 1024;
+constexpr int64_t kMergeIntervalNs = 100 * 1000 * 1000;
+// Number of recorded ranges that can be open on a thread. Past it, the
+// outermost one is dropped (it may be an async range that ended elsewhere).
+constexpr size_t kMaxDepth = 128;
+
+struct OperatorStatsState {
+  std::mutex mutex;
+  bool enabled = false;
+  at::CallbackHandle callback_handle = 0;
+  std::unordered_map<std::string, OperatorStats> stats;
+};
+
+OperatorStatsState& state() {
+  static OperatorStatsState state_;
+  return state_;
+}
+
+// Bumped by every enable so that threads drop the stats of earlier runs.
+std::atomic<uint64_t> generation{0};
+
+struct ThreadStats {
+  ~ThreadStats() {
+    merge();
+  }
+
+  void merge() {
+    if (num_pending == 0) {
+      return;
+    }
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    if (generation.load(std::memory_order_relaxed) == stats_generation) {
+      for (auto& kv : stats) {
+        if (kv.second.count == 0) {
+          continue;
+        }
+        auto& merged = s.stats[kv.first];
+        merged.count += kv.second.count;
+        merged.total_time_ns += kv.second.total_time_ns;
+        merged.input_bytes += kv.second.input_bytes;
+        // Keep the entry so that the next calls don't allocate
+        kv.second = OperatorStats();
+      }
+    }
+    num_pending = 0;
+  }
+
+  uint64_t stats_generation = 0;
+  std::unordered_map<std::string, OperatorStats> stats;
+  size_t num_pending = 0;
+  int64_t last_merge_ns = 0;
+  // (handle, start_ns) of the recorded ranges that are still open.
+  std::vector<std::pair<at::RecordFunctionHandle, int64_t>> open_ranges;
+  // Reused to build the keys without allocating.
+  std::string key;
+};
+
+thread_local ThreadStats thread_stats;
+
+int64_t inputBytes(const at::RecordFunction& fn) {
+  int64_t bytes = 0;
+  for (const auto& input : fn.inputs()) {
+    if (input.isTensor()) {
+      const auto& t = input.toTensor();
+      if (t.defined()) {
+        bytes += t.numel() * t.element_size();
+      }
+    } else if (input.isTensorList()) {
+      for (const at::Tensor& t : input.toTensorVector()) {
+        if (t.defined()) {
+          bytes += t.numel() * t.element_size();
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
+void onOpStart(const at::RecordFunction& fn) {
+  auto& ts = thread_stats;
+  if (ts.open_ranges.size() >= kMaxDepth) {
+    ts.open_ranges.erase(ts.open_ranges.begin());
+  }
+  ts.open_ranges.emplace_back(fn.handle(), getTime());
+}
+
+void onOpEnd(const at::RecordFunction& fn) {
+  const auto end_ns = getTime();
+  auto& ts = thread_stats;
+  auto it = std::find_if(
+      ts.open_ranges.rbegin(),
+      ts.open_ranges.rend(),
+      [&](const std::pair<at::RecordFunctionHandle, int64_t>& range) {
+        return range.first == fn.handle();
+      });
+  if (it == ts.open_ranges.rend()) {
+    return;
+  }
+  const auto start_ns = it->second;
+  ts.open_ranges.erase(std::next(it).base());
+
+  const auto current = generation.load(std::memory_order_acquire);
+  if (ts.stats_generation != current) {
+    ts.stats.clear();
+    ts.num_pending = 0;
+    ts.stats_generation = current;
+    ts.last_merge_ns = end_ns;
+  }
+  ts.key.assign(fn.name().str());
+  ts.key += '/';
+  ts.key += c10::toString(fn.dispatchKey());
+  auto& stats = ts.stats[ts.key];
+  stats.count++;
+  stats.total_time_ns += end_ns - start_ns;
+  if (!fn.inputs().empty()) {
+    stats.input_bytes += inputBytes(fn);
+  }
+  if (++ts.num_pending >= kMergeIntervalCalls ||
+      end_ns - ts.last_merge_ns >= kMergeIntervalNs) {
+    ts.merge();
+    ts.last_merge_ns = end_ns;
+  }
+}
+
+} // namespace
+
+void enableOperatorStats(bool record_input_bytes) {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  TORCH_CHECK(!s.enabled, "Operator stats are already enabled");
+  s.stats.clear();
+  generation++;
+  s.callback_handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(onOpStart, onOpEnd)
+          .needsIds(true)
+          .needsInputs(record_input_bytes)
+          .scopes({at::RecordScope::FUNCTION}));
+  s.enabled = true;
+}
+
+void disableOperatorStats() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  TORCH_CHECK(s.enabled, "Operator stats are not enabled");
+  at::removeCallback(s.callback_handle);
+  s.enabled = false;
+}
+
+bool operatorStatsEnabled() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  return s.enabled;
+}
+
+std::unordered_map<std::string, OperatorStats> getOperatorStats() {
+  thread_stats.merge();
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  return s.stats;
+}
+
+std::unordered_map<std::string, int64_t> exportOperatorStats(
+    const std::string& prefix) {
+  std::unordered_map<std::string, int64_t> exported;
+  for (const auto& kv : getOperatorStats()) {
+    const auto key = prefix + "/" + kv.first;
+    exported[key + "/count"] = kv.second.count;
+    exported[key + "/time_ns"] = kv.second.total_time_ns;
+    exported[key + "/input_bytes"] = kv.second.input_bytes;
+  }
+  return exported;
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Aggregated per-operator counters, cheap enough to be left on in production.
+//
+// A global RecordFunction callback counts the op calls, their time and
+// optionally the bytes of their tensor inputs, per op name and dispatch key.
+// Every thread aggregates its calls in a thread local table, merged into the
+// global one every 1024 calls or 100ms, and when the thread exits, so the
+// global table may miss the last calls of the other threads. Recording never
+// takes a lock between merges.
+//
+// Times are inclusive: an op that calls other ops counts their time too. Ops
+// that end on another thread than the one they started on (async ops) are not
+// recorded. The outputs of the ops aren't visible to RecordFunction callbacks,
+// so only the input bytes are counted.
+
+struct TORCH_API OperatorStats {
+  int64_t count = 0;
+  int64_t total_time_ns = 0;
+  // Only counted when enabled with record_input_bytes
+  int64_t input_bytes = 0;
+};
+
+// Starts recording the ops, discarding the stats of an earlier run. Counting
+// the input bytes boxes the arguments of every op, which costs more. Like
+// at::addGlobalCallback, must not be called while other threads run ops.
+TORCH_API void enableOperatorStats(bool record_input_bytes);
+// Stops recording. The stats are kept until the next enable. Must not be
+// called while other threads run ops.
+TORCH_API void disableOperatorStats();
+TORCH_API bool operatorStatsEnabled();
+
+// Returns the stats merged so far, including those of the calling thread,
+// keyed by "<op name>/<dispatch key>". Can be called while recording.
+TORCH_API std::unordered_map<std::string, OperatorStats> getOperatorStats();
+
+// Returns the stats in the format of a caffe2::ExportedStatMap (see
+// caffe2/core/stats.h), with the keys
+// "<prefix>/<op name>/<dispatch key>/{count,time_ns,input_bytes}", so that
+// they can be published along with the caffe2 stats.
+TORCH_API std::unordered_map<std::string, int64_t> exportOperatorStats(
+    const std::string& prefix = "operator_stats");
+
+}}} // namespace torch::autograd::profiler
@@ -7,6 +7,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <cstring>
 #include <fstream>
 #include <list>
 #include <mutex>
@@ -20,6 +21,13 @@
 
 #include <iostream>
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace torch { namespace autograd { namespace profiler {
 
 namespace {
@@ -43,9 +51,133 @@ namespace {
     STATE = 0,
     REPORT_INPUT_SHAPES,
     PROFILE_MEMORY,
+    RECORD_HW_COUNTERS,
     NUM_PROFILER_CFG_IVALUE_IDX // must be last in list
   };
 
+// Hardware counters of the threads, read with a perf event group per thread
+// that counts the thread in user space. The group is opened the first time a
+// thread records a range, and kept until the thread exits, so that the
+// counters only need a read syscall per range.
+struct HwCounterGroup {
+  HwCounterGroup() {
+    values_.fill(-1);
+#if defined(__linux__)
+    // Same order as HwCounter
+    const uint64_t configs[] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES};
+    static_assert(
+        sizeof(configs) / sizeof(configs[0]) ==
+            static_cast<size_t>(HwCounter::NumCounters),
+        "Expected a perf event per hardware counter");
+    for (size_t i = 0; i < static_cast<size_t>(HwCounter::NumCounters); ++i) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const int fd = syscall(
+          __NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+          /*group_fd=*/leader_fd_, /*flags=*/0);
+      if (fd < 0) {
+        if (leader_fd_ < 0) {
+          // Without the leader, none of the counters can be read
+          break;
+        }
+        // E.g. the CPU has no LLC counters, the other counters still work
+        continue;
+      }
+      if (leader_fd_ < 0) {
+        leader_fd_ = fd;
+      }
+      fds_.push_back(fd);
+      uint64_t id = 0;
+      if (ioctl(fd, PERF_EVENT_IOC_ID, &id) == 0) {
+        ids_[i] = id;
+      }
+    }
+#endif
+  }
+
+  ~HwCounterGroup() {
+#if defined(__linux__)
+    for (int fd : fds_) {
+      close(fd);
+    }
+#endif
+  }
+
+  bool available() const {
+    return !fds_.empty();
+  }
+
+  // The current values of the counters, scaled for the time that they
+  // didn't count when the perf events are multiplexed.
+  const HwCounterValues& read() {
+#if defined(__linux__)
+    if (!available()) {
+      return values_;
+    }
+    // nr, time_enabled, time_running, then a {value, id} pair per event
+    uint64_t buf[3 + 2 * static_cast<size_t>(HwCounter::NumCounters)];
+    const ssize_t size = ::read(leader_fd_, buf, sizeof(buf));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+      return values_;
+    }
+    const uint64_t nr = buf[0];
+    const uint64_t time_enabled = buf[1];
+    const uint64_t time_running = buf[2];
+    if (time_running == 0) {
+      return values_;
+    }
+    const double scale = static_cast<double>(time_enabled) / time_running;
+    for (uint64_t e = 0; e < nr; ++e) {
+      const uint64_t value = buf[3 + 2 * e];
+      const uint64_t id = buf[4 + 2 * e];
+      for (size_t i = 0; i < ids_.size(); ++i) {
+        if (ids_[i] == id) {
+          values_[i] = static_cast<int64_t>(value * scale);
+        }
+      }
+    }
+#endif
+    return values_;
+  }
+
+ private:
+  int leader_fd_ = -1;
+  std::vector<int> fds_;
+  // Ids of the perf events of the counters, 0 for those that didn't open
+  std::array<uint64_t, static_cast<size_t>(HwCounter::NumCounters)> ids_{};
+  HwCounterValues values_;
+};
+
+// Returns the current hardware counters of the thread, all -1 when they
+// can't be read.
+const HwCounterValues& readHwCounters() {
+  thread_local HwCounterGroup group;
+  if (!group.available()) {
+#if defined(__linux__)
+    TORCH_WARN_ONCE(
+        "Could not open the perf events for the hardware counters, they "
+        "won't be recorded. Check /proc/sys/kernel/perf_event_paranoid, or "
+        "the permissions of the container.");
+#else
+    TORCH_WARN_ONCE(
+        "The hardware counters are only recorded on Linux, they won't be "
+        "recorded.");
+#endif
+  }
+  return group.read();
+}
+
 CUDAStubs default_stubs;
 constexpr CUDAStubs* default_stubs_addr = &default_stubs;
 // Constant initialization, so it is guaranteed to be initialized before
@@ -222,6 +354,10 @@ struct ProfilerThreadLocalState
           std::move(shapes),
           at::RecordFunction::getDefaultNodeId());
       evt.setSequenceNr(sequence_nr);
+      if (config_.record_hw_counters) {
+        // Read last, so that recording the event isn't counted in the range
+        evt.setHwCounters(readHwCounters());
+      }
       getEventList().record(std::move(evt));
     }
   }
@@ -233,6 +369,11 @@ struct ProfilerThreadLocalState
     if (config_.state == ProfilerState::NVTX) {
       cuda_stubs->nvtxRangePop();
     } else {
+      // Read first, so that recording the event isn't counted in the range
+      c10::optional<HwCounterValues> hw_counters;
+      if (config_.record_hw_counters) {
+        hw_counters = readHwCounters();
+      }
       // In some cases RecordFunction (and popRange) may be
       // called on a different thread than pushRange
       // As a convention, we put the async pop on the original
@@ -243,6 +384,9 @@ struct ProfilerThreadLocalState
           config_.state == ProfilerState::CUDA,
           handle);
       evt.setNodeId(at::RecordFunction::getDefaultNodeId());
+      if (hw_counters) {
+        evt.setHwCounters(*hw_counters);
+      }
       getEventList(thread_id).record(std::move(evt));
     }
   }
@@ -405,6 +549,7 @@ at::IValue ProfilerConfig::toIValue() const {
   eventIValueList.emplace_back(static_cast<int64_t>(state));
   eventIValueList.emplace_back(report_input_shapes);
   eventIValueList.emplace_back(profile_memory);
+  eventIValueList.emplace_back(record_hw_counters);
   return eventIValueList;
 }
 
@@ -423,7 +568,8 @@ ProfilerConfig ProfilerConfig::fromIValue(
   return ProfilerConfig(
       static_cast<ProfilerState>(ivalues.get(ProfilerIValueIdx::STATE).toInt()),
       ivalues.get(ProfilerIValueIdx::REPORT_INPUT_SHAPES).toBool(),
-      ivalues.get(ProfilerIValueIdx::PROFILE_MEMORY).toBool());
+      ivalues.get(ProfilerIValueIdx::PROFILE_MEMORY).toBool(),
+      ivalues.get(ProfilerIValueIdx::RECORD_HW_COUNTERS).toBool());
 }
 
 ProfilerConfig getProfilerConfig() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <mutex>
 #include <memory>
@@ -105,14 +106,19 @@ struct TORCH_API ProfilerConfig {
   ProfilerConfig(
       ProfilerState state,
       bool report_input_shapes,
-      bool profile_memory)
+      bool profile_memory,
+      bool record_hw_counters = false)
       : state(state),
         report_input_shapes(report_input_shapes),
-        profile_memory(profile_memory) {}
+        profile_memory(profile_memory),
+        record_hw_counters(record_hw_counters) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
   bool profile_memory;
+  // Read the hardware counters of the thread (Linux perf events) at the start
+  // and the end of every range, see HwCounterValues
+  bool record_hw_counters;
 
   // Returns IValues corresponding to ProfilerConfig struct, to be used for
   // serialization.
@@ -123,6 +129,22 @@ struct TORCH_API ProfilerConfig {
 
 };
 
+// Values of the hardware counters of a thread, in user space, in the order of
+// HwCounter. -1 when a counter couldn't be read, e.g. on other platforms
+// than Linux or when perf events are not allowed (see perf_event_paranoid).
+// The counters are multiplexed when the CPU runs out of them, in which case
+// the values are estimates.
+enum class HwCounter : uint8_t {
+  Cycles = 0,
+  Instructions,
+  // Last level cache
+  CacheReferences,
+  CacheMisses,
+  NumCounters // must be last in list
+};
+using HwCounterValues =
+    std::array<int64_t, static_cast<size_t>(HwCounter::NumCounters)>;
+
 enum class TORCH_API EventKind : uint16_t {
   Mark,
   PushRange,
@@ -289,6 +311,19 @@ struct TORCH_API Event final {
     return sequence_nr_;
   }
 
+  void setHwCounters(const HwCounterValues& hw_counters) {
+    hw_counters_ = hw_counters;
+    has_hw_counters_ = true;
+  }
+
+  bool has_hw_counters() const {
+    return has_hw_counters_;
+  }
+
+  const HwCounterValues& hw_counters() const {
+    return hw_counters_;
+  }
+
  private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -305,6 +340,8 @@ struct TORCH_API Event final {
   bool is_remote_ = false;
   int64_t cuda_us_ = -1;
   int64_t sequence_nr_ = -1;
+  bool has_hw_counters_ = false;
+  HwCounterValues hw_counters_;
 };
 
 // a linked-list of fixed sized vectors, to avoid
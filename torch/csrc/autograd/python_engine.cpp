@@ -254,6 +254,44 @@ PyObject* THPEngine_is_checkpoint_valid(PyObject *self, PyObject *noargs) {
   END_HANDLE_TH_ERRORS
 }
 
+PyObject* THPEngine_set_num_cpu_workers(PyObject *self, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "set_num_cpu_workers expects an int, "
+      "but got %s", THPUtils_typename(arg));
+  auto& engine = python::PythonEngine::get_python_engine();
+  engine.set_num_cpu_workers(THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_get_num_cpu_workers(PyObject *self, PyObject *noargs) {
+  HANDLE_TH_ERRORS
+  auto& engine = python::PythonEngine::get_python_engine();
+  return THPUtils_packInt64(engine.num_cpu_workers());
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_set_backward_plan_cache_enabled(PyObject *self, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyBool_Check(arg), "set_backward_plan_cache_enabled expects a bool, "
+      "but got %s", THPUtils_typename(arg));
+  auto& engine = python::PythonEngine::get_python_engine();
+  engine.set_backward_plan_cache_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_is_backward_plan_cache_enabled(PyObject *self, PyObject *noargs) {
+  HANDLE_TH_ERRORS
+  auto& engine = python::PythonEngine::get_python_engine();
+  if (engine.is_backward_plan_cache_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject *THPEngine_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 {
   return type->tp_alloc(type, 0);
@@ -263,6 +301,10 @@ static struct PyMethodDef THPEngine_methods[] = {
   {(char*)"run_backward", (PyCFunction)(void(*)(void))THPEngine_run_backward, METH_VARARGS | METH_KEYWORDS, nullptr},
   {(char*)"queue_callback", (PyCFunction)THPEngine_queue_callback, METH_O, nullptr},
   {(char*)"is_checkpoint_valid", (PyCFunction)THPEngine_is_checkpoint_valid, METH_NOARGS, nullptr},
+  {(char*)"set_num_cpu_workers", (PyCFunction)THPEngine_set_num_cpu_workers, METH_O, nullptr},
+  {(char*)"get_num_cpu_workers", (PyCFunction)THPEngine_get_num_cpu_workers, METH_NOARGS, nullptr},
+  {(char*)"set_backward_plan_cache_enabled", (PyCFunction)THPEngine_set_backward_plan_cache_enabled, METH_O, nullptr},
+  {(char*)"is_backward_plan_cache_enabled", (PyCFunction)THPEngine_is_backward_plan_cache_enabled, METH_NOARGS, nullptr},
   {nullptr}
 };
 
@@ -0,0 +1,72 @@
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/memory.h>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+struct PySavedVariableHooks : public SavedVariableHooks {
+  PySavedVariableHooks(
+      std::shared_ptr<py::function> pack_hook,
+      std::shared_ptr<py::function> unpack_hook)
+      : pack_hook_(std::move(pack_hook)),
+        unpack_hook_(std::move(unpack_hook)) {}
+
+  ~PySavedVariableHooks() override {
+    if (data_) {
+      pybind11::gil_scoped_acquire gil;
+      data_ = py::object();
+    }
+  }
+
+  void call_pack_hook(const at::Tensor& tensor) override {
+    pybind11::gil_scoped_acquire gil;
+    THPObjectPtr obj(THPVariable_Wrap(tensor));
+    if (!obj) throw python_error();
+    PyObject* packed = PyObject_CallFunctionObjArgs(pack_hook_->ptr(), obj.get(), nullptr);
+    if (!packed) throw python_error();
+    data_ = py::reinterpret_steal<py::object>(packed);
+  }
+
+  at::Tensor call_unpack_hook() override {
+    pybind11::gil_scoped_acquire gil;
+    THPObjectPtr res(PyObject_CallFunctionObjArgs(unpack_hook_->ptr(), data_.ptr(), nullptr));
+    if (!res) throw python_error();
+    TORCH_CHECK_TYPE(
+        THPVariable_Check(res.get()),
+        "Output of saved tensor unpack_hook expected to be a Tensor but got ",
+        THPUtils_typename(res.get()));
+    return ((THPVariable*)res.get())->cdata;
+  }
+
+ private:
+  // Shared by all the hooks made by the same factory.
+  std::shared_ptr<py::function> pack_hook_;
+  std::shared_ptr<py::function> unpack_hook_;
+  py::object data_;
+};
+
+std::shared_ptr<py::function> share_with_gil(py::function fn) {
+  return std::shared_ptr<py::function>(
+      new py::function(std::move(fn)), [](py::function* fn) {
+        pybind11::gil_scoped_acquire gil;
+        delete fn;
+      });
+}
+
+} // namespace
+
+SavedVariableHooksFactory make_py_saved_variable_hooks(
+    py::function pack_hook,
+    py::function unpack_hook) {
+  auto pack = share_with_gil(std::move(pack_hook));
+  auto unpack = share_with_gil(std::move(unpack_hook));
+  return [pack, unpack]() -> std::unique_ptr<SavedVariableHooks> {
+    return torch::make_unique<PySavedVariableHooks>(pack, unpack);
+  };
+}
+
+}} // namespace torch::autograd
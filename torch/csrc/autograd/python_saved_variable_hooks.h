@@ -0,0 +1,15 @@
+#pragma once
+
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+#include <torch/csrc/utils/pybind.h>
+
+namespace torch { namespace autograd {
+
+// Makes hooks that call pack_hook(tensor) when a variable is saved, keep
+// whatever it returns, and call unpack_hook on that to get the tensor back.
+SavedVariableHooksFactory make_py_saved_variable_hooks(
+    py::function pack_hook,
+    py::function unpack_hook);
+
+}} // namespace torch::autograd
@@ -0,0 +1,245 @@
+#include <torch/csrc/autograd/sampling_profiler.h>
+
+#include <ATen/record_function.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Longer names are truncated.
+constexpr size_t kMaxNameLength = 64;
+// Number of sampled ranges that can be open on a thread. Past it, the
+// outermost one is dropped (it may be an async range that ended elsewhere).
+constexpr size_t kMaxDepth = 128;
+
+struct SampleRecord {
+  // Even when the record is valid, odd while it is being written. See
+  // SampleRingBuffer.
+  std::atomic<uint64_t> stamp{0};
+  char name[kMaxNameLength];
+  int64_t start_ns;
+  int64_t end_ns;
+  int64_t sequence_nr;
+};
+
+// A ring buffer with a single writer, the thread that owns it, and any number
+// of readers. The writer never waits: it overwrites the oldest record once the
+// buffer is full. Each record is a seqlock whose stamp tells readers whether
+// they copied the record while it was being overwritten, in which case they
+// drop it.
+struct SampleRingBuffer {
+  SampleRingBuffer(uint64_t thread_id, size_t capacity)
+      : thread_id_(thread_id), capacity_(capacity), records_(new SampleRecord[capacity]) {}
+
+  void push(const char* name, int64_t start_ns, int64_t end_ns, int64_t sequence_nr) {
+    const auto index = head_.load(std::memory_order_relaxed);
+    auto& record = records_[index % capacity_];
+    record.stamp.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    strncpy(record.name, name, kMaxNameLength - 1);
+    record.name[kMaxNameLength - 1] = '\0';
+    record.start_ns = start_ns;
+    record.end_ns = end_ns;
+    record.sequence_nr = sequence_nr;
+    record.stamp.store(2 * index + 2, std::memory_order_release);
+    head_.store(index + 1, std::memory_order_release);
+  }
+
+  void snapshot(int64_t base_ns, std::vector<SampledRange>& out) const {
+    const auto end = head_.load(std::memory_order_acquire);
+    const auto begin = end > capacity_ ? end - capacity_ : 0;
+    for (auto index = begin; index < end; index++) {
+      const auto& record = records_[index % capacity_];
+      const auto stamp = record.stamp.load(std::memory_order_acquire);
+      if (stamp != 2 * index + 2) {
+        continue;
+      }
+      SampledRange range;
+      range.name = std::string(record.name, strnlen(record.name, kMaxNameLength));
+      range.thread_id = thread_id_;
+      range.start_ns = record.start_ns - base_ns;
+      range.end_ns = record.end_ns - base_ns;
+      range.sequence_nr = record.sequence_nr;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (record.stamp.load(std::memory_order_relaxed) != stamp) {
+        continue;
+      }
+      out.push_back(std::move(range));
+    }
+  }
+
+ private:
+  const uint64_t thread_id_;
+  const size_t capacity_;
+  std::unique_ptr<SampleRecord[]> records_;
+  // Number of records ever pushed.
+  std::atomic<uint64_t> head_{0};
+};
+
+struct SamplingProfilerState {
+  std::mutex mutex;
+  bool enabled = false;
+  at::CallbackHandle callback_handle = 0;
+  size_t buffer_size = 0;
+  int64_t base_ns = 0;
+  std::vector<std::shared_ptr<SampleRingBuffer>> buffers;
+};
+
+SamplingProfilerState& state() {
+  static SamplingProfilerState state_;
+  return state_;
+}
+
+// Bumped by every enable so that threads drop the buffers of earlier runs.
+std::atomic<uint64_t> generation{0};
+
+struct ThreadState {
+  uint64_t generation = 0;
+  std::shared_ptr<SampleRingBuffer> buffer;
+  // (handle, start_ns) of the sampled ranges that are still open.
+  std::vector<std::pair<at::RecordFunctionHandle, int64_t>> open_ranges;
+};
+
+thread_local ThreadState thread_state;
+
+SampleRingBuffer* threadBuffer(ThreadState& ts) {
+  const auto current = generation.load(std::memory_order_acquire);
+  if (ts.generation != current) {
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    ts.buffer = std::make_shared<SampleRingBuffer>(
+        at::RecordFunction::currentThreadId(), s.buffer_size);
+    s.buffers.push_back(ts.buffer);
+    ts.generation = current;
+  }
+  return ts.buffer.get();
+}
+
+void onRangeStart(const at::RecordFunction& fn) {
+  auto& ts = thread_state;
+  if (ts.open_ranges.size() >= kMaxDepth) {
+    ts.open_ranges.erase(ts.open_ranges.begin());
+  }
+  ts.open_ranges.emplace_back(fn.handle(), getTime());
+}
+
+void onRangeEnd(const at::RecordFunction& fn) {
+  const auto end_ns = getTime();
+  auto& ts = thread_state;
+  // Ranges are nested, so the one ending is normally the last one opened.
+  // Ranges that end on another thread than the one they started on (async
+  // ops) are dropped.
+  auto it = std::find_if(
+      ts.open_ranges.rbegin(),
+      ts.open_ranges.rend(),
+      [&](const std::pair<at::RecordFunctionHandle, int64_t>& range) {
+        return range.first == fn.handle();
+      });
+  if (it == ts.open_ranges.rend()) {
+    return;
+  }
+  const auto start_ns = it->second;
+  ts.open_ranges.erase(std::next(it).base());
+  threadBuffer(ts)->push(fn.name().str(), start_ns, end_ns, fn.seqNr());
+}
+
+void writeEscaped(std::ostream& out, const std::string& str) {
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+}
+
+} // namespace
+
+void enableSamplingProfiler(double sampling_prob, size_t buffer_size) {
+  TORCH_CHECK(
+      sampling_prob > 0.0 && sampling_prob <= 1.0,
+      "Sampling probability must be in (0, 1], but got ",
+      sampling_prob);
+  TORCH_CHECK(buffer_size > 0, "Sampling profiler buffer size must be positive");
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  TORCH_CHECK(!s.enabled, "Sampling profiler is already enabled");
+  s.buffers.clear();
+  s.buffer_size = buffer_size;
+  s.base_ns = getTime();
+  generation++;
+  s.callback_handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(onRangeStart, onRangeEnd)
+          .needsIds(true)
+          .samplingProb(sampling_prob));
+  s.enabled = true;
+}
+
+void disableSamplingProfiler() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  TORCH_CHECK(s.enabled, "Sampling profiler is not enabled");
+  at::removeCallback(s.callback_handle);
+  s.enabled = false;
+}
+
+bool samplingProfilerEnabled() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  return s.enabled;
+}
+
+std::vector<SampledRange> getSampledRanges() {
+  std::vector<std::shared_ptr<SampleRingBuffer>> buffers;
+  int64_t base_ns = 0;
+  {
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    buffers = s.buffers;
+    base_ns = s.base_ns;
+  }
+  std::vector<SampledRange> ranges;
+  for (const auto& buffer : buffers) {
+    const auto first = ranges.size();
+    buffer->snapshot(base_ns, ranges);
+    // Ranges are pushed when they end, so nested ones come first.
+    std::stable_sort(
+        ranges.begin() + first,
+        ranges.end(),
+        [](const SampledRange& a, const SampledRange& b) {
+          return a.start_ns < b.start_ns;
+        });
+  }
+  return ranges;
+}
+
+void writeSampledRangesToChromeTrace(std::ostream& out) {
+  TORCH_CHECK(out, "Could not open file");
+  out << "[";
+  bool first = true;
+  for (const auto& range : getSampledRanges()) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\": \"";
+    writeEscaped(out, range.name);
+    out << "\", \"ph\": \"X\", \"ts\": " << range.start_ns / 1000.0
+        << ", \"dur\": " << (range.end_ns - range.start_ns) / 1000.0
+        << ", \"tid\": " << range.thread_id
+        << ", \"pid\": \"CPU Functions\", \"args\": {\"seq\": "
+        << range.sequence_nr << "}}";
+  }
+  out << "\n]\n";
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// A sampling profiler cheap enough to be left on in production.
+//
+// Unlike the profiler in profiler.h, which records every RecordFunction range
+// of the profiled threads into mutex protected event lists, the sampling
+// profiler installs a global RecordFunction callback that only runs for a
+// random `sampling_prob` fraction of the ranges (ops, autograd nodes during
+// backward, TorchScript functions and user scopes). When a range is not
+// sampled, the only cost is a countdown in RecordFunction. Sampled ranges are
+// written to a fixed size ring buffer owned by the thread that ran them, so
+// recording never takes a lock; once a buffer is full, the oldest ranges are
+// overwritten.
+//
+// Forward ops and the autograd nodes that compute their gradients have the
+// same sequence number, which is exported with every range.
+//
+// Only CPU time is recorded. Use the CUDA mode of the regular profiler to
+// time kernels.
+
+struct TORCH_API SampledRange {
+  std::string name;
+  uint64_t thread_id;
+  // In nanoseconds, relative to when the sampling profiler was enabled.
+  int64_t start_ns;
+  int64_t end_ns;
+  int64_t sequence_nr;
+};
+
+// Starts sampling ranges with the given probability, keeping the last
+// `buffer_size` sampled ranges of every thread. Discards the ranges recorded
+// by an earlier run. Like at::addGlobalCallback, must not be called while
+// other threads run ops.
+TORCH_API void enableSamplingProfiler(double sampling_prob, size_t buffer_size);
+// Stops sampling. The recorded ranges are kept until the next enable. Must not
+// be called while other threads run ops.
+TORCH_API void disableSamplingProfiler();
+TORCH_API bool samplingProfilerEnabled();
+
+// Returns the ranges recorded so far, ordered by thread and start time. Can be
+// called while the profiler runs.
+TORCH_API std::vector<SampledRange> getSampledRanges();
+
+// Writes the ranges recorded so far as a Chrome trace (chrome://tracing).
+TORCH_API void writeSampledRangesToChromeTrace(std::ostream& out);
+
+}}} // namespace torch::autograd::profiler
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
 
 #include <ATen/ATen.h>
 
@@ -30,6 +31,7 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
   void reset_data() {
+    hooks_.reset();
     return data_.reset();
   }
 
@@ -39,6 +41,8 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // If set, holds the data instead of data_. See saved_variable_hooks.h
+  std::unique_ptr<SavedVariableHooks> hooks_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
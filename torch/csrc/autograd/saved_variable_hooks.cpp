@@ -0,0 +1,268 @@
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+#include <c10/core/Event.h>
+#include <c10/core/Stream.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+thread_local std::vector<SavedVariableHooksFactory> hooks_stack;
+
+struct OffloadedTensor {
+  // False for tensors that are not on a CUDA device; device_tensor holds them.
+  bool offloaded = false;
+  at::Device device = at::kCPU;
+  at::Tensor host_tensor;
+  // While the copy to the host runs, the tensor that is being copied. After a
+  // prefetch, the copy on the device.
+  at::Tensor device_tensor;
+  bool prefetched = false;
+  // Recorded after the last copy between host and device.
+  std::unique_ptr<c10::Event> event;
+  // Position in OffloadState::entries.
+  size_t index = 0;
+};
+
+// Shared by the hooks made by one offload factory.
+struct OffloadState {
+  explicit OffloadState(int64_t prefetch) : prefetch_(prefetch) {}
+
+  void pack(const std::shared_ptr<OffloadedTensor>& entry, const at::Tensor& tensor) {
+    if (!tensor.is_cuda() || tensor.is_sparse()) {
+      entry->device_tensor = tensor;
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    poll();
+    entry->offloaded = true;
+    entry->device = tensor.device();
+    entry->host_tensor = at::empty(
+        tensor.sizes(),
+        tensor.options().device(at::kCPU).pinned_memory(true));
+    // Keep the tensor alive until the copy is done; the caching allocator
+    // doesn't know about the side stream.
+    entry->device_tensor = tensor;
+    copy_on_side_stream(*entry, entry->host_tensor, tensor);
+    pending_.push_back(entry);
+
+    entry->index = entries_.size();
+    entries_.push_back(entry);
+    if (entries_.size() >= next_compaction_) {
+      compact();
+    }
+  }
+
+  at::Tensor unpack(OffloadedTensor& entry) {
+    if (!entry.offloaded) {
+      return entry.device_tensor;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    poll();
+    at::Tensor result;
+    if (entry.prefetched) {
+      c10::impl::VirtualGuardImpl impl(entry.device.type());
+      impl.getStream(entry.device).wait(*entry.event);
+      result = std::move(entry.device_tensor);
+      entry.prefetched = false;
+    } else if (entry.device_tensor.defined()) {
+      // The copy to the host is still running.
+      result = entry.device_tensor;
+    } else {
+      result = at::empty(
+          entry.host_tensor.sizes(),
+          entry.host_tensor.options().device(entry.device));
+      result.copy_(entry.host_tensor, /*non_blocking=*/true);
+    }
+    prefetch(entry.index);
+    return result;
+  }
+
+ private:
+  // Copies src into dst on the side stream of entry.device, after the work
+  // queued on the current stream so far.
+  void copy_on_side_stream(
+      OffloadedTensor& entry,
+      at::Tensor& dst,
+      const at::Tensor& src) {
+    c10::impl::VirtualGuardImpl impl(entry.device.type());
+    auto side_stream = side_stream_for(impl, entry.device);
+    c10::Event ready(entry.device.type());
+    ready.record(impl.getStream(entry.device));
+    side_stream.wait(ready);
+    {
+      c10::StreamGuard guard(side_stream);
+      dst.copy_(src, /*non_blocking=*/true);
+    }
+    entry.event = torch::make_unique<c10::Event>(entry.device.type());
+    entry.event->record(side_stream);
+  }
+
+  c10::Stream side_stream_for(
+      const c10::impl::VirtualGuardImpl& impl,
+      at::Device device) {
+    auto it = side_streams_.find(device.index());
+    if (it == side_streams_.end()) {
+      it = side_streams_
+               .emplace(device.index(), impl.getStreamFromGlobalPool(device))
+               .first;
+    }
+    return it->second;
+  }
+
+  // Copies back to the device the tensors saved right before the one at
+  // index, which backward is going to unpack next.
+  void prefetch(size_t index) {
+    const size_t first = index > static_cast<size_t>(prefetch_)
+        ? index - prefetch_
+        : 0;
+    for (size_t i = index; i-- > first;) {
+      auto entry = entries_[i].lock();
+      if (!entry || entry->device_tensor.defined()) {
+        continue;
+      }
+      // Allocated on the current stream, which is the one that uses it.
+      entry->device_tensor = at::empty(
+          entry->host_tensor.sizes(),
+          entry->host_tensor.options().device(entry->device));
+      copy_on_side_stream(*entry, entry->device_tensor, entry->host_tensor);
+      entry->prefetched = true;
+      pending_.push_back(std::move(entry));
+    }
+  }
+
+  // Releases the device tensors whose copy to the host is done. Entries are
+  // kept alive while a copy involving them runs.
+  void poll() {
+    auto done = std::remove_if(
+        pending_.begin(),
+        pending_.end(),
+        [](const std::shared_ptr<OffloadedTensor>& entry) {
+          if (!entry->event->query()) {
+            return false;
+          }
+          if (!entry->prefetched) {
+            entry->device_tensor.reset();
+          }
+          return true;
+        });
+    pending_.erase(done, pending_.end());
+  }
+
+  // Drops the entries of saved variables that were freed.
+  void compact() {
+    auto end = std::remove_if(
+        entries_.begin(),
+        entries_.end(),
+        [](const std::weak_ptr<OffloadedTensor>& entry) {
+          return entry.expired();
+        });
+    entries_.erase(end, entries_.end());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      if (auto entry = entries_[i].lock()) {
+        entry->index = i;
+      }
+    }
+    next_compaction_ = std::max<size_t>(1024, 2 * entries_.size());
+  }
+
+  const int64_t prefetch_;
+  // To protect everything below and the entries
+  std::mutex mutex_;
+  // The offloaded tensors in the order they were saved.
+  std::vector<std::weak_ptr<OffloadedTensor>> entries_;
+  size_t next_compaction_ = 1024;
+  // Entries with a copy that may still be running.
+  std::vector<std::shared_ptr<OffloadedTensor>> pending_;
+  std::unordered_map<c10::DeviceIndex, c10::Stream> side_streams_;
+};
+
+struct OffloadHooks : public SavedVariableHooks {
+  explicit OffloadHooks(std::shared_ptr<OffloadState> state)
+      : state_(std::move(state)),
+        entry_(std::make_shared<OffloadedTensor>()) {}
+
+  void call_pack_hook(const at::Tensor& tensor) override {
+    state_->pack(entry_, tensor);
+  }
+
+  at::Tensor call_unpack_hook() override {
+    return state_->unpack(*entry_);
+  }
+
+ private:
+  std::shared_ptr<OffloadState> state_;
+  std::shared_ptr<OffloadedTensor> entry_;
+};
+
+struct CompressedHooks : public SavedVariableHooks {
+  explicit CompressedHooks(at::ScalarType dtype) : dtype_(dtype) {}
+
+  void call_pack_hook(const at::Tensor& tensor) override {
+    original_dtype_ = tensor.scalar_type();
+    if (at::isFloatingType(original_dtype_) &&
+        at::elementSize(original_dtype_) > at::elementSize(dtype_)) {
+      data_ = tensor.to(dtype_);
+    } else {
+      data_ = tensor;
+    }
+  }
+
+  at::Tensor call_unpack_hook() override {
+    return data_.to(original_dtype_);
+  }
+
+ private:
+  at::ScalarType dtype_;
+  at::ScalarType original_dtype_ = at::ScalarType::Undefined;
+  at::Tensor data_;
+};
+
+} // namespace
+
+void push_saved_variable_hooks(SavedVariableHooksFactory factory) {
+  TORCH_CHECK(factory, "Saved variable hooks factory must not be empty");
+  hooks_stack.push_back(std::move(factory));
+}
+
+void pop_saved_variable_hooks() {
+  TORCH_CHECK(!hooks_stack.empty(), "No saved variable hooks to pop");
+  hooks_stack.pop_back();
+}
+
+const SavedVariableHooksFactory* current_saved_variable_hooks() {
+  return hooks_stack.empty() ? nullptr : &hooks_stack.back();
+}
+
+SavedVariableHooksFactory make_offload_saved_variable_hooks(int64_t prefetch) {
+  TORCH_CHECK(
+      prefetch >= 0,
+      "Number of saved tensors to prefetch must not be negative, but got ",
+      prefetch);
+  auto state = std::make_shared<OffloadState>(prefetch);
+  return [state]() -> std::unique_ptr<SavedVariableHooks> {
+    return torch::make_unique<OffloadHooks>(state);
+  };
+}
+
+SavedVariableHooksFactory make_compressed_saved_variable_hooks(
+    at::ScalarType dtype) {
+  TORCH_CHECK(
+      dtype == at::kHalf || dtype == at::kBFloat16,
+      "Saved tensors can only be compressed to Half or BFloat16, but got ",
+      dtype);
+  return [dtype]() -> std::unique_ptr<SavedVariableHooks> {
+    return torch::make_unique<CompressedHooks>(dtype);
+  };
+}
+
+}} // namespace torch::autograd
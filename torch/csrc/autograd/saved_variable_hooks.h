@@ -0,0 +1,61 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <functional>
+#include <memory>
+
+namespace torch { namespace autograd {
+
+/// Hooks that decide how a `SavedVariable` keeps its tensor between forward
+/// and backward. `call_pack_hook` is called once, when the variable is saved,
+/// and may store the tensor in any form (e.g. copied to host memory or
+/// compressed). `call_unpack_hook` is called each time backward needs the
+/// tensor and must return a tensor with the same value, sizes, dtype and
+/// device as the packed one.
+struct TORCH_API SavedVariableHooks {
+  virtual ~SavedVariableHooks() = default;
+  virtual void call_pack_hook(const at::Tensor& tensor) = 0;
+  virtual at::Tensor call_unpack_hook() = 0;
+};
+
+/// Creates the hooks of one saved variable.
+using SavedVariableHooksFactory =
+    std::function<std::unique_ptr<SavedVariableHooks>()>;
+
+/// Variables saved on this thread use the hooks made by the factory pushed
+/// last, until it is popped. Leaves that require grad (i.e. parameters) are
+/// always saved as they are, since the model keeps them alive anyway.
+TORCH_API void push_saved_variable_hooks(SavedVariableHooksFactory factory);
+TORCH_API void pop_saved_variable_hooks();
+/// Returns the factory pushed last, or nullptr if there is none.
+TORCH_API const SavedVariableHooksFactory* current_saved_variable_hooks();
+
+/// RAII guard around push_saved_variable_hooks and pop_saved_variable_hooks.
+struct TORCH_API SavedVariableHooksGuard {
+  explicit SavedVariableHooksGuard(SavedVariableHooksFactory factory) {
+    push_saved_variable_hooks(std::move(factory));
+  }
+  ~SavedVariableHooksGuard() {
+    pop_saved_variable_hooks();
+  }
+};
+
+/// Keeps saved CUDA tensors in pinned host memory. The copies to the host run
+/// on a side stream, so they overlap with the rest of forward. When backward
+/// unpacks a tensor, the `prefetch` tensors saved right before it are copied
+/// back to the device on the side stream, as backward will need them next.
+/// Tensors on other devices are kept as they are.
+TORCH_API SavedVariableHooksFactory make_offload_saved_variable_hooks(
+    int64_t prefetch);
+
+/// Keeps saved floating point tensors wider than `dtype` (which must be Half
+/// or BFloat16) converted to it, and converts them back when unpacking. This
+/// halves the memory used by saved float tensors, at the cost of computing
+/// gradients from rounded values.
+TORCH_API SavedVariableHooksFactory make_compressed_saved_variable_hooks(
+    at::ScalarType dtype);
+
+}} // namespace torch::autograd
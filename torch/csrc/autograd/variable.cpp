@@ -37,7 +37,9 @@ DifferentiableViewMeta::DifferentiableViewMeta(at::TensorImpl* self_impl, Variab
   }
   is_view_ = true;
   self_impl->set_version_counter(impl::version_counter(base_));
-  attr_version = self_impl->version_counter().current_version();
+  // Views of inference tensors have no version to track
+  const auto& version_counter = self_impl->version_counter();
+  attr_version = version_counter.enabled() ? version_counter.current_version() : 0;
 }
 
 DifferentiableViewMeta::~DifferentiableViewMeta() {
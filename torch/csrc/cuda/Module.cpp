@@ -9,6 +9,7 @@
 #include <ATen/CUDAGeneratorImpl.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/util/Backtrace.h>
 #ifdef USE_NCCL
 #include <torch/csrc/cuda/python_nccl.h>
 #endif
@@ -130,6 +131,41 @@ PyObject * THCPModule_getDefaultStream_wrap(
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_reserveStream_wrap(PyObject *self, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *priority_o = nullptr;
+  PyObject *device_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &priority_o, &device_o) ||
+      !THPUtils_checkLong(priority_o) || !THPUtils_checkLong(device_o)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "_cuda_reserveStream",
+        1,
+        "(int priority, int device);");
+    return nullptr;
+  }
+  int64_t priority = THPUtils_unpackLong(priority_o);
+  int64_t device = THPUtils_unpackLong(device_o);
+  return PyLong_FromUnsignedLongLong(
+    c10::cuda::reserveStreamFromPool(priority < 0, device).pack());
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_releaseStream_wrap(PyObject *self, PyObject *obj)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyLong_Check(obj), "invalid stream");
+  uint64_t bits = PyLong_AsUnsignedLongLong(obj);
+  if (bits == static_cast<uint64_t>(-1) && PyErr_Occurred()) {
+    throw python_error();
+  }
+  c10::cuda::releaseStreamToPool(at::cuda::CUDAStream::unpack(bits));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_setStream_wrap(PyObject *self, PyObject *obj)
 {
   HANDLE_TH_ERRORS
@@ -148,6 +184,35 @@ PyObject * THCPModule_setStream_wrap(PyObject *self, PyObject *obj)
   END_HANDLE_TH_ERRORS
 }
 
+// Makes the (possibly foreign) stream given as a raw handle wait for the work
+// queued so far on the current stream, without blocking the host. Used for
+// the DLPack stream handshake, where 1 and 2 denote the legacy and per-thread
+// default streams on CUDA.
+PyObject * THCPModule_streamWaitCurrent_wrap(PyObject *self, PyObject *obj)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(obj), "invalid stream");
+  int64_t bits = THPUtils_unpackLong(obj);
+  cudaStream_t consumer = reinterpret_cast<cudaStream_t>(bits);
+#ifndef __HIP_PLATFORM_HCC__
+  if (bits == 1) {
+    consumer = cudaStreamLegacy;
+  } else if (bits == 2) {
+    consumer = cudaStreamPerThread;
+  }
+#endif
+  auto producer = at::cuda::getCurrentCUDAStream();
+  if (consumer != producer.stream()) {
+    cudaEvent_t event;
+    AT_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    AT_CUDA_CHECK(cudaEventRecord(event, producer.stream()));
+    AT_CUDA_CHECK(cudaStreamWaitEvent(consumer, event, 0));
+    AT_CUDA_CHECK(cudaEventDestroy(event));
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_getCompiledVersion(PyObject *self, PyObject *noargs)
 {
   return PyLong_FromLong((long) CUDA_VERSION);
@@ -341,12 +406,139 @@ PyObject * THCPModule_resetPeakMemoryStats(PyObject *_unused, PyObject *arg)
   Py_RETURN_NONE;
 }
 
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+
+  py::dict result;
+  result["allocated_bytes.current"] = stats.allocated_bytes;
+  result["allocated_bytes.peak"] = stats.peak_allocated_bytes;
+  result["reserved_bytes.current"] = stats.reserved_bytes;
+  result["reserved_bytes.peak"] = stats.peak_reserved_bytes;
+  result["num_allocs"] = stats.num_allocs;
+  result["num_cache_hits"] = stats.num_cache_hits;
+  result["num_host_allocs"] = stats.num_host_allocs;
+  result["num_host_frees"] = stats.num_host_frees;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_resetPeakHostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_resetPeakStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_setHostMemoryCacheLimit(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to set_host_memory_cache_limit");
+  const int64_t limit = THPUtils_unpackLong(arg);
+  THPUtils_assert(limit >= 0, "set_host_memory_cache_limit expects a non-negative number of bytes");
+  THCCachingHostAllocator_setCacheLimit(static_cast<size_t>(limit));
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+namespace {
+
+// Context recorded by the caching allocator for each allocation while
+// memory history is recorded: the Python stack, innermost frame first, and
+// optionally the C++ stack.
+struct StackContext : public c10::cuda::CUDACachingAllocator::Context {
+  struct Frame {
+    std::string filename;
+    std::string name;
+    int line;
+  };
+  std::vector<Frame> frames;
+  std::string cpp_frames;
+};
+
+std::shared_ptr<StackContext> gatherPythonStack() {
+  auto context = std::make_shared<StackContext>();
+  pybind11::gil_scoped_acquire gil;
+  for (PyFrameObject* frame = PyEval_GetFrame(); frame != nullptr; frame = frame->f_back) {
+    context->frames.push_back({
+      THPUtils_unpackString(frame->f_code->co_filename),
+      THPUtils_unpackString(frame->f_code->co_name),
+      PyFrame_GetLineNumber(frame)});
+  }
+  return context;
+}
+
+std::shared_ptr<c10::cuda::CUDACachingAllocator::Context> gatherPythonContext() {
+  return gatherPythonStack();
+}
+
+std::shared_ptr<c10::cuda::CUDACachingAllocator::Context> gatherPythonAndCppContext() {
+  auto context = gatherPythonStack();
+  context->cpp_frames = c10::get_backtrace(/*frames_to_skip=*/2);
+  return context;
+}
+
+py::object contextToPython(
+    const std::shared_ptr<c10::cuda::CUDACachingAllocator::Context>& context) {
+  auto stack = std::dynamic_pointer_cast<StackContext>(context);
+  if (!stack) {
+    return py::none();
+  }
+  py::list frames;
+  for (const auto& frame : stack->frames) {
+    py::dict frameDict;
+    frameDict["filename"] = frame.filename;
+    frameDict["name"] = frame.name;
+    frameDict["line"] = frame.line;
+    frames.append(frameDict);
+  }
+  py::dict result;
+  result["frames"] = frames;
+  if (!stack->cpp_frames.empty()) {
+    result["cpp_frames"] = stack->cpp_frames;
+  }
+  return std::move(result);
+}
+
+} // namespace
+
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* enabled_o = nullptr;
+  PyObject* record_context_o = nullptr;
+  PyObject* record_cpp_context_o = nullptr;
+  PyObject* max_entries_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OOOO", &enabled_o, &record_context_o,
+                        &record_cpp_context_o, &max_entries_o)) {
+    THPUtils_invalidArguments(
+        args, nullptr, "_cuda_recordMemoryHistory", 1,
+        "(bool enabled, bool record_context, bool record_cpp_context, int trace_alloc_max_entries);");
+    return nullptr;
+  }
+  THPUtils_assert(THPUtils_checkLong(max_entries_o),
+                  "invalid trace_alloc_max_entries argument to _cuda_recordMemoryHistory");
+  c10::cuda::CUDACachingAllocator::CreateContextFn recorder = nullptr;
+  if (PyObject_IsTrue(record_cpp_context_o)) {
+    recorder = gatherPythonAndCppContext;
+  } else if (PyObject_IsTrue(record_context_o)) {
+    recorder = gatherPythonContext;
+  }
+  c10::cuda::CUDACachingAllocator::recordHistory(
+      PyObject_IsTrue(enabled_o), recorder, THPUtils_unpackLong(max_entries_o));
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
 {
   HANDLE_TH_ERRORS
 
   using c10::cuda::CUDACachingAllocator::SegmentInfo;
   using c10::cuda::CUDACachingAllocator::BlockInfo;
+  using c10::cuda::CUDACachingAllocator::TraceEntry;
 
   const auto segmentInfoToDict = [](const SegmentInfo& segmentInfo) {
     py::dict segmentDict;
@@ -355,6 +547,7 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["total_size"] = segmentInfo.total_size;
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
+    segmentDict["stream"] = reinterpret_cast<int64_t>(segmentInfo.stream);
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
 
     py::list blocks;
@@ -362,6 +555,9 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
       py::dict blockDict;
       blockDict["size"] = blockInfo.size;
       blockDict["state"] = (blockInfo.allocated ? "active_allocated" : (blockInfo.active ? "active_pending_free" : "inactive"));
+      if (blockInfo.context_when_allocated) {
+        blockDict["history"] = contextToPython(blockInfo.context_when_allocated);
+      }
       blocks.append(blockDict);
     }
     segmentDict["blocks"] = blocks;
@@ -369,13 +565,48 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     return segmentDict;
   };
 
-  const std::vector<SegmentInfo>& snapshot = c10::cuda::CUDACachingAllocator::snapshot();
-  py::list result;
+  const auto actionToString = [](TraceEntry::Action action) {
+    switch (action) {
+      case TraceEntry::ALLOC: return "alloc";
+      case TraceEntry::FREE: return "free";
+      case TraceEntry::SEGMENT_ALLOC: return "segment_alloc";
+      case TraceEntry::SEGMENT_FREE: return "segment_free";
+      case TraceEntry::OOM: return "oom";
+    }
+    return "unknown";
+  };
+
+  const auto traceEntryToDict = [&](const TraceEntry& entry) {
+    py::dict entryDict;
+    entryDict["action"] = actionToString(entry.action);
+    entryDict["addr"] = entry.addr;
+    entryDict["size"] = entry.size;
+    entryDict["stream"] = reinterpret_cast<int64_t>(entry.stream);
+    if (entry.context) {
+      entryDict["history"] = contextToPython(entry.context);
+    }
+    return entryDict;
+  };
 
-  for (const auto& segmentInfo : snapshot) {
-    result.append(segmentInfoToDict(segmentInfo));
+  const auto snapshot = c10::cuda::CUDACachingAllocator::snapshot();
+
+  py::list segments;
+  for (const auto& segmentInfo : snapshot.segments) {
+    segments.append(segmentInfoToDict(segmentInfo));
   }
 
+  py::list traces;
+  for (const auto& deviceTrace : snapshot.device_traces) {
+    py::list trace;
+    for (const auto& entry : deviceTrace) {
+      trace.append(traceEntryToDict(entry));
+    }
+    traces.append(trace);
+  }
+
+  py::dict result;
+  result["segments"] = segments;
+  result["device_traces"] = traces;
   return result.release().ptr();
   END_HANDLE_TH_ERRORS
 }
@@ -496,13 +727,20 @@ static struct PyMethodDef _THCPModule_methods[] = {
     (PyCFunction)THCPModule_getDefaultStream_wrap, METH_O, nullptr},
   {"_cuda_getCurrentBlasHandle", (PyCFunction)THCPModule_getCurrentBlasHandle_wrap, METH_NOARGS, nullptr},
   {"_cuda_setStream",    (PyCFunction)THCPModule_setStream_wrap,  METH_O, nullptr},
+  {"_cuda_reserveStream", (PyCFunction)THCPModule_reserveStream_wrap, METH_VARARGS, nullptr},
+  {"_cuda_releaseStream", (PyCFunction)THCPModule_releaseStream_wrap, METH_O, nullptr},
+  {"_cuda_streamWaitCurrent", (PyCFunction)THCPModule_streamWaitCurrent_wrap, METH_O, nullptr},
   {"_cuda_getCompiledVersion", (PyCFunction)THCPModule_getCompiledVersion, METH_NOARGS, nullptr},
   {"_cuda_hasPrimaryContext", (PyCFunction) THCPModule_hasPrimaryContext,  METH_O,  nullptr},
   {"_cuda_emptyCache", (PyCFunction) THCPModule_emptyCache, METH_NOARGS, nullptr},
   {"_cuda_memoryStats", (PyCFunction) THCPModule_memoryStats, METH_O, nullptr},
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction) THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_resetPeakHostMemoryStats", (PyCFunction) THCPModule_resetPeakHostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_setHostMemoryCacheLimit", (PyCFunction) THCPModule_setHostMemoryCacheLimit, METH_O, nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_VARARGS, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", (PyCFunction)THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", (PyCFunction)THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
@@ -12,6 +12,7 @@ using version_tuple = std::tuple<size_t, size_t, size_t>;
 
 #ifdef USE_CUDNN
 #include <cudnn.h>
+#include <ATen/native/cudnn/ConvAlgorithmCache.h>
 
 namespace {
 
@@ -87,6 +88,17 @@ void initCudnnBindings(PyObject* module) {
   cudnn.def("getRuntimeVersion", getRuntimeVersion);
   cudnn.def("getCompileVersion", getCompileVersion);
   cudnn.def("getVersionInt", getVersionInt);
+
+#ifdef USE_CUDNN
+  cudnn.def("save_algorithm_cache", [](const std::string& path) {
+    pybind11::gil_scoped_release no_gil;
+    at::native::cudnn_save_algorithm_cache(path);
+  });
+  cudnn.def("load_algorithm_cache", [](const std::string& path) {
+    pybind11::gil_scoped_release no_gil;
+    return at::native::cudnn_load_algorithm_cache(path);
+  });
+#endif
 }
 
 } // namespace shared
@@ -294,6 +294,11 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
 
   torch::autograd::set_device(torch::autograd::CPU_DEVICE);
   graph_task->owner_ = torch::autograd::CPU_DEVICE;
+  // Coalesces the gradients that the 'recv' functions run back to back send
+  // to the same worker. They are sent before any other function runs, and
+  // before the last task is accounted for, so that the graph task can't be
+  // marked completed while they are held back.
+  RecvRpcBackward::GradientsBatch gradientsBatch;
   while (!cpu_ready_queue->empty()) {
     std::shared_ptr<GraphTask> local_graph_task;
     {
@@ -308,8 +313,14 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
         AutoGradMode grad_mode(local_graph_task->grad_mode_);
         try {
           GraphTaskGuard guard(local_graph_task);
+          if (!dynamic_cast<RecvRpcBackward*>(task.fn_.get())) {
+            gradientsBatch.flush();
+          }
           engine_.evaluate_function(
               local_graph_task, task.fn_.get(), task.inputs_, cpu_ready_queue);
+          if (cpu_ready_queue->empty()) {
+            gradientsBatch.flush();
+          }
         } catch (std::exception& e) {
           engine_.thread_on_exception(local_graph_task, task.fn_, e);
           // break the loop in error so that we immediately stop the execution
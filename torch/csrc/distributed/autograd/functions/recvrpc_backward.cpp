@@ -1,5 +1,6 @@
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <ATen/core/functional.h>
+#include <c10/util/Logging.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
@@ -10,6 +11,53 @@ namespace autograd {
 using torch::autograd::Variable;
 using torch::autograd::variable_list;
 
+namespace {
+
+thread_local RecvRpcBackward::GradientsBatch* currentGradientsBatch = nullptr;
+
+void sendGradients(
+    const ContextPtr& autogradContext,
+    rpc::worker_id_t toWorkerId,
+    PropagateGradientsReq&& gradCall) {
+  auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
+  auto futureMessage = rpcAgent->send(
+      rpcAgent->getWorkerInfo(toWorkerId), std::move(gradCall).toMessage());
+
+  // Record the future in the context.
+  autogradContext->addOutstandingRpc(futureMessage);
+}
+
+} // namespace
+
+RecvRpcBackward::GradientsBatch::GradientsBatch()
+    : previous_(currentGradientsBatch) {
+  currentGradientsBatch = this;
+}
+
+RecvRpcBackward::GradientsBatch::~GradientsBatch() {
+  currentGradientsBatch = previous_;
+  try {
+    flush();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to send the gradients of a backward pass: "
+                 << e.what();
+  }
+}
+
+void RecvRpcBackward::GradientsBatch::flush() {
+  auto pending = std::move(pending_);
+  pending_.clear();
+  for (auto& entry : pending) {
+    auto& entries = entry.second;
+    PropagateGradientsReq gradCall(
+        std::move(entries.autogradMetadata),
+        std::move(entries.grads),
+        entries.autogradContext->retrieveGraphTask()->keep_graph_);
+    sendGradients(
+        entries.autogradContext, entry.first.first, std::move(gradCall));
+  }
+}
+
 RecvRpcBackward::RecvRpcBackward(
     const AutogradMetadata& autogradMetadata,
     ContextPtr autogradContext,
@@ -39,19 +87,20 @@ variable_list RecvRpcBackward::apply(variable_list&& grads) {
           "to an error before RecvRcpBackward had a chance to run"));
 
   // Send the gradients over the wire and record the future in the autograd
-  // context.
-  PropagateGradientsReq gradCall(
-      autogradMetadata_,
-      outputGrads,
-      sharedContext->retrieveGraphTask()->keep_graph_);
-
-  // Send the gradients over to the appropriate node.
-  auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
-  auto futureMessage = rpcAgent->send(
-      rpcAgent->getWorkerInfo(fromWorkerId_), std::move(gradCall).toMessage());
-
-  // Record the future in the context.
-  sharedContext->addOutstandingRpc(futureMessage);
+  // context, or leave them to the batch of this thread.
+  if (auto batch = currentGradientsBatch) {
+    auto& entries = batch->pending_[std::make_pair(
+        fromWorkerId_, autogradMetadata_.autogradContextId)];
+    entries.autogradContext = std::move(sharedContext);
+    entries.autogradMetadata.push_back(autogradMetadata_);
+    entries.grads.push_back(std::move(outputGrads));
+  } else {
+    PropagateGradientsReq gradCall(
+        autogradMetadata_,
+        outputGrads,
+        sharedContext->retrieveGraphTask()->keep_graph_);
+    sendGradients(sharedContext, fromWorkerId_, std::move(gradCall));
+  }
 
   // 'recv' function sends the gradients over the wire using RPC, it doesn't
   // need to return anything for any downstream autograd function.
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/autograd_metadata.h>
@@ -27,6 +29,36 @@ class TORCH_API RecvRpcBackward : public torch::autograd::Node {
   torch::autograd::variable_list apply(
       torch::autograd::variable_list&& grads) override;
 
+  // While a GradientsBatch is alive on a thread, the RecvRpcBackward
+  // functions executed on that thread don't send their gradients right away.
+  // They are kept until flush(), which sends the gradients for each worker
+  // and autograd context in a single message, instead of one message per
+  // function. The distributed engine flushes before it runs any other
+  // function, so that coalescing never delays a message behind local work.
+  class TORCH_API GradientsBatch {
+   public:
+    GradientsBatch();
+    ~GradientsBatch();
+
+    GradientsBatch(const GradientsBatch&) = delete;
+    GradientsBatch& operator=(const GradientsBatch&) = delete;
+
+    void flush();
+
+   private:
+    friend class RecvRpcBackward;
+
+    struct Entries {
+      std::shared_ptr<DistAutogradContext> autogradContext;
+      std::vector<AutogradMetadata> autogradMetadata;
+      std::vector<torch::autograd::variable_list> grads;
+    };
+
+    // By worker id and autograd context id.
+    std::map<std::pair<rpc::worker_id_t, int64_t>, Entries> pending_;
+    GradientsBatch* previous_;
+  };
+
  private:
   const AutogradMetadata autogradMetadata_;
 
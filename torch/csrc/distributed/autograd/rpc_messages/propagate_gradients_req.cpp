@@ -14,20 +14,49 @@ PropagateGradientsReq::PropagateGradientsReq(
     const AutogradMetadata& autogradMetadata,
     std::vector<Variable> grads,
     bool retainGraph)
-    : autogradMetadata_(autogradMetadata),
+    : autogradMetadata_({autogradMetadata}), retainGraph_(retainGraph) {
+  grads_.emplace_back(std::move(grads));
+}
+
+PropagateGradientsReq::PropagateGradientsReq(
+    std::vector<AutogradMetadata> autogradMetadata,
+    std::vector<std::vector<Variable>> grads,
+    bool retainGraph)
+    : autogradMetadata_(std::move(autogradMetadata)),
       grads_(std::move(grads)),
-      retainGraph_(retainGraph) {}
+      retainGraph_(retainGraph) {
+  TORCH_INTERNAL_ASSERT(
+      !autogradMetadata_.empty() && autogradMetadata_.size() == grads_.size());
+  for (const auto& metadata : autogradMetadata_) {
+    TORCH_INTERNAL_ASSERT(
+        metadata.autogradContextId == autogradMetadata_[0].autogradContextId,
+        "All gradients in a PropagateGradientsReq must belong to the same "
+        "autograd context");
+  }
+}
 
 Message PropagateGradientsReq::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
   // Add all the grad tensors.
-  for (const auto& grad : grads_) {
-    ivalues.emplace_back(grad);
+  for (const auto& entryGrads : grads_) {
+    for (const auto& grad : entryGrads) {
+      ivalues.emplace_back(grad);
+    }
   }
 
-  // Now add autograd metadata.
-  ivalues.emplace_back(autogradMetadata_.autogradContextId);
-  ivalues.emplace_back(autogradMetadata_.autogradMessageId);
+  // Now add autograd metadata. A batch also records the number of gradients
+  // of every entry, and the number of entries.
+  const bool isBatch = numEntries() > 1;
+  ivalues.emplace_back(autogradMetadata_[0].autogradContextId);
+  for (size_t i = 0; i < numEntries(); i++) {
+    ivalues.emplace_back(autogradMetadata_[i].autogradMessageId);
+    if (isBatch) {
+      ivalues.emplace_back(static_cast<int64_t>(grads_[i].size()));
+    }
+  }
+  if (isBatch) {
+    ivalues.emplace_back(static_cast<int64_t>(numEntries()));
+  }
 
   // Add retain graph.
   ivalues.emplace_back(retainGraph_);
@@ -40,7 +69,8 @@ Message PropagateGradientsReq::toMessageImpl() && {
   return Message(
       std::move(payload),
       std::move(tensorTable),
-      MessageType::BACKWARD_AUTOGRAD_REQ);
+      isBatch ? MessageType::BACKWARD_AUTOGRAD_BATCH_REQ
+              : MessageType::BACKWARD_AUTOGRAD_REQ);
 }
 
 std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
@@ -54,6 +84,8 @@ std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
       *rpc::RpcAgent::getCurrentRpcAgent()->getTypeResolver(),
       &message.tensors());
   std::vector<at::IValue> tupleElements = tuple.toTuple()->elements();
+  const bool isBatch =
+      message.type() == MessageType::BACKWARD_AUTOGRAD_BATCH_REQ;
 
   // Build PropagateGradientsReq.
   TORCH_INTERNAL_ASSERT(tupleElements.size() >= 3);
@@ -62,32 +94,69 @@ std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
   bool retainGraph = tupleElements.back().toBool();
   tupleElements.pop_back();
 
-  // Build AutogradMetadata.
-  int64_t autogradContextId, autogradMessageId;
-  autogradMessageId = tupleElements.back().toInt();
-  tupleElements.pop_back();
-  autogradContextId = tupleElements.back().toInt();
-  tupleElements.pop_back();
+  size_t numEntries = 1;
+  if (isBatch) {
+    numEntries = tupleElements.back().toInt();
+    tupleElements.pop_back();
+  }
 
-  AutogradMetadata autogradMetadata(autogradContextId, autogradMessageId);
+  // Retrieve the message ids of the entries, and the number of gradients of
+  // each of them, from the last one.
+  std::vector<int64_t> autogradMessageIds(numEntries);
+  std::vector<size_t> numGrads(numEntries);
+  for (size_t i = numEntries; i-- > 0;) {
+    if (isBatch) {
+      numGrads[i] = tupleElements.back().toInt();
+      tupleElements.pop_back();
+    }
+    autogradMessageIds[i] = tupleElements.back().toInt();
+    tupleElements.pop_back();
+  }
+  int64_t autogradContextId = tupleElements.back().toInt();
+  tupleElements.pop_back();
+  if (!isBatch) {
+    numGrads[0] = tupleElements.size();
+  }
 
-  // Retrieve the gradient tensors.
-  std::vector<Variable> grads(tupleElements.size());
-  for (size_t i = 0; i < tupleElements.size(); i++) {
-    grads[i] = tupleElements[i].toTensor();
+  // Build the AutogradMetadata and retrieve the gradient tensors.
+  std::vector<AutogradMetadata> autogradMetadata;
+  std::vector<std::vector<Variable>> grads(numEntries);
+  autogradMetadata.reserve(numEntries);
+  size_t offset = 0;
+  for (size_t i = 0; i < numEntries; i++) {
+    autogradMetadata.emplace_back(autogradContextId, autogradMessageIds[i]);
+    grads[i].reserve(numGrads[i]);
+    for (size_t j = 0; j < numGrads[i]; j++) {
+      grads[i].emplace_back(tupleElements[offset++].toTensor());
+    }
   }
+  TORCH_INTERNAL_ASSERT(offset == tupleElements.size());
 
-  return std::unique_ptr<PropagateGradientsReq>(
-      new PropagateGradientsReq(autogradMetadata, grads, retainGraph));
+  return std::unique_ptr<PropagateGradientsReq>(new PropagateGradientsReq(
+      std::move(autogradMetadata), std::move(grads), retainGraph));
 }
 
 const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata() {
-  return autogradMetadata_;
+  return autogradMetadata_[0];
 }
 
 const std::vector<torch::autograd::Variable>& PropagateGradientsReq::
     getGrads() {
-  return grads_;
+  return grads_[0];
+}
+
+size_t PropagateGradientsReq::numEntries() const {
+  return autogradMetadata_.size();
+}
+
+const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata(
+    size_t entry) {
+  return autogradMetadata_.at(entry);
+}
+
+const std::vector<torch::autograd::Variable>& PropagateGradientsReq::getGrads(
+    size_t entry) {
+  return grads_.at(entry);
 }
 
 bool PropagateGradientsReq::retainGraph() {
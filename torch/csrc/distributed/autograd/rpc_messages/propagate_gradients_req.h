@@ -12,6 +12,11 @@ namespace autograd {
 // Used to propagate gradients from one node to another during a distributed
 // backwards pass. This RPC call is invoked when we hit a `recv` autograd
 // function during backward pass execution.
+//
+// The gradients of several `recv` functions of the same autograd context can
+// be sent in one request, with one entry per function. A request with a
+// single entry is a BACKWARD_AUTOGRAD_REQ, and one with more entries a
+// BACKWARD_AUTOGRAD_BATCH_REQ.
 class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
  public:
   PropagateGradientsReq(
@@ -19,10 +24,22 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
       std::vector<torch::autograd::Variable> grads,
       bool retainGraph = false);
 
+  PropagateGradientsReq(
+      std::vector<AutogradMetadata> autogradMetadata,
+      std::vector<std::vector<torch::autograd::Variable>> grads,
+      bool retainGraph = false);
+
+  // The metadata and gradients of the first entry.
   const AutogradMetadata& getAutogradMetadata();
 
   const std::vector<torch::autograd::Variable>& getGrads();
 
+  size_t numEntries() const;
+
+  const AutogradMetadata& getAutogradMetadata(size_t entry);
+
+  const std::vector<torch::autograd::Variable>& getGrads(size_t entry);
+
   // Serialization and deserialization methods.
   rpc::Message toMessageImpl() && override;
   static std::unique_ptr<PropagateGradientsReq> fromMessage(
@@ -32,8 +49,8 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
   bool retainGraph();
 
  private:
-  AutogradMetadata autogradMetadata_;
-  std::vector<torch::autograd::Variable> grads_;
+  std::vector<AutogradMetadata> autogradMetadata_;
+  std::vector<std::vector<torch::autograd::Variable>> grads_;
   bool retainGraph_;
 };
 
@@ -80,10 +80,10 @@ void broadcast_coalesced(
   }
 }
 
-GradBucket::GradBucket(std::vector<at::Tensor> tensors)
-    : tensors_(std::move(tensors)){};
+GradBucket::GradBucket(std::vector<at::Tensor> tensors, size_t index)
+    : tensors_(std::move(tensors)), index_(index){};
 
-const std::vector<at::Tensor>& GradBucket::getTensors() {
+const std::vector<at::Tensor>& GradBucket::getTensors() const {
   return tensors_;
 }
 
@@ -20,15 +20,23 @@ void broadcast_coalesced(
 // mappings as well.
 class GradBucket {
  public:
-  explicit GradBucket(std::vector<at::Tensor> tensors);
+  explicit GradBucket(std::vector<at::Tensor> tensors, size_t index = 0);
   // Each tensor in the list that getTensors returns refers to the replica on
   // each device. There will be multiple replicas only in the case of single
   // process multiple device mode. In the single process single device mode,
   // this list would consist of only a single tensor.
-  const std::vector<at::Tensor>& getTensors();
+  const std::vector<at::Tensor>& getTensors() const;
+
+  // Position of the bucket in the reducer's bucket order. Buckets are reduced
+  // in this order every iteration, so hooks can use it to key state kept
+  // across iterations (e.g. error feedback).
+  size_t getIndex() const {
+    return index_;
+  }
 
  private:
   std::vector<at::Tensor> tensors_;
+  size_t index_;
 };
 
 // DDP's c10d reducer allows communcation hooks defined as a sub class
@@ -0,0 +1,211 @@
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
+
+#include <cmath>
+#include <mutex>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/core/functional.h>
+
+namespace c10d {
+namespace {
+
+// Future of communication that was kicked off by runHook. It is completed
+// lazily: the first wait() (or value()) waits for `work` and then runs
+// `then`, whose result is the new contents of the bucket. This follows
+// FutureNCCL, which also waits inline, and works for process groups whose
+// Work does not implement getFuture().
+class WorkFuture : public torch::jit::Future {
+ public:
+  WorkFuture(
+      std::shared_ptr<ProcessGroup::Work> work,
+      std::function<std::vector<at::Tensor>()> then)
+      : torch::jit::Future(c10::ListType::create(c10::TensorType::get())),
+        work_(std::move(work)),
+        then_(std::move(then)) {}
+
+  void wait() override {
+    finish();
+  }
+
+  at::IValue value() override {
+    finish();
+    return torch::jit::Future::value();
+  }
+
+  const at::IValue& constValue() override {
+    finish();
+    return torch::jit::Future::constValue();
+  }
+
+  void addCallback(std::function<void(void)> callback) override {
+    finish();
+    torch::jit::Future::addCallback(std::move(callback));
+  }
+
+ private:
+  void finish() {
+    std::call_once(finished_, [this] {
+      try {
+        work_->wait();
+        markCompleted(at::IValue(then_()));
+      } catch (const std::exception& e) {
+        setError(e.what());
+      }
+    });
+  }
+
+  std::shared_ptr<ProcessGroup::Work> work_;
+  std::function<std::vector<at::Tensor>()> then_;
+  std::once_flag finished_;
+};
+
+at::Tensor inverse_world_size(const std::shared_ptr<ProcessGroup>& pg) {
+  // imitates wrapped_scalar_tensor in ATen/native/BinaryOps.cpp
+  auto wrapped = c10::scalar_to_tensor(double(1.) / pg->getSize());
+  wrapped.unsafeGetTensorImpl()->set_wrapped_number(true);
+  return wrapped;
+}
+
+// Orthonormalizes the columns of `matrix` in place with Gram-Schmidt. The
+// matrices PowerSGD orthogonalizes have only `matrix_approximation_rank`
+// columns, so this is a handful of small kernels.
+void orthogonalize(at::Tensor& matrix, double eps = 1e-8) {
+  const auto num_cols = matrix.size(1);
+  for (int64_t i = 0; i < num_cols; i++) {
+    auto col = matrix.narrow(1, i, 1);
+    col.div_(col.norm().add_(eps));
+    if (i + 1 < num_cols) {
+      auto rest = matrix.narrow(1, i + 1, num_cols - i - 1);
+      rest.sub_(col * (col * rest).sum(0, /*keepdim=*/true));
+    }
+  }
+}
+
+} // namespace
+
+c10::intrusive_ptr<torch::jit::Future> CppCommHook::allreduceAverage(
+    std::vector<at::Tensor> tensors) {
+  const auto wrapped = inverse_world_size(process_group_);
+  for (auto& tensor : tensors) {
+    tensor.mul_(wrapped);
+  }
+  auto work = process_group_->allreduce(tensors);
+  return c10::make_intrusive<WorkFuture>(
+      std::move(work), [tensors]() { return tensors; });
+}
+
+c10::intrusive_ptr<torch::jit::Future> AllreduceCommHook::runHook(
+    const GradBucket& bucket) {
+  return allreduceAverage(bucket.getTensors());
+}
+
+c10::intrusive_ptr<torch::jit::Future> FP16CompressCommHook::runHook(
+    const GradBucket& bucket) {
+  const auto& tensors = bucket.getTensors();
+  if (tensors.front().is_sparse()) {
+    return allreduceAverage(tensors);
+  }
+
+  const auto wrapped = inverse_world_size(process_group_);
+  std::vector<at::Tensor> compressed;
+  compressed.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    // Divides while casting, so large gradients do not overflow in half.
+    auto half = at::empty_like(tensor, tensor.options().dtype(at::kHalf));
+    at::mul_out(half, tensor, wrapped);
+    compressed.push_back(std::move(half));
+  }
+
+  auto work = process_group_->allreduce(compressed);
+  return c10::make_intrusive<WorkFuture>(
+      std::move(work), [tensors, compressed]() {
+        for (size_t i = 0; i < tensors.size(); i++) {
+          tensors[i].copy_(compressed[i]);
+        }
+        return tensors;
+      });
+}
+
+PowerSGDCommHook::PowerSGDCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    PowerSGDOptions options)
+    : CppCommHook(std::move(process_group)), options_(options) {
+  TORCH_CHECK(
+      options_.matrix_approximation_rank > 0,
+      "PowerSGD matrix_approximation_rank must be positive, but got ",
+      options_.matrix_approximation_rank);
+}
+
+c10::intrusive_ptr<torch::jit::Future> PowerSGDCommHook::runHook(
+    const GradBucket& bucket) {
+  if (bucket.getIndex() == 0) {
+    iter_++;
+  }
+
+  const auto& tensors = bucket.getTensors();
+  // The reducer only allows hooks in single process single device mode.
+  TORCH_INTERNAL_ASSERT(tensors.size() == 1);
+  auto input = tensors.front();
+  if (iter_ <= options_.start_powerSGD_iter || input.is_sparse()) {
+    return allreduceAverage(tensors);
+  }
+
+  // View the bucket as an m x k matrix, padding it with zeros at the end.
+  const auto n = input.numel();
+  const auto m = static_cast<int64_t>(std::ceil(std::sqrt(double(n))));
+  const auto k = (n + m - 1) / m;
+  const auto r = std::min({options_.matrix_approximation_rank, m, k});
+  if ((m + k) * r >= n) {
+    // Sending the factors would not be cheaper than sending the bucket.
+    return allreduceAverage(tensors);
+  }
+
+  auto& state = bucket_states_[bucket.getIndex()];
+  // Buckets are rebuilt after the first iteration, so a bucket index may map
+  // to a bucket of a different size later on.
+  if (state.q.defined() &&
+      (state.q.size(0) != k || state.q.size(1) != r ||
+       state.error.numel() != n)) {
+    state = BucketState();
+  }
+  if (!state.q.defined()) {
+    // Every rank has to start from the same Q.
+    auto generator = at::detail::createCPUGenerator(
+        options_.random_seed + bucket.getIndex());
+    state.q = at::randn({k, r}, generator, input.options().device(at::kCPU))
+                  .to(input.device());
+    state.error = at::zeros_like(input);
+  }
+
+  if (options_.use_error_feedback) {
+    input.add_(state.error);
+  }
+  auto matrix = at::zeros({m * k}, input.options());
+  matrix.narrow(0, 0, n).copy_(input);
+  matrix = matrix.view({m, k});
+
+  auto p = at::matmul(matrix, state.q);
+  std::vector<at::Tensor> p_list = {p};
+  auto work = process_group_->allreduce(p_list);
+
+  const auto use_error_feedback = options_.use_error_feedback;
+  return c10::make_intrusive<WorkFuture>(
+      std::move(work),
+      [this, &state, input, matrix, p, n, use_error_feedback]() mutable {
+        orthogonalize(p);
+        std::vector<at::Tensor> q_list = {at::matmul(matrix.t(), p)};
+        process_group_->allreduce(q_list)->wait();
+        auto& q = q_list.front();
+        q.div_(process_group_->getSize());
+        state.q = q;
+
+        auto approx = at::matmul(p, q.t()).view(-1).narrow(0, 0, n);
+        if (use_error_feedback) {
+          state.error = input - approx;
+        }
+        input.copy_(approx);
+        return std::vector<at::Tensor>{input};
+      });
+}
+
+} // namespace c10d
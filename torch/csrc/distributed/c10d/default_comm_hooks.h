@@ -0,0 +1,111 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/c10d/comm.h>
+
+namespace c10d {
+
+// Communication hooks that ship with DDP. They are implemented in C++, so
+// running them does not take the GIL or convert tensors to Python objects for
+// every bucket. Register them with `Reducer::register_comm_hook` (or
+// `DistributedDataParallel._register_builtin_comm_hook` from Python).
+enum class BuiltinCommHookType {
+  ALLREDUCE = 1,
+  FP16_COMPRESS = 2,
+  POWER_SGD = 3,
+};
+
+// Base class of the built-in hooks. The futures they return hold the new
+// contents of the bucket as a list of tensors.
+class TORCH_API CppCommHook : public CommHookInterface {
+ public:
+  explicit CppCommHook(std::shared_ptr<ProcessGroup> process_group)
+      : process_group_(std::move(process_group)) {}
+
+  ~CppCommHook() override {}
+
+  std::vector<at::Tensor> processFuture(c10::IValue future_value) override {
+    return future_value.toTensorVector();
+  }
+
+ protected:
+  // Allreduces the bucket tensors averaged over the process group, which is
+  // what the reducer does when no hook is registered.
+  c10::intrusive_ptr<torch::jit::Future> allreduceAverage(
+      std::vector<at::Tensor> tensors);
+
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// Allreduces the bucket exactly like the reducer's default path. Mainly useful
+// as a baseline when comparing other hooks.
+class TORCH_API AllreduceCommHook : public CppCommHook {
+ public:
+  using CppCommHook::CppCommHook;
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+};
+
+// Casts the bucket to half precision before the allreduce and back to the
+// bucket's dtype afterwards, halving the bytes sent. The bucket is divided by
+// the world size before the cast so the sum stays in range.
+class TORCH_API FP16CompressCommHook : public CppCommHook {
+ public:
+  using CppCommHook::CppCommHook;
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+};
+
+struct TORCH_API PowerSGDOptions {
+  // Rank r of the approximation. Each bucket of n elements is viewed as a
+  // roughly square m x k matrix and sent as two factors of m x r and k x r.
+  int64_t matrix_approximation_rank = 1;
+  // Number of iterations that run plain allreduce before compression starts.
+  // Compressing from the very first step tends to hurt accuracy.
+  int64_t start_powerSGD_iter = 10;
+  // Adds the compression error of the previous iteration back to the bucket
+  // before compressing it.
+  bool use_error_feedback = true;
+  // Seeds the initial Q factors, which must be the same on every rank.
+  uint64_t random_seed = 0;
+};
+
+// PowerSGD (Vogels et al., NeurIPS 2019): one step of power iteration per
+// iteration computes a rank-r approximation P Q^T of the (averaged) gradient
+// matrix M:
+//
+//   P = allreduce(M Q);  P = orthogonalize(P)
+//   Q = allreduce(M^T P) / world_size
+//   M ~= P Q^T
+//
+// Q is kept between iterations (warm start), so one step per iteration is
+// enough for a good approximation. Buckets too small to benefit from
+// compression, and sparse buckets, are allreduced as is.
+class TORCH_API PowerSGDCommHook : public CppCommHook {
+ public:
+  PowerSGDCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      PowerSGDOptions options);
+
+  c10::intrusive_ptr<torch::jit::Future> runHook(
+      const GradBucket& bucket) override;
+
+ private:
+  struct BucketState {
+    // Q factor of the last iteration, k x r.
+    at::Tensor q;
+    // M - P Q^T of the last iteration, n elements.
+    at::Tensor error;
+  };
+
+  PowerSGDOptions options_;
+  // Counts iterations; bucket 0 is the first one reduced in each iteration.
+  int64_t iter_ = 0;
+  std::unordered_map<size_t, BucketState> bucket_states_;
+};
+
+} // namespace c10d
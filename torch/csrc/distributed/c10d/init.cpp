@@ -23,6 +23,7 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/default_comm_hooks.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/object_ptr.h>
@@ -36,6 +37,9 @@ namespace {
 
 #ifdef USE_C10D_GLOO
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+// Number of devices, each with its own connections and I/O thread, created
+// for every interface, see ProcessGroupGloo::Options::allreduceStripeMinBytes
+constexpr char* GLOO_SOCKET_NUM_CHANNELS_ENV = "GLOO_SOCKET_NUM_CHANNELS";
 #endif
 
 std::vector<std::string> split(char separator, const std::string& string) {
@@ -121,6 +125,32 @@ void _register_comm_hook(
       std::move(state), std::move(comm_hook)));
 };
 
+// Registers one of the C++ communication hooks in default_comm_hooks.h on the
+// reducer. Unlike _register_comm_hook, running these hooks never enters
+// Python.
+void _register_builtin_comm_hook(
+    ::c10d::Reducer& reducer,
+    std::shared_ptr<::c10d::ProcessGroup> process_group,
+    ::c10d::BuiltinCommHookType comm_hook_type,
+    const ::c10d::PowerSGDOptions& power_sgd_options) {
+  switch (comm_hook_type) {
+    case ::c10d::BuiltinCommHookType::ALLREDUCE:
+      reducer.register_comm_hook(std::make_unique<::c10d::AllreduceCommHook>(
+          std::move(process_group)));
+      return;
+    case ::c10d::BuiltinCommHookType::FP16_COMPRESS:
+      reducer.register_comm_hook(
+          std::make_unique<::c10d::FP16CompressCommHook>(
+              std::move(process_group)));
+      return;
+    case ::c10d::BuiltinCommHookType::POWER_SGD:
+      reducer.register_comm_hook(std::make_unique<::c10d::PowerSGDCommHook>(
+          std::move(process_group), power_sgd_options));
+      return;
+  }
+  TORCH_CHECK(false, "Unknown built-in communication hook type.");
+};
+
 PyObject* c10d_init(PyObject* _unused) {
   C10_LOG_API_USAGE_ONCE("c10d.python.import");
   auto c10d_module = THPObjectPtr(PyImport_ImportModule("torch.distributed"));
@@ -137,8 +167,46 @@ PyObject* c10d_init(PyObject* _unused) {
       py::arg("state"),
       py::arg("comm_hook"));
 
+  py::enum_<::c10d::BuiltinCommHookType>(module, "BuiltinCommHookType", R"(
+An enum-like class of the DDP communication hooks implemented in C++:
+``ALLREDUCE``, ``FP16_COMPRESS`` and ``POWER_SGD``.)")
+      .value("ALLREDUCE", ::c10d::BuiltinCommHookType::ALLREDUCE)
+      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS)
+      .value("POWER_SGD", ::c10d::BuiltinCommHookType::POWER_SGD);
+
+  py::class_<::c10d::PowerSGDOptions>(module, "PowerSGDOptions")
+      .def(py::init<>())
+      .def_readwrite(
+          "matrix_approximation_rank",
+          &::c10d::PowerSGDOptions::matrix_approximation_rank)
+      .def_readwrite(
+          "start_powerSGD_iter", &::c10d::PowerSGDOptions::start_powerSGD_iter)
+      .def_readwrite(
+          "use_error_feedback", &::c10d::PowerSGDOptions::use_error_feedback)
+      .def_readwrite("random_seed", &::c10d::PowerSGDOptions::random_seed);
+
+  module.def(
+      "_register_builtin_comm_hook",
+      &_register_builtin_comm_hook,
+      py::arg("reducer"),
+      py::arg("process_group"),
+      py::arg("comm_hook_type"),
+      py::arg("power_sgd_options") = ::c10d::PowerSGDOptions(),
+      py::call_guard<py::gil_scoped_release>());
+
   shared_ptr_class_<::c10d::GradBucket>(module, "_GradBucket")
-      .def(py::init<std::vector<Tensor>&>(), py::arg("tensors"))
+      .def(
+          py::init<std::vector<Tensor>&, size_t>(),
+          py::arg("tensors"),
+          py::arg("index") = 0)
+      .def(
+          "get_index",
+          &::c10d::GradBucket::getIndex,
+          R"(
+            ``get_index`` returns the position of the bucket in the order in
+            which the reducer reduces buckets. It is stable across iterations
+            until the buckets are rebuilt.
+           )")
       .def(
           "get_tensors",
           &::c10d::GradBucket::getTensors,
@@ -159,6 +227,7 @@ PyObject* c10d_init(PyObject* _unused) {
               std::shared_ptr<::c10d::ProcessGroup>,
               std::vector<std::vector<bool>>,
               int64_t,
+              bool,
               bool>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
@@ -166,6 +235,7 @@ PyObject* c10d_init(PyObject* _unused) {
           py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
           py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap,
           py::arg("find_unused_parameters") = false,
+          py::arg("gradient_as_bucket_view") = false,
           py::call_guard<py::gil_scoped_release>())
       .def(
           "initialize_buckets",
@@ -180,7 +250,12 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def(
+          "_enable_adaptive_bucketing",
+          &::c10d::Reducer::enable_adaptive_bucketing,
+          py::arg("rebuild_interval"),
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -294,7 +369,55 @@ They are used in specifying strategies for reduction collectives, e.g.,
                  const std::chrono::milliseconds& timeout) {
                 store.wait(keys, timeout);
               },
-              py::call_guard<py::gil_scoped_release>());
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(
+                          expected_value.begin(), expected_value.end()),
+                      std::vector<uint8_t>(
+                          desired_value.begin(), desired_value.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<char*>(value.data()), value.size());
+              });
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
       .def(py::init<const std::string&, int>());
@@ -387,6 +510,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("opts") = ::c10d::AllreduceCoalescedOptions(),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "broadcast_coalesced",
+              &::c10d::ProcessGroup::broadcast_coalesced,
+              py::arg("tensors"),
+              py::arg("opts") = ::c10d::BroadcastOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "reduce",
               &::c10d::ProcessGroup::reduce,
@@ -608,7 +738,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "allreduce_stripe_min_bytes",
+          &::c10d::ProcessGroupGloo::Options::allreduceStripeMinBytes)
+      .def_readwrite(
+          "allreduce_ring_min_bytes",
+          &::c10d::ProcessGroupGloo::Options::allreduceRingMinBytes);
 
   processGroupGloo.def_static(
       "create_device",
@@ -639,19 +775,29 @@ They are used in specifying strategies for reduction collectives, e.g.,
                       std::chrono::milliseconds timeout) {
             ::c10d::ProcessGroupGloo::Options options;
 
+            int numChannels = 1;
+            char* numChannelsEnv = getenv(GLOO_SOCKET_NUM_CHANNELS_ENV);
+            if (numChannelsEnv) {
+              numChannels = std::max(std::stoi(numChannelsEnv), 1);
+            }
+
             // Use interfaces listed in "GLOO_SOCKET_IFNAME", if set.
             char* ifnameEnv = getenv(GLOO_SOCKET_IFNAME_ENV);
-            if (ifnameEnv) {
-              for (const auto& iface : split(',', ifnameEnv)) {
+            for (int i = 0; i < numChannels; i++) {
+              if (ifnameEnv) {
+                for (const auto& iface : split(',', ifnameEnv)) {
+                  options.devices.push_back(
+                      ::c10d::ProcessGroupGloo::createDeviceForInterface(
+                          iface));
+                }
+              } else {
+                // If no hostname is specified, this function looks up
+                // the machine's hostname and returns a device instance
+                // associated with the address that the hostname resolves
+                // to.
                 options.devices.push_back(
-                    ::c10d::ProcessGroupGloo::createDeviceForInterface(iface));
+                    ::c10d::ProcessGroupGloo::createDefaultDevice());
               }
-            } else {
-              // If no hostname is specified, this function looks up
-              // the machine's hostname and returns a device instance
-              // associated with the address that the hostname resolves to.
-              options.devices.push_back(
-                  ::c10d::ProcessGroupGloo::createDefaultDevice());
             }
 
             options.timeout = timeout;
@@ -666,8 +812,34 @@ They are used in specifying strategies for reduction collectives, e.g.,
 #endif
 
 #ifdef USE_C10D_NCCL
-  shared_ptr_class_<::c10d::ProcessGroupNCCL>(
-      module, "ProcessGroupNCCL", processGroup)
+  auto processGroupNCCL = shared_ptr_class_<::c10d::ProcessGroupNCCL>(
+      module, "ProcessGroupNCCL", processGroup);
+
+  shared_ptr_class_<::c10d::ProcessGroupNCCL::Options>(
+      processGroupNCCL, "Options")
+      .def(py::init<>())
+      .def_readwrite("timeout", &::c10d::ProcessGroupNCCL::Options::opTimeout)
+      .def_readwrite(
+          "hierarchical_allreduce_local_size",
+          &::c10d::ProcessGroupNCCL::Options::hierarchicalAllreduceLocalSize)
+      .def_readwrite(
+          "hierarchical_allreduce_min_bytes",
+          &::c10d::ProcessGroupNCCL::Options::hierarchicalAllreduceMinBytes)
+      .def_readwrite(
+          "lightweight_work",
+          &::c10d::ProcessGroupNCCL::Options::lightweightWork);
+
+  processGroupNCCL
+      .def(
+          py::init<
+              const std::shared_ptr<::c10d::Store>&,
+              int,
+              int,
+              const ::c10d::ProcessGroupNCCL::Options&>(),
+          py::arg("store"),
+          py::arg("rank"),
+          py::arg("size"),
+          py::arg("options"))
       .def(
           py::init<
               const std::shared_ptr<::c10d::Store>&,
@@ -678,7 +850,28 @@ They are used in specifying strategies for reduction collectives, e.g.,
           py::arg("rank"),
           py::arg("size"),
           py::arg("timeout") = std::chrono::milliseconds(
-              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis));
+              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis))
+      .def(
+          "_split",
+          [](::c10d::ProcessGroupNCCL& pg,
+             const std::shared_ptr<::c10d::Store>& store,
+             const std::vector<int>& ranks,
+             int64_t deviceIndex,
+             const ::c10d::ProcessGroupNCCL::Options& options) {
+            return pg.split(
+                store,
+                ranks,
+                at::Device(at::kCUDA, static_cast<at::DeviceIndex>(deviceIndex)),
+                options);
+          },
+          py::arg("store"),
+          py::arg("ranks"),
+          py::arg("device_index"),
+          py::arg("options"),
+          py::call_guard<py::gil_scoped_release>())
+      .def_static(
+          "_is_comm_split_supported",
+          &::c10d::ProcessGroupNCCL::isCommSplitSupported);
 #endif
 
 #ifdef USE_C10D_MPI
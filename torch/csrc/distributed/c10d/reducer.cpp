@@ -1,6 +1,7 @@
 #include <torch/csrc/distributed/c10d/reducer.h>
 
 #include <functional>
+#include <numeric>
 
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
@@ -30,7 +31,8 @@ Reducer::Reducer(
     std::shared_ptr<c10d::ProcessGroup> process_group,
     std::vector<std::vector<bool>> expect_sparse_gradients,
     int64_t bucket_bytes_cap,
-    bool find_unused_parameters)
+    bool find_unused_parameters,
+    bool gradient_as_bucket_view)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
@@ -39,10 +41,13 @@ Reducer::Reducer(
       next_bucket_(0),
       has_marked_unused_parameters_(false),
       find_unused_parameters_(find_unused_parameters),
+      gradient_as_bucket_view_(gradient_as_bucket_view),
       local_used_maps_reduced_(false),
       backward_stats_base_(0),
       has_rebuilt_bucket_(false),
       bucket_bytes_cap_(bucket_bytes_cap),
+      bucket_rebuild_interval_(0),
+      num_adaptive_iterations_(0),
       comm_hook_(nullptr) {
   C10_LOG_API_USAGE_ONCE("torch.distributed.ddp.reducer");
   TORCH_CHECK(replicas_.size() >= 1, "Expected at least one model replica.");
@@ -92,6 +97,14 @@ Reducer::Reducer(
         auto grad_accumulator =
             torch::autograd::impl::grad_accumulator(variable);
 
+        // See Note [Gradients as bucket views]
+        if (gradient_as_bucket_view_) {
+          if (auto accumulate_grad = std::dynamic_pointer_cast<
+                  torch::autograd::AccumulateGrad>(grad_accumulator)) {
+            accumulate_grad->accumulate_in_place = true;
+          }
+        }
+
         using torch::distributed::autograd::ThreadLocalDistAutogradContext;
         // Hook to execute after the gradient accumulator has executed.
         hooks_.emplace_back(
@@ -185,7 +198,34 @@ Reducer::Reducer(
 // used for algorithms like Gradient Compression/GossipGrad. This hook can be
 // registered from Python API using `register_comm_hook`. `PythonCommHook`
 // enables registering a Python hook and is a sub class of `CommHookInterface`.
-// `CommHookInterface` can be used to implement CPP hooks in the future.
+// Built-in C++ hooks (see default_comm_hooks.h) are sub classes of
+// `CommHookInterface` as well, and skip the Python round trip per bucket.
+
+// Note [Adaptive bucketing]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Buckets are reduced in order, so a bucket holding a gradient that becomes
+// ready late holds up every bucket after it. With find_unused_parameters=False
+// the buckets are rebuilt once, in the gradient ready order of the first
+// iteration. With find_unused_parameters=True that order changes from one
+// iteration to the next (e.g. in models with conditional branches), so the
+// one-off rebuild is skipped and the initial assignment is kept forever.
+//
+// Adaptive bucketing instead learns the order across iterations. Every time
+// a variable of replica 0 is marked ready (through its autograd hook, or in
+// bulk when unused parameters are marked), its relative position in the
+// iteration is recorded, and a moving average of that position is kept per
+// variable. Every bucket_rebuild_interval_ iterations, the variables are
+// sorted by average position and packed into buckets with
+// compute_bucket_assignment_by_size.
+//
+// The assignment must be identical on all processes, so rank 0's plan is
+// broadcast. Unlike rebuildBuckets, the broadcast does not block: it is
+// kicked off at the end of the backward pass and only waited on in the next
+// prepare_for_backward, by which time the forward pass has hidden it. The
+// plan is applied only if it differs from the current assignment. The plan
+// is encoded in a fixed size tensor of 2 * num_variables + 1 ints
+// (num_buckets, the bucket sizes padded with zeros, then the indices), so
+// every rank knows the size of the broadcast up front.
 
 Reducer::~Reducer() noexcept(false) {
   // Remove all hooks on variables registered by this Reducer. This is necessary
@@ -320,6 +360,15 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
   // as part of the current backwards pass, and zero the part
   // of the bucket it would otherwise hold.
   runGradCallbackForVariable(variable, [&](auto& grad) {
+    // See Note [Gradients as bucket views]
+    if (gradient_as_bucket_view_ && grad.defined() &&
+        grad.is_alias_of(bucket_view)) {
+      // The gradient was accumulated into the bucket in place.
+      if (comm_hook_ == nullptr) {
+        bucket_view.div_(process_group_->getSize());
+      }
+      return false;
+    }
     if (grad.defined()) {
       // Ensure that the gradient type matches the bucket type.
       TORCH_CHECK(
@@ -328,10 +377,8 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
           bucket_view.toString(),
           ", got ",
           grad.toString());
-      // Assert that the grad tensor and the bucket don't share storage.
-      // If they did, we could avoid the copy altogether.
-      // The reason for not doing this is that existing code calls
-      // `detach_` from `zero_grad`, which is incompatible with views.
+      // Unless gradient_as_bucket_view is set, the grad tensor and the
+      // bucket don't share storage.
       TORCH_INTERNAL_ASSERT(!grad.is_alias_of(bucket_view));
       TORCH_INTERNAL_ASSERT(grad.device() == bucket_view.device());
       TORCH_INTERNAL_ASSERT(grad.numel() == bucket_view.numel());
@@ -366,6 +413,11 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
       } else {
         bucket_view.copy_(grad);
       }
+      if (gradient_as_bucket_view_) {
+        // From now on the gradient is accumulated into the bucket directly.
+        grad = bucket_view;
+        return true;
+      }
     } else {
       bucket_view.zero_();
     }
@@ -467,6 +519,11 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   backward_stats_[replica_index][variable_index] =
       current_time_in_nanos() - backward_stats_base_;
 
+  // See Note [Adaptive bucketing]
+  if (bucket_rebuild_interval_ > 0 && replica_index == 0) {
+    ready_order_.push_back(variable_index);
+  }
+
   // Any time we mark a variable ready (be it in line due to unused parameters,
   // or via an autograd hook), we require a call to the finalize function. If
   // this doesn't happen before the next iteration (or call to
@@ -556,6 +613,10 @@ void Reducer::mark_variable_ready(VariableIndex index) {
       // Run callback with the current stream
       c10::OptionalStreamGuard currentStreamGuard{currentStream};
       this->finalize_backward();
+      // See Note [Adaptive bucketing]
+      if (bucket_rebuild_interval_ > 0) {
+        this->update_adaptive_bucketing();
+      }
       // Rebuild bucket if this is the first time to rebuild
       if (!rebuilt_params_.empty()) {
         auto rebuilt_bucket_indices = rebuildBuckets();
@@ -606,7 +667,8 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
     if (comm_hook_ == nullptr) {
       bucket.work = process_group_->allreduce(tensors);
     } else {
-      bucket.future_work = comm_hook_->runHook(GradBucket(tensors));
+      bucket.future_work =
+          comm_hook_->runHook(GradBucket(tensors, next_bucket_));
     }
   }
 }
@@ -736,6 +798,30 @@ void Reducer::initialize_buckets(
         // param layouts over time, but not messing with params after DDP
         // construction is already a documented constraint.
         initialize_bucketviews(replica, replica.contents);
+
+        // Note [Gradients as bucket views]
+        //
+        // With gradient_as_bucket_view, the grad of every variable becomes
+        // its bucket view, so gradients are accumulated straight into the
+        // bucket contents and allreduced there, without copying them into
+        // the bucket before the reduction and back out of it afterwards.
+        // A grad is turned into its bucket view the first time it is marked
+        // ready (or here, if it already exists, e.g. when buckets are
+        // rebuilt). Its AccumulateGrad then keeps accumulating in place,
+        // even under create_graph (see AccumulateGrad::accumulate_in_place).
+        // Code that replaces the grad with another tensor just costs one
+        // more copy into the bucket the next time it is marked ready.
+        if (gradient_as_bucket_view_) {
+          for (size_t i = 0; i < replica.variables.size(); i++) {
+            auto& grad = replica.variables[i].mutable_grad();
+            const auto& bucket_view = replica.bucket_views[i];
+            if (grad.defined() && !grad.is_sparse() &&
+                grad.options().type_equal(bucket_view.options())) {
+              bucket_view.copy_(grad);
+              grad = bucket_view;
+            }
+          }
+        }
       }
 
       // Add bucket replica to enclosing bucket.
@@ -792,6 +878,9 @@ void Reducer::initialize_bucketviews(
 // want to start performing reductions on `torch.autograd.backward()`.
 void Reducer::prepare_for_backward(
     const std::vector<torch::autograd::Variable>& outputs) {
+  // See Note [Adaptive bucketing]
+  maybe_apply_bucket_plan();
+
   std::lock_guard<std::mutex> lock(mutex_);
   std::unordered_set<torch::autograd::Node*> seen;
   std::vector<torch::autograd::Node*> queue;
@@ -931,6 +1020,14 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
       runGradCallbackForVariable(variable, [&](auto& grad) {
         // If a parameter is globally unused, we keep its grad untouched.
         if (!global_unused) {
+          // See Note [Gradients as bucket views]
+          if (gradient_as_bucket_view_) {
+            if (grad.defined() && grad.is_alias_of(bucket_view)) {
+              return false;
+            }
+            grad = bucket_view;
+            return true;
+          }
           if (!grad.defined()) {
             // Creates grad according to the "Gradient Layout Contract"
             // (see torch/csrc/grad/AccumulateGrad.h)
@@ -983,6 +1080,13 @@ void Reducer::finalize_backward() {
       for (size_t i = 0; i < future_result.size(); i++) {
         if (bucket.expect_sparse_gradient) {
           bucket.replicas[i].contents.copy_(future_result[i]);
+        } else if (gradient_as_bucket_view_) {
+          // The grads are views into contents, so the result has to end up
+          // there.
+          auto& contents = bucket.replicas[i].contents;
+          if (!future_result[i].is_alias_of(contents)) {
+            contents.copy_(future_result[i]);
+          }
         } else {
           // Reinitialize bucket_views with the future_result by following
           // the same logic in `inititalize_buckets`.
@@ -1144,6 +1248,124 @@ std::vector<std::vector<size_t>> Reducer::rebuildBuckets() {
   return rebuilt_bucket_indices;
 }
 
+void Reducer::enable_adaptive_bucketing(int64_t rebuild_interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      find_unused_parameters_,
+      "Adaptive bucketing requires find_unused_parameters=True. Without it, ",
+      "buckets are already rebuilt in gradient ready order after the first ",
+      "iteration.");
+  TORCH_CHECK(
+      rebuild_interval > 0,
+      "Adaptive bucketing rebuild interval must be positive, but got ",
+      rebuild_interval);
+  bucket_rebuild_interval_ = rebuild_interval;
+  num_adaptive_iterations_ = 0;
+  ready_order_.clear();
+  ready_order_.reserve(replicas_[0].size());
+  ready_position_ema_.clear();
+}
+
+// See Note [Adaptive bucketing]
+void Reducer::update_adaptive_bucketing() {
+  const auto variable_count = replicas_[0].size();
+  // Every variable is marked ready exactly once in an iteration that reduces
+  // gradients, unused ones included.
+  TORCH_INTERNAL_ASSERT(ready_order_.size() == variable_count);
+
+  // Weight of the current iteration in the moving average.
+  constexpr double kReadyPositionWeight = 0.1;
+  const bool first = ready_position_ema_.empty();
+  if (first) {
+    ready_position_ema_.resize(variable_count);
+  }
+  for (size_t position = 0; position < variable_count; position++) {
+    const double relative = double(position) / variable_count;
+    auto& ema = ready_position_ema_[ready_order_[position]];
+    ema = first ? relative
+                : (1 - kReadyPositionWeight) * ema +
+            kReadyPositionWeight * relative;
+  }
+  ready_order_.clear();
+
+  if (++num_adaptive_iterations_ % bucket_rebuild_interval_ != 0) {
+    return;
+  }
+  // The previous plan has not been picked up yet if prepare_for_backward was
+  // not called since (e.g. no_sync). The broadcasts must match across ranks,
+  // so never replace it.
+  if (bucket_plan_work_) {
+    return;
+  }
+
+  std::vector<int64_t> order(variable_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](int64_t a, int64_t b) {
+    return ready_position_ema_[a] < ready_position_ema_[b];
+  });
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(variable_count);
+  for (const auto index : order) {
+    tensors.push_back(replicas_[0][index]);
+  }
+  const auto plan = compute_bucket_assignment_by_size(
+      tensors,
+      {kDefaultFirstBucketBytes, static_cast<size_t>(bucket_bytes_cap_)},
+      expect_sparse_gradients_[0],
+      order);
+
+  auto encoded = at::zeros({int64_t(2 * variable_count + 1)}, at::kInt);
+  auto accessor = encoded.accessor<int, 1>();
+  accessor[0] = plan.size();
+  size_t offset = variable_count + 1;
+  for (size_t i = 0; i < plan.size(); i++) {
+    accessor[i + 1] = plan[i].size();
+    for (const auto index : plan[i]) {
+      accessor[offset++] = index;
+    }
+  }
+
+  // Copy CPU tensor to device tensor, as the process_group_ could be NCCL and
+  // it can only broadcast device tensors.
+  bucket_plan_ = {encoded.to(replicas_[0][0].device())};
+  bucket_plan_work_ = process_group_->broadcast(bucket_plan_);
+}
+
+// See Note [Adaptive bucketing]
+void Reducer::maybe_apply_bucket_plan() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!bucket_plan_work_ || require_finalize_) {
+    return;
+  }
+  bucket_plan_work_->wait();
+  bucket_plan_work_.reset();
+  const auto encoded = bucket_plan_.front().to(at::kCPU);
+  bucket_plan_.clear();
+
+  const auto variable_count = replicas_[0].size();
+  auto accessor = encoded.accessor<int, 1>();
+  std::vector<std::vector<size_t>> plan(accessor[0]);
+  size_t offset = variable_count + 1;
+  for (size_t i = 0; i < plan.size(); i++) {
+    plan[i].reserve(accessor[i + 1]);
+    for (int j = 0; j < accessor[i + 1]; j++) {
+      plan[i].push_back(accessor[offset++]);
+    }
+  }
+  TORCH_INTERNAL_ASSERT(offset == 2 * variable_count + 1);
+
+  bool same = plan.size() == buckets_.size();
+  for (size_t i = 0; same && i < plan.size(); i++) {
+    same = plan[i] == buckets_[i].variable_indices;
+  }
+  if (same) {
+    return;
+  }
+  // initialize_buckets() takes the lock itself.
+  lock.unlock();
+  initialize_buckets(std::move(plan));
+}
+
 // See Note [DDP Communication Hook]
 void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
   TORCH_CHECK(
@@ -30,7 +30,8 @@ class Reducer {
       std::shared_ptr<c10d::ProcessGroup> process_group,
       std::vector<std::vector<bool>> expect_sparse_gradients,
       int64_t bucket_bytes_cap,
-      bool find_unused_parameters);
+      bool find_unused_parameters,
+      bool gradient_as_bucket_view = false);
 
   ~Reducer() noexcept(false);
 
@@ -59,6 +60,13 @@ class Reducer {
   // be called once before calling backward.
   void register_comm_hook(std::unique_ptr<CommHookInterface> iface);
 
+  // Enables adaptive bucketing (see Note [Adaptive bucketing]). Every
+  // `rebuild_interval` iterations the bucket assignment is re-planned from
+  // the order in which gradients became ready in past iterations. Requires
+  // find_unused_parameters and must be called with the same interval on all
+  // processes.
+  void enable_adaptive_bucketing(int64_t rebuild_interval);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -86,6 +94,9 @@ class Reducer {
 
   bool has_marked_unused_parameters_;
   const bool find_unused_parameters_;
+  // If true, the grads of the variables are views into the bucket contents
+  // (see Note [Gradients as bucket views]).
+  const bool gradient_as_bucket_view_;
   std::vector<VariableIndex> unused_parameters_;
   // Locally used parameter maps indicating if parameters are used locally
   // during the current iteration or no_sync session if no_sync is on. One
@@ -137,6 +148,15 @@ class Reducer {
   // the performance cost is negligible.
   std::vector<std::vector<size_t>> rebuildBuckets();
 
+  // See Note [Adaptive bucketing]
+  // Folds ready_order_ of the iteration that just finished into
+  // ready_position_ema_ and, every bucket_rebuild_interval_ iterations, kicks
+  // off the broadcast of rank 0's bucket plan.
+  void update_adaptive_bucketing();
+  // Waits for a broadcast bucket plan, if there is one, and initializes the
+  // buckets with it if it differs from the current assignment.
+  void maybe_apply_bucket_plan();
+
   using GradCallback =
       torch::distributed::autograd::DistAutogradContext::GradCallback;
   void runGradCallbackForVariable(
@@ -164,6 +184,7 @@ class Reducer {
     // grad.copy_(bucket_views[i]) and
     // bucket_views[i].copy_(grad)
     // provide convenient ways to move grad data in/out of contents.
+    // With gradient_as_bucket_view, the views are the grads themselves.
     std::vector<at::Tensor> bucket_views;
 
     // Variables that contribute to this bucket replica. Use refcounted value
@@ -248,6 +269,20 @@ class Reducer {
   std::vector<int64_t> rebuilt_param_indices_;
   const int64_t bucket_bytes_cap_;
 
+  // Following variables are for adaptive bucketing, see Note [Adaptive
+  // bucketing]. bucket_rebuild_interval_ is 0 if it is disabled.
+  int64_t bucket_rebuild_interval_;
+  int64_t num_adaptive_iterations_;
+  // Variable indices (of replica 0) in the order they were marked ready
+  // during the current iteration.
+  std::vector<size_t> ready_order_;
+  // Moving average of the relative position, in [0, 1), at which every
+  // variable was marked ready.
+  std::vector<double> ready_position_ema_;
+  // Encoded bucket plan being broadcast from rank 0, and its work handle.
+  std::vector<at::Tensor> bucket_plan_;
+  std::shared_ptr<c10d::ProcessGroup::Work> bucket_plan_work_;
+
   struct RpcContext {
     using ContextPtr = torch::distributed::autograd::ContextPtr;
     // The shared_ptr is to hold the context instance.
@@ -9,6 +9,7 @@
 #include <torch/csrc/distributed/rpc/request_callback_impl.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/rref_context.h>
+#include <torch/csrc/distributed/rpc/script_call_batcher.h>
 #include <torch/csrc/distributed/rpc/tensorpipe_agent.h>
 #include <torch/csrc/distributed/rpc/torchscript_functions.h>
 #include <torch/csrc/distributed/rpc/types.h>
@@ -213,6 +214,7 @@ PyObject* rpc_init(PyObject* /* unused */) {
               "to_here",
               &PyRRef::toHere,
               py::arg("timeout") = py::cast(kUnsetRpcTimeout),
+              py::arg("cache") = false,
               py::call_guard<py::gil_scoped_release>(),
               R"(
                   Blocking call that copies the value of the RRef from the owner
@@ -225,6 +227,27 @@ PyObject* rpc_init(PyObject* /* unused */) {
                           exception indicating so will be raised. If this
                           argument is not provided, the default RPC timeout
                           (60s) will be used.
+                      cache (bool, optional): If ``True``, keeps the copy of
+                          the value on this node, and returns it on the next
+                          calls with ``cache=True`` without contacting the
+                          owner, until the owner calls
+                          :meth:`~torch.distributed.rpc.RRef.invalidate_cached_copies`.
+                          The cached tensors are shared by these calls, and
+                          must not be modified. Calls inside a distributed
+                          autograd context always fetch the value. Default:
+                          ``False``.
+              )")
+          .def(
+              "invalidate_cached_copies",
+              &PyRRef::invalidateCachedCopies,
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+                  If the current node is the owner, tells the users that cache
+                  the value of this ``RRef`` (see :meth:`to_here`) that their
+                  copies are stale, so that they fetch it again. Call it after
+                  modifying the value in place. The users are told
+                  asynchronously, and may still read their stale copies in the
+                  meantime. Otherwise, throws an exception.
               )")
           .def(
               "local_value",
@@ -480,6 +503,10 @@ PyObject* rpc_init(PyObject* /* unused */) {
                   store used for rendezvous. It takes any value accepted for the
                   same argument of :meth:`~torch.distributed.init_process_group`
                   (default: ``env://``).
+              device_maps (Dict[str, Dict[int, int]], optional): For every
+                  callee, the CUDA device that each local CUDA device is mapped
+                  to when sending it tensors (default: ``{}``). See
+                  :meth:`set_device_map`.
       )")
       .def(
           py::init<
@@ -487,12 +514,14 @@ PyObject* rpc_init(PyObject* /* unused */) {
               optional<std::vector<std::string>>,
               optional<std::vector<std::string>>,
               float,
-              std::string>(),
+              std::string,
+              std::unordered_map<std::string, DeviceMap>>(),
           py::arg("num_worker_threads") = kDefaultNumWorkerThreads,
           py::arg("_transports") = optional<std::vector<std::string>>(),
           py::arg("_channels") = optional<std::vector<std::string>>(),
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("device_maps") = std::unordered_map<std::string, DeviceMap>())
       .def_readwrite(
           "num_worker_threads",
           &TensorPipeRpcBackendOptions::numWorkerThreads,
@@ -500,6 +529,41 @@ PyObject* rpc_init(PyObject* /* unused */) {
               The number of threads in the thread-pool used by
               :class:`~torch.distributed.rpc.TensorPipeAgent` to execute
               requests.
+          )")
+      .def_readonly(
+          "device_maps",
+          &TensorPipeRpcBackendOptions::deviceMaps,
+          R"(The device maps set on this worker, keyed by callee name.)")
+      .def(
+          "set_device_map",
+          &TensorPipeRpcBackendOptions::setDeviceMap,
+          py::arg("to"),
+          py::arg("device_map"),
+          R"(
+              Sets the mapping of CUDA devices between this worker and the
+              callee ``to``. CUDA tensors in requests to ``to`` are moved from
+              their device ``i`` on this worker to device ``device_map[i]`` on
+              the callee, and CUDA tensors in its responses go back through the
+              inverse map. The map must be one-to-one. CUDA tensors on devices
+              not in the map cannot be sent to ``to``. The tensors are staged
+              through pinned host memory on both ends.
+
+              Arguments:
+                  to (str): The name of the callee.
+                  device_map (Dict[int, int]): The device indices on this
+                      worker mapped to the ones on the callee. Entries are
+                      added to (and override) the existing map for ``to``.
+
+              Example::
+                  >>> # on worker0
+                  >>> options = TensorPipeRpcBackendOptions()
+                  >>> options.set_device_map("worker1", {0: 1, 1: 0})
+                  >>> rpc.init_rpc("worker0", rank=0, world_size=2,
+                  >>>              rpc_backend_options=options)
+                  >>> x = torch.ones(2, device="cuda:0")
+                  >>> # x arrives on cuda:1 of worker1, the result comes back
+                  >>> # on cuda:0.
+                  >>> rets = rpc.rpc_sync("worker1", torch.add, args=(x, 1))
           )");
 
   module.attr("_DEFAULT_NUM_WORKER_THREADS") =
@@ -544,6 +608,14 @@ PyObject* rpc_init(PyObject* /* unused */) {
               TensorPipeAgent::getWorkerInfos,
           py::call_guard<py::gil_scoped_release>());
 
+  module.def(
+      "_to_here_batch",
+      &PyRRef::toHereBatch,
+      py::arg("rrefs"),
+      py::arg("timeout") = py::cast(kUnsetRpcTimeout),
+      py::arg("cache") = false,
+      py::call_guard<py::gil_scoped_release>());
+
   module.def("_is_current_rpc_agent_set", &RpcAgent::isCurrentRpcAgentSet);
 
   module.def("_get_current_rpc_agent", &RpcAgent::getCurrentRpcAgent);
@@ -726,6 +798,29 @@ PyObject* rpc_init(PyObject* /* unused */) {
 
   module.def("_set_profiler_node_id", &at::RecordFunction::setDefaultNodeId);
 
+  module.def(
+      "_enable_script_call_batching",
+      [](const std::string& qualifiedName,
+         int64_t maxBatchSize,
+         float maxWaitSeconds) {
+        ScriptCallBatcher::getInstance().enable(
+            c10::QualifiedName(qualifiedName),
+            BatchingOptions{maxBatchSize,
+                            std::chrono::milliseconds(static_cast<int64_t>(
+                                maxWaitSeconds * kSecToMsConversion))});
+      },
+      py::arg("qualified_name"),
+      py::arg("max_batch_size"),
+      py::arg("max_wait_seconds"));
+  module.def(
+      "_disable_script_call_batching",
+      [](const std::string& qualifiedName) {
+        ScriptCallBatcher::getInstance().disable(
+            c10::QualifiedName(qualifiedName));
+      },
+      py::arg("qualified_name"),
+      py::call_guard<py::gil_scoped_release>());
+
   py::class_<
       RemoteProfilerManager,
       std::unique_ptr<RemoteProfilerManager, py::nodelete>>(
@@ -86,8 +86,11 @@ bool Message::isRequest() const {
       MessageType::RREF_USER_DELETE == type_ ||
       MessageType::RREF_CHILD_ACCEPT == type_ ||
       MessageType::RREF_FORK_REQUEST == type_ ||
+      MessageType::RREF_CACHE_INVALIDATE == type_ ||
+      MessageType::RREF_BATCH_FETCH_CALL == type_ ||
       // Autograd message
       MessageType::BACKWARD_AUTOGRAD_REQ == type_ ||
+      MessageType::BACKWARD_AUTOGRAD_BATCH_REQ == type_ ||
       MessageType::FORWARD_AUTOGRAD_REQ == type_ ||
       // Cleanup Autograd context request
       MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ == type_ ||
@@ -101,6 +104,7 @@ bool Message::isResponse() const {
       MessageType::REMOTE_RET == type_ || // ret of dist.remote
       MessageType::SCRIPT_RREF_FETCH_RET == type_ || // ret on RRef::toHere()
       MessageType::PYTHON_RREF_FETCH_RET == type_ || // ret on RRef::toHere()
+      MessageType::RREF_BATCH_FETCH_RET == type_ || // ret on batch toHere()
       MessageType::EXCEPTION == type_ || // propagate back exceptions
       MessageType::RREF_ACK == type_ || // ret of other types
       // Autograd response
@@ -39,6 +39,9 @@ enum MessageType {
   RREF_FORK_REQUEST = 12, // A child UserRRef tells the owner about itself
   RREF_CHILD_ACCEPT = 13, // A child UserRRef tells parent that owner knows it
   RREF_ACK = 14, // ACK to internal RRef messages
+  RREF_CACHE_INVALIDATE = 24, // An OwnerRRef tells a user its copy is stale
+  RREF_BATCH_FETCH_CALL = 25, // A user fetches the values of several RRefs
+  RREF_BATCH_FETCH_RET = 26, // An owner sends the values of several RRefs
 
   // Messages with autograd info
   FORWARD_AUTOGRAD_REQ = 15,
@@ -47,6 +50,9 @@ enum MessageType {
   // Messages to propagate gradients on the backward pass.
   BACKWARD_AUTOGRAD_REQ = 17,
   BACKWARD_AUTOGRAD_RESP = 18,
+  // The gradients of several 'recv' functions for the same worker, answered
+  // with a single BACKWARD_AUTOGRAD_RESP.
+  BACKWARD_AUTOGRAD_BATCH_REQ = 23,
 
   // Messages to tell workers to clean up their autograd context.
   CLEANUP_AUTOGRAD_CONTEXT_REQ = 19,
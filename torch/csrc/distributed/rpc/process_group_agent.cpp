@@ -390,8 +390,11 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
+  // The data of the tensors is sent from their storages, after the header.
+  auto serialized =
+      wireSerializeSegments(work.message_.payload(), work.message_.tensors());
+  auto serializedPayload =
+      std::make_unique<std::string>(std::move(serialized.header));
 
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
@@ -414,7 +417,7 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
       serializedPayloadSize,
       [deleteWhenDone](void*) { delete deleteWhenDone; },
       {torch::kChar})};
-  pendingSends.reserve(2);
+  pendingSends.reserve(2 + serialized.segments.size());
 
   sendCounts_.increment(dst);
 
@@ -422,6 +425,16 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
     pendingSends.emplace_back(pg_->send(preamble, dst, dst /* channelTag */));
     pendingSends.emplace_back(pg_->send(payload, dst, dst /* channelTag */));
+    for (auto& segment : serialized.segments) {
+      // The receiver knows the sizes from the header, and skips the empty
+      // segments too.
+      if (segment.numel() == 0) {
+        continue;
+      }
+      std::vector<torch::Tensor> segmentTensors = {segment};
+      pendingSends.emplace_back(
+          pg_->send(segmentTensors, dst, dst /* channelTag */));
+    }
   }
   // Write pendingSends to a global map so that they can be interrupted by
   // ::shutdown().
@@ -458,9 +471,17 @@ void ProcessGroupAgent::sendToSelf(Message&& message) {
         // data outlives the scope of this function. It's shared_ptr<> due
         // to c++11 lambda capture limitations with unique_ptr<>.
         std::unique_ptr<std::string> payload;
+        std::vector<torch::Tensor> segments;
         try {
-          payload = std::make_unique<std::string>(
-              wireSerialize(message.payload(), message.tensors()));
+          auto serialized =
+              wireSerializeSegments(message.payload(), message.tensors());
+          payload = std::make_unique<std::string>(std::move(serialized.header));
+          // The segments alias the storages of the sent tensors, which the
+          // receiver must not share.
+          segments.reserve(serialized.segments.size());
+          for (const auto& segment : serialized.segments) {
+            segments.push_back(segment.clone());
+          }
           // only increment sendCounts when the message is indeed added into
           // local recv.
           sendCounts_.increment(pg_->getRank());
@@ -479,7 +500,8 @@ void ProcessGroupAgent::sendToSelf(Message&& message) {
                 (void*)data,
                 len,
                 [delete_when_done](void*) { delete delete_when_done; },
-                {torch::kChar})));
+                {torch::kChar}),
+            std::move(segments)));
       },
       std::move(message)));
 }
@@ -512,7 +534,8 @@ void ProcessGroupAgent::enqueueSend(SendWork work) {
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
+  auto data = wireDeserializeSegments(
+      payload.storage().data(), payload.numel(), std::move(work.segments_));
   Message message(
       std::move(data.first), std::move(data.second), work.type_, work.id_);
   if (message.isRequest()) {
@@ -747,8 +770,35 @@ void ProcessGroupAgent::listenLoopInternal() {
       return;
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    // The data of the tensors follows the header, each in its own buffer.
+    std::vector<torch::Tensor> segments;
+    auto segmentSizes =
+        wireSegmentSizes(tensors[0].storage().data(), tensors[0].numel());
+    segments.reserve(segmentSizes.size());
+    for (auto segmentSize : segmentSizes) {
+      segments.push_back(torch::empty({segmentSize}, {torch::kByte}));
+      if (segmentSize == 0) {
+        continue;
+      }
+      std::vector<torch::Tensor> segmentTensors = {segments.back()};
+      work = pg_->recv(segmentTensors, srcRank, pg_->getRank());
+      {
+        // Write class variable so it can be aborted by shutdown()
+        std::lock_guard<std::mutex> guard(recvWorkMutex_);
+        recvWork_ = work;
+      }
+
+      if (!rpcAgentRunning_.load() || !work->wait() /* aborted */) {
+        return;
+      }
+    }
+
+    enqueueRecv(RecvWork(
+        allWorkerInfo_[srcRank],
+        type,
+        id,
+        std::move(tensors[0]),
+        std::move(segments)));
   }
 }
 
@@ -41,20 +41,29 @@ struct SendWork {
   Message message_;
 };
 
-// SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
+// SendWork wraps a Message and RecvWork wraps Tensors. The difference here is
 // to allow us to run serialization/deserialization in the worker threads.
+// The payload_ holds the wire header, and the segments_ the data of the
+// tensors of the message, each received into its own buffer (see
+// wireSerializeSegments).
 struct RecvWork {
   RecvWork(
       const WorkerInfo& from,
       MessageType type,
       int64_t id,
-      torch::Tensor&& payload)
-      : from_(from), type_(type), id_(id), payload_(payload) {}
+      torch::Tensor&& payload,
+      std::vector<torch::Tensor>&& segments)
+      : from_(from),
+        type_(type),
+        id_(id),
+        payload_(payload),
+        segments_(std::move(segments)) {}
 
   const WorkerInfo& from_;
   const MessageType type_;
   const int64_t id_;
   torch::Tensor payload_;
+  std::vector<torch::Tensor> segments_;
 };
 
 class TORCH_API ProcessGroupAgent : public RpcAgent {
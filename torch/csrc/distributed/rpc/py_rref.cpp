@@ -153,30 +153,60 @@ std::string PyRRef::ownerName() const {
   return rref_->ownerName();
 }
 
-py::object PyRRef::toHere(const float timeoutSeconds) const {
+py::object PyRRef::toHere(const float timeoutSeconds, bool useCache) const {
   if (rref_->isOwner()) {
     return localValue();
   } else {
     // toHere() calls python_rpc_handler which acquires GIL when UserRRef holds
     // a python object
     IValue value = c10::static_intrusive_pointer_cast<UserRRef>(rref_)->toHere(
-        timeoutSeconds);
-
-    if (rref_->isPyObj()) {
-      // python_rpc_handler deserialization will acquires GIL.
-      auto rfr_values = value.toTuple()->elements();
-      auto& pythonRpcHandler = PythonRpcHandler::getInstance();
-      auto ret = pythonRpcHandler.deserialize(
-          SerializedPyObj::fromIValues(rfr_values));
-      pythonRpcHandler.handleException(ret);
-      return ret;
+        timeoutSeconds, useCache);
+    return fetchedValueToPyObj(std::move(value));
+  }
+}
+
+std::vector<py::object> PyRRef::toHereBatch(
+    const std::vector<PyRRef>& rrefs,
+    const float timeoutSeconds,
+    bool useCache) {
+  std::vector<c10::intrusive_ptr<UserRRef>> userRRefs;
+  for (const auto& rref : rrefs) {
+    if (!rref.rref_->isOwner()) {
+      userRRefs.push_back(
+          c10::static_intrusive_pointer_cast<UserRRef>(rref.rref_));
+    }
+  }
+  auto values = UserRRef::toHereBatch(userRRefs, timeoutSeconds, useCache);
+
+  std::vector<py::object> results;
+  results.reserve(rrefs.size());
+  size_t userIndex = 0;
+  for (const auto& rref : rrefs) {
+    if (rref.rref_->isOwner()) {
+      results.push_back(rref.localValue());
     } else {
-      // acquiring GIL as torch::jit::toPyObject creates new py::object
-      // without grabbing the GIL.
-      pybind11::gil_scoped_acquire ag;
-      return torch::jit::toPyObject(std::move(value));
+      results.push_back(
+          rref.fetchedValueToPyObj(std::move(values[userIndex++])));
     }
   }
+  return results;
+}
+
+py::object PyRRef::fetchedValueToPyObj(IValue value) const {
+  if (rref_->isPyObj()) {
+    // python_rpc_handler deserialization will acquires GIL.
+    auto rfr_values = value.toTuple()->elements();
+    auto& pythonRpcHandler = PythonRpcHandler::getInstance();
+    auto ret = pythonRpcHandler.deserialize(
+        SerializedPyObj::fromIValues(rfr_values));
+    pythonRpcHandler.handleException(ret);
+    return ret;
+  } else {
+    // acquiring GIL as torch::jit::toPyObject creates new py::object
+    // without grabbing the GIL.
+    pybind11::gil_scoped_acquire ag;
+    return torch::jit::toPyObject(std::move(value));
+  }
 }
 
 py::object PyRRef::localValue() const {
@@ -203,6 +233,19 @@ py::object PyRRef::localValue() const {
   return res;
 }
 
+void PyRRef::invalidateCachedCopies() const {
+  TORCH_CHECK(
+      rref_->isOwner(),
+      "For ",
+      *rref_,
+      ", can't call invalidateCachedCopies() on user ",
+      RRefContext::getInstance().agent()->getWorkerInfo(),
+      ". Call it on owner ",
+      owner());
+  RRefContext::getInstance().invalidateCachedCopies(
+      c10::static_intrusive_pointer_cast<OwnerRRef>(rref_));
+}
+
 std::string PyRRef::str() const {
   if (rref_->isOwner()) {
     return c10::str("OwnerRRef(", rref_->rrefId(), ")");
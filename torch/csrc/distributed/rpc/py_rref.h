@@ -24,9 +24,18 @@ class PyRRef {
   WorkerInfo owner() const;
   std::string ownerName() const;
   py::object toHere(
-      const float timeoutSeconds =
-          torch::distributed::rpc::kUnsetRpcTimeout) const;
+      const float timeoutSeconds = torch::distributed::rpc::kUnsetRpcTimeout,
+      bool useCache = false) const;
+  // toHere() on all rrefs, with one message for all the UserRRefs of each
+  // owner.
+  static std::vector<py::object> toHereBatch(
+      const std::vector<PyRRef>& rrefs,
+      const float timeoutSeconds = torch::distributed::rpc::kUnsetRpcTimeout,
+      bool useCache = false);
   py::object localValue() const;
+  // Called on the owner after modifying the value in place, so that the users
+  // that cache it fetch it again.
+  void invalidateCachedCopies() const;
   std::string str() const;
   py::tuple pickle() const;
   static PyRRef unpickle(const py::tuple& t);
@@ -48,6 +57,9 @@ class PyRRef {
   py::object createRRefProxy(const RRefProxyType& mode) const;
 
  private:
+  // The py::object of the value that UserRRef::toHere() returns.
+  py::object fetchedValueToPyObj(IValue value) const;
+
   c10::intrusive_ptr<RRef> rref_;
   c10::optional<c10::intrusive_ptr<JitFuture>> profilingFuture_;
 };
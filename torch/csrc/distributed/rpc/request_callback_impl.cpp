@@ -22,6 +22,7 @@
 #include <torch/csrc/distributed/rpc/rref_impl.h>
 #include <torch/csrc/distributed/rpc/rref_proto.h>
 #include <torch/csrc/distributed/rpc/script_call.h>
+#include <torch/csrc/distributed/rpc/script_call_batcher.h>
 #include <torch/csrc/distributed/rpc/script_remote_call.h>
 #include <torch/csrc/distributed/rpc/script_resp.h>
 #include <torch/csrc/distributed/rpc/unpickled_python_call.h>
@@ -155,14 +156,23 @@ void RequestCallbackImpl::processScriptCall(
     return;
   }
 
-  // runAsync() starts in the calling thread, but may return an uncompleted
-  // future (though for non-async code, it will typically be completed).
-  // If it was async, our callback will typically be invoked by the
-  // continuation on an at::launch() thread.
-  auto jitFuture = PythonRpcHandler::getInstance()
-                       .jitCompilationUnit()
-                       ->get_function(scriptCall.qualifiedName())
-                       .runAsync(stack);
+  auto& fn = PythonRpcHandler::getInstance().jitCompilationUnit()->get_function(
+      scriptCall.qualifiedName());
+  c10::intrusive_ptr<JitFuture> jitFuture;
+  // Batched calls run on other threads, which do not see the distributed
+  // autograd context or the profiler state of this one.
+  if (!scriptCall.isAsyncExecution() &&
+      !DistAutogradContainer::getInstance().hasValidContext() &&
+      !torch::autograd::profiler::profilerEnabled()) {
+    jitFuture = ScriptCallBatcher::getInstance().submit(fn, stack);
+  }
+  if (!jitFuture) {
+    // runAsync() starts in the calling thread, but may return an uncompleted
+    // future (though for non-async code, it will typically be completed).
+    // If it was async, our callback will typically be invoked by the
+    // continuation on an at::launch() thread.
+    jitFuture = fn.runAsync(stack);
+  }
 
   if (scriptCall.isAsyncExecution()) {
     jitFuture->addCallback([responseFuture, messageId, jitFuture]() {
@@ -408,12 +418,43 @@ void RequestCallbackImpl::processPythonRemoteCall(
   }
 }
 
+std::vector<at::IValue> RequestCallbackImpl::serializeRRefValue(
+    const c10::intrusive_ptr<OwnerRRef>& rref) const {
+  if (!rref->isPyObj()) {
+    return RequestCallbackNoPython::serializeRRefValue(rref);
+  }
+  auto& pythonRpcHandler = PythonRpcHandler::getInstance();
+  std::shared_ptr<SerializedPyObj> result;
+  try {
+    // Need this GIL to guard jit::toPyObj and destruct its returned
+    // py::object
+    py::gil_scoped_acquire acquire;
+    result = std::make_shared<SerializedPyObj>(
+        pythonRpcHandler.serialize(jit::toPyObject(rref->getValue())));
+  } catch (py::error_already_set& e) {
+    // py::error_already_set requires GIL to destruct, take special care.
+    std::string what = e.what();
+    {
+      py::gil_scoped_acquire acquire;
+      e.restore();
+      PyErr_Clear();
+    }
+    throw std::runtime_error(what);
+  }
+  return std::move(*result).toIValues();
+}
+
 void RequestCallbackImpl::processPythonRRefFetchCall(
     RpcCommandBase& rpc,
     const int64_t messageId,
     const std::shared_ptr<FutureMessage>& responseFuture) const {
+  auto& prf = static_cast<PythonRRefFetchCall&>(rpc);
+  auto& ctx = RRefContext::getInstance();
+
   // Making this lambda mutable to allow move-capture it in callbacks
-  auto postProcessing = [responseFuture](
+  auto postProcessing = [responseFuture,
+                         cachingForkId{prf.cachingForkId()},
+                         fromWorkerId{prf.fromWorkerId()}](
                             const c10::intrusive_ptr<OwnerRRef>& rref,
                             int64_t messageId) mutable {
     auto whenValueSet = rref->getFuture();
@@ -422,6 +463,11 @@ void RequestCallbackImpl::processPythonRRefFetchCall(
       return;
     }
     try {
+      // The version is taken before the value is serialized, so that the
+      // caching user is told about all the versions after it.
+      int64_t version = cachingForkId
+          ? rref->addCachingUser(*cachingForkId, fromWorkerId)
+          : kUncachedRRefVersion;
       auto& pythonRpcHandler = PythonRpcHandler::getInstance();
       std::shared_ptr<SerializedPyObj> result;
       {
@@ -432,7 +478,8 @@ void RequestCallbackImpl::processPythonRRefFetchCall(
             pythonRpcHandler.serialize(jit::toPyObject(rref->getValue())));
       }
       Message m =
-          PythonRRefFetchRet(std::move(*result).toIValues()).toMessage();
+          PythonRRefFetchRet(std::move(*result).toIValues(), version)
+              .toMessage();
       m.setId(messageId);
       responseFuture->markCompleted(std::move(m));
     } catch (py::error_already_set& e) {
@@ -446,9 +493,6 @@ void RequestCallbackImpl::processPythonRRefFetchCall(
     }
   };
 
-  auto& prf = static_cast<PythonRRefFetchCall&>(rpc);
-  auto& ctx = RRefContext::getInstance();
-
   auto futureOwner = ctx.getOwnerRRef(prf.rrefId());
 
   if (futureOwner->completed() && futureOwner->constValue()->hasValue()) {
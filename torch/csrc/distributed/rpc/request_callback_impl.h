@@ -47,6 +47,9 @@ class TORCH_API RequestCallbackImpl : public RequestCallbackNoPython {
       const int64_t messageId,
       const std::shared_ptr<FutureMessage>& responseFuture) const override;
 
+  std::vector<at::IValue> serializeRRefValue(
+      const c10::intrusive_ptr<OwnerRRef>& rref) const override;
+
   void handleRRefDelete(c10::intrusive_ptr<RRef>& rref) const override;
 
   void processRpcWithErrors(
@@ -216,6 +216,85 @@ void RequestCallbackNoPython::processPythonRRefFetchCall(
   C10_THROW_ERROR(Error, "Python call not supported!");
 }
 
+std::vector<at::IValue> RequestCallbackNoPython::serializeRRefValue(
+    const c10::intrusive_ptr<OwnerRRef>& rref) const {
+  TORCH_CHECK(!rref->isPyObj(), "RRefs with python objects not supported!");
+  return {rref->getValue()};
+}
+
+void RequestCallbackNoPython::processRRefBatchFetchCall(
+    RpcCommandBase& rpc,
+    const int64_t messageId,
+    const std::shared_ptr<FutureMessage>& responseFuture) const {
+  auto& rbf = static_cast<RRefBatchFetchCall&>(rpc);
+  auto& ctx = RRefContext::getInstance();
+
+  // The response goes out once the values of all RRefs are set.
+  struct BatchFetchState {
+    // ForkId is not assignable, so the ids are copied on construction.
+    explicit BatchFetchState(const std::vector<c10::optional<ForkId>>& ids)
+        : cachingForkIds(ids) {}
+
+    std::vector<c10::intrusive_ptr<OwnerRRef>> rrefs;
+    std::vector<c10::optional<ForkId>> cachingForkIds;
+    worker_id_t fromWorkerId;
+    std::atomic<size_t> numPending;
+    std::atomic<bool> failed{false};
+  };
+  auto state = std::make_shared<BatchFetchState>(rbf.cachingForkIds());
+  const size_t numRRefs = rbf.rrefIds().size();
+  state->rrefs.resize(numRRefs);
+  state->fromWorkerId = rbf.fromWorkerId();
+  state->numPending = numRRefs;
+
+  auto sendValues = [this, state, messageId, responseFuture]() {
+    try {
+      std::vector<std::vector<at::IValue>> values;
+      std::vector<int64_t> versions;
+      values.reserve(state->rrefs.size());
+      versions.reserve(state->rrefs.size());
+      for (size_t i = 0; i < state->rrefs.size(); ++i) {
+        const auto& rref = state->rrefs[i];
+        const auto& cachingForkId = state->cachingForkIds[i];
+        versions.push_back(
+            cachingForkId
+                ? rref->addCachingUser(*cachingForkId, state->fromWorkerId)
+                : kUncachedRRefVersion);
+        values.push_back(serializeRRefValue(rref));
+      }
+      Message m =
+          RRefBatchFetchRet(std::move(values), std::move(versions)).toMessage();
+      m.setId(messageId);
+      responseFuture->markCompleted(std::move(m));
+    } catch (const std::exception& e) {
+      responseFuture->setError(e.what());
+    }
+  };
+
+  if (numRRefs == 0) {
+    sendValues();
+    return;
+  }
+  for (size_t i = 0; i < numRRefs; ++i) {
+    auto futureOwner = ctx.getOwnerRRef(rbf.rrefIds()[i]);
+    futureOwner->addCallback(
+        [state, i, futureOwner, responseFuture, sendValues]() {
+          const auto& rref = futureOwner->constValue();
+          state->rrefs[i] = rref;
+          auto whenValueSet = rref->getFuture();
+          whenValueSet->addCallback(
+              [state, responseFuture, sendValues, whenValueSet]() {
+                if (whenValueSet->hasError() && !state->failed.exchange(true)) {
+                  responseFuture->setError(whenValueSet->error()->what());
+                }
+                if (--state->numPending == 0 && !state->failed) {
+                  sendValues();
+                }
+              });
+        });
+  }
+}
+
 void RequestCallbackNoPython::handleRRefDelete(
     c10::intrusive_ptr<RRef>& rref) const {
   TORCH_CHECK(!rref->isPyObj(), "RRefs with python objects not supported!");
@@ -302,30 +381,46 @@ void RequestCallbackNoPython::processRpc(
       auto& ctx = RRefContext::getInstance();
 
       auto futureOwner = ctx.getOwnerRRef(srf.rrefId());
+      // The version is taken before the value is serialized, so that the
+      // caching user is told about all the versions after it.
+      auto version = [cachingForkId{srf.cachingForkId()},
+                      fromWorkerId{srf.fromWorkerId()}](
+                         const c10::intrusive_ptr<OwnerRRef>& rref) {
+        return cachingForkId
+            ? rref->addCachingUser(*cachingForkId, fromWorkerId)
+            : kUncachedRRefVersion;
+      };
 
       if (futureOwner->completed()) { // optional fast-path
         // the OwnerRRef has been created
         const auto& rref = futureOwner->constValue();
         if (rref->hasValue()) {
-          markComplete(ScriptRRefFetchRet({rref->getValue()}).toMessage());
+          markComplete(
+              ScriptRRefFetchRet({rref->getValue()}, version(rref))
+                  .toMessage());
           return;
         }
       }
 
-      futureOwner->addCallback([responseFuture, messageId, futureOwner]() {
+      futureOwner->addCallback([responseFuture,
+                                messageId,
+                                futureOwner,
+                                version]() {
         const auto& rref = futureOwner->constValue();
         auto whenValueSet = rref->getFuture();
 
         // Our response is satisfied when the rpc.remote() request
         // finishes executing on the owner.
         whenValueSet->addCallback(
-            [responseFuture, messageId, rref, whenValueSet]() {
+            [responseFuture, messageId, rref, whenValueSet, version]() {
               if (whenValueSet->hasError()) {
                 responseFuture->setError(whenValueSet->error()->what());
                 return;
               }
               try {
-                Message m = ScriptRRefFetchRet({rref->getValue()}).toMessage();
+                Message m =
+                    ScriptRRefFetchRet({rref->getValue()}, version(rref))
+                        .toMessage();
                 m.setId(messageId);
                 responseFuture->markCompleted(std::move(m));
               } catch (const std::exception& e) {
@@ -340,6 +435,17 @@ void RequestCallbackNoPython::processRpc(
       processPythonRRefFetchCall(rpc, messageId, responseFuture);
       return;
     }
+    case MessageType::RREF_BATCH_FETCH_CALL: {
+      processRRefBatchFetchCall(rpc, messageId, responseFuture);
+      return;
+    }
+    case MessageType::RREF_CACHE_INVALIDATE: {
+      auto& rci = static_cast<RRefCacheInvalidate&>(rpc);
+      RRefContext::getInstance().invalidateCachedValue(
+          rci.forkId(), rci.version());
+      markComplete(RRefAck().toMessage());
+      return;
+    }
     case MessageType::RREF_USER_DELETE: {
       auto& rud = static_cast<RRefUserDelete&>(rpc);
       auto& ctx = RRefContext::getInstance();
@@ -433,7 +539,8 @@ void RequestCallbackNoPython::processRpc(
           });
       return;
     }
-    case MessageType::BACKWARD_AUTOGRAD_REQ: {
+    case MessageType::BACKWARD_AUTOGRAD_REQ:
+    case MessageType::BACKWARD_AUTOGRAD_BATCH_REQ: {
       auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
       const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
 
@@ -442,29 +549,42 @@ void RequestCallbackNoPython::processRpc(
           DistAutogradContainer::getInstance().retrieveContext(
               autogradMetadata.autogradContextId);
 
-      // Lookup the appropriate 'send' function to enqueue.
-      std::shared_ptr<SendRpcBackward> sendFunction =
-          autogradContext->retrieveSendFunction(
-              autogradMetadata.autogradMessageId);
-
-      // Attach the gradients to the send function.
-      sendFunction->setGrads(gradientsCall.getGrads());
-
-      // Now execute the autograd graph using the "distributed engine."
-      auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
-          autogradContext, sendFunction, gradientsCall.retainGraph());
-
-      // Our response is satisfied when the rpcs come back.
-      execFuture->addCallback(
-          [responseFuture, messageId](const FutureMessage& execFuture) {
-            if (!execFuture.hasError()) {
+      // The response is satisfied once the backward passes started by all
+      // the entries are done.
+      struct State {
+        explicit State(size_t count) : remaining(count) {}
+        std::atomic<size_t> remaining;
+        std::atomic<bool> alreadySentError{false};
+      };
+      auto state = std::make_shared<State>(gradientsCall.numEntries());
+
+      for (size_t i = 0; i < gradientsCall.numEntries(); i++) {
+        // Lookup the appropriate 'send' function to enqueue.
+        std::shared_ptr<SendRpcBackward> sendFunction =
+            autogradContext->retrieveSendFunction(
+                gradientsCall.getAutogradMetadata(i).autogradMessageId);
+
+        // Attach the gradients to the send function.
+        sendFunction->setGrads(gradientsCall.getGrads(i));
+
+        // Now execute the autograd graph using the "distributed engine."
+        auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
+            autogradContext, sendFunction, gradientsCall.retainGraph());
+
+        // Our response is satisfied when the rpcs come back.
+        execFuture->addCallback([responseFuture, messageId, state](
+                                    const FutureMessage& execFuture) {
+          if (!execFuture.hasError()) {
+            if (--state->remaining == 0) {
               Message m = std::move(PropagateGradientsResp()).toMessage();
               m.setId(messageId);
               responseFuture->markCompleted(std::move(m));
-            } else {
-              responseFuture->setError(*(execFuture.error()));
             }
-          });
+          } else if (!state->alreadySentError.exchange(true)) {
+            responseFuture->setError(*(execFuture.error()));
+          }
+        });
+      }
       return;
     };
     case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ: {
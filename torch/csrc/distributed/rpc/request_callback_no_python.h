@@ -66,6 +66,15 @@ class TORCH_API RequestCallbackNoPython : public RequestCallback {
       const int64_t messageId,
       const std::shared_ptr<FutureMessage>& responseFuture) const;
 
+  // The values that an RRefFetchRet carries for the value of rref.
+  virtual std::vector<at::IValue> serializeRRefValue(
+      const c10::intrusive_ptr<OwnerRRef>& rref) const;
+
+  void processRRefBatchFetchCall(
+      RpcCommandBase& rpc,
+      const int64_t messageId,
+      const std::shared_ptr<FutureMessage>& responseFuture) const;
+
   virtual void handleRRefDelete(c10::intrusive_ptr<RRef>& rref) const;
 
   void processRpc(
@@ -224,6 +224,51 @@ void RRefContext::delUser(
   confirmedUsers_.erase(forkId);
 }
 
+void RRefContext::invalidateCachedCopies(
+    const c10::intrusive_ptr<OwnerRRef>& rref) {
+  auto versionAndStaleUsers = rref->bumpVersion();
+  std::lock_guard<std::mutex> lock(destroyedMutex_);
+  if (destroyed_) {
+    return;
+  }
+  for (const auto& user : versionAndStaleUsers.second) {
+    ++numPendingFutures_;
+    auto fm = agent_->sendWithRetries(
+        agent_->getWorkerInfo(user.second),
+        RRefCacheInvalidate(
+            rref->rrefId(), user.first, versionAndStaleUsers.first)
+            .toMessage());
+
+    fm->addCallback([this](const FutureMessage& fm) {
+      handleException(fm);
+      --numPendingFutures_;
+    });
+  }
+}
+
+void RRefContext::invalidateCachedValue(
+    const ForkId& forkId,
+    int64_t version) {
+  c10::intrusive_ptr<RRef> rref;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pendingIter = pendingUsers_.find(forkId);
+    if (pendingIter != pendingUsers_.end()) {
+      rref = pendingIter->second->rref_;
+    } else {
+      auto confirmedIter = confirmedUsers_.find(forkId);
+      if (confirmedIter != confirmedUsers_.end()) {
+        rref = confirmedIter->second.lock();
+      }
+    }
+  }
+  // The UserRRef may have been deleted since the owner sent the message.
+  if (rref) {
+    c10::static_intrusive_pointer_cast<UserRRef>(rref)->invalidateCache(
+        version);
+  }
+}
+
 void RRefContext::delAllUsersAndUnforkedOwners(
     std::chrono::milliseconds timeoutMillis) {
   // First, wait for all pending UserRRefs to be confirmed,
@@ -742,6 +787,11 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
       auto forkIter = rrefForks.find(forkId);
       if (forkIter != rrefForks.end()) {
         rrefForks.erase(forkId);
+        auto ownerIter = owners_.find(rrefId);
+        if (ownerIter != owners_.end()) {
+          c10::static_intrusive_pointer_cast<OwnerRRef>(ownerIter->second)
+              ->delCachingUser(forkId);
+        }
       } else {
         LOG(INFO)
             << "Could not find UserRRef instance, "
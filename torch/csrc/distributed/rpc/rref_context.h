@@ -207,6 +207,13 @@ class TORCH_API RRefContext {
       const ForkId& forkId);
   void delAllUsersAndUnforkedOwners(std::chrono::milliseconds timeoutMillis);
 
+  // Starts a new version of the value of the OwnerRRef, and tells the
+  // UserRRefs that cache an older one to drop it.
+  void invalidateCachedCopies(const c10::intrusive_ptr<OwnerRRef>& rref);
+  // Tells the local UserRRef of forkId, if any, that its value has a newer
+  // version.
+  void invalidateCachedValue(const ForkId& forkId, int64_t version);
+
   std::unordered_map<std::string, std::string> getDebugInfo();
 
  private:
@@ -1,6 +1,7 @@
 #include <torch/csrc/distributed/rpc/rref_impl.h>
 #include <ATen/record_function.h>
 #include <fmt/format.h>
+#include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/profiler/remote_profiler_manager.h>
@@ -8,6 +9,8 @@
 #include <torch/csrc/distributed/rpc/rref_proto.h>
 #include <torch/csrc/distributed/rpc/utils.h>
 
+#include <map>
+
 namespace {
 // If the type is subtype of named type, return its qualifiedname, otherwise
 // return its type str.
@@ -125,7 +128,7 @@ const ForkId& UserRRef::forkId() const {
   return forkId_;
 }
 
-IValue UserRRef::toHere(const float timeoutSeconds) const {
+void UserRRef::checkCanFetch() const {
   TORCH_CHECK(
       !getTimedOut(),
       "RRef creation via rpc.remote() timed out, and it "
@@ -135,6 +138,30 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
       !deletedOnOwner_,
       *this,
       " has been deleted. Cannot call to_here() on it after deletion.");
+  TORCH_CHECK(
+      !type_->is_module(),
+      *this,
+      " is an RRef to a ScriptModule. "
+      "It can't be sent through RPC "
+      "from owner, ",
+      ownerWorkerInfo(),
+      ", to user, ",
+      RpcAgent::getCurrentRpcAgent()->getWorkerInfo(),
+      ".");
+}
+
+IValue UserRRef::toHere(const float timeoutSeconds, bool useCache) const {
+  checkCanFetch();
+  // A cached copy would bypass the 'send' and 'recv' functions of the fetch.
+  const bool cache = useCache &&
+      !autograd::DistAutogradContainer::getInstance().hasValidContext();
+  if (cache) {
+    auto cachedValue = this->cachedValue();
+    if (cachedValue) {
+      return std::move(*cachedValue);
+    }
+  }
+
   auto toHereKey = std::string("");
   if (torch::autograd::profiler::profilerEnabled()) {
     toHereKey = fmt::format(
@@ -146,18 +173,11 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
     remoteProfilerManager.setCurrentKey(toHereKey);
   }
   RECORD_USER_SCOPE(toHereKey);
-  TORCH_CHECK(
-      !type_->is_module(),
-      *this,
-      " is an RRef to a ScriptModule. "
-      "It can't be sent through RPC "
-      "from owner, ",
-      ownerWorkerInfo(),
-      ", to user, ",
-      RpcAgent::getCurrentRpcAgent()->getWorkerInfo(),
-      ".");
 
   auto agent = RpcAgent::getCurrentRpcAgent();
+  const worker_id_t selfId = agent->getWorkerInfo().id_;
+  const c10::optional<ForkId> cachingForkId =
+      cache ? c10::optional<ForkId>(forkId_) : c10::nullopt;
 
   // ScriptRRefFetchCall message always carries autograd context id even if
   // the message itself does not contain any tensor, because the response would
@@ -165,9 +185,11 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
   Message msgToSend;
 
   if (isPyObj()) {
-    msgToSend = PythonRRefFetchCall(ownerId_, rrefId()).toMessage();
+    msgToSend =
+        PythonRRefFetchCall(selfId, rrefId(), cachingForkId).toMessage();
   } else {
-    msgToSend = ScriptRRefFetchCall(ownerId_, rrefId()).toMessage();
+    msgToSend =
+        ScriptRRefFetchCall(selfId, rrefId(), cachingForkId).toMessage();
   }
 
   auto futureResponse = autograd::sendMessageWithAutograd(
@@ -190,12 +212,112 @@ IValue UserRRef::toHere(const float timeoutSeconds) const {
       "or PYTHON_RREF_FETCH_RET");
   RpcCommandBase& rpc = *response;
   auto& rrefFetchRet = static_cast<RRefFetchRet&>(rpc);
+  IValue value = fromFetchedValues(rrefFetchRet.values());
+  if (cache) {
+    setCachedValue(value, rrefFetchRet.version());
+  }
+  return value;
+}
+
+std::vector<IValue> UserRRef::toHereBatch(
+    const std::vector<c10::intrusive_ptr<UserRRef>>& rrefs,
+    const float timeoutSeconds,
+    bool useCache) {
+  const bool cache = useCache &&
+      !autograd::DistAutogradContainer::getInstance().hasValidContext();
+  std::vector<IValue> values(rrefs.size());
+  // owner -> indices of the RRefs to fetch from it
+  std::map<worker_id_t, std::vector<size_t>> indicesByOwner;
+  for (size_t i = 0; i < rrefs.size(); ++i) {
+    rrefs[i]->checkCanFetch();
+    if (cache) {
+      auto cachedValue = rrefs[i]->cachedValue();
+      if (cachedValue) {
+        values[i] = std::move(*cachedValue);
+        continue;
+      }
+    }
+    indicesByOwner[rrefs[i]->owner()].push_back(i);
+  }
+
+  auto agent = RpcAgent::getCurrentRpcAgent();
+  const worker_id_t selfId = agent->getWorkerInfo().id_;
+  std::vector<std::shared_ptr<FutureMessage>> futureResponses;
+  futureResponses.reserve(indicesByOwner.size());
+  for (const auto& owner : indicesByOwner) {
+    std::vector<RRefId> rrefIds;
+    std::vector<c10::optional<ForkId>> cachingForkIds;
+    for (size_t i : owner.second) {
+      rrefIds.emplace_back(rrefs[i]->rrefId());
+      cachingForkIds.emplace_back(
+          cache ? c10::optional<ForkId>(rrefs[i]->forkId()) : c10::nullopt);
+    }
+    futureResponses.push_back(autograd::sendMessageWithAutograd(
+        *agent,
+        agent->getWorkerInfo(owner.first),
+        RRefBatchFetchCall(
+            selfId, std::move(rrefIds), std::move(cachingForkIds))
+            .toMessage(),
+        true /* forceGradRecording */,
+        timeoutSeconds));
+  }
+
+  // All requests are in flight before waiting for any of them.
+  size_t ownerIndex = 0;
+  for (const auto& owner : indicesByOwner) {
+    const Message& message = futureResponses[ownerIndex++]->wait();
+    MessageType msgType = message.type();
+    auto response = deserializeResponse(message, msgType);
+    TORCH_INTERNAL_ASSERT(
+        msgType == MessageType::RREF_BATCH_FETCH_RET,
+        "Message type should be RREF_BATCH_FETCH_RET");
+    RpcCommandBase& rpc = *response;
+    auto& batchFetchRet = static_cast<RRefBatchFetchRet&>(rpc);
+    TORCH_INTERNAL_ASSERT(
+        batchFetchRet.values().size() == owner.second.size(),
+        "Expected the values of ",
+        owner.second.size(),
+        " RRefs, but got ",
+        batchFetchRet.values().size());
+    for (size_t j = 0; j < owner.second.size(); ++j) {
+      size_t i = owner.second[j];
+      values[i] = rrefs[i]->fromFetchedValues(batchFetchRet.values()[j]);
+      if (cache) {
+        rrefs[i]->setCachedValue(values[i], batchFetchRet.versions()[j]);
+      }
+    }
+  }
+  return values;
+}
+
+IValue UserRRef::fromFetchedValues(const std::vector<IValue>& values) const {
   if (isPyObj()) {
     // wrap python serialized vector of ivalues into tuple, this
     // made the C++ toHere interface to return single IValue
-    return ivalue::Tuple::create(rrefFetchRet.values());
+    return ivalue::Tuple::create(values);
   } else {
-    return rrefFetchRet.values().front();
+    return values.front();
+  }
+}
+
+c10::optional<IValue> UserRRef::cachedValue() const {
+  std::lock_guard<std::mutex> guard(cacheMutex_);
+  return cachedValue_;
+}
+
+void UserRRef::setCachedValue(const IValue& value, int64_t version) const {
+  std::lock_guard<std::mutex> guard(cacheMutex_);
+  if (version >= newestVersion_ && version >= cachedVersion_) {
+    cachedValue_ = value;
+    cachedVersion_ = version;
+  }
+}
+
+void UserRRef::invalidateCache(int64_t version) const {
+  std::lock_guard<std::mutex> guard(cacheMutex_);
+  newestVersion_ = std::max(newestVersion_, version);
+  if (cachedValue_ && cachedVersion_ < version) {
+    cachedValue_.reset();
   }
 }
 
@@ -258,6 +380,25 @@ void OwnerRRef::setError(const std::string& error) {
   future_->setErrorIfNeeded(error);
 }
 
+int64_t OwnerRRef::addCachingUser(const ForkId& forkId, worker_id_t workerId) {
+  std::lock_guard<std::mutex> guard(cachingUsersMutex_);
+  cachingUsers_.emplace(forkId, workerId);
+  return version_;
+}
+
+void OwnerRRef::delCachingUser(const ForkId& forkId) {
+  std::lock_guard<std::mutex> guard(cachingUsersMutex_);
+  cachingUsers_.erase(forkId);
+}
+
+std::pair<int64_t, std::unordered_map<ForkId, worker_id_t, ForkId::Hash>>
+OwnerRRef::bumpVersion() {
+  std::unordered_map<ForkId, worker_id_t, ForkId::Hash> staleUsers;
+  std::lock_guard<std::mutex> guard(cachingUsersMutex_);
+  staleUsers.swap(cachingUsers_);
+  return std::make_pair(++version_, std::move(staleUsers));
+}
+
 std::ostream& operator<<(std::ostream& os, const RRef& rref) {
   if (rref.isOwner()) {
     return os << "OwnerRRef("
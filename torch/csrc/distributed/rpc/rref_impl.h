@@ -8,6 +8,8 @@
 #include <torch/csrc/distributed/rpc/types.h>
 
 #include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 namespace torch {
 namespace distributed {
@@ -305,9 +307,24 @@ class TORCH_API UserRRef final : public RRef {
 
   // Get of copy of the value from the ``OwnerRRef``. If the value is not ready
   // yet, this call will block.
+  //
+  // With useCache, the first call keeps the copy, and the next ones return it
+  // without an RPC until the owner tells this UserRRef that the value has a
+  // newer version (see OwnerRRef::bumpVersion). Calls in a distributed
+  // autograd context always fetch the value, so that they are recorded.
   IValue toHere(
-      const float timeoutSeconds =
-          torch::distributed::rpc::kUnsetRpcTimeout) const;
+      const float timeoutSeconds = torch::distributed::rpc::kUnsetRpcTimeout,
+      bool useCache = false) const;
+
+  // Like toHere(), for several UserRRefs at once, with one message for all the
+  // UserRRefs of each owner.
+  static std::vector<IValue> toHereBatch(
+      const std::vector<c10::intrusive_ptr<UserRRef>>& rrefs,
+      const float timeoutSeconds = torch::distributed::rpc::kUnsetRpcTimeout,
+      bool useCache = false);
+
+  // Drops the cached copy of the value if it is older than version.
+  void invalidateCache(int64_t version) const;
 
   void tryDel() override;
 
@@ -329,6 +346,16 @@ class TORCH_API UserRRef final : public RRef {
     confirmedByOwner_ = true;
   }
 
+  // Throws if the value can't be fetched from the owner.
+  void checkCanFetch() const;
+  // The cached copy of the value, if any.
+  c10::optional<IValue> cachedValue() const;
+  // Caches the copy of the given version of the value, unless the owner
+  // already said there is a newer one.
+  void setCachedValue(const IValue& value, int64_t version) const;
+  // The value that toHere() returns for the values of an RRefFetchRet.
+  IValue fromFetchedValues(const std::vector<IValue>& values) const;
+
   const ForkId forkId_;
 
   // Indicates if this user has sent delete message to it's owner.
@@ -339,6 +366,13 @@ class TORCH_API UserRRef final : public RRef {
   bool deletedOnOwner_{false};
   // Indicating whether this UserRRef has been confirmed by its owner.
   std::atomic<bool> confirmedByOwner_;
+
+  // The value cached by toHere(useCache=true) and its version, and the newest
+  // version that the owner has told about.
+  mutable std::mutex cacheMutex_;
+  mutable c10::optional<IValue> cachedValue_;
+  mutable int64_t cachedVersion_{kUncachedRRefVersion};
+  mutable int64_t newestVersion_{kUncachedRRefVersion};
 };
 
 // Keep the template only on the derived class because ``RRefContext`` needs to
@@ -391,10 +425,26 @@ class TORCH_API OwnerRRef final : public RRef {
   // Gets a future that is satisfied when the value or error is set.
   std::shared_ptr<JitFuture> getFuture();
 
+  // Records that the UserRRef forkId on worker workerId caches the value, and
+  // returns the version of the value that it caches.
+  int64_t addCachingUser(const ForkId& forkId, worker_id_t workerId);
+  void delCachingUser(const ForkId& forkId);
+  // Starts a new version of the value, after it has been modified in place,
+  // and returns it along with the users whose cached copies are now stale,
+  // which no longer count as caching it.
+  std::pair<
+      int64_t,
+      std::unordered_map<ForkId, worker_id_t, ForkId::Hash>>
+  bumpVersion();
+
  private:
   friend class RRefContext;
 
   std::shared_ptr<JitFuture> future_;
+
+  std::mutex cachingUsersMutex_;
+  int64_t version_{0};
+  std::unordered_map<ForkId, worker_id_t, ForkId::Hash> cachingUsers_;
 };
 
 TORCH_API std::ostream& operator<<(std::ostream& os, const RRef& rref);
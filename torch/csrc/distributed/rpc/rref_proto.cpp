@@ -35,6 +35,27 @@ Message fromIValues(std::vector<IValue> ivalues, MessageType type) {
   return Message(std::move(payload), std::move(tensor_table), type);
 }
 
+worker_id_t toWorkerId(const IValue& value, const char* messageName) {
+  auto id = value.toInt();
+  TORCH_INTERNAL_ASSERT(
+      id >= std::numeric_limits<worker_id_t>::min() &&
+          id <= std::numeric_limits<worker_id_t>::max(),
+      messageName,
+      " fromWorkerId exceeds worker_id_t limit.");
+  return worker_id_t(id);
+}
+
+IValue cachingForkIdToIValue(const c10::optional<ForkId>& forkId) {
+  return forkId ? forkId->toIValue() : IValue();
+}
+
+c10::optional<ForkId> cachingForkIdFromIValue(const IValue& value) {
+  if (value.isNone()) {
+    return c10::nullopt;
+  }
+  return ForkId::fromIValue(value);
+}
+
 } // namespace
 
 /////////////////////////// RRefMessageBase //////////////////////////////////
@@ -83,9 +104,10 @@ std::pair<RRefId, ForkId> ForkMessageBase::fromMessage(
 
 Message ScriptRRefFetchCall::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
-  ivalues.reserve(2);
+  ivalues.reserve(3);
   ivalues.emplace_back(rrefId_.toIValue());
   ivalues.emplace_back(fromWorkerId_);
+  ivalues.emplace_back(cachingForkIdToIValue(cachingForkId_));
   return fromIValues(std::move(ivalues), MessageType::SCRIPT_RREF_FETCH_CALL);
 }
 
@@ -93,21 +115,19 @@ std::unique_ptr<ScriptRRefFetchCall> ScriptRRefFetchCall::fromMessage(
     const Message& message) {
   auto values = toIValues(message, MessageType::SCRIPT_RREF_FETCH_CALL);
   TORCH_INTERNAL_ASSERT(
-      values.size() == 2, "ScriptRRefFetchCall expects 2 IValues from message");
-  auto id = values[1].toInt();
-  TORCH_INTERNAL_ASSERT(
-      id >= std::numeric_limits<worker_id_t>::min() &&
-          id <= std::numeric_limits<worker_id_t>::max(),
-      "ScriptRRefFetchCall fromWorkerId exceeds worker_id_t limit.")
+      values.size() == 3, "ScriptRRefFetchCall expects 3 IValues from message");
   return std::make_unique<ScriptRRefFetchCall>(
-      worker_id_t(id), RRefId::fromIValue(values[0]));
+      toWorkerId(values[1], "ScriptRRefFetchCall"),
+      RRefId::fromIValue(values[0]),
+      cachingForkIdFromIValue(values[2]));
 }
 
 Message PythonRRefFetchCall::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
-  ivalues.reserve(2);
+  ivalues.reserve(3);
   ivalues.emplace_back(rrefId_.toIValue());
   ivalues.emplace_back(fromWorkerId_);
+  ivalues.emplace_back(cachingForkIdToIValue(cachingForkId_));
   return fromIValues(std::move(ivalues), MessageType::PYTHON_RREF_FETCH_CALL);
 }
 
@@ -115,22 +135,25 @@ std::unique_ptr<PythonRRefFetchCall> PythonRRefFetchCall::fromMessage(
     const Message& message) {
   auto values = toIValues(message, MessageType::PYTHON_RREF_FETCH_CALL);
   TORCH_INTERNAL_ASSERT(
-      values.size() == 2, "PythonRRefFetchCall expects 2 IValues from message");
-  auto id = values[1].toInt();
-  TORCH_INTERNAL_ASSERT(
-      id >= std::numeric_limits<worker_id_t>::min() &&
-          id <= std::numeric_limits<worker_id_t>::max(),
-      "PythonRRefFetchCall fromWorkerId exceeds worker_id_t limit.")
+      values.size() == 3, "PythonRRefFetchCall expects 3 IValues from message");
   return std::make_unique<PythonRRefFetchCall>(
-      worker_id_t(id), RRefId::fromIValue(values[0]));
+      toWorkerId(values[1], "PythonRRefFetchCall"),
+      RRefId::fromIValue(values[0]),
+      cachingForkIdFromIValue(values[2]));
 }
 
 const std::vector<at::IValue>& RRefFetchRet::values() {
   return values_;
 }
 
+int64_t RRefFetchRet::version() const {
+  return version_;
+}
+
 Message RRefFetchRet::toMessageImpl() && {
+  // the version goes after the values
   std::vector<at::IValue> ivalues = values_;
+  ivalues.emplace_back(version_);
   std::vector<torch::Tensor> tensor_table;
   auto payload =
       jit::pickle(c10::ivalue::Tuple::create(ivalues), &tensor_table);
@@ -141,16 +164,22 @@ std::unique_ptr<ScriptRRefFetchRet> ScriptRRefFetchRet::fromMessage(
     const Message& message) {
   auto values = toIValues(message, MessageType::SCRIPT_RREF_FETCH_RET);
   TORCH_INTERNAL_ASSERT(
-      values.size() == 1,
+      values.size() == 2,
       "RRef of IValue should contain a single IValue, but got ",
-      values.size());
-  return std::make_unique<ScriptRRefFetchRet>(std::move(values));
+      values.size() - 1);
+  int64_t version = values.back().toInt();
+  values.pop_back();
+  return std::make_unique<ScriptRRefFetchRet>(std::move(values), version);
 }
 
 std::unique_ptr<PythonRRefFetchRet> PythonRRefFetchRet::fromMessage(
     const Message& message) {
-  return std::make_unique<PythonRRefFetchRet>(
-      toIValues(message, MessageType::PYTHON_RREF_FETCH_RET));
+  auto values = toIValues(message, MessageType::PYTHON_RREF_FETCH_RET);
+  TORCH_INTERNAL_ASSERT(
+      !values.empty(), "PythonRRefFetchRet expects a version from message");
+  int64_t version = values.back().toInt();
+  values.pop_back();
+  return std::make_unique<PythonRRefFetchRet>(std::move(values), version);
 }
 
 std::unique_ptr<RRefUserDelete> RRefUserDelete::fromMessage(
@@ -203,6 +232,103 @@ std::unique_ptr<RRefAck> RRefAck::fromMessage(const Message& message) {
   return std::make_unique<RRefAck>();
 }
 
+int64_t RRefCacheInvalidate::version() const {
+  return version_;
+}
+
+Message RRefCacheInvalidate::toMessageImpl() && {
+  return fromIValues(
+      {rrefId_.toIValue(), forkId_.toIValue(), version_},
+      MessageType::RREF_CACHE_INVALIDATE);
+}
+
+std::unique_ptr<RRefCacheInvalidate> RRefCacheInvalidate::fromMessage(
+    const Message& message) {
+  auto values = toIValues(message, MessageType::RREF_CACHE_INVALIDATE);
+  TORCH_INTERNAL_ASSERT(
+      values.size() == 3, "RRefCacheInvalidate expects 3 IValues from message");
+  return std::make_unique<RRefCacheInvalidate>(
+      RRefId::fromIValue(values[0]),
+      ForkId::fromIValue(values[1]),
+      values[2].toInt());
+}
+
+Message RRefBatchFetchCall::toMessageImpl() && {
+  std::vector<at::IValue> rrefIds;
+  rrefIds.reserve(rrefIds_.size());
+  for (const auto& rrefId : rrefIds_) {
+    rrefIds.emplace_back(rrefId.toIValue());
+  }
+  std::vector<at::IValue> cachingForkIds;
+  cachingForkIds.reserve(cachingForkIds_.size());
+  for (const auto& forkId : cachingForkIds_) {
+    cachingForkIds.emplace_back(cachingForkIdToIValue(forkId));
+  }
+  return fromIValues(
+      {fromWorkerId_,
+       c10::ivalue::Tuple::create(std::move(rrefIds)),
+       c10::ivalue::Tuple::create(std::move(cachingForkIds))},
+      MessageType::RREF_BATCH_FETCH_CALL);
+}
+
+std::unique_ptr<RRefBatchFetchCall> RRefBatchFetchCall::fromMessage(
+    const Message& message) {
+  auto values = toIValues(message, MessageType::RREF_BATCH_FETCH_CALL);
+  TORCH_INTERNAL_ASSERT(
+      values.size() == 3, "RRefBatchFetchCall expects 3 IValues from message");
+  const auto& rrefIdValues = values[1].toTuple()->elements();
+  const auto& forkIdValues = values[2].toTuple()->elements();
+  TORCH_INTERNAL_ASSERT(
+      rrefIdValues.size() == forkIdValues.size(),
+      "RRefBatchFetchCall expects a caching ForkId for each RRefId");
+  std::vector<RRefId> rrefIds;
+  rrefIds.reserve(rrefIdValues.size());
+  for (const auto& value : rrefIdValues) {
+    rrefIds.emplace_back(RRefId::fromIValue(value));
+  }
+  std::vector<c10::optional<ForkId>> cachingForkIds;
+  cachingForkIds.reserve(forkIdValues.size());
+  for (const auto& value : forkIdValues) {
+    cachingForkIds.emplace_back(cachingForkIdFromIValue(value));
+  }
+  return std::make_unique<RRefBatchFetchCall>(
+      toWorkerId(values[0], "RRefBatchFetchCall"),
+      std::move(rrefIds),
+      std::move(cachingForkIds));
+}
+
+Message RRefBatchFetchRet::toMessageImpl() && {
+  // one (version, values...) tuple for each RRef
+  std::vector<at::IValue> entries;
+  entries.reserve(values_.size());
+  for (size_t i = 0; i < values_.size(); ++i) {
+    std::vector<at::IValue> entry;
+    entry.reserve(values_[i].size() + 1);
+    entry.emplace_back(versions_[i]);
+    entry.insert(entry.end(), values_[i].begin(), values_[i].end());
+    entries.emplace_back(c10::ivalue::Tuple::create(std::move(entry)));
+  }
+  return fromIValues(std::move(entries), MessageType::RREF_BATCH_FETCH_RET);
+}
+
+std::unique_ptr<RRefBatchFetchRet> RRefBatchFetchRet::fromMessage(
+    const Message& message) {
+  auto entries = toIValues(message, MessageType::RREF_BATCH_FETCH_RET);
+  std::vector<std::vector<at::IValue>> values;
+  std::vector<int64_t> versions;
+  values.reserve(entries.size());
+  versions.reserve(entries.size());
+  for (const auto& entry : entries) {
+    const auto& elements = entry.toTuple()->elements();
+    TORCH_INTERNAL_ASSERT(
+        !elements.empty(), "RRefBatchFetchRet expects a version for each RRef");
+    versions.push_back(elements.front().toInt());
+    values.emplace_back(elements.begin() + 1, elements.end());
+  }
+  return std::make_unique<RRefBatchFetchRet>(
+      std::move(values), std::move(versions));
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
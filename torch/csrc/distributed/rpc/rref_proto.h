@@ -49,29 +49,52 @@ class TORCH_API ForkMessageBase : public RRefMessageBase {
 };
 
 // UserRRef uses this message to fetch the remote RRef value from the owner.
+// With a cachingForkId, the owner records that the UserRRef of this ForkId
+// caches the value, and tells it when the value goes stale.
 class TORCH_API ScriptRRefFetchCall final : public RRefMessageBase {
  public:
-  ScriptRRefFetchCall(worker_id_t fromWorkerId, const RRefId& rrefId)
+  ScriptRRefFetchCall(
+      worker_id_t fromWorkerId,
+      const RRefId& rrefId,
+      c10::optional<ForkId> cachingForkId = c10::nullopt)
       : RRefMessageBase(rrefId, MessageType::SCRIPT_RREF_FETCH_CALL),
-        fromWorkerId_(fromWorkerId) {}
+        fromWorkerId_(fromWorkerId),
+        cachingForkId_(std::move(cachingForkId)) {}
 
   inline worker_id_t fromWorkerId() const {
     return fromWorkerId_;
   }
 
+  inline const c10::optional<ForkId>& cachingForkId() const {
+    return cachingForkId_;
+  }
+
   Message toMessageImpl() && override;
   static std::unique_ptr<ScriptRRefFetchCall> fromMessage(
       const Message& message);
 
  private:
   const worker_id_t fromWorkerId_;
+  const c10::optional<ForkId> cachingForkId_;
 };
 
 class TORCH_API PythonRRefFetchCall final : public RRefMessageBase {
  public:
-  PythonRRefFetchCall(worker_id_t fromWorkerId, const RRefId& rrefId)
+  PythonRRefFetchCall(
+      worker_id_t fromWorkerId,
+      const RRefId& rrefId,
+      c10::optional<ForkId> cachingForkId = c10::nullopt)
       : RRefMessageBase(rrefId, MessageType::PYTHON_RREF_FETCH_CALL),
-        fromWorkerId_(fromWorkerId) {}
+        fromWorkerId_(fromWorkerId),
+        cachingForkId_(std::move(cachingForkId)) {}
+
+  inline worker_id_t fromWorkerId() const {
+    return fromWorkerId_;
+  }
+
+  inline const c10::optional<ForkId>& cachingForkId() const {
+    return cachingForkId_;
+  }
 
   Message toMessageImpl() && override;
   static std::unique_ptr<PythonRRefFetchCall> fromMessage(
@@ -79,26 +102,38 @@ class TORCH_API PythonRRefFetchCall final : public RRefMessageBase {
 
  private:
   const worker_id_t fromWorkerId_;
+  const c10::optional<ForkId> cachingForkId_;
 };
 
-// OwnerRRef uses this message to send the RRef value to a remote UserRRef
+// OwnerRRef uses this message to send the RRef value to a remote UserRRef,
+// along with the version of the value if the user caches it.
 class TORCH_API RRefFetchRet : public RpcCommandBase {
  public:
-  RRefFetchRet(std::vector<at::IValue> values, MessageType type)
-      : values_(std::move(values)), type_(type) {}
+  RRefFetchRet(
+      std::vector<at::IValue> values,
+      MessageType type,
+      int64_t version = kUncachedRRefVersion)
+      : values_(std::move(values)), type_(type), version_(version) {}
 
   const std::vector<at::IValue>& values();
+  int64_t version() const;
   Message toMessageImpl() && override;
 
  private:
   std::vector<at::IValue> values_;
   const MessageType type_;
+  const int64_t version_;
 };
 
 class TORCH_API ScriptRRefFetchRet final : public RRefFetchRet {
  public:
-  explicit ScriptRRefFetchRet(std::vector<at::IValue> values)
-      : RRefFetchRet(std::move(values), MessageType::SCRIPT_RREF_FETCH_RET) {}
+  explicit ScriptRRefFetchRet(
+      std::vector<at::IValue> values,
+      int64_t version = kUncachedRRefVersion)
+      : RRefFetchRet(
+            std::move(values),
+            MessageType::SCRIPT_RREF_FETCH_RET,
+            version) {}
 
   static std::unique_ptr<ScriptRRefFetchRet> fromMessage(
       const Message& message);
@@ -106,8 +141,13 @@ class TORCH_API ScriptRRefFetchRet final : public RRefFetchRet {
 
 class TORCH_API PythonRRefFetchRet final : public RRefFetchRet {
  public:
-  explicit PythonRRefFetchRet(std::vector<at::IValue> values)
-      : RRefFetchRet(std::move(values), MessageType::PYTHON_RREF_FETCH_RET) {}
+  explicit PythonRRefFetchRet(
+      std::vector<at::IValue> values,
+      int64_t version = kUncachedRRefVersion)
+      : RRefFetchRet(
+            std::move(values),
+            MessageType::PYTHON_RREF_FETCH_RET,
+            version) {}
 
   static std::unique_ptr<PythonRRefFetchRet> fromMessage(
       const Message& message);
@@ -163,6 +203,88 @@ class TORCH_API RRefAck final : public RpcCommandBase {
   static std::unique_ptr<RRefAck> fromMessage(const Message& message);
 };
 
+// OwnerRRef uses this message to tell a UserRRef that caches its value that
+// the value now has a newer version.
+class TORCH_API RRefCacheInvalidate final : public ForkMessageBase {
+ public:
+  RRefCacheInvalidate(
+      const RRefId& rrefId,
+      const ForkId& forkId,
+      int64_t version)
+      : ForkMessageBase(rrefId, forkId, MessageType::RREF_CACHE_INVALIDATE),
+        version_(version) {}
+
+  int64_t version() const;
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefCacheInvalidate> fromMessage(
+      const Message& message);
+
+ private:
+  const int64_t version_;
+};
+
+// UserRRefs use this message to fetch the values of several RRefs of the same
+// owner at once. The caching ForkIds are as in ScriptRRefFetchCall.
+class TORCH_API RRefBatchFetchCall final : public RpcCommandBase {
+ public:
+  RRefBatchFetchCall(
+      worker_id_t fromWorkerId,
+      std::vector<RRefId> rrefIds,
+      std::vector<c10::optional<ForkId>> cachingForkIds)
+      : fromWorkerId_(fromWorkerId),
+        rrefIds_(std::move(rrefIds)),
+        cachingForkIds_(std::move(cachingForkIds)) {}
+
+  inline worker_id_t fromWorkerId() const {
+    return fromWorkerId_;
+  }
+
+  inline const std::vector<RRefId>& rrefIds() const {
+    return rrefIds_;
+  }
+
+  inline const std::vector<c10::optional<ForkId>>& cachingForkIds() const {
+    return cachingForkIds_;
+  }
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefBatchFetchCall> fromMessage(
+      const Message& message);
+
+ private:
+  const worker_id_t fromWorkerId_;
+  const std::vector<RRefId> rrefIds_;
+  const std::vector<c10::optional<ForkId>> cachingForkIds_;
+};
+
+// The values of the RRefs of an RRefBatchFetchCall, in the same order. Each
+// of them is as in ScriptRRefFetchRet or PythonRRefFetchRet, depending on
+// whether the RRef holds a py::object.
+class TORCH_API RRefBatchFetchRet final : public RpcCommandBase {
+ public:
+  RRefBatchFetchRet(
+      std::vector<std::vector<at::IValue>> values,
+      std::vector<int64_t> versions)
+      : values_(std::move(values)), versions_(std::move(versions)) {}
+
+  inline std::vector<std::vector<at::IValue>>& values() {
+    return values_;
+  }
+
+  inline const std::vector<int64_t>& versions() const {
+    return versions_;
+  }
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefBatchFetchRet> fromMessage(
+      const Message& message);
+
+ private:
+  std::vector<std::vector<at::IValue>> values_;
+  std::vector<int64_t> versions_;
+};
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
@@ -0,0 +1,270 @@
+#include <torch/csrc/distributed/rpc/script_call_batcher.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+using JitFuture = c10::ivalue::Future;
+
+// Returns the batch size of a call, or -1 if the call cannot be batched.
+int64_t batchSizeOf(const std::vector<c10::IValue>& stack) {
+  int64_t batchSize = -1;
+  for (const auto& arg : stack) {
+    if (!arg.isTensor()) {
+      return -1;
+    }
+    const auto& tensor = arg.toTensor();
+    if (!tensor.defined() || tensor.dim() == 0 || tensor.is_sparse()) {
+      return -1;
+    }
+    if (batchSize == -1) {
+      batchSize = tensor.size(0);
+    } else if (tensor.size(0) != batchSize) {
+      return -1;
+    }
+  }
+  return batchSize;
+}
+
+void runUnbatched(
+    torch::jit::Function& fn,
+    std::vector<c10::IValue> stack,
+    const c10::intrusive_ptr<JitFuture>& future) {
+  c10::IValue output;
+  try {
+    output = fn(std::move(stack));
+  } catch (const std::exception& e) {
+    future->setError(e.what());
+    return;
+  }
+  future->markCompleted(std::move(output));
+}
+
+} // namespace
+
+ScriptCallBatcher& ScriptCallBatcher::getInstance() {
+  static ScriptCallBatcher batcher;
+  return batcher;
+}
+
+ScriptCallBatcher::~ScriptCallBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  timerCV_.notify_one();
+  if (timerThread_.joinable()) {
+    timerThread_.join();
+  }
+}
+
+void ScriptCallBatcher::enable(
+    const c10::QualifiedName& qualifiedName,
+    BatchingOptions options) {
+  TORCH_CHECK(
+      options.maxBatchSize > 0,
+      "maxBatchSize must be positive, but got ",
+      options.maxBatchSize);
+  TORCH_CHECK(
+      options.maxWaitTime.count() >= 0,
+      "maxWaitTime must not be negative, but got ",
+      options.maxWaitTime.count(),
+      "ms");
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& queue = queues_[qualifiedName.qualifiedName()];
+  queue.options = options;
+  if (!timerThread_.joinable()) {
+    timerThread_ = std::thread(&ScriptCallBatcher::timerLoop, this);
+  }
+}
+
+void ScriptCallBatcher::disable(const c10::QualifiedName& qualifiedName) {
+  Batch batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(qualifiedName.qualifiedName());
+    if (it == queues_.end()) {
+      return;
+    }
+    batch.fn = it->second.fn;
+    batch.calls = std::move(it->second.calls);
+    queues_.erase(it);
+  }
+  // Calls that are already queued still run.
+  if (!batch.calls.empty()) {
+    runBatch(std::move(batch));
+  }
+}
+
+c10::intrusive_ptr<JitFuture> ScriptCallBatcher::submit(
+    torch::jit::Function& fn,
+    std::vector<c10::IValue>& stack) {
+  if (stack.empty() || batchSizeOf(stack) == -1) {
+    return {};
+  }
+
+  // Script functions return a single IValue (see rpcTorchscript), which is a
+  // tuple if there are several outputs.
+  const auto& returns = fn.getSchema().returns();
+  if (returns.size() != 1) {
+    return {};
+  }
+  auto future = c10::make_intrusive<JitFuture>(returns.front().type());
+  Batch batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queues_.find(fn.qualname().qualifiedName());
+    if (it == queues_.end()) {
+      return {};
+    }
+    auto& queue = it->second;
+    if (queue.calls.empty()) {
+      queue.fn = &fn;
+      queue.deadline =
+          std::chrono::steady_clock::now() + queue.options.maxWaitTime;
+    } else if (queue.calls.front().stack.size() != stack.size()) {
+      // Different number of arguments (e.g., the function was redefined).
+      return {};
+    }
+    queue.calls.push_back(PendingCall{std::move(stack), future});
+    if (queue.calls.size() < static_cast<size_t>(queue.options.maxBatchSize)) {
+      if (queue.calls.size() == 1) {
+        timerCV_.notify_one();
+      }
+      return future;
+    }
+    batch.fn = queue.fn;
+    batch.calls = std::move(queue.calls);
+    queue.calls.clear();
+  }
+  runBatch(std::move(batch));
+  return future;
+}
+
+void ScriptCallBatcher::timerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!shutdown_) {
+    auto now = std::chrono::steady_clock::now();
+    auto nextDeadline = std::chrono::steady_clock::time_point::max();
+    for (auto& entry : queues_) {
+      auto& queue = entry.second;
+      if (queue.calls.empty()) {
+        continue;
+      }
+      if (queue.deadline <= now) {
+        Batch batch{queue.fn, std::move(queue.calls)};
+        queue.calls.clear();
+        // Run on another thread so that a slow batch does not hold up the
+        // deadlines of other functions.
+        at::launch([batch = std::move(batch)]() mutable {
+          runBatch(std::move(batch));
+        });
+      } else {
+        nextDeadline = std::min(nextDeadline, queue.deadline);
+      }
+    }
+    if (nextDeadline == std::chrono::steady_clock::time_point::max()) {
+      timerCV_.wait(lock);
+    } else {
+      timerCV_.wait_until(lock, nextDeadline);
+    }
+  }
+}
+
+void ScriptCallBatcher::runBatch(Batch batch) {
+  auto& calls = batch.calls;
+  if (calls.size() == 1) {
+    runUnbatched(*batch.fn, std::move(calls[0].stack), calls[0].future);
+    return;
+  }
+
+  std::vector<int64_t> batchSizes;
+  batchSizes.reserve(calls.size());
+  int64_t totalSize = 0;
+  for (const auto& call : calls) {
+    batchSizes.push_back(call.stack.front().toTensor().size(0));
+    totalSize += batchSizes.back();
+  }
+
+  std::vector<c10::IValue> batchedStack;
+  try {
+    const auto numArgs = calls.front().stack.size();
+    batchedStack.reserve(numArgs);
+    std::vector<at::Tensor> parts(calls.size());
+    for (size_t i = 0; i < numArgs; i++) {
+      for (size_t j = 0; j < calls.size(); j++) {
+        parts[j] = calls[j].stack[i].toTensor();
+      }
+      batchedStack.emplace_back(at::cat(parts, 0));
+    }
+  } catch (const std::exception&) {
+    for (auto& call : calls) {
+      runUnbatched(*batch.fn, std::move(call.stack), call.future);
+    }
+    return;
+  }
+
+  // The results are views of the batched output. The agents clone tensors
+  // that use only a small part of their storage before sending them, so this
+  // does not send the whole batch back to every caller.
+  std::vector<c10::IValue> results(calls.size());
+  try {
+    auto split = [&](const c10::IValue& value) {
+      TORCH_CHECK(
+          value.isTensor(),
+          "Batched TorchScript functions must return Tensors, but got ",
+          value.tagKind());
+      const auto& tensor = value.toTensor();
+      TORCH_CHECK(
+          tensor.dim() > 0 && tensor.size(0) == totalSize,
+          "Output of batched TorchScript function ",
+          batch.fn->qualname().qualifiedName(),
+          " must have size ",
+          totalSize,
+          " in dimension 0, but got shape ",
+          tensor.sizes());
+      return tensor.split_with_sizes(batchSizes, 0);
+    };
+
+    auto output = (*batch.fn)(std::move(batchedStack));
+    if (output.isTuple()) {
+      const auto& elements = output.toTuple()->elements();
+      std::vector<std::vector<at::Tensor>> splits;
+      splits.reserve(elements.size());
+      for (const auto& element : elements) {
+        splits.push_back(split(element));
+      }
+      for (size_t i = 0; i < calls.size(); i++) {
+        std::vector<c10::IValue> items;
+        items.reserve(splits.size());
+        for (const auto& parts : splits) {
+          items.emplace_back(parts[i]);
+        }
+        results[i] = c10::ivalue::Tuple::create(std::move(items));
+      }
+    } else {
+      auto parts = split(output);
+      for (size_t i = 0; i < calls.size(); i++) {
+        results[i] = std::move(parts[i]);
+      }
+    }
+  } catch (const std::exception& e) {
+    for (auto& call : calls) {
+      call.future->setError(e.what());
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < calls.size(); i++) {
+    calls[i].future->markCompleted(std::move(results[i]));
+  }
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <ATen/core/function.h>
+#include <ATen/core/ivalue.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+struct TORCH_API BatchingOptions {
+  // A batch runs as soon as it holds this many calls.
+  int64_t maxBatchSize;
+  // Longest time the first call of a batch waits for more calls to arrive.
+  std::chrono::milliseconds maxWaitTime;
+};
+
+// Coalesces concurrent RPCs to the same TorchScript function into a single
+// invocation on the callee. This is meant for serving inference over RPC,
+// where running one large batch is much cheaper than running many small ones.
+//
+// Batching is enabled per function. A batchable call passes only Tensor
+// arguments, all with the same size in dimension 0 (the call's batch size).
+// The calls of a batch are concatenated along dimension 0, the function runs
+// once, and its result (a Tensor or a tuple of Tensors) is split along
+// dimension 0 back into the future of each call. A batch runs when it is full,
+// in the thread that filled it, or when its oldest call has waited for
+// maxWaitTime, on an at::launch() thread. If concatenating the arguments
+// fails, e.g. because their other dimensions differ, each call of the batch
+// runs on its own instead.
+class TORCH_API ScriptCallBatcher {
+ public:
+  static ScriptCallBatcher& getInstance();
+
+  ~ScriptCallBatcher();
+
+  void enable(const c10::QualifiedName& qualifiedName, BatchingOptions options);
+  void disable(const c10::QualifiedName& qualifiedName);
+
+  // Queues a call to fn and returns the future of its result. Returns a null
+  // pointer, and leaves stack untouched, if batching is not enabled for fn or
+  // the arguments cannot be batched; the caller should then run fn itself.
+  c10::intrusive_ptr<c10::ivalue::Future> submit(
+      torch::jit::Function& fn,
+      std::vector<c10::IValue>& stack);
+
+ private:
+  struct PendingCall {
+    std::vector<c10::IValue> stack;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+  };
+
+  struct Batch {
+    torch::jit::Function* fn;
+    std::vector<PendingCall> calls;
+  };
+
+  struct Queue {
+    BatchingOptions options;
+    std::vector<PendingCall> calls;
+    torch::jit::Function* fn = nullptr;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  ScriptCallBatcher() = default;
+
+  // Runs on timerThread_ and flushes the queues whose deadline has passed.
+  void timerLoop();
+
+  static void runBatch(Batch batch);
+
+  std::mutex mutex_;
+  std::condition_variable timerCV_;
+  // Keyed by qualified function name.
+  std::unordered_map<std::string, Queue> queues_;
+  std::thread timerThread_;
+  bool shutdown_{false};
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
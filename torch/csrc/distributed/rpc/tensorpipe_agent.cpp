@@ -1,7 +1,9 @@
 #include <torch/csrc/distributed/rpc/tensorpipe_agent.h>
 
+#include <cstring>
 #include <limits>
 
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <fmt/format.h>
 #include <tensorpipe/tensorpipe.h>
 
@@ -221,6 +223,108 @@ void TensorPipeAgent::collectNames() {
   }
 }
 
+void TensorPipeAgent::collectDeviceMaps() {
+  const std::string& selfName = workerInfo_.name_;
+  const int numDevices = at::detail::getCUDAHooks().getNumGPUs();
+
+  for (const auto& entry : opts_.deviceMaps) {
+    TORCH_CHECK(
+        workerNameToInfo_.count(entry.first),
+        "A device map is set for unknown worker ",
+        entry.first);
+    for (const auto& devices : entry.second) {
+      TORCH_CHECK(
+          devices.first < numDevices,
+          "The device map for ",
+          entry.first,
+          " uses device ",
+          devices.first,
+          ", but worker ",
+          selfName,
+          " only has ",
+          numDevices,
+          " CUDA devices");
+    }
+  }
+
+  // Every worker publishes its (possibly empty) map for every worker, as
+  // pairs of device indices.
+  for (const auto& p : workerNameToInfo_) {
+    const auto& peerName = p.first;
+    std::vector<c10::DeviceIndex> indices;
+    auto it = opts_.deviceMaps.find(peerName);
+    if (it != opts_.deviceMaps.end()) {
+      for (const auto& devices : it->second) {
+        indices.push_back(devices.first);
+        indices.push_back(devices.second);
+      }
+    }
+    std::vector<uint8_t> data(
+        reinterpret_cast<const uint8_t*>(indices.data()),
+        reinterpret_cast<const uint8_t*>(indices.data() + indices.size()));
+    deviceMapsStore_.set(selfName + "/" + peerName, data);
+  }
+
+  for (const auto& p : workerNameToInfo_) {
+    const auto& peerName = p.first;
+    std::vector<uint8_t> data = deviceMapsStore_.get(peerName + "/" + selfName);
+    TORCH_INTERNAL_ASSERT(data.size() % (2 * sizeof(c10::DeviceIndex)) == 0);
+    std::vector<c10::DeviceIndex> indices(
+        data.size() / sizeof(c10::DeviceIndex));
+    std::memcpy(indices.data(), data.data(), data.size());
+
+    auto& reverseDeviceMap = reverseDeviceMaps_[peerName];
+    for (size_t i = 0; i < indices.size(); i += 2) {
+      TORCH_CHECK(
+          indices[i + 1] < numDevices,
+          "Worker ",
+          peerName,
+          " maps its device ",
+          indices[i],
+          " to device ",
+          indices[i + 1],
+          " of worker ",
+          selfName,
+          ", which only has ",
+          numDevices,
+          " CUDA devices");
+      reverseDeviceMap.emplace(indices[i + 1], indices[i]);
+    }
+  }
+}
+
+std::vector<c10::Device> TensorPipeAgent::getTargetDevices(
+    const Message& message,
+    const std::string& peerName,
+    const DeviceMap* deviceMap) {
+  std::vector<c10::Device> devices;
+  devices.reserve(message.tensors().size());
+  for (const auto& tensor : message.tensors()) {
+    if (tensor.device().is_cpu()) {
+      devices.emplace_back(c10::kCPU);
+      continue;
+    }
+    c10::optional<c10::DeviceIndex> target;
+    if (tensor.is_cuda() && deviceMap != nullptr) {
+      auto it = deviceMap->find(tensor.device().index());
+      if (it != deviceMap->end()) {
+        target = it->second;
+      }
+    }
+    TORCH_CHECK(
+        target.has_value(),
+        "TensorPipe RPC backend only supports CPU tensors by default, please ",
+        "move your tensors to CPU before sending them over RPC, or set a ",
+        "device map for ",
+        peerName,
+        " (see TensorPipeRpcBackendOptions.set_device_map). Found tensor on ",
+        "device: ",
+        tensor.device());
+    devices.emplace_back(c10::kCUDA, *target);
+  }
+  return devices;
+}
+
 TensorPipeAgent::TensorPipeAgent(
     const std::shared_ptr<::c10d::Store>& store,
     std::string selfName,
@@ -239,9 +343,11 @@ TensorPipeAgent::TensorPipeAgent(
           tensorpipe::ContextOptions().name(workerInfo_.name_))),
       rankToNameStore_("names", store),
       nameToAddressStore_("addrs", store),
+      deviceMapsStore_("device_maps", store),
       worldSize_(worldSize),
       processGroup_(std::move(processGroup)) {
   collectNames();
+  collectDeviceMaps();
 
   // Initialize the time-series metrics tracking map
   timeSeriesMetrics_.emplace(kGilAverageWaitTime, TimeSeriesMetricsTracker());
@@ -402,10 +508,12 @@ void TensorPipeAgent::pipeRead(
 void TensorPipeAgent::pipeWrite(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
     Message&& rpcMessage,
+    std::vector<c10::Device>&& devices,
     std::function<void(const tensorpipe::Error&)> fn) {
   tensorpipe::Message tpMessage;
   TensorpipeWriteBuffers tpBuffers;
-  std::tie(tpMessage, tpBuffers) = tensorpipeSerialize(std::move(rpcMessage));
+  std::tie(tpMessage, tpBuffers) =
+      tensorpipeSerialize(std::move(rpcMessage), std::move(devices));
   pipe->write(
       std::move(tpMessage),
       [tpBuffers{
@@ -436,22 +544,23 @@ void TensorPipeAgent::sendCompletedResponseMessage(
   Message&& responseMessage = std::move(*futureResponseMessage).moveValue();
   responseMessage.setId(messageId);
   if (!error) {
-    for (const auto& tensor : responseMessage.tensors()) {
-      if (!tensor.device().is_cpu()) {
-        responseMessage = createExceptionResponse(
-            c10::str(
-                "TensorPipe RPC backend only supports CPU tensors, please ",
-                "move your tensors to CPU before sending them over RPC. Found ",
-                "tensor on device: ",
-                tensor.device()),
-            responseMessage.id());
-        break;
-      }
+    // CUDA tensors go back to the devices they came from, i.e., through the
+    // inverse of the caller's device map.
+    std::vector<c10::Device> devices;
+    try {
+      auto it = reverseDeviceMaps_.find(pipe->getRemoteName());
+      devices = getTargetDevices(
+          responseMessage,
+          pipe->getRemoteName(),
+          it == reverseDeviceMaps_.end() ? nullptr : &it->second);
+    } catch (const std::exception& e) {
+      responseMessage = createExceptionResponse(e.what(), responseMessage.id());
     }
 
     pipeWrite(
         pipe,
         std::move(responseMessage),
+        std::move(devices),
         [this, pipe, messageId](const tensorpipe::Error& error) {
           if (error) {
             LOG(WARNING)
@@ -470,6 +579,7 @@ void TensorPipeAgent::sendCompletedResponseMessage(
     pipeWrite(
         pipe,
         createExceptionResponse(error->what(), responseMessage.id()),
+        {},
         [this, pipe, messageId](const tensorpipe::Error& error) {
           if (error) {
             LOG(WARNING)
@@ -579,13 +689,11 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
     throw std::runtime_error(err);
   }
 
-  for (const auto& tensor : requestMessage.tensors()) {
-    TORCH_CHECK(
-        tensor.device().is_cpu(),
-        "TensorPipe RPC backend only supports CPU tensors, please move your ",
-        "tensors to CPU before sending them over RPC. Found tensor on device: ",
-        tensor.device());
-  }
+  auto deviceMapIt = opts_.deviceMaps.find(toWorkerInfo.name_);
+  auto devices = getTargetDevices(
+      requestMessage,
+      toWorkerInfo.name_,
+      deviceMapIt == opts_.deviceMaps.end() ? nullptr : &deviceMapIt->second);
 
   const auto& url = findWorkerURL(toWorkerInfo);
 
@@ -645,6 +753,7 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
   pipeWrite(
       clientPipe.pipe_,
       std::move(requestMessage),
+      std::move(devices),
       [this, &clientPipe, messageId](const tensorpipe::Error& error) mutable {
         if (error) {
           if (error.isOfType<tensorpipe::PipeClosedError>() &&
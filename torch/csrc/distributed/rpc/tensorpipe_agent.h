@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <thread>
+#include <unordered_set>
 
 #include <c10/core/thread_pool.h>
 #include <c10d/PrefixStore.hpp>
@@ -57,17 +58,22 @@ C10_DECLARE_REGISTRY(TensorPipeChannelRegistry, ChannelRegistration);
 
 constexpr auto kDefaultNumWorkerThreads = 16;
 
+// Maps the CUDA devices of this worker to the ones of a peer.
+using DeviceMap = std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>;
+
 struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
   TensorPipeRpcBackendOptions(
       int numWorkerThreads,
       optional<std::vector<std::string>> transports,
       optional<std::vector<std::string>> channels,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      std::unordered_map<std::string, DeviceMap> device_maps = {})
       : RpcBackendOptions(rpc_timeout, init_method),
         numWorkerThreads(numWorkerThreads),
         transports(std::move(transports)),
-        channels(std::move(channels)) {
+        channels(std::move(channels)),
+        deviceMaps(std::move(device_maps)) {
     TORCH_CHECK(
         numWorkerThreads > 0,
         "num_worker_threads must be positive, got ",
@@ -90,11 +96,53 @@ struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
             channelName);
       }
     }
+
+    for (const auto& entry : deviceMaps) {
+      checkDeviceMap(entry.first, entry.second);
+    }
+  }
+
+  // Adds the entries of `deviceMap` to the map for worker `workerName`.
+  void setDeviceMap(const std::string& workerName, const DeviceMap& deviceMap) {
+    auto& currentMap = deviceMaps[workerName];
+    for (const auto& entry : deviceMap) {
+      currentMap[entry.first] = entry.second;
+    }
+    checkDeviceMap(workerName, currentMap);
   }
 
   int numWorkerThreads;
   const optional<std::vector<std::string>> transports;
   const optional<std::vector<std::string>> channels;
+  // For every peer, the CUDA device each local device is mapped to when
+  // sending it a request. Responses use the inverse of the caller's map. CUDA
+  // tensors can only be sent to peers (and only from devices) listed here.
+  std::unordered_map<std::string, DeviceMap> deviceMaps;
+
+ private:
+  static void checkDeviceMap(
+      const std::string& workerName,
+      const DeviceMap& deviceMap) {
+    std::unordered_set<c10::DeviceIndex> targets;
+    for (const auto& entry : deviceMap) {
+      TORCH_CHECK(
+          entry.first >= 0 && entry.second >= 0,
+          "Device indices in the device map for ",
+          workerName,
+          " must be non-negative, got ",
+          entry.first,
+          " -> ",
+          entry.second);
+      // Responses are sent back with the inverse map.
+      TORCH_CHECK(
+          targets.insert(entry.second).second,
+          "The device map for ",
+          workerName,
+          " must be one-to-one, but device ",
+          entry.second,
+          " is the target of more than one device");
+    }
+  }
 };
 
 // Struct to track the network source metrics
@@ -114,7 +162,10 @@ struct AggregatedNetworkData {
 // TensorPipeAgent leverages TensorPipe (https://github.com/pytorch/tensorpipe)
 // to transparently move tensors and payloads through the fastest available
 // transport or channel. It acts like a hybrid RPC transport, providing shared
-// memory (linux) and TCP (linux & mac) support. CUDA support is in progress.
+// memory (linux) and TCP (linux & mac) support. CUDA tensors can be sent to
+// peers for which a device map is set, see
+// TensorPipeRpcBackendOptions::deviceMaps. They are staged through pinned host
+// memory on both ends and placed on the mapped device by the receiver.
 class TensorPipeAgent : public RpcAgent {
  public:
   TensorPipeAgent(
@@ -165,6 +216,18 @@ class TensorPipeAgent : public RpcAgent {
   // Populates workerIdToInfo_ and workerNameToInfo_ using addressStore_
   void collectNames();
 
+  // Publishes the device maps of opts_ and populates reverseDeviceMaps_ with
+  // the inverse of the maps the other workers set for this one.
+  void collectDeviceMaps();
+
+  // Returns the devices the tensors of `message` must be moved to by peer
+  // `peerName`, mapping CUDA devices with `deviceMap` (which may be null).
+  // Throws if a CUDA device is not mapped.
+  static std::vector<c10::Device> getTargetDevices(
+      const Message& message,
+      const std::string& peerName,
+      const DeviceMap* deviceMap);
+
   const std::string& findWorkerURL(const WorkerInfo& worker) const;
 
   // TensorPipe read function that could be used to read response messages
@@ -174,10 +237,12 @@ class TensorPipeAgent : public RpcAgent {
       std::function<void(const tensorpipe::Error&, Message&&)>);
 
   // TensorPipe write function that could be used to write response
-  // messages by server, and write request messages by client.
+  // messages by server, and write request messages by client. `devices` are
+  // the devices the peer will move the tensors of the message to.
   void pipeWrite(
       const std::shared_ptr<tensorpipe::Pipe>&,
       Message&& message,
+      std::vector<c10::Device>&& devices,
       std::function<void(const tensorpipe::Error&)>);
 
   // Callback of listener accept()
@@ -243,8 +308,13 @@ class TensorPipeAgent : public RpcAgent {
 
   ::c10d::PrefixStore rankToNameStore_;
   ::c10d::PrefixStore nameToAddressStore_;
+  ::c10d::PrefixStore deviceMapsStore_;
   const int worldSize_;
 
+  // For every peer, the inverse of the device map it set for this worker, used
+  // to send the CUDA tensors of responses.
+  std::unordered_map<std::string, DeviceMap> reverseDeviceMaps_;
+
   // The join method is required to behave like a barrier and perform collective
   // operations. For simplicity and reliability, we offload this to a process
   // group, but probably one day we might want to re-implement them using RPCs.
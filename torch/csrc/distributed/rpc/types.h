@@ -50,6 +50,10 @@ using RRefId = GloballyUniqueId;
 using ForkId = GloballyUniqueId;
 using ProfilingId = GloballyUniqueId;
 
+// The version of an RRef value that its owner doesn't track for a user, as the
+// user doesn't cache it.
+constexpr int64_t kUncachedRRefVersion = -1;
+
 struct TORCH_API SerializedPyObj final {
   SerializedPyObj(std::string&& payload, std::vector<at::Tensor>&& tensors)
       : payload_(std::move(payload)), tensors_(std::move(tensors)) {}
@@ -22,6 +22,7 @@
 #include <torch/csrc/jit/serialization/unpickler.h>
 
 #ifdef USE_TENSORPIPE
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <tensorpipe/core/message.h>
 #endif
 
@@ -125,10 +126,17 @@ std::unique_ptr<RpcCommandBase> deserializeRequest(const Message& request) {
     case MessageType::RREF_FORK_REQUEST: {
       return RRefForkRequest::fromMessage(request);
     }
+    case MessageType::RREF_CACHE_INVALIDATE: {
+      return RRefCacheInvalidate::fromMessage(request);
+    }
+    case MessageType::RREF_BATCH_FETCH_CALL: {
+      return RRefBatchFetchCall::fromMessage(request);
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       return autograd::RpcWithAutograd::fromMessage(request);
     }
-    case MessageType::BACKWARD_AUTOGRAD_REQ: {
+    case MessageType::BACKWARD_AUTOGRAD_REQ:
+    case MessageType::BACKWARD_AUTOGRAD_BATCH_REQ: {
       return autograd::PropagateGradientsReq::fromMessage(request);
     }
     case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ: {
@@ -163,6 +171,9 @@ std::unique_ptr<RpcCommandBase> deserializeResponse(
     case MessageType::PYTHON_RREF_FETCH_RET: {
       return PythonRRefFetchRet::fromMessage(response);
     }
+    case MessageType::RREF_BATCH_FETCH_RET: {
+      return RRefBatchFetchRet::fromMessage(response);
+    }
     case MessageType::RREF_ACK: {
       return RRefAck::fromMessage(response);
     }
@@ -248,6 +259,10 @@ namespace {
 //    - "meta"    - metadata for the unpickler
 //    - "0" ...   - tensor sections for the unpickler
 //
+// When the tensors are sent as separate segments (wireSerializeSegments), the
+// tensor sections are left out, and a "segments" section lists the sizes of
+// the segments, separated by spaces, in the order of the tensor sections.
+//
 // Note that per the header comments, the format is subject to change,
 // and is best used for rpcs, rather than persistent disk storage.
 std::unordered_map<std::string, std::pair<const char*, size_t>>
@@ -304,6 +319,7 @@ parseWireSections(const void* data, size_t data_size) {
 
 static const char* kMeta = "meta";
 static const char* kPayload = "payload";
+static const char* kSegments = "segments";
 }; // namespace
 
 c10::List<at::Tensor> cloneSparseTensors(
@@ -330,9 +346,15 @@ c10::List<at::Tensor> cloneSparseTensors(
   return pTensors;
 }
 
-std::string wireSerialize(
-    const std::vector<char>& payload,
-    const std::vector<at::Tensor>& tensors) {
+namespace {
+
+struct WireEntry {
+  std::string name;
+  const char* data;
+  size_t size;
+};
+
+void checkWireTensors(const std::vector<at::Tensor>& tensors) {
   for (const auto& tensor : tensors) {
     TORCH_CHECK(
         tensor.device().is_cpu(),
@@ -341,13 +363,91 @@ std::string wireSerialize(
         "them over RPC. Found tensor on device: ",
         tensor.device());
   }
+}
+
+// Pickles the tensors into metaEntry, and returns the tensors whose storages
+// the pickle refers to, in order.
+std::vector<at::Tensor> pickleWireTensors(
+    const std::vector<at::Tensor>& tensors,
+    std::string& metaEntry) {
+  torch::jit::Pickler pickler([&](const void* buf, size_t sz) -> size_t {
+    metaEntry.append(static_cast<const char*>(buf), sz);
+    return sz;
+  });
+  pickler.protocol();
+  pickler.pushIValue(cloneSparseTensors(tensors));
+  pickler.stop();
+  return pickler.tensorData();
+}
+
+std::string writeWireSections(const std::vector<WireEntry>& entries) {
+  std::string header;
+  size_t tot = 0;
+  for (const auto& e : entries) {
+    tot += e.size;
+    header.append(e.name)
+        .append(" ")
+        .append(c10::to_string(e.size))
+        .append("\n");
+  }
+  header.push_back('\n');
+
+  std::string out;
+  out.reserve(header.size() + tot);
+  out.append(header);
+  for (const auto& e : entries) {
+    out.append(e.data, e.size);
+  }
+  return out;
+}
+
+std::vector<char> readWirePayload(
+    const std::unordered_map<std::string, std::pair<const char*, size_t>>&
+        sections) {
+  std::vector<char> payload;
+  auto payloadIt = sections.find(kPayload);
+  if (payloadIt != sections.end() && payloadIt->second.second != 0) {
+    payload.assign(
+        payloadIt->second.first,
+        payloadIt->second.first + payloadIt->second.second);
+  }
+  return payload;
+}
 
-  struct Ent {
-    std::string name;
-    const char* data;
-    size_t size;
+std::vector<at::Tensor> unpickleWireTensors(
+    const std::pair<const char*, size_t>& metaData,
+    const std::function<at::DataPtr(const std::string&)>& sectionReadFunc) {
+  size_t metaDataPos = 0;
+  auto metaDataReadFunc = [&](char* buf, size_t n) -> size_t {
+    if (metaDataPos >= metaData.second || n == 0) {
+      return 0;
+    }
+    size_t toCopy = std::min(metaDataPos + n, metaData.second) - metaDataPos;
+    memcpy(buf, metaData.first + metaDataPos, toCopy);
+    metaDataPos += toCopy;
+    return toCopy;
   };
-  std::vector<Ent> entries;
+
+  // No need to pass typeResolver here, as it always processes string and
+  // tensors only
+  torch::jit::Unpickler unpickler(
+      metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
+  auto ival = unpickler.parse_ivalue();
+  std::vector<at::Tensor> tensors;
+  for (auto&& t : ival.toTensorList()) {
+    tensors.emplace_back(std::move(t));
+  }
+  return tensors;
+}
+
+} // namespace
+
+std::string wireSerialize(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  checkWireTensors(tensors);
+
+  std::vector<WireEntry> entries;
   std::string metaEntry;
   std::vector<at::Tensor> tensorData;
 
@@ -356,14 +456,7 @@ std::string wireSerialize(
   }
 
   if (!tensors.empty()) {
-    torch::jit::Pickler pickler([&](const void* buf, size_t sz) -> size_t {
-      metaEntry.append(static_cast<const char*>(buf), sz);
-      return sz;
-    });
-    pickler.protocol();
-    pickler.pushIValue(cloneSparseTensors(tensors));
-    pickler.stop();
-    tensorData = pickler.tensorData();
+    tensorData = pickleWireTensors(tensors, metaEntry);
     entries.push_back({kMeta, metaEntry.data(), metaEntry.size()});
     for (size_t i = 0; i < tensorData.size(); i++) {
       // Construct WritableTensorData for each tensor in the pickler tensorData
@@ -380,24 +473,7 @@ std::string wireSerialize(
     }
   }
 
-  std::string header;
-  size_t tot = 0;
-  for (const auto& e : entries) {
-    tot += e.size;
-    header.append(e.name)
-        .append(" ")
-        .append(c10::to_string(e.size))
-        .append("\n");
-  }
-  header.push_back('\n');
-
-  std::string out;
-  out.reserve(header.size() + tot);
-  out.append(header);
-  for (const auto& e : entries) {
-    out.append(e.data, e.size);
-  }
-  return out;
+  return writeWireSections(entries);
 }
 
 std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
@@ -405,28 +481,11 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     size_t data_size) {
   auto sections = parseWireSections(data, data_size);
 
-  std::vector<char> payload;
-  auto payloadIt = sections.find(kPayload);
-  if (payloadIt != sections.end() && payloadIt->second.second != 0) {
-    payload.assign(
-        payloadIt->second.first,
-        payloadIt->second.first + payloadIt->second.second);
-  }
+  std::vector<char> payload = readWirePayload(sections);
 
   std::vector<at::Tensor> tensors;
   auto metaIt = sections.find(kMeta);
   if (metaIt != sections.end()) {
-    const auto& metaData = metaIt->second;
-    size_t metaDataPos = 0;
-    auto metaDataReadFunc = [&](char* buf, size_t n) -> size_t {
-      if (metaDataPos >= metaData.second || n == 0) {
-        return 0;
-      }
-      size_t toCopy = std::min(metaDataPos + n, metaData.second) - metaDataPos;
-      memcpy(buf, metaData.first + metaDataPos, toCopy);
-      metaDataPos += toCopy;
-      return toCopy;
-    };
     auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
       auto it = sections.find(ename);
       if (it == sections.end()) {
@@ -439,15 +498,100 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
       }
       return dptr;
     };
+    tensors = unpickleWireTensors(metaIt->second, sectionReadFunc);
+  }
+  return {std::move(payload), std::move(tensors)};
+}
+
+WireSegments wireSerializeSegments(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  checkWireTensors(tensors);
+
+  WireSegments out;
+  std::vector<WireEntry> entries;
+  std::string metaEntry;
+  std::string segmentSizes;
+
+  if (!payload.empty()) {
+    entries.push_back({kPayload, payload.data(), payload.size()});
+  }
+
+  if (!tensors.empty()) {
+    auto tensorData = pickleWireTensors(tensors, metaEntry);
+    entries.push_back({kMeta, metaEntry.data(), metaEntry.size()});
+    out.segments.reserve(tensorData.size());
+    for (auto& tensor : tensorData) {
+      // The data of CPU tensors is their storage, which the segment keeps
+      // alive until the transport is done with it.
+      auto writeableTensorData = jit::getWriteableTensorData(tensor);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      auto data = const_cast<char*>(writeableTensorData.data());
+      auto size = static_cast<int64_t>(writeableTensorData.sizeInBytes());
+      out.segments.push_back(at::from_blob(
+          data,
+          {size},
+          [tensor](void*) {},
+          at::TensorOptions().dtype(at::kByte)));
+      segmentSizes.append(c10::to_string(size)).append(" ");
+    }
+    entries.push_back({kSegments, segmentSizes.data(), segmentSizes.size()});
+  }
 
-    // No need to pass typeResolver here, as it always processes string and
-    // tensors only
-    torch::jit::Unpickler unpickler(
-        metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
-    auto ival = unpickler.parse_ivalue();
-    for (auto&& t : ival.toTensorList()) {
-      tensors.emplace_back(std::move(t));
+  out.header = writeWireSections(entries);
+  return out;
+}
+
+std::vector<int64_t> wireSegmentSizes(const void* header, size_t header_size) {
+  auto sections = parseWireSections(header, header_size);
+  std::vector<int64_t> sizes;
+  auto segmentsIt = sections.find(kSegments);
+  if (segmentsIt == sections.end()) {
+    return sizes;
+  }
+  const char* ptr = segmentsIt->second.first;
+  const char* endp = ptr + segmentsIt->second.second;
+  while (ptr != endp) {
+    const char* sizePtr = ptr;
+    while (ptr != endp && *ptr != ' ') {
+      ptr++;
+    }
+    if (ptr == endp) {
+      throw std::runtime_error("failed parse");
     }
+    sizes.push_back(c10::stoll(std::string(sizePtr, ptr - sizePtr)));
+    ++ptr; // past the ' '
+  }
+  return sizes;
+}
+
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserializeSegments(
+    const void* header,
+    size_t header_size,
+    std::vector<at::Tensor> segments) {
+  auto sections = parseWireSections(header, header_size);
+
+  std::vector<char> payload = readWirePayload(sections);
+
+  std::vector<at::Tensor> tensors;
+  auto metaIt = sections.find(kMeta);
+  if (metaIt != sections.end()) {
+    auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
+      auto index = std::stoul(ename);
+      if (index >= segments.size()) {
+        throw std::runtime_error("Couldn't find entity " + ename);
+      }
+      // The DataPtr owns a reference to the segment, so that the tensor
+      // uses the received memory as its storage.
+      auto segment = std::make_unique<at::Tensor>(std::move(segments[index]));
+      void* data = segment->data_ptr();
+      return at::DataPtr(
+          data,
+          segment.release(),
+          [](void* ctx) { delete static_cast<at::Tensor*>(ctx); },
+          at::Device(at::kCPU));
+    };
+    tensors = unpickleWireTensors(metaIt->second, sectionReadFunc);
   }
   return {std::move(payload), std::move(tensors)};
 }
@@ -469,10 +613,16 @@ constexpr int kTpMessagePayloadIdx = 2;
 // stored as, well, tensors in the tensorpipe::Message).
 constexpr int kTpMessagePickleIdx = 3;
 
+// The tensors themselves are always sent from host memory. Those that must be
+// moved to a GPU by the receiver carry the target device (as a string) in the
+// metadata of their tensorpipe::Message::Tensor, which is part of the
+// descriptor and thus known before the receiver allocates their buffer.
+
 } // namespace
 
 std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
-    Message&& rpcMessage) {
+    Message&& rpcMessage,
+    std::vector<c10::Device> devices) {
   tensorpipe::Message tpMessage;
   TensorpipeWriteBuffers buffers;
 
@@ -494,7 +644,39 @@ std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
       tensorpipe::Message::Payload{payloadPtr, buffers.payload.size()});
 
   // Tensors
-  buffers.tensors = cloneSparseTensors(rpcMessage.tensors()).vec();
+  std::vector<at::Tensor>& tensors = rpcMessage.tensors();
+  TORCH_INTERNAL_ASSERT(
+      devices.empty() || devices.size() == tensors.size(),
+      "expected one target device per tensor, got ",
+      devices.size(),
+      " devices for ",
+      tensors.size(),
+      " tensors");
+  if (devices.empty()) {
+    for (const auto& tensor : tensors) {
+      devices.push_back(tensor.device());
+    }
+  }
+  // CUDA tensors are staged in pinned memory. This is a single device to host
+  // copy of only the data they reference, instead of the pageable copy of their
+  // whole storage that the pickler would do.
+  for (auto& tensor : tensors) {
+    if (tensor.is_cuda()) {
+      auto staged = at::empty(
+          tensor.sizes(),
+          tensor.options().device(at::kCPU).pinned_memory(true));
+      staged.copy_(tensor);
+      tensor = std::move(staged);
+    }
+  }
+  buffers.tensors = cloneSparseTensors(tensors).vec();
+  std::unordered_map<const c10::StorageImpl*, c10::Device> targetDevices;
+  for (size_t i = 0; i < buffers.tensors.size(); ++i) {
+    if (!devices[i].is_cpu()) {
+      targetDevices.emplace(
+          buffers.tensors[i].storage().unsafeGetStorageImpl(), devices[i]);
+    }
+  }
   torch::jit::Pickler pickler([&](const void* buf, size_t sz) -> size_t {
     buffers.pickle.insert(
         buffers.pickle.end(),
@@ -525,6 +707,10 @@ std::tuple<tensorpipe::Message, TensorpipeWriteBuffers> tensorpipeSerialize(
       tpMessage.tensors.push_back(
           tensorpipe::Message::Tensor{tensorPtr, tensorData.sizeInBytes()});
     }
+    auto it = targetDevices.find(tensor.storage().unsafeGetStorageImpl());
+    if (it != targetDevices.end()) {
+      tpMessage.tensors.back().metadata = it->second.str();
+    }
   }
 
   return std::make_tuple(std::move(tpMessage), std::move(buffers));
@@ -568,7 +754,12 @@ TensorpipeReadBuffers tensorpipeAllocate(tensorpipe::Message& tpMessage) {
   tpMessage.payloads[kTpMessagePickleIdx].data = buffers.pickle.data();
 
   for (auto& tensor : tpMessage.tensors) {
-    buffers.tensors.push_back(at::getCPUAllocator()->allocate(tensor.length));
+    // Tensors that go to a GPU are received in pinned memory, from which they
+    // can be copied to the device quickly.
+    auto* allocator = tensor.metadata.empty()
+        ? at::getCPUAllocator()
+        : at::detail::getCUDAHooks().getPinnedMemoryAllocator();
+    buffers.tensors.push_back(allocator->allocate(tensor.length));
     tensor.data = buffers.tensors.back().get();
   }
 
@@ -597,13 +788,26 @@ Message tensorpipeDeserialize(
     return std::move(buffers.tensors.at(index));
   };
 
+  std::unordered_map<const void*, c10::Device> targetDevices;
+  for (size_t i = 0; i < message.tensors.size(); ++i) {
+    if (!message.tensors[i].metadata.empty()) {
+      targetDevices.emplace(
+          buffers.tensors[i].get(), c10::Device(message.tensors[i].metadata));
+    }
+  }
+
   // No need to pass typeResolver here, as it always processes string and
   // tensors only
   torch::jit::Unpickler unpickler(
       pickleReadFunc, nullptr, nullptr, tensorReadFunc, {});
   auto ival = unpickler.parse_ivalue();
   for (auto&& t : ival.toTensorList()) {
-    tensors.emplace_back(std::move(t));
+    at::Tensor tensor = t;
+    auto it = targetDevices.find(tensor.storage().data());
+    if (it != targetDevices.end()) {
+      tensor = tensor.to(it->second);
+    }
+    tensors.emplace_back(std::move(tensor));
   }
 
   return Message(
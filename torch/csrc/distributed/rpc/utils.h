@@ -52,6 +52,32 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size);
 
+// The same format, split into a header, which holds the payload and the
+// metadata of the tensors, and one segment per tensor storage. The segments
+// are 1-D byte tensors that alias the storages, so that a transport can send
+// them as they are, without copying them into a contiguous buffer.
+struct WireSegments {
+  std::string header;
+  std::vector<at::Tensor> segments;
+};
+
+TORCH_API WireSegments wireSerializeSegments(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors);
+
+// The sizes, in bytes, of the segments that come with the given header, so
+// that the receiver can allocate them before receiving them.
+TORCH_API std::vector<int64_t> wireSegmentSizes(
+    const void* header,
+    size_t header_size);
+
+// The received segments become the storages of the tensors, without a copy.
+TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>>
+wireDeserializeSegments(
+    const void* header,
+    size_t header_size,
+    std::vector<at::Tensor> segments);
+
 // We use vector<char> as the type of blobs because it's what rpc::Message uses
 // for its payload, even though it has the disadvantage that it cannot be
 // allocated with uninitialized memory: it is always zeroed out.
@@ -84,8 +110,12 @@ struct TensorpipeReadBuffers {
 
 // Convert an RPC message into a TensorPipe message, plus a holder to all the
 // data that must be kept alive while the write is performed asynchronously.
+// `devices` holds the device each tensor of the message must be placed on by
+// the receiver; if empty, each tensor keeps the device it is on.
 TORCH_API std::tuple<tensorpipe::Message, TensorpipeWriteBuffers>
-tensorpipeSerialize(Message&& rpcMessage);
+tensorpipeSerialize(
+    Message&& rpcMessage,
+    std::vector<c10::Device> devices = {});
 
 // Allocate the buffers that will hold the incoming data. They will be managed
 // by the returned holder, which must be kept alive until the asynchronous read
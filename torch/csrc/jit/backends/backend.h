@@ -33,7 +33,11 @@ class backend {
             ._def_unboxed(
                 "execute",
                 detail::getExecuteFunc<TBackendInterface>(),
-                detail::getExecuteSchema());
+                detail::getExecuteSchema())
+            ._def_unboxed(
+                "execute_async",
+                detail::getExecuteAsyncFunc<TBackendInterface>(),
+                detail::getExecuteAsyncSchema());
   }
 };
 
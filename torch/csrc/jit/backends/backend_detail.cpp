@@ -47,6 +47,19 @@ c10::FunctionSchema getExecuteSchema() {
       /*arguments=*/{self, handle, input},
       /*returns=*/{output});
 }
+
+c10::FunctionSchema getExecuteAsyncSchema() {
+  auto any_list_ty = c10::ListType::create(c10::AnyType::get());
+  c10::Argument self("self", c10::AnyType::get());
+  c10::Argument handle("handle", c10::AnyType::get());
+  c10::Argument input("input", any_list_ty);
+  c10::Argument output("output", c10::FutureType::create(any_list_ty));
+  return c10::FunctionSchema(
+      "execute_async",
+      /*overload_name=*/"",
+      /*arguments=*/{self, handle, input},
+      /*returns=*/{output});
+}
 } // namespace detail
 } // namespace jit
 } // namespace torch
@@ -11,6 +11,7 @@ constexpr static auto kBackendsNamespace = "__backends__";
 c10::FunctionSchema TORCH_API getPreprocessSchema();
 c10::FunctionSchema TORCH_API getCompileSchema();
 c10::FunctionSchema TORCH_API getExecuteSchema();
+c10::FunctionSchema TORCH_API getExecuteAsyncSchema();
 
 template <typename TBackendInterface>
 std::function<void(Stack&)> getPreprocessFunc() {
@@ -45,6 +46,18 @@ std::function<void(Stack&)> getExecuteFunc() {
     push(stack, res);
   };
 }
+
+template <typename TBackendInterface>
+std::function<void(Stack&)> getExecuteAsyncFunc() {
+  return [](Stack& stack) {
+    auto args = pop(stack);
+    auto handle = pop(stack);
+    auto self = pop(stack);
+    auto backend = self.toCustomClass<TBackendInterface>();
+    auto res = backend->executeAsync(handle, args.toList());
+    push(stack, std::move(res));
+  };
+}
 } // namespace detail
 } // namespace jit
 } // namespace torch
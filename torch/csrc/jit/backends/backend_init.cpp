@@ -124,7 +124,7 @@ void initJitBackendBindings(PyObject* module) {
       static const auto method_ct = CodeTemplate(R"(
             def $method(self${,def_inputs}):
                 typed_inputs: List[Any] = [${fwd_inputs,}]
-                $ret, = self.__backend.execute(self.__handles["$method"], typed_inputs)
+                $ret, = torch.wait(self.__backend.execute_async(self.__handles["$method"], typed_inputs))
                 ${refine,}
                 return $ret
             )");
@@ -6,5 +6,18 @@ namespace jit {
 PyTorchBackendInterface::PyTorchBackendInterface() = default;
 PyTorchBackendInterface::~PyTorchBackendInterface() = default;
 
+c10::intrusive_ptr<c10::ivalue::Future> PyTorchBackendInterface::executeAsync(
+    c10::IValue handle,
+    c10::impl::GenericList inputs) {
+  auto future = c10::make_intrusive<c10::ivalue::Future>(
+      c10::ListType::create(c10::AnyType::get()));
+  try {
+    future->markCompleted(execute(std::move(handle), std::move(inputs)));
+  } catch (const std::exception& e) {
+    future->setError(e.what());
+  }
+  return future;
+}
+
 } // namespace jit
 } // namespace torch
@@ -32,6 +32,17 @@ class TORCH_API PyTorchBackendInterface : public torch::CustomClassHolder {
   virtual c10::impl::GenericList execute(
       c10::IValue handle,
       c10::impl::GenericList inputs) = 0;
+
+  // Start executing the method specified by \p handle using \p inputs.
+  // \returns a future that completes with the outputs of execute. Lowered
+  // modules call this and wait for the future, so a lowered method that is
+  // run with torch.jit._fork lets the interpreter run other work until the
+  // future completes. The default runs execute synchronously and returns a
+  // completed future; backends whose runtime runs asynchronously should
+  // override it to complete the future from the runtime's callback instead.
+  virtual c10::intrusive_ptr<c10::ivalue::Future> executeAsync(
+      c10::IValue handle,
+      c10::impl::GenericList inputs);
 };
 } // namespace jit
 } // namespace torch
@@ -11,9 +11,11 @@
 #include <torch/csrc/jit/codegen/cuda/lower2device.h>
 #include <torch/csrc/jit/codegen/cuda/parser.h>
 
+#include <torch/csrc/jit/codegen/disk_cache.h>
 #include <torch/csrc/jit/resource_guard.h>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 namespace torch {
 namespace jit {
@@ -435,42 +437,73 @@ void compileKernel(CudaKernel* entry) {
   int major, minor;
   major = prop->major;
   minor = prop->minor;
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
-  ResourceGuard holdProgram(
-      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
-
   const std::string compute = "--gpu-architecture=compute_" +
       std::to_string(major) + std::to_string(minor);
   const std::vector<const char*> args = {
       "--std=c++14", compute.c_str(), "-default-device"};
 
-  nvrtc().nvrtcAddNameExpression(program, func_name.c_str());
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
-    std::vector<char> log(logsize);
-    nvrtc().nvrtcGetProgramLog(program, log.data());
+  std::ostringstream cache_key;
+  cache_key << "cuda fuser nvrtc " << nvrtc_major << "." << nvrtc_minor
+            << " flags";
+  for (const char* arg : args) {
+    cache_key << " " << arg;
+  }
+  cache_key << "\n" << func_name << "\n" << code;
 
-    TORCH_INTERNAL_ASSERT(
-        false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+  // PYTORCH_CUDA_FUSER_CUBIN dumps the binaries of every kernel it compiles,
+  // so it bypasses the kernel disk cache.
+  const char* prefix_env = getenv("PYTORCH_CUDA_FUSER_CUBIN");
+  c10::optional<std::string> cached;
+  if (!prefix_env) {
+    cached = loadCachedKernel(cache_key.str());
   }
-  const char* lowered_kernel_name;
-  nvrtc().nvrtcGetLoweredName(program, func_name.c_str(), &lowered_kernel_name);
 
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+  // Cache entries hold the lowered kernel name, a null character and the PTX.
+  std::string lowered_kernel_name;
   std::vector<char> ptx;
-  ptx.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
+  const auto name_end = cached ? cached->find('\0') : std::string::npos;
+  if (name_end != std::string::npos) {
+    lowered_kernel_name = cached->substr(0, name_end);
+    ptx.assign(cached->begin() + name_end + 1, cached->end());
+  } else {
+    nvrtcProgram program;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+        &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+    ResourceGuard holdProgram(
+        [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+
+    nvrtc().nvrtcAddNameExpression(program, func_name.c_str());
+    const auto result =
+        nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+    if (result != NVRTC_SUCCESS) {
+      size_t logsize;
+      nvrtc().nvrtcGetProgramLogSize(program, &logsize);
+      std::vector<char> log(logsize);
+      nvrtc().nvrtcGetProgramLog(program, log.data());
+
+      TORCH_INTERNAL_ASSERT(
+          false, code.c_str(), "\nCUDA NVRTC compile error: ", log.data());
+    }
+    const char* lowered_name;
+    nvrtc().nvrtcGetLoweredName(program, func_name.c_str(), &lowered_name);
+    lowered_kernel_name = lowered_name;
+
+    AT_CUDA_NVRTC_CHECK(result);
+    size_t ptx_size;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+    ptx.resize(ptx_size);
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
+
+    if (!prefix_env) {
+      std::string entry = lowered_kernel_name;
+      entry.push_back('\0');
+      entry.append(ptx.begin(), ptx.end());
+      storeCachedKernel(cache_key.str(), entry);
+    }
+  }
 
   // TODO: We do go through different code path, should investigate whether this
   // has an impact on generated binary.
-  const char* prefix_env = getenv("PYTORCH_CUDA_FUSER_CUBIN");
   if (prefix_env) {
     // Output ptx file
     std::stringstream ptx_file_name;
@@ -488,7 +521,7 @@ void compileKernel(CudaKernel* entry) {
         linkState,
         CU_JIT_INPUT_PTX,
         ptx.data(),
-        ptx_size,
+        ptx.size(),
         "compiling PTX",
         0,
         nullptr,
@@ -515,7 +548,7 @@ void compileKernel(CudaKernel* entry) {
         nvrtc().cuModuleLoadData(&(entry->module_), ptx.data()));
   }
   AT_CUDA_DRIVER_CHECK(nvrtc().cuModuleGetFunction(
-      &(entry->function_), entry->module_, lowered_kernel_name));
+      &(entry->function_), entry->module_, lowered_kernel_name.c_str()));
 #if defined(__HIP_PLATFORM_HCC__) && HIP_VERSION < 305
   // HIP function signature is not compatible yet
   uint32_t max_blocks;
@@ -7,6 +7,7 @@
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
+#include <torch/csrc/utils/hash.h>
 
 #include <unordered_map>
 
@@ -25,6 +26,37 @@ std::unique_ptr<KernelArgsReq> makePWKernelSupport(
   return req_ptr;
 }
 
+// Everything about the inputs of a fusion that output allocation and the
+// launch configuration depend on.
+std::vector<int64_t> inputsSignature(const at::ArrayRef<IValue>& inputs) {
+  std::vector<int64_t> signature;
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      signature.push_back(tensor.dim());
+      signature.insert(
+          signature.end(), tensor.sizes().begin(), tensor.sizes().end());
+      signature.insert(
+          signature.end(), tensor.strides().begin(), tensor.strides().end());
+      signature.push_back(static_cast<int64_t>(tensor.scalar_type()));
+      signature.push_back(tensor.device().index());
+      signature.push_back(tensor.requires_grad());
+    } else {
+      signature.push_back(-1 - static_cast<int64_t>(input.type()->kind()));
+    }
+  }
+  return signature;
+}
+
+// Output allocation for one input signature, as computed by shape inference
+// on the fusion graph.
+struct FusionRunInfo {
+  std::vector<std::vector<int64_t>> output_sizes;
+  std::vector<std::vector<int64_t>> output_strides;
+  std::vector<at::TensorOptions> output_options;
+  std::vector<int64_t> broadcasted_shape;
+};
+
 // CudaFusionManager holds compiled `CudaKernel` and handles all interfacing
 // including compilation and execution.
 //
@@ -74,6 +106,35 @@ class CudaFusionManager {
     return graph_cache_[repr];
   };
 
+  // Shape inference of the fusion graph is cached per kernel_id and input
+  // signature, so repeated calls with known shapes skip copying the graph and
+  // propagating shapes through it. Kernels themselves are only specialized
+  // on input ranks (see `makePWKernelSupport`), so new sizes never recompile.
+  c10::optional<FusionRunInfo> getRunInfo(
+      int32_t kernel_id,
+      const std::vector<int64_t>& signature) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& run_infos = run_info_cache_[kernel_id];
+    auto it = run_infos.find(signature);
+    if (it == run_infos.end()) {
+      return c10::nullopt;
+    }
+    return it->second;
+  }
+
+  void setRunInfo(
+      int32_t kernel_id,
+      const std::vector<int64_t>& signature,
+      FusionRunInfo run_info) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& run_infos = run_info_cache_[kernel_id];
+    // don't grow without bound for fusions seeing ever new shapes
+    if (run_infos.size() >= kMaxRunInfosPerKernel) {
+      run_infos.clear();
+    }
+    run_infos.emplace(signature, std::move(run_info));
+  }
+
   void runFusionNode(
       int32_t kernel_id,
       std::shared_ptr<Graph>& graph,
@@ -137,6 +198,15 @@ class CudaFusionManager {
   std::unordered_map<std::string, int32_t> graph_cache_;
   std::unordered_map<int64_t, CudaKernelCache> kernel_cache_;
 
+  static constexpr size_t kMaxRunInfosPerKernel = 1024;
+  std::unordered_map<
+      int32_t,
+      std::unordered_map<
+          std::vector<int64_t>,
+          FusionRunInfo,
+          torch::hash<std::vector<int64_t>>>>
+      run_info_cache_;
+
   int32_t next_unique_id_ = 0;
 };
 
@@ -165,79 +235,100 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
       fusion_node->hasAttribute(attr::cache_id),
       "node prim::CudaFusionGroup has not been compiled yet");
   int32_t kernel_id = fusion_node->i(attr::cache_id);
-
-  // Currently we just construct I/O tensors for static graph;
-  std::shared_ptr<Graph> graph = fusion_node->g(attr::Subgraph)->copy();
+  auto& manager = CudaFusionManager::getManager();
 
   auto execute_lambda = [&]() {
-    const auto nInputs = graph->inputs().size();
+    const auto nInputs = fusion_node->g(attr::Subgraph)->inputs().size();
     at::ArrayRef<IValue> inputs = last(stack, nInputs);
 
-    // shape inference in graph
-    // update shape information per the new inputs;
-    EraseShapeInformation(graph);
-    for (size_t i = 0; i < nInputs; i++) {
-      graph->inputs()[i]->setType(inputs[i].type());
-    }
-    // shape inference
-    ShapeTypePropagate(graph);
+    const auto signature = inputsSignature(inputs);
+    auto run_info = manager.getRunInfo(kernel_id, signature);
+    const bool new_signature = !run_info.has_value();
 
-    // TODO: temporary WAR that allows us to handle fusion with uniform output
-    // shape and consistent broadcast scheme. The difinition is loose and the
-    // implementation is risky. We'll do this properly when we integrate proper
-    // broadcast support.
-    std::vector<int64_t> broadcasted_shape;
+    // The graph is only needed with shapes for compilation, which can only
+    // happen for inputs we haven't seen yet.
+    std::shared_ptr<Graph> graph;
+    if (new_signature) {
+      // Currently we just construct I/O tensors for static graph;
+      graph = fusion_node->g(attr::Subgraph)->copy();
 
-    // we need to construct outputs;
-    std::vector<at::Tensor> outputs;
-    for (const auto* output : graph->outputs()) {
-      const auto type = output->type()->expect<TensorType>();
-      // Expect output to be tensor;
-      TORCH_CHECK(
-          type && type->isComplete(),
-          "Complete TensorType for output is expected.");
-
-      const auto device = *(type->device());
-      const auto scalar_type = *(type->scalarType());
-
-      auto options = at::TensorOptions()
-                         .dtype(scalar_type)
-                         .layout(at::kStrided)
-                         .device(device)
-                         .requires_grad(type->requires_grad());
-
-      // TODO: We should infer output shape from `inputs`
-      const auto sizes = extractSizes(type);
-      const auto strides = extractStrides(type);
-
-      const auto tensor = at::empty_strided(sizes, strides, options);
-      outputs.push_back(tensor);
-
-      // TODO: unsafe broadcast assumption. We assume all output from fusion has
-      //       identical size when broadcasting.
-      if (broadcasted_shape.empty()) {
-        if (!hasReductionNode(graph->block())) {
-          broadcasted_shape = sizes;
-        } else if (isReductionNode(output->node())) {
-          auto i_type =
-              output->node()->inputs()[0]->type()->expect<TensorType>();
-          TORCH_CHECK(
-              i_type && i_type->sizes().isComplete(),
-              "Complete TensorType for output is expected.");
-          broadcasted_shape = extractSizes(i_type);
-        } else {
-          // TODO: this assert is not fool proof. We could have ignored
-          // pre-reduction tensor marked as output after we first encountered
-          // reduction output tensor.
-          TORCH_INTERNAL_ASSERT(
-              false,
-              "pre-reduction tensor output for reduction fusion is nor properly supported yet.");
+      // shape inference in graph
+      // update shape information per the new inputs;
+      EraseShapeInformation(graph);
+      for (size_t i = 0; i < nInputs; i++) {
+        graph->inputs()[i]->setType(inputs[i].type());
+      }
+      // shape inference
+      ShapeTypePropagate(graph);
+
+      run_info = FusionRunInfo();
+      for (const auto* output : graph->outputs()) {
+        const auto type = output->type()->expect<TensorType>();
+        // Expect output to be tensor;
+        TORCH_CHECK(
+            type && type->isComplete(),
+            "Complete TensorType for output is expected.");
+
+        const auto device = *(type->device());
+        const auto scalar_type = *(type->scalarType());
+
+        run_info->output_options.push_back(
+            at::TensorOptions()
+                .dtype(scalar_type)
+                .layout(at::kStrided)
+                .device(device)
+                .requires_grad(type->requires_grad()));
+
+        // TODO: We should infer output shape from `inputs`
+        const auto sizes = extractSizes(type);
+        run_info->output_sizes.push_back(sizes);
+        run_info->output_strides.push_back(extractStrides(type));
+
+        // TODO: temporary WAR that allows us to handle fusion with uniform
+        // output shape and consistent broadcast scheme. The difinition is
+        // loose and the implementation is risky. We'll do this properly when
+        // we integrate proper broadcast support.
+        // TODO: unsafe broadcast assumption. We assume all output from fusion
+        //       has identical size when broadcasting.
+        if (run_info->broadcasted_shape.empty()) {
+          if (!hasReductionNode(graph->block())) {
+            run_info->broadcasted_shape = sizes;
+          } else if (isReductionNode(output->node())) {
+            auto i_type =
+                output->node()->inputs()[0]->type()->expect<TensorType>();
+            TORCH_CHECK(
+                i_type && i_type->sizes().isComplete(),
+                "Complete TensorType for output is expected.");
+            run_info->broadcasted_shape = extractSizes(i_type);
+          } else {
+            // TODO: this assert is not fool proof. We could have ignored
+            // pre-reduction tensor marked as output after we first encountered
+            // reduction output tensor.
+            TORCH_INTERNAL_ASSERT(
+                false,
+                "pre-reduction tensor output for reduction fusion is nor properly supported yet.");
+          }
         }
       }
+    } else {
+      graph = fusion_node->g(attr::Subgraph);
+    }
+
+    // we need to construct outputs;
+    std::vector<at::Tensor> outputs;
+    for (size_t i = 0; i < run_info->output_sizes.size(); i++) {
+      outputs.push_back(at::empty_strided(
+          run_info->output_sizes[i],
+          run_info->output_strides[i],
+          run_info->output_options[i]));
     }
 
-    CudaFusionManager::getManager().runFusionNode(
-        kernel_id, graph, inputs, outputs, broadcasted_shape);
+    manager.runFusionNode(
+        kernel_id, graph, inputs, outputs, run_info->broadcasted_shape);
+    if (new_signature) {
+      // only remember signatures that ran successfully
+      manager.setRunInfo(kernel_id, signature, std::move(*run_info));
+    }
     drop(stack, inputs.size());
     stack.insert(
         stack.end(),
@@ -258,6 +349,7 @@ void runCudaFusionGroup(const Node* fusion_node, Stack& stack) {
           "Failed for some reason. To debug try disable codegen fallback path"
           "via setting the env variable"
           "`export PYTORCH_CUDA_FUSER_DISABLE_FALLBACK=1`");
+      std::shared_ptr<Graph> graph = fusion_node->g(attr::Subgraph)->copy();
       EraseShapeInformation(graph);
       InterpreterState{Code(graph, "fallback_cuda_fuser")}.run(stack);
     }
@@ -0,0 +1,285 @@
+#include <torch/csrc/jit/codegen/disk_cache.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/StringUtil.h>
+#include <caffe2/core/macros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Bump when the layout of entries changes.
+constexpr char kEntryMagic[] = "PTKC1";
+constexpr size_t kEntryMagicSize = sizeof(kEntryMagic) - 1;
+constexpr char kEntrySuffix[] = ".kernel";
+
+constexpr int64_t kDefaultMaxBytes = int64_t(1) << 30;
+
+std::string defaultDirectory() {
+#ifdef _WIN32
+  return "";
+#else
+  if (const char* path = std::getenv("PYTORCH_KERNEL_CACHE_PATH")) {
+    return path;
+  }
+  const char* xdg_cache = std::getenv("XDG_CACHE_HOME");
+  if (xdg_cache && *xdg_cache) {
+    return std::string(xdg_cache) + "/torch/kernels";
+  }
+  const char* home = std::getenv("HOME");
+  if (home && *home) {
+    return std::string(home) + "/.cache/torch/kernels";
+  }
+  return "";
+#endif
+}
+
+int64_t defaultMaxBytes() {
+  const char* env = std::getenv("PYTORCH_KERNEL_CACHE_MAX_BYTES");
+  if (!env) {
+    return kDefaultMaxBytes;
+  }
+  char* end = nullptr;
+  const auto max_bytes = std::strtoll(env, &end, 10);
+  if (end == env || *end != '\0' || max_bytes < 0) {
+    TORCH_WARN(
+        "Ignoring invalid PYTORCH_KERNEL_CACHE_MAX_BYTES=", env, ".");
+    return kDefaultMaxBytes;
+  }
+  return max_bytes;
+}
+
+struct CacheConfig {
+  std::mutex mutex;
+  std::string directory = defaultDirectory();
+  int64_t max_bytes = defaultMaxBytes();
+};
+
+CacheConfig& config() {
+  static CacheConfig config_;
+  return config_;
+}
+
+std::string fullKey(const std::string& key) {
+  return c10::str("torch ", CAFFE2_VERSION, "\n", key);
+}
+
+// FNV-1a; std::hash is not guaranteed to agree between builds.
+uint64_t hashKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string entryPath(const std::string& directory, const std::string& key) {
+  char name[17];
+  snprintf(
+      name,
+      sizeof(name),
+      "%016llx",
+      static_cast<unsigned long long>(hashKey(key)));
+  return directory + "/" + name + kEntrySuffix;
+}
+
+#ifndef _WIN32
+bool makeDirectories(const std::string& directory) {
+  for (size_t pos = directory.find('/', 1);; pos = directory.find('/', pos + 1)) {
+    const auto prefix = directory.substr(0, pos);
+    if (mkdir(prefix.c_str(), 0700) != 0 && errno != EEXIST) {
+      return false;
+    }
+    if (pos == std::string::npos) {
+      return true;
+    }
+  }
+}
+
+bool isEntry(const char* name) {
+  const size_t length = strlen(name);
+  const size_t suffix_length = sizeof(kEntrySuffix) - 1;
+  return length > suffix_length &&
+      strcmp(name + length - suffix_length, kEntrySuffix) == 0;
+}
+
+// Deletes the least recently used entries until the cache holds at most
+// max_bytes. Lookups touch the modification time of the entry they hit.
+void evict(const std::string& directory, int64_t max_bytes) {
+  struct Entry {
+    std::string path;
+    int64_t size;
+    time_t last_used;
+  };
+  DIR* dir = opendir(directory.c_str());
+  if (!dir) {
+    return;
+  }
+  std::vector<Entry> entries;
+  int64_t total_bytes = 0;
+  while (struct dirent* dirent = readdir(dir)) {
+    if (!isEntry(dirent->d_name)) {
+      continue;
+    }
+    auto path = directory + "/" + dirent->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+      continue;
+    }
+    total_bytes += st.st_size;
+    entries.push_back({std::move(path), st.st_size, st.st_mtime});
+  }
+  closedir(dir);
+
+  if (total_bytes <= max_bytes) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.last_used < b.last_used;
+  });
+  for (const auto& entry : entries) {
+    if (total_bytes <= max_bytes) {
+      break;
+    }
+    // Another process may have deleted the entry already.
+    unlink(entry.path.c_str());
+    total_bytes -= entry.size;
+  }
+}
+#endif
+
+} // namespace
+
+std::string getKernelDiskCacheDirectory() {
+  auto& c = config();
+  std::lock_guard<std::mutex> guard(c.mutex);
+  return c.directory;
+}
+
+void setKernelDiskCacheDirectory(std::string directory) {
+  auto& c = config();
+  std::lock_guard<std::mutex> guard(c.mutex);
+  c.directory = std::move(directory);
+}
+
+int64_t getKernelDiskCacheMaxBytes() {
+  auto& c = config();
+  std::lock_guard<std::mutex> guard(c.mutex);
+  return c.max_bytes;
+}
+
+void setKernelDiskCacheMaxBytes(int64_t max_bytes) {
+  TORCH_CHECK(
+      max_bytes >= 0,
+      "Kernel disk cache size must not be negative, but got ",
+      max_bytes);
+  auto& c = config();
+  std::lock_guard<std::mutex> guard(c.mutex);
+  c.max_bytes = max_bytes;
+}
+
+c10::optional<std::string> loadCachedKernel(const std::string& key) {
+#ifdef _WIN32
+  return c10::nullopt;
+#else
+  const auto directory = getKernelDiskCacheDirectory();
+  if (directory.empty()) {
+    return c10::nullopt;
+  }
+  const auto full_key = fullKey(key);
+  const auto path = entryPath(directory, full_key);
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return c10::nullopt;
+  }
+  std::string contents(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (!in.good() && !in.eof()) {
+    return c10::nullopt;
+  }
+
+  uint64_t key_size = 0;
+  const size_t header_size = kEntryMagicSize + sizeof(key_size);
+  if (contents.size() < header_size ||
+      contents.compare(0, kEntryMagicSize, kEntryMagic) != 0) {
+    return c10::nullopt;
+  }
+  memcpy(&key_size, contents.data() + kEntryMagicSize, sizeof(key_size));
+  if (key_size != full_key.size() ||
+      contents.size() < header_size + key_size ||
+      contents.compare(header_size, key_size, full_key) != 0) {
+    return c10::nullopt;
+  }
+
+  // Marks the entry as recently used.
+  utime(path.c_str(), nullptr);
+  return contents.substr(header_size + key_size);
+#endif
+}
+
+void storeCachedKernel(const std::string& key, const std::string& binary) {
+#ifndef _WIN32
+  const auto directory = getKernelDiskCacheDirectory();
+  if (directory.empty()) {
+    return;
+  }
+  if (!makeDirectories(directory)) {
+    TORCH_WARN_ONCE(
+        "Could not create the kernel disk cache directory ",
+        directory,
+        ": ",
+        strerror(errno));
+    return;
+  }
+
+  const auto full_key = fullKey(key);
+  const auto path = entryPath(directory, full_key);
+  // Unique per process and call, so concurrent writers never share a file.
+  static std::atomic<uint64_t> tmp_counter{0};
+  const auto tmp_path =
+      c10::str(path, ".tmp.", getpid(), ".", tmp_counter++);
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    const uint64_t key_size = full_key.size();
+    out.write(kEntryMagic, kEntryMagicSize);
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    out.write(full_key.data(), full_key.size());
+    out.write(binary.data(), binary.size());
+    out.close();
+    if (!out) {
+      unlink(tmp_path.c_str());
+      return;
+    }
+  }
+  // Readers see either the old entry or the complete new one.
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    unlink(tmp_path.c_str());
+    return;
+  }
+  evict(directory, getKernelDiskCacheMaxBytes());
+#endif
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <string>
+
+namespace torch {
+namespace jit {
+
+// An on-disk cache of compiled kernels, shared by the fusers that compile code
+// at runtime (NVRTC for the legacy CUDA fuser, the CUDA fuser and the
+// TensorExpr CUDA backend; LLVM for the TensorExpr CPU backend), so that a
+// new process does not have to recompile kernels an earlier one already
+// built.
+//
+// Entries are looked up by an arbitrary key string that must describe
+// everything the binary depends on: the kernel source or IR, the compiler and
+// its version, the device architecture and the compile flags. The cache adds
+// the library version to every key. Each entry is one file named after a hash
+// of the key; the file also holds the full key, so a hash collision is a miss
+// rather than a wrong kernel.
+//
+// The cache lives in $PYTORCH_KERNEL_CACHE_PATH, or in
+// $XDG_CACHE_HOME/torch/kernels (~/.cache/torch/kernels if XDG_CACHE_HOME is
+// unset). Setting PYTORCH_KERNEL_CACHE_PATH to an empty string disables it.
+// Entries are written to a temporary file and renamed into place, so
+// processes may share a cache. Once the cache holds more than
+// $PYTORCH_KERNEL_CACHE_MAX_BYTES (1 GiB by default), the least recently used
+// entries are deleted.
+//
+// The cache is best effort: I/O errors make lookups miss and stores do
+// nothing. It is not available on Windows.
+
+// Returns the cache directory, or an empty string if the cache is disabled.
+TORCH_API std::string getKernelDiskCacheDirectory();
+// An empty directory disables the cache.
+TORCH_API void setKernelDiskCacheDirectory(std::string directory);
+
+TORCH_API int64_t getKernelDiskCacheMaxBytes();
+TORCH_API void setKernelDiskCacheMaxBytes(int64_t max_bytes);
+
+// Returns the binary stored under key, if any.
+TORCH_API c10::optional<std::string> loadCachedKernel(const std::string& key);
+
+// Stores binary under key, evicting old entries if the cache grows too large.
+TORCH_API void storeCachedKernel(
+    const std::string& key,
+    const std::string& binary);
+
+} // namespace jit
+} // namespace torch
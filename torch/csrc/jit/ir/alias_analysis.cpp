@@ -185,10 +185,7 @@ AliasDb::AliasDb(std::shared_ptr<Graph> graph, bool isFrozen)
     const std::vector<const Value*>& writtenValues = write.second;
     for (const Value* writtenValue : writtenValues) {
       auto elem = elementMap_.at(writtenValue);
-      MemoryLocations writtenMemoryLocations;
-      memoryDAG_->collectAllContainedMemoryLocations(
-          elem, writtenMemoryLocations);
-      writeIndex[node] |= writtenMemoryLocations;
+      writeIndex[node] |= memoryDAG_->getAllContainedMemoryLocations(elem);
     }
   }
 
@@ -491,6 +488,7 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::HorizontalBatch:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/mobile/function.h>
 #include <torch/csrc/jit/mobile/interpreter.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/csrc/jit/runtime/vararg_functions.h>
@@ -11,9 +12,53 @@ namespace jit {
 
 char const* toString(OpCode op);
 namespace mobile {
+namespace {
+std::function<void(Stack&)> findOperator(const c10::OperatorName& opname) {
+  auto jit_op = findOperatorFor(opname);
+  if (jit_op) {
+    return [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
+  }
+  auto op = c10::Dispatcher::singleton().findSchema(opname);
+  if (op.has_value()) {
+    return [op](Stack& stack) { op->callBoxed(&stack); };
+  }
+  return nullptr;
+}
+} // namespace
+
+const std::function<void(Stack&)>* OperatorCache::find(
+    const c10::OperatorName& opname) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = ops_.find(opname);
+  if (it == ops_.end()) {
+    it = ops_.emplace(opname, findOperator(opname)).first;
+  }
+  return it->second ? &it->second : nullptr;
+}
+
 Function::Function(c10::QualifiedName name)
     : name_(name), code_(std::make_shared<Code>()) {}
 
+void Function::set_lazy_initializer(
+    std::function<void(Function&)> initializer) {
+  initializer_ = std::move(initializer);
+  initialized_.store(false, std::memory_order_release);
+}
+
+void Function::initialize() const {
+  std::lock_guard<std::mutex> guard(initialize_mutex_);
+  if (initialized_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  // Build into a separate function so that a failure (e.g. a missing
+  // operator) leaves this one untouched and is reported again on retry.
+  Function staged(name_);
+  initializer_(staged);
+  code_ = std::move(staged.code_);
+  initializer_ = nullptr;
+  initialized_.store(true, std::memory_order_release);
+}
+
 void Function::append_instruction(OpCode op, int X, int N) {
   TORCH_CHECK(
       op != CREATE_OBJECT,
@@ -29,27 +74,25 @@ void Function::append_instruction(OpCode op, int X, int N) {
 
 bool Function::append_operator(
     const std::string& name,
-    const std::string& overload_name) {
+    const std::string& overload_name,
+    OperatorCache* cache) {
   // Keep the original opname in code_
   code_->op_names_.emplace_back(name, overload_name);
-  auto opname = code_->op_names_.back();
+  const auto& opname = code_->op_names_.back();
 
-  auto opname_c10 = opname;
   std::function<void(Stack&)> fn;
-
-  auto jit_op = findOperatorFor(opname);
-  if (jit_op) {
-    fn = [jit_op](Stack& stack) { jit_op->getOperation()(&stack); };
-  } else {
-    auto op = c10::Dispatcher::singleton().findSchema(opname_c10);
-    if (op.has_value()) {
-      fn = [op](Stack& stack) { op->callBoxed(&stack); };
-    } else {
-      return false;
+  if (cache) {
+    if (const auto* cached = cache->find(opname)) {
+      fn = *cached;
     }
+  } else {
+    fn = findOperator(opname);
+  }
+  if (!fn) {
+    return false;
   }
 
-  code_->operators_.emplace_back(fn);
+  code_->operators_.emplace_back(std::move(fn));
   return true;
 }
 
@@ -65,7 +108,52 @@ void Function::set_register_size(size_t size) {
   code_->register_size_ = size;
 }
 
+void Function::specialize_register_calls() {
+  specializeRegisterCalls(*code_);
+}
+
+void Function::collect_op_latencies(
+    std::vector<MobileOpLatency>& latencies,
+    double ticks_per_us) const {
+  const OpLatencyCounter* counters = code_->op_latencies_.get();
+  if (!counters) {
+    return;
+  }
+  for (size_t pc = 0; pc < code_->instructions_.size(); ++pc) {
+    const Instruction& inst = code_->instructions_[pc];
+    const uint64_t count = counters[pc].count.load(std::memory_order_relaxed);
+    if ((inst.op != OP && inst.op != OPN) || count == 0) {
+      continue;
+    }
+    const auto& opname = code_->op_names_[inst.X];
+    MobileOpLatency latency;
+    latency.method_name = name();
+    latency.pc = pc;
+    latency.op_name = opname.overload_name.empty()
+        ? opname.name
+        : opname.name + "." + opname.overload_name;
+    latency.count = count;
+    latency.ticks = counters[pc].ticks.load(std::memory_order_relaxed);
+    latency.total_us = ticks_per_us > 0 ? latency.ticks / ticks_per_us : 0;
+    latencies.push_back(std::move(latency));
+  }
+}
+
+void Function::reset_op_latencies() {
+  OpLatencyCounter* counters = code_->op_latencies_.get();
+  if (!counters) {
+    return;
+  }
+  for (size_t pc = 0; pc < code_->instructions_.size(); ++pc) {
+    counters[pc].count.store(0, std::memory_order_relaxed);
+    counters[pc].ticks.store(0, std::memory_order_relaxed);
+  }
+}
+
 bool Function::run(Stack& stack) const {
+  if (!initialized()) {
+    initialize();
+  }
   InterpreterState interp_state(code_);
   return interp_state.run(stack);
 }
@@ -1,9 +1,15 @@
 #pragma once
 #include <ATen/core/ivalue.h>
-//#include <aten/src/Aten/core/operator_name.h>
+#include <ATen/core/operator_name.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace torch {
+struct MobileOpLatency;
 namespace jit {
 using Stack = std::vector<c10::IValue>;
 enum OpCode : uint8_t;
@@ -11,24 +17,64 @@ enum OpCode : uint8_t;
 namespace mobile {
 struct Code;
 
+// Operators resolved for a model, shared by all of its methods so that an
+// operator used by several methods is only looked up once.
+class OperatorCache {
+ public:
+  // Returns the boxed operator, or nullptr if it is not registered.
+  const std::function<void(Stack&)>* find(const c10::OperatorName& opname);
+
+ private:
+  std::mutex mutex_;
+  // Empty functions mark operators that were looked up and not found
+  std::unordered_map<c10::OperatorName, std::function<void(Stack&)>> ops_;
+};
+
 class Function {
  public:
   Function(c10::QualifiedName name);
   bool run(Stack& stack) const;
+
+  // Defers building the function to its first run, when initializer is called
+  // once to append its instructions, operators, constants and types. Models
+  // carry many methods that are never called; this way loading only pays for
+  // the ones that are.
+  void set_lazy_initializer(std::function<void(Function&)> initializer);
+  bool initialized() const {
+    return initialized_.load(std::memory_order_acquire);
+  }
+
   const std::string& name() const;
   const c10::QualifiedName& qualname() const;
   void append_instruction(OpCode op, int X, int N);
   bool append_operator(
       const std::string& name,
-      const std::string& overload_name);
+      const std::string& overload_name,
+      OperatorCache* cache = nullptr);
   void append_constant(const c10::IValue& constant);
   void append_type(const c10::TypePtr& type);
 
   void set_register_size(size_t size);
+  // Specializes the calls of frequent operators (see register_calls.h); must
+  // be called once all instructions and operators are appended.
+  void specialize_register_calls();
+
+  // Appends the latency of every operator call site of this function that
+  // ran while op latency profiling was enabled (see MobileObserverConfig).
+  void collect_op_latencies(
+      std::vector<MobileOpLatency>& latencies,
+      double ticks_per_us) const;
+  void reset_op_latencies();
 
  private:
+  void initialize() const;
+
   c10::QualifiedName name_;
-  std::shared_ptr<Code> code_;
+  // Replaced once by a lazily initialized function on its first run
+  mutable std::shared_ptr<Code> code_;
+  mutable std::function<void(Function&)> initializer_;
+  mutable std::mutex initialize_mutex_;
+  mutable std::atomic<bool> initialized_{true};
 };
 
 } // namespace mobile
@@ -1,6 +1,8 @@
 #include <torch/csrc/jit/mobile/import.h>
 #include <ATen/core/ivalue.h>
+#include <caffe2/serialize/buffer_adapter.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 #include <torch/csrc/jit/api/compilation_unit.h>
 #include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/mobile/type_parser.h>
@@ -40,7 +42,9 @@ TypePtr parseType(const std::string& pythonStr);
 
 namespace torch {
 namespace jit {
+using caffe2::serialize::BufferAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -81,6 +85,69 @@ void print_unsupported_ops_and_throw(
   TORCH_CHECK(false, "Following ops cannot be found:", error_message);
 }
 
+void parseMethod(
+    const IValue& table,
+    const std::string& function_name,
+    mobile::OperatorCache& operator_cache,
+    mobile::Function& function) {
+  const auto& ins_list =
+      expect_field(table, "instructions", BYTECODE_INDEX_INSTRUCTION)
+          .toTuple()
+          ->elements();
+  const auto& ops_list =
+      expect_field(table, "operators", BYTECODE_INDEX_OPERATOR)
+          .toTuple()
+          ->elements();
+  const auto& consts_list =
+      expect_field(table, "constants", BYTECODE_INDEX_CONSTANT)
+          .toTuple()
+          ->elements();
+  const auto& types_list =
+      expect_field(table, "types", BYTECODE_INDEX_TYPE).toTuple()->elements();
+  const auto& register_size = expect_field(table, "register_size", 4).toInt();
+
+  for (const auto& ins : ins_list) {
+    auto ins_item = ins.toTuple()->elements();
+    TORCH_CHECK(
+        ins_item.size() == 3,
+        "There should be three parts in an instruction. The function name is ",
+        function_name);
+    OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
+    int X = ins_item[1].toInt();
+    int N = ins_item[2].toInt();
+    function.append_instruction(op_code, X, N);
+  }
+
+  std::unordered_set<std::string> unsupported_op_names;
+  for (const auto& op : ops_list) {
+    auto op_item = op.toTuple()->elements();
+    TORCH_CHECK(
+        op_item.size() == 2, "There should be two parts in an operator name.");
+    auto op_found = function.append_operator(
+        op_item[0].toString()->string(),
+        op_item[1].toString()->string(),
+        &operator_cache);
+    if (!op_found) {
+      unsupported_op_names.emplace(operator_str(
+          op_item[0].toString()->string(), op_item[1].toString()->string()));
+    }
+  }
+  if (!unsupported_op_names.empty()) {
+    print_unsupported_ops_and_throw(unsupported_op_names);
+  };
+
+  for (const auto& constant : consts_list) {
+    function.append_constant(constant);
+  }
+
+  for (const auto& t : types_list) {
+    function.append_type(c10::parseType(t.toStringRef()));
+  }
+
+  function.set_register_size(register_size);
+  function.specialize_register_calls();
+}
+
 void parseMethods(
     const std::vector<IValue>& vals,
     mobile::CompilationUnit& mcu) {
@@ -102,6 +169,9 @@ void parseMethods(
       " but the model version is ",
       model_version);
 
+  // Methods are only built on their first run; until then they keep their
+  // bytecode table. The operator lookups are shared between all of them.
+  auto operator_cache = std::make_shared<mobile::OperatorCache>();
   for (size_t i = method_i_start; i < vals.size(); ++i) {
     const auto& element = vals[i];
     const auto& m_tuple = element.toTuple()->elements();
@@ -110,62 +180,10 @@ void parseMethods(
 
     auto function = std::unique_ptr<mobile::Function>(
         new mobile::Function(c10::QualifiedName(function_name)));
-
-    const auto& ins_list =
-        expect_field(table, "instructions", BYTECODE_INDEX_INSTRUCTION)
-            .toTuple()
-            ->elements();
-    const auto& ops_list =
-        expect_field(table, "operators", BYTECODE_INDEX_OPERATOR)
-            .toTuple()
-            ->elements();
-    const auto& consts_list =
-        expect_field(table, "constants", BYTECODE_INDEX_CONSTANT)
-            .toTuple()
-            ->elements();
-    const auto& types_list =
-        expect_field(table, "types", BYTECODE_INDEX_TYPE).toTuple()->elements();
-    const auto& register_size = expect_field(table, "register_size", 4).toInt();
-
-    for (const auto& ins : ins_list) {
-      auto ins_item = ins.toTuple()->elements();
-      TORCH_CHECK(
-          ins_item.size() == 3,
-          "There should be three parts in an instruction. The function name is ",
-          function_name);
-      OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
-      int X = ins_item[1].toInt();
-      int N = ins_item[2].toInt();
-      function->append_instruction(op_code, X, N);
-    }
-
-    std::unordered_set<std::string> unsupported_op_names;
-    for (const auto& op : ops_list) {
-      auto op_item = op.toTuple()->elements();
-      TORCH_CHECK(
-          op_item.size() == 2,
-          "There should be two parts in an operator name.");
-      auto op_found = function->append_operator(
-          op_item[0].toString()->string(), op_item[1].toString()->string());
-      if (!op_found) {
-        unsupported_op_names.emplace(operator_str(
-            op_item[0].toString()->string(), op_item[1].toString()->string()));
-      }
-    }
-    if (!unsupported_op_names.empty()) {
-      print_unsupported_ops_and_throw(unsupported_op_names);
-    };
-
-    for (const auto& constant : consts_list) {
-      function->append_constant(constant);
-    }
-
-    for (const auto& t : types_list) {
-      function->append_type(c10::parseType(t.toStringRef()));
-    }
-
-    function->set_register_size(register_size);
-
+    function->set_lazy_initializer(
+        [table, function_name, operator_cache](mobile::Function& fn) {
+          parseMethod(table, function_name, *operator_cache, fn);
+        });
     mcu.register_function(std::move(function));
   }
 }
@@ -315,6 +333,21 @@ mobile::Module _load_for_mobile(
   return module;
 }
 
+mobile::Module _load_for_mobile_mmapped(
+    const std::string& filename,
+    c10::optional<at::Device> device) {
+  return _load_for_mobile(std::make_unique<MmapFileAdapter>(filename), device);
+}
+
+mobile::Module _load_for_mobile_from_buffer(
+    const void* data,
+    size_t size,
+    c10::optional<at::Device> device,
+    std::shared_ptr<const void> owner) {
+  return _load_for_mobile(
+      std::make_unique<BufferAdapter>(data, size, std::move(owner)), device);
+}
+
 mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device) {
@@ -23,5 +23,23 @@ TORCH_API mobile::Module _load_for_mobile(
 TORCH_API mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt);
+
+// Loads a module without copying the tensor data out of the model file: the
+// file is mapped (see caffe2::serialize::MmapFileAdapter) and the constants
+// and parameters of the module are views into the mapping. This keeps the
+// peak memory of loading close to the size of the bytecode, and the weights
+// are paged in from the file as they are used.
+TORCH_API mobile::Module _load_for_mobile_mmapped(
+    const std::string& filename,
+    c10::optional<at::Device> device = c10::nullopt);
+
+// Same for a model the caller already holds in memory (see
+// caffe2::serialize::BufferAdapter). The tensors of the module are views into
+// data, which must outlive the module unless owner shares its ownership.
+TORCH_API mobile::Module _load_for_mobile_from_buffer(
+    const void* data,
+    size_t size,
+    c10::optional<at::Device> device = c10::nullopt,
+    std::shared_ptr<const void> owner = nullptr);
 } // namespace jit
 } // namespace torch
@@ -20,9 +20,38 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code)
 
 using namespace at;
 
+namespace {
+inline void recordOpLatency(OpLatencyCounter& counter, uint64_t start) {
+  const uint64_t ticks = torch::readMobileCycleCounter() - start;
+  counter.count.fetch_add(1, std::memory_order_relaxed);
+  counter.ticks.fetch_add(ticks, std::memory_order_relaxed);
+}
+} // namespace
+
+OpLatencyCounter* InterpreterState::opLatencies() {
+  std::call_once(code_->op_latencies_once_, [this] {
+    code_->op_latencies_.reset(
+        new OpLatencyCounter[code_->instructions_.size()]);
+  });
+  return code_->op_latencies_.get();
+}
+
 bool InterpreterState::run(Stack& stack) {
   size_t pc = 0;
+  const bool specialized = !code_->register_call_at_.empty();
+  // Null unless op latency profiling is on; checked once per run so the
+  // disabled case costs a predictable branch per operator.
+  OpLatencyCounter* const latencies =
+      torch::observerConfig().isOpLatencyProfilingEnabled() ? opLatencies()
+                                                            : nullptr;
   while (true) {
+    if (specialized && code_->register_call_at_[pc] >= 0) {
+      const RegisterCall& call =
+          code_->register_calls_[code_->register_call_at_[pc]];
+      runRegisterCall(call, latencies);
+      pc += call.length;
+      continue;
+    }
     Instruction inst = code_->instructions_[pc];
 
     //    std::cout << "RUNNING " << pc << " " << code_->instructions_[pc];
@@ -56,12 +85,20 @@ bool InterpreterState::run(Stack& stack) {
         if (!prev_value) {
           enableRecordFunction(false);
         }
+        const uint64_t start = latencies ? torch::readMobileCycleCounter() : 0;
         code_->operators_[inst.X](stack);
+        if (latencies) {
+          recordOpLatency(latencies[pc], start);
+        }
         ++pc;
       } break;
       case OPN: {
         stack.push_back(inst.N);
+        const uint64_t start = latencies ? torch::readMobileCycleCounter() : 0;
         code_->operators_[inst.X](stack);
+        if (latencies) {
+          recordOpLatency(latencies[pc], start);
+        }
         ++pc;
       } break;
       case INTERFACE_CALL: {
@@ -195,10 +232,66 @@ bool InterpreterState::run(Stack& stack) {
   return false;
 }
 
+namespace {
+std::vector<IValue> copyArgs(const IValue* const* args, size_t n) {
+  std::vector<IValue> copies;
+  copies.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    copies.push_back(*args[i]);
+  }
+  return copies;
+}
+} // namespace
+
 IValue& InterpreterState::reg(size_t reg) {
   return *(registers_.end() - reg);
 }
 
+void InterpreterState::runRegisterCall(
+    const RegisterCall& call,
+    OpLatencyCounter* latencies) {
+  const IValue* args[kMaxRegisterCallArgs];
+  for (size_t i = 0; i < call.args.size(); ++i) {
+    const auto& arg = call.args[i];
+    args[i] = arg.source == RegisterCall::Source::CONSTANT
+        ? &code_->constants_[arg.index]
+        : &reg(arg.index);
+  }
+
+  // Same bookkeeping as for OP.
+  if (at::hasGlobalCallbacks()) {
+    if (auto debug_info = c10::ThreadLocalDebugInfo::get(
+            c10::DebugInfoKind::MOBILE_RUNTIME_INFO)) {
+      if (auto* mobile_debug_info =
+              dynamic_cast<MobileDebugInfo*>(debug_info.get())) {
+        mobile_debug_info->setOpIdx(call.op_pc);
+      }
+    }
+  }
+  bool prev_value = isRecordFunctionEnabled();
+  if (!prev_value) {
+    enableRecordFunction(true);
+  }
+  // the inputs are only copied when a callback asks for them
+  RECORD_FUNCTION(
+      code_->op_names_[call.op].name, copyArgs(args, call.args.size()));
+  if (!prev_value) {
+    enableRecordFunction(false);
+  }
+
+  const uint64_t start = latencies ? torch::readMobileCycleCounter() : 0;
+  IValue result = call.fn(args);
+  if (latencies) {
+    recordOpLatency(latencies[call.op_pc], start);
+  }
+  for (const auto& arg : call.args) {
+    if (arg.source == RegisterCall::Source::MOVE) {
+      reg(arg.index) = IValue();
+    }
+  }
+  reg(call.output) = std::move(result);
+}
+
 } // namespace mobile
 } // namespace jit
 } // namespace torch
@@ -2,12 +2,22 @@
 #include <ATen/core/dispatch/Dispatcher.h>
 #include <ATen/core/ivalue.h>
 #include <ATen/core/operator_name.h>
+#include <torch/csrc/jit/mobile/register_calls.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace torch {
 namespace jit {
 namespace mobile {
 using Stack = std::vector<c10::IValue>;
+
+struct OpLatencyCounter {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> ticks{0};
+};
+
 struct Code {
   std::vector<Instruction> instructions_;
   std::vector<c10::OperatorName> op_names_;
@@ -15,6 +25,14 @@ struct Code {
   std::vector<c10::IValue> constants_;
   std::vector<c10::TypePtr> types_;
   size_t register_size_; // Aggregated output size.
+  // Specialized operator calls, see register_calls.h. register_call_at_[pc]
+  // is the index of the call starting at instruction pc, or -1.
+  std::vector<RegisterCall> register_calls_;
+  std::vector<int32_t> register_call_at_;
+  // Per-instruction operator latencies, allocated on the first run with op
+  // latency profiling enabled (see MobileObserverConfig). Indexed by pc.
+  std::once_flag op_latencies_once_;
+  std::unique_ptr<OpLatencyCounter[]> op_latencies_;
 };
 
 struct InterpreterState {
@@ -24,6 +42,10 @@ struct InterpreterState {
  private:
   std::shared_ptr<Code> code_;
   c10::IValue& reg(size_t reg);
+  void runRegisterCall(
+      const RegisterCall& call,
+      OpLatencyCounter* latencies);
+  OpLatencyCounter* opLatencies();
   std::vector<c10::IValue> registers_;
 };
 
@@ -2,6 +2,7 @@
 #include <torch/csrc/jit/mobile/interpreter.h>
 #include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/runtime/jit_exception.h>
+#include <algorithm>
 #include <exception>
 
 #include <ATen/record_function.h>
@@ -84,6 +85,28 @@ Function* Module::find_method(const std::string& basename) const {
   return nullptr;
 }
 
+std::vector<MobileOpLatency> Module::op_latencies() const {
+  std::vector<MobileOpLatency> latencies;
+  const double ticks_per_us =
+      torch::observerConfig().opLatencyTicksPerMicrosecond();
+  for (const auto& fn : cu_->methods()) {
+    fn->collect_op_latencies(latencies, ticks_per_us);
+  }
+  std::sort(
+      latencies.begin(),
+      latencies.end(),
+      [](const MobileOpLatency& a, const MobileOpLatency& b) {
+        return a.ticks > b.ticks;
+      });
+  return latencies;
+}
+
+void Module::reset_op_latencies() {
+  for (auto& fn : cu_->methods()) {
+    fn->reset_op_latencies();
+  }
+}
+
 namespace {
 void slot_params_recurse(
     const c10::intrusive_ptr<c10::ivalue::Object>& obj,
@@ -1,6 +1,7 @@
 #pragma once
 //#include <ATen/core/function_schema.h>
 #include <torch/csrc/jit/mobile/function.h>
+#include <torch/csrc/jit/mobile/observer.h>
 
 namespace torch {
 namespace jit {
@@ -42,6 +43,11 @@ class TORCH_API Module {
   }
   const std::vector<at::Tensor> parameters() const;
   const std::map<std::string, at::Tensor> named_parameters() const;
+  // Operator latencies of all methods accumulated while op latency profiling
+  // was enabled (see MobileObserverConfig), slowest call site first. Meant to
+  // be read after a number of runs, not concurrently with them.
+  std::vector<MobileOpLatency> op_latencies() const;
+  void reset_op_latencies();
 
  private:
   c10::intrusive_ptr<c10::ivalue::Object> object_;
@@ -7,4 +7,20 @@ MobileObserverConfig& observerConfig() {
   return instance;
 }
 
+void MobileObserverConfig::setOpLatencyProfiling(bool enabled) {
+  if (enabled) {
+    window_start_time_ = std::chrono::steady_clock::now();
+    window_start_ticks_ = readMobileCycleCounter();
+  }
+  op_latency_profiling_.store(enabled, std::memory_order_relaxed);
+}
+
+double MobileObserverConfig::opLatencyTicksPerMicrosecond() const {
+  const uint64_t ticks = readMobileCycleCounter() - window_start_ticks_;
+  const double us = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - window_start_time_)
+                        .count();
+  return us > 0 ? ticks / us : 0;
+}
+
 } // namespace torch
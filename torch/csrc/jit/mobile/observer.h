@@ -1,8 +1,18 @@
 #pragma once
 
 #include <c10/util/ThreadLocalDebugInfo.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 namespace torch {
 
 class MobileDebugInfo : public c10::DebugInfoBase {
@@ -52,6 +62,39 @@ class MobileModuleObserver {
   virtual void onFailLoadModel(const std::string&) {}
 };
 
+// Cheapest monotonic counter of the platform: the TSC on x86, the virtual
+// counter of the generic timer on arm64, and steady_clock nanoseconds
+// elsewhere. Only differences of two readings are meaningful.
+inline uint64_t readMobileCycleCounter() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+// Aggregated latency of one operator call site (the pc of its OP instruction)
+// of a lite interpreter method, see mobile::Module::opLatencies().
+struct MobileOpLatency {
+  std::string method_name;
+  size_t pc;
+  // Operator name with the overload appended after a '.', if any
+  std::string op_name;
+  uint64_t count;
+  uint64_t ticks;
+  // ticks converted with the counter frequency measured over the profiling
+  // window
+  double total_us;
+};
+
 class MobileObserverConfig {
  public:
   void setModuleObserver(std::unique_ptr<MobileModuleObserver> reporter) {
@@ -61,8 +104,23 @@ class MobileObserverConfig {
     return module_observer_.get();
   }
 
+  // Opt-in per-operator latency profiling of the lite interpreter. While it is
+  // enabled every operator call is timed with readMobileCycleCounter() and
+  // accumulated into a table preallocated per method, so the overhead is two
+  // counter reads and two relaxed atomic adds per operator. Enabling it also
+  // starts the window used to convert counter ticks to time.
+  void setOpLatencyProfiling(bool enabled);
+  bool isOpLatencyProfilingEnabled() const {
+    return op_latency_profiling_.load(std::memory_order_relaxed);
+  }
+  // Counter ticks per microsecond since profiling was last enabled
+  double opLatencyTicksPerMicrosecond() const;
+
  private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  std::atomic<bool> op_latency_profiling_{false};
+  uint64_t window_start_ticks_ = 0;
+  std::chrono::steady_clock::time_point window_start_time_;
 };
 
 MobileObserverConfig& observerConfig();
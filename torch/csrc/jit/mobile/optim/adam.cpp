@@ -0,0 +1,198 @@
+#include <torch/csrc/jit/mobile/optim/adam.h>
+
+#include <torch/types.h>
+#include <torch/utils.h>
+
+#include <ATen/ATen.h>
+
+#include <cmath>
+#include <functional>
+#include <map>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+bool AdamParamGroup::has_options() const {
+  return options_ != nullptr;
+}
+
+AdamOptions& AdamParamGroup::options() {
+  TORCH_CHECK(has_options());
+  return *options_.get();
+}
+
+const AdamOptions& AdamParamGroup::options() const {
+  TORCH_CHECK(has_options());
+  return *options_.get();
+}
+
+void AdamParamGroup::set_options(std::unique_ptr<AdamOptions> options) {
+  options_ = std::move(options);
+}
+
+std::vector<Tensor>& AdamParamGroup::params() {
+  return params_;
+}
+
+const std::vector<Tensor>& AdamParamGroup::params() const {
+  return params_;
+}
+
+AdamOptions::AdamOptions(double lr) : lr_(lr) {}
+
+bool operator==(const AdamOptions& lhs, const AdamOptions& rhs) {
+  return (lhs.lr() == rhs.lr()) &&
+      (std::get<0>(lhs.betas()) == std::get<0>(rhs.betas())) &&
+      (std::get<1>(lhs.betas()) == std::get<1>(rhs.betas())) &&
+      (lhs.eps() == rhs.eps()) && (lhs.weight_decay() == rhs.weight_decay()) &&
+      (lhs.amsgrad() == rhs.amsgrad()) && (lhs.fused() == rhs.fused());
+}
+
+void Adam::add_param_group(const AdamParamGroup& param_group) {
+  for (const auto& param : param_group.params()) {
+    TORCH_CHECK(param.is_leaf(), "can't optimize a non-leaf Tensor");
+  }
+  TORCH_INTERNAL_ASSERT(defaults_ != nullptr);
+  AdamParamGroup param_group_(param_group.params());
+  if (!param_group.has_options()) {
+    param_group_.set_options(defaults_->clone());
+  } else {
+    param_group_.set_options(param_group.options().clone());
+  }
+  for (const auto& p : param_group_.params()) {
+    TORCH_CHECK(
+        state_.count(c10::guts::to_string(p.unsafeGetTensorImpl())) == 0,
+        "some parameters appear in more than one parameter group");
+  }
+  param_groups_.emplace_back(std::move(param_group_));
+}
+
+void Adam::zero_grad() {
+  for (auto& group : param_groups_) {
+    for (auto& p : group.params()) {
+      if (p.grad().defined()) {
+        p.grad().detach_();
+        p.grad().zero_();
+      }
+    }
+  }
+}
+
+AdamParamState& Adam::param_state(
+    const Tensor& p,
+    const AdamOptions& options) {
+  auto key = c10::guts::to_string(p.unsafeGetTensorImpl());
+  auto it = state_.find(key);
+  if (it == state_.end()) {
+    auto state = std::make_unique<AdamParamState>();
+    state->step(0);
+    state->exp_avg(torch::zeros_like(p, MemoryFormat::Preserve));
+    state->exp_avg_sq(torch::zeros_like(p, MemoryFormat::Preserve));
+    if (options.amsgrad()) {
+      state->max_exp_avg_sq(torch::zeros_like(p, MemoryFormat::Preserve));
+    }
+    it = state_.emplace(key, std::move(state)).first;
+  }
+  return *it->second;
+}
+
+Tensor Adam::step(const LossClosure& closure) {
+  NoGradGuard no_grad;
+  Tensor loss = {};
+  if (closure != nullptr) {
+    at::AutoGradMode enable_grad(true);
+    loss = closure();
+  }
+  for (auto& group : param_groups_) {
+    auto& options = static_cast<AdamOptions&>(group.options());
+    auto beta1 = std::get<0>(options.betas());
+    auto beta2 = std::get<1>(options.betas());
+
+    if (options.fused()) {
+      // Parameters are updated in batches that share a step count, and so
+      // the bias corrections.
+      struct Batch {
+        std::vector<Tensor> params, grads, exp_avgs, exp_avg_sqs,
+            max_exp_avg_sqs;
+      };
+      std::map<int64_t, Batch> batches;
+      for (auto& p : group.params()) {
+        if (!p.grad().defined()) {
+          continue;
+        }
+        auto& state = param_state(p, options);
+        state.step(state.step() + 1);
+        auto& batch = batches[state.step()];
+        batch.params.push_back(p.data());
+        batch.grads.push_back(p.grad().data());
+        batch.exp_avgs.push_back(state.exp_avg());
+        batch.exp_avg_sqs.push_back(state.exp_avg_sq());
+        if (options.amsgrad()) {
+          batch.max_exp_avg_sqs.push_back(state.max_exp_avg_sq());
+        }
+      }
+      for (auto& step_and_batch : batches) {
+        auto& batch = step_and_batch.second;
+        at::_fused_adam_(
+            batch.params,
+            batch.grads,
+            batch.exp_avgs,
+            batch.exp_avg_sqs,
+            batch.max_exp_avg_sqs,
+            step_and_batch.first,
+            options.lr(),
+            beta1,
+            beta2,
+            options.weight_decay(),
+            options.eps(),
+            options.amsgrad(),
+            /*decoupled_weight_decay=*/false);
+      }
+      continue;
+    }
+
+    for (auto& p : group.params()) {
+      if (!p.grad().defined()) {
+        continue;
+      }
+      auto grad = p.grad().data();
+      TORCH_CHECK(!grad.is_sparse(), "Adam does not support sparse gradients");
+      auto& state = param_state(p, options);
+      state.step(state.step() + 1);
+      auto bias_correction1 = 1 - std::pow(beta1, state.step());
+      auto bias_correction2 = 1 - std::pow(beta2, state.step());
+
+      // The scratch buffer first holds the weight decayed gradient, if any,
+      // and then the denominator, so that steps don't allocate.
+      if (!state.denom().defined()) {
+        state.denom(torch::empty_like(p, MemoryFormat::Preserve));
+      }
+      auto denom = state.denom();
+      if (options.weight_decay() != 0) {
+        at::add_out(denom, grad, p.data(), options.weight_decay());
+        grad = denom;
+      }
+
+      auto exp_avg = state.exp_avg();
+      auto exp_avg_sq = state.exp_avg_sq();
+      exp_avg.mul_(beta1).add_(grad, 1 - beta1);
+      exp_avg_sq.mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+      if (options.amsgrad()) {
+        auto max_exp_avg_sq = state.max_exp_avg_sq();
+        at::max_out(max_exp_avg_sq, exp_avg_sq, max_exp_avg_sq);
+        at::sqrt_out(denom, max_exp_avg_sq);
+      } else {
+        at::sqrt_out(denom, exp_avg_sq);
+      }
+      denom.div_(std::sqrt(bias_correction2)).add_(options.eps());
+
+      auto step_size = options.lr() / bias_correction1;
+      p.data().addcdiv_(exp_avg, denom, -step_size);
+    }
+  }
+  return loss;
+}
+} // namespace mobile
+} // namespace jit
+} // namespace torch
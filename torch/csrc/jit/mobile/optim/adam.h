@@ -0,0 +1,143 @@
+#pragma once
+
+#include <torch/arg.h>
+#include <torch/nn/module.h>
+#include <torch/serialize/archive.h>
+#include <torch/types.h>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+class AdamParamState {
+  TORCH_ARG(int64_t, step) = 0;
+  TORCH_ARG(torch::Tensor, exp_avg);
+  TORCH_ARG(torch::Tensor, exp_avg_sq);
+  TORCH_ARG(torch::Tensor, max_exp_avg_sq) = {};
+  // Scratch buffer of the unfused update, allocated once per parameter.
+  TORCH_ARG(torch::Tensor, denom) = {};
+
+ public:
+  std::unique_ptr<AdamParamState> clone() const {
+    return std::make_unique<AdamParamState>(
+        static_cast<const AdamParamState&>(*this));
+  }
+  ~AdamParamState() = default;
+};
+
+struct TORCH_API AdamOptions {
+  /* implicit */ AdamOptions(double lr = 1e-3);
+  TORCH_ARG(double, lr) = 1e-3;
+  typedef std::tuple<double, double> betas_t;
+  TORCH_ARG(betas_t, betas) = std::make_tuple(0.9, 0.999);
+  TORCH_ARG(double, eps) = 1e-8;
+  TORCH_ARG(double, weight_decay) = 0;
+  TORCH_ARG(bool, amsgrad) = false;
+  // Updates every parameter of a group in place with one fused kernel (see
+  // at::_fused_adam_), without the temporaries of the unfused update.
+  TORCH_ARG(bool, fused) = false;
+
+ public:
+  std::unique_ptr<AdamOptions> clone() const {
+    return std::make_unique<AdamOptions>(static_cast<const AdamOptions&>(*this));
+  }
+  TORCH_API friend bool operator==(
+      const AdamOptions& lhs,
+      const AdamOptions& rhs);
+  ~AdamOptions() = default;
+};
+
+/// Stores parameters in the param_group and stores a pointer to the
+/// AdamOptions
+class TORCH_API AdamParamGroup {
+ public:
+  // NOTE: In order to store `AdamParamGroup` in a `std::vector`, it has to be
+  // copy-constructible.
+  AdamParamGroup(const AdamParamGroup& param_group)
+      : params_(param_group.params()),
+        options_(
+            param_group.has_options() ? param_group.options().clone()
+                                      : nullptr) {}
+  AdamParamGroup& operator=(const AdamParamGroup& param_group) {
+    this->params_ = param_group.params();
+    this->options_ =
+        param_group.has_options() ? param_group.options().clone() : nullptr;
+    return *this;
+  }
+  /* implicit */ AdamParamGroup(std::vector<Tensor> params)
+      : params_(std::move(params)) {}
+  AdamParamGroup(
+      std::vector<Tensor> params,
+      std::unique_ptr<AdamOptions> options)
+      : params_(std::move(params)), options_(std::move(options)) {}
+
+  bool has_options() const;
+  AdamOptions& options();
+  const AdamOptions& options() const;
+  void set_options(std::unique_ptr<AdamOptions> options);
+  std::vector<Tensor>& params();
+  const std::vector<Tensor>& params() const;
+
+ protected:
+  std::vector<Tensor> params_;
+  std::unique_ptr<AdamOptions> options_;
+};
+
+class TORCH_API Adam {
+ public:
+  explicit Adam(
+      std::vector<torch::jit::mobile::AdamParamGroup> param_groups,
+      AdamOptions defaults)
+      : defaults_(std::make_unique<AdamOptions>(defaults)) {
+    for (const auto& param_group : param_groups) {
+      add_param_group(param_group);
+    }
+    TORCH_CHECK(defaults.lr() >= 0, "Invalid learning rate: ", defaults.lr());
+    TORCH_CHECK(defaults.eps() >= 0, "Invalid epsilon value: ", defaults.eps());
+    auto betas = defaults.betas();
+    TORCH_CHECK(
+        0 <= std::get<0>(betas) && std::get<0>(betas) < 1.0,
+        "Invalid beta parameter at index 0: ",
+        std::get<0>(betas));
+    TORCH_CHECK(
+        0 <= std::get<1>(betas) && std::get<1>(betas) < 1.0,
+        "Invalid beta parameter at index 1: ",
+        std::get<1>(betas));
+    TORCH_CHECK(
+        defaults.weight_decay() >= 0,
+        "Invalid weight_decay value: ",
+        defaults.weight_decay());
+  }
+
+  explicit Adam(std::vector<Tensor> params, AdamOptions defaults = {})
+      : Adam({std::move(AdamParamGroup(params))}, defaults) {}
+
+  /// Adds the given param_group to the optimizer's param_group list.
+  void add_param_group(const AdamParamGroup& param_group);
+
+  ~Adam() = default;
+
+  using LossClosure = std::function<Tensor()>;
+  /// A loss function closure, which is expected to return the loss value.
+  torch::Tensor step(const LossClosure& closure = nullptr);
+
+  /// Zeros out the gradients of all parameters. The gradient buffers are
+  /// kept, so that the next backward passes accumulate into them in place.
+  void zero_grad();
+
+ protected:
+  // Returns the state of p, creating zero moments on its first step.
+  AdamParamState& param_state(const Tensor& p, const AdamOptions& options);
+
+  std::vector<AdamParamGroup> param_groups_;
+  ska::flat_hash_map<std::string, std::unique_ptr<AdamParamState>> state_;
+  std::unique_ptr<AdamOptions> defaults_;
+};
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -43,7 +43,7 @@ bool operator==(const SGDOptions& lhs, const SGDOptions& rhs) {
   return (lhs.lr() == rhs.lr()) && (lhs.momentum() == rhs.momentum()) &&
       (lhs.dampening() == rhs.dampening()) &&
       (lhs.weight_decay() == rhs.weight_decay()) &&
-      (lhs.nesterov() == rhs.nesterov());
+      (lhs.nesterov() == rhs.nesterov()) && (lhs.fused() == rhs.fused());
 }
 
 bool operator==(const SGDParamState& lhs, const SGDParamState& rhs) {
@@ -80,6 +80,72 @@ void SGD::zero_grad() {
   }
 }
 
+void SGD::fused_step(
+    const std::vector<Tensor>& params,
+    const std::vector<Tensor>& params_data,
+    const std::vector<Tensor>& grads,
+    const SGDOptions& options) {
+  auto momentum = options.momentum();
+  if (momentum == 0) {
+    at::_fused_sgd_(
+        params_data,
+        grads,
+        {},
+        options.lr(),
+        momentum,
+        options.dampening(),
+        options.weight_decay(),
+        options.nesterov(),
+        /*is_first_step=*/false);
+    return;
+  }
+  // Parameters seen for the first time get a fresh buffer that the kernel
+  // initializes to d_p; the others update the buffer they already have.
+  std::vector<Tensor> new_params_data, new_grads, new_bufs;
+  std::vector<Tensor> old_params_data, old_grads, old_bufs;
+  for (size_t i = 0; i < params.size(); i++) {
+    auto key = c10::guts::to_string(params[i].unsafeGetTensorImpl());
+    auto param_state = state_.find(key);
+    if (param_state == state_.end()) {
+      auto buf = torch::zeros_like(params_data[i], MemoryFormat::Preserve);
+      auto state = std::make_unique<SGDParamState>();
+      state->momentum_buffer(buf);
+      state_[key] = std::move(state);
+      new_params_data.push_back(params_data[i]);
+      new_grads.push_back(grads[i]);
+      new_bufs.push_back(buf);
+    } else {
+      old_params_data.push_back(params_data[i]);
+      old_grads.push_back(grads[i]);
+      old_bufs.push_back(param_state->second->momentum_buffer());
+    }
+  }
+  if (!new_params_data.empty()) {
+    at::_fused_sgd_(
+        new_params_data,
+        new_grads,
+        new_bufs,
+        options.lr(),
+        momentum,
+        options.dampening(),
+        options.weight_decay(),
+        options.nesterov(),
+        /*is_first_step=*/true);
+  }
+  if (!old_params_data.empty()) {
+    at::_fused_sgd_(
+        old_params_data,
+        old_grads,
+        old_bufs,
+        options.lr(),
+        momentum,
+        options.dampening(),
+        options.weight_decay(),
+        options.nesterov(),
+        /*is_first_step=*/false);
+  }
+}
+
 Tensor SGD::step(const LossClosure& closure) {
   NoGradGuard no_grad;
   Tensor loss = {};
@@ -94,6 +160,23 @@ Tensor SGD::step(const LossClosure& closure) {
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
 
+    if (options.fused()) {
+      std::vector<Tensor> params;
+      std::vector<Tensor> params_data;
+      std::vector<Tensor> grads;
+      for (auto& p : group.params()) {
+        if (p.grad().defined()) {
+          params.push_back(p);
+          params_data.push_back(p.data());
+          grads.push_back(p.grad().data());
+        }
+      }
+      if (!params.empty()) {
+        fused_step(params, params_data, grads, options);
+      }
+      continue;
+    }
+
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
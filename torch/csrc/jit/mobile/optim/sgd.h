@@ -31,6 +31,9 @@ struct TORCH_API SGDOptions {
   TORCH_ARG(double, dampening) = 0;
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(bool, nesterov) = false;
+  // Updates every parameter of a group in place with one fused kernel (see
+  // at::_fused_sgd_), without the temporaries of the unfused update.
+  TORCH_ARG(bool, fused) = false;
 
  public:
   std::unique_ptr<SGDOptions> clone() const {
@@ -111,10 +114,18 @@ class TORCH_API SGD {
   /// A loss function closure, which is expected to return the loss value.
   torch::Tensor step(const LossClosure& closure = nullptr);
 
-  /// Zeros out the gradients of all parameters.
+  /// Zeros out the gradients of all parameters. The gradient buffers are
+  /// kept, so that the next backward passes accumulate into them in place.
   void zero_grad();
 
  protected:
+  // Applies the update for the given parameters with at::_fused_sgd_.
+  void fused_step(
+      const std::vector<Tensor>& params,
+      const std::vector<Tensor>& params_data,
+      const std::vector<Tensor>& grads,
+      const SGDOptions& options);
+
   std::vector<SGDParamGroup> param_groups_;
   ska::flat_hash_map<std::string, std::unique_ptr<SGDParamState>> state_;
   std::unique_ptr<SGDOptions> defaults_;
@@ -0,0 +1,187 @@
+#include <torch/csrc/jit/mobile/register_calls.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/mobile/interpreter.h>
+#include <torch/csrc/jit/runtime/instruction.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+namespace {
+
+using c10::IValue;
+using Args = const IValue* const*;
+
+c10::optional<at::Tensor> optionalTensor(const IValue& v) {
+  if (v.isNone()) {
+    return c10::nullopt;
+  }
+  return v.toTensor();
+}
+
+struct UnboxedEntry {
+  const char* name;
+  const char* overload_name;
+  size_t num_args;
+  UnboxedOperator fn;
+};
+
+// clang-format off
+const UnboxedEntry kUnboxedOperators[] = {
+    {"aten::conv2d", "", 7, [](Args a) -> IValue {
+       return at::conv2d(
+           a[0]->toTensor(), a[1]->toTensor(), optionalTensor(*a[2]),
+           a[3]->toIntVector(), a[4]->toIntVector(), a[5]->toIntVector(),
+           a[6]->toInt());
+     }},
+    {"aten::linear", "", 3, [](Args a) -> IValue {
+       return at::linear(
+           a[0]->toTensor(), a[1]->toTensor(), optionalTensor(*a[2]));
+     }},
+    {"aten::addmm", "", 5, [](Args a) -> IValue {
+       return at::addmm(
+           a[0]->toTensor(), a[1]->toTensor(), a[2]->toTensor(),
+           a[3]->toScalar(), a[4]->toScalar());
+     }},
+    {"aten::matmul", "", 2, [](Args a) -> IValue {
+       return at::matmul(a[0]->toTensor(), a[1]->toTensor());
+     }},
+    {"aten::add", "Tensor", 3, [](Args a) -> IValue {
+       return at::add(a[0]->toTensor(), a[1]->toTensor(), a[2]->toScalar());
+     }},
+    {"aten::add_", "Tensor", 3, [](Args a) -> IValue {
+       return a[0]->toTensor().add_(a[1]->toTensor(), a[2]->toScalar());
+     }},
+    {"aten::mul", "Tensor", 2, [](Args a) -> IValue {
+       return at::mul(a[0]->toTensor(), a[1]->toTensor());
+     }},
+    {"aten::relu", "", 1, [](Args a) -> IValue {
+       return at::relu(a[0]->toTensor());
+     }},
+    {"aten::relu_", "", 1, [](Args a) -> IValue {
+       at::Tensor self = a[0]->toTensor();
+       return at::relu_(self);
+     }},
+    {"aten::sigmoid", "", 1, [](Args a) -> IValue {
+       return at::sigmoid(a[0]->toTensor());
+     }},
+    {"aten::hardtanh", "", 3, [](Args a) -> IValue {
+       return at::hardtanh(
+           a[0]->toTensor(), a[1]->toScalar(), a[2]->toScalar());
+     }},
+    {"aten::hardtanh_", "", 3, [](Args a) -> IValue {
+       at::Tensor self = a[0]->toTensor();
+       return at::hardtanh_(self, a[1]->toScalar(), a[2]->toScalar());
+     }},
+    {"aten::max_pool2d", "", 6, [](Args a) -> IValue {
+       return at::max_pool2d(
+           a[0]->toTensor(), a[1]->toIntVector(), a[2]->toIntVector(),
+           a[3]->toIntVector(), a[4]->toIntVector(), a[5]->toBool());
+     }},
+    {"aten::adaptive_avg_pool2d", "", 2, [](Args a) -> IValue {
+       return at::adaptive_avg_pool2d(a[0]->toTensor(), a[1]->toIntVector());
+     }},
+    {"aten::flatten", "using_ints", 3, [](Args a) -> IValue {
+       return at::flatten(a[0]->toTensor(), a[1]->toInt(), a[2]->toInt());
+     }},
+    {"aten::view", "", 2, [](Args a) -> IValue {
+       return a[0]->toTensor().view(a[1]->toIntVector());
+     }},
+    {"aten::reshape", "", 2, [](Args a) -> IValue {
+       return at::reshape(a[0]->toTensor(), a[1]->toIntVector());
+     }},
+    {"aten::cat", "", 2, [](Args a) -> IValue {
+       return at::cat(a[0]->toTensorVector(), a[1]->toInt());
+     }},
+    {"aten::dropout", "", 3, [](Args a) -> IValue {
+       return at::dropout(a[0]->toTensor(), a[1]->toDouble(), a[2]->toBool());
+     }},
+};
+// clang-format on
+
+const UnboxedEntry* findUnboxed(const c10::OperatorName& opname) {
+  for (const auto& entry : kUnboxedOperators) {
+    if (opname.name == entry.name &&
+        opname.overload_name == entry.overload_name) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// Number of arguments in the schema the operator was registered with, so
+// that a model exported against another version of it is left alone.
+c10::optional<size_t> schemaNumArgs(const c10::OperatorName& opname) {
+  if (auto jit_op = findOperatorFor(opname)) {
+    return jit_op->schema().arguments().size();
+  }
+  auto op = c10::Dispatcher::singleton().findSchema(opname);
+  if (op.has_value()) {
+    return op->schema().arguments().size();
+  }
+  return c10::nullopt;
+}
+
+} // namespace
+
+void specializeRegisterCalls(Code& code) {
+  const auto& instructions = code.instructions_;
+  code.register_calls_.clear();
+  code.register_call_at_.assign(instructions.size(), -1);
+
+  // Operators are looked up once, not once per call site.
+  std::vector<const UnboxedEntry*> unboxed(code.op_names_.size(), nullptr);
+  for (size_t i = 0; i < code.op_names_.size(); ++i) {
+    const UnboxedEntry* entry = findUnboxed(code.op_names_[i]);
+    if (entry && entry->num_args <= kMaxRegisterCallArgs &&
+        schemaNumArgs(code.op_names_[i]) == entry->num_args) {
+      unboxed[i] = entry;
+    }
+  }
+
+  for (size_t pc = 0; pc + 1 < instructions.size(); ++pc) {
+    const Instruction& inst = instructions[pc];
+    if (inst.op != OP || instructions[pc + 1].op != STORE) {
+      continue;
+    }
+    const UnboxedEntry* entry = unboxed.at(inst.X);
+    if (!entry || pc < entry->num_args) {
+      continue;
+    }
+    const size_t begin = pc - entry->num_args;
+    RegisterCall call;
+    bool matches = true;
+    for (size_t i = begin; i < pc && matches; ++i) {
+      const Instruction& load = instructions[i];
+      switch (load.op) {
+        case LOAD:
+          call.args.push_back({RegisterCall::Source::LOAD, load.X});
+          break;
+        case MOVE:
+          call.args.push_back({RegisterCall::Source::MOVE, load.X});
+          break;
+        case LOADC:
+          call.args.push_back({RegisterCall::Source::CONSTANT, load.X});
+          break;
+        default:
+          matches = false;
+      }
+    }
+    if (!matches) {
+      continue;
+    }
+    call.fn = entry->fn;
+    call.op = inst.X;
+    call.op_pc = pc;
+    call.output = instructions[pc + 1].X;
+    call.length = entry->num_args + 2;
+    code.register_call_at_[begin] = code.register_calls_.size();
+    code.register_calls_.push_back(std::move(call));
+  }
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
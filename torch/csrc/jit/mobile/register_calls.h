@@ -0,0 +1,55 @@
+#pragma once
+#include <ATen/core/ivalue.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+struct Code;
+
+// The bytecode calls an operator by pushing its arguments onto the stack
+// (LOAD / MOVE / LOADC), running the boxed operator (OP), which pops them and
+// pushes its result, and popping the result into a register (STORE). For the
+// operators models spend most of their calls on, specializeRegisterCalls
+// replaces such sequences at load time with a RegisterCall: the interpreter
+// reads the arguments in place from the registers and constants, calls an
+// unboxed kernel wrapper and writes the result to the output register, in a
+// single step and without a round trip through the stack.
+//
+// The bytecode itself is unchanged; only sequences matching exactly are
+// specialized, and everything else (including jumps into the middle of a
+// sequence) runs the original instructions.
+
+// Calls the operator on args, which point to its arguments in schema order.
+using UnboxedOperator = c10::IValue (*)(const c10::IValue* const* args);
+
+constexpr size_t kMaxRegisterCallArgs = 8;
+
+struct RegisterCall {
+  enum class Source : uint8_t { LOAD, MOVE, CONSTANT };
+  struct Arg {
+    Source source;
+    // register (as in Instruction::X) or index into the constant table
+    int32_t index;
+  };
+  std::vector<Arg> args;
+  UnboxedOperator fn;
+  // index into Code::op_names_
+  int32_t op;
+  // pc of the OP instruction, reported to MobileDebugInfo like OP does
+  size_t op_pc;
+  // register the result is stored to
+  int32_t output;
+  // number of instructions the call replaces
+  size_t length;
+};
+
+// Fills Code::register_calls_ and Code::register_call_at_ for code, whose
+// instructions and operators must all have been appended.
+void specializeRegisterCalls(Code& code);
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -11,6 +11,7 @@
 
 #include <ATen/ATen.h>
 #include <algorithm>
+#include <sstream>
 #include <unordered_map>
 
 namespace torch {
@@ -452,6 +453,426 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// Horizontal batching
+//
+// Models made of independent towers, e.g. multi-tower recommendation models,
+// run the same small ops once per tower, with the same shapes, on independent
+// inputs. BatchIndependentOps looks, in each block, for groups of such ops,
+// that don't depend on each other, and replaces each group with a single
+// prim::HorizontalBatch node. At runtime, the node checks that the inputs of
+// the ops are batchable, i.e. that they have the same shapes, dtypes and
+// devices, and then runs a single batched op (bmm, baddbmm, one layer_norm,
+// one elementwise op, one embedding lookup) on the inputs stacked along a new
+// dimension. Otherwise, it runs the ops one by one.
+
+enum class HorizontalBatchKind {
+  // aten::linear and aten::addmm, batched into one bmm or baddbmm
+  Linear,
+  AddMM,
+  // aten::layer_norm, batched into one layer_norm and the affine transform
+  LayerNorm,
+  // elementwise ops whose tensor inputs all have the same shape, run once on
+  // the stacked inputs
+  Elementwise,
+  // aten::embedding of the same table, batched into one lookup of all indices
+  Embedding,
+};
+
+// Tunable parameters. The batched ops copy the inputs into the stacked ones,
+// which only pays off for small ops.
+static constexpr size_t min_horizontal_batch_size = 2;
+static constexpr int64_t max_horizontal_batch_numel = 1024 * 2048;
+
+c10::optional<HorizontalBatchKind> horizontalBatchKind(Node* node) {
+  static const char* elementwise_ops[] = {
+      "aten::relu(Tensor self) -> Tensor",
+      "aten::sigmoid(Tensor self) -> Tensor",
+      "aten::tanh(Tensor self) -> Tensor",
+      "aten::gelu(Tensor self) -> Tensor",
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::mul(Tensor self, Tensor other) -> Tensor",
+      "aten::div(Tensor self, Tensor other) -> Tensor",
+  };
+  if (node->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor")) {
+    return HorizontalBatchKind::Linear;
+  }
+  if (node->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+    return HorizontalBatchKind::AddMM;
+  }
+  if (node->matches(
+          "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight, Tensor? bias, float eps, bool cudnn_enable) -> Tensor")) {
+    return HorizontalBatchKind::LayerNorm;
+  }
+  if (node->matches(
+          "aten::embedding(Tensor weight, Tensor indices, int padding_idx, bool scale_grad_by_freq, bool sparse) -> Tensor")) {
+    return HorizontalBatchKind::Embedding;
+  }
+  for (const char* op : elementwise_ops) {
+    if (node->matches(op)) {
+      return HorizontalBatchKind::Elementwise;
+    }
+  }
+  return c10::nullopt;
+}
+
+// The ops of a group have the same key: the same schema, the same constant
+// non-tensor arguments, and for embeddings the same table.
+c10::optional<std::string> horizontalBatchKey(
+    Node* node,
+    HorizontalBatchKind kind) {
+  std::ostringstream key;
+  key << canonicalSchemaString(node->schema());
+  for (size_t i = 0; i < node->inputs().size(); ++i) {
+    Value* input = node->inputs()[i];
+    key << "|";
+    if (kind == HorizontalBatchKind::Embedding && i == 0) {
+      key << "table" << input->unique();
+    } else if (input->type()->isSubtypeOf(TensorType::get())) {
+      key << "Tensor";
+    } else if (auto ivalue = toIValue(input)) {
+      key << *ivalue;
+    } else {
+      // e.g. a Tensor? that isn't known to be None, or a non-constant scalar
+      return c10::nullopt;
+    }
+  }
+  return key.str();
+}
+
+bool canBatchSameShapes(at::TensorList tensors) {
+  for (const auto& t : tensors) {
+    if (!t.defined() || t.sizes() != tensors[0].sizes() ||
+        t.scalar_type() != tensors[0].scalar_type() ||
+        t.device() != tensors[0].device() || t.is_sparse()) {
+      return false;
+    }
+  }
+  return tensors[0].numel() * static_cast<int64_t>(tensors.size()) <=
+      max_horizontal_batch_numel;
+}
+
+std::vector<at::Tensor> tensorsAt(std::vector<Stack>& members, size_t index) {
+  return fmap(members, [index](const Stack& member) {
+    return member[index].isNone() ? at::Tensor() : member[index].toTensor();
+  });
+}
+
+// Every member has all its Tensor? arguments at index, or none of them.
+c10::optional<bool> allOrNoneDefined(at::TensorList tensors) {
+  bool defined = tensors[0].defined();
+  for (const auto& t : tensors) {
+    if (t.defined() != defined) {
+      return c10::nullopt;
+    }
+  }
+  return defined;
+}
+
+// out[i] = input[i] @ weight[i]^T (+ bias[i]), i.e. linear, or
+// out[i] = beta * self[i] + alpha * mat1[i] @ mat2[i], i.e. addmm.
+bool batchMatmuls(
+    std::vector<Stack>& members,
+    HorizontalBatchKind kind,
+    std::vector<at::Tensor>& outputs) {
+  bool is_linear = kind == HorizontalBatchKind::Linear;
+  auto inputs = tensorsAt(members, is_linear ? 0 : 1);
+  auto weights = tensorsAt(members, is_linear ? 1 : 2);
+  auto biases = tensorsAt(members, is_linear ? 2 : 0);
+  auto has_bias = allOrNoneDefined(biases);
+  if (!has_bias || !canBatchSameShapes(inputs) ||
+      !canBatchSameShapes(weights) || (*has_bias && !canBatchSameShapes(biases))) {
+    return false;
+  }
+  const auto& input = inputs[0];
+  const auto& weight = weights[0];
+  if (input.dim() < 1 || weight.dim() != 2 ||
+      input.scalar_type() != weight.scalar_type() ||
+      input.device() != weight.device() ||
+      input.size(-1) != weight.size(is_linear ? 1 : 0) ||
+      (!is_linear && input.dim() != 2)) {
+    return false;
+  }
+  int64_t num_members = members.size();
+  int64_t out_features = weight.size(is_linear ? 0 : 1);
+  at::Tensor lhs = at::stack(inputs).reshape({num_members, -1, input.size(-1)});
+  at::Tensor rhs = at::stack(weights);
+  if (is_linear) {
+    rhs = rhs.transpose(1, 2);
+  }
+  at::Tensor out;
+  if (*has_bias) {
+    const auto& bias = biases[0];
+    if (bias.dim() > 2 ||
+        (bias.dim() >= 1 && bias.size(-1) != out_features) ||
+        (bias.dim() == 2 && bias.size(0) != lhs.size(1))) {
+      return false;
+    }
+    at::Tensor stacked_bias = at::stack(biases);
+    if (bias.dim() < 2) {
+      stacked_bias = stacked_bias.unsqueeze(1);
+    }
+    if (bias.dim() == 0) {
+      stacked_bias = stacked_bias.unsqueeze(2);
+    }
+    if (is_linear) {
+      out = at::baddbmm(stacked_bias, lhs, rhs);
+    } else {
+      auto beta = members[0][3].toScalar();
+      auto alpha = members[0][4].toScalar();
+      out = at::baddbmm(stacked_bias, lhs, rhs, beta, alpha);
+    }
+  } else {
+    out = at::bmm(lhs, rhs);
+  }
+  std::vector<int64_t> output_sizes = input.sizes().vec();
+  output_sizes.back() = out_features;
+  output_sizes.insert(output_sizes.begin(), num_members);
+  outputs = out.view(output_sizes).unbind(0);
+  return true;
+}
+
+bool batchLayerNorms(
+    std::vector<Stack>& members,
+    std::vector<at::Tensor>& outputs) {
+  auto inputs = tensorsAt(members, 0);
+  auto weights = tensorsAt(members, 2);
+  auto biases = tensorsAt(members, 3);
+  auto has_weight = allOrNoneDefined(weights);
+  auto has_bias = allOrNoneDefined(biases);
+  if (!has_weight || !has_bias || !canBatchSameShapes(inputs) ||
+      (*has_weight && !canBatchSameShapes(weights)) ||
+      (*has_bias && !canBatchSameShapes(biases))) {
+    return false;
+  }
+  auto normalized_shape = members[0][1].toIntVector();
+  const auto& input = inputs[0];
+  int64_t num_batch_dims =
+      input.dim() - static_cast<int64_t>(normalized_shape.size());
+  if (num_batch_dims < 0 ||
+      input.sizes().slice(num_batch_dims) != at::IntArrayRef(normalized_shape)) {
+    return false;
+  }
+  at::Tensor out = at::layer_norm(
+      at::stack(inputs),
+      normalized_shape,
+      /*weight=*/{},
+      /*bias=*/{},
+      members[0][4].toDouble(),
+      members[0][5].toBool());
+  // The affine transform of each member, broadcast over its batch dims.
+  std::vector<int64_t> affine_sizes(num_batch_dims + 1, 1);
+  affine_sizes[0] = members.size();
+  affine_sizes.insert(
+      affine_sizes.end(), normalized_shape.begin(), normalized_shape.end());
+  if (*has_weight) {
+    out = out.mul(at::stack(weights).view(affine_sizes));
+  }
+  if (*has_bias) {
+    out = out.add(at::stack(biases).view(affine_sizes));
+  }
+  outputs = out.unbind(0);
+  return true;
+}
+
+bool batchElementwise(
+    std::vector<Stack>& members,
+    const Operation& op,
+    std::vector<at::Tensor>& outputs) {
+  // All the tensor inputs of all members have the same shape, so that the
+  // stacked inputs don't broadcast differently.
+  std::vector<at::Tensor> all_inputs;
+  std::vector<size_t> tensor_indices;
+  for (size_t i = 0; i < members[0].size(); ++i) {
+    if (members[0][i].isTensor()) {
+      tensor_indices.push_back(i);
+      auto inputs = tensorsAt(members, i);
+      all_inputs.insert(all_inputs.end(), inputs.begin(), inputs.end());
+    }
+  }
+  if (tensor_indices.empty() || !canBatchSameShapes(all_inputs)) {
+    return false;
+  }
+  Stack batched = members[0];
+  for (size_t index : tensor_indices) {
+    batched[index] = at::stack(tensorsAt(members, index));
+  }
+  op(&batched);
+  outputs = batched.back().toTensor().unbind(0);
+  return true;
+}
+
+bool batchEmbeddings(
+    std::vector<Stack>& members,
+    std::vector<at::Tensor>& outputs) {
+  const auto& weight = members[0][0].toTensor();
+  auto indices = tensorsAt(members, 1);
+  int64_t total_numel = 0;
+  for (const auto& index : indices) {
+    if (index.scalar_type() != indices[0].scalar_type() ||
+        index.device() != indices[0].device()) {
+      return false;
+    }
+    total_numel += index.numel();
+  }
+  if (total_numel * weight.size(-1) > max_horizontal_batch_numel) {
+    return false;
+  }
+  std::vector<at::Tensor> flat_indices = fmap(
+      indices, [](const at::Tensor& index) { return index.reshape({-1}); });
+  std::vector<int64_t> split_sizes =
+      fmap(indices, [](const at::Tensor& index) { return index.numel(); });
+  at::Tensor out = at::embedding(
+      weight,
+      at::cat(flat_indices),
+      members[0][2].toInt(),
+      members[0][3].toBool(),
+      members[0][4].toBool());
+  auto chunks = out.split_with_sizes(split_sizes);
+  outputs.clear();
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    std::vector<int64_t> sizes = indices[i].sizes().vec();
+    sizes.push_back(weight.size(-1));
+    outputs.push_back(chunks[i].view(sizes));
+  }
+  return true;
+}
+
+RegisterOperators horizontal_batch_reg({Operator(
+    prim::HorizontalBatch,
+    [](const Node* node) -> Operation {
+      auto kind =
+          static_cast<HorizontalBatchKind>(node->i(Symbol::attr("kind")));
+      size_t num_members = node->outputs().size();
+      size_t num_member_inputs = node->inputs().size() / num_members;
+      const auto& schema = node->s(Symbol::attr("schema"));
+      Operation op;
+      for (const auto& candidate : getAllOperatorsFor(
+               Symbol::fromQualString(node->s(Symbol::attr("name"))))) {
+        if (canonicalSchemaString(candidate->schema()) == schema) {
+          op = candidate->getOperation();
+        }
+      }
+      TORCH_INTERNAL_ASSERT(op, "Couldn't find the operator ", schema);
+      return [kind, num_members, num_member_inputs, op](Stack* stack) {
+        std::vector<Stack> members(num_members);
+        auto it = stack->end() - num_members * num_member_inputs;
+        for (auto& member : members) {
+          member.assign(
+              std::make_move_iterator(it),
+              std::make_move_iterator(it + num_member_inputs));
+          it += num_member_inputs;
+        }
+        drop(stack, num_members * num_member_inputs);
+
+        std::vector<at::Tensor> outputs;
+        bool batched = false;
+        switch (kind) {
+          case HorizontalBatchKind::Linear:
+          case HorizontalBatchKind::AddMM:
+            batched = batchMatmuls(members, kind, outputs);
+            break;
+          case HorizontalBatchKind::LayerNorm:
+            batched = batchLayerNorms(members, outputs);
+            break;
+          case HorizontalBatchKind::Elementwise:
+            batched = batchElementwise(members, op, outputs);
+            break;
+          case HorizontalBatchKind::Embedding:
+            batched = batchEmbeddings(members, outputs);
+            break;
+        }
+        if (batched) {
+          stack->insert(
+              stack->end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
+        } else {
+          for (auto& member : members) {
+            op(&member);
+            stack->emplace_back(std::move(member.back()));
+          }
+        }
+      };
+    },
+    aliasAnalysisIsSpecialCase())});
+
+// Batches the first group of independent ops found in the block, and
+// returns whether it found one. The AliasDb doesn't know about the batched op,
+// so it has to be rebuilt before looking for the next group.
+bool BatchIndependentOps(Block* block, AliasDb& alias_db) {
+  // The candidates of each key, in topological order
+  std::unordered_map<std::string, std::vector<Node*>> candidates;
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, HorizontalBatchKind> kinds;
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      if (BatchIndependentOps(subblock, alias_db)) {
+        return true;
+      }
+    }
+    auto kind = horizontalBatchKind(node);
+    // the ops already batched are dead until DCE
+    if (!kind || node->output()->uses().empty()) {
+      continue;
+    }
+    auto key = horizontalBatchKey(node, *kind);
+    if (!key) {
+      continue;
+    }
+    auto& nodes = candidates[*key];
+    if (nodes.empty()) {
+      keys.push_back(*key);
+      kinds.emplace(*key, *kind);
+    }
+    nodes.push_back(node);
+  }
+
+  Graph* graph = block->owningGraph();
+  for (const auto& key : keys) {
+    auto& nodes = candidates[key];
+    if (nodes.size() < min_horizontal_batch_size) {
+      continue;
+    }
+    // Move the ops that don't depend on the ones already in the group right
+    // before the first one, where the batched op takes their place.
+    std::vector<Node*> group{nodes[0]};
+    for (size_t i = 1; i < nodes.size(); ++i) {
+      bool independent = std::all_of(
+          group.begin(), group.end(), [&](Node* member) {
+            return alias_db.couldMoveBeforeTopologically(nodes[i], member);
+          });
+      if (independent &&
+          alias_db.moveBeforeTopologicallyValid(nodes[i], group[0])) {
+        group.push_back(nodes[i]);
+      }
+    }
+    if (group.size() < min_horizontal_batch_size) {
+      continue;
+    }
+
+    WithInsertPoint insert_guard{group[0]};
+    Node* batched = graph->insertNode(graph->create(
+        prim::HorizontalBatch, /*inputs=*/{}, /*num_outputs=*/group.size()));
+    batched->i_(Symbol::attr("kind"), static_cast<int64_t>(kinds.at(key)));
+    batched->s_(Symbol::attr("name"), group[0]->kind().toQualString());
+    batched->s_(
+        Symbol::attr("schema"), canonicalSchemaString(group[0]->schema()));
+    for (size_t i = 0; i < group.size(); ++i) {
+      for (Value* input : group[i]->inputs()) {
+        batched->addInput(input);
+      }
+      batched->outputs()[i]->setType(group[i]->output()->type());
+      group[i]->output()->replaceAllUsesWith(batched->outputs()[i]);
+    }
+    // NB: the replaced ops are cleaned up by DCE.
+    return true;
+  }
+  return false;
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -478,5 +899,18 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   PeepholeOptimize(graph);
 }
 
+void BatchIndependentOps(std::shared_ptr<Graph>& graph) {
+  if (hasMutableOperators(graph->block())) {
+    return;
+  }
+  while (true) {
+    AliasDb alias_db(graph);
+    if (!BatchIndependentOps(graph->block(), alias_db)) {
+      break;
+    }
+  }
+  EliminateDeadCode(graph);
+}
+
 } // namespace jit
 } // namespace torch
@@ -7,5 +7,10 @@ namespace jit {
 
 TORCH_API void BatchMM(std::shared_ptr<Graph>& graph);
 
+// Merges the independent ops of the same kind and the same shapes in each
+// block, e.g. those of the towers of a model, into batched ops. Not run by
+// the graph executors by default.
+TORCH_API void BatchIndependentOps(std::shared_ptr<Graph>& graph);
+
 }
 } // namespace torch
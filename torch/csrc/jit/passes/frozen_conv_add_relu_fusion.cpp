@@ -0,0 +1,89 @@
+#include <torch/csrc/jit/passes/frozen_conv_add_relu_fusion.h>
+
+#include <ATen/detail/CUDAHooksInterface.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/fuse_relu.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// A conv2d of the pattern whose weight is a constant 4-d CUDA tensor, and
+// whose bias is None or a constant tensor, that cuDNN can run with its
+// epilogue.
+bool isFrozenCudnnConv2d(
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const auto& match_vmap = match.values_map;
+  auto weight = toIValue(match_vmap.at(vmap.at("weight")));
+  if (!weight || !weight->isTensor()) {
+    return false;
+  }
+  const at::Tensor& w = weight->toTensor();
+  if (!w.defined() || !w.is_cuda() || w.dim() != 4 ||
+      !(w.scalar_type() == at::kFloat || w.scalar_type() == at::kHalf ||
+        w.scalar_type() == at::kDouble)) {
+    return false;
+  }
+  auto bias = toIValue(match_vmap.at(vmap.at("bias")));
+  if (!bias ||
+      !(bias->isNone() ||
+        (bias->isTensor() && bias->toTensor().is_cuda() &&
+         bias->toTensor().scalar_type() == w.scalar_type()))) {
+    return false;
+  }
+  return true;
+}
+
+void fuseFrozenConvAddReluImpl(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter rewriter;
+
+  // The chains with an add come first, so that their conv2d + relu suffix is
+  // not matched on its own.
+  std::string conv_add_relu_fused = R"(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups, %z, %alpha):
+        %res = aten::cudnn_convolution_add_relu(%input, %weight, %z, %alpha, %bias, %stride, %padding, %dilation, %groups)
+        return (%res))";
+  for (const auto* add : {"aten::add", "aten::add_"}) {
+    for (const auto* relu : {"aten::relu", "aten::relu_"}) {
+      std::string conv_add_relu = std::string(R"(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups, %z, %alpha):
+        %conv_out = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        %add_out = )") + add + R"((%conv_out, %z, %alpha)
+        %res = )" + relu + R"((%add_out)
+        return (%res))";
+      rewriter.RegisterRewritePattern(conv_add_relu, conv_add_relu_fused);
+    }
+  }
+
+  std::string conv_relu_fused = R"(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups):
+        %res = aten::cudnn_convolution_relu(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        return (%res))";
+  for (const auto* relu : {"aten::relu", "aten::relu_"}) {
+    std::string conv_relu = std::string(R"(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups):
+        %conv_out = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        %res = )") + relu + R"((%conv_out)
+        return (%res))";
+    rewriter.RegisterRewritePattern(conv_relu, conv_relu_fused);
+  }
+
+  rewriter.runOnGraph(graph, isFrozenCudnnConv2d);
+}
+
+} // namespace
+
+void FuseFrozenConvAddRelu(std::shared_ptr<Graph>& graph) {
+  if (!at::detail::getCUDAHooks().compiledWithCuDNN()) {
+    return;
+  }
+  fuseFrozenConvAddReluImpl(graph);
+  FuseAddmmActivation(graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Rewrites the chains of conv2d, an optional residual add and relu of a frozen
+// graph whose conv2d weights are constant CUDA tensors into
+// aten::cudnn_convolution_relu and aten::cudnn_convolution_add_relu, which run
+// the bias, the add and the relu in the epilogue of the cuDNN convolution. The
+// addmm + relu chains of linear layers are rewritten into
+// aten::_addmm_activation as well.
+//
+// Does nothing when PyTorch was built without cuDNN.
+TORCH_API void FuseFrozenConvAddRelu(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,164 @@
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+
+#include <ATen/Config.h>
+#include <ATen/Context.h>
+#include <ATen/NativeFunctions.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+namespace torch {
+namespace jit {
+
+#if AT_MKLDNN_ENABLED()
+
+namespace {
+
+// A conv2d with a constant float weight and constant parameters, whose weight
+// can be reordered ahead of time. Its input must be a float CPU tensor, like
+// the weight.
+bool isFrozenConv2d(Node* n) {
+  if (!n->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+    return false;
+  }
+  auto weight = toIValue(n->namedInput(attr::weight));
+  if (!weight || !weight->isTensor()) {
+    return false;
+  }
+  const at::Tensor& w = weight->toTensor();
+  if (!w.defined() || w.is_mkldnn() || !w.device().is_cpu() ||
+      w.scalar_type() != at::kFloat || w.dim() != 4) {
+    return false;
+  }
+  auto bias = toIValue(n->namedInput(attr::bias));
+  if (!bias || !(bias->isNone() ||
+                 (bias->isTensor() && bias->toTensor().device().is_cpu() &&
+                  bias->toTensor().scalar_type() == at::kFloat))) {
+    return false;
+  }
+  return n->is_constant(attr::stride) && n->is_constant(attr::padding) &&
+      n->is_constant(attr::dilation) && n->is_constant(attr::groups);
+}
+
+// The ops that take mkldnn inputs to mkldnn outputs.
+bool isMkldnnOp(
+    Node* n,
+    const std::unordered_set<Value*>& mkldnn_values) {
+  auto is_mkldnn = [&](Value* v) { return mkldnn_values.count(v) > 0; };
+  if (n->matches("aten::relu(Tensor self) -> Tensor") ||
+      n->matches("aten::relu_(Tensor self) -> Tensor") ||
+      n->matches(
+          "aten::max_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor") ||
+      n->matches(
+          "aten::adaptive_avg_pool2d(Tensor self, int[] output_size) -> Tensor")) {
+    return is_mkldnn(n->input(0));
+  }
+  if (n->matches(
+          "aten::avg_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad, int? divisor_override) -> Tensor")) {
+    // mkldnn pooling takes no divisor
+    auto divisor_override = toIValue(n->namedInput(attr::divisor_override));
+    return is_mkldnn(n->input(0)) && divisor_override &&
+        divisor_override->isNone();
+  }
+  if (n->matches(
+          "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor")) {
+    return is_mkldnn(n->input(0)) && is_mkldnn(n->input(1));
+  }
+  return false;
+}
+
+// Whether a value can be an mkldnn tensor: the ops that write to it must see
+// it directly, so only an in-place op that is its only use may.
+bool canBeMkldnn(Value* v, const AliasDb& aliasDb) {
+  for (const Use& use : v->uses()) {
+    if (aliasDb.writesToAlias(use.user, {v}) &&
+        !(use.user->kind() == Symbol::aten("relu_") && v->uses().size() == 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {
+  if (!at::globalContext().userEnabledMkldnn()) {
+    return;
+  }
+  AliasDb aliasDb(graph);
+  std::unordered_set<Value*> mkldnn_values;
+  std::unordered_set<Node*> mkldnn_nodes;
+  std::vector<Node*> convs;
+  for (Node* n : graph->block()->nodes()) {
+    const bool is_conv = isFrozenConv2d(n);
+    if ((is_conv || isMkldnnOp(n, mkldnn_values)) &&
+        canBeMkldnn(n->output(), aliasDb)) {
+      mkldnn_values.insert(n->output());
+      mkldnn_nodes.insert(n);
+      if (is_conv) {
+        convs.push_back(n);
+      }
+    }
+  }
+  if (convs.empty()) {
+    return;
+  }
+
+  // reorder the weights, and convert the dense inputs of the chains
+  std::unordered_map<Value*, Value*> to_mkldnn;
+  for (Node* n : convs) {
+    const at::Tensor weight = toIValue(n->namedInput(attr::weight))->toTensor();
+    auto stride = toIValue(n->namedInput(attr::stride))->toIntVector();
+    auto padding = toIValue(n->namedInput(attr::padding))->toIntVector();
+    auto dilation = toIValue(n->namedInput(attr::dilation))->toIntVector();
+    auto groups = toIValue(n->namedInput(attr::groups))->toInt();
+    at::Tensor mkldnn_weight = at::native::mkldnn_reorder_conv2d_weight(
+        weight.to_mkldnn(), padding, stride, dilation, groups);
+    // insertConstant bails on opaque tensors
+    Node* weight_node = graph->create(prim::Constant);
+    weight_node->output()->inferTypeFrom(mkldnn_weight);
+    weight_node->t_(attr::value, std::move(mkldnn_weight));
+    weight_node->insertBefore(n);
+    n->replaceInput(1, weight_node->output());
+
+    Value* input = n->input(0);
+    if (!mkldnn_values.count(input)) {
+      auto it = to_mkldnn.find(input);
+      if (it == to_mkldnn.end()) {
+        WithInsertPoint guard(n);
+        Value* converted = graph->insert(Symbol::aten("to_mkldnn"), {input});
+        it = to_mkldnn.emplace(input, converted).first;
+      }
+      n->replaceInput(0, it->second);
+    }
+  }
+
+  // convert the outputs of the chains that leave them
+  for (Value* v : mkldnn_values) {
+    std::vector<Use> dense_uses;
+    for (const Use& use : v->uses()) {
+      if (!mkldnn_nodes.count(use.user)) {
+        dense_uses.push_back(use);
+      }
+    }
+    if (dense_uses.empty()) {
+      continue;
+    }
+    WithInsertPoint guard(v->node()->next());
+    Value* dense = graph->insert(Symbol::aten("to_dense"), {v});
+    for (const Use& use : dense_uses) {
+      use.user->replaceInput(use.offset, dense);
+    }
+  }
+  EliminateDeadCode(graph);
+}
+
+#else
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {}
+
+#endif
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Runs the chains of conv2d, relu, pooling and add of a frozen graph on mkldnn
+// tensors, with the conv2d weights reordered to mkldnn's blocked layout once,
+// and converts to and from dense tensors only at the boundaries of the chains.
+//
+// The reordered weights are opaque constants, so the graph can be run but not
+// saved afterwards.
+TORCH_API void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
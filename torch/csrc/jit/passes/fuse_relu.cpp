@@ -56,8 +56,44 @@ void fuseAddReluImpl(std::shared_ptr<Graph>& graph) {
   // This is because inplace mutation of the testor done by add_ will be lost if
   // inplace mutatation of the same tensor actually does add+relu
 }
+
+void fuseAddmmActivationImpl(std::shared_ptr<Graph>& graph) {
+  SubgraphRewriter rewriter;
+
+  std::string addmm_relu_fused = R"(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %use_gelu : bool = prim::Constant[value=0]()
+        %res = aten::_addmm_activation(%self, %mat1, %mat2, %beta, %alpha, %use_gelu)
+        return (%res))";
+  for (const auto* relu : {"aten::relu", "aten::relu_"}) {
+    std::string addmm_relu = std::string(R"(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %addmm_res = aten::addmm(%self, %mat1, %mat2, %beta, %alpha)
+        %res = )") + relu + R"((%addmm_res)
+        return (%res))";
+    rewriter.RegisterRewritePattern(addmm_relu, addmm_relu_fused);
+  }
+
+  std::string addmm_gelu = R"(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %addmm_res = aten::addmm(%self, %mat1, %mat2, %beta, %alpha)
+        %res = aten::gelu(%addmm_res)
+        return (%res))";
+  std::string addmm_gelu_fused = R"(
+    graph(%self, %mat1, %mat2, %beta, %alpha):
+        %use_gelu : bool = prim::Constant[value=1]()
+        %res = aten::_addmm_activation(%self, %mat1, %mat2, %beta, %alpha, %use_gelu)
+        return (%res))";
+  rewriter.RegisterRewritePattern(addmm_gelu, addmm_gelu_fused);
+
+  rewriter.runOnGraph(graph);
+}
 } // namespace
 
+void FuseAddmmActivation(std::shared_ptr<Graph>& graph) {
+  fuseAddmmActivationImpl(graph);
+}
+
 void FuseAddRelu(script::Module& module) {
   auto graph = module.get_method("forward").graph();
   fuseAddReluImpl(graph);
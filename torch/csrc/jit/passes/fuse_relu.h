@@ -7,5 +7,9 @@ namespace torch {
 namespace jit {
 TORCH_API void FuseAddRelu(script::Module& module);
 TORCH_API void FuseAddRelu(std::shared_ptr<Graph>& graph);
+// Rewrites aten::addmm followed by aten::relu or aten::gelu into
+// aten::_addmm_activation, which applies the activation in the GEMM epilogue
+// where the backend supports that.
+TORCH_API void FuseAddmmActivation(std::shared_ptr<Graph>& graph);
 } // namespace jit
 } // namespace torch
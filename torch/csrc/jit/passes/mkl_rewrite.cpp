@@ -0,0 +1,99 @@
+#include <ATen/core/jit_type.h>
+#include <ATen/native/mkl/LinearPrePack.h>
+
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/fold_conv_bn.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/mkl_rewrite.h>
+#include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/remove_dropout.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+void insertPrePackedLinearOp(std::shared_ptr<Graph>& graph) {
+  // fuse decomposed linear into aten::linear
+  FuseLinear(graph);
+
+  std::string linear_before_inline = R"(
+    graph(%linear, %input, %weight, %bias):
+        %r = prim::CallFunction(%linear, %input, %weight, %bias)
+        return (%r))";
+  std::string prepacked_ops_pattern_before_inline = R"(
+    graph(%linear, %input, %weight, %bias):
+        %packed_weight_bias = mkl_prepack::linear_prepack(%weight, %bias)
+        %res = mkl_prepack::linear_run(%input, %packed_weight_bias)
+        return (%res))";
+  std::string linear_pattern = R"(
+    graph(%input, %weight, %bias):
+        %r = aten::linear(%input, %weight, %bias)
+        return (%r))";
+  std::string prepacked_ops_pattern = R"(
+    graph(%input, %weight, %bias):
+        %packed_weight_bias = mkl_prepack::linear_prepack(%weight, %bias)
+        %res = mkl_prepack::linear_run(%input, %packed_weight_bias)
+        return (%res))";
+
+  auto filter = [](const Match& match,
+                   const std::unordered_map<std::string, Value*>& vmap) {
+    const auto& match_vmap = match.values_map;
+    auto linear_value = match_vmap.at(vmap.at("linear"));
+    auto func_name = graph_rewrite_helper::getFuncName(linear_value);
+    return func_name == "linear";
+  };
+
+  SubgraphRewriter linear_call_fn_rewriter;
+  linear_call_fn_rewriter.RegisterRewritePattern(
+      linear_before_inline, prepacked_ops_pattern_before_inline);
+  linear_call_fn_rewriter.runOnGraph(graph, filter);
+
+  SubgraphRewriter linear_rewriter;
+  linear_rewriter.RegisterRewritePattern(linear_pattern, prepacked_ops_pattern);
+  linear_rewriter.runOnGraph(graph);
+}
+
+} // namespace
+
+void mklInsertPrePackedOps(std::shared_ptr<Graph>& graph) {
+  insertPrePackedLinearOp(graph);
+}
+
+void mklInsertPrePackedOps(script::Module& module) {
+  for (auto& method : module.get_methods()) {
+    auto graph = method.graph();
+    mklInsertPrePackedOps(graph);
+  }
+  for (script::Module m : module.children()) {
+    mklInsertPrePackedOps(m);
+  }
+}
+
+void mklFoldPrePackingOps(script::Module& m) {
+  PrePackingOpsFilterFn filter_fn = [](const Node* n) -> bool {
+    return (
+        n->kind() == Symbol::fromQualString("mkl_prepack::linear_prepack"));
+  };
+  PrePackingOpsFolder(m, filter_fn, "prepack_folding");
+}
+
+script::Module mklOptimizeForInference(
+    const script::Module& m,
+    const std::vector<std::string>& preserved_methods) {
+  auto cloned_module = m.clone();
+  cloned_module.eval();
+  cloned_module = FoldConvBatchNorm(cloned_module);
+  mklInsertPrePackedOps(cloned_module);
+  cloned_module = freeze_module(cloned_module, preserved_methods);
+  mklFoldPrePackingOps(cloned_module);
+  removeDropout(cloned_module);
+  return cloned_module;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+TORCH_API void mklInsertPrePackedOps(std::shared_ptr<Graph>& graph);
+TORCH_API void mklInsertPrePackedOps(script::Module& module);
+TORCH_API void mklFoldPrePackingOps(script::Module& module);
+TORCH_API script::Module mklOptimizeForInference(
+    const script::Module& module,
+    const std::vector<std::string>& preserved_methods = {});
+} // namespace jit
+} // namespace torch
@@ -39,6 +39,17 @@ using graph_rewrite_helper::PatternInfo;
 using graph_rewrite_helper::replaceConvolutionWithAtenConv;
 
 // helper functions
+// filter for the conv - add patterns: the conv output must only feed the
+// add, since it is no longer quantized on its own, and the other operand
+// must be a Tensor, conv - add_scalar being left to quantized::add_scalar
+bool is_fusable_conv_add(
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const auto& match_vmap = match.values_map;
+  return match_vmap.at(vmap.at("first_output"))->uses().size() == 1 &&
+      !isScalar(match_vmap.at(vmap.at("accum")));
+}
+
 void fillQConfigMap(
     const Module& module,
     const QConfigDict& qconfig_dict,
@@ -695,6 +706,24 @@ graph(%self, %input, %conv):
     return (%second_output) )",
       {is_conv3d_module});
 
+  // the conv output is only observed after the add, and after the relu
+  // following it if there is one, see quantized::conv2d_add
+  const PatternInfo nn_conv2d_add = PatternInfo::parse_from_str(
+      R"(
+graph(%self, %input, %conv, %accum, %alpha):
+    %first_output = prim::CallMethod[name="forward"](%conv, %input)
+    %second_output = aten::add(%first_output, %accum, %alpha)
+    return (%second_output) )",
+      {is_conv2d_module, aten_add_alpha_is_one, is_fusable_conv_add});
+
+  const PatternInfo nn_conv2d_inplace_add = PatternInfo::parse_from_str(
+      R"(
+graph(%self, %input, %conv, %accum, %alpha):
+    %first_output = prim::CallMethod[name="forward"](%conv, %input)
+    %second_output = aten::add_(%first_output, %accum, %alpha)
+    return (%second_output) )",
+      {is_conv2d_module, aten_add_alpha_is_one, is_fusable_conv_add});
+
   const PatternInfo add_nn_relu = PatternInfo::parse_from_str(
       R"(
 graph(%self, %a, %b, %alpha, %relu):
@@ -886,6 +915,7 @@ graph(%self, %a, %b):
           nn_conv2d_aten_relu,   nn_conv2d_aten_relu_,
           nn_conv3d_f_relu,      nn_conv3d_nn_relu,
           nn_conv3d_aten_relu,   nn_conv3d_aten_relu_,
+          nn_conv2d_add,         nn_conv2d_inplace_add,
 
           add_nn_relu,           add_f_relu,
           inplace_add_nn_relu,   inplace_add_f_relu,
@@ -1289,8 +1319,9 @@ void InsertObserversHelper::recordObserved(
     std::unordered_map<Value*, Module>& values_to_observe,
     std::unordered_set<Value*>& block_observed_values) {
   Value* to_observe = v;
-  if (delay_observation_map_.count(v)) {
-    to_observe = delay_observation_map_.at(v);
+  // delayed observations can chain, e.g. conv - add - relu
+  while (delay_observation_map_.count(to_observe)) {
+    to_observe = delay_observation_map_.at(to_observe);
   }
   values_to_observe[to_observe] = observer_module;
   block_observed_values.insert(to_observe);
@@ -363,6 +363,42 @@ graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %pad
         %r_quant = quantized::conv2d_relu(%a_quant, %packed_params, %r_scale, %r_zero_point)
         return (%r_quant) )";
 
+  // aten::conv2d - aten::add(_) (- aten::relu(_)), where the conv output is
+  // the first operand of the add; the residual connection of ResNet style
+  // blocks. The observer of the conv output has been moved to the output of
+  // the pattern, so the conv output is a float value here.
+  auto conv2d_add_pattern = [](const std::string& add_op,
+                               const std::string& relu_op) {
+    const std::string relu_line =
+        relu_op.empty() ? "" : "        %r = " + relu_op + "(%add_out)\n";
+    const std::string r = relu_op.empty() ? "%add_out" : "%r";
+    return R"(
+graph(%a_quant, %accum_quant, %alpha, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %add_out = )" +
+        add_op + R"((%conv_out, %accum_dequant, %alpha)
+)" + relu_line +
+        "        %r_quant = aten::quantize_per_tensor(" + r +
+        R"(, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+  };
+
+  // quantized::conv2d_add
+  std::string quantized_conv2d_add = R"(
+graph(%a_quant, %accum_quant, %alpha, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %r_quant = quantized::conv2d_add(%a_quant, %accum_quant, %packed_params, %r_scale, %r_zero_point)
+        return (%r_quant) )";
+
+  // quantized::conv2d_add_relu
+  std::string quantized_conv2d_add_relu = R"(
+graph(%a_quant, %accum_quant, %alpha, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %r_quant = quantized::conv2d_add_relu(%a_quant, %accum_quant, %packed_params, %r_scale, %r_zero_point)
+        return (%r_quant) )";
+
   // aten::conv3d
   std::string conv3d = R"(
 graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
@@ -880,6 +916,32 @@ graph(%a_quant, %alpha, %scale, %input_scale, %r_scale, %r_zero_point, %r_dtype)
       {"quantized::conv1d", conv1d, quantized_conv1d},
       {"quantized::conv1d_relu", conv1d_relu, quantized_conv1d_relu},
       {"quantized::conv1d_relu", conv1d_inplace_relu, quantized_conv1d_relu},
+      // conv2d - add patterns need to come before conv2d ones, which would
+      // otherwise match the conv alone
+      {"quantized::conv2d_add",
+       conv2d_add_pattern("aten::add", ""),
+       quantized_conv2d_add,
+       {aten_add_alpha_is_one}},
+      {"quantized::conv2d_add",
+       conv2d_add_pattern("aten::add_", ""),
+       quantized_conv2d_add,
+       {aten_add_alpha_is_one}},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_pattern("aten::add", "aten::relu"),
+       quantized_conv2d_add_relu,
+       {aten_add_alpha_is_one}},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_pattern("aten::add", "aten::relu_"),
+       quantized_conv2d_add_relu,
+       {aten_add_alpha_is_one}},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_pattern("aten::add_", "aten::relu"),
+       quantized_conv2d_add_relu,
+       {aten_add_alpha_is_one}},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_pattern("aten::add_", "aten::relu_"),
+       quantized_conv2d_add_relu,
+       {aten_add_alpha_is_one}},
       {"quantized::conv2d", conv2d, quantized_conv2d},
       {"quantized::conv2d_relu", conv2d_relu, quantized_conv2d_relu},
       {"quantized::conv2d_relu", conv2d_inplace_relu, quantized_conv2d_relu},
@@ -20,6 +20,10 @@ struct MutationRemover {
     RemoveTensorMutation(graph_->block());
   }
 
+  void functionalizeTensorMutation() {
+    FunctionalizeTensorMutation(graph_->block());
+  }
+
  private:
   bool newMemoryLocation(Value* v) {
     // bail on nodes with side effects, blocks, or graph / graph inputs
@@ -100,6 +104,55 @@ struct MutationRemover {
     return getAllOperatorsFor(Symbol::fromQualString(new_schema)).size() != 0;
   }
 
+  // Inserts the functional equivalent of the in-place op `n` before it.
+  Node* createFunctionalNode(Node* n) {
+    if (isSpecialMappedOp(n)) {
+      return createSpecialMappedOp(n);
+    }
+    auto schema_name = n->schema().name();
+    auto new_schema = schema_name.substr(0, schema_name.size() - 1);
+    Node* new_node = graph_->create(Symbol::fromQualString(new_schema), 1);
+    new_node->copyMetadata(n);
+    new_node->insertBefore(n);
+    for (Value* input : n->inputs()) {
+      new_node->addInput(input);
+    }
+    new_node->output()->setType(n->output()->type());
+    return new_node;
+  }
+
+  // Does `n`, or anything nested in it, use a value other than `v` itself
+  // that may alias (or contain an alias of) `v` as it is mutated by
+  // `mutating_op`? Values that `mutating_op`'s block defines after it can
+  // only alias `v` through uses of `v` or of such earlier aliases, so they
+  // don't need to be looked at.
+  bool usesOtherAlias(Node* n, Value* v, Node* mutating_op) {
+    for (Value* input : n->inputs()) {
+      if (input == v || input == mutating_op->output()) {
+        continue;
+      }
+      Node* def = input->node();
+      if (def->owningBlock() == mutating_op->owningBlock() &&
+          def->isAfter(mutating_op)) {
+        continue;
+      }
+      if (aliasDb_->mayContainAlias(input, v)) {
+        return true;
+      }
+    }
+    for (Block* block : n->blocks()) {
+      for (Node* node : block->nodes()) {
+        if (usesOtherAlias(node, v, mutating_op)) {
+          return true;
+        }
+      }
+      if (usesOtherAlias(block->return_node(), v, mutating_op)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   bool listAppendFollowingListConstruct(Node* n) {
     return n->kind() == aten::append &&
         n->inputs().at(0)->node()->kind() == prim::ListConstruct;
@@ -190,6 +243,91 @@ struct MutationRemover {
     }
   }
 
+  void FunctionalizeTensorMutation(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      auto* node = *it;
+      it++;
+
+      // copy_ has no functional variant, and it is what we insert below
+      if (node->kind() == aten::copy_ || !inplaceOpVariant(node)) {
+        continue;
+      }
+
+      // Only the in-place op itself and later uses of the mutated value may
+      // touch its memory. Everything that reads it after the op then does so
+      // through uses of `mutated_value` that we can redirect.
+      Value* mutated_value = node->inputs().at(0);
+      if (!mutated_value->type()->isSubtypeOf(TensorType::get())) {
+        continue;
+      }
+      bool other_alias_used = false;
+      for (Node* n = node->next(); n != nullptr; n = n->next()) {
+        if (usesOtherAlias(n, mutated_value, node)) {
+          other_alias_used = true;
+          break;
+        }
+        if (n == block->return_node()) {
+          break;
+        }
+      }
+      if (other_alias_used) {
+        continue;
+      }
+
+      Node* new_node = createFunctionalNode(node);
+      auto new_schema = new_node->maybeSchema();
+      if (!new_schema || new_schema->returns().size() != 1 ||
+          new_schema->returns().at(0).alias_info()) {
+        // e.g. t_ -> t, the result would still alias the mutated value
+        new_node->destroy();
+        continue;
+      }
+
+      // If the memory is visible outside of the graph (graph inputs,
+      // attributes, views of those), write the final value back once at the
+      // end instead of on every in-place op.
+      bool needs_copy_back =
+          aliasDb_->mayContainAlias(graph_->inputs(), mutated_value);
+
+      mutated_value->replaceAllUsesAfterNodeWith(node, new_node->output());
+      node->output()->replaceAllUsesWith(new_node->output());
+
+      // We rewrite something like:
+      // x = self.x
+      // x.add_(1)
+      // y = x * 2
+      // return x
+      // to:
+      // x = self.x
+      // x0 = x.add(1)
+      // y = x0 * 2
+      // x.copy_(x0)
+      // return x
+      // x0 is a fresh value, so later in-place ops on it are functionalized
+      // the same way, and will redirect the copy back to their result.
+      if (needs_copy_back) {
+        Node* return_node = graph_->return_node();
+        {
+          WithInsertPoint guard(return_node);
+          graph_->insert(aten::copy_, {mutated_value, new_node->output()});
+        }
+        // the graph still returns the (now updated) input itself
+        for (size_t i = 0; i < return_node->inputs().size(); ++i) {
+          if (return_node->inputs().at(i) == new_node->output()) {
+            return_node->replaceInput(i, mutated_value);
+          }
+        }
+      }
+
+      node->destroy();
+
+      // The write index of the later in-place ops on the mutated value still
+      // refers to its old memory, and the copy back is a new write, so the
+      // alias db can't be patched up incrementally here.
+      aliasDb_ = torch::make_unique<AliasDb>(graph_);
+    }
+  }
+
   void RemoveTensorMutation(Block* block) {
     for (auto it = block->nodes().begin(); it != block->nodes().end();) {
       auto* node = *it;
@@ -210,20 +348,7 @@ struct MutationRemover {
         continue;
       }
 
-      Node* new_node;
-      if (isSpecialMappedOp(node)) {
-        new_node = createSpecialMappedOp(node);
-      } else {
-        auto schema_name = node->schema().name();
-        auto new_schema = schema_name.substr(0, schema_name.size() - 1);
-        new_node = graph_->create(Symbol::fromQualString(new_schema), 1);
-        new_node->copyMetadata(node);
-        new_node->insertBefore(node);
-        for (Value* input : node->inputs()) {
-          new_node->addInput(input);
-        }
-        new_node->output()->setType(node->output()->type());
-      }
+      Node* new_node = createFunctionalNode(node);
 
       mutated_value->replaceAllUsesAfterNodeWith(node, new_node->output());
       node->output()->replaceAllUsesWith(new_node->output());
@@ -273,5 +398,12 @@ void RemoveTensorMutation(const std::shared_ptr<Graph>& graph) {
   mr.removeTensorMutation();
 }
 
+void FunctionalizeTensorMutation(const std::shared_ptr<Graph>& graph) {
+  MutationRemover mr(graph);
+  mr.functionalizeTensorMutation();
+  // in-place ops nested in blocks
+  mr.removeTensorMutation();
+}
+
 } // namespace jit
 } // namespace torch
@@ -15,5 +15,12 @@ TORCH_API void RemoveListMutation(const std::shared_ptr<Graph>& graph);
 // Removes list mutation with functional equivalents
 TORCH_API void RemoveTensorMutation(const std::shared_ptr<Graph>& graph);
 
+// Like RemoveTensorMutation, but also rewrites in-place ops on values that
+// aren't fresh allocations (graph inputs, attributes, their views) and on
+// values that were used before being mutated. This is done whenever nothing
+// but the mutated value itself is used after the in-place op; memory that is
+// visible outside of the graph is written back with a single copy_ at its end.
+TORCH_API void FunctionalizeTensorMutation(const std::shared_ptr<Graph>& graph);
+
 } // namespace jit
 } // namespace torch
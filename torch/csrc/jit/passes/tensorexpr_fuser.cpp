@@ -14,6 +14,70 @@ namespace torch {
 namespace jit {
 
 namespace tensorexpr {
+
+static bool isReductionKind(Node* node) {
+  switch (node->kind()) {
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Reductions are fused if everything that determines the shape of their
+// result is a constant. Only floating point inputs are supported, since
+// integer sums would have to be promoted to long.
+static bool isSupportedReduction(Node* node) {
+  static const OperatorSet reductions{
+      "aten::sum(Tensor self, *, ScalarType? dtype=None) -> Tensor",
+      "aten::sum.dim_IntList(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+      "aten::mean(Tensor self, *, ScalarType? dtype=None) -> Tensor",
+      "aten::mean.dim(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+      "aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+      "aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+      "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enable=True) -> Tensor",
+  };
+  if (!node->isMemberOf(reductions)) {
+    return false;
+  }
+
+  auto tt = node->input(0)->type()->cast<TensorType>();
+  if (!tt || !tt->scalarType() ||
+      (*tt->scalarType() != at::kFloat && *tt->scalarType() != at::kDouble)) {
+    return false;
+  }
+  for (size_t i = 1; i < node->inputs().size(); i++) {
+    auto input = node->input(i);
+    if (auto it = input->type()->cast<TensorType>()) {
+      // The weight and bias of layer_norm.
+      if (it->scalarType() != tt->scalarType()) {
+        return false;
+      }
+    } else if (input->node()->kind() != prim::Constant) {
+      return false;
+    }
+  }
+  if (node->kind() != aten::layer_norm &&
+      !toIValue(node->namedInput(attr::dtype))->isNone()) {
+    return false;
+  }
+
+  // On CUDA, every block reduces the rows of one index of dimension 0, so
+  // dimension 0 has to stay as it is.
+  auto ot = node->output()->type()->cast<TensorType>();
+  if (tt->device() && tt->device()->is_cuda()) {
+    if (!ot || !ot->dim() || !tt->dim() || *ot->dim() != *tt->dim() ||
+        *ot->dim() == 0 || ot->sizes()[0] != tt->sizes()[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool isSupported(Node* node) {
   // TODO:
   switch (node->kind()) {
@@ -82,6 +146,12 @@ bool isSupported(Node* node) {
     case aten::__rshift__:
     case aten::where:
       return true;
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return isSupportedReduction(node);
     // Operators that can be both elementwise or reductions:
     case aten::min:
     case aten::max:
@@ -188,6 +258,49 @@ bool canHandle(Node* node, AliasDb& aliasDb) {
   return tensorexpr::isSupported(node);
 }
 
+// On CUDA, kernels with reductions compute one index of dimension 0 of all
+// their outputs per block (see TensorExprKernel::scheduleRowsForCuda), so all
+// tensors in them need the same rank and size of dimension 0.
+bool hasCompatibleRowsForCuda(Node* consumer, Node* producer) {
+  std::vector<Node*> nodes;
+  for (Node* n : {consumer, producer}) {
+    if (n->kind() == getTensorExprSymbol()) {
+      for (Node* inner : n->g(attr::Subgraph)->nodes()) {
+        nodes.push_back(inner);
+      }
+    } else {
+      nodes.push_back(n);
+    }
+  }
+  if (std::none_of(nodes.begin(), nodes.end(), tensorexpr::isReductionKind)) {
+    return true;
+  }
+
+  c10::optional<std::vector<int64_t>> rows;
+  for (Node* n : nodes) {
+    for (Value* output : n->outputs()) {
+      auto tt = output->type()->cast<TensorType>();
+      if (!tt) {
+        continue;
+      }
+      if (!tt->device() || !tt->device()->is_cuda()) {
+        return true;
+      }
+      auto sizes = tt->sizes().concrete_sizes();
+      if (!sizes || sizes->empty()) {
+        return false;
+      }
+      if (!rows) {
+        rows = std::vector<int64_t>{(int64_t)sizes->size(), (*sizes)[0]};
+      } else if (
+          (int64_t)sizes->size() != (*rows)[0] || (*sizes)[0] != (*rows)[1]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 #define REQ(cond)                           \
   if (!(cond)) {                            \
     GRAPH_DEBUG("Failed cond " #cond "\n"); \
@@ -212,6 +325,8 @@ bool canMerge(Node* consumer, Node* producer, AliasDb& aliasDb) {
   // Alias checks
   REQ(aliasDb.couldMoveBeforeTopologically(producer, consumer));
 
+  REQ(hasCompatibleRowsForCuda(consumer, producer));
+
   // Ops that return aliases can only be folded if this is the only use.
   if (producer->kind() == aten::slice || producer->kind() == aten::unsqueeze ||
       producer->kind() == prim::ConstantChunk) {
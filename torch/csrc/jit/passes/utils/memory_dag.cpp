@@ -51,8 +51,8 @@ bool MemoryDAG::mayAlias(const Element* a, const Element* b) const {
 }
 
 bool MemoryDAG::mayAliasImpl(const Element* a, const Element* b) const {
-  const auto aMemLoc = getMemoryLocations(a);
-  const auto bMemLoc = getMemoryLocations(b);
+  const auto& aMemLoc = getMemoryLocations(a);
+  const auto& bMemLoc = getMemoryLocations(b);
 
   return aMemLoc.intersects(bMemLoc);
 }
@@ -73,6 +73,10 @@ void MemoryDAG::collectAllContainedMemoryLocations(
   if (cont.test(compIdx)) {
     return;
   }
+  if (elem->cachedAllContainedMemoryLocations_) {
+    cont |= *elem->cachedAllContainedMemoryLocations_;
+    return;
+  }
   cont.set(compIdx);
 
   for (const auto& mem_loc : getMemoryLocations(elem)) {
@@ -84,14 +88,19 @@ void MemoryDAG::collectAllContainedMemoryLocations(
   }
 }
 
-bool MemoryDAG::mayContainAliasImpl(const Element* a, const Element* b) const {
-  MemoryLocations all_a_mlocs;
-  MemoryLocations all_b_mlocs;
-
-  collectAllContainedMemoryLocations(a, all_a_mlocs);
-  collectAllContainedMemoryLocations(b, all_b_mlocs);
+const MemoryLocations& MemoryDAG::getAllContainedMemoryLocations(
+    const Element* elem) const {
+  if (!elem->cachedAllContainedMemoryLocations_) {
+    MemoryLocations cont;
+    collectAllContainedMemoryLocations(elem, cont);
+    elem->cachedAllContainedMemoryLocations_ = std::move(cont);
+  }
+  return *elem->cachedAllContainedMemoryLocations_;
+}
 
-  return all_a_mlocs.intersects(all_b_mlocs);
+bool MemoryDAG::mayContainAliasImpl(const Element* a, const Element* b) const {
+  return getAllContainedMemoryLocations(a).intersects(
+      getAllContainedMemoryLocations(b));
 }
 
 bool MemoryDAG::mayContainAlias(
@@ -103,15 +112,15 @@ bool MemoryDAG::mayContainAlias(
 
   MemoryLocations all_a_mlocs;
   for (const auto& elem : a) {
-    collectAllContainedMemoryLocations(elem, all_a_mlocs);
+    all_a_mlocs |= getAllContainedMemoryLocations(elem);
   }
 
-  MemoryLocations all_b_mlocs;
   for (const auto& elem : b) {
-    collectAllContainedMemoryLocations(elem, all_b_mlocs);
+    if (all_a_mlocs.intersects(getAllContainedMemoryLocations(elem))) {
+      return true;
+    }
   }
-
-  return all_a_mlocs.intersects(all_b_mlocs);
+  return false;
 }
 
 void MemoryDAGBuilder::makePointerTo(Element* from, Element* to) {
@@ -187,6 +196,9 @@ void MemoryDAG::setWildcards(
   // For every element, if the cache contains `MemoryLocationFoo`, then we must
   // add `WildcardBar` to it.
   for (const std::unique_ptr<Element>& e : this->indexToElementMap_) {
+    // The new pointers may be reachable from anything, so don't try to patch
+    // these up; they are cheap to recompute on demand.
+    e->cachedAllContainedMemoryLocations_ = c10::nullopt;
     if (e->values.empty()) {
       // This element is a wildcard element, we can skip it.
       TORCH_INTERNAL_ASSERT(e->pointsTo.empty());
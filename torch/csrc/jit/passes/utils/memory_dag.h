@@ -94,6 +94,10 @@ class TORCH_API MemoryDAG {
   void collectAllContainedMemoryLocations(
       const Element* elem,
       MemoryLocations& cont) const;
+  // Everything `elem` may point to, recursively including what its contained
+  // elements may point to.
+  const MemoryLocations& getAllContainedMemoryLocations(
+      const Element* elem) const;
 
   /**
    * The following methods are special cases where we need to reach mutate the
@@ -151,6 +155,8 @@ struct Element {
   // A nullopt means that this cache is not yet populated. Since `MemoryDAG` is
   // immutable, this cache should never need to be invalidated.
   mutable c10::optional<MemoryLocations> cachedMemoryLocations_;
+  // Same for `getAllContainedMemoryLocations`. `setWildcards` resets it.
+  mutable c10::optional<MemoryLocations> cachedAllContainedMemoryLocations_;
 };
 
 } // namespace jit
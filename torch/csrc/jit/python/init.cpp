@@ -2,11 +2,13 @@
 
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/backends/backend_init.h>
+#include <torch/csrc/jit/codegen/disk_cache.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/frontend/tracer.h>
 #include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_graph_fuser_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
@@ -20,12 +22,15 @@
 #include <torch/csrc/jit/passes/erase_number_types.h>
 #include <torch/csrc/jit/passes/fold_conv_bn.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/frozen_conv_add_relu_fusion.h>
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/fuse_relu.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
+#include <torch/csrc/jit/passes/mkl_rewrite.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
 #include <torch/csrc/jit/passes/normalize_ops.h>
@@ -72,6 +77,7 @@
 #include <torch/csrc/jit/runtime/jit_exception.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/csrc/jit/runtime/print_handler.h>
+#include <torch/csrc/jit/runtime/static/init.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
@@ -254,6 +260,9 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_fuse_add_relu",
           [](std::shared_ptr<Graph>& graph) { FuseAddRelu(graph); })
+      .def(
+          "_jit_pass_fuse_addmm_activation",
+          [](std::shared_ptr<Graph>& graph) { FuseAddmmActivation(graph); })
       .def("_jit_pass_dedup_module_uses", &DedupModuleUses)
       .def("_jit_pass_replicate_dequantize", &ReplicateDeQuant)
       .def(
@@ -295,6 +304,7 @@ void initJITBindings(PyObject* module) {
           "_jit_pass_remove_inplace_ops",
           [](std::shared_ptr<Graph> g) { return RemoveInplaceOps(g); })
       .def("_jit_pass_constant_pooling", ConstantPooling)
+      .def("_jit_pass_batch_independent_ops", BatchIndependentOps)
       .def(
           "_jit_pass_create_functional_graphs",
           [](std::shared_ptr<Graph>& g) { return CreateFunctionalGraphs(g); })
@@ -304,6 +314,12 @@ void initJITBindings(PyObject* module) {
             RemoveListMutation(g);
             return RemoveTensorMutation(g);
           })
+      .def(
+          "_jit_pass_functionalize",
+          [](std::shared_ptr<Graph>& g) {
+            RemoveListMutation(g);
+            return FunctionalizeTensorMutation(g);
+          })
       .def(
           "_jit_pass_inline_functional_graphs",
           [](std::shared_ptr<Graph>& g) { return InlineFunctionalGraphs(g); })
@@ -465,6 +481,48 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def(
+          "_jit_set_num_specialized_plans",
+          [](size_t num) {
+            size_t old_num = getNumSpecializedPlans();
+            getNumSpecializedPlans() = num;
+            return old_num;
+          })
+      .def(
+          "_jit_set_parallel_tensor_loading",
+          [](bool enabled) {
+            bool oldState = getParallelTensorLoading();
+            getParallelTensorLoading() = enabled;
+            return oldState;
+          })
+      .def(
+          "_jit_set_tensor_record_sharing",
+          [](bool enabled) {
+            bool oldState = getTensorRecordSharing();
+            getTensorRecordSharing() = enabled;
+            return oldState;
+          })
+      .def("_jit_shared_tensor_record_bytes", &sharedTensorRecordBytes)
+      .def(
+          "_set_default_chunked_compression",
+          [](bool enabled,
+             size_t chunk_size,
+             int level,
+             size_t min_record_size) {
+            if (!enabled) {
+              caffe2::serialize::setDefaultChunkedCompression(c10::nullopt);
+              return;
+            }
+            caffe2::serialize::ChunkedCompressionOptions options;
+            options.chunk_size = chunk_size;
+            options.level = level;
+            options.min_record_size = min_record_size;
+            caffe2::serialize::setDefaultChunkedCompression(options);
+          },
+          py::arg("enabled"),
+          py::arg("chunk_size") = 4 << 20,
+          py::arg("level") = 1,
+          py::arg("min_record_size") = 1 << 20)
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { getInlineEverythingMode() = enabled; })
@@ -524,6 +582,36 @@ void initJITBindings(PyObject* module) {
             using namespace torch::jit::tensorexpr;
             return getTECudaPointwiseBlockSize() = block_size;
           })
+      .def(
+          "_jit_get_te_symbolic_batch_dim",
+          []() -> bool {
+            using namespace torch::jit::tensorexpr;
+            return getTESymbolicBatchDim();
+          })
+      .def(
+          "_jit_set_te_symbolic_batch_dim",
+          [](bool enabled) {
+            using namespace torch::jit::tensorexpr;
+            return getTESymbolicBatchDim() = enabled;
+          })
+      .def(
+          "_jit_get_te_kernel_cache_size",
+          []() -> int {
+            using namespace torch::jit::tensorexpr;
+            return getTEKernelCacheSize();
+          })
+      .def(
+          "_jit_set_te_kernel_cache_size",
+          [](int size) {
+            using namespace torch::jit::tensorexpr;
+            return getTEKernelCacheSize() = size;
+          })
+      .def("_jit_get_kernel_disk_cache_path", &getKernelDiskCacheDirectory)
+      .def("_jit_set_kernel_disk_cache_path", &setKernelDiskCacheDirectory)
+      .def(
+          "_jit_get_kernel_disk_cache_max_bytes", &getKernelDiskCacheMaxBytes)
+      .def(
+          "_jit_set_kernel_disk_cache_max_bytes", &setKernelDiskCacheMaxBytes)
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
       .def("_jit_texpr_fuser_enabled", &tensorExprFuserEnabled)
       .def("_jit_texpr_fallback_allowed", &tensorexpr::fallbackAllowed)
@@ -588,6 +676,29 @@ void initJITBindings(PyObject* module) {
           [](script::Module& module) {
             return vulkanOptimizeForMobile(module);
           })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn",
+          [](std::shared_ptr<Graph>& g) { return ConvertFrozenOpsToMKLDNN(g); })
+      .def(
+          "_jit_pass_fuse_frozen_conv_add_relu",
+          [](std::shared_ptr<Graph>& g) { return FuseFrozenConvAddRelu(g); })
+      .def(
+          "_jit_pass_mkl_insert_prepacked_ops",
+          [](std::shared_ptr<Graph>& graph) {
+            return mklInsertPrePackedOps(graph);
+          })
+      .def(
+          "_jit_pass_mkl_insert_prepacked_ops",
+          [](script::Module& module) { return mklInsertPrePackedOps(module); })
+      .def(
+          "_jit_pass_mkl_fold_prepacking_ops",
+          [](script::Module& module) { return mklFoldPrePackingOps(module); })
+      .def(
+          "_jit_pass_mkl_optimize_for_inference",
+          [](script::Module& module,
+             std::vector<std::string>& preserved_methods) {
+            return mklOptimizeForInference(module, preserved_methods);
+          })
       .def(
           "_jit_pass_onnx_unpack_quantized_weights",
           [](std::shared_ptr<Graph>& graph,
@@ -690,10 +801,13 @@ void initJITBindings(PyObject* module) {
       .def_property_readonly(
           "fallback", [](GraphExecutorState& s) { return s.fallback; });
 
+  // Writes release the GIL, so that torch.save_async does not hold up the
+  // training thread while it writes.
   py::class_<PyTorchStreamWriter>(m, "PyTorchFileWriter")
       .def(py::init<std::string>())
       .def(py::init([](const py::object& buffer) {
         auto writer_func = [=](const void* data, size_t size) {
+          py::gil_scoped_acquire acquire;
           auto bytes = py::bytes(reinterpret_cast<const char*>(data), size);
           buffer.attr("write")(std::move(bytes));
           return size;
@@ -706,8 +820,12 @@ void initJITBindings(PyObject* module) {
           [](PyTorchStreamWriter& self,
              const std::string& name,
              const char* data,
-             size_t size) { return self.writeRecord(name, data, size); })
-      .def("write_end_of_file", &PyTorchStreamWriter::writeEndOfFile)
+             size_t size) { return self.writeRecord(name, data, size); },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "write_end_of_file",
+          &PyTorchStreamWriter::writeEndOfFile,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "write_record",
           [](PyTorchStreamWriter& self,
@@ -716,7 +834,8 @@ void initJITBindings(PyObject* module) {
              size_t size) {
             return self.writeRecord(
                 name, reinterpret_cast<const char*>(data), size);
-          });
+          },
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<MobileOptimizerType>(m, "MobileOptimizerType")
       .value("CONV_BN_FUSION", MobileOptimizerType::CONV_BN_FUSION)
@@ -1080,6 +1199,7 @@ void initJITBindings(PyObject* module) {
   initTreeViewBindings(module);
   initJitScriptBindings(module);
   initJitBackendBindings(module);
+  initStaticRuntimeBindings(module);
 
   setPrintHandler([](const std::string& str) {
     py::gil_scoped_acquire acquire;
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <ATen/ThreadLocalState.h>
+#include <ATen/core/function.h>
 #include <ATen/core/ivalue.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
@@ -65,7 +66,12 @@ struct TORCH_API Code {
 };
 
 struct InterpreterState {
-  TORCH_API InterpreterState(const Code& code);
+  // The forks of the code, and the continuations of its waits when it
+  // suspends, run through taskLauncher, which the interpreters of the forks
+  // inherit.
+  TORCH_API InterpreterState(
+      const Code& code,
+      TaskLauncher taskLauncher = at::launch);
   TORCH_API void run(Stack& stack);
   c10::intrusive_ptr<Future> runAsync(Stack& stack);
   c10::intrusive_ptr<Future> getFuture();
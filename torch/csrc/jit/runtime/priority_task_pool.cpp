@@ -0,0 +1,75 @@
+#include <torch/csrc/jit/runtime/priority_task_pool.h>
+
+#include <ATen/ThreadLocalState.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Logging.h>
+#include <c10/util/thread_name.h>
+
+namespace torch {
+namespace jit {
+
+PriorityTaskPool::PriorityTaskPool(size_t numThreads) {
+  TORCH_CHECK(numThreads > 0, "PriorityTaskPool needs at least one thread");
+  threads_.reserve(numThreads);
+  for (size_t i = 0; i < numThreads; ++i) {
+    threads_.emplace_back([this]() {
+      c10::setThreadName("pt_jit_tasks");
+      mainLoop();
+    });
+  }
+}
+
+PriorityTaskPool::~PriorityTaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void PriorityTaskPool::run(std::function<void()> fn, int64_t priority) {
+  auto task = [fn = std::move(fn),
+               tls_state = at::ThreadLocalState()]() mutable {
+    at::ThreadLocalStateGuard guard(tls_state);
+    fn();
+  };
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push(Task{priority, nextSequence_++, std::move(task)});
+  }
+  cv_.notify_one();
+}
+
+TaskLauncher PriorityTaskPool::launcher(int64_t priority) {
+  return [this, priority](std::function<void()> fn) {
+    run(std::move(fn), priority);
+  };
+}
+
+void PriorityTaskPool::mainLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return !running_ || !tasks_.empty(); });
+    // The pending tasks still run when the pool is destroyed, since the
+    // futures of their runs would never complete otherwise.
+    if (tasks_.empty()) {
+      return;
+    }
+    // top() is const, but the task is popped right away.
+    auto fn = std::move(const_cast<Task&>(tasks_.top()).fn);
+    tasks_.pop();
+    lock.unlock();
+    try {
+      fn();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Exception in a PriorityTaskPool task: " << e.what();
+    }
+    lock.lock();
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <ATen/core/function.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch {
+namespace jit {
+
+// A pool of threads dedicated to the asynchronous runs of TorchScript
+// functions, e.g. the requests of a server. It runs the tasks of the runs,
+// their forks and the continuations of their waits, in the order of their
+// priorities, and in the order they were launched for the same priority.
+//
+// Since a wait suspends the interpreter instead of blocking a thread (see
+// InterpreterStateImpl), the forks of latency-sensitive requests only queue
+// behind the tasks of other requests of at least the same priority:
+//
+//   PriorityTaskPool pool(4);
+//   auto future = fn.runAsync(stack, pool.launcher(/*priority=*/1));
+//
+// The pool must outlive the runs that use its launchers.
+class TORCH_API PriorityTaskPool {
+ public:
+  explicit PriorityTaskPool(size_t numThreads);
+  // Runs the pending tasks, and joins the threads.
+  ~PriorityTaskPool();
+
+  PriorityTaskPool(const PriorityTaskPool&) = delete;
+  PriorityTaskPool& operator=(const PriorityTaskPool&) = delete;
+
+  // The tasks with higher priorities run first. The thread local state of
+  // the caller is propagated to the task, as by at::launch().
+  void run(std::function<void()> fn, int64_t priority = 0);
+
+  // A launcher that runs all its tasks with the given priority, for
+  // Function::runAsync(). The forks of the run inherit it.
+  TaskLauncher launcher(int64_t priority = 0);
+
+  size_t size() const {
+    return threads_.size();
+  }
+
+ private:
+  struct Task {
+    int64_t priority;
+    // breaks the ties between the tasks of the same priority, first in first
+    // out
+    uint64_t sequence;
+    std::function<void()> fn;
+  };
+
+  struct RunsAfter {
+    bool operator()(const Task& a, const Task& b) const {
+      return a.priority < b.priority ||
+          (a.priority == b.priority && a.sequence > b.sequence);
+    }
+  };
+
+  void mainLoop();
+
+  std::priority_queue<Task, std::vector<Task>, RunsAfter> tasks_;
+  uint64_t nextSequence_ = 0;
+  bool running_ = true;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -49,6 +49,7 @@ static std::atomic<bool> profiling_mode{false};
 
 static std::atomic<size_t> num_profiled_runs{1};
 static std::atomic<size_t> bailout_depth{1};
+static std::atomic<size_t> num_specialized_plans{1};
 
 std::atomic<bool>& getProfilingMode() {
   return profiling_mode;
@@ -65,6 +66,10 @@ std::atomic<size_t>& getBailoutDepth() {
   return bailout_depth;
 }
 
+std::atomic<size_t>& getNumSpecializedPlans() {
+  return num_specialized_plans;
+}
+
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
     if (n->kind() == prim::BailOut) {
@@ -362,14 +367,50 @@ ProfilingGraphExecutorImpl::ProfilingGraphExecutorImpl(
     std::string function_name)
     : GraphExecutorImplBase(graph, std::move(function_name)) {}
 
+std::vector<TensorTypePtr> ProfilingGraphExecutorImpl::profiledInputTypes(
+    const std::shared_ptr<Graph>& profiled_graph) {
+  std::vector<TensorTypePtr> input_types;
+  for (Value* i : profiled_graph->inputs()) {
+    TensorTypePtr input_type;
+    for (const Use& u : i->uses()) {
+      if (u.user->kind() == prim::profile) {
+        input_type = u.user->output()->type()->cast<TensorType>();
+        break;
+      }
+    }
+    input_types.push_back(std::move(input_type));
+  }
+  return input_types;
+}
+
+bool ProfilingGraphExecutorImpl::matchesInputs(
+    const SpecializedPlan& sp,
+    const Stack& stack) {
+  auto inputs = last(stack, sp.input_types.size());
+  for (size_t i = 0; i < inputs.size(); i++) {
+    const auto& input_type = sp.input_types[i];
+    if (input_type && inputs[i].isTensor() &&
+        !input_type->matchTensor(inputs[i].toTensor())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     Stack& stack,
     size_t remaining_bailout_depth) {
   std::lock_guard<std::mutex> lock(compile_mutex);
   GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
 
-  if (optimized_plan_) {
-    return *optimized_plan_;
+  // with a single plan, the guards in the plan take care of the inputs
+  // it wasn't profiled with
+  const size_t max_plans = std::max<size_t>(getNumSpecializedPlans(), 1);
+  for (auto it = optimized_plans_.begin(); it != optimized_plans_.end(); ++it) {
+    if (max_plans == 1 || matchesInputs(*it, stack)) {
+      optimized_plans_.splice(optimized_plans_.begin(), optimized_plans_, it);
+      return optimized_plans_.front().plan;
+    }
   }
 
   // simple executor
@@ -377,8 +418,10 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
     GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
-    optimized_plan_ = ExecutionPlan(copy, function_name_);
-    return *optimized_plan_;
+    optimized_plans_.clear();
+    optimized_plans_.emplace_front(
+        std::vector<TensorTypePtr>{}, ExecutionPlan(copy, function_name_));
+    return optimized_plans_.front().plan;
   }
 
   // if a profiling graph hasn't been created yet
@@ -401,17 +444,26 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
   }
 
   auto copy = pr_->graph()->copy();
+  auto input_types = profiledInputTypes(copy);
   runProfilingOptimizations(copy);
-  // cache
-  optimized_plan_ =
-      ExecutionPlan(copy, function_name_, remaining_bailout_depth);
-  return *optimized_plan_;
+  // cache, evicting the least recently used plans
+  optimized_plans_.emplace_front(
+      std::move(input_types),
+      ExecutionPlan(copy, function_name_, remaining_bailout_depth));
+  while (optimized_plans_.size() > max_plans) {
+    optimized_plans_.pop_back();
+  }
+  // the inputs that none of the plans match start a new profiling run
+  retired_profiling_records_.emplace_back(std::move(pr_));
+  profiling_plan_.reset();
+  return optimized_plans_.front().plan;
 }
 
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
   GraphExecutorState state;
-  TORCH_INTERNAL_ASSERT(optimized_plan_);
-  auto opt_plan = *optimized_plan_;
+  TORCH_INTERNAL_ASSERT(!optimized_plans_.empty());
+  // the most recently used plan
+  auto opt_plan = optimized_plans_.front().plan;
   state.execution_plans.emplace(ArgumentSpec{0, 0}, opt_plan);
   return state;
 }
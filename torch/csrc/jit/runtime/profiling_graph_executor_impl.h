@@ -1,6 +1,8 @@
 #pragma once
 #include <torch/csrc/jit/runtime/graph_executor_impl.h>
 
+#include <list>
+
 namespace torch {
 namespace jit {
 
@@ -17,10 +19,27 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
  private:
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
+
+  // a plan optimized for the types of the inputs it was profiled with
+  struct SpecializedPlan {
+    SpecializedPlan(std::vector<TensorTypePtr> input_types, ExecutionPlan plan)
+        : input_types(std::move(input_types)), plan(std::move(plan)) {}
+    // one per graph input, nullptr for the inputs that aren't checked
+    std::vector<TensorTypePtr> input_types;
+    ExecutionPlan plan;
+  };
+  static std::vector<TensorTypePtr> profiledInputTypes(
+      const std::shared_ptr<Graph>& profiled_graph);
+  static bool matchesInputs(const SpecializedPlan& sp, const Stack& stack);
+
   std::unique_ptr<ProfilingRecord> pr_;
   c10::optional<ExecutionPlan>
       profiling_plan_; // plan to run in order to profiling the code
-  c10::optional<ExecutionPlan> optimized_plan_;
+  // most recently used first, at most getNumSpecializedPlans() of them
+  std::list<SpecializedPlan> optimized_plans_;
+  // the profiling plans of the previous profiling runs may still be running
+  // on other threads, and their profiling nodes call back into these
+  std::vector<std::unique_ptr<ProfilingRecord>> retired_profiling_records_;
 };
 
 } // namespace jit
@@ -253,12 +253,12 @@ int64_t normalizeIndex(int64_t idx, int64_t list_size) {
   return idx;
 }
 
+// The ops that return the list they modify leave it where it is on the stack,
+// instead of popping it and pushing it back, which allocates (see pushList).
+
 void listAppend(Stack* stack) {
   IValue el = pop(stack).to<IValue>();
-  c10::List<IValue> list = pop(stack).to<c10::List<IValue>>();
-
-  list.push_back(std::move(el));
-  push(stack, std::move(list));
+  stack->back().toList().push_back(std::move(el));
 }
 
 void listReverse(Stack* stack) {
@@ -333,17 +333,13 @@ void listCopy(Stack* stack) {
 
 void listSelect(Stack* stack) {
   int64_t idx = pop(stack).to<int64_t>();
-  c10::List<IValue> list = pop(stack).to<c10::List<IValue>>();
-
-  auto element = getItem(list, idx);
-  push(stack, std::move(element));
+  IValue element = getItem(stack->back().toListRef(), idx);
+  stack->back() = std::move(element);
 }
 
 void listLen(Stack* stack) {
-  c10::List<IValue> a = pop(stack).to<c10::List<IValue>>();
-
-  const int64_t size = a.size();
-  push(stack, size);
+  const int64_t size = stack->back().toListRef().size();
+  stack->back() = size;
 }
 
 void listList(Stack* stack) {
@@ -352,44 +348,37 @@ void listList(Stack* stack) {
 }
 
 void listAdd(Stack* stack) {
-  c10::List<IValue> b = pop(stack).to<c10::List<IValue>>();
-  c10::List<IValue> a = pop(stack).to<c10::List<IValue>>();
+  IValue b = pop(stack);
+  IValue& a = stack->back();
 
-  c10::List<IValue> ret = make_result_list<IValue>(a.elementType());
-
-  if (a.use_count() == 1) {
-    ret = std::move(a);
-  } else {
-    ret = a.copy();
+  // a becomes the result if nothing else refers to it
+  if (a.use_count() != 1) {
+    a = a.toList().copy();
   }
-
-  ret.append(std::move(b));
-
-  push(stack, std::move(ret));
+  // b is passed as a temporary, so that its elements are moved if nothing
+  // else refers to it either
+  a.toList().append(std::move(b).toList());
 }
 
 void listInplaceAdd(Stack* stack) {
-  c10::List<IValue> b = pop(stack).to<List<IValue>>();
-  c10::List<IValue> a = pop(stack).to<List<IValue>>();
-  a.append(std::move(b));
-  push(stack, std::move(a));
+  IValue b = pop(stack);
+  stack->back().toList().append(std::move(b).toList());
 }
 
 void listMulIntLeftInPlace(Stack* stack) {
   int64_t n = pop(stack).to<int64_t>();
-  c10::List<IValue> list = pop(stack).to<c10::List<IValue>>();
+  c10::List<IValue> list = stack->back().toList();
   if (n <= 0) {
     list.clear();
   } else if (n > 1) {
     size_t list_size = list.size();
+    list.reserve(list_size * n);
     for (int64_t i = 1; i < n; i++) {
       for (size_t j = 0; j < list_size; j++) {
         list.push_back(list.get(j));
       }
     }
   }
-
-  push(stack, std::move(list));
 }
 
 void listMulIntLeft(Stack* stack) {
@@ -406,7 +395,7 @@ void listMulIntLeft(Stack* stack) {
     }
   }
 
-  push(stack, std::move(ret));
+  pushList(stack, ret);
 }
 
 void listMulIntRight(Stack* stack) {
@@ -423,7 +412,7 @@ void listMulIntRight(Stack* stack) {
     }
   }
 
-  push(stack, std::move(ret));
+  pushList(stack, ret);
 }
 
 void listSlice(Stack* stack) {
@@ -443,7 +432,7 @@ void listSlice(Stack* stack) {
   c10::List<IValue> sliced_list = make_result_list<IValue>(list.elementType());
   if (normalized_end <= normalized_start) {
     // early exit if the slice is trivially empty
-    push(stack, std::move(sliced_list));
+    pushList(stack, sliced_list);
     return;
   }
 
@@ -454,17 +443,13 @@ void listSlice(Stack* stack) {
     i += step;
   }
 
-  push(stack, std::move(sliced_list));
+  pushList(stack, sliced_list);
 }
 
 void listSetItem(Stack* stack) {
   IValue value = pop(stack).to<IValue>();
   int64_t idx = pop(stack).to<int64_t>();
-  c10::List<IValue> list = pop(stack).to<c10::List<IValue>>();
-
-  setItem(list, idx, std::move(value));
-
-  push(stack, std::move(list));
+  setItem(stack->back().toList(), idx, std::move(value));
 }
 } // namespace jit
 } // namespace torch
@@ -158,6 +158,24 @@ T getItem(const c10::List<T>& list, int64_t idx) {
   return list.get(normalized_idx);
 }
 
+// Equivalent to list.at(idx), for the elements of a list IValue, which can be
+// read without converting it to a c10::List
+inline const IValue& getItem(c10::ArrayRef<IValue> list, int64_t idx) {
+  const int64_t list_size = list.size();
+  const int64_t normalized_idx = normalizeIndex(idx, list_size);
+  if (normalized_idx < 0 || normalized_idx >= list_size) {
+    throw std::out_of_range("list index out of range");
+  }
+  return list[normalized_idx];
+}
+
+// Pushes a list onto the stack. Prefer this to push(stack, std::move(list)):
+// moving a c10::List allocates a new empty list to leave in its place, while
+// copying it only takes a reference.
+inline void pushList(Stack* stack, const c10::List<IValue>& list) {
+  stack->emplace_back(list);
+}
+
 template <typename T>
 void setItem(const c10::List<T>& list, int64_t idx, T&& value) {
   const int64_t list_size = list.size();
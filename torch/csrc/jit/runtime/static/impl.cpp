@@ -0,0 +1,255 @@
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+std::shared_ptr<Graph> PrepareForStaticRuntime(const Module& module) {
+  TORCH_CHECK(
+      !module.is_training(),
+      "StaticRuntime runs modules in eval mode, call eval() on the module "
+      "first");
+  auto frozen = freeze_module(module);
+  auto graph = frozen.get_method("forward").graph()->copy();
+  // freezing folds the attributes of the module into the graph, so the
+  // module input should not be used anymore
+  TORCH_CHECK(
+      graph->inputs().at(0)->uses().empty(),
+      "StaticRuntime requires a module whose forward only reads its "
+      "attributes");
+  graph->eraseInput(0);
+  PrepareForStaticRuntime(graph);
+  return graph;
+}
+
+void PrepareForStaticRuntime(std::shared_ptr<Graph>& graph) {
+  Inline(*graph);
+  ConstantPropagation(graph);
+  EliminateDeadCode(graph);
+  for (auto* input : graph->inputs()) {
+    TORCH_CHECK(
+        !input->type()->cast<ClassType>(),
+        "StaticRuntime does not support object inputs, but input ",
+        input->debugName(),
+        " has type ",
+        input->type()->str());
+  }
+  for (auto* node : graph->nodes()) {
+    TORCH_CHECK(
+        node->blocks().empty(),
+        "StaticRuntime does not support control flow, but the graph has a ",
+        node->kind().toQualString(),
+        " node");
+  }
+}
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<size_t> inputs,
+    std::vector<size_t> outputs)
+    : node_(node),
+      inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      out_variant_(getOutVariant(node)) {
+  if (!out_variant_) {
+    TORCH_CHECK(
+        node->maybeOperator(),
+        "StaticRuntime found no operator for ",
+        node->kind().toQualString());
+    op_ = node->getOperation();
+  }
+}
+
+void ProcessedNode::run(std::vector<c10::IValue>& registers, Stack& stack)
+    const {
+  if (out_variant_) {
+    out_variant_(*this, registers);
+    return;
+  }
+  stack.clear();
+  for (auto input : inputs_) {
+    stack.emplace_back(registers[input]);
+  }
+  op_(&stack);
+  TORCH_INTERNAL_ASSERT(
+      stack.size() == outputs_.size(),
+      node_->kind().toQualString(),
+      " returned ",
+      stack.size(),
+      " values, but the node has ",
+      outputs_.size(),
+      " outputs");
+  for (size_t i = 0; i < outputs_.size(); i++) {
+    registers[outputs_[i]] = std::move(stack[i]);
+  }
+}
+
+StaticRuntime::StaticRuntime(
+    const Module& module,
+    StaticRuntimeOptions options)
+    : graph_(PrepareForStaticRuntime(module)), options_(options) {
+  init();
+}
+
+StaticRuntime::StaticRuntime(
+    std::shared_ptr<Graph> graph,
+    StaticRuntimeOptions options)
+    : graph_(std::move(graph)), options_(options) {
+  PrepareForStaticRuntime(graph_);
+  init();
+}
+
+void StaticRuntime::init() {
+  std::unordered_map<const Value*, size_t> register_of;
+  auto add_register = [&](const Value* value) {
+    register_of[value] = registers_.size();
+    registers_.emplace_back();
+    return registers_.size() - 1;
+  };
+
+  for (auto* input : graph_->inputs()) {
+    input_regs_.push_back(add_register(input));
+  }
+  for (auto* node : graph_->nodes()) {
+    if (node->kind() == prim::Constant) {
+      auto reg = add_register(node->output());
+      registers_[reg] = toIValue(node->output()).value();
+      continue;
+    }
+    std::vector<size_t> inputs;
+    inputs.reserve(node->inputs().size());
+    for (auto* input : node->inputs()) {
+      inputs.push_back(register_of.at(input));
+    }
+    std::vector<size_t> outputs;
+    outputs.reserve(node->outputs().size());
+    for (auto* output : node->outputs()) {
+      outputs.push_back(add_register(output));
+    }
+    nodes_.emplace_back(node, std::move(inputs), std::move(outputs));
+  }
+  for (auto* output : graph_->outputs()) {
+    output_regs_.push_back(register_of.at(output));
+  }
+
+  // Out variants write into the tensors of the previous run. That must not
+  // change the outputs returned by that run, so registers that may alias an
+  // output start over with None.
+  AliasDb alias_db(graph_);
+  std::vector<Value*> planned;
+  std::vector<size_t> defined_at;
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    const auto& node = nodes_[i];
+    for (auto* output : node.node()->outputs()) {
+      if (alias_db.mayContainAlias(output, graph_->outputs())) {
+        unreused_regs_.push_back(register_of.at(output));
+      } else if (node.hasOutVariant()) {
+        planned.push_back(output);
+        defined_at.push_back(i);
+      }
+    }
+  }
+  if (!options_.plan_memory) {
+    return;
+  }
+
+  // A tensor lives until the last node that uses it or a value that may
+  // alias it, e.g. a view.
+  std::vector<MemoryPlanner::ManagedValue> managed;
+  managed.reserve(planned.size());
+  for (size_t k = 0; k < planned.size(); k++) {
+    size_t last = defined_at[k];
+    for (size_t i = defined_at[k] + 1; i < nodes_.size(); i++) {
+      for (auto* input : nodes_[i].node()->inputs()) {
+        if (alias_db.mayContainAlias(planned[k], input)) {
+          last = i;
+          break;
+        }
+      }
+    }
+    managed.push_back({register_of.at(planned[k]), defined_at[k], last});
+  }
+  planner_ = std::make_unique<MemoryPlanner>(std::move(managed));
+}
+
+c10::IValue StaticRuntime::run(std::vector<c10::IValue> inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_regs_.size(),
+      "StaticRuntime expected ",
+      input_regs_.size(),
+      " inputs, but got ",
+      inputs.size());
+  // the graph is for inference, and out variants do not support autograd
+  at::AutoGradMode no_grad(false);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    registers_[input_regs_[i]] = std::move(inputs[i]);
+  }
+  if (planner_) {
+    planner_->allocate(registers_);
+  }
+  for (const auto& node : nodes_) {
+    node.run(registers_, stack_);
+  }
+
+  std::vector<c10::IValue> outputs;
+  outputs.reserve(output_regs_.size());
+  for (auto reg : output_regs_) {
+    outputs.push_back(registers_[reg]);
+  }
+  for (auto reg : unreused_regs_) {
+    registers_[reg] = c10::IValue();
+  }
+  // do not keep the inputs alive until the next run
+  for (auto reg : input_regs_) {
+    registers_[reg] = c10::IValue();
+  }
+  stack_.clear();
+  if (planner_) {
+    planner_->deallocate(registers_);
+  }
+  if (outputs.size() == 1) {
+    return std::move(outputs[0]);
+  }
+  return c10::ivalue::Tuple::create(std::move(outputs));
+}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inputs) {
+  auto output = run(std::vector<c10::IValue>(inputs.begin(), inputs.end()));
+  if (output.isTensor()) {
+    return {output.toTensor()};
+  }
+  std::vector<at::Tensor> tensors;
+  if (output.isTuple()) {
+    for (const auto& element : output.toTuple()->elements()) {
+      tensors.push_back(element.toTensor());
+    }
+  } else {
+    tensors = output.toTensorVector();
+  }
+  return tensors;
+}
+
+size_t StaticRuntime::numOutVariantNodes() const {
+  size_t count = 0;
+  for (const auto& node : nodes_) {
+    count += node.hasOutVariant();
+  }
+  return count;
+}
+
+size_t StaticRuntime::plannedArenaBytes() const {
+  return planner_ ? planner_->arenaBytes() : 0;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/core/stack.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/static/memory_planner.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// A node of a StaticRuntime graph, whose inputs and outputs are slots in the
+// runtime's register file.
+class TORCH_API ProcessedNode {
+ public:
+  using OutVariant =
+      std::function<void(const ProcessedNode&, std::vector<c10::IValue>&)>;
+
+  ProcessedNode(
+      Node* node,
+      std::vector<size_t> inputs,
+      std::vector<size_t> outputs);
+
+  // `stack` is scratch space for nodes that run their Operation.
+  void run(std::vector<c10::IValue>& registers, Stack& stack) const;
+
+  Node* node() const {
+    return node_;
+  }
+
+  bool hasOutVariant() const {
+    return static_cast<bool>(out_variant_);
+  }
+
+  const c10::IValue& input(size_t i, const std::vector<c10::IValue>& registers)
+      const {
+    return registers[inputs_[i]];
+  }
+
+  c10::IValue& output(size_t i, std::vector<c10::IValue>& registers) const {
+    return registers[outputs_[i]];
+  }
+
+ private:
+  Node* node_;
+  std::vector<size_t> inputs_;
+  std::vector<size_t> outputs_;
+  OutVariant out_variant_;
+  Operation op_;
+};
+
+// Inlines and freezes `module`'s forward, and cleans up the graph for
+// StaticRuntime. `module` must be in eval mode.
+TORCH_API std::shared_ptr<Graph> PrepareForStaticRuntime(const Module& module);
+
+// Checks that `graph` can run on StaticRuntime, and optimizes it in place.
+TORCH_API void PrepareForStaticRuntime(std::shared_ptr<Graph>& graph);
+
+struct TORCH_API StaticRuntimeOptions {
+  // Places intermediate tensors in one arena per run, see MemoryPlanner.
+  bool plan_memory = true;
+};
+
+// Runs frozen, shape-stable inference graphs with as little interpreter
+// overhead as possible. Everything the interpreter does per op at run time is
+// done once, when the runtime is created:
+//
+// - Every value of the graph gets a slot in a register file, and each node
+//   records the registers of its inputs and outputs. Constants are loaded into
+//   their registers up front.
+// - Nodes that have an out variant (see ops.h) call it directly, writing into
+//   the output tensor of the previous run. After the first run, intermediates
+//   are not allocated anymore, unless their shapes change. With
+//   plan_memory, they also share one arena that is allocated per run.
+// - The remaining nodes run their Operation on a stack of their own.
+//
+// The graph must not have control flow, and it must not take the module as
+// an input, which is what PrepareForStaticRuntime produces from a frozen
+// module. A StaticRuntime is not thread-safe; use one per thread.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(
+      const Module& module,
+      StaticRuntimeOptions options = StaticRuntimeOptions());
+  explicit StaticRuntime(
+      std::shared_ptr<Graph> graph,
+      StaticRuntimeOptions options = StaticRuntimeOptions());
+
+  // Runs the graph and returns its outputs; a graph with several outputs
+  // returns a tuple.
+  c10::IValue run(std::vector<c10::IValue> inputs);
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  // Number of nodes that call an out variant instead of their Operation.
+  size_t numOutVariantNodes() const;
+
+  // Bytes of the arena the next run allocates for intermediates, or 0
+  // without memory planning.
+  size_t plannedArenaBytes() const;
+
+ private:
+  void init();
+
+  std::shared_ptr<Graph> graph_;
+  StaticRuntimeOptions options_;
+  std::vector<c10::IValue> registers_;
+  std::vector<ProcessedNode> nodes_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // Registers that are cleared after each run, so that their tensors are
+  // never written to again: those that may alias an output of the graph.
+  std::vector<size_t> unreused_regs_;
+  Stack stack_;
+  std::unique_ptr<MemoryPlanner> planner_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,30 @@
+#include <torch/csrc/jit/runtime/static/init.h>
+
+#include <torch/csrc/jit/python/pybind_utils.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+void initStaticRuntimeBindings(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<StaticRuntime>(m, "StaticRuntime")
+      .def(
+          "run",
+          py::overload_cast<const std::vector<at::Tensor>&>(
+              &StaticRuntime::run),
+          py::call_guard<py::gil_scoped_release>())
+      .def("num_out_variant_nodes", &StaticRuntime::numOutVariantNodes)
+      .def_property_readonly("graph", &StaticRuntime::graph);
+  m.def(
+       "_jit_to_static_runtime",
+       [](const std::shared_ptr<Graph>& graph) {
+         return std::make_unique<StaticRuntime>(graph->copy());
+       })
+      .def("_jit_to_static_runtime", [](const Module& module) {
+        return std::make_unique<StaticRuntime>(module);
+      });
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <torch/csrc/jit/python/pybind.h>
+
+namespace torch {
+namespace jit {
+// Initialize Python bindings for StaticRuntime.
+void initStaticRuntimeBindings(PyObject* module);
+} // namespace jit
+} // namespace torch
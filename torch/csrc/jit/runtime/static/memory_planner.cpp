@@ -0,0 +1,117 @@
+#include <torch/csrc/jit/runtime/static/memory_planner.h>
+
+#include <c10/core/CPUAllocator.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+size_t alignedSize(size_t nbytes) {
+  return (nbytes + c10::gAlignment - 1) / c10::gAlignment * c10::gAlignment;
+}
+
+bool isManagedTensor(const c10::IValue& value) {
+  if (!value.isTensor()) {
+    return false;
+  }
+  const auto& tensor = value.toTensor();
+  return tensor.defined() && tensor.has_storage() &&
+      tensor.device().is_cpu() && tensor.layout() == at::kStrided;
+}
+
+} // namespace
+
+MemoryPlanner::MemoryPlanner(std::vector<ManagedValue> values) {
+  slices_.reserve(values.size());
+  for (const auto& value : values) {
+    Slice slice;
+    slice.value = value;
+    slices_.push_back(slice);
+  }
+}
+
+void MemoryPlanner::allocate(std::vector<c10::IValue>& registers) {
+  if (arena_bytes_ == 0) {
+    return;
+  }
+  arena_ = c10::GetCPUAllocator()->allocate(arena_bytes_);
+  auto* base = static_cast<char*>(arena_.get());
+  for (const auto& slice : slices_) {
+    const auto& value = registers[slice.value.reg];
+    if (slice.nbytes == 0 || !isManagedTensor(value)) {
+      continue;
+    }
+    auto storage = value.toTensor().storage();
+    // not owning, the arena is released after the run
+    storage.set_data_ptr(at::DataPtr(base + slice.offset, at::kCPU));
+    storage.set_nbytes(slice.nbytes);
+  }
+}
+
+void MemoryPlanner::deallocate(std::vector<c10::IValue>& registers) {
+  bool changed = false;
+  for (auto& slice : slices_) {
+    const auto& value = registers[slice.value.reg];
+    if (!isManagedTensor(value)) {
+      continue;
+    }
+    auto storage = value.toTensor().storage();
+    if (storage.nbytes() > slice.nbytes) {
+      slice.nbytes = storage.nbytes();
+      changed = true;
+    }
+    // frees the storage if the run allocated it, i.e. on the first run or
+    // when the tensor outgrew its slice
+    storage.set_data_ptr(at::DataPtr(nullptr, at::kCPU));
+    storage.set_nbytes(0);
+  }
+  arena_.clear();
+  if (changed) {
+    plan();
+  }
+}
+
+void MemoryPlanner::plan() {
+  // Greedy by size: each slice goes to the lowest offset that does not
+  // overlap a slice placed before it whose value is alive at the same time.
+  std::vector<Slice*> order;
+  order.reserve(slices_.size());
+  for (auto& slice : slices_) {
+    if (slice.nbytes > 0) {
+      order.push_back(&slice);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [](Slice* a, Slice* b) {
+    return a->nbytes > b->nbytes;
+  });
+
+  arena_bytes_ = 0;
+  std::vector<Slice*> placed;
+  for (auto* slice : order) {
+    std::vector<std::pair<size_t, size_t>> taken;
+    for (auto* other : placed) {
+      if (other->value.last < slice->value.first ||
+          slice->value.last < other->value.first) {
+        continue;
+      }
+      taken.emplace_back(other->offset, other->offset + alignedSize(other->nbytes));
+    }
+    std::sort(taken.begin(), taken.end());
+    size_t offset = 0;
+    for (const auto& range : taken) {
+      if (offset + slice->nbytes <= range.first) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    slice->offset = offset;
+    placed.push_back(slice);
+    arena_bytes_ = std::max(arena_bytes_, offset + alignedSize(slice->nbytes));
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <c10/core/Allocator.h>
+
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// Places the intermediate tensors of a StaticRuntime in one arena per run.
+//
+// Each managed value lives in a register from the node that produces it
+// (`first`) until the last node that uses it or an alias of it (`last`).
+// Values whose lifetimes do not overlap share bytes of the arena. The sizes
+// are learned from the previous run: before a run, allocate() allocates the
+// arena and points the storage of every managed tensor at its slice, and the
+// out variants then compute into it without calling the allocator. After the
+// run, deallocate() records the storage sizes, which grow if a tensor was
+// resized beyond its slice, and releases the storages and the arena. The
+// first run, which creates the tensors, is the one that profiles them.
+//
+// Only CPU tensors are managed, tensors on other devices keep their own
+// storage.
+class TORCH_API MemoryPlanner {
+ public:
+  struct ManagedValue {
+    size_t reg;
+    size_t first;
+    size_t last;
+  };
+
+  explicit MemoryPlanner(std::vector<ManagedValue> values);
+
+  void allocate(std::vector<c10::IValue>& registers);
+  void deallocate(std::vector<c10::IValue>& registers);
+
+  // Size of the arena the next run allocates.
+  size_t arenaBytes() const {
+    return arena_bytes_;
+  }
+
+ private:
+  struct Slice {
+    ManagedValue value;
+    size_t nbytes = 0;
+    size_t offset = 0;
+  };
+
+  // Assigns the offsets of the slices and computes arena_bytes_.
+  void plan();
+
+  std::vector<Slice> slices_;
+  size_t arena_bytes_ = 0;
+  at::DataPtr arena_;
+};
+
+} // namespace jit
+} // namespace torch
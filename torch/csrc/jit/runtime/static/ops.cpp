@@ -0,0 +1,347 @@
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <ATen/ATen.h>
+#include <ATen/native/layer_norm.h>
+#include <torch/csrc/jit/frontend/function_schema_parser.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using OutVariant = ProcessedNode::OutVariant;
+
+// Returns the tensor in `out` if the result can be written into it, or an
+// undefined tensor if the op has to create its output.
+at::Tensor reusableOutput(
+    c10::IValue& out,
+    const at::Tensor& self,
+    at::ScalarType dtype) {
+  if (!out.isTensor() || self.layout() != at::kStrided ||
+      self.is_quantized()) {
+    return at::Tensor();
+  }
+  auto tensor = out.toTensor();
+  if (tensor.scalar_type() != dtype || tensor.device() != self.device() ||
+      tensor.layout() != at::kStrided) {
+    return at::Tensor();
+  }
+  return tensor;
+}
+
+// Out variant of an op that takes tensors `self` and `other` and scalar
+// arguments after them. `fn` computes a new output, `out_fn` writes into one.
+template <typename Fn, typename OutFn>
+OutVariant binaryOutVariant(Fn fn, OutFn out_fn) {
+  return [fn, out_fn](
+             const ProcessedNode& p, std::vector<c10::IValue>& registers) {
+    const auto& self = p.input(0, registers).toTensor();
+    const auto& other = p.input(1, registers).toTensor();
+    auto& out = p.output(0, registers);
+    auto tensor = reusableOutput(out, self, at::result_type(self, other));
+    if (tensor.defined()) {
+      out_fn(tensor, self, other, p, registers);
+    } else {
+      out = fn(self, other, p, registers);
+    }
+  };
+}
+
+template <typename Fn, typename OutFn>
+OutVariant unaryOutVariant(Fn fn, OutFn out_fn) {
+  return [fn, out_fn](
+             const ProcessedNode& p, std::vector<c10::IValue>& registers) {
+    const auto& self = p.input(0, registers).toTensor();
+    auto& out = p.output(0, registers);
+    // the output of an op that promotes integral inputs to floating point
+    // is never reused, which is only slower.
+    auto tensor = reusableOutput(out, self, self.scalar_type());
+    if (tensor.defined()) {
+      out_fn(tensor, self);
+    } else {
+      out = fn(self);
+    }
+  };
+}
+
+at::Tensor toOptionalTensor(const c10::IValue& value) {
+  return value.isNone() ? at::Tensor() : value.toTensor();
+}
+
+c10::optional<at::Scalar> toOptionalScalar(const c10::IValue& value) {
+  if (value.isNone()) {
+    return c10::nullopt;
+  }
+  return value.toScalar();
+}
+
+struct OutVariantEntry {
+  const char* schema;
+  std::function<OutVariant(Node*)> create;
+};
+
+const std::vector<OutVariantEntry>& outVariants() {
+  using Registers = std::vector<c10::IValue>;
+  static const std::vector<OutVariantEntry> entries = {
+      {"aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       [](Node*) {
+         return binaryOutVariant(
+             [](const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode& p,
+                const Registers& r) {
+               return at::add(self, other, p.input(2, r).toScalar());
+             },
+             [](at::Tensor& out,
+                const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode& p,
+                const Registers& r) {
+               at::add_out(out, self, other, p.input(2, r).toScalar());
+             });
+       }},
+      {"aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       [](Node*) {
+         return binaryOutVariant(
+             [](const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode& p,
+                const Registers& r) {
+               return at::sub(self, other, p.input(2, r).toScalar());
+             },
+             [](at::Tensor& out,
+                const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode& p,
+                const Registers& r) {
+               at::sub_out(out, self, other, p.input(2, r).toScalar());
+             });
+       }},
+      {"aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
+       [](Node*) {
+         return binaryOutVariant(
+             [](const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode&,
+                const Registers&) { return at::mul(self, other); },
+             [](at::Tensor& out,
+                const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode&,
+                const Registers&) { at::mul_out(out, self, other); });
+       }},
+      {"aten::div.Tensor(Tensor self, Tensor other) -> Tensor",
+       [](Node*) {
+         return binaryOutVariant(
+             [](const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode&,
+                const Registers&) { return at::div(self, other); },
+             [](at::Tensor& out,
+                const at::Tensor& self,
+                const at::Tensor& other,
+                const ProcessedNode&,
+                const Registers&) { at::div_out(out, self, other); });
+       }},
+      {"aten::mm(Tensor self, Tensor mat2) -> Tensor",
+       [](Node*) {
+         return binaryOutVariant(
+             [](const at::Tensor& self,
+                const at::Tensor& mat2,
+                const ProcessedNode&,
+                const Registers&) { return at::mm(self, mat2); },
+             [](at::Tensor& out,
+                const at::Tensor& self,
+                const at::Tensor& mat2,
+                const ProcessedNode&,
+                const Registers&) { at::mm_out(out, self, mat2); });
+       }},
+      {"aten::bmm(Tensor self, Tensor mat2) -> Tensor",
+       [](Node*) {
+         return binaryOutVariant(
+             [](const at::Tensor& self,
+                const at::Tensor& mat2,
+                const ProcessedNode&,
+                const Registers&) { return at::bmm(self, mat2); },
+             [](at::Tensor& out,
+                const at::Tensor& self,
+                const at::Tensor& mat2,
+                const ProcessedNode&,
+                const Registers&) { at::bmm_out(out, self, mat2); });
+       }},
+      {"aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+       [](Node*) -> OutVariant {
+         return [](const ProcessedNode& p, Registers& r) {
+           const auto& self = p.input(0, r).toTensor();
+           const auto& mat1 = p.input(1, r).toTensor();
+           const auto& mat2 = p.input(2, r).toTensor();
+           auto beta = p.input(3, r).toScalar();
+           auto alpha = p.input(4, r).toScalar();
+           auto& out = p.output(0, r);
+           auto tensor = reusableOutput(out, mat1, mat1.scalar_type());
+           if (tensor.defined()) {
+             at::addmm_out(tensor, self, mat1, mat2, beta, alpha);
+           } else {
+             out = at::addmm(self, mat1, mat2, beta, alpha);
+           }
+         };
+       }},
+      {"aten::relu(Tensor self) -> Tensor",
+       [](Node*) {
+         // relu is threshold(self, 0, 0), see native/Activation.cpp
+         return unaryOutVariant(
+             [](const at::Tensor& self) { return at::relu(self); },
+             [](at::Tensor& out, const at::Tensor& self) {
+               at::threshold_out(out, self, 0, 0);
+             });
+       }},
+      {"aten::sigmoid(Tensor self) -> Tensor",
+       [](Node*) {
+         return unaryOutVariant(
+             [](const at::Tensor& self) { return at::sigmoid(self); },
+             [](at::Tensor& out, const at::Tensor& self) {
+               at::sigmoid_out(out, self);
+             });
+       }},
+      {"aten::tanh(Tensor self) -> Tensor",
+       [](Node*) {
+         return unaryOutVariant(
+             [](const at::Tensor& self) { return at::tanh(self); },
+             [](at::Tensor& out, const at::Tensor& self) {
+               at::tanh_out(out, self);
+             });
+       }},
+      {"aten::gelu(Tensor self) -> Tensor",
+       [](Node*) {
+         return unaryOutVariant(
+             [](const at::Tensor& self) { return at::gelu(self); },
+             [](at::Tensor& out, const at::Tensor& self) {
+               at::gelu_out(out, self);
+             });
+       }},
+      {"aten::clamp(Tensor self, Scalar? min=None, Scalar? max=None) -> Tensor",
+       [](Node*) -> OutVariant {
+         return [](const ProcessedNode& p, Registers& r) {
+           const auto& self = p.input(0, r).toTensor();
+           auto min = toOptionalScalar(p.input(1, r));
+           auto max = toOptionalScalar(p.input(2, r));
+           auto& out = p.output(0, r);
+           auto tensor = reusableOutput(out, self, self.scalar_type());
+           if (tensor.defined()) {
+             at::clamp_out(tensor, self, min, max);
+           } else {
+             out = at::clamp(self, min, max);
+           }
+         };
+       }},
+      {"aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+       [](Node*) -> OutVariant {
+         return [](const ProcessedNode& p, Registers& r) {
+           const auto& self = p.input(0, r).toTensor();
+           auto dim = p.input(1, r).toInt();
+           const auto& dtype = p.input(2, r);
+           auto& out = p.output(0, r);
+           // _softmax.out only has a CPU kernel, and does not convert
+           at::Tensor tensor;
+           if (dtype.isNone() && self.device().is_cpu() &&
+               at::isFloatingType(self.scalar_type())) {
+             tensor = reusableOutput(out, self, self.scalar_type());
+           }
+           if (tensor.defined()) {
+             at::_softmax_out(tensor, self, dim, /*half_to_float=*/false);
+           } else if (dtype.isNone()) {
+             out = at::softmax(self, dim);
+           } else {
+             out = at::softmax(
+                 self, dim, static_cast<at::ScalarType>(dtype.toInt()));
+           }
+         };
+       }},
+      {"aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enable=True) -> Tensor",
+       [](Node*) -> OutVariant {
+         // mean and rstd are not outputs of the node, so they stay with it
+         auto stats = std::make_shared<std::pair<at::Tensor, at::Tensor>>();
+         return [stats](const ProcessedNode& p, Registers& r) {
+           const auto& input = p.input(0, r).toTensor();
+           auto normalized_shape = p.input(1, r).toIntVector();
+           auto weight = toOptionalTensor(p.input(2, r));
+           auto bias = toOptionalTensor(p.input(3, r));
+           auto eps = p.input(4, r).toDouble();
+           auto& out = p.output(0, r);
+           at::Tensor tensor;
+           if (input.device().is_cpu()) {
+             tensor = reusableOutput(out, input, input.scalar_type());
+           }
+           if (!tensor.defined()) {
+             out = at::layer_norm(input, normalized_shape, weight, bias, eps);
+             return;
+           }
+           auto inputs = at::native::_prepare_layer_norm_inputs(
+               input, normalized_shape, weight, bias);
+           const auto& X = std::get<0>(inputs);
+           if (!stats->first.defined() ||
+               stats->first.scalar_type() != X.scalar_type()) {
+             stats->first = at::empty({0}, X.options());
+             stats->second = at::empty({0}, X.options());
+           }
+           at::native::layer_norm_cpu_out(
+               tensor,
+               stats->first,
+               stats->second,
+               X,
+               std::get<1>(inputs),
+               std::get<2>(inputs),
+               std::get<3>(inputs),
+               std::get<4>(inputs),
+               eps);
+         };
+       }},
+      {"aten::cat(Tensor[] tensors, int dim=0) -> Tensor",
+       [](Node*) -> OutVariant {
+         return [](const ProcessedNode& p, Registers& r) {
+           auto tensors = p.input(0, r).toTensorVector();
+           auto dim = p.input(1, r).toInt();
+           auto& out = p.output(0, r);
+           at::Tensor tensor;
+           if (!tensors.empty()) {
+             tensor = reusableOutput(out, tensors[0], tensors[0].scalar_type());
+           }
+           if (tensor.defined()) {
+             at::cat_out(tensor, tensors, dim);
+           } else {
+             out = at::cat(tensors, dim);
+           }
+         };
+       }},
+  };
+  return entries;
+}
+
+} // namespace
+
+OutVariant getOutVariant(Node* node) {
+  static const auto by_kind = []() {
+    std::unordered_map<Symbol, std::vector<const OutVariantEntry*>> by_kind;
+    for (const auto& entry : outVariants()) {
+      auto schema = parseSchema(entry.schema);
+      by_kind[Symbol::fromQualString(schema.name())].push_back(&entry);
+    }
+    return by_kind;
+  }();
+
+  auto it = by_kind.find(node->kind());
+  if (it == by_kind.end()) {
+    return {};
+  }
+  for (const auto* entry : it->second) {
+    if (node->matches(entry->schema)) {
+      return entry->create(node);
+    }
+  }
+  return {};
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+// Returns the out variant StaticRuntime calls for `node`, or an empty function
+// if `node` has none. An out variant computes the node's outputs into the
+// tensors its output registers hold from the previous run, and creates them
+// if the registers are None or hold tensors of another dtype or device.
+TORCH_API ProcessedNode::OutVariant getOutVariant(Node* node);
+
+} // namespace jit
+} // namespace torch
@@ -40,14 +40,15 @@ void format(Stack& stack, size_t num_inputs) {
 }
 
 void listUnpack(Stack& stack, size_t num_outputs) {
-  auto list = pop(stack).toList();
+  auto list = pop(stack);
+  const auto elements = list.toListRef();
   TORCH_CHECK(
-      list.size() == num_outputs,
+      elements.size() == num_outputs,
       "Expected ",
       num_outputs,
       " elements in a list but found ",
-      list.size());
-  stack.insert(stack.end(), list.begin(), list.end());
+      elements.size());
+  stack.insert(stack.end(), elements.begin(), elements.end());
 }
 
 void tupleConstruct(Stack& stack, size_t num_inputs) {
@@ -76,7 +77,8 @@ void listConstruct(Stack& stack, at::ListTypePtr type, size_t num_inputs) {
     vals.emplace_back(std::move(stack[i]));
   }
   drop(stack, num_inputs);
-  push(stack, std::move(vals));
+  // Moving vals would allocate a new empty list for it
+  stack.emplace_back(vals);
 }
 
 void dictConstruct(Stack& stack, at::DictTypePtr type, size_t num_inputs) {
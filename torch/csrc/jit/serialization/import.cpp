@@ -16,20 +16,35 @@
 #include <caffe2/serialize/file_adapter.h>
 #include <caffe2/serialize/inline_container.h>
 #include <caffe2/serialize/istream_adapter.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace torch {
 namespace jit {
 
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -55,6 +70,254 @@ void postSetStateValidate(const IValue& v) {
   }
 }
 
+std::atomic<bool>& getParallelTensorLoading() {
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+std::atomic<bool>& getTensorRecordSharing() {
+  static std::atomic<bool> enabled{false};
+  return enabled;
+}
+
+namespace {
+
+#if defined(__linux__) && defined(__NR_memfd_create)
+
+// A tensor record shared by the modules that loaded it. It is kept in an
+// anonymous memory file, which each of them maps privately.
+struct SharedRecord {
+  SharedRecord(int fd, void* contents, size_t size)
+      : fd(fd), contents(contents), size(size) {}
+  ~SharedRecord() {
+    munmap(contents, size);
+    close(fd);
+  }
+  const int fd;
+  // A read-only mapping of the file, to compare records with.
+  void* const contents;
+  const size_t size;
+};
+
+// The mapping a tensor loaded from a shared record aliases.
+struct PrivateMapping {
+  std::shared_ptr<SharedRecord> record;
+  void* data;
+};
+
+void deletePrivateMapping(void* ctx) {
+  auto mapping = static_cast<PrivateMapping*>(ctx);
+  munmap(mapping->data, mapping->record->size);
+  delete mapping;
+}
+
+// Hashes the 8-byte words of data, so that identical records are usually
+// found with a single comparison of their contents.
+uint64_t hashRecord(const void* data, size_t size) {
+  const auto bytes = static_cast<const char*>(data);
+  uint64_t hash = size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ (word * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 32;
+  }
+  for (; i < size; i++) {
+    hash = (hash ^ static_cast<uint8_t>(bytes[i])) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// The records shared by the modules loaded in this process, by the hash of
+// their contents. A record is freed once no tensor aliases it anymore.
+class SharedRecordCache {
+ public:
+  static SharedRecordCache& get() {
+    static SharedRecordCache cache;
+    return cache;
+  }
+
+  // Returns a private mapping of the shared record with the contents of data,
+  // which it creates if there is none, or data itself if that fails.
+  at::DataPtr share(at::DataPtr data, size_t size) {
+    const uint64_t hash = hashRecord(data.get(), size);
+    std::shared_ptr<SharedRecord> record;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto range = records_.equal_range(hash);
+      for (auto it = range.first; it != range.second && !record;) {
+        record = it->second.lock();
+        if (!record) {
+          it = records_.erase(it);
+        } else if (
+            record->size != size ||
+            std::memcmp(record->contents, data.get(), size) != 0) {
+          record = nullptr;
+          ++it;
+        }
+      }
+      if (!record) {
+        record = createRecord(data.get(), size);
+        if (!record) {
+          return data;
+        }
+        pruneExpired();
+        records_.emplace(hash, record);
+      }
+    }
+    void* mapped =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, record->fd, 0);
+    if (mapped == MAP_FAILED) {
+      return data;
+    }
+    return at::DataPtr(
+        mapped,
+        new PrivateMapping{std::move(record), mapped},
+        &deletePrivateMapping,
+        at::DeviceType::CPU);
+  }
+
+  size_t sharedBytes() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_t bytes = 0;
+    for (const auto& entry : records_) {
+      if (auto record = entry.second.lock()) {
+        bytes += record->size;
+      }
+    }
+    return bytes;
+  }
+
+ private:
+  static std::shared_ptr<SharedRecord> createRecord(
+      const void* data,
+      size_t size) {
+    const int fd = static_cast<int>(syscall(
+        __NR_memfd_create, "torch_shared_tensor_record", 1 /* MFD_CLOEXEC */));
+    if (fd < 0) {
+      return nullptr;
+    }
+    void* contents = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+      contents =
+          mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (contents == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+    std::memcpy(contents, data, size);
+    mprotect(contents, size, PROT_READ);
+    return std::make_shared<SharedRecord>(fd, contents, size);
+  }
+
+  // Drops the entries of the freed records once they may make up half of the
+  // map, so that the map does not grow with every record ever loaded.
+  void pruneExpired() {
+    if (records_.size() < 2 * live_after_prune_) {
+      return;
+    }
+    for (auto it = records_.begin(); it != records_.end();) {
+      it = it->second.expired() ? records_.erase(it) : std::next(it);
+    }
+    live_after_prune_ = std::max<size_t>(records_.size(), 16);
+  }
+
+  std::mutex mutex_;
+  std::unordered_multimap<uint64_t, std::weak_ptr<SharedRecord>> records_;
+  size_t live_after_prune_ = 16;
+};
+
+// Records smaller than a page would take a whole page each once shared.
+at::DataPtr shareTensorRecord(at::DataPtr data, size_t size) {
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (size < page_size || !data.device().is_cpu() ||
+      caffe2::serialize::isMmapFileData(data)) {
+    return data;
+  }
+  return SharedRecordCache::get().share(std::move(data), size);
+}
+
+size_t sharedTensorRecordBytesImpl() {
+  return SharedRecordCache::get().sharedBytes();
+}
+
+#else
+
+at::DataPtr shareTensorRecord(at::DataPtr data, size_t size) {
+  return data;
+}
+
+size_t sharedTensorRecordBytesImpl() {
+  return 0;
+}
+
+#endif
+
+// Whether the records of tensors loaded onto device should be shared.
+bool shouldShareTensorRecords(c10::optional<at::Device> device) {
+  return getTensorRecordSharing() && (!device || device->is_cpu());
+}
+
+// Reads the records in the `archive_name/` folder of the archive, which hold
+// the storages of the pickled tensors, on the intra-op thread pool. Copies
+// out of the reader are serialized by it, but copies into pinned memory and
+// from there onto `device` overlap with them and with each other.
+std::unordered_map<std::string, at::DataPtr> prefetchRecords(
+    const std::string& archive_name_plus_slash,
+    c10::optional<at::Device> device,
+    PyTorchStreamReader& stream_reader) {
+  // getAllRecords() returns names with the archive's top-level folder.
+  std::vector<std::string> names;
+  for (const auto& record : stream_reader.getAllRecords()) {
+    auto pos = record.find('/');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    auto name = record.substr(pos + 1);
+    if (name.compare(
+            0, archive_name_plus_slash.size(), archive_name_plus_slash) == 0) {
+      names.push_back(std::move(name));
+    }
+  }
+
+  std::vector<at::DataPtr> records(names.size());
+  const bool to_cuda = device && device->is_cuda();
+  const bool share = shouldShareTensorRecords(device);
+  at::parallel_for(0, names.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      at::DataPtr data;
+      size_t size;
+      std::tie(data, size) = stream_reader.getRecord(names[i]);
+      if (to_cuda && size > 0) {
+        const auto numel = static_cast<int64_t>(size);
+        auto bytes = at::TensorOptions().dtype(at::kByte);
+        auto staging = at::empty({numel}, bytes.pinned_memory(true));
+        std::memcpy(staging.data_ptr(), data.get(), size);
+        data.clear();
+        auto dst = at::empty({numel}, bytes.device(*device));
+        // The pinned allocator does not reuse staging until the copy is done.
+        dst.copy_(staging, /*non_blocking=*/true);
+        data = dst.storage().unsafeGetStorageImpl()->set_data_ptr(
+            at::DataPtr());
+      } else if (share) {
+        data = shareTensorRecord(std::move(data), size);
+      }
+      records[i] = std::move(data);
+    }
+  });
+
+  std::unordered_map<std::string, at::DataPtr> result;
+  result.reserve(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    result.emplace(std::move(names[i]), std::move(records[i]));
+  }
+  return result;
+}
+
+} // namespace
+
 IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
@@ -81,9 +344,27 @@ IValue readArchiveAndTensors(
   };
 
   std::string archive_name_plus_slash = archive_name + "/";
+  std::unordered_map<std::string, at::DataPtr> prefetched;
+  if (getParallelTensorLoading()) {
+    prefetched =
+        prefetchRecords(archive_name_plus_slash, device, stream_reader);
+  }
+  const bool share = shouldShareTensorRecords(device);
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
-    return std::get<0>(stream_reader.getRecord(ss));
+    auto it = prefetched.find(ss);
+    if (it != prefetched.end()) {
+      auto data = std::move(it->second);
+      prefetched.erase(it);
+      return data;
+    }
+    at::DataPtr data;
+    size_t size;
+    std::tie(data, size) = stream_reader.getRecord(ss);
+    if (share) {
+      data = shareTensorRecord(std::move(data), size);
+    }
+    return data;
   };
 
   Unpickler unpickler(
@@ -321,6 +602,37 @@ Module load(
   return module;
 }
 
+Module load_mmapped(const std::string& filename, ExtraFilesMap& extra_files) {
+  return load(
+      std::make_unique<MmapFileAdapter>(filename), c10::nullopt, extra_files);
+}
+
+size_t sharedTensorRecordBytes() {
+  return sharedTensorRecordBytesImpl();
+}
+
+size_t evict_mmapped_tensors(const Module& module) {
+  size_t evicted = 0;
+  std::unordered_set<c10::StorageImpl*> seen;
+  for (const auto& attr : module.attributes(/*recurse=*/true)) {
+    if (!attr.isTensor()) {
+      continue;
+    }
+    const auto& tensor = attr.toTensor();
+    if (!tensor.defined() || !tensor.has_storage()) {
+      continue;
+    }
+    auto storage = tensor.storage().unsafeGetStorageImpl();
+    if (!seen.insert(storage).second ||
+        !caffe2::serialize::isMmapFileData(storage->data_ptr())) {
+      continue;
+    }
+    evicted += caffe2::serialize::evictMmapFileData(
+        storage->data_ptr(), storage->nbytes());
+  }
+  return evicted;
+}
+
 Module load(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device,
@@ -5,6 +5,7 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/serialization/unpickler.h>
 
+#include <atomic>
 #include <istream>
 
 namespace caffe2 {
@@ -65,6 +66,44 @@ TORCH_API Module load(
     c10::optional<c10::Device> device = c10::nullopt,
     ExtraFilesMap& extra_files = default_extra_files);
 
+/// Loads a serialized `Module` from the given `filename` without reading its
+/// tensors. The file is mapped into memory privately (copy-on-write) and the
+/// tensors alias the mapping, so their data is only read when it is first
+/// accessed, and processes loading the same file share its pages. Tensors
+/// that were saved on a device other than the CPU are still read and moved to
+/// it. The file must not be modified while the module is alive.
+TORCH_API Module load_mmapped(
+    const std::string& filename,
+    ExtraFilesMap& extra_files = default_extra_files);
+
+/// Drops the memory of the tensor attributes (parameters, buffers and others)
+/// of `module` and its submodules that alias a file mapped by `load_mmapped`,
+/// so that it is read from the file again on the next access. Changes made to
+/// these tensors since they were loaded are lost. Returns the number of bytes
+/// dropped.
+TORCH_API size_t evict_mmapped_tensors(const Module& module);
+
+/// When set, `load`, `import_ir_module` and `readArchiveAndTensors` read all
+/// tensor records of an archive in parallel before unpickling it, instead of
+/// one at a time while unpickling. If the target `device` is a CUDA device,
+/// the records are copied to it through pinned staging buffers while other
+/// records are still being read. Disabled by default.
+TORCH_API std::atomic<bool>& getParallelTensorLoading();
+
+/// When set, `load`, `import_ir_module` and `readArchiveAndTensors` share
+/// the memory of the tensor records that are byte-identical to a record loaded
+/// before and still in use, e.g. the layers that fine-tuned variants of a model
+/// did not change. Each tensor maps the shared record privately
+/// (copy-on-write), so writing to it copies the pages written to, and the
+/// change is not seen by the other tensors. Only applies to records of at least
+/// a page that are loaded onto the CPU, and only on Linux. Disabled by
+/// default.
+TORCH_API std::atomic<bool>& getTensorRecordSharing();
+
+/// Returns the total size of the distinct tensor records currently shared
+/// because of `getTensorRecordSharing`.
+TORCH_API size_t sharedTensorRecordBytes();
+
 TORCH_API IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
@@ -35,13 +35,18 @@ std::vector<char> pickle(
 
 // This has to live here instead of the C++ API to mirror torch.save since the
 // mobile build excludes the C++ API
-std::vector<char> pickle_save(const at::IValue& ivalue) {
+std::vector<char> pickle_save(
+    const at::IValue& ivalue,
+    size_t pack_storages_below) {
 #ifndef C10_MOBILE
   // Pickle the IValue into an array of bytes
   std::vector<char> pickle_data;
   Pickler pickler([&](const char* buf, size_t size) {
     pickle_data.insert(pickle_data.end(), buf, buf + size);
   });
+  if (pack_storages_below > 0) {
+    pickler.packSmallStorages(ivalue, pack_storages_below);
+  }
   pickler.protocol();
   pickler.pushIValue(ivalue);
   pickler.stop();
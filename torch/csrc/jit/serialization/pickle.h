@@ -54,7 +54,15 @@ TORCH_API std::vector<char> pickle(
 
 /// Save a `torch::IValue` in a format that can be loaded by both
 /// `torch::pickle_load` in C++ and `torch.load` in Python.
-TORCH_API std::vector<char> pickle_save(const IValue& ivalue);
+///
+/// If `pack_storages_below` is non-zero, the CPU tensors whose storage holds
+/// at most that many bytes are written as views into one shared record per
+/// dtype instead of one record each (see `Pickler::packSmallStorages`), which
+/// makes values with many small tensors, such as state dicts, much faster to
+/// save and load. The loaded tensors then share their storage.
+TORCH_API std::vector<char> pickle_save(
+    const IValue& ivalue,
+    size_t pack_storages_below = 0);
 
 /// Deserialize a `torch::IValue` from bytes produced by either
 /// `torch::pickle_save` in C++ or `torch.save` in Python
@@ -6,7 +6,9 @@
 #include <aten/src/ATen/quantized/Quantizer.h>
 #include <torch/csrc/jit/api/function_impl.h>
 #include <torch/csrc/jit/serialization/pickler.h>
+#include <map>
 #include <string>
+#include <unordered_set>
 
 namespace torch {
 namespace jit {
@@ -331,6 +333,59 @@ void Pickler::pushGlobal(
   }
 }
 
+void Pickler::packSmallStorages(const IValue& root, size_t max_bytes) {
+  // Each packed storage starts at this alignment so that the loaded views
+  // are as aligned as tensors allocated on their own.
+  constexpr size_t kAlignment = 64;
+  std::map<at::ScalarType, std::vector<at::Storage>> storages;
+  std::unordered_set<const void*> seen;
+  root.visit([&](const IValue& value) {
+    if (!value.isTensor()) {
+      return false;
+    }
+    const at::Tensor& tensor = value.toTensor();
+    if (!tensor.defined() || !tensor.has_storage() ||
+        tensor.layout() != at::kStrided || !tensor.device().is_cpu() ||
+        tensor.is_quantized()) {
+      return true;
+    }
+    const at::Storage& storage = tensor.storage();
+    if (storage.nbytes() == 0 || storage.nbytes() > max_bytes ||
+        !seen.insert(storage.unsafeGetStorageImpl()).second) {
+      return true;
+    }
+    storages[tensor.scalar_type()].push_back(storage);
+    return true;
+  });
+
+  for (const auto& entry : storages) {
+    const auto& group = entry.second;
+    if (group.size() < 2) {
+      continue;
+    }
+    const size_t element_size = c10::elementSize(entry.first);
+    const size_t alignment = std::max<size_t>(kAlignment / element_size, 1);
+    std::vector<int64_t> offsets;
+    offsets.reserve(group.size());
+    int64_t numel = 0;
+    for (const auto& storage : group) {
+      numel = (numel + alignment - 1) / alignment * alignment;
+      offsets.push_back(numel);
+      numel += storage.nbytes() / element_size;
+    }
+    at::Tensor packed = at::empty({numel}, at::dtype(entry.first));
+    char* packed_data = static_cast<char*>(packed.data_ptr());
+    for (size_t i = 0; i < group.size(); ++i) {
+      memcpy(
+          packed_data + offsets[i] * element_size,
+          group[i].data(),
+          group[i].nbytes());
+      packed_storages_.emplace(
+          group[i].unsafeGetStorageImpl(), std::make_pair(packed, offsets[i]));
+    }
+  }
+}
+
 void Pickler::pushTensor(const IValue& ivalue) {
   if (tensor_table_ == nullptr) {
     pushLiteralTensor(ivalue);
@@ -356,10 +411,14 @@ void Pickler::pushLiteralTensor(const IValue& ivalue) {
 
   push<PickleOpCode>(PickleOpCode::MARK);
 
-  pushStorageOfTensor(tensor);
-
-  // storage offset
-  pushInt(tensor.storage_offset());
+  auto packed = packed_storages_.find(tensor.storage().unsafeGetStorageImpl());
+  if (packed != packed_storages_.end()) {
+    pushStorageOfTensor(packed->second.first);
+    pushInt(packed->second.second + tensor.storage_offset());
+  } else {
+    pushStorageOfTensor(tensor);
+    pushInt(tensor.storage_offset());
+  }
 
   // size
   push<PickleOpCode>(PickleOpCode::MARK);
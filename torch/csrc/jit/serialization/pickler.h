@@ -142,6 +142,16 @@ class Pickler {
   void startTuple();
   void endTuple();
 
+  // Packs the storages of the CPU tensors reachable from root that hold at
+  // most max_bytes into one storage per dtype, so that they are written as a
+  // single record instead of one record each. The tensors are pickled as
+  // views at their offset into the packed storage, which torch.load and the
+  // Unpickler read like any other view. Must be called before root is pushed.
+  //
+  // Loaded tensors then share their storage, so this is only meant for values
+  // such as state dicts whose tensors are used on their own.
+  void packSmallStorages(const IValue& root, size_t max_bytes);
+
   const std::vector<at::Tensor>& tensorData() {
     return tensor_data_;
   }
@@ -257,6 +267,11 @@ class Pickler {
   std::vector<at::Tensor> tensor_data_;
   std::unordered_map<const void*, uint32_t> memoized_storage_map_;
 
+  // Storages packed by packSmallStorages: the packed storage (as a 1-D
+  // tensor) and the element offset of the original storage in it
+  std::unordered_map<const void*, std::pair<at::Tensor, int64_t>>
+      packed_storages_;
+
   std::unordered_map<std::string, uint32_t> memoized_globals_map_;
   std::unordered_map<std::string, uint32_t> memoized_strings_map_;
   std::unordered_map<std::string, uint32_t> memoized_devices_map_;
@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/core/Dict.h>
+#include <c10/util/SmallVector.h>
 #ifdef USE_DISTRIBUTED
 #include <torch/csrc/distributed/rpc/rref_context.h>
 #endif
@@ -229,10 +230,14 @@ inline void append<bool>(std::vector<bool>& a, bool&& e) {
   a.push_back(e);
 }
 
-static std::vector<int64_t> tupleToIntList(const IValue& v) {
-  return fmap(v.toTuple()->elements(), [](const IValue& v) -> int64_t {
-    return v.toInt();
-  });
+static c10::SmallVector<int64_t, 5> tupleToIntList(const IValue& v) {
+  const auto& elements = v.toTuple()->elements();
+  c10::SmallVector<int64_t, 5> result;
+  result.reserve(elements.size());
+  for (const auto& element : elements) {
+    result.push_back(element.toInt());
+  }
+  return result;
 }
 
 // note we cannot use toIntList, toDoubleList because during unpickling the
@@ -242,8 +247,25 @@ static std::vector<T> convertList(const IValue& v) {
   return fmap(v.toListRef(), [](const IValue& elem) { return elem.to<T>(); });
 }
 
+void Unpickler::buildPendingTuple() {
+  const size_t start = pending_tuple_start_;
+  pending_tuple_start_ = kNoPendingTuple;
+  auto tuple = c10::ivalue::Tuple::create({});
+  tuple->elements().reserve(stack_.size() - start);
+  auto start_it = stack_.begin() + start;
+  for (auto it = start_it; it != stack_.end(); ++it) {
+    tuple->elements().emplace_back(std::move(*it));
+  }
+  stack_.erase(start_it, stack_.end());
+  stack_.emplace_back(std::move(tuple));
+}
+
 PickleOpCode Unpickler::readInstruction() {
   auto opcode = readOpCode();
+  if (pending_tuple_start_ != kNoPendingTuple &&
+      opcode != PickleOpCode::BINPERSID && opcode != PickleOpCode::REDUCE) {
+    buildPendingTuple();
+  }
   switch (opcode) {
     case PickleOpCode::EMPTY_LIST: {
       stack_.emplace_back(c10::impl::GenericList(AnyType::get()));
@@ -307,16 +329,10 @@ PickleOpCode Unpickler::readInstruction() {
       stack_.emplace_back(readFloat());
       break;
     case PickleOpCode::TUPLE: {
-      size_t start = marks_.back();
+      // Built by the next instruction unless it consumes the elements
+      // directly, see pending_tuple_start_
+      pending_tuple_start_ = marks_.back();
       marks_.pop_back();
-      auto tuple = c10::ivalue::Tuple::create({});
-      tuple->elements().reserve(stack_.size() - start);
-      auto start_it = stack_.begin() + start;
-      for (auto it = start_it; it != stack_.end(); ++it) {
-        tuple->elements().emplace_back(*it);
-      }
-      stack_.erase(start_it, stack_.end());
-      stack_.emplace_back(tuple);
     } break;
     case PickleOpCode::TUPLE1: {
       auto tuple = c10::ivalue::Tuple::create(pop(stack_, 1));
@@ -385,6 +401,22 @@ PickleOpCode Unpickler::readInstruction() {
     // the same thing
     case PickleOpCode::BUILD:
     case PickleOpCode::REDUCE: {
+      if (pending_tuple_start_ != kNoPendingTuple) {
+        // stack is: <functor_idx> <functor_args...>
+        const size_t start = pending_tuple_start_;
+        auto rebuild = start > 0 && stack_[start - 1].isInt()
+            ? tensor_rebuild_globals_.find(stack_[start - 1].toInt())
+            : tensor_rebuild_globals_.end();
+        if (rebuild != tensor_rebuild_globals_.end()) {
+          pending_tuple_start_ = kNoPendingTuple;
+          at::Tensor tensor = rebuildTensorFromArgs(
+              stack_.data() + start, stack_.size() - start, rebuild->second);
+          stack_.erase(stack_.begin() + start - 1, stack_.end());
+          stack_.emplace_back(std::move(tensor));
+          break;
+        }
+        buildPendingTuple();
+      }
       // stack is: <functor_idx> <functor_arg>
       // extract <functor_idx> and remove from the stack:
       std::swap(*(stack_.end() - 2), *(stack_.end() - 1));
@@ -394,42 +426,15 @@ PickleOpCode Unpickler::readInstruction() {
       globals_.at(idx)();
     } break;
     case PickleOpCode::BINPERSID: {
-      auto args = pop(stack_).toTuple()->elements();
-      AT_ASSERT(
-          args.at(0).toStringRef() == "storage",
-          "unknown PERSID key ",
-          args.at(0).toStringRef());
-      at::ScalarType type = args.at(1).toScalarType();
-      const std::string& key = args.at(2).toStringRef();
-      at::Device device(args.at(3).toStringRef());
-      if (device_) {
-        device = *device_;
-      }
-      at::DataPtr storage_ptr = read_record_(key);
-      int64_t numel = args.at(4).toInt();
-      caffe2::TypeMeta dtype = at::CPU(type).typeMeta();
-      at::Storage storage(
-          c10::Storage::use_byte_size_t(),
-          numel * dtype.itemsize(),
-          std::move(storage_ptr),
-          /*allocator=*/nullptr,
-          /*resizable=*/false); // NB: we didn't set any allocator for the
-                                // tensor
-      auto options = at::CPU(type).options();
       at::Tensor tensor;
-      if (options.backend() == c10::Backend::QuantizedCPU) {
-        tensor = at::_empty_affine_quantized({}, options, 0, 0)
-                     .set_(storage, 0, {}, {});
+      if (pending_tuple_start_ != kNoPendingTuple) {
+        const size_t start = pending_tuple_start_;
+        pending_tuple_start_ = kNoPendingTuple;
+        tensor = loadStorage(stack_.data() + start, stack_.size() - start);
+        stack_.erase(stack_.begin() + start, stack_.end());
       } else {
-        tensor = at::empty({0}, options).set_(storage);
-      }
-
-      if (device.type() == DeviceType::CUDA) {
-        tensor = tensor.to(device, tensor.scalar_type());
-      } else if (device.type() != DeviceType::CPU) {
-        AT_ERROR(
-            "supported devices include CPU and CUDA, however got ",
-            DeviceTypeName(device.type(), false));
+        auto args = pop(stack_).toTuple();
+        tensor = loadStorage(args->elements().data(), args->elements().size());
       }
       stack_.push_back(std::move(tensor));
     } break;
@@ -444,6 +449,57 @@ PickleOpCode Unpickler::readInstruction() {
   return opcode;
 }
 
+at::Tensor Unpickler::loadStorage(const IValue* args, size_t num_args) {
+  TORCH_CHECK(
+      num_args == 5,
+      "Expected 5 elements in a persistent id, found ",
+      num_args);
+  AT_ASSERT(
+      args[0].toStringRef() == "storage",
+      "unknown PERSID key ",
+      args[0].toStringRef());
+  at::ScalarType type = args[1].toScalarType();
+  const std::string& key = args[2].toStringRef();
+  at::Device device(args[3].toStringRef());
+  if (device_) {
+    device = *device_;
+  }
+  at::DataPtr storage_ptr = read_record_(key);
+  const auto storage_ptr_device = storage_ptr.device();
+  int64_t numel = args[4].toInt();
+  caffe2::TypeMeta dtype = at::CPU(type).typeMeta();
+  at::Storage storage(
+      c10::Storage::use_byte_size_t(),
+      numel * dtype.itemsize(),
+      std::move(storage_ptr),
+      /*allocator=*/nullptr,
+      /*resizable=*/false); // NB: we didn't set any allocator for the
+                            // tensor
+  auto options = at::CPU(type).options();
+  at::Tensor tensor;
+  if (storage_ptr_device.type() != DeviceType::CPU) {
+    // read_record_ may have already copied the storage to the device.
+    TORCH_CHECK(
+        options.backend() != c10::Backend::QuantizedCPU,
+        "quantized tensors can only be loaded on CPU");
+    tensor = at::empty({0}, options.device(storage_ptr_device)).set_(storage);
+  } else if (options.backend() == c10::Backend::QuantizedCPU) {
+    tensor =
+        at::_empty_affine_quantized({}, options, 0, 0).set_(storage, 0, {}, {});
+  } else {
+    tensor = at::empty({0}, options).set_(storage);
+  }
+
+  if (device.type() == DeviceType::CUDA) {
+    tensor = tensor.to(device, tensor.scalar_type());
+  } else if (device.type() != DeviceType::CPU) {
+    AT_ERROR(
+        "supported devices include CPU and CUDA, however got ",
+        DeviceTypeName(device.type(), false));
+  }
+  return tensor;
+}
+
 void Unpickler::readGlobal(
     const std::string& module_name,
     const std::string& class_name) {
@@ -604,54 +660,68 @@ void Unpickler::readGlobal(
 }
 
 void Unpickler::rebuildTensor(bool quantized) {
+  tensor_rebuild_globals_.emplace(globals_.size(), quantized);
   globals_.emplace_back([this, quantized] {
     auto tup = pop(stack_).toTuple();
     const auto& elements = tup->elements();
-    size_t idx = 0;
-    auto storage_tensor = elements.at(idx++).toTensor();
-    int64_t storage_offset = elements.at(idx++).toInt();
-    std::vector<int64_t> size = tupleToIntList(elements.at(idx++));
-    std::vector<int64_t> stride = tupleToIntList(elements.at(idx++));
-    at::Tensor result;
-    if (quantized) {
-      auto qparams_tuple = elements.at(idx++).toTuple();
-      const auto& qparams = qparams_tuple->elements();
-      auto qscheme = static_cast<at::QScheme>(qparams.at(0).toInt());
-      switch (qscheme) {
-        case at::kPerTensorAffine: {
-          double q_scale = qparams.at(1).toDouble();
-          int64_t q_zero_point = qparams.at(2).toInt();
-          result = at::_empty_affine_quantized(
-              {0}, storage_tensor.options(), q_scale, q_zero_point);
-        } break;
-        case at::kPerChannelAffine: {
-          const auto& scales = qparams.at(1).toTensor();
-          const auto& zero_points = qparams.at(2).toTensor();
-          int64_t axis = qparams.at(3).toInt();
-          result = at::_empty_per_channel_affine_quantized(
-              {0}, scales, zero_points, axis, storage_tensor.options());
-        } break;
-        default:
-          TORCH_CHECK(
-              false,
-              "Unsupported tensor quantization type in serialization ",
-              toString(qscheme));
-          break;
-      }
-    } else {
-      result = at::empty({0}, storage_tensor.options());
-    }
-    bool requires_grad = elements.at(idx).toBool();
-    // elements[idx++] is empty backwards hooks
-    at::TensorImpl* impl = result.unsafeGetTensorImpl();
-    impl->set_storage_keep_dtype(storage_tensor.storage());
-    impl->set_storage_offset(storage_offset);
-    impl->set_sizes_and_strides(size, stride);
-    result = autograd::make_variable(result, requires_grad);
-    stack_.push_back(std::move(result));
+    stack_.push_back(
+        rebuildTensorFromArgs(elements.data(), elements.size(), quantized));
   });
 }
 
+at::Tensor Unpickler::rebuildTensorFromArgs(
+    const IValue* args,
+    size_t num_args,
+    bool quantized) {
+  // storage, storage_offset, size, stride, [qparams,] requires_grad,
+  // backward_hooks
+  TORCH_CHECK(
+      num_args >= (quantized ? 7u : 6u),
+      "Too few tensor rebuild arguments: ",
+      num_args);
+  size_t idx = 0;
+  const auto& storage_tensor = args[idx++].toTensor();
+  int64_t storage_offset = args[idx++].toInt();
+  auto size = tupleToIntList(args[idx++]);
+  auto stride = tupleToIntList(args[idx++]);
+  at::Tensor result;
+  if (quantized) {
+    auto qparams_tuple = args[idx++].toTuple();
+    const auto& qparams = qparams_tuple->elements();
+    auto qscheme = static_cast<at::QScheme>(qparams.at(0).toInt());
+    switch (qscheme) {
+      case at::kPerTensorAffine: {
+        double q_scale = qparams.at(1).toDouble();
+        int64_t q_zero_point = qparams.at(2).toInt();
+        result = at::_empty_affine_quantized(
+            {0}, storage_tensor.options(), q_scale, q_zero_point);
+      } break;
+      case at::kPerChannelAffine: {
+        const auto& scales = qparams.at(1).toTensor();
+        const auto& zero_points = qparams.at(2).toTensor();
+        int64_t axis = qparams.at(3).toInt();
+        result = at::_empty_per_channel_affine_quantized(
+            {0}, scales, zero_points, axis, storage_tensor.options());
+      } break;
+      default:
+        TORCH_CHECK(
+            false,
+            "Unsupported tensor quantization type in serialization ",
+            toString(qscheme));
+        break;
+    }
+  } else {
+    result = at::empty({0}, storage_tensor.options());
+  }
+  bool requires_grad = args[idx].toBool();
+  // args[idx + 1] is empty backwards hooks
+  at::TensorImpl* impl = result.unsafeGetTensorImpl();
+  impl->set_storage_keep_dtype(storage_tensor.storage());
+  impl->set_storage_offset(storage_offset);
+  impl->set_sizes_and_strides(size, stride);
+  return autograd::make_variable(result, requires_grad);
+}
+
 #ifdef USE_DISTRIBUTED
 void Unpickler::rebuildRRef() {
   globals_.emplace_back([this] {
@@ -4,6 +4,9 @@
 #include <caffe2/serialize/inline_container.h>
 #include <torch/csrc/jit/serialization/pickler.h>
 
+#include <limits>
+#include <unordered_map>
+
 namespace torch {
 namespace jit {
 
@@ -96,6 +99,12 @@ class Unpickler {
       const std::string& module_name,
       const std::string& class_name);
   void rebuildTensor(bool quantized);
+  at::Tensor rebuildTensorFromArgs(
+      const IValue* args,
+      size_t num_args,
+      bool quantized);
+  at::Tensor loadStorage(const IValue* args, size_t num_args);
+  void buildPendingTuple();
 #ifdef USE_DISTRIBUTED
   void rebuildRRef();
 #endif
@@ -125,6 +134,16 @@ class Unpickler {
   std::vector<size_t> marks_;
   const std::vector<at::Tensor>* tensor_table_;
 
+  // Position in stack_ of the elements of the last TUPLE, which is only built
+  // when needed: the arguments of persistent ids (BINPERSID) and of tensor
+  // rebuilds (REDUCE) are read straight from the stack, anything else builds
+  // the tuple first. Saves the tuple allocations for every tensor.
+  static constexpr size_t kNoPendingTuple = std::numeric_limits<size_t>::max();
+  size_t pending_tuple_start_ = kNoPendingTuple;
+  // globals_ indices of _rebuild_tensor_v2 (false) and _rebuild_qtensor
+  // (true)
+  std::unordered_map<size_t, bool> tensor_rebuild_globals_;
+
   // When deserializing types on lists and dicts, cache the type here
   // so we don't have to parse the same type multiple times. Strings
   // are already de-duplicated and replaced with BINGETs in the
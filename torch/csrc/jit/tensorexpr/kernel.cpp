@@ -1,11 +1,13 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
 #include <c10/util/string_utils.h>
+#include <cpuinfo.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
 
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
@@ -17,6 +19,8 @@ namespace tensorexpr {
 static int te_cuda_pointwise_loop_levels = -1;
 static int te_cuda_pointwise_block_count = -1;
 static int te_cuda_pointwise_block_size = -1;
+static bool te_symbolic_batch_dim = true;
+static int te_kernel_cache_size = 8;
 static bool fallback_allowed = false;
 
 bool setFallbackAllowed(bool value) {
@@ -48,6 +52,14 @@ int& getTECudaPointwiseBlockSize() {
   return te_cuda_pointwise_block_size;
 }
 
+bool& getTESymbolicBatchDim() {
+  return te_symbolic_batch_dim;
+}
+
+int& getTEKernelCacheSize() {
+  return te_kernel_cache_size;
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -56,6 +68,173 @@ static at::ScalarType tensorType(Tensor* t) {
   return static_cast<at::ScalarType>(t->body()->dtype().scalar_type());
 }
 
+static bool isReduction(Tensor* t) {
+  return dynamic_cast<const ReduceOp*>(t->body()) != nullptr;
+}
+
+static IValue constantValue(const torch::jit::Value* v) {
+  auto ival = toIValue(v);
+  if (!ival) {
+    throw malformed_input("expected a constant argument");
+  }
+  return *ival;
+}
+
+// Returns the sorted dimensions a reduction node reduces a value of the given
+// rank over.
+static std::vector<size_t> reducedDims(const torch::jit::Node* n, size_t rank) {
+  std::vector<int64_t> dims;
+  switch (n->kind()) {
+    case aten::sum:
+    case aten::mean:
+      // The overloads without dims reduce over everything, and so does an
+      // empty list of dims.
+      if (n->inputs().size() > 2) {
+        dims = constantValue(n->input(1)).toIntVector();
+      }
+      break;
+    case aten::softmax:
+    case aten::log_softmax:
+      dims.push_back(constantValue(n->input(1)).toInt());
+      break;
+    case aten::layer_norm: {
+      auto normalized = constantValue(n->input(1)).toIntVector();
+      if (normalized.size() > rank) {
+        throw malformed_input("layer_norm normalizes more dims than it has");
+      }
+      for (size_t i = rank - normalized.size(); i < rank; i++) {
+        dims.push_back(i);
+      }
+      break;
+    }
+    default:
+      throw malformed_input("not a reduction");
+  }
+
+  std::vector<size_t> result;
+  if (dims.empty()) {
+    for (size_t i = 0; i < rank; i++) {
+      result.push_back(i);
+    }
+    return result;
+  }
+  for (auto dim : dims) {
+    if (dim < 0) {
+      dim += rank;
+    }
+    if (dim < 0 || dim >= static_cast<int64_t>(rank)) {
+      throw malformed_input("reduction dim out of range");
+    }
+    result.push_back(dim);
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+static bool reductionKeepsDims(const torch::jit::Node* n) {
+  switch (n->kind()) {
+    case aten::sum:
+    case aten::mean:
+      return n->inputs().size() > 2 && constantValue(n->input(2)).toBool();
+    default:
+      return true;
+  }
+}
+
+// Indices into a reduction with kept dims that is broadcast along dims.
+static std::vector<ExprHandle> keptIndices(
+    const std::vector<ExprHandle>& axes,
+    const std::vector<size_t>& dims) {
+  std::vector<ExprHandle> indices(axes);
+  for (auto dim : dims) {
+    indices[dim] = IntImm::make(0);
+  }
+  return indices;
+}
+
+static ExprHandle numElements(
+    const std::vector<ExprHandle>& sizes,
+    const std::vector<size_t>& dims) {
+  ExprHandle count = IntImm::make(1);
+  for (auto dim : dims) {
+    count = count * sizes[dim];
+  }
+  return IRSimplifier::simplify(count);
+}
+
+static bool sameExtent(const Expr* a, const Expr* b) {
+  if (a == b) {
+    return true;
+  }
+  auto diff = IRSimplifier::simplify(ExprHandle(a) - ExprHandle(b));
+  return immediateEquals(diff.node(), 0);
+}
+
+// Returns true if a store in the body of f does not depend on the loop
+// variable, i.e. the loop accumulates into it.
+static bool isReductionLoop(For* f) {
+  VarFinder finder;
+  for (auto* store : NodeFinder<Store>::find(f->body())) {
+    for (auto* index : store->indices()) {
+      if (finder.findVars(index).count(f->var())) {
+        continue;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// Width in bytes of the host's vector registers; LLVMCodeGen compiles for the
+// host CPU.
+static int hostVectorBytes() {
+  static const int bytes = []() {
+    if (cpuinfo_initialize()) {
+      if (cpuinfo_has_x86_avx512f()) {
+        return 64;
+      }
+      if (cpuinfo_has_x86_avx()) {
+        return 32;
+      }
+    }
+    // SSE and NEON
+    return 16;
+  }();
+  return bytes;
+}
+
+// Vectorized loops fill a vector register with the widest type they store.
+static int vectorLanesFor(For* f) {
+  int elementBytes = 1;
+  for (auto* store : NodeFinder<Store>::find(f->body())) {
+    elementBytes = std::max(elementBytes, store->value()->dtype().byte_size());
+  }
+  return hostVectorBytes() / elementBytes;
+}
+
+static std::vector<For*> findOuterLoops(Stmt* root) {
+  std::vector<For*> loops;
+  if (For* rootF = dynamic_cast<For*>(root)) {
+    loops.push_back(rootF);
+  } else if (tensorexpr::Block* body = dynamic_cast<tensorexpr::Block*>(root)) {
+    std::vector<tensorexpr::Block*> blocks = {body};
+    while (blocks.size()) {
+      tensorexpr::Block* b = blocks.back();
+      blocks.pop_back();
+
+      for (Stmt* s : *b) {
+        if (For* f = dynamic_cast<For*>(s)) {
+          loops.push_back(f);
+        } else if (tensorexpr::Block* b2 = dynamic_cast<tensorexpr::Block*>(s)) {
+          blocks.push_back(b2);
+        }
+      }
+    }
+  }
+  return loops;
+}
+
 static std::vector<ExprHandle> computeIndicesToBroadcast(
     const std::vector<ExprHandle>& outputAxes,
     const std::vector<ExprHandle>& inputSizes) {
@@ -146,7 +325,11 @@ std::vector<ExprHandle> TensorExprKernel::sizesForValue(
   if (v->type()->kind() == TypeKind::TensorType) {
     auto tt = v->type()->cast<TensorType>();
     if (tt->isComplete()) {
-      return sizesFromVaryingShape(tt->sizes());
+      auto sizes = sizesFromVaryingShape(tt->sizes());
+      if (batchSize_ && !sizes.empty()) {
+        sizes[0] = *batchSize_;
+      }
+      return sizes;
     }
   }
 
@@ -305,6 +488,28 @@ std::vector<ExprHandle> TensorExprKernel::inferSizesForValue(
       shape[dim] = concat_size;
       return shape;
     }
+    case aten::sum:
+    case aten::mean: {
+      auto const& n = v->node();
+      auto shape = sizesForValue(n->input(0));
+      auto dims = reducedDims(n, shape.size());
+      bool keepdim = reductionKeepsDims(n);
+      std::vector<ExprHandle> result;
+      for (size_t i = 0; i < shape.size(); i++) {
+        if (!std::binary_search(dims.begin(), dims.end(), i)) {
+          result.push_back(shape[i]);
+        } else if (keepdim) {
+          result.push_back(IntImm::make(1));
+        }
+      }
+      return result;
+    }
+
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return sizesForValue(v->node()->input(0));
+
     case aten::slice:
       throw std::runtime_error(
           "Shape info is not implemented for this kind of node");
@@ -649,6 +854,50 @@ Tensor* TensorExprKernel::computeFourOperand(
       });
 }
 
+Tensor* TensorExprKernel::computeReduction(
+    const std::string& name,
+    const Reducer& reducer,
+    const std::vector<ExprHandle>& sizes,
+    const std::vector<size_t>& dims,
+    bool keepdim,
+    const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body) {
+  std::vector<DimArg> outputArgs;
+  std::vector<DimArg> reduceArgs;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (std::binary_search(dims.begin(), dims.end(), i)) {
+      reduceArgs.emplace_back(sizes[i], "r" + c10::to_string(i));
+      if (keepdim) {
+        outputArgs.emplace_back(IntImm::make(1), "i" + c10::to_string(i));
+      }
+    } else {
+      outputArgs.emplace_back(sizes[i], "i" + c10::to_string(i));
+    }
+  }
+
+  // Reduce passes the output indices followed by the reduction indices; put
+  // them back in the order of the input dimensions.
+  std::function<ExprHandle(ParameterList&)> reduceBody =
+      [&](ParameterList& vars) {
+        std::vector<ExprHandle> axes(sizes.size());
+        size_t outputIdx = 0;
+        size_t reduceIdx = outputArgs.size();
+        for (size_t i = 0; i < sizes.size(); i++) {
+          if (std::binary_search(dims.begin(), dims.end(), i)) {
+            if (keepdim) {
+              outputIdx++;
+            }
+            axes[i] = vars[reduceIdx++];
+          } else {
+            axes[i] = vars[outputIdx++];
+          }
+        }
+        return body(axes);
+      };
+  Tensor* t = Reduce(name, outputArgs, reducer, reduceBody, reduceArgs);
+  reductions_.push_back(t);
+  return t;
+}
+
 Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   switch (v->node()->kind()) {
     case aten::add: {
@@ -1193,6 +1442,124 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
           });
     }
 
+    case aten::sum:
+    case aten::mean: {
+      auto const& n = v->node();
+      auto input = n->input(0);
+      auto sizes = sizesForValue(input);
+      auto dims = reducedDims(n, sizes.size());
+      Tensor* sum = computeReduction(
+          "aten_sum",
+          Sum(),
+          sizes,
+          dims,
+          reductionKeepsDims(n),
+          [this, input](const std::vector<ExprHandle>& axes) {
+            return tensorOrConstant(input, axes);
+          });
+      if (n->kind() == aten::sum) {
+        return sum;
+      }
+      auto count = Cast::make(sum->buf()->dtype(), numElements(sizes, dims));
+      return Compute(
+          "aten_mean",
+          dimsFromSizes(ExprVectorToExprHandleVector(sum->buf()->dims())),
+          [sum, count](const std::vector<VarHandle>& axes) {
+            return sum->call(axes) / count;
+          });
+    }
+
+    case aten::softmax:
+    case aten::log_softmax: {
+      // softmax(x) = exp(x - max(x)) / sum(exp(x - max(x)))
+      auto const& n = v->node();
+      auto input = n->input(0);
+      auto sizes = sizesForValue(input);
+      auto dims = reducedDims(n, sizes.size());
+      auto load = [this, input](const std::vector<ExprHandle>& axes) {
+        return tensorOrConstant(input, axes);
+      };
+      Tensor* max = computeReduction(
+          "aten_softmax_max",
+          Maximum(ExprHandle(-std::numeric_limits<float>::infinity())),
+          sizes,
+          dims,
+          /*keepdim=*/true,
+          load);
+      auto shifted = [load, max, dims](const std::vector<ExprHandle>& axes) {
+        return load(axes) - max->call(keptIndices(axes, dims));
+      };
+      Tensor* sum = computeReduction(
+          "aten_softmax_sum",
+          Sum(),
+          sizes,
+          dims,
+          /*keepdim=*/true,
+          [shifted](const std::vector<ExprHandle>& axes) {
+            return exp(shifted(axes));
+          });
+      bool isLog = n->kind() == aten::log_softmax;
+      return Compute(
+          isLog ? "aten_log_softmax" : "aten_softmax",
+          dimsFromSizes(sizes),
+          [shifted, sum, dims, isLog](const std::vector<VarHandle>& axes) {
+            std::vector<ExprHandle> indices(axes.begin(), axes.end());
+            auto total = sum->call(keptIndices(indices, dims));
+            if (isLog) {
+              return shifted(indices) - log(total);
+            }
+            return exp(shifted(indices)) / total;
+          });
+    }
+
+    case aten::layer_norm: {
+      // The mean and the variance are computed in two passes, which is more
+      // accurate than deriving the variance from the sum of squares.
+      auto const& n = v->node();
+      auto input = n->input(0);
+      auto sizes = sizesForValue(input);
+      auto dims = reducedDims(n, sizes.size());
+      auto load = [this, input](const std::vector<ExprHandle>& axes) {
+        return tensorOrConstant(input, axes);
+      };
+      Dtype dtype = tensors_.at(input->unique())->body()->dtype();
+      auto count = Cast::make(dtype, numElements(sizes, dims));
+      Tensor* sum = computeReduction(
+          "aten_layer_norm_sum", Sum(), sizes, dims, /*keepdim=*/true, load);
+      auto centered = [load, sum, dims, count](
+                          const std::vector<ExprHandle>& axes) {
+        return load(axes) - sum->call(keptIndices(axes, dims)) / count;
+      };
+      Tensor* sqsum = computeReduction(
+          "aten_layer_norm_sqsum",
+          Sum(),
+          sizes,
+          dims,
+          /*keepdim=*/true,
+          [centered](const std::vector<ExprHandle>& axes) {
+            auto c = centered(axes);
+            return c * c;
+          });
+      auto eps = Cast::make(dtype, constant(n->input(4)));
+      auto weight = n->input(2);
+      auto bias = n->input(3);
+      return Compute(
+          "aten_layer_norm",
+          dimsFromSizes(sizes),
+          [&](const std::vector<VarHandle>& axes) {
+            std::vector<ExprHandle> indices(axes.begin(), axes.end());
+            auto var = sqsum->call(keptIndices(indices, dims)) / count;
+            auto result = centered(indices) * rsqrt(var + eps);
+            if (!weight->type()->isSubtypeOf(NoneType::get())) {
+              result = result * tensorOrConstant(weight, indices);
+            }
+            if (!bias->type()->isSubtypeOf(NoneType::get())) {
+              result = result + tensorOrConstant(bias, indices);
+            }
+            return result;
+          });
+    }
+
     case aten::_sigmoid_backward: {
       return computeTwoOperand(
           "aten_sigmoid_backward",
@@ -1218,9 +1585,10 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
 }
 
 void TensorExprKernel::flattenTensors(BackendType backendType) {
-  if (backendType != BackendType::kCudaCodeGen) {
+  if (backendType != BackendType::kCudaCodeGen || !reductions_.empty()) {
     // We only need to flatten for GPU, for other backends just use the same
-    // tensors.
+    // tensors. Kernels with reductions are scheduled by rows instead (see
+    // scheduleRowsForCuda).
     flatTensorOutputs_ = tensorOutputs_;
     return;
   }
@@ -1262,15 +1630,53 @@ void TensorExprKernel::flattenTensors(BackendType backendType) {
   }
 }
 
+void TensorExprKernel::scheduleRowsForCuda(LoopNest& l) {
+  // Every block computes one index of dimension 0 of all outputs and
+  // reductions: the reductions of a row first, in one thread, then the
+  // outputs of the row, in all threads of the block. The reductions never
+  // leave the block this way, but it is only valid if every output reads the
+  // reductions of its own row, that is if all of them have the same rank and
+  // size of dimension 0.
+  std::vector<Tensor*> roots(tensorOutputs_);
+  roots.insert(roots.end(), scratchTensors_.begin(), scratchTensors_.end());
+  for (Tensor* t : roots) {
+    if (t->buf()->ndim() == 0 ||
+        t->buf()->ndim() != roots.front()->buf()->ndim() ||
+        !sameExtent(t->buf()->dim(0), roots.front()->buf()->dim(0))) {
+      throw std::runtime_error(
+          "Reductions on CUDA need all outputs to have the same rank and "
+          "size of dimension 0");
+    }
+  }
+
+  int blockSize = getTECudaPointwiseBlockSize();
+  const int kDefaultBlockSize = 256;
+  blockSize = (blockSize > 0) ? blockSize : kDefaultBlockSize;
+  for (Tensor* t : roots) {
+    std::vector<For*> loops = l.getLoopStmtsFor(t);
+    l.setGPUBlockIndex(loops.front(), 0);
+    if (isReduction(t) || loops.size() < 2) {
+      continue;
+    }
+    For* outer;
+    For* inner;
+    l.splitWithMask(loops.back(), blockSize, &outer, &inner);
+    l.setGPUThreadIndex(inner, 0);
+  }
+}
+
 Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
   flattenTensors(backendType);
 
-  torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
+  std::vector<Tensor*> roots(flatTensorOutputs_);
+  roots.insert(roots.end(), scratchTensors_.begin(), scratchTensors_.end());
+  torch::jit::tensorexpr::LoopNest l(roots);
   GRAPH_DEBUG("Original Stmt:\n", std::to_string(l.root_stmt()), "\n");
 
-  // Compute non-output tensors_ inline
+  // Compute non-output tensors_ inline, except for reductions, which are
+  // computed once into their own buffers.
   for (auto& p : tensors_) {
-    if (!l.hasLoopBodyFor(p.second)) {
+    if (!l.hasLoopBodyFor(p.second) || isReduction(p.second)) {
       continue;
     }
     Stmt* loop = l.getLoopBodyFor(p.second);
@@ -1280,7 +1686,9 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       l.computeInline(loop);
     }
   }
-  if (backendType == kCudaCodeGen) {
+  if (backendType == kCudaCodeGen && !reductions_.empty()) {
+    scheduleRowsForCuda(l);
+  } else if (backendType == kCudaCodeGen) {
     for (size_t i = 0; i < flatTensorOutputs_.size(); i++) {
       Tensor* tensor = flatTensorOutputs_[i];
 
@@ -1331,26 +1739,7 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
   if (backendType == kLLVMCodeGen) {
     std::vector<For*> innerLoops;
-    std::vector<For*> worklist;
-
-    // Find outer-most For loops
-    if (For* rootF = dynamic_cast<For*>(l.root_stmt())) {
-      worklist.push_back(rootF);
-    } else if (Block* body = dynamic_cast<Block*>(l.root_stmt())) {
-      std::vector<Block*> blocks = {body};
-      while (blocks.size()) {
-        Block* b = blocks.back();
-        blocks.pop_back();
-
-        for (Stmt* s : *b) {
-          if (For* f = dynamic_cast<For*>(s)) {
-            worklist.push_back(f);
-          } else if (Block* b2 = dynamic_cast<Block*>(s)) {
-            blocks.push_back(b2);
-          }
-        }
-      }
-    }
+    std::vector<For*> worklist = findOuterLoops(l.root_stmt());
 
     // Traverse the For loop nest find inner-most loops, which are
     // vectorization candidates.
@@ -1373,25 +1762,41 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       }
     }
 
-    // vectorize inner loops.
+    // vectorize inner loops. Loops that accumulate into a reduction are left
+    // alone, since every iteration depends on the previous one.
     for (For* loop : innerLoops) {
+      if (isReductionLoop(loop)) {
+        continue;
+      }
+      const int bodyVectorWidth = vectorLanesFor(loop);
+      if (bodyVectorWidth < 2) {
+        continue;
+      }
       For* outer1;
       For* split1;
       For* tail1;
 
-      static const int kBodyVectorWidth = 8;
-      l.splitWithTail(loop, kBodyVectorWidth, &outer1, &split1, &tail1);
+      l.splitWithTail(loop, bodyVectorWidth, &outer1, &split1, &tail1);
       l.vectorize(split1);
 
-      if (tail1) {
+      const int tailVectorWidth = bodyVectorWidth / 2;
+      if (tail1 && tailVectorWidth >= 2) {
         For* outer2;
         For* split2;
         For* tail2;
-        static const int kTailVectorWidth = 4;
-        l.splitWithTail(tail1, kTailVectorWidth, &outer2, &split2, &tail2);
+        l.splitWithTail(tail1, tailVectorWidth, &outer2, &split2, &tail2);
         l.vectorize(split2);
       }
     }
+
+    // Run the outer-most loops on the intra-op thread pool. Their iterations
+    // write disjoint parts of the outputs, unless they accumulate into a
+    // reduction.
+    for (For* loop : findOuterLoops(l.root_stmt())) {
+      if (!isReductionLoop(loop)) {
+        l.setParallel(loop);
+      }
+    }
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1430,6 +1835,9 @@ std::vector<CodeGen::BufferArg> TensorExprKernel::prepareBufferArgs() {
   for (auto& o : flatTensorOutputs_) {
     params.emplace_back(o);
   }
+  for (auto& t : scratchTensors_) {
+    params.emplace_back(t);
+  }
   return params;
 }
 
@@ -1552,11 +1960,25 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
           ToDtype(static_cast<ScalarType>(*tt->scalarType())),
           {0});
       std::vector<DimArg> inputTensorDims;
+      std::vector<ShapeArg> sizeArgs;
       for (size_t i = 0; i < *tt->sizes().size(); i++) {
         auto const size = *tt->sizes()[i];
+        if (i == 0 && batchSize_) {
+          inputTensorDims.emplace_back(DimArg(*batchSize_, "i0"));
+          continue;
+        }
         inputTensorDims.emplace_back(
             DimArg(IntImm::make(size), "i" + c10::to_string(i)));
       }
+      // All tensors have the same batch size, so it is passed to the kernel
+      // only once, with the first tensor input.
+      if (batchSize_ &&
+          std::none_of(
+              kernelArgs_.begin(), kernelArgs_.end(), [](const KernelArg& a) {
+                return !a.sizes().empty();
+              })) {
+        sizeArgs.emplace_back(0, *batchSize_);
+      }
       auto const strides = tt->strides();
       tensors_.emplace(
           input->unique(),
@@ -1571,7 +1993,7 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
                 return inBuffer(idx);
               }));
       kernelArgs_.emplace_back(
-          inBuffer, std::vector<ShapeArg>(), std::vector<ShapeArg>());
+          inBuffer, std::move(sizeArgs), std::vector<ShapeArg>());
       break;
     }
     case TypeKind::FloatType: {
@@ -1599,14 +2021,88 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
   }
 }
 
+bool TensorExprKernel::canUseSymbolicBatchDim() {
+  if (!getTESymbolicBatchDim()) {
+    return false;
+  }
+
+  // Every tensor has to have the same rank and batch size, so that dimension
+  // 0 of each of them is the batch dimension.
+  c10::optional<size_t> rank;
+  c10::optional<int64_t> batchSize;
+  auto sameBatch = [&](const torch::jit::Value* v) {
+    auto tt = v->type()->cast<TensorType>();
+    if (!tt || !tt->isComplete()) {
+      return true;
+    }
+    auto sizes = *tt->sizes().concrete_sizes();
+    if (sizes.empty()) {
+      return false;
+    }
+    if (!rank) {
+      rank = sizes.size();
+      batchSize = sizes[0];
+    }
+    return sizes.size() == *rank && sizes[0] == *batchSize;
+  };
+  for (auto const& input : graph_->inputs()) {
+    if (!sameBatch(input)) {
+      return false;
+    }
+  }
+  // A batch size of one could be broadcast against other sizes.
+  if (!batchSize || *batchSize == 1) {
+    return false;
+  }
+
+  for (auto const& n : graph_->nodes()) {
+    switch (n->kind()) {
+      // These compute sizes from particular dimensions of their inputs.
+      case prim::ConstantChunk:
+      case prim::ListConstruct:
+      case aten::cat:
+      case aten::slice:
+      case aten::unsqueeze:
+        return false;
+      // Which dims these keep can only be checked on complete types.
+      case aten::sum:
+      case aten::mean:
+      case aten::softmax:
+      case aten::log_softmax:
+      case aten::layer_norm:
+        if (!n->output()->isCompleteTensor()) {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+    for (auto const& output : n->outputs()) {
+      if (!sameBatch(output)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void TensorExprKernel::compile() {
   KernelScope kernelScope(&kernelArena_);
 
+  if (canUseSymbolicBatchDim()) {
+    batchSize_ = VarHandle("batch_size", kInt);
+  }
+
   // Bind inputs to buffers.
   nInputs_ = graph_->inputs().size();
   for (auto const& input : graph_->inputs()) {
     bindInput(input);
     inputTypes_.push_back(input->type());
+    auto tt = input->type()->cast<TensorType>();
+    inputSizes_.push_back(
+        tt ? *tt->sizes().concrete_sizes() : std::vector<int64_t>());
+    inputStrides_.push_back(
+        tt ? *tt->strides().concrete_sizes() : std::vector<int64_t>());
   }
 
   // Bind nodes to tensor compute expressions.
@@ -1634,6 +2130,12 @@ void TensorExprKernel::compile() {
     tensorOutputs_.emplace_back(tensors_.at(output->unique()));
     tensors_.erase(output->unique());
   }
+  for (Tensor* t : reductions_) {
+    if (std::find(tensorOutputs_.begin(), tensorOutputs_.end(), t) ==
+        tensorOutputs_.end()) {
+      scratchTensors_.push_back(t);
+    }
+  }
 
   device_ = pickDeviceType(graph_->inputs());
   BackendType backendType = inferBackendTypeFromDevice(device_);
@@ -1660,7 +2162,117 @@ TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
   }
 }
 
+size_t TensorExprKernel::numSpecializations() {
+  std::lock_guard<std::mutex> guard(specializationsMutex_);
+  return specializations_.size();
+}
+
+bool TensorExprKernel::inputsMatch(const at::ArrayRef<IValue>& inputs) {
+  c10::optional<int64_t> batchSize;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto tt = inputTypes_[i]->cast<TensorType>();
+    if (!tt) {
+      continue;
+    }
+    if (!inputs[i].isTensor()) {
+      return false;
+    }
+    auto const& t = inputs[i].toTensor();
+    auto const& sizes = inputSizes_[i];
+    auto const& strides = inputStrides_[i];
+    if (!isValidPrimProperty(tt->scalarType(), t.scalar_type()) ||
+        !isValidPrimProperty(tt->device(), t.device()) ||
+        t.dim() != static_cast<int64_t>(sizes.size())) {
+      return false;
+    }
+    for (size_t d = 0; d < sizes.size(); d++) {
+      if (t.stride(d) != strides[d]) {
+        return false;
+      }
+      if (d == 0 && batchSize_) {
+        if (!batchSize) {
+          batchSize = t.size(0);
+        } else if (t.size(0) != *batchSize) {
+          return false;
+        }
+      } else if (t.size(d) != sizes[d]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Note [Kernel specializations]
+// A kernel is compiled for the input shapes recorded in its subgraph (up to
+// the batch size, if it is symbolic). When it is called with other shapes, it
+// compiles a copy of the subgraph specialized to them and keeps the
+// getTEKernelCacheSize() most recently used of these around. Inputs of
+// another dtype or device, and tensors passed for non-tensor inputs, run
+// in the interpreter.
+std::shared_ptr<TensorExprKernel> TensorExprKernel::specializationFor(
+    const at::ArrayRef<IValue>& inputs) {
+  {
+    std::lock_guard<std::mutex> guard(specializationsMutex_);
+    for (auto it = specializations_.begin(); it != specializations_.end();
+         ++it) {
+      if ((*it)->inputsMatch(inputs)) {
+        specializations_.splice(
+            specializations_.begin(), specializations_, it);
+        return specializations_.front();
+      }
+    }
+  }
+  if (getTEKernelCacheSize() <= 0) {
+    return nullptr;
+  }
+
+  auto graph = graph_->copy();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto tt = graph->inputs()[i]->type()->cast<TensorType>();
+    if (!tt) {
+      continue;
+    }
+    if (!inputs[i].isTensor()) {
+      return nullptr;
+    }
+    auto const& t = inputs[i].toTensor();
+    if (!isValidPrimProperty(tt->scalarType(), t.scalar_type()) ||
+        !isValidPrimProperty(tt->device(), t.device())) {
+      return nullptr;
+    }
+    graph->inputs()[i]->setType(tt->withSizesStrides(t.sizes(), t.strides()));
+  }
+  // The sizes of the other values are inferred from the new input sizes.
+  for (auto const& n : graph->nodes()) {
+    for (auto const& output : n->outputs()) {
+      if (auto tt = output->type()->cast<TensorType>()) {
+        output->setType(tt->dimensionedOnly());
+      }
+    }
+  }
+  auto kernel = std::make_shared<TensorExprKernel>(graph);
+  GRAPH_DEBUG("Specialized TensorExpr kernel to new input shapes:\n", *graph);
+
+  std::lock_guard<std::mutex> guard(specializationsMutex_);
+  specializations_.push_front(kernel);
+  while (specializations_.size() >
+         static_cast<size_t>(getTEKernelCacheSize())) {
+    specializations_.pop_back();
+  }
+  return kernel;
+}
+
 void TensorExprKernel::run(Stack& stack) {
+  if (!fallback_ && !inputsMatch(last(stack, nInputs_))) {
+    if (auto kernel = specializationFor(last(stack, nInputs_))) {
+      kernel->run(stack);
+    } else {
+      fallback(stack);
+    }
+    return;
+  }
+
   if (!fallbackAllowed()) {
     runKernel(stack);
     return;
@@ -1680,7 +2292,8 @@ void TensorExprKernel::run(Stack& stack) {
 
 std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
     const at::ArrayRef<IValue>& inputs,
-    std::vector<at::Tensor>& outputs) {
+    std::vector<at::Tensor>& outputs,
+    std::vector<at::Tensor>& scratch) {
   std::map<const Expr*, int32_t> varToSize;
 
   std::vector<CodeGen::CallArg> runArgs;
@@ -1705,7 +2318,7 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
     }
   }
 
-  for (auto& o : tensorOutputs_) {
+  auto allocate = [&](Tensor* o) {
     std::vector<int64_t> tensorSize;
     for (const Expr* dim : o->dims()) {
       auto it = varToSize.find(dim);
@@ -1719,11 +2332,18 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
         tensorSize.push_back(s->value());
       }
     }
+    return at::empty(
+        tensorSize, c10::TensorOptions(tensorType(o)).device(device_));
+  };
 
-    outputs.push_back(at::empty(
-        tensorSize, c10::TensorOptions(tensorType(o)).device(device_)));
+  for (auto& o : tensorOutputs_) {
+    outputs.push_back(allocate(o));
     runArgs.emplace_back(outputs.back().data_ptr());
   }
+  for (auto& t : scratchTensors_) {
+    scratch.push_back(allocate(t));
+    runArgs.emplace_back(scratch.back().data_ptr());
+  }
   return runArgs;
 }
 
@@ -1737,8 +2357,10 @@ void TensorExprKernel::runKernel(Stack& stack) {
   // Set up arguments (inputs, then outputs) for kernel call.
   auto inputs = last(stack, nInputs_);
   std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> scratch;
 
-  std::vector<CodeGen::CallArg> runArgs = prepareRunArgs(inputs, outputs);
+  std::vector<CodeGen::CallArg> runArgs =
+      prepareRunArgs(inputs, outputs, scratch);
 
   // Call the kernel.
   codegen_->call(runArgs);
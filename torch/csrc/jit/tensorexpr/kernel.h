@@ -3,12 +3,18 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/tensorexpr/codegen.h>
+#include <torch/csrc/jit/tensorexpr/reduction.h>
 #include <torch/csrc/jit/tensorexpr/tensor.h>
 
+#include <list>
+#include <mutex>
+
 namespace torch {
 namespace jit {
 namespace tensorexpr {
 
+class LoopNest;
+
 template <typename T>
 inline std::vector<int64_t> bufferSizes(const T& t) {
   std::vector<int64_t> sizes;
@@ -30,6 +36,16 @@ class TORCH_API TensorExprKernel {
 
   Stmt* getCodeGenStmt();
 
+  // True if the kernel was compiled with a symbolic size for dimension 0 of
+  // its tensors, so that it runs on any batch size without recompiling.
+  bool hasSymbolicBatchDim() const {
+    return batchSize_.has_value();
+  }
+
+  // Number of kernels compiled for input shapes the subgraph was not
+  // specialized to (see Note [Kernel specializations]).
+  size_t numSpecializations();
+
  private:
   enum BackendType {
     kUninitialized,
@@ -113,9 +129,20 @@ class TORCH_API TensorExprKernel {
           const ExprHandle&,
           const ExprHandle&)>& innerExpr);
 
+  // Reduces a value of the given sizes over dims (sorted). body returns the
+  // value at the given input indices.
+  Tensor* computeReduction(
+      const std::string& name,
+      const Reducer& reducer,
+      const std::vector<ExprHandle>& sizes,
+      const std::vector<size_t>& dims,
+      bool keepdim,
+      const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
+  void scheduleRowsForCuda(LoopNest& l);
   Stmt* generateStmt(BackendType backendType);
   std::vector<CodeGen::BufferArg> prepareBufferArgs();
 
@@ -123,12 +150,18 @@ class TORCH_API TensorExprKernel {
 
   std::vector<CodeGen::CallArg> prepareRunArgs(
       const at::ArrayRef<IValue>& inputs,
-      std::vector<at::Tensor>& outputs);
+      std::vector<at::Tensor>& outputs,
+      std::vector<at::Tensor>& scratch);
   BackendType inferBackendTypeFromDevice(at::Device device);
   at::Device pickDeviceType(const at::ArrayRef<torch::jit::Value*>& inputs);
 
   void bindInput(const torch::jit::Value* input);
 
+  bool canUseSymbolicBatchDim();
+  bool inputsMatch(const at::ArrayRef<IValue>& inputs);
+  std::shared_ptr<TensorExprKernel> specializationFor(
+      const at::ArrayRef<IValue>& inputs);
+
  private:
   struct ShapeArg {
     size_t idx;
@@ -168,12 +201,19 @@ class TORCH_API TensorExprKernel {
   std::vector<KernelArg> kernelArgs_;
   std::vector<Tensor*> tensorOutputs_;
   std::vector<Tensor*> flatTensorOutputs_;
+  std::vector<Tensor*> reductions_;
+  // Reductions that are not outputs. Their results are stored in buffers the
+  // kernel allocates for each call, so that they work on every backend.
+  std::vector<Tensor*> scratchTensors_;
   std::unordered_map<int64_t, Tensor*> tensors_;
   std::unordered_map<int64_t, VarHandle> scalars_;
   std::unique_ptr<CodeGen> codegen_;
   at::Device device_ = at::kCPU;
   KernelArena kernelArena_;
   std::vector<TypePtr> inputTypes_;
+  // Sizes and strides of the tensor inputs; empty for other inputs.
+  std::vector<std::vector<int64_t>> inputSizes_;
+  std::vector<std::vector<int64_t>> inputStrides_;
   std::shared_ptr<Graph> graph_;
   Code code_;
   bool fallback_{false};
@@ -181,11 +221,18 @@ class TORCH_API TensorExprKernel {
   bool hasBroadcast_{false};
   std::unordered_map<const torch::jit::Value*, std::vector<ExprHandle>>
       known_sizes_;
+  // Size of dimension 0 of every tensor, if it is symbolic.
+  c10::optional<VarHandle> batchSize_;
+  // Most recently used first; at most getTEKernelCacheSize() entries.
+  std::list<std::shared_ptr<TensorExprKernel>> specializations_;
+  std::mutex specializationsMutex_;
 };
 
 TORCH_API int& getTECudaPointwiseLoopLevels();
 TORCH_API int& getTECudaPointwiseBlockCount();
 TORCH_API int& getTECudaPointwiseBlockSize();
+TORCH_API bool& getTESymbolicBatchDim();
+TORCH_API int& getTEKernelCacheSize();
 TORCH_API bool fallbackAllowed();
 TORCH_API bool setFallbackAllowed(bool value);
 
@@ -3,7 +3,11 @@
 #include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
+
+#include <algorithm>
 #include <memory>
+#include <unordered_set>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
@@ -59,6 +63,12 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  void emitLoop(
+      const Var* var,
+      llvm::Value* start,
+      llvm::Value* stop,
+      const Block* body);
+  void emitParallelFor(const For* v);
 
  public:
   LLVMCodeGenImpl(
@@ -964,12 +974,24 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
   v->stop()->accept(this);
   auto stop = this->value_;
+  emitLoop(v->var(), start, stop, v->body());
+}
 
+void LLVMCodeGenImpl::emitLoop(
+    const Var* var,
+    llvm::Value* start,
+    llvm::Value* stop,
+    const Block* body_stmt) {
   // Create block for loop condition test.
   auto preheader = irb_.GetInsertBlock();
   auto condBlock = llvm::BasicBlock::Create(getContext(), "cond", fn_);
@@ -979,8 +1001,8 @@ void LLVMCodeGenImpl::visit(const For* v) {
   // Set up phi node for index variable.
   auto idx = irb_.CreatePHI(IntTy_, 2);
   idx->addIncoming(start, preheader);
-  if (!varToVal_.count(v->var())) {
-    varToVal_.emplace(v->var(), idx);
+  if (!varToVal_.count(var)) {
+    varToVal_.emplace(var, idx);
   } else {
     throw std::runtime_error("var should not exist before");
   }
@@ -995,8 +1017,8 @@ void LLVMCodeGenImpl::visit(const For* v) {
 
   // Codegen the body.
   irb_.SetInsertPoint(body);
-  if (v->body()) {
-    v->body()->accept(this);
+  if (body_stmt) {
+    body_stmt->accept(this);
   }
   // "Body" block may have changed if we generated nested control flow.
   body = irb_.GetInsertBlock();
@@ -1009,7 +1031,152 @@ void LLVMCodeGenImpl::visit(const For* v) {
   // Exit the loop.
   irb_.SetInsertPoint(exit);
 
-  varToVal_.erase(v->var());
+  varToVal_.erase(var);
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
+namespace {
+
+// Collects the variables a statement refers to, in the order it refers to
+// them, so that the generated code does not depend on pointer values.
+class VarCollector : public IRVisitor {
+ public:
+  const std::vector<const Var*>& vars() const {
+    return vars_;
+  }
+
+  void visit(const Var* v) override {
+    if (seen_.insert(v).second) {
+      vars_.push_back(v);
+    }
+  }
+
+ private:
+  std::vector<const Var*> vars_;
+  std::unordered_set<const Var*> seen_;
+};
+
+// Roughly how many elements one iteration of a loop body computes, counting
+// the iterations of nested loops with constant bounds.
+int64_t elementsPerIteration(const Stmt* s) {
+  if (auto block = dynamic_cast<const Block*>(s)) {
+    int64_t elements = 0;
+    for (const Stmt* stmt : *block) {
+      elements += elementsPerIteration(stmt);
+    }
+    return elements;
+  }
+  if (auto loop = dynamic_cast<const For*>(s)) {
+    auto start = dynamic_cast<const IntImm*>(loop->start());
+    auto stop = dynamic_cast<const IntImm*>(loop->stop());
+    int64_t trips = (start && stop) ? stop->value() - start->value() : 1;
+    return std::max<int64_t>(trips, 1) * elementsPerIteration(loop->body());
+  }
+  if (auto cond = dynamic_cast<const Cond*>(s)) {
+    return std::max(
+        cond->true_stmt() ? elementsPerIteration(cond->true_stmt()) : 0,
+        cond->false_stmt() ? elementsPerIteration(cond->false_stmt()) : 0);
+  }
+  if (auto store = dynamic_cast<const Store*>(s)) {
+    return store->value()->dtype().lanes();
+  }
+  return 0;
+}
+
+} // namespace
+
+// Emits a parallel loop as a call to nnc_parallel_for (see llvm_jit.cpp),
+// which runs chunks of the iteration space on the intra-op thread pool. The
+// loop is outlined into a function that runs one chunk; the values it uses
+// from the enclosing function are passed to it in a struct.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = irb_.CreateSExt(value_, LongTy_);
+  v->stop()->accept(this);
+  auto stop = irb_.CreateSExt(value_, LongTy_);
+
+  VarCollector collector;
+  v->body()->accept(&collector);
+  std::vector<const Var*> captured;
+  std::vector<llvm::Value*> capturedValues;
+  std::vector<llvm::Type*> capturedTypes;
+  for (const Var* var : collector.vars()) {
+    llvm::Value* value = nullptr;
+    if (varToArg_.count(var)) {
+      value = fn_->arg_begin() + varToArg_.at(var);
+    } else if (varToVal_.count(var)) {
+      value = varToVal_.at(var);
+    } else {
+      // Defined in the body.
+      continue;
+    }
+    captured.push_back(var);
+    capturedValues.push_back(value);
+    capturedTypes.push_back(value->getType());
+  }
+
+  auto envTy = llvm::StructType::get(getContext(), capturedTypes);
+  llvm::IRBuilder<> entryBuilder(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto env = entryBuilder.CreateAlloca(envTy);
+  for (size_t i = 0; i < capturedValues.size(); i++) {
+    irb_.CreateStore(capturedValues[i], irb_.CreateStructGEP(envTy, env, i));
+  }
+
+  auto voidTy = llvm::Type::getVoidTy(getContext());
+  auto voidPtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(voidTy, {LongTy_, LongTy_, voidPtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+
+  // Emit the body into the outlined function. Only the captured values are
+  // visible there.
+  auto callerFn = fn_;
+  auto callerBlock = irb_.GetInsertBlock();
+  auto callerVarToArg = std::move(varToArg_);
+  auto callerVarToVal = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto args = bodyFn->arg_begin();
+  llvm::Value* begin = irb_.CreateTrunc(args, IntTy_);
+  llvm::Value* end = irb_.CreateTrunc(args + 1, IntTy_);
+  auto bodyEnv = irb_.CreatePointerCast(args + 2, envTy->getPointerTo());
+  for (size_t i = 0; i < captured.size(); i++) {
+    varToVal_[captured[i]] = irb_.CreateLoad(
+        capturedTypes[i], irb_.CreateStructGEP(envTy, bodyEnv, i));
+  }
+  emitLoop(v->var(), begin, end, v->body());
+  irb_.CreateRetVoid();
+
+  fn_ = callerFn;
+  varToArg_ = std::move(callerVarToArg);
+  varToVal_ = std::move(callerVarToVal);
+  irb_.SetInsertPoint(callerBlock);
+
+  // Chunks of at::internal::GRAIN_SIZE elements amortize the cost of
+  // dispatching them to other threads.
+  const int64_t grainSize = std::max<int64_t>(
+      1,
+      at::internal::GRAIN_SIZE /
+          std::max<int64_t>(elementsPerIteration(v->body()), 1));
+  auto parallelFor = module_->getOrInsertFunction(
+      "nnc_parallel_for",
+      llvm::FunctionType::get(
+          voidTy,
+          {LongTy_, LongTy_, LongTy_, bodyFn->getType(), voidPtrTy},
+          false));
+  irb_.CreateCall(
+      parallelFor,
+      {start,
+       stop,
+       llvm::ConstantInt::getSigned(LongTy_, grainSize),
+       bodyFn,
+       irb_.CreatePointerCast(env, voidPtrTy)});
   value_ = llvm::ConstantInt::get(IntTy_, 0);
 }
 
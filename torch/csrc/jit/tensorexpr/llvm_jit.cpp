@@ -2,7 +2,16 @@
 
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
+#include <torch/csrc/jit/codegen/disk_cache.h>
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
 #include <sleef.h>
 #include <algorithm>
 #include <memory>
@@ -12,14 +21,99 @@
 namespace llvm {
 namespace orc {
 
+namespace {
+
+// Keeps the object code of compiled modules in the kernel disk cache. The
+// object code depends only on the (already optimized) IR and the target.
+class DiskObjectCache : public ObjectCache {
+ public:
+  void setTarget(const TargetMachine& TM) {
+    Target = TM.getTargetTriple().str() + " " + TM.getTargetCPU().str() + " " +
+        TM.getTargetFeatureString().str();
+  }
+
+  void notifyObjectCompiled(const Module* M, MemoryBufferRef Obj) override {
+    if (!torch::jit::getKernelDiskCacheDirectory().empty()) {
+      torch::jit::storeCachedKernel(cacheKey(*M), Obj.getBuffer().str());
+    }
+  }
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module* M) override {
+    if (torch::jit::getKernelDiskCacheDirectory().empty()) {
+      return nullptr;
+    }
+    auto cached = torch::jit::loadCachedKernel(cacheKey(*M));
+    if (!cached) {
+      return nullptr;
+    }
+    return MemoryBuffer::getMemBufferCopy(*cached);
+  }
+
+ private:
+  std::string cacheKey(const Module& M) const {
+    std::string key;
+    raw_string_ostream os(key);
+    os << "tensorexpr llvm " << LLVM_VERSION_STRING << " " << Target << "\n";
+    M.print(os, nullptr);
+    return os.str();
+  }
+
+  std::string Target;
+};
+
+#if LLVM_VERSION_MAJOR >= 11
+using CompileFunction = std::unique_ptr<IRCompileLayer::IRCompiler>;
+#else
+using CompileFunction = IRCompileLayer::CompileFunction;
+#endif
+
+std::unique_ptr<LLJIT> createLLJIT(DiskObjectCache* ObjCache) {
+  return cantFail(
+      LLJITBuilder()
+          .setCompileFunctionCreator(
+              [ObjCache](JITTargetMachineBuilder JTMB)
+                  -> Expected<CompileFunction> {
+                auto TM = JTMB.createTargetMachine();
+                if (!TM) {
+                  return TM.takeError();
+                }
+                ObjCache->setTarget(**TM);
+#if LLVM_VERSION_MAJOR >= 11
+                return std::make_unique<TMOwningSimpleCompiler>(
+                    std::move(*TM), ObjCache);
+#else
+                return CompileFunction(
+                    TMOwningSimpleCompiler(std::move(*TM), ObjCache));
+#endif
+              })
+          .create());
+}
+
+// Generated code calls this for loops marked parallel, with the loop body
+// outlined into body.
+void nncParallelFor(
+    int64_t start,
+    int64_t stop,
+    int64_t grain_size,
+    void (*body)(int64_t, int64_t, void*),
+    void* env) {
+  at::parallel_for(start, stop, grain_size, [body, env](int64_t b, int64_t e) {
+    body(b, e, env);
+  });
+}
+
+} // namespace
+
 // Lightly modified implementation from LLVM's Kaleidoscope JIT tutorial:
 // https://llvm.org/docs/tutorial/BuildingAJIT1.html
 class TORCH_API PytorchLLVMJITImpl {
  private:
+  // Declared before LLJ, which refers to it.
+  DiskObjectCache ObjCache;
   std::unique_ptr<LLJIT> LLJ;
 
  public:
-  PytorchLLVMJITImpl() : LLJ(cantFail(LLJITBuilder().create())) {
+  PytorchLLVMJITImpl() : LLJ(createLLJIT(&ObjCache)) {
     auto ProcSymbolsGenerator =
         cantFail(DynamicLibrarySearchGenerator::GetForCurrentProcess(
             LLJ->getDataLayout().getGlobalPrefix()));
@@ -28,6 +122,10 @@ class TORCH_API PytorchLLVMJITImpl {
     // Handle platform-specific symbol mangling
     MangleAndInterner Mangle(LLJ->getExecutionSession(), LLJ->getDataLayout());
 
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("nnc_parallel_for"),
+        {llvm::pointerToJITTargetAddress(&nncParallelFor), {}}));
+
     // Register implementations of intrinsics
     cantFail(LLJ->defineAbsolute(
         *Mangle("log10f"), {llvm::pointerToJITTargetAddress(&log10f), {}}));
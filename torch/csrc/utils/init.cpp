@@ -17,11 +17,27 @@ void initThroughputBenchmarkBindings(PyObject* module) {
       .def_readwrite("num_worker_threads", &BenchmarkConfig::num_worker_threads)
       .def_readwrite("num_warmup_iters", &BenchmarkConfig::num_warmup_iters)
       .def_readwrite("num_iters", &BenchmarkConfig::num_iters)
-      .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path);
+      .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path)
+      .def_readwrite("cpu_affinity", &BenchmarkConfig::cpu_affinity)
+      .def_readwrite("target_qps", &BenchmarkConfig::target_qps)
+      .def_readwrite("profile_memory", &BenchmarkConfig::profile_memory);
 
   py::class_<BenchmarkExecutionStats>(m, "BenchmarkExecutionStats")
       .def_readonly("latency_avg_ms", &BenchmarkExecutionStats::latency_avg_ms)
-      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters);
+      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters)
+      .def_readonly("total_time_ms", &BenchmarkExecutionStats::total_time_ms)
+      .def_readonly("latency_p50_ms", &BenchmarkExecutionStats::latency_p50_ms)
+      .def_readonly("latency_p90_ms", &BenchmarkExecutionStats::latency_p90_ms)
+      .def_readonly("latency_p99_ms", &BenchmarkExecutionStats::latency_p99_ms)
+      .def_readonly("latency_p999_ms", &BenchmarkExecutionStats::latency_p999_ms)
+      .def_readonly("cold_latency_ms", &BenchmarkExecutionStats::cold_latency_ms)
+      .def_readonly(
+          "warmup_latency_avg_ms", &BenchmarkExecutionStats::warmup_latency_avg_ms)
+      .def_readonly(
+          "allocations_per_iter", &BenchmarkExecutionStats::allocations_per_iter)
+      .def_readonly(
+          "allocated_bytes_per_iter",
+          &BenchmarkExecutionStats::allocated_bytes_per_iter);
 
   py::class_<ThroughputBenchmark>(m, "ThroughputBenchmark", py::dynamic_attr())
       .def(py::init<jit::Module>())
@@ -9,6 +9,7 @@
 #include <ATen/ATen.h>
 #include <ATen/TracerMode.h>
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -845,6 +846,24 @@ PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
     [](const FunctionSignature & sig) {
       return !sig.deprecated;
     });
+
+  // Precompute, for each number of positional arguments passed without
+  // keywords, the signatures that can possibly accept it (in order), so that
+  // calls to heavily overloaded functions don't type-check signatures that
+  // would fail on the argument count anyway. The last bucket holds the
+  // signatures taking var-args IntArrayRefs, for any larger count.
+  signatures_by_nargs_.resize(max_args + 2);
+  for (size_t idx = 0; idx < signatures_.size(); ++idx) {
+    auto& signature = signatures_[idx];
+    bool varargs_intlist = signature.max_pos_args == 1 &&
+        signature.params[0].type_ == ParameterType::INT_LIST;
+    for (ssize_t nargs = 0; nargs <= max_args + 1; ++nargs) {
+      if (nargs >= signature.min_args &&
+          (nargs <= signature.max_pos_args || varargs_intlist)) {
+        signatures_by_nargs_[nargs].push_back(idx);
+      }
+    }
+  }
 }
 
 void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
@@ -873,10 +892,21 @@ PythonArgs PythonArgParser::raw_parse(PyObject* self, PyObject* args, PyObject*
     return PythonArgs(traceable, signature, parsed_args);
   }
 
-  for (auto& signature : signatures_) {
-    if (signature.parse(self, args, kwargs, parsed_args, false)) {
-      check_deprecated(signature);
-      return PythonArgs(traceable, signature, parsed_args);
+  if (!kwargs || PyDict_Size(kwargs) == 0) {
+    ssize_t nargs = args ? PyTuple_GET_SIZE(args) : 0;
+    for (auto idx : signatures_by_nargs_[std::min(nargs, max_args + 1)]) {
+      auto& signature = signatures_[idx];
+      if (signature.parse(self, args, kwargs, parsed_args, false)) {
+        check_deprecated(signature);
+        return PythonArgs(traceable, signature, parsed_args);
+      }
+    }
+  } else {
+    for (auto& signature : signatures_) {
+      if (signature.parse(self, args, kwargs, parsed_args, false)) {
+        check_deprecated(signature);
+        return PythonArgs(traceable, signature, parsed_args);
+      }
     }
   }
 
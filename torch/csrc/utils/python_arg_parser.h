@@ -115,6 +115,9 @@ private:
   PythonArgs raw_parse(PyObject* self, PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
   std::vector<FunctionSignature> signatures_;
+  // Indices into signatures_ of the candidates for a call with N positional
+  // and no keyword arguments (see constructor)
+  std::vector<std::vector<size_t>> signatures_by_nargs_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
@@ -170,6 +170,14 @@ void initDispatchBindings(PyObject* module) {
   m.def("_dispatch_check_all_invariants", []() {
     c10::Dispatcher::singleton().checkInvariants();
   });
+
+  m.def("_dispatch_set_autograd_fast_path_enabled", [](bool enabled) {
+    c10::Dispatcher::singleton().setAutogradFastPathEnabled(enabled);
+  });
+
+  m.def("_dispatch_autograd_fast_path_enabled", []() {
+    return c10::Dispatcher::singleton().isAutogradFastPathEnabled();
+  });
 }
 
 }}} // namespace torch::impl::dispatch
@@ -691,6 +691,60 @@ void _validate_sparse_coo_tensor_args(c10::DispatchKey dispatch_key, at::ScalarT
   at::native::_validate_sparse_coo_tensor_args(indices, values, r.intlist(2));
 }
 
+namespace {
+
+// Shared by torch.sparse_csr_tensor and torch._sparse_csr_tensor_unsafe,
+// which only differ in checking the contents of the indices. Like the values,
+// the indices keep the dtype of tensor arguments (int32 or int64), and are
+// int64 when inferred from Python data.
+Tensor sparse_csr_tensor_ctor_worker(c10::DispatchKey dispatch_key, at::ScalarType scalar_type,
+                                     PyObject* args, PyObject* kwargs, bool validate) {
+  enum {
+    ARG_CROW_INDICES = 0,
+    ARG_COL_INDICES,
+    ARG_VALUES,
+    ARG_SIZE,
+    ARG_TYPE,
+    ARG_DEVICE,
+    ARG_REQUIRES_GRAD,
+    ARGS_COUNT
+  };
+  static PythonArgParser parser({
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, IntArrayRef size, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+  });
+
+  ParsedArgs<ARGS_COUNT> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  bool type_inference = r.isNone(ARG_TYPE);
+  const auto inferred_dispatch_key = denseTypeIdWithDefault(r, ARG_DEVICE, dispatch_key);
+  const auto inferred_scalar_type = r.scalartypeWithDefault(ARG_TYPE, scalar_type);
+  at::OptionalDeviceGuard device_guard(r.deviceOptional(ARG_DEVICE));
+  Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_VALUES),
+                                         /*copy_variables=*/false, /*copy_numpy=*/true,
+                                         /*type_inference=*/type_inference);
+  Tensor crow_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_CROW_INDICES),
+                                               /*copy_variables=*/false, /*copy_numpy=*/true,
+                                               /*type_inference=*/true);
+  Tensor col_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_COL_INDICES),
+                                              /*copy_variables=*/false, /*copy_numpy=*/true,
+                                              /*type_inference=*/true);
+  if (validate) {
+    at::native::_validate_sparse_csr_tensor_args(crow_indices, col_indices, values, r.intlist(ARG_SIZE));
+  }
+  return at::_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, r.intlist(ARG_SIZE), values.options().layout(at::kSparseCsr))
+      .set_requires_grad(r.toBool(ARG_REQUIRES_GRAD));
+}
+
+} // namespace
+
+Tensor sparse_csr_tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  return sparse_csr_tensor_ctor_worker(dispatch_key, scalar_type, args, kwargs, /*validate=*/true);
+}
+
+Tensor _sparse_csr_tensor_unsafe_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  return sparse_csr_tensor_ctor_worker(dispatch_key, scalar_type, args, kwargs, /*validate=*/false);
+}
+
 Tensor tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
   static PythonArgParser parser({
     "tensor(PyObject* data, *, ScalarType dtype=None, Device? device=None, bool pin_memory=False, bool requires_grad=False, DimnameList? names=None)",
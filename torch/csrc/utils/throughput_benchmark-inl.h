@@ -1,8 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <random>
 #include <thread>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <c10/core/Allocator.h>
+#include <c10/util/ThreadLocalDebugInfo.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/pybind.h>
@@ -13,6 +23,46 @@ namespace torch {
 namespace throughput_benchmark {
 namespace detail {
 
+// Counts the allocations of the thread it is installed on, see
+// BenchmarkConfig::profile_memory
+struct C10_HIDDEN MemoryCounter : public c10::MemoryReportingInfoBase {
+  void reportMemoryUsage(void* /* unused */, int64_t alloc_size, c10::Device)
+      override {
+    if (alloc_size > 0) {
+      ++num_allocations;
+      allocated_bytes += alloc_size;
+    }
+  }
+
+  bool memoryProfilingEnabled() const override {
+    return true;
+  }
+
+  int64_t num_allocations{0};
+  int64_t allocated_bytes{0};
+};
+
+inline void pinCurrentThread(int cpu) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  TORCH_CHECK(err == 0, "Failed to pin a calling thread to CPU ", cpu, ": ", err);
+#else
+  TORCH_WARN_ONCE("CPU affinity of the calling threads is only supported on Linux");
+#endif
+}
+
+// Nearest-rank percentile of sorted latencies
+inline float latencyPercentile(const std::vector<float>& sorted, double q) {
+  if (sorted.empty()) {
+    return -1;
+  }
+  auto rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
 template <class Input, class Output, class Model>
 BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     const BenchmarkConfig& config) const {
@@ -20,6 +70,9 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   TORCH_CHECK(
       config.num_worker_threads == 1,
       "Only parallelization by callers is supported");
+  TORCH_CHECK(
+      config.target_qps >= 0,
+      "Expected a non-negative target QPS, but got ", config.target_qps);
 
   LOG(INFO) << at::get_parallel_info();
 
@@ -48,6 +101,14 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     }
   }
 
+  using Clock = std::chrono::high_resolution_clock;
+  using TimePoint = std::chrono::time_point<Clock>;
+  auto elapsedMs = [](TimePoint from, TimePoint to) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from)
+               .count() /
+        1000.0f / 1000.0f;
+  };
+
   std::mutex m;
   std::condition_variable worker_main_cv;
   std::condition_variable main_worker_cv;
@@ -55,18 +116,32 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   int64_t initialized{0};
   int64_t finished{0};
   bool start{false};
+  TimePoint start_time;
   std::atomic<int64_t> num_attempted_iters{0};
   std::vector<std::thread> callers;
+  // Each of the calling threads only writes to its own entries
+  std::vector<std::vector<float>> warmup_latencies(config.num_calling_threads);
+  std::vector<std::vector<float>> latencies(config.num_calling_threads);
+  std::vector<std::shared_ptr<MemoryCounter>> memory_counters(
+      config.num_calling_threads);
 
   for (auto thread_id = 0; thread_id < config.num_calling_threads;
        ++thread_id) {
     callers.emplace_back([&, thread_id]() {
+      if (!config.cpu_affinity.empty()) {
+        pinCurrentThread(
+            config.cpu_affinity[thread_id % config.cpu_affinity.size()]);
+      }
       // We use conditional variable as a barrier to make sure each thread
       // performs required warmeup iterations before we start measuring
       for (auto j = 0; j < config.num_warmup_iters; ++j) {
+        auto iter_start = Clock::now();
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
+        warmup_latencies[thread_id].push_back(
+            elapsedMs(iter_start, Clock::now()));
         ++input_iters[thread_id];
       }
+      latencies[thread_id].reserve(config.num_iters);
       {
         std::unique_lock<std::mutex> lock(m);
         ++initialized;
@@ -76,10 +151,30 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
         }
       }
       LOG(INFO) << "Starting forward thread " << thread_id;
-      while (num_attempted_iters.fetch_add(1) < config.num_iters) {
+      std::unique_ptr<c10::DebugInfoGuard> memory_guard;
+      if (config.profile_memory) {
+        memory_counters[thread_id] = std::make_shared<MemoryCounter>();
+        memory_guard = std::make_unique<c10::DebugInfoGuard>(
+            c10::DebugInfoKind::PROFILER_STATE, memory_counters[thread_id]);
+      }
+      int64_t iter = 0;
+      while ((iter = num_attempted_iters.fetch_add(1)) < config.num_iters) {
+        TimePoint arrival;
+        if (config.target_qps > 0) {
+          // Open-loop: the iter-th request arrives on schedule, and waits for
+          // a calling thread if all of them are busy
+          arrival = start_time +
+              std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(iter / config.target_qps));
+          std::this_thread::sleep_until(arrival);
+        } else {
+          arrival = Clock::now();
+        }
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
+        latencies[thread_id].push_back(elapsedMs(arrival, Clock::now()));
         ++input_iters[thread_id];
       }
+      memory_guard.reset();
 
       {
         std::unique_lock<std::mutex> lock(m);
@@ -92,10 +187,6 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     });
   }
 
-  using Clock = std::chrono::high_resolution_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
-  TimePoint start_time;
-
   std::unique_ptr<torch::autograd::profiler::RecordProfile> profiler_guard;
   {
     std::unique_lock<std::mutex> lock(m);
@@ -123,20 +214,64 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   profiler_guard.reset();
   LOG(INFO) << "Finished benchmark";
 
+  for (auto& t : callers) {
+    t.join();
+  }
+
   BenchmarkExecutionStats stats;
-  float total_time_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                            end_time - start_time)
-                            .count() /
-      1000.0 / 1000.0;
-  // We use config.num_iters instead of num_attempted_iters as it is
-  // repsesatative of the real work done. Last attempted iteration on each
-  // calling threads doesn't represent the real work (i.e. running the model)
-  stats.latency_avg_ms =
-      total_time_ms * config.num_calling_threads / config.num_iters;
+  float total_time_ms = elapsedMs(start_time, end_time);
+  std::vector<float> all_latencies;
+  all_latencies.reserve(config.num_iters);
+  for (const auto& thread_latencies : latencies) {
+    all_latencies.insert(
+        all_latencies.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  if (config.target_qps > 0) {
+    // The wall time is set by the arrival rate rather than by the latency
+    stats.latency_avg_ms = all_latencies.empty()
+        ? 0
+        : std::accumulate(all_latencies.begin(), all_latencies.end(), 0.0) /
+            all_latencies.size();
+  } else {
+    // We use config.num_iters instead of num_attempted_iters as it is
+    // repsesatative of the real work done. Last attempted iteration on each
+    // calling threads doesn't represent the real work (i.e. running the model)
+    stats.latency_avg_ms =
+        total_time_ms * config.num_calling_threads / config.num_iters;
+  }
   stats.num_iters = config.num_iters;
+  stats.total_time_ms = total_time_ms;
 
-  for (auto& t : callers) {
-    t.join();
+  std::sort(all_latencies.begin(), all_latencies.end());
+  stats.latency_p50_ms = latencyPercentile(all_latencies, 0.5);
+  stats.latency_p90_ms = latencyPercentile(all_latencies, 0.9);
+  stats.latency_p99_ms = latencyPercentile(all_latencies, 0.99);
+  stats.latency_p999_ms = latencyPercentile(all_latencies, 0.999);
+
+  if (config.num_warmup_iters > 0) {
+    float cold_ms = 0;
+    float warmup_ms = 0;
+    for (const auto& thread_latencies : warmup_latencies) {
+      cold_ms += thread_latencies.front();
+      warmup_ms += std::accumulate(
+          thread_latencies.begin(), thread_latencies.end(), 0.0f);
+    }
+    stats.cold_latency_ms = cold_ms / config.num_calling_threads;
+    stats.warmup_latency_avg_ms = warmup_ms /
+        (config.num_calling_threads * config.num_warmup_iters);
+  }
+
+  if (config.profile_memory && config.num_iters > 0) {
+    int64_t num_allocations = 0;
+    int64_t allocated_bytes = 0;
+    for (const auto& counter : memory_counters) {
+      num_allocations += counter->num_allocations;
+      allocated_bytes += counter->allocated_bytes;
+    }
+    stats.allocations_per_iter =
+        static_cast<float>(num_allocations) / config.num_iters;
+    stats.allocated_bytes_per_iter =
+        static_cast<float>(allocated_bytes) / config.num_iters;
   }
   return stats;
 }
@@ -8,7 +8,10 @@ namespace throughput_benchmark {
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value) {
     return os << "Average latency / iter (ms): " << value.latency_avg_ms
-              << "\n Total number of iters: " << value.num_iters;
+              << "\n Total number of iters: " << value.num_iters
+              << "\n Latency p50 / p90 / p99 / p99.9 (ms): "
+              << value.latency_p50_ms << " / " << value.latency_p90_ms << " / "
+              << value.latency_p99_ms << " / " << value.latency_p999_ms;
 }
 
 void ThroughputBenchmark::addInput(py::args args, py::kwargs kwargs) {
@@ -23,6 +23,23 @@ namespace throughput_benchmark {
 struct BenchmarkExecutionStats {
   float latency_avg_ms{-1};
   int64_t num_iters{-1};
+  // Wall time of the main benchmark loop, without the warmup
+  float total_time_ms{-1};
+  // Percentiles of the latencies of the iterations of the main benchmark
+  // loop. In the open-loop mode they include the time a request waited for a
+  // calling thread after its arrival
+  float latency_p50_ms{-1};
+  float latency_p90_ms{-1};
+  float latency_p99_ms{-1};
+  float latency_p999_ms{-1};
+  // Latency of the first call of each calling thread, averaged over the
+  // threads, and the average latency of all warmup iterations
+  float cold_latency_ms{-1};
+  float warmup_latency_avg_ms{-1};
+  // Only set when BenchmarkConfig::profile_memory is. Allocations made by the
+  // calling threads during the main benchmark loop, per iteration
+  float allocations_per_iter{-1};
+  float allocated_bytes_per_iter{-1};
 };
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value);
@@ -57,6 +74,17 @@ struct BenchmarkConfig {
   // before the main benchmark loop (but after the warmup):
   // RecordProfile guard(profiler_output_path);
   std::string profiler_output_path{""};
+  // If not empty, calling thread i is pinned to the CPU core
+  // cpu_affinity[i % cpu_affinity.size()]. Only supported on Linux
+  std::vector<int> cpu_affinity;
+  // If positive, the benchmark runs open-loop: requests arrive at this rate
+  // across all calling threads, whatever the time it takes to serve them, and
+  // their latency is measured from their arrival. Otherwise every calling
+  // thread sends its next request as soon as the previous one is done
+  double target_qps{0};
+  // If set, the allocations of the calling threads are counted during the
+  // main benchmark loop. This adds some overhead to every allocation
+  bool profile_memory{false};
 };
 
 namespace detail {
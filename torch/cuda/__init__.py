@@ -18,6 +18,7 @@ from typing import List, Optional, Tuple, Union
 from torch._six import raise_from
 from ._utils import _get_device_index, _dummy_type
 from .streams import Stream, Event
+from .graphs import CUDAGraph, graph_pool_handle
 from .. import device as _device
 import torch._C
 
@@ -336,6 +337,42 @@ def stream(stream):
         torch._C._cuda_setStream(src_prev_stream._cdata)
 
 
+@contextlib.contextmanager
+def reserved_stream(priority: int = 0, device: Optional[_device_t] = None):
+    r"""Context-manager that reserves a stream from the CUDA stream pool and
+    selects it for its duration.
+
+    Unlike streams created with :class:`Stream`, which are handed out from the
+    pool round-robin, a reserved stream is not returned by :class:`Stream` (or
+    by other reservations) while unreserved streams of the same priority are
+    left. This keeps latency critical work, e.g. a single request of a serving
+    workload, from queueing behind unrelated batch work that happens to share
+    its stream. The size of the pool can be set with the
+    ``PYTORCH_CUDA_STREAMS_PER_POOL`` environment variable
+    (see :ref:`cuda-semantics`).
+
+    Arguments:
+        priority (int, optional): priority of the stream. Can be either
+            -1 (high priority) or 0 (low priority). Default: 0.
+        device (torch.device or int, optional): device to reserve the stream
+            on. Uses the current device if ``None`` (default).
+
+    .. note:: As with any non-default stream, tensors allocated on another
+        stream and used within this context must be marked with
+        :meth:`~torch.Tensor.record_stream` so the caching allocator does not
+        reuse their memory while this stream still uses it.
+    """
+    _lazy_init()
+    cdata = torch._C._cuda_reserveStream(
+        priority, _get_device_index(device, optional=True))
+    reserved = Stream(_cdata=cdata)
+    try:
+        with stream(reserved):
+            yield reserved
+    finally:
+        torch._C._cuda_releaseStream(cdata)
+
+
 def device_count() -> int:
     r"""Returns the number of GPUs available."""
     if is_available():
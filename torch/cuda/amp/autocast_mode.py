@@ -122,8 +122,9 @@ class autocast(object):
         torch.autocast_increment_nesting()
 
     def __exit__(self, *args):
-        # Drop the cache when we exit to a nesting level that's outside any instance of autocast.
-        if torch.autocast_decrement_nesting() == 0:
+        # Drop the cache when we exit to a nesting level that's outside any instance of autocast,
+        # unless it was made persistent with torch.set_autocast_cache_persistent(True).
+        if torch.autocast_decrement_nesting() == 0 and not torch.is_autocast_cache_persistent():
             torch.clear_autocast_cache()
         torch.set_autocast_enabled(self.prev)
         return False
@@ -0,0 +1,76 @@
+import torch
+
+from ._utils import _dummy_type
+
+
+if not hasattr(torch._C, '_CUDAGraph'):
+    # Define dummy base classes
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('_CUDAGraph')
+
+
+def graph_pool_handle():
+    r"""Returns an opaque token representing the id of a graph memory pool.
+
+    Passing the token to :meth:`CUDAGraph.capture_begin` lets several graphs
+    share one private memory pool.
+
+    .. warning::
+        This API is experimental and may change in future releases.
+    """
+    return torch._C._graph_pool_handle()
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    Ops launched on the current (non-default) stream between
+    :meth:`capture_begin` and :meth:`capture_end` are recorded instead of
+    executed. :meth:`replay` then launches the whole recorded sequence with a
+    single CUDA call. Memory allocated during capture is served from a private
+    pool, so tensors created in the captured region keep their addresses
+    across replays; copy new inputs into them before each replay.
+
+    Random ops that read the default CUDA generator through
+    ``philox_cuda_state`` (dropout and most ``torch.distributions`` samplers)
+    produce fresh numbers on every replay.
+
+    Requires PyTorch built with CUDA >= 11.0.
+
+    .. warning::
+        This API is experimental and may change in future releases.
+    """
+    def __new__(cls):
+        return super(CUDAGraph, cls).__new__(cls)
+
+    def capture_begin(self, pool=None):
+        r"""Begins capturing CUDA work on the current stream.
+
+        Arguments:
+            pool (optional): token returned by :func:`graph_pool_handle` or
+                another graph's :meth:`pool`, hinting this graph may share
+                memory with the indicated pool.
+        """
+        if pool is None:
+            super(CUDAGraph, self).capture_begin()
+        else:
+            super(CUDAGraph, self).capture_begin(pool)
+
+    def capture_end(self):
+        r"""Ends CUDA graph capture on the current stream and instantiates the graph."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Replays the CUDA work captured by this graph."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Deletes the graph currently held by this instance and releases its memory pool."""
+        super(CUDAGraph, self).reset()
+
+    def pool(self):
+        r"""Returns an opaque token representing the id of this graph's memory pool.
+
+        The token can be passed to another graph's :meth:`capture_begin`,
+        which hints the other graph may share the same memory pool.
+        """
+        return super(CUDAGraph, self).pool()
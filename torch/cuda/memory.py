@@ -4,7 +4,7 @@ import warnings
 from typing import Any, Dict, Union
 
 import torch
-from . import is_initialized, _get_device_index
+from . import is_initialized, _get_device_index, _lazy_init
 from torch.types import Device
 
 def _host_allocator():
@@ -209,6 +209,46 @@ def reset_peak_memory_stats(device: Union[Device, int] = None) -> None:
     return torch._C._cuda_resetPeakMemoryStats(device)
 
 
+def host_memory_stats() -> Dict[str, int]:
+    r"""Returns a dictionary of statistics of the caching allocator for pinned
+    (page-locked) host memory, which backs :meth:`~torch.Tensor.pin_memory`.
+
+    - ``"allocated_bytes.{current,peak}"``: bytes of pinned memory in use.
+    - ``"reserved_bytes.{current,peak}"``: bytes of pinned memory held by the
+      allocator, including the cached blocks.
+    - ``"num_allocs"``: number of allocation requests.
+    - ``"num_cache_hits"``: number of requests served by a cached block.
+    - ``"num_host_allocs"``: number of ``cudaHostAlloc`` calls.
+    - ``"num_host_frees"``: number of ``cudaFreeHost`` calls.
+
+    Requests are rounded up to one of four size classes per power of two.
+    """
+    _lazy_init()
+    return torch._C._cuda_hostMemoryStats()
+
+
+def reset_peak_host_memory_stats() -> None:
+    r"""Resets the "peak" stats of :func:`~torch.cuda.host_memory_stats`."""
+    _lazy_init()
+    torch._C._cuda_resetPeakHostMemoryStats()
+
+
+def set_host_memory_cache_limit(limit: int) -> None:
+    r"""Sets the maximum number of bytes of unused pinned memory that the
+    pinned memory allocator caches for reuse.
+
+    Cached blocks, largest first, are released in the background once the
+    limit is exceeded. Pinned memory in use is not counted and is never
+    released. The limit is unbounded by default, and can also be set in MB
+    with the ``PYTORCH_CUDA_HOST_CACHE_LIMIT_MB`` environment variable.
+
+    Arguments:
+        limit (int): the limit, in bytes.
+    """
+    _lazy_init()
+    torch._C._cuda_setHostMemoryCacheLimit(limit)
+
+
 def reset_max_memory_allocated(device: Union[Device, int] = None) -> None:
     r"""Resets the starting point in tracking maximum GPU memory occupied by
     tensors for a given device.
@@ -365,9 +405,54 @@ def memory_snapshot():
         See :ref:`cuda-memory-management` for more details about GPU memory
         management.
     """
+    return torch._C._cuda_memorySnapshot()['segments']
+
+
+def _record_memory_history(enabled: bool = True, record_context: bool = True,
+                           trace_alloc_max_entries: int = 1,
+                           record_cpp_context: bool = False) -> None:
+    r"""Enables or disables recording of CUDA memory allocation history.
+
+    While enabled, the caching allocator keeps the Python stack trace that
+    created each live allocation and a ring buffer of the last
+    :attr:`trace_alloc_max_entries` allocator events (allocations, frees,
+    segment allocations and frees, and out-of-memory errors), which are
+    returned by :func:`_snapshot`.
+
+    Arguments:
+        enabled (bool, optional): whether to record history (default: True).
+        record_context (bool, optional): whether to record the Python stack
+            of each allocation (default: True).
+        trace_alloc_max_entries (int, optional): number of allocator events
+            kept per device (default: 1).
+        record_cpp_context (bool, optional): whether to also record the C++
+            stack of each allocation. This is considerably slower (default:
+            False).
+    """
+    torch.cuda.init()
+    torch._C._cuda_recordMemoryHistory(enabled, record_context, record_cpp_context,
+                                       trace_alloc_max_entries)
+
+
+def _snapshot() -> Dict[str, Any]:
+    r"""Returns the state of the CUDA memory allocator along with its recorded
+    history, see :func:`_record_memory_history`.
+
+    The result is a dictionary with the keys ``segments``, as returned by
+    :func:`memory_snapshot`, where the blocks of live allocations also hold the
+    ``history`` of their allocation, and ``device_traces``, a list with the
+    recorded events of each device, oldest first.
+    """
     return torch._C._cuda_memorySnapshot()
 
 
+def _dump_snapshot(filename: str = "dump_snapshot.pickle") -> None:
+    r"""Saves :func:`_snapshot` to :attr:`filename` using pickle."""
+    import pickle
+    with open(filename, "wb") as f:
+        pickle.dump(_snapshot(), f)
+
+
 def memory_summary(device: Union[Device, int] = None, abbreviated: bool = False) -> str:
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
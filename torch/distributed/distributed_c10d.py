@@ -1,3 +1,4 @@
+import os
 import pickle
 import torch
 import warnings
@@ -437,6 +438,19 @@ def init_process_group(backend,
     _default_pg_init_method = init_method
 
 
+def _use_nccl_comm_split(backend):
+    """
+    Whether a new ``backend`` subgroup splits its NCCL communicator from the
+    default group's instead of bootstrapping one through the store. This is
+    opt-in through ``TORCH_NCCL_COMM_SPLIT=1`` and needs NCCL 2.18 or newer.
+    """
+    return (backend == Backend.NCCL and
+            os.environ.get("TORCH_NCCL_COMM_SPLIT", "0") == "1" and
+            is_nccl_available() and
+            isinstance(_default_pg, ProcessGroupNCCL) and
+            ProcessGroupNCCL._is_comm_split_supported())
+
+
 def _new_process_group_helper(world_size,
                               rank,
                               group_ranks,
@@ -485,6 +499,23 @@ def _new_process_group_helper(world_size,
         _pg_map[pg] = (Backend.MPI, None)
         _pg_names[pg] = group_name
     else:
+        # NCCL subgroups may split their communicator from the default
+        # group's, which all ranks of the default group have to take part in,
+        # so this happens before the membership check below.
+        if not is_default_group and _use_nccl_comm_split(backend):
+            options = ProcessGroupNCCL.Options()
+            options.timeout = timeout
+            pg = _default_pg._split(
+                PrefixStore(group_name, store),
+                group_ranks,
+                torch.cuda.current_device(),
+                options)
+            if pg is None:
+                return GroupMember.NON_GROUP_MEMBER
+            _pg_map[pg] = (Backend.NCCL, store)
+            _pg_names[pg] = group_name
+            return pg
+
         # If this is a subgroup (which means group_ranks is specified),
         # we check if the current process is a member of the new group.
         if not is_default_group:
@@ -995,6 +1026,47 @@ def all_reduce_coalesced(tensors,
         work.wait()
 
 
+def broadcast_coalesced(tensors,
+                        src,
+                        group=group.WORLD,
+                        async_op=False):
+    """
+    Broadcasts each tensor in tensors (residing on the same device) from
+    ``src`` to the whole group as a single collective. Like
+    ``all_reduce_coalesced``, shapes are not checked across processes.
+
+    Arguments:
+        tensors (List[Tensor]): Data to be sent if ``src`` is the rank of
+            current process, and tensors to be used to save received data
+            otherwise.
+        src (int): Source rank.
+        group (ProcessGroup, optional): The process group to work on
+        async_op (bool, optional): Whether this op should be an async op
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group
+
+    """
+    _check_tensor_list(tensors, "tensor")
+    if _rank_not_in_group(group):
+        return
+
+    opts = BroadcastOptions()
+    opts.rootRank = src
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.broadcast_coalesced(tensors, opts)
+    else:
+        opts.rootRank = _get_group_rank(group, src)
+        work = group.broadcast_coalesced(tensors, opts)
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def reduce_multigpu(tensor_list,
                     dst,
                     op=ReduceOp.SUM,
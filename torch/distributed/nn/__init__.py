@@ -1 +1,3 @@
 from .api.remote_module import RemoteModule
+from .api.pipeline import Pipeline
+from .api.sharded_embedding_bag import ShardedEmbeddingBag
@@ -0,0 +1,270 @@
+#!/usr/bin/python3
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Callable, Dict, List, Sequence
+
+import torch
+import torch.distributed.autograd as dist_autograd
+import torch.distributed.rpc as rpc
+from torch import nn
+
+
+FILL_DRAIN = "fill_drain"
+ONE_F_ONE_B = "1f1b"
+_SCHEDULES = (FILL_DRAIN, ONE_F_ONE_B)
+
+# Number of CUDA streams each device of a stage owner cycles through, so that
+# the copies and the compute of consecutive micro-batches overlap.
+_NUM_STAGE_STREAMS = 2
+
+_stage_streams: Dict[torch.device, List[Any]] = {}
+_stage_stream_index: Dict[torch.device, int] = {}
+_stage_streams_lock = threading.Lock()
+
+# Guards the accumulation of the gradients of concurrent micro-batches into
+# the ``.grad`` of the parameters of the stages owned by this worker.
+_grad_lock = threading.Lock()
+
+
+def _next_stage_stream(device):
+    with _stage_streams_lock:
+        if device not in _stage_streams:
+            _stage_streams[device] = [
+                torch.cuda.Stream(device) for _ in range(_NUM_STAGE_STREAMS)
+            ]
+            _stage_stream_index[device] = 0
+        index = _stage_stream_index[device]
+        _stage_stream_index[device] = (index + 1) % _NUM_STAGE_STREAMS
+        return _stage_streams[device][index]
+
+
+def _module_device(module):
+    for param in module.parameters():
+        return param.device
+    return torch.device("cpu")
+
+
+def _run_stage(module_rref, input):
+    module = module_rref.local_value()
+    device = _module_device(module)
+    if device.type != "cuda":
+        return module(input)
+    # RPC moves CPU tensors. The copies to and from the device and the
+    # forward of this micro-batch go to their own stream, so they overlap
+    # with those of the micro-batches handled by the other RPC threads.
+    stream = _next_stage_stream(device)
+    with torch.cuda.stream(stream):
+        output = module(input.pin_memory().to(device, non_blocking=True)).cpu()
+    stream.synchronize()
+    return output
+
+
+def _local_value(rref):
+    return rref.local_value()
+
+
+# RPC handler.
+@rpc.functions.async_execution
+def _stage_forward(module_rref, input):
+    if isinstance(input, rpc.PyRRef):
+        # Fetch the output of the previous stage straight from its owner,
+        # without holding an RPC thread while it's computed. The fetch runs
+        # in the distributed autograd context of the request, so that the
+        # backward goes back to the previous stage.
+        return rpc.rpc_async(input.owner(), _local_value, args=(input,)).then(
+            lambda fut: _run_stage(module_rref, fut.wait())
+        )
+    fut = torch.futures.Future()
+    fut.set_result(_run_stage(module_rref, input))
+    return fut
+
+
+# RPC handler.
+def _parameter_rrefs(module_rref):
+    return [rpc.RRef(param) for param in module_rref.local_value().parameters()]
+
+
+# RPC handler.
+def _accumulate_grads(module_rref, context_id):
+    grads = dist_autograd.get_gradients(context_id)
+    with _grad_lock:
+        for param in module_rref.local_value().parameters():
+            grad = grads.get(param)
+            if grad is None:
+                continue
+            if param.grad is None:
+                param.grad = grad.clone()
+            else:
+                param.grad.add_(grad)
+
+
+# RPC handler.
+def _zero_grad(module_rref):
+    module_rref.local_value().zero_grad()
+
+
+class Pipeline(object):
+    r"""
+    A pipeline of stages, each of which is a module on a worker, that runs
+    the micro-batches of its inputs through the stages concurrently, so that
+    every stage works on a different micro-batch.
+
+    A micro-batch goes from one stage to the next through its
+    :class:`~torch.distributed.rpc.RRef`: every stage fetches the output of
+    the previous one from its owner, so the activations never go through the
+    caller, and the caller only issues the ``rpc.remote`` calls. The stages
+    whose parameters are on a CUDA device run the copies and the forward of
+    consecutive micro-batches on different streams.
+
+    Called inside a distributed autograd context, the pipeline records the
+    forward of all micro-batches in that context, and a single
+    :meth:`torch.distributed.autograd.backward` on the output runs the
+    backward of all of them at once, the fill-drain (GPipe) schedule. This is
+    the way to train it with a :class:`~torch.distributed.optim.DistributedOptimizer`
+    on :meth:`parameter_rrefs`. :meth:`train_step` runs the forward and
+    backward of the micro-batches with the schedule of the pipeline, and
+    accumulates the gradients to the ``.grad`` of the parameters of the
+    stages, like a local backward:
+
+    - ``"fill_drain"`` runs the forward of all micro-batches, then the
+      backward of all of them, in one distributed autograd context.
+    - ``"1f1b"`` keeps at most one micro-batch per stage in flight, and runs
+      the backward of each micro-batch, in its own context, as soon as its
+      forward is done, so that the activations of at most ``len(stages)``
+      micro-batches are alive at once.
+
+    Arguments:
+        stages (Sequence): the stages, in order, each of which is an
+            :class:`~torch.distributed.rpc.RRef` of an ``nn.Module`` or a
+            :class:`~torch.distributed.nn.RemoteModule`. The output of a stage
+            is the input of the next one.
+        chunks (int): the number of micro-batches that the inputs are split
+            into, along their first dimension.
+        schedule (str): ``"fill_drain"`` or ``"1f1b"``, the schedule of
+            :meth:`train_step`.
+
+    Example::
+        >>> # On worker 0:
+        >>> import torch
+        >>> import torch.distributed.rpc as rpc
+        >>> from torch import nn
+        >>> from torch.distributed.nn import Pipeline, RemoteModule
+        >>>
+        >>> rpc.init_rpc("worker0", rank=0, world_size=3)
+        >>> stages = [
+        >>>     RemoteModule("worker1", nn.Linear, args=(20, 30)),
+        >>>     RemoteModule("worker2", nn.Linear, args=(30, 10)),
+        >>> ]
+        >>> pipe = Pipeline(stages, chunks=4, schedule="1f1b")
+        >>> loss = pipe.train_step(
+        >>>     torch.randn(128, 20), torch.randn(128, 10), nn.MSELoss(reduction="sum")
+        >>> )
+        >>> rpc.shutdown()
+    """
+
+    def __init__(self, stages: Sequence[Any], chunks: int = 1, schedule: str = FILL_DRAIN):
+        if len(stages) == 0:
+            raise ValueError("Expected a pipeline of at least one stage.")
+        if chunks < 1:
+            raise ValueError(f"Expected at least one micro-batch, but got chunks={chunks}.")
+        if schedule not in _SCHEDULES:
+            raise ValueError(
+                f"Expected a schedule in {_SCHEDULES}, but got {schedule!r}."
+            )
+        self.stages = [
+            stage.module_rref if isinstance(stage, nn.Module) else stage
+            for stage in stages
+        ]
+        self.chunks = chunks
+        self.schedule = schedule
+
+    def _forward_micro_batch(self, input):
+        output = input
+        for stage in self.stages:
+            output = rpc.remote(stage.owner(), _stage_forward, args=(stage, output))
+        return output
+
+    def _accumulate_grads(self, context_id):
+        futs = [
+            rpc.rpc_async(stage.owner(), _accumulate_grads, args=(stage, context_id))
+            for stage in self.stages
+        ]
+        for fut in futs:
+            fut.wait()
+
+    def forward(self, input):
+        r"""
+        Runs the micro-batches of ``input`` through the stages, and returns
+        the concatenation of their outputs.
+        """
+        outputs = [self._forward_micro_batch(chunk) for chunk in input.chunk(self.chunks)]
+        return torch.cat([output.to_here() for output in outputs])
+
+    __call__ = forward
+
+    def train_step(self, input, target, loss_fn: Callable):
+        r"""
+        Runs the forward and the backward of the micro-batches of ``input``
+        and ``target`` with the schedule of the pipeline, and accumulates the
+        gradients of the sum of the losses ``loss_fn(output, target)`` of the
+        micro-batches to the ``.grad`` of the parameters of the stages.
+
+        This must not be called inside a distributed autograd context.
+
+        Returns:
+            The sum of the losses of the micro-batches.
+        """
+        inputs = input.chunk(self.chunks)
+        targets = target.chunk(self.chunks)
+        if len(inputs) != len(targets):
+            raise ValueError(
+                f"Expected input and target to split into the same number of micro-batches, "
+                f"but got {len(inputs)} and {len(targets)}."
+            )
+
+        if self.schedule == FILL_DRAIN:
+            with dist_autograd.context() as context_id:
+                outputs = [self._forward_micro_batch(chunk) for chunk in inputs]
+                losses = [
+                    loss_fn(output.to_here(), target)
+                    for output, target in zip(outputs, targets)
+                ]
+                dist_autograd.backward(context_id, losses)
+                self._accumulate_grads(context_id)
+            return sum(loss.detach() for loss in losses)
+
+        def run_micro_batch(input, target):
+            # Distributed autograd contexts are per thread, and a context
+            # only takes one backward.
+            with dist_autograd.context() as context_id:
+                loss = loss_fn(self._forward_micro_batch(input).to_here(), target)
+                dist_autograd.backward(context_id, [loss])
+                self._accumulate_grads(context_id)
+            return loss.detach()
+
+        with ThreadPoolExecutor(max_workers=len(self.stages)) as executor:
+            losses = [
+                executor.submit(run_micro_batch, input, target)
+                for input, target in zip(inputs, targets)
+            ]
+            return sum(loss.result() for loss in losses)
+
+    def parameter_rrefs(self):
+        r"""
+        Returns the :class:`~torch.distributed.rpc.RRef` of the parameters of
+        all stages, for a :class:`~torch.distributed.optim.DistributedOptimizer`.
+        """
+        futs = [
+            rpc.rpc_async(stage.owner(), _parameter_rrefs, args=(stage,))
+            for stage in self.stages
+        ]
+        return [rref for fut in futs for rref in fut.wait()]
+
+    def zero_grad(self):
+        r"""Sets the ``.grad`` of the parameters of all stages to zero."""
+        futs = [
+            rpc.rpc_async(stage.owner(), _zero_grad, args=(stage,))
+            for stage in self.stages
+        ]
+        for fut in futs:
+            fut.wait()
@@ -0,0 +1,280 @@
+from typing import List, Optional
+
+import torch
+import torch.distributed as dist
+import torch.nn.functional as F
+from torch import nn
+from torch.nn.parameter import Parameter
+
+
+_MODES = ("sum", "mean")
+
+
+def _shard_offsets(num_embeddings, world_size):
+    rows_per_rank = (num_embeddings + world_size - 1) // world_size
+    return [min(r * rows_per_rank, num_embeddings) for r in range(world_size + 1)]
+
+
+def _all_to_all(input, output_splits, input_splits, group):
+    output = input.new_empty((sum(output_splits),) + tuple(input.shape[1:]))
+    work = dist.all_to_all_single(
+        output, input, output_splits, input_splits, group=group, async_op=True
+    )
+    return output, work
+
+
+class _Chunk(object):
+    """
+    The state of one chunk of bags that is carried from the forward to the
+    backward of :class:`_ShardedEmbeddingBagFunction`.
+    """
+
+    def __init__(self, num_bags, send_counts, recv_counts, bags_per_rank):
+        # Number of bags of this chunk on this rank.
+        self.num_bags = num_bags
+        # Number of indices this rank sends to / receives from every rank.
+        self.send_counts = send_counts
+        self.recv_counts = recv_counts
+        # Number of bags of this chunk on every rank.
+        self.bags_per_rank = bags_per_rank
+        # Local rows looked up for the other ranks and the bag, numbered
+        # across all ranks, each of them is pooled into.
+        self.rows = None
+        self.bags = None
+        self.per_sample_weights = None
+
+
+class _ShardedEmbeddingBagFunction(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, weight, indices, bag_ids, per_sample_weights, num_bags, bag_lengths,
+                shard_offsets, mode, num_chunks, group):
+        world_size = dist.get_world_size(group)
+        device = weight.device
+        boundaries = torch.tensor(shard_offsets[1:-1], dtype=indices.dtype, device=device)
+        shard_starts = torch.tensor(shard_offsets[:-1], dtype=indices.dtype, device=device)
+
+        # Split the bags, and the indices that belong to them, into chunks whose
+        # exchanges and lookups are pipelined.
+        bag_splits = [num_bags // num_chunks + (1 if c < num_bags % num_chunks else 0)
+                      for c in range(num_chunks)]
+        index_splits = [int(lengths.sum()) for lengths in bag_lengths.split(bag_splits)]
+
+        # Route every index to the rank that owns its row. The indices of a
+        # chunk are grouped by owner, keeping them in bag order within an owner.
+        send_payloads = []
+        send_weights = []
+        send_counts = []
+        bag_start = 0
+        for chunk_indices, chunk_bag_ids, chunk_weights, chunk_bags in zip(
+                indices.split(index_splits),
+                bag_ids.split(index_splits),
+                per_sample_weights.split(index_splits) if per_sample_weights is not None
+                else [None] * num_chunks,
+                bag_splits):
+            owners = torch.bucketize(chunk_indices, boundaries, right=True)
+            order = torch.argsort(owners * chunk_indices.numel() +
+                                  torch.arange(chunk_indices.numel(), device=device))
+            owners = owners[order]
+            rows = chunk_indices[order] - shard_starts[owners]
+            send_payloads.append(torch.stack([rows, chunk_bag_ids[order] - bag_start], dim=1))
+            if chunk_weights is not None:
+                send_weights.append(chunk_weights[order])
+            send_counts.append(torch.bincount(owners, minlength=world_size))
+            bag_start += chunk_bags
+
+        # A single exchange of the index counts and the number of bags of every
+        # chunk, laid out as [destination rank, chunk, (indices, bags)].
+        counts = torch.stack([
+            torch.stack(send_counts, dim=1),
+            torch.tensor(bag_splits, device=device).expand(world_size, num_chunks),
+        ], dim=2).contiguous()
+        recv = torch.empty_like(counts)
+        dist.all_to_all_single(recv, counts, group=group)
+        counts = counts.tolist()
+        recv = recv.tolist()
+
+        chunks = []
+        index_works = []
+        for c in range(num_chunks):
+            chunk = _Chunk(
+                bag_splits[c],
+                [counts[r][c][0] for r in range(world_size)],
+                [recv[r][c][0] for r in range(world_size)],
+                [recv[r][c][1] for r in range(world_size)])
+            chunks.append(chunk)
+            payload = _all_to_all(send_payloads[c], chunk.recv_counts, chunk.send_counts, group)
+            weights = (_all_to_all(send_weights[c], chunk.recv_counts, chunk.send_counts, group)
+                       if per_sample_weights is not None else None)
+            index_works.append((payload, weights))
+
+        # As soon as the indices of a chunk arrive, look them up in the local
+        # shard and send the partially pooled bags back, while the indices of
+        # the next chunks are still in flight.
+        output_works = []
+        for chunk, (payload, weights) in zip(chunks, index_works):
+            payload, work = payload
+            work.wait()
+            if weights is not None:
+                weights, weights_work = weights
+                weights_work.wait()
+            source_bag_starts = torch.tensor(
+                [0] + chunk.bags_per_rank[:-1], dtype=payload.dtype, device=device).cumsum(0)
+            sources = torch.arange(world_size, device=device).repeat_interleave(
+                torch.tensor(chunk.recv_counts, device=device))
+            chunk.rows = payload[:, 0]
+            chunk.bags = payload[:, 1] + source_bag_starts[sources]
+            chunk.per_sample_weights = weights
+            total_bags = sum(chunk.bags_per_rank)
+            bag_sizes = torch.bincount(chunk.bags, minlength=total_bags)
+            offsets = bag_sizes.cumsum(0) - bag_sizes
+            pooled = F.embedding_bag(
+                chunk.rows, weight, offsets, mode="sum", per_sample_weights=weights)
+            output_works.append(_all_to_all(
+                pooled, [chunk.num_bags] * world_size, chunk.bags_per_rank, group))
+
+        outputs = []
+        for chunk, (partials, work) in zip(chunks, output_works):
+            work.wait()
+            outputs.append(partials.view(world_size, chunk.num_bags, weight.size(1)).sum(0))
+        output = torch.cat(outputs) if outputs else weight.new_empty((0, weight.size(1)))
+        if mode == "mean":
+            output = output / bag_lengths.clamp(min=1).unsqueeze(1).to(output.dtype)
+
+        ctx.chunks = chunks
+        ctx.mode = mode
+        ctx.group = group
+        ctx.weight_shape = weight.shape
+        ctx.save_for_backward(bag_lengths)
+        return output
+
+    @staticmethod
+    def backward(ctx, grad_output):
+        bag_lengths, = ctx.saved_tensors
+        world_size = dist.get_world_size(ctx.group)
+        if ctx.mode == "mean":
+            grad_output = grad_output / bag_lengths.clamp(min=1).unsqueeze(1).to(grad_output.dtype)
+        grad_output = grad_output.contiguous()
+
+        # Every rank that owns rows of a bag receives the gradient of the bag,
+        # and scatters it into the rows it looked up for that bag.
+        grad_works = []
+        for chunk, grad_chunk in zip(ctx.chunks, grad_output.split([c.num_bags for c in ctx.chunks])):
+            grad_works.append(_all_to_all(
+                grad_chunk.repeat(world_size, 1), chunk.bags_per_rank,
+                [chunk.num_bags] * world_size, ctx.group))
+
+        grad_weight = grad_output.new_zeros(ctx.weight_shape)
+        for chunk, (grad_bags, work) in zip(ctx.chunks, grad_works):
+            work.wait()
+            grad_rows = grad_bags.index_select(0, chunk.bags)
+            if chunk.per_sample_weights is not None:
+                grad_rows = grad_rows * chunk.per_sample_weights.unsqueeze(1)
+            grad_weight.index_add_(0, chunk.rows, grad_rows)
+        return (grad_weight,) + (None,) * 9
+
+
+class ShardedEmbeddingBag(nn.Module):
+    r"""
+    An :class:`~torch.nn.EmbeddingBag` whose table is sharded row-wise across
+    the ranks of a process group, so that tables larger than the memory of a
+    single device can be trained with model parallelism.
+
+    Rank ``r`` stores the rows ``[shard_offsets[r], shard_offsets[r + 1])`` of
+    the table in :attr:`weight`. Every rank calls ``forward`` with its own
+    batch of bags, which it fully owns the output of. A forward does
+
+    1. an all-to-all that sends every index to the rank owning its row,
+    2. a lookup of the received indices in the local shard with
+       :func:`~torch.nn.functional.embedding_bag`, which pools them into
+       partial bags, and
+    3. an all-to-all that returns the partial bags, which are then reduced.
+
+    The batch is split into ``num_chunks`` chunks of bags, and the steps of
+    consecutive chunks are pipelined: a chunk is looked up while the indices
+    of the next ones are still being exchanged. The backward sends the
+    gradient of every bag to the ranks owning its rows in one all-to-all per
+    chunk and accumulates it into a dense gradient of the local shard.
+
+    All ranks must call ``forward`` and ``backward`` collectively.
+
+    Arguments:
+        num_embeddings (int): size of the whole table.
+        embedding_dim (int): the size of each embedding vector.
+        mode (str, optional): ``"sum"`` or ``"mean"``. Default: ``"sum"``.
+        group (ProcessGroup, optional): the process group the table is sharded
+            across. Default: the default process group.
+        num_chunks (int, optional): number of chunks the bags of a batch are
+            pipelined in. Default: 1.
+        device (torch.device, optional): the device of the local shard.
+
+    Example::
+        >>> # On every rank, with the default process group initialized.
+        >>> emb = ShardedEmbeddingBag(10 ** 8, 64, device=torch.device("cuda", rank))
+        >>> input = torch.randint(10 ** 8, (1024, 20), device="cuda")
+        >>> output = emb(input)   # 1024 bags of this rank, shape (1024, 64)
+    """
+
+    def __init__(self, num_embeddings: int, embedding_dim: int, mode: str = "sum",
+                 group=None, num_chunks: int = 1, device: Optional[torch.device] = None):
+        super(ShardedEmbeddingBag, self).__init__()
+        if mode not in _MODES:
+            raise ValueError(
+                "ShardedEmbeddingBag supports modes {}, got '{}'".format(_MODES, mode))
+        if num_chunks < 1:
+            raise ValueError("num_chunks must be positive, got {}".format(num_chunks))
+        self.group = group if group is not None else dist.group.WORLD
+        self.num_embeddings = num_embeddings
+        self.embedding_dim = embedding_dim
+        self.mode = mode
+        self.num_chunks = num_chunks
+        world_size = dist.get_world_size(self.group)
+        rank = dist.get_rank(self.group)
+        self.shard_offsets: List[int] = _shard_offsets(num_embeddings, world_size)
+        local_rows = self.shard_offsets[rank + 1] - self.shard_offsets[rank]
+        self.weight = Parameter(torch.empty(local_rows, embedding_dim, device=device))
+        self.reset_parameters()
+
+    def reset_parameters(self):
+        nn.init.normal_(self.weight)
+
+    def forward(self, input, offsets=None, per_sample_weights=None):
+        r"""
+        Takes the same ``input``, ``offsets`` and ``per_sample_weights`` as
+        :class:`~torch.nn.EmbeddingBag`, with indices into the whole table.
+        ``per_sample_weights`` is only supported with ``mode="sum"`` and does
+        not receive a gradient.
+        """
+        device = self.weight.device
+        input = input.to(device)
+        if offsets is not None:
+            offsets = offsets.to(device)
+        if per_sample_weights is not None:
+            per_sample_weights = per_sample_weights.to(device)
+            if self.mode != "sum":
+                raise ValueError("per_sample_weights is only supported for mode='sum'")
+            if per_sample_weights.requires_grad:
+                raise ValueError("ShardedEmbeddingBag does not compute gradients of per_sample_weights")
+            per_sample_weights = per_sample_weights.reshape(-1)
+        if input.dim() == 2:
+            if offsets is not None:
+                raise ValueError("offsets must be None when input is 2D")
+            num_bags, bag_length = input.shape
+            bag_lengths = torch.full((num_bags,), bag_length, dtype=torch.long, device=device)
+            indices = input.reshape(-1)
+        elif input.dim() == 1:
+            if offsets is None or offsets.dim() != 1:
+                raise ValueError("offsets has to be a 1D Tensor when input is 1D")
+            num_bags = offsets.numel()
+            ends = torch.cat([offsets[1:], offsets.new_tensor([input.numel()])])
+            bag_lengths = (ends - offsets).long()
+            indices = input
+        else:
+            raise ValueError("input has to be 1D or 2D Tensor, but got Tensor of dimension {}".format(input.dim()))
+        bag_ids = torch.arange(num_bags, device=device).repeat_interleave(bag_lengths)
+        return _ShardedEmbeddingBagFunction.apply(
+            self.weight, indices.long(), bag_ids, per_sample_weights, num_bags, bag_lengths,
+            self.shard_offsets, self.mode, self.num_chunks, self.group)
+
+    def extra_repr(self):
+        return "{}, {}, mode='{}', shard_offsets={}".format(
+            self.num_embeddings, self.embedding_dim, self.mode, self.shard_offsets)
@@ -0,0 +1,144 @@
+from collections import OrderedDict
+
+import torch.distributed as dist
+from torch.optim import Optimizer
+
+
+def _partition_parameters(param_groups, world_size):
+    # Greedily gives the largest parameters first to the rank with the fewest
+    # elements so far. This only depends on the order and the sizes of the
+    # parameters, which are the same on all ranks.
+    sizes = [0] * world_size
+    partition = [[dict(group, params=[]) for group in param_groups] for _ in range(world_size)]
+    params = [
+        (param, group_index)
+        for group_index, group in enumerate(param_groups)
+        for param in group["params"]
+    ]
+    for param, group_index in sorted(params, key=lambda p: -p[0].numel()):
+        rank = sizes.index(min(sizes))
+        partition[rank][group_index]["params"].append(param)
+        sizes[rank] += param.numel()
+    return partition
+
+
+class ZeroRedundancyOptimizer(Optimizer):
+    r"""
+    Wraps an optimizer and shards its states across the ranks of a process
+    group, so that each rank only keeps the states, e.g. the moments of
+    :class:`~torch.optim.Adam`, of the parameters of its shard.
+
+    The parameters are partitioned across the ranks in balanced shards. Like
+    the optimizer it wraps, :meth:`step` takes the gradients of all ranks to
+    be the same, e.g. those reduced by
+    :class:`~torch.nn.parallel.DistributedDataParallel`. Each rank updates
+    the parameters of its shard, and then broadcasts them to the other ranks,
+    in one coalesced collective per rank, device and dtype.
+
+    Given the ``module`` that the parameters belong to, :meth:`step` doesn't
+    wait for these broadcasts. They go on while the next forward runs, and
+    each submodule only waits for those of its own parameters before its
+    forward, so that the first layers don't wait for the whole model.
+
+    :meth:`state_dict` and :meth:`load_state_dict` only cover the states of
+    the shard of this rank.
+
+    Arguments:
+        params (iterable): the parameters, or the dicts of the parameter
+            groups, to optimize. They must be the same, in the same order, on
+            all ranks.
+        optimizer_class (type): the class of the optimizer to wrap, e.g.
+            :class:`~torch.optim.Adam`.
+        group (ProcessGroup, optional): the process group to shard across.
+        module (nn.Module, optional): the module that the parameters belong
+            to, whose forward overlaps with the broadcasts of the parameters.
+        **defaults: the arguments of ``optimizer_class``.
+
+    Example::
+        >>> ddp = DistributedDataParallel(model)
+        >>> optimizer = ZeroRedundancyOptimizer(
+        >>>     ddp.parameters(), torch.optim.Adam, module=ddp, lr=0.01
+        >>> )
+        >>> ddp(input).sum().backward()
+        >>> optimizer.step()
+    """
+
+    def __init__(self, params, optimizer_class, group=dist.group.WORLD, module=None, **defaults):
+        super(ZeroRedundancyOptimizer, self).__init__(params, defaults)
+        self.group = group
+        self.rank = dist.get_rank(group)
+        self.world_size = dist.get_world_size(group)
+        self.partition = _partition_parameters(self.param_groups, self.world_size)
+        local_groups = [
+            shard_group for shard_group in self.partition[self.rank]
+            if len(shard_group["params"]) > 0
+        ]
+        # The wrapped optimizer needs a parameter group, even an empty one.
+        self.optim = optimizer_class(local_groups or self.partition[self.rank][:1], **defaults)
+        # What the learning rate schedulers see and change.
+        self.param_groups = self.optim.param_groups
+
+        # parameter -> work of the pending broadcast of its shard
+        self._pending_broadcasts = OrderedDict()
+        self._hooks = []
+        if module is not None:
+            for submodule in module.modules():
+                if any(True for _ in submodule.parameters(recurse=False)):
+                    self._hooks.append(
+                        submodule.register_forward_pre_hook(self._wait_for_own_broadcasts))
+
+    def _global_rank(self, rank):
+        if self.group is dist.group.WORLD:
+            return rank
+        return dist.distributed_c10d._get_global_rank(self.group, rank)
+
+    def _wait_for_own_broadcasts(self, submodule, input):
+        for param in submodule.parameters(recurse=False):
+            work = self._pending_broadcasts.pop(param, None)
+            if work is not None:
+                work.wait()
+
+    def _wait_for_broadcasts(self):
+        works = list(self._pending_broadcasts.values())
+        self._pending_broadcasts.clear()
+        for work in works:
+            work.wait()
+
+    def _broadcast_parameters(self):
+        for rank, shard in enumerate(self.partition):
+            buckets = OrderedDict()
+            for group in shard:
+                for param in group["params"]:
+                    buckets.setdefault((param.device, param.dtype), []).append(param)
+            for params in buckets.values():
+                work = dist.broadcast_coalesced(
+                    [param.data for param in params],
+                    src=self._global_rank(rank),
+                    group=self.group,
+                    async_op=True)
+                for param in params:
+                    self._pending_broadcasts[param] = work
+        if not self._hooks:
+            self._wait_for_broadcasts()
+
+    def step(self, closure=None):
+        # The parameters that a closure would use must be up to date.
+        self._wait_for_broadcasts()
+        loss = self.optim.step(closure)
+        self._broadcast_parameters()
+        return loss
+
+    def zero_grad(self):
+        # Zeroes the gradients of all parameters, not only those of the shard.
+        for shard in self.partition:
+            for group in shard:
+                for param in group["params"]:
+                    if param.grad is not None:
+                        param.grad.detach_()
+                        param.grad.zero_()
+
+    def state_dict(self):
+        return self.optim.state_dict()
+
+    def load_state_dict(self, state_dict):
+        self.optim.load_state_dict(state_dict)
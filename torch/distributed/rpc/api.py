@@ -28,6 +28,7 @@ from . import (
     _is_current_rpc_agent_set,
     _reset_current_rpc_agent,
     _set_and_start_rpc_agent,
+    _to_here_batch,
     backend_registry,
 )
 
@@ -341,6 +342,38 @@ def get_worker_info(worker_name=None):
         return _get_current_rpc_agent().get_worker_info()
 
 
+@_require_initialized
+def batch_to_here(rrefs, timeout=UNSET_RPC_TIMEOUT, cache=False):
+    r"""
+    Copies the values of ``rrefs`` to the local node, like
+    :meth:`~torch.distributed.rpc.RRef.to_here` on each of them, but with a
+    single message to each owner for all the RRefs that it owns, sent to all
+    owners at once.
+
+    Arguments:
+        rrefs (list): the :class:`~torch.distributed.rpc.RRef` s to fetch.
+        timeout (float, optional): timeout in seconds for each of the
+            messages. If this argument is not provided, the default RPC
+            timeout will be used.
+        cache (bool, optional): as in
+            :meth:`~torch.distributed.rpc.RRef.to_here`. The cached values
+            aren't fetched again. Default: ``False``.
+
+    Returns:
+        The list of the values of ``rrefs``, in the same order.
+
+    Example::
+        >>> import torch
+        >>> import torch.distributed.rpc as rpc
+        >>> rrefs = [
+        >>>     rpc.remote("worker1", torch.add, args=(torch.ones(2), i))
+        >>>     for i in range(8)
+        >>> ]
+        >>> values = rpc.batch_to_here(rrefs)
+    """
+    return _to_here_batch(list(rrefs), timeout, cache)
+
+
 def _to_worker_info(name_or_info):
     if isinstance(name_or_info, WorkerInfo):
         return name_or_info
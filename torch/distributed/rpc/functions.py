@@ -1,5 +1,7 @@
 import functools
 
+import torch
+
 
 def async_execution(fn):
     r"""
@@ -135,3 +137,69 @@ def async_execution(fn):
         return fn(*args, **kwargs)
     wrapper._wrapped_async_rpc_function = fn
     return wrapper
+
+
+def enable_batching(fn, max_batch_size, max_wait_ms):
+    r"""
+    Batches concurrent :meth:`~torch.distributed.rpc.rpc_sync` and
+    :meth:`~torch.distributed.rpc.rpc_async` calls to the TorchScript function
+    ``fn`` that run on this worker. Instead of running ``fn`` once per request, the callee
+    concatenates the arguments of up to ``max_batch_size`` pending requests
+    along dimension 0, runs ``fn`` once on the result, and splits the return
+    value along dimension 0 back into the individual responses. This helps
+    when RPC is used to serve inference requests, where one large batch is
+    much cheaper to run than many small ones.
+
+    A batch runs as soon as it holds ``max_batch_size`` requests, or when its
+    first request has waited for ``max_wait_ms`` milliseconds. Only requests
+    whose arguments are all Tensors with the same size in dimension 0 are
+    batched; other requests run on their own as before. ``fn`` must return a
+    Tensor or a tuple of Tensors whose size in dimension 0 is the sum of the
+    sizes of its arguments in dimension 0, and it must treat the rows of its
+    arguments independently of each other. Requests that use distributed
+    autograd or the RPC profiler, or that run ``async_execution`` functions,
+    are never batched.
+
+    Arguments:
+        fn (torch.jit.ScriptFunction): the TorchScript function to batch.
+        max_batch_size (int): the maximum number of requests in a batch.
+        max_wait_ms (float): the maximum time, in milliseconds, a request
+            waits for other requests to join its batch.
+
+    Example::
+        >>> import torch.distributed.rpc as rpc
+        >>>
+        >>> @torch.jit.script
+        >>> def classify(x: torch.Tensor) -> torch.Tensor:
+        >>>     return x.argmax(dim=1)
+        >>>
+        >>> # On the callee, after init_rpc:
+        >>> rpc.functions.enable_batching(classify, max_batch_size=32, max_wait_ms=5)
+        >>>
+        >>> # On each caller:
+        >>> fut = rpc.rpc_async("server", classify, args=(torch.rand(1, 10),))
+    """
+    from . import _enable_script_call_batching
+
+    if not isinstance(fn, torch.jit.ScriptFunction):
+        raise ValueError(
+            "enable_batching expects a torch.jit.ScriptFunction, but got {}".format(
+                type(fn)
+            )
+        )
+    _enable_script_call_batching(
+        torch._jit_internal._qualified_name(fn), max_batch_size, max_wait_ms / 1000.0
+    )
+
+
+def disable_batching(fn):
+    r"""
+    Stops batching RPCs to ``fn`` (see :meth:`enable_batching`). Requests that
+    are already waiting to be batched still run.
+
+    Arguments:
+        fn (torch.jit.ScriptFunction): the TorchScript function.
+    """
+    from . import _disable_script_call_batching
+
+    _disable_script_call_batching(torch._jit_internal._qualified_name(fn))
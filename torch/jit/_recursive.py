@@ -253,8 +253,9 @@ class ConcreteTypeStore(object):
     def __init__(self):
         # Python module type => List[ConcreteModuleType)]
         self.type_store = {}
-        # ConcreteTypes that have had their methods already compiled
-        self.methods_compiled = set()
+        # ConcreteTypes that have had their methods already compiled =>
+        # List[(method name, Python function it was compiled from)]
+        self.methods_compiled = {}
 
     def get_or_create_concrete_type(self, nn_module):
         """
@@ -326,7 +327,10 @@ def create_script_module_impl(nn_module, concrete_type, stubs_fn):
         stubs_fn:  Lambda that takes an nn.Module and generates a list of ScriptMethodStubs to compile.
     """
     cpp_module = torch._C._create_module_with_type(concrete_type.jit_type)
-    stubs = stubs_fn(nn_module)
+    # Instances sharing a concrete type share its compiled methods, so the
+    # (comparatively expensive) parsing of their sources is only done once.
+    compiled_methods = concrete_type_store.methods_compiled.get(concrete_type)
+    stubs = stubs_fn(nn_module) if compiled_methods is None else None
 
     def init_fn(script_module):
         # Initialize the ScriptModule:
@@ -372,10 +376,26 @@ def create_script_module_impl(nn_module, concrete_type, stubs_fn):
     script_module = torch.jit.RecursiveScriptModule._construct(cpp_module, init_fn)
 
     # Compile methods if necessary
-    if concrete_type not in concrete_type_store.methods_compiled:
+    if compiled_methods is None:
         create_methods_from_stubs(concrete_type, stubs)
         torch._C._run_emit_module_hook(cpp_module)
-        concrete_type_store.methods_compiled.add(concrete_type)
+        compiled_methods = []
+        for stub in stubs:
+            if stub.original_method is None:
+                # define()'d methods don't have an Python original_method, so we
+                # don't need to do any Python re-wrapping stuff
+                continue
+            name = stub.original_method.__name__
+            if name != stub.def_.name().name:
+                # TODO: Why skip this? Because @torch.jit._overload_method will
+                # mangle the name of the function.
+                continue
+            original_fn = stub.original_method
+            if inspect.ismethod(original_fn):
+                # don't keep this instance alive through the store
+                original_fn = original_fn.__func__
+            compiled_methods.append((name, original_fn))
+        concrete_type_store.methods_compiled[concrete_type] = compiled_methods
 
     # Special handling so methods like __len__ work in script methods on classes derived from containers
     if isinstance(nn_module, (torch.nn.ModuleList, torch.nn.Sequential, torch.nn.ModuleDict)) and \
@@ -391,23 +411,16 @@ def create_script_module_impl(nn_module, concrete_type, stubs_fn):
 
 
     # Make the compiled methods available to the Python ScriptModule class.
-    for stub in stubs:
-        if stub.original_method is None:
-            # define()'d methods don't have an Python original_method, so we
-            # don't need to do any Python re-wrapping stuff
-            continue
-
-        name = stub.original_method.__name__
-        if name != stub.def_.name().name:
-            # TODO: Why skip this? Because @torch.jit._overload_method will
-            # mangle the name of the function.
-            continue
+    for name, original_fn in compiled_methods:
         script_method = cpp_module._get_method(name)
+        original_method = getattr(nn_module, name, None)
+        if not inspect.ismethod(original_method) or original_method.__func__ is not original_fn:
+            original_method = original_fn
 
         # Wrap the original to propagate docstrings and such.
         # TODO: we don't currently do this functions that are recursively
         # compiled, we should.
-        script_method = functools.wraps(stub.original_method)(script_method)
+        script_method = functools.wraps(original_method)(script_method)
 
         # Add the methods to the script_module directly. This ensures they will
         # be found first when `name` is looked up (as opposed to the stubs or
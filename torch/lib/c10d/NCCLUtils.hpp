@@ -29,6 +29,14 @@
 #endif
 #endif
 
+// ncclCommSplit() is available from NCCL 2.18.
+#if defined(NCCL_MAJOR) && (NCCL_MAJOR == 2) && defined(NCCL_MINOR) && \
+    (NCCL_MINOR >= 18)
+#define ENABLE_NCCL_COMM_SPLIT
+#elif defined(NCCL_MAJOR) && (NCCL_MAJOR >= 3)
+#define ENABLE_NCCL_COMM_SPLIT
+#endif
+
 // Macro to throw on a non-successful NCCL return value.
 #define C10D_NCCL_CHECK(cmd)                                                 \
   do {                                                                       \
@@ -96,6 +104,29 @@ class NCCLComm {
     return comm;
   }
 
+#ifdef ENABLE_NCCL_COMM_SPLIT
+  // Creates the communicator of `color' from `source', ordering its ranks by
+  // `key'. Collective over all ranks of `source'; ranks that pass
+  // NCCL_SPLIT_NOCOLOR get nullptr. Split communicators have no ncclUniqueId
+  // of their own, so the caller provides `commId' to identify it (e.g. in the
+  // aborted communicator keys of the store), which must be the same on all
+  // ranks of the new communicator.
+  static std::shared_ptr<NCCLComm> split(
+      NCCLComm* source,
+      int color,
+      int key,
+      ncclUniqueId commId) {
+    auto comm = std::make_shared<NCCLComm>();
+    C10D_NCCL_CHECK(ncclCommSplit(
+        source->getNcclComm(), color, key, &(comm->ncclComm_), nullptr));
+    if (comm->ncclComm_ == nullptr) {
+      return nullptr;
+    }
+    comm->ncclId_ = commId;
+    return comm;
+  }
+#endif
+
   ncclUniqueId getNcclId() {
     return ncclId_;
   }
@@ -88,6 +88,13 @@ ProcessGroup::~ProcessGroup() {}
 
 // This is introduced so that implementors of ProcessGroup would not need to
 // have this implmentation.
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::broadcast_coalesced(
+    std::vector<at::Tensor>& /* unused */,
+    const BroadcastOptions& /* unused */) {
+  throw std::runtime_error(
+      "no support for broadcast_coalesced in this process group");
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroup::allgather_coalesced(
     std::vector<std::vector<at::Tensor>>& /* usused */,
     std::vector<at::Tensor>& /* usused */,
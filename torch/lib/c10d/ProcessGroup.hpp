@@ -133,6 +133,15 @@ class ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceCoalescedOptions& opts = AllreduceCoalescedOptions()) = 0;
 
+  // Broadcasts all `tensors` from `opts.rootRank` as a single collective and
+  // returns a single Work for them. Unlike `broadcast`, every tensor is a
+  // separate payload (not a replica on another device), so `opts.rootTensor`
+  // is ignored. Useful to sync many small tensors, such as parameters and
+  // buffers, without paying the per collective overhead for each.
+  virtual std::shared_ptr<ProcessGroup::Work> broadcast_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions());
+
   virtual std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) = 0;
@@ -405,7 +405,10 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      allreduceStripeMinBytes(1 << 20),
+      allreduceRingMinBytes(0) {}
 
 namespace {
 
@@ -523,7 +526,9 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
-      collectiveCounter_(0) {
+      collectiveCounter_(0),
+      allreduceStripeMinBytes_(options.allreduceStripeMinBytes),
+      allreduceRingMinBytes_(options.allreduceRingMinBytes) {
   auto& devices = options.devices;
   if (devices.empty()) {
     throw std::runtime_error("No device(s) specified");
@@ -771,6 +776,67 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::broadcast(
 
 namespace {
 
+class AsyncBroadcastCoalescedWork : public AsyncBroadcastWork {
+ public:
+  AsyncBroadcastCoalescedWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      int rootRank,
+      uint32_t tag)
+      : AsyncBroadcastWork(context, inputs, rootRank, 0, tag) {}
+
+  void run() override {
+    // Broadcasts all tensors as one flattened buffer.
+    at::Tensor coalescedTensor = flattenDenseTensors(inputs);
+    broadcast(coalescedTensor);
+
+    size_t offset = 0;
+    for (at::Tensor& tensor : inputs) {
+      const int64_t tensorNumel = tensor.numel();
+      tensor.copy_(coalescedTensor.slice(0, offset, offset + tensorNumel)
+                       .view(tensor.sizes()));
+      offset += tensorNumel;
+    }
+  }
+};
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::broadcast_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupGloo::broadcast_coalesced: " + msg);
+  };
+  assertNonEmpty(invalidArgument, tensors);
+  assertRootRank(invalidArgument, opts.rootRank, size_);
+  assertDense(invalidArgument, tensors);
+
+  // tensors will be flattened and concatenated (coalesced), so they must
+  // have the same device and type.
+  if (!std::all_of(tensors.begin(), tensors.end(), [&](at::Tensor& t) {
+        return t.options().type_equal(tensors[0].options());
+      })) {
+    invalidArgument("tensors must all have the same type");
+  }
+  assertSameDevice(invalidArgument, tensors);
+
+  const auto& device = tensors[0].device();
+  if (device.type() != at::kCPU) {
+    invalidArgument(c10::str("unsupported device type ", device.type()));
+  }
+
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncBroadcastCoalescedWork>(
+      std::move(context), tensors, opts.rootRank, tag);
+  enqueue(work);
+  return work;
+}
+
+namespace {
+
 class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
  public:
   AsyncAllreduceWork(
@@ -784,12 +850,26 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
   std::vector<at::Tensor> inputs;
   const ReduceOp reduceOp;
   const uint32_t tag;
+  // See ProcessGroupGloo::Options::allreduceRingMinBytes
+  int64_t ringMinBytes = 0;
 
   void allreduce(std::vector<at::Tensor>& tensors) {
+    allreduce(tensors, context);
+  }
+
+  void allreduce(
+      std::vector<at::Tensor>& tensors,
+      const std::shared_ptr<gloo::Context>& context) {
     const auto& scalarType = tensors[0].scalar_type();
     gloo::AllreduceOptions opts(context);
     opts.setReduceFunction(getFunction(scalarType, reduceOp));
     opts.setTag(tag);
+    if (ringMinBytes > 0) {
+      opts.setAlgorithm(
+          static_cast<int64_t>(tensors[0].nbytes()) < ringMinBytes
+              ? gloo::AllreduceOptions::Algorithm::BCUBE
+              : gloo::AllreduceOptions::Algorithm::RING);
+    }
     GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors);
     gloo::allreduce(opts);
   }
@@ -820,6 +900,68 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
   }
 };
 
+// Splits the allreduce of large, contiguous tensors in one stripe per
+// context, and runs the stripes concurrently, each over the connections and
+// I/O thread of its context, so that a single collective can saturate a fast
+// NIC. All ranks make the same split, and every stripe uses the collective's
+// tag on its own context, so the stripes can't match other collectives.
+class AsyncStripedAllreduceWork : public AsyncAllreduceWork {
+ public:
+  AsyncStripedAllreduceWork(
+      std::vector<std::shared_ptr<gloo::Context>> contexts,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(contexts[0], inputs, reduceOp, tag),
+        contexts(std::move(contexts)) {}
+
+  std::vector<std::shared_ptr<gloo::Context>> contexts;
+
+  void run() override {
+    const int64_t numel = inputs[0].numel();
+    const int64_t numStripes = contexts.size();
+    const int64_t stripeNumel = (numel + numStripes - 1) / numStripes;
+
+    std::vector<std::exception_ptr> errors(numStripes);
+    auto runStripe = [&](int64_t i) {
+      try {
+        const int64_t begin = i * stripeNumel;
+        const int64_t length = std::min(stripeNumel, numel - begin);
+        if (length <= 0) {
+          return;
+        }
+        std::vector<at::Tensor> stripes;
+        stripes.reserve(inputs.size());
+        for (auto& input : inputs) {
+          stripes.push_back(input.view({-1}).narrow(0, begin, length));
+        }
+        allreduce(stripes, contexts[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numStripes - 1);
+    for (int64_t i = 1; i < numStripes; i++) {
+      threads.emplace_back(runStripe, i);
+    }
+    runStripe(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    // Only the first output in the tensor list contains the results.
+    for (size_t i = 1; i < inputs.size(); i++) {
+      inputs[i].copy_(inputs[0]);
+    }
+  }
+};
+
 class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
  public:
   AsyncAllreduceCoalescedWork(
@@ -1285,8 +1427,16 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     if (layout == c10::kStrided) {
-      work = std::make_shared<AsyncAllreduceWork>(
-          std::move(context), inputs, opts.reduceOp, tag);
+      std::shared_ptr<AsyncAllreduceWork> allreduceWork;
+      if (shouldStripeAllreduce(inputs)) {
+        allreduceWork = std::make_shared<AsyncStripedAllreduceWork>(
+            contexts_, inputs, opts.reduceOp, tag);
+      } else {
+        allreduceWork = std::make_shared<AsyncAllreduceWork>(
+            std::move(context), inputs, opts.reduceOp, tag);
+      }
+      allreduceWork->ringMinBytes = allreduceRingMinBytes_;
+      work = std::move(allreduceWork);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceWork>(
           std::move(context), inputs, tag);
@@ -1313,6 +1463,17 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   return work;
 }
 
+bool ProcessGroupGloo::shouldStripeAllreduce(
+    const std::vector<at::Tensor>& inputs) const {
+  if (contexts_.size() < 2 || allreduceStripeMinBytes_ <= 0 ||
+      static_cast<int64_t>(inputs[0].nbytes()) < allreduceStripeMinBytes_) {
+    return false;
+  }
+  return std::all_of(inputs.begin(), inputs.end(), [](const at::Tensor& t) {
+    return t.is_contiguous();
+  });
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
@@ -129,6 +129,16 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // With more than one device, dense CPU allreduces of at least this many
+    // bytes are split in one stripe per device, and the stripes run
+    // concurrently over the connections of their devices. 0 disables it.
+    int64_t allreduceStripeMinBytes;
+
+    // If positive, allreduces of fewer bytes than this use the bcube
+    // algorithm, which takes a logarithmic number of steps, and the others
+    // the bandwidth optimal ring. If 0, Gloo picks the algorithm.
+    int64_t allreduceRingMinBytes;
   };
 
   // Helper functions to create a new device object.
@@ -170,6 +180,10 @@ class ProcessGroupGloo : public ProcessGroup {
       const AllreduceCoalescedOptions& opts =
           AllreduceCoalescedOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> broadcast_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) override;
@@ -252,6 +266,13 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // Whether the dense CPU allreduce of inputs is split across the contexts.
+  bool shouldStripeAllreduce(const std::vector<at::Tensor>& inputs) const;
+
+  // See Options::allreduceStripeMinBytes and Options::allreduceRingMinBytes.
+  int64_t allreduceStripeMinBytes_;
+  int64_t allreduceRingMinBytes_;
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
@@ -1,5 +1,6 @@
 #include <c10d/ProcessGroupNCCL.hpp>
 
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <unordered_set>
@@ -236,8 +237,12 @@ ProcessGroupNCCL::WorkNCCL::WorkNCCL(const std::vector<at::Device>& devices)
     : devices_(devices), workStartTime_(std::chrono::steady_clock::now()) {
   // Creates the CUDA event wrappers
   // Note: The actual events are lazily created when first recorded to with
-  // DEFAULT_FLAGS = cudaEventDisableTiming.
-  cudaEvents_.resize(devices.size());
+  // DEFAULT_FLAGS = cudaEventDisableTiming. The collectives replace them with
+  // events from the pool of the process group.
+  cudaEvents_.reserve(devices.size());
+  for (size_t i = 0; i < devices.size(); ++i) {
+    cudaEvents_.push_back(std::make_shared<at::cuda::CUDAEvent>());
+  }
   ncclComms_.resize(devices.size());
 }
 
@@ -277,7 +282,7 @@ bool ProcessGroupNCCL::WorkNCCL::finishedGPUExecution() {
 bool ProcessGroupNCCL::WorkNCCL::finishedGPUExecutionInternal() const {
   for (size_t i = 0; i < devices_.size(); ++i) {
     // Checking the work's corresponding CUDA events' status
-    auto ret = cudaEventQuery(cudaEvents_[i]);
+    auto ret = cudaEventQuery(*cudaEvents_[i]);
     if (ret != cudaSuccess && ret != cudaErrorNotReady) {
       AT_CUDA_CHECK(ret);
     }
@@ -308,7 +313,7 @@ void ProcessGroupNCCL::WorkNCCL::synchronizeStreams() {
   for (size_t i = 0; i < devices_.size(); ++i) {
     auto currentStream = at::cuda::getCurrentCUDAStream(devices_[i].index());
     // Block the current stream on the NCCL stream
-    cudaEvents_[i].block(currentStream);
+    cudaEvents_[i]->block(currentStream);
   }
 }
 
@@ -390,16 +395,52 @@ void ProcessGroupNCCL::parseNcclBlockingWait() {
   }
 }
 
+ProcessGroupNCCL::Options::Options()
+    : opTimeout(kProcessGroupNCCLOpTimeoutMillis),
+      hierarchicalAllreduceLocalSize(0),
+      hierarchicalAllreduceMinBytes(1 << 20),
+      lightweightWork(false) {}
+
+namespace {
+
+ProcessGroupNCCL::Options optionsWithTimeout(
+    const std::chrono::milliseconds& opTimeout) {
+  ProcessGroupNCCL::Options options;
+  options.opTimeout = opTimeout;
+  return options;
+}
+
+} // namespace
+
 ProcessGroupNCCL::ProcessGroupNCCL(
     const std::shared_ptr<Store>& store,
     int rank,
     int size,
     const std::chrono::milliseconds& opTimeout)
+    : ProcessGroupNCCL(store, rank, size, optionsWithTimeout(opTimeout)) {}
+
+ProcessGroupNCCL::ProcessGroupNCCL(
+    const std::shared_ptr<Store>& store,
+    int rank,
+    int size,
+    const Options& options)
     : ProcessGroup(rank, size),
       store_(store),
       ncclCommCounter_(0),
       terminateWatchdog_(false),
-      opTimeout_(opTimeout) {
+      opTimeout_(options.opTimeout),
+      hierarchicalAllreduceLocalSize_(options.hierarchicalAllreduceLocalSize),
+      hierarchicalAllreduceMinBytes_(options.hierarchicalAllreduceMinBytes),
+      eventPool_(std::make_shared<CUDAEventPool>()),
+      lightweightWork_(options.lightweightWork) {
+  TORCH_CHECK(
+      hierarchicalAllreduceLocalSize_ <= 1 ||
+          size % hierarchicalAllreduceLocalSize_ == 0,
+      "ProcessGroupNCCL size (",
+      size,
+      ") must be a multiple of hierarchicalAllreduceLocalSize (",
+      hierarchicalAllreduceLocalSize_,
+      ")");
   try {
     parseNcclBlockingWait();
   } catch (std::exception& e) {
@@ -407,6 +448,10 @@ ProcessGroupNCCL::ProcessGroupNCCL(
         "Invalid value for environment variable: " +
         std::string(NCCL_BLOCKING_WAIT));
   }
+  TORCH_CHECK(
+      !(lightweightWork_ && blockingWait_),
+      "ProcessGroupNCCL lightweightWork is not supported with ",
+      NCCL_BLOCKING_WAIT);
 
 #ifdef ENABLE_NCCL_ERROR_CHECKING
   ncclCommWatchdogThread_ =
@@ -627,9 +672,6 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
 
   at::cuda::OptionalCUDAGuard gpuGuard;
 
-  std::vector<at::cuda::CUDAStream> streamVal;
-  streamVal.reserve(devices.size());
-
   // Create the NCCL communicators for each GPU
   C10D_NCCL_CHECK(ncclGroupStart());
 
@@ -640,13 +682,32 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
 
     gpuGuard.set_index(devices[i].index());
     ncclComms[i] = NCCLComm::create(numRanks, rank, ncclID);
-
-    // Creates the NCCL streams
-    streamVal.push_back(at::cuda::getStreamFromPool());
   }
 
   C10D_NCCL_CHECK(ncclGroupEnd());
 
+  return registerNCCLComm(devicesKey, devices, std::move(ncclComms), ncclID);
+}
+
+std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::registerNCCLComm(
+    const std::string& devicesKey,
+    const std::vector<at::Device>& devices,
+    std::vector<std::shared_ptr<NCCLComm>> ncclComms,
+    const ncclUniqueId& ncclID) {
+  for (auto& device : devices) {
+    usedDeviceIdxs_.insert(device.index());
+  }
+
+  at::cuda::OptionalCUDAGuard gpuGuard;
+
+  // Creates the NCCL streams
+  std::vector<at::cuda::CUDAStream> streamVal;
+  streamVal.reserve(devices.size());
+  for (auto& device : devices) {
+    gpuGuard.set_index(device.index());
+    streamVal.push_back(at::cuda::getStreamFromPool());
+  }
+
   ncclStreams_.emplace(devicesKey, std::move(streamVal));
 
   // Note: these events are created with the (default) cudaEventDisableTiming
@@ -669,6 +730,123 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   return devNCCLCommMap_[devicesKey];
 }
 
+bool ProcessGroupNCCL::isCommSplitSupported() {
+#ifdef ENABLE_NCCL_COMM_SPLIT
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::shared_ptr<ProcessGroupNCCL> ProcessGroupNCCL::split(
+    const std::shared_ptr<Store>& store,
+    const std::vector<int>& ranks,
+    const at::Device& device,
+    const Options& options) {
+  const auto it = std::find(ranks.begin(), ranks.end(), rank_);
+  std::shared_ptr<ProcessGroupNCCL> group;
+  if (it != ranks.end()) {
+    group = std::make_shared<ProcessGroupNCCL>(
+        store,
+        static_cast<int>(it - ranks.begin()),
+        static_cast<int>(ranks.size()),
+        options);
+  }
+
+#ifdef ENABLE_NCCL_COMM_SPLIT
+  const std::vector<at::Device> devices{device};
+  const auto key = getKeyFromDevices(devices);
+  auto& parentComms = getNCCLComm(key, devices);
+
+  // Split communicators have no ncclUniqueId, so derive one from the parent's,
+  // which is the same on all ranks, and the number of splits so far.
+  auto ncclID = parentComms[0]->getNcclId();
+  const uint64_t splitIndex = ++splitCounter_;
+  for (size_t i = 0; i < sizeof(splitIndex); ++i) {
+    ncclID.internal[NCCL_UNIQUE_ID_BYTES - 1 - i] ^=
+        static_cast<char>((splitIndex >> (8 * i)) & 0xff);
+  }
+
+  at::cuda::OptionalCUDAGuard gpuGuard(device);
+  auto ncclComm = NCCLComm::split(
+      parentComms[0].get(),
+      group ? 0 : NCCL_SPLIT_NOCOLOR,
+      group ? group->getRank() : 0,
+      ncclID);
+  if (group) {
+    group->registerNCCLComm(key, devices, {std::move(ncclComm)}, ncclID);
+  }
+#endif
+
+  return group;
+}
+
+ProcessGroupNCCL::HierarchicalNCCLComms& ProcessGroupNCCL::
+    getHierarchicalNCCLComms(
+        const std::string& devicesKey,
+        const at::Device& device) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hierarchicalNCCLCommMap_.find(devicesKey);
+    if (it != hierarchicalNCCLCommMap_.end()) {
+      return it->second;
+    }
+  }
+
+  // Ranks [node * localSize, (node + 1) * localSize) share a node.
+  const int localSize = hierarchicalAllreduceLocalSize_;
+  const int node = rank_ / localSize;
+  const int localRank = rank_ % localSize;
+  const int numNodes = size_ / localSize;
+
+  // Like broadcastUniqueNCCLID, but the ID is created by the first rank of
+  // the group instead of rank 0.
+  const auto keyPrefix =
+      "hierarchical/" + std::to_string(ncclCommCounter_++) + "/";
+  const auto exchangeNCCLID = [this](const std::string& storeKey, bool root) {
+    ncclUniqueId ncclID;
+    if (root) {
+      C10D_NCCL_CHECK(ncclGetUniqueId(&ncclID));
+      auto vec = std::vector<uint8_t>(
+          reinterpret_cast<uint8_t*>(&ncclID),
+          reinterpret_cast<uint8_t*>(&ncclID) + NCCL_UNIQUE_ID_BYTES);
+      store_->set(storeKey, vec);
+    } else {
+      auto vec = store_->get(storeKey);
+      TORCH_CHECK(vec.size() == NCCL_UNIQUE_ID_BYTES);
+      std::memcpy(&ncclID, vec.data(), vec.size());
+    }
+    return ncclID;
+  };
+  const auto intraNodeID = exchangeNCCLID(
+      keyPrefix + "node/" + std::to_string(node), localRank == 0);
+  const auto interNodeID = exchangeNCCLID(
+      keyPrefix + "local_rank/" + std::to_string(localRank), node == 0);
+
+  // Every rank creates the node-local communicator first, so the blocking
+  // initializations cannot wait on each other.
+  at::cuda::OptionalCUDAGuard gpuGuard(device);
+  HierarchicalNCCLComms comms;
+  comms.intraNode = NCCLComm::create(localSize, localRank, intraNodeID);
+  comms.interNode = NCCLComm::create(numNodes, node, interNodeID);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ncclIdToCommMap_.emplace(
+      buildNcclUniqueIdStr(intraNodeID),
+      std::vector<std::shared_ptr<NCCLComm>>{comms.intraNode});
+  ncclIdToCommMap_.emplace(
+      buildNcclUniqueIdStr(interNodeID),
+      std::vector<std::shared_ptr<NCCLComm>>{comms.interNode});
+  devNCCLCommMap_.emplace(
+      devicesKey + "/intra_node",
+      std::vector<std::shared_ptr<NCCLComm>>{comms.intraNode});
+  devNCCLCommMap_.emplace(
+      devicesKey + "/inter_node",
+      std::vector<std::shared_ptr<NCCLComm>>{comms.interNode});
+  return hierarchicalNCCLCommMap_.emplace(devicesKey, std::move(comms))
+      .first->second;
+}
+
 namespace {
 
 // Check validity of tensor
@@ -721,6 +899,27 @@ void check_gpu_tensors(const std::vector<at::Tensor>& tensors) {
   }
 }
 
+// Checks the inputs of a coalesced collective: unlike check_gpu_tensors, the
+// tensors are separate payloads that live on the same device.
+void check_gpu_tensors_coalesced(const std::vector<at::Tensor>& tensors) {
+  if (tensors.size() == 0) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+
+  const auto& first = tensors.front();
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (t.get_device() != first.get_device()) {
+      throw std::runtime_error("Tensors must be on the same GPU device");
+    }
+    if (!t.is_non_overlapping_and_dense()) {
+      throw std::runtime_error("Tensors must be non-overlapping and dense");
+    }
+  }
+}
+
 // Flatten each list in `tensor_lists' for a gather or scatter operation, and
 // ensure compatibility with the corresponding tensor in `other'.
 std::vector<at::Tensor> flatten_for_scatter_gather(
@@ -775,9 +974,68 @@ c10::intrusive_ptr<c10::ivalue::Future> ProcessGroupNCCL::WorkNCCL::
   // FutureNCCL has a reference to WorkNCCL. Therefore, we don't store a
   // FutureNCCL reference inside WorkNCCL and we create a new object here
   // to avoid circular reference between WorkNCCL and FutureNCCL.
+  TORCH_CHECK(
+      outputs_,
+      "getFuture is not supported for the works of a ProcessGroupNCCL "
+      "created with lightweightWork");
   return c10::make_intrusive<FutureNCCL>(shared_from_this(), outputs_);
 }
 
+std::shared_ptr<at::cuda::CUDAEvent> ProcessGroupNCCL::CUDAEventPool::get(
+    at::DeviceIndex device) {
+  std::unique_ptr<at::cuda::CUDAEvent> event;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& events = events_[device];
+    if (!events.empty()) {
+      event = std::move(events.back());
+      events.pop_back();
+    }
+  }
+  if (!event) {
+    event.reset(new at::cuda::CUDAEvent());
+  }
+
+  // The event goes back to the pool when the last work holding it is
+  // destroyed, unless the pool is already gone.
+  std::weak_ptr<CUDAEventPool> weakPool = shared_from_this();
+  return std::shared_ptr<at::cuda::CUDAEvent>(
+      event.release(), [weakPool, device](at::cuda::CUDAEvent* event) {
+        std::unique_ptr<at::cuda::CUDAEvent> owned(event);
+        if (auto pool = weakPool.lock()) {
+          std::lock_guard<std::mutex> lock(pool->mutex_);
+          pool->events_[device].push_back(std::move(owned));
+        }
+      });
+}
+
+void ProcessGroupNCCL::recordWork(
+    WorkNCCL& work,
+    const std::vector<at::Device>& devices,
+    const std::vector<std::shared_ptr<NCCLComm>>& ncclComms,
+    std::vector<at::cuda::CUDAStream>& ncclStreams,
+    const std::vector<at::Tensor>& outputs) {
+  for (size_t i = 0; i < devices.size(); ++i) {
+    work.cudaEvents_[i] = eventPool_->get(devices[i].index());
+    work.cudaEvents_[i]->record(ncclStreams[i]);
+  }
+  work.blockingWait_ = blockingWait_;
+  work.opTimeout_ = opTimeout_;
+
+  if (lightweightWork_) {
+    // See Options::lightweightWork.
+    work.ncclComms_.clear();
+    return;
+  }
+
+  for (size_t i = 0; i < devices.size(); ++i) {
+    work.ncclComms_[i] = ncclComms[i];
+  }
+  work.store_ = store_;
+  // Store a reference to outputs to be used by WorkNCCL::getFuture.
+  work.outputs_ = std::make_shared<std::vector<at::Tensor>>(outputs);
+}
+
 template <typename Fn, typename PreProcess, typename PostProcess>
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     std::vector<at::Tensor>& inputs,
@@ -795,9 +1053,6 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
   // Work itself will create the CUDA events on all GPUs of tensors
   auto work = initWork(devices);
 
-  // Store a reference to outputs to be used by WorkNCCL::getFuture.
-  work->outputs_ = std::make_shared<std::vector<at::Tensor>>(outputs);
-
   at::cuda::OptionalCUDAGuard gpuGuard;
 
   pre(ncclStreams_[key]);
@@ -831,15 +1086,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
   post(ncclStreams_[key]);
 
   // Event should only be recorded after the ncclGroupEnd()
-  for (size_t i = 0; i < inputs.size(); ++i) {
-    at::cuda::CUDAStream& ncclStream = ncclStreams_[key][i];
-    work->cudaEvents_[i].record(ncclStream);
-    work->ncclComms_[i] = ncclComms[i];
-    work->blockingWait_ = blockingWait_;
-    work->opTimeout_ = opTimeout_;
-    work->store_ = store_;
-  }
-
+  recordWork(*work, devices, ncclComms, ncclStreams_[key], outputs);
   return work;
 }
 
@@ -856,11 +1103,166 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
       [](std::vector<at::cuda::CUDAStream>&) {});
 }
 
+template <typename Fn, typename PostProcess>
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collectiveCoalesced(
+    std::vector<at::Tensor>& inputs,
+    std::vector<at::Tensor>& outputs,
+    Fn fn,
+    PostProcess post) {
+  const std::vector<at::Device> devices{inputs[0].device()};
+  const auto key = getKeyFromDevices(devices);
+  auto& ncclComms = getNCCLComm(key, devices);
+
+  // First let NCCL streams wait for input tensors allocation streams
+  syncStreams(devices, ncclEvents_[key], ncclStreams_[key]);
+
+  auto work = initWork(devices);
+
+  at::cuda::OptionalCUDAGuard gpuGuard(devices[0]);
+  at::cuda::CUDAStream& ncclStream = ncclStreams_[key][0];
+
+  // See [Sync Streams].
+  for (auto& input : inputs) {
+    c10::cuda::CUDACachingAllocator::recordStream(
+        input.storage().data_ptr(), ncclStream);
+  }
+
+  {
+    AutoNcclGroup nccl_group_guard;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      C10D_NCCL_CHECK(
+          fn(inputs[i], outputs[i], ncclComms[0]->getNcclComm(), ncclStream));
+    }
+  }
+
+  post(ncclStream);
+
+  // Event should only be recorded after the ncclGroupEnd()
+  recordWork(*work, devices, ncclComms, ncclStreams_[key], outputs);
+  return work;
+}
+
+// Note [Hierarchical allreduce]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A flat ring allreduce over N ranks sends about 2 * (N - 1) / N times the
+// tensor size over every link of the ring, including the slow ones between
+// nodes. With L ranks per node, the hierarchical allreduce instead:
+//
+//   1. reduce-scatters the tensor within the node, so that every local rank
+//      holds the node's sum of one 1/L shard,
+//   2. allreduces each shard across nodes among the ranks with the same
+//      local rank, and
+//   3. allgathers the shards within the node.
+//
+// Only step 2 crosses nodes and it moves 1/L of the data per rank, spread
+// over L concurrent rings, which cuts the inter-node traffic by a factor of
+// L. All three steps run in place on the NCCL stream, so the result and the
+// Work semantics are the same as for the flat allreduce and callers such as
+// the DDP reducer need no changes. Tensors whose size is not a multiple of L
+// go through a padded copy.
+//
+// It assumes one device per process and that the ranks of a node are
+// consecutive, which is how torch.distributed.launch assigns them.
+bool ProcessGroupNCCL::useHierarchicalAllreduce(
+    const std::vector<at::Tensor>& tensors) const {
+  const int localSize = hierarchicalAllreduceLocalSize_;
+  if (localSize <= 1 || size_ / localSize <= 1 || tensors.size() != 1) {
+    return false;
+  }
+  const auto& tensor = tensors.front();
+  return tensor.numel() * tensor.element_size() >=
+      hierarchicalAllreduceMinBytes_;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduceHierarchical(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  const auto devices = getDeviceList(tensors);
+  const auto key = getKeyFromDevices(devices);
+  // Also sets up the streams and events for this set of devices.
+  auto& ncclComms = getNCCLComm(key, devices);
+  auto& comms = getHierarchicalNCCLComms(key, devices[0]);
+
+  // First let NCCL streams wait for input tensors allocation streams
+  syncStreams(devices, ncclEvents_[key], ncclStreams_[key]);
+
+  auto work = initWork(devices);
+
+  at::cuda::OptionalCUDAGuard gpuGuard(devices[0]);
+  at::cuda::CUDAStream& ncclStream = ncclStreams_[key][0];
+  auto& tensor = tensors[0];
+  // See [Sync Streams].
+  c10::cuda::CUDACachingAllocator::recordStream(
+      tensor.storage().data_ptr(), ncclStream);
+
+  const int localSize = hierarchicalAllreduceLocalSize_;
+  const int localRank = rank_ % localSize;
+  const auto numel = tensor.numel();
+  const auto shardNumel = (numel + localSize - 1) / localSize;
+
+  auto flat = tensor.view({-1});
+  auto buffer = flat;
+  if (shardNumel * localSize != numel) {
+    // Allocated on the NCCL stream, so it needs no recordStream. The padding
+    // is only ever reduced with padding.
+    at::cuda::CUDAStreamGuard guard(ncclStream);
+    buffer = at::zeros({shardNumel * localSize}, tensor.options());
+    buffer.narrow(0, 0, numel).copy_(flat);
+  }
+
+  const auto dataType = getNcclDataType(tensor.scalar_type());
+  const auto reduceOp = getNcclReduceOp(opts.reduceOp, tensor);
+  auto* base = static_cast<char*>(buffer.data_ptr());
+  auto* shard = base + localRank * shardNumel * buffer.element_size();
+  {
+    // The three steps depend on each other, so they are not grouped. See
+    // AutoNcclGroup for why the free mutex is held.
+    std::lock_guard<std::mutex> freeLock(
+        *c10::cuda::CUDACachingAllocator::getFreeMutex());
+    C10D_NCCL_CHECK(ncclReduceScatter(
+        base,
+        shard,
+        shardNumel,
+        dataType,
+        reduceOp,
+        comms.intraNode->getNcclComm(),
+        ncclStream.stream()));
+    C10D_NCCL_CHECK(ncclAllReduce(
+        shard,
+        shard,
+        shardNumel,
+        dataType,
+        reduceOp,
+        comms.interNode->getNcclComm(),
+        ncclStream.stream()));
+    C10D_NCCL_CHECK(ncclAllGather(
+        shard,
+        base,
+        shardNumel,
+        dataType,
+        comms.intraNode->getNcclComm(),
+        ncclStream.stream()));
+  }
+
+  if (!buffer.is_same(flat)) {
+    at::cuda::CUDAStreamGuard guard(ncclStream);
+    flat.copy_(buffer.narrow(0, 0, numel));
+  }
+
+  recordWork(*work, devices, ncclComms, ncclStreams_[key], tensors);
+  return work;
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
     std::vector<at::Tensor>& tensors,
     const AllreduceOptions& opts) {
   check_gpu_tensors(tensors);
 
+  // See Note [Hierarchical allreduce]
+  if (useHierarchicalAllreduce(tensors)) {
+    return allreduceHierarchical(tensors, opts);
+  }
+
   return collective(
       tensors,
       tensors,
@@ -882,8 +1284,48 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with NCCL");
+  check_gpu_tensors_coalesced(tensors);
+
+  return collectiveCoalesced(
+      tensors,
+      tensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllReduce(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            getNcclReduceOp(opts.reduceOp, input),
+            comm,
+            stream.stream());
+      },
+      [](at::cuda::CUDAStream&) {});
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  check_gpu_tensors_coalesced(tensors);
+
+  return collectiveCoalesced(
+      tensors,
+      tensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclBcast(
+            input.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            opts.rootRank,
+            comm,
+            stream.stream());
+      },
+      [](at::cuda::CUDAStream&) {});
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
@@ -978,11 +1420,73 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_coalesced(
-    std::vector<std::vector<at::Tensor>>& /* unused */,
-    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& outputTensorLists,
+    std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& /* unused */) {
-  throw std::runtime_error(
-      "ProcessGroupNCCL does not support allgather_coalesced");
+  check_gpu_tensors_coalesced(inputTensors);
+  if (outputTensorLists.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "Tensor list operands to allgather_coalesced must have one list per "
+        "rank");
+  }
+  for (const auto& outputTensors : outputTensorLists) {
+    if (outputTensors.size() != inputTensors.size()) {
+      throw std::runtime_error(
+          "Output tensor lists must be as long as the input tensor list");
+    }
+    for (size_t i = 0; i < inputTensors.size(); ++i) {
+      if (outputTensors[i].scalar_type() != inputTensors[i].scalar_type() ||
+          outputTensors[i].sizes() != inputTensors[i].sizes()) {
+        throw std::runtime_error(
+            "Output tensors must match the input tensors in type and size");
+      }
+    }
+  }
+
+  // Every input is gathered into a flat buffer holding the contributions of
+  // all ranks, which is copied to the outputs afterwards.
+  std::vector<at::Tensor> inputsContiguous;
+  std::vector<at::Tensor> outputsFlattened;
+  inputsContiguous.reserve(inputTensors.size());
+  outputsFlattened.reserve(inputTensors.size());
+  for (const auto& input : inputTensors) {
+    inputsContiguous.push_back(input.contiguous());
+    outputsFlattened.push_back(
+        at::empty({size_ * input.numel()}, input.options()));
+  }
+
+  return collectiveCoalesced(
+      inputsContiguous,
+      outputsFlattened,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      },
+      [&](at::cuda::CUDAStream& ncclStream) {
+        at::cuda::CUDAStreamGuard guard(ncclStream);
+        for (size_t r = 0; r < outputTensorLists.size(); ++r) {
+          for (size_t i = 0; i < inputTensors.size(); ++i) {
+            auto& output = outputTensorLists[r][i];
+            const auto numel = output.numel();
+            // See [Sync Streams].
+            c10::cuda::CUDACachingAllocator::recordStream(
+                output.storage().data_ptr(), ncclStream);
+            output.copy_(
+                outputsFlattened[i].narrow(0, r * numel, numel).view_as(output),
+                true);
+          }
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
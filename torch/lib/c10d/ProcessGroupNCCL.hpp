@@ -93,8 +93,10 @@ class ProcessGroupNCCL : public ProcessGroup {
     // The cached list of CUDA devices to operate on
     std::vector<at::Device> devices_;
 
-    // The CUDA events tracking this work item on multiple CUDA devices
-    std::vector<at::cuda::CUDAEvent> cudaEvents_;
+    // The CUDA events tracking this work item on multiple CUDA devices. The
+    // collectives take them from the event pool of the process group, and they
+    // go back to the pool when the work is destroyed.
+    std::vector<std::shared_ptr<at::cuda::CUDAEvent>> cudaEvents_;
 
     // The NCCL communicators used for this work item.
     std::vector<std::shared_ptr<NCCLComm>> ncclComms_;
@@ -205,6 +207,31 @@ class ProcessGroupNCCL : public ProcessGroup {
     at::IValue outputs_;
   };
 
+  struct Options {
+    Options();
+
+    std::chrono::milliseconds opTimeout;
+
+    // If greater than 1, allreduce runs hierarchically over nodes of this
+    // many consecutive ranks (see Note [Hierarchical allreduce]): a
+    // reduce-scatter within the node, an allreduce of every shard across
+    // nodes, then an allgather within the node. This cuts the traffic over
+    // the (slower) links between nodes by a factor of the node size.
+    int hierarchicalAllreduceLocalSize;
+
+    // Tensors smaller than this are latency bound and still use a flat
+    // allreduce.
+    int64_t hierarchicalAllreduceMinBytes;
+
+    // If true, the works returned by collectives only keep what wait() needs,
+    // which cuts the host overhead of fire-and-forget collectives. They hold
+    // no reference to the outputs, so getFuture() is not supported, nor to
+    // the communicators, so isCompleted() and isSuccess() don't check them
+    // for errors (the watchdog still does). Not supported with
+    // NCCL_BLOCKING_WAIT.
+    bool lightweightWork;
+  };
+
   // If you wish to create multiple process groups, each with a potentially
   // different rank and size, you can do so by passing a new store instance
   // to each one. If you have only a single store object, you can
@@ -226,6 +253,12 @@ class ProcessGroupNCCL : public ProcessGroup {
       const std::chrono::milliseconds& opTimeout =
           std::chrono::milliseconds(kProcessGroupNCCLOpTimeoutMillis));
 
+  ProcessGroupNCCL(
+      const std::shared_ptr<Store>& store,
+      int rank,
+      int size,
+      const Options& options);
+
   // This constructor includes the deprecated `groupName` argument.
   // If you have existing code that uses the `groupName`, you can replace
   // it by specifying a `c10d::PrefixStore(groupName, store)` for store.
@@ -240,6 +273,25 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   virtual ~ProcessGroupNCCL();
 
+  // Creates the process group of `ranks` (ranks of this group, ordered by
+  // their rank in the new group) with `options`. If NCCL supports it, the
+  // communicator of the new group on `device` is split from the one of this
+  // group instead of being bootstrapped through the store, which matters when
+  // many subgroups are created. Communicators on other devices are created
+  // through `store` as usual.
+  //
+  // Must be called by all ranks of this group, in the same order. Returns
+  // nullptr on the ranks that are not in `ranks`.
+  std::shared_ptr<ProcessGroupNCCL> split(
+      const std::shared_ptr<Store>& store,
+      const std::vector<int>& ranks,
+      const at::Device& device,
+      const Options& options);
+
+  // Whether split() derives the communicators of the new group from this
+  // group's communicators.
+  static bool isCommSplitSupported();
+
   std::shared_ptr<ProcessGroup::Work> broadcast(
       std::vector<at::Tensor>& tensors,
       const BroadcastOptions& opts = BroadcastOptions()) override;
@@ -253,6 +305,10 @@ class ProcessGroupNCCL : public ProcessGroup {
       const AllreduceCoalescedOptions& opts =
           AllreduceCoalescedOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> broadcast_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) override;
@@ -329,6 +385,14 @@ class ProcessGroupNCCL : public ProcessGroup {
       const std::string& devicesKey,
       const std::vector<at::Device>& devices);
 
+  // Creates the NCCL streams and events for `ncclComms` and adds them to the
+  // cache under `devicesKey`.
+  std::vector<std::shared_ptr<NCCLComm>>& registerNCCLComm(
+      const std::string& devicesKey,
+      const std::vector<at::Device>& devices,
+      std::vector<std::shared_ptr<NCCLComm>> ncclComms,
+      const ncclUniqueId& ncclID);
+
   // Wrapper method which can be overridden for tests.
   virtual std::exception_ptr checkForNCCLErrors(
       const std::vector<std::shared_ptr<NCCLComm>>& ncclComms);
@@ -336,6 +400,19 @@ class ProcessGroupNCCL : public ProcessGroup {
   virtual std::shared_ptr<ProcessGroupNCCL::WorkNCCL> initWork(
       std::vector<at::Device> devices);
 
+  // Communicators of the node-local and cross-node groups of this rank, used
+  // by the hierarchical allreduce.
+  struct HierarchicalNCCLComms {
+    std::shared_ptr<NCCLComm> intraNode;
+    std::shared_ptr<NCCLComm> interNode;
+  };
+
+  // Like getNCCLComm, but for the communicators of the hierarchical
+  // allreduce. Only supports a single device per process.
+  HierarchicalNCCLComms& getHierarchicalNCCLComms(
+      const std::string& devicesKey,
+      const at::Device& device);
+
  private:
   // Helper that encapsulates work shared across all collective communication
   // primitives.  The callbacks have the following signatures:
@@ -356,6 +433,33 @@ class ProcessGroupNCCL : public ProcessGroup {
       PreProcess pre,
       PostProcess post);
 
+  // Like collective, but for the coalesced collectives, whose inputs are
+  // separate payloads on a single device. All calls to `fn' are issued in
+  // one NCCL group and complete as a single Work. `post' has the signature
+  //
+  //    void post(at::cuda::CUDAStream&);
+  template <typename Fn, typename PostProcess>
+  std::shared_ptr<ProcessGroup::Work> collectiveCoalesced(
+      std::vector<at::Tensor>& inputs,
+      std::vector<at::Tensor>& outputs,
+      Fn fn,
+      PostProcess post);
+
+  // Fills in `work` after its collective was enqueued on `ncclStreams`.
+  void recordWork(
+      WorkNCCL& work,
+      const std::vector<at::Device>& devices,
+      const std::vector<std::shared_ptr<NCCLComm>>& ncclComms,
+      std::vector<at::cuda::CUDAStream>& ncclStreams,
+      const std::vector<at::Tensor>& outputs);
+
+  // Returns whether allreduce of `tensors` should run hierarchically.
+  bool useHierarchicalAllreduce(const std::vector<at::Tensor>& tensors) const;
+
+  std::shared_ptr<ProcessGroup::Work> allreduceHierarchical(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts);
+
   // Checks for NCCL errors on each of the communicators and returns an
   // appropriate exception_ptr (nullptr if no errors).
   static std::exception_ptr checkForNCCLErrorsInternal(
@@ -467,6 +571,42 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Timeout for operations. This is only used when blockingWait_ is enabled.
   std::chrono::milliseconds opTimeout_;
 
+  // See Options::hierarchicalAllreduceLocalSize and
+  // Options::hierarchicalAllreduceMinBytes.
+  int hierarchicalAllreduceLocalSize_;
+  int64_t hierarchicalAllreduceMinBytes_;
+
+  // The communicators of the hierarchical allreduce, keyed by device like
+  // devNCCLCommMap_. They are also added to devNCCLCommMap_ (under derived
+  // keys) so that the watchdog checks them for errors.
+  std::unordered_map<std::string, HierarchicalNCCLComms>
+      hierarchicalNCCLCommMap_;
+
+  // Hands out the CUDA events of the works. Events are created once per
+  // device and reused after the work holding them is destroyed, instead of
+  // creating and destroying events for every collective. The pool is shared
+  // with the works, which may outlive the process group.
+  class CUDAEventPool : public std::enable_shared_from_this<CUDAEventPool> {
+   public:
+    std::shared_ptr<at::cuda::CUDAEvent> get(at::DeviceIndex device);
+
+   private:
+    std::mutex mutex_;
+    std::unordered_map<
+        at::DeviceIndex,
+        std::vector<std::unique_ptr<at::cuda::CUDAEvent>>>
+        events_;
+  };
+
+  std::shared_ptr<CUDAEventPool> eventPool_;
+
+  // See Options::lightweightWork.
+  bool lightweightWork_;
+
+  // The number of groups split from this process group, used to derive the
+  // IDs of their communicators.
+  uint64_t splitCounter_{0};
+
   // Set of communicators that this process group has aborted and their
   // ncclUniqueId has been written to the store. We don't need a lock
   // for this map since only the watchdog thread accesses this set. The
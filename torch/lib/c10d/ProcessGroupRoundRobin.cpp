@@ -35,6 +35,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::allreduce_coalesced(
   return next()->allreduce_coalesced(tensors, opts);
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::broadcast_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  return next()->broadcast_coalesced(tensors, opts);
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupRoundRobin::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
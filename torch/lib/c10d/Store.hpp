@@ -38,6 +38,24 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Batched versions of get and set. Stores that can do them in one request
+  // override them, the defaults get and set the keys one by one. multiGet
+  // waits for all the keys to be set, like get.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Atomically sets key to desiredValue if its current value is
+  // expectedValue, or if it isn't set and expectedValue is empty. Returns the
+  // value of key after the operation, or expectedValue if key isn't set.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -1,6 +1,9 @@
 #include <c10d/TCPStore.hpp>
 
 #include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
@@ -10,7 +13,16 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_GET,
+  MULTI_SET,
+  COMPARE_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
@@ -54,6 +66,81 @@ void TCPStoreDaemon::join() {
   daemonThread_.join();
 }
 
+#ifdef __linux__
+
+// The daemon waits on the sockets with epoll, which only returns the sockets
+// that have events, so that a round doesn't cost time linear in the number
+// of connected workers, as it does with poll. This matters at init time,
+// when thousands of ranks connect and wait on their keys at once.
+void TCPStoreDaemon::run() {
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  ResourceGuard epollGuard([epollFd]() { ::close(epollFd); });
+  auto addFd = [epollFd](int fd, uint32_t events) {
+    struct ::epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+  };
+  addFd(storeListenSocket_, EPOLLIN);
+  // The read end of the pipe gets EPOLLHUP when the daemon is stopped
+  addFd(controlPipeFd_[0], EPOLLIN);
+
+  constexpr int kMaxEvents = 64;
+  struct ::epoll_event events[kMaxEvents];
+  while (true) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events, kMaxEvents, -1));
+
+    for (int i = 0; i < numEvents; ++i) {
+      const int fd = events[i].data.fd;
+      const uint32_t revents = events[i].events;
+
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        if (revents ^ EPOLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.push_back(sockFd);
+        addFd(sockFd, EPOLLIN);
+        continue;
+      }
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (fd == controlPipeFd_[0]) {
+        if (!(revents & EPOLLHUP)) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the control pipe's reading fd: " +
+                  std::to_string(revents));
+        }
+        return;
+      }
+
+      // Now query the socket that has the event
+      try {
+        query(fd);
+      } catch (...) {
+        // An exception in recv/send most likely means that the socket on the
+        // other side has been closed. The store keeps running, and if the
+        // worker didn't exit normally, the other workers get an exception
+        // once they try to use the store.
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        closeSocket(fd);
+      }
+    }
+  }
+}
+
+#else
+
 void TCPStoreDaemon::run() {
   std::vector<struct pollfd> fds;
   fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
@@ -115,32 +202,8 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
+        closeSocket(fds[fdIdx].fd);
         fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
         --fdIdx;
         continue;
       }
@@ -148,6 +211,31 @@ void TCPStoreDaemon::run() {
   }
 }
 
+#endif // __linux__
+
+void TCPStoreDaemon::closeSocket(int socket) {
+  ::close(socket);
+
+  // Remove all the tracking state of the close FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
+      if (*vecIt == socket) {
+        vecIt = it->second.erase(vecIt);
+      } else {
+        ++vecIt;
+      }
+    }
+    if (it->second.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+  sockets_.erase(
+      std::remove(sockets_.begin(), sockets_.end(), socket), sockets_.end());
+}
+
 void TCPStoreDaemon::stop() {
   if (controlPipeFd_[1] != -1) {
     // close the write end of the pipe
@@ -180,6 +268,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -261,6 +358,54 @@ void TCPStoreDaemon::waitHandler(int socket) {
   }
 }
 
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  for (size_t i = 0; i < nargs; i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (nargs - 1)));
+  }
+}
+
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
+void TCPStoreDaemon::compareSetHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  std::vector<uint8_t> expectedValue = tcputil::recvVector<uint8_t>(socket);
+  std::vector<uint8_t> desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  auto pos = tcpStore_.find(key);
+  if (pos == tcpStore_.end()) {
+    if (!expectedValue.empty()) {
+      tcputil::sendVector<uint8_t>(socket, expectedValue);
+      return;
+    }
+    tcpStore_[key] = desiredValue;
+    tcputil::sendVector<uint8_t>(socket, desiredValue);
+    wakeupWaitingClients(key);
+    return;
+  }
+  if (pos->second == expectedValue) {
+    pos->second = std::move(desiredValue);
+    tcputil::sendVector<uint8_t>(socket, pos->second);
+    wakeupWaitingClients(key);
+    return;
+  }
+  tcputil::sendVector<uint8_t>(socket, pos->second);
+}
+
 bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
   return std::all_of(keys.begin(), keys.end(), [this](const std::string& s) {
     return tcpStore_.count(s) > 0;
@@ -281,6 +426,7 @@ TCPStore::TCPStore(
       tcpStorePort_(masterPort),
       numWorkers_(numWorkers),
       initKey_("init/"),
+      initDoneKey_("init/done"),
       regularPrefix_("/") {
   if (isServer_) {
     // Opening up the listening socket
@@ -309,27 +455,14 @@ TCPStore::~TCPStore() {
 }
 
 void TCPStore::waitForWorkers() {
-  addHelper_(initKey_, 1);
-  // Let server block until all workers have completed, this ensures that
-  // the server daemon thread is always running until the very end
+  // The last worker to join wakes up the server, which blocks until all
+  // workers have completed, this ensures that the server daemon thread is
+  // always running until the very end
+  if (addHelper_(initKey_, 1) >= numWorkers_) {
+    addHelper_(initDoneKey_, 1);
+  }
   if (isServer_) {
-    const auto start = std::chrono::steady_clock::now();
-    while (true) {
-      std::vector<uint8_t> value = getHelper_(initKey_);
-      auto buf = reinterpret_cast<const char*>(value.data());
-      auto len = value.size();
-      int numWorkersCompleted = std::stoi(std::string(buf, len));
-      if (numWorkersCompleted >= numWorkers_) {
-        break;
-      }
-      const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-          std::chrono::steady_clock::now() - start);
-      if (timeout_ != kNoTimeout && elapsed > timeout_) {
-        break;
-      }
-      /* sleep override */
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    waitHelper_({initDoneKey_}, timeout_);
   }
 }
 
@@ -423,6 +556,58 @@ void TCPStore::waitHelper_(
   }
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  waitHelper_(regKeys, timeout_);
+
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET, true);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values[i] = tcputil::recvVector<uint8_t>(storeSocket_);
+  }
+  return values;
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, but got " +
+        std::to_string(keys.size()) + " keys and " +
+        std::to_string(values.size()) + " values");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET, true);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regularPrefix_ + keys[i], true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET, true);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 PortType TCPStore::getPort() {
   return tcpStorePort_;
 }
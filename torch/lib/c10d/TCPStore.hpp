@@ -21,12 +21,17 @@ class TCPStoreDaemon {
   void stop();
 
   void query(int socket);
+  // Closes a client socket and drops the keys it waits on
+  void closeSocket(int socket);
 
   void setHandler(int socket);
   void addHandler(int socket);
   void getHandler(int socket) const;
   void checkHandler(int socket) const;
   void waitHandler(int socket);
+  void multiGetHandler(int socket) const;
+  void multiSetHandler(int socket);
+  void compareSetHandler(int socket);
 
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
@@ -69,6 +74,18 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
   // Waits for all workers to join.
   void waitForWorkers();
 
@@ -91,6 +108,9 @@ class TCPStore : public Store {
 
   int numWorkers_;
   const std::string initKey_;
+  // Set by the last worker to join, so that the server waits for it instead
+  // of polling the number of workers
+  const std::string initDoneKey_;
   const std::string regularPrefix_;
 
   // Only needs to be launched as the server
@@ -116,3 +116,28 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testBatchedOps) {
+  auto store = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", 0, 1, true, std::chrono::seconds(30));
+  c10d::PrefixStore prefixStore("testPrefix", store);
+
+  auto toVec = [](const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+  };
+  prefixStore.multiSet({"key0", "key1"}, {toVec("value0"), toVec("value1")});
+  c10d::test::set(prefixStore, "key2", "value2");
+  auto values = prefixStore.multiGet({"key0", "key1", "key2"});
+  ASSERT_EQ(3, values.size());
+  EXPECT_EQ(toVec("value0"), values[0]);
+  EXPECT_EQ(toVec("value1"), values[1]);
+  EXPECT_EQ(toVec("value2"), values[2]);
+
+  EXPECT_EQ(toVec("a"), prefixStore.compareSet("cas", {}, toVec("a")));
+  EXPECT_EQ(toVec("a"), prefixStore.compareSet("cas", toVec("b"), toVec("c")));
+  EXPECT_EQ(toVec("c"), prefixStore.compareSet("cas", toVec("a"), toVec("c")));
+  c10d::test::check(prefixStore, "cas", "c");
+  EXPECT_EQ(
+      toVec("x"), prefixStore.compareSet("missing", toVec("x"), toVec("y")));
+  EXPECT_FALSE(prefixStore.check({"missing"}));
+}
@@ -4119,6 +4119,16 @@ def multi_head_attention_forward(query,                           # type: Tensor
         if key_padding_mask is not None:
             key_padding_mask = pad(key_padding_mask, (0, 1))
 
+    if not need_weights and attn_mask is None and (dropout_p == 0.0 or not training) and \
+            (key_padding_mask is None or key_padding_mask.dtype == torch.bool):
+        # The fused kernel doesn't materialize the attention weights, so that
+        # memory grows linearly with the sequence lengths
+        attn_output = torch._fused_attention(q, k, v, key_padding_mask)
+        assert list(attn_output.size()) == [bsz * num_heads, tgt_len, head_dim]
+        attn_output = attn_output.transpose(0, 1).contiguous().view(tgt_len, bsz, embed_dim)
+        attn_output = linear(attn_output, out_proj_weight, out_proj_bias)
+        return attn_output, None
+
     attn_output_weights = torch.bmm(q, k.transpose(1, 2))
     assert list(attn_output_weights.size()) == [bsz * num_heads, tgt_len, src_len]
 
@@ -104,6 +104,13 @@ class RNNBase(Module):
             # keep self._flat_weights up to date if you do self.weight = ...
             idx = self._flat_weights_names.index(attr)
             self._flat_weights[idx] = value
+            super(RNNBase, self).__setattr__(attr, value)
+            # and compact again, so that cuDNN doesn't copy the weights at
+            # every call. Data parallel replicas assign plain tensors, whose
+            # storage must not change.
+            if isinstance(value, Parameter):
+                self.flatten_parameters()
+            return
         super(RNNBase, self).__setattr__(attr, value)
 
     def flatten_parameters(self) -> None:
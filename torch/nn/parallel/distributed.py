@@ -314,6 +314,14 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view (bool): When set to ``True``, gradients are
+                                        views into the flat buckets that are allreduced,
+                                        so they are accumulated in place (also with
+                                        ``create_graph=True``) and reduced without being
+                                        copied into and out of the buckets. ``param.grad``
+                                        becomes a view after the first backward pass.
+                                        Replacing it with another tensor costs one extra
+                                        copy in the next backward pass. (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -328,7 +336,8 @@ class DistributedDataParallel(Module):
                  process_group=None,
                  bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -375,6 +384,7 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.gradient_as_bucket_view = gradient_as_bucket_view
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
 
@@ -509,7 +519,8 @@ class DistributedDataParallel(Module):
             self.process_group,
             expect_sparse_gradient,
             self.bucket_bytes_cap,
-            self.find_unused_parameters)
+            self.find_unused_parameters,
+            self.gradient_as_bucket_view)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -527,6 +538,7 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('gradient_as_bucket_view', False)
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -699,6 +711,62 @@ class DistributedDataParallel(Module):
         self._check_comm_hook(hook)
         dist._register_comm_hook(self.reducer, state, hook)
 
+    def _register_builtin_comm_hook(self, comm_hook_type, power_sgd_options=None):
+        r"""
+        Register one of the communication hooks that are implemented in C++.
+        They behave like hooks registered with ``_register_comm_hook``, but
+        run without entering Python for every bucket.
+
+        Arguments:
+            comm_hook_type (dist.BuiltinCommHookType): ``ALLREDUCE`` averages
+                gradients like DDP does without a hook. ``FP16_COMPRESS``
+                casts buckets to half precision for the allreduce, halving the
+                bytes sent. ``POWER_SGD`` sends a low-rank approximation of
+                each bucket, with error feedback.
+            power_sgd_options (dist.PowerSGDOptions, optional): configures
+                ``POWER_SGD`` (``matrix_approximation_rank``,
+                ``start_powerSGD_iter``, ``use_error_feedback`` and
+                ``random_seed``). Ignored by the other hooks.
+
+        .. warning ::
+            DDP communication hook can only be registered once and should be
+            registered before calling backward.
+
+        .. warning ::
+            DDP communication hook is experimental and subject to change.
+
+        Example::
+            >>> options = dist.PowerSGDOptions()
+            >>> options.matrix_approximation_rank = 4
+            >>> ddp._register_builtin_comm_hook(dist.BuiltinCommHookType.POWER_SGD, options)
+        """
+        if power_sgd_options is None:
+            power_sgd_options = dist.PowerSGDOptions()
+        dist._register_builtin_comm_hook(
+            self.reducer, self.process_group, comm_hook_type, power_sgd_options)
+
+    def _enable_adaptive_bucketing(self, rebuild_interval=100):
+        r"""
+        Re-plan gradient buckets while training, for modules constructed with
+        ``find_unused_parameters=True``. DDP learns the order in which
+        gradients become ready across iterations, and every
+        ``rebuild_interval`` iterations it reassigns parameters to buckets in
+        that order. This way the reduction of early buckets is not held up by
+        gradients that are computed late, which keeps communication
+        overlapping the backward pass in models with conditional branches.
+
+        The new assignment is broadcast from rank 0 without blocking and takes
+        effect at the start of a later iteration.
+
+        Arguments:
+            rebuild_interval (int): number of iterations between re-plans.
+                Must be the same on all processes.
+
+        .. warning ::
+            Adaptive bucketing is experimental and subject to change.
+        """
+        self.reducer._enable_adaptive_bucketing(rebuild_interval)
+
     def _distributed_broadcast_coalesced(self, tensors, buffer_size):
         dist._broadcast_coalesced(self.process_group, tensors, buffer_size)
 
@@ -527,6 +527,60 @@ def clamp(input, min_, max_):
         raise ValueError("Input to 'quantized.clamp' must be quantized!")
     return torch.clamp(input, min_, max_)
 
+def bmm(input, mat2, scale, zero_point):
+    # type: (Tensor, Tensor, float, int) -> Tensor
+    r"""This is the quantized version of :func:`~torch.bmm`.
+
+    Args:
+        input: quantized batch of matrices of shape :math:`(B, M, K)`
+        mat2: quantized batch of matrices of shape :math:`(B, K, N)`
+        scale: quantization scale of the output tensor
+        zero_point: quantization zero point of the output tensor
+    """
+    if not input.is_quantized or not mat2.is_quantized:
+        raise ValueError("Inputs to 'quantized.bmm' must be quantized!")
+    return torch.ops.quantized.bmm(input, mat2, scale, zero_point)
+
+def softmax(input, dim, scale=1. / 256, zero_point=0):
+    # type: (Tensor, int, float, int) -> Tensor
+    r"""This is the quantized version of :func:`~torch.nn.functional.softmax`.
+
+    Args:
+        input: quantized input
+        dim: dimension along which softmax is computed
+        scale: quantization scale of the output tensor. The default covers
+            the output range :math:`[0, 1)` for ``torch.quint8`` outputs.
+        zero_point: quantization zero point of the output tensor
+    """
+    if not input.is_quantized:
+        raise ValueError("Input to 'quantized.softmax' must be quantized!")
+    return torch.ops.quantized.softmax(input, dim, scale, zero_point)
+
+def scaled_dot_product_attention(q, k, v, attn_mask, scaling, scale, zero_point):
+    # type: (Tensor, Tensor, Tensor, Optional[Tensor], float, float, int) -> Tensor
+    r"""Computes ``softmax(scaling * q @ k.transpose(1, 2) + attn_mask) @ v`` on
+    quantized tensors in one fused kernel, without materializing the attention
+    weights. This is the core of
+    :func:`~torch.nn.functional.multi_head_attention_forward` once the
+    projections are done with :func:`~torch.nn.quantized.functional.linear`.
+
+    Args:
+        q: quantized queries of shape :math:`(B, L, E)`
+        k: quantized keys of shape :math:`(B, S, E)`
+        v: quantized values of shape :math:`(B, S, E_v)`
+        attn_mask: optional mask of shape :math:`(L, S)` or :math:`(B, L, S)`.
+            Boolean masks are ``True`` where attention is not allowed, float
+            masks are added to the scores.
+        scaling: factor the scores are multiplied with, usually
+            :math:`E^{-1/2}`
+        scale: quantization scale of the output tensor
+        zero_point: quantization zero point of the output tensor
+    """
+    if not (q.is_quantized and k.is_quantized and v.is_quantized):
+        raise ValueError("Inputs to 'quantized.scaled_dot_product_attention' must be quantized!")
+    return torch.ops.quantized.scaled_dot_product_attention(
+        q, k, v, attn_mask, scaling, scale, zero_point)
+
 def upsample(input, size=None, scale_factor=None, mode='nearest', align_corners=None):
     r"""Upsamples the input to either the given :attr:`size` or the given
     :attr:`scale_factor`
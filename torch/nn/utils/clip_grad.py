@@ -21,20 +21,29 @@ def clip_grad_norm_(parameters, max_norm, norm_type=2):
     """
     if isinstance(parameters, torch.Tensor):
         parameters = [parameters]
-    parameters = list(filter(lambda p: p.grad is not None, parameters))
+    grads = [p.grad.detach() for p in parameters if p.grad is not None]
     max_norm = float(max_norm)
     norm_type = float(norm_type)
-    if len(parameters) == 0:
+    if len(grads) == 0:
         return torch.tensor(0.)
-    device = parameters[0].grad.device
+    device = grads[0].device
+    # The norms and the clipping coefficient stay on the device, so the grads
+    # are scaled without synchronizing on the total norm.
+    same_device = all(g.device == device for g in grads)
+    if same_device:
+        norms = torch._foreach_norm(grads, norm_type)
+    else:
+        norms = [torch.norm(g, norm_type).to(device) for g in grads]
     if norm_type == inf:
-        total_norm = max(p.grad.detach().abs().max().to(device) for p in parameters)
+        total_norm = torch.stack(norms).max()
+    else:
+        total_norm = torch.norm(torch.stack(norms), norm_type)
+    clip_coef = torch.clamp(max_norm / (total_norm + 1e-6), max=1.0)
+    if same_device:
+        torch._foreach_mul_(grads, clip_coef)
     else:
-        total_norm = torch.norm(torch.stack([torch.norm(p.grad.detach(), norm_type).to(device) for p in parameters]), norm_type)
-    clip_coef = max_norm / (total_norm + 1e-6)
-    if clip_coef < 1:
-        for p in parameters:
-            p.grad.detach().mul_(clip_coef.to(p.grad.device))
+        for g in grads:
+            g.mul_(clip_coef.to(g.device))
     return total_norm
 
 
@@ -237,6 +237,13 @@ def pack_padded_sequence(input, lengths, batch_first=False, enforce_sorted=True)
     else:
         lengths, sorted_indices = torch.sort(lengths, descending=True)
         sorted_indices = sorted_indices.to(input.device)
+        if not torch._C._get_tracing_state():
+            # Gathers the sequences straight into the packed data, without
+            # sorting the padded batch first. Traces keep the ops that have
+            # ONNX symbolics.
+            data, batch_sizes = \
+                _VF._pack_padded_sequence_unsorted(input, lengths, sorted_indices, batch_first)
+            return _packed_sequence_init(data, batch_sizes, sorted_indices, None)
         batch_dim = 0 if batch_first else 1
         input = input.index_select(batch_dim, sorted_indices)
 
@@ -306,6 +313,11 @@ def pad_packed_sequence(sequence, batch_first=False, padding_value=0.0, total_le
                              "total_length={} and max sequence length being {}"
                              .format(total_length, max_seq_length))
         max_seq_length = total_length
+    if sequence.sorted_indices is not None and not torch._C._get_tracing_state():
+        # Puts the sequences back in their original order while padding
+        return _VF._pad_packed_sequence_unsorted(
+            sequence.data, sequence.batch_sizes, sequence.sorted_indices, batch_first,
+            padding_value, max_seq_length)
     padded_output, lengths = _VF._pad_packed_sequence(
         sequence.data, sequence.batch_sizes, batch_first, padding_value, max_seq_length)
     unsorted_indices = sequence.unsorted_indices
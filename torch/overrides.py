@@ -101,6 +101,8 @@ def get_ignored_functions() -> Set[Callable]:
         torch.cudnn_affine_grid_generator,
         torch.cudnn_batch_norm,
         torch.cudnn_convolution,
+        torch.cudnn_convolution_relu,
+        torch.cudnn_convolution_add_relu,
         torch.cudnn_convolution_transpose,
         torch.cudnn_grid_sampler,
         torch.cudnn_is_acceptable,
@@ -131,6 +133,7 @@ def get_ignored_functions() -> Set[Callable]:
         torch.result_type,
         torch.scalar_tensor,
         torch.sparse_coo_tensor,
+        torch.sparse_csr_tensor,
         torch.tril_indices,
         torch.triu_indices,
         torch.vander,
@@ -148,6 +151,10 @@ def get_ignored_functions() -> Set[Callable]:
         torch.nn.functional.tanh,
         torch.set_autocast_enabled,
         torch.is_autocast_enabled,
+        torch.set_autocast_cpu_enabled,
+        torch.is_autocast_cpu_enabled,
+        torch.set_autocast_cache_persistent,
+        torch.is_autocast_cache_persistent,
         torch.clear_autocast_cache,
         torch.autocast_increment_nesting,
         torch.autocast_decrement_nesting,
@@ -328,7 +335,9 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.exp: lambda input, out=None: -1,
         torch.expm1: lambda input, out=None: -1,
         torch.fake_quantize_per_channel_affine: lambda input, scale, zero_point, axis, quant_min, quant_max: -1,
+        torch.fake_quantize_per_channel_affine_cachemask: lambda input, scale, zero_point, axis, quant_min, quant_max: -1,
         torch.fake_quantize_per_tensor_affine: lambda input, scale, zero_point, quant_min, quant_max: -1,
+        torch.fake_quantize_per_tensor_affine_cachemask: lambda input, scale, zero_point, quant_min, quant_max: -1,
         torch.fbgemm_linear_fp16_weight: lambda input, packed_weight, bias: -1,
         torch.fbgemm_linear_fp16_weight_fp32_activation: lambda input, packed_weight, bias: -1,
         torch.fbgemm_linear_int8_weight: lambda input, weight, packed, col_offsets, weight_scale, weight_zero_point, bias: -1,
@@ -767,6 +776,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.is_mkldnn.__get__: lambda self: -1,
         Tensor.is_quantized.__get__: lambda self: -1,
         Tensor.is_sparse.__get__: lambda self: -1,
+        Tensor.is_sparse_csr.__get__: lambda self: -1,
         Tensor.layout.__get__: lambda self: -1,
         Tensor.name.__get__: lambda self: -1,
         Tensor.names.__get__: lambda self: -1,
@@ -778,6 +788,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.real.__get__: lambda self: -1,
         Tensor.imag.__get__: lambda self: -1,
         Tensor.__cuda_array_interface__.__get__: lambda self: -1,
+        Tensor.__dlpack__: lambda self, stream=None: -1,
+        Tensor.__dlpack_device__: lambda self: -1,
         Tensor.type: lambda self, dtype=None, non_blocking=False, **kwargs: -1,
         Tensor._coalesced_: lambda self: -1,
         Tensor._dimI: lambda self: -1,
@@ -799,10 +811,12 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.char: lambda self, memory_format=torch.preserve_format: -1,
         Tensor.cauchy_: lambda self, median=0, sigma=1, *, generator=None: -1,
         Tensor.coalesce: lambda self: -1,
+        Tensor.col_indices: lambda self: -1,
         Tensor._coalesced_: lambda self, coalesced: -1,
         Tensor.contiguous: lambda self, memory_format=torch.contiguous_format: -1,
         Tensor.copy_: lambda self, src, non_blocking=False: -1,
         Tensor.cpu: lambda self, memory_format=torch.preserve_format: -1,
+        Tensor.crow_indices: lambda self: -1,
         Tensor.cuda: lambda self, memory_format=torch.preserve_format: -1,
         Tensor.data_ptr: lambda self: -1,
         Tensor.dense_dim: lambda self: -1,
@@ -852,6 +866,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.reshape_as: lambda self, other: -1,
         Tensor.resize: lambda self, *size: -1,
         Tensor.resize_: lambda self, size: -1,
+        Tensor.resize_amortized_: lambda self, size: -1,
+        Tensor.reserve_: lambda self, capacity: -1,
         Tensor.resize_as: lambda self, other: -1,
         Tensor.retain_grad: lambda self: -1,
         Tensor.set_: lambda self, source=None, storage_offset=0, size=None, stride=None: -1,
@@ -870,6 +886,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.to: lambda self, dtype, non_blocking=False, copy=False, memory_format=torch.preserve_format: -1,
         Tensor.to_dense: lambda self: -1,
         Tensor.to_sparse: lambda self: -1,
+        Tensor.to_sparse_csr: lambda self: -1,
         Tensor.tolist: lambda self: -1,
         Tensor.to_mkldnn: lambda self: -1,
         Tensor.type_as: lambda self, other: -1,
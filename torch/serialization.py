@@ -9,7 +9,7 @@ import tarfile
 import tempfile
 import warnings
 from contextlib import closing, contextmanager
-from ._utils import _import_dotted_name
+from ._utils import _import_dotted_name, _rebuild_tensor
 from ._six import string_classes as _string_classes
 from torch._utils_internal import get_source_lines_and_file
 from torch.types import Storage
@@ -447,7 +447,7 @@ def _legacy_save(obj, f, pickle_module, pickle_protocol) -> None:
         serialized_storages[key]._write_file(f, _should_read_directly(f), True)
 
 
-def _save(obj, zip_file, pickle_module, pickle_protocol):
+def _pickle_with_storages(obj, pickle_module, pickle_protocol):
     serialized_storages = {}
 
     def persistent_id(obj):
@@ -474,7 +474,11 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
     pickler = pickle_module.Pickler(data_buf, protocol=pickle_protocol)
     pickler.persistent_id = persistent_id
     pickler.dump(obj)
-    data_value = data_buf.getvalue()
+    return data_buf.getvalue(), serialized_storages
+
+
+def _save(obj, zip_file, pickle_module, pickle_protocol):
+    data_value, serialized_storages = _pickle_with_storages(obj, pickle_module, pickle_protocol)
     zip_file.write_record('data.pkl', data_value, len(data_value))
 
     # Write each tensor to a file named tensor/the_tensor_key in the zip archive
@@ -493,6 +497,111 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
             zip_file.write_record(name, buf_value, len(buf_value))
 
 
+def _snapshot_storages(serialized_storages):
+    """
+    Copies every storage into a host tensor. CPU storages are cloned right
+    away. CUDA storages are copied into pinned memory with non_blocking copies
+    on a side stream of their device, which first waits for the work already
+    queued on the current stream. Returns the copies and one event per device
+    that is recorded after the copies were queued.
+    """
+    snapshots = {}
+    events = []
+    side_streams = {}
+    for key, storage in serialized_storages.items():
+        src = _rebuild_tensor(storage, 0, (storage.size(),), (1,))
+        if storage.device.type == 'cpu':
+            snapshots[key] = src.clone()
+            continue
+        if storage.device.type != 'cuda':
+            # No async copy for other devices, fall back to a blocking one
+            snapshots[key] = src.cpu()
+            continue
+        stream = side_streams.get(storage.device)
+        if stream is None:
+            stream = torch.cuda.Stream(storage.device)
+            stream.wait_stream(torch.cuda.current_stream(storage.device))
+            side_streams[storage.device] = stream
+        snapshot = torch.empty(src.size(), dtype=src.dtype, pin_memory=True)
+        with torch.cuda.stream(stream):
+            snapshot.copy_(src, non_blocking=True)
+        # Keeps the caching allocator from reusing the memory of `src`
+        # before the copy is done, should the storage be freed meanwhile.
+        src.record_stream(stream)
+        snapshots[key] = snapshot
+    for stream in side_streams.values():
+        events.append(stream.record_event())
+    return snapshots, events
+
+
+def save_async(obj, f: Union[str, os.PathLike, BinaryIO],
+               pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL) -> 'torch.futures.Future':
+    """Saves an object to a disk file without waiting for the write.
+
+    Like :func:`torch.save`, but only pickles ``obj`` and takes a snapshot of
+    its storages before returning. The snapshot of CUDA storages is copied
+    into pinned host memory on a side stream, so the call returns without
+    synchronizing the device. Writing the archive happens on a background
+    thread, and the returned future completes (with ``None``) once ``f`` has
+    been written. Tensors in ``obj`` may be modified right after the call,
+    the saved values are those they had when the work queued on the current
+    streams finishes.
+
+    Only the zipfile-based format of :func:`torch.save` is written.
+
+    Args:
+        obj: saved object
+        f: a file-like object (has to implement write and flush) or a string or
+           os.PathLike object containing a file name. A file-like object is
+           written from the background thread, and must not be used until
+           the returned future completes.
+        pickle_module: module used for pickling metadata and objects
+        pickle_protocol: can be specified to override the default protocol
+
+    Returns:
+        A :class:`torch.futures.Future` that completes once the file has been
+        written. Waiting on it raises if writing failed.
+
+    Example:
+        >>> fut = torch.save_async(model.state_dict(), 'checkpoint.pt')
+        >>> # training continues while the checkpoint is written
+        >>> fut.wait()
+    """
+    import threading
+    import torch.futures
+
+    _check_dill_version(pickle_module)
+    data_value, serialized_storages = _pickle_with_storages(obj, pickle_module, pickle_protocol)
+    snapshots, events = _snapshot_storages(serialized_storages)
+
+    written = torch.futures.Future()
+
+    def write():
+        try:
+            for event in events:
+                event.synchronize()
+            with _open_file_like(f, 'wb') as opened_file:
+                with _open_zipfile_writer(opened_file) as zip_file:
+                    zip_file.write_record('data.pkl', data_value, len(data_value))
+                    for key in sorted(snapshots.keys()):
+                        snapshot = snapshots[key]
+                        num_bytes = snapshot.numel() * snapshot.element_size()
+                        zip_file.write_record('data/{}'.format(key), snapshot.data_ptr(), num_bytes)
+        except Exception as e:
+            written.set_result(e)
+        else:
+            written.set_result(None)
+
+    def check_error(fut):
+        error = fut.wait()
+        if error is not None:
+            raise error
+
+    result = written.then(check_error)
+    threading.Thread(target=write, daemon=True).start()
+    return result
+
+
 def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
     """Loads an object saved with :func:`torch.save` from a file.
 
@@ -17,6 +17,8 @@ else:
 __all__ = [
     'addmm',
     'mm',
+    'block_sparse_mm',
+    'block_sparse_masked_mm',
     'sum',
     'softmax',
     'log_softmax',
@@ -83,6 +85,73 @@ def mm(mat1, mat2):
     return torch._sparse_mm(mat1, mat2)
 
 
+def block_sparse_mm(values: Tensor, block_indices: Tensor, rows: int, dense: Tensor) -> Tensor:
+    r"""
+    Performs a matrix multiplication of a block-sparse matrix and the dense
+    matrix :attr:`dense`. The block-sparse matrix has :attr:`rows` rows and as
+    many columns as :attr:`dense` has rows, and is made of :math:`B_m \times B_k`
+    blocks, of which only those at the block rows and block columns given by
+    :attr:`block_indices` are specified; the others are zero, and repeated
+    blocks add up. If :attr:`dense` is a :math:`(*, k \times p)` tensor, out
+    will be a :math:`(*, rows \times p)` dense tensor.
+
+    All the blocks are multiplied at once with a batched matrix product, which
+    uses tensor cores for half precision inputs on CUDA. This function supports
+    backward for both :attr:`values` and :attr:`dense`.
+
+    Args:
+        values (Tensor): the :math:`(*, nblocks, B_m, B_k)` specified blocks
+        block_indices (LongTensor): the :math:`(2, nblocks)` block row and block
+            column of each of the blocks
+        rows (int): the number of rows of the block-sparse matrix, a multiple
+            of :math:`B_m`
+        dense (Tensor): the dense matrix to be multiplied, with a multiple of
+            :math:`B_k` rows
+
+    Example::
+
+        >>> values = torch.randn(2, 2, 2)
+        >>> block_indices = torch.tensor([[0, 1], [1, 0]])
+        >>> dense = torch.randn(4, 3)
+        >>> torch.sparse.block_sparse_mm(values, block_indices, 4, dense).shape
+        torch.Size([4, 3])
+    """
+    return torch._block_sparse_dense_mm(values, block_indices, rows, dense)
+
+
+def block_sparse_masked_mm(mat1: Tensor, mat2: Tensor, block_indices: Tensor, blocksize: Tuple[int, int]) -> Tensor:
+    r"""
+    Computes the blocks of the matrix product of the dense matrices
+    :attr:`mat1` and :attr:`mat2` at the block rows and block columns given by
+    :attr:`block_indices`, such as the attention scores of a block-sparse
+    attention pattern, without computing the others. If :attr:`mat1` is a
+    :math:`(*, n \times m)` tensor and :attr:`mat2` is a :math:`(*, m \times p)`
+    tensor, out will be the :math:`(*, nblocks, B_n, B_p)` values of a
+    block-sparse :math:`(n \times p)` matrix, as taken by
+    :func:`torch.sparse.block_sparse_mm`.
+
+    This function supports backward for both matrices.
+
+    Args:
+        mat1 (Tensor): the first dense matrix to be multiplied
+        mat2 (Tensor): the second dense matrix to be multiplied
+        block_indices (LongTensor): the :math:`(2, nblocks)` block row and block
+            column of each of the blocks to compute
+        blocksize (tuple of ints): the size :math:`(B_n, B_p)` of the blocks,
+            which divides the size of the product
+
+    Example::
+
+        >>> q = torch.randn(8, 16)
+        >>> k = torch.randn(8, 16)
+        >>> block_indices = torch.tensor([[0, 1, 1], [0, 0, 1]])
+        >>> scores = torch.sparse.block_sparse_masked_mm(q, k.t(), block_indices, (4, 4))
+        >>> scores.shape
+        torch.Size([3, 4, 4])
+    """
+    return torch._block_sparse_masked_mm(mat1, mat2, block_indices, blocksize)
+
+
 def sum(input, dim=None, dtype=None):
     # type: (Tensor, Optional[Tuple[int]], Optional[int]) -> Tensor
     r"""
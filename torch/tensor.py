@@ -714,6 +714,38 @@ class Tensor(torch._C._TensorBase):
 
         return dict(typestr=typestr, shape=shape, strides=strides, data=data, version=2)
 
+    def __dlpack__(self, stream=None):
+        r"""Exports the tensor as a DLPack capsule, see
+        :func:`torch.utils.dlpack.to_dlpack`.
+
+        Args:
+            stream (int, optional): handle of the CUDA stream the consumer will
+                use the tensor on; it is made to wait for the work queued on the
+                current stream. ``None`` skips the handshake.
+        """
+        relevant_args = (self,)
+        from torch.overrides import has_torch_function, handle_torch_function
+        if type(self) is not Tensor and has_torch_function(relevant_args):
+            return handle_torch_function(Tensor.__dlpack__, relevant_args, self, stream=stream)
+        if self.requires_grad:
+            raise RuntimeError(
+                "Can't export tensors that require gradient, use tensor.detach()")
+        from torch.utils.dlpack import to_dlpack
+        return to_dlpack(self, stream=stream)
+
+    def __dlpack_device__(self):
+        r"""Returns the ``(DLDeviceType, device_id)`` pair of the tensor."""
+        relevant_args = (self,)
+        from torch.overrides import has_torch_function, handle_torch_function
+        if type(self) is not Tensor and has_torch_function(relevant_args):
+            return handle_torch_function(Tensor.__dlpack_device__, relevant_args, self)
+        from torch.utils.dlpack import kDLCPU, kDLGPU, kDLROCM
+        if self.is_cuda:
+            return (kDLROCM if torch.version.hip is not None else kDLGPU, self.get_device())
+        if self.device.type == 'cpu':
+            return (kDLCPU, 0)
+        raise RuntimeError("Can't export tensors on {} with DLPack".format(self.device))
+
     def refine_names(self, *names):
         r"""Refines the dimension names of :attr:`self` according to :attr:`names`.
 
@@ -101,6 +101,14 @@ def num_profiled_runs(num_runs):
     finally:
         torch._C._jit_set_num_profiled_runs(old_num_runs)
 
+@contextmanager
+def num_specialized_plans(num_plans):
+    old_num_plans = torch._C._jit_set_num_specialized_plans(num_plans)
+    try:
+        yield
+    finally:
+        torch._C._jit_set_num_specialized_plans(old_num_plans)
+
 func_call = torch._C.ScriptFunction.__call__
 meth_call = torch._C.ScriptMethod.__call__
 
@@ -0,0 +1,109 @@
+#!/usr/bin/python3
+import torch
+import torch.distributed.autograd as dist_autograd
+import torch.distributed.rpc as rpc
+import torch.testing._internal.dist_utils as dist_utils
+from torch import nn
+from torch.distributed.nn import Pipeline, RemoteModule
+from torch.testing._internal.distributed.rpc.rpc_agent_test_fixture import (
+    RpcAgentTestFixture,
+)
+
+
+def _params_and_grads(module_rref):
+    params = list(module_rref.local_value().parameters())
+    return [param.detach().clone() for param in params], [param.grad for param in params]
+
+
+class PipelineTest(RpcAgentTestFixture):
+    @property
+    def world_size(self):  # Override setting in RpcAgentTestFixture
+        return 3
+
+    def _create_stages(self):
+        return [
+            RemoteModule(dist_utils.worker_name(1), nn.Linear, args=(4, 6)),
+            RemoteModule(dist_utils.worker_name(2), nn.Linear, args=(6, 3)),
+        ]
+
+    def _local_copy(self, stages):
+        local_stages = [nn.Linear(4, 6), nn.Linear(6, 3)]
+        for stage, local_stage in zip(stages, local_stages):
+            params, _ = rpc.rpc_sync(
+                stage.module_rref.owner(), _params_and_grads, args=(stage.module_rref,)
+            )
+            with torch.no_grad():
+                for param, local_param in zip(params, local_stage.parameters()):
+                    local_param.copy_(param)
+        return nn.Sequential(*local_stages)
+
+    def _test_train_step(self, schedule):
+        stages = self._create_stages()
+        local = self._local_copy(stages)
+        pipe = Pipeline(stages, chunks=4, schedule=schedule)
+        input = torch.rand(10, 4)
+        target = torch.rand(10, 3)
+        loss_fn = nn.MSELoss(reduction="sum")
+
+        loss = pipe.train_step(input, target, loss_fn)
+        local_loss = loss_fn(local(input), target)
+        local_loss.backward()
+        self.assertEqual(local_loss.detach(), loss)
+        for stage, local_stage in zip(stages, local):
+            _, grads = rpc.rpc_sync(
+                stage.module_rref.owner(), _params_and_grads, args=(stage.module_rref,)
+            )
+            for grad, local_param in zip(grads, local_stage.parameters()):
+                self.assertEqual(local_param.grad, grad)
+
+        pipe.zero_grad()
+        for stage in stages:
+            _, grads = rpc.rpc_sync(
+                stage.module_rref.owner(), _params_and_grads, args=(stage.module_rref,)
+            )
+            for grad in grads:
+                self.assertEqual(torch.zeros_like(grad), grad)
+
+    @dist_utils.dist_init
+    def test_train_step_fill_drain(self):
+        if self.rank != 0:
+            return
+        self._test_train_step("fill_drain")
+
+    @dist_utils.dist_init
+    def test_train_step_1f1b(self):
+        if self.rank != 0:
+            return
+        self._test_train_step("1f1b")
+
+    @dist_utils.dist_init
+    def test_forward_in_context(self):
+        if self.rank != 0:
+            return
+        stages = self._create_stages()
+        local = self._local_copy(stages)
+        pipe = Pipeline(stages, chunks=3)
+        input = torch.rand(7, 4, requires_grad=True)
+        local_input = input.detach().clone().requires_grad_(True)
+
+        with dist_autograd.context() as context_id:
+            output = pipe(input)
+            dist_autograd.backward(context_id, [output.sum()])
+            grads = dist_autograd.get_gradients(context_id)
+            local_output = local(local_input)
+            local_output.sum().backward()
+            self.assertEqual(local_output, output)
+            self.assertEqual(local_input.grad, grads[input])
+            self.assertEqual(len(pipe.parameter_rrefs()), 4)
+
+    @dist_utils.dist_init
+    def test_bad_args(self):
+        if self.rank != 0:
+            return
+        stages = self._create_stages()
+        with self.assertRaisesRegex(ValueError, "at least one stage"):
+            Pipeline([])
+        with self.assertRaisesRegex(ValueError, "at least one micro-batch"):
+            Pipeline(stages, chunks=0)
+        with self.assertRaisesRegex(ValueError, "Expected a schedule"):
+            Pipeline(stages, schedule="interleaved")
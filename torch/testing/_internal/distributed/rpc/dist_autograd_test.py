@@ -1055,6 +1055,22 @@ class DistAutogradTest(RpcAgentTestFixture):
 
         self._test_trainer_ps(create_torchscript_tensor, _run_trainer_torchscript)
 
+    @dist_init
+    def test_backward_coalesced_gradients(self):
+        # On the callee, the sum depends on the 'recv' functions of both the
+        # remote call and the rpc, which send their gradients to this worker
+        # in a single message when they run back to back.
+        callee = worker_name((self.rank + 1) % self.world_size)
+        t1 = torch.rand((3, 3), requires_grad=True)
+        t2 = torch.rand((3, 3), requires_grad=True)
+        with dist_autograd.context() as context_id:
+            rref_t1 = rpc.remote(callee, torch.mul, args=(t1, 2))
+            ret = rpc.rpc_sync(callee, my_rref_add, args=(rref_t1, t2))
+            dist_autograd.backward(context_id, [ret.sum()])
+            grads = dist_autograd.get_gradients(context_id)
+            self.assertEqual(torch.full((3, 3), 2.0), grads[t1])
+            self.assertEqual(torch.ones(3, 3), grads[t2])
+
     @dist_init
     def test_backward_multiple_round_trips(self):
         local_grads = None
@@ -835,6 +835,28 @@ def async_wrong_type() -> Tensor:
     return torch.zeros(2)
 
 
+@torch.jit.script
+def add_batch_size(x: Tensor) -> Tensor:
+    # Adds the size of the batch that x ran in, which shows whether calls to it
+    # were batched.
+    return x + x.size(0)
+
+
+@torch.jit.script
+def add_and_sub(x: Tensor, y: Tensor) -> Tuple[Tensor, Tensor]:
+    return x + y, x - y
+
+
+def enable_batching(fn_name, max_batch_size, max_wait_ms):
+    fn = {"add_batch_size": add_batch_size, "add_and_sub": add_and_sub}[fn_name]
+    rpc.functions.enable_batching(fn, max_batch_size, max_wait_ms)
+
+
+def disable_batching(fn_name):
+    fn = {"add_batch_size": add_batch_size, "add_and_sub": add_and_sub}[fn_name]
+    rpc.functions.disable_batching(fn)
+
+
 def load_script_module_with_pickled_rref(pickled_script_module):
     f = io.BytesIO(pickled_script_module)
     m = torch.jit.load(f)
@@ -1218,3 +1240,42 @@ class JitRpcTest(
 
         with self.assertRaisesRegex(RuntimeError, "Expected Future but got Tensor"):
             rref.to_here()
+
+    @dist_init
+    def test_script_call_batching(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        num = 4
+        # The wait time is long enough that only a full batch runs.
+        rpc.rpc_sync(dst, enable_batching, args=("add_batch_size", num, 60000))
+        futs = [
+            rpc.rpc_async(dst, add_batch_size, args=(torch.ones(1, 2) * i,))
+            for i in range(num)
+        ]
+        for i, fut in enumerate(futs):
+            self.assertEqual(fut.wait(), torch.ones(1, 2) * i + num)
+
+        # Calls of different sizes with tuple outputs.
+        rpc.rpc_sync(dst, enable_batching, args=("add_and_sub", 3, 60000))
+        args = [(torch.rand(n, 2), torch.rand(n, 2)) for n in range(1, 4)]
+        futs = [rpc.rpc_async(dst, add_and_sub, args=arg) for arg in args]
+        for (x, y), fut in zip(args, futs):
+            self.assertEqual(fut.wait(), (x + y, x - y))
+
+        # Arguments of different sizes in dimension 0 are not batched, and the
+        # call runs (and fails) on its own.
+        with self.assertRaisesRegex(RuntimeError, "The size of tensor a"):
+            rpc.rpc_sync(dst, add_and_sub, args=(torch.ones(2), torch.ones(3)))
+
+        rpc.rpc_sync(dst, disable_batching, args=("add_batch_size",))
+        rpc.rpc_sync(dst, disable_batching, args=("add_and_sub",))
+        ret = rpc.rpc_sync(dst, add_batch_size, args=(torch.ones(3, 2),))
+        self.assertEqual(ret, torch.ones(3, 2) + 3)
+
+    @dist_init
+    def test_script_call_batching_max_wait(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        rpc.rpc_sync(dst, enable_batching, args=("add_batch_size", 100, 10))
+        ret = rpc.rpc_sync(dst, add_batch_size, args=(torch.ones(2, 2),))
+        # The batch runs after the wait time with only one call in it.
+        self.assertEqual(ret, torch.ones(2, 2) + 2)
+        rpc.rpc_sync(dst, disable_batching, args=("add_batch_size",))
@@ -159,6 +159,15 @@ def add_rref_to_value(rref, value):
     return rref.to_here() + value
 
 
+def add_to_rref_and_invalidate(rref, value):
+    rref.local_value().add_(value)
+    rref.invalidate_cached_copies()
+
+
+def rref_invalidate_cached_copies(rref):
+    rref.invalidate_cached_copies()
+
+
 def run_nested_pickle(pickle_cls_instance, tensor):
     return pickle_cls_instance.t + tensor
 
@@ -2097,6 +2106,69 @@ class RpcTest(RpcAgentTestFixture):
             ),
         )
 
+    @dist_init
+    def test_rref_to_here_cache(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        rref = rpc.remote(dst, torch.add, args=(torch.ones(2, 2), 1))
+        self.assertEqual(rref.to_here(cache=True), torch.ones(2, 2) * 2)
+
+        # The owner modifies the value without invalidating the copies, the
+        # cached one is returned while to_here() without caching fetches it.
+        rpc.rpc_sync(dst, _call_method_on_rref, args=(torch.Tensor.add_, rref, 1))
+        self.assertEqual(rref.to_here(cache=True), torch.ones(2, 2) * 2)
+        self.assertEqual(rref.to_here(), torch.ones(2, 2) * 3)
+
+        # The invalidation is asynchronous.
+        rpc.rpc_sync(dst, add_to_rref_and_invalidate, args=(rref, 1))
+        start = time.time()
+        while not torch.equal(rref.to_here(cache=True), torch.ones(2, 2) * 4):
+            self.assertLess(time.time() - start, 10)
+            time.sleep(0.1)
+
+        # Reads inside a distributed autograd context skip the cache.
+        rpc.rpc_sync(dst, _call_method_on_rref, args=(torch.Tensor.add_, rref, 1))
+        with dist_autograd.context():
+            self.assertEqual(rref.to_here(cache=True), torch.ones(2, 2) * 5)
+
+    @dist_init
+    def test_rref_to_here_cache_py_udf(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        rref = rpc.remote(dst, MyClass, args=(2,))
+        self.assertEqual(rref.to_here(cache=True).get_value(), 2)
+        rpc.rpc_sync(dst, _call_method_on_rref, args=(MyClass.increment_value, rref, 1))
+        self.assertEqual(rref.to_here(cache=True).get_value(), 2)
+        rpc.rpc_sync(dst, rref_invalidate_cached_copies, args=(rref,))
+        start = time.time()
+        while rref.to_here(cache=True).get_value() != 3:
+            self.assertLess(time.time() - start, 10)
+            time.sleep(0.1)
+
+    @dist_init
+    def test_rref_invalidate_cached_copies_on_user(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        rref = rpc.remote(dst, torch.add, args=(torch.ones(2, 2), 1))
+        with self.assertRaisesRegex(RuntimeError, "Call it on owner"):
+            rref.invalidate_cached_copies()
+
+    @dist_init
+    def test_batch_to_here(self):
+        rrefs = []
+        expected = []
+        for i in range(self.world_size * 2):
+            dst = worker_name(i % self.world_size)
+            rrefs.append(rpc.remote(dst, torch.add, args=(torch.ones(2, 2), i)))
+            expected.append(torch.ones(2, 2) + i)
+        # Owner RRefs and Python objects.
+        rrefs.append(RRef(torch.ones(2, 2)))
+        expected.append(torch.ones(2, 2))
+        rrefs.append(rpc.remote(worker_name((self.rank + 1) % self.world_size), my_function, args=(1, 2, 3)))
+        expected.append(6)
+
+        self.assertEqual(rpc.batch_to_here(rrefs), expected)
+        self.assertEqual(rpc.batch_to_here(rrefs, cache=True), expected)
+        self.assertEqual(rpc.batch_to_here(rrefs, cache=True), expected)
+        self.assertEqual(rpc.batch_to_here([]), [])
+
     @dist_init
     def test_rref_get_future(self):
         # Tests that we can obtain the future corresponding to the creation of
@@ -3739,3 +3811,63 @@ class TensorPipeAgentRpcTest(RpcAgentTestFixture):
                 num_worker_threads=self.rpc_backend_options.num_worker_threads,
                 rpc_timeout=timeout,
             )
+
+    @dist_init(setup_rpc=False)
+    def test_tensorpipe_device_map_checks(self):
+        options = rpc.TensorPipeRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+        )
+        options.set_device_map("worker1", {0: 1})
+        options.set_device_map("worker1", {1: 0})
+        self.assertEqual(options.device_maps, {"worker1": {0: 1, 1: 0}})
+
+        with self.assertRaisesRegex(RuntimeError, "must be one-to-one"):
+            options.set_device_map("worker2", {0: 1, 1: 1})
+
+        with self.assertRaisesRegex(RuntimeError, "must be non-negative"):
+            rpc.TensorPipeRpcBackendOptions(
+                init_method=self.rpc_backend_options.init_method,
+                device_maps={"worker1": {-1: 0}},
+            )
+
+    @staticmethod
+    def _add_and_get_device(t1, t2):
+        return t1 + t2, t1.device.index
+
+    @skip_if_lt_x_gpu(2)
+    @dist_init(setup_rpc=False)
+    def test_tensorpipe_device_maps(self):
+        dst = worker_name((self.rank + 1) % self.world_size)
+        options = rpc.TensorPipeRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+            num_worker_threads=self.rpc_backend_options.num_worker_threads,
+        )
+        options.set_device_map(dst, {0: 1, 1: 0})
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=options,
+        )
+
+        t1 = torch.rand(3, 3, device="cuda:0")
+        t2 = torch.rand(3, 3)
+        ret, callee_device = rpc.rpc_sync(
+            dst, TensorPipeAgentRpcTest._add_and_get_device, args=(t1, t2.cuda(0))
+        )
+        # The request went to cuda:1 on the callee, the response back to cuda:0.
+        self.assertEqual(callee_device, 1)
+        self.assertEqual(ret.device, torch.device("cuda:0"))
+        self.assertEqual(ret, t1 + t2.cuda(0))
+
+        # CPU tensors are not affected by the map.
+        ret = rpc.rpc_sync(dst, torch.add, args=(t2, 1))
+        self.assertEqual(ret.device, torch.device("cpu"))
+
+        # Devices that are not mapped cannot be sent.
+        if torch.cuda.device_count() > 2:
+            with self.assertRaisesRegex(RuntimeError, "set a device map for"):
+                rpc.rpc_sync(dst, torch.add, args=(t2.cuda(2), 1))
+
+        rpc.shutdown()
@@ -9,6 +9,9 @@ from torch.testing._internal.distributed.ddp_under_dist_autograd_test import (
     DdpComparisonTest,
     DdpUnderDistAutogradTest,
 )
+from torch.testing._internal.distributed.nn.api.pipeline_test import (
+    PipelineTest,
+)
 from torch.testing._internal.distributed.nn.api.remote_module_test import (
     RemoteModuleTest,
 )
@@ -88,6 +91,7 @@ GENERIC_TESTS = [
     JitRpcTest,
     JitDistAutogradTest,
     RemoteModuleTest,
+    PipelineTest,
     DdpUnderDistAutogradTest,
     DdpComparisonTest,
 ]
@@ -1,28 +1,62 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 import torch
 
-from torch._C import _from_dlpack as from_dlpack
-from torch._C import _to_dlpack as to_dlpack
-
-torch._C._add_docstr(from_dlpack, r"""from_dlpack(dlpack) -> Tensor
-
-Decodes a DLPack to a tensor.
-
-Args:
-    dlpack: a PyCapsule object with the dltensor
-
-The tensor will share the memory with the object represented
-in the dlpack.
-Note that each dlpack can only be consumed once.
-""")
-
-torch._C._add_docstr(to_dlpack, r"""to_dlpack(tensor) -> PyCapsule
-
-Returns a DLPack representing the tensor.
-
-Args:
-    tensor: a tensor to be exported
-
-The dlpack shares the tensors memory.
-Note that each dlpack can only be consumed once.
-""")
+# DLDeviceType values of the devices exchanged with PyTorch
+kDLCPU = 1
+kDLGPU = 2
+kDLROCM = 10
+
+
+def to_dlpack(tensor, stream=None):
+    r"""to_dlpack(tensor, stream=None) -> PyCapsule
+
+    Returns a DLPack representing the tensor.
+
+    Args:
+        tensor: a tensor to be exported
+        stream (int, optional): for CUDA tensors, the handle of the stream
+            the consumer will use the tensor on (``1`` and ``2`` denote the
+            legacy and per-thread default streams). Work queued so far on the
+            current stream is made visible to it with an event, so neither
+            side has to synchronize the device. ``None`` (default) or ``-1``
+            skips the handshake.
+
+    The dlpack shares the tensors memory.
+    Note that each dlpack can only be consumed once.
+    """
+    if stream is not None and stream != -1 and tensor.is_cuda:
+        with torch.cuda.device(tensor.device):
+            torch._C._cuda_streamWaitCurrent(stream)
+    return torch._C._to_dlpack(tensor)
+
+
+def from_dlpack(ext_tensor):
+    r"""from_dlpack(ext_tensor) -> Tensor
+
+    Decodes a DLPack to a tensor.
+
+    Args:
+        ext_tensor: a PyCapsule object with the dltensor, or an object
+            implementing the ``__dlpack__`` protocol. In the latter case, the
+            producer is handed the current stream of the tensor's device, so
+            that it orders its pending work before ours without a sync.
+
+    The tensor will share the memory with the object represented
+    in the dlpack. Byte offsets and arbitrary strides of the producer are
+    kept as is, no copy is made.
+    Note that each dlpack can only be consumed once.
+    """
+    if hasattr(ext_tensor, '__dlpack__'):
+        device_type, device_id = ext_tensor.__dlpack_device__()
+        if device_type in (kDLGPU, kDLROCM):
+            stream = torch.cuda.current_stream(device_id).cuda_stream
+            # The default stream is passed as 1 (legacy default stream) on
+            # CUDA and as 0 on ROCm, see the __dlpack__ protocol
+            if stream == 0 and torch.version.hip is None:
+                stream = 1
+            dlpack = ext_tensor.__dlpack__(stream=stream)
+        else:
+            dlpack = ext_tensor.__dlpack__()
+    else:
+        dlpack = ext_tensor
+    return torch._C._from_dlpack(dlpack)
@@ -37,6 +37,38 @@ class ExecutionStats(object):
     def num_iters(self):
         return self._c_stats.num_iters
 
+    @property
+    def latency_p50_ms(self):
+        return self._c_stats.latency_p50_ms
+
+    @property
+    def latency_p90_ms(self):
+        return self._c_stats.latency_p90_ms
+
+    @property
+    def latency_p99_ms(self):
+        return self._c_stats.latency_p99_ms
+
+    @property
+    def latency_p999_ms(self):
+        return self._c_stats.latency_p999_ms
+
+    @property
+    def cold_latency_ms(self):
+        return self._c_stats.cold_latency_ms
+
+    @property
+    def warmup_latency_avg_ms(self):
+        return self._c_stats.warmup_latency_avg_ms
+
+    @property
+    def allocations_per_iter(self):
+        return self._c_stats.allocations_per_iter
+
+    @property
+    def allocated_bytes_per_iter(self):
+        return self._c_stats.allocated_bytes_per_iter
+
     @property
     def iters_per_second(self):
         '''
@@ -46,17 +78,24 @@ class ExecutionStats(object):
 
     @property
     def total_time_seconds(self):
-        return self.num_iters * (
-            self.latency_avg_ms / 1000.0) / self.benchmark_config.num_calling_threads
-
+        return self._c_stats.total_time_ms / 1000.0
 
     def __str__(self):
         return '\n'.join([
             "Average latency per example: " + format_time(time_ms=self.latency_avg_ms),
             "Total number of iterations: {}".format(self.num_iters),
             "Total number of iterations per second (across all threads): {:.2f}".format(self.iters_per_second),
-            "Total time: " + format_time(time_s=self.total_time_seconds)
-        ])
+            "Total time: " + format_time(time_s=self.total_time_seconds),
+            "Latency p50 / p90 / p99 / p99.9: " + " / ".join(
+                format_time(time_ms=latency) for latency in [
+                    self.latency_p50_ms, self.latency_p90_ms,
+                    self.latency_p99_ms, self.latency_p999_ms]),
+            "Cold start latency: " + format_time(time_ms=self.cold_latency_ms),
+            "Average warmup latency: " + format_time(time_ms=self.warmup_latency_avg_ms),
+        ] + ([
+            "Allocations per iteration: {:.2f}".format(self.allocations_per_iter),
+            "Allocated bytes per iteration: {:.2f}".format(self.allocated_bytes_per_iter),
+        ] if self.benchmark_config.profile_memory else []))
 
 
 class ThroughputBenchmark(object):
@@ -122,7 +161,10 @@ class ThroughputBenchmark(object):
             num_calling_threads=1,
             num_warmup_iters=10,
             num_iters=100,
-            profiler_output_path=""):
+            profiler_output_path="",
+            cpu_affinity=None,
+            target_qps=0,
+            profile_memory=False):
         '''
         Args:
             num_warmup_iters (int): Warmup iters are used to make sure we run a module
@@ -142,16 +184,40 @@ class ThroughputBenchmark(object):
                 execution (but not the warmup phase). The full trace will be saved
                 into the file path provided by this argument
 
+            cpu_affinity (list of int, optional): CPU cores to pin the calling threads
+                to. Calling thread i is pinned to ``cpu_affinity[i % len(cpu_affinity)]``.
+                Only supported on Linux
+
+            target_qps (float): If positive, the benchmark runs open-loop: requests
+                arrive at this rate across all the calling threads, whether or not a
+                thread is free to serve them, and their latency is measured from their
+                arrival. Otherwise (the default) every calling thread sends its next
+                request as soon as the previous one is done
+
+            profile_memory (bool): If set, the allocations made by the calling threads
+                during the main benchmark execution are counted. This adds some
+                overhead to every allocation
+
 
-        This function returns BenchmarkExecutionStats object which is defined via pybind11.
-        It currently has two fields:
+        This function returns an ExecutionStats object wrapping the
+        BenchmarkExecutionStats object which is defined via pybind11. Its fields are:
             - num_iters - number of actual iterations the benchmark have made
-            - avg_latency_ms - average time it took to infer on one input example in milliseconds
+            - latency_avg_ms - average time it took to infer on one input example in milliseconds
+            - latency_p50_ms, latency_p90_ms, latency_p99_ms, latency_p999_ms - percentiles
+              of the latencies of the iterations in milliseconds
+            - cold_latency_ms - latency of the first call of a calling thread, averaged
+              over the threads, and warmup_latency_avg_ms - average latency of the warmup
+              iterations, both in milliseconds
+            - allocations_per_iter, allocated_bytes_per_iter - if profile_memory is set,
+              the number of allocations and the allocated bytes per iteration
         '''
         config = torch._C.BenchmarkConfig()
         config.num_calling_threads = num_calling_threads
         config.num_warmup_iters = num_warmup_iters
         config.num_iters = num_iters
         config.profiler_output_path = profiler_output_path
+        config.cpu_affinity = cpu_affinity or []
+        config.target_qps = target_qps
+        config.profile_memory = profile_memory
         c_stats = self._benchmark.benchmark(config)
         return ExecutionStats(c_stats, config)